@@ -0,0 +1,398 @@
+"""
+Component-level microbenchmarks.
+
+Measures the throughput of individual building blocks (BSDF evaluation and
+sampling, texture lookups, emitter sampling, warping functions, discrete
+distributions and ray queries against a small scene) on randomized inputs.
+Results are written in the JSON format of Google Benchmark, so that they can
+be compared with its ``compare.py`` tool. Usage::
+
+    $ source setpath.sh
+    $ python benchmarks/micro.py -o micro.json
+    $ python benchmarks/micro.py -v llvm_rgb -f 'bsdf/rough.*' -o micro.json
+
+Scalar variants evaluate one input at a time from Python, which mostly
+measures the overhead of the bindings. They remain useful to compare plugins
+against each other. JIT variants evaluate a whole batch of inputs per
+iteration. The kernels are compiled during a warm-up iteration, hence the
+timings exclude tracing and compilation.
+"""
+
+import argparse
+import json
+import os
+import platform
+import re
+import socket
+import sys
+import time
+from datetime import datetime
+
+import numpy as np
+import drjit as dr
+import mitsuba as mi
+
+# Number of inputs per iteration in JIT and scalar variants
+JIT_WIDTH = 1 << 20
+SCALAR_WIDTH = 1 << 10
+
+
+def random_inputs(width, seed=0):
+    """Uniform random inputs, the same for all variants"""
+    rng = np.random.default_rng(seed)
+    return {
+        'u1': rng.random(width, dtype=np.float32),
+        'u2': rng.random((width, 2), dtype=np.float32),
+        'uv': rng.random((width, 2), dtype=np.float32),
+        'dir': rng.standard_normal((width, 3)).astype(np.float32),
+        'pos': rng.uniform(-1, 1, (width, 3)).astype(np.float32),
+    }
+
+
+def convert(inputs, index=None):
+    """
+    Convert the random inputs to Dr.Jit types of the current variant. In
+    scalar variants, ``index`` selects the element to convert.
+    """
+    def hemisphere(d):
+        d = d / np.linalg.norm(d, axis=-1, keepdims=True)
+        d[..., 2] = np.abs(d[..., 2])
+        return d
+
+    def get(value):
+        return value if index is None else value[index]
+
+    return {
+        'u1': mi.Float(get(inputs['u1'])),
+        'u2': mi.Point2f(get(inputs['u2'])),
+        'uv': mi.Point2f(get(inputs['uv'])),
+        'wi': mi.Vector3f(hemisphere(get(inputs['dir']))),
+        'wo': mi.Vector3f(hemisphere(get(inputs['dir'][::-1]).copy())),
+        'pos': mi.Point3f(get(inputs['pos'])),
+    }
+
+
+# ----------------------------------------------------------------------------
+#  Benchmark definitions. Each factory instantiates the component under test
+#  and returns a function that processes a set of converted inputs.
+# ----------------------------------------------------------------------------
+
+BSDFS = {
+    'diffuse': { 'type': 'diffuse' },
+    'roughconductor': { 'type': 'roughconductor', 'alpha': 0.2 },
+    'roughdielectric': { 'type': 'roughdielectric', 'alpha': 0.2 },
+    'roughplastic': { 'type': 'roughplastic', 'alpha': 0.2 },
+    'principled': { 'type': 'principled', 'roughness': 0.3, 'metallic': 0.5 },
+}
+
+
+def bsdf_benchmarks():
+    def make(desc, method):
+        def factory():
+            bsdf = mi.load_dict(desc)
+            ctx = mi.BSDFContext()
+
+            def func(x):
+                si = dr.zeros(mi.SurfaceInteraction3f, dr.width(x['wi']))
+                si.wi = x['wi']
+                si.uv = x['uv']
+                si.sh_frame = mi.Frame3f(mi.Vector3f(0, 0, 1))
+                if method == 'eval':
+                    return bsdf.eval(ctx, si, x['wo'])
+                elif method == 'pdf':
+                    return bsdf.pdf(ctx, si, x['wo'])
+                else:
+                    return bsdf.sample(ctx, si, x['u1'], x['u2'])
+            return func
+        return factory
+
+    return { f'bsdf/{name}/{method}': make(desc, method)
+             for name, desc in BSDFS.items()
+             for method in ['eval', 'sample', 'pdf'] }
+
+
+def texture_benchmarks():
+    rng = np.random.default_rng(1)
+    image = rng.random((1024, 1024, 3), dtype=np.float32)
+
+    def make(desc):
+        def factory():
+            texture = mi.load_dict(desc())
+
+            def func(x):
+                si = dr.zeros(mi.SurfaceInteraction3f, dr.width(x['uv']))
+                si.uv = x['uv']
+                return texture.eval(si)
+            return func
+        return factory
+
+    def bitmap(filter_type):
+        return lambda: {
+            'type': 'bitmap',
+            'data': mi.TensorXf(image),
+            'raw': True,
+            'filter_type': filter_type
+        }
+
+    return {
+        'texture/bitmap_bilinear/eval': make(bitmap('bilinear')),
+        'texture/bitmap_nearest/eval': make(bitmap('nearest')),
+        'texture/checkerboard/eval': make(lambda: { 'type': 'checkerboard' }),
+    }
+
+
+def emitter_benchmarks():
+    rng = np.random.default_rng(2)
+    envmap = mi.Bitmap(rng.random((256, 512, 3), dtype=np.float32))
+
+    def make(desc, shape=None):
+        def factory():
+            if shape is None:
+                emitter = mi.load_dict(desc())
+            else:
+                emitter = mi.load_dict(dict(shape, emitter=desc())).emitter()
+
+            def func(x):
+                it = dr.zeros(mi.Interaction3f, dr.width(x['pos']))
+                it.p = x['pos'] * 2 + mi.Vector3f(0, 0, 4)
+                return emitter.sample_direction(it, x['u2'])
+            return func
+        return factory
+
+    return {
+        'emitter/point/sample_direction':
+            make(lambda: { 'type': 'point', 'position': [0, 0, 0] }),
+        'emitter/spot/sample_direction':
+            make(lambda: { 'type': 'spot' }),
+        'emitter/area_sphere/sample_direction':
+            make(lambda: { 'type': 'area' }, { 'type': 'sphere' }),
+        'emitter/area_rectangle/sample_direction':
+            make(lambda: { 'type': 'area' }, { 'type': 'rectangle' }),
+        'emitter/envmap/sample_direction':
+            make(lambda: { 'type': 'envmap', 'bitmap': envmap }),
+    }
+
+
+def warp_benchmarks():
+    W = lambda f: (lambda: f)
+    return {
+        'warp/square_to_uniform_disk_concentric':
+            W(lambda x: mi.warp.square_to_uniform_disk_concentric(x['u2'])),
+        'warp/square_to_uniform_sphere':
+            W(lambda x: mi.warp.square_to_uniform_sphere(x['u2'])),
+        'warp/square_to_cosine_hemisphere':
+            W(lambda x: mi.warp.square_to_cosine_hemisphere(x['u2'])),
+        'warp/square_to_uniform_cone':
+            W(lambda x: mi.warp.square_to_uniform_cone(x['u2'], 0.5)),
+        'warp/square_to_beckmann':
+            W(lambda x: mi.warp.square_to_beckmann(x['u2'], 0.2)),
+        'warp/square_to_von_mises_fisher':
+            W(lambda x: mi.warp.square_to_von_mises_fisher(x['u2'], 10.0)),
+        'warp/square_to_uniform_triangle':
+            W(lambda x: mi.warp.square_to_uniform_triangle(x['u2'])),
+        'warp/uniform_sphere_to_square':
+            W(lambda x: mi.warp.uniform_sphere_to_square(x['wi'])),
+    }
+
+
+def distr_benchmarks():
+    rng = np.random.default_rng(3)
+    pmf = rng.random(1 << 16, dtype=np.float32)
+    data = rng.random((512, 1024), dtype=np.float32)
+
+    def discrete():
+        distr = mi.DiscreteDistribution(pmf)
+        return lambda x: distr.sample_reuse_pmf(x['u1'])
+
+    def hierarchical():
+        distr = mi.Hierarchical2D0(data)
+        return lambda x: distr.sample(x['u2'])
+
+    def marginal():
+        distr = mi.MarginalContinuous2D0(data)
+        return lambda x: distr.sample(x['u2'])
+
+    return {
+        'distr/DiscreteDistribution/sample': discrete,
+        'distr/Hierarchical2D0/sample': hierarchical,
+        'distr/MarginalContinuous2D0/sample': marginal,
+    }
+
+
+def ray_benchmarks():
+    def make(method, coherent):
+        def factory():
+            scene = mi.load_dict({
+                'type': 'scene',
+                'sphere': { 'type': 'sphere', 'to_world':
+                            mi.ScalarTransform4f.scale(0.5) },
+                'cube': { 'type': 'cube' },
+                'floor': { 'type': 'rectangle', 'to_world':
+                           mi.ScalarTransform4f.translate([0, 0, -1])
+                                               .scale(10) },
+            })
+
+            def func(x):
+                if coherent:
+                    # Pinhole camera looking at the scene from above
+                    o = mi.Point3f(0, 0, 4)
+                    d = dr.normalize(mi.Vector3f(x['uv'].x - 0.5,
+                                                 x['uv'].y - 0.5, -1))
+                else:
+                    o = x['pos']
+                    d = dr.normalize(mi.Vector3f(x['wi'].x, x['wi'].y,
+                                                 x['wi'].z - 0.5))
+                ray = mi.Ray3f(o, d)
+                if method == 'intersect':
+                    return scene.ray_intersect_preliminary(ray, coherent)
+                else:
+                    return scene.ray_test(ray, coherent)
+            return func
+        return factory
+
+    return { f'ray/{method}_{"coherent" if coherent else "incoherent"}':
+                 make(method, coherent)
+             for method in ['intersect', 'test']
+             for coherent in [True, False] }
+
+
+def all_benchmarks():
+    result = {}
+    for f in [bsdf_benchmarks, texture_benchmarks, emitter_benchmarks,
+              warp_benchmarks, distr_benchmarks, ray_benchmarks]:
+        result.update(f())
+    return result
+
+
+# ----------------------------------------------------------------------------
+#  Timing
+# ----------------------------------------------------------------------------
+
+def measure(step, min_time):
+    """Run ``step`` until ``min_time`` has elapsed, return (iterations, time)"""
+    iterations, elapsed = 0, 0.0
+    while elapsed < min_time:
+        start = time.perf_counter()
+        step()
+        elapsed += time.perf_counter() - start
+        iterations += 1
+    return iterations, elapsed
+
+
+def run_jit(factory, inputs, min_time):
+    """Process all inputs as a single batch per iteration"""
+    x = convert(inputs)
+    dr.eval(x)
+    func = factory()
+
+    def step():
+        dr.eval(func(x))
+        dr.sync_thread()
+
+    step()  # Warm-up: tracing and compilation
+    return measure(step, min_time)
+
+
+def run_scalar(factory, inputs, min_time):
+    """Process the inputs one by one"""
+    xs = [convert(inputs, i) for i in range(len(inputs['u1']))]
+    func = factory()
+
+    def step():
+        for x in xs:
+            func(x)
+
+    return measure(step, min_time)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n\n')[0])
+    parser.add_argument('-v', '--variant', action='append',
+                        help='Variant to benchmark (default: all RGB variants)')
+    parser.add_argument('-f', '--filter', default='.*',
+                        help='Regular expression selecting benchmarks by name')
+    parser.add_argument('-r', '--repetitions', type=int, default=3,
+                        help='Repetitions of each benchmark (default: 3)')
+    parser.add_argument('-t', '--min-time', type=float, default=0.2,
+                        help='Minimum time per repetition in s (default: 0.2)')
+    parser.add_argument('-o', '--output', default='micro.json',
+                        help='Output JSON file (default: micro.json)')
+    args = parser.parse_args()
+
+    variants = args.variant or [v for v in mi.variants() if v.endswith('_rgb')]
+    pattern = re.compile(args.filter)
+
+    report = {
+        'context': {
+            'date': datetime.now().isoformat(),
+            'host_name': socket.gethostname(),
+            'executable': ' '.join([sys.executable] + sys.argv),
+            'num_cpus': os.cpu_count(),
+            'mhz_per_cpu': 0,
+            'cpu_scaling_enabled': False,
+            'caches': [],
+            'library_build_type': 'release',
+            'mitsuba_version': mi.__version__,
+            'platform': platform.platform(),
+        },
+        'benchmarks': []
+    }
+
+    for variant in variants:
+        mi.set_variant(variant)
+        is_jit = dr.is_jit_v(mi.Float)
+        width = JIT_WIDTH if is_jit else SCALAR_WIDTH
+        inputs = random_inputs(width)
+        runner = run_jit if is_jit else run_scalar
+
+        for name, factory in all_benchmarks().items():
+            if not pattern.search(name):
+                continue
+            run_name = f'{variant}/{name}'
+            times = []
+            for rep in range(args.repetitions):
+                try:
+                    iterations, elapsed = runner(factory, inputs, args.min_time)
+                except Exception as e:
+                    print(f'{run_name}: failed ({e})')
+                    break
+                ns = elapsed / iterations * 1e9
+                times.append(ns)
+                report['benchmarks'].append({
+                    'name': run_name,
+                    'run_name': run_name,
+                    'run_type': 'iteration',
+                    'repetitions': args.repetitions,
+                    'repetition_index': rep,
+                    'threads': 1,
+                    'iterations': iterations,
+                    'real_time': ns,
+                    'cpu_time': ns,
+                    'time_unit': 'ns',
+                    'items_per_second': width * iterations / elapsed,
+                })
+            if times:
+                median = sorted(times)[len(times) // 2]
+                report['benchmarks'].append({
+                    'name': run_name + '_median',
+                    'run_name': run_name,
+                    'run_type': 'aggregate',
+                    'aggregate_name': 'median',
+                    'repetitions': len(times),
+                    'threads': 1,
+                    'iterations': len(times),
+                    'real_time': median,
+                    'cpu_time': median,
+                    'time_unit': 'ns',
+                    'items_per_second': width / (median * 1e-9),
+                })
+                print('%-60s %10.2f Mitems/s' % (run_name,
+                                                 width / median * 1e3))
+
+    with open(args.output, 'w') as f:
+        json.dump(report, f, indent=2)
+    print('Wrote %s' % args.output)
+
+
+if __name__ == '__main__':
+    main()
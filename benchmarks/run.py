@@ -0,0 +1,155 @@
+"""
+Rendering benchmark suite.
+
+Renders the scenes from ``scenes.py`` with each requested variant and writes
+the timings to a JSON file, which can be compared across versions of Mitsuba
+to detect performance regressions. Usage::
+
+    $ source setpath.sh
+    $ python benchmarks/run.py -o results.json
+    $ python benchmarks/run.py -v llvm_ad_rgb -s cbox -s hair -o results.json
+
+For JIT variants, the first ("cold") render of every scene is preceded by a
+flush of the in-memory kernel cache, hence its time includes tracing and
+compilation (unless the kernels are found in the on-disk cache, which is
+reported as well). The following ("warm") renders reuse the compiled kernels.
+"""
+
+import argparse
+import json
+import os
+import platform
+import sys
+import tempfile
+import time
+
+import drjit as dr
+import mitsuba as mi
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from scenes import SCENES, SPP
+
+
+def peak_memory():
+    """Peak resident memory of the process in bytes"""
+    try:
+        import resource
+        usage = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+        return usage if sys.platform == 'darwin' else usage * 1024
+    except ImportError:
+        return None
+
+
+def render(scene, spp):
+    """Render the scene once and return the elapsed wall-clock time (s)"""
+    dr.sync_thread()
+    start = time.perf_counter()
+    image = mi.render(scene, spp=spp)
+    dr.eval(image)
+    dr.sync_thread()
+    return time.perf_counter() - start
+
+
+def ray_count():
+    """Number of rays traced so far (requires MI_RAY_STATISTICS, else None)"""
+    C = mi.RayStatistics.Counter
+    count = mi.RayStatistics.value(C.IntersectRays) + \
+            mi.RayStatistics.value(C.ShadowRays)
+    return count if count > 0 else None
+
+
+def run_scene(name, tmp_dir, spp, repeat):
+    is_jit = dr.is_jit_v(mi.Float)
+
+    start = time.perf_counter()
+    scene = mi.load_dict(SCENES[name](tmp_dir))
+    dr.sync_thread()
+    load_time = time.perf_counter() - start
+
+    film_size = scene.sensors()[0].film().crop_size()
+    samples = int(film_size[0]) * int(film_size[1]) * spp
+
+    result = { 'load_time': load_time, 'samples': samples }
+
+    # Cold run
+    if is_jit:
+        dr.flush_kernel_cache()
+        mi.RenderStats.set_enabled(True)
+    mi.RayStatistics.reset()
+    result['cold_time'] = render(scene, spp)
+    rays = ray_count()
+
+    if is_jit:
+        stats = mi.RenderStats.last()
+        mi.RenderStats.set_enabled(False)
+        result['cold_kernels'] = len(stats['kernels'])
+        result['cold_cache_misses'] = stats['cache_misses']
+        result['cold_codegen_time'] = sum(k['codegen_time'] + k['backend_time']
+                                          for k in stats['kernels']) * 1e-3
+
+    # Warm runs
+    times = []
+    for _ in range(repeat):
+        mi.RayStatistics.reset()
+        times.append(render(scene, spp))
+        rays = ray_count() or rays
+    times.sort()
+    warm = times[len(times) // 2]
+
+    result['warm_times'] = times
+    result['warm_time'] = warm
+    result['samples_per_second'] = samples / warm
+    result['rays_per_second'] = rays / warm if rays is not None else None
+    result['peak_memory'] = peak_memory()
+    return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n\n')[0])
+    parser.add_argument('-v', '--variant', action='append',
+                        help='Variant to benchmark (default: all RGB variants)')
+    parser.add_argument('-s', '--scene', action='append', choices=list(SCENES),
+                        help='Scene to render (default: all)')
+    parser.add_argument('-n', '--repeat', type=int, default=3,
+                        help='Number of warm renders per scene (default: 3)')
+    parser.add_argument('--spp', type=int, default=SPP,
+                        help='Samples per pixel (default: %i)' % SPP)
+    parser.add_argument('-o', '--output', default='benchmark.json',
+                        help='Output JSON file (default: benchmark.json)')
+    args = parser.parse_args()
+
+    variants = args.variant or [v for v in mi.variants() if v.endswith('_rgb')]
+    scene_names = args.scene or list(SCENES)
+
+    report = {
+        'mitsuba': mi.__version__,
+        'platform': platform.platform(),
+        'processor': platform.processor(),
+        'cpu_count': os.cpu_count(),
+        'spp': args.spp,
+        'results': {}
+    }
+
+    with tempfile.TemporaryDirectory() as tmp_dir:
+        for variant in variants:
+            mi.set_variant(variant)
+            report['results'][variant] = {}
+            for name in scene_names:
+                print('[%s] %s .. ' % (variant, name), end='', flush=True)
+                try:
+                    r = run_scene(name, tmp_dir, args.spp, args.repeat)
+                    print('cold %.3fs, warm %.3fs, %.2f Msamples/s' %
+                          (r['cold_time'], r['warm_time'],
+                           r['samples_per_second'] * 1e-6))
+                except Exception as e:
+                    r = { 'error': str(e) }
+                    print('failed: %s' % e)
+                report['results'][variant][name] = r
+
+    with open(args.output, 'w') as f:
+        json.dump(report, f, indent=2)
+    print('Wrote %s' % args.output)
+
+
+if __name__ == '__main__':
+    main()
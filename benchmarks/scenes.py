@@ -0,0 +1,213 @@
+"""
+Fixed set of benchmark scenes.
+
+All scenes are generated procedurally from a fixed random seed so that the
+benchmark does not depend on external data and renders exactly the same
+workload on every machine. Each function is called once a variant has been
+selected. It takes a scratch directory (for plugins that read their input
+from disk) and returns a scene dictionary for ``mi.load_dict()``.
+"""
+
+import os
+import numpy as np
+import mitsuba as mi
+
+# Film resolution and sample count shared by all scenes
+RESOLUTION = 256
+SPP = 16
+
+
+def _sensor(origin, target, fov=39.3077, resolution=RESOLUTION, spp=SPP):
+    return {
+        'type': 'perspective',
+        'fov': fov,
+        'to_world': mi.ScalarTransform4f.look_at(origin=origin, target=target,
+                                                 up=[0, 1, 0]),
+        'sampler': { 'type': 'independent', 'sample_count': spp },
+        'film': {
+            'type': 'hdrfilm',
+            'width': resolution,
+            'height': resolution,
+            'rfilter': { 'type': 'box' },
+            'pixel_format': 'rgb'
+        }
+    }
+
+
+def cbox(tmp_dir):
+    """The Cornell box with a path tracer (``mi.cornell_box()``)"""
+    scene = mi.cornell_box()
+    scene['sensor'] = _sensor([0, 0, 3.9], [0, 0, 0])
+    return scene
+
+
+def large_mesh(tmp_dir, res=768):
+    """A displaced height field with ~1.2M triangles under an environment"""
+    rng = np.random.default_rng(0)
+    x, z = np.meshgrid(np.linspace(-1, 1, res), np.linspace(-1, 1, res))
+    y = 0.05 * np.sin(9 * x) * np.cos(7 * z) + \
+        0.02 * rng.standard_normal((res, res))
+
+    vertices = np.stack([x, y, z], axis=-1).reshape(-1, 3)
+    idx = np.arange(res * res, dtype=np.uint32).reshape(res, res)
+    a, b = idx[:-1, :-1].ravel(), idx[:-1, 1:].ravel()
+    c, d = idx[1:, :-1].ravel(), idx[1:, 1:].ravel()
+    faces = np.concatenate([np.stack([a, c, b], -1),
+                            np.stack([b, c, d], -1)])
+
+    mesh = mi.Mesh('heightfield', len(vertices), len(faces))
+    params = mi.traverse(mesh)
+    params['vertex_positions'] = type(params['vertex_positions'])(
+        vertices.ravel().astype(np.float32))
+    params['faces'] = type(params['faces'])(faces.ravel())
+    params.update()
+
+    return {
+        'type': 'scene',
+        'integrator': { 'type': 'path', 'max_depth': 6 },
+        'sensor': _sensor([0, 1.2, 2.2], [0, 0, 0]),
+        'emitter': { 'type': 'constant' },
+        'sun': {
+            'type': 'directional',
+            'direction': [-1, -1, -0.5],
+            'irradiance': { 'type': 'rgb', 'value': 3.0 }
+        },
+        'mesh': mesh
+    }
+
+
+def hair(tmp_dir, count=20000, segments=8):
+    """A patch of randomly perturbed linear hair curves"""
+    rng = np.random.default_rng(1)
+    fname = os.path.join(tmp_dir, 'hair.txt')
+    with open(fname, 'w') as f:
+        for _ in range(count):
+            p = np.array([rng.uniform(-1, 1), 0.0, rng.uniform(-1, 1)])
+            for j in range(segments):
+                f.write('%f %f %f %f\n' % (*p, 0.004 * (1 - j / segments)))
+                p = p + np.array([rng.normal(0, 0.02), 0.06,
+                                  rng.normal(0, 0.02)])
+            f.write('\n')
+
+    return {
+        'type': 'scene',
+        'integrator': { 'type': 'path', 'max_depth': 8 },
+        'sensor': _sensor([0, 0.8, 2.5], [0, 0.25, 0]),
+        'emitter': { 'type': 'constant' },
+        'curves': {
+            'type': 'linearcurve',
+            'filename': fname,
+            'bsdf': {
+                'type': 'roughconductor',
+                'alpha': 0.3
+            }
+        },
+        'floor': {
+            'type': 'rectangle',
+            'to_world': mi.ScalarTransform4f.rotate([1, 0, 0], -90).scale(2),
+        }
+    }
+
+
+def volume(tmp_dir, res=64):
+    """A heterogeneous medium (smoothed noise) inside a cube"""
+    rng = np.random.default_rng(2)
+    density = rng.uniform(0, 1, (res, res, res))
+    for axis in range(3):
+        density = (density + np.roll(density, 1, axis) +
+                   np.roll(density, -1, axis)) / 3
+    density = np.clip((density - 0.45) * 8, 0, 1).astype(np.float32)
+
+    return {
+        'type': 'scene',
+        'integrator': { 'type': 'volpath', 'max_depth': 16 },
+        'sensor': _sensor([0, 0.5, 3.5], [0, 0, 0]),
+        'emitter': { 'type': 'constant' },
+        'cube': {
+            'type': 'cube',
+            'bsdf': { 'type': 'null' },
+            'interior': {
+                'type': 'heterogeneous',
+                'albedo': 0.8,
+                'scale': 20.0,
+                'sigma_t': {
+                    'type': 'gridvolume',
+                    'data': mi.TensorXf(density[..., None]),
+                    'to_world': mi.ScalarTransform4f.translate(-1).scale(2)
+                }
+            }
+        }
+    }
+
+
+def many_lights(tmp_dir, count=512):
+    """Hundreds of small spherical area lights above a diffuse floor"""
+    rng = np.random.default_rng(3)
+    scene = {
+        'type': 'scene',
+        'integrator': { 'type': 'path', 'max_depth': 4 },
+        'sensor': _sensor([0, 2.5, 3.0], [0, 0, 0]),
+        'floor': {
+            'type': 'rectangle',
+            'to_world': mi.ScalarTransform4f.rotate([1, 0, 0], -90).scale(4),
+        }
+    }
+    for i in range(count):
+        p = [rng.uniform(-3, 3), rng.uniform(0.1, 1.0), rng.uniform(-3, 3)]
+        scene[f'light_{i}'] = {
+            'type': 'sphere',
+            'center': p,
+            'radius': 0.02,
+            'emitter': {
+                'type': 'area',
+                'radiance': {
+                    'type': 'rgb',
+                    'value': rng.uniform(5, 50, 3).tolist()
+                }
+            }
+        }
+    return scene
+
+
+def textures(tmp_dir, count=64, res=512):
+    """A grid of quads, each with its own high-resolution bitmap texture"""
+    rng = np.random.default_rng(4)
+    side = int(np.sqrt(count))
+    scene = {
+        'type': 'scene',
+        'integrator': { 'type': 'path', 'max_depth': 4 },
+        'sensor': _sensor([0, 0, 9], [0, 0, 0]),
+        'emitter': { 'type': 'constant' },
+    }
+    u, v = np.meshgrid(np.linspace(0, 1, res), np.linspace(0, 1, res))
+    for i in range(count):
+        freq = rng.uniform(4, 64, 2)
+        image = np.stack([
+            0.5 + 0.5 * np.sin(freq[0] * u * 2 * np.pi),
+            0.5 + 0.5 * np.sin(freq[1] * v * 2 * np.pi),
+            rng.uniform(0, 1, (res, res))
+        ], axis=-1).astype(np.float32)
+        x, y = i % side - (side - 1) / 2, i // side - (side - 1) / 2
+        scene[f'quad_{i}'] = {
+            'type': 'rectangle',
+            'to_world': mi.ScalarTransform4f.translate([x, y, 0]).scale(0.48),
+            'bsdf': {
+                'type': 'diffuse',
+                'reflectance': {
+                    'type': 'bitmap',
+                    'data': mi.TensorXf(image),
+                    'raw': True
+                }
+            }
+        }
+    return scene
+
+
+SCENES = {
+    'cbox': cbox,
+    'large_mesh': large_mesh,
+    'hair': hair,
+    'volume': volume,
+    'many_lights': many_lights,
+    'textures': textures,
+}
@@ -49,6 +49,7 @@ rst_prolog = r"""
 .. |phase| replace:: :paramtype:`phase`
 .. |point| replace:: :paramtype:`point`
 .. |transform| replace:: :paramtype:`transform`
+.. |animation| replace:: :paramtype:`animation`
 .. |volume| replace:: :paramtype:`volume`
 
 .. |drjit| replace:: :monosp:`drjit`
@@ -152,7 +153,8 @@ excluded_api = [
 
 # Define the structure of the generated reference pages for the different libraries.
 api_doc_structure = {
-    'Core': ['mitsuba.render', 'mitsuba.set_variant', 'mitsuba.variant',
+    'Core': ['mitsuba.render', 'mitsuba.render_batch', 'mitsuba.InteractiveSession',
+             'mitsuba.set_variant', 'mitsuba.variant',
              'mitsuba.traverse', 'mitsuba.SceneParameters',
              'mitsuba.variants', 'mitsuba.set_log_level',
              'mitsuba.ArgParser', 'mitsuba.AtomicFloat',
@@ -14,6 +14,8 @@ SHAPE_ORDERING = [
     'serialized',
     'cube'
     'sphere',
+    'spheres',
+    'ellipsoids',
     'disk',
     'cylinder',
     'bsplinecurve',
@@ -21,6 +23,8 @@ SHAPE_ORDERING = [
     'rectangle',
     'cube',
     'sdfgrid',
+    'subdivision',
+    'displacement',
     'shapegroup',
     'instance'
 ]
@@ -55,7 +59,8 @@ EMITTER_ORDERING = [
     'constant',
     'envmap',
     'spot',
-    'projector'
+    'projector',
+    'volumelight'
 ]
 
 SENSOR_ORDERING = [
@@ -82,15 +87,22 @@ SPECTRUM_ORDERING = [
 
 SAMPLER_ORDERING = [
     'independent',
+    'philox',
     'stratified',
     'multijitter',
     'orthogonal',
-    'ldsampler'
+    'ldsampler',
+    'sobol',
+    'halton'
 ]
 
 INTEGRATOR_ORDERING = [
     'direct',
     'path',
+    'guided_path',
+    'sppm',
+    'bdpt',
+    'radiance_cache',
     'aov',
     'volpath',
     'volpathmis',
@@ -103,7 +115,8 @@ INTEGRATOR_ORDERING = [
 
 FILM_ORDERING = [
     'hdrfilm',
-    'specfilm'
+    'specfilm',
+    'streamfilm'
 ]
 
 RFILTER_ORDERING = [
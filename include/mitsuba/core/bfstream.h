@@ -0,0 +1,126 @@
+#pragma once
+
+#include <mitsuba/core/fstream.h>
+#include <fstream>
+#include <future>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/** \brief Read-only \ref Stream implementation backed by a file, which
+ * reads large blocks ahead of time on a background thread.
+ *
+ * Loaders often issue a large number of small \ref read() calls, each of
+ * which amounts to a separate request to the operating system when using a
+ * \ref FileStream. This class instead reads the file in blocks of a
+ * configurable size and serves the requests from memory. While one block is
+ * being consumed, the next one is read asynchronously, which hides the
+ * latency of slow (e.g. network) file systems for sequential accesses.
+ * Seeking outside of the current block discards the block being read ahead.
+ */
+class MI_EXPORT_LIB BufferedFileStream : public Stream {
+public:
+    using Stream::read;
+    using Stream::write;
+
+    /** \brief Constructs a new BufferedFileStream by opening the file
+     * pointed to by <tt>p</tt> in read-only mode.
+     *
+     * \param buffer_size
+     *     Size of the blocks that are read from the file (in bytes). Two
+     *     blocks are held in memory at any time.
+     *
+     * Throws an exception if the file cannot be opened.
+     */
+    BufferedFileStream(const fs::path &p, size_t buffer_size = 4 * 1024 * 1024);
+
+    /** \brief Closes the stream and the underlying file.
+     * No further read operations are permitted.
+     *
+     * This function is idempotent.
+     * It is called automatically by the destructor.
+     */
+    virtual void close() override;
+
+    /// Whether the stream is closed (no read is then permitted).
+    virtual bool is_closed() const override;
+
+    /// Return the path descriptor associated with this BufferedFileStream
+    const fs::path &path() const { return m_path; }
+
+    /// Return the size of the blocks that are read from the file
+    size_t buffer_size() const { return m_buffer_size; }
+
+    // =========================================================================
+    //! @{ \name Implementation of the Stream interface
+    // =========================================================================
+
+    /**
+     * \brief Reads a specified amount of data from the stream.
+     * Throws an exception when the stream ended prematurely.
+     */
+    virtual void read(void *p, size_t size) override;
+
+    /// Always throws, since the stream is read-only
+    virtual void write(const void *p, size_t size) override;
+
+    /// Seeks to a position inside the stream. May throw if the resulting state is invalid.
+    virtual void seek(size_t pos) override;
+
+    /// Always throws, since the stream is read-only
+    virtual void truncate(size_t size) override;
+
+    /// Gets the current position inside the file
+    virtual size_t tell() const override;
+
+    /// Returns the size of the file
+    virtual size_t size() const override { return m_size; }
+
+    /// Does nothing, since the stream is read-only
+    virtual void flush() override { }
+
+    /// Always false, since the stream is read-only
+    virtual bool can_write() const override { return false; }
+
+    /// True except if the stream was closed.
+    virtual bool can_read() const override { return !is_closed(); }
+
+    /// Returns a string representation
+    virtual std::string to_string() const override;
+
+    //! @}
+    // =========================================================================
+
+    MI_DECLARE_CLASS()
+protected:
+
+    /// Protected destructor
+    virtual ~BufferedFileStream();
+
+    /// Start reading the block at offset \c pos into the back buffer
+    void read_ahead(size_t pos);
+
+    /// Wait for the back buffer and swap it with the front buffer
+    void swap_buffers();
+
+private:
+    fs::path m_path;
+    size_t m_size;
+    size_t m_buffer_size;
+
+    /// Only accessed by the pending read (if any)
+    std::ifstream m_file;
+
+    /// Block that is currently being consumed
+    std::unique_ptr<uint8_t[]> m_front;
+    /// File offset and length of the front block, and read position within it
+    size_t m_front_offset = 0, m_front_size = 0, m_front_pos = 0;
+
+    /// Block that is being read ahead
+    std::unique_ptr<uint8_t[]> m_back;
+    /// File offset of the back block
+    size_t m_back_offset = 0;
+    /// Pending read of the back block (returns its length)
+    std::future<size_t> m_pending;
+};
+
+NAMESPACE_END(mitsuba)
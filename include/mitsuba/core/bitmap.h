@@ -153,6 +153,23 @@ public:
          */
         BMP,
 
+        /**
+         * \brief DirectDraw Surface file format
+         *
+         * The following is supported:
+         * <ul>
+         *   <li>Loading of the top MIP level of 2D textures compressed using
+         *   BC6H (signed and unsigned), which are decoded into \ref Float16
+         *   RGB bitmaps</li>
+         *   <li>Loading of the top MIP level of 2D textures compressed using
+         *   BC7, which are decoded into \ref UInt8 RGBA bitmaps</li>
+         * </ul>
+         *
+         * The block compression format is recorded in the
+         * <tt>block_compression</tt> metadata field of the bitmap.
+         */
+        DDS,
+
         /// Unknown file format
         Unknown,
 
@@ -227,8 +244,16 @@ public:
      *
      * \param format
      *    File format to be read (PNG/EXR/Auto-detect ...)
+     *
+     * \param max_resolution
+     *    When nonzero, images whose width or height exceeds this value are
+     *    downsampled by an integer factor while loading (e.g. to quickly
+     *    preview scenes with many large textures). JPEG files are directly
+     *    decoded at a reduced resolution using libjpeg's DCT scaling, and
+     *    other formats are box-filtered after loading.
      */
-    Bitmap(Stream *stream, FileFormat format = FileFormat::Auto);
+    Bitmap(Stream *stream, FileFormat format = FileFormat::Auto,
+           uint32_t max_resolution = 0);
 
     /**
      * \brief Load a bitmap from a given filename
@@ -238,8 +263,13 @@ public:
      *
      * \param format
      *    File format to be read (PNG/EXR/Auto-detect ...)
+     *
+     * \param max_resolution
+     *    Maximum width and height of the loaded image (see the stream-based
+     *    constructor). The default value 0 loads the image at full resolution.
      */
-    Bitmap(const fs::path &path, FileFormat = FileFormat::Auto);
+    Bitmap(const fs::path &path, FileFormat = FileFormat::Auto,
+           uint32_t max_resolution = 0);
 
     /// Copy constructor (copies the image contents)
     Bitmap(const Bitmap &bitmap);
@@ -247,6 +277,31 @@ public:
     /// Move constructor
     Bitmap(Bitmap &&bitmap);
 
+    /**
+     * \brief Load several bitmaps from disk concurrently
+     *
+     * The files are decoded in parallel on Mitsuba's thread pool, which
+     * considerably speeds up the loading of texture-heavy scenes. OpenEXR
+     * files are additionally decompressed using multiple threads per file.
+     * The bitmaps are returned in the order of \c paths. If any of the
+     * files can't be loaded, the first error is re-thrown once all other
+     * files were processed.
+     *
+     * \param paths
+     *    Names of the files to be loaded
+     *
+     * \param format
+     *    File format to be read (PNG/EXR/Auto-detect ...)
+     *
+     * \param max_resolution
+     *    Maximum width and height of the loaded images (see the stream-based
+     *    constructor). The default value 0 loads the images at full resolution.
+     */
+    static std::vector<ref<Bitmap>>
+    read_batch(const std::vector<fs::path> &paths,
+               FileFormat format = FileFormat::Auto,
+               uint32_t max_resolution = 0);
+
     /// Return the pixel format of this bitmap
     PixelFormat pixel_format() const { return m_pixel_format; }
 
@@ -341,14 +396,18 @@ public:
      *        <li>PNG images: Controls how much libpng will attempt to compress
      *            the output (with 1 being the lowest and 9 denoting the
      *            highest compression). The default argument uses the
-     *            compression level 5. </li>
+     *            compression level 5. Large images are compressed in
+     *            parallel chunks.</li>
      *        <li>JPEG images: denotes the desired quality (between 0 and 100).
      *            The default argument (-1) uses the highest quality (100).</li>
      *        <li>OpenEXR images: denotes the quality level of the DWAB
      *            compressor, with higher values corresponding to a lower quality.
      *            A value of 45 is recommended as the default for lossy compression.
      *            The default argument (-1) causes the implementation to switch
-     *            to the lossless PIZ compressor.</li>
+     *            to the lossless PIZ compressor. A different method can be
+     *            requested via a \c compression metadata string (e.g.
+     *            <tt>zip</tt>, <tt>dwaa</tt>, or <tt>dwab</tt>), in which
+     *            case the quality only applies to the DWA compressors.</li>
      *    </ul>
      */
     void write(Stream *stream, FileFormat format = FileFormat::Auto,
@@ -371,14 +430,18 @@ public:
      *        <li>PNG images: Controls how much libpng will attempt to compress
      *            the output (with 1 being the lowest and 9 denoting the
      *            highest compression). The default argument uses the
-     *            compression level 5. </li>
+     *            compression level 5. Large images are compressed in
+     *            parallel chunks.</li>
      *        <li>JPEG images: denotes the desired quality (between 0 and 100).
      *            The default argument (-1) uses the highest quality (100).</li>
      *        <li>OpenEXR images: denotes the quality level of the DWAB
      *            compressor, with higher values corresponding to a lower quality.
      *            A value of 45 is recommended as the default for lossy compression.
      *            The default argument (-1) causes the implementation to switch
-     *            to the lossless PIZ compressor.</li>
+     *            to the lossless PIZ compressor. A different method can be
+     *            requested via a \c compression metadata string (e.g.
+     *            <tt>zip</tt>, <tt>dwaa</tt>, or <tt>dwab</tt>), in which
+     *            case the quality only applies to the DWA compressors.</li>
      *    </ul>
      */
     void write(const fs::path &path, FileFormat format = FileFormat::Auto,
@@ -599,7 +662,10 @@ public:
      void rebuild_struct(size_t channel_count = 0, const std::vector<std::string> &channel_names = {});
 
      /// Read a file from a stream
-     void read(Stream *stream, FileFormat format);
+     void read(Stream *stream, FileFormat format, uint32_t max_resolution = 0);
+
+     /// Downsample the image in-place by averaging blocks of \c factor^2 pixels
+     void downsample_box(uint32_t factor);
 
      /// Read a file encoded using the OpenEXR file format
      void read_exr(Stream *stream);
@@ -607,8 +673,14 @@ public:
      /// Write a file using the OpenEXR file format
      void write_exr(Stream *stream, int compression = -1) const;
 
-     /// Read a file encoded using the JPEG file format
-     void read_jpeg(Stream *stream);
+     /**
+      * \brief Read a file encoded using the JPEG file format
+      *
+      * When \c max_resolution is nonzero, the image is decoded at a reduced
+      * resolution (1/2, 1/4, or 1/8) that accounts for as much of the
+      * required downsampling as possible.
+      */
+     void read_jpeg(Stream *stream, uint32_t max_resolution = 0);
 
      /// Save a file using the JPEG file format
      void write_jpeg(Stream *stream, int quality) const;
@@ -619,6 +691,16 @@ public:
      /// Save a file using the PNG file format
      void write_png(Stream *stream, int quality) const;
 
+     /**
+      * \brief Save a file using the PNG file format, compressing chunks of
+      * rows in parallel
+      *
+      * Each chunk is deflated independently, using the end of the preceding
+      * chunk as its dictionary, and the results are concatenated into a
+      * single zlib stream (as done by \c pigz).
+      */
+     void write_png_parallel(Stream *stream, int quality) const;
+
      /// Read a file encoded using the PPM file format
      void read_ppm(Stream *stream);
 
@@ -631,6 +713,9 @@ public:
      /// Read a file encoded using the TGA file format
      void read_tga(Stream *stream);
 
+     /// Read a file encoded using the DDS file format
+     void read_dds(Stream *stream);
+
      /// Read a file encoded using the RGBE file format
      void read_rgbe(Stream *stream);
 
@@ -202,6 +202,22 @@ public:                                             \
     MI_VARIANT const Class *Name<Float, Spectrum>::class_() const { return m_class; }
 
 
+#if defined(MI_STATIC_PLUGINS)
+/* Plugins that are linked into libmitsuba name their entry points after the
+   CMake target (e.g. 'mi_plugin_name_diffuse'), which are then referenced
+   by the table in 'static_plugins.cpp' */
+#define MI_PLUGIN_ENTRY_2(Func, Target) mi_##Func##_##Target
+#define MI_PLUGIN_ENTRY_1(Func, Target) MI_PLUGIN_ENTRY_2(Func, Target)
+#define MI_PLUGIN_ENTRY(Func) MI_PLUGIN_ENTRY_1(Func, MI_PLUGIN_TARGET)
+
+/// Instantiate a Mitsuba plugin and provide its entry points
+#define MI_EXPORT_PLUGIN(Name, Descr)                                                             \
+    extern "C" {                                                                                   \
+        const char *MI_PLUGIN_ENTRY(plugin_name)() { return #Name; }                              \
+        const char *MI_PLUGIN_ENTRY(plugin_descr)() { return Descr; }                             \
+    }                                                                                              \
+    MI_INSTANTIATE_CLASS(Name)
+#else
 /// Instantiate and export a Mitsuba plugin
 #define MI_EXPORT_PLUGIN(Name, Descr)                                                             \
     extern "C" {                                                                                   \
@@ -209,6 +225,7 @@ public:                                             \
         MI_EXPORT const char *plugin_descr() { return Descr; }                                    \
     }                                                                                              \
     MI_INSTANTIATE_CLASS(Name)
+#endif
 
 NAMESPACE_BEGIN(detail)
 template <typename, typename Arg, typename = void>
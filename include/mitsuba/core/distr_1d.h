@@ -4,9 +4,135 @@
 #include <mitsuba/core/vector.h>
 #include <mitsuba/core/math.h>
 #include <drjit/dynamic.h>
+#include <vector>
 
 NAMESPACE_BEGIN(mitsuba)
 
+/**
+ * \brief Guide table that accelerates the search for the interval containing
+ * a value within a nondecreasing array
+ *
+ * The continuous distributions below locate intervals (within their nodes or
+ * their CDF) using a binary search, which requires a chain of dependent
+ * lookups per query. This table partitions the range of the array into
+ * equally sized cells and records the range of entries that fall into each
+ * one of them. A query is mapped to its cell in a single step, after which
+ * only the entries of that cell are searched using a fixed number of
+ * bisection steps. The result is identical to that of a binary search over
+ * the whole array.
+ */
+template <typename Float> struct IntervalGuide {
+    using FloatStorage  = DynamicBuffer<Float>;
+    using UInt32        = dr::uint32_array_t<Float>;
+    using UInt32Storage = DynamicBuffer<UInt32>;
+    using ScalarFloat   = dr::scalar_t<Float>;
+
+public:
+    /// Create an empty guide table
+    IntervalGuide() { }
+
+    /// Build the guide table for a nondecreasing array stored on the host
+    IntervalGuide(const ScalarFloat *data, size_t size) {
+        build(data, size);
+    }
+
+    /// Build the guide table for a nondecreasing array (may reside on the device)
+    IntervalGuide(const FloatStorage &data) {
+        if constexpr (dr::is_jit_v<Float>) {
+            FloatStorage data_host = dr::migrate(data, AllocType::Host);
+            dr::sync_thread();
+            build(data_host.data(), data_host.size());
+        } else {
+            build(data.data(), data.size());
+        }
+    }
+
+    /// Is the guide table empty/uninitialized?
+    bool empty() const { return m_offsets.empty(); }
+
+    /// Return the number of bisection steps performed by \ref find()
+    uint32_t iterations() const { return m_iterations; }
+
+    /**
+     * \brief Find the first index in <tt>[start, end)</tt> for which \c pred
+     * is false, or \c end if there is none
+     *
+     * This is equivalent to <tt>dr::binary_search(start, end, pred)</tt>,
+     * where the predicate must be of the form <tt>data[index] < value</tt>.
+     * Additional conditions may only change its result for entries that are
+     * equal to \c value. The predicate receives a mask of the lanes that
+     * are still searching.
+     */
+    template <typename Index, typename Value, typename Bound, typename Predicate>
+    Index find(const Value &value, const Bound &start, const Bound &end,
+               const Predicate &pred) const {
+        using Mask = dr::mask_t<Value>;
+
+        Index c  = cell<Value, Index>(value, m_min, m_scale, m_last_cell),
+              lo = dr::clamp(dr::gather<Index>(m_offsets, c), start, end),
+              hi = dr::clamp(dr::gather<Index>(m_offsets, c + 1u), start, end);
+
+        for (uint32_t i = 0; i < m_iterations; ++i) {
+            Mask search = Mask(lo < hi);
+            Index middle = (lo + hi) >> 1;
+            Mask cond = search && pred(middle, search);
+            lo = dr::select(cond, middle + 1u, lo);
+            hi = dr::select(search && !cond, middle, hi);
+        }
+
+        return lo;
+    }
+
+private:
+    /// Map a value to its cell (monotonic in \c value)
+    template <typename Value, typename Index, typename Scalar>
+    static Index cell(const Value &value, const Scalar &min,
+                      const Scalar &scale, uint32_t last_cell) {
+        Value t = dr::clamp((value - min) * scale, 0.f, (ScalarFloat) last_cell);
+        return dr::minimum(Index(t), last_cell);
+    }
+
+    void build(const ScalarFloat *data, size_t size) {
+        if (size == 0)
+            Throw("IntervalGuide: empty array!");
+
+        ScalarFloat min = data[0],
+                    range = data[size - 1] - data[0],
+                    scale = range > 0.f ? (ScalarFloat) size / range : 0.f;
+        uint32_t last_cell = (uint32_t) size - 1;
+
+        /* Count the entries of each cell. Since cell() is monotonic, the
+           entries of a cell are contiguous and bound its search range */
+        std::vector<uint32_t> offsets(size + 1, 0);
+        for (size_t i = 0; i < size; ++i)
+            offsets[cell<ScalarFloat, uint32_t>(data[i], min, scale, last_cell) + 1]++;
+
+        uint32_t max_count = 0;
+        for (size_t i = 0; i < size; ++i) {
+            max_count = std::max(max_count, offsets[i + 1]);
+            offsets[i + 1] += offsets[i];
+        }
+
+        m_iterations = 0;
+        while ((1ull << m_iterations) < (uint64_t) max_count + 1)
+            m_iterations++;
+
+        m_offsets = dr::load<UInt32Storage>(offsets.data(), size + 1);
+        m_min = min;
+        m_scale = scale;
+        m_last_cell = last_cell;
+        dr::make_opaque(m_min, m_scale);
+    }
+
+private:
+    /// Number of entries that map to the cells preceding each cell
+    UInt32Storage m_offsets;
+    Float m_min = 0.f;
+    Float m_scale = 0.f;
+    uint32_t m_last_cell = 0;
+    uint32_t m_iterations = 0;
+};
+
 /**
  * \brief Discrete 1D probability distribution
  *
@@ -16,12 +142,18 @@ NAMESPACE_BEGIN(mitsuba)
  * probability mass functions (PMFs) will automatically be normalized during
  * initialization. The associated scale factor can be retrieved using the
  * function \ref normalization().
+ *
+ * By default, samples are generated by inverting the cumulative distribution
+ * function using a binary search. Alternatively, an alias table can be
+ * enabled via \ref set_alias_table(), with which every sample costs a
+ * constant number of lookups regardless of the size of the distribution.
  */
 template <typename Value> struct DiscreteDistribution {
     using Float = std::conditional_t<dr::is_static_array_v<Value>,
                                      dr::value_t<Value>, Value>;
     using FloatStorage   = DynamicBuffer<Float>;
     using UInt32         = dr::uint32_array_t<Float>;
+    using UInt32Storage  = DynamicBuffer<UInt32>;
     using Index          = dr::uint32_array_t<Value>;
     using Mask           = dr::mask_t<Value>;
     using Vector2u       = dr::Array<UInt32, 2>;
@@ -57,8 +189,35 @@ public:
             compute_cdf();
         else
             compute_cdf_scalar(m_pmf.data(), m_pmf.size());
+
+        if (m_alias)
+            compute_alias_table();
     }
 
+    /**
+     * \brief Enable or disable sampling using an alias table
+     *
+     * When enabled, \ref sample() and its variants use Walker's alias method
+     * instead of inverting the CDF. This replaces the binary search (a chain
+     * of dependent lookups) by two lookups per sample. The table is built
+     * using Vose's algorithm and kept up to date by \ref update().
+     *
+     * Note that the resulting mapping from samples to indices is not
+     * monotonic, which reduces the benefit of stratified sample patterns.
+     */
+    void set_alias_table(bool enable) {
+        m_alias = enable;
+        if (enable && !m_pmf.empty())
+            compute_alias_table();
+        else if (!enable) {
+            m_alias_prob = FloatStorage();
+            m_alias_index = UInt32Storage();
+        }
+    }
+
+    /// Does this distribution sample using an alias table?
+    bool has_alias_table() const { return m_alias; }
+
     /// Return the unnormalized probability mass function
     FloatStorage &pmf() { return m_pmf; }
 
@@ -116,6 +275,9 @@ public:
     Index sample(Value sample, Mask active = true) const {
         MI_MASK_ARGUMENT(active);
 
+        if (m_alias)
+            return sample_alias(sample, active).first;
+
         sample *= m_sum;
 
         return dr::binary_search<Index>(
@@ -173,6 +335,9 @@ public:
     sample_reuse(Value value, Mask active = true) const {
         MI_MASK_ARGUMENT(active);
 
+        if (m_alias)
+            return sample_alias(value, active);
+
         Index index = sample(value, active);
 
         Value pmf = eval_pmf_normalized(index, active),
@@ -202,6 +367,11 @@ public:
     sample_reuse_pmf(Value value, Mask active = true) const {
         MI_MASK_ARGUMENT(active);
 
+        if (m_alias) {
+            auto [index, reused] = sample_alias(value, active);
+            return { index, reused, eval_pmf_normalized(index, active) };
+        }
+
         auto [index, pdf] = sample_pmf(value, active);
 
         Value pmf = eval_pmf_normalized(index, active),
@@ -263,12 +433,101 @@ private:
         dr::make_opaque(m_valid, m_sum, m_normalization);
     }
 
+    /**
+     * Sample the alias table. Returns the index and the sample value, which
+     * is re-scaled so that it can be reused as a uniform variate.
+     */
+    std::pair<Index, Value> sample_alias(Value value, Mask active) const {
+        Value scaled = dr::clamp(value, 0.f, 1.f) * m_alias_size;
+        Index index = dr::minimum(Index(scaled), m_alias_last);
+        Value offset = scaled - Value(index);
+
+        Value prob  = dr::gather<Value>(m_alias_prob, index, active);
+        Index alias = dr::gather<Index>(m_alias_index, index, active);
+
+        Mask redirect = offset >= prob;
+        Value reused = dr::select(redirect, (offset - prob) / (1.f - prob),
+                                  offset / prob);
+
+        return { dr::select(redirect, alias, index),
+                 dr::clamp(reused, 0.f, dr::OneMinusEpsilon<Value>) };
+    }
+
+    /// Build the alias table (Vose's algorithm) on the host
+    void compute_alias_table() {
+        size_t size = m_pmf.size();
+
+        FloatStorage pmf_host = m_pmf;
+        if constexpr (dr::is_jit_v<Float>) {
+            pmf_host = dr::migrate(m_pmf, AllocType::Host);
+            dr::sync_thread();
+        }
+        const ScalarFloat *pmf = pmf_host.data();
+
+        double sum = 0.0;
+        uint32_t last_nonzero = 0;
+        for (uint32_t i = 0; i < size; ++i) {
+            sum += (double) pmf[i];
+            if (pmf[i] > 0)
+                last_nonzero = i;
+        }
+
+        // Probabilities scaled so that their average is 1
+        std::vector<double> q(size);
+        std::vector<uint32_t> small, large, alias(size);
+        std::vector<ScalarFloat> prob(size);
+        double scale = (double) size / sum;
+        for (uint32_t i = 0; i < size; ++i) {
+            q[i] = (double) pmf[i] * scale;
+            (q[i] < 1.0 ? small : large).push_back(i);
+        }
+
+        while (!small.empty() && !large.empty()) {
+            uint32_t s = small.back(), l = large.back();
+            small.pop_back();
+
+            // Bin 's' is filled up using the excess mass of bin 'l'
+            prob[s] = (ScalarFloat) q[s];
+            alias[s] = l;
+            q[l] = (q[l] + q[s]) - 1.0;
+
+            if (q[l] < 1.0) {
+                large.pop_back();
+                small.push_back(l);
+            }
+        }
+
+        // Remaining bins are full (up to round-off errors)
+        for (uint32_t l : large) {
+            prob[l] = 1.f;
+            alias[l] = l;
+        }
+        for (uint32_t s : small) {
+            bool nonzero = pmf[s] > 0;
+            prob[s] = nonzero ? 1.f : 0.f;
+            alias[s] = nonzero ? s : last_nonzero;
+        }
+
+        m_alias_prob = dr::load<FloatStorage>(prob.data(), size);
+        m_alias_index = dr::load<UInt32Storage>(alias.data(), size);
+        m_alias_size = Float((ScalarFloat) size);
+        m_alias_last = UInt32((uint32_t) size - 1);
+        dr::make_opaque(m_alias_size, m_alias_last);
+    }
+
 private:
     FloatStorage m_pmf;
     FloatStorage m_cdf;
     Float m_sum = 0.f;
     Float m_normalization = 0.f;
     Vector2u m_valid;
+
+    /// Alias table: probability of keeping a bin, and its alias
+    bool m_alias = false;
+    FloatStorage m_alias_prob;
+    UInt32Storage m_alias_index;
+    Float m_alias_size = 0.f;
+    UInt32 m_alias_last = 0;
 };
 
 /**
@@ -425,10 +684,10 @@ public:
 
         sample *= m_integral;
 
-        Index index = dr::binary_search<Index>(
-            m_valid.x(), m_valid.y(),
-            [&](Index index) DRJIT_INLINE_LAMBDA {
-                Value value = dr::gather<Value>(m_cdf, index, active);
+        Index index = m_cdf_guide.template find<Index>(
+            sample, m_valid.x(), m_valid.y(),
+            [&](Index index, Mask search) DRJIT_INLINE_LAMBDA {
+                Value value = dr::gather<Value>(m_cdf, index, active && search);
                 if constexpr (!dr::is_jit_v<Float>) {
                     return value < sample;
                 } else {
@@ -470,10 +729,10 @@ public:
 
         sample *= m_integral;
 
-        Index index = dr::binary_search<Index>(
-            m_valid.x(), m_valid.y(),
-            [&](Index index) DRJIT_INLINE_LAMBDA {
-                Value value = dr::gather<Value>(m_cdf, index, active);
+        Index index = m_cdf_guide.template find<Index>(
+            sample, m_valid.x(), m_valid.y(),
+            [&](Index index, Mask search) DRJIT_INLINE_LAMBDA {
+                Value value = dr::gather<Value>(m_cdf, index, active && search);
                 if constexpr (!dr::is_jit_v<Float>) {
                     return value < sample;
                 } else {
@@ -537,6 +796,7 @@ private:
         m_max = dr::slice(dr::max(m_pdf));
         dr::make_opaque(m_valid, m_cdf, m_integral, m_normalization,
                         m_inv_interval_size);
+        m_cdf_guide = IntervalGuide<Float>(m_cdf);
     }
 
     void compute_cdf_scalar(const ScalarFloat *pdf, size_t size) {
@@ -588,6 +848,7 @@ private:
         m_inv_interval_size = dr::rcp(m_interval_size);
         m_interval_size_scalar = (ScalarFloat) interval_size;
         dr::make_opaque(m_integral, m_normalization, m_inv_interval_size);
+        m_cdf_guide = IntervalGuide<Float>(cdf.data(), size - 1);
     }
 
 private:
@@ -601,6 +862,8 @@ private:
     ScalarVector2f m_range { 0.f, 0.f };
     Vector2u m_valid;
     ScalarFloat m_max = 0.f;
+    /// Accelerates the search for the interval containing a sample
+    IntervalGuide<Float> m_cdf_guide;
 };
 
 /**
@@ -707,10 +970,10 @@ public:
 
         active &= x >= m_range.x() && x <= m_range.y();
 
-        Index index = dr::binary_search<Index>(
-            0, (uint32_t) m_nodes.size(),
-            [&](Index index) DRJIT_INLINE_LAMBDA {
-                return dr::gather<Value>(m_nodes, index, active) < x;
+        Index index = m_node_guide.template find<Index>(
+            x, 0u, (uint32_t) m_nodes.size(),
+            [&](Index index, Mask search) DRJIT_INLINE_LAMBDA {
+                return dr::gather<Value>(m_nodes, index, active && search) < x;
             }
         );
 
@@ -737,10 +1000,10 @@ public:
     Value eval_cdf(Value x, Mask active = true) const {
         MI_MASK_ARGUMENT(active);
 
-        Index index = dr::binary_search<Index>(
-            0, (uint32_t) m_nodes.size(),
-            [&](Index index) DRJIT_INLINE_LAMBDA {
-                return dr::gather<Value>(m_nodes, index, active) < x;
+        Index index = m_node_guide.template find<Index>(
+            x, 0u, (uint32_t) m_nodes.size(),
+            [&](Index index, Mask search) DRJIT_INLINE_LAMBDA {
+                return dr::gather<Value>(m_nodes, index, active && search) < x;
             }
         );
 
@@ -781,10 +1044,10 @@ public:
 
         sample *= m_integral;
 
-        Index index = dr::binary_search<Index>(
-            m_valid.x(), m_valid.y(),
-            [&](Index index) DRJIT_INLINE_LAMBDA {
-                Value value = dr::gather<Value>(m_cdf, index, active);
+        Index index = m_cdf_guide.template find<Index>(
+            sample, m_valid.x(), m_valid.y(),
+            [&](Index index, Mask search) DRJIT_INLINE_LAMBDA {
+                Value value = dr::gather<Value>(m_cdf, index, active && search);
                 if constexpr (!dr::is_jit_v<Float>) {
                     return value < sample;
                 } else {
@@ -829,10 +1092,10 @@ public:
 
         sample *= m_integral;
 
-        Index index = dr::binary_search<Index>(
-            m_valid.x(), m_valid.y(),
-            [&](Index index) DRJIT_INLINE_LAMBDA {
-                Value value = dr::gather<Value>(m_cdf, index, active);
+        Index index = m_cdf_guide.template find<Index>(
+            sample, m_valid.x(), m_valid.y(),
+            [&](Index index, Mask search) DRJIT_INLINE_LAMBDA {
+                Value value = dr::gather<Value>(m_cdf, index, active && search);
                 if constexpr (!dr::is_jit_v<Float>) {
                     return value < sample;
                 } else {
@@ -904,6 +1167,8 @@ private:
         dr::make_opaque(m_valid, m_integral, m_normalization);
         m_interval_size = dr::slice(dr::min(nodes_next - nodes_curr));
         m_max = dr::slice(dr::max(m_pdf));
+        m_node_guide = IntervalGuide<Float>(m_nodes);
+        m_cdf_guide = IntervalGuide<Float>(m_cdf);
     }
 
     void compute_cdf_scalar(const ScalarFloat *nodes, const ScalarFloat *pdf, size_t size) {
@@ -919,6 +1184,7 @@ private:
 
         double integral = 0.;
         std::vector<ScalarFloat> cdf(size - 1);
+        const ScalarFloat *nodes_start = nodes;
 
         m_max = pdf[0];
         for (size_t i = 0; i < size - 1; ++i) {
@@ -961,6 +1227,8 @@ private:
         m_integral = dr::gather<Float>(m_cdf, m_valid.y());
         m_normalization = dr::rcp(m_integral);
         dr::make_opaque(m_integral, m_normalization);
+        m_node_guide = IntervalGuide<Float>(nodes_start, size);
+        m_cdf_guide = IntervalGuide<Float>(cdf.data(), size - 1);
     }
 
 private:
@@ -973,6 +1241,8 @@ private:
     Vector2u m_valid;
     ScalarFloat m_interval_size = 0.f;
     ScalarFloat m_max = 0.f;
+    /// Accelerate the search for the interval containing a position or sample
+    IntervalGuide<Float> m_node_guide, m_cdf_guide;
 };
 
 template <typename Value>
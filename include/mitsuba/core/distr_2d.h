@@ -11,7 +11,9 @@
 
 #include <mitsuba/core/warp.h>
 #include <mitsuba/core/util.h>
+#include <mitsuba/core/stream.h>
 #include <drjit/dynamic.h>
+#include <drjit/half.h>
 #include <array>
 
 NAMESPACE_BEGIN(mitsuba)
@@ -481,6 +483,90 @@ public:
             level.ready();
     }
 
+    /**
+     * Construct a hierarchical sample warping scheme for floating point
+     * data of resolution \c size that is stored in a Dr.Jit array.
+     *
+     * In contrast to the constructor above, the MIP hierarchy is built using
+     * gather/scatter operations and parallel reductions on the Dr.Jit
+     * backend. When \c data resides on the GPU, the construction therefore
+     * doesn't require any transfer to the host. Conditional distributions
+     * are not supported by this constructor.
+     */
+    Hierarchical2D(const FloatStorage &data, const ScalarVector2u &size,
+                   bool normalize = true)
+        : Base(size, { }, { }) {
+        static_assert(Dimension == 0,
+                      "Hierarchical2D: conditional distributions must be "
+                      "constructed from host memory!");
+        using UInt32Storage = dr::uint32_array_t<FloatStorage>;
+        using Point2uStorage = Point<UInt32Storage, 2>;
+
+        if (dr::width(data) != dr::prod(size))
+            Throw("Hierarchical2D: the data array has the wrong size!");
+
+        // The linear interpolant has 'size-1' patches
+        ScalarVector2u n_patches = size - 1;
+        uint32_t max_level = math::log2i_ceil(dr::max(n_patches));
+
+        m_max_patch_index = n_patches - 1;
+
+        // Enumerate the 'res.x() * res.y()' entries of a level
+        auto coordinates = [](const ScalarVector2u &res) {
+            UInt32Storage i = dr::arange<UInt32Storage>(dr::prod(res)),
+                          y = i / res.x();
+            return Point2uStorage(i - y * res.x(), y);
+        };
+
+        // Integrate linear interpolant
+        Point2uStorage p = coordinates(n_patches);
+        UInt32Storage i = p.y() * size.x() + p.x();
+        FloatStorage avg = .25f * (dr::gather<FloatStorage>(data, i) +
+                                   dr::gather<FloatStorage>(data, i + 1u) +
+                                   dr::gather<FloatStorage>(data, i + size.x()) +
+                                   dr::gather<FloatStorage>(data, i + size.x() + 1u));
+
+        Level l1(n_patches + (n_patches & 1u), FloatStorage());
+        l1.data = dr::zeros<FloatStorage>(l1.size);
+        dr::scatter(l1.data, avg, l1.index(p));
+
+        // Normalize without reading the integral back to the host
+        FloatStorage l0 = data;
+        if (normalize) {
+            FloatStorage scale = (ScalarFloat) dr::prod(n_patches) / dr::sum(avg);
+            l0 *= scale;
+            l1.data *= scale;
+        }
+
+        m_levels.reserve(max_level + 2);
+        m_levels.emplace_back(size, std::move(l0));
+        m_levels.push_back(std::move(l1));
+
+        // Build a MIP hierarchy
+        ScalarVector2u level_size = n_patches;
+        for (uint32_t level = 2; level <= max_level + 1; ++level) {
+            const Level &prev = m_levels[level - 1];
+            level_size = dr::sr<1>(level_size + 1u);
+
+            p = coordinates(level_size);
+            i = prev.index(Point2uStorage(p.x() * 2u, p.y() * 2u));
+            FloatStorage value = dr::gather<FloatStorage>(prev.data, i) +
+                                 dr::gather<FloatStorage>(prev.data, i + 1u) +
+                                 dr::gather<FloatStorage>(prev.data, i + 2u) +
+                                 dr::gather<FloatStorage>(prev.data, i + 3u);
+
+            Level next(level_size + (level_size & 1u), FloatStorage());
+            next.data = dr::zeros<FloatStorage>(next.size);
+            dr::scatter(next.data, value, next.index(p));
+            m_levels.push_back(std::move(next));
+        }
+
+        if constexpr (dr::is_jit_v<Float>) {
+            for (auto &level : m_levels)
+                dr::make_opaque(level.data);
+        }
+    }
+
     /**
      * \brief Given a uniformly distributed 2D sample, draw a sample from the
      * distribution (parameterized by \c param if applicable)
@@ -574,6 +660,119 @@ public:
         };
     }
 
+    /**
+     * \brief Variant of \ref sample() that draws samples proportionally to
+     * the product of the distribution and a second, non-negative factor
+     *
+     * The second factor is only known through the function \c weight, which
+     * receives the lower and upper corner of a rectangular region of the unit
+     * square and must return a conservative upper bound of the factor on that
+     * region. During the hierarchical traversal, the four children of every
+     * MIP node are selected proportionally to their mass times this bound.
+     * Patches are sampled as in \ref sample(), and the returned density
+     * accounts for the modified selection probabilities (it matches \ref
+     * eval_product() when given the same function).
+     */
+    template <typename WeightFn>
+    std::pair<Point2f, Float> sample_product(Point2f sample,
+                                             const WeightFn &weight,
+                                             const Float *param = nullptr,
+                                             Mask active = true) const {
+        MI_MASK_ARGUMENT(active);
+
+        /// Find offset and interpolation weights wrt. conditional parameters
+        Float param_weight[2 * DimensionInt];
+        UInt32 slice_offset = interpolate_weights(param, param_weight, active);
+
+        // Avoid issues with roundoff error
+        sample = dr::clamp(sample, 0.f, 1.f);
+
+        // Hierarchical sample warping
+        Point2u offset = dr::zeros<Point2u>();
+        Float factor = 1.f;
+        for (int l = (int) m_levels.size() - 2; l > 0; --l) {
+            const Level &level = m_levels[l];
+
+            offset = dr::sl<1>(offset);
+
+            // Fetch values from next MIP level
+            UInt32 offset_i = level.index(offset) + slice_offset * level.size;
+
+            Float v00 = level.lookup(offset_i, m_param_strides,
+                                     param_weight, active);
+            offset_i += 1u;
+
+            Float v10 = level.lookup(offset_i, m_param_strides,
+                                     param_weight, active);
+            offset_i += 1u;
+
+            Float v01 = level.lookup(offset_i, m_param_strides,
+                                     param_weight, active);
+            offset_i += 1u;
+
+            Float v11 = level.lookup(offset_i, m_param_strides,
+                                     param_weight, active);
+
+            auto [w00, w10, w01, w11] = region_weights(l, offset, weight);
+            Float sum = v00 + v10 + v01 + v11;
+            v00 *= w00; v10 *= w10; v01 *= w01; v11 *= w11;
+
+            // Avoid issues with roundoff error
+            sample = dr::clamp(sample, 0.f, 1.f);
+
+            // Select the row
+            Float r0 = v00 + v10,
+                  r1 = v01 + v11;
+            sample.y() *= r0 + r1;
+            Mask y_mask = sample.y() > r0;
+            dr::masked(offset.y(), y_mask) += 1u;
+            dr::masked(sample.y(), y_mask) -= r0;
+            sample.y() /= dr::select(y_mask, r1, r0);
+
+            // Select the column
+            Float c0 = dr::select(y_mask, v01, v00),
+                  c1 = dr::select(y_mask, v11, v10);
+            sample.x() *= c0 + c1;
+            Mask x_mask = sample.x() > c0;
+            dr::masked(sample.x(), x_mask) -= c0;
+            sample.x() /= dr::select(x_mask, c1, c0);
+            dr::masked(offset.x(), x_mask) += 1u;
+
+            // Ratio of the modified and the original selection probability
+            Float w = dr::select(y_mask, dr::select(x_mask, w11, w01),
+                                         dr::select(x_mask, w10, w00)),
+                  norm = r0 + r1;
+            factor *= dr::select(norm > 0.f, w * sum / norm, 0.f);
+        }
+
+        const Level &level0 = m_levels[0];
+
+        UInt32 offset_i =
+            offset.x() + offset.y() * level0.width + slice_offset * level0.size;
+
+        // Fetch corners of bilinear patch
+        Float v00 = level0.lookup(offset_i, m_param_strides,
+                                  param_weight, active);
+
+        Float v10 = level0.lookup(offset_i + 1, m_param_strides,
+                                  param_weight, active);
+
+        Float v01 = level0.lookup(offset_i + level0.width, m_param_strides,
+                                  param_weight, active);
+
+        Float v11 = level0.lookup(offset_i + level0.width + 1, m_param_strides,
+                                  param_weight, active);
+
+        Float pdf;
+        std::tie(sample, pdf) =
+            warp::square_to_bilinear(v00, v10, v01, v11, sample);
+
+        return {
+            (Point2f(Point2i(offset)) + sample) * m_patch_size,
+            pdf * factor
+        };
+    }
+
     /// Inverse of the mapping implemented in ``sample()``
     std::pair<Point2f, Float> invert(Point2f sample,
                                      const Float *param = nullptr,
@@ -698,6 +897,64 @@ public:
         return warp::square_to_bilinear_pdf(v00, v10, v01, v11, pos);
     }
 
+    /**
+     * \brief Evaluate the density of \ref sample_product() at position \c
+     * pos. The distribution is parameterized by \c param if applicable.
+     */
+    template <typename WeightFn>
+    Float eval_product(Point2f pos, const WeightFn &weight,
+                       const Float *param = nullptr,
+                       Mask active = true) const {
+        /// Find offset and interpolation weights wrt. conditional parameters
+        Float param_weight[2 * DimensionInt];
+        UInt32 slice_offset = interpolate_weights(param, param_weight, active);
+
+        Float pdf = eval(pos, param, active);
+
+        // Avoid issues with roundoff error
+        pos = dr::clamp(pos, 0.f, 1.f) * m_inv_patch_size;
+        Point2u offset = dr::minimum(Point2u(Point2i(pos)), m_max_patch_index);
+
+        // Replay the hierarchical traversal in reverse direction
+        for (int l = 1; l < (int) m_levels.size() - 1; ++l) {
+            const Level &level = m_levels[l];
+
+            Point2u group = offset & ~1u;
+            UInt32 offset_i = level.index(group) + slice_offset * level.size;
+
+            Float v00 = level.lookup(offset_i, m_param_strides,
+                                     param_weight, active);
+            offset_i += 1u;
+
+            Float v10 = level.lookup(offset_i, m_param_strides,
+                                     param_weight, active);
+            offset_i += 1u;
+
+            Float v01 = level.lookup(offset_i, m_param_strides,
+                                     param_weight, active);
+            offset_i += 1u;
+
+            Float v11 = level.lookup(offset_i, m_param_strides,
+                                     param_weight, active);
+
+            auto [w00, w10, w01, w11] = region_weights(l, group, weight);
+
+            Mask x_mask = dr::neq(offset.x() & 1u, 0u),
+                 y_mask = dr::neq(offset.y() & 1u, 0u);
+
+            Float w = dr::select(y_mask, dr::select(x_mask, w11, w01),
+                                         dr::select(x_mask, w10, w00)),
+                  sum = v00 + v10 + v01 + v11,
+                  norm = v00 * w00 + v10 * w10 + v01 * w01 + v11 * w11;
+
+            pdf *= dr::select(norm > 0.f, w * sum / norm, 0.f);
+
+            offset = dr::sr<1>(offset);
+        }
+
+        return pdf;
+    }
+
     std::string to_string() const {
         std::ostringstream oss;
         oss << "Hierarchical2D" << Dimension << "[" << std::endl
@@ -731,6 +988,26 @@ public:
     }
 
 protected:
+    /**
+     * Evaluate the weight function of \ref sample_product() on the regions
+     * covered by the 2x2 children at position \c group of MIP level \c l
+     */
+    template <typename WeightFn>
+    std::array<Float, 4> region_weights(int l, const Point2u &group,
+                                        const WeightFn &weight) const {
+        ScalarVector2f extent = m_patch_size * (ScalarFloat) (1u << (l - 1));
+
+        Point2f p00 = Point2f(Point2i(group)) * extent,
+                p10 = p00 + ScalarVector2f(extent.x(), 0.f),
+                p01 = p00 + ScalarVector2f(0.f, extent.y()),
+                p11 = p00 + extent;
+
+        return { weight(p00, dr::minimum(p00 + extent, 1.f)),
+                 weight(p10, dr::minimum(p10 + extent, 1.f)),
+                 weight(p01, dr::minimum(p01 + extent, 1.f)),
+                 weight(p11, dr::minimum(p11 + extent, 1.f)) };
+    }
+
     struct Level {
         uint32_t size;
         uint32_t width;
@@ -751,6 +1028,10 @@ protected:
             memset(data.data(), 0, n * sizeof(ScalarFloat));
         }
 
+        /// Wrap an existing array (used for the construction on the device)
+        Level(ScalarVector2u res, FloatStorage &&data)
+            : size(dr::prod(res)), width(res.x()), data(std::move(data)) { }
+
         void ready() {
             if constexpr (dr::is_cuda_v<Float>)
                 data = dr::migrate(data, AllocType::Device);
@@ -849,6 +1130,9 @@ public:
         m_param_strides, m_param_values, m_slices, interpolate_weights
     )
 
+    using UInt16        = dr::replace_scalar_t<Float, uint16_t>;
+    using UInt16Storage = DynamicBuffer<UInt16>;
+
     Marginal2D() = default;
 
     /**
@@ -989,6 +1273,73 @@ public:
         m_data = dr::load<FloatStorage>(data_out.get(), m_slices * n_data);
     }
 
+    /**
+     * Construct a marginal sample warping scheme from the tables that were
+     * previously written to \c stream by \ref write(). This skips the
+     * construction of the CDFs. The remaining arguments must match those of
+     * the instance that wrote the tables.
+     */
+    Marginal2D(Stream *stream,
+               const ScalarVector2u &size,
+               const std::array<uint32_t, Dimension> &param_res = { },
+               const std::array<const ScalarFloat *, Dimension> &param_values = { },
+               bool normalize = true)
+        : Base(size, param_res, param_values), m_size(size), m_normalized(normalize) {
+        uint8_t half = 0;
+        stream->read(half);
+
+        size_t n_data = (size_t) m_slices * dr::prod(m_size);
+        if (half)
+            m_data_half = read_storage<UInt16Storage>(stream, n_data);
+        else
+            m_data = read_storage<FloatStorage>(stream, n_data);
+
+        m_marg_cdf = read_storage<FloatStorage>(stream);
+        m_cond_cdf = read_storage<FloatStorage>(stream);
+    }
+
+    /// Write the precomputed tables of this instance to a stream
+    void write(Stream *stream) const {
+        stream->write((uint8_t) (is_half_precision() ? 1 : 0));
+        if (is_half_precision())
+            write_storage(stream, m_data_half);
+        else
+            write_storage(stream, m_data);
+        write_storage(stream, m_marg_cdf);
+        write_storage(stream, m_cond_cdf);
+    }
+
+    /**
+     * \brief Store the density values in half precision
+     *
+     * This halves the memory footprint of the density values at the cost of
+     * precision. It is only supported by instances that were constructed
+     * with <tt>enable_sampling=false</tt>, i.e. that only interpolate the
+     * values via \ref eval().
+     */
+    void set_half_precision() {
+        if (!m_marg_cdf.empty())
+            Throw("Marginal2D::set_half_precision(): only supported when "
+                  "sampling is disabled!");
+        if (is_half_precision())
+            return;
+
+        auto &&data = dr::migrate(m_data, AllocType::Host);
+        if constexpr (dr::is_jit_v<Float>)
+            dr::sync_thread();
+
+        size_t count = data.size();
+        std::unique_ptr<uint16_t[]> values(new uint16_t[count]);
+        for (size_t i = 0; i < count; ++i)
+            values[i] = dr::half::float32_to_float16((float) data.data()[i]);
+
+        m_data_half = dr::load<UInt16Storage>(values.get(), count);
+        m_data = FloatStorage();
+    }
+
+    /// Are the density values stored in half precision?
+    bool is_half_precision() const { return !m_data_half.empty(); }
+
     /**
      * \brief Given a uniformly distributed 2D sample, draw a sample from the
      * distribution (parameterized by \c param if applicable)
@@ -1043,16 +1394,23 @@ public:
         if (Dimension != 0)
             index += slice_offset * size;
 
-        Float v00 = lookup(m_data, 0, index,
-                           size, param_weight, active),
-              v10 = lookup(m_data, 1, index,
-                           size, param_weight, active),
-              v01 = lookup(m_data, m_size.x(), index,
-                           size, param_weight, active),
-              v11 = lookup(m_data, m_size.x() + 1, index,
-                           size, param_weight, active);
+        auto interpolate = [&](const auto &data) {
+            Float v00 = lookup(data, 0, index,
+                               size, param_weight, active),
+                  v10 = lookup(data, 1, index,
+                               size, param_weight, active),
+                  v01 = lookup(data, m_size.x(), index,
+                               size, param_weight, active),
+                  v11 = lookup(data, m_size.x() + 1, index,
+                               size, param_weight, active);
+
+            return warp::square_to_bilinear_pdf(v00, v10, v01, v11, pos);
+        };
 
-        return warp::square_to_bilinear_pdf(v00, v10, v01, v11, pos);
+        if (is_half_precision())
+            return interpolate(m_data_half);
+        else
+            return interpolate(m_data);
     }
 
     std::string to_string() const {
@@ -1077,15 +1435,38 @@ public:
         }
         oss << "  storage = { " << m_slices << " slice" << (m_slices > 1 ? "s" : "")
             << ", ";
-        size_t size = m_slices * (dr::prod(m_size) * 2 + m_size.y());
-        oss << util::mem_string(size * sizeof(ScalarFloat)) << " }" << std::endl
+        size_t size = (m_data.size() + m_marg_cdf.size() + m_cond_cdf.size()) *
+                          sizeof(ScalarFloat) + m_data_half.size() * sizeof(uint16_t);
+        oss << util::mem_string(size) << " }" << std::endl
             << "]";
         return oss.str();
     }
 
 protected:
-    template <size_t Dim = Dimension>
-    MI_INLINE Float lookup(const FloatStorage &data,
+    template <typename Storage>
+    static void write_storage(Stream *stream, const Storage &storage) {
+        auto &&data = dr::migrate(storage, AllocType::Host);
+        if constexpr (dr::is_jit_v<Float>)
+            dr::sync_thread();
+        stream->write((uint64_t) data.size());
+        stream->write_array(data.data(), data.size());
+    }
+
+    template <typename Storage>
+    static Storage read_storage(Stream *stream, size_t expected = (size_t) -1) {
+        using Scalar = dr::scalar_t<Storage>;
+        uint64_t count = 0;
+        stream->read(count);
+        if (expected != (size_t) -1 && count != expected)
+            Throw("Marginal2D: the stored tables don't match the resolution "
+                  "of the distribution!");
+        std::unique_ptr<Scalar[]> values(new Scalar[count]);
+        stream->read_array(values.get(), count);
+        return dr::load<Storage>(values.get(), count);
+    }
+
+    template <size_t Dim = Dimension, typename Storage = FloatStorage>
+    MI_INLINE Float lookup(const Storage &data,
                             size_t offset,
                             UInt32 i0,
                             uint32_t size,
@@ -1103,7 +1484,11 @@ protected:
         } else {
             DRJIT_MARK_USED(param_weight);
             DRJIT_MARK_USED(size);
-            return dr::gather<Float>(data, i0 + offset, active);
+            if constexpr (std::is_same_v<Storage, UInt16Storage>)
+                return Float(math::half_to_float(
+                    UInt32(dr::gather<UInt16>(data, i0 + offset, active))));
+            else
+                return dr::gather<Float>(data, i0 + offset, active);
         }
     }
 
@@ -1448,6 +1833,9 @@ protected:
     /// Density values
     FloatStorage m_data;
 
+    /// Density values in half precision (replaces \ref m_data if set)
+    UInt16Storage m_data_half;
+
     /// Marginal and conditional PDFs
     FloatStorage m_marg_cdf;
     FloatStorage m_cond_cdf;
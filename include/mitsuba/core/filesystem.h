@@ -208,6 +208,11 @@ extern MI_EXPORT_LIB bool exists(const path& p) noexcept;
  */
 extern MI_EXPORT_LIB size_t file_size(const path& p);
 
+/** \brief Returns the time of the last modification of the file at <tt>p</tt>
+ * (in seconds since the epoch). The file must exist.
+ */
+extern MI_EXPORT_LIB int64_t last_write_time(const path& p);
+
 /** \brief Checks whether two paths refer to the same file system object.
  * Both must refer to an existing file or directory.
  * Symlinks are followed to determine equivalence.
@@ -237,6 +242,12 @@ extern MI_EXPORT_LIB bool remove(const path& p);
  */
 extern MI_EXPORT_LIB bool rename(const path& src, const path &dst);
 
+/** \brief Returns the names of the entries of the directory <tt>p</tt>
+ * (excluding '.' and '..') in unspecified order. Returns an empty list if
+ * <tt>p</tt> is not a readable directory.
+ */
+extern MI_EXPORT_LIB std::vector<path> directory_entries(const path& p);
+
 NAMESPACE_END(filesystem)
 
 NAMESPACE_END(mitsuba)
@@ -3,6 +3,9 @@
 #include <mitsuba/core/filesystem.h>
 #include <mitsuba/core/object.h>
 #include <iosfwd>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
 
 NAMESPACE_BEGIN(mitsuba)
 
@@ -12,6 +15,12 @@ NAMESPACE_BEGIN(mitsuba)
  * This convenience class looks for a file or directory given its name
  * and a set of search paths. The implementation walks through the
  * search paths in order and stops once the file is found.
+ *
+ * Successful lookups are cached, so that resolving the same name again
+ * doesn't query the file system (which can be slow on network storage). The
+ * cache is thread-safe and cleared whenever the list of search paths
+ * changes. Files that are moved or deleted after having been resolved
+ * require a call to \ref clear_cache().
  */
 class MI_EXPORT_LIB FileResolver : public Object {
 public:
@@ -27,14 +36,29 @@ public:
     /// Walk through the list of search paths and try to resolve the input path
     fs::path resolve(const fs::path &path) const;
 
+    /**
+     * \brief List the contents of all search paths
+     *
+     * Subsequent calls to \ref resolve() only check the search paths whose
+     * listing contains the first component of the requested path, which
+     * saves a file system query per search path that doesn't contain it.
+     * Entries that are created after this call are therefore only found
+     * once the listings are discarded, which happens when the search paths
+     * change or \ref clear_cache() is called.
+     */
+    void prefetch();
+
+    /// Discard all cached lookups and directory listings
+    void clear_cache();
+
     /// Return the number of search paths
     size_t size() const { return m_paths.size(); }
 
     /// Return an iterator at the beginning of the list of search paths
-    iterator begin() { return m_paths.begin(); }
+    iterator begin() { clear_cache(); return m_paths.begin(); }
 
     /// Return an iterator at the end of the list of search paths
-    iterator end()   { return m_paths.end(); }
+    iterator end()   { clear_cache(); return m_paths.end(); }
 
     /// Return an iterator at the beginning of the list of search paths (const)
     const_iterator begin() const { return m_paths.begin(); }
@@ -46,22 +70,28 @@ public:
     bool contains(const fs::path &p) const;
 
     /// Erase the entry at the given iterator position
-    void erase(iterator it) { m_paths.erase(it); }
+    void erase(iterator it) { m_paths.erase(it); clear_cache(); }
 
     /// Erase the search path from the list
     void erase(const fs::path &p);
 
     /// Clear the list of search paths
-    void clear() { m_paths.clear(); }
+    void clear() { m_paths.clear(); clear_cache(); }
 
     /// Prepend an entry at the beginning of the list of search paths
-    void prepend(const fs::path &path) { m_paths.insert(m_paths.begin(), path); }
+    void prepend(const fs::path &path) {
+        m_paths.insert(m_paths.begin(), path);
+        clear_cache();
+    }
 
     /// Append an entry to the end of the list of search paths
-    void append(const fs::path &path) { m_paths.push_back(path); }
+    void append(const fs::path &path) {
+        m_paths.push_back(path);
+        clear_cache();
+    }
 
     /// Return an entry from the list of search paths
-    fs::path &operator[](size_t index) { return m_paths[index]; }
+    fs::path &operator[](size_t index) { clear_cache(); return m_paths[index]; }
 
     /// Return an entry from the list of search paths (const)
     const fs::path &operator[](size_t index) const { return m_paths[index]; }
@@ -72,6 +102,13 @@ public:
     MI_DECLARE_CLASS()
 private:
     std::vector<fs::path> m_paths;
+
+    /// Guards the cached lookups
+    mutable std::mutex m_mutex;
+    /// Maps names to the paths they were resolved to
+    mutable std::unordered_map<fs::string_type, fs::path> m_cache;
+    /// Entries of each search path (empty unless \ref prefetch() was called)
+    std::vector<std::unordered_set<fs::string_type>> m_listings;
 };
 
 NAMESPACE_END(mitsuba)
@@ -18,11 +18,12 @@ class Object;
 class Class;
 template <typename> class ref;
 
-// class AnimatedTransform;
+class AnimatedTransform;
 class AnnotatedStream;
 class Appender;
 class ArgParser;
 class Bitmap;
+class BufferedFileStream;
 class DefaultFormatter;
 class DummyStream;
 class FileResolver;
@@ -34,6 +35,8 @@ class Mutex;
 class PluginManager;
 class Properties;
 class ScopedThreadEnvironment;
+class ServerSocket;
+class SocketStream;
 class Stream;
 class StreamAppender;
 class Struct;
@@ -4,6 +4,7 @@
 #include <functional>
 #include <tuple>
 #include <iostream>
+#include <cstring>
 
 NAMESPACE_BEGIN(mitsuba)
 
@@ -11,6 +12,28 @@ inline size_t hash_combine(size_t hash1, size_t hash2) {
     return hash2 ^ (hash1 + 0x9e3779b9 + (hash2 << 6) + (hash2 >> 2));
 }
 
+/**
+ * \brief Hash a contiguous region of memory
+ *
+ * Processes the input in 8-byte words using a 64-bit FNV-1a-style mixing
+ * step. This is not a cryptographic hash; it is meant for quickly detecting
+ * whether large buffers (e.g. mesh geometry) have changed.
+ */
+inline uint64_t hash_buffer(const void *ptr, size_t size, uint64_t seed = 0) {
+    const uint8_t *data = (const uint8_t *) ptr;
+    uint64_t value = seed ^ 0xcbf29ce484222325ull;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        memcpy(&word, data + i, sizeof(uint64_t));
+        value = (value ^ word) * 0x100000001b3ull;
+        value ^= value >> 32;
+    }
+    for (; i < size; ++i)
+        value = (value ^ data[i]) * 0x100000001b3ull;
+    return value;
+}
+
 template <typename T, std::enable_if_t<!std::is_enum_v<T>, int> = 0> size_t hash(const T &t) {
     return std::hash<T>()(t);
 }
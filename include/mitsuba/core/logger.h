@@ -76,6 +76,24 @@ public:
     /// Return the current error level
     LogLevel error_level() const;
 
+    /**
+     * \brief Enable or disable asynchronous logging
+     *
+     * In asynchronous mode, \ref log() formats the message on the calling
+     * thread and places it into a lock-free queue, from which a background
+     * thread forwards it to the appenders. This keeps slow appenders (e.g.
+     * file output at the \c Debug or \c Trace level) off the render
+     * threads. The queue is flushed before an error is raised, before
+     * progress messages, and when asynchronous mode is disabled.
+     */
+    void set_asynchronous(bool value);
+
+    /// Return whether asynchronous logging is enabled
+    bool asynchronous() const;
+
+    /// Forward all queued messages to the appenders (asynchronous mode)
+    void flush();
+
     /// Add an appender to this logger
     void add_appender(Appender *appender);
 
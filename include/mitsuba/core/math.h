@@ -430,5 +430,68 @@ template <typename Array> Array sample_shifted(const dr::value_t<Array> &sample)
         sample, std::make_index_sequence<Array::Size>());
 }
 
+/**
+ * \brief Convert the bit pattern of half precision values (stored in 32 bit
+ * integers) to single precision
+ */
+template <typename UInt32>
+dr::float32_array_t<UInt32> half_to_float(const UInt32 &h) {
+    using Float32 = dr::float32_array_t<UInt32>;
+    const uint32_t exp_mask = 0x7C00u << 13;
+
+    UInt32 o = (h & 0x7FFFu) << 13,
+           exp = o & exp_mask;
+    o += (127 - 15) << 23;
+
+    // Infinity/NaN: extend the exponent
+    o = dr::select(dr::eq(exp, exp_mask), o + ((128 - 16) << 23), o);
+
+    // Zero/denormal: renormalize
+    auto denormal = dr::eq(exp, 0u);
+    Float32 f = dr::reinterpret_array<Float32>(
+        dr::select(denormal, o + (1u << 23), o));
+    f = dr::select(denormal, f - dr::reinterpret_array<Float32>(UInt32(113u << 23)), f);
+
+    return dr::reinterpret_array<Float32>(
+        dr::reinterpret_array<UInt32>(f) | ((h & 0x8000u) << 16));
+}
+
+/**
+ * \brief Convert single precision values to the bit pattern of half
+ * precision values (stored in 32 bit integers)
+ *
+ * This is the inverse of \ref half_to_float(). Values are rounded to the
+ * nearest representable half precision value (ties to even), overflow
+ * produces infinities, and NaNs are preserved.
+ */
+template <typename Float32>
+dr::uint32_array_t<Float32> float_to_half(const Float32 &f) {
+    using UInt32 = dr::uint32_array_t<Float32>;
+    const uint32_t f32_infinity = 255u << 23,
+                   f16_max      = (127u + 16u) << 23,
+                   denorm_magic = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+
+    UInt32 u = dr::reinterpret_array<UInt32>(f),
+           sign = u & 0x80000000u;
+    u ^= sign;
+
+    // Overflow to infinity, NaNs become quiet NaNs
+    UInt32 inf_nan = dr::select(u > f32_infinity, UInt32(0x7E00u), UInt32(0x7C00u));
+
+    // Denormals: let the floating point addition perform the rounding
+    UInt32 denormal = dr::reinterpret_array<UInt32>(
+        dr::reinterpret_array<Float32>(u) +
+        dr::reinterpret_array<Float32>(UInt32(denorm_magic))) - denorm_magic;
+
+    // Normalized values: rebias the exponent and round the mantissa to even
+    UInt32 mant_odd = (u >> 13) & 1u,
+           normal = (u + (((15u - 127u) << 23) + 0xFFFu) + mant_odd) >> 13;
+
+    UInt32 result = dr::select(u >= f16_max, inf_nan,
+                               dr::select(u < (113u << 23), denormal, normal));
+
+    return result | (sign >> 16);
+}
+
 NAMESPACE_END(math)
 NAMESPACE_END(mitsuba)
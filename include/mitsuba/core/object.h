@@ -2,6 +2,8 @@
 
 #include <atomic>
 #include <stdexcept>
+#include <tuple>
+#include <vector>
 #include <mitsuba/core/class.h>
 
 NAMESPACE_BEGIN(mitsuba)
@@ -317,6 +319,26 @@ protected:
                                     const std::type_info &type) = 0;
 };
 
+/// An object, its depth within the scene graph, and the names of its modified parameters
+using ParameterUpdate = std::tuple<uint32_t, ref<Object>, std::vector<std::string>>;
+
+/**
+ * \brief Invoke \ref Object::parameters_changed() on a batch of objects
+ *
+ * The objects are notified from the bottom to the top of the scene graph
+ * (i.e. in order of decreasing depth), so that parent objects observe the
+ * updated state of their children. Objects at the same depth don't depend
+ * on each other and are updated in parallel. Every object receives a
+ * single notification, hence a scene that contains any number of modified
+ * shapes rebuilds or refits its acceleration data structure only once.
+ *
+ * This is the implementation of <tt>SceneParameters.update()</tt> in
+ * Python, which avoids the overheads of notifying the objects one at a
+ * time.
+ */
+extern MI_EXPORT_LIB void
+parameters_changed_batch(std::vector<ParameterUpdate> updates);
+
 /// Prints the canonical string representation of an object instance
 MI_EXPORT_LIB std::ostream& operator<<(std::ostream &os, const Object *object);
 
@@ -67,4 +67,18 @@ private:
     static ref<PluginManager> m_instance;
 };
 
+#if defined(MI_STATIC_PLUGINS)
+NAMESPACE_BEGIN(detail)
+/// Entry of the table of plugins that were linked into libmitsuba
+struct StaticPlugin {
+    const char *name;
+    const char *(*plugin_name)();
+    const char *(*plugin_descr)();
+};
+
+/// Table generated by CMake, terminated by an entry with a \c nullptr name
+extern const StaticPlugin static_plugins[];
+NAMESPACE_END(detail)
+#endif
+
 NAMESPACE_END(mitsuba)
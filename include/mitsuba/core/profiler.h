@@ -2,6 +2,10 @@
 
 #include <mitsuba/core/object.h>
 
+#if defined(MI_ENABLE_PROFILER)
+#  include <atomic>
+#endif
+
 #if defined(MI_ENABLE_ITTNOTIFY)
 #  include <ittnotify.h>
 #endif
@@ -84,8 +88,60 @@ extern MI_EXPORT_LIB __itt_string_handle *
     mitsuba_itt_phase[int(ProfilerPhase::ProfilerPhaseCount)];
 #endif
 
+#if defined(MI_ENABLE_PROFILER)
+/// Bit mask of the profiler phases that are active on a given thread
+struct ProfilerRecord {
+    std::atomic<uint64_t> flags { 0 };
+};
+
+/// Record of the current thread (lazily registered by \ref ScopedPhase)
+extern MI_EXPORT_LIB thread_local ProfilerRecord *profiler_record;
+#endif
+
+/**
+ * \brief Built-in sampling profiler
+ *
+ * When Mitsuba is compiled with \c MI_ENABLE_PROFILER, every \ref ScopedPhase
+ * sets a bit in a thread-local phase mask. A background thread periodically
+ * samples the masks of all threads and accumulates a histogram over them,
+ * which \ref report() turns into a hierarchical breakdown of where time was
+ * spent. Otherwise, the functions below do nothing.
+ */
+class MI_EXPORT_LIB Profiler {
+public:
+    static void static_initialization();
+    static void static_shutdown();
+
+    /// Discard all samples collected so far
+    static void reset();
+
+    /// Return a hierarchical breakdown of the samples collected so far
+    static std::string report();
+
+    /// Write the output of \ref report() to the log and reset the profiler
+    static void print_report();
+
+#if defined(MI_ENABLE_PROFILER)
+    /// Register the calling thread with the sampling thread
+    static ProfilerRecord *register_thread();
+#endif
+};
+
 struct ScopedPhase {
     ScopedPhase(ProfilerPhase phase) {
+#if defined(MI_ENABLE_PROFILER)
+        /* Only the owning thread writes to its record, and nested scopes of
+           the same phase leave the bit to the outermost one */
+        ProfilerRecord *record = profiler_record;
+        if (unlikely(!record))
+            record = Profiler::register_thread();
+        uint64_t flag = 1ull << (int) phase,
+                 flags = record->flags.load(std::memory_order_relaxed);
+        m_record = record;
+        m_flag = (flags & flag) ? 0 : flag;
+        record->flags.store(flags | flag, std::memory_order_relaxed);
+#endif
+
         /// Interface with various external visual profilers
 #if defined(MI_ENABLE_ITTNOTIFY)
         __itt_task_begin(mitsuba_itt_domain, __itt_null, __itt_null,
@@ -99,6 +155,12 @@ struct ScopedPhase {
     }
 
     ~ScopedPhase() {
+#if defined(MI_ENABLE_PROFILER)
+        m_record->flags.store(
+            m_record->flags.load(std::memory_order_relaxed) & ~m_flag,
+            std::memory_order_relaxed);
+#endif
+
 #if defined(MI_ENABLE_ITTNOTIFY)
         __itt_task_end(mitsuba_itt_domain);
 #endif
@@ -110,12 +172,12 @@ struct ScopedPhase {
 
     ScopedPhase(const ScopedPhase &) = delete;
     ScopedPhase &operator=(const ScopedPhase &) = delete;
-};
 
-class MI_EXPORT_LIB Profiler {
-public:
-    static void static_initialization();
-    static void static_shutdown();
+#if defined(MI_ENABLE_PROFILER)
+private:
+    ProfilerRecord *m_record;
+    uint64_t m_flag;
+#endif
 };
 
 NAMESPACE_END(mitsuba)
@@ -222,22 +222,19 @@ public:  // Type-specific getters and setters ----------------------------------
     /// Store a tensor handle in the Properties instance
     void set_tensor_handle(const std::string &name, const TensorHandle &value, bool error_duplicates = true);
 
-#if 0
     /// Store an animated transformation in the Properties instance
     void set_animated_transform(const std::string &name, ref<AnimatedTransform> value,
                                 bool error_duplicates = true);
-    /// Store a (constant) animated transformation in the Properties instance
-    void set_animated_transform(const std::string &name, const Transform4f &value,
-                                bool error_duplicates = true);
-    /// Retrieve an animated transformation
+    /**
+     * \brief Retrieve an animated transformation
+     *
+     * A regular 4x4 transformation is accepted as well and converted into a
+     * constant animation.
+     */
     ref<AnimatedTransform> animated_transform(const std::string &name) const;
     /// Retrieve an animated transformation (use default value if no entry exists)
-    ref<AnimatedTransform> animated_transform(
-            const std::string &name, ref<AnimatedTransform> def_val) const;
-    /// Retrieve an animated transformation (default value is a constant transform)
     ref<AnimatedTransform> animated_transform(const std::string &name,
-                                              const Transform<Point4f> &def_val) const;
-#endif
+                                              ref<AnimatedTransform> def_val) const;
 
     /// Store an arbitrary object in the Properties instance
     void set_object(const std::string &name, const ref<Object> &value, bool error_duplicates = true);
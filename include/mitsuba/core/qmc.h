@@ -97,6 +97,11 @@ public:
      * Halton and Hammersley sequence variants. It works like the normal
      * radical inverse function \ref eval(), except that every digit
      * is run through an extra scrambling permutation.
+     *
+     * Instead of processing one digit at a time, the implementation looks
+     * up groups of several digits in a precomputed table (see \ref
+     * digit_table()), which substantially reduces the number of divisions
+     * for small bases.
      */
     template <typename Float, typename UInt64 = dr::uint64_array_t<Float>>
     Float eval_scrambled(size_t base_index, UInt64 index) const {
@@ -104,31 +109,56 @@ public:
             Throw("eval(): out of bounds (prime base too large)");
 
         const PrimeBase base = m_base[base_index];
-        const uint16_t *perm = m_permutations[base_index];
+        const DigitTable table = m_digit_tables[base_index];
 
         UInt64 value(0),
-               divisor((uint64_t) base.value),
+               divisor((uint64_t) table.size),
                mask(0xffffu);
         Float factor(1.f),
-              recip(base.recip);
+              recip(table.recip);
 
         auto active = dr::neq(index, 0);
 
         while (dr::any(active)) {
             auto active_f = dr::reinterpret_array<dr::mask_t<Float>>(active);
-            UInt64 next = dr::idiv(index, base.divisor);
+            UInt64 next = dr::idiv(index, table.divisor);
             dr::masked(factor, active_f) = factor * recip;
-            UInt64 digit = index - next * divisor;
+            UInt64 digits = index - next * divisor;
             dr::masked(value, active) =
-                value * divisor + (dr::gather<UInt64, 2>(perm, digit, active) & mask);
+                value * divisor +
+                (dr::gather<UInt64, 2>(table.values, digits, active) & mask);
             index = next;
             active = dr::neq(index, 0);
         }
 
+        // Account for the infinite sequence of scrambled leading zeros
+        const uint16_t *perm = m_permutations[base_index];
         Float correction(base.recip * (Float) perm[0] / ((Float) 1 - base.recip));
         return dr::minimum(dr::OneMinusEpsilon<Float>, (Float(value) + correction) * factor);
     }
 
+    /**
+     * \brief Return the table that \ref eval_scrambled() uses to process
+     * several digits of the given prime base at once
+     *
+     * The table has \ref digit_table_size() entries. Entry \c i contains
+     * the scrambled digits of \c i in reverse order, i.e. the scrambled
+     * radical inverse of \c i multiplied by the table size.
+     */
+    const uint16_t *digit_table(size_t base_index) const {
+        return m_digit_tables[base_index].values;
+    }
+
+    /**
+     * \brief Return the size of the table returned by \ref digit_table()
+     *
+     * This is the largest power of the prime base that does not exceed
+     * 4096 entries (or the base itself, if larger).
+     */
+    uint32_t digit_table_size(size_t base_index) const {
+        return m_digit_tables[base_index].size;
+    }
+
     /// Return the permutation corresponding to the given prime number basis
     uint16_t *permutation(size_t basis) const {
         return m_permutations[basis];
@@ -174,12 +204,22 @@ private:
 #  pragma pack(pop)
 #endif
 
+    /// Lookup table to process several digits of a prime base at once
+    struct DigitTable {
+        dr::divisor<uint64_t> divisor;
+        uint32_t size;
+        float recip;
+        const uint16_t *values;
+    };
+
     size_t m_base_count = 0;
     std::unique_ptr<PrimeBase[]> m_base;
     std::unique_ptr<uint16_t[]> m_permutation_storage;
     std::unique_ptr<uint16_t*[]> m_permutations;
     std::unique_ptr<uint16_t[]> m_inv_permutation_storage;
     std::unique_ptr<uint16_t*[]> m_inv_permutations;
+    std::unique_ptr<DigitTable[]> m_digit_tables;
+    std::unique_ptr<uint16_t[]> m_digit_table_storage;
     int m_scramble;
 };
 
@@ -236,4 +276,48 @@ Float sobol_2(UInt index, UInt scramble = 0) {
     }
 }
 
+/// Reverse the order of the bits of a 32 bit unsigned integer
+template <typename UInt32> UInt32 reverse_bits_32(UInt32 x) {
+    x = (x << 16) | (x >> 16);
+    x = ((x & 0x00ff00ffu) << 8) | ((x & 0xff00ff00u) >> 8);
+    x = ((x & 0x0f0f0f0fu) << 4) | ((x & 0xf0f0f0f0u) >> 4);
+    x = ((x & 0x33333333u) << 2) | ((x & 0xccccccccu) >> 2);
+    x = ((x & 0x55555555u) << 1) | ((x & 0xaaaaaaaau) >> 1);
+    return x;
+}
+
+/**
+ * \brief Hash-based Owen scrambling of a 32 bit fixed point value in base 2
+ *
+ * Every bit of the result is flipped depending on \c seed and on all of the
+ * more significant bits of \c x, which corresponds to a nested uniform
+ * scramble. This is the improved Laine-Karras hash proposed in "Practical
+ * Hash-based Owen Scrambling" by Brent Burley (JCGT 2020).
+ *
+ * When applied to a sample index (rather than a sample value), this
+ * function shuffles the order of the points of a sequence while mapping
+ * every aligned block of <tt>2^m</tt> indices onto another such block.
+ */
+template <typename UInt32> UInt32 owen_scramble_2(UInt32 x, UInt32 seed) {
+    x = reverse_bits_32(x);
+    x ^= x * 0x3d20adeau;
+    x += seed;
+    x *= (seed >> 16) | 1u;
+    x ^= x * 0x05526c56u;
+    x ^= x * 0x53a22864u;
+    return reverse_bits_32(x);
+}
+
+/// Second dimension of the Sobol' sequence as a 32 bit fixed point value
+template <typename UInt32> UInt32 sobol_2_bits(UInt32 index) {
+    UInt32 v = 1u << 31, result = 0u;
+    dr::Loop<dr::mask_t<UInt32>> loop("sobol_2_bits", v, result, index);
+    while (loop(dr::neq(index, 0u))) {
+        dr::masked(result, dr::eq(index & 1u, 1u)) ^= v;
+        index >>= 1;
+        v ^= v >> 1;
+    }
+    return result;
+}
+
 NAMESPACE_END(mitsuba)
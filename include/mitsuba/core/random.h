@@ -173,6 +173,52 @@ auto sample_tea_float(UInt v0, UInt v1, int rounds = 4) {
         return sample_tea_float64(v0, v1, rounds);
 }
 
+/**
+ * \brief Counter-based pseudorandom number generation using the Philox4x32
+ * block cipher by John Salmon, Mark Moraes, Ron Dror, and David Shaw.
+ *
+ * For details, refer to "Parallel Random Numbers: As Easy as 1, 2, 3" by the
+ * same authors. In contrast to a stateful generator such as \ref PCG32, every
+ * output is a pure function of its inputs, which means that the counter can
+ * be reconstructed on the fly rather than having to be stored.
+ *
+ * \param counter
+ *     Four 32-bit values to be encrypted (e.g. the sequence index, the
+ *     sample index and the requested random number dimension)
+ * \param key
+ *     Two 32-bit values specifying the key (e.g. a seed)
+ * \param rounds
+ *     How many rounds should be executed? The default of 10 passes all tests
+ *     of the BigCrush suite with a safety margin.
+ * \return
+ *     Four uniformly distributed 32-bit integers
+ */
+template <typename UInt32>
+std::array<UInt32, 4> philox_4x32(std::array<UInt32, 4> counter,
+                                  std::array<UInt32, 2> key, int rounds = 10) {
+    static_assert(
+        std::is_same_v<dr::scalar_t<UInt32>, uint32_t>,
+        "philox_4x32(): template type should be a 32 bit unsigned integer!");
+
+    auto &[c0, c1, c2, c3] = counter;
+    auto &[k0, k1] = key;
+
+    DRJIT_NOUNROLL for (int i = 0; i < rounds; ++i) {
+        UInt32 hi0 = dr::mulhi(c0, 0xd2511f53u), lo0 = c0 * 0xd2511f53u,
+               hi1 = dr::mulhi(c2, 0xcd9e8d57u), lo1 = c2 * 0xcd9e8d57u;
+
+        c0 = hi1 ^ c1 ^ k0;
+        c1 = lo1;
+        c2 = hi0 ^ c3 ^ k1;
+        c3 = lo0;
+
+        k0 += 0x9e3779b9u;
+        k1 += 0xbb67ae85u;
+    }
+
+    return counter;
+}
+
 /**
  * \brief Generate pseudorandom permutation vector using a shuffling network
  *
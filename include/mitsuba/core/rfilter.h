@@ -10,6 +10,9 @@ NAMESPACE_BEGIN(mitsuba)
 /// Reconstruction filters will be tabulated at this resolution
 #define MI_FILTER_RESOLUTION 31
 
+/// Number of quantized subpixel offsets in tabulated splatting weight tables
+#define MI_FILTER_SUBPIXEL_RESOLUTION 64
+
 /**
  * \brief When resampling data to a different resolution using \ref
  * Resampler::resample(), this enumeration specifies how lookups
@@ -44,6 +47,11 @@ enum class FilterBoundaryCondition {
  * Because image filters are generally too expensive to evaluate for each
  * sample, the implementation of this class internally precomputes an discrete
  * representation, whose resolution given by \ref MI_FILTER_RESOLUTION.
+ *
+ * When the filter is created with <tt>tabulate=true</tt>, it furthermore
+ * precomputes a separable table of splatting weights indexed by the
+ * quantized subpixel offset of a sample (see \ref weight_table()), which
+ * \ref ImageBlock::put() then uses instead of evaluating the filter.
  */
 template <typename Float, typename Spectrum>
 class MI_EXPORT_LIB ReconstructionFilter : public Object {
@@ -74,6 +82,39 @@ public:
         }
     }
 
+    /// Does this filter provide a tabulated splatting weight table?
+    bool has_weight_table() const { return m_weight_taps != 0; }
+
+    /**
+     * \brief Return the number of taps per row of the splatting weight table
+     *
+     * This equals <tt>2 * n + 1</tt>, where <tt>n = ceil(radius - 0.5)</tt>
+     * is the number of pixels that a sample can influence on either side of
+     * the pixel containing it. The function returns zero when the filter was
+     * not created with <tt>tabulate=true</tt>.
+     */
+    uint32_t weight_taps() const { return m_weight_taps; }
+
+    /**
+     * \brief Return the separable splatting weight table
+     *
+     * The table has \ref MI_FILTER_SUBPIXEL_RESOLUTION rows of \ref
+     * weight_taps() entries. Row \c j stores the filter weights of a sample
+     * whose fractional pixel coordinate \c f falls into the interval
+     * <tt>[j, j + 1) / MI_FILTER_SUBPIXEL_RESOLUTION</tt>, evaluated at the
+     * centers of the pixels <tt>-n .. n</tt> relative to the pixel containing
+     * the sample. The same table is used along both image axes.
+     */
+    const DynamicBuffer<Float> &weight_table() const { return m_weight_table; }
+
+    /// Return the weight table row associated with a fractional pixel coordinate
+    template <typename Value>
+    MI_INLINE dr::uint32_array_t<Value> weight_table_row(const Value &f) const {
+        using UInt = dr::uint32_array_t<Value>;
+        return dr::minimum(UInt(dr::maximum(f, Value(0.f)) * MI_FILTER_SUBPIXEL_RESOLUTION),
+                           UInt(MI_FILTER_SUBPIXEL_RESOLUTION - 1));
+    }
+
     MI_DECLARE_CLASS()
 protected:
     /// Create a new reconstruction filter
@@ -89,6 +130,9 @@ protected:
     ScalarFloat m_radius, m_scale_factor;
     std::vector<ScalarFloat> m_values;
     uint32_t m_border_size;
+    bool m_tabulate;
+    uint32_t m_weight_taps;
+    DynamicBuffer<Float> m_weight_table;
 };
 
 /**
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <mitsuba/core/object.h>
+#include <mitsuba/core/filesystem.h>
+#include <mitsuba/core/struct.h>
+#include <mitsuba/core/vector.h>
+#include <memory>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**
+ * \brief Incrementally writes an OpenEXR image in increasing scanline order
+ *
+ * The file header is written upon construction, and the image is then
+ * appended in bands of rows via \ref write_rows(). Only the band being
+ * written needs to be resident in memory, which makes it possible to produce
+ * images that are much larger than the available memory.
+ *
+ * The channels of the image are given by the fields of a \ref Struct
+ * (supported types: \c float16, \c float32, and \c uint32). Every band must
+ * be a \ref Bitmap of the same width with an identical layout.
+ */
+class MI_EXPORT_LIB ScanlineWriter : public Object {
+public:
+    /// Create the file and write its header
+    ScanlineWriter(const fs::path &filename, const ScalarVector2u &size,
+                   const Struct *format);
+
+    /// Append the rows of \c band below the ones written so far
+    void write_rows(const Bitmap *band);
+
+    /// Return the number of rows written so far
+    uint32_t rows_written() const;
+
+    /// Return the resolution of the image
+    const ScalarVector2u &size() const;
+
+    /// Return the associated filename
+    const fs::path &filename() const;
+
+    /// Flush and close the file (called automatically by the destructor)
+    void close();
+
+    std::string to_string() const override;
+
+    MI_DECLARE_CLASS()
+protected:
+    virtual ~ScanlineWriter();
+
+private:
+    struct ScanlineWriterPrivate;
+    std::unique_ptr<ScanlineWriterPrivate> d;
+};
+
+NAMESPACE_END(mitsuba)
@@ -70,6 +70,135 @@ NAMESPACE_BEGIN(spline)
     Value d1          = dr::select(mask_up_idx,  width * (f2 - f0) /             \
                                                      (x2 - x0), f1 - f0);
 
+// =======================================================================
+//! @{ \name Acceleration of interval searches
+// =======================================================================
+
+/**
+ * \brief Uniform grid that accelerates the interval searches of
+ * \a non-uniformly sampled splines
+ *
+ * The functions below that operate on non-uniformly spaced data (e.g. \ref
+ * eval_1d() or \ref sample_1d()) must find the interval containing a query
+ * within a monotonic array (the nodes, function values, or the CDF depending
+ * on the function), which normally requires a binary search with a
+ * logarithmic number of dependent gathers. This class partitions the range of
+ * such an array into equally sized cells and records the range of entries
+ * that fall into each one of them. A query is then mapped to its cell in
+ * constant time, after which only the few entries of that cell must be
+ * searched. The number of search steps is uniform across all queries, which
+ * keeps packet and JIT arrays coherent.
+ *
+ * The result is identical to that of \ref math::find_interval(). The index
+ * does not store a copy of the array, which must be passed to \ref find()
+ * again and remain unchanged.
+ */
+template <typename Float> class IntervalIndex {
+public:
+    IntervalIndex() = default;
+
+    /**
+     * \brief Build the index for a monotonically increasing array
+     *
+     * \param data
+     *      Array containing \c size entries in increasing order
+     * \param size
+     *      Denotes the size of the \c data array
+     * \param cells
+     *      Number of grid cells. The default value of zero creates one cell
+     *      per interval.
+     */
+    IntervalIndex(const Float *data, uint32_t size, uint32_t cells = 0) {
+        if (size < 2)
+            Throw("IntervalIndex: the array must have at least two entries!");
+
+        m_size  = size;
+        m_cells = cells > 0 ? cells : size - 1;
+        m_min   = data[0];
+
+        Float range = data[size - 1] - data[0];
+        m_scale = range > 0 ? Float(m_cells) / range : Float(0);
+
+        /* Count the interior entries that map to each cell. Since cell() is
+           monotonic, the entries of a cell form a contiguous range */
+        m_offsets.assign(m_cells + 1, 0);
+        for (uint32_t i = 1; i < size - 1; ++i)
+            m_offsets[cell(data[i]) + 1]++;
+
+        uint32_t max_count = 0;
+        for (uint32_t i = 0; i < m_cells; ++i) {
+            max_count = std::max(max_count, m_offsets[i + 1]);
+            m_offsets[i + 1] += m_offsets[i];
+        }
+
+        /* Bisection steps needed to search the fullest cell */
+        m_iterations = 0;
+        while ((1ull << m_iterations) < (uint64_t) max_count + 1)
+            m_iterations++;
+    }
+
+    /**
+     * \brief Find the interval containing \c x
+     *
+     * Returns the largest index <tt>i</tt> in <tt>[0, size-2]</tt> such that
+     * <tt>data[i] <= x</tt>, or zero if there is no such entry.
+     *
+     * \param data
+     *      The array that was used to build the index
+     * \param x
+     *      Query point
+     * \param active
+     *      Mask of active lanes
+     */
+    template <typename Index, typename Value>
+    Index find(const Float *data, const Value &x,
+               dr::mask_t<Value> active = true) const {
+        using Mask = dr::mask_t<Value>;
+
+        Index c  = cell<Value, Index>(x),
+              lo = dr::gather<Index>(m_offsets.data(), c, active),
+              hi = dr::gather<Index>(m_offsets.data(), c + 1, active);
+
+        /* The interval lies in [lo, hi], bisect the entries of the cell */
+        for (uint32_t i = 0; i < m_iterations; ++i) {
+            Mask search = active && Mask(lo < hi);
+            Index mid = (lo + hi + 1) >> 1;
+            Mask left = dr::gather<Value>(data, mid, search) <= x;
+            lo = dr::select(search && left, mid, lo);
+            hi = dr::select(search && !left, mid - 1, hi);
+        }
+
+        return lo;
+    }
+
+    /// Return the size of the array that was used to build the index
+    uint32_t size() const { return m_size; }
+
+    /// Return the number of grid cells
+    uint32_t cells() const { return m_cells; }
+
+    /// Return the number of bisection steps performed by \ref find()
+    uint32_t iterations() const { return m_iterations; }
+
+private:
+    /// Map a position to its grid cell (monotonic in \c x)
+    template <typename Value, typename Index = dr::uint32_array_t<Value>>
+    Index cell(const Value &x) const {
+        Value t = dr::clamp((x - m_min) * m_scale, Value(0.f),
+                            Value(Float(m_cells - 1)));
+        return dr::minimum(Index(t), Index(m_cells - 1));
+    }
+
+private:
+    /// Number of interior entries that map to cells preceding each cell
+    std::vector<uint32_t> m_offsets;
+    uint32_t m_size = 0, m_cells = 0, m_iterations = 0;
+    Float m_min = 0, m_scale = 0;
+};
+
+// =======================================================================
+/*! @} */
+
 // =======================================================================
 //! @{ \name Functions for evaluating and sampling cubic Catmull-Rom splines
 // =======================================================================
@@ -259,6 +388,9 @@ Value eval_1d(Float min, Float max, const Float *values,
  *      Denotes the size of the \c nodes and \c values array
  * \param x
  *      Evaluation point
+ * \param index
+ *      Optional \ref IntervalIndex built over \c nodes, which replaces
+ *      the binary search for the interval containing \c x
  * \remark
  *      The Python API lacks the \c size parameter, which is inferred
  *      automatically from the size of the input array
@@ -271,7 +403,8 @@ Value eval_1d(Float min, Float max, const Float *values,
  */
 template <bool Extrapolate = false, typename Value, typename Float>
 Value eval_1d(const Float *nodes, const Float *values,
-              uint32_t size, Value x) {
+              uint32_t size, Value x,
+              const IntervalIndex<Float> *index = nullptr) {
     using Mask = dr::mask_t<Value>;
     using Index = dr::uint32_array_t<Value>;
 
@@ -282,11 +415,15 @@ Value eval_1d(const Float *nodes, const Float *values,
         return dr::zeros<Value>();
 
     /* Find the index of the left node in the queried subinterval */
-    Index idx = math::find_interval<Index>(size,
-        [&](Index idx) {
-            return dr::gather<Value>(nodes, idx, mask_valid) <= x;
-        }
-    );
+    Index idx;
+    if (index)
+        idx = index->template find<Index>(nodes, x);
+    else
+        idx = math::find_interval<Index>(size,
+            [&](Index idx) {
+                return dr::gather<Value>(nodes, idx, mask_valid) <= x;
+            }
+        );
 
     GET_SPLINE_NONUNIFORM(idx);
 
@@ -395,12 +532,16 @@ void integrate_1d(const Value *nodes, const Value *values,
  *      Input parameter for the inversion
  * \param eps
  *      Error tolerance (default: 1e-6f)
+ * \param index
+ *      Optional \ref IntervalIndex built over \c values, which replaces
+ *      the binary search for the interval containing \c y
  * \return
  *      The spline parameter \c t such that <tt>eval_1d(..., t)=y</tt>
  */
 template <typename Value, typename Float>
 Value invert_1d(Float min, Float max, const Float *values, uint32_t size,
-                Value y, Float eps = 1e-6f) {
+                Value y, Float eps = 1e-6f,
+                const IntervalIndex<Float> *index = nullptr) {
     using Mask = dr::mask_t<Value>;
     using Index = dr::uint32_array_t<Value>;
 
@@ -418,11 +559,15 @@ Value invert_1d(Float min, Float max, const Float *values, uint32_t size,
 
     /* Map y to a spline interval by searching through the
        'values' array (which is assumed to be monotonic) */
-    Index idx = math::find_interval<Index>(size,
-        [&](Index idx) {
-            return dr::gather<Value>(values, idx, in_bounds) <= y;
-        }
-    );
+    Index idx;
+    if (index)
+        idx = index->template find<Index>(values, y, in_bounds);
+    else
+        idx = math::find_interval<Index>(size,
+            [&](Index idx) {
+                return dr::gather<Value>(values, idx, in_bounds) <= y;
+            }
+        );
 
     const Float width = Float(max - min) / (size - 1);
     GET_SPLINE_UNIFORM(idx);
@@ -484,12 +629,16 @@ Value invert_1d(Float min, Float max, const Float *values, uint32_t size,
  *      Input parameter for the inversion
  * \param eps
  *      Error tolerance (default: 1e-6f)
+ * \param index
+ *      Optional \ref IntervalIndex built over \c values, which replaces
+ *      the binary search for the interval containing \c y
  * \return
  *      The spline parameter \c t such that <tt>eval_1d(..., t)=y</tt>
  */
 template <typename Value, typename Float>
 Value invert_1d(const Float *nodes, const Float *values, uint32_t size,
-                Value y, Float eps = 1e-6f) {
+                Value y, Float eps = 1e-6f,
+                const IntervalIndex<Float> *index = nullptr) {
     using Mask = dr::mask_t<Value>;
     using Index = dr::uint32_array_t<Value>;
 
@@ -509,11 +658,15 @@ Value invert_1d(const Float *nodes, const Float *values, uint32_t size,
 
     /* Map y to a spline interval by searching through the
        'values' array (which is assumed to be monotonic) */
-    Index idx = math::find_interval<Index>(size,
-        [&](Index idx) {
-            return dr::gather<Value>(values, idx, in_bounds) <= y;
-        }
-    );
+    Index idx;
+    if (index)
+        idx = index->template find<Index>(values, y, in_bounds);
+    else
+        idx = math::find_interval<Index>(size,
+            [&](Index idx) {
+                return dr::gather<Value>(values, idx, in_bounds) <= y;
+            }
+        );
 
     GET_SPLINE_NONUNIFORM(idx);
 
@@ -576,6 +729,9 @@ Value invert_1d(const Float *nodes, const Float *values, uint32_t size,
  *      A uniformly distributed random sample in the interval <tt>[0,1]</tt>
  * \param eps
  *      Error tolerance (default: 1e-6f)
+ * \param index
+ *      Optional \ref IntervalIndex built over \c cdf, which replaces
+ *      the binary search for the interval containing the scaled \c sample
  * \return
  *      1. The sampled position
  *      2. The value of the spline evaluated at the sampled position
@@ -585,7 +741,8 @@ Value invert_1d(const Float *nodes, const Float *values, uint32_t size,
 template <typename Value, typename Float>
 std::tuple<Value, Value, Value>
 sample_1d(Float min, Float max, const Float *values, const Float *cdf,
-          uint32_t size, Value sample, Float eps = 1e-6f) {
+          uint32_t size, Value sample, Float eps = 1e-6f,
+          const IntervalIndex<Float> *index = nullptr) {
     using Mask = dr::mask_t<Value>;
     using Index = dr::uint32_array_t<Value>;
 
@@ -603,11 +760,15 @@ sample_1d(Float min, Float max, const Float *values, const Float *cdf,
 
     /* Map y to a spline interval by searching through the
        monotonic 'cdf' array */
-    Index idx = math::find_interval<Index>(size,
-        [&](Index idx) {
-            return dr::gather<Value>(cdf, idx) <= sample;
-        }
-    );
+    Index idx;
+    if (index)
+        idx = index->template find<Index>(cdf, sample);
+    else
+        idx = math::find_interval<Index>(size,
+            [&](Index idx) {
+                return dr::gather<Value>(cdf, idx) <= sample;
+            }
+        );
 
     GET_SPLINE_UNIFORM(idx);
 
@@ -674,6 +835,9 @@ sample_1d(Float min, Float max, const Float *values, const Float *cdf,
  *      A uniformly distributed random sample in the interval <tt>[0,1]</tt>
  * \param eps
  *      Error tolerance (default: 1e-6f)
+ * \param index
+ *      Optional \ref IntervalIndex built over \c cdf, which replaces
+ *      the binary search for the interval containing the scaled \c sample
  * \return
  *      1. The sampled position
  *      2. The value of the spline evaluated at the sampled position
@@ -683,7 +847,8 @@ sample_1d(Float min, Float max, const Float *values, const Float *cdf,
 template <typename Value, typename Float>
 std::tuple<Value, Value, Value>
 sample_1d(const Float *nodes, const Float *values, const Float *cdf,
-          uint32_t size, Value sample, Float eps = 1e-6f) {
+          uint32_t size, Value sample, Float eps = 1e-6f,
+          const IntervalIndex<Float> *index = nullptr) {
     using Mask = dr::mask_t<Value>;
     using Index = dr::uint32_array_t<Value>;
 
@@ -698,11 +863,15 @@ sample_1d(const Float *nodes, const Float *values, const Float *cdf,
 
     /* Map y to a spline interval by searching through the
        monotonic 'cdf' array */
-    Index idx = math::find_interval<Index>(size,
-        [&](Index idx) {
-            return dr::gather<Value>(cdf, idx) <= sample;
-        }
-    );
+    Index idx;
+    if (index)
+        idx = index->template find<Index>(cdf, sample);
+    else
+        idx = math::find_interval<Index>(size,
+            [&](Index idx) {
+                return dr::gather<Value>(cdf, idx) <= sample;
+            }
+        );
 
     GET_SPLINE_NONUNIFORM(idx);
 
@@ -857,6 +1026,9 @@ std::pair<Mask, Int32> eval_spline_weights(Float min, Float max, uint32_t size,
  *      Evaluation point
  * \param[out] weights
  *      Pointer to a weight array of size 4 that will be populated
+ * \param index
+ *      Optional \ref IntervalIndex built over \c nodes, which replaces
+ *      the binary search for the interval containing \c x
  * \remark
  *      The Python API lacks the \c size parameter, which is inferred
  *      automatically from the size of the input array. The \c offset
@@ -873,7 +1045,8 @@ template <bool Extrapolate = false,
           typename Int32 = dr::int32_array_t<Value>,
           typename Mask = dr::mask_t<Value>>
 std::pair<Mask, Int32> eval_spline_weights(const Float* nodes, uint32_t size,
-                                           Value x, Value *weights) {
+                                           Value x, Value *weights,
+                                           const IntervalIndex<Float> *index = nullptr) {
     using Index = dr::uint32_array_t<Value>;
 
     /* Give up when given an out-of-range or NaN argument */
@@ -883,11 +1056,15 @@ std::pair<Mask, Int32> eval_spline_weights(const Float* nodes, uint32_t size,
         return std::make_pair(Mask(false), dr::zeros<Int32>());
 
     /* Find the index of the left node in the queried subinterval */
-    Index idx = math::find_interval<Index>(size,
-        [&](Index idx) {
-            return dr::gather<Value>(nodes, idx, mask_valid) <= x;
-        }
-    );
+    Index idx;
+    if (index)
+        idx = index->template find<Index>(nodes, x);
+    else
+        idx = math::find_interval<Index>(size,
+            [&](Index idx) {
+                return dr::gather<Value>(nodes, idx, mask_valid) <= x;
+            }
+        );
 
     Value x0 = dr::gather<Value>(nodes, idx),
            x1 = dr::gather<Value>(nodes, idx + 1),
@@ -972,6 +1149,10 @@ std::pair<Mask, Int32> eval_spline_weights(const Float* nodes, uint32_t size,
  *      \c X coordinate of the evaluation point
  * \param y
  *      \c Y coordinate of the evaluation point
+ * \param index1
+ *      Optional \ref IntervalIndex built over \c nodes1
+ * \param index2
+ *      Optional \ref IntervalIndex built over \c nodes2
  * \remark
  *      The Python API lacks the \c size1 and \c size2 parameters, which are
  *      inferred automatically from the size of the input arrays.
@@ -981,7 +1162,9 @@ std::pair<Mask, Int32> eval_spline_weights(const Float* nodes, uint32_t size,
  */
 template <bool Extrapolate = false, typename Value, typename Float>
 Value eval_2d(const Float *nodes1, uint32_t size1, const Float *nodes2,
-              uint32_t size2, const Float *values, Value x, Value y) {
+              uint32_t size2, const Float *values, Value x, Value y,
+              const IntervalIndex<Float> *index1 = nullptr,
+              const IntervalIndex<Float> *index2 = nullptr) {
     using Mask = dr::mask_t<Value>;
     using Index = dr::int32_array_t<Value>;
 
@@ -990,9 +1173,9 @@ Value eval_2d(const Float *nodes1, uint32_t size1, const Float *nodes2,
     Mask valid_x, valid_y;
 
     std::tie(valid_x, offset[0]) =
-        eval_spline_weights<Extrapolate>(nodes1, size1, x, weights[0]);
+        eval_spline_weights<Extrapolate>(nodes1, size1, x, weights[0], index1);
     std::tie(valid_y, offset[1]) =
-        eval_spline_weights<Extrapolate>(nodes2, size2, y, weights[1]);
+        eval_spline_weights<Extrapolate>(nodes2, size2, y, weights[1], index2);
 
     /* Compute interpolation weights separately for each dimension */
     if (unlikely(dr::none(valid_x && valid_y)))
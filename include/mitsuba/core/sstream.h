@@ -0,0 +1,149 @@
+#pragma once
+
+#include <mitsuba/core/stream.h>
+#include <mitsuba/core/object.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/** \brief \ref Stream implementation backed by a connected TCP socket.
+ *
+ * Reads and writes block until the requested number of bytes has been
+ * transferred, which makes this class suitable as the transport for simple
+ * length-prefixed message protocols. Seeking and truncation are not
+ * supported, and \ref tell() reports the number of bytes read and written so
+ * far. All multi-byte values are transferred in network byte order.
+ */
+class MI_EXPORT_LIB SocketStream : public Stream {
+public:
+    using Stream::read;
+    using Stream::write;
+
+    /// Connect to the given host and TCP port
+    SocketStream(const std::string &host, uint16_t port);
+
+    /// Wrap an already connected socket descriptor (takes ownership)
+    SocketStream(intptr_t socket, const std::string &peer);
+
+    /// Returns a string representation
+    std::string to_string() const override;
+
+    /** \brief Closes the stream and the underlying socket.
+     * No further read or write operations are permitted.
+     *
+     * This function is idempotent.
+     * It is called automatically by the destructor.
+     */
+    virtual void close() override;
+
+    /// Whether the stream is closed (no read or write are then permitted).
+    virtual bool is_closed() const override { return m_socket < 0; }
+
+    // =========================================================================
+    //! @{ \name Socket-specific features
+    // =========================================================================
+
+    /// Return a human-readable description of the remote end
+    const std::string &peer() const { return m_peer; }
+
+    /// Return the number of bytes received so far
+    size_t received() const { return m_received; }
+
+    /// Return the number of bytes sent so far
+    size_t sent() const { return m_sent; }
+
+    //! @}
+    // =========================================================================
+
+    // =========================================================================
+    //! @{ \name Implementation of the Stream interface
+    // =========================================================================
+
+    /**
+     * \brief Reads a specified amount of data from the socket.
+     * Throws an exception when the connection was closed prematurely.
+     */
+    virtual void read(void *p, size_t size) override;
+
+    /**
+     * \brief Writes a specified amount of data into the socket.
+     * Throws an exception when not all data could be sent.
+     */
+    virtual void write(const void *p, size_t size) override;
+
+    /// Unsupported. Always throws.
+    virtual void seek(size_t pos) override;
+
+    /// Unsupported. Always throws.
+    virtual void truncate(size_t size) override;
+
+    /// Returns the total number of bytes transferred in either direction
+    virtual size_t tell() const override { return m_received + m_sent; }
+
+    /// Unsupported. Always throws.
+    virtual size_t size() const override;
+
+    /// No-op, since data is sent immediately
+    virtual void flush() override { }
+
+    /// Can we write to the stream?
+    virtual bool can_write() const override { return !is_closed(); }
+
+    /// Can we read from the stream?
+    virtual bool can_read() const override { return !is_closed(); }
+
+    //! @}
+    // =========================================================================
+
+    MI_DECLARE_CLASS()
+protected:
+    /// Protected destructor
+    virtual ~SocketStream();
+
+private:
+    intptr_t m_socket;
+    std::string m_peer;
+    size_t m_received;
+    size_t m_sent;
+};
+
+/** \brief Listening TCP socket that hands out a \ref SocketStream for every
+ * incoming connection.
+ */
+class MI_EXPORT_LIB ServerSocket : public Object {
+public:
+    /**
+     * \brief Bind to the given TCP port on all interfaces and start listening
+     *
+     * Passing <tt>port=0</tt> lets the operating system choose a free port,
+     * which can subsequently be queried using \ref port().
+     */
+    ServerSocket(uint16_t port = 0);
+
+    /// Return the port that the socket is bound to
+    uint16_t port() const { return m_port; }
+
+    /**
+     * \brief Block until a client connects and return a stream for it
+     *
+     * Returns \c nullptr when the socket was closed by another thread while
+     * waiting.
+     */
+    ref<SocketStream> accept();
+
+    /// Stop listening. Wakes up threads that are blocked in \ref accept().
+    void close();
+
+    /// Returns a string representation
+    std::string to_string() const override;
+
+    MI_DECLARE_CLASS()
+protected:
+    /// Protected destructor
+    virtual ~ServerSocket();
+
+private:
+    intptr_t m_socket;
+    uint16_t m_port;
+};
+
+NAMESPACE_END(mitsuba)
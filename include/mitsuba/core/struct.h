@@ -360,8 +360,12 @@ MI_DECLARE_ENUM_OPERATORS(Struct::Flags)
  * this reason, the implementation of this class relies on a JIT compiler that
  * generates fast conversion code on demand for each specific conversion. The
  * function is cached and reused in case the same conversion is needed later
- * on. Note that JIT compilation only works on x86_64 processors; other
- * platforms use a slow generic fallback implementation.
+ * on. Note that JIT compilation only works on x86_64 processors. Other
+ * platforms (e.g. AArch64) use precompiled conversion routines for the common
+ * case where each target field is obtained from a single source field of a
+ * floating point or unsigned 8/16 bit integer type (e.g. 8-bit sRGB to linear
+ * 32-bit floats). All remaining conversions use a slow generic fallback
+ * implementation.
  */
 class MI_EXPORT_LIB StructConverter : public Object {
     using FuncType = bool (*) (size_t, size_t, const void *, void *);
@@ -428,6 +432,25 @@ protected:
     bool load(const uint8_t *src, const Struct::Field &f, Value &value) const;
     void linearize(Value &value) const;
     void save(uint8_t *dst, const Struct::Field &f, Value value, size_t x, size_t y) const;
+
+    /// Target field that is handled by the precompiled conversion routines
+    struct FastField {
+        /// Corresponding source field (unless \c constant is set)
+        Struct::Field source;
+        Struct::Field target;
+        /// Copy the field without conversion (same type and flags)
+        bool copy;
+        /// The field is set to its encoded default value \c constant_value
+        bool constant;
+        uint8_t constant_value[8];
+        /// Decoded values of an 8-bit source field
+        std::vector<Float> lut;
+    };
+
+    /// Check if the precompiled conversion routines apply, and prepare them
+    bool init_fast_path();
+    void convert_2d_fast(size_t width, size_t height, const uint8_t *src,
+                         uint8_t *dest) const;
 #endif
 
 protected:
@@ -437,6 +460,8 @@ protected:
     FuncType m_func;
 #else
     bool m_dither;
+    bool m_fast;
+    std::vector<FastField> m_fast_fields;
 #endif
 };
 
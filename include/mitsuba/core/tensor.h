@@ -1,7 +1,10 @@
 #pragma once
 
 #include <mitsuba/core/mmap.h>
+#include <mitsuba/core/properties.h>
 #include <mitsuba/core/struct.h>
+#include <drjit/jit.h>
+#include <drjit/tensor.h>
 #include <unordered_map>
 
 NAMESPACE_BEGIN(mitsuba)
@@ -10,7 +13,9 @@ NAMESPACE_BEGIN(mitsuba)
  * \brief Simple exchange format for tensor data of arbitrary rank and size
  *
  * This class provides convenient memory-mapped read-only access to tensor
- * data, usually exported from NumPy.
+ * data, usually exported from NumPy. Besides Mitsuba's own multi-field
+ * format, it also reads NumPy ``.npy`` files, which contain a single field
+ * named after the file (without extension).
  */
 class MI_EXPORT_LIB TensorFile : public MemoryMappedFile {
 public:
@@ -39,6 +44,26 @@ public:
     /// Return a data structure with information about the specified field
     const Field &field(const std::string &name) const;
 
+    /// Return the names of all fields (in alphabetical order)
+    std::vector<std::string> field_names() const;
+
+    /**
+     * \brief Create a tensor of the given type from the specified field
+     *
+     * When the field has the floating point type of the tensor, the tensor
+     * directly references the memory-mapped file on the CPU (scalar and LLVM
+     * variants), and the file remains mapped as long as the tensor data is
+     * in use. Other field types are converted, and GPU variants copy the
+     * data to the device.
+     *
+     * An empty \c name selects the only field of the file.
+     *
+     * The result is a handle that can be passed to plugins via \ref
+     * Properties::set_tensor_handle().
+     */
+    template <typename Tensor>
+    Properties::TensorHandle tensor(const std::string &name = "") const;
+
     /// Return a human-readable summary
     std::string to_string() const override;
 
@@ -47,8 +72,66 @@ protected:
     /// Destructor
     ~TensorFile();
 
+    /// Parse the header of a NumPy ``.npy`` file
+    void read_npy();
+
 private:
     std::unordered_map<std::string, Field> m_fields;
 };
 
+template <typename Tensor>
+Properties::TensorHandle TensorFile::tensor(const std::string &name) const {
+    using Storage = typename Tensor::Array;
+    using Scalar = dr::scalar_t<Storage>;
+
+    std::string name_ = name;
+    if (name_.empty()) {
+        if (m_fields.size() != 1)
+            Throw("TensorFile: \"%s\" contains %zu fields, please specify "
+                  "the name of one of them!", filename(), m_fields.size());
+        name_ = m_fields.begin()->first;
+    }
+
+    const Field &f = field(name_);
+    size_t size = 1;
+    for (size_t s : f.shape)
+        size *= s;
+
+    Storage data;
+    if (f.dtype == struct_type_v<Scalar> && !dr::is_cuda_v<Storage> &&
+        (uintptr_t) f.data % alignof(Scalar) == 0) {
+        data = dr::map<Storage>((void *) f.data, size);
+
+        if constexpr (dr::is_jit_v<Storage>) {
+            // Keep the file mapped until the JIT variable is freed
+            inc_ref();
+            jit_var_set_callback(
+                data.index(),
+                [](uint32_t /* index */, int free, void *payload) {
+                    if (free)
+                        ((const TensorFile *) payload)->dec_ref();
+                },
+                (void *) this);
+        }
+    } else {
+        ref<Struct> source = new Struct();
+        source->append("value", f.dtype);
+        ref<Struct> target = new Struct();
+        target->append("value", struct_type_v<Scalar>);
+
+        std::unique_ptr<Scalar[]> buf(new Scalar[size]);
+        ref<StructConverter> conv = new StructConverter(source, target);
+        if (!conv->convert(size, f.data, buf.get()))
+            Throw("TensorFile: could not convert field \"%s\"!", name_);
+        data = dr::load<Storage>(buf.get(), size);
+    }
+
+    // The tensor handle keeps the file mapped in scalar variants
+    ref<const TensorFile> self = this;
+    Tensor *tensor = new Tensor(data, f.shape.size(), f.shape.data());
+    return Properties::TensorHandle(tensor, [self](void *ptr) {
+        delete (Tensor *) ptr;
+    });
+}
+
 NAMESPACE_END(mitsuba)
@@ -144,6 +144,20 @@ public:
     /// Set the global thread count (e.g. spawn new threads in thread pool if > 1)
     static void set_thread_count(size_t);
 
+    /**
+     * \brief Pin the worker threads of the global thread pool to individual
+     * cores, grouped by NUMA node
+     *
+     * Workers are assigned to the cores of the first NUMA node before moving
+     * on to the next one (see \ref util::numa_topology()), which prevents
+     * them from migrating across sockets. Once enabled, pinning is reapplied
+     * by \ref set_thread_count(). The calling thread is not pinned.
+     */
+    static void pin_worker_threads();
+
+    /// Return the NUMA node of the calling worker thread, or -1 if it isn't pinned
+    static int numa_node();
+
     /**
      * \brief Register a new thread (e.g. Dr.Jit, Python) with Mitsuba thread system.
      * Returns true upon success.
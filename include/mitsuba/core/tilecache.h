@@ -0,0 +1,165 @@
+#pragma once
+
+#include <mitsuba/core/object.h>
+#include <mitsuba/core/filesystem.h>
+#include <mitsuba/core/vector.h>
+#include <functional>
+#include <memory>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/// A rectangular block of texels of a \ref TiledImage
+struct ImageTile {
+    /// Texels in row-major order with interleaved channels (float32)
+    std::unique_ptr<float[]> data;
+
+    /// Resolution of the tile (smaller than the nominal tile size at borders)
+    ScalarVector2u size;
+
+    /// Number of channels per texel
+    uint32_t channel_count;
+
+    /// Return the memory footprint of the tile in bytes
+    size_t bytes() const {
+        return (size_t) size.x() * size.y() * channel_count * sizeof(float);
+    }
+};
+
+/**
+ * \brief Image file whose contents are decoded in tiles on demand
+ *
+ * Only the header of the file is read upon construction. Tiles are then
+ * decoded via \ref read_tile(), which is typically invoked by the global
+ * \ref TileCache.
+ *
+ * - Tiled OpenEXR files are read one native tile at a time (the tile size
+ *   specified at construction is ignored in this case).
+ *
+ * - Scanline OpenEXR files are read in bands of rows, and all tiles of a band
+ *   are decoded at once.
+ *
+ * - Other formats supported by \ref Bitmap cannot be decoded partially. The
+ *   entire image is decoded whenever one of its tiles is requested.
+ *
+ * Images are converted into linear float32 luminance (1 channel) or RGB (3
+ * channels) data, and alpha channels are dropped. Unless \c raw is set, LDR
+ * formats with an sRGB transfer curve are linearized.
+ */
+class MI_EXPORT_LIB TiledImage : public Object {
+public:
+    /// Callback receiving the tile coordinates and the decoded tile
+    using TileCallback =
+        std::function<void(uint32_t /* tx */, uint32_t /* ty */, ImageTile &&)>;
+
+    /// Open the specified file and read its header
+    TiledImage(const fs::path &filename, uint32_t tile_size = 64,
+               bool raw = false);
+
+    /// Return the resolution of the image in texels
+    const ScalarVector2u &size() const;
+
+    /// Return the number of channels (1 or 3)
+    uint32_t channel_count() const;
+
+    /// Return the nominal tile size in texels
+    uint32_t tile_size() const;
+
+    /// Return the number of tiles along each dimension
+    ScalarVector2u tile_count() const;
+
+    /// Return an identifier that is unique among all images created so far
+    uint64_t uid() const;
+
+    /// Return the associated filename
+    const fs::path &filename() const;
+
+    /**
+     * \brief Decode the tile at the given tile coordinates
+     *
+     * The callback is invoked for the requested tile and for every other
+     * tile that could be decoded at no extra cost (e.g. the remaining tiles
+     * of a band of scanlines). The requested tile is always passed last.
+     * This function is thread-safe.
+     */
+    void read_tile(uint32_t tx, uint32_t ty, const TileCallback &callback) const;
+
+    std::string to_string() const override;
+
+    MI_DECLARE_CLASS()
+protected:
+    virtual ~TiledImage();
+
+private:
+    struct TiledImagePrivate;
+    std::unique_ptr<TiledImagePrivate> d;
+};
+
+/**
+ * \brief Global cache of image tiles with a fixed memory budget
+ *
+ * Tiles of \ref TiledImage instances are loaded lazily on their first access
+ * and evicted in least-recently-used order once the resident tiles exceed
+ * the memory budget. Tiles are handed out as reference-counted pointers,
+ * hence an evicted tile stays valid for as long as it is in use.
+ *
+ * Every thread keeps a small direct-mapped cache of the tiles that it
+ * accessed most recently. Lookups that hit this per-thread cache do not
+ * acquire any lock; they only mark the tile as referenced, which grants it
+ * a second chance when it reaches the end of the global LRU list.
+ */
+class MI_EXPORT_LIB TileCache : public Object {
+public:
+    using TilePtr = std::shared_ptr<const ImageTile>;
+
+    /// Counters describing the effectiveness of the cache
+    struct Statistics {
+        /// Lookups served by the per-thread or global cache
+        size_t hits = 0;
+
+        /// Lookups that required decoding a tile
+        size_t misses = 0;
+
+        /// Number of tiles evicted to stay within the budget
+        size_t evictions = 0;
+
+        /// Number of tiles and bytes currently held by the global cache
+        size_t resident_tiles = 0, resident_bytes = 0;
+
+        /// Memory budget in bytes
+        size_t budget = 0;
+    };
+
+    /// Return the global tile cache
+    static TileCache *instance();
+
+    /// Return the tile at the given coordinates, loading it if necessary
+    TilePtr tile(const TiledImage *image, uint32_t tx, uint32_t ty);
+
+    /// Set the memory budget in bytes (evicts tiles immediately if needed)
+    void set_budget(size_t bytes);
+
+    /// Return the memory budget in bytes
+    size_t budget() const;
+
+    /// Return the current statistics
+    Statistics statistics() const;
+
+    /// Reset the hit, miss, and eviction counters
+    void reset_statistics();
+
+    /// Evict all tiles
+    void clear();
+
+    std::string to_string() const override;
+
+    MI_DECLARE_CLASS()
+protected:
+    TileCache();
+    virtual ~TileCache();
+
+private:
+    struct TileCachePrivate;
+    std::unique_ptr<TileCachePrivate> d;
+};
+
+NAMESPACE_END(mitsuba)
@@ -8,6 +8,7 @@
 #  pragma clang diagnostic ignored "-Wdouble-promotion"
 #endif
 
+#include <mitsuba/core/object.h>
 #include <mitsuba/core/ray.h>
 #include <drjit/transform.h>
 #include <drjit/sphere.h>
@@ -368,16 +369,20 @@ template <typename Point_> struct Transform {
     DRJIT_STRUCT(Transform, matrix, inverse_transpose)
 };
 
-// WARNING: the AnimatedTransform class is outdated and dysfunctional with the
-// latest version of Mitsuba 3. Please update this code before using it!
-#if 0
 /**
  * \brief Encapsulates an animated 4x4 homogeneous coordinate transformation
  *
- * The animation is stored as keyframe animation with linear segments. The
- * implementation performs a polar decomposition of each keyframe into a 3x3
- * scale/shear matrix, a rotation quaternion, and a translation vector. These
- * will all be interpolated independently at eval time.
+ * The animation is stored as keyframe animation with linear segments. Each
+ * keyframe is decomposed once when it is appended: a QR decomposition of the
+ * linear part yields a rotation quaternion and an upper triangular 3x3
+ * scale/shear matrix, which together with the translation vector describe
+ * the transformation as <tt>T * R * S</tt>. These components are interpolated
+ * independently at eval time (the rotation using spherical linear
+ * interpolation), which matches the scale/rotation/translation motion keys
+ * of Embree and OptiX.
+ *
+ * Times before the first and after the last keyframe evaluate to the
+ * transformation of the respective keyframe.
  */
 class MI_EXPORT_LIB AnimatedTransform : public Object {
 public:
@@ -389,7 +394,7 @@ public:
         /// Time value associated with this keyframe
         Float time;
 
-        /// 3x3 scale/shear matrix
+        /// Upper triangular 3x3 scale/shear matrix
         Matrix3f scale;
 
         /// Rotation quaternion
@@ -415,11 +420,13 @@ public:
     /// Create an empty animated transform
     AnimatedTransform() = default;
 
-//     /** Create a constant "animated" transform.
-//      * The provided transformation will be used as long as no keyframes
-//      * are specified. However, it will be overwritten as soon as the
-//      * first keyframe is appended.
-//      */
+    /**
+     * \brief Create a constant "animated" transform
+     *
+     * The provided transformation will be used as long as no keyframes are
+     * specified. However, it will be overwritten as soon as the first
+     * keyframe is appended.
+     */
     AnimatedTransform(const Transform4f &trafo)
       : m_transform(trafo) { }
 
@@ -431,72 +438,92 @@ public:
     /// Append a keyframe to the current animated transform
     void append(const Keyframe &keyframe);
 
-    // TODO move this method definition to transform.cpp
-    /// Compatibility wrapper, which strips the mask argument and invokes \ref eval()
+    /**
+     * \brief Evaluate the transformation at the specified time
+     *
+     * This function is vectorized over \c time. Since animations typically
+     * only consist of a few keyframes, the segment of each lane is selected
+     * by comparing against all keyframe times, which avoids gathers and
+     * works with any Dr.Jit array type.
+     */
     template <typename T>
     Transform<Point<T, 4>> eval(T time, dr::mask_t<T> active = true) const {
-        using Index        = dr::uint32_array_t<T>;
-        using Value        = dr::replace_scalar_t<T, Float>; // ensure we are working with Float32
-        using Matrix3f     = dr::Matrix<Value, 3>;
-        using Matrix4f     = dr::Matrix<Value, 4>;
-        using Quaternion4f = dr::Quaternion<Value>;
-        using Vector3f     = Vector<Value, 3>;
+        using Matrix3     = dr::Matrix<T, 3>;
+        using Matrix4     = dr::Matrix<T, 4>;
+        using Quaternion4 = dr::Quaternion<T>;
+        using Vector3     = Vector<T, 3>;
 
         static_assert(!std::is_integral_v<T>,
                       "AnimatedTransform::eval() should be called with a "
                       "floating point-typed `time` parameter");
-
-        DRJIT_MARK_USED(time);
         DRJIT_MARK_USED(active);
-        return Transform<Point<T, 4>>(m_transform.matrix);
-
-        // TODO
-        // // Perhaps the transformation isn't animated
-        // if (likely(size() <= 1))
-        //     return Transform<Point<T, 4>>(m_transform.matrix);
-
-        // // Look up the interval containing 'time'
-        // Index idx0 = math::find_interval(
-        //     (uint32_t) size(),
-        //     [&](Index idx) {
-        //         constexpr size_t Stride_ = sizeof(Keyframe); // MSVC: have to redeclare constexpr variable in lambda scope :(
-        //         return dr::gather<Value, Stride_>(m_keyframes.data(), idx, active) < time;
-        //     });
-
-        // Index idx1 = idx0 + 1;
-
-        // // Compute constants describing the layout of the 'Keyframe' data structure
-        // constexpr size_t Stride      = sizeof(Keyframe);
-        // constexpr size_t ScaleOffset = offsetof(Keyframe, scale) / sizeof(Float);
-        // constexpr size_t QuatOffset  = offsetof(Keyframe, quat)  / sizeof(Float);
-        // constexpr size_t TransOffset = offsetof(Keyframe, trans) / sizeof(Float);
-
-        // // Compute the relative time value in [0, 1]
-        // Value t0 = dr::gather<Value, Stride, false>(m_keyframes.data(), idx0, active),
-        //       t1 = dr::gather<Value, Stride, false>(m_keyframes.data(), idx1, active),
-        //       t  = dr::minimum(dr::maximum((time - t0) / (t1 - t0), 0.f), 1.f);
-
-        // // Interpolate the scale matrix
-        // Matrix3f scale0 = dr::gather<Matrix3f, Stride, false>((Float *) m_keyframes.data() + ScaleOffset, idx0, active),
-        //          scale1 = dr::gather<Matrix3f, Stride, false>((Float *) m_keyframes.data() + ScaleOffset, idx1, active),
-        //          scale  = scale0 * (1 - t) + scale1 * t;
-
-        // // Interpolate the rotation quaternion
-        // Quaternion4f quat0 = dr::gather<Quaternion4f, Stride, false>((Float *) m_keyframes.data() + QuatOffset, idx0, active),
-        //              quat1 = dr::gather<Quaternion4f, Stride, false>((Float *) m_keyframes.data() + QuatOffset, idx1, active),
-        //              quat = dr::slerp(quat0, quat1, t);
-
-        // // Interpolate the translation component
-        // Vector3f trans0 = dr::gather<Vector3f, Stride, false>((Float *) m_keyframes.data() + TransOffset, idx0, active),
-        //          trans1 = dr::gather<Vector3f, Stride, false>((Float *) m_keyframes.data() + TransOffset, idx1, active),
-        //          trans = trans0 * (1 - t) + trans1 * t;
-
-        // return Transform<Point<T, 4>>(
-        //     dr::transform_compose<Matrix4f>(scale, quat, trans),
-        //     dr::transform_compose_inverse<Matrix4f>(scale, quat, trans)
-        // );
+
+        // Perhaps the transformation isn't animated
+        if (likely(size() <= 1))
+            return Transform<Point<T, 4>>(Matrix4(m_transform.matrix),
+                                          Matrix4(m_transform.inverse_transpose));
+
+        // Look up the segment containing 'time'
+        size_t first = 0;
+        if constexpr (!dr::is_array_v<T>) {
+            while (first + 2 < size() && time >= m_keyframes[first + 1].time)
+                first++;
+        }
+
+        const Keyframe &k0 = m_keyframes[first], &k1 = m_keyframes[first + 1];
+        T t0 = k0.time, t1 = k1.time;
+        Matrix3 scale0(k0.scale), scale1(k1.scale);
+        Quaternion4 quat0(k0.quat), quat1(k1.quat);
+        Vector3 trans0(k0.trans), trans1(k1.trans);
+
+        if constexpr (dr::is_array_v<T>) {
+            for (size_t i = 1; i + 1 < size(); ++i) {
+                const Keyframe &k = m_keyframes[i], &kn = m_keyframes[i + 1];
+                dr::mask_t<T> m = time >= k.time;
+                t0     = dr::select(m, T(k.time), t0);
+                t1     = dr::select(m, T(kn.time), t1);
+                scale0 = dr::select(m, Matrix3(k.scale), scale0);
+                scale1 = dr::select(m, Matrix3(kn.scale), scale1);
+                quat0  = dr::select(m, Quaternion4(k.quat), quat0);
+                quat1  = dr::select(m, Quaternion4(kn.quat), quat1);
+                trans0 = dr::select(m, Vector3(k.trans), trans0);
+                trans1 = dr::select(m, Vector3(kn.trans), trans1);
+            }
+        }
+
+        // Compute the relative time value in [0, 1]
+        T t = dr::clamp((time - t0) / (t1 - t0), 0.f, 1.f);
+
+        Matrix3 scale    = scale0 * (1.f - t) + scale1 * t;
+        Quaternion4 quat = dr::slerp(quat0, quat1, t);
+        Vector3 trans    = dr::fmadd(trans1 - trans0, t, trans0);
+
+        return Transform<Point<T, 4>>(
+            dr::transform_compose<Matrix4>(scale, quat, trans),
+            dr::transpose(dr::transform_compose_inverse<Matrix4>(scale, quat, trans))
+        );
     }
 
+    /**
+     * \brief Return the interpolated keyframe at the specified time
+     *
+     * The components of the returned keyframe are consistent with \ref
+     * eval(), e.g. to initialize the motion keys of a ray tracing backend.
+     */
+    Keyframe interpolate(Float time) const;
+
+    /**
+     * \brief Resample the animation at uniformly spaced times spanning the
+     * first to the last keyframe
+     *
+     * Ray tracing backends (Embree, OptiX) require motion keys at uniformly
+     * spaced times. The number of returned keys is chosen so that their
+     * spacing does not exceed the shortest interval between two keyframes
+     * (but at most \c max_keys), hence uniformly spaced keyframes are
+     * reproduced exactly.
+     */
+    std::vector<Keyframe> resample(size_t max_keys = 64) const;
+
     /**
      * \brief Return an axis-aligned box bounding the amount of translation
      * throughout the animation sequence
@@ -529,7 +556,7 @@ public:
         return !operator==(t);
     }
 
-    /// Return a human-readable summary of this bitmap
+    /// Return a human-readable summary of this animated transform
     virtual std::string to_string() const override;
 
     MI_DECLARE_CLASS()
@@ -537,7 +564,6 @@ private:
     Transform4f m_transform;
     std::vector<Keyframe> m_keyframes;
 };
-#endif
 
 // -----------------------------------------------------------------------
 //! @{ \name Printing
@@ -549,8 +575,8 @@ std::ostream &operator<<(std::ostream &os, const Transform<Point> &t) {
     return os;
 }
 
-// std::ostream &operator<<(std::ostream &os, const AnimatedTransform::Keyframe &frame);
-// std::ostream &operator<<(std::ostream &os, const AnimatedTransform &t);
+extern MI_EXPORT_LIB std::ostream &operator<<(std::ostream &os, const AnimatedTransform::Keyframe &frame);
+extern MI_EXPORT_LIB std::ostream &operator<<(std::ostream &os, const AnimatedTransform &t);
 
 //! @}
 // -----------------------------------------------------------------------
@@ -18,6 +18,15 @@ NAMESPACE_BEGIN(util)
 /// Determine the number of available CPU cores (including virtual cores)
 extern MI_EXPORT_LIB int core_count();
 
+/**
+ * \brief Return the CPU cores available to this process, grouped by NUMA node
+ *
+ * On Linux, the topology is read from <tt>/sys/devices/system/node</tt>. On
+ * other platforms, or when this information is unavailable, a single node
+ * containing all cores is returned.
+ */
+extern MI_EXPORT_LIB std::vector<std::vector<int>> numa_topology();
+
 /**
  * \brief Convert a time difference (in seconds) to a string representation
  * \param time Time difference in (fractional) sections
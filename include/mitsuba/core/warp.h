@@ -578,6 +578,73 @@ MI_INLINE Value square_to_uniform_cone_pdf(const Vector<Value, 3> &v,
 
 // =======================================================================
 
+/**
+ * \brief Solid angle of the spherical triangle with the given vertices
+ *
+ * The vertices must be unit vectors. Based on "The Solid Angle of a Plane
+ * Triangle" by A. Van Oosterom and J. Strackee, IEEE TBME 1983.
+ */
+template <typename Value>
+MI_INLINE Value spherical_triangle_solid_angle(const Vector<Value, 3> &a,
+                                               const Vector<Value, 3> &b,
+                                               const Vector<Value, 3> &c) {
+    Value numer = dr::abs(dr::dot(a, dr::cross(b, c))),
+          denom = 1.f + dr::dot(a, b) + dr::dot(b, c) + dr::dot(c, a);
+    return 2.f * dr::atan2(numer, denom);
+}
+
+/**
+ * \brief Uniformly sample a direction on the spherical triangle with the
+ * given vertices
+ *
+ * The vertices must be unit vectors, and the density of the resulting
+ * directions is the reciprocal of \ref spherical_triangle_solid_angle().
+ * Based on "Stratified Sampling of Spherical Triangles" by James Arvo,
+ * SIGGRAPH 1995.
+ */
+template <typename Value>
+MI_INLINE Vector<Value, 3>
+square_to_spherical_triangle(const Point<Value, 2> &sample,
+                             const Vector<Value, 3> &a,
+                             const Vector<Value, 3> &b,
+                             const Vector<Value, 3> &c) {
+    using Vector3 = Vector<Value, 3>;
+
+    // Interior angles of the spherical triangle
+    Vector3 n_ab = dr::normalize(dr::cross(a, b)),
+            n_bc = dr::normalize(dr::cross(b, c)),
+            n_ca = dr::normalize(dr::cross(c, a));
+    Value alpha = dr::unit_angle(n_ab, -n_ca),
+          beta  = dr::unit_angle(n_bc, -n_ab),
+          gamma = dr::unit_angle(n_ca, -n_bc);
+
+    // Find the vertex 'cp' on the arc from 'a' to 'c' of the sub-triangle
+    Value area_pi = dr::fmadd(sample.x(), alpha + beta + gamma - dr::Pi<Value>,
+                              dr::Pi<Value>);
+    auto [sin_alpha, cos_alpha] = dr::sincos(alpha);
+    auto [sin_area, cos_area]   = dr::sincos(area_pi);
+
+    Value sin_phi = sin_area * cos_alpha - cos_area * sin_alpha,
+          cos_phi = cos_area * cos_alpha + sin_area * sin_alpha,
+          k1      = cos_phi + cos_alpha,
+          k2      = sin_phi - sin_alpha * dr::dot(a, b);
+
+    Value cos_bp = (k2 + (k2 * cos_phi - k1 * sin_phi) * cos_alpha) /
+                   ((k2 * sin_phi + k1 * cos_phi) * sin_alpha);
+    cos_bp = dr::clamp(cos_bp, -1.f, 1.f);
+    Value sin_bp = dr::safe_sqrt(dr::fnmadd(cos_bp, cos_bp, 1.f));
+
+    Vector3 cp = cos_bp * a + sin_bp * dr::normalize(c - dr::dot(c, a) * a);
+
+    // Sample a direction on the arc from 'b' to 'cp'
+    Value cos_theta = 1.f - sample.y() * (1.f - dr::dot(cp, b)),
+          sin_theta = dr::safe_sqrt(dr::fnmadd(cos_theta, cos_theta, 1.f));
+
+    return cos_theta * b + sin_theta * dr::normalize(cp - dr::dot(cp, b) * b);
+}
+
+// =======================================================================
+
 /// Warp a uniformly distributed square sample to a Beckmann distribution
 template <typename Value>
 MI_INLINE Vector<Value, 3> square_to_beckmann(const Point<Value, 2> &sample,
@@ -52,22 +52,159 @@ using ParameterList = std::vector<std::tuple<std::string, std::string, bool>>;
  *
  * \param parallel
  *     Whether the loading should be executed on multiple threads in parallel
+ *
+ * \param deduplicate
+ *     Whether structurally identical anonymous BSDFs and textures (i.e.
+ *     objects without an \c id that have the same plugin and properties)
+ *     should be instantiated only once and shared. The deduplication ratio
+ *     is written to the log.
+ *
+ * \param streaming
+ *     Whether the file should be read incrementally instead of building a
+ *     DOM of the entire document. This bounds the memory used by the parser
+ *     for very large scene files, and lets the objects that were parsed
+ *     already be instantiated while the rest of the file is read (when \c
+ *     parallel is set). Forward references are resolved once the file was
+ *     read entirely, and <tt>\<path\></tt> elements must precede all
+ *     objects. \c update_scene is not supported in this mode.
+ *
+ * The file may also be a compiled scene created by \ref compile_file(), in
+ * which case XML parsing is skipped entirely. Parameters cannot be specified
+ * in this case, since they were already substituted during compilation.
  */
 extern MI_EXPORT_LIB std::vector<ref<Object>> load_file(
                                         const fs::path &path,
                                         const std::string &variant,
                                         ParameterList parameters = ParameterList(),
                                         bool update_scene = false,
-                                        bool parallel = true);
+                                        bool parallel = true,
+                                        bool deduplicate = false,
+                                        bool streaming = false);
 
 /// Load a Mitsuba scene from an XML string
 extern MI_EXPORT_LIB std::vector<ref<Object>> load_string(
                                         const std::string &string,
                                         const std::string &variant,
                                         ParameterList parameters = ParameterList(),
-                                        bool parallel = true);
+                                        bool parallel = true,
+                                        bool deduplicate = false);
 
+/**
+ * Compile a Mitsuba scene from an XML file into a binary file that can be
+ * loaded much faster using \ref load_file()
+ *
+ * The compiled file stores the fully resolved object graph, i.e. the plugin
+ * names, typed properties and transformations of all objects, their
+ * dependencies, and the file resolver search paths. Includes, parameters and
+ * defaults are expanded at compile time. Since color and spectrum values are
+ * converted in a variant-specific way, the compiled file can only be loaded
+ * with the variant that was used to create it.
+ *
+ * \param path
+ *     Filename of the scene XML file
+ *
+ * \param output
+ *     Filename of the compiled scene
+ *
+ * \param variant
+ *     Specifies the variant of plugins to instantiate (e.g. "scalar_rgb")
+ *
+ * \param parameters
+ *     Optional list of parameters that can be referenced as <tt>$varname</tt>
+ *     in the scene.
+ */
+extern MI_EXPORT_LIB void compile_file(const fs::path &path,
+                                       const fs::path &output,
+                                       const std::string &variant,
+                                       ParameterList parameters = ParameterList());
 
+/**
+ * \brief Loads a scene from an XML file and incrementally applies later
+ * changes of its description
+ *
+ * Instead of reloading the entire scene when its description changes
+ * slightly (e.g. one material was edited or one object was moved), this class
+ * compares the new description against the previous one and only updates the
+ * objects that actually changed. Objects are matched by their \c id, while
+ * anonymous objects are matched by their position within the parent object
+ * or, failing that, by their structure.
+ *
+ * A changed object is updated in place when all modified properties are
+ * exposed under the same name by \ref Object::traverse() (e.g. the \c
+ * reflectance of a BSDF or the \c to_world transformation of a sphere). The
+ * geometry of meshes may change as well (\c to_world or \c filename), in
+ * which case their vertex buffers are replaced. A new instance of the plugin
+ * is created temporarily to obtain the new parameter values, which are then
+ * copied into the existing object, followed by calls to \ref
+ * Object::parameters_changed() on the object and its ancestors. The scene
+ * eventually updates its acceleration data structure if shapes were
+ * modified.
+ *
+ * All other changes (e.g. a different plugin type, added or removed child
+ * objects, or properties that cannot be accessed via \ref Object::traverse())
+ * re-create the object along with its ancestors, while unchanged child
+ * objects are reused. If this affects the scene itself, \ref scene() returns
+ * a new object after the update.
+ *
+ * Updates are applied one object at a time. When an update fails (e.g.
+ * because of an invalid plugin parameter), the scene may therefore be left in
+ * a partially updated state.
+ */
+class MI_EXPORT_LIB SceneUpdater : public Object {
+public:
+    /**
+     * \brief Load a scene from an XML file
+     *
+     * \param path
+     *     Filename of the scene XML file
+     *
+     * \param variant
+     *     Specifies the variant of plugins to instantiate (e.g. "scalar_rgb")
+     *
+     * \param parameters
+     *     Optional list of parameters that can be referenced as
+     *     <tt>$varname</tt> in the scene.
+     */
+    SceneUpdater(const fs::path &path, const std::string &variant,
+                 ParameterList parameters = ParameterList());
+
+    /// Return the current scene
+    Object *scene() const;
+
+    /**
+     * \brief Update the scene to match a new version of its XML file
+     *
+     * Returns the identifiers of the objects that were updated in place or
+     * re-created, including the generated identifiers of anonymous objects.
+     * Relative paths are resolved with respect to the directory of the
+     * original scene file.
+     */
+    std::vector<std::string> update_file(const fs::path &path,
+                                         ParameterList parameters = ParameterList());
+
+    /// Update the scene to match a new description given as XML string
+    std::vector<std::string> update_string(const std::string &string,
+                                           ParameterList parameters = ParameterList());
+
+    /**
+     * \brief Change the properties of the object with the given \c id
+     *
+     * The entries of \c props are added to the object's properties,
+     * replacing existing ones of the same name. A non-empty plugin name
+     * switches the plugin type. Returns the identifiers of the objects that
+     * were updated in place or re-created.
+     */
+    std::vector<std::string> update(const std::string &id,
+                                    const Properties &props);
+
+    MI_DECLARE_CLASS()
+protected:
+    virtual ~SceneUpdater();
+
+private:
+    struct SceneUpdaterPrivate;
+    std::unique_ptr<SceneUpdaterPrivate> d;
+};
 
 NAMESPACE_BEGIN(detail)
 /// Create a Texture object from RGB values
@@ -88,6 +225,18 @@ extern MI_EXPORT_LIB ref<Object> create_texture_from_spectrum(
                                         bool is_spectral_mode,
                                         bool is_monochromatic_mode);
 
+/**
+ * \brief Create a tensor from a field of a tensor or NumPy file
+ *
+ * The file is resolved using the file resolver of the current thread. An
+ * empty \c field selects the only field of the file. See \ref
+ * TensorFile::tensor() for details.
+ */
+extern MI_EXPORT_LIB Properties::TensorHandle load_tensor(
+                                        const fs::path &filename,
+                                        const std::string &field,
+                                        const std::string &variant);
+
 /// Expands a node (if it does not expand it is wrapped into a std::vector)
 extern MI_EXPORT_LIB std::vector<ref<Object>> expand_node(
                                         const ref<Object> &top_node);
@@ -10,22 +10,30 @@ extern "C" {
 NAMESPACE_BEGIN(mitsuba)
 
 NAMESPACE_BEGIN(detail)
-/// Buffer size used to communicate with zlib. The larger, the better.
+/// Buffer size used to communicate with the compression libraries. The larger, the better.
 constexpr size_t kZStreamBufferSize = 32768;
 NAMESPACE_END(detail)
 
 /**
- * \brief Transparent compression/decompression stream based on \c zlib.
+ * \brief Transparent compression/decompression stream based on \c zlib,
+ * \c zstd, or \c LZ4.
  *
  * This class transparently decompresses and compresses reads and writes
  * to a nested stream, respectively.
+ *
+ * The zstd and LZ4 formats decompress considerably faster than zlib at
+ * similar compression ratios. Their availability depends on whether the
+ * respective libraries were found when Mitsuba was compiled (see \ref
+ * has_backend()).
  */
 class MI_EXPORT_LIB ZStream : public Stream {
 public:
 
     enum EStreamType {
         EDeflateStream, /// A raw deflate stream
-        EGZipStream /// A gzip-compatible stream
+        EGZipStream, /// A gzip-compatible stream
+        EZstdStream, /// A zstd stream
+        ELZ4Stream /// An LZ4 frame stream
     };
 
     using Stream::read;
@@ -34,9 +42,28 @@ public:
     /** \brief Creates a new compression stream with the given underlying stream.
      * This new instance takes ownership of the child stream. The child stream
      * must outlive the ZStream.
+     *
+     * \param level
+     *     Compression level. The value -1 selects the default level of the
+     *     compression library.
+     *
+     * \param threads
+     *     Number of worker threads that compress data in the background
+     *     (zstd only). The default value 0 compresses on the calling thread.
      */
     ZStream(Stream *child_stream, EStreamType stream_type = EDeflateStream,
-            int level = -1);
+            int level = -1, int threads = 0);
+
+    /// Was Mitsuba compiled with support for the given stream type?
+    static bool has_backend(EStreamType stream_type);
+
+    /**
+     * \brief Determine the stream type from the first bytes of a (seekable)
+     * stream, without changing its position
+     *
+     * Returns \ref EDeflateStream when the format is not recognized.
+     */
+    static EStreamType detect_type(Stream *stream);
 
     /// Returns a string representation
     std::string to_string() const override;
@@ -62,6 +89,9 @@ public:
     /// Returns the child stream of this compression stream
     Stream *child_stream() { return m_child_stream; }
 
+    /// Returns the compression format of this stream
+    EStreamType stream_type() const { return m_stream_type; }
+
     //! @}
     // =========================================================================
 
@@ -88,23 +118,23 @@ public:
 
     /// Unsupported. Always throws.
     virtual void seek(size_t) override {
-        Throw("seek(): unsupported in a ZLIB stream!");
+        Throw("seek(): unsupported in a compression stream!");
     }
 
     //// Unsupported. Always throws.
     virtual void truncate(size_t) override {
-        Throw("truncate(): unsupported in a ZLIB stream!");
+        Throw("truncate(): unsupported in a compression stream!");
     }
 
     /// Unsupported. Always throws.
     virtual size_t tell() const override {
-        Throw("tell(): unsupported in a ZLIB stream!");
+        Throw("tell(): unsupported in a compression stream!");
         return 0;
     }
 
     /// Unsupported. Always throws.
     virtual size_t size() const override {
-        Throw("size(): unsupported in a ZLIB stream!");
+        Throw("size(): unsupported in a compression stream!");
         return 0;
     }
 
@@ -126,11 +156,30 @@ protected:
     /// Protected destructor
     virtual ~ZStream();
 
+    /// Fill the input buffer from the child stream (zstd and LZ4)
+    void refill(size_t size);
+
+    /**
+     * \brief Compress data using zstd or LZ4 and write it to the child stream
+     *
+     * \param mode
+     *     0: compress the data, 1: flush the stream, 2: end the stream
+     */
+    void write_frames(const void *p, size_t size, int mode);
+
 private:
+    struct ZstdState;
+    struct LZ4State;
+
     ref<Stream> m_child_stream;
+    EStreamType m_stream_type;
     std::unique_ptr<z_stream> m_deflate_stream, m_inflate_stream;
+    std::unique_ptr<ZstdState> m_zstd;
+    std::unique_ptr<LZ4State> m_lz4;
     uint8_t m_deflate_buffer[detail::kZStreamBufferSize];
     uint8_t m_inflate_buffer[detail::kZStreamBufferSize];
+    /// Consumed and total bytes of the input buffer (zstd and LZ4)
+    size_t m_inflate_pos = 0, m_inflate_size = 0;
     bool m_did_write;
 };
 
@@ -404,6 +404,10 @@ R"doc(Number of samples to compute for each pass over the image blocks.
 Must be a multiple of the total sample count per pixel. If set to
 (size_t) -1, all the work is done in a single pass (default).)doc";
 
+static const char *__doc_mitsuba_AdjointIntegrator_m_splat_replicas =
+R"doc(Number of copies of the image that splats are spread over in JIT
+variants (see ImageBlock::set_replicas()))doc";
+
 static const char *__doc_mitsuba_AdjointIntegrator_render = R"doc(//! @{ \name Integrator interface implementation)doc";
 
 static const char *__doc_mitsuba_AdjointIntegrator_sample =
@@ -426,6 +430,97 @@ Parameter ``sample_scale``:
     A scale factor that must be applied to each sample to account for
     the film resolution and number of samples.)doc";
 
+static const char *__doc_mitsuba_AnimatedTransform =
+R"doc(Encapsulates an animated 4x4 homogeneous coordinate transformation
+
+The animation is stored as keyframe animation with linear segments.
+Each keyframe is decomposed once when it is appended: a QR
+decomposition of the linear part yields a rotation quaternion and an
+upper triangular 3x3 scale/shear matrix, which together with the
+translation vector describe the transformation as <tt>T * R * S</tt>.
+These components are interpolated independently at eval time (the
+rotation using spherical linear interpolation), which matches the
+scale/rotation/translation motion keys of Embree and OptiX.
+
+Times before the first and after the last keyframe evaluate to the
+transformation of the respective keyframe.)doc";
+
+static const char *__doc_mitsuba_AnimatedTransform_AnimatedTransform = R"doc(Create an empty animated transform)doc";
+
+static const char *__doc_mitsuba_AnimatedTransform_AnimatedTransform_2 =
+R"doc(Create a constant "animated" transform
+
+The provided transformation will be used as long as no keyframes are
+specified. However, it will be overwritten as soon as the first
+keyframe is appended.)doc";
+
+static const char *__doc_mitsuba_AnimatedTransform_Keyframe = R"doc(Represents a single keyframe in an animated transform)doc";
+
+static const char *__doc_mitsuba_AnimatedTransform_Keyframe_Keyframe = R"doc()doc";
+
+static const char *__doc_mitsuba_AnimatedTransform_Keyframe_operator_eq = R"doc()doc";
+
+static const char *__doc_mitsuba_AnimatedTransform_Keyframe_operator_ne = R"doc()doc";
+
+static const char *__doc_mitsuba_AnimatedTransform_Keyframe_quat = R"doc(Rotation quaternion)doc";
+
+static const char *__doc_mitsuba_AnimatedTransform_Keyframe_scale = R"doc(Upper triangular 3x3 scale/shear matrix)doc";
+
+static const char *__doc_mitsuba_AnimatedTransform_Keyframe_time = R"doc(Time value associated with this keyframe)doc";
+
+static const char *__doc_mitsuba_AnimatedTransform_Keyframe_trans = R"doc(3D translation)doc";
+
+static const char *__doc_mitsuba_AnimatedTransform_append = R"doc(Append a keyframe to the current animated transform)doc";
+
+static const char *__doc_mitsuba_AnimatedTransform_append_2 = R"doc(Append a keyframe to the current animated transform)doc";
+
+static const char *__doc_mitsuba_AnimatedTransform_class = R"doc()doc";
+
+static const char *__doc_mitsuba_AnimatedTransform_eval =
+R"doc(Evaluate the transformation at the specified time
+
+This function is vectorized over ``time``. Since animations typically
+only consist of a few keyframes, the segment of each lane is selected
+by comparing against all keyframe times, which avoids gathers and
+works with any Dr.Jit array type.)doc";
+
+static const char *__doc_mitsuba_AnimatedTransform_has_scale =
+R"doc(Determine whether the transformation involves any kind of scaling)doc";
+
+static const char *__doc_mitsuba_AnimatedTransform_interpolate =
+R"doc(Return the interpolated keyframe at the specified time
+
+The components of the returned keyframe are consistent with eval(),
+e.g. to initialize the motion keys of a ray tracing backend.)doc";
+
+static const char *__doc_mitsuba_AnimatedTransform_m_keyframes = R"doc()doc";
+
+static const char *__doc_mitsuba_AnimatedTransform_m_transform = R"doc()doc";
+
+static const char *__doc_mitsuba_AnimatedTransform_operator_array = R"doc(Return a Keyframe data structure)doc";
+
+static const char *__doc_mitsuba_AnimatedTransform_operator_eq = R"doc(Equality comparison operator)doc";
+
+static const char *__doc_mitsuba_AnimatedTransform_operator_ne = R"doc()doc";
+
+static const char *__doc_mitsuba_AnimatedTransform_resample =
+R"doc(Resample the animation at uniformly spaced times spanning the first
+to the last keyframe
+
+Ray tracing backends (Embree, OptiX) require motion keys at uniformly
+spaced times. The number of returned keys is chosen so that their
+spacing does not exceed the shortest interval between two keyframes
+(but at most ``max_keys``), hence uniformly spaced keyframes are
+reproduced exactly.)doc";
+
+static const char *__doc_mitsuba_AnimatedTransform_size = R"doc(Return the number of keyframes)doc";
+
+static const char *__doc_mitsuba_AnimatedTransform_to_string = R"doc(Return a human-readable summary of this animated transform)doc";
+
+static const char *__doc_mitsuba_AnimatedTransform_translation_bounds =
+R"doc(Return an axis-aligned box bounding the amount of translation
+throughout the animation sequence)doc";
+
 static const char *__doc_mitsuba_Appender =
 R"doc(This class defines an abstract destination for logging-relevant
 information)doc";
@@ -1085,7 +1180,14 @@ Parameter ``stream``:
     Pointer to an arbitrary stream data source
 
 Parameter ``format``:
-    File format to be read (PNG/EXR/Auto-detect ...))doc";
+    File format to be read (PNG/EXR/Auto-detect ...)
+
+Parameter ``max_resolution``:
+    When nonzero, images whose width or height exceeds this value are
+    downsampled by an integer factor while loading (e.g. to quickly
+    preview scenes with many large textures). JPEG files are directly
+    decoded at a reduced resolution using libjpeg's DCT scaling, and
+    other formats are box-filtered after loading.)doc";
 
 static const char *__doc_mitsuba_Bitmap_Bitmap_3 =
 R"doc(Load a bitmap from a given filename
@@ -1094,7 +1196,12 @@ Parameter ``path``:
     Name of the file to be loaded
 
 Parameter ``format``:
-    File format to be read (PNG/EXR/Auto-detect ...))doc";
+    File format to be read (PNG/EXR/Auto-detect ...)
+
+Parameter ``max_resolution``:
+    Maximum width and height of the loaded image (see the stream-based
+    constructor). The default value 0 loads the image at full
+    resolution.)doc";
 
 static const char *__doc_mitsuba_Bitmap_Bitmap_4 = R"doc(Copy constructor (copies the image contents))doc";
 
@@ -1115,6 +1222,20 @@ The following is supported:
 
 * Loading of uncompressed 8-bit luminance and RGBA bitmaps)doc";
 
+static const char *__doc_mitsuba_Bitmap_FileFormat_DDS =
+R"doc(DirectDraw Surface file format
+
+The following is supported:
+
+* Loading of the top MIP level of 2D textures compressed using BC6H
+(signed and unsigned), which are decoded into Float16 RGB bitmaps
+
+* Loading of the top MIP level of 2D textures compressed using BC7,
+which are decoded into UInt8 RGBA bitmaps
+
+The block compression format is recorded in the
+``block_compression`` metadata field of the bitmap.)doc";
+
 static const char *__doc_mitsuba_Bitmap_FileFormat_JPEG =
 R"doc(Joint Photographic Experts Group file format
 
@@ -1310,6 +1431,10 @@ static const char *__doc_mitsuba_Bitmap_data_2 = R"doc(Return a pointer to the u
 
 static const char *__doc_mitsuba_Bitmap_detect_file_format = R"doc(Attempt to detect the bitmap file format in a given stream)doc";
 
+static const char *__doc_mitsuba_Bitmap_downsample_box =
+R"doc(Downsample the image in-place by averaging blocks of ``factor^2``
+pixels)doc";
+
 static const char *__doc_mitsuba_Bitmap_has_alpha = R"doc(Return whether this image has an alpha channel)doc";
 
 static const char *__doc_mitsuba_Bitmap_height = R"doc(Return the bitmap's height in pixels)doc";
@@ -1350,11 +1475,39 @@ static const char *__doc_mitsuba_Bitmap_premultiplied_alpha = R"doc(Return wheth
 
 static const char *__doc_mitsuba_Bitmap_read = R"doc(Read a file from a stream)doc";
 
+static const char *__doc_mitsuba_Bitmap_read_batch =
+R"doc(Load several bitmaps from disk concurrently
+
+The files are decoded in parallel on Mitsuba's thread pool, which
+considerably speeds up the loading of texture-heavy scenes. OpenEXR
+files are additionally decompressed using multiple threads per file.
+The bitmaps are returned in the order of ``paths``. If any of the
+files can't be loaded, the first error is re-thrown once all other
+files were processed.
+
+Parameter ``paths``:
+    Names of the files to be loaded
+
+Parameter ``format``:
+    File format to be read (PNG/EXR/Auto-detect ...)
+
+Parameter ``max_resolution``:
+    Maximum width and height of the loaded images (see the stream-based
+    constructor). The default value 0 loads the images at full
+    resolution.)doc";
+
 static const char *__doc_mitsuba_Bitmap_read_bmp = R"doc(Read a file encoded using the BMP file format)doc";
 
+static const char *__doc_mitsuba_Bitmap_read_dds = R"doc(Read a file encoded using the DDS file format)doc";
+
 static const char *__doc_mitsuba_Bitmap_read_exr = R"doc(Read a file encoded using the OpenEXR file format)doc";
 
-static const char *__doc_mitsuba_Bitmap_read_jpeg = R"doc(Read a file encoded using the JPEG file format)doc";
+static const char *__doc_mitsuba_Bitmap_read_jpeg =
+R"doc(Read a file encoded using the JPEG file format
+
+When ``max_resolution`` is nonzero, the image is decoded at a reduced
+resolution (1/2, 1/4, or 1/8) that accounts for as much of the
+required downsampling as possible.)doc";
 
 static const char *__doc_mitsuba_Bitmap_read_pfm = R"doc(Read a file encoded using the PFM file format)doc";
 
@@ -1483,6 +1636,7 @@ Parameter ``quality``:
 * PNG images: Controls how much libpng will attempt to compress the
 output (with 1 being the lowest and 9 denoting the highest
 compression). The default argument uses the compression level 5.
+Large images are compressed in parallel chunks.
 
 * JPEG images: denotes the desired quality (between 0 and 100). The
 default argument (-1) uses the highest quality (100).
@@ -1491,7 +1645,9 @@ default argument (-1) uses the highest quality (100).
 with higher values corresponding to a lower quality. A value of 45 is
 recommended as the default for lossy compression. The default argument
 (-1) causes the implementation to switch to the lossless PIZ
-compressor.)doc";
+compressor. A different method can be requested via a ``compression``
+metadata string (e.g. ``zip``, ``dwaa``, or ``dwab``), in which case
+the quality only applies to the DWA compressors.)doc";
 
 static const char *__doc_mitsuba_Bitmap_write_2 =
 R"doc(Write an encoded form of the bitmap to a file using the specified file
@@ -1511,6 +1667,7 @@ Parameter ``quality``:
 * PNG images: Controls how much libpng will attempt to compress the
 output (with 1 being the lowest and 9 denoting the highest
 compression). The default argument uses the compression level 5.
+Large images are compressed in parallel chunks.
 
 * JPEG images: denotes the desired quality (between 0 and 100). The
 default argument (-1) uses the highest quality (100).
@@ -1519,7 +1676,9 @@ default argument (-1) uses the highest quality (100).
 with higher values corresponding to a lower quality. A value of 45 is
 recommended as the default for lossy compression. The default argument
 (-1) causes the implementation to switch to the lossless PIZ
-compressor.)doc";
+compressor. A different method can be requested via a ``compression``
+metadata string (e.g. ``zip``, ``dwaa``, or ``dwab``), in which case
+the quality only applies to the DWA compressors.)doc";
 
 static const char *__doc_mitsuba_Bitmap_write_async =
 R"doc(Equivalent to write(), but executes asynchronously on a different
@@ -1533,6 +1692,14 @@ static const char *__doc_mitsuba_Bitmap_write_pfm = R"doc(Save a file using the
 
 static const char *__doc_mitsuba_Bitmap_write_png = R"doc(Save a file using the PNG file format)doc";
 
+static const char *__doc_mitsuba_Bitmap_write_png_parallel =
+R"doc(Save a file using the PNG file format, compressing chunks of rows in
+parallel
+
+Each chunk is deflated independently, using the end of the preceding
+chunk as its dictionary, and the results are concatenated into a
+single zlib stream (as done by ``pigz``).)doc";
+
 static const char *__doc_mitsuba_Bitmap_write_ppm = R"doc(Save a file using the PPM file format)doc";
 
 static const char *__doc_mitsuba_Bitmap_write_rgbe = R"doc(Save a file using the RGBE file format)doc";
@@ -1730,6 +1897,94 @@ static const char *__doc_mitsuba_BoundingSphere_radius = R"doc()doc";
 
 static const char *__doc_mitsuba_BoundingSphere_ray_intersect = R"doc(Check if a ray intersects a bounding box)doc";
 
+static const char *__doc_mitsuba_BufferedFileStream =
+R"doc(Read-only Stream implementation backed by a file, which reads large
+blocks ahead of time on a background thread.
+
+Loaders often issue a large number of small read() calls, each of
+which amounts to a separate request to the operating system when using
+a FileStream. This class instead reads the file in blocks of a
+configurable size and serves the requests from memory. While one block
+is being consumed, the next one is read asynchronously, which hides the
+latency of slow (e.g. network) file systems for sequential accesses.
+Seeking outside of the current block discards the block being read
+ahead.)doc";
+
+static const char *__doc_mitsuba_BufferedFileStream_BufferedFileStream =
+R"doc(Constructs a new BufferedFileStream by opening the file pointed to by
+``p`` in read-only mode.
+
+Parameter ``buffer_size``:
+    Size of the blocks that are read from the file (in bytes). Two
+    blocks are held in memory at any time.
+
+Throws an exception if the file cannot be opened.)doc";
+
+static const char *__doc_mitsuba_BufferedFileStream_buffer_size = R"doc(Return the size of the blocks that are read from the file)doc";
+
+static const char *__doc_mitsuba_BufferedFileStream_can_read = R"doc(True except if the stream was closed.)doc";
+
+static const char *__doc_mitsuba_BufferedFileStream_can_write = R"doc(Always false, since the stream is read-only)doc";
+
+static const char *__doc_mitsuba_BufferedFileStream_class = R"doc()doc";
+
+static const char *__doc_mitsuba_BufferedFileStream_close =
+R"doc(Closes the stream and the underlying file. No further read operations
+are permitted.
+
+This function is idempotent. It is called automatically by the
+destructor.)doc";
+
+static const char *__doc_mitsuba_BufferedFileStream_flush = R"doc(Does nothing, since the stream is read-only)doc";
+
+static const char *__doc_mitsuba_BufferedFileStream_is_closed = R"doc(Whether the stream is closed (no read is then permitted).)doc";
+
+static const char *__doc_mitsuba_BufferedFileStream_m_back = R"doc(Block that is being read ahead)doc";
+
+static const char *__doc_mitsuba_BufferedFileStream_m_back_offset = R"doc(File offset of the back block)doc";
+
+static const char *__doc_mitsuba_BufferedFileStream_m_buffer_size = R"doc()doc";
+
+static const char *__doc_mitsuba_BufferedFileStream_m_file = R"doc(Only accessed by the pending read (if any))doc";
+
+static const char *__doc_mitsuba_BufferedFileStream_m_front = R"doc(Block that is currently being consumed)doc";
+
+static const char *__doc_mitsuba_BufferedFileStream_m_front_offset =
+R"doc(File offset and length of the front block, and read position within
+it)doc";
+
+static const char *__doc_mitsuba_BufferedFileStream_m_path = R"doc()doc";
+
+static const char *__doc_mitsuba_BufferedFileStream_m_pending = R"doc(Pending read of the back block (returns its length))doc";
+
+static const char *__doc_mitsuba_BufferedFileStream_m_size = R"doc()doc";
+
+static const char *__doc_mitsuba_BufferedFileStream_path =
+R"doc(Return the path descriptor associated with this BufferedFileStream)doc";
+
+static const char *__doc_mitsuba_BufferedFileStream_read =
+R"doc(Reads a specified amount of data from the stream. Throws an exception
+when the stream ended prematurely.)doc";
+
+static const char *__doc_mitsuba_BufferedFileStream_read_ahead =
+R"doc(Start reading the block at offset ``pos`` into the back buffer)doc";
+
+static const char *__doc_mitsuba_BufferedFileStream_seek =
+R"doc(Seeks to a position inside the stream. May throw if the resulting
+state is invalid.)doc";
+
+static const char *__doc_mitsuba_BufferedFileStream_size = R"doc(Returns the size of the file)doc";
+
+static const char *__doc_mitsuba_BufferedFileStream_swap_buffers = R"doc(Wait for the back buffer and swap it with the front buffer)doc";
+
+static const char *__doc_mitsuba_BufferedFileStream_tell = R"doc(Gets the current position inside the file)doc";
+
+static const char *__doc_mitsuba_BufferedFileStream_to_string = R"doc(Returns a string representation)doc";
+
+static const char *__doc_mitsuba_BufferedFileStream_truncate = R"doc(Always throws, since the stream is read-only)doc";
+
+static const char *__doc_mitsuba_BufferedFileStream_write = R"doc(Always throws, since the stream is read-only)doc";
+
 static const char *__doc_mitsuba_Class =
 R"doc(Stores meta-information about Object instances.
 
@@ -1911,6 +2166,8 @@ static const char *__doc_mitsuba_ContinuousDistribution_interval_resolution = R"
 
 static const char *__doc_mitsuba_ContinuousDistribution_m_cdf = R"doc()doc";
 
+static const char *__doc_mitsuba_ContinuousDistribution_m_cdf_guide = R"doc(Accelerates the search for the interval containing a sample)doc";
+
 static const char *__doc_mitsuba_ContinuousDistribution_m_integral = R"doc()doc";
 
 static const char *__doc_mitsuba_ContinuousDistribution_m_interval_size = R"doc()doc";
@@ -2115,7 +2372,13 @@ and provides various routines for transforming uniformly distributed
 samples so that they follow the stored distribution. Note that
 unnormalized probability mass functions (PMFs) will automatically be
 normalized during initialization. The associated scale factor can be
-retrieved using the function normalization().)doc";
+retrieved using the function normalization().
+
+By default, samples are generated by inverting the cumulative
+distribution function using a binary search. Alternatively, an alias
+table can be enabled via set_alias_table(), with which every sample
+costs a constant number of lookups regardless of the size of the
+distribution.)doc";
 
 static const char *__doc_mitsuba_DiscreteDistribution2D =
 R"doc(======================================================================
@@ -2224,6 +2487,8 @@ static const char *__doc_mitsuba_DiscreteDistribution_cdf_2 =
 R"doc(Return the unnormalized cumulative distribution function (const
 version))doc";
 
+static const char *__doc_mitsuba_DiscreteDistribution_compute_alias_table = R"doc(Build the alias table (Vose's algorithm) on the host)doc";
+
 static const char *__doc_mitsuba_DiscreteDistribution_compute_cdf = R"doc()doc";
 
 static const char *__doc_mitsuba_DiscreteDistribution_compute_cdf_scalar = R"doc()doc";
@@ -2246,6 +2511,18 @@ static const char *__doc_mitsuba_DiscreteDistribution_eval_pmf_normalized =
 R"doc(Evaluate the normalized probability mass function (PMF) at index
 ``index``)doc";
 
+static const char *__doc_mitsuba_DiscreteDistribution_has_alias_table = R"doc(Does this distribution sample using an alias table?)doc";
+
+static const char *__doc_mitsuba_DiscreteDistribution_m_alias = R"doc(Alias table: probability of keeping a bin, and its alias)doc";
+
+static const char *__doc_mitsuba_DiscreteDistribution_m_alias_index = R"doc()doc";
+
+static const char *__doc_mitsuba_DiscreteDistribution_m_alias_last = R"doc()doc";
+
+static const char *__doc_mitsuba_DiscreteDistribution_m_alias_prob = R"doc()doc";
+
+static const char *__doc_mitsuba_DiscreteDistribution_m_alias_size = R"doc()doc";
+
 static const char *__doc_mitsuba_DiscreteDistribution_m_cdf = R"doc()doc";
 
 static const char *__doc_mitsuba_DiscreteDistribution_m_normalization = R"doc()doc";
@@ -2271,6 +2548,10 @@ Parameter ``sample``:
 Returns:
     The discrete index associated with the sample)doc";
 
+static const char *__doc_mitsuba_DiscreteDistribution_sample_alias =
+R"doc(Sample the alias table. Returns the index and the sample value, which
+is re-scaled so that it can be reused as a uniform variate.)doc";
+
 static const char *__doc_mitsuba_DiscreteDistribution_sample_pmf =
 R"doc(%Transform a uniformly distributed sample to the stored distribution
 
@@ -2313,6 +2594,17 @@ Returns:
 1. the discrete index associated with the sample 2. the re-scaled
 sample value 3. the normalized probability value of the sample)doc";
 
+static const char *__doc_mitsuba_DiscreteDistribution_set_alias_table =
+R"doc(Enable or disable sampling using an alias table
+
+When enabled, sample() and its variants use Walker's alias method
+instead of inverting the CDF. This replaces the binary search (a chain
+of dependent lookups) by two lookups per sample. The table is built
+using Vose's algorithm and kept up to date by update().
+
+Note that the resulting mapping from samples to indices is not
+monotonic, which reduces the benefit of stratified sample patterns.)doc";
+
 static const char *__doc_mitsuba_DiscreteDistribution_size = R"doc(Return the number of entries)doc";
 
 static const char *__doc_mitsuba_DiscreteDistribution_sum = R"doc(Return the original sum of PMF entries before normalization)doc";
@@ -2776,7 +3068,13 @@ R"doc(Simple class for resolving paths on Linux/Windows/Mac OS
 
 This convenience class looks for a file or directory given its name
 and a set of search paths. The implementation walks through the search
-paths in order and stops once the file is found.)doc";
+paths in order and stops once the file is found.
+
+Successful lookups are cached, so that resolving the same name again
+doesn't query the file system (which can be slow on network storage).
+The cache is thread-safe and cleared whenever the list of search paths
+changes. Files that are moved or deleted after having been resolved
+require a call to clear_cache().)doc";
 
 static const char *__doc_mitsuba_FileResolver_FileResolver = R"doc(Initialize a new file resolver with the current working directory)doc";
 
@@ -2794,6 +3092,8 @@ static const char *__doc_mitsuba_FileResolver_class = R"doc()doc";
 
 static const char *__doc_mitsuba_FileResolver_clear = R"doc(Clear the list of search paths)doc";
 
+static const char *__doc_mitsuba_FileResolver_clear_cache = R"doc(Discard all cached lookups and directory listings)doc";
+
 static const char *__doc_mitsuba_FileResolver_contains = R"doc(Check if a given path is included in the search path list)doc";
 
 static const char *__doc_mitsuba_FileResolver_end = R"doc(Return an iterator at the end of the list of search paths)doc";
@@ -2804,12 +3104,28 @@ static const char *__doc_mitsuba_FileResolver_erase = R"doc(Erase the entry at t
 
 static const char *__doc_mitsuba_FileResolver_erase_2 = R"doc(Erase the search path from the list)doc";
 
+static const char *__doc_mitsuba_FileResolver_m_cache = R"doc()doc";
+
+static const char *__doc_mitsuba_FileResolver_m_listings = R"doc()doc";
+
+static const char *__doc_mitsuba_FileResolver_m_mutex = R"doc()doc";
+
 static const char *__doc_mitsuba_FileResolver_m_paths = R"doc()doc";
 
 static const char *__doc_mitsuba_FileResolver_operator_array = R"doc(Return an entry from the list of search paths)doc";
 
 static const char *__doc_mitsuba_FileResolver_operator_array_2 = R"doc(Return an entry from the list of search paths (const))doc";
 
+static const char *__doc_mitsuba_FileResolver_prefetch =
+R"doc(List the contents of all search paths
+
+Subsequent calls to resolve() only check the search paths whose
+listing contains the first component of the requested path, which
+saves a file system query per search path that doesn't contain it.
+Entries that are created after this call are therefore only found once
+the listings are discarded, which happens when the search paths change
+or clear_cache() is called.)doc";
+
 static const char *__doc_mitsuba_FileResolver_prepend = R"doc(Prepend an entry at the beginning of the list of search paths)doc";
 
 static const char *__doc_mitsuba_FileResolver_resolve =
@@ -2928,6 +3244,10 @@ the Image Block.)doc";
 
 static const char *__doc_mitsuba_FilmFlags_Spectral = R"doc(The film stores a spectral representation of the image)doc";
 
+static const char *__doc_mitsuba_FilmFlags_Streaming =
+R"doc(The film streams finished rows to disk and cannot be developed in
+memory. Blocks must be committed once per pixel and in scanline order.)doc";
+
 static const char *__doc_mitsuba_Film_Film = R"doc(Create a film)doc";
 
 static const char *__doc_mitsuba_Film_base_channels_count = R"doc(Return the number of channels for the developed image (excluding AOVS))doc";
@@ -2963,6 +3283,31 @@ static const char *__doc_mitsuba_Film_crop_size = R"doc(Return the size of the c
 
 static const char *__doc_mitsuba_Film_develop = R"doc(Return a image buffer object storing the developed image)doc";
 
+static const char *__doc_mitsuba_Film_develop_preview =
+R"doc(Develop the film into a compact image for display purposes
+
+Compared to bitmap() followed by Bitmap::convert(), the normalization
+by the weight channel, the exposure adjustment, tone mapping, and
+conversion to the output format are fused into a single pass. In JIT
+variants, it runs on the device and only the final image is copied to
+the host. AOV channels are never accessed.
+
+Parameter ``exposure``:
+    Exposure adjustment in stops (the values are scaled by
+    ``2^exposure``)
+
+Parameter ``aces``:
+    Apply the (fitted) ACES filmic tone mapping curve
+
+Parameter ``component_format``:
+    Either ``Struct::Type::UInt8``, which produces sRGB-encoded values
+    clamped to ``[0, 1]``, or ``Struct::Type::Float16``, which produces
+    linear values.
+
+Returns:
+    An RGB or RGBA bitmap, depending on whether the film stores an
+    alpha channel)doc";
+
 static const char *__doc_mitsuba_Film_flags = R"doc(Flags for all properties combined.)doc";
 
 static const char *__doc_mitsuba_Film_m_crop_offset = R"doc()doc";
@@ -3063,11 +3408,21 @@ static const char *__doc_mitsuba_Film_size =
 R"doc(Ignoring the crop window, return the resolution of the underlying
 sensor)doc";
 
+static const char *__doc_mitsuba_Film_storage =
+R"doc(Return the image block that accumulates the samples (if any))doc";
+
 static const char *__doc_mitsuba_Film_to_string = R"doc(//! @})doc";
 
 static const char *__doc_mitsuba_Film_traverse = R"doc()doc";
 
-static const char *__doc_mitsuba_Film_write = R"doc(Write the developed contents of the film to a file on disk)doc";
+static const char *__doc_mitsuba_Film_write =
+R"doc(Write the developed contents of the film to a file on disk
+
+Parameter ``write_async``:
+    When set, the image is developed on the calling thread but encoded
+    and written to disk by a background task (see Bitmap::write_async()),
+    so that the caller can proceed with further work in the meantime.
+    Pending writes are completed by Thread::wait_for_tasks().)doc";
 
 static const char *__doc_mitsuba_FilterBoundaryCondition =
 R"doc(When resampling data to a different resolution using
@@ -3332,6 +3687,81 @@ Returns the warped sample and associated probability density.)doc";
 
 static const char *__doc_mitsuba_Hierarchical2D_to_string = R"doc()doc";
 
+static const char *__doc_mitsuba_HybridRenderer =
+R"doc(Renders a scene using the CPU and a GPU at the same time
+
+The scene is loaded twice: once in an LLVM variant that renders on the
+CPU, and once in a CUDA variant that renders on the GPU. Both replicas
+render passes of the same image concurrently, and their accumulated
+raw film contents are finally merged into the film of the CUDA
+replica, which develops the image.
+
+Samples are assigned in proportion to the throughput of each side,
+which is measured during the render. Each side starts with a single
+sample per pixel and afterwards requests passes that take roughly
+``pass_time`` seconds at its current speed. Near the end of the
+render, a side only receives its share of the remaining samples
+(proportional to its throughput), and a slower side that would not
+complete a single sample per pixel in that time stops, so that it
+does not delay the completion of the render.
+
+Since the assignment of passes depends on timing, results of different
+renders with the same seed are not bitwise identical. The LLVM variant
+uses all worker threads of the thread pool (see
+Thread::set_thread_count()).)doc";
+
+static const char *__doc_mitsuba_HybridRenderer_BackendStats = R"doc(Statistics of one side (CPU or GPU) gathered during the last render)doc";
+
+static const char *__doc_mitsuba_HybridRenderer_BackendStats_busy_time = R"doc(Time spent rendering passes (in seconds))doc";
+
+static const char *__doc_mitsuba_HybridRenderer_BackendStats_passes = R"doc(Number of passes rendered by this side)doc";
+
+static const char *__doc_mitsuba_HybridRenderer_BackendStats_spp = R"doc(Number of samples per pixel rendered by this side)doc";
+
+static const char *__doc_mitsuba_HybridRenderer_BackendStats_throughput = R"doc(Number of samples rendered per second of busy time)doc";
+
+static const char *__doc_mitsuba_HybridRenderer_BackendStats_utilization = R"doc(Fraction of the total render time spent rendering passes)doc";
+
+static const char *__doc_mitsuba_HybridRenderer_BackendStats_variant = R"doc(Variant used by this side)doc";
+
+static const char *__doc_mitsuba_HybridRenderer_HybridRenderer =
+R"doc(Load the scene in an LLVM and a CUDA variant
+
+Parameter ``filename``:
+    Filename of the scene XML file
+
+Parameter ``cpu_variant``:
+    Name of an LLVM variant (e.g. ``"llvm_ad_rgb"``)
+
+Parameter ``gpu_variant``:
+    Name of a CUDA variant with the same color representation (e.g.
+    ``"cuda_ad_rgb"``)
+
+Parameter ``defines``:
+    Parameters that can be referenced as ``$key`` within the scene
+    description.)doc";
+
+static const char *__doc_mitsuba_HybridRenderer_backend_stats = R"doc(Return the statistics of the CPU and GPU side during the last render)doc";
+
+static const char *__doc_mitsuba_HybridRenderer_render =
+R"doc(Render the specified sensor on both sides and return the developed
+image
+
+Parameter ``seed``:
+    Base seed of the render. Every pass uses a distinct seed derived
+    from it.
+
+Parameter ``spp``:
+    Total number of samples per pixel, or 0 to use the sampler's
+    default.
+
+Parameter ``pass_time``:
+    Targeted duration of a single pass (in seconds). Shorter passes
+    adapt faster to the measured throughput, while longer passes
+    utilize the GPU better.)doc";
+
+static const char *__doc_mitsuba_HybridRenderer_scene = R"doc(Return the scene of the CPU (index 0) or GPU (index 1) side)doc";
+
 static const char *__doc_mitsuba_IOREntry = R"doc()doc";
 
 static const char *__doc_mitsuba_IOREntry_name = R"doc()doc";
@@ -3468,6 +3898,15 @@ the read() function.
 
 See the other constructor for an explanation of the parameters.)doc";
 
+static const char *__doc_mitsuba_ImageBlock_ImageBlock_3 =
+R"doc(Construct an image block from a binary stream
+
+This reads the offset, size, border size, channel count, and raw
+contents previously written via write(). The resulting block has no
+reconstruction filter and is mainly intended to be merged into another
+block or film via put_block(), e.g. after transferring it over the
+network.)doc";
+
 static const char *__doc_mitsuba_ImageBlock_accum = R"doc()doc";
 
 static const char *__doc_mitsuba_ImageBlock_border_size = R"doc(Return the border region used by the reconstruction filter)doc";
@@ -3510,6 +3949,9 @@ static const char *__doc_mitsuba_ImageBlock_m_warn_invalid = R"doc()doc";
 
 static const char *__doc_mitsuba_ImageBlock_m_warn_negative = R"doc()doc";
 
+static const char *__doc_mitsuba_ImageBlock_memory_usage =
+R"doc(Return the host and device memory used by the image block (in bytes))doc";
+
 static const char *__doc_mitsuba_ImageBlock_normalize = R"doc(Re-normalize filter weights in put() and read())doc";
 
 static const char *__doc_mitsuba_ImageBlock_offset = R"doc(Return the current block offset)doc";
@@ -3564,6 +4006,8 @@ Parameter ``values``:
     the result of the read operation for each channel. In Python, the
     function returns these values as a list.)doc";
 
+static const char *__doc_mitsuba_ImageBlock_replicas = R"doc(Return the number of image copies used by put() in JIT variants)doc";
+
 static const char *__doc_mitsuba_ImageBlock_rfilter = R"doc(Return the image reconstruction filter underlying the ImageBlock)doc";
 
 static const char *__doc_mitsuba_ImageBlock_set_coalesce = R"doc(Try to coalesce reads/writes in JIT modes?)doc";
@@ -3579,6 +4023,18 @@ This corresponds to the offset from the top-left corner of a larger
 image (e.g. a Film) to the top-left corner of this ImageBlock
 instance.)doc";
 
+static const char *__doc_mitsuba_ImageBlock_set_replicas =
+R"doc(Spread the atomic writes of put() over several copies of the image in
+JIT variants
+
+Each lane of the wavefront accumulates into the copy given by its
+index modulo ``value``. This reduces the contention of atomic memory
+operations when many samples target the same pixels (e.g. caustics in
+a particle tracer), at the cost of ``value`` times the memory. The
+copies are summed when tensor() is accessed. A value of ``1`` (the
+default) disables this. Not used in combination with error-compensated
+accumulation.)doc";
+
 static const char *__doc_mitsuba_ImageBlock_set_size = R"doc(Set the block size. This potentially destroys the block's content.)doc";
 
 static const char *__doc_mitsuba_ImageBlock_set_warn_invalid = R"doc(Warn when writing invalid (NaN, +/- infinity) sample values?)doc";
@@ -3599,6 +4055,8 @@ static const char *__doc_mitsuba_ImageBlock_warn_negative = R"doc(Warn when writ
 
 static const char *__doc_mitsuba_ImageBlock_width = R"doc(Return the bitmap's width in pixels)doc";
 
+static const char *__doc_mitsuba_ImageBlock_write = R"doc(Serialize the image block (including its border region) to a stream)doc";
+
 static const char *__doc_mitsuba_Integrator =
 R"doc(Abstract integrator base class, which does not make any assumptions
 with regards to how radiance is computed.
@@ -3754,6 +4212,35 @@ This function is just a thin wrapper around the previous
 render_backward() function. It accepts a sensor *index* instead and
 renders the scene using sensor 0 by default.)doc";
 
+static const char *__doc_mitsuba_Integrator_render_ensemble =
+R"doc(Render an ensemble of statistically independent images of the scene
+
+This is useful to estimate the variance of a rendering (or of a
+quantity derived from it) without issuing ``ensemble_size`` separate
+render() calls. The default implementation does exactly that, using
+the seeds ``seed, seed + 1, ...``. The SamplingIntegrator instead
+renders all members within a single wavefront in JIT variants, which
+shares the setup of the sensor and of the scene and launches a single
+rendering kernel.
+
+Afterwards, ``sensor->film()`` holds the last member of the ensemble.
+
+Parameter ``ensemble_size``:
+    Number of images to render.
+
+The other parameters have the same meaning as in render().
+
+Returns:
+    A tensor of shape ``(ensemble_size, height, width, channels)``,
+    whose leading index selects the member.)doc";
+
+static const char *__doc_mitsuba_Integrator_render_ensemble_2 =
+R"doc(Render an ensemble of statistically independent images of the scene
+
+This function is just a thin wrapper around the previous
+render_ensemble() overload. It accepts a sensor *index* instead and
+renders the scene using sensor 0 by default.)doc";
+
 static const char *__doc_mitsuba_Integrator_render_forward =
 R"doc(Evaluates the forward-mode derivative of the rendering step.
 
@@ -3836,6 +4323,9 @@ enforced accurately.
 Note that accurate timeouts rely on m_render_timer, which needs to be
 reset at the beginning of the rendering phase.)doc";
 
+static const char *__doc_mitsuba_Integrator_stack_images =
+R"doc(Stack images of identical shape along a new leading dimension)doc";
+
 static const char *__doc_mitsuba_Interaction = R"doc(Generic surface interaction data structure)doc";
 
 static const char *__doc_mitsuba_Interaction_Interaction = R"doc(Constructor)doc";
@@ -3896,6 +4386,56 @@ fields that deviate from the standard zero-initialization convention.
 In this particular class, the ``t`` field should be set to an infinite
 value to mark invalid intersection records.)doc";
 
+static const char *__doc_mitsuba_IntervalGuide =
+R"doc(Guide table that accelerates the search for the interval containing a
+value within a nondecreasing array
+
+The continuous distributions below locate intervals (within their
+nodes or their CDF) using a binary search, which requires a chain of
+dependent lookups per query. This table partitions the range of the
+array into equally sized cells and records the range of entries that
+fall into each one of them. A query is mapped to its cell in a single
+step, after which only the entries of that cell are searched using a
+fixed number of bisection steps. The result is identical to that of a
+binary search over the whole array.)doc";
+
+static const char *__doc_mitsuba_IntervalGuide_IntervalGuide = R"doc(Create an empty guide table)doc";
+
+static const char *__doc_mitsuba_IntervalGuide_IntervalGuide_2 =
+R"doc(Build the guide table for a nondecreasing array stored on the host)doc";
+
+static const char *__doc_mitsuba_IntervalGuide_IntervalGuide_3 =
+R"doc(Build the guide table for a nondecreasing array (may reside on the
+device))doc";
+
+static const char *__doc_mitsuba_IntervalGuide_build = R"doc()doc";
+
+static const char *__doc_mitsuba_IntervalGuide_cell = R"doc(Map a value to its cell (monotonic in ``value``))doc";
+
+static const char *__doc_mitsuba_IntervalGuide_empty = R"doc(Is the guide table empty/uninitialized?)doc";
+
+static const char *__doc_mitsuba_IntervalGuide_find =
+R"doc(Find the first index in ``[start, end)`` for which ``pred`` is false,
+or ``end`` if there is none
+
+This is equivalent to ``dr::binary_search(start, end, pred)``, where
+the predicate must be of the form ``data[index] < value``. Additional
+conditions may only change its result for entries that are equal to
+``value``. The predicate receives a mask of the lanes that are still
+searching.)doc";
+
+static const char *__doc_mitsuba_IntervalGuide_iterations = R"doc(Return the number of bisection steps performed by find())doc";
+
+static const char *__doc_mitsuba_IntervalGuide_m_iterations = R"doc()doc";
+
+static const char *__doc_mitsuba_IntervalGuide_m_last_cell = R"doc()doc";
+
+static const char *__doc_mitsuba_IntervalGuide_m_min = R"doc()doc";
+
+static const char *__doc_mitsuba_IntervalGuide_m_offsets = R"doc(Number of entries that map to the cells preceding each cell)doc";
+
+static const char *__doc_mitsuba_IntervalGuide_m_scale = R"doc()doc";
+
 static const char *__doc_mitsuba_IrregularContinuousDistribution =
 R"doc(Continuous 1D probability distribution defined in terms of an
 *irregularly* sampled linear interpolant
@@ -3955,12 +4495,17 @@ static const char *__doc_mitsuba_IrregularContinuousDistribution_interval_resolu
 
 static const char *__doc_mitsuba_IrregularContinuousDistribution_m_cdf = R"doc()doc";
 
+static const char *__doc_mitsuba_IrregularContinuousDistribution_m_cdf_guide = R"doc()doc";
+
 static const char *__doc_mitsuba_IrregularContinuousDistribution_m_integral = R"doc()doc";
 
 static const char *__doc_mitsuba_IrregularContinuousDistribution_m_interval_size = R"doc()doc";
 
 static const char *__doc_mitsuba_IrregularContinuousDistribution_m_max = R"doc()doc";
 
+static const char *__doc_mitsuba_IrregularContinuousDistribution_m_node_guide =
+R"doc(Accelerate the search for the interval containing a position or sample)doc";
+
 static const char *__doc_mitsuba_IrregularContinuousDistribution_m_nodes = R"doc()doc";
 
 static const char *__doc_mitsuba_IrregularContinuousDistribution_m_normalization = R"doc()doc";
@@ -4072,8 +4617,12 @@ static const char *__doc_mitsuba_Logger_class = R"doc()doc";
 
 static const char *__doc_mitsuba_Logger_clear_appenders = R"doc(Remove all appenders from this logger)doc";
 
+static const char *__doc_mitsuba_Logger_asynchronous = R"doc(Return whether asynchronous logging is enabled)doc";
+
 static const char *__doc_mitsuba_Logger_d = R"doc()doc";
 
+static const char *__doc_mitsuba_Logger_flush = R"doc(Forward all queued messages to the appenders (asynchronous mode))doc";
+
 static const char *__doc_mitsuba_Logger_error_level = R"doc(Return the current error level)doc";
 
 static const char *__doc_mitsuba_Logger_formatter = R"doc(Return the logger's formatter implementation)doc";
@@ -4130,6 +4679,16 @@ R"doc(Return the contents of the log file as a string
 
 Throws a runtime exception upon failure)doc";
 
+static const char *__doc_mitsuba_Logger_set_asynchronous =
+R"doc(Enable or disable asynchronous logging
+
+In asynchronous mode, log() formats the message on the calling thread
+and places it into a lock-free queue, from which a background thread
+forwards it to the appenders. This keeps slow appenders (e.g. file
+output at the ``Debug`` or ``Trace`` level) off the render threads.
+The queue is flushed before an error is raised, before progress
+messages, and when asynchronous mode is disabled.)doc";
+
 static const char *__doc_mitsuba_Logger_remove_appender = R"doc(Remove an appender from this logger)doc";
 
 static const char *__doc_mitsuba_Logger_set_error_level =
@@ -4208,6 +4767,12 @@ not construct the cdf needed for sample warping, which saves memory in
 case this functionality is not needed (e.g. if only the interpolation
 in ``eval()`` is used).)doc";
 
+static const char *__doc_mitsuba_Marginal2D_Marginal2D_3 =
+R"doc(Construct a marginal sample warping scheme from the tables that were
+previously written to ``stream`` by write(). This skips the
+construction of the CDFs. The remaining arguments must match those of
+the instance that wrote the tables.)doc";
+
 static const char *__doc_mitsuba_Marginal2D_eval =
 R"doc(Evaluate the density at position ``pos``. The distribution is
 parameterized by ``param`` if applicable.)doc";
@@ -4220,18 +4785,24 @@ static const char *__doc_mitsuba_Marginal2D_invert_discrete = R"doc()doc";
 
 static const char *__doc_mitsuba_Marginal2D_invert_segment = R"doc()doc";
 
+static const char *__doc_mitsuba_Marginal2D_is_half_precision = R"doc(Are the density values stored in half precision?)doc";
+
 static const char *__doc_mitsuba_Marginal2D_lookup = R"doc()doc";
 
 static const char *__doc_mitsuba_Marginal2D_m_cond_cdf = R"doc()doc";
 
 static const char *__doc_mitsuba_Marginal2D_m_data = R"doc(Density values)doc";
 
+static const char *__doc_mitsuba_Marginal2D_m_data_half = R"doc(Density values in half precision (replaces m_data if set))doc";
+
 static const char *__doc_mitsuba_Marginal2D_m_marg_cdf = R"doc(Marginal and conditional PDFs)doc";
 
 static const char *__doc_mitsuba_Marginal2D_m_normalized = R"doc(Are the probability values normalized?)doc";
 
 static const char *__doc_mitsuba_Marginal2D_m_size = R"doc(Resolution of the discretized density function)doc";
 
+static const char *__doc_mitsuba_Marginal2D_read_storage = R"doc()doc";
+
 static const char *__doc_mitsuba_Marginal2D_sample =
 R"doc(Given a uniformly distributed 2D sample, draw a sample from the
 distribution (parameterized by ``param`` if applicable)
@@ -4244,8 +4815,20 @@ static const char *__doc_mitsuba_Marginal2D_sample_discrete = R"doc()doc";
 
 static const char *__doc_mitsuba_Marginal2D_sample_segment = R"doc()doc";
 
+static const char *__doc_mitsuba_Marginal2D_set_half_precision =
+R"doc(Store the density values in half precision
+
+This halves the memory footprint of the density values at the cost of
+precision. It is only supported by instances that were constructed
+with ``enable_sampling=false``, i.e. that only interpolate the values
+via eval().)doc";
+
 static const char *__doc_mitsuba_Marginal2D_to_string = R"doc()doc";
 
+static const char *__doc_mitsuba_Marginal2D_write = R"doc(Write the precomputed tables of this instance to a stream)doc";
+
+static const char *__doc_mitsuba_Marginal2D_write_storage = R"doc()doc";
+
 static const char *__doc_mitsuba_Medium = R"doc()doc";
 
 static const char *__doc_mitsuba_Medium_2 = R"doc()doc";
@@ -4314,10 +4897,46 @@ static const char *__doc_mitsuba_Medium_Medium = R"doc()doc";
 
 static const char *__doc_mitsuba_Medium_Medium_2 = R"doc()doc";
 
+static const char *__doc_mitsuba_Medium_bbox =
+R"doc(Returns the world-space bounding box of the medium
+
+The default implementation returns an invalid bounding box, which
+indicates that the medium isn't bounded (e.g. homogeneous media).)doc";
+
 static const char *__doc_mitsuba_Medium_class = R"doc()doc";
 
+static const char *__doc_mitsuba_Medium_emitter =
+R"doc(Return the emitter that samples the emission of this medium using next
+event estimation (if any)
+
+When set, integrators only account for the emission of the medium at
+collisions along rays that didn't sample emitters at their origin.)doc";
+
+static const char *__doc_mitsuba_Medium_get_control_extinction =
+R"doc(Returns the control extinction used by residual ratio tracking
+
+Residual ratio tracking splits the extinction into a control
+extinction, whose transmittance is evaluated analytically, and a
+residual that is estimated by ratio tracking. The control extinction
+is constant along rays and must not exceed the extinction anywhere
+within the medium's bounding box. Integrators multiply the null
+collision weights by ``sigma_n + sigma_c`` instead of ``sigma_n`` and
+apply ``exp(-sigma_c * t)`` for every distance ``t`` travelled through
+the bounding box.
+
+The control extinction is zero unless residual ratio tracking was
+selected, in which case both estimators coincide.)doc";
+
 static const char *__doc_mitsuba_Medium_get_majorant = R"doc(Returns the medium's majorant used for delta tracking)doc";
 
+static const char *__doc_mitsuba_Medium_get_radiance =
+R"doc(Returns the radiance emitted by the medium at ``mi``
+
+The emission coefficient (emitted radiance per unit length) is the
+product of this value and the absorption coefficient ``sigma_t -
+sigma_s``, so that optically thick regions glow with the returned
+radiance. The default implementation returns zero.)doc";
+
 static const char *__doc_mitsuba_Medium_get_scattering_coefficients =
 R"doc(Returns the medium coefficients Sigma_s, Sigma_n and Sigma_t evaluated
 at a given MediumInteraction mi)doc";
@@ -4328,18 +4947,26 @@ static const char *__doc_mitsuba_Medium_id = R"doc(Return a string identifier)do
 
 static const char *__doc_mitsuba_Medium_intersect_aabb = R"doc(Intersects a ray with the medium's bounding box)doc";
 
+static const char *__doc_mitsuba_Medium_is_emitter = R"doc(Returns whether this medium emits light)doc";
+
 static const char *__doc_mitsuba_Medium_is_homogeneous = R"doc(Returns whether this medium is homogeneous)doc";
 
+static const char *__doc_mitsuba_Medium_m_emitter = R"doc(Emitter that samples the emission of this medium (not owned))doc";
+
 static const char *__doc_mitsuba_Medium_m_has_spectral_extinction = R"doc()doc";
 
 static const char *__doc_mitsuba_Medium_m_id = R"doc(Identifier (if available))doc";
 
+static const char *__doc_mitsuba_Medium_m_is_emitter = R"doc()doc";
+
 static const char *__doc_mitsuba_Medium_m_is_homogeneous = R"doc()doc";
 
 static const char *__doc_mitsuba_Medium_m_phase_function = R"doc()doc";
 
 static const char *__doc_mitsuba_Medium_m_sample_emitters = R"doc()doc";
 
+static const char *__doc_mitsuba_Medium_m_transmittance_estimator = R"doc()doc";
+
 static const char *__doc_mitsuba_Medium_operator_delete = R"doc()doc";
 
 static const char *__doc_mitsuba_Medium_operator_delete_2 = R"doc()doc";
@@ -4373,10 +5000,14 @@ Returns:
     will always be valid, except if the ray missed the Medium's
     bounding box.)doc";
 
+static const char *__doc_mitsuba_Medium_set_emitter = R"doc(Set the emitter that samples the emission of this medium)doc";
+
 static const char *__doc_mitsuba_Medium_set_id = R"doc(Set a string identifier)doc";
 
 static const char *__doc_mitsuba_Medium_to_string = R"doc(Return a human-readable representation of the Medium)doc";
 
+static const char *__doc_mitsuba_Medium_transmittance_estimator = R"doc(Returns the estimator used for the transmittance along shadow rays)doc";
+
 static const char *__doc_mitsuba_Medium_transmittance_eval_pdf =
 R"doc(Compute the transmittance and PDF
 
@@ -4584,7 +5215,11 @@ R"doc(/brief Build directed edge data structure to efficiently access
 adjacent edges.
 
 This is an implementation of the technique described in:
-``https://www.graphics.rwth-aachen.de/media/papers/directed.pdf``.)doc";
+``https://www.graphics.rwth-aachen.de/media/papers/directed.pdf``.
+
+The directed edges are matched by sorting them by their undirected
+edge using a parallel radix sort on the host. Edges shared by more
+than two faces are treated as boundary edges.)doc";
 
 static const char *__doc_mitsuba_Mesh_build_indirect_silhouette_distribution =
 R"doc(/brief Precompute the set of edges that could contribute to the
@@ -4635,12 +5270,33 @@ static const char *__doc_mitsuba_Mesh_face_indices = R"doc(Returns the vertex in
 
 static const char *__doc_mitsuba_Mesh_face_normal = R"doc(Returns the normal direction of the face with index ``index``)doc";
 
+static const char *__doc_mitsuba_Mesh_face_position_sample =
+R"doc(Fill the position sample of the given face and barycentric coordinates)doc";
+
 static const char *__doc_mitsuba_Mesh_faces_buffer = R"doc(Return face indices buffer)doc";
 
 static const char *__doc_mitsuba_Mesh_faces_buffer_2 = R"doc(Const variant of faces_buffer.)doc";
 
 static const char *__doc_mitsuba_Mesh_has_attribute = R"doc()doc";
 
+static const char *__doc_mitsuba_Mesh_decoded_vertex_normals =
+R"doc(Return the vertex normals as a flat floating point buffer
+
+Unlike vertex_normals_buffer(), this also works for meshes with
+compact vertex attributes, whose normals are then decoded.)doc";
+
+static const char *__doc_mitsuba_Mesh_decoded_vertex_texcoords =
+R"doc(Analogous to decoded_vertex_normals() for texture coordinates)doc";
+
+static const char *__doc_mitsuba_Mesh_has_compact_vertex_attributes =
+R"doc(Does this mesh store its vertex normals and texture coordinates in
+compact form?
+
+In this case, normals are octahedral-encoded using 2x16 bits and
+texture coordinates are stored as pairs of half precision values. Both
+are decoded on the fly by vertex_normal() and vertex_texcoord(), and
+cannot be modified or differentiated.)doc";
+
 static const char *__doc_mitsuba_Mesh_has_face_normals = R"doc(Does this mesh use face normals?)doc";
 
 static const char *__doc_mitsuba_Mesh_has_mesh_attributes = R"doc(Does this mesh have additional mesh attributes?)doc";
@@ -4653,8 +5309,18 @@ static const char *__doc_mitsuba_Mesh_initialize = R"doc(Must be called at the e
 
 static const char *__doc_mitsuba_Mesh_interpolate_attribute = R"doc()doc";
 
+static const char *__doc_mitsuba_Mesh_interpolate_vertex_motion =
+R"doc(Linearly interpolate the position of a vertex between the keyframes
+enclosing ``time``
+
+``positions`` holds keyframe 0 and ``motion`` the remaining ones (see
+vertex_motion_positions_buffer()). Both are either buffers or raw
+pointers.)doc";
+
 static const char *__doc_mitsuba_Mesh_invert_silhouette_sample = R"doc()doc";
 
+static const char *__doc_mitsuba_Mesh_is_animated = R"doc(Does this mesh deform over time? (see motion_key_count()))doc";
+
 static const char *__doc_mitsuba_Mesh_m_E2E = R"doc(Directed edges data structures to support neighbor queries)doc";
 
 static const char *__doc_mitsuba_Mesh_m_E2E_outdated = R"doc()doc";
@@ -4675,6 +5341,9 @@ static const char *__doc_mitsuba_Mesh_m_flip_normals = R"doc()doc";
 
 static const char *__doc_mitsuba_Mesh_m_mesh_attributes = R"doc()doc";
 
+static const char *__doc_mitsuba_Mesh_m_motion_keys =
+R"doc(Number of keyframes of the vertex positions (see motion_key_count()))doc";
+
 static const char *__doc_mitsuba_Mesh_m_mutex = R"doc()doc";
 
 static const char *__doc_mitsuba_Mesh_m_name = R"doc()doc";
@@ -4691,6 +5360,12 @@ static const char *__doc_mitsuba_Mesh_m_vertex_buffer_ptr = R"doc()doc";
 
 static const char *__doc_mitsuba_Mesh_m_vertex_count = R"doc()doc";
 
+static const char *__doc_mitsuba_Mesh_m_vertex_motion_buffer_ptrs =
+R"doc(Per-keyframe vertex buffers of a deforming mesh (OptiX motion GAS))doc";
+
+static const char *__doc_mitsuba_Mesh_m_vertex_motion_positions =
+R"doc(Vertex positions of the keyframes 1, 2, .. of a deforming mesh)doc";
+
 static const char *__doc_mitsuba_Mesh_m_vertex_normals = R"doc()doc";
 
 static const char *__doc_mitsuba_Mesh_m_vertex_positions = R"doc()doc";
@@ -4699,6 +5374,19 @@ static const char *__doc_mitsuba_Mesh_m_vertex_texcoords = R"doc()doc";
 
 static const char *__doc_mitsuba_Mesh_merge = R"doc(Merge two meshes into one)doc";
 
+static const char *__doc_mitsuba_Mesh_merge_2 =
+R"doc(Merge a list of meshes into one
+
+The meshes must have the same BSDF, media, emitter, sensor, vertex
+attributes and additional mesh attributes. The size of the merged mesh
+is computed up front, and its buffers are filled in parallel. The cost
+is therefore linear in the total size of the meshes, which is not the
+case for a sequence of pairwise merge() calls.)doc";
+
+static const char *__doc_mitsuba_Mesh_mesh_attributes =
+R"doc(Return the names and dimensions of the additional mesh attributes,
+sorted by name)doc";
+
 static const char *__doc_mitsuba_Mesh_moeller_trumbore =
 R"doc(Moeller and Trumbore algorithm for computing ray-triangle intersection
 
@@ -4724,6 +5412,14 @@ Returns:
     and ``v`` contains the first two components of the intersection in
     barycentric coordinates)doc";
 
+static const char *__doc_mitsuba_Mesh_motion_key_count =
+R"doc(Return the number of keyframes of the vertex positions
+
+A mesh with more than one keyframe deforms over time (deformation
+motion blur). The keyframes are uniformly distributed over the time
+interval [0, 1], and vertex positions are linearly interpolated between
+them using the time of each ray.)doc";
+
 static const char *__doc_mitsuba_Mesh_opposite_dedge =
 R"doc(Returns the opposite edge index associated with directed edge
 ``index``)doc";
@@ -4736,6 +5432,8 @@ static const char *__doc_mitsuba_Mesh_parameters_changed = R"doc()doc";
 
 static const char *__doc_mitsuba_Mesh_parameters_grad_enabled = R"doc()doc";
 
+static const char *__doc_mitsuba_Mesh_pdf_direction = R"doc()doc";
+
 static const char *__doc_mitsuba_Mesh_pdf_position = R"doc()doc";
 
 static const char *__doc_mitsuba_Mesh_precompute_silhouette = R"doc()doc";
@@ -4777,6 +5475,15 @@ static const char *__doc_mitsuba_Mesh_recompute_bbox = R"doc(Recompute the bound
 
 static const char *__doc_mitsuba_Mesh_recompute_vertex_normals = R"doc(Compute smooth vertex normals and replace the current normal values)doc";
 
+static const char *__doc_mitsuba_Mesh_sample_direction =
+R"doc(Sample a direction towards the mesh
+
+Small meshes (e.g. quads that represent a window or a softbox) that are
+seen under a large solid angle are sampled uniformly in solid angle: a
+face is chosen proportionally to its solid angle, followed by a uniform
+sample of the spherical triangle it subtends. Other meshes fall back to
+area sampling.)doc";
+
 static const char *__doc_mitsuba_Mesh_sample_position = R"doc()doc";
 
 static const char *__doc_mitsuba_Mesh_sample_precomputed_silhouette = R"doc()doc";
@@ -4785,16 +5492,69 @@ static const char *__doc_mitsuba_Mesh_sample_silhouette = R"doc()doc";
 
 static const char *__doc_mitsuba_Mesh_set_scene = R"doc()doc";
 
+static const char *__doc_mitsuba_Mesh_silhouette_edge_weight =
+R"doc(Evaluate the silhouette weight of the given directed edges
+
+Returns the weight that precompute_silhouette() assigns to each
+directed edge ``dedge`` as seen from ``viewpoint``, or zero when the
+edge isn't part of the silhouette. This makes it possible to update a
+precomputed silhouette for the edges adjacent to moved vertices only.)doc";
+
+static const char *__doc_mitsuba_Mesh_solid_angle =
+R"doc(Compute the solid angle of the mesh as seen from ``p``
+
+The solid angles of the individual faces are appended to
+``face_solid_angles`` (if specified). Faces whose plane contains ``p``
+don't contribute.)doc";
+
+static const char *__doc_mitsuba_Mesh_solid_angle_sampling = R"doc(Can sample_direction() sample the mesh by solid angle?)doc";
+
+static const char *__doc_mitsuba_Mesh_subdivide =
+R"doc(Refine the mesh using Loop subdivision
+
+The mesh is treated as the control cage of a Loop subdivision surface,
+and each subdivision step splits every triangle into four. Vertices at
+the same position are welded beforehand, hence seams of the UV
+parameterization don't tear the surface. Boundary edges are treated as
+creases. Texture coordinates and vertex attributes are interpolated
+linearly, and face attributes are inherited by the refined faces.
+
+Parameter ``max_levels``:
+    Maximum number of subdivision steps
+
+Parameter ``max_edge_length``:
+    Subdivision stops early once all edges are at most this long.
+    Disabled when set to zero.
+
+Parameter ``smooth``:
+    When set to ``False``, the vertices remain in place and new vertices
+    are inserted at the edge midpoints, i.e. the mesh is tessellated
+    without changing its shape.)doc";
+
 static const char *__doc_mitsuba_Mesh_surface_area = R"doc()doc";
 
 static const char *__doc_mitsuba_Mesh_to_string = R"doc(Return a human-readable string representation of the shape contents.)doc";
 
 static const char *__doc_mitsuba_Mesh_traverse = R"doc(@})doc";
 
+static const char *__doc_mitsuba_Mesh_update_motion_keys =
+R"doc(Update m_motion_keys from the size of the keyframe buffer
+m_vertex_motion_positions)doc";
+
 static const char *__doc_mitsuba_Mesh_vertex_count = R"doc(Return the total number of vertices)doc";
 
 static const char *__doc_mitsuba_Mesh_vertex_data_bytes = R"doc()doc";
 
+static const char *__doc_mitsuba_Mesh_vertex_motion_positions_buffer =
+R"doc(Return the vertex positions of the additional keyframes of a
+deforming mesh
+
+The buffer concatenates the positions of keyframes 1, 2, .. (keyframe
+0 is given by vertex_positions_buffer()), and is empty for static
+meshes. See motion_key_count().)doc";
+
+static const char *__doc_mitsuba_Mesh_vertex_motion_positions_buffer_2 = R"doc(Const variant of vertex_motion_positions_buffer.)doc";
+
 static const char *__doc_mitsuba_Mesh_vertex_normal = R"doc(Returns the normal direction of the vertex with index ``index``)doc";
 
 static const char *__doc_mitsuba_Mesh_vertex_normals_buffer = R"doc(Return vertex normals buffer)doc";
@@ -4803,6 +5563,14 @@ static const char *__doc_mitsuba_Mesh_vertex_normals_buffer_2 = R"doc(Const vari
 
 static const char *__doc_mitsuba_Mesh_vertex_position = R"doc(Returns the world-space position of the vertex with index ``index``)doc";
 
+static const char *__doc_mitsuba_Mesh_vertex_position_at =
+R"doc(Returns the world-space position of the vertex with index ``index`` at
+the given ``time``
+
+The position is linearly interpolated between the two enclosing
+keyframes of a deforming mesh (see motion_key_count()), and is
+identical to vertex_position() for static meshes.)doc";
+
 static const char *__doc_mitsuba_Mesh_vertex_positions_buffer = R"doc(Return vertex positions buffer)doc";
 
 static const char *__doc_mitsuba_Mesh_vertex_positions_buffer_2 = R"doc(Const variant of vertex_positions_buffer.)doc";
@@ -4848,7 +5616,21 @@ Distribution" by Wenzel Jakob
 
 An improvement of the GGX model sampling routine is discussed in "A
 Simpler and Exact Sampling Routine for the GGX Distribution of Visible
-Normals" by Eric Heitz)doc";
+Normals" by Eric Heitz
+
+By default, the visible normals of the GGX distribution are sampled
+using
+
+"Sampling Visible GGX Normals with Spherical Caps" by Jonathan Dupuy
+and Anis Benyoub
+
+which draws the same distribution as the method above with fewer
+transcendental operations. The bounded variant from
+
+"Bounded VNDF Sampling for Smith-GGX Reflections" by Kenta Eto and
+Yusuke Tokuyoshi
+
+can be selected via set_vndf_sampling().)doc";
 
 static const char *__doc_mitsuba_MicrofacetDistribution_G = R"doc(Smith's separable shadowing-masking approximation)doc";
 
@@ -4899,8 +5681,17 @@ static const char *__doc_mitsuba_MicrofacetDistribution_m_alpha_v = R"doc()doc";
 
 static const char *__doc_mitsuba_MicrofacetDistribution_m_sample_visible = R"doc()doc";
 
+static const char *__doc_mitsuba_MicrofacetDistribution_bounded_vndf_scale =
+R"doc(Scale factor of the spherical cap height in the bounded VNDF method
+(Eto and Tokuyoshi, Listing 1)
+
+Incident directions below the horizon aren't bounded, hence a factor
+of one is returned.)doc";
+
 static const char *__doc_mitsuba_MicrofacetDistribution_m_type = R"doc()doc";
 
+static const char *__doc_mitsuba_MicrofacetDistribution_m_vndf_sampling = R"doc()doc";
+
 static const char *__doc_mitsuba_MicrofacetDistribution_pdf =
 R"doc(Returns the density function associated with the sample() function.
 
@@ -4932,6 +5723,12 @@ static const char *__doc_mitsuba_MicrofacetDistribution_sample_visible = R"doc(R
 
 static const char *__doc_mitsuba_MicrofacetDistribution_sample_visible_11 = R"doc(Visible normal sampling code for the alpha=1 case)doc";
 
+static const char *__doc_mitsuba_MicrofacetDistribution_set_vndf_sampling =
+R"doc(Set the method used to sample the visible normals
+
+The spherical cap methods only exist for the GGX distribution. The
+Beckmann distribution always uses VNDFSampling::Heitz.)doc";
+
 static const char *__doc_mitsuba_MicrofacetDistribution_scale_alpha = R"doc(Scale the roughness values by some constant)doc";
 
 static const char *__doc_mitsuba_MicrofacetDistribution_smith_g1 =
@@ -4945,6 +5742,10 @@ Parameter ``m``:
 
 static const char *__doc_mitsuba_MicrofacetDistribution_type = R"doc(Return the distribution type)doc";
 
+static const char *__doc_mitsuba_MicrofacetDistribution_use_bounded_vndf = R"doc(Does sample() use the bounded spherical cap method?)doc";
+
+static const char *__doc_mitsuba_MicrofacetDistribution_vndf_sampling = R"doc(Return the method used to sample the visible normals)doc";
+
 static const char *__doc_mitsuba_MicrofacetType = R"doc(Supported normal distribution functions)doc";
 
 static const char *__doc_mitsuba_MicrofacetType_Beckmann = R"doc(Beckmann distribution derived from Gaussian random surfaces)doc";
@@ -5016,6 +5817,88 @@ static const char *__doc_mitsuba_MonteCarloIntegrator_m_max_depth = R"doc()doc";
 
 static const char *__doc_mitsuba_MonteCarloIntegrator_m_rr_depth = R"doc()doc";
 
+static const char *__doc_mitsuba_MultiDeviceRenderer =
+R"doc(Renders a scene using several CUDA devices of the same machine
+
+Dr.Jit variables, compiled kernels and OptiX acceleration data
+structures belong to the device that created them. This class
+therefore loads a separate replica of the scene on every device, each
+of them on a thread bound to that device. The samples of a render are
+split into passes that the devices fetch from a shared queue, so that
+faster devices automatically render more of them. Each device
+accumulates the raw film contents of its passes, and the results are
+finally merged into the film of the primary device (the first one in
+the list), which develops the image.
+
+After every render, the number of passes, throughput and utilization
+of each device as well as the overall scaling efficiency are written
+to the log and can be queried via device_stats(). The scaling
+efficiency relates the combined throughput to that of the fastest
+device multiplied by the number of devices.)doc";
+
+static const char *__doc_mitsuba_MultiDeviceRenderer_DeviceStats = R"doc(Statistics of a single device gathered during the last render)doc";
+
+static const char *__doc_mitsuba_MultiDeviceRenderer_DeviceStats_busy_time = R"doc(Time spent rendering passes (in seconds))doc";
+
+static const char *__doc_mitsuba_MultiDeviceRenderer_DeviceStats_device = R"doc(CUDA device ID)doc";
+
+static const char *__doc_mitsuba_MultiDeviceRenderer_DeviceStats_passes = R"doc(Number of passes rendered by the device)doc";
+
+static const char *__doc_mitsuba_MultiDeviceRenderer_DeviceStats_spp = R"doc(Number of samples per pixel rendered by the device)doc";
+
+static const char *__doc_mitsuba_MultiDeviceRenderer_DeviceStats_throughput = R"doc(Number of samples rendered per second of busy time)doc";
+
+static const char *__doc_mitsuba_MultiDeviceRenderer_DeviceStats_utilization = R"doc(Fraction of the total render time spent rendering passes)doc";
+
+static const char *__doc_mitsuba_MultiDeviceRenderer_MultiDeviceRenderer =
+R"doc(Load a replica of the scene on each device
+
+The calling thread is switched to the primary device, on which the
+image returned by render() resides. Replicas are loaded sequentially
+on the thread of their device.
+
+Parameter ``filename``:
+    Filename of the scene XML file
+
+Parameter ``devices``:
+    CUDA device IDs to render on. The default (an empty list) selects
+    all available devices.
+
+Parameter ``defines``:
+    Parameters that can be referenced as ``$key`` within the scene
+    description.)doc";
+
+static const char *__doc_mitsuba_MultiDeviceRenderer_device_stats = R"doc(Return per-device statistics of the last render)doc";
+
+static const char *__doc_mitsuba_MultiDeviceRenderer_devices = R"doc(Return the CUDA device IDs used by this renderer)doc";
+
+static const char *__doc_mitsuba_MultiDeviceRenderer_render =
+R"doc(Render the specified sensor using all devices
+
+The interface mirrors Integrator::render().
+
+Parameter ``seed``:
+    Base seed of the render. Every pass uses a distinct seed derived
+    from it, hence the result does not depend on the device that
+    rendered a given pass.
+
+Parameter ``spp``:
+    Total number of samples per pixel, or 0 to use the sampler's
+    default.
+
+Parameter ``spp_per_pass``:
+    Samples per pixel of a single pass. The default (0) creates four
+    passes per device.
+
+Parameter ``develop``:
+    Whether to return the developed image (otherwise, an empty tensor
+    is returned, and the result can be retrieved from the film of the
+    primary replica).)doc";
+
+static const char *__doc_mitsuba_MultiDeviceRenderer_scaling_efficiency = R"doc(Return the scaling efficiency of the last render (between 0 and 1))doc";
+
+static const char *__doc_mitsuba_MultiDeviceRenderer_scene = R"doc(Return the scene replica of the device with the given index)doc";
+
 static const char *__doc_mitsuba_NamedReference = R"doc(Wrapper object used to represent named references to Object instances)doc";
 
 static const char *__doc_mitsuba_NamedReference_NamedReference = R"doc()doc";
@@ -5160,6 +6043,8 @@ static const char *__doc_mitsuba_OptixAccelData_linear_curves = R"doc()doc";
 
 static const char *__doc_mitsuba_OptixAccelData_meshes = R"doc()doc";
 
+static const char *__doc_mitsuba_OptixAccelData_motion_meshes = R"doc(Deforming meshes (motion GAS))doc";
+
 static const char *__doc_mitsuba_OptixDenoiser =
 R"doc(Wrapper for the OptiX AI denoiser
 
@@ -5193,6 +6078,19 @@ Parameter ``normals``:
     Whether or not shading normals information will also be given to
     the Denoiser.
 
+Parameter ``temporal``:
+    Whether or not the temporal denoising model should be used. It
+    additionally takes the optical flow and the previous denoised
+    frame as inputs, which reduces flickering in animations.
+
+Parameter ``tile_size``:
+    When nonzero, the denoiser processes the image in tiles of this
+    size (width x height), which are extended by the overlap region
+    required by the OptiX denoiser to avoid seams. This bounds the
+    memory used by the denoiser's state and scratch buffers, which is
+    otherwise proportional to the full input resolution. By default,
+    the image is denoised in a single invocation.
+
 Returns:
     A callable object which will apply the OptiX denoiser.)doc";
 
@@ -5208,6 +6106,8 @@ static const char *__doc_mitsuba_OptixDenoiser_m_input_size = R"doc()doc";
 
 static const char *__doc_mitsuba_OptixDenoiser_m_options = R"doc()doc";
 
+static const char *__doc_mitsuba_OptixDenoiser_m_overlap = R"doc()doc";
+
 static const char *__doc_mitsuba_OptixDenoiser_m_scratch = R"doc()doc";
 
 static const char *__doc_mitsuba_OptixDenoiser_m_scratch_size = R"doc()doc";
@@ -5218,6 +6118,8 @@ static const char *__doc_mitsuba_OptixDenoiser_m_state_size = R"doc()doc";
 
 static const char *__doc_mitsuba_OptixDenoiser_m_temporal = R"doc()doc";
 
+static const char *__doc_mitsuba_OptixDenoiser_m_tile_size = R"doc()doc";
+
 static const char *__doc_mitsuba_OptixDenoiser_operator_assign = R"doc()doc";
 
 static const char *__doc_mitsuba_OptixDenoiser_operator_call =
@@ -5338,6 +6240,8 @@ static const char *__doc_mitsuba_OptixShapeType_Cylinder = R"doc()doc";
 
 static const char *__doc_mitsuba_OptixShapeType_Disk = R"doc()doc";
 
+static const char *__doc_mitsuba_OptixShapeType_Ellipsoids = R"doc()doc";
+
 static const char *__doc_mitsuba_OptixShapeType_LinearCurve = R"doc()doc";
 
 static const char *__doc_mitsuba_OptixShapeType_NumOptixShapeTypes = R"doc()doc";
@@ -5348,6 +6252,8 @@ static const char *__doc_mitsuba_OptixShapeType_SDFGrid = R"doc()doc";
 
 static const char *__doc_mitsuba_OptixShapeType_Sphere = R"doc()doc";
 
+static const char *__doc_mitsuba_OptixShapeType_Spheres = R"doc()doc";
+
 static const char *__doc_mitsuba_OptixShape_ch_name = R"doc(Whether or not this is a built-in OptiX shape type)doc";
 
 static const char *__doc_mitsuba_OptixShape_is_builtin = R"doc(Lowercase version of OPTIX_SHAPE_TYPE_NAMES)doc";
@@ -5751,7 +6657,23 @@ fields that deviate from the standard zero-initialization convention.
 In this particular class, the ``t`` field should be set to an infinite
 value to mark invalid intersection records.)doc";
 
-static const char *__doc_mitsuba_Profiler = R"doc()doc";
+static const char *__doc_mitsuba_Profiler =
+R"doc(Built-in sampling profiler
+
+When Mitsuba is compiled with ``MI_ENABLE_PROFILER``, every
+ScopedPhase sets a bit in a thread-local phase mask. A background
+thread periodically samples the masks of all threads and accumulates
+a histogram over them, which report() turns into a hierarchical
+breakdown of where time was spent. Otherwise, the functions below do
+nothing.)doc";
+
+static const char *__doc_mitsuba_Profiler_print_report = R"doc(Write the output of report() to the log and reset the profiler)doc";
+
+static const char *__doc_mitsuba_Profiler_register_thread = R"doc(Register the calling thread with the sampling thread)doc";
+
+static const char *__doc_mitsuba_Profiler_report = R"doc(Return a hierarchical breakdown of the samples collected so far)doc";
+
+static const char *__doc_mitsuba_Profiler_reset = R"doc(Discard all samples collected so far)doc";
 
 static const char *__doc_mitsuba_ProfilerPhase =
 R"doc(List of 'phases' that are handled by the profiler. Note that a partial
@@ -5948,6 +6870,15 @@ static const char *__doc_mitsuba_Properties_Type_Transform3f = R"doc(3x3 transfo
 
 static const char *__doc_mitsuba_Properties_Type_Transform4f = R"doc(4x4 transform for homogeneous coordinates)doc";
 
+static const char *__doc_mitsuba_Properties_animated_transform =
+R"doc(Retrieve an animated transformation
+
+A regular 4x4 transformation is accepted as well and converted into a
+constant animation.)doc";
+
+static const char *__doc_mitsuba_Properties_animated_transform_2 =
+R"doc(Retrieve an animated transformation (use default value if no entry exists))doc";
+
 static const char *__doc_mitsuba_Properties_as_string = R"doc(Return one of the parameters (converting it to a string if necessary))doc";
 
 static const char *__doc_mitsuba_Properties_as_string_2 =
@@ -6028,6 +6959,8 @@ R"doc(Remove a property with the specified name
 Returns:
     ``True`` upon success)doc";
 
+static const char *__doc_mitsuba_Properties_set_animated_transform = R"doc(Store an animated transformation in the Properties instance)doc";
+
 static const char *__doc_mitsuba_Properties_set_array3f = R"doc(Store a 3D array in the Properties instance)doc";
 
 static const char *__doc_mitsuba_Properties_set_bool = R"doc(Store a boolean value in the Properties instance)doc";
@@ -6109,6 +7042,16 @@ bases including scrambled versions.
 This class is used to implement Halton and Hammersley sequences for
 QMC integration in Mitsuba.)doc";
 
+static const char *__doc_mitsuba_RadicalInverse_DigitTable = R"doc(Lookup table to process several digits of a prime base at once)doc";
+
+static const char *__doc_mitsuba_RadicalInverse_DigitTable_divisor = R"doc()doc";
+
+static const char *__doc_mitsuba_RadicalInverse_DigitTable_recip = R"doc()doc";
+
+static const char *__doc_mitsuba_RadicalInverse_DigitTable_size = R"doc()doc";
+
+static const char *__doc_mitsuba_RadicalInverse_DigitTable_values = R"doc()doc";
+
 static const char *__doc_mitsuba_RadicalInverse_PrimeBase = R"doc()doc";
 
 static const char *__doc_mitsuba_RadicalInverse_PrimeBase_divisor = R"doc()doc";
@@ -6148,6 +7091,20 @@ R"doc(Compute the Faure permutations using dynamic programming
 For reference, see "Good permutations for extreme discrepancy" by
 Henri Faure, Journal of Number Theory, Vol. 42, 1, 1992.)doc";
 
+static const char *__doc_mitsuba_RadicalInverse_digit_table =
+R"doc(Return the table that eval_scrambled() uses to process several digits
+of the given prime base at once
+
+The table has digit_table_size() entries. Entry ``i`` contains the
+scrambled digits of ``i`` in reverse order, i.e. the scrambled radical
+inverse of ``i`` multiplied by the table size.)doc";
+
+static const char *__doc_mitsuba_RadicalInverse_digit_table_size =
+R"doc(Return the size of the table returned by digit_table()
+
+This is the largest power of the prime base that does not exceed 4096
+entries (or the base itself, if larger).)doc";
+
 static const char *__doc_mitsuba_RadicalInverse_eval =
 R"doc(Calculate the radical inverse function
 
@@ -6172,7 +7129,11 @@ R"doc(Calculate a scrambled radical inverse function
 This function is used as a building block to construct permuted Halton
 and Hammersley sequence variants. It works like the normal radical
 inverse function eval(), except that every digit is run through an
-extra scrambling permutation.)doc";
+extra scrambling permutation.
+
+Instead of processing one digit at a time, the implementation looks up
+groups of several digits in a precomputed table (see digit_table()),
+which substantially reduces the number of divisions for small bases.)doc";
 
 static const char *__doc_mitsuba_RadicalInverse_inverse_permutation =
 R"doc(Return the inverse permutation corresponding to the given prime number
@@ -6184,6 +7145,10 @@ static const char *__doc_mitsuba_RadicalInverse_m_base = R"doc()doc";
 
 static const char *__doc_mitsuba_RadicalInverse_m_base_count = R"doc()doc";
 
+static const char *__doc_mitsuba_RadicalInverse_m_digit_table_storage = R"doc()doc";
+
+static const char *__doc_mitsuba_RadicalInverse_m_digit_tables = R"doc()doc";
+
 static const char *__doc_mitsuba_RadicalInverse_m_inv_permutation_storage = R"doc()doc";
 
 static const char *__doc_mitsuba_RadicalInverse_m_inv_permutations = R"doc()doc";
@@ -6367,6 +7332,8 @@ static const char *__doc_mitsuba_ReconstructionFilter_eval_discretized =
 R"doc(Evaluate a discretized version of the filter (generally faster than
 'eval'))doc";
 
+static const char *__doc_mitsuba_ReconstructionFilter_has_weight_table = R"doc(Does this filter provide a tabulated splatting weight table?)doc";
+
 static const char *__doc_mitsuba_ReconstructionFilter_init_discretization = R"doc(Mandatory initialization prior to calls to eval_discretized())doc";
 
 static const char *__doc_mitsuba_ReconstructionFilter_is_box_filter = R"doc(Check whether this is a box filter?)doc";
@@ -6381,6 +7348,251 @@ static const char *__doc_mitsuba_ReconstructionFilter_m_values = R"doc()doc";
 
 static const char *__doc_mitsuba_ReconstructionFilter_radius = R"doc(Return the filter's width)doc";
 
+static const char *__doc_mitsuba_ReconstructionFilter_weight_table =
+R"doc(Return the separable splatting weight table
+
+The table has MI_FILTER_SUBPIXEL_RESOLUTION rows of weight_taps()
+entries. Row ``j`` stores the filter weights of a sample whose
+fractional pixel coordinate ``f`` falls into the interval ``[j, j + 1)
+/ MI_FILTER_SUBPIXEL_RESOLUTION``, evaluated at the centers of the
+pixels ``-n .. n`` relative to the pixel containing the sample. The
+same table is used along both image axes.)doc";
+
+static const char *__doc_mitsuba_ReconstructionFilter_weight_table_row = R"doc(Return the weight table row associated with a fractional pixel coordinate)doc";
+
+static const char *__doc_mitsuba_ReconstructionFilter_weight_taps =
+R"doc(Return the number of taps per row of the splatting weight table
+
+This equals ``2 * n + 1``, where ``n = ceil(radius - 0.5)`` is the
+number of pixels that a sample can influence on either side of the
+pixel containing it. The function returns zero when the filter was not
+created with ``tabulate=true``.)doc";
+
+static const char *__doc_mitsuba_RenderClient =
+R"doc(Client of a RenderServer
+
+Every function sends a single request and blocks until the server
+replies. Errors raised by the server (e.g. an unknown scene identifier
+or parameter name) are rethrown as exceptions.)doc";
+
+static const char *__doc_mitsuba_RenderClient_RenderClient = R"doc(Connect to the server at the given host and port)doc";
+
+static const char *__doc_mitsuba_RenderClient_load_scene =
+R"doc(Ask the server to load a scene file and keep it resident
+
+The filename is resolved on the server. The definitions can be
+referenced as ``$key`` within the scene description.)doc";
+
+static const char *__doc_mitsuba_RenderClient_remove_scene = R"doc(Ask the server to release a resident scene)doc";
+
+static const char *__doc_mitsuba_RenderClient_render =
+R"doc(Render a resident scene and return the developed image
+
+Parameter ``overrides``:
+    Parameter values that apply to this job only (see RenderServer)
+
+Parameter ``spp``:
+    Samples per pixel, or 0 to use the sampler's default.)doc";
+
+static const char *__doc_mitsuba_RenderClient_shutdown_server = R"doc(Ask the server to shut down once the pending requests are completed)doc";
+
+static const char *__doc_mitsuba_RenderCoordinator =
+R"doc(Coordinator of a distributed, tile-based render
+
+The coordinator listens on a TCP port for RenderWorker instances,
+which are typically separate processes on other machines that have
+loaded the same scene. The sensor's crop window is split into
+rectangular tiles that are handed out to the workers on demand. Each
+worker renders its tile with the scene's integrator and streams back
+the raw contents of its film as a zlib-compressed ImageBlock, which the
+coordinator then accumulates into its own film.
+
+To bound tail latency, tiles that are still outstanding once the queue
+has run dry are issued again to idle workers if they have been in
+flight longer than ``reissue_factor`` times the median tile render
+time observed so far. The first result that arrives for a tile is
+merged, and any later duplicates are discarded. Tiles held by a worker
+whose connection drops are put back into the queue.
+
+Note that tiles are filtered independently, hence reconstruction
+filters with a radius exceeding one pixel receive slightly fewer
+contributions along tile boundaries.)doc";
+
+static const char *__doc_mitsuba_RenderCoordinator_RenderCoordinator =
+R"doc(Start listening for workers
+
+Parameter ``port``:
+    TCP port to listen on. The default (0) lets the operating system
+    choose a free port, which can be queried via port().
+
+Parameter ``tile_size``:
+    Edge length of the square tiles that are handed out to workers.
+
+Parameter ``reissue_factor``:
+    Outstanding tiles are re-issued once they have been running for
+    longer than this factor times the median tile render time.
+
+Parameter ``max_issues``:
+    Maximum number of times that a single tile is handed out.)doc";
+
+static const char *__doc_mitsuba_RenderCoordinator_port = R"doc(Return the TCP port that the coordinator listens on)doc";
+
+static const char *__doc_mitsuba_RenderCoordinator_reissued_count = R"doc(Return the number of tiles that were re-issued during the last render)doc";
+
+static const char *__doc_mitsuba_RenderCoordinator_render =
+R"doc(Render the specified sensor using the connected workers
+
+The interface mirrors Integrator::render(). The function blocks until
+every tile has been merged into the sensor's film. Workers may connect
+before or during the call.
+
+Parameter ``seed``:
+    Base seed of the render. Every tile uses a distinct seed derived
+    from it, and re-issued tiles reuse the seed of the original tile.
+
+Parameter ``spp``:
+    Samples per pixel to be rendered by the workers, or 0 to use the
+    sampler's default.
+
+Parameter ``develop``:
+    Whether to return the developed image (otherwise, an empty tensor
+    is returned, and the result can be retrieved from the film).)doc";
+
+static const char *__doc_mitsuba_RenderCoordinator_shutdown = R"doc(Stop accepting workers and ask the connected ones to terminate)doc";
+
+static const char *__doc_mitsuba_RenderCoordinator_worker_count = R"doc(Return the number of currently connected workers)doc";
+
+static const char *__doc_mitsuba_RenderServer =
+R"doc(Persistent render server that keeps scenes resident between jobs
+
+The server listens on a TCP port for RenderClient connections, which
+submit requests to load a scene under an identifier, to remove a
+scene, or to render a resident scene. This avoids paying for scene
+loading, acceleration data structure construction and (in JIT
+variants) kernel compilation in every request: subsequent jobs that
+only differ in their parameter values reuse all of them.
+
+A render job specifies the scene identifier, the sensor index, the
+sample count and seed, as well as a list of parameter overrides. These
+use the names of ``mi.traverse()`` (e.g. ``"sensor.to_world"`` or
+``"my_bsdf.reflectance.value"``) and whitespace or comma-separated
+numbers as values (16 numbers in row-major order for
+transformations). Overrides only apply to a single job: the previous
+values are restored once it completes. In JIT variants, the new values
+are made opaque so that the compiled kernels can be reused.
+
+Requests of all clients enter a single FIFO queue and are executed one
+at a time by the thread that calls run(), which therefore owns the JIT
+state of the scenes. The result of a render job is sent back as an
+OpenEXR image.)doc";
+
+static const char *__doc_mitsuba_RenderServer_RenderServer =
+R"doc(Start listening for clients
+
+Parameter ``port``:
+    TCP port to listen on. The default (0) lets the operating system
+    choose a free port, which can be queried via port().
+
+Parameter ``max_queued``:
+    Maximum number of pending requests. Further requests are rejected
+    with an error until the queue has room again.)doc";
+
+static const char *__doc_mitsuba_RenderServer_add_scene = R"doc(Make a scene that was loaded by the caller resident under ``id``)doc";
+
+static const char *__doc_mitsuba_RenderServer_jobs_completed = R"doc(Return the number of requests that were processed so far)doc";
+
+static const char *__doc_mitsuba_RenderServer_load_scene =
+R"doc(Load a scene from an XML file and make it resident under ``id``
+
+Any scene previously registered under the same identifier is replaced.)doc";
+
+static const char *__doc_mitsuba_RenderServer_port = R"doc(Return the TCP port that the server listens on)doc";
+
+static const char *__doc_mitsuba_RenderServer_remove_scene = R"doc(Release the scene with the given identifier)doc";
+
+static const char *__doc_mitsuba_RenderServer_run =
+R"doc(Process requests until the server is shut down
+
+Shutdown is triggered by a call to shutdown() or by a client (see
+RenderClient::shutdown_server()). Requests that are already queued at
+this point are completed first, and later ones are rejected.)doc";
+
+static const char *__doc_mitsuba_RenderServer_scene_ids = R"doc(Return the identifiers of all resident scenes)doc";
+
+static const char *__doc_mitsuba_RenderServer_shutdown = R"doc(Stop accepting clients and make run() return)doc";
+
+static const char *__doc_mitsuba_RenderWorker =
+R"doc(Worker of a distributed, tile-based render
+
+Connects to a RenderCoordinator and renders the tiles that it hands
+out using the integrator of a locally loaded copy of the scene.)doc";
+
+static const char *__doc_mitsuba_RenderWorker_RenderWorker = R"doc(Connect to the coordinator at the given host and port)doc";
+
+static const char *__doc_mitsuba_RenderWorker_run =
+R"doc(Render tiles until the coordinator shuts down
+
+The film's crop window is restored before this function returns.
+
+Returns:
+    The number of tiles that were rendered)doc";
+
+static const char *__doc_mitsuba_RayStatistics =
+R"doc(Ray tracing counters of scalar variants
+
+When Mitsuba is compiled with ``MI_ENABLE_RAY_STATISTICS``, the scene
+and the kd-tree count traced rays, traversal steps and primitive
+intersection tests in thread-local counters.
+SamplingIntegrator::render() reports the aggregated values at the end
+of a render. Otherwise, the macros below expand to nothing and
+RayStatistics::report() returns an empty string.)doc";
+
+static const char *__doc_mitsuba_RayStatistics_CameraRays = R"doc(Primary rays generated by the sensor)doc";
+
+static const char *__doc_mitsuba_RayStatistics_Counter = R"doc()doc";
+
+static const char *__doc_mitsuba_RayStatistics_IntersectRays = R"doc(Rays traced via ``Scene::ray_intersect()`` (including camera rays))doc";
+
+static const char *__doc_mitsuba_RayStatistics_NodeVisits = R"doc(kd-tree nodes visited during traversal)doc";
+
+static const char *__doc_mitsuba_RayStatistics_PrimitiveTests = R"doc(Ray-primitive intersection tests)doc";
+
+static const char *__doc_mitsuba_RayStatistics_ShadowRays = R"doc(Shadow rays traced via ``Scene::ray_test()``)doc";
+
+static const char *__doc_mitsuba_RayStatistics_report = R"doc(Summarize the counters (``time``: duration of the render in ms))doc";
+
+static const char *__doc_mitsuba_RayStatistics_reset = R"doc(Reset the counters of all threads)doc";
+
+static const char *__doc_mitsuba_RayStatistics_value = R"doc(Return the sum of a counter over all threads)doc";
+
+static const char *__doc_mitsuba_RenderStats =
+R"doc(Statistics about the kernels compiled and launched by a render() call
+
+When enabled via set_enabled(), the outermost ``render()`` call of a
+JIT variant (both SamplingIntegrator and the Python AD integrators)
+records Dr.Jit's kernel history and stores a summary that can
+subsequently be queried with last(). Scalar variants don't produce
+statistics.)doc";
+
+static const char *__doc_mitsuba_RenderStats_begin =
+R"doc(Start collecting statistics (used by the integrators)
+
+Returns ``True`` if collection was started, in which case the caller
+must invoke end() once rendering has finished. Nested calls (e.g. by
+``render_forward()``) return ``False``.)doc";
+
+static const char *__doc_mitsuba_RenderStats_cache_misses = R"doc(Number of kernels that had to be compiled)doc";
+
+static const char *__doc_mitsuba_RenderStats_enabled = R"doc(Is the collection of statistics enabled?)doc";
+
+static const char *__doc_mitsuba_RenderStats_end = R"doc(Stop collecting statistics and make them available via last())doc";
+
+static const char *__doc_mitsuba_RenderStats_last = R"doc(Return the statistics of the last render() call)doc";
+
+static const char *__doc_mitsuba_RenderStats_set_enabled = R"doc(Enable or disable collection by subsequent render() calls)doc";
+
+static const char *__doc_mitsuba_RenderStats_to_string = R"doc(Return a human-readable summary)doc";
+
 static const char *__doc_mitsuba_Resampler =
 R"doc(Utility class for efficiently resampling discrete datasets to
 different resolutions
@@ -6597,6 +7809,15 @@ the wavefront.)doc";
 
 static const char *__doc_mitsuba_Sampler_seeded = R"doc(Return whether the sampler was seeded)doc";
 
+static const char *__doc_mitsuba_Sampler_set_pixel =
+R"doc(Inform the sampler about the film pixel of the current sample
+
+Rendering algorithms call this function before drawing the first
+component of a camera sample. Samplers that correlate the sequences of
+neighboring pixels (e.g. to distribute the error as blue noise in
+screen space) can use this information, while all others ignore it.
+The default implementation does nothing.)doc";
+
 static const char *__doc_mitsuba_Sampler_set_sample_count = R"doc(Set the number of samples per pixel)doc";
 
 static const char *__doc_mitsuba_Sampler_set_samples_per_wavefront =
@@ -6624,22 +7845,77 @@ static const char *__doc_mitsuba_SamplingIntegrator_4 = R"doc()doc";
 
 static const char *__doc_mitsuba_SamplingIntegrator_5 = R"doc()doc";
 
+static const char *__doc_mitsuba_SamplingIntegrator_CostCounters =
+R"doc(Counters of the work performed by a sample (see set_cost_aovs()))doc";
+
+static const char *__doc_mitsuba_SamplingIntegrator_CostCounters_null_steps = R"doc()doc";
+
+static const char *__doc_mitsuba_SamplingIntegrator_CostCounters_shadow_rays = R"doc()doc";
+
+static const char *__doc_mitsuba_SamplingIntegrator_CostCounters_vertices = R"doc()doc";
+
 static const char *__doc_mitsuba_SamplingIntegrator_SamplingIntegrator = R"doc(//! @})doc";
 
+static const char *__doc_mitsuba_SamplingIntegrator_aov_names =
+R"doc(Names of the cost AOVs when they are enabled, and an empty list
+otherwise)doc";
+
+static const char *__doc_mitsuba_SamplingIntegrator_budget_sample_count =
+R"doc(Number of samples that a pixel receives under the current sample
+budget
+
+Parameter ``pixel``:
+    Pixel position relative to the crop window (positions outside of
+    it, e.g. in the film border, are clamped)
+
+Parameter ``spp``:
+    Sample count that the budget refers to)doc";
+
+static const char *__doc_mitsuba_SamplingIntegrator_clear_primary_ray_cache =
+R"doc(Discard the camera rays and intersections that were cached via the
+``primary_ray_cache`` parameter
+
+The cache is rebuilt automatically when the scene, the sensor, its
+transformation, the film crop window, or the number of samples per pass
+change. Other modifications that affect the camera rays or their first
+intersection (e.g. of the field of view or of the scene geometry) must
+be followed by a call to this function.)doc";
+
+static const char *__doc_mitsuba_SamplingIntegrator_clear_sample_budget = R"doc(Remove a sample budget specified via set_sample_budget())doc";
+
 static const char *__doc_mitsuba_SamplingIntegrator_class = R"doc()doc";
 
+static const char *__doc_mitsuba_SamplingIntegrator_cost_aovs = R"doc(Are the cost counters enabled? (see set_cost_aovs()))doc";
+
+static const char *__doc_mitsuba_SamplingIntegrator_has_cost_counters = R"doc(Does the integrator implement the cost counters?)doc";
+
+static const char *__doc_mitsuba_SamplingIntegrator_has_sample_budget = R"doc(Has a sample budget been specified via set_sample_budget()?)doc";
+
 static const char *__doc_mitsuba_SamplingIntegrator_m_block_size = R"doc(Size of (square) image blocks to render in parallel (in scalar mode))doc";
 
+static const char *__doc_mitsuba_SamplingIntegrator_m_cost_aovs = R"doc(Report the cost counters as AOVs? (see set_cost_aovs()))doc";
+
 static const char *__doc_mitsuba_SamplingIntegrator_m_samples_per_pass =
 R"doc(Number of samples to compute for each pass over the image blocks.
 
 Must be a multiple of the total sample count per pixel. If set to
 (uint32_t) -1, all the work is done in a single pass (default).)doc";
 
+static const char *__doc_mitsuba_SamplingIntegrator_put_cost_aovs =
+R"doc(Write the cost counters to the first three entries of ``aovs``)doc";
+
 static const char *__doc_mitsuba_SamplingIntegrator_render = R"doc(//! @{ \name Integrator interface implementation)doc";
 
 static const char *__doc_mitsuba_SamplingIntegrator_render_block = R"doc()doc";
 
+static const char *__doc_mitsuba_SamplingIntegrator_render_camera_sample =
+R"doc(Estimate the radiance along a camera ray and splat it (second half of
+render_sample())
+
+When specified, ``splat_offset`` is added to the position where the
+sample is splatted into ``block``, which lets several images share a
+block (see render_ensemble()).)doc";
+
 static const char *__doc_mitsuba_SamplingIntegrator_render_sample = R"doc()doc";
 
 static const char *__doc_mitsuba_SamplingIntegrator_sample =
@@ -6685,6 +7961,54 @@ Remark:
 (spec, mask, aov) = integrator.sample(scene, sampler, ray, medium, active)
 ```)doc";
 
+static const char *__doc_mitsuba_SamplingIntegrator_sample_from_primary =
+R"doc(Sample the incident radiance along a ray whose first intersection with
+the scene is already known
+
+This entry point lets integrators that trace the camera ray themselves
+(e.g. the ``aov`` integrator) share the resulting intersection ``si``
+with nested integrators, which can then skip tracing the primary ray.
+Invalid entries of ``si`` denote rays that escaped the scene. The other
+parameters and the return value match those of sample().
+
+The default implementation ignores ``si`` and forwards to sample().)doc";
+
+static const char *__doc_mitsuba_SamplingIntegrator_set_cost_aovs =
+R"doc(Enable the cost counters of the integrator
+
+When enabled, sample() reports the work performed by each sample using
+three additional AOVs that follow those of the integrator: the number
+of path vertices (``cost.V``), shadow rays (``cost.S``), and null-
+collision steps in participating media (``cost.N``). This is used by
+the ``cost`` AOV of the ``aov`` integrator. Throws if the integrator
+doesn't implement the counters.)doc";
+
+static const char *__doc_mitsuba_SamplingIntegrator_set_sample_budget =
+R"doc(Distribute the samples of subsequent renders non-uniformly
+
+Parameter ``budget``:
+    A tensor of shape ``(height, width)`` or ``(height, width, 1)``
+    matching the crop window of the film. Its entries specify the
+    fraction of the sample count that is spent on each pixel, which
+    always receives at least one sample. Values are clamped to ``[0,
+    1]``. An empty tensor removes the budget.
+
+This generalizes adaptive sampling to budgets that are decided by the
+caller, e.g. to keep the latency low around the cursor of an
+interactive viewer. Both the block-based and the wavefront rendering
+paths respect the budget, and it can be combined with
+``adaptive_threshold`` (in which case it bounds the adaptive sample
+count).)doc";
+
+static const char *__doc_mitsuba_SamplingIntegrator_set_sample_budget_2 =
+R"doc(Distribute the samples of subsequent renders according to a circular
+region of interest
+
+Pixels within distance ``radius`` of ``center`` (specified in pixels
+relative to the crop window) receive the full sample count. Beyond it,
+the budget falls off smoothly to ``min_fraction`` over a distance of
+``falloff`` pixels.)doc";
+
 static const char *__doc_mitsuba_Scene =
 R"doc(Central scene data structure
 
@@ -6715,12 +8039,20 @@ static const char *__doc_mitsuba_Scene_4 = R"doc()doc";
 
 static const char *__doc_mitsuba_Scene_5 = R"doc()doc";
 
+static const char *__doc_mitsuba_Scene_MemoryRecord =
+R"doc(Memory used by an object: name, category, host bytes, device bytes)doc";
+
 static const char *__doc_mitsuba_Scene_Scene = R"doc(Instantiate a scene from a Properties object)doc";
 
 static const char *__doc_mitsuba_Scene_accel_init_cpu = R"doc(Create the ray-intersection acceleration data structure)doc";
 
 static const char *__doc_mitsuba_Scene_accel_init_gpu = R"doc()doc";
 
+static const char *__doc_mitsuba_Scene_accel_memory_cpu =
+R"doc(Return the size of the ray-intersection acceleration data structure)doc";
+
+static const char *__doc_mitsuba_Scene_accel_memory_gpu = R"doc()doc";
+
 static const char *__doc_mitsuba_Scene_accel_parameters_changed_cpu = R"doc(Updates the ray-intersection acceleration data structure)doc";
 
 static const char *__doc_mitsuba_Scene_accel_parameters_changed_gpu = R"doc()doc";
@@ -6832,6 +8164,28 @@ static const char *__doc_mitsuba_Scene_m_silhouette_shapes = R"doc()doc";
 
 static const char *__doc_mitsuba_Scene_m_silhouette_shapes_dr = R"doc()doc";
 
+static const char *__doc_mitsuba_Scene_memory_report =
+R"doc(Return a table summarizing memory_usage() per category and per object
+(sorted by decreasing size)
+
+Parameter ``max_objects``:
+    Maximum number of objects that are listed)doc";
+
+static const char *__doc_mitsuba_Scene_memory_usage =
+R"doc(Estimate the memory used by the objects of the scene
+
+Walks the scene graph using traverse() and sums up the storage of the
+parameters exposed by each object. Every object is only counted once,
+under the name it is first reached by (following the naming convention
+of ``mi.traverse()``). The category of an object is its base class
+(e.g. ``Shape``, ``Texture``, or ``Volume``). The acceleration data
+structure and the image blocks of the films are reported separately
+with the categories ``Accel`` and ``ImageBlock``.
+
+Only data that is exposed via traverse() is accounted for, which
+includes the bulk of the mesh, texture, and volume data. Temporary
+variables of Dr.Jit aren't included.)doc";
+
 static const char *__doc_mitsuba_Scene_parameters_changed = R"doc(Update internal state following a parameter update)doc";
 
 static const char *__doc_mitsuba_Scene_pdf_emitter =
@@ -7224,6 +8578,15 @@ static const char *__doc_mitsuba_Scene_to_string = R"doc(Return a human-readable
 
 static const char *__doc_mitsuba_Scene_traverse = R"doc(Traverse the scene graph and invoke the given callback for each object)doc";
 
+static const char *__doc_mitsuba_Scene_update_emitter_cache =
+R"doc(Rebuild the emitter selection distributions of the emitter cache from
+the contributions that were recorded so far
+
+Emitter sampling only records contributions when the visibility of the
+sample is tested (see sample_emitter_direction()). Sampling
+integrators call this function between rendering passes. It does
+nothing when the ``emitter_cache`` scene parameter is disabled.)doc";
+
 static const char *__doc_mitsuba_Scene_update_emitter_sampling_distribution = R"doc(Updates the discrete distribution used to select an emitter)doc";
 
 static const char *__doc_mitsuba_Scene_update_silhouette_sampling_distribution = R"doc(Updates the discrete distribution used to select a shape's silhouette)doc";
@@ -7270,6 +8633,8 @@ static const char *__doc_mitsuba_Sensor_film_2 = R"doc(Return the Film instance
 
 static const char *__doc_mitsuba_Sensor_m_alpha = R"doc()doc";
 
+static const char *__doc_mitsuba_Sensor_m_emitter_wavelengths = R"doc(Importance sample the wavelengths using the emitter spectra?)doc";
+
 static const char *__doc_mitsuba_Sensor_m_film = R"doc()doc";
 
 static const char *__doc_mitsuba_Sensor_m_resolution = R"doc()doc";
@@ -7282,6 +8647,8 @@ static const char *__doc_mitsuba_Sensor_m_shutter_open_time = R"doc()doc";
 
 static const char *__doc_mitsuba_Sensor_m_srf = R"doc()doc";
 
+static const char *__doc_mitsuba_Sensor_m_wavelength_distr = R"doc()doc";
+
 static const char *__doc_mitsuba_Sensor_needs_aperture_sample =
 R"doc(Does the sampling technique require a sample for the aperture
 position?)doc";
@@ -7344,6 +8711,11 @@ the wavelengths.
 In RGB and monochromatic modes, since no wavelengths need to be
 sampled, this simply returns an empty vector and the value 1.
 
+When the sensor was created with ``wavelength_sampling=emitters`` (and
+without a sensor response function), the wavelengths are drawn from a
+mixture of the RGB importance spectrum and its product with the
+emission spectra of the scene (see set_scene()).
+
 Parameter ``sample``:
     A uniformly distributed 1D value that is used to sample the
     spectral dimension of the sensitivity profile.
@@ -7369,14 +8741,45 @@ times to provide each participating worker thread with its own
 instance (see Scene::sampler()). Therefore, this sampler should never
 be used for anything except creating clones.)doc";
 
+static const char *__doc_mitsuba_Sensor_set_scene =
+R"doc(Inform the sensor about the properties of the scene
+
+When emitter-driven wavelength sampling is enabled, this function
+tabulates the average emission spectrum of the scene's emitters. Later
+changes to the emitters don't update this table.)doc";
+
 static const char *__doc_mitsuba_Sensor_shutter_open = R"doc(Return the time value of the shutter opening event)doc";
 
 static const char *__doc_mitsuba_Sensor_shutter_open_time = R"doc(Return the length, for which the shutter remains open)doc";
 
 static const char *__doc_mitsuba_Sensor_traverse = R"doc(//! @})doc";
 
+static const char *__doc_mitsuba_ServerSocket =
+R"doc(Listening TCP socket that hands out a SocketStream for every incoming
+connection.)doc";
+
+static const char *__doc_mitsuba_ServerSocket_ServerSocket =
+R"doc(Bind to the given TCP port on all interfaces and start listening
+
+Passing ``port=0`` lets the operating system choose a free port, which
+can subsequently be queried using port().)doc";
+
+static const char *__doc_mitsuba_ServerSocket_accept =
+R"doc(Block until a client connects and return a stream for it
+
+Returns ``nullptr`` when the socket was closed by another thread while
+waiting.)doc";
+
+static const char *__doc_mitsuba_ServerSocket_close = R"doc(Stop listening. Wakes up threads that are blocked in accept().)doc";
+
+static const char *__doc_mitsuba_ServerSocket_port = R"doc(Return the port that the socket is bound to)doc";
+
 static const char *__doc_mitsuba_Shape = R"doc(Forward declaration for `SilhouetteSample`)doc";
 
+static const char *__doc_mitsuba_ShapeGroup_is_animated = R"doc(Return whether this shapegroup contains deforming meshes)doc";
+
+static const char *__doc_mitsuba_ShapeGroup_m_has_motion = R"doc()doc";
+
 static const char *__doc_mitsuba_Shape_2 = R"doc(Forward declaration for `SilhouetteSample`)doc";
 
 static const char *__doc_mitsuba_Shape_3 = R"doc()doc";
@@ -7417,6 +8820,8 @@ static const char *__doc_mitsuba_ShapeGroup_has_meshes = R"doc(Return whether th
 
 static const char *__doc_mitsuba_ShapeGroup_has_others = R"doc(Return whether this shapegroup contains other type of shapes)doc";
 
+static const char *__doc_mitsuba_ShapeGroup_has_spheres = R"doc(Return whether this shapegroup contains sphere cloud shapes)doc";
+
 static const char *__doc_mitsuba_ShapeGroup_m_accel = R"doc()doc";
 
 static const char *__doc_mitsuba_ShapeGroup_m_bbox = R"doc()doc";
@@ -7540,6 +8945,8 @@ static const char *__doc_mitsuba_ShapeType_SDFGrid = R"doc(SDF Grids (`sdfgrid`)
 
 static const char *__doc_mitsuba_ShapeType_Sphere = R"doc(Spheres (`sphere`))doc";
 
+static const char *__doc_mitsuba_ShapeType_Spheres = R"doc(Sphere clouds (`spheres`))doc";
+
 static const char *__doc_mitsuba_Shape_Shape = R"doc(//! @})doc";
 
 static const char *__doc_mitsuba_Shape_Shape_2 = R"doc()doc";
@@ -7731,6 +9138,14 @@ Parameter ``ss``:
 Returns:
     The corresponding boundary sample space point)doc";
 
+static const char *__doc_mitsuba_Shape_is_animated =
+R"doc(Does the transformation or geometry of this shape change over time?
+
+Ray tracing backends must then take the time of each ray into account
+(motion blur). This is the case for instances with an animated
+transformation, deforming meshes (see Mesh::motion_key_count()) and
+shape groups containing them.)doc";
+
 static const char *__doc_mitsuba_Shape_is_emitter = R"doc(Is this shape also an area emitter?)doc";
 
 static const char *__doc_mitsuba_Shape_is_instance = R"doc(Is this shape an instance?)doc";
@@ -8007,6 +9422,15 @@ Returns:
     only used by the ShapeGroup class and be set to \c (uint32_t)-1
     otherwise.)doc";
 
+static const char *__doc_mitsuba_Shape_ray_intersect_primitive_scalar =
+R"doc(Scalar test for an intersection with a single primitive of the shape
+
+This operation is used by the native acceleration data structures for
+shapes that are made of several primitives (e.g. curves), which are
+then stored individually in the kd-tree or BVH. The default
+implementation ignores ``prim_index`` and forwards the call to
+ray_intersect_preliminary_scalar().)doc";
+
 static const char *__doc_mitsuba_Shape_ray_test =
 R"doc(Fast ray shadow test
 
@@ -8030,6 +9454,8 @@ static const char *__doc_mitsuba_Shape_ray_test_packet_2 = R"doc()doc";
 
 static const char *__doc_mitsuba_Shape_ray_test_packet_3 = R"doc()doc";
 
+static const char *__doc_mitsuba_Shape_ray_test_primitive_scalar = R"doc(Shadow ray variant of ray_intersect_primitive_scalar())doc";
+
 static const char *__doc_mitsuba_Shape_ray_test_scalar = R"doc()doc";
 
 static const char *__doc_mitsuba_Shape_sample_direction =
@@ -8117,6 +9543,14 @@ Parameter ``flags``:
 Returns:
     Silhouette sample record.)doc";
 
+static const char *__doc_mitsuba_Shape_select_lod =
+R"doc(Select the level of detail for renderings from ``viewpoint``
+
+The scene calls this function for all of its shapes with the position
+of its first sensor before building the acceleration data structure.
+The default implementation does nothing, see the ``instance`` plugin
+for an implementation.)doc";
+
 static const char *__doc_mitsuba_Shape_sensor = R"doc(Return the area sensor associated with this shape (if any))doc";
 
 static const char *__doc_mitsuba_Shape_sensor_2 = R"doc(Return the area sensor associated with this shape (if any))doc";
@@ -8203,24 +9637,209 @@ only by the triangle index but also the edge index of the selected
 triangle. A value larger than 3 indicates a failed projection. For
 other primitives, zero indicates a failed projection.
 
-For triangle meshes, index 0 stands for the directed edge p0->p1 (not
-the opposite edge p1->p2), index 1 stands for the edge p1->p2, and
-index 2 for p2->p0.)doc";
+For triangle meshes, index 0 stands for the directed edge p0->p1 (not
+the opposite edge p1->p2), index 1 stands for the edge p1->p2, and
+index 2 for p2->p0.)doc";
+
+static const char *__doc_mitsuba_SilhouetteSample_scene_index = R"doc(Index of the shape in the scene (if applicable))doc";
+
+static const char *__doc_mitsuba_SilhouetteSample_shape = R"doc(Pointer to the associated shape)doc";
+
+static const char *__doc_mitsuba_SilhouetteSample_silhouette_d = R"doc(Direction of the silhouette curve at the boundary point)doc";
+
+static const char *__doc_mitsuba_SilhouetteSample_spawn_ray =
+R"doc(Spawn a ray on the silhouette point in the direction of d
+
+The ray origin is offset in the direction of the segment (d) aswell as
+in the in the direction of the silhouette normal (n). Without this
+offsetting, during a ray intersection, the ray could potentially find
+an intersection point at its origin due to numerical instabilities in
+the intersection routines.)doc";
+
+static const char *__doc_mitsuba_SocketStream =
+R"doc(Stream implementation backed by a connected TCP socket.
+
+Reads and writes block until the requested number of bytes has been
+transferred, which makes this class suitable as the transport for
+simple length-prefixed message protocols. Seeking and truncation are
+not supported, and tell() reports the number of bytes read and written
+so far. All multi-byte values are transferred in network byte order.)doc";
+
+static const char *__doc_mitsuba_SocketStream_SocketStream = R"doc(Connect to the given host and TCP port)doc";
+
+static const char *__doc_mitsuba_SocketStream_SocketStream_2 = R"doc(Wrap an already connected socket descriptor (takes ownership))doc";
+
+static const char *__doc_mitsuba_SocketStream_peer = R"doc(Return a human-readable description of the remote end)doc";
+
+static const char *__doc_mitsuba_SocketStream_received = R"doc(Return the number of bytes received so far)doc";
+
+static const char *__doc_mitsuba_SocketStream_sent = R"doc(Return the number of bytes sent so far)doc";
+
+static const char *__doc_mitsuba_SparseGridTexture =
+R"doc(Lookup structure for a SparseVolumeGrid
+
+The tree is uploaded into flat index and value buffers that are
+traversed with gathers, which works the same way on the CPU and within
+CUDA/LLVM kernels. The interface mirrors the subset of
+``dr::Texture3f`` that the ``gridvolume`` plugin relies on: evaluation
+uses the same voxel-centered conventions, filter and wrap modes.
+
+Neighboring voxels usually reside within the same leaf. Interpolated
+lookups therefore traverse the tree once for the first voxel of the
+stencil and reuse the cached leaf for all other voxels falling into it.)doc";
+
+static const char *__doc_mitsuba_SparseGridTexture_SparseGridTexture =
+R"doc(Upload the tree of ``grid``
+
+Parameter ``values``:
+    Leaf data with ``channels`` entries per voxel, laid out like
+    SparseVolumeGrid::values(). This makes it possible to upload
+    converted data (e.g. spectral upsampling coefficients).)doc";
+
+static const char *__doc_mitsuba_SparseGridTexture_channel_count = R"doc(Return the number of channels)doc";
+
+static const char *__doc_mitsuba_SparseGridTexture_eval = R"doc(Evaluate the grid at the local position ``p`` in ``[0, 1]^3``)doc";
+
+static const char *__doc_mitsuba_SparseGridTexture_eval_fetch =
+R"doc(Fetch the 8 voxels of the trilinear interpolation stencil around
+``p`` (ordered as in ``dr::Texture::eval_fetch()``))doc";
+
+static const char *__doc_mitsuba_SparseGridTexture_fetch = R"doc(Read all channels of voxel ``v`` from ``leaf`` (zero if unallocated))doc";
+
+static const char *__doc_mitsuba_SparseGridTexture_lookup_leaf = R"doc(Traverse the tree to find the leaf containing voxel ``v``)doc";
+
+static const char *__doc_mitsuba_SparseGridTexture_shape = R"doc(Return the resolution of the (virtual) dense grid)doc";
+
+static const char *__doc_mitsuba_SparseGridTexture_trilinear_stencil =
+R"doc(Invoke ``func(index, weight, leaf, voxel)`` for the voxels of the
+trilinear interpolation stencil around ``p``)doc";
+
+static const char *__doc_mitsuba_SparseGridTexture_values = R"doc(Return the voxel values of all leaves)doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid =
+R"doc(Sparse hierarchical storage for 3D volume grids
+
+Large simulation caches (smoke, clouds, explosions) typically only
+occupy a small fraction of their bounding grid. This class stores such
+volumes in a shallow tree with a fixed topology similar to NanoVDB: a
+dense root table references internal nodes spanning :math:`16^3`
+leaves, each of which in turn stores a dense brick of :math:`8^3`
+voxels. Only leaves that contain data are allocated. All other voxels
+take on the background value zero.
+
+The class handles loading and writing of sparse volume files
+(extension ``.svol``, see the documentation of the ``gridvolume``
+plugin for the specification), which are read directly into the sparse
+representation without ever allocating the dense grid. Sparse grids can
+furthermore be created from a dense VolumeGrid or from a list of active
+voxels.
+
+Lookups are performed by SparseGridTexture.)doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_SparseVolumeGrid =
+R"doc(Load a sparse volume grid from a given filename
+
+Parameter ``path``:
+    Name of the file to be loaded (expected to end in ".svol"))doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_SparseVolumeGrid_2 =
+R"doc(Load a sparse volume grid from an arbitrary stream data source
+
+Parameter ``stream``:
+    Pointer to an arbitrary stream data source)doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_SparseVolumeGrid_3 =
+R"doc(Convert a dense volume grid into its sparse representation
+
+Parameter ``grid``:
+    The dense source grid
+
+Parameter ``threshold``:
+    Leaves whose values do not exceed this threshold in magnitude are
+    not allocated and hence evaluate to zero.)doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_SparseVolumeGrid_4 =
+R"doc(Create a sparse volume grid from a list of active voxels
+
+Parameter ``size``:
+    Resolution of the (virtual) dense grid
+
+Parameter ``channel_count``:
+    Number of channels per voxel
+
+Parameter ``coords``:
+    Integer voxel coordinates, stored as consecutive (x, y, z) triplets
+
+Parameter ``values``:
+    Voxel values, stored as ``channel_count`` consecutive entries per
+    voxel
+
+Parameter ``count``:
+    Number of active voxels)doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_allocate_leaf = R"doc(Return the index of the leaf containing ``voxel``, allocating it if needed)doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_bbox_transform =
+R"doc(Return the transformation from the unit axis-aligned box to the grid's
+bounding box)doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_buffer_size = R"doc(Return the size of the tree and voxel data in bytes (excluding metadata))doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_channel_count = R"doc(Return the number of channels)doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_class = R"doc()doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_initialize = R"doc(Set up an empty tree for the given resolution)doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_leaf_count = R"doc(Return the number of allocated leaf nodes)doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_leaf_max = R"doc(Return the maximum over all voxels and channels of every leaf)doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_leaf_origins = R"doc(Return the coordinates of the first voxel of every leaf)doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_max = R"doc(Return the precomputed maximum over the volume grid)doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_max_per_channel =
+R"doc(Return the precomputed maximum over the volume grid per channel
+
+Pointer allocation/deallocation must be performed by the caller.)doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_node_count = R"doc(Return the number of allocated internal nodes)doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_nodes = R"doc(Return the child tables of all internal nodes, which hold leaf indices)doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_occupancy = R"doc(Return the fraction of the dense grid covered by allocated leaves)doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_read = R"doc()doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_root = R"doc(Return the root table holding the index of each internal node)doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_root_size = R"doc(Return the resolution of the root table (in internal nodes))doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_size = R"doc(Return the resolution of the (virtual) dense voxel grid)doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_to_string = R"doc(Return a human-readable summary of this sparse grid)doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_update_statistics = R"doc(Recompute the maxima and leaf origins after the tree has changed)doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_values =
+R"doc(Return the voxel values of all leaves
 
-static const char *__doc_mitsuba_SilhouetteSample_scene_index = R"doc(Index of the shape in the scene (if applicable))doc";
+The data of leaf ``i`` starts at offset ``i * LeafSize *
+channel_count()`` and is ordered like a small dense VolumeGrid (x
+varies fastest, channels are interleaved).)doc";
 
-static const char *__doc_mitsuba_SilhouetteSample_shape = R"doc(Pointer to the associated shape)doc";
+static const char *__doc_mitsuba_SparseVolumeGrid_write =
+R"doc(Write an encoded form of the sparse grid to a binary volume file
 
-static const char *__doc_mitsuba_SilhouetteSample_silhouette_d = R"doc(Direction of the silhouette curve at the boundary point)doc";
+Parameter ``path``:
+    Target file name (expected to end in ".svol"))doc";
 
-static const char *__doc_mitsuba_SilhouetteSample_spawn_ray =
-R"doc(Spawn a ray on the silhouette point in the direction of d
+static const char *__doc_mitsuba_SparseVolumeGrid_write_2 =
+R"doc(Write an encoded form of the sparse grid to a stream
 
-The ray origin is offset in the direction of the segment (d) aswell as
-in the in the direction of the silhouette normal (n). Without this
-offsetting, during a ray intersection, the ray could potentially find
-an intersection point at its origin due to numerical instabilities in
-the intersection routines.)doc";
+Parameter ``stream``:
+    Target stream that will receive the encoded output)doc";
 
 static const char *__doc_mitsuba_Spectrum =
 R"doc(//! @{ \name Data types for spectral quantities with sampled
@@ -8288,14 +9907,36 @@ static const char *__doc_mitsuba_Spiral_m_steps_left = R"doc()doc";
 static const char *__doc_mitsuba_Spiral_max_block_size = R"doc(Return the maximum block size)doc";
 
 static const char *__doc_mitsuba_Spiral_next_block =
-R"doc(Return the offset, size, and unique identifier of the next block.
+R"doc(Return the offset, size, unique identifier, and (square) block size of
+the next block.
 
-A size of zero indicates that the spiral traversal is done.)doc";
+The returned block size equals max_block_size() except for subdivided
+straggler blocks. It should be used along with the identifier to
+derive per-pixel seeds. A size of zero indicates that the spiral
+traversal is done.)doc";
 
 static const char *__doc_mitsuba_Spiral_reset =
 R"doc(Reset the spiral to its initial state. Does not affect the number of
 passes.)doc";
 
+static const char *__doc_mitsuba_Spiral_set_scanline_order =
+R"doc(Hand out the blocks in scanline order instead of along a spiral
+
+Blocks are sorted by row and then by column, while their identifiers
+(and therefore per-pixel random number seeds) are left unchanged. This
+is required by films that stream finished rows to disk. Must be called
+before set_straggler_blocks().)doc";
+
+static const char *__doc_mitsuba_Spiral_set_straggler_blocks =
+R"doc(Subdivide the last ``count`` blocks of the final pass into quadrants
+that are handed out individually
+
+Has no effect on blocks that are too small to be subdivided.)doc";
+
+static const char *__doc_mitsuba_Spiral_total_block_count =
+R"doc(Return the number of blocks generated by next_block() over all
+passes, including sub-blocks of subdivided stragglers)doc";
+
 static const char *__doc_mitsuba_Stream =
 R"doc(Abstract seekable stream class
 
@@ -8528,13 +10169,31 @@ functionality. For this reason, the implementation of this class
 relies on a JIT compiler that generates fast conversion code on demand
 for each specific conversion. The function is cached and reused in
 case the same conversion is needed later on. Note that JIT compilation
-only works on x86_64 processors; other platforms use a slow generic
-fallback implementation.)doc";
+only works on x86_64 processors. Other platforms (e.g. AArch64) use
+precompiled conversion routines for the common case where each target
+field is obtained from a single source field of a floating point or
+unsigned 8/16 bit integer type (e.g. 8-bit sRGB to linear 32-bit
+floats). All remaining conversions use a slow generic fallback
+implementation.)doc";
 
 static const char *__doc_mitsuba_StructConverter_StructConverter =
 R"doc(Construct an optimized conversion routine going from ``source`` to
 ``target``)doc";
 
+static const char *__doc_mitsuba_StructConverter_FastField = R"doc(Target field that is handled by the precompiled conversion routines)doc";
+
+static const char *__doc_mitsuba_StructConverter_FastField_constant = R"doc(The field is set to its encoded default value ``constant_value``)doc";
+
+static const char *__doc_mitsuba_StructConverter_FastField_constant_value = R"doc()doc";
+
+static const char *__doc_mitsuba_StructConverter_FastField_copy = R"doc(Copy the field without conversion (same type and flags))doc";
+
+static const char *__doc_mitsuba_StructConverter_FastField_lut = R"doc(Decoded values of an 8-bit source field)doc";
+
+static const char *__doc_mitsuba_StructConverter_FastField_source = R"doc(Corresponding source field (unless ``constant`` is set))doc";
+
+static const char *__doc_mitsuba_StructConverter_FastField_target = R"doc()doc";
+
 static const char *__doc_mitsuba_StructConverter_Value = R"doc()doc";
 
 static const char *__doc_mitsuba_StructConverter_Value_flags = R"doc()doc";
@@ -8547,12 +10206,21 @@ static const char *__doc_mitsuba_StructConverter_convert = R"doc(Convert ``count
 
 static const char *__doc_mitsuba_StructConverter_convert_2d = R"doc()doc";
 
+static const char *__doc_mitsuba_StructConverter_convert_2d_fast = R"doc()doc";
+
+static const char *__doc_mitsuba_StructConverter_init_fast_path =
+R"doc(Check if the precompiled conversion routines apply, and prepare them)doc";
+
 static const char *__doc_mitsuba_StructConverter_linearize = R"doc()doc";
 
 static const char *__doc_mitsuba_StructConverter_load = R"doc()doc";
 
 static const char *__doc_mitsuba_StructConverter_m_dither = R"doc()doc";
 
+static const char *__doc_mitsuba_StructConverter_m_fast = R"doc()doc";
+
+static const char *__doc_mitsuba_StructConverter_m_fast_fields = R"doc()doc";
+
 static const char *__doc_mitsuba_StructConverter_m_source = R"doc()doc";
 
 static const char *__doc_mitsuba_StructConverter_m_target = R"doc()doc";
@@ -9334,6 +11002,9 @@ before a leaf node will be created.)doc";
 
 static const char *__doc_mitsuba_TShapeKDTree_max_depth = R"doc(Return the maximum tree depth (0 == use heuristic))doc";
 
+static const char *__doc_mitsuba_TShapeKDTree_memory_usage =
+R"doc(Return the memory used by the nodes and primitive indices (in bytes))doc";
+
 static const char *__doc_mitsuba_TShapeKDTree_min_max_bins = R"doc(Return the number of bins used for Min-Max binning)doc";
 
 static const char *__doc_mitsuba_TShapeKDTree_ready = R"doc()doc";
@@ -9371,7 +11042,9 @@ static const char *__doc_mitsuba_TensorFile =
 R"doc(Simple exchange format for tensor data of arbitrary rank and size
 
 This class provides convenient memory-mapped read-only access to
-tensor data, usually exported from NumPy.)doc";
+tensor data, usually exported from NumPy. Besides Mitsuba's own multi-
+field format, it also reads NumPy ``.npy`` files, which contain a
+single field named after the file (without extension).)doc";
 
 static const char *__doc_mitsuba_TensorFile_Field = R"doc(Information about the specified field)doc";
 
@@ -9389,10 +11062,28 @@ static const char *__doc_mitsuba_TensorFile_class = R"doc()doc";
 
 static const char *__doc_mitsuba_TensorFile_field = R"doc(Return a data structure with information about the specified field)doc";
 
+static const char *__doc_mitsuba_TensorFile_field_names = R"doc(Return the names of all fields (in alphabetical order))doc";
+
 static const char *__doc_mitsuba_TensorFile_has_field = R"doc(Does the file contain a field of the specified name?)doc";
 
 static const char *__doc_mitsuba_TensorFile_m_fields = R"doc()doc";
 
+static const char *__doc_mitsuba_TensorFile_read_npy = R"doc(Parse the header of a NumPy ``.npy`` file)doc";
+
+static const char *__doc_mitsuba_TensorFile_tensor =
+R"doc(Create a tensor of the given type from the specified field
+
+When the field has the floating point type of the tensor, the tensor
+directly references the memory-mapped file on the CPU (scalar and LLVM
+variants), and the file remains mapped as long as the tensor data is
+in use. Other field types are converted, and GPU variants copy the
+data to the device.
+
+An empty ``name`` selects the only field of the file.
+
+The result is a handle that can be passed to plugins via
+Properties::set_tensor_handle().)doc";
+
 static const char *__doc_mitsuba_TensorFile_to_string = R"doc(Return a human-readable summary)doc";
 
 static const char *__doc_mitsuba_Texture =
@@ -9501,6 +11192,13 @@ default implementation throws an exception.
 Even if the operation is provided, it may only return an
 approximation.)doc";
 
+static const char *__doc_mitsuba_Texture_needs_differentials =
+R"doc(Does this texture evaluation use the UV partials (``duv_dx`` and
+``duv_dy``) of the surface interaction?
+
+BSDFs query this flag to request the computation of texture-space
+differentials (see BSDFFlags::NeedsDifferentials).)doc";
+
 static const char *__doc_mitsuba_Texture_pdf_position = R"doc(Returns the probability per unit area of sample_position())doc";
 
 static const char *__doc_mitsuba_Texture_pdf_spectrum =
@@ -9696,6 +11394,19 @@ privileges for this operation.
 Returns:
     ``True`` upon success.)doc";
 
+static const char *__doc_mitsuba_Thread_pin_worker_threads =
+R"doc(Pin the worker threads of the global thread pool to individual cores,
+grouped by NUMA node
+
+Workers are assigned to the cores of the first NUMA node before moving
+on to the next one (see util::numa_topology()), which prevents them
+from migrating across sockets. Once enabled, pinning is reapplied by
+set_thread_count(). The calling thread is not pinned.)doc";
+
+static const char *__doc_mitsuba_Thread_numa_node =
+R"doc(Return the NUMA node of the calling worker thread, or -1 if it isn't
+pinned)doc";
+
 static const char *__doc_mitsuba_Thread_set_thread_count =
 R"doc(Set the global thread count (e.g. spawn new threads in thread pool if
 > 1))doc";
@@ -9724,6 +11435,97 @@ static const char *__doc_mitsuba_Thread_wait_for_tasks = R"doc(Wait for previous
 
 static const char *__doc_mitsuba_Thread_yield = R"doc(Yield to another processor)doc";
 
+static const char *__doc_mitsuba_TileCache = R"doc(Global cache of image tiles with a fixed memory budget
+
+Tiles of TiledImage instances are loaded lazily on their first access
+and evicted in least-recently-used order once the resident tiles
+exceed the memory budget. Tiles are handed out as reference-counted
+pointers, hence an evicted tile stays valid for as long as it is in
+use.
+
+Every thread keeps a small direct-mapped cache of the tiles that it
+accessed most recently. Lookups that hit this per-thread cache do not
+acquire any lock; they only mark the tile as referenced, which grants
+it a second chance when it reaches the end of the global LRU list.)doc";
+
+static const char *__doc_mitsuba_TileCache_Statistics = R"doc(Counters describing the effectiveness of the cache)doc";
+
+static const char *__doc_mitsuba_TileCache_Statistics_budget = R"doc(Memory budget in bytes)doc";
+
+static const char *__doc_mitsuba_TileCache_Statistics_evictions = R"doc(Number of tiles evicted to stay within the budget)doc";
+
+static const char *__doc_mitsuba_TileCache_Statistics_hits = R"doc(Lookups served by the per-thread or global cache)doc";
+
+static const char *__doc_mitsuba_TileCache_Statistics_misses = R"doc(Lookups that required decoding a tile)doc";
+
+static const char *__doc_mitsuba_TileCache_Statistics_resident_bytes = R"doc(Number of tiles and bytes currently held by the global cache)doc";
+
+static const char *__doc_mitsuba_TileCache_Statistics_resident_tiles = R"doc(Number of tiles and bytes currently held by the global cache)doc";
+
+static const char *__doc_mitsuba_TileCache_TileCache = R"doc()doc";
+
+static const char *__doc_mitsuba_TileCache_budget = R"doc(Return the memory budget in bytes)doc";
+
+static const char *__doc_mitsuba_TileCache_class = R"doc()doc";
+
+static const char *__doc_mitsuba_TileCache_clear = R"doc(Evict all tiles)doc";
+
+static const char *__doc_mitsuba_TileCache_instance = R"doc(Return the global tile cache)doc";
+
+static const char *__doc_mitsuba_TileCache_reset_statistics = R"doc(Reset the hit, miss, and eviction counters)doc";
+
+static const char *__doc_mitsuba_TileCache_set_budget = R"doc(Set the memory budget in bytes (evicts tiles immediately if needed))doc";
+
+static const char *__doc_mitsuba_TileCache_statistics = R"doc(Return the current statistics)doc";
+
+static const char *__doc_mitsuba_TileCache_tile = R"doc(Return the tile at the given coordinates, loading it if necessary)doc";
+
+static const char *__doc_mitsuba_TileCache_to_string = R"doc()doc";
+
+static const char *__doc_mitsuba_TiledImage = R"doc(Image file whose contents are decoded in tiles on demand
+
+Only the header of the file is read upon construction. Tiles are then
+decoded via read_tile(), which is typically invoked by the global
+TileCache.
+
+- Tiled OpenEXR files are read one native tile at a time (the tile
+size specified at construction is ignored in this case).
+
+- Scanline OpenEXR files are read in bands of rows, and all tiles of a
+band are decoded at once.
+
+- Other formats supported by Bitmap cannot be decoded partially. The
+entire image is decoded whenever one of its tiles is requested.
+
+Images are converted into linear float32 luminance (1 channel) or RGB
+(3 channels) data, and alpha channels are dropped. Unless ``raw`` is
+set, LDR formats with an sRGB transfer curve are linearized.)doc";
+
+static const char *__doc_mitsuba_TiledImage_TiledImage = R"doc(Open the specified file and read its header)doc";
+
+static const char *__doc_mitsuba_TiledImage_channel_count = R"doc(Return the number of channels (1 or 3))doc";
+
+static const char *__doc_mitsuba_TiledImage_class = R"doc()doc";
+
+static const char *__doc_mitsuba_TiledImage_filename = R"doc(Return the associated filename)doc";
+
+static const char *__doc_mitsuba_TiledImage_read_tile = R"doc(Decode the tile at the given tile coordinates
+
+The callback is invoked for the requested tile and for every other
+tile that could be decoded at no extra cost (e.g. the remaining tiles
+of a band of scanlines). The requested tile is always passed last.
+This function is thread-safe.)doc";
+
+static const char *__doc_mitsuba_TiledImage_size = R"doc(Return the resolution of the image in texels)doc";
+
+static const char *__doc_mitsuba_TiledImage_tile_count = R"doc(Return the number of tiles along each dimension)doc";
+
+static const char *__doc_mitsuba_TiledImage_tile_size = R"doc(Return the nominal tile size in texels)doc";
+
+static const char *__doc_mitsuba_TiledImage_to_string = R"doc()doc";
+
+static const char *__doc_mitsuba_TiledImage_uid = R"doc(Return an identifier that is unique among all images created so far)doc";
+
 static const char *__doc_mitsuba_Timer = R"doc()doc";
 
 static const char *__doc_mitsuba_Timer_Timer = R"doc()doc";
@@ -9895,6 +11697,14 @@ static const char *__doc_mitsuba_Transform_translate = R"doc(Create a translatio
 
 static const char *__doc_mitsuba_Transform_translation = R"doc(Get the translation part of a matrix)doc";
 
+static const char *__doc_mitsuba_TransmittanceEstimator = R"doc(Estimators of the transmittance along shadow rays)doc";
+
+static const char *__doc_mitsuba_TransmittanceEstimator_RatioTracking = R"doc(Ratio tracking: weight by the null-collision probability at every step)doc";
+
+static const char *__doc_mitsuba_TransmittanceEstimator_ResidualRatioTracking =
+R"doc(Residual ratio tracking: evaluate the transmittance of a control
+extinction analytically, and ratio track the remaining residual)doc";
+
 static const char *__doc_mitsuba_TransportMode =
 R"doc(Specifies the transport mode when sampling or evaluating a scattering
 function)doc";
@@ -9921,6 +11731,20 @@ static const char *__doc_mitsuba_TraversalCallback_put_parameter = R"doc(Inform
 
 static const char *__doc_mitsuba_TraversalCallback_put_parameter_impl = R"doc(Actual implementation of put_parameter(). [To be provided by subclass])doc";
 
+static const char *__doc_mitsuba_VNDFSampling = R"doc(Supported routines for sampling the distribution of visible normals)doc";
+
+static const char *__doc_mitsuba_VNDFSampling_BoundedSphericalCaps =
+R"doc(Bounded spherical cap method by Eto and Tokuyoshi (GGX only)
+
+This variant concentrates the samples on visible normals whose
+reflection lies above the horizon. Its density differs from the
+visible normal distribution, and it is only valid for reflection
+(i.e. not for refraction through a dielectric interface).)doc";
+
+static const char *__doc_mitsuba_VNDFSampling_Heitz = R"doc(Stretch-based method by Heitz and d'Eon (the only choice for Beckmann))doc";
+
+static const char *__doc_mitsuba_VNDFSampling_SphericalCaps = R"doc(Spherical cap method by Dupuy and Benyoub (GGX only))doc";
+
 static const char *__doc_mitsuba_Vector = R"doc(//! @{ \name Elementary vector, point, and normal data types)doc";
 
 static const char *__doc_mitsuba_Vector_Vector = R"doc()doc";
@@ -9953,11 +11777,20 @@ static const char *__doc_mitsuba_VolumeGrid_4 = R"doc()doc";
 
 static const char *__doc_mitsuba_VolumeGrid_5 = R"doc()doc";
 
+static const char *__doc_mitsuba_VolumeGrid_HeaderSize = R"doc(Size of the header that precedes the voxel data in a volume file)doc";
+
 static const char *__doc_mitsuba_VolumeGrid_VolumeGrid =
 R"doc(Load a VolumeGrid from a given filename
 
 Parameter ``path``:
-    Name of the file to be loaded)doc";
+    Name of the file to be loaded
+
+Parameter ``memory_map``:
+    Map the file into memory and access the voxel data in place
+    instead of reading it into a separate buffer. This is only possible
+    when the file contents match the in-memory representation (single
+    precision variants on little endian machines) and is skipped
+    otherwise. The data of a memory-mapped grid is read-only.)doc";
 
 static const char *__doc_mitsuba_VolumeGrid_VolumeGrid_2 =
 R"doc(Load a VolumeGrid from an arbitrary stream data source
@@ -9979,10 +11812,15 @@ static const char *__doc_mitsuba_VolumeGrid_channel_count = R"doc(Return the num
 
 static const char *__doc_mitsuba_VolumeGrid_class = R"doc()doc";
 
-static const char *__doc_mitsuba_VolumeGrid_data = R"doc(Return a pointer to the underlying volume storage)doc";
+static const char *__doc_mitsuba_VolumeGrid_data =
+R"doc(Return a pointer to the underlying volume storage
+
+The storage must not be modified if the grid is memory-mapped.)doc";
 
 static const char *__doc_mitsuba_VolumeGrid_data_2 = R"doc(Return a pointer to the underlying volume storage)doc";
 
+static const char *__doc_mitsuba_VolumeGrid_is_memory_mapped = R"doc(Is the voxel data accessed in place within a memory-mapped file?)doc";
+
 static const char *__doc_mitsuba_VolumeGrid_m_bbox = R"doc()doc";
 
 static const char *__doc_mitsuba_VolumeGrid_m_channel_count = R"doc()doc";
@@ -9993,6 +11831,8 @@ static const char *__doc_mitsuba_VolumeGrid_m_max = R"doc()doc";
 
 static const char *__doc_mitsuba_VolumeGrid_m_max_per_channel = R"doc()doc";
 
+static const char *__doc_mitsuba_VolumeGrid_m_mmap = R"doc()doc";
+
 static const char *__doc_mitsuba_VolumeGrid_m_size = R"doc()doc";
 
 static const char *__doc_mitsuba_VolumeGrid_max = R"doc(Return the precomputed maximum over the volume grid)doc";
@@ -10004,6 +11844,8 @@ Pointer allocation/deallocation must be performed by the caller.)doc";
 
 static const char *__doc_mitsuba_VolumeGrid_read = R"doc()doc";
 
+static const char *__doc_mitsuba_VolumeGrid_read_header = R"doc(Read the header (everything except for the voxel data))doc";
+
 static const char *__doc_mitsuba_VolumeGrid_set_max = R"doc(Set the precomputed maximum over the volume grid)doc";
 
 static const char *__doc_mitsuba_VolumeGrid_set_max_per_channel =
@@ -10015,6 +11857,8 @@ static const char *__doc_mitsuba_VolumeGrid_size = R"doc(Return the resolution o
 
 static const char *__doc_mitsuba_VolumeGrid_to_string = R"doc(Return a human-readable summary of this volume grid)doc";
 
+static const char *__doc_mitsuba_VolumeGrid_update_max = R"doc(Compute the maximum over the grid and over each channel in parallel)doc";
+
 static const char *__doc_mitsuba_VolumeGrid_write =
 R"doc(Write an encoded form of the bitmap to a binary volume file
 
@@ -10079,21 +11923,51 @@ maximum value for each channel.
 
 Pointer allocation/deallocation must be performed by the caller.)doc";
 
+static const char *__doc_mitsuba_Volume_max_per_supervoxel =
+R"doc(Returns conservative upper bounds of the volume's values within the
+cells of a coarse regular grid that subdivides the volume's local unit
+cube.
+
+The returned array holds ``resolution.x() * resolution.y() *
+resolution.z()`` entries, ordered like the volume data itself (the x
+index varies fastest). Every entry bounds all values that a lookup
+within the corresponding cell can return, which makes it suitable as a
+piecewise-constant majorant for delta tracking.
+
+The default implementation bounds every cell by max().)doc";
+
+static const char *__doc_mitsuba_Volume_min =
+R"doc(Returns a lower bound of the values of the volume over all
+dimensions.
+
+This is used, e.g., as the control extinction of residual ratio
+tracking. The bound is not necessarily tight.)doc";
+
 static const char *__doc_mitsuba_Volume_resolution =
 R"doc(Returns the resolution of the volume, assuming that it is based on a
 discrete representation.
 
 The default implementation returns ``(1, 1, 1)``)doc";
 
+static const char *__doc_mitsuba_Volume_to_local =
+R"doc(Returns the transformation that maps world space onto the volume's
+local unit cube)doc";
+
 static const char *__doc_mitsuba_Volume_to_string = R"doc(Returns a human-reable summary)doc";
 
 static const char *__doc_mitsuba_Volume_update_bbox = R"doc()doc";
 
 static const char *__doc_mitsuba_ZStream =
-R"doc(Transparent compression/decompression stream based on ``zlib``.
+R"doc(Transparent compression/decompression stream based on ``zlib``,
+``zstd``, or ``LZ4``.
 
 This class transparently decompresses and compresses reads and writes
-to a nested stream, respectively.)doc";
+to a nested stream, respectively.
+
+The zstd and LZ4 formats decompress considerably faster than zlib at
+similar compression ratios. Their availability depends on whether the
+respective libraries were found when Mitsuba was compiled (see
+has_backend()).)doc";
 
 static const char *__doc_mitsuba_ZStream_EStreamType = R"doc()doc";
 
@@ -10101,10 +11975,22 @@ static const char *__doc_mitsuba_ZStream_EStreamType_EDeflateStream = R"doc()doc
 
 static const char *__doc_mitsuba_ZStream_EStreamType_EGZipStream = R"doc(A raw deflate stream)doc";
 
+static const char *__doc_mitsuba_ZStream_EStreamType_ELZ4Stream = R"doc(A zstd stream)doc";
+
+static const char *__doc_mitsuba_ZStream_EStreamType_EZstdStream = R"doc(A gzip-compatible stream)doc";
+
 static const char *__doc_mitsuba_ZStream_ZStream =
 R"doc(Creates a new compression stream with the given underlying stream.
 This new instance takes ownership of the child stream. The child
-stream must outlive the ZStream.)doc";
+stream must outlive the ZStream.
+
+Parameter ``level``:
+    Compression level. The value -1 selects the default level of the
+    compression library.
+
+Parameter ``threads``:
+    Number of worker threads that compress data in the background
+    (zstd only). The default value 0 compresses on the calling thread.)doc";
 
 static const char *__doc_mitsuba_ZStream_can_read = R"doc(Can we read from the stream?)doc";
 
@@ -10123,8 +12009,17 @@ read or write operations are permitted.
 This function is idempotent. It is called automatically by the
 destructor.)doc";
 
+static const char *__doc_mitsuba_ZStream_detect_type =
+R"doc(Determine the stream type from the first bytes of a (seekable)
+stream, without changing its position
+
+Returns EDeflateStream when the format is not recognized.)doc";
+
 static const char *__doc_mitsuba_ZStream_flush = R"doc(Flushes any buffered data)doc";
 
+static const char *__doc_mitsuba_ZStream_has_backend =
+R"doc(Was Mitsuba compiled with support for the given stream type?)doc";
+
 static const char *__doc_mitsuba_ZStream_is_closed = R"doc(Whether the stream is closed (no read or write are then permitted).)doc";
 
 static const char *__doc_mitsuba_ZStream_m_child_stream = R"doc()doc";
@@ -10137,17 +12032,31 @@ static const char *__doc_mitsuba_ZStream_m_did_write = R"doc()doc";
 
 static const char *__doc_mitsuba_ZStream_m_inflate_buffer = R"doc()doc";
 
+static const char *__doc_mitsuba_ZStream_m_inflate_pos = R"doc(Consumed and total bytes of the input buffer (zstd and LZ4))doc";
+
+static const char *__doc_mitsuba_ZStream_m_inflate_size = R"doc(Consumed and total bytes of the input buffer (zstd and LZ4))doc";
+
 static const char *__doc_mitsuba_ZStream_m_inflate_stream = R"doc()doc";
 
+static const char *__doc_mitsuba_ZStream_m_lz4 = R"doc()doc";
+
+static const char *__doc_mitsuba_ZStream_m_stream_type = R"doc()doc";
+
+static const char *__doc_mitsuba_ZStream_m_zstd = R"doc()doc";
+
 static const char *__doc_mitsuba_ZStream_read =
 R"doc(Reads a specified amount of data from the stream, decompressing it
 first using ZLib. Throws an exception when the stream ended
 prematurely.)doc";
 
+static const char *__doc_mitsuba_ZStream_refill = R"doc(Fill the input buffer from the child stream (zstd and LZ4))doc";
+
 static const char *__doc_mitsuba_ZStream_seek = R"doc(Unsupported. Always throws.)doc";
 
 static const char *__doc_mitsuba_ZStream_size = R"doc(Unsupported. Always throws.)doc";
 
+static const char *__doc_mitsuba_ZStream_stream_type = R"doc(Returns the compression format of this stream)doc";
+
 static const char *__doc_mitsuba_ZStream_tell = R"doc(Unsupported. Always throws.)doc";
 
 static const char *__doc_mitsuba_ZStream_to_string = R"doc(Returns a string representation)doc";
@@ -10159,6 +12068,12 @@ R"doc(Writes a specified amount of data into the stream, compressing it
 first using ZLib. Throws an exception when not all data could be
 written.)doc";
 
+static const char *__doc_mitsuba_ZStream_write_frames =
+R"doc(Compress data using zstd or LZ4 and write it to the child stream
+
+Parameter ``mode``:
+    0: compress the data, 1: flush the stream, 2: end the stream)doc";
+
 static const char *__doc_mitsuba_accumulate_2d =
 R"doc(Accumulate the contents of a source bitmap into a target bitmap with
 specified offsets for both.
@@ -10178,6 +12093,47 @@ if this is required by the BSDF (e.g. for texture filtering).
 
 Implementation in 'bsdf.h')doc";
 
+static const char *__doc_mitsuba_build_guiding_octree =
+R"doc(Partition the unit cube into an octree adapted to a set of points
+
+This function implements the construction of the spatial guiding
+distribution used by the projective sampling integrators (see
+``OcSpaceDistr`` in ``mitsuba/ad/guiding.py``). The unit cube is first
+split into ``x_slices`` slabs along the X axis. The nodes are then
+subdivided level by level: every child node with at most one point
+becomes a leaf (starting from the third level), and all remaining
+nodes become leaves at level ``max_depth``.
+
+The construction runs on the host and performs a single pass over the
+points per level. Points that don't lie inside any of the slabs (i.e.
+with ``x <= 0``) are ignored.
+
+Parameter ``x``:
+    X coordinates of the points
+
+Parameter ``y``:
+    Y coordinates of the points
+
+Parameter ``z``:
+    Z coordinates of the points
+
+Parameter ``count``:
+    Number of points
+
+Parameter ``x_slices``:
+    Number of root nodes along the X axis
+
+Parameter ``max_depth``:
+    Maximum depth of the octree
+
+Parameter ``max_leaf_count``:
+    Maximum number of leaves. An exception is raised when the
+    construction would exceed it.
+
+Returns:
+    The bounding boxes of all leaves, in the order in which they were
+    created.)doc";
+
 static const char *__doc_mitsuba_build_gas =
 R"doc(Build OptiX geometry acceleration structures (GAS) for a given list of
 shapes.
@@ -10486,6 +12442,11 @@ condition is not treated as an error).)doc";
 
 static const char *__doc_mitsuba_filesystem_current_path = R"doc(Returns the current working directory (equivalent to getcwd))doc";
 
+static const char *__doc_mitsuba_filesystem_directory_entries =
+R"doc(Returns the names of the entries of the directory ``p`` (excluding
+'.' and '..') in unspecified order. Returns an empty list if ``p`` is
+not a readable directory.)doc";
+
 static const char *__doc_mitsuba_filesystem_equivalent =
 R"doc(Checks whether two paths refer to the same file system object. Both
 must refer to an existing file or directory. Symlinks are followed to
@@ -10504,6 +12465,10 @@ static const char *__doc_mitsuba_filesystem_is_regular_file =
 R"doc(Checks if ``p`` points to a regular file, as opposed to a directory or
 symlink.)doc";
 
+static const char *__doc_mitsuba_filesystem_last_write_time =
+R"doc(Returns the time of the last modification of the file at ``p`` (in
+seconds since the epoch). The file must exist.)doc";
+
 static const char *__doc_mitsuba_filesystem_path =
 R"doc(Represents a path to a filesystem resource. On construction, the path
 is parsed and stored in a system-agnostic representation. The path can
@@ -10863,6 +12828,18 @@ UInt32 index = find_interval(
 );
 ```)doc";
 
+static const char *__doc_mitsuba_math_float_to_half =
+R"doc(Convert single precision values to the bit pattern of half precision
+values (stored in 32 bit integers)
+
+This is the inverse of half_to_float(). Values are rounded to the
+nearest representable half precision value (ties to even), overflow
+produces infinities, and NaNs are preserved.)doc";
+
+static const char *__doc_mitsuba_math_half_to_float =
+R"doc(Convert the bit pattern of half precision values (stored in 32 bit
+integers) to single precision)doc";
+
 static const char *__doc_mitsuba_math_is_power_of_two = R"doc(Check whether the provided integer is a power of two)doc";
 
 static const char *__doc_mitsuba_math_legendre_p = R"doc(Evaluate the l-th Legendre polynomial using recurrence)doc";
@@ -10971,6 +12948,12 @@ R"doc(Constructs the Mueller matrix of a (right) circular polarizer.
 
 "Polarized Light and Optical Systems" by Chipman et al. Table 6.2)doc";
 
+static const char *__doc_mitsuba_mueller_rotate_columns =
+R"doc(Efficiently computes ``M * transpose(rotator(theta))``
+
+This is the counterpart of rotate_rows() that mixes the columns 1 and
+2 of ``M``.)doc";
+
 static const char *__doc_mitsuba_mueller_rotate_mueller_basis =
 R"doc(Return the Mueller matrix for some new reference frames. This version
 rotates the input/output frames independently.
@@ -11038,6 +13021,13 @@ Returns:
     New Mueller matrix that operates from ``basis_target`` to
     ``basis_target``.)doc";
 
+static const char *__doc_mitsuba_mueller_rotate_rows =
+R"doc(Efficiently computes ``rotator(theta) * M``
+
+A rotator only mixes the rows 1 and 2 of ``M``, which takes 16
+multiplications instead of the 64 of a dense matrix product. The
+rotation is specified by the cosine and sine of ``2 * theta``.)doc";
+
 static const char *__doc_mitsuba_mueller_rotate_stokes_basis =
 R"doc(Gives the Mueller matrix that aligns the reference frames (defined by
 their respective basis vectors) of two collinear stokes vectors.
@@ -11122,6 +13112,17 @@ Returns:
     The (implicitly defined) reference coordinate system basis for the
     Stokes vector traveling along forward.)doc";
 
+static const char *__doc_mitsuba_mueller_stokes_basis_rotation =
+R"doc(Gives the rotation that aligns the reference frames of two collinear
+Stokes vectors
+
+Returns the cosine and sine of twice the angle between
+``basis_current`` and ``basis_target``, i.e. the entries of the
+rotator computed by rotate_stokes_basis(). They are computed directly
+from the dot and cross products of the bases, without evaluating any
+trigonometric functions. The arguments are the same as for
+rotate_stokes_basis().)doc";
+
 static const char *__doc_mitsuba_operator_add = R"doc()doc";
 
 static const char *__doc_mitsuba_operator_add_2 = R"doc()doc";
@@ -11296,12 +13297,63 @@ static const char *__doc_mitsuba_operator_sub = R"doc(Subtracting two points sho
 
 static const char *__doc_mitsuba_operator_sub_2 = R"doc(Subtracting a vector from a point should always yield a point)doc";
 
+static const char *__doc_mitsuba_optix_configure_cache =
+R"doc(Configure the disk cache of compiled OptiX modules
+
+OptiX stores the modules that it compiles from the PTX code of Mitsuba's
+ray tracing programs in a cache on disk, which makes the creation of the
+ray tracing pipeline much faster in subsequent processes. The entries of
+the cache are keyed by the PTX code, the compile options (which depend on
+the shape types of the scene) and the OptiX and driver versions, hence the
+cache never returns stale modules.
+
+By default, the cache is stored in the directory chosen by the driver
+(or the one specified via the ``OPTIX_CACHE_PATH`` environment variable).
+Processes that start in a fresh environment (e.g. containers) should point
+it to a persistent location using this function.
+
+Parameter ``path``:
+    Directory of the cache. An empty string disables the cache.
+
+Parameter ``max_size``:
+    Maximum size of the cache in bytes, or zero to keep the driver's
+    default limit.
+
+The setting also applies when OptiX is initialized later on.)doc";
+
 static const char *__doc_mitsuba_optix_initialize = R"doc()doc";
 
 static const char *__doc_mitsuba_orthographic_projection =
 R"doc(Helper function to create a orthographic projection transformation
 matrix)doc";
 
+static const char *__doc_mitsuba_owen_scramble_2 =
+R"doc(Hash-based Owen scrambling of a 32 bit fixed point value in base 2
+
+Every bit of the result is flipped depending on ``seed`` and on all of
+the more significant bits of ``x``, which corresponds to a nested
+uniform scramble. This is the improved Laine-Karras hash proposed in
+"Practical Hash-based Owen Scrambling" by Brent Burley (JCGT 2020).
+
+When applied to a sample index (rather than a sample value), this
+function shuffles the order of the points of a sequence while mapping
+every aligned block of ``2^m`` indices onto another such block.)doc";
+
+static const char *__doc_mitsuba_parameters_changed_batch =
+R"doc(Invoke Object::parameters_changed() on a batch of objects
+
+The objects are notified from the bottom to the top of the scene graph
+(i.e. in order of decreasing depth), so that parent objects observe the
+updated state of their children. Objects at the same depth don't
+depend on each other and are updated in parallel. Every object
+receives a single notification, hence a scene that contains any number
+of modified shapes rebuilds or refits its acceleration data structure
+only once.
+
+This is the implementation of <tt>SceneParameters.update()</tt> in
+Python, which avoids the overheads of notifying the objects one at a
+time.)doc";
+
 static const char *__doc_mitsuba_parse_fov = R"doc(Helper function to parse the field of view field of a camera)doc";
 
 static const char *__doc_mitsuba_pdf_rgb_spectrum =
@@ -11362,6 +13414,30 @@ static const char *__doc_mitsuba_perspective_projection =
 R"doc(Helper function to create a perspective projection transformation
 matrix)doc";
 
+static const char *__doc_mitsuba_philox_4x32 =
+R"doc(Counter-based pseudorandom number generation using the Philox4x32
+block cipher by John Salmon, Mark Moraes, Ron Dror, and David Shaw.
+
+For details, refer to "Parallel Random Numbers: As Easy as 1, 2, 3" by
+the same authors. In contrast to a stateful generator such as PCG32,
+every output is a pure function of its inputs, which means that the
+counter can be reconstructed on the fly rather than having to be
+stored.
+
+Parameter ``counter``:
+    Four 32-bit values to be encrypted (e.g. the sequence index, the
+    sample index and the requested random number dimension)
+
+Parameter ``key``:
+    Two 32-bit values specifying the key (e.g. a seed)
+
+Parameter ``rounds``:
+    How many rounds should be executed? The default of 10 passes all
+    tests of the BigCrush suite with a safety margin.
+
+Returns:
+    Four uniformly distributed 32-bit integers)doc";
+
 static const char *__doc_mitsuba_prepare_ias =
 R"doc(Prepares and fills the OptixInstance array associated with a given
 list of shapes.)doc";
@@ -11455,6 +13531,8 @@ Returns:
 
 static const char *__doc_mitsuba_radical_inverse_2 = R"doc(Van der Corput radical inverse in base 2)doc";
 
+static const char *__doc_mitsuba_reverse_bits_32 = R"doc(Reverse the order of the bits of a 32 bit unsigned integer)doc";
+
 static const char *__doc_mitsuba_ref =
 R"doc(Reference counting helper
 
@@ -11710,6 +13788,8 @@ static const char *__doc_mitsuba_sggx_sample_2 = R"doc()doc";
 
 static const char *__doc_mitsuba_sobol_2 = R"doc(Sobol' radical inverse in base 2)doc";
 
+static const char *__doc_mitsuba_sobol_2_bits = R"doc(Second dimension of the Sobol' sequence as a 32 bit fixed point value)doc";
+
 static const char *__doc_mitsuba_spectrum_from_file =
 R"doc(Read a spectral power distribution from an ASCII file.
 
@@ -11769,6 +13849,77 @@ static const char *__doc_mitsuba_spectrum_to_xyz =
 R"doc(Spectral responses to XYZ normalized according to the CIE curves to
 ensure that a unit-valued spectrum integrates to a luminance of 1.0.)doc";
 
+static const char *__doc_mitsuba_spline_IntervalIndex =
+R"doc(Uniform grid that accelerates the interval searches of *non*-uniformly
+sampled splines
+
+The functions below that operate on non-uniformly spaced data (e.g.
+eval_1d() or sample_1d()) must find the interval containing a
+query within a monotonic array (the nodes, function values, or the CDF
+depending on the function), which normally requires a binary search
+with a logarithmic number of dependent gathers. This class partitions
+the range of such an array into equally sized cells and records the
+range of entries that fall into each one of them. A query is then
+mapped to its cell in constant time, after which only the few entries
+of that cell must be searched. The number of search steps is uniform
+across all queries, which keeps packet and JIT arrays coherent.
+
+The result is identical to that of math::find_interval(). The index
+does not store a copy of the array, which must be passed to find()
+again and remain unchanged.)doc";
+
+static const char *__doc_mitsuba_spline_IntervalIndex_IntervalIndex = R"doc()doc";
+
+static const char *__doc_mitsuba_spline_IntervalIndex_IntervalIndex_2 =
+R"doc(Build the index for a monotonically increasing array
+
+Parameter ``data``:
+    Array containing ``size`` entries in increasing order
+
+Parameter ``size``:
+    Denotes the size of the ``data`` array
+
+Parameter ``cells``:
+    Number of grid cells. The default value of zero creates one cell
+    per interval.)doc";
+
+static const char *__doc_mitsuba_spline_IntervalIndex_cell = R"doc(Map a position to its grid cell (monotonic in ``x``))doc";
+
+static const char *__doc_mitsuba_spline_IntervalIndex_cells = R"doc(Return the number of grid cells)doc";
+
+static const char *__doc_mitsuba_spline_IntervalIndex_find =
+R"doc(Find the interval containing ``x``
+
+Returns the largest index ``i`` in ``[0, size-2]`` such that
+``data[i] <= x``, or zero if there is no such entry.
+
+Parameter ``data``:
+    The array that was used to build the index
+
+Parameter ``x``:
+    Query point
+
+Parameter ``active``:
+    Mask of active lanes)doc";
+
+static const char *__doc_mitsuba_spline_IntervalIndex_iterations = R"doc(Return the number of bisection steps performed by find())doc";
+
+static const char *__doc_mitsuba_spline_IntervalIndex_m_cells = R"doc()doc";
+
+static const char *__doc_mitsuba_spline_IntervalIndex_m_iterations = R"doc()doc";
+
+static const char *__doc_mitsuba_spline_IntervalIndex_m_min = R"doc()doc";
+
+static const char *__doc_mitsuba_spline_IntervalIndex_m_offsets =
+R"doc(Number of interior entries that map to cells preceding each cell)doc";
+
+static const char *__doc_mitsuba_spline_IntervalIndex_m_scale = R"doc()doc";
+
+static const char *__doc_mitsuba_spline_IntervalIndex_m_size = R"doc()doc";
+
+static const char *__doc_mitsuba_spline_IntervalIndex_size =
+R"doc(Return the size of the array that was used to build the index)doc";
+
 static const char *__doc_mitsuba_spline_eval_1d =
 R"doc(Evaluate a cubic spline interpolant of a *uniformly* sampled 1D
 function
@@ -11836,6 +13987,10 @@ Parameter ``size``:
 Parameter ``x``:
     Evaluation point
 
+Parameter ``index``:
+    Optional IntervalIndex built over ``nodes``, which replaces the
+    binary search for the interval containing ``x``
+
 Remark:
     The Python API lacks the ``size`` parameter, which is inferred
     automatically from the size of the input array
@@ -11887,6 +14042,12 @@ Parameter ``x``:
 Parameter ``y``:
     ``Y`` coordinate of the evaluation point
 
+Parameter ``index1``:
+    Optional IntervalIndex built over ``nodes1``
+
+Parameter ``index2``:
+    Optional IntervalIndex built over ``nodes2``
+
 Remark:
     The Python API lacks the ``size1`` and ``size2`` parameters, which
     are inferred automatically from the size of the input arrays.
@@ -12025,6 +14186,10 @@ Parameter ``x``:
 Parameter ``weights``:
     Pointer to a weight array of size 4 that will be populated
 
+Parameter ``index``:
+    Optional IntervalIndex built over ``nodes``, which replaces the
+    binary search for the interval containing ``x``
+
 Remark:
     The Python API lacks the ``size`` parameter, which is inferred
     automatically from the size of the input array. The ``offset`` and
@@ -12116,6 +14281,10 @@ Parameter ``y``:
 Parameter ``eps``:
     Error tolerance (default: 1e-6f)
 
+Parameter ``index``:
+    Optional IntervalIndex built over ``values``, which replaces the
+    binary search for the interval containing ``y``
+
 Returns:
     The spline parameter ``t`` such that ``eval_1d(..., t)=y``)doc";
 
@@ -12141,6 +14310,10 @@ Parameter ``y``:
 Parameter ``eps``:
     Error tolerance (default: 1e-6f)
 
+Parameter ``index``:
+    Optional IntervalIndex built over ``values``, which replaces the
+    binary search for the interval containing ``y``
+
 Returns:
     The spline parameter ``t`` such that ``eval_1d(..., t)=y``)doc";
 
@@ -12171,6 +14344,10 @@ Parameter ``sample``:
 Parameter ``eps``:
     Error tolerance (default: 1e-6f)
 
+Parameter ``index``:
+    Optional IntervalIndex built over ``cdf``, which replaces the
+    binary search for the interval containing the scaled ``sample``
+
 Returns:
     1. The sampled position 2. The value of the spline evaluated at
     the sampled position 3. The probability density at the sampled
@@ -12203,6 +14380,10 @@ Parameter ``sample``:
 Parameter ``eps``:
     Error tolerance (default: 1e-6f)
 
+Parameter ``index``:
+    Optional IntervalIndex built over ``cdf``, which replaces the
+    binary search for the interval containing the scaled ``sample``
+
 Returns:
     1. The sampled position 2. The value of the spline evaluated at
     the sampled position 3. The probability density at the sampled
@@ -12220,8 +14401,41 @@ Parameter ``c``:
 Returns:
     Coefficients for use with srgb_model_eval)doc";
 
+static const char *__doc_mitsuba_srgb_model_fetch_2 =
+R"doc(Look up the model coefficients for an array of sRGB color values
+
+JIT version of srgb_model_fetch(), which uploads the model tables and
+performs the lookup on the device.)doc";
+
+static const char *__doc_mitsuba_srgb_model_fetch_3 =
+R"doc(Convert an array of sRGB color values into model coefficients
+
+This function processes the values in parallel using multiple threads
+and SIMD packets, and is the preferred way of converting whole
+textures.
+
+Parameter ``data``:
+    Pointer to ``count`` groups of ``stride`` values. The first three
+    values of every group hold an sRGB color, which is overwritten with
+    the model coefficients. The remaining values of a group are left
+    untouched.
+
+Parameter ``mean``:
+    When not ``nullptr``, the average of srgb_model_mean() over all
+    converted values is written to this address.)doc";
+
+static const char *__doc_mitsuba_srgb_model_fetch_4 = R"doc(Double precision version of the above)doc";
+
 static const char *__doc_mitsuba_srgb_model_mean = R"doc()doc";
 
+static const char *__doc_mitsuba_srgb_model_tables =
+R"doc(Return the tables of the spectral upsampling model
+
+The model is loaded if this didn't already happen. Returns the
+resolution of the model and writes pointers to its scale table
+(``res`` entries) and coefficient table (``3 * res^3 * 3`` entries) to
+``scale`` and ``data``.)doc"; = R"doc()doc";
+
 static const char *__doc_mitsuba_srgb_to_xyz = R"doc(Convert ITU-R Rec. BT.709 linear RGB to XYZ tristimulus values)doc";
 
 static const char *__doc_mitsuba_string_contains = R"doc(Check if a list of keys contains a specific key)doc";
@@ -12325,6 +14539,13 @@ static const char *__doc_mitsuba_util_Version_patch = R"doc()doc";
 
 static const char *__doc_mitsuba_util_core_count = R"doc(Determine the number of available CPU cores (including virtual cores))doc";
 
+static const char *__doc_mitsuba_util_numa_topology =
+R"doc(Return the CPU cores available to this process, grouped by NUMA node
+
+On Linux, the topology is read from ``/sys/devices/system/node``. On
+other platforms, or when this information is unavailable, a single node
+containing all cores is returned.)doc";
+
 static const char *__doc_mitsuba_util_detect_debugger = R"doc(Returns 'true' if the application is running inside a debugger)doc";
 
 static const char *__doc_mitsuba_util_info_build = R"doc(Return human-readable information about the Mitsuba build)doc";
@@ -12421,6 +14642,12 @@ static const char *__doc_mitsuba_warp_interval_to_tent = R"doc(Warp a uniformly
 
 static const char *__doc_mitsuba_warp_linear_to_interval = R"doc(Inverse of interval_to_linear)doc";
 
+static const char *__doc_mitsuba_warp_spherical_triangle_solid_angle =
+R"doc(Solid angle of the spherical triangle with the given vertices
+
+The vertices must be unit vectors. Based on "The Solid Angle of a Plane
+Triangle" by A. Van Oosterom and J. Strackee, IEEE TBME 1983.)doc";
+
 static const char *__doc_mitsuba_warp_square_to_beckmann = R"doc(Warp a uniformly distributed square sample to a Beckmann distribution)doc";
 
 static const char *__doc_mitsuba_warp_square_to_beckmann_pdf = R"doc(Probability density of square_to_beckmann())doc";
@@ -12454,6 +14681,15 @@ distribution)doc";
 
 static const char *__doc_mitsuba_warp_square_to_rough_fiber_pdf = R"doc(Probability density of square_to_rough_fiber())doc";
 
+static const char *__doc_mitsuba_warp_square_to_spherical_triangle =
+R"doc(Uniformly sample a direction on the spherical triangle with the given
+vertices
+
+The vertices must be unit vectors, and the density of the resulting
+directions is the reciprocal of spherical_triangle_solid_angle().
+Based on "Stratified Sampling of Spherical Triangles" by James Arvo,
+SIGGRAPH 1995.)doc";
+
 static const char *__doc_mitsuba_warp_square_to_std_normal =
 R"doc(Sample a point on a 2D standard normal distribution. Internally uses
 the Box-Muller transformation)doc";
@@ -12545,6 +14781,75 @@ static const char *__doc_mitsuba_warp_uniform_triangle_to_square = R"doc(Inverse
 
 static const char *__doc_mitsuba_warp_von_mises_fisher_to_square = R"doc(Inverse of the mapping von_mises_fisher_to_square)doc";
 
+static const char *__doc_mitsuba_wrap_voxel_index =
+R"doc(Map an integer voxel coordinate into the range ``[0, n)`` following
+the given texture wrap mode)doc";
+
+static const char *__doc_mitsuba_xml_SceneUpdater =
+R"doc(Loads a scene from an XML file and incrementally applies later changes
+of its description
+
+Instead of reloading the entire scene when its description changes
+slightly (e.g. one material was edited or one object was moved), this
+class compares the new description against the previous one and only
+updates the objects that actually changed. Objects are matched by
+their ``id``, while anonymous objects are matched by their position
+within the parent object or, failing that, by their structure.
+
+A changed object is updated in place when all modified properties are
+exposed under the same name by Object::traverse() (e.g. the
+``reflectance`` of a BSDF or the ``to_world`` transformation of a
+sphere). The geometry of meshes may change as well (``to_world`` or
+``filename``), in which case their vertex buffers are replaced. A new
+instance of the plugin is created temporarily to obtain the new
+parameter values, which are then copied into the existing object,
+followed by calls to Object::parameters_changed() on the object and
+its ancestors. The scene eventually updates its acceleration data
+structure if shapes were modified.
+
+All other changes (e.g. a different plugin type, added or removed
+child objects, or properties that cannot be accessed via
+Object::traverse()) re-create the object along with its ancestors,
+while unchanged child objects are reused. If this affects the scene
+itself, scene() returns a new object after the update.
+
+Updates are applied one object at a time. When an update fails (e.g.
+because of an invalid plugin parameter), the scene may therefore be
+left in a partially updated state.)doc";
+
+static const char *__doc_mitsuba_xml_SceneUpdater_SceneUpdater =
+R"doc(Load a scene from an XML file
+
+Parameter ``path``:
+    Filename of the scene XML file
+
+Parameter ``variant``:
+    Specifies the variant of plugins to instantiate (e.g. "scalar_rgb")
+
+Parameter ``parameters``:
+    Optional list of parameters that can be referenced as ``$varname``
+    in the scene.)doc";
+
+static const char *__doc_mitsuba_xml_SceneUpdater_scene = R"doc(Return the current scene)doc";
+
+static const char *__doc_mitsuba_xml_SceneUpdater_update =
+R"doc(Change the properties of the object with the given ``id``
+
+The entries of ``props`` are added to the object's properties,
+replacing existing ones of the same name. A non-empty plugin name
+switches the plugin type. Returns the identifiers of the objects that
+were updated in place or re-created.)doc";
+
+static const char *__doc_mitsuba_xml_SceneUpdater_update_file =
+R"doc(Update the scene to match a new version of its XML file
+
+Returns the identifiers of the objects that were updated in place or
+re-created, including the generated identifiers of anonymous objects.
+Relative paths are resolved with respect to the directory of the
+original scene file.)doc";
+
+static const char *__doc_mitsuba_xml_SceneUpdater_update_string = R"doc(Update the scene to match a new description given as XML string)doc";
+
 static const char *__doc_mitsuba_xml_ScopedSetJITScope = R"doc()doc";
 
 static const char *__doc_mitsuba_xml_ScopedSetJITScope_ScopedSetJITScope = R"doc()doc";
@@ -12553,6 +14858,30 @@ static const char *__doc_mitsuba_xml_ScopedSetJITScope_backend = R"doc()doc";
 
 static const char *__doc_mitsuba_xml_ScopedSetJITScope_backup = R"doc()doc";
 
+static const char *__doc_mitsuba_xml_compile_file =
+R"doc(Compile a Mitsuba scene from an XML file into a binary file that can
+be loaded much faster using load_file()
+
+The compiled file stores the fully resolved object graph, i.e. the
+plugin names, typed properties and transformations of all objects,
+their dependencies, and the file resolver search paths. Includes,
+parameters and defaults are expanded at compile time. Since color and
+spectrum values are converted in a variant-specific way, the compiled
+file can only be loaded with the variant that was used to create it.
+
+Parameter ``path``:
+    Filename of the scene XML file
+
+Parameter ``output``:
+    Filename of the compiled scene
+
+Parameter ``variant``:
+    Specifies the variant of plugins to instantiate (e.g. "scalar_rgb")
+
+Parameter ``parameters``:
+    Optional list of parameters that can be referenced as ``$varname``
+    in the scene.)doc";
+
 static const char *__doc_mitsuba_xml_detail_create_texture_from_rgb = R"doc(Create a Texture object from RGB values)doc";
 
 static const char *__doc_mitsuba_xml_detail_create_texture_from_spectrum =
@@ -12563,6 +14892,13 @@ static const char *__doc_mitsuba_xml_detail_expand_node =
 R"doc(Expands a node (if it does not expand it is wrapped into a
 std::vector))doc";
 
+static const char *__doc_mitsuba_xml_detail_load_tensor =
+R"doc(Create a tensor from a field of a tensor or NumPy file
+
+The file is resolved using the file resolver of the current thread. An
+empty ``field`` selects the only field of the file. See
+TensorFile::tensor() for details.)doc";
+
 static const char *__doc_mitsuba_xml_detail_xml_to_properties =
 R"doc(Read a Mitsuba XML file and return a list of pairs containing the name
 of the plugin and the corresponding populated Properties object)doc";
@@ -12587,7 +14923,27 @@ Parameter ``update_scene``:
 
 Parameter ``parallel``:
     Whether the loading should be executed on multiple threads in
-    parallel)doc";
+    parallel
+
+Parameter ``deduplicate``:
+    Whether structurally identical anonymous BSDFs and textures (i.e.
+    objects without an ``id`` that have the same plugin and
+    properties) should be instantiated only once and shared. The
+    deduplication ratio is written to the log.
+
+Parameter ``streaming``:
+    Whether the file should be read incrementally instead of building
+    a DOM of the entire document. This bounds the memory used by the
+    parser for very large scene files, and lets the objects that were
+    parsed already be instantiated while the rest of the file is read
+    (when ``parallel`` is set). Forward references are resolved once
+    the file was read entirely, and ``<path>`` elements must precede
+    all objects. ``update_scene`` is not supported in this mode.
+
+The file may also be a compiled scene created by compile_file(), in
+which case XML parsing is skipped entirely. Parameters cannot be
+specified in this case, since they were already substituted during
+compilation.)doc";
 
 static const char *__doc_mitsuba_xml_load_string = R"doc(Load a Mitsuba scene from an XML string)doc";
 
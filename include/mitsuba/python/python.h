@@ -154,6 +154,29 @@ inline py::module_ create_submodule(py::module_ &m, const char *name) {
     return module;
 }
 
+/**
+ * \brief Implement the DLPack protocol (``__dlpack__`` and
+ * ``__dlpack_device__``) of a class by forwarding it to the Dr.Jit array
+ * returned by one of its methods
+ *
+ * This allows passing instances directly to other frameworks (e.g.
+ * ``torch.from_dlpack()``), which then access the memory of the array on
+ * its device without any copies.
+ */
+template <typename Class> void bind_dlpack(Class &cls, const char *method) {
+    std::string name(method);
+    cls.def("__dlpack__",
+            [name](py::object self, py::object stream) {
+                py::object array = self.attr(name.c_str())();
+                if (stream.is_none())
+                    return array.attr("__dlpack__")();
+                return array.attr("__dlpack__")(py::arg("stream") = stream);
+            }, py::arg("stream") = py::none())
+       .def("__dlpack_device__", [name](py::object self) {
+                return self.attr(name.c_str())().attr("__dlpack_device__")();
+            });
+}
+
 template <typename Array> void bind_drjit_ptr_array(py::class_<Array> &cls) {
     using Type = std::decay_t<std::remove_pointer_t<dr::value_t<Array>>>;
     using UInt32 = dr::uint32_array_t<Array>;
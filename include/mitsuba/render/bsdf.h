@@ -635,7 +635,7 @@ std::ostream &operator<<(std::ostream &os, const BSDFSample3<Float, Spectrum>& b
 template <typename Float, typename Spectrum>
 typename SurfaceInteraction<Float, Spectrum>::BSDFPtr SurfaceInteraction<Float, Spectrum>::bsdf(
     const typename SurfaceInteraction<Float, Spectrum>::RayDifferential3f &ray) {
-    const BSDFPtr bsdf = shape->bsdf();
+    const BSDFPtr bsdf = this->bsdf();
 
     if (!has_uv_partials() && dr::any(bsdf->needs_differentials()))
         compute_uv_partials(ray);
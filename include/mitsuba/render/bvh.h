@@ -0,0 +1,474 @@
+#pragma once
+
+#include <mitsuba/core/bbox.h>
+#include <mitsuba/core/fwd.h>
+#include <mitsuba/core/logger.h>
+#include <mitsuba/core/math.h>
+#include <mitsuba/core/object.h>
+#include <mitsuba/core/ray.h>
+#include <mitsuba/render/interaction.h>
+#include <mitsuba/render/mesh.h>
+
+/// Compile-time BVH depth limit to enable traversal with stack memory
+#define MI_BVH_MAXDEPTH 64u
+
+/// Upper bound on the number of SAH bins that can be requested
+#define MI_BVH_MAX_BINS 64u
+
+/// Subtrees with more primitives than this are built in parallel
+#define MI_BVH_PARALLEL_THRESHOLD 4096u
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**
+ * \brief Wide bounding volume hierarchy for ray tracing in the native
+ * (non-Embree) CPU backend
+ *
+ * This class is an alternative to \ref ShapeKDTree. It first builds a binary
+ * BVH using the binned surface area heuristic ("On fast Construction of
+ * SAH-based Bounding Volume Hierarchies" by I. Wald) and then collapses it
+ * into a 4- or 8-wide tree, whose nodes store the bounds of all children.
+ *
+ * To reduce memory traffic during traversal, child bounding boxes are
+ * quantized to 8 bits per coordinate relative to a per-node grid with a
+ * power-of-two spacing ("Efficient Incoherent Ray Traversal on GPUs Through
+ * Compressed Wide BVHs" by H. Ylitie, T. Karras, and S. Laine). The
+ * quantization is conservative, i.e. dequantized boxes always contain the
+ * original ones. All children of a node are tested against the ray at once
+ * using fixed-size Dr.Jit packets, which map onto the SIMD instruction set of
+ * the host (SSE/AVX on x86_64, NEON on AArch64).
+ *
+ * Like the kd-tree, the BVH is selected and configured through properties of
+ * the \ref Scene (see \ref ShapeBVH::ShapeBVH()).
+ */
+template <typename Float, typename Spectrum>
+class MI_EXPORT_LIB ShapeBVH : public Object {
+public:
+    MI_IMPORT_TYPES(Shape, Mesh)
+
+    using ScalarRay3f = Ray<ScalarPoint3f, Spectrum>;
+    using Size        = uint32_t;
+    using Index       = uint32_t;
+
+    /**
+     * \brief Create an empty BVH and take build-related parameters from
+     * \c props.
+     *
+     * The following properties are supported:
+     *
+     * <ul>
+     *   <li>\c bvh_width: number of children per node (4 or 8, default: 4)</li>
+     *   <li>\c bvh_max_leaf_size: maximum number of primitives per leaf
+     *       (default: 4)</li>
+     *   <li>\c bvh_bins: number of bins used by the SAH builder
+     *       (default: 16)</li>
+     *   <li>\c bvh_intersection_cost, \c bvh_traversal_cost: relative cost
+     *       of primitive intersections and node traversals used by the
+     *       surface area heuristic (default: 1 and 1.2)</li>
+     * </ul>
+     */
+    ShapeBVH(const Properties &props);
+
+    /// Clear the BVH (build-related parameters remain)
+    void clear();
+
+    /// Register a new shape with the BVH (to be called before \ref build())
+    void add_shape(Shape *shape);
+
+    /// Build the BVH
+    void build();
+
+    /**
+     * \brief Load a BVH that was previously saved via \ref write_cache()
+     *
+     * Shapes must be registered beforehand. Returns \c false (and leaves the
+     * BVH untouched) when the file does not exist, was created for a
+     * different \c key, or uses a different node width.
+     */
+    bool read_cache(const fs::path &filename, uint64_t key);
+
+    /// Save the BVH to a cache file identified by \c key
+    void write_cache(const fs::path &filename, uint64_t key) const;
+
+    /// Has the BVH been built?
+    bool ready() const { return m_node_count > 0; }
+
+    /// Return the memory used by the nodes and primitive indices (in bytes)
+    size_t memory_usage() const {
+        return m_node_count * m_node_size + m_index_count * sizeof(Index);
+    }
+
+    /// Return the branching factor of the BVH
+    Size width() const { return m_width; }
+
+    /// Return the bounding box of the entire BVH
+    const ScalarBoundingBox3f &bbox() const { return m_bbox; }
+
+    /// Return the number of registered shapes
+    Size shape_count() const { return Size(m_shapes.size()); }
+
+    /// Return the number of registered primitives
+    Size primitive_count() const { return m_primitive_map.back(); }
+
+    /// Return the i-th shape (const version)
+    const Shape *shape(size_t i) const { Assert(i < m_shapes.size()); return m_shapes[i]; }
+
+    /// Return the i-th shape
+    Shape *shape(size_t i) { Assert(i < m_shapes.size()); return m_shapes[i]; }
+
+    /// Return the bounding box of the i-th primitive
+    MI_INLINE ScalarBoundingBox3f bbox(Index i) const {
+        Index shape_index = find_shape(i);
+        return m_shapes[shape_index]->bbox(i);
+    }
+
+    template <bool ShadowRay>
+    MI_INLINE PreliminaryIntersection3f ray_intersect_preliminary(const Ray3f &ray,
+                                                                   Mask active) const {
+        DRJIT_MARK_USED(active);
+        if constexpr (!dr::is_array_v<Float>)
+            return ray_intersect_scalar<ShadowRay>(ray);
+        else
+            Throw("bvh should only be used in scalar mode");
+    }
+
+    template <bool ShadowRay>
+    MI_INLINE PreliminaryIntersection<ScalarFloat, Shape>
+    ray_intersect_scalar(const ScalarRay3f &ray) const {
+        if (m_width == 8)
+            return ray_intersect_wide<8, ShadowRay>(ray);
+        else
+            return ray_intersect_wide<4, ShadowRay>(ray);
+    }
+
+    /// Brute force intersection routine for debugging purposes
+    template <bool ShadowRay>
+    MI_INLINE PreliminaryIntersection3f
+    ray_intersect_naive(Ray3f ray, Mask active) const {
+        if constexpr (!dr::is_array_v<Float>) {
+            PreliminaryIntersection3f pi = dr::zeros<PreliminaryIntersection3f>();
+
+            for (Size i = 0; i < primitive_count(); ++i) {
+                PreliminaryIntersection3f prim_pi = intersect_prim<ShadowRay>(i, ray);
+
+                if (prim_pi.is_valid()) {
+                    pi = prim_pi;
+                    ray.maxt = prim_pi.t;
+                    if constexpr (ShadowRay)
+                        break;
+                }
+            }
+
+            DRJIT_MARK_USED(active);
+            return pi;
+        } else {
+            Throw("bvh should only be used in scalar mode");
+        }
+    }
+
+    /// Return a human-readable string representation of the scene contents.
+    virtual std::string to_string() const override;
+
+    MI_DECLARE_CLASS()
+protected:
+    /**
+     * \brief Wide BVH node with quantized child bounding boxes
+     *
+     * The bounds of child \c i along axis \c a are given by
+     * <tt>origin[a] + bounds[a][i] * scale[a]</tt> (lower) and
+     * <tt>origin[a] + bounds[a + 3][i] * scale[a]</tt> (upper).
+     */
+    template <size_t Width> struct BVHNode {
+        /// Origin of the quantization grid
+        ScalarFloat origin[3];
+
+        /// Power-of-two grid spacing along each axis
+        ScalarFloat scale[3];
+
+        /// Quantized child bounds (lower x/y/z, followed by upper x/y/z)
+        uint8_t bounds[6][Width];
+
+        /// Inner child: index of the child node. Leaf: primitive list offset
+        Index child[Width];
+
+        /// Number of primitives referenced by leaf children (0 for inner children)
+        Index prim_count[Width];
+
+        /// Bit mask of occupied child slots
+        uint32_t child_mask;
+    };
+
+    /// Ray-traversal routine for a specific branching factor
+    template <size_t Width, bool ShadowRay>
+    MI_INLINE PreliminaryIntersection<ScalarFloat, Shape>
+    ray_intersect_wide(ScalarRay3f ray) const {
+        using FloatP = dr::Packet<ScalarFloat, Width>;
+        using MaskP  = dr::mask_t<FloatP>;
+
+        /// Ray traversal stack entry
+        struct BVHStackEntry {
+            // Child node index, or primitive offset for leaves
+            Index child;
+            // Number of primitives of a leaf (0 for inner nodes)
+            Index prim_count;
+            // Ray distance of the entry point into the node's bounds
+            ScalarFloat t;
+        };
+
+        // Allocate the node stack
+        BVHStackEntry stack[MI_BVH_MAXDEPTH * (Width - 1) + 1];
+        int32_t stack_index = 0;
+
+        // Resulting intersection struct
+        PreliminaryIntersection<ScalarFloat, Shape> pi;
+
+        const BVHNode<Width> *nodes = (const BVHNode<Width> *) m_nodes.get();
+
+        /* Avoid NaNs (0 * inf) in the slab test by nudging zero-valued
+           direction components. This only affects rays that are exactly
+           parallel to a slab. */
+        ScalarVector3f d = dr::select(dr::abs(ray.d) < dr::Smallest<ScalarFloat>,
+                                      dr::mulsign(ScalarVector3f(dr::Smallest<ScalarFloat>), ray.d),
+                                      ray.d),
+                       d_rcp = dr::rcp(d);
+
+        /* Conservative enlargement of the far distance for watertight box
+           tests ("Robust BVH Ray Traversal" by T. Ize) */
+        const ScalarFloat eps3      = 3 * dr::Epsilon<ScalarFloat>,
+                          far_scale = 1 + 2 * eps3 / (1 - eps3);
+
+        stack[stack_index++] = { 0u, 0u, 0.f };
+
+        while (stack_index > 0) {
+            const BVHStackEntry entry = stack[--stack_index];
+
+            // Skip nodes that lie beyond the closest intersection found so far
+            if (entry.t > ray.maxt)
+                continue;
+
+            if (entry.prim_count > 0) { // Arrived at a leaf
+                Index prim_end = entry.child + entry.prim_count;
+                for (Index i = entry.child; i < prim_end; i++) {
+                    Index prim_index = m_indices[i];
+
+                    PreliminaryIntersection<ScalarFloat, Shape> prim_pi =
+                        intersect_prim<ShadowRay>(prim_index, ray);
+
+                    if (unlikely(prim_pi.is_valid())) {
+                        if constexpr (ShadowRay)
+                            return prim_pi;
+
+                        Assert(prim_pi.t >= 0.f && prim_pi.t <= ray.maxt);
+                        pi = prim_pi;
+                        ray.maxt = pi.t;
+                    }
+                }
+                continue;
+            }
+
+            const BVHNode<Width> &node = nodes[entry.child];
+
+            /* Dequantize and intersect all child boxes at once */
+            FloatP t_near(0.f), t_far(ray.maxt);
+            for (size_t axis = 0; axis < 3; ++axis) {
+                FloatP lo, hi;
+                for (size_t i = 0; i < Width; ++i) {
+                    lo.entry(i) = (ScalarFloat) node.bounds[axis][i];
+                    hi.entry(i) = (ScalarFloat) node.bounds[axis + 3][i];
+                }
+
+                ScalarFloat offset = node.origin[axis] - ray.o[axis],
+                            scale  = node.scale[axis],
+                            rcp    = d_rcp[axis];
+
+                FloatP t0 = dr::fmadd(lo, scale, offset) * rcp,
+                       t1 = dr::fmadd(hi, scale, offset) * rcp;
+
+                t_near = dr::maximum(t_near, dr::minimum(t0, t1));
+                t_far  = dr::minimum(t_far,  dr::maximum(t0, t1));
+            }
+
+            MaskP hit = t_near <= t_far * far_scale;
+            if (dr::none(hit))
+                continue;
+
+            /* Sort the intersected children by distance so that the closest
+               one ends up on top of the stack */
+            BVHStackEntry hits[Width];
+            uint32_t hit_count = 0;
+            for (size_t i = 0; i < Width; ++i) {
+                if (!(node.child_mask & (1u << i)) || !hit.entry(i))
+                    continue;
+
+                BVHStackEntry e { node.child[i], node.prim_count[i], t_near.entry(i) };
+                uint32_t j = hit_count++;
+                while (j > 0 && hits[j - 1].t < e.t) {
+                    hits[j] = hits[j - 1];
+                    --j;
+                }
+                hits[j] = e;
+            }
+
+            for (uint32_t i = 0; i < hit_count; ++i)
+                stack[stack_index++] = hits[i];
+        }
+
+        return pi;
+    }
+
+    /**
+     * \brief Map an abstract primitive index to a specific shape managed by
+     * the \ref ShapeBVH.
+     *
+     * The function returns the shape index and updates the \a idx parameter to
+     * point to the primitive index (e.g. triangle ID) within the shape.
+     */
+    MI_INLINE Index find_shape(Index &i) const {
+        Assert(i < primitive_count());
+
+        Index shape_index = math::find_interval<Index>(
+            Size(m_primitive_map.size()),
+            [&](Index k) DRJIT_INLINE_LAMBDA {
+                return m_primitive_map[k] <= i;
+            }
+        );
+
+        Assert(shape_index < shape_count() &&
+               m_primitive_map.size() == shape_count() + 1);
+
+        Assert(i >= m_primitive_map[shape_index]);
+        Assert(i <  m_primitive_map[shape_index + 1]);
+        i -= m_primitive_map[shape_index];
+
+        return shape_index;
+    }
+
+    /// Check whether a primitive is intersected by the given ray.
+    template <bool ShadowRay = false>
+    MI_INLINE PreliminaryIntersection<ScalarFloat, Shape>
+    intersect_prim(Index prim_index, const ScalarRay3f &ray) const {
+        Index shape_index  = find_shape(prim_index);
+        const Shape *shape = this->shape(shape_index);
+        const Mesh *mesh = (const Mesh *) shape;
+
+        PreliminaryIntersection<ScalarFloat, Shape> pi;
+
+        /* Instances: transform the ray using the compact per-instance record
+           and directly traverse the referenced shape group */
+        if (!m_instances.empty() && m_instances[shape_index].shapegroup) {
+            const InstanceRecord &inst = m_instances[shape_index];
+            ScalarRay3f local_ray = inst.transform(ray);
+
+            if constexpr (ShadowRay) {
+                bool hit = inst.shapegroup->ray_test_scalar(local_ray);
+                pi.t = dr::select(hit, 0.f, pi.t);
+            } else {
+                uint32_t inst_index;
+                std::tie(pi.t, pi.prim_uv, inst_index, prim_index) =
+                    inst.shapegroup->ray_intersect_preliminary_scalar(local_ray);
+
+                if (inst_index != (uint32_t) -1) {
+                    pi.prim_index  = prim_index;
+                    pi.shape       = (const Shape *) (size_t) shape_index;
+                    pi.instance    = shape;
+                    pi.shape_index = inst_index;
+                }
+            }
+
+            return pi;
+        }
+
+        if constexpr (ShadowRay) {
+            bool hit;
+            if (shape->is_mesh())
+                hit = mesh->ray_intersect_triangle_scalar(prim_index, ray).first != dr::Infinity<ScalarFloat>;
+            else
+                hit = shape->ray_test_primitive_scalar(prim_index, ray);
+            pi.t = dr::select(hit, 0.f , pi.t);
+        } else {
+            uint32_t inst_index = (uint32_t) -1;
+            if (shape->is_mesh())
+                std::tie(pi.t, pi.prim_uv) = mesh->ray_intersect_triangle_scalar(prim_index, ray);
+            else
+                std::tie(pi.t, pi.prim_uv, inst_index, prim_index) =
+                    shape->ray_intersect_primitive_scalar(prim_index, ray);
+            pi.prim_index = prim_index;
+
+            bool hit_inst  = (inst_index != (uint32_t) -1);
+            pi.shape       = hit_inst ? (const Shape *) (size_t) shape_index : shape; // shape_index for LLVM + bvh
+            pi.instance    = hit_inst ? shape : nullptr;
+            pi.shape_index = hit_inst ? inst_index : shape_index;
+        }
+
+        return pi;
+    }
+
+    /**
+     * \brief Compact description of an instance
+     *
+     * Stores the upper 3x4 block of the instance's world-to-object
+     * transformation along with the referenced shape group, so that the
+     * traversal can descend into the group without a virtual call through
+     * the \c Instance shape.
+     */
+    struct InstanceRecord {
+        /// World-to-object transformation (row-major, affine part only)
+        ScalarFloat to_object[3][4];
+
+        /// Shape group referenced by the instance (\c nullptr for other shapes)
+        const Shape *shapegroup = nullptr;
+
+        /// Transform a ray into the local frame of the shape group
+        MI_INLINE ScalarRay3f transform(const ScalarRay3f &ray) const {
+            ScalarRay3f result(ray);
+            for (size_t i = 0; i < 3; ++i) {
+                const ScalarFloat *m = to_object[i];
+                result.o[i] = dr::fmadd(m[0], ray.o[0],
+                              dr::fmadd(m[1], ray.o[1],
+                              dr::fmadd(m[2], ray.o[2], m[3])));
+                result.d[i] = dr::fmadd(m[0], ray.d[0],
+                              dr::fmadd(m[1], ray.d[1], m[2] * ray.d[2]));
+            }
+            return result;
+        }
+    };
+
+    /// Helper data structure used during tree construction (see bvh.cpp)
+    struct BuildContext;
+
+    /// Recursively build the binary SAH tree over a range of primitive indices
+    void build_recursive(BuildContext &ctx, Index node, Index begin,
+                         Index end, Size depth) const;
+
+    /// Convert the binary build tree into a tree with the given branching factor
+    template <size_t Width> void collapse(const BuildContext &ctx);
+
+    /// Emit a wide node (and recursively, its subtree) for a binary build node
+    template <size_t Width>
+    Index emit_node(const BuildContext &ctx, Index bin_node,
+                    std::vector<BVHNode<Width>> &nodes) const;
+
+protected:
+    std::vector<ref<Shape>> m_shapes;
+    std::vector<Size> m_primitive_map;
+    ScalarBoundingBox3f m_bbox;
+
+    /// Per-shape instance records (empty if no instances were registered)
+    std::vector<InstanceRecord> m_instances;
+
+    /// Wide nodes (type \ref BVHNode<4> or \ref BVHNode<8> depending on \ref m_width)
+    std::unique_ptr<uint8_t[]> m_nodes;
+    std::unique_ptr<Index[]> m_indices;
+    Size m_node_count = 0;
+    Size m_index_count = 0;
+    size_t m_node_size = 0;
+
+    Size m_width;
+    Size m_max_leaf_size;
+    Size m_bin_count;
+    ScalarFloat m_intersection_cost;
+    ScalarFloat m_traversal_cost;
+};
+
+MI_EXTERN_CLASS(ShapeBVH)
+NAMESPACE_END(mitsuba)
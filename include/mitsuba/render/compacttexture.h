@@ -0,0 +1,325 @@
+#pragma once
+
+#include <drjit/dynamic.h>
+#include <drjit/texture.h>
+
+#include <mitsuba/core/logger.h>
+#include <mitsuba/core/math.h>
+#include <mitsuba/render/fwd.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**
+ * \brief Map an integer voxel coordinate into the range <tt>[0, n)</tt>
+ * following the given texture wrap mode
+ */
+template <typename Int>
+MI_INLINE Int wrap_voxel_index(const Int &i, int32_t n, dr::WrapMode mode) {
+    if (mode == dr::WrapMode::Repeat) {
+        Int m = i % n;
+        return dr::select(m < 0, m + n, m);
+    } else if (mode == dr::WrapMode::Mirror) {
+        Int m = i % (2 * n);
+        m = dr::select(m < 0, m + 2 * n, m);
+        return dr::select(m >= n, 2 * n - 1 - m, m);
+    } else {
+        return dr::clamp(i, 0, n - 1);
+    }
+}
+
+/// Storage formats of texture data on the device
+enum class TextureStorage : uint32_t {
+    /// Single precision floating point values
+    Float32,
+
+    /// Half precision floating point values
+    Float16,
+
+    /// 8 bit unsigned integers, normalized with a per-channel scale and offset
+    UInt8
+};
+
+/// Parse the value of a <tt>storage</tt> plugin parameter
+inline TextureStorage texture_storage(const std::string &name) {
+    if (name == "float32")
+        return TextureStorage::Float32;
+    else if (name == "float16")
+        return TextureStorage::Float16;
+    else if (name == "uint8")
+        return TextureStorage::UInt8;
+    else
+        Throw("Invalid storage format \"%s\", must be one of: \"float32\", "
+              "\"float16\", or \"uint8\"!", name);
+}
+
+inline std::ostream &operator<<(std::ostream &os, TextureStorage storage) {
+    switch (storage) {
+        case TextureStorage::Float32: os << "float32"; break;
+        case TextureStorage::Float16: os << "float16"; break;
+        case TextureStorage::UInt8:   os << "uint8"; break;
+        default: os << "unknown"; break;
+    }
+    return os;
+}
+
+/**
+ * \brief Texture that keeps its values in a compact representation
+ *
+ * Values are stored either as half precision floats or as 8 bit integers
+ * that are mapped to <tt>offset + q * scale</tt> using a per-channel scale
+ * and offset determined from the range of the input data. This reduces the
+ * memory footprint and bandwidth of large textures by a factor of 2 and 4,
+ * respectively.
+ *
+ * Lookups gather the compact values and convert them to single precision
+ * before filtering, hence interpolation itself runs in full precision. The
+ * interface mirrors the subset of \c dr::Texture used by the \c bitmap and
+ * \c gridvolume plugins, including its conventions for the position
+ * argument, the data layout and the order of \ref eval_fetch(). In contrast
+ * to \c dr::Texture, the data is not differentiable and cannot be updated
+ * after construction.
+ */
+template <typename Float, size_t Dimension>
+class CompactTexture {
+public:
+    static constexpr size_t Corners = 1 << Dimension;
+    static constexpr size_t MaxChannels = 6;
+
+    using ScalarFloat  = dr::scalar_t<Float>;
+    using Mask         = dr::mask_t<Float>;
+    using UInt8        = dr::replace_scalar_t<Float, uint8_t>;
+    using UInt16       = dr::replace_scalar_t<Float, uint16_t>;
+    using UInt32       = dr::uint32_array_t<Float>;
+    using Int32        = dr::int32_array_t<Float>;
+    using Float32      = dr::float32_array_t<Float>;
+    using PosF         = dr::Array<Float, Dimension>;
+    using PosI         = dr::Array<Int32, Dimension>;
+    using UInt8Storage  = DynamicBuffer<UInt8>;
+    using UInt16Storage = DynamicBuffer<UInt16>;
+
+    CompactTexture() = default;
+
+    /**
+     * \brief Convert and upload texture data
+     *
+     * \param data
+     *    Single precision values laid out like the tensor of a \c dr::Texture
+     *    with the given shape.
+     *
+     * \param shape
+     *    Resolution along each dimension (outermost first), followed by the
+     *    number of channels.
+     *
+     * \param storage
+     *    Either \ref TextureStorage::Float16 or \ref TextureStorage::UInt8.
+     */
+    CompactTexture(const ScalarFloat *data, const size_t shape[Dimension + 1],
+                   TextureStorage storage, dr::FilterMode filter_mode,
+                   dr::WrapMode wrap_mode)
+        : m_storage(storage), m_filter_mode(filter_mode),
+          m_wrap_mode(wrap_mode) {
+        size_t count = 1;
+        for (size_t i = 0; i <= Dimension; ++i) {
+            m_shape[i] = shape[i];
+            count *= shape[i];
+        }
+
+        const size_t channels = channel_count();
+        if (channels > MaxChannels)
+            Throw("CompactTexture: at most %zu channels are supported (got %zu)",
+                  MaxChannels, channels);
+        if (count > (size_t) 0xFFFFFFFFu)
+            Throw("CompactTexture: the texture is too large to be indexed "
+                  "with 32 bit integers (%zu values)", count);
+
+        m_scale.assign(channels, 1.f);
+        m_offset.assign(channels, 0.f);
+
+        if (storage == TextureStorage::Float16) {
+            std::unique_ptr<uint16_t[]> values(new uint16_t[count]);
+            for (size_t i = 0; i < count; ++i)
+                values[i] = dr::half::float32_to_float16((float) data[i]);
+            m_half = dr::load<UInt16Storage>(values.get(), count);
+        } else if (storage == TextureStorage::UInt8) {
+            // Determine the range of every channel
+            std::vector<ScalarFloat> lo(channels, dr::Infinity<ScalarFloat>),
+                                     hi(channels, -dr::Infinity<ScalarFloat>);
+            for (size_t i = 0; i < count; ++i) {
+                size_t c = i % channels;
+                lo[c] = dr::minimum(lo[c], data[i]);
+                hi[c] = dr::maximum(hi[c], data[i]);
+            }
+
+            for (size_t c = 0; c < channels; ++c) {
+                if (!(lo[c] <= hi[c])) // Empty texture or NaN values
+                    lo[c] = hi[c] = 0.f;
+                m_offset[c] = lo[c];
+                m_scale[c] = (hi[c] - lo[c]) / 255.f;
+            }
+
+            std::unique_ptr<uint8_t[]> values(new uint8_t[count]);
+            for (size_t i = 0; i < count; ++i) {
+                size_t c = i % channels;
+                ScalarFloat q = m_scale[c] > 0.f
+                    ? (data[i] - m_offset[c]) / m_scale[c] : 0.f;
+                values[i] = (uint8_t) dr::clamp(dr::round(q), (ScalarFloat) 0,
+                                                (ScalarFloat) 255);
+            }
+            m_byte = dr::load<UInt8Storage>(values.get(), count);
+        } else {
+            Throw("CompactTexture: unsupported storage format \"%s\"!",
+                  storage);
+        }
+    }
+
+    /// Return the resolution along each dimension, followed by the channel count
+    const size_t *shape() const { return m_shape; }
+
+    /// Return the number of channels
+    size_t channel_count() const { return m_shape[Dimension]; }
+
+    /// Return the storage format of the texture values
+    TextureStorage storage() const { return m_storage; }
+
+    dr::FilterMode filter_mode() const { return m_filter_mode; }
+    dr::WrapMode wrap_mode() const { return m_wrap_mode; }
+
+    /// Return the size of the compact representation in bytes
+    size_t buffer_size() const {
+        return m_storage == TextureStorage::Float16 ? m_half.size() * 2
+                                                    : m_byte.size();
+    }
+
+    /// Apply the wrap mode to integer texel coordinates
+    template <typename T> PosI wrap(const T &pos) const {
+        PosI result;
+        for (size_t i = 0; i < Dimension; ++i)
+            result[i] = wrap_voxel_index(
+                pos[i], (int32_t) m_shape[Dimension - 1 - i], m_wrap_mode);
+        return result;
+    }
+
+    /// Evaluate the texture at the position \c pos in <tt>[0, 1]^Dimension</tt>
+    void eval(const PosF &pos, Float *out, Mask active = true) const {
+        const size_t channels = channel_count();
+
+        if (m_filter_mode == dr::FilterMode::Nearest) {
+            fetch(wrap(dr::floor2int<PosI>(pos * resolution())), out, active);
+            return;
+        }
+
+        for (size_t c = 0; c < channels; ++c)
+            out[c] = dr::zeros<Float>();
+
+        Float values[MaxChannels];
+        stencil(pos, [&](size_t, const Float &w, const PosI &p) {
+            fetch(p, values, active);
+            for (size_t c = 0; c < channels; ++c)
+                out[c] = dr::fmadd(w, values[c], out[c]);
+        });
+    }
+
+    /**
+     * \brief Fetch the texels of the linear interpolation stencil around
+     * \c pos (ordered as in \c dr::Texture::eval_fetch())
+     */
+    void eval_fetch(const PosF &pos, dr::Array<Float *, Corners> &out,
+                    Mask active = true) const {
+        stencil(pos, [&](size_t k, const Float &, const PosI &p) {
+            fetch(p, out[k], active);
+        });
+    }
+
+    /// Convert all values back to single precision and return them on the host
+    std::vector<ScalarFloat> host_values() const {
+        const size_t channels = channel_count();
+        std::vector<ScalarFloat> result;
+
+        if (m_storage == TextureStorage::Float16) {
+            auto &&data = dr::migrate(m_half, AllocType::Host);
+            if constexpr (dr::is_jit_v<Float>)
+                dr::sync_thread();
+            result.resize(data.size());
+            for (size_t i = 0; i < result.size(); ++i)
+                result[i] = (ScalarFloat) dr::half::float16_to_float32(data.data()[i]);
+        } else {
+            auto &&data = dr::migrate(m_byte, AllocType::Host);
+            if constexpr (dr::is_jit_v<Float>)
+                dr::sync_thread();
+            result.resize(data.size());
+            for (size_t i = 0; i < result.size(); ++i) {
+                size_t c = i % channels;
+                result[i] = dr::fmadd((ScalarFloat) data.data()[i], m_scale[c],
+                                      m_offset[c]);
+            }
+        }
+
+        return result;
+    }
+
+protected:
+    PosF resolution() const {
+        PosF res;
+        for (size_t i = 0; i < Dimension; ++i)
+            res[i] = (ScalarFloat) m_shape[Dimension - 1 - i];
+        return res;
+    }
+
+    /// Read and convert all channels of the (wrapped) texel \c p
+    void fetch(const PosI &p, Float *out, Mask active) const {
+        const size_t channels = channel_count();
+
+        UInt32 index = UInt32(p[Dimension - 1]);
+        for (size_t i = Dimension - 1; i-- > 0;)
+            index = index * (uint32_t) m_shape[Dimension - 1 - i] + UInt32(p[i]);
+        index *= (uint32_t) channels;
+
+        for (size_t c = 0; c < channels; ++c) {
+            UInt32 idx = index + (uint32_t) c;
+            if (m_storage == TextureStorage::Float16)
+                out[c] = Float(math::half_to_float(
+                    UInt32(dr::gather<UInt16>(m_half, idx, active))));
+            else
+                out[c] = dr::fmadd(Float(dr::gather<UInt8>(m_byte, idx, active)),
+                                   m_scale[c], m_offset[c]);
+        }
+    }
+
+    /**
+     * \brief Invoke <tt>func(index, weight, texel)</tt> for the texels of the
+     * linear interpolation stencil around \c pos
+     */
+    template <typename Func>
+    void stencil(const PosF &pos, Func &&func) const {
+        PosF u = dr::fmadd(pos, resolution(), -.5f);
+        PosI p0 = dr::floor2int<PosI>(u);
+        PosF w1 = u - PosF(p0),
+             w0 = 1.f - w1;
+        PosI v0 = wrap(p0),
+             v1 = wrap(p0 + 1);
+
+        for (size_t k = 0; k < Corners; ++k) {
+            PosI v;
+            Float w = 1.f;
+            for (size_t i = 0; i < Dimension; ++i) {
+                bool upper = (k >> i) & 1;
+                v[i] = upper ? v1[i] : v0[i];
+                w *= upper ? w1[i] : w0[i];
+            }
+            func(k, w, v);
+        }
+    }
+
+protected:
+    size_t m_shape[Dimension + 1] = { };
+    TextureStorage m_storage = TextureStorage::Float16;
+    dr::FilterMode m_filter_mode = dr::FilterMode::Linear;
+    dr::WrapMode m_wrap_mode = dr::WrapMode::Clamp;
+
+    std::vector<ScalarFloat> m_scale;
+    std::vector<ScalarFloat> m_offset;
+    UInt16Storage m_half;
+    UInt8Storage m_byte;
+};
+
+NAMESPACE_END(mitsuba)
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <mitsuba/core/bbox.h>
+#include <mitsuba/core/random.h>
+#include <mitsuba/core/vector.h>
+#include <drjit/math.h>
+#include <algorithm>
+#include <vector>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**
+ * This file contains helper routines that are used by the curve shapes
+ * (\c linearcurve and \c bsplinecurve) to intersect and bound their segments
+ * in the native (kd-tree / BVH) backend. All functions are templated over the
+ * underlying value type, so that they can process several curve pieces at
+ * once when instantiated with a Dr.Jit packet type.
+ */
+
+/**
+ * \brief Ray intersection with a round cone, i.e. the convex hull of two
+ * spheres with centers \c p0, \c p1 and radii \c r0, \c r1
+ *
+ * Round cones are the segments of a linear curve with spherical joints and
+ * endcaps. Only the point where the ray enters the round cone is reported,
+ * hence the back faces are culled.
+ *
+ * The implementation follows the analytic solution by Inigo Quilez.
+ *
+ * \return
+ *     A pair containing the (possibly negative) distance along the ray, and
+ *     the curve parameter in <tt>[0, 1]</tt> of the sphere that touches the
+ *     surface at the intersection point. The distance is infinite when the
+ *     ray misses the round cone.
+ */
+template <typename Value>
+std::pair<Value, Value> intersect_round_cone(const Point<Value, 3> &o,
+                                             const Vector<Value, 3> &d,
+                                             const Point<Value, 3> &p0,
+                                             const Value &r0,
+                                             const Point<Value, 3> &p1,
+                                             const Value &r1) {
+    using Vector3 = Vector<Value, 3>;
+    using Mask = dr::mask_t<Value>;
+
+    // Work with a normalized direction, and rescale the distance at the end
+    Value d_norm = dr::norm(d);
+    Vector3 rd = d / d_norm,
+            ba = p1 - p0,
+            oa = o - p0,
+            ob = o - p1;
+
+    Value rr = r0 - r1,
+          m0 = dr::dot(ba, ba),
+          m1 = dr::dot(ba, oa),
+          m2 = dr::dot(ba, rd),
+          m3 = dr::dot(rd, oa),
+          m5 = dr::dot(oa, oa),
+          m6 = dr::dot(ob, rd),
+          m7 = dr::dot(ob, ob),
+          d2 = m0 - rr * rr;
+
+    // 1. Conical part between the two spheres
+    Value k2 = d2 - m2 * m2,
+          k1 = d2 * m3 - m1 * m2 + m2 * rr * r0,
+          k0 = d2 * m5 - m1 * m1 + m1 * rr * r0 * 2.f - m0 * r0 * r0,
+          h  = k1 * k1 - k0 * k2;
+
+    Value t_body = (-dr::safe_sqrt(h) - k1) / k2,
+          y      = m1 - r0 * rr + t_body * m2;
+    Mask body = h >= 0.f && dr::neq(k2, 0.f) && d2 > 0.f && y > 0.f && y < d2;
+
+    // 2. Spherical caps
+    Value h0 = m3 * m3 - m5 + r0 * r0,
+          h1 = m6 * m6 - m7 + r1 * r1,
+          t0 = dr::select(h0 >= 0.f, -m3 - dr::safe_sqrt(h0), dr::Infinity<Value>),
+          t1 = dr::select(h1 >= 0.f, -m6 - dr::safe_sqrt(h1), dr::Infinity<Value>);
+
+    Value t = dr::select(body, t_body, dr::minimum(t0, t1)),
+          v = dr::select(body, y / d2, dr::select(t0 <= t1, Value(0.f), Value(1.f)));
+
+    return { t / d_norm, v };
+}
+
+/**
+ * \brief Closest points between a ray segment and a line segment
+ *
+ * Computes the parameters <tt>t in [0, maxt]</tt> along the ray
+ * <tt>o + t * d</tt> and <tt>s in [0, 1]</tt> along the segment
+ * <tt>a + s * (b - a)</tt> of the two closest points (following Ericson,
+ * Real-Time Collision Detection, Section 5.1.9).
+ *
+ * \return A tuple containing the squared distance, \c t and \c s
+ */
+template <typename Value>
+std::tuple<Value, Value, Value>
+ray_segment_closest_points(const Point<Value, 3> &o, const Vector<Value, 3> &d,
+                           const Value &maxt, const Point<Value, 3> &a,
+                           const Point<Value, 3> &b) {
+    using Vector3 = Vector<Value, 3>;
+
+    Vector3 e = b - a, r = o - a;
+    Value dd = dr::dot(d, d), ee = dr::dot(e, e), de = dr::dot(d, e),
+          f = dr::dot(e, r), c = dr::dot(d, r),
+          denom = dd * ee - de * de;
+
+    Value t = dr::select(denom > 0.f,
+                         dr::clamp((de * f - c * ee) / denom, 0.f, maxt), 0.f),
+          s = dr::select(ee > 0.f, (de * t + f) / ee, 0.f);
+
+    auto below = s < 0.f, above = s > 1.f;
+    t = dr::select(below, dr::clamp(-c / dd, 0.f, maxt), t);
+    t = dr::select(above, dr::clamp((de - c) / dd, 0.f, maxt), t);
+    s = dr::clamp(s, 0.f, 1.f);
+
+    Value dist_sqr = dr::squared_norm(o + t * d - (a + s * e));
+    return { dist_sqr, t, s };
+}
+
+/**
+ * \brief Clip the box that bounds a sphere swept along a line segment
+ *
+ * The segment starts at \c a and ends at \c b, and the radius of the sphere
+ * never exceeds \c radius. The resulting box is clipped to \c clip and used
+ * to expand \c result.
+ */
+template <typename BoundingBox, typename Point3, typename Float>
+void expand_swept_sphere_bbox(BoundingBox &result, const Point3 &a,
+                              const Point3 &b, Float radius,
+                              const BoundingBox &clip) {
+    BoundingBox bbox(dr::minimum(a, b) - radius, dr::maximum(a, b) + radius);
+    bbox.clip(clip);
+    if (bbox.valid())
+        result.expand(bbox);
+}
+
+/**
+ * \brief Stochastic simplification of a set of curves (e.g. hair or fur)
+ *
+ * Following "Stochastic Simplification of Aggregate Detail" by Cook et al.
+ * (2007), this function keeps a random subset of <tt>1 / ratio</tt> of the
+ * curves. When \c widen is set, the radii of the surviving curves are scaled
+ * by the ratio of the original and remaining curve counts, which preserves
+ * the total projected area of the curves and hence their appearance from a
+ * distance. The selection is deterministic for a given \c seed.
+ *
+ * \param vertices
+ *     Control points of all curves (updated in place)
+ *
+ * \param radius
+ *     Radius of each control point (updated in place)
+ *
+ * \param curve_1st_idx
+ *     Index of the first control point of each curve (updated in place)
+ */
+template <typename Point, typename Float>
+void simplify_curves(std::vector<Point> &vertices, std::vector<Float> &radius,
+                     std::vector<size_t> &curve_1st_idx, float ratio,
+                     uint32_t seed, bool widen) {
+    size_t curve_count = curve_1st_idx.size(),
+           keep_count = std::max((size_t) 1,
+                                 (size_t) std::lround(curve_count / ratio));
+    if (keep_count >= curve_count)
+        return;
+
+    // Keep the curves with the smallest random keys, in their original order
+    std::vector<std::pair<uint32_t, uint32_t>> keys(curve_count);
+    for (uint32_t i = 0; i < (uint32_t) curve_count; ++i)
+        keys[i] = { sample_tea_32(i, seed).first, i };
+    std::nth_element(keys.begin(), keys.begin() + keep_count, keys.end());
+    std::sort(keys.begin(), keys.begin() + keep_count,
+              [](const auto &a, const auto &b) { return a.second < b.second; });
+
+    Float scale = widen ? (Float) curve_count / (Float) keep_count : Float(1);
+    std::vector<Point> vertices_out;
+    std::vector<Float> radius_out;
+    std::vector<size_t> curve_1st_idx_out;
+    curve_1st_idx_out.reserve(keep_count);
+
+    for (size_t k = 0; k < keep_count; ++k) {
+        size_t i = keys[k].second,
+               begin = curve_1st_idx[i],
+               end = i + 1 < curve_count ? curve_1st_idx[i + 1] : vertices.size();
+        curve_1st_idx_out.push_back(vertices_out.size());
+        for (size_t j = begin; j < end; ++j) {
+            vertices_out.push_back(vertices[j]);
+            radius_out.push_back(radius[j] * scale);
+        }
+    }
+
+    vertices = std::move(vertices_out);
+    radius = std::move(radius_out);
+    curve_1st_idx = std::move(curve_1st_idx_out);
+}
+
+NAMESPACE_END(mitsuba)
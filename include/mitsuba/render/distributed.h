@@ -0,0 +1,506 @@
+#pragma once
+
+#include <mitsuba/core/bitmap.h>
+#include <mitsuba/core/filesystem.h>
+#include <mitsuba/core/object.h>
+#include <mitsuba/core/sstream.h>
+#include <mitsuba/render/fwd.h>
+#include <drjit/tensor.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+template <typename Float, typename Spectrum> struct RenderCoordinatorPrivate;
+template <typename Float, typename Spectrum> struct RenderServerPrivate;
+template <typename Float, typename Spectrum> struct MultiDeviceRendererPrivate;
+struct HybridRendererPrivate;
+
+/// List of (name, value) pairs used for scene definitions and parameter overrides
+using RenderParameterList = std::vector<std::pair<std::string, std::string>>;
+
+/**
+ * \brief Coordinator of a distributed, tile-based render
+ *
+ * The coordinator listens on a TCP port for \ref RenderWorker instances,
+ * which are typically separate processes on other machines that have loaded
+ * the same scene. The sensor's crop window is split into rectangular tiles
+ * that are handed out to the workers on demand. Each worker renders its tile
+ * with the scene's integrator and streams back the raw contents of its film
+ * as a zlib-compressed \ref ImageBlock, which the coordinator then
+ * accumulates into its own film.
+ *
+ * To bound tail latency, tiles that are still outstanding once the queue has
+ * run dry are issued again to idle workers if they have been in flight longer
+ * than <tt>reissue_factor</tt> times the median tile render time observed so
+ * far. The first result that arrives for a tile is merged, and any later
+ * duplicates are discarded. Tiles held by a worker whose connection drops are
+ * put back into the queue.
+ *
+ * Note that tiles are filtered independently, hence reconstruction filters
+ * with a radius exceeding one pixel receive slightly fewer contributions
+ * along tile boundaries.
+ */
+template <typename Float, typename Spectrum>
+class MI_EXPORT_LIB RenderCoordinator : public Object {
+public:
+    MI_IMPORT_TYPES(Scene, Sensor, Film, ImageBlock)
+
+    /**
+     * \brief Start listening for workers
+     *
+     * \param port
+     *    TCP port to listen on. The default (0) lets the operating system
+     *    choose a free port, which can be queried via \ref port().
+     *
+     * \param tile_size
+     *    Edge length of the square tiles that are handed out to workers.
+     *
+     * \param reissue_factor
+     *    Outstanding tiles are re-issued once they have been running for
+     *    longer than this factor times the median tile render time.
+     *
+     * \param max_issues
+     *    Maximum number of times that a single tile is handed out.
+     */
+    RenderCoordinator(uint16_t port = 0, uint32_t tile_size = 64,
+                      float reissue_factor = 2.f, uint32_t max_issues = 3);
+
+    /**
+     * \brief Render the specified sensor using the connected workers
+     *
+     * The interface mirrors \ref Integrator::render(). The function blocks
+     * until every tile has been merged into the sensor's film. Workers may
+     * connect before or during the call.
+     *
+     * \param seed
+     *    Base seed of the render. Every tile uses a distinct seed derived
+     *    from it, and re-issued tiles reuse the seed of the original tile.
+     *
+     * \param spp
+     *    Samples per pixel to be rendered by the workers, or 0 to use the
+     *    sampler's default.
+     *
+     * \param develop
+     *    Whether to return the developed image (otherwise, an empty tensor is
+     *    returned, and the result can be retrieved from the film).
+     */
+    TensorXf render(Scene *scene, uint32_t sensor_index, uint32_t seed = 0,
+                    uint32_t spp = 0, bool develop = true);
+
+    /// Stop accepting workers and ask the connected ones to terminate
+    void shutdown();
+
+    /// Return the TCP port that the coordinator listens on
+    uint16_t port() const;
+
+    /// Return the number of currently connected workers
+    size_t worker_count() const;
+
+    /// Return the number of tiles that were re-issued during the last render
+    size_t reissued_count() const;
+
+    std::string to_string() const override;
+
+    MI_DECLARE_CLASS()
+protected:
+    virtual ~RenderCoordinator();
+
+    /// Serve a single worker (runs on a dedicated thread)
+    void serve(ref<SocketStream> stream);
+
+private:
+    std::unique_ptr<RenderCoordinatorPrivate<Float, Spectrum>> d;
+};
+
+/**
+ * \brief Worker of a distributed, tile-based render
+ *
+ * Connects to a \ref RenderCoordinator and renders the tiles that it hands
+ * out using the integrator of a locally loaded copy of the scene.
+ */
+template <typename Float, typename Spectrum>
+class MI_EXPORT_LIB RenderWorker : public Object {
+public:
+    MI_IMPORT_TYPES(Scene, Sensor, Film, ImageBlock)
+
+    /// Connect to the coordinator at the given host and port
+    RenderWorker(const std::string &host, uint16_t port);
+
+    /**
+     * \brief Render tiles until the coordinator shuts down
+     *
+     * The film's crop window is restored before this function returns.
+     *
+     * \return The number of tiles that were rendered
+     */
+    size_t run(Scene *scene);
+
+    std::string to_string() const override;
+
+    MI_DECLARE_CLASS()
+protected:
+    virtual ~RenderWorker();
+
+private:
+    ref<SocketStream> m_stream;
+    size_t m_tiles_rendered;
+};
+
+/**
+ * \brief Persistent render server that keeps scenes resident between jobs
+ *
+ * The server listens on a TCP port for \ref RenderClient connections, which
+ * submit requests to load a scene under an identifier, to remove a scene, or
+ * to render a resident scene. This avoids paying for scene loading,
+ * acceleration data structure construction and (in JIT variants) kernel
+ * compilation in every request: subsequent jobs that only differ in their
+ * parameter values reuse all of them.
+ *
+ * A render job specifies the scene identifier, the sensor index, the sample
+ * count and seed, as well as a list of parameter overrides. These use the
+ * names of \c mi.traverse() (e.g. <tt>"sensor.to_world"</tt> or
+ * <tt>"my_bsdf.reflectance.value"</tt>) and whitespace or comma-separated
+ * numbers as values (16 numbers in row-major order for transformations).
+ * Overrides only apply to a single job: the previous values are restored
+ * once it completes. In JIT variants, the new values are made opaque so that
+ * the compiled kernels can be reused.
+ *
+ * Requests of all clients enter a single FIFO queue and are executed one at
+ * a time by the thread that calls \ref run(), which therefore owns the JIT
+ * state of the scenes. The result of a render job is sent back as an OpenEXR
+ * image.
+ */
+template <typename Float, typename Spectrum>
+class MI_EXPORT_LIB RenderServer : public Object {
+public:
+    MI_IMPORT_TYPES(Scene, Sensor, Film)
+
+    /**
+     * \brief Start listening for clients
+     *
+     * \param port
+     *    TCP port to listen on. The default (0) lets the operating system
+     *    choose a free port, which can be queried via \ref port().
+     *
+     * \param max_queued
+     *    Maximum number of pending requests. Further requests are rejected
+     *    with an error until the queue has room again.
+     */
+    RenderServer(uint16_t port = 0, size_t max_queued = 64);
+
+    /// Make a scene that was loaded by the caller resident under \c id
+    void add_scene(const std::string &id, Scene *scene);
+
+    /**
+     * \brief Load a scene from an XML file and make it resident under \c id
+     *
+     * Any scene previously registered under the same identifier is replaced.
+     */
+    void load_scene(const std::string &id, const fs::path &filename,
+                    const RenderParameterList &defines = {});
+
+    /// Release the scene with the given identifier
+    void remove_scene(const std::string &id);
+
+    /// Return the identifiers of all resident scenes
+    std::vector<std::string> scene_ids() const;
+
+    /**
+     * \brief Process requests until the server is shut down
+     *
+     * Shutdown is triggered by a call to \ref shutdown() or by a client
+     * (see \ref RenderClient::shutdown_server()). Requests that are already
+     * queued at this point are completed first, and later ones are rejected.
+     */
+    void run();
+
+    /// Stop accepting clients and make \ref run() return
+    void shutdown();
+
+    /// Return the TCP port that the server listens on
+    uint16_t port() const;
+
+    /// Return the number of requests that were processed so far
+    size_t jobs_completed() const;
+
+    std::string to_string() const override;
+
+    MI_DECLARE_CLASS()
+protected:
+    virtual ~RenderServer();
+
+    /// Serve a single client (runs on a dedicated thread)
+    void serve(ref<SocketStream> stream);
+
+    /// Execute a single request and write its reply into \c reply
+    void execute(uint32_t type, MemoryStream *payload, MemoryStream *reply);
+
+    /// Render a job on a resident scene and return the developed image
+    ref<Bitmap> render_job(MemoryStream *payload);
+
+private:
+    std::unique_ptr<RenderServerPrivate<Float, Spectrum>> d;
+};
+
+/**
+ * \brief Client of a \ref RenderServer
+ *
+ * Every function sends a single request and blocks until the server replies.
+ * Errors raised by the server (e.g. an unknown scene identifier or parameter
+ * name) are rethrown as exceptions.
+ */
+class MI_EXPORT_LIB RenderClient : public Object {
+public:
+    /// Connect to the server at the given host and port
+    RenderClient(const std::string &host, uint16_t port);
+
+    /**
+     * \brief Ask the server to load a scene file and keep it resident
+     *
+     * The filename is resolved on the server. The definitions can be
+     * referenced as <tt>$key</tt> within the scene description.
+     */
+    void load_scene(const std::string &id, const std::string &filename,
+                    const RenderParameterList &defines = {});
+
+    /// Ask the server to release a resident scene
+    void remove_scene(const std::string &id);
+
+    /**
+     * \brief Render a resident scene and return the developed image
+     *
+     * \param overrides
+     *    Parameter values that apply to this job only (see \ref RenderServer)
+     *
+     * \param spp
+     *    Samples per pixel, or 0 to use the sampler's default.
+     */
+    ref<Bitmap> render(const std::string &id,
+                       const RenderParameterList &overrides = {},
+                       uint32_t sensor_index = 0, uint32_t spp = 0,
+                       uint32_t seed = 0);
+
+    /// Ask the server to shut down once the pending requests are completed
+    void shutdown_server();
+
+    std::string to_string() const override;
+
+    MI_DECLARE_CLASS()
+protected:
+    virtual ~RenderClient();
+
+    /// Send a request and return the payload of the reply
+    ref<MemoryStream> request(uint32_t type, const MemoryStream *payload);
+
+private:
+    ref<SocketStream> m_stream;
+};
+
+/**
+ * \brief Renders a scene using several CUDA devices of the same machine
+ *
+ * Dr.Jit variables, compiled kernels and OptiX acceleration data structures
+ * belong to the device that created them. This class therefore loads a
+ * separate replica of the scene on every device, each of them on a thread
+ * bound to that device. The samples of a render are split into passes that
+ * the devices fetch from a shared queue, so that faster devices automatically
+ * render more of them. Each device accumulates the raw film contents of its
+ * passes, and the results are finally merged into the film of the primary
+ * device (the first one in the list), which develops the image.
+ *
+ * After every render, the number of passes, throughput and utilization of
+ * each device as well as the overall scaling efficiency are written to the
+ * log and can be queried via \ref device_stats(). The scaling efficiency
+ * relates the combined throughput to that of the fastest device multiplied by
+ * the number of devices.
+ */
+template <typename Float, typename Spectrum>
+class MI_EXPORT_LIB MultiDeviceRenderer : public Object {
+public:
+    MI_IMPORT_TYPES(Scene, Sensor, Film, ImageBlock)
+
+    /// Statistics of a single device gathered during the last render
+    struct DeviceStats {
+        /// CUDA device ID
+        int device = 0;
+        /// Number of passes rendered by the device
+        uint32_t passes = 0;
+        /// Number of samples per pixel rendered by the device
+        uint32_t spp = 0;
+        /// Time spent rendering passes (in seconds)
+        float busy_time = 0.f;
+        /// Fraction of the total render time spent rendering passes
+        float utilization = 0.f;
+        /// Number of samples rendered per second of busy time
+        float throughput = 0.f;
+    };
+
+    /**
+     * \brief Load a replica of the scene on each device
+     *
+     * The calling thread is switched to the primary device, on which the
+     * image returned by \ref render() resides. Replicas are loaded
+     * sequentially on the thread of their device.
+     *
+     * \param filename
+     *    Filename of the scene XML file
+     *
+     * \param devices
+     *    CUDA device IDs to render on. The default (an empty list) selects
+     *    all available devices.
+     *
+     * \param defines
+     *    Parameters that can be referenced as <tt>$key</tt> within the scene
+     *    description.
+     */
+    MultiDeviceRenderer(const fs::path &filename,
+                        const std::vector<int> &devices = {},
+                        const RenderParameterList &defines = {});
+
+    /**
+     * \brief Render the specified sensor using all devices
+     *
+     * The interface mirrors \ref Integrator::render().
+     *
+     * \param seed
+     *    Base seed of the render. Every pass uses a distinct seed derived
+     *    from it, hence the result does not depend on the device that
+     *    rendered a given pass.
+     *
+     * \param spp
+     *    Total number of samples per pixel, or 0 to use the sampler's default.
+     *
+     * \param spp_per_pass
+     *    Samples per pixel of a single pass. The default (0) creates four
+     *    passes per device.
+     *
+     * \param develop
+     *    Whether to return the developed image (otherwise, an empty tensor is
+     *    returned, and the result can be retrieved from the film of the
+     *    primary replica).
+     */
+    TensorXf render(uint32_t sensor_index = 0, uint32_t seed = 0,
+                    uint32_t spp = 0, uint32_t spp_per_pass = 0,
+                    bool develop = true);
+
+    /// Return the CUDA device IDs used by this renderer
+    const std::vector<int> &devices() const;
+
+    /// Return the scene replica of the device with the given index
+    Scene *scene(size_t index = 0) const;
+
+    /// Return per-device statistics of the last render
+    const std::vector<DeviceStats> &device_stats() const;
+
+    /// Return the scaling efficiency of the last render (between 0 and 1)
+    float scaling_efficiency() const;
+
+    std::string to_string() const override;
+
+    MI_DECLARE_CLASS()
+protected:
+    virtual ~MultiDeviceRenderer();
+
+private:
+    std::unique_ptr<MultiDeviceRendererPrivate<Float, Spectrum>> d;
+};
+
+/**
+ * \brief Renders a scene using the CPU and a GPU at the same time
+ *
+ * The scene is loaded twice: once in an LLVM variant that renders on the CPU,
+ * and once in a CUDA variant that renders on the GPU. Both replicas render
+ * passes of the same image concurrently, and their accumulated raw film
+ * contents are finally merged into the film of the CUDA replica, which
+ * develops the image.
+ *
+ * Samples are assigned in proportion to the throughput of each side, which is
+ * measured during the render. Each side starts with a single sample per pixel
+ * and afterwards requests passes that take roughly \c pass_time seconds at its
+ * current speed. Near the end of the render, a side only receives its share
+ * of the remaining samples (proportional to its throughput), and a slower side
+ * that would not complete a single sample per pixel in that time stops, so
+ * that it does not delay the completion of the render.
+ *
+ * Since the assignment of passes depends on timing, results of different
+ * renders with the same seed are not bitwise identical. The LLVM variant uses
+ * all worker threads of the thread pool (see \ref Thread::set_thread_count()).
+ */
+class MI_EXPORT_LIB HybridRenderer : public Object {
+public:
+    /// Statistics of one side (CPU or GPU) gathered during the last render
+    struct BackendStats {
+        /// Variant used by this side
+        std::string variant;
+        /// Number of passes rendered by this side
+        uint32_t passes = 0;
+        /// Number of samples per pixel rendered by this side
+        uint32_t spp = 0;
+        /// Time spent rendering passes (in seconds)
+        float busy_time = 0.f;
+        /// Fraction of the total render time spent rendering passes
+        float utilization = 0.f;
+        /// Number of samples rendered per second of busy time
+        float throughput = 0.f;
+    };
+
+    /**
+     * \brief Load the scene in an LLVM and a CUDA variant
+     *
+     * \param filename
+     *    Filename of the scene XML file
+     *
+     * \param cpu_variant
+     *    Name of an LLVM variant (e.g. <tt>"llvm_ad_rgb"</tt>)
+     *
+     * \param gpu_variant
+     *    Name of a CUDA variant with the same color representation (e.g.
+     *    <tt>"cuda_ad_rgb"</tt>)
+     *
+     * \param defines
+     *    Parameters that can be referenced as <tt>$key</tt> within the scene
+     *    description.
+     */
+    HybridRenderer(const fs::path &filename, const std::string &cpu_variant,
+                   const std::string &gpu_variant,
+                   const RenderParameterList &defines = {});
+
+    /**
+     * \brief Render the specified sensor on both sides and return the
+     * developed image
+     *
+     * \param seed
+     *    Base seed of the render. Every pass uses a distinct seed derived
+     *    from it.
+     *
+     * \param spp
+     *    Total number of samples per pixel, or 0 to use the sampler's default.
+     *
+     * \param pass_time
+     *    Targeted duration of a single pass (in seconds). Shorter passes
+     *    adapt faster to the measured throughput, while longer passes
+     *    utilize the GPU better.
+     */
+    ref<Bitmap> render(uint32_t sensor_index = 0, uint32_t seed = 0,
+                       uint32_t spp = 0, float pass_time = 0.5f);
+
+    /// Return the scene of the CPU (index 0) or GPU (index 1) side
+    Object *scene(size_t index) const;
+
+    /// Return the statistics of the CPU and GPU side during the last render
+    const std::vector<BackendStats> &backend_stats() const;
+
+    std::string to_string() const override;
+
+    MI_DECLARE_CLASS()
+protected:
+    virtual ~HybridRenderer();
+
+private:
+    std::unique_ptr<HybridRendererPrivate> d;
+};
+
+MI_EXTERN_CLASS(RenderCoordinator)
+MI_EXTERN_CLASS(RenderWorker)
+MI_EXTERN_CLASS(RenderServer)
+MI_EXTERN_CLASS(MultiDeviceRenderer)
+NAMESPACE_END(mitsuba)
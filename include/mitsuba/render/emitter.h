@@ -77,6 +77,36 @@ public:
     /// Modify the emitter's "dirty" flag
     void set_dirty(bool dirty) { m_dirty = dirty; }
 
+    /// Index of the emitter in the list of emitters of its scene
+    uint32_t emitter_index() const { return m_emitter_index; }
+
+    /// Set the index of the emitter in the list of emitters of its scene
+    void set_emitter_index(uint32_t index) { m_emitter_index = index; }
+
+    /**
+     * \brief Conservative bounds of the emission used to build a light tree
+     *
+     * Light is emitted from within \c bbox with a total power of at most
+     * \c power. The normals of the emitting surface lie within \c theta_o
+     * radians of \c axis, and light is emitted up to \c theta_e radians away
+     * from the normal (\f$\pi/2\f$ for surfaces with cosine falloff).
+     */
+    struct LightBounds {
+        ScalarBoundingBox3f bbox;
+        ScalarFloat power = -1.f;
+        ScalarVector3f axis = ScalarVector3f(0.f, 0.f, 1.f);
+        ScalarFloat theta_o = dr::Pi<ScalarFloat>;
+        ScalarFloat theta_e = .5f * dr::Pi<ScalarFloat>;
+    };
+
+    /**
+     * \brief Return the bounds of the emission used by the light tree
+     *
+     * The default implementation returns a negative power, in which case the
+     * emitter is excluded from the light tree and sampled uniformly.
+     */
+    virtual LightBounds light_bounds() const;
+
     DRJIT_VCALL_REGISTER(Float, mitsuba::Emitter)
 
     MI_DECLARE_CLASS()
@@ -94,6 +124,9 @@ protected:
 
     /// True if the emitters's parameters have changed
     bool m_dirty = false;
+
+    /// Index in the scene's emitter list (set by the scene)
+    uint32_t m_emitter_index = (uint32_t) -1;
 };
 
 MI_EXTERN_CLASS(Emitter)
@@ -117,6 +150,7 @@ DRJIT_VCALL_TEMPLATE_BEGIN(mitsuba::Emitter)
     DRJIT_VCALL_GETTER(shape, const typename Class::Shape *)
     DRJIT_VCALL_GETTER(medium, const typename Class::Medium *)
     DRJIT_VCALL_GETTER(sampling_weight, float)
+    DRJIT_VCALL_GETTER(emitter_index, uint32_t)
 DRJIT_VCALL_TEMPLATE_END(mitsuba::Emitter)
 
 //! @}
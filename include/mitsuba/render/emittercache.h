@@ -0,0 +1,248 @@
+#pragma once
+
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include <mitsuba/core/bbox.h>
+#include <mitsuba/core/fwd.h>
+#include <mitsuba/core/logger.h>
+#include <mitsuba/render/fwd.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**
+ * \brief Spatial cache of the emitters that contribute to the illumination of
+ * the different regions of a scene
+ *
+ * The bounding box of the scene is divided into a regular grid of cells. When
+ * a shadow ray towards an emitter is unoccluded, the scene reports the
+ * contribution of the sample to the cell containing the reference point (see
+ * \ref record()). Since the recorded values are divided by the probability of
+ * choosing the emitter, their sum estimates the unoccluded radiance that each
+ * emitter provides to a cell, regardless of how emitters were selected.
+ *
+ * \ref update() turns the recorded values into a discrete distribution per
+ * cell. The scene uses it for a fraction of the emitter samples (see \ref
+ * fraction()) and its regular emitter sampling strategy for the rest, which
+ * keeps the estimates unbiased even for emitters that weren't observed yet.
+ * Cells without any recorded contributions use the sampling weights of the
+ * emitters. The distributions are only rebuilt by \ref update(), which
+ * happens between rendering passes.
+ *
+ * When the grid contains more cells than the cache can store, cells are
+ * mapped to the slots of the cache by a spatial hash function, and cells
+ * that collide share their statistics.
+ */
+template <typename Float, typename Spectrum>
+class EmitterSelectionCache {
+public:
+    MI_IMPORT_TYPES()
+
+    using FloatStorage = DynamicBuffer<Float>;
+
+    /**
+     * \brief Create an empty cache
+     *
+     * \param bbox
+     *     Region of space covered by the grid
+     *
+     * \param resolution
+     *     Number of grid cells along each axis
+     *
+     * \param fraction
+     *     Fraction of the emitter samples that are drawn from the cache
+     *
+     * \param weights
+     *     Sampling weights of the emitters (used by cells without any
+     *     recorded contributions)
+     */
+    EmitterSelectionCache(const ScalarBoundingBox3f &bbox, uint32_t resolution,
+                          ScalarFloat fraction,
+                          const std::vector<ScalarFloat> &weights)
+        : m_resolution(resolution), m_fraction(fraction),
+          m_emitter_count((uint32_t) weights.size()), m_weights(weights) {
+        if (resolution == 0)
+            Throw("EmitterSelectionCache: the resolution must be positive!");
+        if (fraction < 0.f || fraction >= 1.f)
+            Throw("EmitterSelectionCache: the fraction must be in [0, 1)!");
+
+        m_offset = bbox.min;
+        m_scale = ScalarFloat(resolution) / dr::maximum(bbox.extents(), 1e-6f);
+
+        /* Bound the size of the per-cell distributions. With many emitters,
+           the grid is hashed into fewer slots */
+        uint64_t cells = (uint64_t) resolution * resolution * resolution;
+        m_slot_count = (uint32_t) std::max<uint64_t>(
+            1, std::min<uint64_t>(cells, MaxEntries / m_emitter_count));
+        m_hashed = m_slot_count < cells;
+
+        size_t size = (size_t) m_slot_count * m_emitter_count;
+        if constexpr (dr::is_jit_v<Float>) {
+            m_stats = dr::zeros<FloatStorage>(size);
+        } else {
+            m_stats_host.reset(new std::atomic<ScalarFloat>[size]);
+            for (size_t i = 0; i < size; ++i)
+                m_stats_host[i].store(0.f, std::memory_order_relaxed);
+        }
+
+        update();
+    }
+
+    /// Fraction of the emitter samples that are drawn from the cache
+    ScalarFloat fraction() const { return m_fraction; }
+
+    /// Number of distributions stored by the cache
+    uint32_t slot_count() const { return m_slot_count; }
+
+    /// Record the contribution of emitter \c index at the point \c p
+    void record(const Point3f &p, const UInt32 &index, const Float &value,
+                Mask active) {
+        active &= value > 0.f;
+        UInt32 entry = slot(p) * m_emitter_count + index;
+
+        if constexpr (dr::is_jit_v<Float>) {
+            dr::scatter_reduce(ReduceOp::Add, m_stats, dr::detach(value),
+                               entry, active);
+        } else {
+            // Multiple threads may record at the same time in scalar mode
+            if (active) {
+                std::atomic<ScalarFloat> &target = m_stats_host[entry];
+                ScalarFloat old = target.load(std::memory_order_relaxed);
+                while (!target.compare_exchange_weak(
+                    old, old + value, std::memory_order_relaxed))
+                    ;
+            }
+        }
+    }
+
+    /**
+     * \brief Sample an emitter from the distribution of the cell containing
+     * the point \c p
+     *
+     * Returns the emitter index and the reused sample.
+     */
+    std::pair<UInt32, Float> sample(const Point3f &p, Float sample,
+                                    Mask active) const {
+        UInt32 offset = slot(p) * m_emitter_count;
+
+        UInt32 index = dr::binary_search<UInt32>(
+            0, m_emitter_count - 1, [&](const UInt32 &i) {
+                return dr::gather<Float>(m_cdf, offset + i, active) < sample;
+            });
+
+        auto [cdf_prev, pmf] = interval(offset, index, active);
+        sample = dr::select(pmf > 0.f, (sample - cdf_prev) / pmf, 0.f);
+
+        return { index, dr::minimum(sample, dr::OneMinusEpsilon<Float>) };
+    }
+
+    /// Probability of choosing emitter \c index at the point \c p
+    Float pmf(const Point3f &p, const UInt32 &index, Mask active) const {
+        return interval(slot(p) * m_emitter_count, index, active).second;
+    }
+
+    /**
+     * \brief Combine the probability \c base_pmf of the scene's regular
+     * emitter sampling strategy with the one of the cache
+     */
+    Float mix(const Point3f &p, const UInt32 &index, const Float &base_pmf,
+              Mask active) const {
+        return dr::fmadd(m_fraction, pmf(p, index, active),
+                         (1.f - m_fraction) * base_pmf);
+    }
+
+    /// Rebuild the distributions from the contributions recorded so far
+    void update() {
+        size_t size = (size_t) m_slot_count * m_emitter_count;
+        std::vector<ScalarFloat> stats(size);
+
+        if constexpr (dr::is_jit_v<Float>) {
+            dr::eval(m_stats);
+            FloatStorage host = dr::migrate(m_stats, AllocType::Host);
+            dr::sync_thread();
+            std::memcpy(stats.data(), host.data(), size * sizeof(ScalarFloat));
+        } else {
+            for (size_t i = 0; i < size; ++i)
+                stats[i] = m_stats_host[i].load(std::memory_order_relaxed);
+        }
+
+        std::vector<ScalarFloat> cdf(size);
+        uint32_t learned = 0;
+        for (uint32_t s = 0; s < m_slot_count; ++s) {
+            const ScalarFloat *values = stats.data() + (size_t) s * m_emitter_count;
+
+            double total = 0.0, accum = 0.0;
+            for (uint32_t i = 0; i < m_emitter_count; ++i)
+                total += values[i];
+
+            if (total > 0.0) {
+                learned++;
+            } else {
+                values = m_weights.data();
+                for (uint32_t i = 0; i < m_emitter_count; ++i)
+                    total += values[i];
+            }
+
+            ScalarFloat *out = cdf.data() + (size_t) s * m_emitter_count;
+            for (uint32_t i = 0; i < m_emitter_count; ++i) {
+                accum += values[i];
+                out[i] = total > 0.0 ? ScalarFloat(accum / total) : 0.f;
+            }
+            out[m_emitter_count - 1] = total > 0.0 ? 1.f : 0.f;
+        }
+
+        m_cdf = dr::load<FloatStorage>(cdf.data(), size);
+
+        Log(Debug, "Emitter cache: %u/%u cells with recorded contributions.",
+            learned, m_slot_count);
+    }
+
+protected:
+    /// Return the slot of the grid cell containing \c p
+    UInt32 slot(const Point3f &p) const {
+        Vector3i cell = dr::floor2int<Vector3i>((p - m_offset) * m_scale);
+        Vector3u c = Vector3u(dr::clamp(cell, 0, (int32_t) m_resolution - 1));
+
+        if (m_hashed) {
+            UInt32 hash = (c.x() * 73856093u) ^ (c.y() * 19349663u) ^
+                          (c.z() * 83492791u);
+            return hash % m_slot_count;
+        }
+
+        return (c.z() * m_resolution + c.y()) * m_resolution + c.x();
+    }
+
+    /// Return the CDF value preceding entry \c index and its probability
+    std::pair<Float, Float> interval(const UInt32 &offset, const UInt32 &index,
+                                     Mask active) const {
+        Float cdf = dr::gather<Float>(m_cdf, offset + index, active),
+              cdf_prev = dr::gather<Float>(m_cdf, offset + index - 1,
+                                           active && index > 0);
+        return { cdf_prev, cdf - cdf_prev };
+    }
+
+private:
+    /// Upper bound on the number of (cell, emitter) entries
+    static constexpr uint64_t MaxEntries = 1u << 24;
+
+    ScalarPoint3f m_offset;
+    ScalarVector3f m_scale;
+    uint32_t m_resolution;
+    uint32_t m_slot_count;
+    bool m_hashed;
+
+    ScalarFloat m_fraction;
+    uint32_t m_emitter_count;
+    std::vector<ScalarFloat> m_weights;
+
+    /// Recorded contributions per (slot, emitter) in JIT variants
+    FloatStorage m_stats;
+    /// Recorded contributions per (slot, emitter) in scalar variants
+    std::unique_ptr<std::atomic<ScalarFloat>[]> m_stats_host;
+    /// Per-slot CDFs over the emitters
+    FloatStorage m_cdf;
+};
+
+NAMESPACE_END(mitsuba)
@@ -4,10 +4,13 @@
 #include <mitsuba/core/logger.h>
 #include <mitsuba/core/object.h>
 #include <mitsuba/core/rfilter.h>
+#include <mitsuba/core/struct.h>
 #include <mitsuba/core/vector.h>
 #include <mitsuba/render/sampler.h>
 #include <mitsuba/render/fwd.h>
 #include <mitsuba/render/texture.h>
+#include <mutex>
+#include <shared_mutex>
 
 NAMESPACE_BEGIN(mitsuba)
 
@@ -34,6 +37,12 @@ enum class FilmFlags : uint32_t {
      * a special treatment of the samples before storing them in the Image Block.
      */
     Special              = 0x4,
+
+    /**
+     * The film streams finished rows to disk and cannot be developed in
+     * memory. Blocks must be committed once per pixel and in scanline order.
+     */
+    Streaming            = 0x8,
 };
 
 MI_DECLARE_ENUM_OPERATORS(FilmFlags)
@@ -72,12 +81,52 @@ public:
     /// Return a bitmap object storing the developed contents of the film
     virtual ref<Bitmap> bitmap(bool raw = false) const = 0;
 
-    /// Write the developed contents of the film to a file on disk
-    virtual void write(const fs::path &path) const = 0;
+    /**
+     * \brief Develop the film into a compact image for display purposes
+     *
+     * Compared to \ref bitmap() followed by \ref Bitmap::convert(), the
+     * normalization by the weight channel, the exposure adjustment, tone
+     * mapping, and conversion to the output format are fused into a single
+     * pass. In JIT variants, it runs on the device and only the final image
+     * is copied to the host. AOV channels are never accessed.
+     *
+     * \param exposure
+     *    Exposure adjustment in stops (the values are scaled by
+     *    <tt>2^exposure</tt>)
+     *
+     * \param aces
+     *    Apply the (fitted) ACES filmic tone mapping curve
+     *
+     * \param component_format
+     *    Either \c Struct::Type::UInt8, which produces sRGB-encoded values
+     *    clamped to <tt>[0, 1]</tt>, or \c Struct::Type::Float16, which
+     *    produces linear values.
+     *
+     * \return An RGB or RGBA bitmap, depending on whether the film stores
+     *    an alpha channel
+     */
+    virtual ref<Bitmap> develop_preview(float exposure = 0.f, bool aces = false,
+                                        Struct::Type component_format =
+                                            Struct::Type::UInt8) const;
+
+    /**
+     * \brief Write the developed contents of the film to a file on disk
+     *
+     * \param write_async
+     *    When set, the image is developed on the calling thread but encoded
+     *    and written to disk by a background task (see \ref
+     *    Bitmap::write_async()), so that the caller can proceed with further
+     *    work in the meantime. Pending writes are completed by \ref
+     *    Thread::wait_for_tasks().
+     */
+    virtual void write(const fs::path &path, bool write_async = false) const = 0;
 
     /// dr::schedule() variables that represent the internal film storage
     virtual void schedule_storage() = 0;
 
+    /// Return the image block that accumulates the samples (if any)
+    virtual const ImageBlock *storage() const { return nullptr; }
+
     /**
       * \brief Prepare spectrum samples to be in the format expected by the film
       *
@@ -214,6 +263,23 @@ protected:
     /// Virtual destructor
     virtual ~Film();
 
+    /**
+     * \brief Thread-safe accumulation of \c block into the film's \c storage
+     *
+     * In scalar variants, the storage is partitioned into tiles of
+     * 32x32 pixels, each of which is guarded by one of a fixed set of striped
+     * locks. Only \c mutex is taken in shared mode along with the locks of
+     * the tiles overlapped by the block (including its border), hence workers
+     * committing disjoint regions do not serialize. Operations that access
+     * the entire storage must hold \c mutex exclusively. JIT variants simply
+     * hold \c mutex exclusively.
+     *
+     * Time spent waiting for the locks is attributed to the
+     * \ref ProfilerPhase::ImageBlockPut phase.
+     */
+    void put_block_striped(ImageBlock *storage, const ImageBlock *block,
+                           std::shared_mutex &mutex);
+
     /// Combined flags for all properties of this film.
     uint32_t m_flags;
 
@@ -224,6 +290,10 @@ protected:
     bool m_sample_border;
     ref<ReconstructionFilter> m_filter;
     ref<Texture> m_srf;
+
+private:
+    static constexpr uint32_t TileLockSize = 32, TileLockCount = 64;
+    std::mutex m_tile_locks[TileLockCount];
 };
 
 MI_EXTERN_CLASS(Film)
@@ -21,6 +21,8 @@ template <typename Float, typename Spectrum> class Medium;
 template <typename Float, typename Spectrum> class Mesh;
 template <typename Float, typename Spectrum> class MicrofacetDistribution;
 template <typename Float, typename Spectrum> class ReconstructionFilter;
+template <typename Float, typename Spectrum> class RenderCoordinator;
+template <typename Float, typename Spectrum> class RenderWorker;
 template <typename Float, typename Spectrum> class Sampler;
 template <typename Float, typename Spectrum> class Scene;
 template <typename Float, typename Spectrum> class Sensor;
@@ -29,6 +31,8 @@ template <typename Float, typename Spectrum> class ProjectiveCamera;
 template <typename Float, typename Spectrum> class Shape;
 template <typename Float, typename Spectrum> class ShapeGroup;
 template <typename Float, typename Spectrum> class ShapeKDTree;
+template <typename Float, typename Spectrum> class ShapeBVH;
+template <typename Float, typename Spectrum> class SparseVolumeGrid;
 template <typename Float, typename Spectrum> class Texture;
 template <typename Float, typename Spectrum> class Volume;
 template <typename Float, typename Spectrum> class VolumeGrid;
@@ -94,9 +98,12 @@ template <typename Float_, typename Spectrum_> struct RenderAliases {
     using Film                   = mitsuba::Film<FloatU, SpectrumU>;
     using ImageBlock             = mitsuba::ImageBlock<FloatU, SpectrumU>;
     using ReconstructionFilter   = mitsuba::ReconstructionFilter<FloatU, SpectrumU>;
+    using RenderCoordinator      = mitsuba::RenderCoordinator<FloatU, SpectrumU>;
+    using RenderWorker           = mitsuba::RenderWorker<FloatU, SpectrumU>;
     using Texture                = mitsuba::Texture<FloatU, SpectrumU>;
     using Volume                 = mitsuba::Volume<FloatU, SpectrumU>;
     using VolumeGrid             = mitsuba::VolumeGrid<FloatU, SpectrumU>;
+    using SparseVolumeGrid       = mitsuba::SparseVolumeGrid<FloatU, SpectrumU>;
 
     using MeshAttribute          = mitsuba::MeshAttribute<FloatU, SpectrumU>;
 
@@ -0,0 +1,225 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include <mitsuba/core/fwd.h>
+#include <mitsuba/core/logger.h>
+#include <mitsuba/core/util.h>
+#include <mitsuba/render/interaction.h>
+#include <mitsuba/render/shapegroup.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**
+ * \brief Pages the geometry of shape groups in and out of device memory to
+ * render scenes that exceed the memory of the GPU
+ *
+ * The unit of paging is a \ref ShapeGroup: the triangle meshes of a group are
+ * either resident in device memory, or they are moved to pinned host memory
+ * and replaced by a proxy box in the acceleration data structure (see \ref
+ * ShapeGroup::set_resident()). The scene reports all intersected groups to
+ * the cache via \ref record(). A ray that hits the proxy of a non-resident
+ * group signals that the group is needed.
+ *
+ * Since a ray can't wait for its geometry within a megakernel, rendering
+ * proceeds in passes: when a pass intersected any non-resident group, \ref
+ * end_pass() pages in the requested groups, evicts the least recently used
+ * ones that weren't needed by the current pass, and asks the integrator to
+ * render the pass again using the same random numbers. The image therefore
+ * doesn't depend on the budget, and a pass is repeated at most once per
+ * group that it needs.
+ *
+ * Only the rays that enter the bounding box of a non-resident group are
+ * detected. Rays that begin and end within the box (e.g. short shadow rays
+ * between overlapping groups) may miss its geometry.
+ */
+template <typename Float, typename Spectrum>
+class GeometryCache {
+public:
+    MI_IMPORT_TYPES(ShapeGroup, ShapePtr)
+
+    /**
+     * \brief Enable paging for the given shape groups
+     *
+     * Groups are made resident in order until \c budget (in bytes) is
+     * exhausted, all remaining ones are paged out right away. This must
+     * happen before the scene builds its acceleration data structure.
+     */
+    GeometryCache(const std::vector<ref<ShapeGroup>> &groups, size_t budget)
+        : m_groups(groups), m_budget(budget), m_last_used(groups.size(), 0),
+          m_bytes(groups.size(), 0) {
+        std::vector<uint32_t> slots;
+        auto set_slot = [&](const Object *shape, uint32_t slot) {
+            uint32_t id =
+                jit_registry_get_id(dr::backend_v<Float>, (void *) shape);
+            if (id >= slots.size())
+                slots.resize(id + 1, 0);
+            slots[id] = slot;
+        };
+
+        size_t resident_bytes = 0;
+        for (size_t i = 0; i < m_groups.size(); ++i) {
+            ShapeGroup *group = m_groups[i];
+            group->enable_paging();
+
+            // Slot 0 receives the intersections with shapes outside of groups
+            for (auto &shape : group->shapes())
+                set_slot(shape.get(), (uint32_t) i + 1);
+            set_slot(group->proxy(), (uint32_t) i + 1);
+
+            m_bytes[i] = group->geometry_bytes();
+            if (resident_bytes + m_bytes[i] <= m_budget)
+                resident_bytes += m_bytes[i];
+            else
+                group->set_resident(false);
+        }
+
+        m_slots = dr::load<UInt32Storage>(slots.data(), slots.size());
+        m_usage = dr::zeros<UInt32Storage>(m_groups.size() + 1);
+
+        Log(Info, "Geometry paging: %zu/%zu shape groups resident (%s of %s).",
+            resident_count(), m_groups.size(),
+            util::mem_string(resident_bytes), util::mem_string(m_budget));
+    }
+
+    /// Record the shape groups that were intersected by the given shapes
+    void record(const ShapePtr &shape, Mask active) const {
+        UInt32 id = dr::reinterpret_array<UInt32>(shape);
+        active &= id < (uint32_t) dr::width(m_slots);
+        UInt32 slot = dr::gather<UInt32>(m_slots, id, active);
+        dr::scatter(m_usage, UInt32(1), slot, active && slot > 0);
+    }
+
+    /// Prepare the recording of a (possibly repeated) pass
+    void begin_pass() {
+        m_usage = dr::zeros<UInt32Storage>(m_groups.size() + 1);
+        for (size_t i = 0; i < m_groups.size(); ++i) {
+            if (m_groups[i]->resident())
+                m_bytes[i] = m_groups[i]->geometry_bytes();
+        }
+    }
+
+    /**
+     * \brief Process the groups that were needed by the last pass
+     *
+     * Returns \c true when the pass only intersected resident geometry.
+     * Otherwise, the missing groups were paged in and the pass must be
+     * repeated after updating the acceleration data structure of the scene
+     * via \ref Scene::parameters_changed().
+     */
+    bool end_pass() {
+        auto &&usage = dr::migrate(m_usage, AllocType::Host);
+        dr::sync_thread();
+        const uint32_t *used = usage.data();
+
+        std::vector<uint32_t> missing;
+        for (uint32_t i = 0; i < (uint32_t) m_groups.size(); ++i) {
+            if (!used[i + 1])
+                continue;
+            m_last_used[i] = m_pass + 1;
+            if (!m_groups[i]->resident())
+                missing.push_back(i);
+        }
+
+        if (missing.empty()) {
+            m_pass++;
+            return true;
+        }
+
+        size_t needed = 0;
+        for (uint32_t i : missing)
+            needed += m_bytes[i];
+
+        // Evict the least recently used groups that the current pass didn't need
+        std::vector<uint32_t> candidates;
+        size_t resident_bytes = 0;
+        for (uint32_t i = 0; i < (uint32_t) m_groups.size(); ++i) {
+            if (!m_groups[i]->resident())
+                continue;
+            resident_bytes += m_bytes[i];
+            if (m_last_used[i] <= m_pass)
+                candidates.push_back(i);
+        }
+
+        std::stable_sort(candidates.begin(), candidates.end(),
+                         [&](uint32_t a, uint32_t b) {
+                             return m_last_used[a] < m_last_used[b];
+                         });
+
+        for (uint32_t i : candidates) {
+            if (resident_bytes + needed <= m_budget)
+                break;
+            m_groups[i]->set_resident(false);
+            resident_bytes -= m_bytes[i];
+            m_evictions++;
+        }
+
+        if (resident_bytes + needed > m_budget && !m_warned) {
+            Log(Warn, "Geometry paging: a single pass requires %s of geometry, "
+                      "which exceeds the budget of %s. Consider reducing the "
+                      "number of samples per pass.",
+                util::mem_string(resident_bytes + needed),
+                util::mem_string(m_budget));
+            m_warned = true;
+        }
+
+        for (uint32_t i : missing)
+            m_groups[i]->set_resident(true);
+
+        m_page_ins += (uint32_t) missing.size();
+        m_repeats++;
+
+        Log(Debug, "Geometry paging: repeating pass %u after paging in %zu "
+                   "shape group%s.", m_pass, missing.size(),
+            missing.size() == 1 ? "" : "s");
+
+        return false;
+    }
+
+    /// Return the number of shape groups that are currently resident
+    size_t resident_count() const {
+        return (size_t) std::count_if(
+            m_groups.begin(), m_groups.end(),
+            [](const ref<ShapeGroup> &g) { return g->resident(); });
+    }
+
+    /// Return a summary of the paging activity for the log
+    std::string stats() const {
+        size_t resident_bytes = 0;
+        for (size_t i = 0; i < m_groups.size(); ++i) {
+            if (m_groups[i]->resident())
+                resident_bytes += m_bytes[i];
+        }
+
+        return tfm::format(
+            "Geometry paging: %u repeated pass%s, %u page-in%s, %u "
+            "eviction%s, %zu/%zu shape groups resident (%s).",
+            m_repeats, m_repeats == 1 ? "" : "es", m_page_ins,
+            m_page_ins == 1 ? "" : "s", m_evictions,
+            m_evictions == 1 ? "" : "s", resident_count(), m_groups.size(),
+            util::mem_string(resident_bytes));
+    }
+
+private:
+    using UInt32Storage = DynamicBuffer<UInt32>;
+
+    std::vector<ref<ShapeGroup>> m_groups;
+    size_t m_budget;
+
+    /// Maps the registry IDs of grouped shapes and proxies to group index + 1
+    UInt32Storage m_slots;
+    /// Intersected groups of the current pass (indexed like \c m_slots)
+    mutable UInt32Storage m_usage;
+
+    /// Index of the last pass that needed each group (plus one)
+    std::vector<uint32_t> m_last_used;
+    /// Device memory of each group when resident
+    std::vector<size_t> m_bytes;
+
+    uint32_t m_pass = 0;
+    uint32_t m_repeats = 0, m_page_ins = 0, m_evictions = 0;
+    bool m_warned = false;
+};
+
+NAMESPACE_END(mitsuba)
@@ -155,6 +155,20 @@ public:
                bool warn_negative = std::is_scalar_v<Float>,
                bool warn_invalid = std::is_scalar_v<Float>);
 
+    /**
+     * \brief Construct an image block from a binary stream
+     *
+     * This reads the offset, size, border size, channel count, and raw
+     * contents previously written via \ref write(). The resulting block has
+     * no reconstruction filter and is mainly intended to be merged into
+     * another block or film via \ref put_block(), e.g. after transferring it
+     * over the network.
+     */
+    ImageBlock(Stream *stream);
+
+    /// Serialize the image block (including its border region) to a stream
+    void write(Stream *stream) const;
+
     /// Accumulate another image block into this one
     void put_block(const ImageBlock *block);
 
@@ -301,6 +315,23 @@ public:
     /// Use Kahan-style error-compensated floating point accumulation?
     bool compensate() const { return m_compensate; }
 
+    /**
+     * \brief Spread the atomic writes of \ref put() over several copies of
+     * the image in JIT variants
+     *
+     * Each lane of the wavefront accumulates into the copy given by its index
+     * modulo \c value. This reduces the contention of atomic memory
+     * operations when many samples target the same pixels (e.g. caustics in
+     * a particle tracer), at the cost of \c value times the memory. The
+     * copies are summed when \ref tensor() is accessed. A value of \c 1
+     * (the default) disables this. Not used in combination with
+     * error-compensated accumulation.
+     */
+    void set_replicas(uint32_t value);
+
+    /// Return the number of image copies used by \ref put() in JIT variants
+    uint32_t replicas() const { return m_replicas; }
+
     /// Return the number of channels stored by the image block
     uint32_t channel_count() const { return m_channel_count; }
 
@@ -319,6 +350,9 @@ public:
     /// Return the underlying image tensor (const version)
     const TensorXf &tensor() const;
 
+    /// Return the host and device memory used by the image block (in bytes)
+    std::pair<size_t, size_t> memory_usage() const;
+
     //! @}
     // =============================================================
 
@@ -338,12 +372,14 @@ protected:
     uint32_t m_border_size;
     TensorXf m_tensor;
     mutable TensorXf m_tensor_compensation;
+    Float m_tensor_replicas;
     ref<const ReconstructionFilter> m_rfilter;
     bool m_normalize;
     bool m_coalesce;
     bool m_compensate;
     bool m_warn_negative;
     bool m_warn_invalid;
+    uint32_t m_replicas = 1;
 };
 
 MI_EXTERN_CLASS(ImageBlock)
@@ -92,6 +92,50 @@ public:
                     bool develop = true,
                     bool evaluate = true);
 
+    /**
+     * \brief Render an ensemble of statistically independent images of the
+     * scene
+     *
+     * This is useful to estimate the variance of a rendering (or of a
+     * quantity derived from it) without issuing \c ensemble_size separate
+     * \ref render() calls. The default implementation does exactly that,
+     * using the seeds <tt>seed, seed + 1, ...</tt>. The \ref
+     * SamplingIntegrator instead renders all members within a single
+     * wavefront in JIT variants, which shares the setup of the sensor and of
+     * the scene and launches a single rendering kernel.
+     *
+     * Afterwards, <tt>sensor->film()</tt> holds the last member of the
+     * ensemble.
+     *
+     * \param ensemble_size
+     *     Number of images to render.
+     *
+     * The other parameters have the same meaning as in \ref render().
+     *
+     * \return
+     *     A tensor of shape <tt>(ensemble_size, height, width,
+     *     channels)</tt>, whose leading index selects the member.
+     */
+    virtual TensorXf render_ensemble(Scene *scene,
+                                     uint32_t ensemble_size,
+                                     Sensor *sensor,
+                                     uint32_t seed = 0,
+                                     uint32_t spp = 0);
+
+    /**
+     * \brief Render an ensemble of statistically independent images of the
+     * scene
+     *
+     * This function is just a thin wrapper around the previous \ref
+     * render_ensemble() overload. It accepts a sensor *index* instead and
+     * renders the scene using sensor 0 by default.
+     */
+    TensorXf render_ensemble(Scene *scene,
+                             uint32_t ensemble_size,
+                             uint32_t sensor_index = 0,
+                             uint32_t seed = 0,
+                             uint32_t spp = 0);
+
 
     // =========================================================================
     //! @{ \name Default backwards and forwards differentiation
@@ -317,6 +361,9 @@ protected:
     /// Virtual destructor
     virtual ~Integrator() { }
 
+    /// Stack images of identical shape along a new leading dimension
+    static TensorXf stack_images(const std::vector<TensorXf> &images);
+
 protected:
     /// Integrators should stop all work when this flag is set to true.
     bool m_stop;
@@ -348,7 +395,7 @@ protected:
 template <typename Float, typename Spectrum>
 class MI_EXPORT_LIB SamplingIntegrator : public Integrator<Float, Spectrum> {
 public:
-    MI_IMPORT_BASE(Integrator, should_stop, aov_names,
+    MI_IMPORT_BASE(Integrator, should_stop,
                     m_stop, m_timeout, m_render_timer, m_hide_emitters)
     MI_IMPORT_TYPES(Scene, Sensor, Film, ImageBlock, Medium, Sampler)
 
@@ -398,6 +445,45 @@ public:
                                              Float *aovs = nullptr,
                                              Mask active = true) const;
 
+    /**
+     * \brief Sample the incident radiance along a ray whose first
+     * intersection with the scene is already known
+     *
+     * This entry point lets integrators that trace the camera ray themselves
+     * (e.g. the \c aov integrator) share the resulting intersection \c si
+     * with nested integrators, which can then skip tracing the primary ray.
+     * Invalid entries of \c si denote rays that escaped the scene. The other
+     * parameters and the return value match those of \ref sample().
+     *
+     * The default implementation ignores \c si and forwards to \ref sample().
+     */
+    virtual std::pair<Spectrum, Mask>
+    sample_from_primary(const Scene *scene,
+                        Sampler *sampler,
+                        const RayDifferential3f &ray,
+                        const SurfaceInteraction3f &si,
+                        const Medium *medium = nullptr,
+                        Float *aovs = nullptr,
+                        Mask active = true) const;
+
+    /**
+     * \brief Enable the cost counters of the integrator
+     *
+     * When enabled, \ref sample() reports the work performed by each sample
+     * using three additional AOVs that follow those of the integrator: the
+     * number of path vertices (<tt>cost.V</tt>), shadow rays
+     * (<tt>cost.S</tt>), and null-collision steps in participating media
+     * (<tt>cost.N</tt>). This is used by the \c cost AOV of the \c aov
+     * integrator. Throws if the integrator doesn't implement the counters.
+     */
+    void set_cost_aovs(bool value);
+
+    /// Are the cost counters enabled? (see \ref set_cost_aovs())
+    bool cost_aovs() const { return m_cost_aovs; }
+
+    /// Does the integrator implement the cost counters?
+    virtual bool has_cost_counters() const { return false; }
+
     // =========================================================================
     //! @{ \name Integrator interface implementation
     // =========================================================================
@@ -409,6 +495,85 @@ public:
                     bool develop = true,
                     bool evaluate = true) override;
 
+    TensorXf render_ensemble(Scene *scene,
+                             uint32_t ensemble_size,
+                             Sensor *sensor,
+                             uint32_t seed = 0,
+                             uint32_t spp = 0) override;
+
+    /// Names of the cost AOVs when they are enabled, and an empty list otherwise
+    std::vector<std::string> aov_names() const override;
+
+    //! @}
+    // =========================================================================
+
+    // =========================================================================
+    //! @{ \name Sample budget
+    // =========================================================================
+
+    /**
+     * \brief Distribute the samples of subsequent renders non-uniformly
+     *
+     * \param budget
+     *    A tensor of shape <tt>(height, width)</tt> or <tt>(height, width,
+     *    1)</tt> matching the crop window of the film. Its entries specify
+     *    the fraction of the sample count that is spent on each pixel, which
+     *    always receives at least one sample. Values are clamped to
+     *    <tt>[0, 1]</tt>. An empty tensor removes the budget.
+     *
+     * This generalizes adaptive sampling to budgets that are decided by the
+     * caller, e.g. to keep the latency low around the cursor of an
+     * interactive viewer. Both the block-based and the wavefront rendering
+     * paths respect the budget, and it can be combined with \c
+     * adaptive_threshold (in which case it bounds the adaptive sample count).
+     */
+    void set_sample_budget(const TensorXf &budget);
+
+    /**
+     * \brief Distribute the samples of subsequent renders according to a
+     * circular region of interest
+     *
+     * Pixels within distance \c radius of \c center (specified in pixels
+     * relative to the crop window) receive the full sample count. Beyond it,
+     * the budget falls off smoothly to \c min_fraction over a distance of \c
+     * falloff pixels.
+     */
+    void set_sample_budget(const ScalarPoint2f &center, ScalarFloat radius,
+                           ScalarFloat falloff, ScalarFloat min_fraction);
+
+    /// Remove a sample budget specified via \ref set_sample_budget()
+    void clear_sample_budget();
+
+    /// Has a sample budget been specified via \ref set_sample_budget()?
+    bool has_sample_budget() const {
+        return !m_budget.empty() || m_budget_roi.radius >= 0.f;
+    }
+
+    /**
+     * \brief Number of samples that a pixel receives under the current sample
+     * budget
+     *
+     * \param pixel
+     *    Pixel position relative to the crop window (positions outside of it,
+     *    e.g. in the film border, are clamped)
+     *
+     * \param spp
+     *    Sample count that the budget refers to
+     */
+    uint32_t budget_sample_count(const ScalarPoint2i &pixel, uint32_t spp) const;
+
+    /**
+     * \brief Discard the camera rays and intersections that were cached via
+     * the \c primary_ray_cache parameter
+     *
+     * The cache is rebuilt automatically when the scene, the sensor, its
+     * transformation, the film crop window, or the number of samples per pass
+     * change. Other modifications that affect the camera rays or their first
+     * intersection (e.g. of the field of view or of the scene geometry) must
+     * be followed by a call to this function.
+     */
+    void clear_primary_ray_cache();
+
     //! @}
     // =========================================================================
 
@@ -436,11 +601,210 @@ protected:
                        ScalarFloat diff_scale_factor,
                        Mask active = true) const;
 
+    /**
+     * \brief Sample the incident radiance along a camera ray
+     *
+     * This is the entry point used by \ref render_camera_sample(), which also
+     * provides the film position \c pos of the sample. The default
+     * implementation simply forwards to \ref sample(). Integrators that rely
+     * on per-pixel information (e.g. gathered during a prepass) can override
+     * it.
+     */
+    virtual std::pair<Spectrum, Mask> sample_pixel(const Scene *scene,
+                                                   Sampler *sampler,
+                                                   const RayDifferential3f &ray,
+                                                   const Vector2f &pos,
+                                                   const Medium *medium,
+                                                   Float *aovs,
+                                                   Mask active) const;
+
+    /// Camera ray generated for a single film sample by \ref sample_camera_ray()
+    struct CameraSample {
+        Vector2f sample_pos;
+        RayDifferential3f ray;
+        Spectrum ray_weight;
+    };
+
+    /// Generate the camera ray of a film sample (first half of \ref render_sample())
+    CameraSample sample_camera_ray(const Sensor *sensor,
+                                   Sampler *sampler,
+                                   const Vector2f &pos,
+                                   ScalarFloat diff_scale_factor,
+                                   Mask active = true) const;
+
+    /**
+     * \brief Estimate the radiance along a camera ray and splat it (second
+     * half of \ref render_sample())
+     *
+     * When specified, \c splat_offset is added to the position where the
+     * sample is splatted into \c block, which lets several images share a
+     * block (see \ref render_ensemble()).
+     */
+    void render_camera_sample(const Scene *scene,
+                              const Sensor *sensor,
+                              Sampler *sampler,
+                              ImageBlock *block,
+                              Float *aovs,
+                              const Vector2f &pos,
+                              const CameraSample &cs,
+                              Mask active = true,
+                              const Vector2f *splat_offset = nullptr) const;
+
+    /**
+     * \brief Version of \ref render_sample() that reuses cached camera rays
+     * (JIT variants)
+     *
+     * Instead of the sampler, the sub-pixel position and aperture sample of
+     * pass \c pass are given by the deterministic jitter pattern <tt>pass %
+     * m_primary_ray_cache</tt>. The camera rays of each pattern are generated
+     * and intersected with the scene only once and then handed to the
+     * integrator via \ref Scene::set_pending_intersection(). The sampler
+     * dimensions of the camera ray are still consumed, so that the remaining
+     * dimensions match \ref render_sample().
+     */
+    void render_sample_cached(const Scene *scene,
+                              const Sensor *sensor,
+                              Sampler *sampler,
+                              ImageBlock *block,
+                              Float *aovs,
+                              const Vector2f &pos,
+                              ScalarFloat diff_scale_factor,
+                              uint32_t spp_per_pass,
+                              uint32_t pass);
+
+    /**
+     * \brief Packetized version of \ref render_block() (scalar variants)
+     *
+     * Processes the pixels of a block in groups of up to 16. The camera rays
+     * of a group are intersected together using \ref
+     * Scene::ray_intersect_preliminary_packet(), after which each path is
+     * continued in scalar form by \ref sample(). Every pixel uses its own
+     * forked sampler, which keeps the random number sequences consistent with
+     * the non-packetized implementation.
+     */
+    void render_block_packet(const Scene *scene,
+                             const Sensor *sensor,
+                             Sampler *sampler,
+                             ImageBlock *block,
+                             Float *aovs,
+                             uint32_t sample_count,
+                             uint32_t seed,
+                             uint32_t block_size) const;
+
+    /**
+     * \brief Adaptive version of the wavefront rendering loop (JIT variants)
+     *
+     * Renders the image in rounds of \ref m_adaptive_min_spp samples per
+     * pixel. After every round, the relative standard error of each pixel's
+     * mean luminance is evaluated, and only pixels that haven't converged yet
+     * are included in the (compacted) wavefront of the next round, until
+     * \c spp samples have been taken.
+     *
+     * Pixels furthermore leave the wavefront once they have received the
+     * number of samples specified by the sample budget (see \ref
+     * set_sample_budget()). Without an adaptive threshold, the rounds are
+     * then chosen so that every pixel receives exactly this many samples.
+     */
+    void render_adaptive(const Scene *scene,
+                         const Sensor *sensor,
+                         Sampler *sampler,
+                         ImageBlock *block,
+                         Float *aovs,
+                         const ScalarVector2u &film_size,
+                         uint32_t seed,
+                         uint32_t spp) const;
+
+    /// Should sampling of a pixel stop given its luminance statistics?
+    bool adaptive_converged(ScalarFloat sum, ScalarFloat sum_sqr,
+                            uint32_t sample_count) const;
+
+    /// Render time statistics of the image blocks processed by a worker
+    struct BlockTimings {
+        uint32_t count = 0;
+        float busy = 0.f, max = 0.f; // In milliseconds
+
+        void add(float time) {
+            count++;
+            busy += time;
+            max = std::max(max, time);
+        }
+    };
+
+    /// Log block render times and the load balance between workers (scalar mode)
+    void log_block_timings(const std::vector<BlockTimings> &timings) const;
+
+    /// State of a progressive render that is tracked across passes
+    struct ProgressiveState {
+        /// Seed passed to \ref render() and samples per pixel of every pass
+        uint32_t seed = 0, spp_per_pass = 0;
+        /// Time elapsed since the last snapshot and checkpoint
+        Timer snapshot_timer, checkpoint_timer;
+    };
+
+    /**
+     * \brief Bookkeeping after a completed progressive pass
+     *
+     * Writes a snapshot of the film when \ref m_snapshot_interval has
+     * elapsed since the last one, and decides whether another pass fits into
+     * the time budget (based on the average duration of the passes so far).
+     * A checkpoint is written when \ref m_checkpoint_interval has elapsed,
+     * or when the render stops before all passes are done.
+     *
+     * \return \c true if rendering should continue with the next pass.
+     */
+    bool progressive_pass_done(const Film *film, uint32_t pass,
+                               uint32_t n_passes, float budget,
+                               ProgressiveState &state) const;
+
+    /**
+     * \brief Write a checkpoint of a progressive render to \ref m_checkpoint_path
+     *
+     * The checkpoint contains the raw film contents (including the weight
+     * channel) along with the seed, the sample count per pass, and the number
+     * of passes that have been accumulated so far. It is first written to a
+     * temporary file that then replaces the previous checkpoint, so that an
+     * interruption never leaves a truncated checkpoint behind.
+     */
+    void write_checkpoint(const Film *film, uint32_t passes_done,
+                          uint32_t n_passes,
+                          const ProgressiveState &state) const;
+
+    /**
+     * \brief Restore the film from a checkpoint written by \ref write_checkpoint()
+     *
+     * Checkpoints of a different render configuration are ignored with a
+     * warning.
+     *
+     * \return The number of passes that are already contained in the film
+     */
+    uint32_t read_checkpoint(Film *film, uint32_t n_passes,
+                             const ProgressiveState &state) const;
+
+    /// Counters of the work performed by a sample (see \ref set_cost_aovs())
+    struct CostCounters {
+        UInt32 vertices = 0;
+        UInt32 shadow_rays = 0;
+        UInt32 null_steps = 0;
+    };
+
+    /// Write the cost counters to the first three entries of \c aovs
+    static void put_cost_aovs(Float *aovs, const CostCounters &cost) {
+        aovs[0] = Float(cost.vertices);
+        aovs[1] = Float(cost.shadow_rays);
+        aovs[2] = Float(cost.null_steps);
+    }
+
 protected:
 
     /// Size of (square) image blocks to render in parallel (in scalar mode)
     uint32_t m_block_size;
 
+    /// Report the cost counters as AOVs? (see \ref set_cost_aovs())
+    bool m_cost_aovs = false;
+
+    /// Trace camera rays in packets (scalar mode, see \ref render_block_packet())
+    bool m_packet_tracing;
+
     /**
      * \brief Number of samples to compute for each pass over the image blocks.
      *
@@ -448,6 +812,74 @@ protected:
      * If set to (uint32_t) -1, all the work is done in a single pass (default).
      */
     uint32_t m_samples_per_pass;
+
+    /// Relative error threshold for adaptive sampling (0: disabled)
+    ScalarFloat m_adaptive_threshold;
+
+    /// Samples per pixel taken between adaptive convergence checks
+    uint32_t m_adaptive_min_spp;
+
+    /**
+     * \brief Samples per pixel of a progressive pass (0: disabled)
+     *
+     * In progressive mode, every pass covers the entire image and is
+     * committed to the film before the next one starts. The timeout is then
+     * enforced between passes, so that the film is always sampled uniformly.
+     */
+    uint32_t m_progressive_spp;
+
+    /// Interval between film snapshots in progressive mode (seconds, 0: disabled)
+    float m_snapshot_interval;
+
+    /// Destination of the film snapshots
+    std::string m_snapshot_path;
+
+    /// Interval between checkpoints in progressive mode (seconds, 0: disabled)
+    float m_checkpoint_interval;
+
+    /// Location of the checkpoint file
+    std::string m_checkpoint_path;
+
+    /// Resume from an existing checkpoint at \ref m_checkpoint_path?
+    bool m_resume;
+
+    /**
+     * \brief Number of cached jitter patterns of the camera rays (JIT
+     * variants, 0: disabled)
+     *
+     * See \ref render_sample_cached(). The memory footprint grows linearly
+     * with the number of patterns, since every one of them stores a ray and
+     * an intersection per sample of a pass.
+     */
+    uint32_t m_primary_ray_cache;
+
+    /// Camera rays and their first intersections (see \ref render_sample_cached())
+    struct PrimaryRayCache {
+        /// Configuration that the cached rays were generated for
+        const Scene *scene = nullptr;
+        const Sensor *sensor = nullptr;
+        Transform4f to_world;
+        ScalarPoint2u crop_offset;
+        ScalarVector2u crop_size;
+        uint32_t spp_per_pass = 0;
+
+        /// Camera samples and intersections of each jitter pattern
+        std::vector<CameraSample> samples;
+        std::vector<PreliminaryIntersection3f> pi;
+        std::vector<bool> ready;
+    } m_primary_cache;
+
+    /// Per-pixel sample budget in row-major order (see \ref set_sample_budget())
+    std::vector<ScalarFloat> m_budget;
+
+    /// Resolution of \ref m_budget
+    ScalarVector2u m_budget_size;
+
+    /// Region of interest that specifies the sample budget (if radius >= 0)
+    struct BudgetROI {
+        ScalarPoint2f center;
+        ScalarFloat radius = -1.f, falloff = 0.f, min_fraction = 0.f;
+    } m_budget_roi;
 };
 
 /** \brief Abstract integrator that performs *recursive* Monte Carlo sampling
@@ -562,6 +994,12 @@ protected:
 
     /// Depth to begin using russian roulette
     int m_rr_depth;
+
+    /**
+     * \brief Number of copies of the image that splats are spread over in
+     * JIT variants (see \ref ImageBlock::set_replicas())
+     */
+    uint32_t m_splat_replicas;
 };
 
 
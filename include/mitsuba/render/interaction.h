@@ -63,6 +63,13 @@ enum class RayFlags : uint32_t {
 
     /// Compute all fields of the surface interaction ignoring shape's motion
     AllNonDifferentiable = All | DetachShape,
+
+    /* \brief Compute the position, geometric normal, UV coordinates and
+       position partials, but skip the construction of the shading frame.
+       Meant for queries that don't evaluate materials or emitters (e.g. depth
+       or AOV outputs), since the \c sh_frame and \c wi fields are left
+       undefined. */
+    Geometric = Minimal | UV | dPdUV,
 };
 
 MI_DECLARE_ENUM_OPERATORS(RayFlags)
@@ -309,8 +316,23 @@ struct SurfaceInteraction : Interaction<Float_, Spectrum_> {
      */
     BSDFPtr bsdf(const RayDifferential3f &ray);
 
-    // Returns the BSDF of the intersected shape
-    BSDFPtr bsdf() const { return shape->bsdf(); }
+    /**
+     * \brief Returns the BSDF of the intersected shape
+     *
+     * When the shape was hit through an instance that overrides the
+     * materials of its shape group, the BSDF of the instance is returned.
+     */
+    BSDFPtr bsdf() const {
+        BSDFPtr result = shape->bsdf();
+        if constexpr (dr::is_array_v<ShapePtr>) {
+            BSDFPtr override_ = instance->bsdf(dr::neq(instance, nullptr));
+            result = dr::select(dr::neq(override_, nullptr), override_, result);
+        } else {
+            if (instance && instance->bsdf())
+                result = instance->bsdf();
+        }
+        return result;
+    }
 
     /// Computes texture coordinate partials
     void compute_uv_partials(const RayDifferential3f &ray) {
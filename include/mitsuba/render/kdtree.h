@@ -2,12 +2,15 @@
 
 #include <unordered_set>
 #include <atomic>
+#include <chrono>
+#include <mutex>
 
 #include <nanothread/nanothread.h>
 #include <mitsuba/core/bbox.h>
 #include <mitsuba/core/fwd.h>
 #include <mitsuba/core/logger.h>
 #include <mitsuba/core/math.h>
+#include <mitsuba/core/mmap.h>
 #include <mitsuba/core/object.h>
 #include <mitsuba/core/ray.h>
 #include <mitsuba/core/timer.h>
@@ -15,6 +18,7 @@
 #include <mitsuba/core/vector.h>
 #include <mitsuba/render/interaction.h>
 #include <mitsuba/render/mesh.h>
+#include <mitsuba/render/raystats.h>
 
 /// Compile-time KD-tree depth limit to enable traversal with stack memory
 #define MI_KD_MAXDEPTH 48u
@@ -70,6 +74,7 @@ public:
             if (chunk.remainder() >= size) {
                 T* result = reinterpret_cast<T *>(chunk.cur);
                 chunk.cur += size;
+                m_peak = std::max(m_peak, used());
                 return result;
             }
         }
@@ -81,6 +86,10 @@ public:
         uint8_t *start = data.get(), *cur = start + size;
         m_chunks.emplace_back(std::move(data), cur, alloc_size);
 
+        if (m_counter)
+            *m_counter += alloc_size;
+        m_peak = std::max(m_peak, used());
+
         return reinterpret_cast<T *>(start);
     }
 
@@ -149,6 +158,23 @@ public:
         return result;
     }
 
+    /// Return the total amount of unused chunk memory in bytes
+    size_t remainder() const { return size() - used(); }
+
+    /// Return the peak amount of used memory in bytes since \ref reset_peak()
+    size_t peak() const { return m_peak; }
+
+    /// Reset the peak memory usage to the current usage
+    void reset_peak() { m_peak = used(); }
+
+    /**
+     * \brief Add the size of every chunk created from now on to \c counter
+     *
+     * This makes it possible to track the combined memory usage of the
+     * allocators of several threads. Pass \c nullptr to disable.
+     */
+    void set_counter(std::atomic<size_t> *counter) { m_counter = counter; }
+
     /// Return a string representation of the chunks
     friend std::ostream& operator<<(std::ostream &os, const OrderedChunkAllocator &o) {
         os << "OrderedChunkAllocator[" << std::endl;
@@ -182,6 +208,8 @@ private:
     };
 
     size_t m_min_allocation;
+    size_t m_peak = 0;
+    std::atomic<size_t> *m_counter = nullptr;
     std::vector<Chunk> m_chunks;
 };
 
@@ -303,6 +331,44 @@ private:
     std::atomic<uint64_t> m_size_and_capacity;
     std::atomic<Value *> m_slices[32] { };
 };
+
+/**
+ * \brief Header of a serialized acceleration data structure
+ *
+ * Cache files consist of this header, followed by <tt>node_count *
+ * node_size</tt> bytes of node data and <tt>index_count</tt> 32-bit
+ * primitive indices. The \c key field identifies the geometry and build
+ * parameters that produced the file (see \ref Scene).
+ */
+struct AccelCacheHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t key;
+    uint32_t node_size;
+    uint32_t node_count;
+    uint32_t index_count;
+    uint32_t padding;
+    double bbox_min[3];
+    double bbox_max[3];
+};
+
+/// Write an acceleration data structure to the given cache file
+extern MI_EXPORT_LIB void accel_cache_write(const fs::path &filename,
+                                            AccelCacheHeader header,
+                                            const void *nodes,
+                                            const void *indices);
+
+/**
+ * \brief Map a cache file written by \ref accel_cache_write()
+ *
+ * The \c key and \c node_size fields of \c header must be set by the
+ * caller. Returns \c nullptr when the file does not exist or does not match
+ * them; otherwise, the remaining header fields are filled in, and the node
+ * and index data can be found at \c node_data and \c index_data.
+ */
+extern MI_EXPORT_LIB ref<MemoryMappedFile>
+accel_cache_read(const fs::path &filename, AccelCacheHeader &header,
+                 const void *&node_data, const void *&index_data);
 NAMESPACE_END(detail)
 
 
@@ -458,6 +524,21 @@ public:
         m_exact_prim_threshold = value;
     }
 
+    /**
+     * \brief Return the memory budget (in bytes) for temporary data used by
+     * the O(n log n) builder (0 means unlimited)
+     */
+    size_t build_memory_budget() const { return m_build_memory_budget; }
+
+    /**
+     * \brief Specify the memory budget (in bytes) for temporary data used by
+     * the O(n log n) builder.
+     *
+     * Subtrees whose edge event lists would exceed the budget are built
+     * using Min-Max binning instead. A value of 0 disables the limit.
+     */
+    void set_build_memory_budget(size_t value) { m_build_memory_budget = value; }
+
     /// Return the log level of kd-tree status messages
     LogLevel log_level() const { return m_log_level; }
 
@@ -466,6 +547,11 @@ public:
 
     bool ready() const { return (bool) m_nodes; }
 
+    /// Return the memory used by the nodes and primitive indices (in bytes)
+    size_t memory_usage() const {
+        return m_node_count * sizeof(KDNode) + m_index_count * sizeof(Index);
+    }
+
     /// Return the bounding box of the entire kd-tree
     const BoundingBox bbox() const { return m_bbox; }
 
@@ -668,14 +754,18 @@ protected:
         ClassificationStorage classification_storage;
         detail::OrderedChunkAllocator left_alloc;
         detail::OrderedChunkAllocator right_alloc;
-        BuildContext *ctx = nullptr;
+        /// Identifier of the build that last used this context
+        uint64_t build_id = 0;
 
         ~LocalBuildContext() {
             Assert(left_alloc.used() == 0);
             Assert(right_alloc.used() == 0);
-            if (ctx)
-                ctx->temp_storage += left_alloc.size() + right_alloc.size() +
-                                     classification_storage.size();
+        }
+
+        /// Total amount of memory held by this context in bytes
+        size_t size() const {
+            return left_alloc.size() + right_alloc.size() +
+                   classification_storage.size();
         }
     };
 
@@ -698,10 +788,45 @@ protected:
         Size nonempty_leaf_count = 0;
         Size max_depth = 0;
         Size prim_buckets[16] { };
-
-        BuildContext(const Derived &derived) : derived(derived) { }
+        /* Per-level statistics of the min-max binning phase (accumulated
+           wall-clock time in nanoseconds over all nodes of a level) */
+        std::atomic<uint64_t> level_binning_time[MI_KD_MAXDEPTH + 1] { };
+        std::atomic<uint64_t> level_partition_time[MI_KD_MAXDEPTH + 1] { };
+        std::atomic<uint32_t> level_node_count[MI_KD_MAXDEPTH + 1] { };
+        std::atomic<uint64_t> nlogn_time {0};
+        /* Thread-local contexts participating in the build, and the combined
+           size of their allocations (checked against the memory budget) */
+        uint64_t build_id;
+        std::mutex locals_mutex;
+        std::vector<LocalBuildContext *> locals;
+        std::atomic<size_t> scratch_usage {0};
+        std::atomic<size_t> budget_fallbacks {0};
+
+        BuildContext(const Derived &derived) : derived(derived) {
+            static std::atomic<uint64_t> build_counter {0};
+            build_id = ++build_counter;
+        }
     };
 
+    /**
+     * \brief Grain size for parallel loops over the primitives of a node
+     *
+     * Large nodes near the root are split into enough pieces to occupy the
+     * whole thread pool, while smaller ones use \ref MI_KD_GRAIN_SIZE to
+     * keep the scheduling overhead low.
+     */
+    static Size grain_size(Size prim_count) {
+        Size threads = std::max((Size) pool_size(), (Size) 1);
+        return std::max(std::min(prim_count / (4 * threads), (Size) MI_KD_GRAIN_SIZE),
+                        (Size) 1024);
+    }
+
+    /// Nanoseconds elapsed since \c start
+    static uint64_t elapsed_ns(std::chrono::steady_clock::time_point start) {
+        return (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+    }
+
     /// Data type for split candidates suggested by the tree cost model
     struct SplitCandidate {
         Scalar cost = dr::Infinity<Scalar>;
@@ -989,7 +1114,8 @@ protected:
             BoundingBox left_bounds, right_bounds;
 
             dr::parallel_for(
-                dr::blocked_range<Size>(0u, Size(indices.size()), MI_KD_GRAIN_SIZE),
+                dr::blocked_range<Size>(0u, Size(indices.size()),
+                                        grain_size(Size(indices.size()))),
                 [&](const dr::blocked_range<Index> &range) {
                     IndexVector left_indices_local, right_indices_local;
                     BoundingBox left_bounds_local, right_bounds_local;
@@ -1136,19 +1262,28 @@ protected:
             }
 
             if (prim_count <= derived.exact_primitive_threshold()) {
-                *m_cost = transition_to_nlogn();
-                return;
+                if (nlogn_fits_budget(prim_count)) {
+                    auto nlogn_start = std::chrono::steady_clock::now();
+                    *m_cost = transition_to_nlogn();
+                    m_ctx.nlogn_time += elapsed_ns(nlogn_start);
+                    return;
+                }
+
+                // Not enough memory left, continue with min-max binning
+                m_ctx.budget_fallbacks++;
             }
 
             /* ==================================================================== */
             /*                              Binning                                 */
             /* ==================================================================== */
 
-            /* Accumulate all shapes into bins */
+            auto binning_start = std::chrono::steady_clock::now();
+
+            /* Accumulate all shapes into per-thread bins, and reduce them */
             MinMaxBins bins(derived.min_max_bins(), m_tight_bbox);
             std::mutex bins_mutex;
             dr::parallel_for(
-                dr::blocked_range<Size>(0u, prim_count, MI_KD_GRAIN_SIZE),
+                dr::blocked_range<Size>(0u, prim_count, grain_size(prim_count)),
                 [&](const dr::blocked_range<Index> &range) {
                     MinMaxBins bins_local(derived.min_max_bins(), m_tight_bbox);
                     for (Index i = range.begin(); i != range.end(); ++i)
@@ -1166,6 +1301,9 @@ protected:
             model.set_bounding_box(m_bbox);
             auto best = bins.best_candidate(prim_count, model);
 
+            m_ctx.level_binning_time[m_depth] += elapsed_ns(binning_start);
+            m_ctx.level_node_count[m_depth]++;
+
             Assert(dr::isfinite(best.cost));
             Assert(best.split >= m_bbox.min[best.axis]);
             Assert(best.split <= m_bbox.max[best.axis]);
@@ -1186,11 +1324,15 @@ protected:
             /*                            Partitioning                              */
             /* ==================================================================== */
 
+            auto partition_start = std::chrono::steady_clock::now();
+
             auto partition = bins.partition(derived, m_indices, best);
 
             /* Release index list */
             IndexVector().swap(m_indices);
 
+            m_ctx.level_partition_time[m_depth] += elapsed_ns(partition_start);
+
             /* ==================================================================== */
             /*                              Recursion                               */
             /* ==================================================================== */
@@ -1680,10 +1822,55 @@ protected:
             return final_cost;
         }
 
+        /**
+         * \brief Check whether the O(N log N) builder can process a node with
+         * \c prim_count primitives without exceeding the memory budget
+         *
+         * The event lists of the node and of the children along the current
+         * recursion path take up to roughly three times the size of the
+         * initial list. The check is approximate since other threads may
+         * allocate concurrently.
+         */
+        bool nlogn_fits_budget(Size prim_count) const {
+            size_t budget = m_ctx.derived.build_memory_budget();
+            if (budget == 0)
+                return true;
+
+            size_t required =
+                3 * (size_t) prim_count * 2 * Dimension * sizeof(EdgeEvent),
+                   available = m_local.left_alloc.remainder() +
+                               m_local.right_alloc.remainder(),
+                   new_bytes = required > available ? required - available : 0;
+
+            // Memory of this thread that isn't accounted for yet
+            if (m_local.build_id != m_ctx.build_id)
+                new_bytes += m_local.left_alloc.size() + m_local.right_alloc.size() +
+                             (m_ctx.derived.primitive_count() + 3) / 4;
+
+            return m_ctx.scratch_usage + new_bytes <= budget;
+        }
+
+        /// Associate the thread-local build context with the current build
+        void register_local() {
+            if (m_local.build_id == m_ctx.build_id)
+                return;
+
+            m_local.build_id = m_ctx.build_id;
+            m_local.classification_storage.resize(m_ctx.derived.primitive_count());
+            m_local.left_alloc.reset_peak();
+            m_local.right_alloc.reset_peak();
+            m_local.left_alloc.set_counter(&m_ctx.scratch_usage);
+            m_local.right_alloc.set_counter(&m_ctx.scratch_usage);
+            m_ctx.scratch_usage += m_local.size();
+
+            std::lock_guard<std::mutex> guard(m_ctx.locals_mutex);
+            m_ctx.locals.push_back(&m_local);
+        }
+
         /// Create an initial sorted edge event list and start the O(N log N) builder
         Scalar transition_to_nlogn() {
             const auto &derived = m_ctx.derived;
-            // m_local = &m_ctx.local; // TODO remove this
+            register_local();
 
             Size prim_count = Size(m_indices.size()), final_prim_count = prim_count;
 
@@ -1732,8 +1919,6 @@ protected:
 
             m_local.left_alloc.template shrink_allocation<EdgeEvent>(
                 events_start, events_end - events_start);
-            m_local.classification_storage.resize(derived.primitive_count());
-            m_local.ctx = &m_ctx;
 
             Scalar cost = build_nlogn(m_node, final_prim_count, events_start,
                                       events_end, m_bbox, m_depth, 0);
@@ -1883,14 +2068,27 @@ protected:
                 util::mem_string(prim_count * sizeof(Index)).c_str());
 
             IndexVector indices(prim_count);
-            for (size_t i = 0; i < prim_count; ++i)
-                indices[i] = (Index) i;
+            dr::parallel_for(
+                dr::blocked_range<Size>(0u, prim_count, grain_size(prim_count)),
+                [&](const dr::blocked_range<Size> &range) {
+                    for (Size i = range.begin(); i != range.end(); ++i)
+                        indices[i] = (Index) i;
+                }
+            );
 
             BuildTask task = BuildTask(ctx, 0, std::move(indices), m_bbox,
                                        m_bbox, 0, 0, &final_cost);
             task.execute();
         }
 
+        /* Detach the thread-local contexts from this build. Their memory is
+           retained and reused by subsequent builds on the same thread. */
+        for (LocalBuildContext *local : ctx.locals) {
+            local->left_alloc.set_counter(nullptr);
+            local->right_alloc.set_counter(nullptr);
+            ctx.temp_storage += local->size();
+        }
+
         Log(m_log_level, "Structural kd-tree statistics:");
 
         /* ==================================================================== */
@@ -1991,6 +2189,37 @@ protected:
             Log(m_log_level, "   Final cost                  : %.2f",
                 final_cost);
             Log(m_log_level, "");
+
+            Log(m_log_level, "Build timings (accumulated over all nodes of a level):");
+            for (Size i = 0; i <= MI_KD_MAXDEPTH; ++i) {
+                uint32_t node_count = ctx.level_node_count[i];
+                if (node_count == 0)
+                    continue;
+                Log(m_log_level, "   Level %2i (%6i nodes)     : binning %s, partitioning %s",
+                    i, node_count,
+                    util::time_string(ctx.level_binning_time[i] * 1e-6f, true),
+                    util::time_string(ctx.level_partition_time[i] * 1e-6f, true));
+            }
+            Log(m_log_level, "   O(n log n) subtrees         : %s",
+                util::time_string(ctx.nlogn_time * 1e-6f, true));
+            Log(m_log_level, "");
+
+            Log(m_log_level, "Build memory (O(n log n) scratch space per thread):");
+            for (size_t i = 0; i < ctx.locals.size(); ++i) {
+                const LocalBuildContext *local = ctx.locals[i];
+                Log(m_log_level, "   Thread %3i                  : peak %s, reserved %s",
+                    i,
+                    util::mem_string(local->left_alloc.peak() +
+                                     local->right_alloc.peak() +
+                                     local->classification_storage.size()),
+                    util::mem_string(local->size()));
+            }
+            if (m_build_memory_budget > 0)
+                Log(m_log_level, "   Budget                      : %s (%i nodes "
+                    "fell back to min-max binning)",
+                    util::mem_string(m_build_memory_budget),
+                    ctx.budget_fallbacks);
+            Log(m_log_level, "");
         }
     }
 
@@ -2007,6 +2236,7 @@ protected:
     Size m_stop_primitives = 3;
     Size m_max_bad_refines = 0;
     Size m_exact_prim_threshold = 65536;
+    size_t m_build_memory_budget = 0;
     Size m_min_max_bins = 128;
     LogLevel m_log_level = Debug;
     BoundingBox m_bbox;
@@ -2137,6 +2367,7 @@ public:
     using Base::ready;
     using Base::set_clip_primitives;
     using Base::set_exact_primitive_threshold;
+    using Base::set_build_memory_budget;
     using Base::set_max_depth;
     using Base::set_min_max_bins;
     using Base::set_retract_bad_splits;
@@ -2160,6 +2391,18 @@ public:
     /// Build the kd-tree
     void build();
 
+    /**
+     * \brief Load a kd-tree that was previously saved via \ref write_cache()
+     *
+     * Shapes must be registered beforehand. Returns \c false (and leaves the
+     * kd-tree untouched) when the file does not exist or was created for a
+     * different \c key.
+     */
+    bool read_cache(const fs::path &filename, uint64_t key);
+
+    /// Save the kd-tree to a cache file identified by \c key
+    void write_cache(const fs::path &filename, uint64_t key) const;
+
     /// Return the number of registered shapes
     Size shape_count() const { return Size(m_shapes.size()); }
 
@@ -2197,6 +2440,13 @@ public:
     template <bool ShadowRay>
     MI_INLINE PreliminaryIntersection<ScalarFloat, Shape>
     ray_intersect_scalar(ScalarRay3f ray) const {
+        if constexpr (ShadowRay) {
+            PreliminaryIntersection<ScalarFloat, Shape> pi;
+            if (ray_test_scalar(ray))
+                pi.t = 0.f;
+            return pi;
+        }
+
         /// Ray traversal stack entry
         struct KDStackEntry {
             // Ray distance associated with the node entry and exit point
@@ -2211,6 +2461,7 @@ public:
 
         // Resulting intersection struct
         PreliminaryIntersection<ScalarFloat, Shape> pi;
+        MI_RAY_STAT_SCOPE();
 
         // Intersect against the scene bounding box
         auto bbox_result = m_bbox.ray_intersect(ray);
@@ -2222,6 +2473,7 @@ public:
 
         const KDNode *node = m_nodes.get();
         while (mint <= maxt) {
+            MI_RAY_STAT_NODE();
             if (likely(!node->leaf())) { // Inner node
                 const ScalarFloat split = node->split();
                 const uint32_t axis     = node->axis();
@@ -2263,6 +2515,7 @@ public:
                 Index prim_end = prim_start + node->primitive_count();
                 for (Index i = prim_start; i < prim_end; i++) {
                     Index prim_index = m_indices[i];
+                    MI_RAY_STAT_PRIM();
 
                     PreliminaryIntersection<ScalarFloat, Shape> prim_pi =
                         intersect_prim<ShadowRay>(prim_index, ray);
@@ -2292,113 +2545,251 @@ public:
         return pi;
     }
 
-#if 0
-    template <bool ShadowRay>
-    MI_INLINE PreliminaryIntersection3f ray_intersect_packet(Ray3f ray,
-                                                              Mask active) const {
+    /**
+     * \brief Specialized traversal routine for shadow rays
+     *
+     * Returns \c true as soon as any primitive blocks the ray segment. Since
+     * the closest intersection doesn't matter, the traversal neither
+     * shortens the ray nor computes intersection details. When both children
+     * of a node overlap the segment, the one covering the longer part of it
+     * is visited first, as it is more likely to contain an occluder.
+     */
+    MI_INLINE bool ray_test_scalar(const ScalarRay3f &ray) const {
         /// Ray traversal stack entry
         struct KDStackEntry {
             // Ray distance associated with the node entry and exit point
-            Float mint, maxt;
-            // Is the corresponding SIMD lane enabled?
-            Mask active;
-            // Pointer to the far child
+            ScalarFloat mint, maxt;
+            // Pointer to the postponed child
             const KDNode *node;
         };
 
         // Allocate the node stack
         KDStackEntry stack[MI_KD_MAXDEPTH];
         int32_t stack_index = 0;
+        MI_RAY_STAT_SCOPE();
 
-        // Resulting intersection struct
-        PreliminaryIntersection3f pi = dr::zeros<PreliminaryIntersection3f>();
+        // Intersect against the scene bounding box
+        auto bbox_result = m_bbox.ray_intersect(ray);
+
+        ScalarFloat mint = std::max(ScalarFloat(0), std::get<1>(bbox_result)),
+                    maxt = std::min(ray.maxt, std::get<2>(bbox_result));
+
+        ScalarVector3f d_rcp = dr::rcp(ray.d);
 
         const KDNode *node = m_nodes.get();
+        while (mint <= maxt) {
+            MI_RAY_STAT_NODE();
+            if (likely(!node->leaf())) { // Inner node
+                const ScalarFloat split = node->split();
+                const uint32_t axis     = node->axis();
 
-        /* Intersect against the scene bounding box */
-        auto bbox_result = m_bbox.ray_intersect(ray);
-        Float mint = dr::maximum(ray.mint, std::get<1>(bbox_result));
-        Float maxt = dr::minimum(ray.maxt, std::get<2>(bbox_result));
+                /* Compute parametric distance along the rays to the split plane */
+                ScalarFloat t_plane = (split - ray.o[axis]) * d_rcp[axis];
+
+                bool left_first  = (ray.o[axis] < split) ||
+                                   (ray.o[axis] == split && ray.d[axis] >= 0.f),
+                     start_after = t_plane<mint, end_before = t_plane> maxt ||
+                                   t_plane < 0.f || !dr::isfinite(t_plane),
+                     single_node = start_after || end_before;
+
+                /* If we only need to visit one node, just pick the correct one and continue */
+                if (likely(single_node)) {
+                    bool visit_left = end_before == left_first;
+                    node = node->left() + (visit_left ? 0 : 1);
+                    continue;
+                }
+
+                /* Visit the child covering the longer part of the segment first */
+                Index node_offset = left_first ? 0 : 1;
+                const KDNode *left  = node->left(),
+                             *n_near = left + node_offset,
+                             *n_far  = left + (1 - node_offset);
+
+                KDStackEntry& entry = stack[stack_index++];
+                if (t_plane - mint >= maxt - t_plane) {
+                    entry = { t_plane, maxt, n_far };
+                    node = n_near;
+                    maxt = t_plane;
+                } else {
+                    entry = { mint, t_plane, n_near };
+                    node = n_far;
+                    mint = t_plane;
+                }
+                continue;
+            } else if (node->primitive_count() > 0) { // Arrived at a leaf node
+                Index prim_start = node->primitive_offset();
+                Index prim_end = prim_start + node->primitive_count();
+                for (Index i = prim_start; i < prim_end; i++) {
+                    MI_RAY_STAT_PRIM();
+                    if (unlikely(occluded_prim(m_indices[i], ray)))
+                        return true;
+                }
+            }
+
+            if (likely(stack_index > 0)) {
+                --stack_index;
+                KDStackEntry& entry = stack[stack_index];
+                mint = entry.mint;
+                maxt = entry.maxt;
+                node = entry.node;
+            } else {
+                break;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * \brief Traverse the kd-tree with a packet of \c Width rays
+     *
+     * Inner nodes are processed for all rays of the packet at once using
+     * SIMD arithmetic. When the rays disagree about which child to visit
+     * first, the packet follows the majority and postpones the other child
+     * along with the mask of rays that still need to visit it. Leaf
+     * primitives are only tested against the rays that are still active.
+     *
+     * Lanes with <tt>valid[i] == false</tt> are ignored. The closest
+     * intersection of each lane is written to \c pi (for shadow rays,
+     * <tt>pi[i].t</tt> is set to zero when the ray is occluded), and the
+     * \c maxt field of \c rays is shortened accordingly.
+     */
+    template <bool ShadowRay, size_t Width>
+    MI_INLINE void ray_intersect_packet(ScalarRay3f *rays, const bool *valid,
+                                        PreliminaryIntersection<ScalarFloat, Shape> *pi) const {
+        using FloatP = dr::Packet<ScalarFloat, Width>;
+        using MaskP  = dr::mask_t<FloatP>;
+
+        /// Ray traversal stack entry
+        struct KDStackEntry {
+            // Ray distances associated with the node entry and exit point
+            FloatP mint, maxt;
+            // Lanes that need to visit the node
+            MaskP active;
+            // Pointer to the postponed child
+            const KDNode *node;
+        };
+
+        // Allocate the node stack
+        KDStackEntry stack[MI_KD_MAXDEPTH];
+        int32_t stack_index = 0;
+
+        /* Convert the rays into SoA layout and intersect them against the
+           scene bounding box. Invalid lanes keep an empty interval. */
+        FloatP o[3] = { 0.f, 0.f, 0.f }, d[3] = { 1.f, 1.f, 1.f },
+               d_rcp[3] = { 1.f, 1.f, 1.f },
+               mint(dr::Infinity<ScalarFloat>), maxt(0.f), ray_maxt(0.f);
+        for (size_t i = 0; i < Width; ++i) {
+            if (!valid[i])
+                continue;
+
+            const ScalarRay3f &ray = rays[i];
+            auto bbox_result = m_bbox.ray_intersect(ray);
+            ScalarVector3f ray_d_rcp = dr::rcp(ray.d);
+
+            for (size_t axis = 0; axis < 3; ++axis) {
+                o[axis].entry(i)     = ray.o[axis];
+                d[axis].entry(i)     = ray.d[axis];
+                d_rcp[axis].entry(i) = ray_d_rcp[axis];
+            }
+
+            mint.entry(i)     = std::max(ScalarFloat(0), std::get<1>(bbox_result));
+            maxt.entry(i)     = std::min(ray.maxt, std::get<2>(bbox_result));
+            ray_maxt.entry(i) = ray.maxt;
+        }
+
+        MaskP active = maxt >= mint;
+        const KDNode *node = m_nodes.get();
 
         while (true) {
-            active = active && (maxt >= mint);
-            if (ShadowRay)
-                active = active && !pi.is_valid();
+            active = active && maxt >= mint;
 
             if (likely(dr::any(active))) {
                 if (likely(!node->leaf())) { // Inner node
-                    const dr::scalar_t<Float> split = node->split();
-                    const uint32_t axis = node->axis();
-
-                    // Compute parametric distance along the rays to the split plane
-                    Float t_plane          = (split - ray.o[axis]) * ray.d_rcp[axis];
-                    Mask left_first        = (ray.o[axis] < split) ||
-                                              (dr::eq(ray.o[axis], split) && ray.d[axis] >= 0.f),
-                         start_after       = t_plane < mint,
-                         end_before        = t_plane > maxt || t_plane < 0.f || !dr::isfinite(t_plane),
-                         single_node       = start_after || end_before,
-                         visit_left        = dr::eq(end_before, left_first),
-                         visit_only_left   = single_node &&  visit_left,
-                         visit_only_right  = single_node && !visit_left;
-
-                    bool all_visit_only_left  = dr::all(visit_only_left || !active),
-                         all_visit_only_right = dr::all(visit_only_right || !active),
-                         all_visit_same_node  = all_visit_only_left || all_visit_only_right;
-
-                    /* If we only need to visit one node, just pick the correct one and continue */
-                    if (all_visit_same_node) {
-                        node = node->left() + (all_visit_only_left ? 0 : 1);
+                    const ScalarFloat split = node->split();
+                    const uint32_t axis     = node->axis();
+
+                    /* Compute parametric distance along the rays to the split plane */
+                    FloatP t_plane = (split - o[axis]) * d_rcp[axis];
+
+                    MaskP left_first  = (o[axis] < split) ||
+                                        (dr::eq(o[axis], split) && d[axis] >= 0.f),
+                          start_after = t_plane < mint,
+                          end_before  = t_plane > maxt || t_plane < 0.f ||
+                                        !dr::isfinite(t_plane),
+                          single_node = start_after || end_before,
+                          visit_left  = dr::eq(end_before, left_first);
+
+                    /* If all rays only need to visit the same child, pick it and continue */
+                    if (dr::all((single_node && visit_left) || !active)) {
+                        node = node->left();
+                        continue;
+                    } else if (dr::all((single_node && !visit_left) || !active)) {
+                        node = node->left() + 1;
                         continue;
                     }
 
-                    size_t left_votes  = count(left_first && active),
-                           right_votes = count(!left_first && active);
-
-                    bool go_left = left_votes >= right_votes;
+                    /* Visit the child preferred by the majority of rays first */
+                    bool go_left = 2 * dr::count(left_first && active) >= dr::count(active);
 
-                    Mask go_left_bcast = Mask(go_left),
-                         correct_order = dr::eq(left_first, go_left_bcast),
-                         visit_both    = !single_node,
-                         visit_cur     = visit_both || eq (visit_left, go_left_bcast),
-                         visit_next    = visit_both || dr::neq(visit_left, go_left_bcast);
+                    MaskP go_left_p(go_left),
+                          visit_both    = !single_node,
+                          correct_order = visit_both && dr::eq(left_first, go_left_p),
+                          wrong_order   = visit_both && dr::neq(left_first, go_left_p),
+                          visit_cur     = visit_both || dr::eq(visit_left, go_left_p),
+                          visit_next    = visit_both || dr::neq(visit_left, go_left_p);
 
-                    /* Visit both child nodes in the right order */
                     Index node_offset = go_left ? 0 : 1;
                     const KDNode *left   = node->left(),
                                  *n_cur  = left + node_offset,
                                  *n_next = left + (1 - node_offset);
 
                     /* Postpone visit to 'n_next' */
-                    Mask sel0 =  correct_order && visit_both,
-                         sel1 = !correct_order && visit_both;
-                    KDStackEntry& entry = stack[stack_index++];
-                    entry.mint = dr::select(sel0, t_plane, mint);
-                    entry.maxt = dr::select(sel1, t_plane, maxt);
-                    entry.active = active && visit_next;
-                    entry.node = n_next;
+                    MaskP next_active = active && visit_next;
+                    if (dr::any(next_active)) {
+                        KDStackEntry& entry = stack[stack_index++];
+                        entry.mint   = dr::select(correct_order, t_plane, mint);
+                        entry.maxt   = dr::select(wrong_order, t_plane, maxt);
+                        entry.active = next_active;
+                        entry.node   = n_next;
+                    }
 
                     /* Visit 'n_cur' now */
-                    mint = dr::select(sel1, t_plane, mint);
-                    maxt = dr::select(sel0, t_plane, maxt);
+                    mint   = dr::select(wrong_order, t_plane, mint);
+                    maxt   = dr::select(correct_order, t_plane, maxt);
                     active = active && visit_cur;
-                    node = n_cur;
+                    node   = n_cur;
                     continue;
                 } else if (node->primitive_count() > 0) { // Arrived at a leaf node
                     Index prim_start = node->primitive_offset();
                     Index prim_end = prim_start + node->primitive_count();
-                    for (Index i = prim_start; i < prim_end; i++) {
-                        Index prim_index = m_indices[i];
 
-                        PreliminaryIntersection3f prim_pi =
-                            intersect_prim<ShadowRay>(prim_index, ray, active);
+                    for (size_t j = 0; j < Width; ++j) {
+                        if (!active.entry(j))
+                            continue;
+                        ScalarRay3f &ray = rays[j];
 
-                        dr::masked(pi, prim_pi.is_valid()) = prim_pi;
+                        for (Index i = prim_start; i < prim_end; i++) {
+                            Index prim_index = m_indices[i];
 
-                        if constexpr (!ShadowRay) {
-                            Assert(dr::all(!prim_pi.is_valid() ||
-                                       (prim_pi.t >= ray.mint &&
-                                        prim_pi.t <= ray.maxt)));
-                            dr::masked(ray.maxt, prim_pi.is_valid()) = prim_pi.t;
+                            if constexpr (ShadowRay) {
+                                if (unlikely(occluded_prim(prim_index, ray))) {
+                                    // Disable the lane for the rest of the traversal
+                                    pi[j].t = 0.f;
+                                    ray_maxt.entry(j) = -1.f;
+                                    break;
+                                }
+                            } else {
+                                PreliminaryIntersection<ScalarFloat, Shape> prim_pi =
+                                    intersect_prim<false>(prim_index, ray);
+
+                                if (unlikely(prim_pi.is_valid())) {
+                                    Assert(prim_pi.t >= 0.f && prim_pi.t <= ray.maxt);
+                                    pi[j] = prim_pi;
+                                    ray.maxt = prim_pi.t;
+                                    ray_maxt.entry(j) = prim_pi.t;
+                                }
+                            }
                         }
                     }
                 }
@@ -2407,18 +2798,15 @@ public:
             if (likely(stack_index > 0)) {
                 --stack_index;
                 KDStackEntry& entry = stack[stack_index];
-                mint = entry.mint;
-                maxt = dr::minimum(entry.maxt, ray.maxt);
+                mint   = entry.mint;
+                maxt   = dr::minimum(entry.maxt, ray_maxt);
                 active = entry.active;
-                node = entry.node;
+                node   = entry.node;
             } else {
                 break;
             }
         }
-
-        return pi;
     }
-#endif
 
     /// Brute force intersection routine for debugging purposes
     template <bool ShadowRay>
@@ -2499,7 +2887,7 @@ protected:
             if (shape->is_mesh())
                 hit = mesh->ray_intersect_triangle_scalar(prim_index, ray).first != dr::Infinity<ScalarFloat>;
             else
-                hit = shape->ray_test_scalar(ray);
+                hit = shape->ray_test_primitive_scalar(prim_index, ray);
             pi.t = dr::select(hit, 0.f , pi.t);
         } else {
             uint32_t inst_index = (uint32_t) -1;
@@ -2507,7 +2895,7 @@ protected:
                 std::tie(pi.t, pi.prim_uv) = mesh->ray_intersect_triangle_scalar(prim_index, ray);
             else
                 std::tie(pi.t, pi.prim_uv, inst_index, prim_index) =
-                    shape->ray_intersect_preliminary_scalar(ray);
+                    shape->ray_intersect_primitive_scalar(prim_index, ray);
             pi.prim_index = prim_index;
 
             bool hit_inst  = (inst_index != (uint32_t) -1);
@@ -2519,6 +2907,17 @@ protected:
         return pi;
     }
 
+    /// Check whether a primitive blocks the given shadow ray
+    MI_INLINE bool occluded_prim(Index prim_index, const ScalarRay3f &ray) const {
+        Index shape_index  = find_shape(prim_index);
+        const Shape *shape = this->shape(shape_index);
+
+        if (shape->is_mesh())
+            return ((const Mesh *) shape)->ray_test_triangle_scalar(prim_index, ray);
+        else
+            return shape->ray_test_primitive_scalar(prim_index, ray);
+    }
+
 protected:
     std::vector<ref<Shape>> m_shapes;
     std::vector<Size> m_primitive_map;
@@ -0,0 +1,365 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include <mitsuba/core/bbox.h>
+#include <mitsuba/core/fwd.h>
+#include <mitsuba/core/logger.h>
+#include <mitsuba/core/math.h>
+#include <mitsuba/render/emitter.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**
+ * \brief Bounding volume hierarchy over the emitters of a scene that is used
+ * to select an emitter with a probability proportional to an estimate of its
+ * contribution at a given reference point
+ *
+ * Every node stores the bounding box, power and a cone of emission directions
+ * ("orientation bounds") of the emitters below it. The traversal descends the
+ * tree stochastically, choosing each child with a probability proportional to
+ * the importance bound of "Importance Sampling of Many Lights with Adaptive
+ * Tree Splitting" by A. Conty Estevez and C. Kulla. The probability of a
+ * particular emitter can be recomputed in \ref pmf() by walking up the tree
+ * from its leaf, which makes the tree usable for multiple importance sampling.
+ *
+ * Emitters that don't provide bounds (see \ref Emitter::light_bounds(), e.g.
+ * environment or directional emitters) are kept in a separate list. The tree
+ * as a whole is chosen like one additional emitter of that list.
+ *
+ * In the \c culling_only mode, the bounds are only used to discard emitters
+ * that can't illuminate the reference point (e.g. spot lights facing away).
+ * The remaining emitters are chosen with the same probability as with
+ * uniform emitter sampling, and the tree receives a share of the samples
+ * that is proportional to the number of emitters it contains.
+ *
+ * The tree is built once on the host. Its nodes are then stored in flat
+ * arrays so that traversal can use gathers in all variants. Since JIT
+ * variants can't stop at different depths per lane, traversal always runs for
+ * \ref height() iterations and masks lanes that already reached a leaf.
+ */
+template <typename Float, typename Spectrum>
+class LightTree {
+public:
+    MI_IMPORT_TYPES(Emitter)
+
+    using FloatStorage  = DynamicBuffer<Float>;
+    using UInt32Storage = DynamicBuffer<UInt32>;
+    using LightBounds   = typename Emitter::LightBounds;
+
+    /// Build a light tree over the given emitters (indexed by their position)
+    LightTree(const std::vector<ref<Emitter>> &emitters,
+              bool culling_only = false)
+        : m_culling_only(culling_only) {
+        std::vector<Primitive> prims;
+        std::vector<uint32_t> others;
+        std::vector<uint32_t> leaf_of(emitters.size(), (uint32_t) -1);
+
+        for (uint32_t i = 0; i < (uint32_t) emitters.size(); ++i) {
+            LightBounds lb = emitters[i]->light_bounds();
+            if (lb.power < 0.f || !lb.bbox.valid()) {
+                others.push_back(i);
+                continue;
+            }
+            if (culling_only)
+                lb.power = emitters[i]->sampling_weight();
+            else
+                lb.power *= emitters[i]->sampling_weight();
+            prims.push_back({ lb, lb.bbox.center(), i });
+        }
+
+        m_tree_size  = (uint32_t) prims.size();
+        m_other_size = (uint32_t) others.size();
+        if (m_tree_size == 0)
+            m_tree_prob = 0.f;
+        else if (culling_only)
+            m_tree_prob = m_tree_size / ScalarFloat(m_tree_size + m_other_size);
+        else
+            m_tree_prob = 1.f / (m_other_size + 1.f);
+        m_height     = 0;
+
+        if (m_tree_size > 0) {
+            m_nodes.reserve(2 * prims.size() - 1);
+            m_parents.reserve(2 * prims.size() - 1);
+            build(prims, 0, (uint32_t) prims.size(), (uint32_t) 0, 0);
+        }
+
+        uint32_t node_count = (uint32_t) m_nodes.size();
+        std::vector<ScalarFloat> bbox(6 * node_count), axis(3 * node_count),
+                                 params(3 * node_count);
+        std::vector<uint32_t> children(2 * node_count);
+
+        for (uint32_t k = 0; k < node_count; ++k) {
+            const Node &n = m_nodes[k];
+            for (size_t j = 0; j < 3; ++j) {
+                bbox[6 * k + j]     = n.bounds.bbox.min[j];
+                bbox[6 * k + 3 + j] = n.bounds.bbox.max[j];
+                axis[3 * k + j]     = n.bounds.axis[j];
+            }
+            params[3 * k + 0] = n.bounds.power;
+            params[3 * k + 1] = n.bounds.theta_o;
+            params[3 * k + 2] = n.bounds.theta_e;
+            // Leaves store the emitter index, internal nodes their children
+            children[2 * k + 0] = n.leaf ? n.emitter : n.left;
+            children[2 * k + 1] = n.leaf ? 0u : n.right;
+            if (n.leaf)
+                leaf_of[n.emitter] = k;
+        }
+
+        m_bbox     = dr::load<FloatStorage>(bbox.data(), bbox.size());
+        m_axis     = dr::load<FloatStorage>(axis.data(), axis.size());
+        m_params   = dr::load<FloatStorage>(params.data(), params.size());
+        m_children = dr::load<UInt32Storage>(children.data(), children.size());
+        m_parent   = dr::load<UInt32Storage>(m_parents.data(), m_parents.size());
+        m_leaf_of  = dr::load<UInt32Storage>(leaf_of.data(), leaf_of.size());
+        m_others   = dr::load<UInt32Storage>(others.data(), others.size());
+
+        Log(Debug, "Light tree: %u emitters in %u nodes (height %u), %u "
+                   "emitters sampled uniformly.",
+            m_tree_size, node_count, m_height, m_other_size);
+
+        m_nodes.clear();
+        m_nodes.shrink_to_fit();
+        m_parents.clear();
+        m_parents.shrink_to_fit();
+    }
+
+    /// Number of emitters stored in the tree
+    uint32_t tree_size() const { return m_tree_size; }
+
+    /// Number of edges on the longest path from the root to a leaf
+    uint32_t height() const { return m_height; }
+
+    /**
+     * \brief Sample an emitter for the reference point \c p
+     *
+     * Returns the emitter index, its probability and the reused sample.
+     */
+    std::tuple<UInt32, Float, Float> sample(const Point3f &p, Float sample,
+                                            Mask active) const {
+        UInt32 index = 0;
+        Float pmf = 0.f;
+
+        Mask in_tree = active && sample < m_tree_prob;
+
+        if (m_other_size > 0) {
+            Mask other = active && !in_tree;
+            Float u = dr::select(other, (sample - m_tree_prob) /
+                                            (1.f - m_tree_prob), 0.f);
+            Float u_scaled = u * (ScalarFloat) m_other_size;
+            UInt32 offset = dr::minimum(UInt32(u_scaled), m_other_size - 1u);
+            dr::masked(index, other) =
+                dr::gather<UInt32>(m_others, offset, other);
+            dr::masked(pmf, other) = (1.f - m_tree_prob) / m_other_size;
+            dr::masked(sample, other) = u_scaled - Float(offset);
+        }
+
+        if (m_tree_size > 0) {
+            dr::masked(sample, in_tree) = sample / m_tree_prob;
+            dr::masked(pmf, in_tree) = m_tree_prob;
+
+            UInt32 node = 0;
+            for (uint32_t i = 0; i < m_height; ++i) {
+                Vector2u child = dr::gather<Vector2u>(m_children, node, in_tree);
+                Mask internal = in_tree && dr::neq(child.y(), 0u);
+                if (dr::none_or<false>(internal))
+                    break;
+
+                Float p_left = left_probability(p, child, internal);
+                Mask left = sample < p_left;
+                Float p_child = dr::select(left, p_left, 1.f - p_left);
+
+                dr::masked(sample, internal) = dr::minimum(
+                    (sample - dr::select(left, 0.f, p_left)) / p_child,
+                    dr::OneMinusEpsilon<Float>);
+                dr::masked(pmf, internal) *= p_child;
+                dr::masked(node, internal) = dr::select(left, child.x(), child.y());
+            }
+
+            dr::masked(index, in_tree) =
+                dr::gather<UInt32>(m_children, 2u * node, in_tree);
+        }
+
+        return { index, pmf, sample };
+    }
+
+    /// Evaluate the probability of \ref sample() choosing \c emitter_index
+    Float pmf(const Point3f &p, UInt32 emitter_index, Mask active) const {
+        UInt32 node = dr::gather<UInt32>(m_leaf_of, emitter_index, active);
+        Mask in_tree = active && dr::neq(node, (uint32_t) -1);
+
+        Float pmf = 0.f;
+        if (m_other_size > 0)
+            dr::masked(pmf, active && !in_tree) =
+                (1.f - m_tree_prob) / m_other_size;
+
+        if (m_tree_size > 0) {
+            dr::masked(pmf, in_tree) = m_tree_prob;
+
+            for (uint32_t i = 0; i < m_height; ++i) {
+                Mask valid = in_tree && dr::neq(node, 0u);
+                if (dr::none_or<false>(valid))
+                    break;
+
+                UInt32 parent = dr::gather<UInt32>(m_parent, node, valid);
+                Vector2u child = dr::gather<Vector2u>(m_children, parent, valid);
+
+                Float p_left = left_probability(p, child, valid);
+                dr::masked(pmf, valid) *=
+                    dr::select(dr::eq(node, child.x()), p_left, 1.f - p_left);
+                dr::masked(node, valid) = parent;
+            }
+        }
+
+        return pmf;
+    }
+
+protected:
+    struct Primitive {
+        LightBounds bounds;
+        ScalarPoint3f centroid;
+        uint32_t emitter;
+    };
+
+    struct Node {
+        LightBounds bounds;
+        uint32_t left = 0, right = 0;
+        uint32_t emitter = 0;
+        bool leaf = false;
+    };
+
+    /// Recursively build the subtree over prims[begin, end)
+    uint32_t build(std::vector<Primitive> &prims, uint32_t begin,
+                   uint32_t end, uint32_t parent, uint32_t depth) {
+        uint32_t index = (uint32_t) m_nodes.size();
+        m_nodes.emplace_back();
+        m_parents.push_back(parent);
+        m_height = std::max(m_height, depth);
+
+        if (end - begin == 1) {
+            Node &node   = m_nodes[index];
+            node.bounds  = prims[begin].bounds;
+            node.emitter = prims[begin].emitter;
+            node.leaf    = true;
+            return index;
+        }
+
+        // Median split along the largest extent of the centroids
+        ScalarBoundingBox3f centroid_bbox;
+        for (uint32_t i = begin; i < end; ++i)
+            centroid_bbox.expand(prims[i].centroid);
+        uint32_t axis = centroid_bbox.major_axis();
+        uint32_t mid = (begin + end) / 2;
+
+        std::nth_element(prims.begin() + begin, prims.begin() + mid,
+                         prims.begin() + end,
+                         [axis](const Primitive &a, const Primitive &b) {
+                             return a.centroid[axis] < b.centroid[axis];
+                         });
+
+        uint32_t left  = build(prims, begin, mid, index, depth + 1),
+                 right = build(prims, mid, end, index, depth + 1);
+
+        Node &node  = m_nodes[index];
+        node.left   = left;
+        node.right  = right;
+        node.bounds = merge(m_nodes[left].bounds, m_nodes[right].bounds);
+        return index;
+    }
+
+    /// Union of two light bounds (cones are merged as in PBRT v4)
+    static LightBounds merge(const LightBounds &a, const LightBounds &b) {
+        LightBounds result;
+        result.bbox = ScalarBoundingBox3f::merge(a.bbox, b.bbox);
+        result.power = a.power + b.power;
+        result.theta_e = std::max(a.theta_e, b.theta_e);
+
+        ScalarFloat theta_d = dr::unit_angle(a.axis, b.axis);
+        if (std::min(theta_d + b.theta_o, dr::Pi<ScalarFloat>) <= a.theta_o) {
+            result.axis = a.axis;
+            result.theta_o = a.theta_o;
+        } else if (std::min(theta_d + a.theta_o, dr::Pi<ScalarFloat>) <= b.theta_o) {
+            result.axis = b.axis;
+            result.theta_o = b.theta_o;
+        } else {
+            ScalarFloat theta_o = .5f * (a.theta_o + theta_d + b.theta_o);
+            ScalarVector3f w_r = dr::cross(a.axis, b.axis);
+            if (theta_o >= dr::Pi<ScalarFloat> || !(dr::squared_norm(w_r) > 0.f)) {
+                result.axis = a.axis;
+                result.theta_o = dr::Pi<ScalarFloat>;
+            } else {
+                // Rotate a.axis towards b.axis (Rodrigues, w_r is orthogonal)
+                auto [sin_r, cos_r] = dr::sincos(theta_o - a.theta_o);
+                w_r = dr::normalize(w_r);
+                result.axis = dr::normalize(a.axis * cos_r +
+                                            dr::cross(w_r, a.axis) * sin_r);
+                result.theta_o = theta_o;
+            }
+        }
+
+        return result;
+    }
+
+    /// Probability of descending into the left child of a node
+    Float left_probability(const Point3f &p, const Vector2u &child,
+                           Mask active) const {
+        Float i_left  = importance(p, child.x(), active),
+              i_right = importance(p, child.y(), active),
+              i_sum   = i_left + i_right;
+        return dr::select(i_sum > 0.f, i_left / i_sum, .5f);
+    }
+
+    /// Conservative estimate of the contribution of a node at \c p
+    Float importance(const Point3f &p, const UInt32 &node, Mask active) const {
+        Point3f p_min  = dr::gather<Point3f>(m_bbox, 2u * node, active),
+                p_max  = dr::gather<Point3f>(m_bbox, 2u * node + 1u, active);
+        Vector3f axis  = dr::gather<Vector3f>(m_axis, node, active);
+        Vector3f param = dr::gather<Vector3f>(m_params, node, active);
+        Float power = param.x(), theta_o = param.y(), theta_e = param.z();
+
+        Point3f center = .5f * (p_min + p_max);
+        Float radius_2 = dr::squared_norm(p_max - center);
+        Vector3f d = p - center;
+        Float dist_2 = dr::squared_norm(d);
+
+        // Angle between the cone axis and the direction to 'p'
+        Vector3f wi = d * dr::rsqrt(dr::maximum(dist_2, dr::Smallest<Float>));
+        Float theta_w = dr::safe_acos(dr::dot(axis, wi));
+
+        // Angle subtended by the bounding sphere of the node
+        Float theta_b = dr::select(
+            dist_2 > radius_2, dr::safe_asin(dr::sqrt(radius_2 / dist_2)),
+            dr::Pi<Float>);
+
+        Float theta_p = dr::maximum(theta_w - theta_o - theta_b, 0.f);
+
+        if (m_culling_only)
+            return dr::select(theta_p < theta_e, power, 0.f);
+
+        Float result = power * dr::maximum(dr::cos(theta_p), 0.f) /
+                       dr::maximum(dist_2, dr::maximum(radius_2, math::RayEpsilon<Float>));
+        return dr::select(theta_p < theta_e, result, 0.f);
+    }
+
+protected:
+    FloatStorage m_bbox;
+    FloatStorage m_axis;
+    FloatStorage m_params;
+    UInt32Storage m_children;
+    UInt32Storage m_parent;
+    UInt32Storage m_leaf_of;
+    UInt32Storage m_others;
+
+    ScalarFloat m_tree_prob;
+    bool m_culling_only;
+    uint32_t m_tree_size;
+    uint32_t m_other_size;
+    uint32_t m_height;
+
+    /// Host-side nodes, only used during construction
+    std::vector<Node> m_nodes;
+    std::vector<uint32_t> m_parents;
+};
+
+NAMESPACE_END(mitsuba)
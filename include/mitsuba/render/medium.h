@@ -8,10 +8,30 @@
 
 NAMESPACE_BEGIN(mitsuba)
 
+/// Estimators of the transmittance along shadow rays
+enum class TransmittanceEstimator : uint32_t {
+    /// Ratio tracking: weight by the null-collision probability at every step
+    RatioTracking,
+
+    /**
+     * Residual ratio tracking: evaluate the transmittance of a control
+     * extinction analytically, and ratio track the remaining residual
+     */
+    ResidualRatioTracking
+};
+
 template <typename Float, typename Spectrum>
 class MI_EXPORT_LIB Medium : public Object {
 public:
-    MI_IMPORT_TYPES(PhaseFunction, Sampler, Scene, Texture);
+    MI_IMPORT_TYPES(Emitter, PhaseFunction, Sampler, Scene, Texture);
+
+    /**
+     * \brief Returns the world-space bounding box of the medium
+     *
+     * The default implementation returns an invalid bounding box, which
+     * indicates that the medium isn't bounded (e.g. homogeneous media).
+     */
+    virtual ScalarBoundingBox3f bbox() const;
 
     /// Intersects a ray with the medium's bounding box
     virtual std::tuple<Mask, Float, Float>
@@ -22,6 +42,25 @@ public:
     get_majorant(const MediumInteraction3f &mi,
                  Mask active = true) const = 0;
 
+    /**
+     * \brief Returns the control extinction used by residual ratio tracking
+     *
+     * Residual ratio tracking splits the extinction into a control
+     * extinction, whose transmittance is evaluated analytically, and a
+     * residual that is estimated by ratio tracking. The control extinction
+     * is constant along rays and must not exceed the extinction anywhere
+     * within the medium's bounding box. Integrators multiply the null
+     * collision weights by <tt>sigma_n + sigma_c</tt> instead of
+     * <tt>sigma_n</tt> and apply <tt>exp(-sigma_c * t)</tt> for every
+     * distance \c t travelled through the bounding box.
+     *
+     * The control extinction is zero unless residual ratio tracking was
+     * selected, in which case both estimators coincide.
+     */
+    virtual UnpolarizedSpectrum
+    get_control_extinction(const MediumInteraction3f &mi,
+                           Mask active = true) const;
+
     /// Returns the medium coefficients Sigma_s, Sigma_n and Sigma_t evaluated
     /// at a given MediumInteraction mi
     virtual std::tuple<UnpolarizedSpectrum, UnpolarizedSpectrum,
@@ -29,6 +68,17 @@ public:
     get_scattering_coefficients(const MediumInteraction3f &mi,
                                 Mask active = true) const = 0;
 
+    /**
+     * \brief Returns the radiance emitted by the medium at \c mi
+     *
+     * The emission coefficient (emitted radiance per unit length) is the
+     * product of this value and the absorption coefficient
+     * <tt>sigma_t - sigma_s</tt>, so that optically thick regions glow with
+     * the returned radiance. The default implementation returns zero.
+     */
+    virtual UnpolarizedSpectrum get_radiance(const MediumInteraction3f &mi,
+                                             Mask active = true) const;
+
     /**
      * \brief Sample a free-flight distance in the medium.
      *
@@ -47,8 +97,10 @@ public:
      *                 The MediumInteraction will always be valid,
      *                 except if the ray missed the Medium's bounding box.
      */
-    MediumInteraction3f sample_interaction(const Ray3f &ray, Float sample,
-                                           UInt32 channel, Mask active) const;
+    virtual MediumInteraction3f sample_interaction(const Ray3f &ray,
+                                                   Float sample,
+                                                   UInt32 channel,
+                                                   Mask active) const;
 
     /**
      * \brief Compute the transmittance and PDF
@@ -86,6 +138,26 @@ public:
         return m_has_spectral_extinction;
     }
 
+    /// Returns whether this medium emits light
+    MI_INLINE bool is_emitter() const { return m_is_emitter; }
+
+    /**
+     * \brief Return the emitter that samples the emission of this medium
+     * using next event estimation (if any)
+     *
+     * When set, integrators only account for the emission of the medium at
+     * collisions along rays that didn't sample emitters at their origin.
+     */
+    MI_INLINE const Emitter *emitter() const { return m_emitter; }
+
+    /// Set the emitter that samples the emission of this medium
+    void set_emitter(const Emitter *emitter);
+
+    /// Returns the estimator used for the transmittance along shadow rays
+    MI_INLINE TransmittanceEstimator transmittance_estimator() const {
+        return m_transmittance_estimator;
+    }
+
     void traverse(TraversalCallback *callback) override;
 
     /// Return a string identifier
@@ -108,6 +180,10 @@ protected:
 protected:
     ref<PhaseFunction> m_phase_function;
     bool m_sample_emitters, m_is_homogeneous, m_has_spectral_extinction;
+    bool m_is_emitter = false;
+    /// Emitter that samples the emission of this medium (not owned)
+    const Emitter *m_emitter = nullptr;
+    TransmittanceEstimator m_transmittance_estimator;
 
     /// Identifier (if available)
     std::string m_id;
@@ -125,11 +201,15 @@ DRJIT_VCALL_TEMPLATE_BEGIN(mitsuba::Medium)
     DRJIT_VCALL_GETTER(use_emitter_sampling, bool)
     DRJIT_VCALL_GETTER(is_homogeneous, bool)
     DRJIT_VCALL_GETTER(has_spectral_extinction, bool)
+    DRJIT_VCALL_GETTER(is_emitter, bool)
+    DRJIT_VCALL_GETTER(emitter, const typename Class::Emitter *)
     DRJIT_VCALL_METHOD(get_majorant)
+    DRJIT_VCALL_METHOD(get_control_extinction)
     DRJIT_VCALL_METHOD(intersect_aabb)
     DRJIT_VCALL_METHOD(sample_interaction)
     DRJIT_VCALL_METHOD(transmittance_eval_pdf)
     DRJIT_VCALL_METHOD(get_scattering_coefficients)
+    DRJIT_VCALL_METHOD(get_radiance)
 DRJIT_VCALL_TEMPLATE_END(mitsuba::Medium)
 
 //! @}
@@ -7,6 +7,7 @@
 #include <mitsuba/core/transform.h>
 #include <mitsuba/core/distr_1d.h>
 #include <mitsuba/core/properties.h>
+#include <algorithm>
 #include <unordered_map>
 #include <mutex>
 #include <drjit/dynamic.h>
@@ -68,12 +69,34 @@ public:
     /// Const variant of \ref vertex_positions_buffer.
     const FloatStorage& vertex_positions_buffer() const { return m_vertex_positions; }
 
-    /// Return vertex normals buffer
+    /**
+     * \brief Return the vertex positions of the additional keyframes of a
+     * deforming mesh
+     *
+     * The buffer concatenates the positions of keyframes 1, 2, .. (keyframe
+     * 0 is given by \ref vertex_positions_buffer()), and is empty for static
+     * meshes. See \ref motion_key_count().
+     */
+    FloatStorage& vertex_motion_positions_buffer() { return m_vertex_motion_positions; }
+    /// Const variant of \ref vertex_motion_positions_buffer.
+    const FloatStorage& vertex_motion_positions_buffer() const { return m_vertex_motion_positions; }
+
+    /**
+     * \brief Return vertex normals buffer
+     *
+     * The buffer is empty when the mesh uses compact vertex attributes, see
+     * \ref has_compact_vertex_attributes().
+     */
     FloatStorage& vertex_normals_buffer() { return m_vertex_normals; }
     /// Const variant of \ref vertex_normals_buffer.
     const FloatStorage& vertex_normals_buffer() const { return m_vertex_normals; }
 
-    /// Return vertex texcoords buffer
+    /**
+     * \brief Return vertex texcoords buffer
+     *
+     * The buffer is empty when the mesh uses compact vertex attributes, see
+     * \ref has_compact_vertex_attributes().
+     */
     FloatStorage& vertex_texcoords_buffer() { return m_vertex_texcoords; }
     /// Const variant of \ref vertex_texcoords_buffer.
     const FloatStorage& vertex_texcoords_buffer() const { return m_vertex_texcoords; }
@@ -111,11 +134,32 @@ public:
         return dr::gather<Result>(m_vertex_positions, index, active);
     }
 
+    /**
+     * \brief Returns the world-space position of the vertex with index \c
+     * index at the given \c time
+     *
+     * The position is linearly interpolated between the two enclosing
+     * keyframes of a deforming mesh (see \ref motion_key_count()), and is
+     * identical to \ref vertex_position() for static meshes.
+     */
+    template <typename Index, typename Time>
+    MI_INLINE auto vertex_position_at(Index index, const Time &time,
+                                      dr::mask_t<Index> active = true) const {
+        using Result = Point<dr::replace_scalar_t<Index, InputFloat>, 3>;
+        if (m_motion_keys <= 1)
+            return vertex_position(index, active);
+        return interpolate_vertex_motion<Result>(
+            m_vertex_positions, m_vertex_motion_positions, index, time, active);
+    }
+
     /// Returns the normal direction of the vertex with index \c index
     template <typename Index>
     MI_INLINE auto vertex_normal(Index index,
                                  dr::mask_t<Index> active = true) const {
         using Result = Normal<dr::replace_scalar_t<Index, InputFloat>, 3>;
+        if (m_compact_attributes)
+            return decode_octahedral<Result>(dr::gather<dr::uint32_array_t<Index>>(
+                m_vertex_normals_compact, index, active));
         return dr::gather<Result>(m_vertex_normals, index, active);
     }
 
@@ -124,6 +168,9 @@ public:
     MI_INLINE auto vertex_texcoord(Index index,
                                    dr::mask_t<Index> active = true) const {
         using Result = Point<dr::replace_scalar_t<Index, InputFloat>, 2>;
+        if (m_compact_attributes)
+            return decode_half2<Result>(dr::gather<dr::uint32_array_t<Index>>(
+                m_vertex_texcoords_compact, index, active));
         return dr::gather<Result>(m_vertex_texcoords, index, active);
     }
 
@@ -148,14 +195,53 @@ public:
     }
 
     /// Does this mesh have per-vertex normals?
-    bool has_vertex_normals() const { return dr::width(m_vertex_normals) != 0; }
+    bool has_vertex_normals() const {
+        return dr::width(m_vertex_normals) != 0 ||
+               dr::width(m_vertex_normals_compact) != 0;
+    }
 
     /// Does this mesh have per-vertex texture coordinates?
-    bool has_vertex_texcoords() const { return dr::width(m_vertex_texcoords) != 0; }
+    bool has_vertex_texcoords() const {
+        return dr::width(m_vertex_texcoords) != 0 ||
+               dr::width(m_vertex_texcoords_compact) != 0;
+    }
+
+    /**
+     * \brief Does this mesh store its vertex normals and texture coordinates
+     * in compact form?
+     *
+     * In this case, normals are octahedral-encoded using 2x16 bits and
+     * texture coordinates are stored as pairs of half precision values. Both
+     * are decoded on the fly by \ref vertex_normal() and \ref
+     * vertex_texcoord(), and cannot be modified or differentiated.
+     */
+    bool has_compact_vertex_attributes() const { return m_compact_attributes; }
+
+    /**
+     * \brief Return the number of keyframes of the vertex positions
+     *
+     * A mesh with more than one keyframe deforms over time (deformation
+     * motion blur). The keyframes are uniformly distributed over the time
+     * interval [0, 1], and vertex positions are linearly interpolated between
+     * them using the time of each ray.
+     */
+    ScalarSize motion_key_count() const { return m_motion_keys; }
+
+    /// Does this mesh deform over time? (see \ref motion_key_count())
+    bool is_animated() const override { return m_motion_keys > 1; }
 
     /// Does this mesh have additional mesh attributes?
     bool has_mesh_attributes() const { return m_mesh_attributes.size() > 0; }
 
+    /// Return the names and dimensions of the additional mesh attributes, sorted by name
+    std::vector<std::pair<std::string, size_t>> mesh_attributes() const {
+        std::vector<std::pair<std::string, size_t>> result;
+        for (const auto &[name, attribute] : m_mesh_attributes)
+            result.emplace_back(name, attribute.size);
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
     /// Does this mesh use face normals?
     bool has_face_normals() const { return m_face_normals; }
 
@@ -181,12 +267,71 @@ public:
     /// Merge two meshes into one
     ref<Mesh> merge(const Mesh *other) const;
 
+    /**
+     * \brief Merge a list of meshes into one
+     *
+     * The meshes must have the same BSDF, media, emitter, sensor, vertex
+     * attributes and additional mesh attributes. The size of the merged mesh
+     * is computed up front, and its buffers are filled in parallel. The cost
+     * is therefore linear in the total size of the meshes, which is not the
+     * case for a sequence of pairwise \ref merge() calls.
+     */
+    static ref<Mesh> merge(const std::vector<const Mesh *> &meshes);
+
+    /**
+     * \brief Refine the mesh using Loop subdivision
+     *
+     * The mesh is treated as the control cage of a Loop subdivision surface,
+     * and each subdivision step splits every triangle into four. Vertices at
+     * the same position are welded beforehand, hence seams of the UV
+     * parameterization don't tear the surface. Boundary edges are treated as
+     * creases. Texture coordinates and vertex attributes are interpolated
+     * linearly, and face attributes are inherited by the refined faces.
+     *
+     * \param max_levels
+     *    Maximum number of subdivision steps
+     *
+     * \param max_edge_length
+     *    Subdivision stops early once all edges are at most this long.
+     *    Disabled when set to zero.
+     *
+     * \param smooth
+     *    When set to \c false, the vertices remain in place and new vertices
+     *    are inserted at the edge midpoints, i.e. the mesh is tessellated
+     *    without changing its shape.
+     */
+    ref<Mesh> subdivide(uint32_t max_levels,
+                        ScalarFloat max_edge_length = 0.f,
+                        bool smooth = true) const;
+
     /// Compute smooth vertex normals and replace the current normal values
     void recompute_vertex_normals();
 
+    /**
+     * \brief Return the vertex normals as a flat floating point buffer
+     *
+     * Unlike \ref vertex_normals_buffer(), this also works for meshes with
+     * compact vertex attributes, whose normals are then decoded.
+     */
+    FloatStorage decoded_vertex_normals() const;
+
+    /// Analogous to \ref decoded_vertex_normals() for texture coordinates
+    FloatStorage decoded_vertex_texcoords() const;
+
     /// Recompute the bounding box (e.g. after modifying the vertex positions)
     void recompute_bbox();
 
+    /**
+     * \brief Move the vertex, face and attribute buffers of the mesh to
+     * another type of memory
+     *
+     * This is used to page the geometry of large CUDA scenes out of device
+     * memory (<tt>AllocType::HostPinned</tt>) and back in
+     * (<tt>AllocType::Device</tt>). The mesh is marked as dirty, and its
+     * acceleration data structure must be rebuilt before it is traced again.
+     */
+    void migrate_buffers(AllocType type);
+
     // =============================================================
     //! @{ \name Shape interface implementation
     // =============================================================
@@ -198,6 +343,8 @@ public:
     ScalarBoundingBox3f bbox(ScalarIndex index,
                              const ScalarBoundingBox3f &clip) const override;
 
+    std::pair<ScalarVector3f, ScalarFloat> normal_bounds() const override;
+
     ScalarSize primitive_count() const override;
 
     Float surface_area() const override;
@@ -208,6 +355,22 @@ public:
 
     Float pdf_position(const PositionSample3f &ps, Mask active = true) const override;
 
+    /**
+     * \brief Sample a direction towards the mesh
+     *
+     * Small meshes (e.g. quads that represent a window or a softbox) that are
+     * seen under a large solid angle are sampled uniformly in solid angle:
+     * a face is chosen proportionally to its solid angle, followed by a
+     * uniform sample of the spherical triangle it subtends. Other meshes
+     * fall back to area sampling.
+     */
+    DirectionSample3f sample_direction(const Interaction3f &it,
+                                       const Point2f &sample,
+                                       Mask active = true) const override;
+
+    Float pdf_direction(const Interaction3f &it, const DirectionSample3f &ds,
+                        Mask active = true) const override;
+
     Point3f barycentric_coordinates(const SurfaceInteraction3f &si,
                                     Mask active = true) const;
 
@@ -256,6 +419,18 @@ public:
     std::tuple<DynamicBuffer<UInt32>, DynamicBuffer<Float>>
     precompute_silhouette(const ScalarPoint3f &viewpoint) const override;
 
+    /**
+     * \brief Evaluate the silhouette weight of the given directed edges
+     *
+     * Returns the weight that \ref precompute_silhouette() assigns to each
+     * directed edge \c dedge as seen from \c viewpoint, or zero when the edge
+     * isn't part of the silhouette. This makes it possible to update a
+     * precomputed silhouette for the edges adjacent to moved vertices only.
+     */
+    Float silhouette_edge_weight(const ScalarPoint3f &viewpoint,
+                                 const UInt32 &dedge,
+                                 Mask active = true) const;
+
     SilhouetteSample3f sample_precomputed_silhouette(const Point3f &viewpoint,
                                                      Index sample1,
                                                      Float sample2,
@@ -286,27 +461,7 @@ public:
     ray_intersect_triangle_impl(const dr::uint32_array_t<T> &index,
                                 const Ray3 &ray,
                                 dr::mask_t<T> active = true) const {
-        using Point3T = Point<T, 3>;
-        using Faces = dr::Array<dr::uint32_array_t<T>, 3>;
-
-        Faces fi;
-        Point3T p0, p1, p2;
-#if defined(MI_ENABLE_LLVM) && !defined(MI_ENABLE_EMBREE)
-        // Ensure we don't rely on drjit-core when called from an LLVM kernel
-        if constexpr (!dr::is_array_v<T> && dr::is_llvm_v<Float>) {
-            fi = dr::gather<Faces>(m_faces_ptr, index, active);
-            p0 = dr::gather<InputPoint3f>(m_vertex_positions_ptr, fi[0], active),
-            p1 = dr::gather<InputPoint3f>(m_vertex_positions_ptr, fi[1], active),
-            p2 = dr::gather<InputPoint3f>(m_vertex_positions_ptr, fi[2], active);
-        } else
-#endif
-        {
-            fi = face_indices(index, active);
-            p0 = vertex_position(fi[0], active),
-            p1 = vertex_position(fi[1], active),
-            p2 = vertex_position(fi[2], active);
-        }
-
+        auto [p0, p1, p2] = triangle_positions<T>(index, ray.time, active);
         auto [t, uv, hit] = moeller_trumbore(ray, p0, p1, p2, active);
         return { dr::select(hit, t, dr::Infinity<T>), uv };
     }
@@ -327,6 +482,19 @@ public:
         return ray_intersect_triangle_impl<ScalarFloat>(index, ray, true);
     }
 
+    /**
+     * \brief Shadow ray test against a single triangle
+     *
+     * Equivalent to checking the distance returned by \ref
+     * ray_intersect_triangle_scalar(), but without producing the intersection
+     * distance and barycentric coordinates.
+     */
+    MI_INLINE bool ray_test_triangle_scalar(const ScalarUInt32 &index,
+                                            const ScalarRay3f &ray) const {
+        auto [p0, p1, p2] = triangle_positions<ScalarFloat>(index, ray.time, true);
+        return std::get<2>(moeller_trumbore(ray, p0, p1, p2, true));
+    }
+
 #define MI_DECLARE_RAY_INTERSECT_TRI_PACKET(N)                            \
     using FloatP##N   = dr::Packet<dr::scalar_t<Float>, N>;                \
     using MaskP##N    = dr::mask_t<FloatP##N>;                             \
@@ -348,6 +516,16 @@ public:
 #if defined(MI_ENABLE_EMBREE)
     /// Return the Embree version of this shape
     virtual RTCGeometry embree_geometry(RTCDevice device) override;
+
+    /**
+     * \brief Point an existing Embree geometry (created by \ref
+     * embree_geometry()) to the current vertex positions
+     *
+     * The topology of the mesh must not have changed since the geometry was
+     * created. This is used to refit rather than rebuild the BVH of dynamic
+     * scenes, and does not apply to deforming meshes.
+     */
+    void embree_update_geometry(RTCGeometry geom);
 #endif
 
 #if defined(MI_ENABLE_CUDA)
@@ -388,6 +566,10 @@ protected:
      *
      * This is an implementation of the technique described in:
      * <tt>https://www.graphics.rwth-aachen.de/media/papers/directed.pdf</tt>.
+     *
+     * The directed edges are matched by sorting them by their undirected
+     * edge using a parallel radix sort on the host. Edges shared by more
+     * than two faces are treated as boundary edges.
      */
     void build_directed_edges();
 
@@ -412,12 +594,174 @@ protected:
      */
     void build_parameterization();
 
+    /**
+     * \brief Update \ref m_motion_keys from the size of the keyframe buffer
+     * \ref m_vertex_motion_positions
+     */
+    void update_motion_keys();
+
+    /**
+     * \brief Encode the floating point vertex normals and texture
+     * coordinates into their compact representation and release them
+     */
+    void compact_vertex_attributes();
+
+    /**
+     * \brief Exclude fully transparent triangles from the acceleration data
+     * structure
+     *
+     * Evaluates the null transmission of the mesh's BSDF (e.g. the opacity of
+     * a \c mask BSDF) on a regular grid with \c opacity_bake_resolution
+     * segments per triangle edge. Triangles that are transparent at all grid
+     * points are replaced by degenerate triangles in the index buffer that is
+     * passed to Embree and OptiX, which never report intersections with them.
+     */
+    void bake_opacity();
+
+    /// Index buffer of the ray tracing backends (see \ref bake_opacity())
+    const DynamicBuffer<UInt32> &accel_faces() const {
+        return m_accel_faces.size() > 0 ? m_accel_faces : m_faces;
+    }
+
+    /// Decode an octahedral-encoded unit vector (2x16 bit fixed point)
+    template <typename Result, typename UInt32_>
+    static Result decode_octahedral(const UInt32_ &value) {
+        using Value = dr::value_t<Result>;
+        Value x = Value(value & 0xffffu) * (2.f / 65535.f) - 1.f,
+              y = Value(dr::sr<16>(value)) * (2.f / 65535.f) - 1.f,
+              z = 1.f - dr::abs(x) - dr::abs(y),
+              t = dr::maximum(-z, 0.f);
+
+        // Unfold the lower hemisphere
+        x = dr::select(x >= 0.f, x - t, x + t);
+        y = dr::select(y >= 0.f, y - t, y + t);
+
+        return dr::normalize(Result(x, y, z));
+    }
+
+    /// Decode a pair of half precision values packed into 32 bits
+    template <typename Result, typename UInt32_>
+    static Result decode_half2(const UInt32_ &value) {
+        using Value = dr::value_t<Result>;
+        auto decode = [](const UInt32_ &h) {
+            /* Shift the exponent and mantissa into place and rebias the
+               exponent with a multiplication, which also handles denormals
+               (infinities and NaNs are not needed for texture coordinates) */
+            Value v = dr::reinterpret_array<Value>(dr::sl<13>(h & 0x7fffu)) * 0x1p112f;
+            return dr::reinterpret_array<Value>(
+                dr::reinterpret_array<UInt32_>(v) | dr::sl<16>(h & 0x8000u));
+        };
+        return Result(decode(value & 0xffffu), decode(dr::sr<16>(value)));
+    }
+
     // Ensures that the sampling table are ready.
     DRJIT_INLINE void ensure_pmf_built() const {
         if (unlikely(m_area_pmf.empty()))
             const_cast<Mesh *>(this)->build_pmf();
     }
 
+    /// Fill the position sample of the given face and barycentric coordinates
+    PositionSample3f face_position_sample(const Vector3u &fi, const Point2f &b,
+                                          Mask active) const;
+
+    /// Meshes with at most this many faces can be sampled by solid angle
+    static constexpr ScalarSize SolidAngleSamplingMaxFaces = 16;
+
+    /// Solid angle above which \ref sample_direction() samples spherical triangles
+    static constexpr float SolidAngleThreshold = 1e-2f;
+
+    /// Can \ref sample_direction() sample the mesh by solid angle?
+    bool solid_angle_sampling() const {
+        return m_face_count <= SolidAngleSamplingMaxFaces &&
+               m_motion_keys <= 1 && !m_is_instance &&
+               !parameters_grad_enabled();
+    }
+
+    /**
+     * \brief Compute the solid angle of the mesh as seen from \c p
+     *
+     * The solid angles of the individual faces are appended to \c
+     * face_solid_angles (if specified). Faces whose plane contains \c p don't
+     * contribute.
+     */
+    Float solid_angle(const Point3f &p, std::vector<Float> *face_solid_angles,
+                      Mask active) const;
+
+    /**
+     * \brief Fetch the vertex positions of a triangle at the given time
+     * (usable from LLVM kernels)
+     */
+    template <typename T>
+    MI_INLINE std::tuple<Point<T, 3>, Point<T, 3>, Point<T, 3>>
+    triangle_positions(const dr::uint32_array_t<T> &index, const T &time,
+                       dr::mask_t<T> active = true) const {
+        using Point3T = Point<T, 3>;
+        using Faces = dr::Array<dr::uint32_array_t<T>, 3>;
+
+        Faces fi;
+        Point3T p0, p1, p2;
+#if defined(MI_ENABLE_LLVM) && !defined(MI_ENABLE_EMBREE)
+        // Ensure we don't rely on drjit-core when called from an LLVM kernel
+        if constexpr (!dr::is_array_v<T> && dr::is_llvm_v<Float>) {
+            fi = dr::gather<Faces>(m_faces_ptr, index, active);
+            if (m_motion_keys > 1) {
+                p0 = interpolate_vertex_motion<InputPoint3f>(
+                    m_vertex_positions_ptr, m_vertex_motion_positions_ptr, fi[0], time, active);
+                p1 = interpolate_vertex_motion<InputPoint3f>(
+                    m_vertex_positions_ptr, m_vertex_motion_positions_ptr, fi[1], time, active);
+                p2 = interpolate_vertex_motion<InputPoint3f>(
+                    m_vertex_positions_ptr, m_vertex_motion_positions_ptr, fi[2], time, active);
+            } else {
+                p0 = dr::gather<InputPoint3f>(m_vertex_positions_ptr, fi[0], active),
+                p1 = dr::gather<InputPoint3f>(m_vertex_positions_ptr, fi[1], active),
+                p2 = dr::gather<InputPoint3f>(m_vertex_positions_ptr, fi[2], active);
+            }
+        } else
+#endif
+        {
+            fi = face_indices(index, active);
+            p0 = vertex_position_at(fi[0], time, active),
+            p1 = vertex_position_at(fi[1], time, active),
+            p2 = vertex_position_at(fi[2], time, active);
+        }
+
+        return { p0, p1, p2 };
+    }
+
+    /**
+     * \brief Linearly interpolate the position of a vertex between the
+     * keyframes enclosing \c time
+     *
+     * \c positions holds keyframe 0 and \c motion the remaining ones (see
+     * \ref vertex_motion_positions_buffer()). Both are either buffers or raw
+     * pointers.
+     */
+    template <typename Result, typename Source, typename Index, typename Time>
+    MI_INLINE Result interpolate_vertex_motion(const Source &positions,
+                                               const Source &motion,
+                                               const Index &index,
+                                               const Time &time,
+                                               dr::mask_t<Index> active) const {
+        using Value = dr::value_t<Result>;
+        using UInt32_ = dr::uint32_array_t<Index>;
+
+        Value s = dr::clamp(Value(time), 0.f, 1.f) * (InputFloat) (m_motion_keys - 1);
+        UInt32_ key = dr::minimum(UInt32_(s), m_motion_keys - 2);
+        Value w = s - Value(key);
+
+        // Keyframe k > 0 is stored at offset (k - 1) * vertex_count in 'motion'
+        UInt32_ offset = key * m_vertex_count + index;
+        dr::mask_t<UInt32_> first = dr::eq(key, 0u);
+
+        Result p1 = dr::gather<Result>(motion, offset, active),
+               p0 = dr::select(
+                   first, dr::gather<Result>(positions, index, active && first),
+                   dr::gather<Result>(motion, offset - m_vertex_count,
+                                      active && !first));
+
+        return Result(dr::lerp(p0, p1, w));
+    }
+
     /** \brief Moeller and Trumbore algorithm for computing ray-triangle
      * intersection
      *
@@ -531,12 +875,22 @@ protected:
 
     ScalarSize m_vertex_count = 0;
     ScalarSize m_face_count = 0;
+    /// Number of keyframes of the vertex positions (see \ref motion_key_count())
+    ScalarSize m_motion_keys = 1;
 
     mutable FloatStorage m_vertex_positions;
+    /// Vertex positions of the keyframes 1, 2, .. of a deforming mesh
+    mutable FloatStorage m_vertex_motion_positions;
     mutable FloatStorage m_vertex_normals;
     mutable FloatStorage m_vertex_texcoords;
 
+    /// Compact vertex normals and texture coordinates (see \ref compact_vertex_attributes)
+    mutable DynamicBuffer<UInt32> m_vertex_normals_compact;
+    mutable DynamicBuffer<UInt32> m_vertex_texcoords_compact;
+
     mutable DynamicBuffer<UInt32> m_faces;
+    /// Faces without the transparent triangles (see \ref bake_opacity())
+    mutable DynamicBuffer<UInt32> m_accel_faces;
 
     /// Directed edges data structures to support neighbor queries
     mutable DynamicBuffer<UInt32> m_E2E;
@@ -552,6 +906,7 @@ protected:
     /* Data pointer to ensure triangle intersection routine doesn't rely on
        drjit-core when called from an LLVM kernel */
     float* m_vertex_positions_ptr;
+    float* m_vertex_motion_positions_ptr;
     uint32_t* m_faces_ptr;
 #endif
 
@@ -559,11 +914,19 @@ protected:
 
 #if defined(MI_ENABLE_CUDA)
     mutable void* m_vertex_buffer_ptr = nullptr;
+    /// Per-keyframe vertex buffers of a deforming mesh (OptiX motion GAS)
+    mutable std::vector<void *> m_vertex_motion_buffer_ptrs;
 #endif
 
     /// Flag that can be set by the user to disable loading/computation of vertex normals
     bool m_face_normals = false;
     bool m_flip_normals = false;
+    /// Store vertex normals and texture coordinates in compact form?
+    bool m_compact_attributes = false;
+    /// Sample faces using an alias table instead of a CDF inversion?
+    bool m_alias_sampling = false;
+    /// Grid resolution used to detect transparent triangles (0: disabled)
+    uint32_t m_opacity_bake_resolution = 0;
 
     /* Surface area distribution -- generated on demand when \ref
        prepare_area_pmf() is first called. */
@@ -10,6 +10,8 @@
 #include <mitsuba/core/warp.h>
 #include <mitsuba/render/fresnel.h>
 #include <mitsuba/render/fwd.h>
+#include <map>
+#include <mutex>
 
 NAMESPACE_BEGIN(mitsuba)
 
@@ -36,6 +38,42 @@ MI_INLINE std::ostream &operator<<(std::ostream &os, MicrofacetType tp) {
     return os;
 }
 
+/// Supported routines for sampling the distribution of visible normals
+enum class VNDFSampling : uint32_t {
+    /// Stretch-based method by Heitz and d'Eon (the only choice for Beckmann)
+    Heitz = 0,
+
+    /// Spherical cap method by Dupuy and Benyoub (GGX only)
+    SphericalCaps = 1,
+
+    /**
+     * \brief Bounded spherical cap method by Eto and Tokuyoshi (GGX only)
+     *
+     * This variant concentrates the samples on visible normals whose
+     * reflection lies above the horizon. Its density differs from the visible
+     * normal distribution, and it is only valid for reflection (i.e. not for
+     * refraction through a dielectric interface).
+     */
+    BoundedSphericalCaps = 2
+};
+
+MI_INLINE std::ostream &operator<<(std::ostream &os, VNDFSampling method) {
+    switch (method) {
+        case VNDFSampling::Heitz:
+            os << "heitz";
+            break;
+        case VNDFSampling::SphericalCaps:
+            os << "spherical_caps";
+            break;
+        case VNDFSampling::BoundedSphericalCaps:
+            os << "bounded_spherical_caps";
+            break;
+        default:
+            Throw("Unknown visible normal sampling method: %s", (uint32_t) method);
+    }
+    return os;
+}
+
 /**
  * \brief Implementation of the Beckman and GGX / Trowbridge-Reitz microfacet
  * distributions and various useful sampling routines
@@ -59,6 +97,19 @@ MI_INLINE std::ostream &operator<<(std::ostream &os, MicrofacetType tp) {
  * An improvement of the GGX model sampling routine is discussed in
  *    "A Simpler and Exact Sampling Routine for the GGX Distribution of Visible Normals"
  *     by Eric Heitz
+ *
+ * By default, the visible normals of the GGX distribution are sampled using
+ *
+ *   "Sampling Visible GGX Normals with Spherical Caps"
+ *    by Jonathan Dupuy and Anis Benyoub
+ *
+ * which draws the same distribution as the method above with fewer
+ * transcendental operations. The bounded variant from
+ *
+ *   "Bounded VNDF Sampling for Smith-GGX Reflections"
+ *    by Kenta Eto and Yusuke Tokuyoshi
+ *
+ * can be selected via \ref set_vndf_sampling().
  */
 template <typename Float, typename Spectrum>
 class MicrofacetDistribution {
@@ -140,6 +191,20 @@ public:
 
         m_sample_visible = props.get<bool>("sample_visible", sample_visible);
 
+        if (props.has_property("vndf_sampling")) {
+            std::string method = string::to_lower(props.string("vndf_sampling"));
+            if (method == "heitz")
+                m_vndf_sampling = VNDFSampling::Heitz;
+            else if (method == "spherical_caps")
+                m_vndf_sampling = VNDFSampling::SphericalCaps;
+            else if (method == "bounded_spherical_caps")
+                m_vndf_sampling = VNDFSampling::BoundedSphericalCaps;
+            else
+                Throw("Specified an invalid visible normal sampling method "
+                      "\"%s\", must be \"heitz\", \"spherical_caps\" or "
+                      "\"bounded_spherical_caps\"!", method.c_str());
+        }
+
         configure();
     }
 
@@ -159,6 +224,17 @@ public:
     /// Return whether or not only visible normals are sampled?
     bool sample_visible() const { return m_sample_visible; }
 
+    /// Return the method used to sample the visible normals
+    VNDFSampling vndf_sampling() const { return m_vndf_sampling; }
+
+    /**
+     * \brief Set the method used to sample the visible normals
+     *
+     * The spherical cap methods only exist for the GGX distribution. The
+     * Beckmann distribution always uses \ref VNDFSampling::Heitz.
+     */
+    void set_vndf_sampling(VNDFSampling method) { m_vndf_sampling = method; }
+
     /// Is this an isotropic microfacet distribution?
     bool is_isotropic() const {
         if constexpr (dr::is_jit_v<Float>)
@@ -219,7 +295,16 @@ public:
     Float pdf(const Vector3f &wi, const Vector3f &m) const {
         Float result = eval(m);
 
-        if (m_sample_visible)
+        if (m_sample_visible && use_bounded_vndf()) {
+            /* Bounded VNDF: the cosine of the incident direction in the
+               normalization of the visible normals is scaled by 'k' */
+            Float t = dr::sqrt(dr::sqr(m_alpha_u * wi.x()) +
+                               dr::sqr(m_alpha_v * wi.y()) + dr::sqr(wi.z())),
+                  k = bounded_vndf_scale(wi);
+            result *= 2.f * dr::abs_dot(wi, m) /
+                      dr::fmadd(k, Frame3f::cos_theta(wi), t);
+            dr::masked(result, dr::dot(wi, m) * Frame3f::cos_theta(wi) <= 0.f) = 0.f;
+        } else if (m_sample_visible)
             result *= smith_g1(wi, m) * dr::abs_dot(wi, m) / Frame3f::cos_theta(wi);
         else
             result *= Frame3f::cos_theta(m);
@@ -293,6 +378,35 @@ public:
                          cos_theta),
                 pdf
             };
+        } else if (m_type == MicrofacetType::GGX &&
+                   m_vndf_sampling != VNDFSampling::Heitz) {
+            // Visible normal sampling using spherical caps
+
+            // Step 1: stretch wi
+            Vector3f wi_p = dr::normalize(Vector3f(
+                m_alpha_u * wi.x(),
+                m_alpha_v * wi.y(),
+                wi.z()
+            ));
+
+            // Step 2: sample a spherical cap in (-wi_p.z, 1]
+            Float b = Frame3f::cos_theta(wi_p);
+            if (use_bounded_vndf())
+                b = dr::select(Frame3f::cos_theta(wi) > 0.f,
+                               bounded_vndf_scale(wi) * b, b);
+
+            auto [sin_phi, cos_phi] = dr::sincos((2.f * dr::Pi<Float>) * sample.y());
+            Float z = dr::fmsub(1.f - sample.x(), 1.f + b, b),
+                  sin_theta = dr::safe_sqrt(dr::fnmadd(z, z, 1.f));
+
+            // Step 3: compute the halfway direction & unstretch
+            Normal3f m = dr::normalize(Vector3f(
+                m_alpha_u * dr::fmadd(sin_theta, cos_phi, wi_p.x()),
+                m_alpha_v * dr::fmadd(sin_theta, sin_phi, wi_p.y()),
+                dr::maximum(z + wi_p.z(), 0.f)
+            ));
+
+            return { m, pdf(wi, m) };
         } else {
             // Visible normal sampling.
             Float sin_phi, cos_phi, cos_theta;
@@ -427,6 +541,28 @@ protected:
         m_alpha_v = dr::maximum(m_alpha_v, 1e-4f);
     }
 
+    /// Does \ref sample() use the bounded spherical cap method?
+    bool use_bounded_vndf() const {
+        return m_type == MicrofacetType::GGX &&
+               m_vndf_sampling == VNDFSampling::BoundedSphericalCaps;
+    }
+
+    /**
+     * \brief Scale factor of the spherical cap height in the bounded VNDF
+     * method (Eto and Tokuyoshi, Listing 1)
+     *
+     * Incident directions below the horizon aren't bounded, hence a factor
+     * of one is returned.
+     */
+    Float bounded_vndf_scale(const Vector3f &wi) const {
+        Float a   = dr::minimum(m_alpha_u, m_alpha_v),
+              a_2 = dr::sqr(a),
+              s   = 1.f + dr::sqrt(dr::sqr(wi.x()) + dr::sqr(wi.y())),
+              s_2 = dr::sqr(s),
+              k   = (1.f - a_2) * s_2 / dr::fmadd(a_2, dr::sqr(wi.z()), s_2);
+        return dr::select(Frame3f::cos_theta(wi) > 0.f, k, 1.f);
+    }
+
     /// Compute the squared 1D roughness along direction \c v
     Float project_roughness_2(const Vector3f &v) const {
         if (is_isotropic())
@@ -442,6 +578,7 @@ protected:
     MicrofacetType m_type;
     Float m_alpha_u, m_alpha_v;
     bool  m_sample_visible;
+    VNDFSampling m_vndf_sampling = VNDFSampling::SphericalCaps;
 };
 
 template <typename Float, typename Spectrum>
@@ -455,11 +592,19 @@ std::ostream &operator<<(std::ostream &os, const MicrofacetDistribution<Float, S
     os << "," << std::endl
        << "  alpha_u = " << md.alpha_u() << "," << std::endl
        << "  alpha_v = " << md.alpha_v() << "," << std::endl
-       << "  sample_visible = " << md.sample_visible() << std::endl
+       << "  sample_visible = " << md.sample_visible() << "," << std::endl
+       << "  vndf_sampling = " << md.vndf_sampling() << std::endl
        << "]";
     return os;
 }
 
+/**
+ * \brief Numerically integrate the directional albedo of a rough dielectric
+ * interface in reflection
+ *
+ * A relative index of refraction \c eta of zero denotes a perfect reflector,
+ * i.e. the Fresnel factor is set to one.
+ */
 template <typename Float, typename MicrofaceDistributionP>
 Float eval_reflectance(const MicrofaceDistributionP &distr,
                        const Vector<Float, 3> &wi, dr::scalar_t<Float> eta) {
@@ -468,7 +613,7 @@ Float eval_reflectance(const MicrofaceDistributionP &distr,
     if (!distr.sample_visible())
         Throw("eval_reflectance(): requires visible normal sampling!");
 
-    int res = eta > 1 ? 32 : 128;
+    int res = (eta > 1 || eta == 0) ? 32 : 128;
 
     using FloatX = dr::DynamicArray<dr::scalar_t<Float>>;
     auto [nodes, weights] = quad::gauss_legendre<FloatX>(res);
@@ -500,7 +645,9 @@ Float eval_reflectance(const MicrofaceDistributionP &distr,
 
             Normal3fP m = std::get<0>(distr.sample(wi_p, node));
             Vector3fP wo = reflect(wi_p, m);
-            FloatP f = std::get<0>(fresnel(dr::dot(wi_p, m), FloatP(eta)));
+            FloatP f = 1.f;
+            if (eta != 0)
+                f = std::get<0>(fresnel(dr::dot(wi_p, m), FloatP(eta)));
             FloatP smith = distr.smith_g1(wo, m) * f;
             dr::masked(smith, wo.z() <= 0.f || wi_p.z() <= 0.f) = 0.f;
             result_p += smith * dr::prod(weight) * 0.25f;
@@ -512,6 +659,10 @@ Float eval_reflectance(const MicrofaceDistributionP &distr,
     return result;
 }
 
+/**
+ * \brief Numerically integrate the directional albedo of a rough dielectric
+ * interface in transmission
+ */
 template <typename Float, typename MicrofaceDistributionP>
 Float eval_transmittance(const MicrofaceDistributionP &distr,
                          Vector<Float, 3> &wi, dr::scalar_t<Float> eta) {
@@ -567,4 +718,86 @@ Float eval_transmittance(const MicrofaceDistributionP &distr,
     return result;
 }
 
+/// Resolution of the tables computed by \ref microfacet_albedo_table()
+#define MI_MICROFACET_ALBEDO_RES 32
+
+/**
+ * \brief Tabulate the directional albedo of a single-scattering microfacet
+ * model for energy compensation
+ *
+ * The table stores the albedo \c E as a function of the roughness \c alpha
+ * (outer dimension) and the cosine of the incident elevation (inner
+ * dimension). Both are sampled uniformly on <tt>[0, 1]</tt> using
+ * \ref MI_MICROFACET_ALBEDO_RES entries. Lookups should be performed with
+ * \ref eval_microfacet_albedo().
+ *
+ * When \c eta is zero, the table describes a perfect reflector (i.e. the
+ * Fresnel factor is one), otherwise it contains the sum of reflection and
+ * transmission through a dielectric interface with relative IOR \c eta.
+ *
+ * Tables are computed once per distribution type and IOR, and cached for
+ * subsequent calls.
+ */
+template <typename Float, typename Spectrum>
+DynamicBuffer<Float> microfacet_albedo_table(MicrofacetType type,
+                                             dr::scalar_t<Float> eta) {
+    using ScalarFloat = dr::scalar_t<Float>;
+    using FloatX = DynamicBuffer<ScalarFloat>;
+    using Vector3fX = Vector<FloatX, 3>;
+    using FloatP = dr::Packet<ScalarFloat>;
+    constexpr size_t Res = MI_MICROFACET_ALBEDO_RES;
+
+    static std::mutex mutex;
+    static std::map<std::pair<MicrofacetType, ScalarFloat>,
+                    std::vector<ScalarFloat>> cache;
+
+    std::lock_guard<std::mutex> guard(mutex);
+    auto it = cache.find({ type, eta });
+    if (it == cache.end()) {
+        FloatX mu = dr::maximum(1e-3f, dr::linspace<FloatX>(0, 1, Res));
+        Vector3fX wi(dr::safe_sqrt(1 - mu * mu), dr::zeros<FloatX>(Res), mu);
+
+        std::vector<ScalarFloat> table(Res * Res);
+        for (size_t i = 0; i < Res; ++i) {
+            ScalarFloat alpha = dr::maximum(1e-3f, ScalarFloat(i) / (Res - 1));
+            mitsuba::MicrofacetDistribution<FloatP, Spectrum> distr(type, alpha);
+
+            FloatX albedo = eval_reflectance(distr, wi, eta);
+            if (eta != 0)
+                albedo += eval_transmittance(distr, wi, eta);
+
+            for (size_t j = 0; j < Res; ++j)
+                table[i * Res + j] = dr::clamp(albedo[j], 1e-3f, 1.f);
+        }
+
+        it = cache.emplace(std::make_pair(type, eta), std::move(table)).first;
+    }
+
+    return dr::load<DynamicBuffer<Float>>(it->second.data(), Res * Res);
+}
+
+/**
+ * \brief Bilinearly interpolate a table computed by \ref microfacet_albedo_table()
+ */
+template <typename Float>
+Float eval_microfacet_albedo(const DynamicBuffer<Float> &table, Float alpha,
+                             Float cos_theta, dr::mask_t<Float> active = true) {
+    using UInt32 = dr::uint32_array_t<Float>;
+    constexpr uint32_t Res = MI_MICROFACET_ALBEDO_RES;
+
+    Float x = dr::clamp(cos_theta, 0.f, 1.f) * (Res - 1),
+          y = dr::clamp(alpha, 0.f, 1.f) * (Res - 1);
+    UInt32 xi = dr::minimum(UInt32(x), Res - 2),
+           yi = dr::minimum(UInt32(y), Res - 2),
+           index = yi * Res + xi;
+
+    Float fx = x - Float(xi), fy = y - Float(yi),
+          v00 = dr::gather<Float>(table, index, active),
+          v10 = dr::gather<Float>(table, index + 1, active),
+          v01 = dr::gather<Float>(table, index + Res, active),
+          v11 = dr::gather<Float>(table, index + Res + 1, active);
+
+    return dr::lerp(dr::lerp(v00, v10, fx), dr::lerp(v01, v11, fx), fy);
+}
+
 NAMESPACE_END(mitsuba)
@@ -127,4 +127,42 @@ MI_INLINE Float sggx_projected_area(const Vector<Float, 3> &wi,
     return dr::safe_sqrt(sigma2);
 }
 
+/**
+ * \brief Constructs the parameters of an SGGX microflake distribution that
+ * is rotationally symmetric around an axis
+ *
+ * The resulting matrix is <tt>S = sigma_axis^2 w w^T + sigma_perp^2 (I - w
+ * w^T)</tt>, where \c w denotes the normalized axis. Fiber-like distributions
+ * are obtained with <tt>sigma_axis < sigma_perp</tt>, and surface-like
+ * distributions with <tt>sigma_axis > sigma_perp</tt>.
+ *
+ * \param axis
+ *      The symmetry axis of the distribution (it does not need to be
+ *      normalized, and its sign is irrelevant)
+ *
+ * \param sigma_axis
+ *      The projected area of the distribution along the axis
+ *
+ * \param sigma_perp
+ *      The projected area of the distribution perpendicular to the axis
+ *
+ * \return The parameters of the SGGX phase function stored as a 6D vector
+ *      [S_xx, S_yy, S_zz, S_xy, S_xz, S_yz]
+ */
+template <typename Float>
+dr::Array<Float, 6> sggx_from_axis(const Vector<Float, 3> &axis,
+                                   const Float &sigma_axis,
+                                   const Float &sigma_perp) {
+    Vector<Float, 3> w = dr::normalize(axis);
+    Float perp = dr::sqr(sigma_perp),
+          diff = dr::sqr(sigma_axis) - perp;
+
+    return { dr::fmadd(diff, w.x() * w.x(), perp),
+             dr::fmadd(diff, w.y() * w.y(), perp),
+             dr::fmadd(diff, w.z() * w.z(), perp),
+             diff * w.x() * w.y(),
+             diff * w.x() * w.z(),
+             diff * w.y() * w.z() };
+}
+
 NAMESPACE_END(mitsuba)
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <mitsuba/core/bbox.h>
+#include <mitsuba/core/logger.h>
+#include <mitsuba/core/vector.h>
+#include <vector>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**
+ * \brief Partition the unit cube into an octree adapted to a set of points
+ *
+ * This function implements the construction of the spatial guiding
+ * distribution used by the projective sampling integrators (see \c
+ * OcSpaceDistr in <tt>mitsuba/ad/guiding.py</tt>). The unit cube is first
+ * split into \c x_slices slabs along the X axis. The nodes are then
+ * subdivided level by level: every child node with at most one point becomes
+ * a leaf (starting from the third level), and all remaining nodes become
+ * leaves at level \c max_depth.
+ *
+ * The construction runs on the host and performs a single pass over the
+ * points per level. Points that don't lie inside any of the slabs (i.e. with
+ * <tt>x <= 0</tt>) are ignored.
+ *
+ * \param x
+ *     X coordinates of the points
+ *
+ * \param y
+ *     Y coordinates of the points
+ *
+ * \param z
+ *     Z coordinates of the points
+ *
+ * \param count
+ *     Number of points
+ *
+ * \param x_slices
+ *     Number of root nodes along the X axis
+ *
+ * \param max_depth
+ *     Maximum depth of the octree
+ *
+ * \param max_leaf_count
+ *     Maximum number of leaves. An exception is raised when the construction
+ *     would exceed it.
+ *
+ * \return
+ *     The bounding boxes of all leaves, in the order in which they were
+ *     created.
+ */
+template <typename Scalar>
+std::vector<BoundingBox<Point<Scalar, 3>>>
+build_guiding_octree(const Scalar *x, const Scalar *y, const Scalar *z,
+                     size_t count, uint32_t x_slices, uint32_t max_depth,
+                     uint32_t max_leaf_count) {
+    using Point3 = Point<Scalar, 3>;
+    using BoundingBox3 = BoundingBox<Point3>;
+    constexpr uint32_t Invalid = 0xFFFFFFFFu;
+
+    if (x_slices == 0)
+        Throw("build_guiding_octree(): 'x_slices' must be positive!");
+
+    // 1. Root nodes: slabs along the X axis
+    std::vector<BoundingBox3> nodes(x_slices), children;
+    Scalar step = Scalar(1) / Scalar(x_slices);
+    for (uint32_t i = 0; i < x_slices; ++i)
+        nodes[i] = BoundingBox3(Point3(i * step, 0, 0),
+                                Point3(i + 1 == x_slices ? Scalar(1) : (i + 1) * step, 1, 1));
+
+    std::vector<uint32_t> point_node(count);
+    for (size_t i = 0; i < count; ++i) {
+        // Binary search for the first slab boundary that is >= x (or 'x_slices')
+        uint32_t lo = 0, hi = x_slices;
+        while (lo < hi) {
+            uint32_t mid = (lo + hi) / 2;
+            if (mid * step < x[i])
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        point_node[i] = lo - 1; // Wraps to 'Invalid' when lo == 0
+    }
+
+    std::vector<BoundingBox3> leaves;
+    std::vector<uint32_t> points_per_child, remap;
+
+    // 2. Subdivide the nodes level by level
+    for (uint32_t level = 1; !nodes.empty(); ++level) {
+        uint32_t node_count = (uint32_t) nodes.size();
+
+        // Children are stored by octant, i.e. at 'node + octant * node_count'
+        children.resize((size_t) node_count * 8);
+        for (uint32_t i = 0; i < node_count; ++i) {
+            const BoundingBox3 &b = nodes[i];
+            Point3 c = b.center();
+            for (uint32_t o = 0; o < 8; ++o) {
+                Point3 lo((o & 1) ? c.x() : b.min.x(), (o & 2) ? c.y() : b.min.y(),
+                          (o & 4) ? c.z() : b.min.z()),
+                       hi((o & 1) ? b.max.x() : c.x(), (o & 2) ? b.max.y() : c.y(),
+                          (o & 4) ? b.max.z() : c.z());
+                children[i + (size_t) o * node_count] = BoundingBox3(lo, hi);
+            }
+        }
+
+        // Sort the points into the children
+        points_per_child.assign(children.size(), 0);
+        for (size_t i = 0; i < count; ++i) {
+            uint32_t node = point_node[i];
+            if (node == Invalid)
+                continue;
+            Point3 c = nodes[node].center();
+            uint32_t octant = (x[i] > c.x() ? 1 : 0) | (y[i] > c.y() ? 2 : 0) |
+                              (z[i] > c.z() ? 4 : 0);
+            node += octant * node_count;
+            point_node[i] = node;
+            points_per_child[node]++;
+        }
+
+        // Record the leaves and compact the remaining nodes
+        remap.resize(children.size());
+        nodes.clear();
+        for (size_t i = 0; i < children.size(); ++i) {
+            bool is_leaf = (level >= 3 && points_per_child[i] <= 1) ||
+                           level >= max_depth;
+            if (is_leaf) {
+                leaves.push_back(children[i]);
+                remap[i] = Invalid;
+            } else {
+                remap[i] = (uint32_t) nodes.size();
+                nodes.push_back(children[i]);
+            }
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            if (point_node[i] != Invalid)
+                point_node[i] = remap[point_node[i]];
+        }
+
+        if (!nodes.empty() &&
+            leaves.size() + nodes.size() * 8 > (size_t) max_leaf_count)
+            Throw("OcSpaceDistr: Number of leaf nodes exceeds "
+                  "'max_leaf_count'. Please increase 'max_leaf_count' or "
+                  "increase 'mass_contruction_thres'.");
+    }
+
+    return leaves;
+}
+
+NAMESPACE_END(mitsuba)
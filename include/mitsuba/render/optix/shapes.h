@@ -5,12 +5,14 @@
 // Those header files are located in '/mitsuba/src/shapes/optix/'
 #include "cylinder.cuh"
 #include "disk.cuh"
+#include "ellipsoids.cuh"
 #include "mesh.cuh"
 #include "rectangle.cuh"
 #include "sdfgrid.cuh"
 #include "sphere.cuh"
 #include "bsplinecurve.cuh"
 #include "linearcurve.cuh"
+#include "spheres.cuh"
 #else
 
 #include <unordered_map>
@@ -27,21 +29,25 @@ NAMESPACE_BEGIN(mitsuba)
 enum OptixShapeType {
     BSplineCurve,
     LinearCurve,
+    Spheres,
     Disk,
     Rectangle,
     Sphere,
     Cylinder,
     SDFGrid,
+    Ellipsoids,
     NumOptixShapeTypes
 };
 static std::string OPTIX_SHAPE_TYPE_NAMES[NumOptixShapeTypes] = {
     "BSplineCurve",
     "LinearCurve", 
+    "Spheres",
     "Disk",  
     "Rectangle",
     "Sphere",
     "Cylinder",
-    "SDFGrid"
+    "SDFGrid",
+    "Ellipsoids"
 };
 static std::unordered_map<std::string, size_t> OPTIX_SHAPE_TYPE_INDEX = [](){
     std::unordered_map<std::string, size_t> out;
@@ -53,7 +59,8 @@ static std::unordered_map<std::string, size_t> OPTIX_SHAPE_TYPE_INDEX = [](){
 
 /// Defines the ordering of the shapes for OptiX (hitgroups, SBT)
 static OptixShapeType OPTIX_SHAPE_ORDER[] = {
-    BSplineCurve, LinearCurve, Disk, Rectangle, Sphere, Cylinder, SDFGrid
+    BSplineCurve, LinearCurve, Spheres, Disk, Rectangle, Sphere, Cylinder, SDFGrid,
+    Ellipsoids
 };
 
 static constexpr size_t OPTIX_SHAPE_TYPE_COUNT = std::size(OPTIX_SHAPE_ORDER);
@@ -71,7 +78,7 @@ struct OptixShape {
 static std::unordered_map<OptixShapeType, OptixShape> OPTIX_SHAPES = []() {
     std::unordered_map<OptixShapeType, OptixShape> result;
     for (OptixShapeType type : OPTIX_SHAPE_ORDER)
-        if ((type == BSplineCurve) || (type == LinearCurve))
+        if ((type == BSplineCurve) || (type == LinearCurve) || (type == Spheres))
             result[type] = { string::to_lower(OPTIX_SHAPE_TYPE_NAMES[type]), true };
         else
             result[type] = { string::to_lower(OPTIX_SHAPE_TYPE_NAMES[type]), false };
@@ -96,17 +103,34 @@ struct OptixAccelData {
         OptixTraversableHandle handle = 0ull;
         void* buffer = nullptr;
         uint32_t count = 0u;
+        /// Size of \c buffer (the GAS may be updated in place)
+        size_t buffer_size = 0;
+        /// Scratch memory kept alive across updates of an updatable GAS
+        void* temp_buffer = nullptr;
+        size_t temp_size = 0;
+        /// Number of in-place updates since the last full build
+        uint32_t update_count = 0u;
+        /// Vertex/face counts and index buffers of the build inputs
+        std::vector<uint64_t> topology;
     };
     HandleData meshes;
+    /// Deforming meshes (motion GAS)
+    HandleData motion_meshes;
     HandleData bspline_curves;
     HandleData linear_curves;
+    HandleData spheres;
     HandleData custom_shapes;
 
     ~OptixAccelData() {
         if (meshes.buffer) jit_free(meshes.buffer);
+        if (motion_meshes.buffer) jit_free(motion_meshes.buffer);
         if (bspline_curves.buffer) jit_free(bspline_curves.buffer);
         if (linear_curves.buffer) jit_free(linear_curves.buffer);
+        if (spheres.buffer) jit_free(spheres.buffer);
         if (custom_shapes.buffer) jit_free(custom_shapes.buffer);
+        for (HandleData *h : { &meshes, &motion_meshes, &bspline_curves,
+                               &linear_curves, &spheres, &custom_shapes })
+            if (h->temp_buffer) jit_free(h->temp_buffer);
     }
 };
 
@@ -116,17 +140,20 @@ void fill_hitgroup_records(std::vector<ref<Shape>> &shapes,
                            std::vector<HitGroupSbtRecord> &out_hitgroup_records,
                            const OptixProgramGroup *program_groups) {
 
-    // Fill records in this order: meshes, b-spline curves, linear curves, other
+    // Fill records in this order: meshes, deforming meshes, b-spline curves,
+    // linear curves, spheres, other
     struct {
         size_t idx(const ref<Shape>& shape) const {
             uint32_t type = shape->shape_type();
             if (type == +ShapeType::Mesh)
-                return 0;
+                return shape->is_animated() ? 1 : 0;
             if (type == +ShapeType::BSplineCurve)
-                return 1;
-            if (type == +ShapeType::LinearCurve)
                 return 2;
-            return 3;
+            if (type == +ShapeType::LinearCurve)
+                return 3;
+            if (type == +ShapeType::Spheres)
+                return 4;
+            return 5;
         };
 
         bool operator()(const ref<Shape> &a, const ref<Shape> &b) const {
@@ -147,47 +174,60 @@ void fill_hitgroup_records(std::vector<ref<Shape>> &shapes,
  *
  * Two different GAS will be created for the meshes and the custom shapes. Optix
  * handles to those GAS will be stored in an \ref OptixAccelData.
+ *
+ * Deforming meshes are placed into a separate motion GAS, whose motion keys
+ * are uniformly distributed over the time interval [0, 1]. All deforming
+ * meshes of a GAS must therefore have the same number of keyframes.
+ *
+ * When \c update_interval is nonzero, the mesh GAS is built with
+ * <tt>OPTIX_BUILD_FLAG_ALLOW_UPDATE</tt>. Subsequent calls then refit it in
+ * place (reusing its output and scratch buffers) as long as the topology of
+ * the meshes is unchanged, and perform a full rebuild every \c
+ * update_interval updates to restore the quality of the BVH.
  */
 template <typename Shape>
 void build_gas(const OptixDeviceContext &context,
                const std::vector<ref<Shape>> &shapes,
-               OptixAccelData& out_accel) {
+               OptixAccelData& out_accel,
+               uint32_t update_interval = 0) {
 
     // Separate geometry types
-    std::vector<ref<Shape>> meshes, bspline_curves,
-        linear_curves, custom_shapes;
+    std::vector<ref<Shape>> meshes, motion_meshes, bspline_curves,
+        linear_curves, spheres, custom_shapes;
     for (auto shape : shapes) {
         uint32_t type = shape->shape_type();
-        if (type == +ShapeType::Mesh)
+        if (type == +ShapeType::Mesh && shape->is_animated())
+            motion_meshes.push_back(shape);
+        else if (type == +ShapeType::Mesh)
             meshes.push_back(shape);
         else if (type == +ShapeType::BSplineCurve)
             bspline_curves.push_back(shape);
         else if (type == +ShapeType::LinearCurve)
             linear_curves.push_back(shape);
+        else if (type == +ShapeType::Spheres)
+            spheres.push_back(shape);
         else if (!shape->is_instance())
             custom_shapes.push_back(shape);
     }
 
     // Build a GAS given a subset of shape pointers
     auto build_single_gas = [&context](const std::vector<ref<Shape>> &shape_subset,
-                                       OptixAccelData::HandleData &handle) {
-
-        OptixAccelBuildOptions accel_options = {};
-        accel_options.buildFlags = OPTIX_BUILD_FLAG_ALLOW_COMPACTION |
-                                   OPTIX_BUILD_FLAG_PREFER_FAST_TRACE;
-
-        accel_options.operation  = OPTIX_BUILD_OPERATION_BUILD;
-        accel_options.motionOptions.numKeys = 0;
-        if (handle.buffer) {
-            jit_free(handle.buffer);
-            handle.handle = 0ull;
-            handle.buffer = nullptr;
-            handle.count = 0;
-        }
+                                       OptixAccelData::HandleData &handle,
+                                       uint32_t update_interval,
+                                       uint32_t motion_keys = 0) {
+        auto release = [&handle]() {
+            if (handle.buffer)
+                jit_free(handle.buffer);
+            if (handle.temp_buffer)
+                jit_free(handle.temp_buffer);
+            handle = OptixAccelData::HandleData();
+        };
 
         size_t shapes_count = shape_subset.size();
-        if (shapes_count == 0)
+        if (shapes_count == 0) {
+            release();
             return;
+        }
 
         std::vector<OptixBuildInput> build_inputs(shapes_count);
         for (size_t i = 0; i < shapes_count; i++)
@@ -196,6 +236,64 @@ void build_gas(const OptixDeviceContext &context,
         // Ensure shape data pointers are fully evaluated before building the BVH
         dr::sync_thread();
 
+        // Only triangle meshes with an unchanged topology can be updated
+        bool allow_update = update_interval > 0;
+        std::vector<uint64_t> topology;
+        for (size_t i = 0; i < shapes_count && allow_update; i++) {
+            const OptixBuildInput &input = build_inputs[i];
+            if (input.type != OPTIX_BUILD_INPUT_TYPE_TRIANGLES) {
+                allow_update = false;
+                break;
+            }
+            topology.push_back(input.triangleArray.numVertices);
+            topology.push_back(input.triangleArray.numIndexTriplets);
+            topology.push_back((uint64_t) input.triangleArray.indexBuffer);
+        }
+
+        OptixAccelBuildOptions accel_options = {};
+        accel_options.buildFlags = OPTIX_BUILD_FLAG_ALLOW_COMPACTION |
+                                   OPTIX_BUILD_FLAG_PREFER_FAST_TRACE;
+        if (allow_update)
+            accel_options.buildFlags |= OPTIX_BUILD_FLAG_ALLOW_UPDATE;
+        accel_options.motionOptions.numKeys   = (unsigned short) motion_keys;
+        accel_options.motionOptions.flags     = OPTIX_MOTION_FLAG_NONE;
+        accel_options.motionOptions.timeBegin = 0.f;
+        accel_options.motionOptions.timeEnd   = 1.f;
+
+        if (allow_update && handle.handle && handle.temp_buffer &&
+            handle.update_count < update_interval && handle.topology == topology) {
+            // Refit the existing GAS in place
+            accel_options.operation = OPTIX_BUILD_OPERATION_UPDATE;
+            jit_optix_check(optixAccelBuild(
+                context,
+                (CUstream) jit_cuda_stream(),
+                &accel_options,
+                build_inputs.data(),
+                (unsigned int) shapes_count,
+                (CUdeviceptr) handle.temp_buffer,
+                handle.temp_size,
+                (CUdeviceptr) handle.buffer,
+                handle.buffer_size,
+                &handle.handle,
+                nullptr, // emitted property list
+                0        // num emitted properties
+            ));
+            handle.update_count++;
+            return;
+        }
+
+        accel_options.operation = OPTIX_BUILD_OPERATION_BUILD;
+
+        /* Keep the scratch memory of updatable GAS around, it is large enough
+           for both full builds and in-place updates */
+        void *reused_temp_buffer = nullptr;
+        size_t reused_temp_size = 0;
+        if (allow_update) {
+            std::swap(reused_temp_buffer, handle.temp_buffer);
+            std::swap(reused_temp_size, handle.temp_size);
+        }
+        release();
+
         OptixAccelBufferSizes buffer_sizes;
         jit_optix_check(optixAccelComputeMemoryUsage(
             context,
@@ -205,7 +303,18 @@ void build_gas(const OptixDeviceContext &context,
             &buffer_sizes
         ));
 
-        void* d_temp_buffer = jit_malloc(AllocType::Device, buffer_sizes.tempSizeInBytes);
+        size_t temp_size = buffer_sizes.tempSizeInBytes;
+        if (allow_update)
+            temp_size = std::max(temp_size, buffer_sizes.tempUpdateSizeInBytes);
+
+        void* d_temp_buffer = reused_temp_buffer;
+        if (reused_temp_size < temp_size) {
+            if (reused_temp_buffer)
+                jit_free(reused_temp_buffer);
+            d_temp_buffer = jit_malloc(AllocType::Device, temp_size);
+        } else {
+            temp_size = reused_temp_size;
+        }
         void* output_buffer = jit_malloc(AllocType::Device, buffer_sizes.outputSizeInBytes);
         void* compact_size_buffer = jit_malloc(AllocType::Device, 8);
 
@@ -221,7 +330,7 @@ void build_gas(const OptixDeviceContext &context,
             build_inputs.data(),
             (unsigned int) shapes_count,
             (CUdeviceptr) d_temp_buffer,
-            buffer_sizes.tempSizeInBytes,
+            temp_size,
             (CUdeviceptr) output_buffer,
             buffer_sizes.outputSizeInBytes,
             &accel,
@@ -229,8 +338,15 @@ void build_gas(const OptixDeviceContext &context,
             1                // num emitted properties
         ));
 
-        jit_free(d_temp_buffer);
+        if (allow_update) {
+            handle.temp_buffer = d_temp_buffer;
+            handle.temp_size = temp_size;
+            handle.topology = std::move(topology);
+        } else {
+            jit_free(d_temp_buffer);
+        }
 
+        size_t output_size = buffer_sizes.outputSizeInBytes;
         size_t compact_size;
         jit_memcpy(JitBackend::CUDA,
                    &compact_size,
@@ -251,20 +367,35 @@ void build_gas(const OptixDeviceContext &context,
             ));
             jit_free(output_buffer);
             output_buffer = compact_buffer;
+            output_size = compact_size;
         }
 
         handle.handle = accel;
         handle.buffer = output_buffer;
+        handle.buffer_size = output_size;
         handle.count = (uint32_t) shapes_count;
     };
 
+    using Mesh = typename Shape::RenderAliases::Mesh;
+    uint32_t motion_keys = 0;
+    for (auto &shape : motion_meshes) {
+        uint32_t keys = (uint32_t) static_cast<Mesh *>(shape.get())->motion_key_count();
+        if (motion_keys != 0 && keys != motion_keys)
+            Throw("build_gas(): all deforming meshes of a scene or shape group "
+                  "must have the same number of keyframes (got %u and %u)!",
+                  motion_keys, keys);
+        motion_keys = keys;
+    }
+
     scoped_optix_context guard;
 
-    // Order: meshes, b-spline curves, linear curves, other
-    build_single_gas(custom_shapes, out_accel.custom_shapes);
-    build_single_gas(meshes, out_accel.meshes);
-    build_single_gas(bspline_curves, out_accel.bspline_curves);
-    build_single_gas(linear_curves, out_accel.linear_curves);
+    // Order: meshes, deforming meshes, b-spline curves, linear curves, spheres, other
+    build_single_gas(custom_shapes, out_accel.custom_shapes, 0);
+    build_single_gas(meshes, out_accel.meshes, update_interval);
+    build_single_gas(motion_meshes, out_accel.motion_meshes, 0, motion_keys);
+    build_single_gas(bspline_curves, out_accel.bspline_curves, 0);
+    build_single_gas(linear_curves, out_accel.linear_curves, 0);
+    build_single_gas(spheres, out_accel.spheres, 0);
 }
 
 /// Prepares and fills the \ref OptixInstance array associated with a given list of shapes.
@@ -302,10 +433,12 @@ void prepare_ias(const OptixDeviceContext &context,
         }
     };
 
-    // Order: meshes, b-spline curves, linear curves, other
+    // Order: meshes, deforming meshes, b-spline curves, linear curves, spheres, other
     build_optix_instance(accel.meshes);
+    build_optix_instance(accel.motion_meshes);
     build_optix_instance(accel.bspline_curves);
     build_optix_instance(accel.linear_curves);
+    build_optix_instance(accel.spheres);
     build_optix_instance(accel.custom_shapes);
 
     // Apply the same process to every shape instances
@@ -3,6 +3,7 @@
 #if defined(MI_ENABLE_CUDA)
 
 #include <iomanip>
+#include <string>
 #include <mitsuba/core/platform.h>
 
 // =====================================================
@@ -16,6 +17,7 @@ using OptixModule            = void *;
 using OptixProgramGroup      = void *;
 using OptixResult            = int;
 using OptixTraversableHandle = unsigned long long;
+using OptixTraversableType   = int;
 using OptixBuildOperation    = int;
 using OptixBuildInputType    = int;
 using OptixVertexFormat      = int;
@@ -36,7 +38,9 @@ using OptixDenoiserStructPtr = void*;
 #define OPTIX_BUILD_INPUT_TYPE_CUSTOM_PRIMITIVES 0x2142
 #define OPTIX_BUILD_INPUT_TYPE_INSTANCES         0x2143
 #define OPTIX_BUILD_INPUT_TYPE_CURVES            0x2145
+#define OPTIX_BUILD_INPUT_TYPE_SPHERES           0x2146
 #define OPTIX_BUILD_OPERATION_BUILD              0x2161
+#define OPTIX_BUILD_OPERATION_UPDATE             0x2162
 
 #define OPTIX_GEOMETRY_FLAG_NONE           0
 #define OPTIX_GEOMETRY_FLAG_DISABLE_ANYHIT 1
@@ -54,6 +58,7 @@ using OptixDenoiserStructPtr = void*;
 #define OPTIX_COMPILE_DEBUG_LEVEL_MODERATE       0x2353
 #define OPTIX_COMPILE_DEBUG_LEVEL_FULL           0x2352
 
+#define OPTIX_BUILD_FLAG_ALLOW_UPDATE               1
 #define OPTIX_BUILD_FLAG_ALLOW_COMPACTION           2
 #define OPTIX_BUILD_FLAG_PREFER_FAST_TRACE          4
 #define OPTIX_BUILD_FLAG_ALLOW_RANDOM_VERTEX_ACCESS 16
@@ -71,10 +76,12 @@ using OptixDenoiserStructPtr = void*;
 
 #define OPTIX_PRIMITIVE_TYPE_ROUND_CUBIC_BSPLINE 0x2502
 #define OPTIX_PRIMITIVE_TYPE_ROUND_LINEAR        0x2503
+#define OPTIX_PRIMITIVE_TYPE_SPHERE              0x2506
 
 #define OPTIX_PRIMITIVE_TYPE_FLAGS_CUSTOM              (1 << 0)
 #define OPTIX_PRIMITIVE_TYPE_FLAGS_ROUND_CUBIC_BSPLINE (1 << 2)
 #define OPTIX_PRIMITIVE_TYPE_FLAGS_ROUND_LINEAR        (1 << 3)
+#define OPTIX_PRIMITIVE_TYPE_FLAGS_SPHERE              (1 << 6)
 #define OPTIX_PRIMITIVE_TYPE_FLAGS_TRIANGLE            (1 << 31)
 
 #define OPTIX_CURVE_ENDCAP_DEFAULT 0
@@ -86,6 +93,10 @@ using OptixDenoiserStructPtr = void*;
 #define OPTIX_INSTANCE_FLAG_NONE              0
 #define OPTIX_INSTANCE_FLAG_DISABLE_TRANSFORM (1u << 6)
 
+#define OPTIX_TRAVERSABLE_TYPE_SRT_MOTION_TRANSFORM 0x21C3
+#define OPTIX_TRANSFORM_BYTE_ALIGNMENT              64ull
+#define OPTIX_MOTION_FLAG_NONE                      0
+
 #define OPTIX_RAY_FLAG_NONE                   0
 #define OPTIX_RAY_FLAG_TERMINATE_ON_FIRST_HIT (1u << 2)
 #define OPTIX_RAY_FLAG_DISABLE_CLOSESTHIT     (1u << 3)
@@ -169,6 +180,21 @@ struct OptixBuildInputCurveArray {
     unsigned int endcapFlags;
 };
 
+struct OptixBuildInputSphereArray {
+    const CUdeviceptr* vertexBuffers;
+    unsigned int vertexStrideInBytes;
+    unsigned int numVertices;
+    const CUdeviceptr* radiusBuffers;
+    unsigned int radiusStrideInBytes;
+    int singleRadius;
+    const unsigned int* flags;
+    unsigned int numSbtRecords;
+    CUdeviceptr sbtIndexOffsetBuffer;
+    unsigned int sbtIndexOffsetSizeInBytes;
+    unsigned int sbtIndexOffsetStrideInBytes;
+    unsigned int primitiveIndexOffset;
+};
+
 struct OptixBuildInput {
     OptixBuildInputType type;
     union {
@@ -176,6 +202,7 @@ struct OptixBuildInput {
         OptixBuildInputCustomPrimitiveArray customPrimitiveArray;
         OptixBuildInputInstanceArray instanceArray;
         OptixBuildInputCurveArray curveArray;
+        OptixBuildInputSphereArray sphereArray;
         char pad[1024];
     };
 };
@@ -187,6 +214,17 @@ struct OptixBuiltinISOptions {
     unsigned int curveEndcapFlags;
 };
 
+struct OptixSRTData {
+    float sx, a, b, pvx, sy, c, pvy, sz, pvz, qx, qy, qz, qw, tx, ty, tz;
+};
+
+struct OptixSRTMotionTransform {
+    OptixTraversableHandle child;
+    OptixMotionOptions motionOptions;
+    unsigned int pad[3];
+    OptixSRTData srtData[2];
+};
+
 struct OptixInstance {
     float transform[12];
     unsigned int instanceId;
@@ -356,6 +394,8 @@ D(optixProgramGroupCreate, OptixDeviceContext, const OptixProgramGroupDesc *,
 D(optixSbtRecordPackHeader, OptixProgramGroup, void *);
 D(optixAccelCompact, OptixDeviceContext, CUstream, OptixTraversableHandle,
   CUdeviceptr, size_t, OptixTraversableHandle *);
+D(optixConvertPointerToTraversableHandle, OptixDeviceContext, CUdeviceptr,
+  OptixTraversableType, OptixTraversableHandle *);
 D(optixDenoiserCreate, OptixDeviceContext, OptixDenoiserModelKind,
   const OptixDenoiserOptions *, OptixDenoiserStructPtr *);
 D(optixDenoiserDestroy, OptixDenoiserStructPtr);
@@ -369,12 +409,42 @@ D(optixDenoiserInvoke, OptixDenoiserStructPtr, CUstream,
   unsigned int, unsigned int, CUdeviceptr, size_t);
 D(optixDenoiserComputeIntensity, OptixDenoiserStructPtr, CUstream,
   const OptixImage2D *inputImage, CUdeviceptr, CUdeviceptr, size_t);
+D(optixDeviceContextSetCacheEnabled, OptixDeviceContext, int);
+D(optixDeviceContextSetCacheLocation, OptixDeviceContext, const char *);
+D(optixDeviceContextSetCacheDatabaseSizes, OptixDeviceContext, size_t, size_t);
 
 #undef D
 
 NAMESPACE_BEGIN(mitsuba)
 extern MI_EXPORT_LIB void optix_initialize();
 
+/**
+ * \brief Configure the disk cache of compiled OptiX modules
+ *
+ * OptiX stores the modules that it compiles from the PTX code of Mitsuba's
+ * ray tracing programs in a cache on disk, which makes the creation of the
+ * ray tracing pipeline much faster in subsequent processes. The entries of
+ * the cache are keyed by the PTX code, the compile options (which depend on
+ * the shape types of the scene) and the OptiX and driver versions, hence the
+ * cache never returns stale modules.
+ *
+ * By default, the cache is stored in the directory chosen by the driver
+ * (or the one specified via the \c OPTIX_CACHE_PATH environment variable).
+ * Processes that start in a fresh environment (e.g. containers) should point
+ * it to a persistent location using this function.
+ *
+ * \param path
+ *     Directory of the cache. An empty string disables the cache.
+ *
+ * \param max_size
+ *     Maximum size of the cache in bytes, or zero to keep the driver's
+ *     default limit.
+ *
+ * The setting also applies when OptiX is initialized later on.
+ */
+extern MI_EXPORT_LIB void optix_configure_cache(const std::string &path,
+                                                size_t max_size = 0);
+
 /**
  * \brief RAII wrapper which sets the CUDA context associated to the OptiX
  * context for the current scope.
@@ -20,6 +20,10 @@ NAMESPACE_BEGIN(mitsuba)
  * with a \ref Film which used the `box` \ref ReconstructionFilter. With a
  * filter that spans multiple pixels, the denoiser might identify some local
  * variance as a feature of the scene and will not denoise it.
+ *
+ * The state and scratch buffers of the denoiser are allocated once upon
+ * construction and reused by every subsequent invocation, e.g. when
+ * denoising the consecutive frames of an animation.
  */
 template <typename Float, typename Spectrum>
 class MI_EXPORT_LIB OptixDenoiser : public Object {
@@ -40,10 +44,24 @@ public:
      *      Whether or not shading normals information will also be given to the
      *      Denoiser.
      *
+     * \param temporal
+     *      Whether or not the temporal denoising model should be used. It
+     *      additionally takes the optical flow and the previous denoised
+     *      frame as inputs, which reduces flickering in animations.
+     *
+     * \param tile_size
+     *      When nonzero, the denoiser processes the image in tiles of this
+     *      size (width x height), which are extended by the overlap region
+     *      required by the OptiX denoiser to avoid seams. This bounds the
+     *      memory used by the denoiser's state and scratch buffers, which is
+     *      otherwise proportional to the full input resolution. By default,
+     *      the image is denoised in a single invocation.
+     *
      * \return A callable object which will apply the OptiX denoiser.
      */
     OptixDenoiser(const ScalarVector2u &input_size, bool albedo, bool normals,
-                  bool temporal);
+                  bool temporal,
+                  const ScalarVector2u &tile_size = ScalarVector2u(0));
 
     OptixDenoiser(const OptixDenoiser &other) = delete;
 
@@ -189,10 +207,12 @@ private:
                         const TensorXf &previous_denoised) const;
 
     ScalarVector2u m_input_size;
+    ScalarVector2u m_tile_size;
+    uint32_t m_overlap;
     CUdeviceptr m_state;
-    uint32_t m_state_size;
+    size_t m_state_size;
     CUdeviceptr m_scratch;
-    uint32_t m_scratch_size;
+    size_t m_scratch_size;
     OptixDenoiserOptions m_options;
     bool m_temporal;
     OptixDenoiserStructPtr m_denoiser;
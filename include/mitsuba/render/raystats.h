@@ -0,0 +1,90 @@
+#pragma once
+
+#include <mitsuba/render/fwd.h>
+#include <string>
+
+#if defined(MI_ENABLE_RAY_STATISTICS)
+#  include <atomic>
+#endif
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**
+ * \brief Ray tracing counters of scalar variants
+ *
+ * When Mitsuba is compiled with \c MI_ENABLE_RAY_STATISTICS, the scene and
+ * the kd-tree count traced rays, traversal steps and primitive intersection
+ * tests in thread-local counters. \ref SamplingIntegrator::render() reports
+ * the aggregated values at the end of a render. Otherwise, the macros below
+ * expand to nothing and \ref RayStatistics::report() returns an empty string.
+ */
+struct MI_EXPORT_LIB RayStatistics {
+    enum Counter : uint32_t {
+        /// Primary rays generated by the sensor
+        CameraRays = 0,
+        /// Rays traced via \c Scene::ray_intersect() (including camera rays)
+        IntersectRays,
+        /// Shadow rays traced via \c Scene::ray_test()
+        ShadowRays,
+        /// kd-tree nodes visited during traversal
+        NodeVisits,
+        /// Ray-primitive intersection tests
+        PrimitiveTests,
+
+        CounterCount
+    };
+
+    /// Reset the counters of all threads
+    static void reset();
+
+    /// Return the sum of a counter over all threads
+    static uint64_t value(Counter counter);
+
+    /// Summarize the counters (\c time: duration of the render in ms)
+    static std::string report(float time);
+};
+
+#if defined(MI_ENABLE_RAY_STATISTICS)
+/// Counters of a single thread (only written by that thread)
+struct RayStatisticsRecord {
+    std::atomic<uint64_t> value[RayStatistics::CounterCount] { };
+
+    MI_INLINE void add(uint32_t counter, uint64_t amount) {
+        std::atomic<uint64_t> &v = value[counter];
+        v.store(v.load(std::memory_order_relaxed) + amount,
+                std::memory_order_relaxed);
+    }
+};
+
+extern MI_EXPORT_LIB thread_local RayStatisticsRecord *ray_statistics_record;
+extern MI_EXPORT_LIB RayStatisticsRecord *ray_statistics_register_thread();
+
+MI_INLINE void ray_statistics_add(uint32_t counter, uint64_t amount) {
+    RayStatisticsRecord *record = ray_statistics_record;
+    if (unlikely(!record))
+        record = ray_statistics_register_thread();
+    record->add(counter, amount);
+}
+
+/// Traversal counters kept on the stack and flushed when leaving the scope
+struct RayStatisticsScope {
+    uint64_t nodes = 0, prims = 0;
+    ~RayStatisticsScope() {
+        ray_statistics_add(RayStatistics::NodeVisits, nodes);
+        ray_statistics_add(RayStatistics::PrimitiveTests, prims);
+    }
+};
+
+#  define MI_RAY_STAT(counter, amount)                                         \
+    mitsuba::ray_statistics_add(mitsuba::RayStatistics::counter, amount)
+#  define MI_RAY_STAT_SCOPE() mitsuba::RayStatisticsScope ray_stat_scope
+#  define MI_RAY_STAT_NODE() (++ray_stat_scope.nodes)
+#  define MI_RAY_STAT_PRIM() (++ray_stat_scope.prims)
+#else
+#  define MI_RAY_STAT(counter, amount) ((void) 0)
+#  define MI_RAY_STAT_SCOPE() ((void) 0)
+#  define MI_RAY_STAT_NODE() ((void) 0)
+#  define MI_RAY_STAT_PRIM() ((void) 0)
+#endif
+
+NAMESPACE_END(mitsuba)
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <mitsuba/render/fwd.h>
+#include <string>
+#include <vector>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**
+ * \brief Statistics about the kernels compiled and launched by a render() call
+ *
+ * When enabled via \ref set_enabled(), the outermost <tt>render()</tt> call of
+ * a JIT variant (both \ref SamplingIntegrator and the Python AD integrators)
+ * records Dr.Jit's kernel history and stores a summary that can subsequently
+ * be queried with \ref last(). Scalar variants don't produce statistics.
+ */
+struct MI_EXPORT_LIB RenderStats {
+    /// Information about a single launched kernel
+    struct Kernel {
+        /// Kernel type (\c JIT, \c Reduce, \c VCallReduce, or \c Other)
+        std::string type;
+        /// Hash of the kernel source (empty for non-JIT kernels)
+        std::string hash;
+        /// Number of threads/lanes
+        uint32_t size;
+        /// Number of IR operations
+        uint32_t operation_count;
+        /// Was the kernel found in the in-memory or on-disk cache?
+        bool cache_hit;
+        /// Was the kernel loaded from the on-disk cache?
+        bool cache_disk;
+        /// Time spent generating/compiling/running the kernel (ms)
+        float codegen_time, backend_time, execution_time;
+    };
+
+    /// List of launched kernels in the order of their launch
+    std::vector<Kernel> kernels;
+
+    /// Number of instances each virtual function call domain may dispatch to
+    std::vector<std::pair<std::string, uint32_t>> vcall_targets;
+
+    /// Wall-clock time of the render() call (ms)
+    float render_time = 0.f;
+
+    /// Peak resident memory of the process at the end of the render (bytes)
+    size_t peak_memory = 0;
+
+    /// Number of kernels that had to be compiled
+    size_t cache_misses() const;
+
+    /// Return a human-readable summary
+    std::string to_string() const;
+
+    /// Enable or disable collection by subsequent render() calls
+    static void set_enabled(bool value);
+
+    /// Is the collection of statistics enabled?
+    static bool enabled();
+
+    /**
+     * \brief Start collecting statistics (used by the integrators)
+     *
+     * Returns \c true if collection was started, in which case the caller
+     * must invoke \ref end() once rendering has finished. Nested calls
+     * (e.g. by <tt>render_forward()</tt>) return \c false.
+     */
+    static bool begin();
+
+    /// Stop collecting statistics and make them available via \ref last()
+    static void end(const std::vector<std::pair<std::string, uint32_t>> &vcall_targets);
+
+    /// Return the statistics of the last render() call
+    static RenderStats last();
+};
+
+/// Collects \ref RenderStats over the lifetime of the object
+template <typename Float, typename Spectrum> struct ScopedRenderStats {
+    MI_IMPORT_TYPES()
+    MI_IMPORT_OBJECT_TYPES()
+    using PhaseFunctionPtr = typename RenderAliases::PhaseFunctionPtr;
+
+    ScopedRenderStats() {
+        if constexpr (dr::is_jit_v<Float>)
+            m_active = RenderStats::begin();
+    }
+
+    ~ScopedRenderStats() {
+        if constexpr (dr::is_jit_v<Float>) {
+            if (!m_active)
+                return;
+            RenderStats::end({
+                { "Shape",         registry_size<ShapePtr>() },
+                { "BSDF",          registry_size<BSDFPtr>() },
+                { "Emitter",       registry_size<EmitterPtr>() },
+                { "Sensor",        registry_size<SensorPtr>() },
+                { "Medium",        registry_size<MediumPtr>() },
+                { "PhaseFunction", registry_size<PhaseFunctionPtr>() }
+            });
+        }
+    }
+
+    ScopedRenderStats(const ScopedRenderStats &) = delete;
+    ScopedRenderStats &operator=(const ScopedRenderStats &) = delete;
+
+private:
+    template <typename Ptr> static uint32_t registry_size() {
+        return jit_registry_get_max(dr::backend_v<Float>,
+                                    Ptr::CallSupport::Domain);
+    }
+
+private:
+    bool m_active = false;
+};
+
+NAMESPACE_END(mitsuba)
@@ -104,6 +104,17 @@ public:
      */
     virtual void advance();
 
+    /**
+     * \brief Inform the sampler about the film pixel of the current sample
+     *
+     * Rendering algorithms call this function before drawing the first
+     * component of a camera sample. Samplers that correlate the sequences of
+     * neighboring pixels (e.g. to distribute the error as blue noise in
+     * screen space) can use this information, while all others ignore it.
+     * The default implementation does nothing.
+     */
+    virtual void set_pixel(const Point2u &pixel);
+
     /// Retrieve the next component value from the current sample
     virtual Float next_1d(Mask active = true);
 
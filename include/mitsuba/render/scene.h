@@ -3,8 +3,11 @@
 #include <mitsuba/core/distr_1d.h>
 #include <mitsuba/core/spectrum.h>
 #include <mitsuba/render/emitter.h>
+#include <mitsuba/render/emittercache.h>
 #include <mitsuba/render/shapegroup.h>
 #include <mitsuba/render/fwd.h>
+#include <mitsuba/render/geometrycache.h>
+#include <mitsuba/render/lighttree.h>
 #include <mitsuba/render/sensor.h>
 
 NAMESPACE_BEGIN(mitsuba)
@@ -269,6 +272,40 @@ public:
     SurfaceInteraction3f ray_intersect_naive(const Ray3f &ray,
                                              Mask active = true) const;
 
+    /**
+     * \brief Intersect a packet of rays with the scene (scalar variants only)
+     *
+     * This function is equivalent to calling \ref ray_intersect_preliminary()
+     * on each of the \c count rays, but lets the Embree backend process
+     * coherent rays (e.g. the camera rays of neighboring pixels) as a single
+     * ray stream (<tt>rtcIntersectNp</tt>). Other backends simply trace the
+     * rays one by one.
+     */
+    void ray_intersect_preliminary_packet(const Ray3f *rays,
+                                          PreliminaryIntersection3f *pi,
+                                          size_t count) const;
+
+    /**
+     * \brief Provide the result of a forthcoming intersection query
+     *
+     * In scalar variants, the next call to \ref ray_intersect() or \ref
+     * ray_intersect_preliminary() on the calling thread whose ray exactly
+     * matches \c ray returns a copy of \c pi instead of tracing the ray again.
+     * This allows handing rays that were already traced by \ref
+     * ray_intersect_preliminary_packet() over to integrators, which then
+     * continue each path in scalar form.
+     *
+     * In JIT variants, \c ray and \c pi are wavefronts. Until the pending
+     * result is discarded, the lanes of every intersection query of the same
+     * width whose ray exactly matches the corresponding pending ray reuse
+     * \c pi, and only the remaining lanes are traced. This is used to reuse
+     * cached camera rays across rendering passes.
+     *
+     * Passing \c nullptr discards the pending result.
+     */
+    void set_pending_intersection(const Ray3f *ray,
+                                  const PreliminaryIntersection3f *pi = nullptr) const;
+
     //! @}
     // =============================================================
 
@@ -538,9 +575,65 @@ public:
     /// Return the list of sensors as a Dr.Jit array
     const DynamicBuffer<SensorPtr> &sensors_dr() const { return m_sensors_dr; }
 
+    /**
+     * \brief Return the geometry cache that pages shape groups in and out of
+     * device memory (see \c geometry_budget), or \c nullptr if disabled
+     */
+    GeometryCache<Float, Spectrum> *geometry_cache() const {
+        return m_geometry_cache.get();
+    }
+
+    /**
+     * \brief Return the learned per-region emitter selection cache (see \c
+     * emitter_cache), or \c nullptr if disabled
+     */
+    EmitterSelectionCache<Float, Spectrum> *emitter_cache() const {
+        return m_emitter_cache.get();
+    }
+
+    /**
+     * \brief Rebuild the emitter selection distributions of the emitter
+     * cache from the contributions that were recorded so far
+     *
+     * Emitter sampling only records contributions when the visibility of
+     * the sample is tested (see \ref sample_emitter_direction()). Sampling
+     * integrators call this function between rendering passes. It does
+     * nothing when the \c emitter_cache scene parameter is disabled.
+     */
+    void update_emitter_cache();
+
     //! @}
     // =============================================================
 
+    /// Memory used by an object: name, category, host bytes, device bytes
+    using MemoryRecord = std::tuple<std::string, std::string, size_t, size_t>;
+
+    /**
+     * \brief Estimate the memory used by the objects of the scene
+     *
+     * Walks the scene graph using \ref traverse() and sums up the storage of
+     * the parameters exposed by each object. Every object is only counted
+     * once, under the name it is first reached by (following the naming
+     * convention of <tt>mi.traverse()</tt>). The category of an object is
+     * its base class (e.g. \c Shape, \c Texture, or \c Volume). The
+     * acceleration data structure and the image blocks of the films are
+     * reported separately with the categories \c Accel and \c ImageBlock.
+     *
+     * Only data that is exposed via \ref traverse() is accounted for, which
+     * includes the bulk of the mesh, texture, and volume data. Temporary
+     * variables of Dr.Jit aren't included.
+     */
+    std::vector<MemoryRecord> memory_usage();
+
+    /**
+     * \brief Return a table summarizing \ref memory_usage() per category
+     * and per object (sorted by decreasing size)
+     *
+     * \param max_objects
+     *     Maximum number of objects that are listed
+     */
+    std::string memory_report(size_t max_objects = 20);
+
     /// Traverse the scene graph and invoke the given callback for each object
     void traverse(TraversalCallback *callback) override;
 
@@ -570,6 +663,21 @@ protected:
     /// Unmarks all shapes as dirty
     void clear_shapes_dirty();
 
+    /**
+     * \brief Should emitter queries call the scene's single emitter directly
+     * instead of dispatching over \ref m_emitters_dr?
+     *
+     * This can be disabled via Dr.Jit's \c VCallInline flag (e.g. to debug
+     * the virtual function call code path).
+     */
+    bool single_emitter_call() const {
+        if constexpr (dr::is_jit_v<Float>) {
+            if (!jit_flag(JitFlag::VCallInline))
+                return false;
+        }
+        return m_emitters.size() == 1;
+    }
+
     /// Create the ray-intersection acceleration data structure
     void accel_init_cpu(const Properties &props);
     void accel_init_gpu(const Properties &props);
@@ -582,6 +690,10 @@ protected:
     void accel_release_cpu();
     void accel_release_gpu();
 
+    /// Return the size of the ray-intersection acceleration data structure
+    size_t accel_memory_cpu() const;
+    size_t accel_memory_gpu() const;
+
     static void static_accel_initialization_cpu();
     static void static_accel_initialization_gpu();
     static void static_accel_shutdown_cpu();
@@ -598,11 +710,16 @@ protected:
     MI_INLINE SurfaceInteraction3f ray_intersect_gpu(const Ray3f &ray, uint32_t ray_flags, Mask active) const;
     MI_INLINE SurfaceInteraction3f ray_intersect_naive_cpu(const Ray3f &ray, Mask active) const;
 
+    /// Trace a packet of rays (scalar variants)
+    MI_INLINE void ray_intersect_preliminary_packet_cpu(
+        const Ray3f *rays, PreliminaryIntersection3f *pi, size_t count) const;
+
     /// Trace a shadow ray
     MI_INLINE Mask ray_test_cpu(const Ray3f &ray, Mask coherent, Mask active) const;
     MI_INLINE Mask ray_test_gpu(const Ray3f &ray, Mask active) const;
 
     using ShapeKDTree = mitsuba::ShapeKDTree<Float, Spectrum>;
+    using ShapeBVH = mitsuba::ShapeBVH<Float, Spectrum>;
 
     /// Updates the discrete distribution used to select an emitter
     void update_emitter_sampling_distribution();
@@ -634,6 +751,20 @@ protected:
 
     ScalarFloat m_emitter_pmf;
     std::unique_ptr<DiscreteDistribution<Float>> m_emitter_distr = nullptr;
+    /// Optional light tree used for emitter sampling (see \c light_tree)
+    std::unique_ptr<LightTree<Float, Spectrum>> m_light_tree = nullptr;
+    bool m_use_light_tree;
+    /// Optional learned per-region emitter selection (see \c emitter_cache)
+    std::unique_ptr<EmitterSelectionCache<Float, Spectrum>> m_emitter_cache = nullptr;
+    bool m_use_emitter_cache;
+    uint32_t m_emitter_cache_resolution;
+    ScalarFloat m_emitter_cache_fraction;
+    /// Only skip emitters that can't contribute (see \c light_culling)
+    bool m_use_light_culling;
+    /// Sample emitters using an alias table (see \c alias_sampling)
+    bool m_use_alias_table;
+    /// Optional paging of shape group geometry (see \c geometry_budget)
+    std::unique_ptr<GeometryCache<Float, Spectrum>> m_geometry_cache = nullptr;
 
     std::vector<ref<Shape>> m_silhouette_shapes;
     DynamicBuffer<ShapePtr> m_silhouette_shapes_dr;
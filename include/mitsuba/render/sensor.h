@@ -1,5 +1,6 @@
 #pragma once
 
+#include <mitsuba/core/distr_1d.h>
 #include <mitsuba/core/properties.h>
 #include <mitsuba/core/spectrum.h>
 #include <mitsuba/core/transform.h>
@@ -17,7 +18,7 @@ NAMESPACE_BEGIN(mitsuba)
 template <typename Float, typename Spectrum>
 class MI_EXPORT_LIB Sensor : public Endpoint<Float, Spectrum> {
 public:
-    MI_IMPORT_TYPES(Film, Sampler, Texture)
+    MI_IMPORT_TYPES(Film, Sampler, Scene, Emitter, Texture)
     MI_IMPORT_BASE(Endpoint, sample_ray, m_needs_sample_3)
 
     // =============================================================
@@ -74,6 +75,11 @@ public:
      * In RGB and monochromatic modes, since no wavelengths need to be sampled,
      * this simply returns an empty vector and the value 1.
      *
+     * When the sensor was created with <tt>wavelength_sampling=emitters</tt>
+     * (and without a sensor response function), the wavelengths are drawn
+     * from a mixture of the RGB importance spectrum and its product with the
+     * emission spectra of the scene (see \ref set_scene()).
+     *
      * \param sample
      *     A uniformly distributed 1D value that is used to sample the spectral
      *     dimension of the sensitivity profile.
@@ -87,6 +93,15 @@ public:
     sample_wavelengths(const SurfaceInteraction3f &si, Float sample,
                        Mask active = true) const override;
 
+    /**
+     * \brief Inform the sensor about the properties of the scene
+     *
+     * When emitter-driven wavelength sampling is enabled, this function
+     * tabulates the average emission spectrum of the scene's emitters. Later
+     * changes to the emitters don't update this table.
+     */
+    void set_scene(const Scene *scene) override;
+
     //! @}
     // =============================================================
 
@@ -162,6 +177,10 @@ protected:
     ScalarFloat m_shutter_open_time;
     ref<const Texture> m_srf;
     bool m_alpha;
+
+    /// Importance sample the wavelengths using the emitter spectra?
+    bool m_emitter_wavelengths = false;
+    ContinuousDistribution<Wavelength> m_wavelength_distr;
 };
 
 //! @}
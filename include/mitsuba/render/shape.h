@@ -221,6 +221,24 @@ public:
     ray_intersect_preliminary_scalar(const ScalarRay3f &ray) const;
     virtual bool ray_test_scalar(const ScalarRay3f &ray) const;
 
+    /**
+     * \brief Scalar test for an intersection with a single primitive of the
+     * shape
+     *
+     * This operation is used by the native acceleration data structures for
+     * shapes that are made of several primitives (e.g. curves), which are
+     * then stored individually in the kd-tree or BVH. The default
+     * implementation ignores \c prim_index and forwards the call to
+     * \ref ray_intersect_preliminary_scalar().
+     */
+    virtual std::tuple<ScalarFloat, ScalarPoint2f, ScalarUInt32, ScalarUInt32>
+    ray_intersect_primitive_scalar(ScalarIndex prim_index,
+                                   const ScalarRay3f &ray) const;
+
+    /// Shadow ray variant of \ref ray_intersect_primitive_scalar()
+    virtual bool ray_test_primitive_scalar(ScalarIndex prim_index,
+                                           const ScalarRay3f &ray) const;
+
     /// Macro to declare packet versions of the scalar routine above
     #define MI_DECLARE_RAY_INTERSECT_PACKET(N)                            \
         using FloatP##N   = dr::Packet<dr::scalar_t<Float>, N>;            \
@@ -282,6 +300,15 @@ public:
      */
     virtual Float surface_area() const;
 
+    /**
+     * \brief Return a cone that bounds the shape's surface normals, given by
+     * its axis and half-angle (in radians)
+     *
+     * This is used to bound the emission of area lights. The default
+     * implementation returns the full sphere of directions.
+     */
+    virtual std::pair<ScalarVector3f, ScalarFloat> normal_bounds() const;
+
     /**
      * \brief Returns whether this shape contains the specified attribute.
      *
@@ -400,6 +427,40 @@ public:
     /// Is this shape an instance?
     bool is_instance() const { return class_()->name() == "Instance"; };
 
+    /**
+     * \brief Return the shape group referenced by this instance
+     *
+     * Returns \c nullptr if the shape isn't an instance or if its
+     * transformation is animated. This is used by the native CPU backend to
+     * traverse shape groups directly from its instance acceleration data
+     * structure.
+     */
+    virtual const Shape *instanced_shapegroup() const { return nullptr; }
+
+    /**
+     * \brief Does the transformation or geometry of this shape change over
+     * time?
+     *
+     * Ray tracing backends must then take the time of each ray into account
+     * (motion blur). This is the case for instances with an animated
+     * transformation, deforming meshes (see \ref Mesh::motion_key_count())
+     * and shape groups containing them.
+     */
+    virtual bool is_animated() const { return false; }
+
+    /**
+     * \brief Select the level of detail for renderings from \c viewpoint
+     *
+     * The scene calls this function for all of its shapes with the position
+     * of its first sensor before building the acceleration data structure.
+     * The default implementation does nothing, see the \c instance plugin
+     * for an implementation.
+     */
+    virtual void select_lod(const ScalarPoint3f & /* viewpoint */) { }
+
+    /// Return the world-to-object transformation (host-side copy)
+    const ScalarTransform4f &to_object_scalar() const { return m_to_object.scalar(); }
+
     /// Does the surface of this shape mark a medium transition?
     bool is_medium_transition() const { return m_interior_medium.get() != nullptr ||
                                                m_exterior_medium.get() != nullptr; }
@@ -454,6 +515,17 @@ public:
 #if defined(MI_ENABLE_EMBREE)
     /// Return the Embree version of this shape
     virtual RTCGeometry embree_geometry(RTCDevice device);
+
+    /**
+     * \brief Update the transformation of an existing Embree geometry
+     * (created by \ref embree_geometry()) in place
+     *
+     * This is used when only the transformation of an instance changed, in
+     * which case the top-level BVH is recommitted without recreating the
+     * geometries of the scene. Returns \c false when the geometry must be
+     * recreated instead, which is the default.
+     */
+    virtual bool embree_update_transform(RTCGeometry geom);
 #endif
 
 #if defined(MI_ENABLE_CUDA)
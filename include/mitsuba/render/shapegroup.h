@@ -4,6 +4,7 @@
 
 #if defined(MI_ENABLE_EMBREE)
 #  include <embree3/rtcore.h>
+#  include <mutex>
 #else
 #  include <mitsuba/render/kdtree.h>
 #endif
@@ -18,7 +19,7 @@ template <typename Float, typename Spectrum>
 class MI_EXPORT_LIB ShapeGroup : public Shape<Float, Spectrum> {
 public:
     MI_IMPORT_BASE(Shape, m_id, m_dirty)
-    MI_IMPORT_TYPES(ShapeKDTree, ShapePtr)
+    MI_IMPORT_TYPES(ShapeKDTree, ShapePtr, Mesh)
 
     using typename Base::ScalarSize;
     using typename Base::ScalarRay3f;
@@ -57,9 +58,56 @@ public:
     /// Return whether this shapegroup contains linear curve shapes
     bool has_linear_curves() const { return m_has_linear_curves; }
 
+    /// Return whether this shapegroup contains sphere cloud shapes
+    bool has_spheres() const { return m_has_spheres; }
+
     /// Return whether this shapegroup contains other type of shapes
     bool has_others() const { return m_has_others; }
 
+    /// Return whether this shapegroup contains deforming meshes
+    bool is_animated() const override { return m_has_motion; }
+
+    /// Return the shapes of this group
+    const std::vector<ref<Base>> &shapes() const { return m_shapes; }
+
+    // =============================================================
+    //! @{ \name Geometry paging (see the \c geometry_budget scene parameter)
+    // =============================================================
+
+    /**
+     * \brief Prepare the group for paging its geometry out of device memory
+     *
+     * This creates a proxy mesh spanning the bounding box of the group, which
+     * replaces its shapes in the acceleration data structure while they are
+     * not resident. Must be called before the scene creates its ray tracing
+     * pipeline.
+     */
+    void enable_paging();
+
+    /// Return the proxy mesh of the group (\c nullptr if paging is disabled)
+    Base *proxy() const { return m_proxy.get(); }
+
+    /// Return whether the geometry of the group is resident in device memory
+    bool resident() const { return m_resident; }
+
+    /**
+     * \brief Page the mesh geometry of the group in or out of device memory
+     *
+     * Rays that intersect a non-resident group hit its proxy mesh instead.
+     * The acceleration data structure of the scene must be updated afterwards
+     * via \ref Scene::parameters_changed().
+     */
+    void set_resident(bool resident);
+
+    /**
+     * \brief Return the device memory (in bytes) that is used by the mesh
+     * geometry of the group and its acceleration data structure when resident
+     */
+    size_t geometry_bytes() const;
+
+    //! @}
+    // =============================================================
+
     void traverse(TraversalCallback *callback) override;
     void parameters_changed(const std::vector<std::string> &/*keys*/ = {}) override;
     bool parameters_grad_enabled() const override;
@@ -94,17 +142,27 @@ private:
 #if defined(MI_ENABLE_EMBREE)
     RTCScene m_embree_scene = nullptr;
     std::vector<int> m_embree_geometries;
+    /// Serializes the BVH builds of instances that are created in parallel
+    std::mutex m_embree_mutex;
 #else
     ref<ShapeKDTree> m_kdtree;
 #endif
 
+    /// Stand-in for the shapes while they are paged out of device memory
+    ref<Base> m_proxy;
+    bool m_resident = true;
+
 #if defined(MI_ENABLE_CUDA)
     OptixAccelData m_accel;
     /// OptiX hitgroup sbt offset
     uint32_t m_sbt_offset;
+
+    OptixAccelData m_proxy_accel;
+    uint32_t m_proxy_sbt_offset;
 #endif
 
-    bool m_has_meshes, m_has_bspline_curves, m_has_linear_curves, m_has_others;
+    bool m_has_meshes, m_has_bspline_curves, m_has_linear_curves, m_has_spheres,
+         m_has_others, m_has_motion;
 };
 
 MI_EXTERN_CLASS(ShapeGroup)
@@ -0,0 +1,398 @@
+#pragma once
+
+#include <drjit/dynamic.h>
+#include <drjit/texture.h>
+
+#include <mitsuba/core/bbox.h>
+#include <mitsuba/core/filesystem.h>
+#include <mitsuba/core/logger.h>
+#include <mitsuba/core/object.h>
+#include <mitsuba/core/transform.h>
+#include <mitsuba/render/compacttexture.h>
+#include <mitsuba/render/fwd.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**
+ * \brief Sparse hierarchical storage for 3D volume grids
+ *
+ * Large simulation caches (smoke, clouds, explosions) typically only occupy a
+ * small fraction of their bounding grid. This class stores such volumes in a
+ * shallow tree with a fixed topology similar to NanoVDB: a dense root table
+ * references internal nodes spanning \f$16^3\f$ leaves, each of which in turn
+ * stores a dense brick of \f$8^3\f$ voxels. Only leaves that contain data are
+ * allocated. All other voxels take on the background value zero.
+ *
+ * The class handles loading and writing of sparse volume files (extension
+ * <tt>.svol</tt>, see the documentation of the \c gridvolume plugin for the
+ * specification), which are read directly into the sparse representation
+ * without ever allocating the dense grid. Sparse grids can furthermore be
+ * created from a dense \ref VolumeGrid or from a list of active voxels.
+ *
+ * Lookups are performed by \ref SparseGridTexture.
+ */
+MI_VARIANT
+class MI_EXPORT_LIB SparseVolumeGrid : public Object {
+public:
+    MI_IMPORT_CORE_TYPES()
+    using VolumeGrid = mitsuba::VolumeGrid<Float, Spectrum>;
+
+    /// Base-2 logarithm of the edge length of a leaf node (in voxels)
+    static constexpr uint32_t LeafLog2 = 3;
+    /// Base-2 logarithm of the edge length of an internal node (in leaves)
+    static constexpr uint32_t NodeLog2 = 4;
+    /// Edge length of a leaf node (in voxels)
+    static constexpr uint32_t LeafDim = 1u << LeafLog2;
+    /// Edge length of an internal node (in leaves)
+    static constexpr uint32_t NodeDim = 1u << NodeLog2;
+    /// Number of voxels per leaf node
+    static constexpr uint32_t LeafSize = LeafDim * LeafDim * LeafDim;
+    /// Number of child slots per internal node
+    static constexpr uint32_t NodeSize = NodeDim * NodeDim * NodeDim;
+    /// Marks unallocated nodes in the root table and in the internal nodes
+    static constexpr uint32_t InvalidIndex = 0xFFFFFFFFu;
+
+    /// Return the transformation from the unit axis-aligned box to the grid's bounding box
+    ScalarTransform4f bbox_transform() const {
+        auto scale_transf = ScalarTransform4f::scale(dr::rcp(m_bbox.extents()));
+        auto translation  = ScalarTransform4f::translate(-m_bbox.min);
+        return scale_transf * translation;
+    }
+
+    /**
+     * \brief Load a sparse volume grid from a given filename
+     *
+     * \param path
+     *    Name of the file to be loaded (expected to end in ".svol")
+     */
+    SparseVolumeGrid(const fs::path &path);
+
+    /**
+     * \brief Load a sparse volume grid from an arbitrary stream data source
+     *
+     * \param stream
+     *    Pointer to an arbitrary stream data source
+     */
+    SparseVolumeGrid(Stream *stream);
+
+    /**
+     * \brief Convert a dense volume grid into its sparse representation
+     *
+     * \param grid
+     *    The dense source grid
+     *
+     * \param threshold
+     *    Leaves whose values do not exceed this threshold in magnitude are
+     *    not allocated and hence evaluate to zero.
+     */
+    SparseVolumeGrid(const VolumeGrid *grid, ScalarFloat threshold = 0.f);
+
+    /**
+     * \brief Create a sparse volume grid from a list of active voxels
+     *
+     * \param size
+     *    Resolution of the (virtual) dense grid
+     *
+     * \param channel_count
+     *    Number of channels per voxel
+     *
+     * \param coords
+     *    Integer voxel coordinates, stored as consecutive (x, y, z) triplets
+     *
+     * \param values
+     *    Voxel values, stored as \c channel_count consecutive entries per voxel
+     *
+     * \param count
+     *    Number of active voxels
+     */
+    SparseVolumeGrid(const ScalarVector3u &size, ScalarUInt32 channel_count,
+                     const ScalarUInt32 *coords, const ScalarFloat *values,
+                     size_t count);
+
+    /// Return the resolution of the (virtual) dense voxel grid
+    ScalarVector3u size() const { return m_size; }
+
+    /// Return the number of channels
+    size_t channel_count() const { return m_channel_count; }
+
+    /// Return the resolution of the root table (in internal nodes)
+    ScalarVector3u root_size() const { return m_root_size; }
+
+    /// Return the number of allocated internal nodes
+    size_t node_count() const { return m_nodes.size() / NodeSize; }
+
+    /// Return the number of allocated leaf nodes
+    size_t leaf_count() const { return m_leaf_origin.size(); }
+
+    /// Return the root table holding the index of each internal node
+    const std::vector<ScalarUInt32> &root() const { return m_root; }
+
+    /// Return the child tables of all internal nodes, which hold leaf indices
+    const std::vector<ScalarUInt32> &nodes() const { return m_nodes; }
+
+    /**
+     * \brief Return the voxel values of all leaves
+     *
+     * The data of leaf \c i starts at offset <tt>i * LeafSize *
+     * channel_count()</tt> and is ordered like a small dense \ref VolumeGrid
+     * (x varies fastest, channels are interleaved).
+     */
+    const std::vector<ScalarFloat> &values() const { return m_values; }
+
+    /// Return the coordinates of the first voxel of every leaf
+    const std::vector<ScalarVector3u> &leaf_origins() const { return m_leaf_origin; }
+
+    /// Return the maximum over all voxels and channels of every leaf
+    const std::vector<ScalarFloat> &leaf_max() const { return m_leaf_max; }
+
+    /// Return the precomputed maximum over the volume grid
+    ScalarFloat max() const { return m_max; }
+
+    /**
+     * \brief Return the precomputed maximum over the volume grid per channel
+     *
+     * Pointer allocation/deallocation must be performed by the caller.
+     */
+    void max_per_channel(ScalarFloat *out) const;
+
+    /// Return the fraction of the dense grid covered by allocated leaves
+    ScalarFloat occupancy() const;
+
+    /// Return the size of the tree and voxel data in bytes (excluding metadata)
+    size_t buffer_size() const;
+
+    /**
+     * Write an encoded form of the sparse grid to a binary volume file
+     *
+     * \param path
+     *    Target file name (expected to end in ".svol")
+     */
+    void write(const fs::path &path) const;
+
+    /**
+     * Write an encoded form of the sparse grid to a stream
+     *
+     * \param stream
+     *    Target stream that will receive the encoded output
+     */
+    void write(Stream *stream) const;
+
+    /// Return a human-readable summary of this sparse grid
+    virtual std::string to_string() const override;
+
+    MI_DECLARE_CLASS()
+
+protected:
+    /// Set up an empty tree for the given resolution
+    void initialize(const ScalarVector3u &size, ScalarUInt32 channel_count);
+
+    /// Return the index of the leaf containing \c voxel, allocating it if needed
+    ScalarUInt32 allocate_leaf(const ScalarVector3u &voxel);
+
+    /// Recompute the maxima and leaf origins after the tree has changed
+    void update_statistics();
+
+    void read(Stream *stream);
+
+protected:
+    ScalarVector3u m_size;
+    ScalarVector3u m_root_size;
+    ScalarUInt32 m_channel_count;
+    ScalarBoundingBox3f m_bbox;
+
+    std::vector<ScalarUInt32> m_root;
+    std::vector<ScalarUInt32> m_nodes;
+    std::vector<ScalarFloat> m_values;
+
+    std::vector<ScalarVector3u> m_leaf_origin;
+    std::vector<ScalarFloat> m_leaf_max;
+    ScalarFloat m_max;
+    std::vector<ScalarFloat> m_max_per_channel;
+};
+
+/**
+ * \brief Lookup structure for a \ref SparseVolumeGrid
+ *
+ * The tree is uploaded into flat index and value buffers that are traversed
+ * with gathers, which works the same way on the CPU and within CUDA/LLVM
+ * kernels. The interface mirrors the subset of \c dr::Texture3f that the
+ * \c gridvolume plugin relies on: evaluation uses the same voxel-centered
+ * conventions, filter and wrap modes.
+ *
+ * Neighboring voxels usually reside within the same leaf. Interpolated
+ * lookups therefore traverse the tree once for the first voxel of the stencil
+ * and reuse the cached leaf for all other voxels falling into it.
+ */
+MI_VARIANT
+class SparseGridTexture {
+public:
+    MI_IMPORT_TYPES(SparseVolumeGrid)
+    using FloatStorage  = DynamicBuffer<Float>;
+    using UInt32Storage = DynamicBuffer<UInt32>;
+
+    static constexpr uint32_t LeafLog2     = SparseVolumeGrid::LeafLog2;
+    static constexpr uint32_t NodeLog2     = SparseVolumeGrid::NodeLog2;
+    static constexpr uint32_t LeafDim      = SparseVolumeGrid::LeafDim;
+    static constexpr uint32_t NodeDim      = SparseVolumeGrid::NodeDim;
+    static constexpr uint32_t LeafSize     = SparseVolumeGrid::LeafSize;
+    static constexpr uint32_t NodeSize     = SparseVolumeGrid::NodeSize;
+    static constexpr uint32_t InvalidIndex = SparseVolumeGrid::InvalidIndex;
+    static constexpr size_t MaxChannels    = 6;
+
+    SparseGridTexture() = default;
+
+    /**
+     * \brief Upload the tree of \c grid
+     *
+     * \param values
+     *    Leaf data with \c channels entries per voxel, laid out like
+     *    \ref SparseVolumeGrid::values(). This makes it possible to upload
+     *    converted data (e.g. spectral upsampling coefficients).
+     */
+    SparseGridTexture(const SparseVolumeGrid *grid, const ScalarFloat *values,
+                      size_t channels, dr::FilterMode filter_mode,
+                      dr::WrapMode wrap_mode)
+        : m_shape(grid->size()), m_root_size(grid->root_size()),
+          m_channels(channels), m_filter_mode(filter_mode),
+          m_wrap_mode(wrap_mode) {
+        if (channels > MaxChannels)
+            Throw("SparseGridTexture: at most %zu channels are supported "
+                  "(got %zu)", MaxChannels, channels);
+        size_t value_count = grid->leaf_count() * LeafSize * channels;
+        if (value_count > (size_t) InvalidIndex)
+            Throw("SparseGridTexture: the sparse grid is too large to be "
+                  "indexed with 32 bit integers (%zu values)", value_count);
+
+        m_root   = dr::load<UInt32Storage>(grid->root().data(), grid->root().size());
+        m_nodes  = dr::load<UInt32Storage>(grid->nodes().data(), grid->nodes().size());
+        m_values = dr::load<FloatStorage>(values, value_count);
+    }
+
+    /// Return the resolution of the (virtual) dense grid
+    ScalarVector3i shape() const { return m_shape; }
+
+    /// Return the number of channels
+    size_t channel_count() const { return m_channels; }
+
+    dr::FilterMode filter_mode() const { return m_filter_mode; }
+    dr::WrapMode wrap_mode() const { return m_wrap_mode; }
+
+    /// Return the voxel values of all leaves
+    FloatStorage &values() { return m_values; }
+    const FloatStorage &values() const { return m_values; }
+
+    /// Evaluate the grid at the local position \c p in <tt>[0, 1]^3</tt>
+    void eval(const Point3f &p, Float *out, Mask active = true) const {
+        if (m_filter_mode == dr::FilterMode::Nearest) {
+            Vector3i v = wrap(
+                dr::floor2int<Vector3i>(Vector3f(p) * Vector3f(m_shape)));
+            fetch(lookup_leaf(v, active), v, out, active);
+            return;
+        }
+
+        for (size_t c = 0; c < m_channels; ++c)
+            out[c] = dr::zeros<Float>();
+
+        Float values[MaxChannels];
+        trilinear_stencil(p, active, [&](uint32_t, const Float &w,
+                                         const UInt32 &leaf, const Vector3i &v) {
+            fetch(leaf, v, values, active);
+            for (size_t c = 0; c < m_channels; ++c)
+                out[c] = dr::fmadd(w, values[c], out[c]);
+        });
+    }
+
+    /**
+     * \brief Fetch the 8 voxels of the trilinear interpolation stencil
+     * around \c p (ordered as in \c dr::Texture::eval_fetch())
+     */
+    void eval_fetch(const Point3f &p, dr::Array<Float *, 8> &out,
+                    Mask active = true) const {
+        trilinear_stencil(p, active, [&](uint32_t k, const Float &,
+                                         const UInt32 &leaf, const Vector3i &v) {
+            fetch(leaf, v, out[k], active);
+        });
+    }
+
+protected:
+    Vector3i wrap(const Vector3i &v) const {
+        return Vector3i(wrap_voxel_index(v.x(), m_shape.x(), m_wrap_mode),
+                        wrap_voxel_index(v.y(), m_shape.y(), m_wrap_mode),
+                        wrap_voxel_index(v.z(), m_shape.z(), m_wrap_mode));
+    }
+
+    /// Traverse the tree to find the leaf containing voxel \c v
+    UInt32 lookup_leaf(const Vector3i &v, Mask active) const {
+        Vector3i r = v >> (LeafLog2 + NodeLog2);
+        UInt32 root_index =
+            UInt32((r.z() * m_root_size.y() + r.y()) * m_root_size.x() + r.x());
+        UInt32 node = dr::gather<UInt32>(m_root, root_index, active);
+
+        Mask valid = active && dr::neq(node, InvalidIndex);
+        Vector3i c = (v >> LeafLog2) & (NodeDim - 1);
+        UInt32 child = node * NodeSize +
+                       UInt32((c.z() * NodeDim + c.y()) * NodeDim + c.x());
+        return dr::select(valid, dr::gather<UInt32>(m_nodes, child, valid),
+                          InvalidIndex);
+    }
+
+    /// Read all channels of voxel \c v from \c leaf (zero if unallocated)
+    void fetch(const UInt32 &leaf, const Vector3i &v, Float *out,
+               Mask active) const {
+        Mask valid = active && dr::neq(leaf, InvalidIndex);
+        Vector3i l = v & (LeafDim - 1);
+        UInt32 offset =
+            (leaf * LeafSize + UInt32((l.z() * LeafDim + l.y()) * LeafDim + l.x())) *
+            (uint32_t) m_channels;
+        for (size_t c = 0; c < m_channels; ++c)
+            out[c] = dr::gather<Float>(m_values, offset + (uint32_t) c, valid);
+    }
+
+    /**
+     * \brief Invoke <tt>func(index, weight, leaf, voxel)</tt> for the voxels
+     * of the trilinear interpolation stencil around \c p
+     */
+    template <typename Func>
+    void trilinear_stencil(const Point3f &p, Mask active, Func &&func) const {
+        Vector3f u = dr::fmadd(Vector3f(p), Vector3f(m_shape), -.5f);
+        Vector3i p0 = dr::floor2int<Vector3i>(u);
+        Vector3f w1 = u - Vector3f(p0),
+                 w0 = 1.f - w1;
+        Vector3i v0 = wrap(p0),
+                 v1 = wrap(p0 + 1);
+
+        UInt32 cached_leaf = lookup_leaf(v0, active);
+        Vector3i cached_block = v0 >> LeafLog2;
+
+        for (uint32_t k = 0; k < 8; ++k) {
+            Vector3i v((k & 1) ? v1.x() : v0.x(),
+                       (k & 2) ? v1.y() : v0.y(),
+                       (k & 4) ? v1.z() : v0.z());
+            Float w = ((k & 1) ? w1.x() : w0.x()) *
+                      ((k & 2) ? w1.y() : w0.y()) *
+                      ((k & 4) ? w1.z() : w0.z());
+
+            UInt32 leaf = cached_leaf;
+            if (k > 0) {
+                Mask cached = dr::all(dr::eq(v >> LeafLog2, cached_block));
+                leaf = dr::select(cached, cached_leaf,
+                                  lookup_leaf(v, active && !cached));
+            }
+            func(k, w, leaf, v);
+        }
+    }
+
+protected:
+    ScalarVector3i m_shape;
+    ScalarVector3i m_root_size;
+    size_t m_channels = 0;
+    dr::FilterMode m_filter_mode = dr::FilterMode::Linear;
+    dr::WrapMode m_wrap_mode = dr::WrapMode::Clamp;
+
+    UInt32Storage m_root;
+    UInt32Storage m_nodes;
+    FloatStorage m_values;
+};
+
+MI_EXTERN_CLASS(SparseVolumeGrid)
+NAMESPACE_END(mitsuba)
@@ -4,7 +4,8 @@
 #include <mitsuba/core/spectrum.h>
 #include <mitsuba/render/film.h>
 #include <mitsuba/render/imageblock.h>
-#include <mutex>
+#include <atomic>
+#include <vector>
 
 #if !defined(MI_BLOCK_SIZE)
 #  define MI_BLOCK_SIZE 32
@@ -15,6 +16,16 @@ NAMESPACE_BEGIN(mitsuba)
 /**
  * \brief Generates a spiral of blocks to be rendered.
  *
+ * The spiral order of the blocks is computed once at construction time, and
+ * blocks are then handed out using an atomic counter, so that many worker
+ * threads can query \ref next_block() concurrently without contention.
+ *
+ * To reduce load imbalance at the end of a render, the last blocks of the
+ * final pass can optionally be subdivided into quadrants (see \ref
+ * set_straggler_blocks()). The identifiers of these sub-blocks are chosen so
+ * that <tt>block_id * block_size^2</tt> matches the corresponding range of
+ * the parent block, which keeps per-pixel random number seeds unchanged.
+ *
  * \author Adam Arbree
  * Aug 25, 2005
  * RayTracer.java
@@ -40,32 +51,64 @@ public:
     /// Return the total number of blocks
     uint32_t block_count() { return m_block_count; }
 
+    /**
+     * \brief Return the number of blocks generated by \ref next_block()
+     * over all passes, including sub-blocks of subdivided stragglers
+     */
+    uint32_t total_block_count() const {
+        return m_block_count * (m_passes - 1) + (uint32_t) m_last_pass.size();
+    }
+
+    /**
+     * \brief Subdivide the last \c count blocks of the final pass into
+     * quadrants that are handed out individually
+     *
+     * Has no effect on blocks that are too small to be subdivided.
+     */
+    void set_straggler_blocks(uint32_t count);
+
+    /**
+     * \brief Hand out the blocks in scanline order instead of along a spiral
+     *
+     * Blocks are sorted by row and then by column, while their identifiers
+     * (and therefore per-pixel random number seeds) are left unchanged. This
+     * is required by films that stream finished rows to disk. Must be called
+     * before \ref set_straggler_blocks().
+     */
+    void set_scanline_order();
+
     /// Reset the spiral to its initial state. Does not affect the number of passes.
     void reset();
 
     /**
-     * \brief Return the offset, size, and unique identifier of the next block.
+     * \brief Return the offset, size, unique identifier, and (square) block
+     * size of the next block.
      *
-     * A size of zero indicates that the spiral traversal is done.
+     * The returned block size equals \ref max_block_size() except for
+     * subdivided straggler blocks. It should be used along with the
+     * identifier to derive per-pixel seeds. A size of zero indicates that the
+     * spiral traversal is done.
      */
-    std::tuple<Vector2i, Vector2u, uint32_t> next_block();
+    std::tuple<Vector2i, Vector2u, uint32_t, uint32_t> next_block();
 
     MI_DECLARE_CLASS()
 protected:
-    enum class Direction { Right, Down, Left, Up };
+    /// Block of the precomputed traversal order
+    struct Block {
+        Vector2u offset;
+        Vector2u size;
+        uint32_t id;
+        uint32_t block_size;
+    };
 
-    std::mutex m_mutex;       //< Protects the state for thread safety
+    std::vector<Block> m_blocks_ordered; //< Blocks of a pass in spiral order
+    std::vector<Block> m_last_pass;      //< Blocks of the final pass (may be subdivided)
+    std::atomic<uint32_t> m_counter;     //< Number of blocks handed out so far
     Vector2u m_size;          //< Size of the 2D image (in pixels)
     Vector2u m_offset;        //< Offset to the crop region on the sensor (pixels)
-    Vector2u m_blocks;        //< Number of blocks in each direction
-    Point2i  m_position;      //< Relative position of the current block
-    Direction direction;      //< Current spiral direction
-    uint32_t m_block_counter; //< Number of blocks generated so far
     uint32_t m_block_count;   //< Number of blocks to be generated in pass
-    uint32_t m_passes_left;   //< Remaining spiral passes to be generated
+    uint32_t m_passes;        //< Number of spiral passes to be generated
     uint32_t m_block_size;    //< Size of the (square) blocks (in pixels)
-    uint32_t m_steps_left;    //< Steps before next change of direction
-    uint32_t m_spiral_size;   //< Current spiral size in blocks
 };
 
 NAMESPACE_END(mitsuba)
@@ -41,6 +41,127 @@ MI_INLINE dr::value_t<Array3f> srgb_model_mean(const Array3f &coeff) {
  */
 MI_EXPORT_LIB dr::Array<float, 3> srgb_model_fetch(const Color<float, 3> &);
 
+/**
+ * \brief Convert an array of sRGB color values into model coefficients
+ *
+ * This function processes the values in parallel using multiple threads and
+ * SIMD packets, and is the preferred way of converting whole textures.
+ *
+ * \param data
+ *     Pointer to \c count groups of \c stride values. The first three values
+ *     of every group hold an sRGB color, which is overwritten with the model
+ *     coefficients. The remaining values of a group are left untouched.
+ *
+ * \param mean
+ *     When not \c nullptr, the average of \ref srgb_model_mean() over all
+ *     converted values is written to this address.
+ */
+MI_EXPORT_LIB void srgb_model_fetch(float *data, size_t count,
+                                    size_t stride = 3, double *mean = nullptr);
+
+/// Double precision version of the above
+MI_EXPORT_LIB void srgb_model_fetch(double *data, size_t count,
+                                    size_t stride = 3, double *mean = nullptr);
+
+/**
+ * \brief Return the tables of the spectral upsampling model
+ *
+ * The model is loaded if this didn't already happen. Returns the resolution
+ * of the model and writes pointers to its scale table (\c res entries) and
+ * coefficient table (<tt>3 * res^3 * 3</tt> entries) to \c scale and \c data.
+ */
+MI_EXPORT_LIB uint32_t srgb_model_tables(const float **scale,
+                                         const float **data);
+
+NAMESPACE_BEGIN(detail)
+/**
+ * \brief Vectorized version of \ref srgb_model_fetch()
+ *
+ * This function mirrors <tt>rgb2spec_fetch()</tt> and is generic over the
+ * array type \c Float. The model tables are either pointers into host memory
+ * (for SIMD packets) or Dr.Jit arrays (for JIT variants).
+ */
+template <typename Float, typename Table>
+dr::Array<Float, 3> srgb_model_fetch(const Color<Float, 3> &c, uint32_t res,
+                                     const Table &scale, const Table &data) {
+    using UInt32 = dr::uint32_array_t<Float>;
+    using Mask = dr::mask_t<Float>;
+
+    Color<Float, 3> rgb = dr::clamp(c, 0.f, 1.f);
+
+    // Monochromatic colors are handled analytically
+    Mask mono = dr::eq(rgb.x(), rgb.y()) && dr::eq(rgb.y(), rgb.z());
+    Float v = rgb.x(),
+          mono_z = dr::select(dr::eq(v, 0.f), -dr::Infinity<Float>,
+                   dr::select(dr::eq(v, 1.f), dr::Infinity<Float>,
+                              (v - .5f) * dr::rsqrt(v * (1.f - v))));
+
+    // Determine the largest component
+    Mask m1 = rgb.y() >= rgb.x();
+    UInt32 i = dr::select(m1, UInt32(1), UInt32(0));
+    Float z = dr::select(m1, rgb.y(), rgb.x());
+    Mask m2 = rgb.z() >= z;
+    i = dr::select(m2, UInt32(2), i);
+    z = dr::select(m2, rgb.z(), z);
+
+    Float scale_xy = (float) (res - 1) / z,
+          x = dr::select(dr::eq(i, 0u), rgb.y(), dr::select(dr::eq(i, 1u), rgb.z(), rgb.x())) * scale_xy,
+          y = dr::select(dr::eq(i, 0u), rgb.z(), dr::select(dr::eq(i, 1u), rgb.x(), rgb.y())) * scale_xy;
+
+    // Trilinearly interpolated lookup
+    UInt32 xi = dr::minimum(UInt32(x), res - 2),
+           yi = dr::minimum(UInt32(y), res - 2),
+           zi = dr::binary_search<UInt32>(1, res - 1, [&](UInt32 idx) {
+                    return dr::gather<Float>(scale, idx) <= z;
+                }) - 1;
+    zi = dr::minimum(zi, res - 2);
+
+    UInt32 offset = (((i * res + zi) * res + yi) * res + xi) * 3,
+           dx = 3, dy = 3 * res, dz = 3 * res * res;
+
+    // Don't access the tables with the (invalid) indices of monochromatic colors
+    Mask active = !mono;
+
+    Float s0 = dr::gather<Float>(scale, zi),
+          s1 = dr::gather<Float>(scale, zi + 1);
+
+    Float x1 = x - Float(xi), x0 = 1.f - x1,
+          y1 = y - Float(yi), y0 = 1.f - y1,
+          z1 = (z - s0) / (s1 - s0), z0 = 1.f - z1;
+
+    dr::Array<Float, 3> out;
+    for (uint32_t j = 0; j < 3; ++j) {
+        auto d = [&](uint32_t o) {
+            return dr::gather<Float>(data, offset + o + j, active);
+        };
+        out[j] = ((d(0) * x0 + d(dx) * x1) * y0 +
+                  (d(dy) * x0 + d(dy + dx) * x1) * y1) * z0 +
+                 ((d(dz) * x0 + d(dz + dx) * x1) * y0 +
+                  (d(dz + dy) * x0 + d(dz + dy + dx) * x1) * y1) * z1;
+    }
+
+    return dr::select(mono, dr::Array<Float, 3>(0.f, 0.f, mono_z), out);
+}
+NAMESPACE_END(detail)
+
+/**
+ * \brief Look up the model coefficients for an array of sRGB color values
+ *
+ * JIT version of \ref srgb_model_fetch(), which uploads the model tables and
+ * performs the lookup on the device.
+ */
+template <typename Float, std::enable_if_t<dr::is_jit_v<Float>, int> = 0>
+dr::Array<Float, 3> srgb_model_fetch(const Color<Float, 3> &c) {
+    using FloatD = dr::detached_t<Float>;
+    using Float32 = dr::float32_array_t<FloatD>;
+    const float *scale, *data;
+    uint32_t res = srgb_model_tables(&scale, &data);
+    FloatD scale_v = FloatD(dr::load<Float32>(scale, res)),
+           data_v  = FloatD(dr::load<Float32>(data, (size_t) res * res * res * 9));
+    return dr::Array<Float, 3>(detail::srgb_model_fetch(
+        Color<FloatD, 3>(dr::detach(c)), res, scale_v, data_v));
+}
+
 /// Sanity check: convert the coefficients back to sRGB
 // MI_EXPORT_LIB Color<float, 3> srgb_model_eval_rgb(const dr::Array<float, 3> &);
 
@@ -213,6 +213,15 @@ public:
     /// Does this texture evaluation depend on the UV coordinates
     virtual bool is_spatially_varying() const { return false; }
 
+    /**
+     * \brief Does this texture evaluation use the UV partials
+     * (\c duv_dx and \c duv_dy) of the surface interaction?
+     *
+     * BSDFs query this flag to request the computation of texture-space
+     * differentials (see \ref BSDFFlags::NeedsDifferentials).
+     */
+    virtual bool needs_differentials() const { return false; }
+
     /// Convenience function returning the standard D65 illuminant
     static ref<Texture> D65(ScalarFloat scale = 1.f);
 
@@ -52,6 +52,15 @@ public:
     /// Returns the maximum value of the volume over all dimensions.
     virtual ScalarFloat max() const;
 
+    /**
+     * \brief Returns a lower bound of the values of the volume over all
+     * dimensions.
+     *
+     * This is used, e.g., as the control extinction of residual ratio
+     * tracking. The bound is not necessarily tight.
+     */
+    virtual ScalarFloat min() const;
+
     /**
      * \brief In the case of a multi-channel volume, this function returns
      * the maximum value for each channel.
@@ -60,9 +69,28 @@ public:
      */
     virtual void max_per_channel(ScalarFloat *out) const;
 
+    /**
+     * \brief Returns conservative upper bounds of the volume's values within
+     * the cells of a coarse regular grid that subdivides the volume's local
+     * unit cube.
+     *
+     * The returned array holds <tt>resolution.x() * resolution.y() *
+     * resolution.z()</tt> entries, ordered like the volume data itself (the x
+     * index varies fastest). Every entry bounds all values that a lookup
+     * within the corresponding cell can return, which makes it suitable as a
+     * piecewise-constant majorant for delta tracking.
+     *
+     * The default implementation bounds every cell by \ref max().
+     */
+    virtual std::vector<ScalarFloat>
+    max_per_supervoxel(const ScalarVector3i &resolution) const;
+
     /// Returns the bounding box of the volume
     ScalarBoundingBox3f bbox() const { return m_bbox; }
 
+    /// Returns the transformation that maps world space onto the volume's local unit cube
+    const ScalarTransform4f &to_local() const { return m_to_local; }
+
     /**
      * \brief Returns the resolution of the volume, assuming that it is based
      * on a discrete representation.
@@ -3,6 +3,7 @@
 #include <drjit/tensor.h>
 
 #include <mitsuba/core/bbox.h>
+#include <mitsuba/core/mmap.h>
 #include <mitsuba/core/properties.h>
 #include <mitsuba/core/spectrum.h>
 #include <mitsuba/core/transform.h>
@@ -34,8 +35,15 @@ public:
      *
      * \param path
      *    Name of the file to be loaded
+     *
+     * \param memory_map
+     *    Map the file into memory and access the voxel data in place instead
+     *    of reading it into a separate buffer. This is only possible when
+     *    the file contents match the in-memory representation (single
+     *    precision variants on little endian machines) and is skipped
+     *    otherwise. The data of a memory-mapped grid is read-only.
      */
-    VolumeGrid(const fs::path &path);
+    VolumeGrid(const fs::path &path, bool memory_map = true);
 
     /**
      * \brief Load a VolumeGrid from an arbitrary stream data source
@@ -47,11 +55,24 @@ public:
 
     VolumeGrid(ScalarVector3u size, ScalarUInt32 channel_count);
 
-    /// Return a pointer to the underlying volume storage
-    ScalarFloat *data() { return m_data.get(); }
+    /**
+     * \brief Return a pointer to the underlying volume storage
+     *
+     * The storage must not be modified if the grid is memory-mapped.
+     */
+    ScalarFloat *data() {
+        return m_mmap ? (ScalarFloat *) ((uint8_t *) m_mmap->data() + HeaderSize)
+                      : m_data.get();
+    }
 
     /// Return a pointer to the underlying volume storage
-    const ScalarFloat *data() const { return m_data.get(); }
+    const ScalarFloat *data() const {
+        return m_mmap ? (const ScalarFloat *) ((const uint8_t *) m_mmap->data() + HeaderSize)
+                      : m_data.get();
+    }
+
+    /// Is the voxel data accessed in place within a memory-mapped file?
+    bool is_memory_mapped() const { return (bool) m_mmap; }
 
     /// Return the resolution of the voxel grid
     ScalarVector3u size() const { return m_size; }
@@ -110,10 +131,20 @@ public:
     MI_DECLARE_CLASS()
 
 protected:
+    /// Size of the header that precedes the voxel data in a volume file
+    static constexpr size_t HeaderSize = 48;
+
     void read(Stream *stream);
 
+    /// Read the header (everything except for the voxel data)
+    void read_header(Stream *stream);
+
+    /// Compute the maximum over the grid and over each channel in parallel
+    void update_max();
+
 protected:
     std::unique_ptr<ScalarFloat[]> m_data;
+    ref<MemoryMappedFile> m_mmap;
 
     ScalarVector3u m_size;
     ScalarUInt32 m_channel_count;
@@ -1,4 +1,5 @@
 #include <mitsuba/core/properties.h>
+#include <mitsuba/core/random.h>
 #include <mitsuba/core/spectrum.h>
 #include <mitsuba/core/string.h>
 #include <mitsuba/render/bsdf.h>
@@ -26,6 +27,11 @@ Blended material (:monosp:`blendbsdf`)
    - Two nested BSDF instances that should be mixed according to the specified blending weight
    - |exposed|, |differentiable|
 
+ * - stochastic
+   - |bool|
+   - If set to |true|, :monosp:`eval()` evaluates a single nested BSDF that is chosen
+     stochastically according to the blending weights, instead of all of them. (Default: |false|)
+
 .. subfigstart::
 .. subfigure:: ../../resources/data/docs/images/render/bsdf_blendbsdf.jpg
    :caption: A material created by blending between rough plastic and smooth metal based on a binary bitmap texture
@@ -38,6 +44,15 @@ rough, reflecting, or transmitting) can be mixed with others in this manner to s
 The association of nested BSDF plugins with the two positions in the interpolation is based on the
 alphanumeric order of their identifiers.
 
+Nested blend materials are flattened into a single list of weighted BSDFs when the
+material is constructed, so that every blending weight is evaluated only once. Deep blend
+trees (e.g. layered paints) can furthermore be made cheaper to evaluate by enabling the
+:monosp:`stochastic` mode of the outermost blend: :monosp:`eval()` will then evaluate a
+single nested BSDF, selected proportionally to its weight, which is an unbiased estimate
+of the full blend. :monosp:`pdf()` is always evaluated in full so that multiple importance
+sampling weights remain exact. The :monosp:`stochastic` parameter of nested blend
+materials is ignored.
+
 The following XML snippet describes the material shown above:
 
 .. tabs::
@@ -93,10 +108,11 @@ public:
         if (bsdf_index != 2)
             Throw("BlendBSDF: Two child BSDFs must be specified!");
 
+        m_stochastic = props.get<bool>("stochastic", false);
+
+        // Flatten nested blend trees into a single list of weighted lobes
         m_components.clear();
-        for (size_t i = 0; i < 2; ++i)
-            for (size_t j = 0; j < m_nested_bsdf[i]->component_count(); ++j)
-                m_components.push_back(m_nested_bsdf[i]->flags(j));
+        flatten(this, {});
 
         m_flags = m_nested_bsdf[0]->flags() | m_nested_bsdf[1]->flags();
         dr::set_attr(this, "flags", m_flags);
@@ -115,37 +131,35 @@ public:
                                              Mask active) const override {
         MI_MASKED_FUNCTION(ProfilerPhase::BSDFSample, active);
 
-        Float weight = eval_weight(si, active);
+        std::vector<Float> weights = eval_lobe_weights(si, active);
         if (unlikely(ctx.component != (uint32_t) -1)) {
-            bool sample_first = ctx.component < m_nested_bsdf[0]->component_count();
+            size_t index = lobe_index(ctx.component);
+            const Lobe &lobe = m_lobes[index];
             BSDFContext ctx2(ctx);
-            if (!sample_first)
-                ctx2.component -= (uint32_t) m_nested_bsdf[0]->component_count();
-            else
-                weight = 1.f - weight;
-            auto [bs, result] = m_nested_bsdf[sample_first ? 0 : 1]->sample(ctx2, si, sample1, sample2, active);
-            result *= weight;
+            ctx2.component -= lobe.component_offset;
+            auto [bs, result] = lobe.bsdf->sample(ctx2, si, sample1, sample2, active);
+            result *= weights[index];
             return { bs, result };
         }
 
         BSDFSample3f bs = dr::zeros<BSDFSample3f>();
         Spectrum result(0.f);
 
-        Mask m0 = active && sample1 >  weight,
-             m1 = active && sample1 <= weight;
-
-        if (dr::any_or<true>(m0)) {
-            auto [bs0, result0] = m_nested_bsdf[0]->sample(
-                ctx, si, (sample1 - weight) / (1 - weight), sample2, m0);
-            dr::masked(bs, m0) = bs0;
-            dr::masked(result, m0) = result0;
-        }
+        Mask done = !active;
+        Float offset = 0.f;
+        for (size_t i = m_lobes.size(); i-- > 0; ) {
+            const Float &weight = weights[i];
+            Mask m = !done && (sample1 <= offset + weight || i == 0);
+            done |= m;
+
+            if (dr::any_or<true>(m)) {
+                auto [bs_i, result_i] = m_lobes[i].bsdf->sample(
+                    ctx, si, (sample1 - offset) / weight, sample2, m);
+                dr::masked(bs, m) = bs_i;
+                dr::masked(result, m) = result_i;
+            }
 
-        if (dr::any_or<true>(m1)) {
-            auto [bs1, result1] = m_nested_bsdf[1]->sample(
-                ctx, si, sample1 / weight, sample2, m1);
-            dr::masked(bs, m1) = bs1;
-            dr::masked(result, m1) = result1;
+            offset += weight;
         }
 
         return { bs, result };
@@ -155,19 +169,32 @@ public:
                   const Vector3f &wo, Mask active) const override {
         MI_MASKED_FUNCTION(ProfilerPhase::BSDFEvaluate, active);
 
-        Float weight = eval_weight(si, active);
+        std::vector<Float> weights = eval_lobe_weights(si, active);
         if (unlikely(ctx.component != (uint32_t) -1)) {
-            bool sample_first = ctx.component < m_nested_bsdf[0]->component_count();
+            size_t index = lobe_index(ctx.component);
+            const Lobe &lobe = m_lobes[index];
             BSDFContext ctx2(ctx);
-            if (!sample_first)
-                ctx2.component -= (uint32_t) m_nested_bsdf[0]->component_count();
-            else
-                weight = 1.f - weight;
-            return weight * m_nested_bsdf[sample_first ? 0 : 1]->eval(ctx2, si, wo, active);
+            ctx2.component -= lobe.component_offset;
+            return weights[index] * lobe.bsdf->eval(ctx2, si, wo, active);
         }
 
-        return m_nested_bsdf[0]->eval(ctx, si, wo, active) * (1 - weight) +
-               m_nested_bsdf[1]->eval(ctx, si, wo, active) * weight;
+        Spectrum result(0.f);
+        if (m_stochastic) {
+            UInt32 selected = select_lobe(weights, si, wo, active);
+            for (size_t i = 0; i < m_lobes.size(); ++i) {
+                Mask m = active && dr::eq(selected, (uint32_t) i);
+                if (dr::any_or<true>(m)) {
+                    dr::masked(result, m) =
+                        m_lobes[i].bsdf->eval(ctx, si, wo, m) *
+                        selection_weight(weights[i]);
+                }
+            }
+        } else {
+            for (size_t i = 0; i < m_lobes.size(); ++i)
+                result += m_lobes[i].bsdf->eval(ctx, si, wo, active) * weights[i];
+        }
+
+        return result;
     }
 
     Float pdf(const BSDFContext &ctx, const SurfaceInteraction3f &si,
@@ -175,16 +202,18 @@ public:
         MI_MASKED_FUNCTION(ProfilerPhase::BSDFEvaluate, active);
 
         if (unlikely(ctx.component != (uint32_t) -1)) {
-            bool sample_first = ctx.component < m_nested_bsdf[0]->component_count();
+            const Lobe &lobe = m_lobes[lobe_index(ctx.component)];
             BSDFContext ctx2(ctx);
-            if (!sample_first)
-                ctx2.component -= (uint32_t) m_nested_bsdf[0]->component_count();
-            return m_nested_bsdf[sample_first ? 0 : 1]->pdf(ctx2, si, wo, active);
+            ctx2.component -= lobe.component_offset;
+            return lobe.bsdf->pdf(ctx2, si, wo, active);
         }
 
-        Float weight = eval_weight(si, active);
-        return m_nested_bsdf[0]->pdf(ctx, si, wo, active) * (1 - weight) +
-               m_nested_bsdf[1]->pdf(ctx, si, wo, active) * weight;
+        // The PDF is always evaluated in full, as needed by MIS
+        std::vector<Float> weights = eval_lobe_weights(si, active);
+        Float result(0.f);
+        for (size_t i = 0; i < m_lobes.size(); ++i)
+            result += m_lobes[i].bsdf->pdf(ctx, si, wo, active) * weights[i];
+        return result;
     }
 
     std::pair<Spectrum, Float> eval_pdf(const BSDFContext &ctx,
@@ -193,41 +222,65 @@ public:
                                         Mask active) const override {
         MI_MASKED_FUNCTION(ProfilerPhase::BSDFEvaluate, active);
 
-        Float weight = eval_weight(si, active);
+        std::vector<Float> weights = eval_lobe_weights(si, active);
         if (unlikely(ctx.component != (uint32_t) -1)) {
-            bool sample_first = ctx.component < m_nested_bsdf[0]->component_count();
+            size_t index = lobe_index(ctx.component);
+            const Lobe &lobe = m_lobes[index];
             BSDFContext ctx2(ctx);
-            if (!sample_first)
-                ctx2.component -= (uint32_t) m_nested_bsdf[0]->component_count();
-            else
-                weight = 1.f - weight;
-
-            auto [val, pdf] = m_nested_bsdf[sample_first ? 0 : 1]->eval_pdf(ctx2, si, wo, active);
-            return { weight * val, pdf };
+            ctx2.component -= lobe.component_offset;
+            auto [val, pdf] = lobe.bsdf->eval_pdf(ctx2, si, wo, active);
+            return { weights[index] * val, pdf };
         }
 
-        auto [val_0, pdf_0] = m_nested_bsdf[0]->eval_pdf(ctx, si, wo, active);
-        auto [val_1, pdf_1] = m_nested_bsdf[1]->eval_pdf(ctx, si, wo, active);
+        UInt32 selected(0);
+        if (m_stochastic)
+            selected = select_lobe(weights, si, wo, active);
+
+        Spectrum val(0.f);
+        Float pdf(0.f);
+        for (size_t i = 0; i < m_lobes.size(); ++i) {
+            const Float &weight = weights[i];
+
+            if (m_stochastic) {
+                Mask m = active && dr::eq(selected, (uint32_t) i);
+                if (dr::any_or<true>(m)) {
+                    auto [val_i, pdf_i] = m_lobes[i].bsdf->eval_pdf(ctx, si, wo, active);
+                    dr::masked(val, m) = val_i * selection_weight(weight);
+                    pdf += pdf_i * weight;
+                } else {
+                    pdf += m_lobes[i].bsdf->pdf(ctx, si, wo, active) * weight;
+                }
+            } else {
+                auto [val_i, pdf_i] = m_lobes[i].bsdf->eval_pdf(ctx, si, wo, active);
+                val += val_i * weight;
+                pdf += pdf_i * weight;
+            }
+        }
 
-        return { val_0 * (1 - weight) + val_1 * weight,
-                 pdf_0 * (1 - weight) + pdf_1 * weight };
+        return { val, pdf };
     }
 
-    MI_INLINE Float eval_weight(const SurfaceInteraction3f &si, const Mask &active) const {
-        return dr::clamp(m_weight->eval_1(si, active), 0.f, 1.f);
+    MI_INLINE Float eval_weight(const Texture *texture,
+                                const SurfaceInteraction3f &si,
+                                const Mask &active) const {
+        return dr::clamp(texture->eval_1(si, active), 0.f, 1.f);
     }
 
     Spectrum eval_diffuse_reflectance(const SurfaceInteraction3f &si,
                                      Mask active) const override {
-        Float weight = eval_weight(si, active);
-        return m_nested_bsdf[0]->eval_diffuse_reflectance(si, active) * (1 - weight) +
-               m_nested_bsdf[1]->eval_diffuse_reflectance(si, active) * weight;
+        std::vector<Float> weights = eval_lobe_weights(si, active);
+        Spectrum result(0.f);
+        for (size_t i = 0; i < m_lobes.size(); ++i)
+            result += m_lobes[i].bsdf->eval_diffuse_reflectance(si, active) * weights[i];
+        return result;
     }
 
     std::string to_string() const override {
         std::ostringstream oss;
         oss << "BlendBSDF[" << std::endl
             << "  weight = " << string::indent(m_weight) << "," << std::endl
+            << "  stochastic = " << m_stochastic << "," << std::endl
+            << "  lobe_count = " << m_lobes.size() << "," << std::endl
             << "  nested_bsdf[0] = " << string::indent(m_nested_bsdf[0]) << "," << std::endl
             << "  nested_bsdf[1] = " << string::indent(m_nested_bsdf[1]) << std::endl
             << "]";
@@ -235,9 +288,106 @@ public:
     }
 
     MI_DECLARE_CLASS()
+private:
+    /// A leaf of the (flattened) blend tree
+    struct Lobe {
+        ref<Base> bsdf;
+        /// Blend weights along the path to the lobe (index into \c m_weights, complement?)
+        std::vector<std::pair<uint32_t, bool>> factors;
+        /// Index of the first component of the lobe
+        uint32_t component_offset;
+    };
+
+    /// Recursively collect the lobes of a blend tree
+    void flatten(Base *bsdf, const std::vector<std::pair<uint32_t, bool>> &factors) {
+        BlendBSDF *blend = dynamic_cast<BlendBSDF *>(bsdf);
+        if (!blend) {
+            m_lobes.push_back({ bsdf, factors, (uint32_t) m_components.size() });
+            for (size_t j = 0; j < bsdf->component_count(); ++j)
+                m_components.push_back(bsdf->flags(j));
+            return;
+        }
+
+        uint32_t index = (uint32_t) m_weights.size();
+        m_weights.push_back(blend->m_weight);
+        for (size_t i = 0; i < 2; ++i) {
+            std::vector<std::pair<uint32_t, bool>> factors_i(factors);
+            factors_i.emplace_back(index, i == 0);
+            flatten(blend->m_nested_bsdf[i].get(), factors_i);
+        }
+    }
+
+    /// Evaluate the effective weight of every lobe (each blend weight is evaluated once)
+    std::vector<Float> eval_lobe_weights(const SurfaceInteraction3f &si,
+                                         const Mask &active) const {
+        std::vector<Float> node_weights(m_weights.size());
+        for (size_t i = 0; i < m_weights.size(); ++i)
+            node_weights[i] = eval_weight(m_weights[i].get(), si, active);
+
+        std::vector<Float> weights(m_lobes.size(), Float(1.f));
+        for (size_t i = 0; i < m_lobes.size(); ++i) {
+            for (auto [index, complement] : m_lobes[i].factors) {
+                const Float &w = node_weights[index];
+                weights[i] *= complement ? (1.f - w) : w;
+            }
+        }
+        return weights;
+    }
+
+    /**
+     * Weight of a stochastically selected lobe. Dividing by the detached
+     * weight keeps the estimate unbiased, including its derivative with
+     * respect to the weight.
+     */
+    Float selection_weight(const Float &weight) const {
+        Float w = dr::detach(weight);
+        return dr::select(w > 0.f, weight / w, 0.f);
+    }
+
+    /// Return the lobe containing the given component
+    size_t lobe_index(uint32_t component) const {
+        size_t index = 0;
+        while (index + 1 < m_lobes.size() &&
+               component >= m_lobes[index + 1].component_offset)
+            ++index;
+        return index;
+    }
+
+    /**
+     * Stochastically select a lobe proportionally to its weight for the
+     * one-sample evaluation. The random number is derived from a hash of the
+     * shading point and outgoing direction, since \c eval() doesn't receive
+     * any sample.
+     */
+    UInt32 select_lobe(const std::vector<Float> &weights,
+                       const SurfaceInteraction3f &si, const Vector3f &wo,
+                       const Mask &active) const {
+        using UInt = dr::uint_array_t<Float>;
+        auto bits = [](const Vector3f &v) {
+            return UInt32(dr::reinterpret_array<UInt>(dr::detach(v.x())) ^
+                          dr::reinterpret_array<UInt>(dr::detach(v.y())) * 3u ^
+                          dr::reinterpret_array<UInt>(dr::detach(v.z())) * 7u);
+        };
+        Float sample = Float(sample_tea_float32(bits(Vector3f(si.p)), bits(wo)));
+
+        UInt32 selected(0);
+        Mask done = !active;
+        Float offset = 0.f;
+        for (size_t i = m_lobes.size(); i-- > 0; ) {
+            offset += dr::detach(weights[i]);
+            Mask m = !done && (sample < offset || i == 0);
+            dr::masked(selected, m) = (uint32_t) i;
+            done |= m;
+        }
+        return selected;
+    }
+
 protected:
     ref<Texture> m_weight;
     ref<Base> m_nested_bsdf[2];
+    bool m_stochastic;
+    std::vector<ref<Texture>> m_weights;
+    std::vector<Lobe> m_lobes;
 };
 
 MI_IMPLEMENT_CLASS_VARIANT(BlendBSDF, BSDF)
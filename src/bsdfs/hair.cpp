@@ -17,7 +17,7 @@ Hair material (:monosp:`hair`)
 -------------------------------------------
 
 .. pluginparameters::
- :extra-rows: 6
+ :extra-rows: 7
 
  * - eumelanin, pheomelanin
    - |float|
@@ -57,6 +57,14 @@ Hair material (:monosp:`hair`)
      angle is given in degrees. (Default: 2)
    - |exposed|, |differentiable|, |discontinuous|
 
+ * - azimuthal_resolution
+   - |int|
+   - When positive, the trimmed logistic distribution that models the azimuthal
+     roughness is precomputed into a table with this many entries, which is
+     linearly interpolated instead of being evaluated analytically. Derivatives
+     with respect to the azimuthal roughness are not tracked in this
+     mode. (Default: 0, i.e. analytic evaluation)
+
  * - use_pigmentation
    - |bool|
    - Specifies whether to use the pigmentation concentration values or the
@@ -177,6 +185,11 @@ public:
         }
         m_scale = props.get<ScalarFloat>("scale", 1.f);
 
+        int azimuthal_resolution = props.get<int>("azimuthal_resolution", 0);
+        if (azimuthal_resolution < 0 || azimuthal_resolution == 1)
+            Throw("The azimuthal resolution must be zero or at least 2!");
+        m_azimuthal_resolution = (size_t) azimuthal_resolution;
+
         if (longitudinal_roughness < 0 || longitudinal_roughness > 1.f)
             Throw("The longitudinal roughness should be in the range [0, 1]!");
         if (azimuthal_roughness < 0 || azimuthal_roughness > 1.f)
@@ -561,6 +574,21 @@ private:
         m_v[2] = 4 * m_v[0];
         for (int p = 3; p <= P_MAX; ++p)
             m_v[p] = m_v[2];
+
+        // Tabulate the azimuthal distribution over [-pi, pi]
+        if (m_azimuthal_resolution > 0) {
+            using FloatX = DynamicBuffer<ScalarFloat>;
+            ScalarFloat s = dr::slice(m_s);
+            FloatX phi = dr::linspace<FloatX>(-dr::Pi<ScalarFloat>, dr::Pi<ScalarFloat>,
+                                              m_azimuthal_resolution);
+            FloatX x = dr::abs(phi) / s, e = dr::exp(-x);
+            ScalarFloat norm = 1.f / (1.f + dr::exp(-dr::Pi<ScalarFloat> / s)) -
+                               1.f / (1.f + dr::exp(dr::Pi<ScalarFloat> / s));
+            FloatX values = e / (s * dr::sqr(1.f + e) * norm);
+
+            m_azimuthal_table =
+                dr::load<DynamicBuffer<Float>>(values.data(), dr::width(values));
+        }
     }
 
     /// Sine / cosine of longitudinal angle for direction `w`
@@ -734,12 +762,29 @@ private:
         dr::masked(phi, phi > dr::Pi<Float>) = phi - 2 * dr::Pi<Float>;
 
         // Model roughness with trimmed logistic distribution
+        if (m_azimuthal_resolution > 0)
+            return lerp_gather(m_azimuthal_table,
+                               (phi + dr::Pi<Float>) * dr::InvTwoPi<Float>,
+                               m_azimuthal_resolution);
+
         return (
             logistic(phi, s) /
             (logistic_cdf(dr::Pi<Float>, s) - logistic_cdf(-dr::Pi<Float>, s))
         );
     }
 
+    Float lerp_gather(const DynamicBuffer<Float> &data, Float x,
+                      size_t size) const {
+        using UInt32 = dr::uint32_array_t<Float>;
+        x = dr::clamp(x, 0.f, 1.f) * Float(size - 1);
+        UInt32 index = dr::minimum(UInt32(x), uint32_t(size - 2));
+
+        Float v0 = dr::gather<Float>(data, index),
+              v1 = dr::gather<Float>(data, index + 1);
+
+        return dr::lerp(v0, v1, x - Float(index));
+    }
+
     /// Get the exctionction/absorption
     UnpolarizedSpectrum absorption(const SurfaceInteraction3f &si,
                                    Mask active) const {
@@ -786,6 +831,10 @@ private:
     Float m_v[P_MAX + 1]; /// Longitudinal variance due to roughness
     Float m_s; /// Azimuthal roughness scaling factor
     Float m_sin_2k_alpha[3], m_cos_2k_alpha[3];
+
+    /// Tabulated azimuthal distribution (if \c m_azimuthal_resolution > 0)
+    size_t m_azimuthal_resolution;
+    DynamicBuffer<Float> m_azimuthal_table;
 };
 
 MI_IMPLEMENT_CLASS_VARIANT(Hair, BSDF)
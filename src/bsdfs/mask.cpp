@@ -40,6 +40,13 @@ Note that the standard :ref:`path tracer <integrator-path>` does not have a good
 but the (:ref:`volumetric path tracer <integrator-volpath>`) does. It may thus be preferable when rendering
 scenes that contain the :ref:`mask <bsdf-mask>` plugin, even if there is nothing *volumetric* in the scene.
 
+Every intersection with a transparent region of the mask is a separate path
+vertex that requires another ray tracing operation. Meshes that consist of
+many fully transparent triangles (e.g. foliage cards) can exclude them from
+the acceleration data structure using their ``opacity_bake_resolution``
+parameter (see e.g. the :ref:`PLY <shape-ply>` shape), in which case rays
+never stop at these triangles.
+
 The following XML snippet describes a material configuration for a transparent leaf:
 
 .. tabs::
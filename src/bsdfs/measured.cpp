@@ -1,11 +1,15 @@
 #include <mitsuba/core/properties.h>
 #include <mitsuba/core/fresolver.h>
+#include <mitsuba/core/fstream.h>
 #include <mitsuba/core/tensor.h>
 #include <mitsuba/core/distr_2d.h>
 #include <mitsuba/core/warp.h>
 #include <mitsuba/render/bsdf.h>
 #include <array>
 #include <cmath>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 
 /// Set to 1 to fall back to cosine-weighted sampling (for debugging)
 #define MI_SAMPLE_DIFFUSE     0
@@ -13,6 +17,10 @@
 /// Sample the luminance map before warping by the NDF/VNDF?
 #define MI_SAMPLE_LUMINANCE   1
 
+/// Identifies the files storing the precomputed warping tables ("MWCF")
+#define MI_MEASURED_CACHE_MAGIC   ((uint32_t) 0x4643574D)
+#define MI_MEASURED_CACHE_VERSION ((uint32_t) 1)
+
 NAMESPACE_BEGIN(mitsuba)
 
 /**!
@@ -28,6 +36,17 @@ Measured material (:monosp:`measured`)
    - |string|
    - Filename of the material data file to be loaded
 
+ * - cache
+   - |bool|
+   - Store the precomputed sample warping tables in a file next to the material data
+     (the filename with a ``.cache`` suffix), and reuse them when the material is loaded
+     again. Stale cache files are detected and replaced. (Default: |false|)
+
+ * - half_precision
+   - |bool|
+   - Store the spectral (or RGB) reflectance tables in half precision, which halves
+     their memory footprint. (Default: |false|)
+
 This plugin implements the data-driven material model described in the paper `An
 Adaptive Parameterization for Efficient Material Acquisition and Rendering
 <http://rgl.epfl.ch/publications/Dupuy2018Adaptive>`__. A database containing
@@ -41,6 +60,8 @@ The original measurements are spectral and cover the 360--1000nm range, hence
 it is strongly recommended that you use a spectral workflow. (Many colors
 cannot be reliably represented in RGB, as they are outside of the color gamut)
 
+Instances that load the same file (with the same options) share their data.
+
 .. subfigstart::
 .. subfigure:: ../../resources/data/docs/images/render/bsdf_measured_aniso_morpho_melenaus.jpg
    :caption: Iridescent butterfly (Dorsal *Morpho Melenaus* wing, anisotropic)
@@ -172,52 +193,75 @@ public:
                 (phi_i_data[phi_i.shape[0] - 1] - phi_i_data[0]));
         }
 
-        // Construct NDF interpolant data structure
-        m_ndf = Warp2D0(
-            (ScalarFloat *) ndf.data,
-            ScalarVector2u(ndf.shape[1], ndf.shape[0]),
-            { }, { }, false, false
-        );
-
-        // Construct projected surface area interpolant data structure
-        m_sigma = Warp2D0(
-            (ScalarFloat *) sigma.data,
-            ScalarVector2u(sigma.shape[1], sigma.shape[0]),
-            { }, { }, false, false
-        );
-
-        // Construct VNDF warp data structure
-        m_vndf = Warp2D2(
-            (ScalarFloat *) vndf.data,
-            ScalarVector2u(vndf.shape[3], vndf.shape[2]),
-            {{ (uint32_t) phi_i.shape[0],
-               (uint32_t) theta_i.shape[0] }},
-            {{ (const ScalarFloat *) phi_i.data,
-               (const ScalarFloat *) theta_i.data }}
-        );
-
-        // Construct Luminance warp data structure
-        m_luminance = Warp2D2(
-            (ScalarFloat *) luminance.data,
-            ScalarVector2u(luminance.shape[3], luminance.shape[2]),
-            {{ (uint32_t) phi_i.shape[0],
-               (uint32_t) theta_i.shape[0] }},
-            {{ (const ScalarFloat *) phi_i.data,
-               (const ScalarFloat *) theta_i.data }}
-        );
-
-        // Construct spectral interpolant
-        m_spectra = Warp2D3(
-            (ScalarFloat *) spectra.data,
-            ScalarVector2u(spectra.shape[4], spectra.shape[3]),
-            {{ (uint32_t) phi_i.shape[0],
-               (uint32_t) theta_i.shape[0],
-               (uint32_t) wavelengths.shape[0] }},
-            {{ (const ScalarFloat *) phi_i.data,
-               (const ScalarFloat *) theta_i.data,
-               (const ScalarFloat *) wavelengths.data }},
-            false, false
-        );
+        /* Instances that load the same file with the same options share
+           their sample warping data structures */
+        bool cache = props.get<bool>("cache", false),
+             half_precision = props.get<bool>("half_precision", false);
+        std::string key = tfm::format("%s|%i|%i", fs::absolute(file_path).string(),
+                                      fs::last_write_time(file_path),
+                                      (int) half_precision);
+        m_data = shared_data(key);
+
+        std::call_once(m_data->loaded, [&]() {
+            std::array<uint32_t, 2> param_res = {{ (uint32_t) phi_i.shape[0],
+                                                   (uint32_t) theta_i.shape[0] }};
+            std::array<const ScalarFloat *, 2> param_values = {{
+                (const ScalarFloat *) phi_i.data,
+                (const ScalarFloat *) theta_i.data
+            }};
+            std::array<uint32_t, 3> param_res_spec = {{
+                param_res[0], param_res[1], (uint32_t) wavelengths.shape[0] }};
+            std::array<const ScalarFloat *, 3> param_values_spec = {{
+                param_values[0], param_values[1],
+                (const ScalarFloat *) wavelengths.data }};
+
+            ScalarVector2u ndf_size(ndf.shape[1], ndf.shape[0]),
+                           sigma_size(sigma.shape[1], sigma.shape[0]),
+                           vndf_size(vndf.shape[3], vndf.shape[2]),
+                           luminance_size(luminance.shape[3], luminance.shape[2]),
+                           spectra_size(spectra.shape[4], spectra.shape[3]);
+
+            fs::path cache_path = file_path;
+            cache_path.replace_extension(file_path.extension().string() + ".cache");
+
+            if (cache && read_cache(cache_path, file_path, half_precision,
+                                    [&](Stream *stream) {
+                m_data->ndf = Warp2D0(stream, ndf_size, { }, { }, false);
+                m_data->sigma = Warp2D0(stream, sigma_size, { }, { }, false);
+                m_data->vndf = Warp2D2(stream, vndf_size, param_res, param_values);
+                m_data->luminance =
+                    Warp2D2(stream, luminance_size, param_res, param_values);
+                m_data->spectra = Warp2D3(stream, spectra_size, param_res_spec,
+                                          param_values_spec, false);
+            }))
+                return;
+
+            // Construct NDF interpolant data structure
+            m_data->ndf = Warp2D0((ScalarFloat *) ndf.data, ndf_size,
+                                  { }, { }, false, false);
+
+            // Construct projected surface area interpolant data structure
+            m_data->sigma = Warp2D0((ScalarFloat *) sigma.data, sigma_size,
+                                    { }, { }, false, false);
+
+            // Construct VNDF warp data structure
+            m_data->vndf = Warp2D2((ScalarFloat *) vndf.data, vndf_size,
+                                   param_res, param_values);
+
+            // Construct Luminance warp data structure
+            m_data->luminance = Warp2D2((ScalarFloat *) luminance.data,
+                                        luminance_size, param_res, param_values);
+
+            // Construct spectral interpolant
+            m_data->spectra = Warp2D3((ScalarFloat *) spectra.data, spectra_size,
+                                      param_res_spec, param_values_spec,
+                                      false, false);
+            if (half_precision)
+                m_data->spectra.set_half_precision();
+
+            if (cache)
+                write_cache(cache_path, file_path, half_precision);
+        });
 
         std::string description_str(
             (const char *) description.data,
@@ -276,10 +320,10 @@ public:
         Float pdf = 1.f;
 
         #if MI_SAMPLE_LUMINANCE == 1
-        std::tie(sample, pdf) = m_luminance.sample(sample, params, active);
+        std::tie(sample, pdf) = m_data->luminance.sample(sample, params, active);
         #endif
 
-        auto [u_m, ndf_pdf] = m_vndf.sample(sample, params, active);
+        auto [u_m, ndf_pdf] = m_data->vndf.sample(sample, params, active);
 
         Float phi_m   = u2phi(u_m.y()),
               theta_m = u2theta(u_m.x());
@@ -317,7 +361,7 @@ public:
 
         u_m[1] = u_m[1] - dr::floor(u_m[1]);
 
-    std::tie(sample, std::ignore) = m_vndf.invert(u_m, params, active);
+    std::tie(sample, std::ignore) = m_data->vndf.invert(u_m, params, active);
 #endif // MI_SAMPLE_DIFFUSE
 
         bs.eta               = 1.f;
@@ -328,12 +372,12 @@ public:
         for (size_t i = 0; i < dr::array_size_v<UnpolarizedSpectrum>; ++i) {
             Float params_spec[3] = { phi_i, theta_i,
                 is_spectral_v<Spectrum> ? si.wavelengths[i] : Float((float) i) };
-            spec[i] = m_spectra.eval(sample, params_spec, active);
+            spec[i] = m_data->spectra.eval(sample, params_spec, active);
         }
 
         if (m_jacobian)
-            spec *= m_ndf.eval(u_m, params, active) /
-                    (4 * m_sigma.eval(u_wi, params, active));
+            spec *= m_data->ndf.eval(u_m, params, active) /
+                    (4 * m_data->sigma.eval(u_wi, params, active));
 
         bs.wo.x() = dr::mulsign_neg(bs.wo.x(), sx);
         bs.wo.y() = dr::mulsign_neg(bs.wo.y(), sy);
@@ -381,18 +425,18 @@ public:
         u_m[1] = u_m[1] - dr::floor(u_m[1]);
 
         Float params[2] = { phi_i, theta_i };
-        auto [sample, unused] = m_vndf.invert(u_m, params, active);
+        auto [sample, unused] = m_data->vndf.invert(u_m, params, active);
 
         UnpolarizedSpectrum spec;
         for (size_t i = 0; i < dr::array_size_v<UnpolarizedSpectrum>; ++i) {
             Float params_spec[3] = { phi_i, theta_i,
                 is_spectral_v<Spectrum> ? si.wavelengths[i] : Float((float) i) };
-            spec[i] = m_spectra.eval(sample, params_spec, active);
+            spec[i] = m_data->spectra.eval(sample, params_spec, active);
         }
 
         if (m_jacobian)
-            spec *= m_ndf.eval(u_m, params, active) /
-                    (4 * m_sigma.eval(u_wi, params, active));
+            spec *= m_data->ndf.eval(u_m, params, active) /
+                    (4 * m_data->sigma.eval(u_wi, params, active));
 
         return depolarizer<Spectrum>(spec) & active;
     }
@@ -438,11 +482,11 @@ public:
         u_m[1] = u_m[1] - dr::floor(u_m[1]);
 
         Float params[2] = { phi_i, theta_i };
-        auto [sample, vndf_pdf] = m_vndf.invert(u_m, params, active);
+        auto [sample, vndf_pdf] = m_data->vndf.invert(u_m, params, active);
 
         Float pdf = 1.f;
         #if MI_SAMPLE_LUMINANCE == 1
-        pdf = m_luminance.eval(sample, params, active);
+        pdf = m_data->luminance.eval(sample, params, active);
         #endif
 
         Float jacobian =
@@ -459,17 +503,137 @@ public:
         std::ostringstream oss;
         oss << "Measured[" << std::endl
             << "  filename = \"" << m_name << "\"," << std::endl
-            << "  ndf = " << string::indent(m_ndf.to_string()) << "," << std::endl
-            << "  sigma = " << string::indent(m_sigma.to_string()) << "," << std::endl
-            << "  vndf = " << string::indent(m_vndf.to_string()) << "," << std::endl
-            << "  luminance = " << string::indent(m_luminance.to_string()) << "," << std::endl
-            << "  spectra = " << string::indent(m_spectra.to_string()) << std::endl
+            << "  ndf = " << string::indent(m_data->ndf.to_string()) << "," << std::endl
+            << "  sigma = " << string::indent(m_data->sigma.to_string()) << "," << std::endl
+            << "  vndf = " << string::indent(m_data->vndf.to_string()) << "," << std::endl
+            << "  luminance = " << string::indent(m_data->luminance.to_string()) << "," << std::endl
+            << "  spectra = " << string::indent(m_data->spectra.to_string()) << std::endl
             << "]";
         return oss.str();
     }
 
     MI_DECLARE_CLASS()
 private:
+    /// Sample warping data structures, shared by instances loading the same file
+    struct MeasuredData {
+        Warp2D0 ndf;
+        Warp2D0 sigma;
+        Warp2D2 vndf;
+        Warp2D2 luminance;
+        Warp2D3 spectra;
+
+        /// Set once the data has been loaded
+        std::once_flag loaded;
+    };
+
+    /**
+     * \brief Return the data associated with the given cache key, or a new
+     * instance that has yet to be loaded
+     *
+     * The cache only holds weak references: the data of a file is released
+     * once the last material using it is destroyed.
+     */
+    static std::shared_ptr<MeasuredData> shared_data(const std::string &key) {
+        static std::mutex cache_mutex;
+        static std::unordered_map<std::string, std::weak_ptr<MeasuredData>> cache;
+
+        std::lock_guard<std::mutex> guard(cache_mutex);
+        std::shared_ptr<MeasuredData> data = cache[key].lock();
+        if (!data) {
+            // Drop the entries of materials that no longer exist
+            for (auto it = cache.begin(); it != cache.end();) {
+                if (it->second.expired())
+                    it = cache.erase(it);
+                else
+                    ++it;
+            }
+            data = std::make_shared<MeasuredData>();
+            cache[key] = data;
+        }
+        return data;
+    }
+
+    /**
+     * \brief Load the warping tables from the cache file \c cache_path
+     *
+     * Returns \c false if the file doesn't exist, or if it belongs to
+     * another version of the material file or to another variant.
+     */
+    template <typename Func>
+    bool read_cache(const fs::path &cache_path, const fs::path &file_path,
+                    bool half_precision, Func func) {
+        if (!fs::exists(cache_path))
+            return false;
+
+        try {
+            ref<Stream> stream = new FileStream(cache_path);
+            stream->set_byte_order(Stream::ELittleEndian);
+
+            uint32_t magic = 0, version = 0;
+            uint64_t file_size = 0;
+            int64_t write_time = 0;
+            uint8_t float_size = 0, half = 0;
+            stream->read(magic);
+            stream->read(version);
+            stream->read(file_size);
+            stream->read(write_time);
+            stream->read(float_size);
+            stream->read(half);
+
+            if (magic != MI_MEASURED_CACHE_MAGIC ||
+                version != MI_MEASURED_CACHE_VERSION ||
+                file_size != fs::file_size(file_path) ||
+                write_time != fs::last_write_time(file_path) ||
+                float_size != sizeof(ScalarFloat) ||
+                half != (uint8_t) half_precision)
+                return false;
+
+            func(stream.get());
+            Log(Debug, "Loaded sample warping tables from \"%s\"", cache_path);
+            return true;
+        } catch (const std::exception &e) {
+            Log(Warn, "Could not read the cache file \"%s\": %s", cache_path,
+                e.what());
+            return false;
+        }
+    }
+
+    /// Write the warping tables to the cache file \c cache_path
+    void write_cache(const fs::path &cache_path, const fs::path &file_path,
+                     bool half_precision) {
+        /* Write to a temporary file first, so that concurrent jobs never
+           observe partially written caches */
+        fs::path tmp_path = cache_path;
+        tmp_path.replace_extension(cache_path.extension().string() + ".tmp");
+
+        try {
+            {
+                ref<Stream> stream = new FileStream(tmp_path, FileStream::ETruncReadWrite);
+                stream->set_byte_order(Stream::ELittleEndian);
+                stream->write(MI_MEASURED_CACHE_MAGIC);
+                stream->write(MI_MEASURED_CACHE_VERSION);
+                stream->write((uint64_t) fs::file_size(file_path));
+                stream->write((int64_t) fs::last_write_time(file_path));
+                stream->write((uint8_t) sizeof(ScalarFloat));
+                stream->write((uint8_t) half_precision);
+
+                m_data->ndf.write(stream.get());
+                m_data->sigma.write(stream.get());
+                m_data->vndf.write(stream.get());
+                m_data->luminance.write(stream.get());
+                m_data->spectra.write(stream.get());
+                stream->close();
+            }
+
+            if (!fs::rename(tmp_path, cache_path))
+                Throw("could not rename \"%s\"", tmp_path);
+        } catch (const std::exception &e) {
+            Log(Warn, "Could not write the cache file \"%s\": %s", cache_path,
+                e.what());
+            fs::remove(tmp_path);
+        }
+    }
+
     template <typename Value> Value u2theta(Value u) const {
         return dr::sqr(u) * (dr::Pi<Float> / 2.f);
     }
@@ -488,11 +652,7 @@ private:
 
 private:
     std::string m_name;
-    Warp2D0 m_ndf;
-    Warp2D0 m_sigma;
-    Warp2D2 m_vndf;
-    Warp2D2 m_luminance;
-    Warp2D3 m_spectra;
+    std::shared_ptr<MeasuredData> m_data;
     bool m_isotropic;
     bool m_jacobian;
     int m_reduction;
@@ -146,6 +146,11 @@ This effect is also seen in real life,
 for instance a piece of wood will look slightly darker after coating it
 with a layer of varnish.
 
+The specular and diffuse components are sampled in proportion to an estimate
+of their directional albedo at every shading point, which accounts for the
+Fresnel reflectance at the angle of incidence and the values of the
+reflectance textures.
+
 */
 
 template <typename Float, typename Spectrum>
@@ -177,6 +182,9 @@ public:
         m_components.push_back(BSDFFlags::DeltaReflection | BSDFFlags::FrontSide);
         m_components.push_back(BSDFFlags::DiffuseReflection | BSDFFlags::FrontSide);
         m_flags = m_components[0] | m_components[1];
+        if (m_diffuse_reflectance->needs_differentials() ||
+            (m_specular_reflectance && m_specular_reflectance->needs_differentials()))
+            m_flags = m_flags | BSDFFlags::NeedsDifferentials;
         dr::set_attr(this, "flags", m_flags);
 
         parameters_changed();
@@ -196,15 +204,6 @@ public:
         // Numerically approximate the diffuse Fresnel reflectance
         m_fdr_int = fresnel_diffuse_reflectance(1.f / m_eta);
         m_fdr_ext = fresnel_diffuse_reflectance(m_eta);
-
-        // Compute weights that further steer samples towards the specular or diffuse components
-        Float d_mean = m_diffuse_reflectance->mean(),
-              s_mean = 1.f;
-
-        if (m_specular_reflectance)
-            s_mean = m_specular_reflectance->mean();
-
-        m_specular_sampling_weight = s_mean / (d_mean + s_mean);
     }
 
     std::pair<BSDFSample3f, Spectrum> sample(const BSDFContext &ctx,
@@ -225,17 +224,17 @@ public:
         if (unlikely((!has_specular && !has_diffuse) || dr::none_or<false>(active)))
             return { bs, result };
 
-        // Determine which component should be sampled
-        Float f_i           = std::get<0>(fresnel(cos_theta_i, Float(m_eta))),
-              prob_specular = f_i * m_specular_sampling_weight,
-              prob_diffuse  = (1.f - f_i) * (1.f - m_specular_sampling_weight);
+        Float f_i = std::get<0>(fresnel(cos_theta_i, Float(m_eta)));
 
-        if (unlikely(has_specular != has_diffuse))
-            prob_specular = has_specular ? 1.f : 0.f;
-        else
-            prob_specular = prob_specular / (prob_specular + prob_diffuse);
+        UnpolarizedSpectrum diff = 0.f;
+        if (has_diffuse)
+            diff = m_diffuse_reflectance->eval(si, active);
 
-        prob_diffuse = 1.f - prob_specular;
+        // Determine which component should be sampled
+        Float prob_specular = has_specular ? 1.f : 0.f;
+        if (has_specular && has_diffuse)
+            prob_specular = specular_probability(si, f_i, diff, active);
+        Float prob_diffuse = 1.f - prob_specular;
 
         Mask sample_specular = active && (sample1 < prob_specular),
              sample_diffuse  = active && !sample_specular;
@@ -262,7 +261,7 @@ public:
             dr::masked(bs.sampled_type, sample_diffuse) = +BSDFFlags::DiffuseReflection;
 
             Float f_o = std::get<0>(fresnel(Frame3f::cos_theta(bs.wo), Float(m_eta)));
-            UnpolarizedSpectrum value = m_diffuse_reflectance->eval(si, sample_diffuse);
+            UnpolarizedSpectrum value = diff;
             value /= 1.f - (m_nonlinear ? (value * m_fdr_int) : m_fdr_int);
             value *= m_inv_eta_2 * (1.f - f_i) * (1.f - f_o) / prob_diffuse;
             result[sample_diffuse] = value;
@@ -312,10 +311,9 @@ public:
         Float prob_diffuse = 1.f;
 
         if (ctx.is_enabled(BSDFFlags::DeltaReflection, 0)) {
-            Float f_i           = std::get<0>(fresnel(cos_theta_i, Float(m_eta))),
-                  prob_specular = f_i * m_specular_sampling_weight;
-            prob_diffuse  = (1.f - f_i) * (1.f - m_specular_sampling_weight);
-            prob_diffuse = prob_diffuse / (prob_specular + prob_diffuse);
+            Float f_i = std::get<0>(fresnel(cos_theta_i, Float(m_eta)));
+            prob_diffuse = 1.f - specular_probability(
+                si, f_i, m_diffuse_reflectance->eval(si, active), active);
         }
 
         Float pdf = warp::square_to_cosine_hemisphere_pdf(wo) * prob_diffuse;
@@ -343,19 +341,17 @@ public:
               f_o = std::get<0>(fresnel(cos_theta_o, Float(m_eta)));
 
         UnpolarizedSpectrum diff = m_diffuse_reflectance->eval(si, active);
+
+        Float prob_diffuse = 1.f;
+        if (ctx.is_enabled(BSDFFlags::DeltaReflection, 0))
+            prob_diffuse = 1.f - specular_probability(si, f_i, diff, active);
+
         diff /= 1.f - (m_nonlinear ? (diff * m_fdr_int) : m_fdr_int);
 
         Float hemi_pdf = warp::square_to_cosine_hemisphere_pdf(wo);
 
         diff *= hemi_pdf * m_inv_eta_2 * (1.f - f_i) * (1.f - f_o);
 
-        Float prob_diffuse = 1.f;
-        if (ctx.is_enabled(BSDFFlags::DeltaReflection, 0)) {
-            Float prob_specular = f_i * m_specular_sampling_weight;
-            prob_diffuse  = (1.f - f_i) * (1.f - m_specular_sampling_weight);
-            prob_diffuse = prob_diffuse / (prob_specular + prob_diffuse);
-        }
-
         return { dr::select(active, depolarizer<Spectrum>(diff), 0.f),
                  dr::select(active, hemi_pdf * prob_diffuse, 0.f) };
     }
@@ -365,6 +361,32 @@ public:
         return m_diffuse_reflectance->eval(si, active);
     }
 
+    /**
+     * \brief Probability of sampling the specular component
+     *
+     * The directional albedo of the specular component is estimated by
+     * \c f_i times its reflectance, and that of the diffuse component by
+     * <tt>(1 - f_i)</tt> times the diffuse reflectance (accounting for
+     * internal scattering) and the transmittance toward the exterior.
+     */
+    Float specular_probability(const SurfaceInteraction3f &si, Float f_i,
+                               const UnpolarizedSpectrum &diffuse_reflectance,
+                               Mask active) const {
+        UnpolarizedSpectrum diff = dr::detach(diffuse_reflectance);
+        diff /= 1.f - (m_nonlinear ? (diff * m_fdr_int) : m_fdr_int);
+
+        Float albedo_specular = f_i,
+              albedo_diffuse  = (1.f - f_i) * dr::mean(diff) * m_inv_eta_2 *
+                                (1.f - m_fdr_ext);
+
+        if (m_specular_reflectance)
+            albedo_specular *= dr::mean(
+                dr::detach(m_specular_reflectance->eval(si, active)));
+
+        Float albedo = albedo_specular + albedo_diffuse;
+        return dr::select(albedo > 0.f, albedo_specular / albedo, .5f);
+    }
+
     std::string to_string() const override {
         std::ostringstream oss;
         oss << "SmoothPlastic[" << std::endl
@@ -372,8 +394,7 @@ public:
         if (m_specular_reflectance)
             oss << "  specular_reflectance = " << m_specular_reflectance     << "," << std::endl;
 
-        oss << "  specular_sampling_weight = " << m_specular_sampling_weight << "," << std::endl
-            << "  nonlinear = "                << (int) m_nonlinear          << "," << std::endl
+        oss << "  nonlinear = "                << (int) m_nonlinear          << "," << std::endl
             << "  eta = "                      << m_eta                      << "," << std::endl
             << "  fdr_int = "                  << m_fdr_int                  << "," << std::endl
             << "  fdr_ext = "                  << m_fdr_ext                         << std::endl
@@ -389,7 +410,6 @@ private:
     ScalarFloat m_inv_eta_2;
     ScalarFloat m_fdr_int;
     ScalarFloat m_fdr_ext;
-    Float m_specular_sampling_weight;
     bool m_nonlinear;
 };
 
@@ -332,7 +332,7 @@ public:
                 Spectrum To = mueller::specular_transmission(dr::abs(Frame3f::cos_theta(wo_hat)), m_eta);
 
                 // Diffuse subsurface scattering that acts as a depolarizer.
-                Spectrum diff = depolarizer<Spectrum>(m_diffuse_reflectance->eval(si, active));
+                UnpolarizedSpectrum diffuse = m_diffuse_reflectance->eval(si, active);
 
                 // Refract outside
                 Normal3f n(0.f, 0.f, 1.f);
@@ -342,7 +342,13 @@ public:
                 Vector3f wi_hat_p = -refract(wi_hat, cos_theta_t_i, inv_eta);
                 Spectrum Ti = mueller::specular_transmission(dr::abs(Frame3f::cos_theta(wi_hat_p)), inv_eta);
 
-                diff = Ti * diff * To;
+                /* Ti * depolarizer(diffuse) * To only involves the first
+                   column of Ti and the first row of To, whose nonzero entries
+                   are the upper left 2x2 block of the transmission matrices. */
+                Spectrum diff = dr::zeros<Spectrum>();
+                for (size_t i = 0; i < 2; ++i)
+                    for (size_t j = 0; j < 2; ++j)
+                        diff(i, j) = Ti(i, 0) * diffuse * To(0, j);
 
                 /* The Stokes reference frame vector of `diff` lies perpendicular
                    to the plane of reflection. */
@@ -105,6 +105,18 @@ The Principled BSDF (:monosp:`principled`)
    - The rate of the secondary specular reflection in sampling. (Default:0.0)
    - |exposed|
 
+ * - packed
+   - |texture|
+   - Optional texture whose color channels provide several of the scalar
+     parameters above (see below).
+   - |exposed|, |differentiable|
+
+ * - packed_channels
+   - |string|
+   - Comma-separated list of the parameters stored in the red, green and blue
+     channels of :paramtype:`packed`. Unused channels are denoted by
+     ``none``. (Default: ``none, roughness, metallic``)
+
 The principled BSDF is a complex BSDF with numerous reflective and transmissive
 lobes. It is able to produce great number of material types ranging from metals
 to rough dielectrics. Moreover, the set of input parameters are designed to be
@@ -137,6 +149,12 @@ You can see the general structure of the BSDF below.
 .. subfigend::
     :label: fig-structure-principled
 
+The probabilities of sampling the diffuse lobe and the dielectric reflection of
+the BRDF major lobe are proportional to estimates of their directional albedo
+at every shading point. They account for the Fresnel reflectance at the angle
+of incidence and for the luminance of the base color, and are further scaled
+by the sampling rates above.
+
 The following XML snippet describes a material definition for :monosp:`principled`
 material:
 
@@ -178,6 +196,42 @@ material:
 
 All of the parameters except sampling rates and `eta` should take values
 between 0.0 and 1.0.
+
+Textured materials often store several scalar parameters in the channels of a
+single image, e.g. the occlusion-roughness-metallic (ORM) maps of glTF assets.
+Such an image can be provided via the :paramtype:`packed` parameter, in which
+case the BSDF evaluates it only once per query instead of performing a separate
+lookup for each parameter. The parameters stored in the packed texture must not
+be specified separately. The bitmap should be loaded with ``raw`` set to
+``true``, since its channels don't represent a color.
+
+.. tabs::
+    .. code-tab:: xml
+
+        <bsdf type="principled">
+            <texture type="bitmap" name="base_color">
+                <string name="filename" value="base_color.png"/>
+            </texture>
+            <texture type="bitmap" name="packed">
+                <string name="filename" value="orm.png"/>
+                <boolean name="raw" value="true"/>
+            </texture>
+            <string name="packed_channels" value="none, roughness, metallic"/>
+        </bsdf>
+
+    .. code-tab:: python
+
+        'type': 'principled',
+        'base_color': {
+            'type': 'bitmap',
+            'filename': 'base_color.png'
+        },
+        'packed': {
+            'type': 'bitmap',
+            'filename': 'orm.png',
+            'raw': True
+        },
+        'packed_channels': 'none, roughness, metallic'
  */
 template <typename Float, typename Spectrum>
 class Principled final : public BSDF<Float, Spectrum> {
@@ -190,27 +244,66 @@ public:
         // Parameter definitions
         m_base_color = props.texture<Texture>("base_color", 0.5f);
         m_roughness = props.texture<Texture>("roughness", 0.5f);
-        m_has_anisotropic = get_flag("anisotropic", props);
         m_anisotropic = props.texture<Texture>("anisotropic", 0.0f);
-        m_has_spec_trans = get_flag("spec_trans", props);
+        m_has_anisotropic = get_flag("anisotropic", props, m_anisotropic.get());
         m_spec_trans = props.texture<Texture>("spec_trans", 0.0f);
-        m_has_sheen = get_flag("sheen", props);
+        m_has_spec_trans = get_flag("spec_trans", props, m_spec_trans.get());
         m_sheen = props.texture<Texture>("sheen", 0.0f);
-        m_has_sheen_tint = get_flag("sheen_tint", props);
+        m_has_sheen = get_flag("sheen", props, m_sheen.get());
         m_sheen_tint = props.texture<Texture>("sheen_tint", 0.0f);
-        m_has_flatness = get_flag("flatness", props);
+        m_has_sheen_tint = get_flag("sheen_tint", props, m_sheen_tint.get());
         m_flatness = props.texture<Texture>("flatness", 0.0f);
-        m_has_spec_tint = get_flag("spec_tint", props);
+        m_has_flatness = get_flag("flatness", props, m_flatness.get());
         m_spec_tint = props.texture<Texture>("spec_tint", 0.0f);
-        m_has_metallic = get_flag("metallic", props);
+        m_has_spec_tint = get_flag("spec_tint", props, m_spec_tint.get());
         m_metallic = props.texture<Texture>("metallic", 0.0f);
-        m_has_clearcoat = get_flag("clearcoat", props);
+        m_has_metallic = get_flag("metallic", props, m_metallic.get());
         m_clearcoat = props.texture<Texture>("clearcoat", 0.0f);
+        m_has_clearcoat = get_flag("clearcoat", props, m_clearcoat.get());
         m_clearcoat_gloss = props.texture<Texture>("clearcoat_gloss", 0.0f);
         m_spec_srate = props.get("main_specular_sampling_rate", 1.0f);
         m_clearcoat_srate = props.get("clearcoat_sampling_rate", 1.0f);
         m_diff_refl_srate = props.get("diffuse_reflectance_sampling_rate", 1.0f);
 
+        // Scalar parameters stored in the channels of a single texture
+        for (int &channel : m_packed_channels)
+            channel = -1;
+        if (props.has_property("packed")) {
+            m_packed = props.texture<Texture>("packed");
+            std::vector<std::string> channels = string::tokenize(
+                props.string("packed_channels", "none, roughness, metallic"));
+            if (channels.size() > 3)
+                Throw("The parameter \"packed_channels\" can assign at most "
+                      "three channels!");
+
+            for (size_t i = 0; i < channels.size(); ++i) {
+                if (channels[i] == "none")
+                    continue;
+                auto it = std::find(std::begin(packed_param_names),
+                                    std::end(packed_param_names), channels[i]);
+                if (it == std::end(packed_param_names))
+                    Throw("Invalid entry \"%s\" of \"packed_channels\"!",
+                          channels[i]);
+                size_t param = it - std::begin(packed_param_names);
+                if (m_packed_channels[param] >= 0)
+                    Throw("The parameter \"%s\" was assigned to several "
+                          "channels of \"packed\"!", channels[i]);
+                if (props.has_property(channels[i]))
+                    Throw("The parameter \"%s\" cannot be specified both "
+                          "directly and via \"packed\"!", channels[i]);
+                m_packed_channels[param] = (int) i;
+            }
+
+            m_has_anisotropic |= m_packed_channels[Anisotropic] >= 0;
+            m_has_spec_trans  |= m_packed_channels[SpecTrans] >= 0;
+            m_has_sheen       |= m_packed_channels[Sheen] >= 0;
+            m_has_sheen_tint  |= m_packed_channels[SheenTint] >= 0;
+            m_has_flatness    |= m_packed_channels[Flatness] >= 0;
+            m_has_spec_tint   |= m_packed_channels[SpecTint] >= 0;
+            m_has_metallic    |= m_packed_channels[Metallic] >= 0;
+            m_has_clearcoat   |= m_packed_channels[Clearcoat] >= 0;
+        }
+
         /*Eta and specular has one to one correspondence, both of them can
          * not be specified. */
         if (props.has_property("eta") && props.has_property("specular")) {
@@ -265,6 +358,9 @@ public:
 
         for (auto c : m_components)
             m_flags |= c;
+        if (m_base_color->needs_differentials() ||
+            (m_packed && m_packed->needs_differentials()))
+            m_flags |= +BSDFFlags::NeedsDifferentials;
         dr::set_attr(this, "flags", m_flags);
     }
 
@@ -290,6 +386,13 @@ public:
         callback->put_object("sheen_tint",      m_sheen_tint.get(),  +ParamFlags::Differentiable);
         callback->put_object("spec_trans",      m_spec_trans.get(),  +ParamFlags::Differentiable);
         callback->put_object("flatness",        m_flatness.get(),    +ParamFlags::Differentiable);
+
+        if (m_packed) {
+            uint32_t flags = +ParamFlags::Differentiable;
+            if (m_packed_channels[Roughness] >= 0)
+                flags |= +ParamFlags::Discontinuous;
+            callback->put_object("packed", m_packed.get(), flags);
+        }
     }
 
     void
@@ -345,11 +448,16 @@ public:
             return { bs, 0.0f };
 
         // Store the weights.
-        Float anisotropic = m_has_anisotropic ? m_anisotropic->eval_1(si, active) : 0.0f,
-        roughness = m_roughness->eval_1(si, active),
-        spec_trans = m_has_spec_trans ? m_spec_trans->eval_1(si, active) : 0.0f,
-        metallic = m_has_metallic ? m_metallic->eval_1(si, active) : 0.0f,
-        clearcoat = m_has_clearcoat ? m_clearcoat->eval_1(si, active) : 0.0f;
+        Color3f packed = eval_packed(si, active);
+        Float anisotropic = m_has_anisotropic
+                ? eval_param(m_anisotropic, Anisotropic, packed, si, active) : 0.0f,
+        roughness = eval_param(m_roughness, Roughness, packed, si, active),
+        spec_trans = m_has_spec_trans
+                ? eval_param(m_spec_trans, SpecTrans, packed, si, active) : 0.0f,
+        metallic = m_has_metallic
+                ? eval_param(m_metallic, Metallic, packed, si, active) : 0.0f,
+        clearcoat = m_has_clearcoat
+                ? eval_param(m_clearcoat, Clearcoat, packed, si, active) : 0.0f;
 
         // Weights of BSDF and BRDF major lobes
         Float brdf = (1.0f - metallic) * (1.0f - spec_trans),
@@ -375,9 +483,12 @@ public:
         // Probability definitions
         /* Inside  the material, just microfacet Reflection and
            microfacet Transmission is sampled. */
+        auto [albedo_spec, albedo_diff] = brdf_albedo(
+                si, cos_theta_i, packed, metallic, active && front_side);
         Float prob_spec_reflect = dr::select(
                 front_side,
-                m_spec_srate * (1.0f - bsdf * (1.0f - F_spec_dielectric)),
+                m_spec_srate * (metallic + brdf * albedo_spec +
+                                bsdf * F_spec_dielectric),
                 F_spec_dielectric);
         Float prob_spec_trans =
                 m_has_spec_trans
@@ -391,7 +502,8 @@ public:
                 ? dr::select(front_side, 0.25f * clearcoat * m_clearcoat_srate,
                              0.0f)
                              : 0.0f;
-        Float prob_diffuse = dr::select(front_side, brdf * m_diff_refl_srate, 0.0f);
+        Float prob_diffuse = dr::select(
+                front_side, brdf * albedo_diff * m_diff_refl_srate, 0.0f);
 
         // Normalizing the probabilities.
         Float rcp_tot_prob = dr::rcp(prob_spec_reflect + prob_spec_trans +
@@ -454,7 +566,8 @@ public:
         }
         // The secondary specular reflection sampling (clearcoat)
         if (m_has_clearcoat && dr::any_or<true>(sample_clearcoat)) {
-            Float clearcoat_gloss = m_clearcoat_gloss->eval_1(si, active);
+            Float clearcoat_gloss = eval_param(m_clearcoat_gloss, ClearcoatGloss,
+                                               packed, si, active);
 
             // Clearcoat roughness is mapped between 0.1 and 0.001.
             GTR1 cc_dist(dr::lerp(0.1f, 0.001f, clearcoat_gloss));
@@ -503,13 +616,20 @@ public:
             return 0.0f;
 
         // Store the weights.
-        Float anisotropic = m_has_anisotropic ? m_anisotropic->eval_1(si, active) : 0.0f,
-              roughness = m_roughness->eval_1(si, active),
-              flatness = m_has_flatness ? m_flatness->eval_1(si, active) : 0.0f,
-              spec_trans = m_has_spec_trans ? m_spec_trans->eval_1(si, active) : 0.0f,
-              metallic = m_has_metallic ? m_metallic->eval_1(si, active) : 0.0f,
-              clearcoat = m_has_clearcoat ? m_clearcoat->eval_1(si, active) : 0.0f,
-              sheen = m_has_sheen ? m_sheen->eval_1(si, active) : 0.0f;
+        Color3f packed = eval_packed(si, active);
+        Float anisotropic = m_has_anisotropic
+                  ? eval_param(m_anisotropic, Anisotropic, packed, si, active) : 0.0f,
+              roughness = eval_param(m_roughness, Roughness, packed, si, active),
+              flatness = m_has_flatness
+                  ? eval_param(m_flatness, Flatness, packed, si, active) : 0.0f,
+              spec_trans = m_has_spec_trans
+                  ? eval_param(m_spec_trans, SpecTrans, packed, si, active) : 0.0f,
+              metallic = m_has_metallic
+                  ? eval_param(m_metallic, Metallic, packed, si, active) : 0.0f,
+              clearcoat = m_has_clearcoat
+                  ? eval_param(m_clearcoat, Clearcoat, packed, si, active) : 0.0f,
+              sheen = m_has_sheen
+                  ? eval_param(m_sheen, Sheen, packed, si, active) : 0.0f;
         UnpolarizedSpectrum base_color = m_base_color->eval(si, active);
 
         // Weights for BRDF and BSDF major lobes.
@@ -547,8 +667,11 @@ public:
 
         Mask reflection_compatibilty =
                 mac_mic_compatibility(wh, si.wi, wo, cos_theta_i, true);
-        Mask refraction_compatibilty =
-                mac_mic_compatibility(wh, si.wi, wo, cos_theta_i, false);
+        // Only needed by the specular transmission lobe
+        Mask refraction_compatibilty = false;
+        if (m_has_spec_trans)
+            refraction_compatibilty =
+                    mac_mic_compatibility(wh, si.wi, wo, cos_theta_i, false);
         // Masks for evaluating the lobes.
         // Specular reflection mask
         Mask spec_reflect_active = active && reflect &&
@@ -587,8 +710,8 @@ public:
             Float lum = m_has_spec_tint
                     ? mitsuba::luminance(base_color, si.wavelengths)
                     : 1.0f;
-            Float spec_tint =
-                    m_has_spec_tint ? m_spec_tint->eval_1(si, active) : 0.0f;
+            Float spec_tint = m_has_spec_tint
+                    ? eval_param(m_spec_tint, SpecTint, packed, si, active) : 0.0f;
 
             // Fresnel term
             UnpolarizedSpectrum F_principled = principled_fresnel(
@@ -621,7 +744,8 @@ public:
 
         // Secondary isotropic specular reflection.
         if (m_has_clearcoat && dr::any_or<true>(clearcoat_active)) {
-            Float clearcoat_gloss = m_clearcoat_gloss->eval_1(si, active);
+            Float clearcoat_gloss = eval_param(m_clearcoat_gloss, ClearcoatGloss,
+                                               packed, si, active);
 
             // Clearcoat lobe uses the schlick approximation for Fresnel
             // term.
@@ -685,7 +809,8 @@ public:
 
                 // Tint the sheen evaluation towards the base color.
                 if (m_has_sheen_tint) {
-                    Float sheen_tint = m_sheen_tint->eval_1(si, active);
+                    Float sheen_tint =
+                        eval_param(m_sheen_tint, SheenTint, packed, si, active);
 
                     // Luminance evaluation
                     Float lum = mitsuba::luminance(base_color, si.wavelengths);
@@ -721,14 +846,16 @@ public:
             return 0.0f;
 
         // Store the weights.
-        Float anisotropic =
-                m_has_anisotropic ? m_anisotropic->eval_1(si, active) : 0.0f,
-                roughness = m_roughness->eval_1(si, active),
-                spec_trans =
-                        m_has_spec_trans ? m_spec_trans->eval_1(si, active) : 0.0f;
-        Float metallic = m_has_metallic ? m_metallic->eval_1(si, active) : 0.0f,
-        clearcoat =
-                m_has_clearcoat ? m_clearcoat->eval_1(si, active) : 0.0f;
+        Color3f packed = eval_packed(si, active);
+        Float anisotropic = m_has_anisotropic
+                ? eval_param(m_anisotropic, Anisotropic, packed, si, active) : 0.0f,
+                roughness = eval_param(m_roughness, Roughness, packed, si, active),
+                spec_trans = m_has_spec_trans
+                ? eval_param(m_spec_trans, SpecTrans, packed, si, active) : 0.0f;
+        Float metallic = m_has_metallic
+                ? eval_param(m_metallic, Metallic, packed, si, active) : 0.0f,
+        clearcoat = m_has_clearcoat
+                ? eval_param(m_clearcoat, Clearcoat, packed, si, active) : 0.0f;
 
         // BRDF and BSDF major lobe weights
         Float brdf = (1.0f - metallic) * (1.0f - spec_trans),
@@ -760,9 +887,12 @@ public:
                 fresnel(dr::dot(si.wi, wh), m_eta);
 
         // Defining the probabilities
+        auto [albedo_spec, albedo_diff] = brdf_albedo(
+                si, cos_theta_i, packed, metallic, active && front_side);
         Float prob_spec_reflect = dr::select(
                 front_side,
-                m_spec_srate * (1.0f - bsdf * (1.0f - F_spec_dielectric)),
+                m_spec_srate * (metallic + brdf * albedo_spec +
+                                bsdf * F_spec_dielectric),
                 F_spec_dielectric);
         Float prob_spec_trans =
                 m_has_spec_trans
@@ -775,8 +905,8 @@ public:
                 ? dr::select(front_side, 0.25f * clearcoat * m_clearcoat_srate,
                              0.0f)
                              : 0.0f;
-        Float prob_diffuse =
-                dr::select(front_side, brdf * m_diff_refl_srate, 0.f);
+        Float prob_diffuse = dr::select(
+                front_side, brdf * albedo_diff * m_diff_refl_srate, 0.f);
 
         // Normalizing the probabilities.
         Float rcp_tot_prob = dr::rcp(prob_spec_reflect + prob_spec_trans +
@@ -829,7 +959,8 @@ public:
         }
         // Adding the secondary specular reflection pdf.(clearcoat)
         if (m_has_clearcoat) {
-            Float clearcoat_gloss = m_clearcoat_gloss->eval_1(si, active);
+            Float clearcoat_gloss = eval_param(m_clearcoat_gloss, ClearcoatGloss,
+                                               packed, si, active);
             GTR1 cc_dist(dr::lerp(0.1f, 0.001f, clearcoat_gloss));
             dr::masked(pdf, mfacet_reflect_macmic) +=
                     prob_clearcoat * cc_dist.pdf(wh) * dwh_dwo_abs;
@@ -860,11 +991,70 @@ public:
             << "clearcoat_gloss: " << m_clearcoat_gloss << "," << std::endl
             << "metallic: " << m_metallic << "," << std::endl
             << "spec_tint: " << m_spec_tint << "," << std::endl;
+        if (m_packed)
+            oss << "packed: " << m_packed << "," << std::endl;
 
         return oss.str();
     }
     MI_DECLARE_CLASS()
 private:
+    /// Scalar parameters that can be read from the channels of \c m_packed
+    enum PackedParam : uint32_t {
+        Roughness, Anisotropic, SpecTrans, Metallic, Clearcoat,
+        ClearcoatGloss, Flatness, Sheen, SheenTint, SpecTint, PackedParamCount
+    };
+
+    static constexpr const char *packed_param_names[PackedParamCount] = {
+        "roughness", "anisotropic", "spec_trans", "metallic", "clearcoat",
+        "clearcoat_gloss", "flatness", "sheen", "sheen_tint", "spec_tint"
+    };
+
+    /// Evaluate the packed parameter texture (if any) once per query
+    Color3f eval_packed(const SurfaceInteraction3f &si, Mask active) const {
+        if (!m_packed)
+            return 0.f;
+        return m_packed->eval_3(si, active);
+    }
+
+    /// Evaluate a scalar parameter, reading it from \c packed if possible
+    Float eval_param(const ref<Texture> &texture, PackedParam param,
+                     const Color3f &packed, const SurfaceInteraction3f &si,
+                     Mask active) const {
+        int channel = m_packed_channels[param];
+        if (channel >= 0)
+            return packed[channel];
+        return texture->eval_1(si, active);
+    }
+
+    /**
+     * \brief Estimate the directional albedo of the dielectric reflection
+     * and of the diffuse lobe of the BRDF major lobe toward \c si.wi
+     *
+     * The former is the Fresnel reflectance of a smooth interface at the
+     * angle of incidence. The latter is the luminance of the base color times
+     * the cosine-weighted mean of the diffuse Fresnel factors, plus an
+     * estimate of the sheen sampled by the same lobe.
+     */
+    std::pair<Float, Float> brdf_albedo(const SurfaceInteraction3f &si,
+                                        Float cos_theta_i, const Color3f &packed,
+                                        Float metallic, Mask active) const {
+        Float cos_i = dr::abs(cos_theta_i);
+        Float albedo_spec = std::get<0>(fresnel(cos_i, dr::detach(m_eta)));
+
+        UnpolarizedSpectrum base_color =
+                dr::detach(m_base_color->eval(si, active));
+        Float albedo_diff = mitsuba::luminance(base_color, si.wavelengths) *
+                            (1.0f - 0.5f * schlick_weight(cos_i)) *
+                            (41.0f / 42.0f);
+
+        if (m_has_sheen) {
+            Float sheen = eval_param(m_sheen, Sheen, packed, si, active);
+            albedo_diff += dr::detach(sheen * (1.0f - metallic)) / 21.0f;
+        }
+
+        return { albedo_spec, albedo_diff };
+    }
+
     /// Parameters
     ref<Texture> m_base_color;
     ref<Texture> m_roughness;
@@ -881,6 +1071,11 @@ private:
     Float m_specular;
     bool m_eta_specular;
 
+    /// Texture that provides several scalar parameters in its channels
+    ref<Texture> m_packed;
+    /// Channel of \c m_packed that provides each parameter (-1: none)
+    int m_packed_channels[PackedParamCount];
+
     /// Sampling rates
     ScalarFloat m_diff_refl_srate;
     ScalarFloat m_spec_srate;
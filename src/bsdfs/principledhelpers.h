@@ -131,6 +131,37 @@ bool get_flag(const std::string &name, const Properties &props) {
     }
 }
 
+/**
+ * \brief Get the flag which determines whether the corresponding
+ * feature is going to be implemented or not.
+ *
+ * In addition to the above, this also disables features whose texture is
+ * known to be zero everywhere, i.e. constant textures (e.g. \c uniform)
+ * with a maximum of zero. The lobes of disabled features are then omitted
+ * from the generated code.
+ * \param name
+ *     Name of the feature.
+ * \param props
+ *     Given properties.
+ * \param texture
+ *     Texture of the feature.
+ * \return the flag of the feature.
+ */
+template <typename Texture>
+bool get_flag(const std::string &name, const Properties &props,
+              const Texture *texture) {
+    if (!get_flag(name, props))
+        return false;
+    if (texture->is_spatially_varying())
+        return true;
+    try {
+        return texture->max() != 0.f;
+    } catch (const std::exception &) {
+        // Textures that don't implement max()
+        return true;
+    }
+}
+
 /**
  * \brief Computes the schlick weight for Fresnel Schlick approximation.
  * \param cos_i
@@ -56,6 +56,11 @@ Rough conductor material (:monosp:`roughconductor`)
      focuses computation on the visible parts of the microfacet normal distribution, considerably
      reducing variance in some cases. (Default: |true|, i.e. use visible normal sampling)
 
+ * - energy_compensation
+   - |bool|
+   - Compensate for the energy that is lost by the single-scattering microfacet model at high
+     roughness, see below. (Default: |false|)
+
 This plugin implements a realistic microfacet scattering model for rendering
 rough conducting materials, such as metals.
 
@@ -152,6 +157,14 @@ consider using the :ref:`twosided <bsdf-twosided>` BRDF adapter.
 In *polarized* rendering modes, the material automatically switches to a polarized
 implementation of the underlying Fresnel equations.
 
+Microfacet models only account for a single reflection on the microsurface, hence
+rough conductors appear darker than they should. When :monosp:`energy_compensation`
+is enabled, the model is scaled by the multiple scattering compensation factor
+:math:`1 + F_0 (1 - E(\mu_i)) / E(\mu_i)` proposed by Turquin, where :math:`E` is the
+directional albedo of the microfacet model with a Fresnel factor of one and :math:`F_0`
+is the reflectance at normal incidence. :math:`E` is precomputed once (per
+distribution type) into a table over the roughness and the incident elevation.
+
  */
 
 template <typename Float, typename Spectrum>
@@ -186,6 +199,9 @@ public:
 
         m_sample_visible = props.get<bool>("sample_visible", true);
 
+        if (props.get<bool>("energy_compensation", false))
+            m_albedo = microfacet_albedo_table<Float, Spectrum>(m_type, 0.f);
+
         if (props.has_property("alpha_u") || props.has_property("alpha_v")) {
             if (!props.has_property("alpha_u") || !props.has_property("alpha_v"))
                 Throw("Microfacet model: both 'alpha_u' and 'alpha_v' must be specified.");
@@ -204,10 +220,13 @@ public:
         m_flags = BSDFFlags::GlossyReflection | BSDFFlags::FrontSide;
         if (m_alpha_u != m_alpha_v)
             m_flags = m_flags | BSDFFlags::Anisotropic;
-        dr::set_attr(this, "flags", m_flags);
 
         m_components.clear();
         m_components.push_back(m_flags);
+
+        if (m_specular_reflectance && m_specular_reflectance->needs_differentials())
+            m_flags = m_flags | BSDFFlags::NeedsDifferentials;
+        dr::set_attr(this, "flags", m_flags);
     }
 
     void traverse(TraversalCallback *callback) override {
@@ -308,6 +327,9 @@ public:
         if (m_specular_reflectance)
             weight *= m_specular_reflectance->eval(si, active);
 
+        if (has_energy_compensation())
+            weight *= energy_compensation(distr, cos_theta_i, eta_c, active);
+
         return { bs, (F * weight) & active };
     }
 
@@ -385,6 +407,9 @@ public:
         if (m_specular_reflectance)
             result *= m_specular_reflectance->eval(si, active);
 
+        if (has_energy_compensation())
+            result *= energy_compensation(distr, cos_theta_i, eta_c, active);
+
         return (F * result) & active;
     }
 
@@ -507,6 +532,9 @@ public:
         if (m_specular_reflectance)
             value *= m_specular_reflectance->eval(si, active);
 
+        if (has_energy_compensation())
+            value *= energy_compensation(distr, cos_theta_i, eta_c, active);
+
         Float pdf;
         if (likely(m_sample_visible))
             pdf = D * smith_g1_wi / (4.f * cos_theta_i);
@@ -521,6 +549,7 @@ public:
         oss << "RoughConductor[" << std::endl
             << "  distribution = " << m_type << "," << std::endl
             << "  sample_visible = " << m_sample_visible << "," << std::endl
+            << "  energy_compensation = " << has_energy_compensation() << "," << std::endl
             << "  alpha_u = " << string::indent(m_alpha_u) << "," << std::endl
             << "  alpha_v = " << string::indent(m_alpha_v) << "," << std::endl;
         if (m_specular_reflectance)
@@ -533,6 +562,19 @@ public:
 
     MI_DECLARE_CLASS()
 private:
+    bool has_energy_compensation() const { return dr::width(m_albedo) > 0; }
+
+    /// Multiple scattering compensation factor following Turquin (2019)
+    UnpolarizedSpectrum
+    energy_compensation(const MicrofacetDistribution &distr, Float cos_theta_i,
+                        const dr::Complex<UnpolarizedSpectrum> &eta_c,
+                        Mask active) const {
+        Float alpha = dr::sqrt(distr.alpha_u() * distr.alpha_v()),
+              albedo = eval_microfacet_albedo(m_albedo, alpha, cos_theta_i, active);
+        UnpolarizedSpectrum f0 = fresnel_conductor(UnpolarizedSpectrum(1.f), eta_c);
+        return 1.f + f0 * (1.f - albedo) / albedo;
+    }
+
     /// Specifies the type of microfacet distribution
     MicrofacetType m_type;
     /// Anisotropic roughness values
@@ -545,6 +587,8 @@ private:
     ref<Texture> m_k;
     /// Specular reflectance component
     ref<Texture> m_specular_reflectance;
+    /// Directional albedo for energy compensation (empty if disabled)
+    DynamicBuffer<Float> m_albedo;
 };
 
 MI_IMPLEMENT_CLASS_VARIANT(RoughConductor, BSDF)
@@ -60,6 +60,11 @@ Rough dielectric material (:monosp:`roughdielectric`)
      focuses computation on the visible parts of the microfacet normal distribution, considerably
      reducing variance in some cases. (Default: |true|, i.e. use visible normal sampling)
 
+ * - energy_compensation
+   - |bool|
+   - Compensate for the energy that is lost by the single-scattering microfacet model at high
+     roughness, see below. (Default: |false|)
+
  * - eta
    - |float|
    - Relative index of refraction from the exterior to the interior
@@ -151,6 +156,15 @@ approach of sampling all normals is still available and can be enabled
 by setting :monosp:`sample_visible` to |false|. However this will lead
 to significantly slower convergence.
 
+Microfacet models only account for a single scattering event on the microsurface, which
+causes a loss of energy at high roughness. When :monosp:`energy_compensation` is
+enabled, reflection and transmission are divided by the directional albedo
+:math:`E(\mu_i)` of the single-scattering model (i.e. its total reflectance and
+transmittance), following Turquin's multiple scattering compensation. :math:`E` is
+precomputed once per distribution type and index of refraction into tables over the
+roughness and the incident elevation, for both sides of the interface. Derivatives with
+respect to :monosp:`eta` don't account for the compensation factor.
+
  */
 
 template <typename Float, typename Spectrum>
@@ -193,6 +207,7 @@ public:
         }
 
         m_sample_visible = props.get<bool>("sample_visible", true);
+        m_energy_compensation = props.get<bool>("energy_compensation", false);
 
         if (props.has_property("alpha_u") || props.has_property("alpha_v")) {
             if (!props.has_property("alpha_u") || !props.has_property("alpha_v"))
@@ -235,6 +250,12 @@ public:
     void parameters_changed(const std::vector<std::string> &/*keys*/ = {}) override {
         m_inv_eta = dr::rcp(m_eta);
         dr::make_opaque(m_eta, m_inv_eta);
+
+        if (m_energy_compensation) {
+            ScalarFloat eta = dr::slice(m_eta);
+            m_albedo_ext = microfacet_albedo_table<Float, Spectrum>(m_type, eta);
+            m_albedo_int = microfacet_albedo_table<Float, Spectrum>(m_type, 1.f / eta);
+        }
     }
 
     std::pair<BSDFSample3f, Spectrum> sample(const BSDFContext &ctx,
@@ -352,6 +373,9 @@ public:
 
         bs.pdf *= dr::abs(dwh_dwo);
 
+        if (m_energy_compensation)
+            weight *= energy_compensation(distr, cos_theta_i, active);
+
         return { bs, depolarizer<Spectrum>(weight) & active };
     }
 
@@ -428,6 +452,9 @@ public:
             result[eval_t] = value;
         }
 
+        if (m_energy_compensation)
+            result *= energy_compensation(distr, cos_theta_i, active);
+
         return depolarizer<Spectrum>(result);
     }
 
@@ -584,6 +611,9 @@ public:
             result[eval_t] = value;
         }
 
+        if (m_energy_compensation)
+            result *= energy_compensation(distr, cos_theta_i, active);
+
         /* Trick by Walter et al.: slightly scale the roughness values to
            reduce importance sampling weights. Not needed for the
            Heitz and D'Eon sampling technique. */
@@ -609,7 +639,8 @@ public:
         std::ostringstream oss;
         oss << "RoughDielectric[" << std::endl
             << "  distribution = "           << m_type           << "," << std::endl
-            << "  sample_visible = "         << (int) m_sample_visible << "," << std::endl;
+            << "  sample_visible = "         << (int) m_sample_visible << "," << std::endl
+            << "  energy_compensation = "    << (int) m_energy_compensation << "," << std::endl;
 
         if (!has_flag(m_flags, BSDFFlags::Anisotropic)) {
             oss << "  alpha = "                  << string::indent(m_alpha_v) << "," << std::endl;
@@ -631,12 +662,27 @@ public:
 
     MI_DECLARE_CLASS()
 private:
+    /// Multiple scattering compensation factor following Turquin (2019)
+    Float energy_compensation(const MicrofacetDistribution &distr,
+                              Float cos_theta_i, Mask active) const {
+        Float alpha = dr::sqrt(distr.alpha_u() * distr.alpha_v());
+        Mask front = cos_theta_i > 0.f;
+        Float albedo = dr::select(
+            front,
+            eval_microfacet_albedo(m_albedo_ext, alpha, cos_theta_i, active && front),
+            eval_microfacet_albedo(m_albedo_int, alpha, -cos_theta_i, active && !front));
+        return dr::rcp(albedo);
+    }
+
     ref<Texture> m_specular_reflectance;
     ref<Texture> m_specular_transmittance;
     MicrofacetType m_type;
     ref<Texture> m_alpha_u, m_alpha_v;
     Float m_eta, m_inv_eta;
     bool m_sample_visible;
+    bool m_energy_compensation;
+    /// Directional albedo outside/inside of the interface (if compensating)
+    DynamicBuffer<Float> m_albedo_ext, m_albedo_int;
 };
 
 MI_IMPLEMENT_CLASS_VARIANT(RoughDielectric, BSDF)
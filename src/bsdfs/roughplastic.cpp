@@ -160,6 +160,11 @@ the :monosp:`nonlinear` parameter:
 For more details, please refer to the description
 of this parameter given in the :ref:`plastic <bsdf-plastic>` plugin section.
 
+The specular and diffuse components are sampled in proportion to an estimate
+of their directional albedo at every shading point. It combines a precomputed
+table of the rough Fresnel transmittance of the coating, which accounts for
+the angle of incidence, with the values of the reflectance textures.
+
  */
 
 template <typename Float, typename Spectrum>
@@ -201,6 +206,9 @@ public:
         m_components.push_back(BSDFFlags::GlossyReflection | BSDFFlags::FrontSide);
         m_components.push_back(BSDFFlags::DiffuseReflection | BSDFFlags::FrontSide);
         m_flags =  m_components[0] | m_components[1];
+        if (m_diffuse_reflectance->needs_differentials() ||
+            (m_specular_reflectance && m_specular_reflectance->needs_differentials()))
+            m_flags = m_flags | BSDFFlags::NeedsDifferentials;
         dr::set_attr(this, "flags", m_flags);
 
         parameters_changed();
@@ -218,16 +226,6 @@ public:
         // Compute inverse of eta squared
         m_inv_eta_2 = 1.f / (m_eta * m_eta);
 
-        /* Compute weights that further steer samples towards
-           the specular or diffuse components */
-        Float d_mean = m_diffuse_reflectance->mean(),
-              s_mean = 1.f;
-
-        if (m_specular_reflectance)
-            s_mean = m_specular_reflectance->mean();
-
-        m_specular_sampling_weight = s_mean / (d_mean + s_mean);
-
         // Precompute rough reflectance (vectorized)
         if (keys.empty() || string::contains(keys, "alpha") || string::contains(keys, "eta")) {
             using FloatX = DynamicBuffer<ScalarFloat>;
@@ -249,9 +247,13 @@ public:
 
             m_internal_reflectance =
                 dr::mean(eval_reflectance(distr, wi, 1.f / eta) * wi.z()) * 2.f;
+
+            // Cosine-weighted transmittance of the light leaving the coating
+            m_diffuse_transmittance =
+                dr::mean(external_transmittance * wi.z()) * 2.f;
         }
-        dr::make_opaque(m_eta, m_inv_eta_2, m_alpha, m_specular_sampling_weight,
-                        m_internal_reflectance);
+        dr::make_opaque(m_eta, m_inv_eta_2, m_alpha, m_internal_reflectance,
+                        m_diffuse_transmittance);
     }
 
     std::pair<BSDFSample3f, Spectrum> sample(const BSDFContext &ctx,
@@ -276,14 +278,10 @@ public:
                                 MI_ROUGH_TRANSMITTANCE_RES, active);
 
         // Determine which component should be sampled
-        Float prob_specular = (1.f - t_i) * m_specular_sampling_weight,
-              prob_diffuse  = t_i * (1.f - m_specular_sampling_weight);
-
-        if (unlikely(has_specular != has_diffuse))
-            prob_specular = has_specular ? 1.f : 0.f;
-        else
-            prob_specular = prob_specular / (prob_specular + prob_diffuse);
-        prob_diffuse = 1.f - prob_specular;
+        Float prob_specular = has_specular ? 1.f : 0.f;
+        if (has_specular && has_diffuse)
+            prob_specular = specular_probability(
+                si, t_i, m_diffuse_reflectance->eval(si, active), active);
 
         Mask sample_specular = active && (sample1 < prob_specular),
              sample_diffuse = active && !sample_specular;
@@ -305,9 +303,8 @@ public:
             dr::masked(bs.sampled_type, sample_diffuse) = +BSDFFlags::DiffuseReflection;
         }
 
-        bs.pdf = pdf(ctx, si, bs.wo, active);
+        std::tie(result, bs.pdf) = eval_pdf(ctx, si, bs.wo, active);
         active &= bs.pdf > 0.f;
-        result = eval(ctx, si, bs.wo, active);
 
         return { bs, (depolarizer<Spectrum>(result) / bs.pdf) & active };
     }
@@ -366,6 +363,33 @@ public:
         return depolarizer<Spectrum>(value) & active;
     }
 
+    /**
+     * \brief Probability of sampling the specular component
+     *
+     * The directional albedo of the specular component is estimated by
+     * <tt>(1 - t_i)</tt> times its reflectance, and that of the diffuse
+     * component by \c t_i times the diffuse reflectance (accounting for
+     * internal scattering) and the transmittance toward the exterior.
+     */
+    Float specular_probability(const SurfaceInteraction3f &si, Float t_i,
+                               const UnpolarizedSpectrum &diffuse_reflectance,
+                               Mask active) const {
+        UnpolarizedSpectrum diff = dr::detach(diffuse_reflectance);
+        diff /= 1.f - (m_nonlinear ? (diff * m_internal_reflectance)
+                                   : UnpolarizedSpectrum(m_internal_reflectance));
+
+        Float albedo_specular = 1.f - t_i,
+              albedo_diffuse  = t_i * dr::mean(diff) * m_inv_eta_2 *
+                                m_diffuse_transmittance;
+
+        if (m_specular_reflectance)
+            albedo_specular *= dr::mean(
+                dr::detach(m_specular_reflectance->eval(si, active)));
+
+        Float albedo = albedo_specular + albedo_diffuse;
+        return dr::select(albedo > 0.f, albedo_specular / albedo, .5f);
+    }
+
     Float lerp_gather(const DynamicBuffer<Float> &data, Float x, size_t size,
                       Mask active = true) const {
         using UInt32 = dr::uint32_array_t<Float>;
@@ -397,14 +421,11 @@ public:
                                 MI_ROUGH_TRANSMITTANCE_RES, active);
 
         // Determine which component should be sampled
-        Float prob_specular = (1.f - t_i) * m_specular_sampling_weight,
-              prob_diffuse  = t_i * (1.f - m_specular_sampling_weight);
-
-        if (unlikely(has_specular != has_diffuse))
-            prob_specular = has_specular ? 1.f : 0.f;
-        else
-            prob_specular = prob_specular / (prob_specular + prob_diffuse);
-        prob_diffuse = 1.f - prob_specular;
+        Float prob_specular = has_specular ? 1.f : 0.f;
+        if (has_specular && has_diffuse)
+            prob_specular = specular_probability(
+                si, t_i, m_diffuse_reflectance->eval(si, active), active);
+        Float prob_diffuse = 1.f - prob_specular;
 
         Vector3f H = dr::normalize(wo + si.wi);
 
@@ -442,15 +463,15 @@ public:
         Float t_i = lerp_gather(m_external_transmittance, cos_theta_i,
                                 MI_ROUGH_TRANSMITTANCE_RES, active);
 
-        // Determine which component should be sampled
-        Float prob_specular = (1.f - t_i) * m_specular_sampling_weight,
-              prob_diffuse  = t_i * (1.f - m_specular_sampling_weight);
+        UnpolarizedSpectrum diff = 0.f;
+        if (has_diffuse)
+            diff = m_diffuse_reflectance->eval(si, active);
 
-        if (unlikely(has_specular != has_diffuse))
-            prob_specular = has_specular ? 1.f : 0.f;
-        else
-            prob_specular = prob_specular / (prob_specular + prob_diffuse);
-        prob_diffuse = 1.f - prob_specular;
+        // Determine which component should be sampled
+        Float prob_specular = has_specular ? 1.f : 0.f;
+        if (has_specular && has_diffuse)
+            prob_specular = specular_probability(si, t_i, diff, active);
+        Float prob_diffuse = 1.f - prob_specular;
 
         // Calculate the reflection half-vector
         Vector3f H = dr::normalize(wo + si.wi);
@@ -491,7 +512,6 @@ public:
             Float t_o = lerp_gather(m_external_transmittance, cos_theta_o,
                                     MI_ROUGH_TRANSMITTANCE_RES, active);
 
-            UnpolarizedSpectrum diff = m_diffuse_reflectance->eval(si, active);
             diff /= 1.f - (m_nonlinear ? (diff * m_internal_reflectance)
                                        : UnpolarizedSpectrum(m_internal_reflectance));
 
@@ -517,8 +537,7 @@ public:
         if (m_specular_reflectance)
             oss << "  specular_reflectance = "     << m_specular_reflectance              << "," << std::endl;
 
-        oss << "  specular_sampling_weight = " << m_specular_sampling_weight          << "," << std::endl
-            << "  eta = "                      << m_eta                               << "," << std::endl
+        oss << "  eta = "                      << m_eta                               << "," << std::endl
             << "  nonlinear = "                << m_nonlinear                         << std::endl
             << "]";
         return oss.str();
@@ -532,11 +551,11 @@ private:
     Float m_eta;
     Float m_inv_eta_2;
     Float m_alpha;
-    Float m_specular_sampling_weight;
     bool m_nonlinear;
     bool m_sample_visible;
     DynamicBuffer<Float> m_external_transmittance;
     Float m_internal_reflectance;
+    Float m_diffuse_transmittance;
 };
 
 MI_IMPLEMENT_CLASS_VARIANT(RoughPlastic, BSDF);
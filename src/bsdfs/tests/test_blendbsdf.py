@@ -184,3 +184,62 @@ def test05_sample_components(variant_scalar_rgb):
     expected_b = weight*1.0    # InvPi will cancel out with sampling pdf, but still need to apply weight
     bs_b, weight_b = bsdf.sample(ctx, si, 0.3, [0.5, 0.5])
     assert dr.allclose(weight_b, expected_b)
+
+
+def test06_nested_stochastic(variant_scalar_rgb):
+    def diffuse(value):
+        return { 'type': 'diffuse', 'reflectance': { 'type': 'rgb', 'value': value } }
+
+    def create(stochastic):
+        return mi.load_dict({
+            'type': 'blendbsdf',
+            'weight': 0.25,
+            'stochastic': stochastic,
+            'nested1': {
+                'type': 'blendbsdf',
+                'weight': 0.5,
+                'nested1': diffuse(0.2),
+                'nested2': diffuse(0.4),
+            },
+            'nested2': {
+                'type': 'blendbsdf',
+                'weight': 0.75,
+                'nested1': diffuse(0.6),
+                'nested2': { 'type': 'roughconductor' },
+            },
+        })
+
+    bsdf = create(False)
+    assert bsdf.component_count() == 4
+    assert bsdf.flags(3) == mi.BSDFFlags.GlossyReflection | mi.BSDFFlags.FrontSide
+
+    si = mi.SurfaceInteraction3f()
+    si.p = [0, 0, 0]
+    si.n = [0, 0, 1]
+    si.sh_frame = mi.Frame3f(si.n)
+    si.wi = [0, 0, 1]
+    ctx = mi.BSDFContext()
+    wo = mi.ScalarVector3f(0, 0, 1)
+
+    # Flattened lobes are weighted by the product of the blend weights
+    conductor = mi.load_dict({ 'type': 'roughconductor' })
+    lobe_weights = [0.75 * 0.5, 0.75 * 0.5, 0.25 * 0.25, 0.25 * 0.75]
+    lobe_values = [0.2 * dr.inv_pi, 0.4 * dr.inv_pi, 0.6 * dr.inv_pi,
+                   conductor.eval(ctx, si, wo)]
+    expected = sum(w * v for w, v in zip(lobe_weights, lobe_values))
+    assert dr.allclose(bsdf.eval(ctx, si, wo), expected)
+
+    ctx.component = 2
+    assert dr.allclose(bsdf.eval(ctx, si, wo), lobe_weights[2] * lobe_values[2])
+    ctx.component = mi.UInt32(-1)
+
+    # The one-sample estimate averages to the full evaluation, and the PDF is exact
+    bsdf_s = create(True)
+    assert dr.allclose(bsdf_s.pdf(ctx, si, wo), bsdf.pdf(ctx, si, wo))
+
+    n = 4000
+    total = mi.Color3f(0)
+    for i in range(n):
+        si.p = [i * 1e-3, 0, 0]
+        total += bsdf_s.eval(ctx, si, wo)
+    assert dr.allclose(total / n, expected, rtol=5e-2)
@@ -189,3 +189,33 @@ def test06_chi2(variants_vec_backends_once_rgb):
                         )
 
                         assert chi2.run()
+
+
+def test07_azimuthal_table(variants_vec_backends_once_rgb):
+    sampler = mi.load_dict({'type': 'independent'})
+    sampler.seed(seed=0, wavefront_size=10000)
+
+    si    = mi.SurfaceInteraction3f()
+    si.p  = [0, 0, 0]
+    si.n  = [0, 0, 1]
+    si.wi = mi.warp.square_to_uniform_sphere(sampler.next_2d())
+    si.sh_frame = mi.Frame3f(si.n)
+    wo = mi.warp.square_to_uniform_sphere(sampler.next_2d())
+
+    ctx = mi.BSDFContext()
+
+    for azi_roughness in [0.2, 0.5, 0.9]:
+        props = {
+            'type': 'hair',
+            'azimuthal_roughness': azi_roughness,
+        }
+        bsdf_ref = mi.load_dict(props)
+        bsdf = mi.load_dict({ **props, 'azimuthal_resolution': 4096 })
+
+        value_ref, pdf_ref = bsdf_ref.eval_pdf(ctx, si, wo)
+        value, pdf = bsdf.eval_pdf(ctx, si, wo)
+        assert dr.allclose(value, value_ref, rtol=1e-2, atol=1e-4)
+        assert dr.allclose(pdf, pdf_ref, rtol=1e-2, atol=1e-4)
+
+    with pytest.raises(RuntimeError, match='azimuthal resolution'):
+        mi.load_dict({ 'type': 'hair', 'azimuthal_resolution': 1 })
@@ -194,3 +194,109 @@ def test05_eval_pdf(variant_scalar_rgb):
         wo = [dr.sin(theta), 0, dr.cos(theta)]
         assert dr.allclose(bsdf.pdf(ctx, si, wo=wo), pdf_true[i])
         assert dr.allclose(bsdf.eval(ctx, si, wo=wo)[0], evaluate_true[i])
+
+
+def test06_constant_zero_lobes(variant_scalar_rgb):
+    # Lobes whose texture is constant zero are disabled at construction
+    b = mi.load_dict({
+        'type': 'principled',
+        'clearcoat': { 'type': 'uniform', 'value': 0.0 },
+        'spec_trans': { 'type': 'uniform', 'value': 0.0 },
+        'anisotropic': { 'type': 'uniform', 'value': 0.0 },
+        'sheen': { 'type': 'uniform', 'value': 0.0 },
+    })
+    assert b.component_count() == 2
+    assert not mi.has_flag(b.flags(), mi.BSDFFlags.GlossyTransmission)
+    assert not mi.has_flag(b.flags(), mi.BSDFFlags.Anisotropic)
+
+    b_ref = mi.load_dict({ 'type': 'principled' })
+
+    si = mi.SurfaceInteraction3f()
+    si.p = [0, 0, 0]
+    si.n = [0, 0, 1]
+    si.wi = dr.normalize(mi.ScalarVector3f(1, 0, 1))
+    si.sh_frame = mi.Frame3f(si.n)
+    ctx = mi.BSDFContext()
+
+    for i in range(10):
+        theta = i / 9.0 * (dr.pi / 2)
+        wo = [dr.sin(theta), 0, dr.cos(theta)]
+        assert dr.allclose(b.eval(ctx, si, wo), b_ref.eval(ctx, si, wo))
+        assert dr.allclose(b.pdf(ctx, si, wo), b_ref.pdf(ctx, si, wo))
+
+    # Non-zero constant textures keep their lobes
+    b = mi.load_dict({
+        'type': 'principled',
+        'spec_trans': { 'type': 'uniform', 'value': 0.5 },
+    })
+    assert b.component_count() == 3
+    assert mi.has_flag(b.flags(), mi.BSDFFlags.GlossyTransmission)
+
+
+def test07_packed_parameters(variant_scalar_rgb):
+    # Parameters read from the channels of a packed texture
+    b = mi.load_dict({
+        'type': 'principled',
+        'packed': { 'type': 'rgb', 'value': [0.2, 0.6, 0.3] },
+        'packed_channels': 'clearcoat, roughness, metallic',
+        'spec_trans': 0.5,
+    })
+    assert b.component_count() == 4
+    assert 'packed.value' in mi.traverse(b)
+
+    b_ref = mi.load_dict({
+        'type': 'principled',
+        'clearcoat': 0.2,
+        'roughness': 0.6,
+        'metallic': 0.3,
+        'spec_trans': 0.5,
+    })
+
+    si = mi.SurfaceInteraction3f()
+    si.p = [0, 0, 0]
+    si.n = [0, 0, 1]
+    si.wi = dr.normalize(mi.ScalarVector3f(1, 0, 1))
+    si.sh_frame = mi.Frame3f(si.n)
+    ctx = mi.BSDFContext()
+
+    for i in range(10):
+        theta = i / 9.0 * (dr.pi / 2)
+        wo = [dr.sin(theta), 0, dr.cos(theta)]
+        assert dr.allclose(b.eval(ctx, si, wo), b_ref.eval(ctx, si, wo))
+        assert dr.allclose(b.pdf(ctx, si, wo), b_ref.pdf(ctx, si, wo))
+
+    bs, weight = b.sample(ctx, si, 0.3, [0.4, 0.6])
+    bs_ref, weight_ref = b_ref.sample(ctx, si, 0.3, [0.4, 0.6])
+    assert dr.allclose(bs.wo, bs_ref.wo)
+    assert dr.allclose(weight, weight_ref)
+
+    with pytest.raises(RuntimeError, match='directly and via'):
+        mi.load_dict({
+            'type': 'principled',
+            'packed': { 'type': 'rgb', 'value': [0.2, 0.6, 0.3] },
+            'roughness': 0.5,
+        })
+
+    with pytest.raises(RuntimeError, match='Invalid entry'):
+        mi.load_dict({
+            'type': 'principled',
+            'packed': { 'type': 'rgb', 'value': [0.2, 0.6, 0.3] },
+            'packed_channels': 'none, glossiness',
+        })
+
+
+def test08_chi2_dark_base_color_sheen(variants_vec_backends_once_rgb):
+    # The sheen must remain reachable when the base color is black
+    xml = """<rgb name="base_color" value="0.0"/>
+             <float name="roughness" value="0.3"/>
+             <float name="sheen" value="1.0"/>
+          """
+    wi = dr.normalize(mi.ScalarVector3f([1, 0, 1]))
+    sample_func, pdf_func = mi.chi2.BSDFAdapter("principled", xml, wi=wi)
+    chi2 = mi.chi2.ChiSquareTest(
+        domain=mi.chi2.SphericalDomain(),
+        sample_func=sample_func,
+        pdf_func=pdf_func,
+        sample_dim=3
+    )
+    assert chi2.run()
@@ -115,3 +115,30 @@ def test06_eval_pdf(variant_scalar_rgb):
         v_eval_pdf = bsdf.eval_pdf(ctx, si, wo=wo)
         assert dr.allclose(v_eval, v_eval_pdf[0])
         assert dr.allclose(v_pdf, v_eval_pdf[1])
+
+
+def test07_energy_compensation(variants_vec_backends_once_rgb):
+    n = 1000000
+    sampler = mi.load_dict({'type': 'independent'})
+    sampler.seed(0, n)
+
+    si = dr.zeros(mi.SurfaceInteraction3f, n)
+    si.wi = dr.normalize(mi.Vector3f(0.5, 0, 1))
+    si.sh_frame = mi.Frame3f(mi.Vector3f(0, 0, 1))
+    ctx = mi.BSDFContext()
+
+    # The default parameters describe a perfect mirror
+    for distribution in ['beckmann', 'ggx']:
+        albedo = []
+        for compensation in [False, True]:
+            bsdf = mi.load_dict({
+                'type': 'roughconductor',
+                'distribution': distribution,
+                'alpha': 0.8,
+                'energy_compensation': compensation
+            })
+            _, weight = bsdf.sample(ctx, si, sampler.next_1d(), sampler.next_2d())
+            albedo.append(dr.mean(weight.x))
+
+        assert albedo[0] < 0.95
+        assert dr.allclose(albedo[1], 1.0, atol=2e-2)
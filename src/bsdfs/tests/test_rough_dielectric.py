@@ -245,4 +245,31 @@ def test13_attached_sampling(variants_all_ad_rgb):
 
     dr.forward(angle)
     assert dr.allclose(dr.grad(weight), 0.02079637348651886)
-    
\ No newline at end of file
+    
+
+def test14_energy_compensation(variants_vec_backends_once_rgb):
+    n = 1000000
+    sampler = mi.load_dict({'type': 'independent'})
+    sampler.seed(0, n)
+
+    ctx = mi.BSDFContext(mi.TransportMode.Importance)
+
+    # Total reflectance and transmittance from both sides of the interface
+    for wi in [[0.5, 0, 1], [0.3, 0, -1]]:
+        si = dr.zeros(mi.SurfaceInteraction3f, n)
+        si.wi = dr.normalize(mi.Vector3f(wi))
+        si.sh_frame = mi.Frame3f(mi.Vector3f(0, 0, 1))
+
+        albedo = []
+        for compensation in [False, True]:
+            bsdf = mi.load_dict({
+                'type': 'roughdielectric',
+                'distribution': 'ggx',
+                'alpha': 0.8,
+                'energy_compensation': compensation
+            })
+            _, weight = bsdf.sample(ctx, si, sampler.next_1d(), sampler.next_2d())
+            albedo.append(dr.mean(weight.x))
+
+        assert albedo[0] < 0.95
+        assert dr.allclose(albedo[1], 1.0, atol=2e-2)
@@ -75,3 +75,29 @@ def test04_eval_attribute(variants_all_rgb):
     assert dr.allclose(bsdf.eval_attribute('diffuse_reflectance', si), reflectance)
     assert dr.allclose(bsdf.eval_attribute_3('diffuse_reflectance', si), reflectance)
     assert dr.allclose(bsdf.eval_attribute_1('alpha', si), roughness)
+
+
+@pytest.mark.parametrize('bsdf_type', ['plastic', 'roughplastic'])
+def test05_lobe_sampling_weights(variants_vec_rgb, bsdf_type):
+    def sample_specular(diffuse_reflectance, cos_theta_i):
+        bsdf = mi.load_dict({
+            'type': bsdf_type,
+            'diffuse_reflectance': diffuse_reflectance
+        })
+
+        n = 10000
+        si = dr.zeros(mi.SurfaceInteraction3f, n)
+        si.wi = [dr.sqrt(1 - cos_theta_i**2), 0, cos_theta_i]
+        sampler = mi.load_dict({'type': 'independent'})
+        sampler.seed(0, n)
+
+        bs, weight = bsdf.sample(mi.BSDFContext(), si, sampler.next_1d(),
+                                 sampler.next_2d())
+        return dr.count(dr.eq(bs.sampled_component, 0)) / n
+
+    # Black plastic only has a specular component worth sampling
+    assert dr.allclose(sample_specular(0.0, 0.8), 1.0)
+
+    # Otherwise, the specular component is mostly sampled at grazing angles
+    assert sample_specular(0.8, 0.8) < 0.2
+    assert sample_specular(0.8, 0.05) > sample_specular(0.8, 0.8)
@@ -0,0 +1,169 @@
+#include <mitsuba/core/bfstream.h>
+#include <mitsuba/core/filesystem.h>
+#include <mitsuba/core/logger.h>
+#include <cstring>
+#include <sstream>
+
+NAMESPACE_BEGIN(mitsuba)
+
+BufferedFileStream::BufferedFileStream(const fs::path &p, size_t buffer_size)
+    : Stream(), m_path(p), m_buffer_size(buffer_size) {
+    if (buffer_size == 0)
+        Throw("\"%s\": the buffer size must be positive!", m_path.string());
+
+    // Disable the (small) internal buffer of the standard library
+    m_file.rdbuf()->pubsetbuf(nullptr, 0);
+
+    m_file.open(p.string(), std::ios::binary | std::ios::in);
+    if (!m_file.good())
+        Throw("\"%s\": I/O error while attempting to open file: %s",
+              m_path.string(), strerror(errno));
+
+    m_size = fs::file_size(m_path);
+    m_front.reset(new uint8_t[buffer_size]);
+    m_back.reset(new uint8_t[buffer_size]);
+    read_ahead(0);
+}
+
+BufferedFileStream::~BufferedFileStream() {
+    close();
+}
+
+void BufferedFileStream::close() {
+    if (m_pending.valid()) {
+        try {
+            m_pending.get();
+        } catch (...) { }
+    }
+    m_file.close();
+}
+
+bool BufferedFileStream::is_closed() const {
+    return !m_file.is_open();
+}
+
+void BufferedFileStream::read_ahead(size_t pos) {
+    m_back_offset = pos;
+    m_pending = std::async(std::launch::async,
+        [this, pos, buffer = m_back.get()]() -> size_t {
+            /* Report errors on the calling thread, which can't be done
+               using Throw() on this one */
+            m_file.seekg((std::streamoff) pos);
+            m_file.read((char *) buffer, (std::streamsize) m_buffer_size);
+            size_t count = (size_t) m_file.gcount();
+            bool failed = m_file.bad();
+            m_file.clear();
+            if (failed)
+                throw std::runtime_error(strerror(errno));
+            return count;
+        });
+}
+
+void BufferedFileStream::swap_buffers() {
+    size_t count;
+    try {
+        count = m_pending.get();
+    } catch (const std::exception &e) {
+        Throw("\"%s\": I/O error while attempting to read %zu bytes at "
+              "offset %zu: %s", m_path.string(), m_buffer_size,
+              m_back_offset, e.what());
+    }
+
+    std::swap(m_front, m_back);
+    m_front_offset = m_back_offset;
+    m_front_size = count;
+    m_front_pos = 0;
+
+    if (count > 0)
+        read_ahead(m_front_offset + count);
+}
+
+void BufferedFileStream::read(void *p_, size_t size) {
+    if (unlikely(is_closed()))
+        Throw("\"%s\": attempted to read from a closed stream",
+              m_path.string());
+
+    uint8_t *p = (uint8_t *) p_;
+    size_t total = size;
+
+    while (size > 0) {
+        if (m_front_pos == m_front_size) {
+            if (!m_pending.valid())
+                break;
+            swap_buffers();
+            if (m_front_size == 0)
+                break;
+        }
+
+        size_t count = std::min(size, m_front_size - m_front_pos);
+        std::memcpy(p, m_front.get() + m_front_pos, count);
+        m_front_pos += count;
+        p += count;
+        size -= count;
+    }
+
+    if (unlikely(size > 0)) {
+        size_t gcount = total - size;
+        throw EOFException(tfm::format("\"%s\": read %zu out of %zu bytes",
+                                       m_path.string(), gcount, total), gcount);
+    }
+}
+
+void BufferedFileStream::write(const void *, size_t) {
+    Throw("\"%s\": attempting to write to a read-only BufferedFileStream",
+          m_path.string());
+}
+
+void BufferedFileStream::truncate(size_t) {
+    Throw("\"%s\": attempting to truncate a read-only BufferedFileStream",
+          m_path.string());
+}
+
+void BufferedFileStream::seek(size_t pos) {
+    if (unlikely(is_closed()))
+        Throw("\"%s\": attempted to seek in a closed stream", m_path.string());
+
+    // Still within the current block?
+    if (pos >= m_front_offset && pos <= m_front_offset + m_front_size) {
+        m_front_pos = pos - m_front_offset;
+        return;
+    }
+
+    // Discard the blocks and start reading at the new position
+    if (m_pending.valid()) {
+        try {
+            m_pending.get();
+        } catch (...) { }
+    }
+    m_front_offset = pos;
+    m_front_size = m_front_pos = 0;
+    read_ahead(pos);
+}
+
+size_t BufferedFileStream::tell() const {
+    return m_front_offset + m_front_pos;
+}
+
+std::string BufferedFileStream::to_string() const {
+    std::ostringstream oss;
+
+    oss << class_()->name() << "[" << std::endl;
+    if (is_closed()) {
+        oss << "  closed" << std::endl;
+    } else {
+        oss << "  path = \"" << m_path.string() << "\"" << "," << std::endl
+            << "  host_byte_order = " << host_byte_order() << "," << std::endl
+            << "  byte_order = " << byte_order() << "," << std::endl
+            << "  buffer_size = " << m_buffer_size << "," << std::endl
+            << "  pos = " << tell() << "," << std::endl
+            << "  size = " << size() << std::endl;
+    }
+
+    oss << "]";
+
+    return oss.str();
+}
+
+MI_IMPLEMENT_CLASS(BufferedFileStream, Stream)
+
+NAMESPACE_END(mitsuba)
@@ -6,16 +6,26 @@
 #include <mitsuba/core/rfilter.h>
 #include <mitsuba/core/transform.h>
 #include <mitsuba/core/fstream.h>
+#include <mitsuba/core/mmap.h>
 #include <mitsuba/core/profiler.h>
+#include <mitsuba/core/string.h>
+#include <mitsuba/core/thread.h>
+#include <mitsuba/core/timer.h>
 #include <unordered_map>
+#include <type_traits>
 #include <thread>
+#include <cmath>
 
 #include <nanothread/nanothread.h>
 #include <drjit/half.h>
+#include <drjit/color.h>
 
 /* libpng */
 #include <png.h>
 
+/* zlib */
+#include <zlib.h>
+
 /* libjpeg */
 extern "C" {
     #include <jpeglib.h>
@@ -109,13 +119,47 @@ Bitmap::Bitmap(Bitmap &&bitmap)
       m_owns_data(bitmap.m_owns_data) {
 }
 
-Bitmap::Bitmap(Stream *stream, FileFormat format) {
-    read(stream, format);
+Bitmap::Bitmap(Stream *stream, FileFormat format, uint32_t max_resolution) {
+    read(stream, format, max_resolution);
 }
 
-Bitmap::Bitmap(const fs::path &filename, FileFormat format) {
+Bitmap::Bitmap(const fs::path &filename, FileFormat format,
+               uint32_t max_resolution) {
     ref<FileStream> fs = new FileStream(filename);
-    read(fs, format);
+    read(fs, format, max_resolution);
+}
+
+std::vector<ref<Bitmap>> Bitmap::read_batch(const std::vector<fs::path> &paths,
+                                            FileFormat format,
+                                            uint32_t max_resolution) {
+    std::vector<ref<Bitmap>> result(paths.size());
+    std::vector<std::exception_ptr> errors(paths.size());
+
+    Timer timer;
+    ThreadEnvironment env;
+    dr::parallel_for(
+        dr::blocked_range<size_t>(0, paths.size(), 1),
+        [&](const dr::blocked_range<size_t> &range) {
+            ScopedSetThreadEnvironment set_env(env);
+            for (size_t i = range.begin(); i != range.end(); ++i) {
+                try {
+                    result[i] = new Bitmap(paths[i], format, max_resolution);
+                } catch (...) {
+                    errors[i] = std::current_exception();
+                }
+            }
+        }
+    );
+
+    for (auto &error : errors) {
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    Log(Debug, "Loaded %zu bitmap%s (took %s)", paths.size(),
+        paths.size() == 1 ? "" : "s", util::time_string((float) timer.value()));
+
+    return result;
 }
 
 Bitmap::~Bitmap() {
@@ -411,6 +455,141 @@ ref<Bitmap> Bitmap::convert(PixelFormat pixel_format,
     return result;
 }
 
+// Defined in dither-matrix256.cpp
+extern const float dither_matrix256[65536];
+
+/**
+ * Fast paths of \ref Bitmap::convert() for the most common conversions
+ * between bitmaps with identical channels: float32 to uint8 (normalized and
+ * optionally sRGB-encoded), float32 to float16, and float16 to float32. They
+ * are bit-compatible with the generic \ref StructConverter (including its
+ * dithering) up to rounding, and process rows in parallel.
+ *
+ * Returns \c false if the conversion is not eligible.
+ */
+static bool convert_fast(const Bitmap *source, Bitmap *target) {
+    const Struct *ss = source->struct_(), *ts = target->struct_();
+    size_t channels = source->channel_count();
+
+    if (ts->field_count() != channels ||
+        ss->byte_order() != Struct::host_byte_order() ||
+        ts->byte_order() != Struct::host_byte_order())
+        return false;
+
+    Struct::Type st = source->component_format(),
+                 tt = target->component_format();
+
+    enum class Kernel { Float32ToUInt8, Float32ToFloat16, Float16ToFloat32 } kernel;
+    if (st == Struct::Type::Float32 && tt == Struct::Type::UInt8)
+        kernel = Kernel::Float32ToUInt8;
+    else if (st == Struct::Type::Float32 && tt == Struct::Type::Float16)
+        kernel = Kernel::Float32ToFloat16;
+    else if (st == Struct::Type::Float16 && tt == Struct::Type::Float32)
+        kernel = Kernel::Float16ToFloat32;
+    else
+        return false;
+
+    /* Channels must match one to one. Weights, (un)premultiplication, and all
+       gamma conversions except linear -> sRGB are left to the generic path */
+    const uint32_t same_flags = Struct::Flags::Weight |
+                                Struct::Flags::PremultipliedAlpha |
+                                Struct::Flags::Alpha;
+    std::vector<uint8_t> gamma(channels);
+    for (size_t i = 0; i < channels; ++i) {
+        const Struct::Field &fs = (*ss)[i], &ft = (*ts)[i];
+        if (fs.name != ft.name || !ft.blend.empty() ||
+            fs.offset != i * fs.size || ft.offset != i * ft.size ||
+            (fs.flags & same_flags) != (ft.flags & same_flags) ||
+            has_flag(fs.flags, Struct::Flags::Weight) ||
+            has_flag(fs.flags, Struct::Flags::Gamma))
+            return false;
+        gamma[i] = has_flag(ft.flags, Struct::Flags::Gamma);
+        if (kernel == Kernel::Float32ToUInt8) {
+            if (!has_flag(ft.flags, Struct::Flags::Normalized))
+                return false;
+        } else if (gamma[i]) {
+            return false;
+        }
+    }
+
+    size_t width = source->width(), height = source->height(),
+           row_size = width * channels;
+
+    if (kernel != Kernel::Float32ToUInt8) {
+        // Rows are independent, convert the buffer in large contiguous blocks
+        size_t count = row_size * height, block_size = 1 << 16;
+        dr::parallel_for(
+            dr::blocked_range<size_t>(0, (count + block_size - 1) / block_size, 1),
+            [&](const dr::blocked_range<size_t> &range) {
+                size_t start = range.begin() * block_size,
+                       end   = std::min(range.end() * block_size, count);
+                if (kernel == Kernel::Float32ToFloat16) {
+                    const float *s = (const float *) source->data();
+                    uint16_t *t = (uint16_t *) target->data();
+                    for (size_t i = start; i < end; ++i)
+                        t[i] = dr::half::float32_to_float16(s[i]);
+                } else {
+                    const uint16_t *s = (const uint16_t *) source->data();
+                    float *t = (float *) target->data();
+                    for (size_t i = start; i < end; ++i)
+                        t[i] = dr::half::float16_to_float32(s[i]);
+                }
+            }
+        );
+        return true;
+    }
+
+    /* Quantization to 8 bit. The dither matrix and the per-channel gamma flag
+       are expanded into tables whose period (256 pixels) is a multiple of the
+       packet width, so that every packet reads a contiguous range */
+    constexpr size_t Width = 8;
+    using FloatP = dr::Packet<float, Width>;
+    size_t period = 256 * channels;
+
+    std::unique_ptr<float[]> gamma_tbl(new float[period]);
+    for (size_t i = 0; i < period; ++i)
+        gamma_tbl[i] = gamma[i % channels] ? 1.f : 0.f;
+
+    dr::parallel_for(
+        dr::blocked_range<size_t>(0, height, 16),
+        [&](const dr::blocked_range<size_t> &range) {
+            std::unique_ptr<float[]> dither(new float[period]);
+            for (size_t y = range.begin(); y != range.end(); ++y) {
+                const float *drow = dither_matrix256 + (y % 256) * 256;
+                for (size_t i = 0; i < period; ++i)
+                    dither[i] = drow[i / channels];
+
+                const float *s = (const float *) source->data() + y * row_size;
+                uint8_t *t = (uint8_t *) target->data() + y * row_size;
+
+                size_t i = 0;
+                for (; i + Width <= row_size; i += Width) {
+                    size_t k = i % period;
+                    FloatP v = dr::load<FloatP>(s + i),
+                           g = dr::load<FloatP>(gamma_tbl.get() + k),
+                           d = dr::load<FloatP>(dither.get() + k);
+                    v = dr::select(g != 0.f, dr::linear_to_srgb(v), v);
+                    v = dr::round(dr::clamp(dr::fmadd(v, 255.f, d), 0.f, 255.f));
+                    dr::Packet<int32_t, Width> vi(v);
+                    for (size_t j = 0; j < Width; ++j)
+                        t[i + j] = (uint8_t) vi[j];
+                }
+
+                for (; i < row_size; ++i) {
+                    size_t k = i % period;
+                    float v = s[i];
+                    if (gamma_tbl[k] != 0.f)
+                        v = dr::linear_to_srgb(v);
+                    v = std::rint(std::clamp(v * 255.f + dither[k], 0.f, 255.f));
+                    t[i] = (uint8_t) v;
+                }
+            }
+        }
+    );
+
+    return true;
+}
+
 void Bitmap::convert(Bitmap *target) const {
     if (m_size != target->size())
         Throw("Bitmap::convert(): Incompatible target size!"
@@ -526,9 +705,36 @@ void Bitmap::convert(Bitmap *target) const {
               m_struct, target_struct, field.name);
     }
 
+    if (convert_fast(this, target))
+        return;
+
     StructConverter conv(m_struct, target_struct, true);
-    bool rv = conv.convert_2d(m_size.x(), m_size.y(), uint8_data(), target->uint8_data());
-    if (!rv)
+
+    /* Convert bands of rows in parallel. The dither pattern repeats every 256
+       rows, hence bands must start at multiples of 256 when quantizing */
+    bool quantize = false;
+    for (const Struct::Field &field : *target_struct)
+        quantize |= field.is_integer();
+
+    size_t width = m_size.x(), height = m_size.y(),
+           band  = quantize ? 256 : 32,
+           source_row = width * bytes_per_pixel(),
+           target_row = width * target->bytes_per_pixel();
+
+    std::atomic<bool> success(true);
+    dr::parallel_for(
+        dr::blocked_range<size_t>(0, (height + band - 1) / band, 1),
+        [&](const dr::blocked_range<size_t> &range) {
+            size_t y0 = range.begin() * band,
+                   y1 = std::min(range.end() * band, height);
+            if (!conv.convert_2d(width, y1 - y0,
+                                 uint8_data() + y0 * source_row,
+                                 target->uint8_data() + y0 * target_row))
+                success = false;
+        }
+    );
+
+    if (!success)
         Throw("Bitmap::convert(): conversion kernel indicated a failure!");
 }
 
@@ -689,22 +895,112 @@ std::vector<std::pair<std::string, ref<Bitmap>>> Bitmap::split() const {
     return result;
 }
 
-void Bitmap::read(Stream *stream, FileFormat format) {
+void Bitmap::read(Stream *stream, FileFormat format, uint32_t max_resolution) {
     if (format == FileFormat::Auto)
         format = detect_file_format(stream);
 
     switch (format) {
         case FileFormat::BMP:     read_bmp(stream);   break;
-        case FileFormat::JPEG:    read_jpeg(stream);  break;
+        case FileFormat::JPEG:    read_jpeg(stream, max_resolution); break;
         case FileFormat::OpenEXR: read_exr(stream);   break;
         case FileFormat::RGBE:    read_rgbe(stream);  break;
         case FileFormat::PFM:     read_pfm(stream);   break;
         case FileFormat::PPM:     read_ppm(stream);   break;
         case FileFormat::TGA:     read_tga(stream);   break;
         case FileFormat::PNG:     read_png(stream);   break;
+        case FileFormat::DDS:     read_dds(stream);   break;
         default:
             Throw("Bitmap: Unknown file format!");
     }
+
+    uint32_t res = dr::max(m_size);
+    if (max_resolution > 0 && res > max_resolution)
+        downsample_box((res + max_resolution - 1) / max_resolution);
+}
+
+template <typename Scalar>
+static void downsample_box(const Scalar *source, Scalar *target,
+                           const Bitmap::Vector2u &source_size,
+                           const Bitmap::Vector2u &target_size,
+                           size_t channels, uint32_t factor) {
+    dr::parallel_for(
+        dr::blocked_range<uint32_t>(0, target_size.y(), 16),
+        [&](const dr::blocked_range<uint32_t> &range) {
+            std::unique_ptr<double[]> sum(new double[channels]);
+
+            for (uint32_t y = range.begin(); y != range.end(); ++y) {
+                uint32_t y0 = y * factor,
+                         y1 = std::min(y0 + factor, source_size.y());
+
+                for (uint32_t x = 0; x < target_size.x(); ++x) {
+                    uint32_t x0 = x * factor,
+                             x1 = std::min(x0 + factor, source_size.x());
+
+                    for (size_t c = 0; c < channels; ++c)
+                        sum[c] = 0.0;
+
+                    for (uint32_t sy = y0; sy < y1; ++sy) {
+                        const Scalar *row = source + ((size_t) sy * source_size.x() + x0) * channels;
+                        for (uint32_t sx = x0; sx < x1; ++sx)
+                            for (size_t c = 0; c < channels; ++c)
+                                sum[c] += (double) *row++;
+                    }
+
+                    double scale = 1.0 / ((double) (x1 - x0) * (y1 - y0));
+                    Scalar *out = target + ((size_t) y * target_size.x() + x) * channels;
+                    for (size_t c = 0; c < channels; ++c) {
+                        if constexpr (std::is_integral_v<Scalar>)
+                            out[c] = (Scalar) std::round(sum[c] * scale);
+                        else
+                            out[c] = (Scalar) (sum[c] * scale);
+                    }
+                }
+            }
+        }
+    );
+}
+
+void Bitmap::downsample_box(uint32_t factor) {
+    if (factor <= 1)
+        return;
+
+    Vector2u size = (m_size + factor - 1) / factor;
+    std::unique_ptr<uint8_t[]> data(
+        new uint8_t[(size_t) size.x() * size.y() * bytes_per_pixel()]);
+    size_t channels = channel_count();
+
+    Log(Debug, "Downsampling bitmap from %ix%i to %ix%i ..", m_size.x(),
+        m_size.y(), size.x(), size.y());
+
+    switch (m_component_format) {
+#define MI_DOWNSAMPLE(Type, Scalar)                                            \
+        case Struct::Type::Type:                                               \
+            mitsuba::downsample_box((const Scalar *) m_data.get(),            \
+                                    (Scalar *) data.get(), m_size, size,       \
+                                    channels, factor);                         \
+            break;
+
+        MI_DOWNSAMPLE(UInt8, uint8_t)
+        MI_DOWNSAMPLE(Int8, int8_t)
+        MI_DOWNSAMPLE(UInt16, uint16_t)
+        MI_DOWNSAMPLE(Int16, int16_t)
+        MI_DOWNSAMPLE(UInt32, uint32_t)
+        MI_DOWNSAMPLE(Int32, int32_t)
+        MI_DOWNSAMPLE(Float16, dr::half)
+        MI_DOWNSAMPLE(Float32, float)
+        MI_DOWNSAMPLE(Float64, double)
+
+#undef MI_DOWNSAMPLE
+
+        default:
+            Throw("downsample_box(): Unsupported component type!");
+    }
+
+    if (!m_owns_data)
+        m_data.release();
+    m_data = std::move(data);
+    m_owns_data = true;
+    m_size = size;
 }
 
 Bitmap::FileFormat Bitmap::detect_file_format(Stream *stream) {
@@ -729,6 +1025,9 @@ Bitmap::FileFormat Bitmap::detect_file_format(Stream *stream) {
         format = FileFormat::PNG;
     } else if (Imf::isImfMagic((const char *) start)) {
         format = FileFormat::OpenEXR;
+    } else if (start[0] == 'D' && start[1] == 'D' && start[2] == 'S' &&
+               start[3] == ' ') {
+        format = FileFormat::DDS;
     } else {
         // Check for a TGAv2 file
         char footer[18];
@@ -869,31 +1168,86 @@ std::string Bitmap::to_string() const {
 //   OpenEXR bitmap I/O
 // -----------------------------------------------------------------------------
 
+/**
+ * Adapter for reading OpenEXR files from a \ref Stream. Files opened for
+ * reading are memory-mapped, which lets OpenEXR decompress chunks straight
+ * from the mapping instead of copying them into intermediate buffers.
+ */
 class EXRIStream : public Imf::IStream {
 public:
     EXRIStream(Stream *stream) : IStream(stream->to_string().c_str()),
         m_stream(stream) {
         m_offset = stream->tell();
         m_size = stream->size();
+
+        FileStream *fs = dynamic_cast<FileStream *>(stream);
+        if (fs && !fs->can_write()) {
+            try {
+                m_mmap = new MemoryMappedFile(fs->path());
+                m_data = (const char *) m_mmap->data();
+                m_size = m_mmap->size();
+            } catch (const std::exception &e) {
+                Log(Debug, "EXRIStream: could not map \"%s\" into memory "
+                           "(%s), reading it via the stream instead.",
+                    fs->path().string(), e.what());
+                m_mmap = nullptr;
+            }
+        }
+    }
+
+    ~EXRIStream() {
+        // Leave the stream after the last byte that was read
+        if (m_mmap)
+            m_stream->seek(std::min(m_offset + m_pos, m_size));
+    }
+
+    bool isMemoryMapped() const override { return m_mmap.get() != nullptr; }
+
+    char *readMemoryMapped(int n) override {
+        const char *ptr = advance(n);
+        return const_cast<char *>(ptr);
     }
 
     bool read(char *c, int n) override {
+        if (m_mmap) {
+            memcpy(c, advance(n), (size_t) n);
+            return m_offset + m_pos < m_size;
+        }
+
         m_stream->read(c, n);
         return m_stream->tell() == m_size;
     }
 
     Imf::Int64 tellg() override {
+        if (m_mmap)
+            return (Imf::Int64) m_pos;
         return m_stream->tell()-m_offset;
     }
 
     void seekg(Imf::Int64 pos) override {
-        m_stream->seek((size_t) pos + m_offset);
+        if (m_mmap)
+            m_pos = (size_t) pos;
+        else
+            m_stream->seek((size_t) pos + m_offset);
     }
 
     void clear() override { }
+private:
+    const char *advance(int n) {
+        size_t start = m_offset + m_pos;
+        if (n < 0 || start + (size_t) n > m_size)
+            Throw("EXRIStream: attempted to read past the end of \"%s\"!",
+                  m_mmap->filename().string());
+        m_pos += (size_t) n;
+        return m_data + start;
+    }
+
 private:
     ref<Stream> m_stream;
     size_t m_offset, m_size;
+    ref<MemoryMappedFile> m_mmap;
+    const char *m_data = nullptr;
+    size_t m_pos = 0;
 };
 
 class EXROStream : public Imf::OStream {
@@ -935,11 +1289,21 @@ public:
     void finish() override { }
 };
 
+/**
+ * Number of threads that OpenEXR uses to (de-)compress scanline blocks and
+ * tiles in parallel, which matches the thread count of the renderer
+ */
+static int exr_thread_count() {
+    if (pool_size() == 0)
+        return 0;
+    return (int) std::max((size_t) 1, Thread::thread_count());
+}
+
 void Bitmap::read_exr(Stream *stream) {
     ScopedPhase phase(ProfilerPhase::BitmapRead);
 
     EXRIStream istr(stream);
-    Imf::InputFile file(istr);
+    Imf::InputFile file(istr, exr_thread_count());
 
     const Imf::Header &header = file.header();
     const Imf::ChannelList &channels = header.channels();
@@ -1337,6 +1701,31 @@ void Bitmap::write_exr(Stream *stream, int quality) const {
     if (!metadata.has_property("generatedBy"))
         metadata.set_string("generatedBy", "Mitsuba version " MI_VERSION);
 
+    Imf::Compression compression =
+        quality <= 0 ? Imf::PIZ_COMPRESSION : Imf::DWAB_COMPRESSION;
+
+    // An explicitly requested compression method takes precedence
+    if (metadata.has_property("compression")) {
+        std::string name = string::to_lower(metadata.string("compression"));
+        metadata.remove_property("compression");
+
+        if (name == "none")       compression = Imf::NO_COMPRESSION;
+        else if (name == "rle")   compression = Imf::RLE_COMPRESSION;
+        else if (name == "zips")  compression = Imf::ZIPS_COMPRESSION;
+        else if (name == "zip")   compression = Imf::ZIP_COMPRESSION;
+        else if (name == "piz")   compression = Imf::PIZ_COMPRESSION;
+        else if (name == "pxr24") compression = Imf::PXR24_COMPRESSION;
+        else if (name == "b44")   compression = Imf::B44_COMPRESSION;
+        else if (name == "b44a")  compression = Imf::B44A_COMPRESSION;
+        else if (name == "dwaa")  compression = Imf::DWAA_COMPRESSION;
+        else if (name == "dwab")  compression = Imf::DWAB_COMPRESSION;
+        else
+            Throw("write_exr(): unsupported compression method \"%s\"!", name);
+    }
+
+    bool dwa = compression == Imf::DWAA_COMPRESSION ||
+               compression == Imf::DWAB_COMPRESSION;
+
     std::vector<std::string> keys = metadata.property_names();
 
     Imf::Header header(
@@ -1346,11 +1735,11 @@ void Bitmap::write_exr(Stream *stream, int quality) const {
         Imath::V2f(0, 0),  // screenWindowCenter,
         1.f,               // screenWindowWidth
         Imf::INCREASING_Y, // lineOrder
-        quality <= 0 ? Imf::PIZ_COMPRESSION : Imf::DWAB_COMPRESSION // compression
+        compression        // compression
     );
 
-    if (quality > 0)
-        Imf::addDwaCompressionLevel(header, float(quality));
+    if (dwa)
+        Imf::addDwaCompressionLevel(header, quality > 0 ? float(quality) : 45.f);
 
     for (auto it = keys.begin(); it != keys.end(); ++it) {
         using Type = Properties::Type;
@@ -1431,7 +1820,7 @@ void Bitmap::write_exr(Stream *stream, int quality) const {
     }
 
     EXROStream ostr(stream);
-    Imf::OutputFile file(ostr, header);
+    Imf::OutputFile file(ostr, header, exr_thread_count());
     file.setFrameBuffer(framebuffer);
     file.writePixels((int) m_size.y());
 }
@@ -1529,7 +1918,7 @@ extern "C" {
     }
 };
 
-void Bitmap::read_jpeg(Stream *stream) {
+void Bitmap::read_jpeg(Stream *stream, uint32_t max_resolution) {
     ScopedPhase phase(ProfilerPhase::BitmapRead);
     struct jpeg_decompress_struct cinfo;
     struct jpeg_error_mgr jerr;
@@ -1549,6 +1938,20 @@ void Bitmap::read_jpeg(Stream *stream) {
     jbuf.stream = stream;
 
     jpeg_read_header(&cinfo, TRUE);
+
+    /* Let libjpeg skip the high frequencies of the DCT coefficients when a
+       reduced resolution suffices, which is much faster than a full decode.
+       The remaining factor (if any) is handled by Bitmap::read() */
+    if (max_resolution > 0) {
+        uint32_t res = (uint32_t) std::max(cinfo.image_width, cinfo.image_height),
+                 factor = (res + max_resolution - 1) / max_resolution;
+        unsigned int denom = 1;
+        while (denom < 8 && factor % (denom * 2) == 0)
+            denom *= 2;
+        cinfo.scale_num = 1;
+        cinfo.scale_denom = denom;
+    }
+
     jpeg_start_decompress(&cinfo);
 
     m_size = Vector2u(cinfo.output_width, cinfo.output_height);
@@ -1779,29 +2182,44 @@ void Bitmap::read_png(Stream *stream) {
     delete[] rows;
 }
 
-void Bitmap::write_png(Stream *stream, int compression) const {
-    ScopedPhase phase(ProfilerPhase::BitmapWrite);
-    png_structp png_ptr;
-    png_infop info_ptr;
-    volatile png_bytepp rows = nullptr;
+/// Number of (filtered) bytes compressed by each task of the parallel PNG writer
+static constexpr size_t kPNGChunkSize = 256 * 1024;
 
+/// Determine the PNG color type and bit depth of a bitmap
+static std::pair<int, int> png_format(Bitmap::PixelFormat pixel_format,
+                                      Struct::Type component_format) {
     int color_type, bit_depth;
-    switch (m_pixel_format) {
-        case PixelFormat::Y: color_type = PNG_COLOR_TYPE_GRAY; break;
-        case PixelFormat::YA: color_type = PNG_COLOR_TYPE_GRAY_ALPHA; break;
-        case PixelFormat::RGB: color_type = PNG_COLOR_TYPE_RGB; break;
-        case PixelFormat::RGBA: color_type = PNG_COLOR_TYPE_RGBA; break;
+    switch (pixel_format) {
+        case Bitmap::PixelFormat::Y: color_type = PNG_COLOR_TYPE_GRAY; break;
+        case Bitmap::PixelFormat::YA: color_type = PNG_COLOR_TYPE_GRAY_ALPHA; break;
+        case Bitmap::PixelFormat::RGB: color_type = PNG_COLOR_TYPE_RGB; break;
+        case Bitmap::PixelFormat::RGBA: color_type = PNG_COLOR_TYPE_RGBA; break;
         default:
             Throw("write_png(): Unsupported pixel format!");
-            return;
     }
 
-    switch (m_component_format) {
+    switch (component_format) {
         case Struct::Type::UInt8: bit_depth = 8; break;
         case Struct::Type::UInt16: bit_depth = 16; break;
         default:
             Throw("write_png(): Unsupported component type!");
-            return;
+    }
+
+    return { color_type, bit_depth };
+}
+
+void Bitmap::write_png(Stream *stream, int compression) const {
+    ScopedPhase phase(ProfilerPhase::BitmapWrite);
+    png_structp png_ptr;
+    png_infop info_ptr;
+    volatile png_bytepp rows = nullptr;
+
+    auto [color_type, bit_depth] = png_format(m_pixel_format, m_component_format);
+
+    // Large images are compressed by several threads
+    if (buffer_size() > kPNGChunkSize) {
+        write_png_parallel(stream, compression);
+        return;
     }
 
     png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr,
@@ -1876,6 +2294,249 @@ void Bitmap::write_png(Stream *stream, int compression) const {
     delete[] rows;
 }
 
+/// Append a 32-bit big endian value to a buffer
+static void png_append_uint32(std::vector<uint8_t> &buf, uint32_t value) {
+    for (int i = 3; i >= 0; --i)
+        buf.push_back((uint8_t) (value >> (8 * i)));
+}
+
+/// Write a PNG chunk consisting of a type, payload, and checksum
+static void png_write_chunk(Stream *stream, const char *type,
+                            const uint8_t *data, size_t size) {
+    std::vector<uint8_t> buf;
+    png_append_uint32(buf, (uint32_t) size);
+    buf.insert(buf.end(), type, type + 4);
+    stream->write(buf.data(), buf.size());
+    if (size > 0)
+        stream->write(data, size);
+
+    uLong crc = crc32(0L, (const Bytef *) type, 4);
+    crc = crc32(crc, (const Bytef *) data, (uInt) size);
+    buf.clear();
+    png_append_uint32(buf, (uint32_t) crc);
+    stream->write(buf.data(), buf.size());
+}
+
+/// Apply the PNG filter (out of 5 candidates) that minimizes the sum of the output bytes
+static void png_filter_row(const uint8_t *row, const uint8_t *prev,
+                           size_t row_bytes, size_t bpp, uint8_t *out,
+                           uint8_t *scratch) {
+    // Same heuristic as libpng: minimal sum of absolute (signed) differences
+    uint64_t best_cost = (uint64_t) -1;
+    for (uint8_t type = 0; type < 5; ++type) {
+        uint8_t *target = type == 0 ? out + 1 : scratch;
+        uint64_t cost = 0;
+
+        for (size_t i = 0; i < row_bytes; ++i) {
+            int a = i >= bpp ? row[i - bpp] : 0,
+                b = prev ? prev[i] : 0,
+                c = (prev && i >= bpp) ? prev[i - bpp] : 0,
+                pred;
+
+            switch (type) {
+                case 0: pred = 0; break;
+                case 1: pred = a; break;
+                case 2: pred = b; break;
+                case 3: pred = (a + b) / 2; break;
+                default: {
+                        int p = a + b - c, pa = std::abs(p - a),
+                            pb = std::abs(p - b), pc = std::abs(p - c);
+                        pred = (pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c);
+                    }
+                    break;
+            }
+
+            uint8_t value = (uint8_t) (row[i] - pred);
+            target[i] = value;
+            cost += value < 128 ? value : 256 - value;
+        }
+
+        if (cost < best_cost) {
+            best_cost = cost;
+            out[0] = type;
+            if (type != 0)
+                std::memcpy(out + 1, scratch, row_bytes);
+        }
+    }
+}
+
+void Bitmap::write_png_parallel(Stream *stream, int compression) const {
+    auto [color_type, bit_depth] = png_format(m_pixel_format, m_component_format);
+
+    size_t bpp = bytes_per_pixel(),
+           row_bytes = bpp * m_size.x(),
+           line_bytes = row_bytes + 1,
+           rows_per_chunk = std::max((size_t) 1, kPNGChunkSize / line_bytes),
+           chunk_count = (m_size.y() + rows_per_chunk - 1) / rows_per_chunk;
+
+    /* Phase 1: filter all rows. PNG stores 16 bit values in big endian
+       byte order */
+    bool swap = bit_depth == 16 && Stream::host_byte_order() == Stream::ELittleEndian;
+    std::unique_ptr<uint8_t[]> filtered(new uint8_t[line_bytes * m_size.y()]);
+
+    dr::parallel_for(
+        dr::blocked_range<size_t>(0, m_size.y(), rows_per_chunk),
+        [&](const dr::blocked_range<size_t> &range) {
+            std::unique_ptr<uint8_t[]> scratch(new uint8_t[row_bytes * 3]);
+            uint8_t *row_be = scratch.get() + row_bytes,
+                    *prev_be = row_be + row_bytes;
+
+            auto fetch = [&](size_t y, uint8_t *target) -> const uint8_t * {
+                const uint8_t *row = m_data.get() + y * row_bytes;
+                if (!swap)
+                    return row;
+                for (size_t i = 0; i < row_bytes; i += 2) {
+                    target[i] = row[i + 1];
+                    target[i + 1] = row[i];
+                }
+                return target;
+            };
+
+            const uint8_t *prev =
+                range.begin() > 0 ? fetch(range.begin() - 1, prev_be) : nullptr;
+            for (size_t y = range.begin(); y != range.end(); ++y) {
+                const uint8_t *row = fetch(y, row_be);
+                png_filter_row(row, prev, row_bytes, bpp,
+                               filtered.get() + y * line_bytes, scratch.get());
+                if (swap) {
+                    std::swap(row_be, prev_be);
+                    prev = prev_be;
+                } else {
+                    prev = row;
+                }
+            }
+        }
+    );
+
+    /* Phase 2: compress chunks of rows into raw deflate streams. Each one
+       is primed with the data preceding it, and all but the last one end
+       with a sync flush so that they can be concatenated */
+    std::vector<std::vector<uint8_t>> chunks(chunk_count);
+    std::vector<uLong> checksums(chunk_count);
+    std::vector<std::exception_ptr> errors(chunk_count);
+
+    dr::parallel_for(
+        dr::blocked_range<size_t>(0, chunk_count, 1),
+        [&](const dr::blocked_range<size_t> &range) {
+            for (size_t i = range.begin(); i != range.end(); ++i) {
+                try {
+                    size_t start = i * rows_per_chunk * line_bytes,
+                           end = std::min((i + 1) * rows_per_chunk,
+                                          (size_t) m_size.y()) * line_bytes;
+                    const uint8_t *input = filtered.get() + start;
+                    size_t size = end - start;
+
+                    z_stream zs;
+                    memset(&zs, 0, sizeof(z_stream));
+                    if (deflateInit2(&zs, compression, Z_DEFLATED, -15, 8,
+                                     Z_FILTERED) != Z_OK)
+                        Throw("write_png(): could not initialize zlib!");
+
+                    if (i > 0) {
+                        size_t dict_size = std::min(start, (size_t) 32768);
+                        deflateSetDictionary(&zs, input - dict_size,
+                                             (uInt) dict_size);
+                    }
+
+                    std::vector<uint8_t> &out = chunks[i];
+                    out.resize(deflateBound(&zs, (uLong) size) + 16);
+                    zs.next_in = (Bytef *) input;
+                    zs.avail_in = (uInt) size;
+                    zs.next_out = out.data();
+                    zs.avail_out = (uInt) out.size();
+
+                    int retval = deflate(&zs, i + 1 == chunk_count ? Z_FINISH
+                                                                   : Z_SYNC_FLUSH);
+                    size_t written = out.size() - zs.avail_out;
+                    deflateEnd(&zs);
+
+                    if (retval == Z_STREAM_ERROR || zs.avail_in != 0)
+                        Throw("write_png(): deflate() failed!");
+
+                    out.resize(written);
+                    checksums[i] = adler32(adler32(0L, nullptr, 0),
+                                           input, (uInt) size);
+                } catch (...) {
+                    errors[i] = std::current_exception();
+                }
+            }
+        }
+    );
+
+    for (auto &error : errors) {
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    // Phase 3: write the file
+    const uint8_t signature[8] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+    stream->write(signature, 8);
+
+    std::vector<uint8_t> buf;
+    png_append_uint32(buf, m_size.x());
+    png_append_uint32(buf, m_size.y());
+    buf.insert(buf.end(), { (uint8_t) bit_depth, (uint8_t) color_type,
+                            0 /* deflate */, 0 /* adaptive filter */,
+                            0 /* no interlacing */ });
+    png_write_chunk(stream, "IHDR", buf.data(), buf.size());
+
+    if (m_srgb_gamma) {
+        // Same chunks as png_set_sRGB_gAMA_and_cHRM()
+        uint8_t intent = PNG_sRGB_INTENT_ABSOLUTE;
+        png_write_chunk(stream, "sRGB", &intent, 1);
+
+        buf.clear();
+        png_append_uint32(buf, 45455);
+        png_write_chunk(stream, "gAMA", buf.data(), buf.size());
+
+        buf.clear();
+        for (uint32_t value : { 31270, 32900, 64000, 33000,
+                                30000, 60000, 15000, 6000 })
+            png_append_uint32(buf, value);
+        png_write_chunk(stream, "cHRM", buf.data(), buf.size());
+    }
+
+    Properties metadata(m_metadata);
+    if (!metadata.has_property("generated_by"))
+        metadata.set_string("generated_by", "Mitsuba version " MI_VERSION);
+
+    for (const std::string &key : metadata.property_names()) {
+        // Keywords are limited to 79 characters
+        std::string value = metadata.as_string(key);
+        buf.assign(key.begin(), key.begin() + std::min(key.size(), (size_t) 79));
+        buf.push_back(0);
+        buf.insert(buf.end(), value.begin(), value.end());
+        png_write_chunk(stream, "tEXt", buf.data(), buf.size());
+    }
+
+    // Wrap the concatenated deflate streams into a zlib stream
+    int level;
+    if (compression < 0 || compression == 6)
+        level = 2;
+    else if (compression < 2)
+        level = 0;
+    else
+        level = compression < 6 ? 1 : 3;
+    uint8_t header[2] = { 0x78, (uint8_t) (level << 6) };
+    header[1] += (uint8_t) ((31 - (header[0] * 256 + header[1]) % 31) % 31);
+    chunks[0].insert(chunks[0].begin(), header, header + 2);
+
+    uLong checksum = checksums[0];
+    for (size_t i = 1; i < chunk_count; ++i) {
+        size_t size = std::min((i + 1) * rows_per_chunk, (size_t) m_size.y()) * line_bytes -
+                      i * rows_per_chunk * line_bytes;
+        checksum = adler32_combine(checksum, checksums[i], (z_off_t) size);
+    }
+    png_append_uint32(chunks.back(), (uint32_t) checksum);
+
+    for (const std::vector<uint8_t> &chunk : chunks) {
+        if (!chunk.empty())
+            png_write_chunk(stream, "IDAT", chunk.data(), chunk.size());
+    }
+
+    png_write_chunk(stream, "IEND", nullptr, 0);
+}
+
 // -----------------------------------------------------------------------------
 //   PNG bitmap I/O
 // -----------------------------------------------------------------------------
@@ -2502,6 +3163,564 @@ void Bitmap::read_tga(Stream *stream) {
     }
 }
 
+// -----------------------------------------------------------------------------
+//   BC6H / BC7 block decompression
+// -----------------------------------------------------------------------------
+
+/// Sequential reader of the bits of a 128 bit compressed block (LSB first)
+struct BlockBitReader {
+    const uint8_t *data;
+    uint32_t pos = 0;
+
+    BlockBitReader(const uint8_t *data) : data(data) { }
+
+    uint32_t read(uint32_t count) {
+        uint32_t result = 0;
+        for (uint32_t i = 0; i < count; ++i, ++pos)
+            result |= (uint32_t) ((data[pos >> 3] >> (pos & 7)) & 1) << i;
+        return result;
+    }
+};
+
+/// Two-subset partitions shared by BC6H and BC7 (bit i = subset of texel i)
+static const uint16_t bc_partitions_2[64] = {
+    0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80,
+    0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+    0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE,
+    0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+    0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A,
+    0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+    0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C,
+    0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22
+};
+
+/// Three-subset partitions of BC7 (2 bits per texel)
+static const uint32_t bc7_partitions_3[64] = {
+    0xAA685050, 0x6A5A5040, 0x5A5A4200, 0x5450A0A8, 0xA5A50000, 0xA0A05050,
+    0x5555A0A0, 0x5A5A5050, 0xAA550000, 0xAA555500, 0xAAAA5500, 0x90909090,
+    0x94949494, 0xA4A4A4A4, 0xA9A59450, 0x2A0A4250, 0xA5945040, 0x0A425054,
+    0xA5A5A500, 0x55A0A0A0, 0xA8A85454, 0x6A6A4040, 0xA4A45000, 0x1A1A0500,
+    0x0050A4A4, 0xAAA59090, 0x14696914, 0x69691400, 0xA08585A0, 0xAA821414,
+    0x50A4A450, 0x6A5A0200, 0xA9A58000, 0x5090A0A8, 0xA8A09050, 0x24242424,
+    0x00AA5500, 0x24924924, 0x24499224, 0x50A50A50, 0x500AA550, 0xAAAA4444,
+    0x66660000, 0xA5A0A5A0, 0x50A050A0, 0x69286928, 0x44AAAA44, 0x66666600,
+    0xAA444444, 0x54A854A8, 0x95809580, 0x96969600, 0xA85454A8, 0x80959580,
+    0xAA141414, 0x96960000, 0xAAAA1414, 0xA05050A0, 0xA0A5A5A0, 0x96000000,
+    0x40804080, 0xA9A8A9A8, 0xAAAAAA44, 0x2A4A5254
+};
+
+/// Anchor texel of the second subset of two-subset partitions
+static const uint8_t bc_anchor_2[64] = {
+    15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+    15,  2,  8,  2,  2,  8,  8, 15,  2,  8,  2,  2,  8,  8,  2,  2,
+    15, 15,  6,  8,  2,  8, 15, 15,  2,  8,  2,  2,  2, 15, 15,  6,
+     6,  2,  6,  8, 15, 15,  2,  2, 15, 15, 15, 15, 15,  2,  2, 15
+};
+
+/// Anchor texels of the second and third subsets of three-subset partitions
+static const uint8_t bc7_anchor_3[2][64] = {
+    {  3,  3, 15, 15,  8,  3, 15, 15,  8,  8,  6,  6,  6,  5,  3,  3,
+       3,  3,  8, 15,  3,  3,  6, 10,  5,  8,  8,  6,  8,  5, 15, 15,
+       8, 15,  3,  5,  6, 10,  8, 15, 15,  3, 15,  5, 15, 15, 15, 15,
+       3, 15,  5,  5,  5,  8,  5, 10,  5, 10,  8, 13, 15, 12,  3,  3 },
+    { 15,  8,  8,  3, 15, 15,  3,  8, 15, 15, 15, 15, 15, 15, 15,  8,
+      15,  8, 15,  3, 15,  8, 15,  8,  3, 15,  6, 10, 15, 15, 10,  8,
+      15,  3, 15, 10, 10,  8,  9, 10,  6, 15,  8, 15,  3,  6,  6,  8,
+      15,  3, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,  3, 15, 15,  8 }
+};
+
+static const uint8_t bc_weights_2[4] = { 0, 21, 43, 64 };
+static const uint8_t bc_weights_3[8] = { 0, 9, 18, 27, 37, 46, 55, 64 };
+static const uint8_t bc_weights_4[16] = { 0,  4,  9, 13, 17, 21, 26, 30,
+                                          34, 38, 43, 47, 51, 55, 60, 64 };
+
+static const uint8_t *bc_weights(uint32_t bits) {
+    return bits == 2 ? bc_weights_2 : (bits == 3 ? bc_weights_3 : bc_weights_4);
+}
+
+/// Return the subset of texel 'i' in the given partition
+static uint32_t bc_subset(uint32_t subsets, uint32_t partition, uint32_t i) {
+    if (subsets == 1)
+        return 0;
+    else if (subsets == 2)
+        return (bc_partitions_2[partition] >> i) & 1;
+    else
+        return (bc7_partitions_3[partition] >> (2 * i)) & 3;
+}
+
+/// Does texel 'i' store its index with one bit less than the others?
+static bool bc_is_anchor(uint32_t subsets, uint32_t partition, uint32_t i) {
+    if (i == 0)
+        return true;
+    else if (subsets == 2)
+        return i == bc_anchor_2[partition];
+    else if (subsets == 3)
+        return i == bc7_anchor_3[0][partition] || i == bc7_anchor_3[1][partition];
+    return false;
+}
+
+/// Decode a BC7 block into 4x4 RGBA8 texels
+static void bc7_decode_block(const uint8_t *block, uint8_t *out) {
+    struct ModeInfo {
+        uint8_t subsets, partition_bits, rotation_bits, index_selection_bits,
+                color_bits, alpha_bits, endpoint_pbits, shared_pbits,
+                index_bits, index_bits_2;
+    };
+
+    static const ModeInfo modes[8] = {
+        { 3, 4, 0, 0, 4, 0, 1, 0, 3, 0 },
+        { 2, 6, 0, 0, 6, 0, 0, 1, 3, 0 },
+        { 3, 6, 0, 0, 5, 0, 0, 0, 2, 0 },
+        { 2, 6, 0, 0, 7, 0, 1, 0, 2, 0 },
+        { 1, 0, 2, 1, 5, 6, 0, 0, 2, 3 },
+        { 1, 0, 2, 0, 7, 8, 0, 0, 2, 2 },
+        { 1, 0, 0, 0, 7, 7, 1, 0, 4, 0 },
+        { 2, 6, 0, 0, 5, 5, 1, 0, 2, 0 }
+    };
+
+    uint32_t mode = 0;
+    while (mode < 8 && !(block[0] & (1 << mode)))
+        ++mode;
+
+    if (mode == 8) {
+        // Reserved mode: the specification mandates transparent black
+        memset(out, 0, 16 * 4);
+        return;
+    }
+
+    const ModeInfo &info = modes[mode];
+    BlockBitReader bits(block);
+    bits.read(mode + 1);
+
+    uint32_t partition = bits.read(info.partition_bits),
+             rotation  = bits.read(info.rotation_bits),
+             index_selection = bits.read(info.index_selection_bits);
+
+    uint32_t endpoint_count = 2 * info.subsets;
+    uint8_t endpoints[6][4];
+
+    for (uint32_t c = 0; c < 3; ++c)
+        for (uint32_t e = 0; e < endpoint_count; ++e)
+            endpoints[e][c] = (uint8_t) bits.read(info.color_bits);
+
+    for (uint32_t e = 0; e < endpoint_count; ++e)
+        endpoints[e][3] = (uint8_t) bits.read(info.alpha_bits);
+
+    // Append the p-bits (if any) and expand the endpoints to 8 bits
+    uint32_t pbits[6] = { 0 };
+    bool has_pbits = info.endpoint_pbits || info.shared_pbits;
+    if (info.endpoint_pbits) {
+        for (uint32_t e = 0; e < endpoint_count; ++e)
+            pbits[e] = bits.read(1);
+    } else if (info.shared_pbits) {
+        for (uint32_t s = 0; s < info.subsets; ++s)
+            pbits[2 * s] = pbits[2 * s + 1] = bits.read(1);
+    }
+
+    for (uint32_t e = 0; e < endpoint_count; ++e) {
+        for (uint32_t c = 0; c < 4; ++c) {
+            uint32_t precision = c < 3 ? info.color_bits : info.alpha_bits;
+            if (precision == 0) {
+                endpoints[e][c] = 255;
+                continue;
+            }
+            uint32_t value = endpoints[e][c];
+            if (has_pbits) {
+                value = (value << 1) | pbits[e];
+                precision += 1;
+            }
+            value <<= 8 - precision;
+            value |= value >> precision;
+            endpoints[e][c] = (uint8_t) value;
+        }
+    }
+
+    uint32_t indices[16], indices_2[16];
+    for (uint32_t i = 0; i < 16; ++i)
+        indices[i] = bits.read(info.index_bits -
+                               (bc_is_anchor(info.subsets, partition, i) ? 1 : 0));
+    if (info.index_bits_2) {
+        for (uint32_t i = 0; i < 16; ++i)
+            indices_2[i] = bits.read(info.index_bits_2 - (i == 0 ? 1 : 0));
+    }
+
+    for (uint32_t i = 0; i < 16; ++i) {
+        uint32_t subset = bc_subset(info.subsets, partition, i);
+        const uint8_t *e0 = endpoints[2 * subset], *e1 = endpoints[2 * subset + 1];
+
+        uint32_t color_index = indices[i], color_bits = info.index_bits,
+                 alpha_index = indices[i], alpha_bits = info.index_bits;
+        if (info.index_bits_2) {
+            if (index_selection) {
+                color_index = indices_2[i];
+                color_bits = info.index_bits_2;
+            } else {
+                alpha_index = indices_2[i];
+                alpha_bits = info.index_bits_2;
+            }
+        }
+
+        uint32_t wc = bc_weights(color_bits)[color_index],
+                 wa = bc_weights(alpha_bits)[alpha_index];
+
+        uint8_t *texel = out + 4 * i;
+        for (uint32_t c = 0; c < 3; ++c)
+            texel[c] = (uint8_t) (((64 - wc) * e0[c] + wc * e1[c] + 32) >> 6);
+        texel[3] = (uint8_t) (((64 - wa) * e0[3] + wa * e1[3] + 32) >> 6);
+
+        if (rotation)
+            std::swap(texel[3], texel[rotation - 1]);
+    }
+}
+
+/**
+ * Bit layout of the BC6H endpoints (excluding the mode bits). Every segment
+ * refers to channel 'c' of endpoint 'e' and lists its bits in the order in
+ * which they are stored (some segments are stored in reverse order).
+ */
+struct BC6HSegment { uint8_t e, c, first, last; };
+
+#define S(e, c, first, last) { e, c, first, last }
+static const BC6HSegment bc6h_layout_1[] = { // 10.5.5.5
+    S(2,1,4,4), S(2,2,4,4), S(3,2,4,4), S(0,0,0,9), S(0,1,0,9), S(0,2,0,9),
+    S(1,0,0,4), S(3,1,4,4), S(2,1,0,3), S(1,1,0,4), S(3,2,0,0), S(3,1,0,3),
+    S(1,2,0,4), S(3,2,1,1), S(2,2,0,3), S(2,0,0,4), S(3,2,2,2), S(3,0,0,4),
+    S(3,2,3,3)
+};
+static const BC6HSegment bc6h_layout_2[] = { // 7.6.6.6
+    S(2,1,5,5), S(3,1,4,4), S(3,1,5,5), S(0,0,0,6), S(3,2,0,0), S(3,2,1,1),
+    S(2,2,4,4), S(0,1,0,6), S(2,2,5,5), S(3,2,2,2), S(2,1,4,4), S(0,2,0,6),
+    S(3,2,3,3), S(3,2,5,5), S(3,2,4,4), S(1,0,0,5), S(2,1,0,3), S(1,1,0,5),
+    S(3,1,0,3), S(1,2,0,5), S(2,2,0,3), S(2,0,0,5), S(3,0,0,5)
+};
+static const BC6HSegment bc6h_layout_3[] = { // 11.5.4.4
+    S(0,0,0,9), S(0,1,0,9), S(0,2,0,9), S(1,0,0,4), S(0,0,10,10),
+    S(2,1,0,3), S(1,1,0,3), S(0,1,10,10), S(3,2,0,0), S(3,1,0,3),
+    S(1,2,0,3), S(0,2,10,10), S(3,2,1,1), S(2,2,0,3), S(2,0,0,4),
+    S(3,2,2,2), S(3,0,0,4), S(3,2,3,3)
+};
+static const BC6HSegment bc6h_layout_4[] = { // 11.4.5.4
+    S(0,0,0,9), S(0,1,0,9), S(0,2,0,9), S(1,0,0,3), S(0,0,10,10),
+    S(3,1,4,4), S(2,1,0,3), S(1,1,0,4), S(0,1,10,10), S(3,1,0,3),
+    S(1,2,0,3), S(0,2,10,10), S(3,2,1,1), S(2,2,0,3), S(2,0,0,3),
+    S(3,2,0,0), S(3,2,2,2), S(3,0,0,3), S(2,1,4,4), S(3,2,3,3)
+};
+static const BC6HSegment bc6h_layout_5[] = { // 11.4.4.5
+    S(0,0,0,9), S(0,1,0,9), S(0,2,0,9), S(1,0,0,3), S(0,0,10,10),
+    S(2,2,4,4), S(2,1,0,3), S(1,1,0,3), S(0,1,10,10), S(3,2,0,0),
+    S(3,1,0,3), S(1,2,0,4), S(0,2,10,10), S(2,2,0,3), S(2,0,0,3),
+    S(3,2,1,1), S(3,2,2,2), S(3,0,0,3), S(3,2,4,4), S(3,2,3,3)
+};
+static const BC6HSegment bc6h_layout_6[] = { // 9.5.5.5
+    S(0,0,0,8), S(2,2,4,4), S(0,1,0,8), S(2,1,4,4), S(0,2,0,8), S(3,2,4,4),
+    S(1,0,0,4), S(3,1,4,4), S(2,1,0,3), S(1,1,0,4), S(3,2,0,0), S(3,1,0,3),
+    S(1,2,0,4), S(3,2,1,1), S(2,2,0,3), S(2,0,0,4), S(3,2,2,2), S(3,0,0,4),
+    S(3,2,3,3)
+};
+static const BC6HSegment bc6h_layout_7[] = { // 8.6.5.5
+    S(0,0,0,7), S(3,1,4,4), S(2,2,4,4), S(0,1,0,7), S(3,2,2,2), S(2,1,4,4),
+    S(0,2,0,7), S(3,2,3,3), S(3,2,4,4), S(1,0,0,5), S(2,1,0,3), S(1,1,0,4),
+    S(3,2,0,0), S(3,1,0,3), S(1,2,0,4), S(3,2,1,1), S(2,2,0,3), S(2,0,0,5),
+    S(3,0,0,5)
+};
+static const BC6HSegment bc6h_layout_8[] = { // 8.5.6.5
+    S(0,0,0,7), S(3,2,0,0), S(2,2,4,4), S(0,1,0,7), S(2,1,5,5), S(2,1,4,4),
+    S(0,2,0,7), S(3,1,5,5), S(3,2,4,4), S(1,0,0,4), S(3,1,4,4), S(2,1,0,3),
+    S(1,1,0,5), S(3,1,0,3), S(1,2,0,4), S(3,2,1,1), S(2,2,0,3), S(2,0,0,4),
+    S(3,2,2,2), S(3,0,0,4), S(3,2,3,3)
+};
+static const BC6HSegment bc6h_layout_9[] = { // 8.5.5.6
+    S(0,0,0,7), S(3,2,1,1), S(2,2,4,4), S(0,1,0,7), S(2,2,5,5), S(2,1,4,4),
+    S(0,2,0,7), S(3,2,5,5), S(3,2,4,4), S(1,0,0,4), S(3,1,4,4), S(2,1,0,3),
+    S(1,1,0,4), S(3,2,0,0), S(3,1,0,3), S(1,2,0,5), S(2,2,0,3), S(2,0,0,4),
+    S(3,2,2,2), S(3,0,0,4), S(3,2,3,3)
+};
+static const BC6HSegment bc6h_layout_10[] = { // 6.6.6.6
+    S(0,0,0,5), S(3,1,4,4), S(3,2,0,0), S(3,2,1,1), S(2,2,4,4), S(0,1,0,5),
+    S(2,1,5,5), S(2,2,5,5), S(3,2,2,2), S(2,1,4,4), S(0,2,0,5), S(3,1,5,5),
+    S(3,2,3,3), S(3,2,5,5), S(3,2,4,4), S(1,0,0,5), S(2,1,0,3), S(1,1,0,5),
+    S(3,1,0,3), S(1,2,0,5), S(2,2,0,3), S(2,0,0,5), S(3,0,0,5)
+};
+static const BC6HSegment bc6h_layout_11[] = { // 10.10
+    S(0,0,0,9), S(0,1,0,9), S(0,2,0,9), S(1,0,0,9), S(1,1,0,9), S(1,2,0,9)
+};
+static const BC6HSegment bc6h_layout_12[] = { // 11.9
+    S(0,0,0,9), S(0,1,0,9), S(0,2,0,9), S(1,0,0,8), S(0,0,10,10),
+    S(1,1,0,8), S(0,1,10,10), S(1,2,0,8), S(0,2,10,10)
+};
+static const BC6HSegment bc6h_layout_13[] = { // 12.8
+    S(0,0,0,9), S(0,1,0,9), S(0,2,0,9), S(1,0,0,7), S(0,0,11,10),
+    S(1,1,0,7), S(0,1,11,10), S(1,2,0,7), S(0,2,11,10)
+};
+static const BC6HSegment bc6h_layout_14[] = { // 16.4
+    S(0,0,0,9), S(0,1,0,9), S(0,2,0,9), S(1,0,0,3), S(0,0,15,10),
+    S(1,1,0,3), S(0,1,15,10), S(1,2,0,3), S(0,2,15,10)
+};
+#undef S
+
+/// Sign-extend the lowest 'bits' bits of 'value'
+static int32_t bc_sign_extend(int32_t value, uint32_t bits) {
+    uint32_t shift = 32 - bits;
+    return (int32_t) ((uint32_t) value << shift) >> shift;
+}
+
+static int32_t bc6h_unquantize(int32_t value, uint32_t bits, bool is_signed) {
+    if (!is_signed) {
+        if (bits >= 15 || value == 0)
+            return value;
+        if (value == (1 << bits) - 1)
+            return 0xFFFF;
+        return ((value << 16) + 0x8000) >> bits;
+    } else {
+        if (bits >= 16)
+            return value;
+        bool negative = value < 0;
+        int32_t magnitude = negative ? -value : value, result;
+        if (magnitude == 0)
+            result = 0;
+        else if (magnitude >= (1 << (bits - 1)) - 1)
+            result = 0x7FFF;
+        else
+            result = ((magnitude << 15) + 0x4000) >> (bits - 1);
+        return negative ? -result : result;
+    }
+}
+
+/// Map an interpolated BC6H value to the bit pattern of a half precision float
+static uint16_t bc6h_finish_unquantize(int32_t value, bool is_signed) {
+    if (!is_signed)
+        return (uint16_t) ((value * 31) >> 6);
+    else if (value < 0)
+        return (uint16_t) (0x8000 | ((-value * 31) >> 5));
+    else
+        return (uint16_t) ((value * 31) >> 5);
+}
+
+/// Decode a BC6H block into 4x4 RGB half precision texels
+static void bc6h_decode_block(const uint8_t *block, uint16_t *out, bool is_signed) {
+    struct ModeInfo {
+        uint8_t code;
+        bool transformed;
+        uint8_t precision, delta_bits[3];
+        const BC6HSegment *layout;
+        size_t layout_size;
+    };
+
+    #define L(x) x, sizeof(x) / sizeof(BC6HSegment)
+    static const ModeInfo modes[14] = {
+        { 0x00, true,  10, {  5,  5,  5 }, L(bc6h_layout_1) },
+        { 0x01, true,   7, {  6,  6,  6 }, L(bc6h_layout_2) },
+        { 0x02, true,  11, {  5,  4,  4 }, L(bc6h_layout_3) },
+        { 0x06, true,  11, {  4,  5,  4 }, L(bc6h_layout_4) },
+        { 0x0A, true,  11, {  4,  4,  5 }, L(bc6h_layout_5) },
+        { 0x0E, true,   9, {  5,  5,  5 }, L(bc6h_layout_6) },
+        { 0x12, true,   8, {  6,  5,  5 }, L(bc6h_layout_7) },
+        { 0x16, true,   8, {  5,  6,  5 }, L(bc6h_layout_8) },
+        { 0x1A, true,   8, {  5,  5,  6 }, L(bc6h_layout_9) },
+        { 0x1E, false,  6, {  6,  6,  6 }, L(bc6h_layout_10) },
+        { 0x03, false, 10, { 10, 10, 10 }, L(bc6h_layout_11) },
+        { 0x07, true,  11, {  9,  9,  9 }, L(bc6h_layout_12) },
+        { 0x0B, true,  12, {  8,  8,  8 }, L(bc6h_layout_13) },
+        { 0x0F, true,  16, {  4,  4,  4 }, L(bc6h_layout_14) }
+    };
+    #undef L
+
+    BlockBitReader bits(block);
+    uint32_t code = bits.read(2);
+    if (code > 1)
+        code |= bits.read(3) << 2;
+
+    const ModeInfo *info = nullptr;
+    for (const ModeInfo &mode : modes) {
+        if (mode.code == code) {
+            info = &mode;
+            break;
+        }
+    }
+
+    if (!info) {
+        // Reserved mode: the specification mandates black
+        memset(out, 0, 16 * 3 * sizeof(uint16_t));
+        return;
+    }
+
+    int32_t endpoints[4][3] = { };
+    for (size_t i = 0; i < info->layout_size; ++i) {
+        const BC6HSegment &s = info->layout[i];
+        int32_t step = s.last >= s.first ? 1 : -1;
+        for (int32_t b = s.first; ; b += step) {
+            endpoints[s.e][s.c] |= (int32_t) bits.read(1) << b;
+            if (b == s.last)
+                break;
+        }
+    }
+
+    bool two_regions = (info->code & 3) != 3;
+    uint32_t subsets = two_regions ? 2 : 1,
+             partition = two_regions ? bits.read(5) : 0,
+             endpoint_count = 2 * subsets,
+             index_bits = two_regions ? 3 : 4;
+
+    // Reconstruct the endpoints from the base value and deltas
+    for (uint32_t c = 0; c < 3; ++c) {
+        uint32_t precision = info->precision;
+        if (is_signed)
+            endpoints[0][c] = bc_sign_extend(endpoints[0][c], precision);
+
+        for (uint32_t e = 1; e < endpoint_count; ++e) {
+            int32_t &value = endpoints[e][c];
+            if (info->transformed || is_signed)
+                value = bc_sign_extend(value, info->delta_bits[c]);
+            if (info->transformed) {
+                value = (endpoints[0][c] + value) & ((1 << precision) - 1);
+                if (is_signed)
+                    value = bc_sign_extend(value, precision);
+            }
+        }
+
+        for (uint32_t e = 0; e < endpoint_count; ++e)
+            endpoints[e][c] = bc6h_unquantize(endpoints[e][c], precision, is_signed);
+    }
+
+    const uint8_t *weights = bc_weights(index_bits);
+    for (uint32_t i = 0; i < 16; ++i) {
+        uint32_t index = bits.read(index_bits -
+                                   (bc_is_anchor(subsets, partition, i) ? 1 : 0)),
+                 subset = bc_subset(subsets, partition, i),
+                 w = weights[index];
+        const int32_t *e0 = endpoints[2 * subset], *e1 = endpoints[2 * subset + 1];
+        for (uint32_t c = 0; c < 3; ++c)
+            out[3 * i + c] = bc6h_finish_unquantize(
+                ((64 - (int32_t) w) * e0[c] + (int32_t) w * e1[c] + 32) >> 6,
+                is_signed);
+    }
+}
+
+void Bitmap::read_dds(Stream *stream) {
+    ScopedPhase phase(ProfilerPhase::BitmapRead);
+    auto byte_order = stream->byte_order();
+    stream->set_byte_order(Stream::ELittleEndian);
+    try {
+        char magic[4];
+        stream->read(magic, 4);
+        if (strncmp(magic, "DDS ", 4) != 0)
+            Throw("read_dds(): Invalid header identifier!");
+
+        /* DDS_HEADER: size, flags, height, width, pitch, depth, MIP count,
+           11 reserved words, 8 words of pixel format, caps 1-4, reserved */
+        uint32_t header[31];
+        for (uint32_t &value : header)
+            stream->read(value);
+
+        uint32_t height = header[2], width = header[3], four_cc = header[20];
+        if (header[0] != 124 || width == 0 || height == 0)
+            Throw("read_dds(): Invalid header!");
+
+        if (four_cc != 0x30315844 /* 'DX10' */)
+            Throw("read_dds(): Only files with a DX10 header extension are "
+                  "supported!");
+
+        // DDS_HEADER_DXT10: format, dimension, flags, array size, flags 2
+        uint32_t dxt10[5];
+        for (uint32_t &value : dxt10)
+            stream->read(value);
+
+        if (dxt10[1] != 3 /* TEXTURE2D */ || (dxt10[2] & 4) /* TEXTURECUBE */ ||
+            dxt10[3] > 1)
+            Throw("read_dds(): Only individual 2D textures are supported!");
+
+        bool bc6h, is_signed = false;
+        std::string compression;
+        switch (dxt10[0]) {
+            case 94: // DXGI_FORMAT_BC6H_TYPELESS
+            case 95: // DXGI_FORMAT_BC6H_UF16
+                bc6h = true;
+                compression = "BC6H_UF16";
+                break;
+
+            case 96: // DXGI_FORMAT_BC6H_SF16
+                bc6h = true;
+                is_signed = true;
+                compression = "BC6H_SF16";
+                break;
+
+            case 97: // DXGI_FORMAT_BC7_TYPELESS
+            case 98: // DXGI_FORMAT_BC7_UNORM
+                bc6h = false;
+                compression = "BC7_UNORM";
+                break;
+
+            case 99: // DXGI_FORMAT_BC7_UNORM_SRGB
+                bc6h = false;
+                compression = "BC7_UNORM_SRGB";
+                break;
+
+            default:
+                Throw("read_dds(): Unsupported DXGI format %u (only BC6H and "
+                      "BC7 are supported)!", dxt10[0]);
+        }
+
+        m_size = Vector2u(width, height);
+        m_pixel_format = bc6h ? PixelFormat::RGB : PixelFormat::RGBA;
+        m_component_format = bc6h ? Struct::Type::Float16 : Struct::Type::UInt8;
+        m_srgb_gamma = compression == "BC7_UNORM_SRGB";
+        m_premultiplied_alpha = false;
+        m_metadata.set_string("block_compression", compression);
+        rebuild_struct();
+
+        auto fs = dynamic_cast<FileStream *>(stream);
+        Log(Debug, "Loading DDS file \"%s\" (%ix%i, %s) ..",
+            fs ? fs->path().string() : "<stream>", m_size.x(), m_size.y(),
+            compression);
+
+        // Only the top MIP level is read, the remaining levels are skipped
+        size_t blocks_x = (width + 3) / 4, blocks_y = (height + 3) / 4;
+        std::unique_ptr<uint8_t[]> blocks(new uint8_t[blocks_x * blocks_y * 16]);
+        stream->read(blocks.get(), blocks_x * blocks_y * 16);
+
+        m_data = std::unique_ptr<uint8_t[]>(new uint8_t[buffer_size()]);
+        m_owns_data = true;
+
+        size_t channels = bc6h ? 3 : 4, texel_size = bc6h ? 2 : 1,
+               row_size = (size_t) width * channels * texel_size;
+
+        dr::parallel_for(
+            dr::blocked_range<size_t>(0, blocks_y, 16),
+            [&](const dr::blocked_range<size_t> &range) {
+                uint16_t decoded_half[16 * 3];
+                uint8_t decoded_byte[16 * 4];
+                const uint8_t *decoded = bc6h ? (const uint8_t *) decoded_half
+                                              : decoded_byte;
+
+                for (size_t by = range.begin(); by != range.end(); ++by) {
+                    for (size_t bx = 0; bx < blocks_x; ++bx) {
+                        const uint8_t *block = blocks.get() + (by * blocks_x + bx) * 16;
+                        if (bc6h)
+                            bc6h_decode_block(block, decoded_half, is_signed);
+                        else
+                            bc7_decode_block(block, decoded_byte);
+
+                        // Copy the texels that lie within the image
+                        size_t x0 = bx * 4, y0 = by * 4,
+                               w = std::min<size_t>(4, width - x0),
+                               h = std::min<size_t>(4, height - y0);
+                        for (size_t y = 0; y < h; ++y)
+                            memcpy(m_data.get() + (y0 + y) * row_size +
+                                       x0 * channels * texel_size,
+                                   decoded + y * 4 * channels * texel_size,
+                                   w * channels * texel_size);
+                    }
+                }
+            }
+        );
+
+        stream->set_byte_order(byte_order);
+    } catch (...) {
+        stream->set_byte_order(byte_order);
+        throw;
+    }
+}
+
 std::ostream &operator<<(std::ostream &os, Bitmap::PixelFormat value) {
     switch (value) {
         case Bitmap::PixelFormat::Y:            os << "y"; break;
@@ -2527,6 +3746,7 @@ std::ostream &operator<<(std::ostream &os, Bitmap::FileFormat value) {
         case Bitmap::FileFormat::PFM:     os << "PFM"; break;
         case Bitmap::FileFormat::PPM:     os << "PPM"; break;
         case Bitmap::FileFormat::RGBE:    os << "RGBE"; break;
+        case Bitmap::FileFormat::DDS:     os << "DDS"; break;
         case Bitmap::FileFormat::Auto:    os << "Auto"; break;
         default: Throw("Unknown file format!");
     }
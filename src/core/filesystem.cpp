@@ -7,6 +7,7 @@
 #include <codecvt>
 #include <cstdlib>
 #include <cstring>
+#include <cwchar>
 #include <locale>
 #include <stdexcept>
 #include <sstream>
@@ -14,6 +15,7 @@
 #if defined(_WIN32)
 #  include <windows.h>
 #else
+#  include <dirent.h>
 #  include <unistd.h>
 #  include <sys/stat.h>
 #endif
@@ -133,6 +135,19 @@ size_t file_size(const path& p) {
     return (size_t) sb.st_size;
 }
 
+int64_t last_write_time(const path& p) {
+#if defined(_WIN32)
+    struct _stati64 sb;
+    if (_wstati64(p.native().c_str(), &sb) != 0)
+        throw std::runtime_error("filesystem::last_write_time(): cannot stat file \"" + p.string() + "\"!");
+#else
+    struct stat sb;
+    if (stat(p.native().c_str(), &sb) != 0)
+        throw std::runtime_error("filesystem::last_write_time(): cannot stat file \"" + p.string() + "\"!");
+#endif
+    return (int64_t) sb.st_mtime;
+}
+
 bool equivalent(const path& p1, const path& p2) {
 #if defined(_WIN32)
     struct _stati64 sb1, sb2;
@@ -205,6 +220,33 @@ bool rename(const path& src, const path &dst) {
 #endif
 }
 
+std::vector<path> directory_entries(const path& p) {
+    std::vector<path> result;
+#if !defined(_WIN32)
+    DIR *dir = opendir(p.native().c_str());
+    if (!dir)
+        return result;
+    while (struct dirent *entry = readdir(dir)) {
+        if (std::strcmp(entry->d_name, ".") != 0 &&
+            std::strcmp(entry->d_name, "..") != 0)
+            result.emplace_back(entry->d_name);
+    }
+    closedir(dir);
+#else
+    WIN32_FIND_DATAW data;
+    HANDLE handle = FindFirstFileW((p.native() + NSTR("\\*")).c_str(), &data);
+    if (handle == INVALID_HANDLE_VALUE)
+        return result;
+    do {
+        if (std::wcscmp(data.cFileName, NSTR(".")) != 0 &&
+            std::wcscmp(data.cFileName, NSTR("..")) != 0)
+            result.emplace_back(data.cFileName);
+    } while (FindNextFileW(handle, &data));
+    FindClose(handle);
+#endif
+    return result;
+}
+
 // -----------------------------------------------------------------------------
 
 fs::path path::extension() const {
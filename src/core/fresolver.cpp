@@ -9,10 +9,15 @@ FileResolver::FileResolver() : Object() {
 }
 
 FileResolver::FileResolver(const FileResolver &fr)
-  : Object(), m_paths(fr.m_paths) { }
+  : Object(), m_paths(fr.m_paths) {
+    std::lock_guard<std::mutex> guard(fr.m_mutex);
+    m_cache = fr.m_cache;
+    m_listings = fr.m_listings;
+}
 
 void FileResolver::erase(const fs::path &p) {
     m_paths.erase(std::remove(m_paths.begin(), m_paths.end(), p), m_paths.end());
+    clear_cache();
 }
 
 bool FileResolver::contains(const fs::path &p) const {
@@ -20,16 +25,54 @@ bool FileResolver::contains(const fs::path &p) const {
 }
 
 fs::path FileResolver::resolve(const fs::path &path) const {
-    if (!path.is_absolute()) {
-        for (auto const &base : m_paths) {
-            fs::path combined = base / path;
-            if (fs::exists(combined))
-                return combined;
+    if (path.is_absolute())
+        return path;
+
+    fs::string_type name = path.native();
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        auto it = m_cache.find(name);
+        if (it != m_cache.end())
+            return it->second;
+    }
+
+    /* The directory listings can only rule out search paths if the first
+       component of the path refers to one of their entries */
+    fs::string_type first = name.substr(0, name.find(fs::preferred_separator));
+    bool use_listings = !m_listings.empty() &&
+                        first.find_first_not_of('.') != fs::string_type::npos;
+
+    for (size_t i = 0; i < m_paths.size(); ++i) {
+        if (use_listings && m_listings[i].find(first) == m_listings[i].end())
+            continue;
+        fs::path combined = m_paths[i] / path;
+        if (fs::exists(combined)) {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            m_cache.emplace(name, combined);
+            return combined;
         }
     }
+
     return path;
 }
 
+void FileResolver::prefetch() {
+    std::vector<std::unordered_set<fs::string_type>> listings(m_paths.size());
+    for (size_t i = 0; i < m_paths.size(); ++i) {
+        for (const fs::path &entry : fs::directory_entries(m_paths[i]))
+            listings[i].insert(entry.native());
+    }
+
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_listings = std::move(listings);
+}
+
+void FileResolver::clear_cache() {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_cache.clear();
+    m_listings.clear();
+}
+
 std::string FileResolver::to_string() const {
     std::ostringstream oss;
     oss << "FileResolver[" << std::endl;
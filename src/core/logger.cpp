@@ -8,20 +8,141 @@
 #include <iostream>
 #include <algorithm>
 #include <mutex>
+#include <atomic>
+#include <condition_variable>
 
 NAMESPACE_BEGIN(mitsuba)
 
+/// Number of messages that can be queued in asynchronous mode (power of two)
+static constexpr size_t LogQueueSize = 4096;
+
 struct Logger::LoggerPrivate {
     std::mutex mutex;
     LogLevel error_level = Error;
     std::vector<ref<Appender>> appenders;
     ref<Formatter> formatter;
+
+    /* Bounded multi-producer queue of formatted messages used in asynchronous
+       mode. Each slot carries a sequence number that tells producers whether
+       it is free and the consumer whether it holds a message. Messages are
+       consumed by whichever thread holds 'mutex', which keeps the consumer
+       side single-threaded and ordered with respect to progress messages. */
+    struct Slot {
+        std::atomic<size_t> seq;
+        LogLevel level;
+        std::string text;
+    };
+    std::unique_ptr<Slot[]> queue;
+    std::atomic<size_t> queue_tail { 0 };
+    size_t queue_head = 0;
+
+    std::atomic<bool> async { false };
+    std::atomic<bool> stop { false };
+    std::condition_variable cv;
+    std::mutex cv_mutex;
+    std::thread drain_thread;
+
+    /// Try to enqueue a message, returns 'false' when the queue is full
+    bool push(LogLevel level, std::string &text) {
+        size_t pos = queue_tail.load(std::memory_order_relaxed);
+        Slot *slot;
+        while (true) {
+            slot = &queue[pos & (LogQueueSize - 1)];
+            size_t seq = slot->seq.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t) seq - (intptr_t) pos;
+            if (diff == 0) {
+                if (queue_tail.compare_exchange_weak(pos, pos + 1,
+                                                     std::memory_order_relaxed))
+                    break;
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = queue_tail.load(std::memory_order_relaxed);
+            }
+        }
+        slot->level = level;
+        slot->text = std::move(text);
+        slot->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Forward all queued messages to the appenders (requires 'mutex')
+    void drain() {
+        if (!queue)
+            return;
+        while (true) {
+            Slot &slot = queue[queue_head & (LogQueueSize - 1)];
+            if (slot.seq.load(std::memory_order_acquire) != queue_head + 1)
+                break;
+            std::string text = std::move(slot.text);
+            LogLevel level = slot.level;
+            slot.seq.store(queue_head + LogQueueSize, std::memory_order_release);
+            queue_head++;
+            for (auto entry : appenders)
+                entry->append(level, text);
+        }
+    }
+
+    void start() {
+        if (!queue) {
+            queue.reset(new Slot[LogQueueSize]);
+            for (size_t i = 0; i < LogQueueSize; ++i)
+                queue[i].seq.store(i, std::memory_order_relaxed);
+        }
+        stop = false;
+        drain_thread = std::thread([this]() {
+            while (!stop) {
+                {
+                    std::unique_lock<std::mutex> guard(cv_mutex);
+                    cv.wait_for(guard, std::chrono::milliseconds(50));
+                }
+                std::lock_guard<std::mutex> guard(mutex);
+                drain();
+            }
+        });
+    }
+
+    void shutdown() {
+        if (!drain_thread.joinable())
+            return;
+        {
+            std::lock_guard<std::mutex> guard(cv_mutex);
+            stop = true;
+        }
+        cv.notify_one();
+        drain_thread.join();
+        std::lock_guard<std::mutex> guard(mutex);
+        drain();
+    }
 };
 
 Logger::Logger(LogLevel log_level)
     : m_log_level(log_level), d(new LoggerPrivate()) { }
 
-Logger::~Logger() { }
+Logger::~Logger() {
+    d->shutdown();
+}
+
+void Logger::set_asynchronous(bool value) {
+    if (value == d->async)
+        return;
+    if (value) {
+        d->start();
+        d->async = true;
+    } else {
+        d->async = false;
+        d->shutdown();
+    }
+}
+
+bool Logger::asynchronous() const {
+    return d->async;
+}
+
+void Logger::flush() {
+    std::lock_guard<std::mutex> guard(d->mutex);
+    d->drain();
+}
 
 void Logger::set_formatter(Formatter *formatter) {
     std::lock_guard<std::mutex> guard(d->mutex);
@@ -57,8 +178,12 @@ void Logger::log(LogLevel level, const Class *class_, const char *file,
 
     if (level < m_log_level)
         return;
-    else if (level >= d->error_level)
+    else if (level >= d->error_level) {
+        // Don't lose the messages leading up to the error
+        if (d->async)
+            flush();
         detail::Throw(level, class_, file, line, msg);
+    }
 
     if (!d->formatter) {
         std::cerr << "PANIC: Logging has not been properly initialized!" << std::endl;
@@ -68,6 +193,16 @@ void Logger::log(LogLevel level, const Class *class_, const char *file,
     std::string text = d->formatter->format(level, class_,
         Thread::thread(), file, line, msg);
 
+    if (d->async) {
+        /* Warnings are rare and should show up promptly. When the queue is
+           full, the producer drains it itself instead of dropping messages */
+        while (!d->push(level, text))
+            flush();
+        if (level >= Warn)
+            d->cv.notify_one();
+        return;
+    }
+
     std::lock_guard<std::mutex> guard(d->mutex);
     for (auto entry : d->appenders)
         entry->append(level, text);
@@ -76,6 +211,7 @@ void Logger::log(LogLevel level, const Class *class_, const char *file,
 void Logger::log_progress(float progress, const std::string &name,
     const std::string &formatted, const std::string &eta, const void *ptr) {
     std::lock_guard<std::mutex> guard(d->mutex);
+    d->drain();
     for (auto entry : d->appenders)
         entry->log_progress(progress, name, formatted, eta, ptr);
 }
@@ -87,12 +223,14 @@ void Logger::add_appender(Appender *appender) {
 
 void Logger::remove_appender(Appender *appender) {
     std::lock_guard<std::mutex> guard(d->mutex);
+    d->drain();
     d->appenders.erase(std::remove(d->appenders.begin(),
         d->appenders.end(), ref<Appender>(appender)), d->appenders.end());
 }
 
 std::string Logger::read_log() {
     std::lock_guard<std::mutex> guard(d->mutex);
+    d->drain();
     for (auto appender: d->appenders) {
         if (appender->class_()->derives_from(MI_CLASS(StreamAppender))) {
             auto sa = static_cast<StreamAppender *>(appender.get());
@@ -106,6 +244,7 @@ std::string Logger::read_log() {
 
 void Logger::clear_appenders() {
     std::lock_guard<std::mutex> guard(d->mutex);
+    d->drain();
     d->appenders.clear();
 }
 
@@ -124,6 +263,9 @@ void Logger::static_initialization() {
 }
 
 void Logger::static_shutdown() {
+    Logger *logger = Thread::thread()->logger();
+    if (logger)
+        logger->set_asynchronous(false);
     Thread::thread()->set_logger(nullptr);
 }
 
@@ -1,4 +1,9 @@
 #include <mitsuba/core/object.h>
+#include <mitsuba/core/string.h>
+#include <mitsuba/core/thread.h>
+#include <mitsuba/core/xml.h>
+#include <nanothread/nanothread.h>
+#include <algorithm>
 #include <cstdlib>
 #include <cstdio>
 #include <sstream>
@@ -35,6 +40,52 @@ std::string Object::to_string() const {
 
 Object::~Object() { }
 
+void parameters_changed_batch(std::vector<ParameterUpdate> updates) {
+    if (updates.empty())
+        return;
+
+    std::stable_sort(updates.begin(), updates.end(),
+                     [](const ParameterUpdate &a, const ParameterUpdate &b) {
+                         return std::get<0>(a) > std::get<0>(b);
+                     });
+
+    /* Objects created by the workers (e.g. JIT variables) should end up in
+       the same scope as if they were created by the calling thread */
+    uint32_t backend = 0, scope = 0;
+#if defined(MI_ENABLE_LLVM) || defined(MI_ENABLE_CUDA)
+    const std::string &variant = std::get<1>(updates[0])->class_()->variant();
+    if (string::starts_with(variant, "cuda_"))
+        backend = (uint32_t) JitBackend::CUDA;
+    else if (string::starts_with(variant, "llvm_"))
+        backend = (uint32_t) JitBackend::LLVM;
+    if (backend)
+        scope = jit_scope((JitBackend) backend);
+#endif
+
+    ThreadEnvironment env;
+    for (size_t begin = 0, end; begin < updates.size(); begin = end) {
+        uint32_t depth = std::get<0>(updates[begin]);
+        for (end = begin + 1;
+             end < updates.size() && std::get<0>(updates[end]) == depth; ++end)
+            ;
+
+        if (end - begin == 1) {
+            std::get<1>(updates[begin])->parameters_changed(std::get<2>(updates[begin]));
+            continue;
+        }
+
+        dr::parallel_for(
+            dr::blocked_range<size_t>(begin, end, 1),
+            [&](const dr::blocked_range<size_t> &range) {
+                ScopedSetThreadEnvironment set_env(env);
+                xml::ScopedSetJITScope set_scope(backend, scope);
+                for (size_t i = range.begin(); i != range.end(); ++i)
+                    std::get<1>(updates[i])->parameters_changed(std::get<2>(updates[i]));
+            }
+        );
+    }
+}
+
 std::ostream& operator<<(std::ostream &os, const Object *object) {
     os << ((object != nullptr) ? object->to_string() : "nullptr");
     return os;
@@ -18,6 +18,13 @@ NAMESPACE_BEGIN(mitsuba)
 
 class Plugin {
 public:
+#if defined(MI_STATIC_PLUGINS)
+    Plugin(const detail::StaticPlugin &plugin) : m_handle(nullptr) {
+        plugin_name  = plugin.plugin_name();
+        plugin_descr = plugin.plugin_descr();
+    }
+#endif
+
     Plugin(const fs::path &path) : m_path(path) {
         #if defined(_WIN32)
             m_handle = LoadLibraryW(path.native().c_str());
@@ -49,6 +56,8 @@ public:
     }
 
     ~Plugin() {
+        if (!m_handle)
+            return;
         #if defined(_WIN32)
             FreeLibrary(m_handle);
         #else
@@ -90,6 +99,20 @@ struct PluginManager::PluginManagerPrivate {
     std::unordered_set<std::string> m_python_plugins;
     std::mutex m_mutex;
 
+#if defined(MI_STATIC_PLUGINS)
+    PluginManagerPrivate() {
+        for (const detail::StaticPlugin *p = detail::static_plugins; p->name; ++p)
+            m_plugins[p->name] = new Plugin(*p);
+    }
+
+    Plugin *plugin(const std::string &name) {
+        // The table is complete from the start, no locking or file lookups
+        auto it = m_plugins.find(name);
+        if (it == m_plugins.end())
+            Throw("Plugin \"%s\" not found!", name.c_str());
+        return it->second;
+    }
+#else
     Plugin *plugin(const std::string &name) {
         std::lock_guard<std::mutex> guard(m_mutex);
 
@@ -125,6 +148,7 @@ struct PluginManager::PluginManagerPrivate {
         // Plugin not found!
         Throw("Plugin \"%s\" not found!", name.c_str());
     }
+#endif
 };
 
 ref<PluginManager> PluginManager::m_instance = new PluginManager();
@@ -2,6 +2,18 @@
 #include <mitsuba/core/logger.h>
 #include <mitsuba/core/util.h>
 
+#if defined(MI_ENABLE_PROFILER)
+#  include <mitsuba/core/timer.h>
+#  include <thread>
+#  include <mutex>
+#  include <map>
+#  include <unordered_map>
+#  include <vector>
+#  include <sstream>
+#  include <iomanip>
+#  include <algorithm>
+#endif
+
 NAMESPACE_BEGIN(mitsuba)
 
 #if defined(MI_ENABLE_ITTNOTIFY)
@@ -10,14 +22,179 @@ __itt_string_handle *
     mitsuba_itt_phase[int(ProfilerPhase::ProfilerPhaseCount)] { };
 #endif
 
+#if defined(MI_ENABLE_PROFILER)
+static_assert(int(ProfilerPhase::ProfilerPhaseCount) <= 64,
+              "List of profiler phases is limited to 64 entries");
+
+/// Sampling interval of the profiler thread
+static constexpr std::chrono::microseconds ProfilerInterval(1000);
+
+thread_local ProfilerRecord *profiler_record = nullptr;
+
+/* Records are never released, since a thread may exit while the sampling
+   thread reads its record. A record is cleared by the phases that set it,
+   hence the record of a finished thread simply reads as idle. */
+static std::mutex profiler_records_mutex;
+static std::vector<ProfilerRecord *> profiler_records;
+
+struct ProfilerState {
+    std::mutex mutex;
+    std::unordered_map<uint64_t, size_t> histogram;
+    size_t ticks = 0;
+    Timer timer;
+    std::atomic<bool> stop { false };
+    std::thread thread;
+};
+
+static ProfilerState *profiler_state = nullptr;
+
+ProfilerRecord *Profiler::register_thread() {
+    ProfilerRecord *record = new ProfilerRecord();
+    profiler_record = record;
+    std::lock_guard<std::mutex> guard(profiler_records_mutex);
+    profiler_records.push_back(record);
+    return record;
+}
+
+static void profiler_sample_loop(ProfilerState *state) {
+    while (!state->stop) {
+        std::this_thread::sleep_for(ProfilerInterval);
+
+        std::lock_guard<std::mutex> guard(state->mutex);
+        std::lock_guard<std::mutex> guard2(profiler_records_mutex);
+        for (ProfilerRecord *record : profiler_records) {
+            uint64_t flags = record->flags.load(std::memory_order_relaxed);
+            if (flags)
+                state->histogram[flags]++;
+        }
+        state->ticks++;
+    }
+}
+
+/// Node of the phase hierarchy reconstructed from the sampled masks
+struct ProfilerNode {
+    size_t count = 0;
+    std::map<int, ProfilerNode> children;
+};
+
+static void profiler_print(std::ostringstream &oss, const ProfilerNode &node,
+                           size_t total, float ms_per_sample, int depth) {
+    std::vector<std::pair<int, const ProfilerNode *>> children;
+    for (auto &[phase, child] : node.children)
+        children.emplace_back(phase, &child);
+    std::sort(children.begin(), children.end(),
+              [](const auto &a, const auto &b) {
+                  return a.second->count > b.second->count;
+              });
+
+    for (auto &[phase, child] : children) {
+        size_t self = child->count;
+        for (auto &[phase2, child2] : child->children)
+            self -= child2.count;
+
+        oss << std::string(2 * depth + 2, ' ')
+            << std::left << std::setw(std::max(50 - 2 * depth, 10))
+            << profiler_phase_id[phase] << std::right << std::fixed
+            << std::setprecision(2) << std::setw(7)
+            << child->count * 100.f / total << "% "
+            << std::setw(10)
+            << util::time_string(child->count * ms_per_sample);
+        if (!child->children.empty())
+            oss << " (self: " << std::setprecision(2)
+                << self * 100.f / total << "%)";
+        oss << std::endl;
+
+        profiler_print(oss, *child, total, ms_per_sample, depth + 1);
+    }
+}
+#endif
+
 void Profiler::static_initialization() {
 #if defined(MI_ENABLE_ITTNOTIFY)
     mitsuba_itt_domain = __itt_domain_create("mitsuba");
     for (int i = 0; i < (int) ProfilerPhase::ProfilerPhaseCount; ++i)
         mitsuba_itt_phase[i] = __itt_string_handle_create(profiler_phase_id[i]);
 #endif
+
+#if defined(MI_ENABLE_PROFILER)
+    if (profiler_state)
+        return;
+    profiler_state = new ProfilerState();
+    profiler_state->thread = std::thread(profiler_sample_loop, profiler_state);
+#endif
+}
+
+void Profiler::static_shutdown() {
+#if defined(MI_ENABLE_PROFILER)
+    if (!profiler_state)
+        return;
+    profiler_state->stop = true;
+    profiler_state->thread.join();
+    delete profiler_state;
+    profiler_state = nullptr;
+#endif
+}
+
+void Profiler::reset() {
+#if defined(MI_ENABLE_PROFILER)
+    if (!profiler_state)
+        return;
+    std::lock_guard<std::mutex> guard(profiler_state->mutex);
+    profiler_state->histogram.clear();
+    profiler_state->ticks = 0;
+    profiler_state->timer.reset();
+#endif
 }
 
-void Profiler::static_shutdown() { }
+std::string Profiler::report() {
+#if defined(MI_ENABLE_PROFILER)
+    if (!profiler_state)
+        return "";
+
+    ProfilerNode root;
+    float elapsed;
+    size_t ticks;
+    /* critical section */ {
+        std::lock_guard<std::mutex> guard(profiler_state->mutex);
+        elapsed = (float) profiler_state->timer.value();
+        ticks = profiler_state->ticks;
+
+        /* Phases are declared in call graph order, hence the set bits of a
+           mask (in increasing order) spell out a path through the hierarchy */
+        for (auto &[flags, count] : profiler_state->histogram) {
+            ProfilerNode *node = &root;
+            root.count += count;
+            for (int i = 0; i < (int) ProfilerPhase::ProfilerPhaseCount; ++i) {
+                if (flags & (1ull << i)) {
+                    node = &node->children[i];
+                    node->count += count;
+                }
+            }
+        }
+    }
+
+    if (root.count == 0)
+        return "";
+
+    float ms_per_sample = elapsed / (float) std::max(ticks, (size_t) 1);
+    std::ostringstream oss;
+    oss << "Profiler: " << root.count << " samples over "
+        << util::time_string(elapsed) << " (thread time, percentages "
+        << "relative to all samples)" << std::endl;
+    profiler_print(oss, root, root.count, ms_per_sample, 0);
+    return oss.str();
+#else
+    return "";
+#endif
+}
+
+void Profiler::print_report() {
+#if defined(MI_ENABLE_PROFILER)
+    std::string text = report();
+    if (!text.empty())
+        Log(Info, "%s", text);
+    reset();
+#endif
+}
 
 NAMESPACE_END(mitsuba)
@@ -5,8 +5,8 @@
 
 #include <cstdlib>
 #include <iostream>
-#include <map>
 #include <sstream>
+#include <algorithm>
 #include <cstring>
 #include <climits>
 
@@ -35,6 +35,7 @@ using VariantType = variant<
     Transform3f,
     Transform4f,
     TensorHandle,
+    ref<AnimatedTransform>,
     Color3f,
     NamedReference,
     ref<Object>,
@@ -42,6 +43,8 @@ using VariantType = variant<
 >;
 
 struct alignas(32) Entry {
+    std::string name;
+    size_t hash;
     VariantType data;
     bool queried;
 };
@@ -73,22 +76,108 @@ struct SortKey {
     }
 };
 
+/**
+ * Entries are stored in a flat array (in insertion order) that is indexed by
+ * a small open-addressing hash table over the precomputed key hashes. Looking
+ * up a property thus hashes the name once and then compares a few integers,
+ * instead of performing a sequence of string comparisons in a tree. The
+ * natural sort order (\ref SortKey) used by all functions that enumerate
+ * properties is only established when it is actually needed.
+ */
 struct Properties::PropertiesPrivate {
-    std::map<std::string, Entry, SortKey> entries;
+    /// Entries in insertion order
+    std::vector<Entry> entries;
+    /// Hash table with indices into \c entries (power of two size)
+    std::vector<uint32_t> table;
     std::string id, plugin_name;
-};
 
-using Iterator = typename std::map<std::string, Entry, SortKey>::iterator;
+    static constexpr uint32_t Empty = (uint32_t) -1;
+
+    static size_t hash(const std::string &name) {
+        return std::hash<std::string>()(name);
+    }
+
+    /// Look up an entry, returns \c nullptr when it does not exist
+    Entry *find(const std::string &name) {
+        if (table.empty())
+            return nullptr;
+        size_t h = hash(name), mask = table.size() - 1;
+        for (size_t i = h & mask; ; i = (i + 1) & mask) {
+            uint32_t index = table[i];
+            if (index == Empty)
+                return nullptr;
+            Entry &e = entries[index];
+            if (e.hash == h && e.name == name)
+                return &e;
+        }
+    }
+
+    /// Return the entry with the given name, creating it when necessary
+    Entry &insert(const std::string &name) {
+        if (Entry *e = find(name))
+            return *e;
+        Entry &e = entries.emplace_back();
+        e.name = name;
+        e.hash = hash(name);
+        e.queried = false;
+        if (2 * entries.size() > table.size())
+            rebuild();
+        else
+            insert_index((uint32_t) entries.size() - 1);
+        return e;
+    }
+
+    void erase(Entry *e) {
+        entries.erase(entries.begin() + (e - entries.data()));
+        rebuild();
+    }
+
+    /// Pointers to the entries satisfying \c pred, in natural sort order
+    template <typename Pred> std::vector<Entry *> sorted(Pred pred) {
+        std::vector<Entry *> result;
+        for (Entry &e : entries) {
+            if (pred(e))
+                result.push_back(&e);
+        }
+        std::sort(result.begin(), result.end(),
+                  [](const Entry *a, const Entry *b) {
+                      return SortKey()(a->name, b->name);
+                  });
+        return result;
+    }
+
+    std::vector<Entry *> sorted() {
+        return sorted([](const Entry &) { return true; });
+    }
+
+private:
+    void insert_index(uint32_t index) {
+        size_t mask = table.size() - 1,
+               i    = entries[index].hash & mask;
+        while (table[i] != Empty)
+            i = (i + 1) & mask;
+        table[i] = index;
+    }
+
+    void rebuild() {
+        size_t size = 16;
+        while (size < 4 * entries.size())
+            size *= 2;
+        table.assign(size, Empty);
+        for (size_t i = 0; i < entries.size(); ++i)
+            insert_index((uint32_t) i);
+    }
+};
 
 template <typename T, typename T2 = T>
-T get_impl(const Iterator &it) {
-    if (!it->second.data.template is<T>() && !it->second.data.template is<T2>())
+T get_impl(Entry &e) {
+    if (!e.data.template is<T>() && !e.data.template is<T2>())
         Throw("The property \"%s\" has the wrong type (expected <%s> or <%s>, is <%s>)",
-              it->first, typeid(T).name(), typeid(T2).name(), it->second.data.type().name());
-    it->second.queried = true;
-    if (it->second.data.template is<T2>())
-        return (T const &) (T2 const &) it->second.data;
-    return (T const &) it->second.data;
+              e.name, typeid(T).name(), typeid(T2).name(), e.data.type().name());
+    e.queried = true;
+    if (e.data.template is<T2>())
+        return (T const &) (T2 const &) e.data;
+    return (T const &) e.data;
 }
 
 
@@ -98,108 +187,109 @@ T get_impl(const Iterator &it) {
  * backwards compatibility
  */
 template<>
-Transform3f get_impl<Transform3f, Transform4f>(const Iterator &it) {
-    if (!it->second.data.template is<Transform3f>() && !it->second.data.template is<Transform4f>())
+Transform3f get_impl<Transform3f, Transform4f>(Entry &e) {
+    if (!e.data.template is<Transform3f>() && !e.data.template is<Transform4f>())
         Throw("The property \"%s\" has the wrong type (expected <%s> or <%s>, is <%s>)",
-              it->first, typeid(Transform3f).name(), typeid(Transform4f).name(), it->second.data.type().name());
-    it->second.queried = true;
-    if (it->second.data.template is<Transform4f>())
-        return ((Transform4f const &)it->second.data).extract();
-    return (Transform3f const &) it->second.data;
+              e.name, typeid(Transform3f).name(), typeid(Transform4f).name(), e.data.type().name());
+    e.queried = true;
+    if (e.data.template is<Transform4f>())
+        return ((Transform4f const &) e.data).extract();
+    return (Transform3f const &) e.data;
 }
 
 template <typename T>
-T get_routing(const Iterator &it) {
+T get_routing(Entry &e) {
     if constexpr (dr::is_static_array_v<T>) {
         Assert(T::Size == 3);
         if constexpr (std::is_same_v<T, Color<float, 3>> ||
                       std::is_same_v<T, Color<double, 3>>)
-            return (T) get_impl<Color3f, Array3f>(it);
+            return (T) get_impl<Color3f, Array3f>(e);
         else
-            return (T) get_impl<Array3f>(it);
+            return (T) get_impl<Array3f>(e);
     }
 
     if constexpr (std::is_same_v<T, TensorHandle>)
-        return get_impl<TensorHandle>(it);
+        return get_impl<TensorHandle>(e);
 
     if constexpr (std::is_same_v<T, Transform<Point<float, 3>>> ||
                   std::is_same_v<T, Transform<Point<double, 3>>>)
-        return (T) get_impl<Transform3f, Transform4f>(it);
+        return (T) get_impl<Transform3f, Transform4f>(e);
 
     if constexpr (std::is_same_v<T, Transform<Point<float, 4>>> ||
                   std::is_same_v<T, Transform<Point<double, 4>>>)
-        return (T) get_impl<Transform4f>(it);
+        return (T) get_impl<Transform4f>(e);
 
     if constexpr (std::is_floating_point_v<T>)
-        return (T) get_impl<Float, int64_t>(it);
+        return (T) get_impl<Float, int64_t>(e);
 
     if constexpr (std::is_same_v<T, ref<Object>>)
-        return get_impl<ref<Object>>(it);
+        return get_impl<ref<Object>>(e);
 
     if constexpr (std::is_same_v<T, bool>)
-        return get_impl<T>(it);
+        return get_impl<T>(e);
 
     if constexpr (std::is_integral_v<T> && !std::is_pointer_v<T>) {
-        int64_t v = get_impl<int64_t>(it);
+        int64_t v = get_impl<int64_t>(e);
         if constexpr (std::is_unsigned_v<T>) {
             if (v < 0) {
                 Throw("Property \"%s\" has negative value %i, but was queried as a"
-                    " size_t (unsigned).", it->first, v);
+                    " size_t (unsigned).", e.name, v);
             }
         }
         return (T) v;
     }
 
     if constexpr (std::is_same_v<T, std::string>)
-        return get_impl<T>(it);
+        return get_impl<T>(e);
 
     Throw("Unsupported type: <%s>.", typeid(T).name());
 }
 
 template <typename T>
 T Properties::get(const std::string &name) const {
-    const auto it = d->entries.find(name);
-    if (it == d->entries.end())
+    Entry *e = d->find(name);
+    if (!e)
         Throw("Property \"%s\" has not been specified!", name);
-    return get_routing<T>(it);
+    return get_routing<T>(*e);
 }
 
 template <typename T>
 T Properties::get(const std::string &name, const T &def_val) const {
-    const auto it = d->entries.find(name);
-    if (it == d->entries.end())
+    Entry *e = d->find(name);
+    if (!e)
         return def_val;
-    return get_routing<T>(it);
+    return get_routing<T>(*e);
 }
 #define DEFINE_PROPERTY_SETTER(Type, SetterName) \
     void Properties::SetterName(const std::string &name, Type const &value, bool error_duplicates) { \
         if (has_property(name) && error_duplicates) \
             Log(Error, "Property \"%s\" was specified multiple times!", name); \
-        d->entries[name].data = (Type) value; \
-        d->entries[name].queried = false; \
+        Entry &e = d->insert(name); \
+        e.data = (Type) value; \
+        e.queried = false; \
     }
 
 #define DEFINE_PROPERTY_ACCESSOR(Type, TagName, SetterName, GetterName) \
     DEFINE_PROPERTY_SETTER(Type, SetterName) \
     \
     Type const & Properties::GetterName(const std::string &name) const { \
-        const auto it = d->entries.find(name); \
-        if (it == d->entries.end()) \
+        Entry *e = d->find(name); \
+        if (!e) \
             Throw("Property \"%s\" has not been specified!", name); \
-        if (!it->second.data.is<Type>()) \
+        if (!e->data.is<Type>()) \
             Throw("The property \"%s\" has the wrong type (expected <" #TagName ">).", name); \
-        it->second.queried = true; \
-        return (Type const &) it->second.data; \
+        e->queried = true; \
+        return (Type const &) e->data; \
     } \
     \
     Type const & Properties::GetterName(const std::string &name, Type const &def_val) const { \
-        const auto it = d->entries.find(name); \
-        if (it == d->entries.end()) \
+        Entry *e = d->find(name); \
+        if (!e) \
             return def_val; \
-        if (!it->second.data.is<Type>()) \
+        if (!e->data.is<Type>()) \
             Throw("The property \"%s\" has the wrong type (expected <" #TagName ">).", name); \
-        it->second.queried = true; \
-        return (Type const &) it->second.data; \
+        e->queried = true; \
+        return (Type const &) e->data; \
     }
 
 DEFINE_PROPERTY_SETTER(bool,         set_bool)
@@ -233,7 +323,7 @@ void Properties::operator=(const Properties &props) {
 }
 
 bool Properties::has_property(const std::string &name) const {
-    return d->entries.find(name) != d->entries.end();
+    return d->find(name) != nullptr;
 }
 
 namespace {
@@ -248,6 +338,7 @@ namespace {
         Type operator()(const Transform3f &) { return Type::Transform3f; }
         Type operator()(const Transform4f &) { return Type::Transform4f; }
         Type operator()(const TensorHandle &) { return Type::Tensor; }
+        Type operator()(const ref<AnimatedTransform> &) { return Type::AnimatedTransform; }
         Type operator()(const Color3f &) { return Type::Color; }
         Type operator()(const NamedReference &) { return Type::NamedReference; }
         Type operator()(const ref<Object> &) { return Type::Object; }
@@ -266,6 +357,7 @@ namespace {
         void operator()(const Transform3f &t) { os << t; }
         void operator()(const Transform4f &t) { os << t; }
         void operator()(const TensorHandle &t) { os << t.get(); }
+        void operator()(const ref<AnimatedTransform> &t) { os << t->to_string(); }
         void operator()(const Color3f &t) { os << t; }
         void operator()(const NamedReference &nr) { os << "\"" << (const std::string &) nr << "\""; }
         void operator()(const ref<Object> &o) { os << o->to_string(); }
@@ -274,33 +366,33 @@ namespace {
 }
 
 Properties::Type Properties::type(const std::string &name) const {
-    const auto it = d->entries.find(name);
-    if (it == d->entries.end())
+    Entry *e = d->find(name);
+    if (!e)
         Throw("type(): Could not find property named \"%s\"!", name);
 
-    return it->second.data.visit(PropertyTypeVisitor());
+    return e->data.visit(PropertyTypeVisitor());
 }
 
 bool Properties::mark_queried(const std::string &name) const {
-    auto it = d->entries.find(name);
-    if (it == d->entries.end())
+    Entry *e = d->find(name);
+    if (!e)
         return false;
-    it->second.queried = true;
+    e->queried = true;
     return true;
 }
 
 bool Properties::was_queried(const std::string &name) const {
-    const auto it = d->entries.find(name);
-    if (it == d->entries.end())
+    Entry *e = d->find(name);
+    if (!e)
         Throw("Could not find property named \"%s\"!", name);
-    return it->second.queried;
+    return e->queried;
 }
 
 bool Properties::remove_property(const std::string &name) {
-    const auto it = d->entries.find(name);
-    if (it == d->entries.end())
+    Entry *e = d->find(name);
+    if (!e)
         return false;
-    d->entries.erase(it);
+    d->erase(e);
     return true;
 }
 
@@ -323,59 +415,68 @@ void Properties::set_id(const std::string &id) {
 void Properties::copy_attribute(const Properties &properties,
                                 const std::string &source_name,
                                 const std::string &target_name) {
-    const auto it = properties.d->entries.find(source_name);
-    if (it == properties.d->entries.end())
+    Entry *e = properties.d->find(source_name);
+    if (!e)
         Throw("copy_attribute(): Could not find parameter \"%s\"!", source_name);
-    d->entries[target_name] = it->second;
+    // Copy before inserting, which may reallocate the entries of 'properties'
+    VariantType data = e->data;
+    bool queried = e->queried;
+    Entry &target = d->insert(target_name);
+    target.data = std::move(data);
+    target.queried = queried;
 }
 
 std::vector<std::string> Properties::property_names() const {
     std::vector<std::string> result;
-    for (const auto &e : d->entries)
-        result.push_back(e.first);
+    result.reserve(d->entries.size());
+    for (const Entry *e : d->sorted())
+        result.push_back(e->name);
     return result;
 }
 
 std::vector<std::pair<std::string, NamedReference>> Properties::named_references() const {
     std::vector<std::pair<std::string, NamedReference>> result;
-    result.reserve(d->entries.size());
-    for (auto &e : d->entries) {
-        auto type = e.second.data.visit(PropertyTypeVisitor());
-        if (type != Type::NamedReference)
-            continue;
-        auto const &value = (const NamedReference &) e.second.data;
-        result.push_back(std::make_pair(e.first, value));
-        e.second.queried = true;
+    auto entries = d->sorted([](const Entry &e) {
+        return e.data.is<NamedReference>();
+    });
+    result.reserve(entries.size());
+    for (Entry *e : entries) {
+        auto const &value = (const NamedReference &) e->data;
+        result.push_back(std::make_pair(e->name, value));
+        e->queried = true;
     }
     return result;
 }
 
 std::vector<std::pair<std::string, ref<Object>>> Properties::objects(bool mark_queried) const {
     std::vector<std::pair<std::string, ref<Object>>> result;
-    result.reserve(d->entries.size());
-    for (auto &e : d->entries) {
-        auto type = e.second.data.visit(PropertyTypeVisitor());
-        if (type != Type::Object)
-            continue;
-        result.push_back(std::make_pair(e.first, (const ref<Object> &) e.second));
+    auto entries = d->sorted([](const Entry &e) {
+        return e.data.is<ref<Object>>();
+    });
+    result.reserve(entries.size());
+    for (Entry *e : entries) {
+        result.push_back(std::make_pair(e->name, (const ref<Object> &) e->data));
         if (mark_queried)
-            e.second.queried = true;
+            e->queried = true;
     }
     return result;
 }
 
 std::vector<std::string> Properties::unqueried() const {
     std::vector<std::string> result;
-    for (const auto &e : d->entries) {
-        if (!e.second.queried)
-            result.push_back(e.first);
-    }
+    for (const Entry *e : d->sorted([](const Entry &e) { return !e.queried; }))
+        result.push_back(e->name);
     return result;
 }
 
 void Properties::merge(const Properties &p) {
-    for (const auto &e : p.d->entries)
-        d->entries[e.first] = e.second;
+    if (&p == this)
+        return;
+    for (const Entry &e : p.d->entries) {
+        Entry &target = d->insert(e.name);
+        target.data = e.data;
+        target.queried = e.queried;
+    }
 }
 
 bool Properties::operator==(const Properties &p) const {
@@ -384,11 +485,9 @@ bool Properties::operator==(const Properties &p) const {
         d->entries.size() != p.d->entries.size())
         return false;
 
-    for (const auto &e : d->entries) {
-        auto it = p.d->entries.find(e.first);
-        if (it == p.d->entries.end())
-            return false;
-        if (e.second.data != it->second.data)
+    for (const Entry &e : d->entries) {
+        const Entry *e2 = p.d->find(e.name);
+        if (!e2 || e.data != e2->data)
             return false;
     }
 
@@ -396,46 +495,34 @@ bool Properties::operator==(const Properties &p) const {
 }
 
 std::string Properties::as_string(const std::string &name) const {
+    Entry *e = d->find(name);
+    if (!e)
+        Throw("Property \"%s\" has not been specified!", name);
     std::ostringstream oss;
-    bool found = false;
-    for (auto &e : d->entries) {
-        if (e.first != name)
-            continue;
-        e.second.data.visit(StreamVisitor(oss));
-        found = true;
-        break;
-    }
-    if (!found)
-        Throw("Property \"%s\" has not been specified!", name); \
+    e->data.visit(StreamVisitor(oss));
     return oss.str();
 }
 
 std::string Properties::as_string(const std::string &name, const std::string &def_val) const {
-    std::ostringstream oss;
-    bool found = false;
-    for (auto &e : d->entries) {
-        if (e.first != name)
-            continue;
-        e.second.data.visit(StreamVisitor(oss));
-        found = true;
-        break;
-    }
-    if (!found)
+    Entry *e = d->find(name);
+    if (!e)
         return def_val;
+    std::ostringstream oss;
+    e->data.visit(StreamVisitor(oss));
     return oss.str();
 }
 
 std::ostream &operator<<(std::ostream &os, const Properties &p) {
-    auto it = p.d->entries.begin();
+    auto entries = p.d->sorted();
 
     os << "Properties[" << std::endl
        << "  plugin_name = \"" << (p.d->plugin_name) << "\"," << std::endl
        << "  id = \"" << p.d->id << "\"," << std::endl
        << "  elements = {" << std::endl;
-    while (it != p.d->entries.end()) {
-        os << "    \"" << it->first << "\" -> ";
-        it->second.data.visit(StreamVisitor(os));
-        if (++it != p.d->entries.end()) os << ",";
+    for (size_t i = 0; i < entries.size(); ++i) {
+        os << "    \"" << entries[i]->name << "\" -> ";
+        entries[i]->data.visit(StreamVisitor(os));
+        if (i + 1 < entries.size()) os << ",";
         os << std::endl;
     }
     os << "  }" << std::endl
@@ -452,102 +539,70 @@ std::ostream &operator<<(std::ostream &os, const Properties &p) {
 void Properties::set_float(const std::string &name, const Float &value, bool error_duplicates) {
     if (has_property(name) && error_duplicates)
         Log(Error, "Property \"%s\" was specified multiple times!", name);
-    d->entries[name].data = (Float) value;
-    d->entries[name].queried = false;
+    Entry &e = d->insert(name);
+    e.data = (Float) value;
+    e.queried = false;
 }
 
 /// Array3f setter
 void Properties::set_array3f(const std::string &name, const Array3f &value, bool error_duplicates) {
     if (has_property(name) && error_duplicates)
         Log(Error, "Property \"%s\" was specified multiple times!", name);
-    d->entries[name].data = (Array3f) value;
-    d->entries[name].queried = false;
+    Entry &e = d->insert(name);
+    e.data = (Array3f) value;
+    e.queried = false;
 }
 
-#if 0
-/// AnimatedTransform setter.
+/// AnimatedTransform setter
 void Properties::set_animated_transform(const std::string &name,
                                         ref<AnimatedTransform> value,
                                         bool error_duplicates) {
     if (has_property(name) && error_duplicates)
         Log(Error, "Property \"%s\" was specified multiple times!", name);
-    d->entries[name].data = ref<Object>(value.get());
-    d->entries[name].queried = false;
+    Entry &e = d->insert(name);
+    e.data = value;
+    e.queried = false;
 }
 
-/// AnimatedTransform setter (from a simple Transform).
-void Properties::set_animated_transform(const std::string &name,
-                                        const Transform4f &value,
-                                        bool error_duplicates) {
-    ref<AnimatedTransform> trafo(new AnimatedTransform(value));
-    return set_animated_transform(name, trafo, error_duplicates);
-}
-
-/// AnimatedTransform getter (without default value).
+/// AnimatedTransform getter (without default value)
 ref<AnimatedTransform> Properties::animated_transform(const std::string &name) const {
-    const auto it = d->entries.find(name);
-    if (it == d->entries.end())
+    Entry *e = d->find(name);
+    if (!e)
         Throw("Property \"%s\" has not been specified!", name);
-    if (it->second.data.is<Transform4f>()) {
+
+    if (e->data.is<Transform4f>()) {
         // Also accept simple transforms, from which we can build
         // an AnimatedTransform.
-        it->second.queried = true;
+        e->queried = true;
         return new AnimatedTransform(
-            static_cast<const Transform4f &>(it->second.data));
-    }
-    if (!it->second.data.is<ref<Object>>()) {
-        Throw("The property \"%s\" has the wrong type (expected "
-              " <animated_transform> or <transform>).", name);
+            (AnimatedTransform::Transform4f) (const Transform4f &) e->data);
     }
-    ref<Object> o = it->second.data;
-    if (!o->class_()->derives_from(MI_CLASS(AnimatedTransform)))
+
+    if (!e->data.is<ref<AnimatedTransform>>())
         Throw("The property \"%s\" has the wrong type (expected "
-              " <animated_transform> or <transform>).", name);
-    it->second.queried = true;
-    return (AnimatedTransform *) o.get();
+              "<animation> or <transform>).", name);
+
+    e->queried = true;
+    return (const ref<AnimatedTransform> &) e->data;
 }
 
-/// AnimatedTransform getter (with default value).
+/// AnimatedTransform getter (with default value)
 ref<AnimatedTransform> Properties::animated_transform(
         const std::string &name, ref<AnimatedTransform> def_val) const {
-    const auto it = d->entries.find(name);
-    if (it == d->entries.end())
+    if (!has_property(name))
         return def_val;
-    if (it->second.data.is<Transform4f>()) {
-        // Also accept simple transforms, from which we can build
-        // an AnimatedTransform.
-        it->second.queried = true;
-        return new AnimatedTransform(
-            static_cast<const Transform4f &>(it->second.data));
-    }
-    if (!it->second.data.is<ref<Object>>()) {
-        Throw("The property \"%s\" has the wrong type (expected "
-              " <animated_transform> or <transform>).", name);
-    }
-    ref<Object> o = it->second.data;
-    if (!o->class_()->derives_from(MI_CLASS(AnimatedTransform)))
-        Throw("The property \"%s\" has the wrong type (expected "
-              " <animated_transform> or <transform>).", name);
-    it->second.queried = true;
-    return (AnimatedTransform *) o.get();
-}
-
-/// Retrieve an animated transformation (default value is a constant transform)
-ref<AnimatedTransform> Properties::animated_transform(
-        const std::string &name, const Transform4f &def_val) const {
-    return animated_transform(name, new AnimatedTransform(def_val));
+    return animated_transform(name);
 }
-#endif
 
 ref<Object> Properties::find_object(const std::string &name) const {
-    const auto it = d->entries.find(name);
-    if (it == d->entries.end())
+    Entry *e = d->find(name);
+    if (!e)
         return ref<Object>();
 
-    if (!it->second.data.is<ref<Object>>())
+    if (!e->data.is<ref<Object>>())
         Throw("The property \"%s\" has the wrong type.", name);
 
-    return it->second.data;
+    return e->data;
 }
 
 #define EXPORT_PROPERTY_ACCESSOR(T) \
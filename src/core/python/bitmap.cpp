@@ -33,6 +33,7 @@ MI_PY_EXPORT(Bitmap) {
         .value("JPEG",    Bitmap::FileFormat::JPEG,    D(Bitmap, FileFormat, JPEG))
         .value("TGA",     Bitmap::FileFormat::TGA,     D(Bitmap, FileFormat, TGA))
         .value("BMP",     Bitmap::FileFormat::BMP,     D(Bitmap, FileFormat, BMP))
+        .value("DDS",     Bitmap::FileFormat::DDS,     D(Bitmap, FileFormat, DDS))
         .value("Unknown", Bitmap::FileFormat::Unknown, D(Bitmap, FileFormat, Unknown))
         .value("Auto",    Bitmap::FileFormat::Auto,    D(Bitmap, FileFormat, Auto));
 
@@ -143,11 +144,11 @@ MI_PY_EXPORT(Bitmap) {
     bitmap.attr("Float64") = type_.attr("Float64");
     bitmap.attr("Invalid") = type_.attr("Invalid");
 
-    bitmap.def(py::init<const fs::path &, Bitmap::FileFormat>(), "path"_a,
-            "format"_a = Bitmap::FileFormat::Auto,
+    bitmap.def(py::init<const fs::path &, Bitmap::FileFormat, uint32_t>(), "path"_a,
+            "format"_a = Bitmap::FileFormat::Auto, "max_resolution"_a = 0,
             py::call_guard<py::gil_scoped_release>())
-        .def(py::init<Stream *, Bitmap::FileFormat>(), "stream"_a,
-            "format"_a = Bitmap::FileFormat::Auto,
+        .def(py::init<Stream *, Bitmap::FileFormat, uint32_t>(), "stream"_a,
+            "format"_a = Bitmap::FileFormat::Auto, "max_resolution"_a = 0,
             py::call_guard<py::gil_scoped_release>())
         .def("write",
             py::overload_cast<Stream *, Bitmap::FileFormat, int>(
@@ -165,6 +166,10 @@ MI_PY_EXPORT(Bitmap) {
             "path"_a, "format"_a = Bitmap::FileFormat::Auto, "quality"_a = -1,
             D(Bitmap, write_async))
         .def("split", &Bitmap::split, D(Bitmap, split))
+        .def_static("read_batch", &Bitmap::read_batch, "paths"_a,
+            "format"_a = Bitmap::FileFormat::Auto, "max_resolution"_a = 0,
+            D(Bitmap, read_batch),
+            py::call_guard<py::gil_scoped_release>())
         .def_static("detect_file_format", &Bitmap::detect_file_format, D(Bitmap, detect_file_format))
         .def_property_readonly("__array_interface__", [](Bitmap &bitmap) -> py::object {
             if (bitmap.struct_()->size() == 0)
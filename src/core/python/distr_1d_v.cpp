@@ -28,6 +28,8 @@ MI_PY_EXPORT(DiscreteDistribution) {
         .def("eval_cdf_normalized", &DiscreteDistribution::eval_cdf_normalized,
              "index"_a, "active"_a = true, D(DiscreteDistribution, eval_cdf_normalized))
         .def_method(DiscreteDistribution, update)
+        .def_method(DiscreteDistribution, set_alias_table, "enable"_a)
+        .def_method(DiscreteDistribution, has_alias_table)
         .def_method(DiscreteDistribution, normalization)
         .def_method(DiscreteDistribution, sum)
         .def("sample",
@@ -91,13 +91,36 @@ template <typename Warp> void bind_warp_hierarchical(py::module &m, const char *
 }
 
 template <typename Warp> void bind_warp_marginal(py::module &m, const char *name) {
+    using ScalarFloat    = dr::scalar_t<typename Warp::Float>;
+    using ScalarVector2u = dr::Array<uint32_t, 2>;
+
     bind_warp<Warp>(m, name,
         D(Marginal2D),
         D(Marginal2D, Marginal2D, 2),
         D(Marginal2D, sample),
         D(Marginal2D, invert),
         D(Marginal2D, eval)
-    );
+    )
+    .def(py::init([](Stream *stream, const ScalarVector2u &size,
+                     const std::array<std::vector<ScalarFloat>, Warp::Dimension>
+                         &param_values_in,
+                     bool normalize) {
+            std::array<uint32_t, Warp::Dimension> param_res;
+            std::array<const ScalarFloat *, Warp::Dimension> param_values;
+
+            for (size_t i = 0; i < Warp::Dimension; ++i) {
+                param_values[i] = param_values_in[i].data();
+                param_res[i]    = (uint32_t) param_values_in[i].size();
+            }
+
+            return Warp(stream, size, param_res, param_values, normalize);
+        }), "stream"_a, "size"_a, "param_values"_a = py::list(),
+        "normalize"_a = true, D(Marginal2D, Marginal2D, 3))
+    .def("write", &Warp::write, "stream"_a, D(Marginal2D, write))
+    .def("set_half_precision", &Warp::set_half_precision,
+         D(Marginal2D, set_half_precision))
+    .def("is_half_precision", &Warp::is_half_precision,
+         D(Marginal2D, is_half_precision));
 }
 
 MI_PY_EXPORT(Hierarchical2D) {
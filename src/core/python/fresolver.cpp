@@ -24,6 +24,8 @@ MI_PY_EXPORT(FileResolver) {
             fr[i] = value;
         })
         .def_method(FileResolver, resolve)
+        .def_method(FileResolver, prefetch)
+        .def_method(FileResolver, clear_cache)
         .def_method(FileResolver, clear)
         .def_method(FileResolver, prepend)
         .def_method(FileResolver, append);
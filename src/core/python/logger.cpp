@@ -55,6 +55,9 @@ MI_PY_EXPORT(Logger) {
         .def_method(Logger, log_level)
         .def_method(Logger, set_error_level)
         .def_method(Logger, error_level)
+        .def_method(Logger, set_asynchronous)
+        .def_method(Logger, asynchronous)
+        .def_method(Logger, flush, py::call_guard<py::gil_scoped_release>())
         .def_method(Logger, add_appender, py::keep_alive<1, 2>())
         .def_method(Logger, remove_appender)
         .def_method(Logger, clear_appenders)
@@ -60,4 +60,8 @@ MI_PY_EXPORT(Object) {
         .def_property_readonly("ptr", [](Object *self) { return (uintptr_t) self; })
         .def("class_", &Object::class_, py::return_value_policy::reference, D(Object, class))
         .def("__repr__", &Object::to_string, D(Object, to_string));
+
+    m.def("parameters_changed_batch", &parameters_changed_batch, "updates"_a,
+          py::call_guard<py::gil_scoped_release>(),
+          D(parameters_changed_batch));
 }
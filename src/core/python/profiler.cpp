@@ -0,0 +1,9 @@
+#include <mitsuba/core/profiler.h>
+#include <mitsuba/python/python.h>
+
+MI_PY_EXPORT(Profiler) {
+    py::class_<Profiler>(m, "Profiler", D(Profiler))
+        .def_static_method(Profiler, reset)
+        .def_static_method(Profiler, report)
+        .def_static_method(Profiler, print_report);
+}
@@ -51,8 +51,8 @@ py::object properties_get(const Properties& p, const std::string &key) {
         return py::cast(p.get<Transform<Point<PFloat, 3>>>(key));
     else if (type == Properties::Type::Transform4f)
         return py::cast(p.get<Transform<Point<PFloat, 4>>>(key));
-    // else if (type == Properties::Type::AnimatedTransform)
-        // return py::cast(p.animated_transform(key));
+    else if (type == Properties::Type::AnimatedTransform)
+        return py::cast(p.animated_transform(key));
     else if (type == Properties::Type::Tensor)
         return py::cast(*(p.tensor<TensorXf>(key)));
     else if (type == Properties::Type::Object)
@@ -107,10 +107,9 @@ MI_PY_EXPORT(Properties) {
             .SET_ITEM_BINDING(array3f, typename Properties::Array3f)
             .SET_ITEM_BINDING(transform3f, typename Properties::Transform3f)
             .SET_ITEM_BINDING(transform, typename Properties::Transform4f)
-            // .SET_ITEM_BINDING(animated_transform, ref<AnimatedTransform>)
+            .SET_ITEM_BINDING(animated_transform, ref<AnimatedTransform>)
             .SET_ITEM_BINDING(object, ref<Object>)
             .GET_ITEM_DEFAULT_BINDING(string, string, std::string)
-            // .GET_ITEM_DEFAULT_BINDING(animated_transform, animated_transform, ref<AnimatedTransform>)
             .def("__setitem__",[](Properties& p, const std::string &key, const TensorXf &value) {
                 p.set_tensor_handle(key, TensorHandle(std::make_shared<TensorXf>(value)), false);
             })
@@ -147,7 +146,7 @@ MI_PY_EXPORT(Properties) {
             .value("Array3f",           Properties::Type::Array3f)
             .value("Transform3f",       Properties::Type::Transform3f)
             .value("Transform4f",       Properties::Type::Transform4f)
-            // .value("AnimatedTransform", Properties::Type::AnimatedTransform)
+            .value("AnimatedTransform", Properties::Type::AnimatedTransform)
             .value("TensorHandle",      Properties::Type::Tensor)
             .value("Color",             Properties::Type::Color)
             .value("String",            Properties::Type::String)
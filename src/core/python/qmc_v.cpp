@@ -29,4 +29,7 @@ MI_PY_EXPORT(qmc) {
 
     m.def("sobol_2", sobol_2<UInt32>,
           "index"_a, "scramble"_a, D(sobol_2));
+
+    m.def("owen_scramble_2", owen_scramble_2<UInt32>,
+          "x"_a, "seed"_a, D(owen_scramble_2));
 }
@@ -37,6 +37,9 @@ MI_PY_EXPORT(sample_tea) {
     m.attr("sample_tea_float") = m.attr(
         sizeof(Float) != sizeof(Float64) ? "sample_tea_float32" : "sample_tea_float64");
 
+    m.def("philox_4x32", philox_4x32<UInt32>,
+          "counter"_a, "key"_a, "rounds"_a = 10, D(philox_4x32));
+
     m.def("permute",
           permute<UInt32>,
           "value"_a, "size"_a, "seed"_a, "rounds"_a = 4, D(permute));
@@ -17,7 +17,13 @@ void bind_rfilter(py::module &m, const char *name) {
                  D(ReconstructionFilter, eval), "x"_a, "active"_a = true)
             .def("eval_discretized", &ReconstructionFilter::eval_discretized,
                  D(ReconstructionFilter, eval_discretized), "x"_a,
-                 "active"_a = true);
+                 "active"_a = true)
+            .def("has_weight_table", &ReconstructionFilter::has_weight_table,
+                 D(ReconstructionFilter, has_weight_table))
+            .def("weight_taps", &ReconstructionFilter::weight_taps,
+                 D(ReconstructionFilter, weight_taps))
+            .def("weight_table", &ReconstructionFilter::weight_table,
+                 D(ReconstructionFilter, weight_table));
     }
 }
 
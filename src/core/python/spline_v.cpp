@@ -7,6 +7,31 @@ template<typename Float_>
 void bind_spline(py::module &m) {
     MI_PY_IMPORT_TYPES()
     if constexpr (!dr::is_cuda_v<Float_>) {
+        using IntervalIndex = spline::IntervalIndex<ScalarFloat>;
+
+        MI_PY_CHECK_ALIAS(IntervalIndex, "IntervalIndex") {
+            py::class_<IntervalIndex>(m, "IntervalIndex", D(spline, IntervalIndex))
+                .def(py::init([](const py::array_t<ScalarFloat> &data,
+                                 uint32_t cells) {
+                         if (data.ndim() != 1)
+                             throw std::runtime_error(
+                                 "'data' must be a one-dimensional array!");
+                         return IntervalIndex(data.data(),
+                                              (uint32_t) data.shape(0), cells);
+                     }),
+                     "data"_a, "cells"_a = 0, D(spline, IntervalIndex, IntervalIndex, 2))
+                .def("size", &IntervalIndex::size, D(spline, IntervalIndex, size))
+                .def("cells", &IntervalIndex::cells, D(spline, IntervalIndex, cells))
+                .def("iterations", &IntervalIndex::iterations,
+                     D(spline, IntervalIndex, iterations));
+        }
+
+        auto check_index = [](const IntervalIndex *index, size_t size) {
+            if (index && index->size() != size)
+                throw std::runtime_error(
+                    "'index' was built for an array of a different size!");
+        };
+
         m.def("eval_spline", spline::eval_spline<ScalarFloat>, "f0"_a, "f1"_a,
               "d0"_a, "d1"_a, "t"_a, D(spline, eval_spline))
             .def("eval_spline_d", spline::eval_spline_d<ScalarFloat>, "f0"_a,
@@ -24,8 +49,9 @@ void bind_spline(py::module &m) {
                  },
                  "min"_a, "max"_a, "values"_a, "x"_a, D(spline, eval_1d))
             .def("eval_1d",
-                 [](const py::array_t<ScalarFloat> &nodes,
-                    const py::array_t<ScalarFloat> &values, Float x) {
+                 [check_index](const py::array_t<ScalarFloat> &nodes,
+                    const py::array_t<ScalarFloat> &values, Float x,
+                    const IntervalIndex *index) {
                      if (nodes.ndim() != 1 || values.ndim() != 1)
                          throw std::runtime_error(
                              "'nodes' and 'values' must be a one-dimensional "
@@ -33,10 +59,13 @@ void bind_spline(py::module &m) {
                      if (nodes.shape(0) != values.shape(0))
                          throw std::runtime_error(
                              "'nodes' and 'values' must have a matching size!");
+                     check_index(index, nodes.shape(0));
                      return spline::eval_1d(nodes.data(), values.data(),
-                                            (uint32_t) values.shape(0), x);
+                                            (uint32_t) values.shape(0), x,
+                                            index);
                  },
-                 "nodes"_a, "values"_a, "x"_a, D(spline, eval_1d, 2))
+                 "nodes"_a, "values"_a, "x"_a, "index"_a = py::none(),
+                 D(spline, eval_1d, 2))
             .def("integrate_1d",
                  [](ScalarFloat min, ScalarFloat max,
                     const py::array_t<ScalarFloat> &values) {
@@ -70,22 +99,23 @@ void bind_spline(py::module &m) {
                  },
                  "nodes"_a, "values"_a, D(spline, integrate_1d, 2))
             .def("invert_1d",
-                 [](ScalarFloat min, ScalarFloat max,
+                 [check_index](ScalarFloat min, ScalarFloat max,
                     const py::array_t<ScalarFloat> &values, Float y,
-                    ScalarFloat eps) {
+                    ScalarFloat eps, const IntervalIndex *index) {
                      if (values.ndim() != 1)
                          throw std::runtime_error(
                              "'values' must be a one-dimensional array!");
+                     check_index(index, values.shape(0));
                      return spline::invert_1d(min, max, values.data(),
                                               (uint32_t) values.shape(0), y,
-                                              eps);
+                                              eps, index);
                  },
                  "min"_a, "max_"_a, "values"_a, "y"_a, "eps"_a = 1e-6f,
-                 D(spline, invert_1d))
+                 "index"_a = py::none(), D(spline, invert_1d))
             .def("invert_1d",
-                 [](const py::array_t<ScalarFloat> &nodes,
+                 [check_index](const py::array_t<ScalarFloat> &nodes,
                     const py::array_t<ScalarFloat> &values, Float y,
-                    ScalarFloat eps) {
+                    ScalarFloat eps, const IntervalIndex *index) {
                      if (nodes.ndim() != 1 || values.ndim() != 1)
                          throw std::runtime_error(
                              "'nodes' and 'values' must be a one-dimensional "
@@ -93,17 +123,18 @@ void bind_spline(py::module &m) {
                      if (nodes.shape(0) != values.shape(0))
                          throw std::runtime_error(
                              "'nodes' and 'values' must have a matching size!");
+                     check_index(index, values.shape(0));
                      return spline::invert_1d(nodes.data(), values.data(),
                                               (uint32_t) values.shape(0), y,
-                                              eps);
+                                              eps, index);
                  },
                  "nodes"_a, "values"_a, "y"_a, "eps"_a = 1e-6f,
-                 D(spline, invert_1d, 2))
+                 "index"_a = py::none(), D(spline, invert_1d, 2))
             .def("sample_1d",
-                 [](ScalarFloat min, ScalarFloat max,
+                 [check_index](ScalarFloat min, ScalarFloat max,
                     const py::array_t<ScalarFloat> &values,
                     const py::array_t<ScalarFloat> &cdf, Float sample,
-                    ScalarFloat eps) {
+                    ScalarFloat eps, const IntervalIndex *index) {
                      if (values.ndim() != 1)
                          throw std::runtime_error(
                              "'values' must be a one-dimensional array!");
@@ -113,17 +144,18 @@ void bind_spline(py::module &m) {
                      if (values.size() != cdf.size())
                          throw std::runtime_error(
                              "'values' and 'cdf' must have a matching size!");
+                     check_index(index, cdf.shape(0));
                      return spline::sample_1d(
                          min, max, values.data(), cdf.data(),
-                         (uint32_t) values.shape(0), sample, eps);
+                         (uint32_t) values.shape(0), sample, eps, index);
                  },
                  "min"_a, "max"_a, "values"_a, "cdf"_a, "sample"_a,
-                 "eps"_a = 1e-6f, D(spline, sample_1d))
+                 "eps"_a = 1e-6f, "index"_a = py::none(), D(spline, sample_1d))
             .def("sample_1d",
-                 [](const py::array_t<ScalarFloat> &nodes,
+                 [check_index](const py::array_t<ScalarFloat> &nodes,
                     const py::array_t<ScalarFloat> &values,
                     const py::array_t<ScalarFloat> &cdf, Float sample,
-                    ScalarFloat eps) {
+                    ScalarFloat eps, const IntervalIndex *index) {
                      if (values.ndim() != 1)
                          throw std::runtime_error(
                              "'values' must be a one-dimensional array!");
@@ -133,12 +165,13 @@ void bind_spline(py::module &m) {
                      if (values.size() != cdf.size())
                          throw std::runtime_error(
                              "'values' and 'cdf' must have a matching size!");
+                     check_index(index, cdf.shape(0));
                      return spline::sample_1d(
                          nodes.data(), values.data(), cdf.data(),
-                         (uint32_t) values.shape(0), sample, eps);
+                         (uint32_t) values.shape(0), sample, eps, index);
                  },
                  "nodes"_a, "values"_a, "cdf"_a, "sample"_a, "eps"_a = 1e-6f,
-                 D(spline, sample_1d, 2))
+                 "index"_a = py::none(), D(spline, sample_1d, 2))
             .def("eval_spline_weights",
                  [](ScalarFloat min, ScalarFloat max, uint32_t size, Float x) {
                      std::vector<Float> weight(4);
@@ -149,24 +182,31 @@ void bind_spline(py::module &m) {
                  "min"_a, "max"_a, "size"_a, "x"_a,
                  D(spline, eval_spline_weights))
             .def("eval_spline_weights",
-                 [](const py::array_t<ScalarFloat> &nodes, Float x) {
+                 [check_index](const py::array_t<ScalarFloat> &nodes, Float x,
+                               const IntervalIndex *index) {
+                     check_index(index, nodes.shape(0));
                      std::vector<Float> weight(4);
                      auto [result, offset] = spline::eval_spline_weights(
                          nodes.data(), (uint32_t) nodes.shape(0), x,
-                         weight.data());
+                         weight.data(), index);
                      return std::make_tuple(result, offset, weight);
                  },
-                 "nodes"_a, "x"_a, D(spline, eval_spline_weights, 2))
+                 "nodes"_a, "x"_a, "index"_a = py::none(),
+                 D(spline, eval_spline_weights, 2))
             .def("eval_2d",
-                 [](const py::array_t<ScalarFloat> &nodes1,
+                 [check_index](const py::array_t<ScalarFloat> &nodes1,
                     const py::array_t<ScalarFloat> &nodes2,
-                    const py::array_t<ScalarFloat> &values, Float x, Float y) {
+                    const py::array_t<ScalarFloat> &values, Float x, Float y,
+                    const IntervalIndex *index1, const IntervalIndex *index2) {
+                     check_index(index1, nodes1.shape(0));
+                     check_index(index2, nodes2.shape(0));
                      return spline::eval_2d(
                          nodes1.data(), (uint32_t) nodes1.shape(0),
                          nodes2.data(), (uint32_t) nodes2.shape(0),
-                         values.data(), x, y);
+                         values.data(), x, y, index1, index2);
                  },
                  "nodes1"_a, "nodes2"_a, "values"_a, "x"_a, "y"_a,
+                 "index1"_a = py::none(), "index2"_a = py::none(),
                  D(spline, eval_2d));
     }
 }
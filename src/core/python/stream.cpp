@@ -1,7 +1,9 @@
 #include <mitsuba/core/stream.h>
+#include <mitsuba/core/bfstream.h>
 #include <mitsuba/core/dstream.h>
 #include <mitsuba/core/fstream.h>
 #include <mitsuba/core/mstream.h>
+#include <mitsuba/core/sstream.h>
 #include <mitsuba/core/zstream.h>
 
 #include <mitsuba/core/filesystem.h>
@@ -89,6 +91,14 @@ MI_PY_EXPORT(FileStream) {
         "p"_a, "mode"_a = FileStream::ERead, D(FileStream, FileStream));
 }
 
+MI_PY_EXPORT(BufferedFileStream) {
+    MI_PY_CLASS(BufferedFileStream, Stream)
+        .def(py::init<const mitsuba::filesystem::path &, size_t>(),
+            "p"_a, "buffer_size"_a = 4 * 1024 * 1024, D(BufferedFileStream, BufferedFileStream))
+        .def_method(BufferedFileStream, path)
+        .def_method(BufferedFileStream, buffer_size);
+}
+
 MI_PY_EXPORT(MemoryStream) {
     MI_PY_CLASS(MemoryStream, Stream)
         .def(py::init<size_t>(), D(MemoryStream, MemoryStream),
@@ -106,14 +116,42 @@ MI_PY_EXPORT(ZStream) {
     py::enum_<ZStream::EStreamType>(c, "EStreamType", D(ZStream, EStreamType))
         .value("EDeflateStream", ZStream::EDeflateStream, D(ZStream, EStreamType, EDeflateStream))
         .value("EGZipStream", ZStream::EGZipStream, D(ZStream, EStreamType, EGZipStream))
+        .value("EZstdStream", ZStream::EZstdStream, D(ZStream, EStreamType, EZstdStream))
+        .value("ELZ4Stream", ZStream::ELZ4Stream, D(ZStream, EStreamType, ELZ4Stream))
         .export_values();
 
 
-    c.def(py::init<Stream*, ZStream::EStreamType, int>(), D(ZStream, ZStream),
+    c.def(py::init<Stream*, ZStream::EStreamType, int, int>(), D(ZStream, ZStream),
         "child_stream"_a,
         "stream_type"_a = ZStream::EDeflateStream,
-        "level"_a = -1)
+        "level"_a = -1,
+        "threads"_a = 0)
         .def("child_stream", [](ZStream &stream) {
             return py::cast(stream.child_stream());
-        }, D(ZStream, child_stream));
+        }, D(ZStream, child_stream))
+        .def("stream_type", &ZStream::stream_type, D(ZStream, stream_type))
+        .def_static("has_backend", &ZStream::has_backend, "stream_type"_a,
+                    D(ZStream, has_backend))
+        .def_static("detect_type", &ZStream::detect_type, "stream"_a,
+                    D(ZStream, detect_type));
+}
+
+MI_PY_EXPORT(SocketStream) {
+    MI_PY_CLASS(SocketStream, Stream)
+        .def(py::init<const std::string &, uint16_t>(),
+             D(SocketStream, SocketStream), "host"_a, "port"_a,
+             py::call_guard<py::gil_scoped_release>())
+        .def_method(SocketStream, peer)
+        .def_method(SocketStream, received)
+        .def_method(SocketStream, sent);
+}
+
+MI_PY_EXPORT(ServerSocket) {
+    MI_PY_CLASS(ServerSocket, Object)
+        .def(py::init<uint16_t>(), D(ServerSocket, ServerSocket),
+             "port"_a = 0)
+        .def_method(ServerSocket, port)
+        .def("accept", &ServerSocket::accept, D(ServerSocket, accept),
+             py::call_guard<py::gil_scoped_release>())
+        .def_method(ServerSocket, close);
 }
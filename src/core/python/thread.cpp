@@ -98,7 +98,9 @@ MI_PY_EXPORT(Thread) {
        .def_method(Thread, detach)
        .def_method(Thread, join)
        .def_static_method(Thread, sleep)
-       .def_static_method(Thread, wait_for_tasks);
+       .def_static_method(Thread, wait_for_tasks)
+       .def_static_method(Thread, pin_worker_threads)
+       .def_static_method(Thread, numa_node);
 
     py::class_<ThreadEnvironment>(m, "ThreadEnvironment", D(ThreadEnvironment))
         .def(py::init<>());
@@ -0,0 +1,37 @@
+#include <mitsuba/core/tilecache.h>
+#include <mitsuba/python/python.h>
+
+MI_PY_EXPORT(TileCache) {
+    MI_PY_CLASS(TiledImage, Object)
+        .def(py::init<const fs::path &, uint32_t, bool>(), "filename"_a,
+             "tile_size"_a = 64, "raw"_a = false)
+        .def_method(TiledImage, size)
+        .def_method(TiledImage, channel_count)
+        .def_method(TiledImage, tile_size)
+        .def_method(TiledImage, tile_count)
+        .def_method(TiledImage, uid)
+        .def_method(TiledImage, filename);
+
+    auto cache = MI_PY_CLASS(TileCache, Object)
+        .def_static("instance", &TileCache::instance,
+                    py::return_value_policy::reference, D(TileCache, instance))
+        .def_method(TileCache, set_budget, "bytes"_a)
+        .def_method(TileCache, budget)
+        .def_method(TileCache, statistics)
+        .def_method(TileCache, reset_statistics)
+        .def_method(TileCache, clear);
+
+    py::class_<TileCache::Statistics>(cache, "Statistics", D(TileCache, Statistics))
+        .def_readonly("hits", &TileCache::Statistics::hits,
+                      D(TileCache, Statistics, hits))
+        .def_readonly("misses", &TileCache::Statistics::misses,
+                      D(TileCache, Statistics, misses))
+        .def_readonly("evictions", &TileCache::Statistics::evictions,
+                      D(TileCache, Statistics, evictions))
+        .def_readonly("resident_tiles", &TileCache::Statistics::resident_tiles,
+                      D(TileCache, Statistics, resident_tiles))
+        .def_readonly("resident_bytes", &TileCache::Statistics::resident_bytes,
+                      D(TileCache, Statistics, resident_bytes))
+        .def_readonly("budget", &TileCache::Statistics::budget,
+                      D(TileCache, Statistics, budget));
+}
@@ -289,7 +289,6 @@ MI_PY_EXPORT(Transform) {
     py::implicitly_convertible<Matrix4f, Transform4f>();
 }
 
-#if 0
 MI_PY_EXPORT(AnimatedTransform) {
     MI_PY_IMPORT_TYPES()
     using Keyframe      = typename AnimatedTransform::Keyframe;
@@ -324,8 +323,9 @@ MI_PY_EXPORT(AnimatedTransform) {
                 D(AnimatedTransform, append))
             .def("append", py::overload_cast<const Keyframe &>( &AnimatedTransform::append))
             .def("eval", &AnimatedTransform::template eval<Float>,
-                 "time"_a, "unused"_a = true, D(AnimatedTransform, eval))
+                 "time"_a, "active"_a = true, D(AnimatedTransform, eval))
+            .def_method(AnimatedTransform, interpolate, "time"_a)
+            .def_method(AnimatedTransform, resample, "max_keys"_a = 64)
             .def_method(AnimatedTransform, translation_bounds);
     }
 }
-#endif
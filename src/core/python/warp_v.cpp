@@ -130,6 +130,14 @@ MI_PY_EXPORT(warp) {
           warp::square_to_uniform_cone_pdf<false, Float>,
           "v"_a, "cos_cutoff"_a, D(warp, square_to_uniform_cone_pdf));
 
+    m.def("spherical_triangle_solid_angle",
+          warp::spherical_triangle_solid_angle<Float>,
+          "a"_a, "b"_a, "c"_a, D(warp, spherical_triangle_solid_angle));
+
+    m.def("square_to_spherical_triangle",
+          warp::square_to_spherical_triangle<Float>,
+          "sample"_a, "a"_a, "b"_a, "c"_a, D(warp, square_to_spherical_triangle));
+
     m.def("square_to_beckmann",
           warp::square_to_beckmann<Float>,
           "sample"_a, "alpha"_a, D(warp, square_to_beckmann));
@@ -0,0 +1,49 @@
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/xml.h>
+#include <mitsuba/python/python.h>
+
+extern py::object cast_object(Object *o);
+
+/// Convert keyword arguments into parameters of the XML parser
+static xml::ParameterList parameter_list(const py::kwargs &kwargs) {
+    xml::ParameterList param;
+    for (auto [k, v] : kwargs)
+        param.emplace_back((std::string) py::str(k), (std::string) py::str(v),
+                           false);
+    return param;
+}
+
+MI_PY_EXPORT(SceneUpdater) {
+    py::class_<xml::SceneUpdater, Object, ref<xml::SceneUpdater>>(
+        m, "SceneUpdater", D(xml, SceneUpdater))
+        .def(py::init([](const fs::path &path, py::object variant,
+                         py::kwargs kwargs) {
+                 if (variant.is_none())
+                     variant = py::module_::import("mitsuba").attr("variant")();
+                 xml::ParameterList param = parameter_list(kwargs);
+                 std::string variant_str = py::cast<std::string>(variant);
+                 py::gil_scoped_release release;
+                 return new xml::SceneUpdater(path, variant_str, param);
+             }),
+             "path"_a, "variant"_a = py::none(), D(xml, SceneUpdater, SceneUpdater))
+        .def("scene",
+             [](const xml::SceneUpdater &u) { return cast_object(u.scene()); },
+             D(xml, SceneUpdater, scene))
+        .def("update_file",
+             [](xml::SceneUpdater &u, const fs::path &path, py::kwargs kwargs) {
+                 xml::ParameterList param = parameter_list(kwargs);
+                 py::gil_scoped_release release;
+                 return u.update_file(path, param);
+             },
+             "path"_a, D(xml, SceneUpdater, update_file))
+        .def("update_string",
+             [](xml::SceneUpdater &u, const std::string &string, py::kwargs kwargs) {
+                 xml::ParameterList param = parameter_list(kwargs);
+                 py::gil_scoped_release release;
+                 return u.update_string(string, param);
+             },
+             "string"_a, D(xml, SceneUpdater, update_string))
+        .def("update", &xml::SceneUpdater::update, "id"_a, "props"_a,
+             D(xml, SceneUpdater, update),
+             py::call_guard<py::gil_scoped_release>());
+}
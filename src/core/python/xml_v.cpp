@@ -62,7 +62,8 @@ MI_PY_EXPORT(xml) {
 
     m.def(
         "load_file",
-        [](const std::string &name, bool update_scene, bool parallel, py::kwargs kwargs) {
+        [](const std::string &name, bool update_scene, bool parallel,
+           bool deduplicate, bool streaming, py::kwargs kwargs) {
             xml::ParameterList param;
             if (kwargs) {
                 for (auto [k, v] : kwargs)
@@ -76,17 +77,20 @@ MI_PY_EXPORT(xml) {
             std::vector<ref<Object>> objects;
             {
                 py::gil_scoped_release release;
-                objects = xml::load_file(name, GET_VARIANT(), param, update_scene, parallel);
+                objects = xml::load_file(name, GET_VARIANT(), param,
+                                         update_scene, parallel, deduplicate,
+                                         streaming);
             }
 
             return single_object_or_list(objects);
         },
         "path"_a, "update_scene"_a = false, "parallel"_a = true,
-        D(xml, load_file));
+        "deduplicate"_a = false, "streaming"_a = false, D(xml, load_file));
 
     m.def(
         "load_string",
-        [](const std::string &name, bool parallel, py::kwargs kwargs) {
+        [](const std::string &name, bool parallel, bool deduplicate,
+           py::kwargs kwargs) {
             xml::ParameterList param;
             if (kwargs) {
                 for (auto [k, v] : kwargs)
@@ -100,14 +104,33 @@ MI_PY_EXPORT(xml) {
             std::vector<ref<Object>> objects;
             {
                 py::gil_scoped_release release;
-                objects = xml::load_string(name, GET_VARIANT(), param, parallel);
+                objects = xml::load_string(name, GET_VARIANT(), param,
+                                           parallel, deduplicate);
             }
 
             return single_object_or_list(objects);
         },
-        "string"_a, "parallel"_a = true,
+        "string"_a, "parallel"_a = true, "deduplicate"_a = false,
         D(xml, load_string));
 
+    m.def(
+        "compile_file",
+        [](const std::string &name, const std::string &output, py::kwargs kwargs) {
+            xml::ParameterList param;
+            if (kwargs) {
+                for (auto [k, v] : kwargs)
+                    param.emplace_back(
+                        (std::string) py::str(k),
+                        (std::string) py::str(v),
+                        false
+                    );
+            }
+
+            py::gil_scoped_release release;
+            xml::compile_file(name, output, GET_VARIANT(), param);
+        },
+        "path"_a, "output"_a, D(xml, compile_file));
+
     m.def(
         "load_dict",
         [](const py::dict dict, bool parallel) {
@@ -297,6 +320,7 @@ void parse_dictionary(DictParseContext &ctx,
         SET_PROPS(ScalarArray3f, ScalarArray3f, set_array3f);
         SET_PROPS(ScalarTransform3f, ScalarTransform3f, set_transform3f);
         SET_PROPS(ScalarTransform4f, ScalarTransform4f, set_transform);
+        SET_PROPS(AnimatedTransform, ref<AnimatedTransform>, set_animated_transform);
 
         if (key.find('.') != std::string::npos) {
             Throw("The object key '%s' contains a '.' character, which is "
@@ -314,6 +338,27 @@ void parse_dictionary(DictParseContext &ctx,
                 continue;
             }
 
+            // Nested dict with type == "tensor" references the field of a
+            // tensor or NumPy file, which is mapped into memory
+            if (type2 == "tensor") {
+                std::string filename, field;
+                for (auto& kv2 : dict2) {
+                    std::string key2 = kv2.first.template cast<std::string>();
+                    if (key2 == "filename")
+                        filename = kv2.second.template cast<std::string>();
+                    else if (key2 == "field")
+                        field = kv2.second.template cast<std::string>();
+                    else if (key2 != "type")
+                        Throw("Unexpected key in tensor dictionary: %s", key2);
+                }
+                if (filename.empty())
+                    Throw("Tensor dictionary requires a \"filename\" entry: %s", key);
+                props.set_tensor_handle(
+                    key, mitsuba::xml::detail::load_tensor(filename, field,
+                                                           GET_VARIANT()));
+                continue;
+            }
+
             if (type2 == "resources") {
                 ref<FileResolver> fs = Thread::thread()->file_resolver();
                 std::string path = dict2["path"].template cast<std::string>();
@@ -107,6 +107,50 @@ RadicalInverse::RadicalInverse(size_t max_base, int scramble) : m_scramble(scram
             m_permutations[i] = ptr;  ptr += prime;
         }
     }
+    /* Tables to process several digits per lookup in eval_scrambled(). Large
+       bases directly use their permutation (i.e. a single digit per lookup) */
+    const uint32_t max_table_size = 4096;
+    m_digit_tables = std::unique_ptr<DigitTable[]>(new DigitTable[m_base_count]);
+
+    size_t table_storage_size = 3; /* Padding for 64bit gather operations */
+    for (size_t i = 0; i < m_base_count; ++i) {
+        uint32_t prime = m_base[i].value, size = prime;
+        while (size * prime <= max_table_size)
+            size *= prime;
+        if (size != prime)
+            table_storage_size += size;
+        m_digit_tables[i].size = size;
+        m_digit_tables[i].recip = (float) (1.0 / (double) size);
+        m_digit_tables[i].divisor = dr::divisor<uint64_t>((uint64_t) size);
+    }
+
+    m_digit_table_storage =
+        std::unique_ptr<uint16_t[]>(new uint16_t[table_storage_size]);
+    uint16_t *table_ptr = m_digit_table_storage.get();
+
+    for (size_t i = 0; i < m_base_count; ++i) {
+        DigitTable &table = m_digit_tables[i];
+        uint32_t prime = m_base[i].value;
+        const uint16_t *perm = m_permutations[i];
+
+        if (table.size == prime) {
+            table.values = perm;
+            continue;
+        }
+
+        for (uint32_t j = 0; j < table.size; ++j) {
+            uint32_t digits = j, value = 0;
+            for (uint32_t k = 1; k < table.size; k *= prime) {
+                value = value * prime + perm[digits % prime];
+                digits /= prime;
+            }
+            table_ptr[j] = (uint16_t) value;
+        }
+
+        table.values = table_ptr;
+        table_ptr += table.size;
+    }
+
     Log(Debug, "Done (took %s)", util::time_string((float) timer.value()));
 
     /* Invert the first two permutations */
@@ -1,9 +1,15 @@
 #include <mitsuba/core/rfilter.h>
 #include <mitsuba/core/config.h>
+#include <mitsuba/core/properties.h>
 
 NAMESPACE_BEGIN(mitsuba)
 
-MI_VARIANT ReconstructionFilter<Float, Spectrum>::ReconstructionFilter(const Properties &/*props*/) { }
+MI_VARIANT ReconstructionFilter<Float, Spectrum>::ReconstructionFilter(const Properties &props)
+    : m_weight_taps(0) {
+    /* Precompute a separable table of splatting weights indexed by
+       the quantized subpixel offset of a sample (see weight_table()) */
+    m_tabulate = props.get<bool>("tabulate", false);
+}
 MI_VARIANT ReconstructionFilter<Float, Spectrum>::~ReconstructionFilter() { }
 
 MI_VARIANT void ReconstructionFilter<Float, Spectrum>::init_discretization() {
@@ -21,6 +27,38 @@ MI_VARIANT void ReconstructionFilter<Float, Spectrum>::init_discretization() {
 
     m_scale_factor = MI_FILTER_RESOLUTION / m_radius;
     m_border_size = (int) dr::ceil(m_radius - .5f - 2.f * math::RayEpsilon<ScalarFloat>);
+
+    // The box filter takes a dedicated fast path in ImageBlock::put()
+    if (!m_tabulate || is_box_filter())
+        return;
+
+    int n = dr::ceil2int<int>(m_radius - .5f);
+    m_weight_taps = 2 * n + 1;
+
+    size_t size = (size_t) m_weight_taps * MI_FILTER_SUBPIXEL_RESOLUTION;
+
+    if constexpr (dr::is_jit_v<Float>) {
+        UInt32 index = dr::arange<UInt32>(size),
+               row   = index / m_weight_taps,
+               tap   = index - row * m_weight_taps;
+
+        Float f = (Float(row) + .5f) * (1.f / MI_FILTER_SUBPIXEL_RESOLUTION),
+              x = Float(tap) - (ScalarFloat) n + .5f - f;
+
+        m_weight_table = eval(x);
+        dr::make_opaque(m_weight_table);
+    } else {
+        std::unique_ptr<ScalarFloat[]> weights(new ScalarFloat[size]);
+
+        for (uint32_t j = 0; j < MI_FILTER_SUBPIXEL_RESOLUTION; ++j) {
+            ScalarFloat f = (j + .5f) / MI_FILTER_SUBPIXEL_RESOLUTION;
+            for (uint32_t i = 0; i < m_weight_taps; ++i)
+                weights[j * m_weight_taps + i] =
+                    eval((ScalarFloat) ((int) i - n) + .5f - f);
+        }
+
+        m_weight_table = dr::load<DynamicBuffer<Float>>(weights.get(), size);
+    }
 }
 
 MI_VARIANT bool ReconstructionFilter<Float, Spectrum>::is_box_filter() const {
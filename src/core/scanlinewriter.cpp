@@ -0,0 +1,152 @@
+#include <mitsuba/core/scanlinewriter.h>
+#include <mitsuba/core/bitmap.h>
+#include <mitsuba/core/logger.h>
+#include <mitsuba/core/profiler.h>
+#include <mitsuba/core/string.h>
+#include <mitsuba/mitsuba.h>
+#include <mutex>
+
+#if defined(_MSC_VER)
+#  pragma warning(push)
+#  pragma warning(disable : 4267) // conversion from 'size_t' to 'int', possible loss of data
+#endif
+
+#include <ImfOutputFile.h>
+#include <ImfChannelList.h>
+#include <ImfFrameBuffer.h>
+#include <ImfHeader.h>
+#include <ImfStringAttribute.h>
+
+#if defined(_MSC_VER)
+#  pragma warning(pop)
+#endif
+
+NAMESPACE_BEGIN(mitsuba)
+
+struct ScanlineWriter::ScanlineWriterPrivate {
+    fs::path filename;
+    ScalarVector2u size;
+    ref<Struct> format;
+    uint32_t rows_written = 0;
+
+    /// OpenEXR files are not thread-safe, serialize accesses
+    std::mutex mutex;
+    std::unique_ptr<Imf::OutputFile> file;
+};
+
+ScanlineWriter::ScanlineWriter(const fs::path &filename,
+                               const ScalarVector2u &size,
+                               const Struct *format)
+    : d(new ScanlineWriterPrivate()) {
+    if (dr::any(size == 0u))
+        Throw("ScanlineWriter: the image resolution must be nonzero!");
+
+    d->filename = filename;
+    d->size = size;
+    d->format = new Struct(*format);
+
+    Imf::Header header(
+        (int) size.x(),    // width
+        (int) size.y(),    // height,
+        1.f,               // pixelAspectRatio
+        Imath::V2f(0, 0),  // screenWindowCenter,
+        1.f,               // screenWindowWidth
+        Imf::INCREASING_Y, // lineOrder
+        Imf::PIZ_COMPRESSION // compression
+    );
+
+    header.insert("generatedBy",
+                  Imf::StringAttribute("Mitsuba version " MI_VERSION));
+
+    Imf::ChannelList &channels = header.channels();
+    for (const Struct::Field &field : *d->format) {
+        Imf::PixelType comp_type;
+        switch (field.type) {
+            case Struct::Type::Float32: comp_type = Imf::FLOAT; break;
+            case Struct::Type::Float16: comp_type = Imf::HALF; break;
+            case Struct::Type::UInt32: comp_type = Imf::UINT; break;
+            default: Throw("ScanlineWriter: unsupported field type %s!", field.type);
+        }
+        channels.insert(field.name, Imf::Channel(comp_type));
+    }
+
+    d->file.reset(new Imf::OutputFile(filename.string().c_str(), header));
+}
+
+ScanlineWriter::~ScanlineWriter() {
+    close();
+}
+
+void ScanlineWriter::close() {
+    std::lock_guard<std::mutex> guard(d->mutex);
+    if (!d->file)
+        return;
+
+    if (d->rows_written != d->size.y())
+        Log(Warn, "ScanlineWriter: closing \"%s\" after writing only %u of "
+                  "%u rows!", d->filename.string(), d->rows_written,
+                  d->size.y());
+    d->file.reset();
+}
+
+void ScanlineWriter::write_rows(const Bitmap *band) {
+    ScopedPhase phase(ProfilerPhase::BitmapWrite);
+    std::lock_guard<std::mutex> guard(d->mutex);
+
+    if (!d->file)
+        Throw("ScanlineWriter::write_rows(): the file was already closed!");
+    if (band->width() != d->size.x())
+        Throw("ScanlineWriter::write_rows(): expected a band of width %u, "
+              "got %u!", d->size.x(), band->width());
+    if (d->rows_written + band->height() > d->size.y())
+        Throw("ScanlineWriter::write_rows(): the band exceeds the image "
+              "height (%u + %u > %u)!", d->rows_written, band->height(),
+              d->size.y());
+    if (!(*band->struct_() == *d->format))
+        Throw("ScanlineWriter::write_rows(): incompatible band format %s!",
+              band->struct_());
+
+    if (band->height() == 0)
+        return;
+
+    size_t pixel_stride = d->format->size(),
+           row_stride   = pixel_stride * d->size.x();
+
+    /* OpenEXR addresses slices with absolute pixel coordinates, offset the
+       base pointer so that row 'rows_written' maps to the start of the band */
+    const char *base = (const char *) band->uint8_data() -
+                       (ptrdiff_t) row_stride * d->rows_written;
+
+    Imf::FrameBuffer framebuffer;
+    for (const Struct::Field &field : *d->format) {
+        Imf::PixelType comp_type =
+            field.type == Struct::Type::Float32
+                ? Imf::FLOAT
+                : (field.type == Struct::Type::Float16 ? Imf::HALF : Imf::UINT);
+        framebuffer.insert(field.name,
+                           Imf::Slice(comp_type, (char *) base + field.offset,
+                                      pixel_stride, row_stride));
+    }
+
+    d->file->setFrameBuffer(framebuffer);
+    d->file->writePixels((int) band->height());
+    d->rows_written += band->height();
+}
+
+uint32_t ScanlineWriter::rows_written() const { return d->rows_written; }
+const ScalarVector2u &ScanlineWriter::size() const { return d->size; }
+const fs::path &ScanlineWriter::filename() const { return d->filename; }
+
+std::string ScanlineWriter::to_string() const {
+    std::ostringstream oss;
+    oss << "ScanlineWriter[" << std::endl
+        << "  filename = \"" << d->filename.string() << "\"," << std::endl
+        << "  size = " << d->size << "," << std::endl
+        << "  rows_written = " << d->rows_written << "," << std::endl
+        << "  format = " << string::indent(d->format) << std::endl
+        << "]";
+    return oss.str();
+}
+
+MI_IMPLEMENT_CLASS(ScanlineWriter, Object)
+NAMESPACE_END(mitsuba)
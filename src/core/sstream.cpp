@@ -0,0 +1,273 @@
+#include <mitsuba/core/sstream.h>
+#include <mitsuba/core/logger.h>
+#include <cstring>
+
+#if defined(_WIN32)
+#  include <winsock2.h>
+#  include <ws2tcpip.h>
+#  pragma comment(lib, "ws2_32.lib")
+#else
+#  include <sys/types.h>
+#  include <sys/socket.h>
+#  include <netdb.h>
+#  include <netinet/in.h>
+#  include <netinet/tcp.h>
+#  include <arpa/inet.h>
+#  include <unistd.h>
+#  include <errno.h>
+#endif
+
+NAMESPACE_BEGIN(mitsuba)
+
+NAMESPACE_BEGIN(detail)
+
+#if defined(_WIN32)
+using socket_t = SOCKET;
+static void close_socket(intptr_t s) { closesocket((socket_t) s); }
+static int socket_error() { return WSAGetLastError(); }
+
+/// Initialize Winsock once per process
+static void socket_static_initialization() {
+    static bool initialized = []() {
+        WSADATA data;
+        if (WSAStartup(MAKEWORD(2, 2), &data) != 0)
+            Throw("Could not initialize Winsock!");
+        return true;
+    }();
+    (void) initialized;
+}
+#else
+using socket_t = int;
+static void close_socket(intptr_t s) { ::close((socket_t) s); }
+static int socket_error() { return errno; }
+static void socket_static_initialization() { }
+#endif
+
+NAMESPACE_END(detail)
+
+// =============================================================
+//! SocketStream
+// =============================================================
+
+SocketStream::SocketStream(const std::string &host, uint16_t port)
+    : Stream(), m_socket(-1), m_received(0), m_sent(0) {
+    detail::socket_static_initialization();
+    set_byte_order(ENetworkByteOrder);
+    m_peer = tfm::format("%s:%i", host, port);
+
+    addrinfo hints, *servinfo = nullptr;
+    memset(&hints, 0, sizeof(addrinfo));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    std::string port_str = std::to_string(port);
+    int rv = getaddrinfo(host.c_str(), port_str.c_str(), &hints, &servinfo);
+    if (rv != 0)
+        Throw("Could not resolve \"%s\": %s", m_peer, gai_strerror(rv));
+
+    for (addrinfo *p = servinfo; p != nullptr; p = p->ai_next) {
+        detail::socket_t s = ::socket(p->ai_family, p->ai_socktype, p->ai_protocol);
+        if ((intptr_t) s < 0)
+            continue;
+        if (::connect(s, p->ai_addr, (int) p->ai_addrlen) != 0) {
+            detail::close_socket((intptr_t) s);
+            continue;
+        }
+        m_socket = (intptr_t) s;
+        break;
+    }
+    freeaddrinfo(servinfo);
+
+    if (m_socket < 0)
+        Throw("Could not connect to \"%s\" (error %i)", m_peer,
+              detail::socket_error());
+
+    // Messages are small and latency-sensitive, don't wait for more data
+    int flag = 1;
+    setsockopt((detail::socket_t) m_socket, IPPROTO_TCP, TCP_NODELAY,
+               (const char *) &flag, sizeof(int));
+}
+
+SocketStream::SocketStream(intptr_t socket, const std::string &peer)
+    : Stream(), m_socket(socket), m_peer(peer), m_received(0), m_sent(0) {
+    set_byte_order(ENetworkByteOrder);
+    int flag = 1;
+    setsockopt((detail::socket_t) m_socket, IPPROTO_TCP, TCP_NODELAY,
+               (const char *) &flag, sizeof(int));
+}
+
+SocketStream::~SocketStream() {
+    close();
+}
+
+void SocketStream::close() {
+    intptr_t s = m_socket;
+    if (s < 0)
+        return;
+    m_socket = -1;
+    // Wake up threads that are blocked reading from the socket
+#if defined(_WIN32)
+    shutdown((detail::socket_t) s, SD_BOTH);
+#else
+    shutdown((detail::socket_t) s, SHUT_RDWR);
+#endif
+    detail::close_socket(s);
+}
+
+void SocketStream::read(void *p, size_t size) {
+    if (is_closed())
+        Throw("Attempted to read from a closed stream: %s", to_string());
+
+    char *ptr = (char *) p;
+    while (size > 0) {
+        int n = (int) std::min(size, (size_t) (1 << 30));
+        int rv = (int) ::recv((detail::socket_t) m_socket, ptr, n, 0);
+        if (rv == 0)
+            Throw("Connection to \"%s\" was closed (%zu more bytes required)",
+                  m_peer, size);
+        else if (rv < 0)
+            Throw("Error while reading from \"%s\" (error %i)", m_peer,
+                  detail::socket_error());
+        ptr += rv;
+        size -= (size_t) rv;
+        m_received += (size_t) rv;
+    }
+}
+
+void SocketStream::write(const void *p, size_t size) {
+    if (is_closed())
+        Throw("Attempted to write to a closed stream: %s", to_string());
+
+#if defined(MSG_NOSIGNAL)
+    int flags = MSG_NOSIGNAL;
+#else
+    int flags = 0;
+#endif
+
+    const char *ptr = (const char *) p;
+    while (size > 0) {
+        int n = (int) std::min(size, (size_t) (1 << 30));
+        int rv = (int) ::send((detail::socket_t) m_socket, ptr, n, flags);
+        if (rv <= 0)
+            Throw("Error while writing to \"%s\" (error %i)", m_peer,
+                  detail::socket_error());
+        ptr += rv;
+        size -= (size_t) rv;
+        m_sent += (size_t) rv;
+    }
+}
+
+void SocketStream::seek(size_t) {
+    Throw("SocketStream does not support seeking.");
+}
+
+void SocketStream::truncate(size_t) {
+    Throw("SocketStream does not support truncation.");
+}
+
+size_t SocketStream::size() const {
+    Throw("SocketStream does not have a size.");
+}
+
+std::string SocketStream::to_string() const {
+    std::ostringstream oss;
+    oss << class_()->name() << "[" << std::endl
+        << "  peer = \"" << m_peer << "\"," << std::endl
+        << "  received = " << m_received << "," << std::endl
+        << "  sent = " << m_sent << "," << std::endl
+        << "  is_closed = " << is_closed() << std::endl
+        << "]";
+    return oss.str();
+}
+
+// =============================================================
+//! ServerSocket
+// =============================================================
+
+ServerSocket::ServerSocket(uint16_t port) : m_socket(-1), m_port(port) {
+    detail::socket_static_initialization();
+
+    detail::socket_t s = ::socket(AF_INET, SOCK_STREAM, 0);
+    if ((intptr_t) s < 0)
+        Throw("Could not create a socket (error %i)", detail::socket_error());
+
+    int flag = 1;
+    setsockopt(s, SOL_SOCKET, SO_REUSEADDR, (const char *) &flag, sizeof(int));
+
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(sockaddr_in));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+
+    if (::bind(s, (sockaddr *) &addr, sizeof(sockaddr_in)) != 0) {
+        detail::close_socket((intptr_t) s);
+        Throw("Could not bind to port %i (error %i)", port,
+              detail::socket_error());
+    }
+
+    if (::listen(s, SOMAXCONN) != 0) {
+        detail::close_socket((intptr_t) s);
+        Throw("Could not listen on port %i (error %i)", port,
+              detail::socket_error());
+    }
+
+    socklen_t addr_len = sizeof(sockaddr_in);
+    if (::getsockname(s, (sockaddr *) &addr, &addr_len) == 0)
+        m_port = ntohs(addr.sin_port);
+
+    m_socket = (intptr_t) s;
+}
+
+ServerSocket::~ServerSocket() {
+    close();
+}
+
+ref<SocketStream> ServerSocket::accept() {
+    intptr_t listener = m_socket;
+    if (listener < 0)
+        return nullptr;
+
+    sockaddr_in addr;
+    socklen_t addr_len = sizeof(sockaddr_in);
+    detail::socket_t s =
+        ::accept((detail::socket_t) listener, (sockaddr *) &addr, &addr_len);
+    if ((intptr_t) s < 0) {
+        if (m_socket < 0)
+            return nullptr; // closed while waiting
+        Throw("Could not accept a connection (error %i)",
+              detail::socket_error());
+    }
+
+    char host[INET_ADDRSTRLEN] = { 0 };
+    inet_ntop(AF_INET, &addr.sin_addr, host, INET_ADDRSTRLEN);
+    return new SocketStream((intptr_t) s,
+                            tfm::format("%s:%i", host, ntohs(addr.sin_port)));
+}
+
+void ServerSocket::close() {
+    intptr_t s = m_socket;
+    if (s < 0)
+        return;
+    m_socket = -1;
+#if defined(_WIN32)
+    shutdown((detail::socket_t) s, SD_BOTH);
+#else
+    shutdown((detail::socket_t) s, SHUT_RDWR);
+#endif
+    detail::close_socket(s);
+}
+
+std::string ServerSocket::to_string() const {
+    std::ostringstream oss;
+    oss << class_()->name() << "[" << std::endl
+        << "  port = " << m_port << "," << std::endl
+        << "  is_closed = " << (m_socket < 0) << std::endl
+        << "]";
+    return oss.str();
+}
+
+MI_IMPLEMENT_CLASS(SocketStream, Stream)
+MI_IMPLEMENT_CLASS(ServerSocket, Object)
+
+NAMESPACE_END(mitsuba)
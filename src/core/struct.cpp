@@ -8,6 +8,7 @@
 #include <drjit/half.h>
 #include <drjit/color.h>
 #include <unordered_map>
+#include <cstring>
 #include <ostream>
 #include <map>
 
@@ -1495,6 +1496,7 @@ StructConverter::StructConverter(const Struct *source, const Struct *target, boo
     __cache[key] = (void *) m_func;
 #else
     m_dither = dither;
+    m_fast = init_fast_path();
 #endif
 }
 
@@ -1752,9 +1754,278 @@ void StructConverter::save(uint8_t *dst, const Struct::Field &f, Value value, si
     }
 }
 
+/// Types that the precompiled conversion routines can decode and encode
+static bool is_fast_type(Struct::Type type) {
+    switch (type) {
+        case Struct::Type::UInt8:
+        case Struct::Type::UInt16:
+        case Struct::Type::Float16:
+        case Struct::Type::Float32:
+        case Struct::Type::Float64:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool StructConverter::init_fast_path() {
+    if (m_source->byte_order() != Struct::host_byte_order() ||
+        m_target->byte_order() != Struct::host_byte_order())
+        return false;
+
+    bool has_alpha = false;
+    for (const Struct::Field &f : *m_source) {
+        /* Assertions, weights and alpha (un)premultiplication require the
+           generic implementation */
+        if (has_flag(f.flags, Struct::Flags::Assert) ||
+            (has_flag(f.flags, Struct::Flags::Weight) &&
+             !m_target->has_field(f.name)))
+            return false;
+        has_alpha |= has_flag(f.flags, Struct::Flags::Alpha);
+    }
+
+    uint32_t flag_mask = Struct::Flags::Normalized | Struct::Flags::Gamma;
+    uint32_t special_channels_mask = Struct::Flags::Weight | Struct::Flags::Alpha;
+
+    std::vector<FastField> fields;
+    for (const Struct::Field &f : *m_target) {
+        if (!f.blend.empty())
+            return false;
+
+        FastField ff;
+        ff.target = f;
+        ff.copy = ff.constant = false;
+        bool target_premult = has_flag(f.flags, Struct::Flags::PremultipliedAlpha);
+        bool special = (f.flags & special_channels_mask) != 0;
+
+        if (!m_source->has_field(f.name)) {
+            if (!has_flag(f.flags, Struct::Flags::Default) ||
+                (m_dither && f.is_integer()) ||
+                (has_alpha && !special && target_premult))
+                return false;
+
+            // Encode the default value once using the generic implementation
+            Value value;
+            value.d = f.default_;
+            value.type = Struct::Type::Float64;
+            value.flags = +Struct::Flags::Empty;
+            if (!(f.type == Struct::Type::Float64 && (f.flags & flag_mask) == 0))
+                linearize(value);
+            std::vector<uint8_t> buf(f.offset + f.size);
+            save(buf.data(), f, value, 0, 0);
+            std::memcpy(ff.constant_value, buf.data() + f.offset, f.size);
+            ff.constant = true;
+            fields.push_back(std::move(ff));
+            continue;
+        }
+
+        const Struct::Field &s = m_source->field(f.name);
+        bool source_premult = has_flag(s.flags, Struct::Flags::PremultipliedAlpha);
+        if (has_alpha && !special && source_premult != target_premult)
+            return false;
+
+        ff.source = s;
+        bool same_flags = (s.flags & flag_mask) == (f.flags & flag_mask);
+        if (s.type == f.type && same_flags) {
+            ff.copy = true;
+        } else if (same_flags && Struct::is_integer(s.type) &&
+                   Struct::is_integer(f.type) &&
+                   !has_flag(f.flags, Struct::Flags::Normalized)) {
+            // Integer casts are left to the generic implementation
+            return false;
+        } else if (!is_fast_type(s.type) || !is_fast_type(f.type)) {
+            return false;
+        }
+
+        if (!ff.copy && s.type == Struct::Type::UInt8) {
+            // Decode all 256 possible values using the generic implementation
+            ff.lut.resize(256);
+            for (uint32_t i = 0; i < 256; ++i) {
+                Value value;
+                value.u = i;
+                value.type = s.type;
+                value.flags = s.flags;
+                linearize(value);
+                ff.lut[i] = value.f;
+            }
+        }
+
+        fields.push_back(std::move(ff));
+    }
+
+    m_fast_fields = std::move(fields);
+    return true;
+}
+
+/// Decode a range of source fields into linear floating point values
+static void fast_load(const Float *lut,
+                      const Struct::Field &f, const uint8_t *src,
+                      size_t stride, size_t count,
+                      Float *out) {
+    src += f.offset;
+
+    switch (f.type) {
+        case Struct::Type::UInt8:
+            // Normalization and gamma correction are part of the table
+            for (size_t i = 0; i < count; ++i)
+                out[i] = lut[src[i * stride]];
+            return;
+
+        case Struct::Type::UInt16: {
+                Float scale = has_flag(f.flags, Struct::Flags::Normalized)
+                                  ? Float(1 / Struct::range(f.type).second)
+                                  : Float(1);
+                for (size_t i = 0; i < count; ++i) {
+                    uint16_t value;
+                    std::memcpy(&value, src + i * stride, sizeof(uint16_t));
+                    out[i] = (Float) value * scale;
+                }
+            }
+            break;
+
+        case Struct::Type::Float16:
+            for (size_t i = 0; i < count; ++i) {
+                uint16_t value;
+                std::memcpy(&value, src + i * stride, sizeof(uint16_t));
+                out[i] = (Float) dr::half::float16_to_float32(value);
+            }
+            break;
+
+        case Struct::Type::Float32:
+            for (size_t i = 0; i < count; ++i) {
+                float value;
+                std::memcpy(&value, src + i * stride, sizeof(float));
+                out[i] = (Float) value;
+            }
+            break;
+
+        case Struct::Type::Float64:
+            for (size_t i = 0; i < count; ++i) {
+                double value;
+                std::memcpy(&value, src + i * stride, sizeof(double));
+                out[i] = (Float) value;
+            }
+            break;
+
+        default: Throw("StructConverter: unknown field type!");
+    }
+
+    if (has_flag(f.flags, Struct::Flags::Gamma)) {
+        for (size_t i = 0; i < count; ++i)
+            out[i] = dr::srgb_to_linear(out[i]);
+    }
+}
+
+/// Encode a range of linear floating point values into target fields
+static void fast_save(const Struct::Field &f, Float *in,
+                      uint8_t *dst, size_t stride, size_t count, size_t x,
+                      size_t y, bool dither) {
+    dst += f.offset;
+
+    if (has_flag(f.flags, Struct::Flags::Gamma)) {
+        for (size_t i = 0; i < count; ++i)
+            in[i] = dr::linear_to_srgb(in[i]);
+    }
+
+    switch (f.type) {
+        case Struct::Type::UInt8:
+        case Struct::Type::UInt16: {
+                auto range = f.range();
+                Float scale = has_flag(f.flags, Struct::Flags::Normalized)
+                                  ? (Float) range.second
+                                  : Float(1);
+                const float *dither_row = dither_matrix256 + (y % 256) * 256;
+                for (size_t i = 0; i < count; ++i) {
+                    double d = (double) (in[i] * scale);
+                    if (dither)
+                        d += (double) dither_row[(x + i) % 256];
+                    d = std::max(d, range.first);
+                    d = std::min(d, range.second);
+                    d = std::rint(d);
+                    if (f.type == Struct::Type::UInt8) {
+                        dst[i * stride] = (uint8_t) d;
+                    } else {
+                        uint16_t value = (uint16_t) d;
+                        std::memcpy(dst + i * stride, &value, sizeof(uint16_t));
+                    }
+                }
+            }
+            break;
+
+        case Struct::Type::Float16:
+            for (size_t i = 0; i < count; ++i) {
+                uint16_t value = dr::half::float32_to_float16((float) in[i]);
+                std::memcpy(dst + i * stride, &value, sizeof(uint16_t));
+            }
+            break;
+
+        case Struct::Type::Float32:
+            for (size_t i = 0; i < count; ++i) {
+                float value = (float) in[i];
+                std::memcpy(dst + i * stride, &value, sizeof(float));
+            }
+            break;
+
+        case Struct::Type::Float64:
+            for (size_t i = 0; i < count; ++i) {
+                double value = (double) in[i];
+                std::memcpy(dst + i * stride, &value, sizeof(double));
+            }
+            break;
+
+        default: Throw("StructConverter: unknown field type!");
+    }
+}
+
+void StructConverter::convert_2d_fast(size_t width, size_t height,
+                                      const uint8_t *src,
+                                      uint8_t *dest) const {
+    size_t source_size = m_source->size();
+    size_t target_size = m_target->size();
+
+    // Fields are processed one at a time in small batches of elements
+    constexpr size_t BatchSize = 256;
+    Float buf[BatchSize];
+
+    for (size_t y = 0; y < height; ++y) {
+        for (size_t x = 0; x < width; x += BatchSize) {
+            size_t count = std::min(BatchSize, width - x);
+            const uint8_t *src_batch = src + x * source_size;
+            uint8_t *dest_batch = dest + x * target_size;
+
+            for (const FastField &ff : m_fast_fields) {
+                const Struct::Field &f = ff.target;
+                if (ff.constant) {
+                    for (size_t i = 0; i < count; ++i)
+                        std::memcpy(dest_batch + i * target_size + f.offset,
+                                    ff.constant_value, f.size);
+                } else if (ff.copy) {
+                    for (size_t i = 0; i < count; ++i)
+                        std::memcpy(dest_batch + i * target_size + f.offset,
+                                    src_batch + i * source_size + ff.source.offset,
+                                    f.size);
+                } else {
+                    fast_load(ff.lut.data(), ff.source, src_batch,
+                              source_size, count, buf);
+                    fast_save(f, buf, dest_batch, target_size, count, x, y,
+                              m_dither);
+                }
+            }
+        }
+
+        src += width * source_size;
+        dest += width * target_size;
+    }
+}
+
 bool StructConverter::convert_2d(size_t width, size_t height, const void *src_, void *dest_) const {
     using namespace mitsuba::detail;
 
+    if (m_fast) {
+        convert_2d_fast(width, height, (const uint8_t *) src_, (uint8_t *) dest_);
+        return true;
+    }
+
     size_t source_size = m_source->size();
     size_t target_size = m_target->size();
     Struct::Field weight_field, alpha_field;
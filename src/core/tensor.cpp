@@ -1,11 +1,18 @@
 #include <mitsuba/core/tensor.h>
 #include <mitsuba/core/mstream.h>
+#include <mitsuba/core/string.h>
 #include <mitsuba/core/util.h>
+#include <algorithm>
 
 NAMESPACE_BEGIN(mitsuba)
 
 TensorFile::TensorFile(const fs::path &filename)
     : MemoryMappedFile(filename, false) {
+    if (size() >= 6 && memcmp(data(), "\x93NUMPY", 6) == 0) {
+        read_npy();
+        return;
+    }
+
     if (size() < 12 + 2 + 4)
         Throw("Invalid tensor file: too small, truncated?");
     ref<MemoryStream> stream = new MemoryStream(data(), size());
@@ -51,6 +58,104 @@ TensorFile::TensorFile(const fs::path &filename)
     }
 }
 
+void TensorFile::read_npy() {
+    const uint8_t *ptr = (const uint8_t *) data();
+    if (size() < 10)
+        Throw("Invalid NumPy file: too small, truncated?");
+
+    uint8_t version = ptr[6];
+    size_t header_offset, header_size;
+    if (version == 1) {
+        header_offset = 10;
+        header_size = (size_t) ptr[8] | ((size_t) ptr[9] << 8);
+    } else if (version == 2 || version == 3) {
+        if (size() < 12)
+            Throw("Invalid NumPy file: too small, truncated?");
+        header_offset = 12;
+        header_size = (size_t) ptr[8] | ((size_t) ptr[9] << 8) |
+                      ((size_t) ptr[10] << 16) | ((size_t) ptr[11] << 24);
+    } else {
+        Throw("Invalid NumPy file: unknown file version %i.", (int) version);
+    }
+
+    if (header_offset + header_size > size())
+        Throw("Invalid NumPy file: truncated header.");
+
+    // The header is a Python dictionary literal, e.g.
+    // {'descr': '<f4', 'fortran_order': False, 'shape': (64, 64), }
+    std::string header((const char *) ptr + header_offset, header_size);
+    auto value_of = [&](const std::string &key) -> size_t {
+        size_t pos = header.find("'" + key + "'");
+        if (pos == std::string::npos)
+            Throw("Invalid NumPy file: missing \"%s\" entry.", key);
+        pos = header.find(':', pos);
+        if (pos == std::string::npos)
+            Throw("Invalid NumPy file: malformed header.");
+        return header.find_first_not_of(" ", pos + 1);
+    };
+
+    size_t pos = value_of("descr");
+    size_t end = header.find('\'', pos + 1);
+    if (header[pos] != '\'' || end == std::string::npos)
+        Throw("Invalid NumPy file: malformed \"descr\" entry.");
+    std::string descr = header.substr(pos + 1, end - pos - 1);
+    if (descr.size() < 3)
+        Throw("Invalid NumPy file: unsupported data type \"%s\".", descr);
+
+    char byte_order = descr[0];
+    std::string type = descr.substr(1);
+    bool little_endian = Struct::host_byte_order() == Struct::ByteOrder::LittleEndian;
+    bool swapped = (byte_order == '<' && !little_endian) ||
+                   (byte_order == '>' && little_endian);
+
+    static const std::pair<const char *, Struct::Type> types[] = {
+        { "b1", Struct::Type::UInt8 },   { "u1", Struct::Type::UInt8 },
+        { "i1", Struct::Type::Int8 },    { "u2", Struct::Type::UInt16 },
+        { "i2", Struct::Type::Int16 },   { "u4", Struct::Type::UInt32 },
+        { "i4", Struct::Type::Int32 },   { "u8", Struct::Type::UInt64 },
+        { "i8", Struct::Type::Int64 },   { "f2", Struct::Type::Float16 },
+        { "f4", Struct::Type::Float32 }, { "f8", Struct::Type::Float64 }
+    };
+
+    Struct::Type dtype = Struct::Type::Invalid;
+    for (auto [name, value] : types) {
+        if (type == name)
+            dtype = value;
+    }
+
+    if (dtype == Struct::Type::Invalid)
+        Throw("Invalid NumPy file: unsupported data type \"%s\".", descr);
+    if (swapped && type[1] != '1')
+        Throw("Invalid NumPy file: byte-swapped data is not supported.");
+
+    pos = value_of("fortran_order");
+    if (header.compare(pos, 4, "True") == 0)
+        Throw("Invalid NumPy file: arrays in Fortran order are not supported.");
+
+    pos = value_of("shape");
+    end = header.find(')', pos);
+    if (header[pos] != '(' || end == std::string::npos)
+        Throw("Invalid NumPy file: malformed \"shape\" entry.");
+
+    std::vector<size_t> shape;
+    size_t count = 1;
+    for (const std::string &s : string::tokenize(header.substr(pos + 1, end - pos - 1), ", ")) {
+        shape.push_back((size_t) std::stoull(s));
+        count *= shape.back();
+    }
+
+    size_t offset = header_offset + header_size;
+    size_t item_size = (size_t) (type[1] - '0');
+    if (offset + count * item_size > size())
+        Throw("Invalid NumPy file: truncated data.");
+
+    Log(Info, "Loading tensor data from \"%s\" .. (%s)",
+        filename().filename(), util::mem_string(size()));
+
+    m_fields[filename().stem().string()] =
+        Field{ dtype, offset, shape, (const uint8_t *) data() + offset };
+}
+
 /// Does the file contain a field of the specified name?
 bool TensorFile::has_field(const std::string &name) const {
     return m_fields.find(name) != m_fields.end();
@@ -64,6 +169,14 @@ const TensorFile::Field &TensorFile::field(const std::string &name) const {
     return it->second;
 }
 
+std::vector<std::string> TensorFile::field_names() const {
+    std::vector<std::string> names;
+    for (const auto &it : m_fields)
+        names.push_back(it.first);
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
 TensorFile::~TensorFile() { }
 
 std::string TensorFile::to_string() const {
@@ -66,6 +66,50 @@ def test_read_write_complex_exr(variant_scalar_rgb, tmpdir):
     assert str(b3) != str(b1)
 
 
+@pytest.mark.parametrize('compression', ['zip', 'dwaa', 'dwab'])
+def test_write_exr_compression(variant_scalar_rgb, tmpdir, compression):
+    # Tests the selection of the OpenEXR compression method via the metadata
+    values = np.linspace(0, 1, 64 * 48 * 3, dtype=np.float32).reshape(48, 64, 3)
+    b1 = mi.Bitmap(values, mi.Bitmap.PixelFormat.RGB)
+    b1.metadata()['compression'] = compression
+    tmp_file = os.path.join(str(tmpdir), "out.exr")
+    b1.write(tmp_file)
+
+    b2 = mi.Bitmap(tmp_file)
+    os.remove(tmp_file)
+    assert not b2.metadata().has_property('compression')
+
+    if compression == 'zip':
+        assert np.array_equal(np.array(b2), values)
+    else:
+        assert np.allclose(np.array(b2), values, atol=5e-2)
+
+    b1.metadata()['compression'] = 'invalid'
+    with pytest.raises(RuntimeError, match='unsupported compression'):
+        b1.write(tmp_file)
+
+
+def test_read_batch(variant_scalar_rgb, tmpdir):
+    # Tests loading several images of different formats concurrently
+    paths = []
+    for i, ext in enumerate(['exr', 'png', 'exr', 'png']):
+        values = np.full((16 + i, 8, 3), i / 4, dtype=np.float32)
+        b = mi.Bitmap(values, mi.Bitmap.PixelFormat.RGB)
+        if ext == 'png':
+            b = b.convert(mi.Bitmap.PixelFormat.RGB, mi.Struct.Type.UInt8, True)
+        paths.append(os.path.join(str(tmpdir), f'out_{i}.{ext}'))
+        b.write(paths[-1])
+
+    bitmaps = mi.Bitmap.read_batch(paths)
+    assert len(bitmaps) == 4
+    for i, b in enumerate(bitmaps):
+        assert b == mi.Bitmap(paths[i])
+        assert b.size() == [8, 16 + i]
+
+    with pytest.raises(RuntimeError):
+        mi.Bitmap.read_batch(paths + [os.path.join(str(tmpdir), 'missing.exr')])
+
+
 def test_convert_rgb_y(variant_scalar_rgb, tmpdir):
     # Tests RGBA(float64) -> Y (float32) conversion
     b1 = mi.Bitmap(mi.Bitmap.PixelFormat.RGBA, mi.Struct.Type.Float64, [3, 1])
@@ -116,6 +160,28 @@ def test_convert_optional_args(variant_scalar_rgb):
     assert b3.component_format() == mi.Struct.Type.UInt8
 
 
+def test_convert_fast_paths(variant_scalar_rgb, np_rng):
+    # float32 -> uint8/float16 conversions use dedicated kernels, compare them
+    # against the generic converter (float64 source) on a multi-band image
+    for pf, ch in [(mi.Bitmap.PixelFormat.RGB, 3), (mi.Bitmap.PixelFormat.RGBA, 4)]:
+        ref = np_rng.random((301, 83, ch)) * 1.2 - 0.1
+        b32 = mi.Bitmap(ref.astype(np.float32), pf)
+        b64 = mi.Bitmap(ref.astype(np.float32).astype(np.float64), pf)
+
+        for srgb in [False, True]:
+            fast = np.array(b32.convert(pf, mi.Struct.Type.UInt8, srgb))
+            slow = np.array(b64.convert(pf, mi.Struct.Type.UInt8, srgb))
+            assert fast.shape == slow.shape
+            assert np.max(np.abs(fast.astype(int) - slow.astype(int))) <= 1
+
+        b16 = b32.convert(pf, mi.Struct.Type.Float16, False)
+        assert b16.component_format() == mi.Struct.Type.Float16
+        assert np.array_equal(np.array(b16), ref.astype(np.float32).astype(np.float16))
+
+        b32_2 = b16.convert(pf, mi.Struct.Type.Float32, False)
+        assert np.array_equal(np.array(b32_2), np.array(b16).astype(np.float32))
+
+
 def test_premultiply_alpha(variant_scalar_rgb, tmpdir):
     # Tests RGBA(float64) -> Y (float32) conversion
     b1 = mi.Bitmap(mi.Bitmap.PixelFormat.RGBA, mi.Struct.Type.Float64, [3, 1])
@@ -176,6 +242,55 @@ def test_read_write_png(variant_scalar_rgb, tmpdir, np_rng):
     os.remove(tmp_file)
 
 
+def test_write_png_parallel(variant_scalar_rgb, tmpdir, np_rng):
+    # Large images are compressed in parallel chunks
+    tmp_file = os.path.join(str(tmpdir), "out.png")
+
+    for pf, ct, shape in [(mi.Bitmap.PixelFormat.RGB, mi.Struct.Type.UInt8, (512, 700, 3)),
+                          (mi.Bitmap.PixelFormat.YA, mi.Struct.Type.UInt16, (700, 301, 2))]:
+        dtype = np.uint8 if ct == mi.Struct.Type.UInt8 else np.uint16
+        y, x = np.mgrid[0:shape[0], 0:shape[1]]
+        ref = (x[..., None] * 3 + y[..., None] * 7 + np.arange(shape[2]))
+        ref = (ref + np_rng.integers(0, 4, shape)).astype(dtype)
+
+        b = mi.Bitmap(pf, ct, [shape[1], shape[0]])
+        np.array(b, copy=False)[:] = ref
+        b.metadata()['note'] = 'parallel'
+        for level in [1, 9]:
+            b.write(tmp_file, quality=level)
+            b2 = mi.Bitmap(tmp_file)
+            assert np.array_equal(np.array(b2), ref)
+            assert b2.metadata()['note'] == 'parallel'
+
+    os.remove(tmp_file)
+
+
+def test_read_max_resolution(variant_scalar_rgb, tmpdir):
+    values = np.zeros((96, 200, 3), dtype=np.float32)
+    values[:, :100] = 1
+    b = mi.Bitmap(values, mi.Bitmap.PixelFormat.RGB)
+
+    for ext in ['exr', 'png', 'jpg']:
+        tmp_file = os.path.join(str(tmpdir), f'out.{ext}')
+        if ext != 'exr':
+            b.convert(mi.Bitmap.PixelFormat.RGB, mi.Struct.Type.UInt8, True).write(tmp_file)
+        else:
+            b.write(tmp_file)
+
+        assert mi.Bitmap(tmp_file, max_resolution=200).size() == [200, 96]
+        assert mi.Bitmap(tmp_file, max_resolution=100).size() == [100, 48]
+        # 8x via DCT scaling for JPEG, box filter for other formats
+        assert mi.Bitmap(tmp_file, max_resolution=25).size() == [25, 12]
+        # Remaining factor of 3 after the 1/2 DCT scaling
+        b2 = mi.Bitmap(tmp_file, max_resolution=34)
+        assert b2.size() == [34, 16]
+
+        values2 = np.array(b2.convert(mi.Bitmap.PixelFormat.RGB, mi.Struct.Type.Float32, False))
+        assert np.allclose(values2[:, :16], 1, atol=0.05)
+        assert np.allclose(values2[:, 17:], 0, atol=0.05)
+        assert mi.Bitmap.read_batch([tmp_file], max_resolution=100)[0].size() == [100, 48]
+
+
 def test_read_write_hdr(variant_scalar_rgb, tmpdir, np_rng):
     b = mi.Bitmap(mi.Bitmap.PixelFormat.RGB, mi.Struct.Type.Float32, [10, 20])
     ref = np.float32(np_rng.random((20, 10, 3)))
@@ -428,3 +543,67 @@ def test_check_weight_division(variant_scalar_rgb):
     assert np.all(x[0, 0, :] == (2, 0, 0, 0))
     assert np.all(x[1, 0, :] == (1, 0, 0, 0))
     assert np.all(x[2, 0, :] == (2, 0, 0, 0))
+
+
+def write_dds(filename, width, height, dxgi_format, blocks):
+    import struct
+    header = struct.pack('<4s7I44x', b'DDS ', 124, 0x1007, height, width,
+                         len(blocks[0]) * len(blocks), 0, 1)
+    pixel_format = struct.pack('<2I4s5I', 32, 0x4, b'DX10', 0, 0, 0, 0, 0)
+    caps = struct.pack('<5I', 0x1000, 0, 0, 0, 0)
+    dxt10 = struct.pack('<5I', dxgi_format, 3, 0, 1, 0)
+    with open(filename, 'wb') as f:
+        f.write(header + pixel_format + caps + dxt10 + b''.join(blocks))
+
+
+def pack_block(fields):
+    # Pack (value, bit count) pairs into a 128 bit block, LSB first
+    value, pos = 0, 0
+    for v, n in fields:
+        value |= v << pos
+        pos += n
+    assert pos <= 128
+    return value.to_bytes(16, 'little')
+
+
+def test_read_dds_bc7(variant_scalar_rgb, tmpdir):
+    weights = [0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64]
+
+    # Mode 6: endpoints (0, 0, 254, 254) and (255, 1, 255, 255), texel i
+    # uses index i
+    block = pack_block([(1 << 6, 7), (0, 7), (127, 7), (0, 7), (0, 7),
+                        (127, 7), (127, 7), (127, 7), (127, 7), (0, 1), (1, 1),
+                        (0, 3)] + [(i, 4) for i in range(1, 16)])
+
+    filename = os.path.join(str(tmpdir), 'bc7.dds')
+    write_dds(filename, 6, 5, 98, [block] * 4)
+
+    b = mi.Bitmap(filename)
+    assert b.size() == [6, 5]
+    assert b.pixel_format() == mi.Bitmap.PixelFormat.RGBA
+    assert b.component_format() == mi.Struct.Type.UInt8
+    assert not b.srgb_gamma()
+    assert b.metadata()['block_compression'] == 'BC7_UNORM'
+
+    x = np.array(b)
+    e0, e1 = [0, 0, 254, 254], [255, 1, 255, 255]
+    for y in range(5):
+        for i in range(6):
+            w = weights[(y % 4) * 4 + i % 4]
+            ref = [((64 - w) * a + w * b + 32) >> 6 for a, b in zip(e0, e1)]
+            assert np.all(x[y, i] == ref)
+
+
+def test_read_dds_bc6h(variant_scalar_rgb, tmpdir):
+    # Mode 11 (10 bit endpoints): all endpoints set to 512
+    block = pack_block([(3, 5)] + [(512, 10)] * 6)
+
+    filename = os.path.join(str(tmpdir), 'bc6h.dds')
+    write_dds(filename, 4, 4, 95, [block])
+
+    b = mi.Bitmap(filename)
+    assert b.pixel_format() == mi.Bitmap.PixelFormat.RGB
+    assert b.component_format() == mi.Struct.Type.Float16
+
+    ref = np.array([0x3E0F], dtype=np.uint16).view(np.float16)[0]
+    assert np.all(np.array(b) == ref)
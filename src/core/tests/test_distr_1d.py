@@ -268,3 +268,66 @@ def test18_irrcont_simple_function(variants_vec_backends_once):
                 0.48734, 0.654313, 0.786607, 0.899653, 1.])
          * d.normalization())
     )
+
+
+def test19_discr_alias(variants_vec_backends_once):
+    # Sampling using an alias table must follow the same distribution
+    pmf = [0, 1, 3, 0, 2, 0.5, 0]
+    x = mi.DiscreteDistribution(pmf)
+    assert not x.has_alias_table()
+    x.set_alias_table(True)
+    assert x.has_alias_table()
+
+    n = 100000
+    samples = (dr.arange(mi.Float, n) + .5) / n
+    index, reused, pmf_value = x.sample_reuse_pmf(samples)
+
+    # Zero-valued buckets are never sampled
+    assert dr.all(dr.neq(index, 0) & dr.neq(index, 3) & dr.neq(index, 6))
+    assert dr.allclose(pmf_value, x.eval_pmf_normalized(index))
+
+    # Histogram of the sampled indices matches the PMF
+    hist = dr.zeros(mi.Float, len(pmf))
+    dr.scatter_reduce(dr.ReduceOp.Add, hist, 1.0, index)
+    assert dr.allclose(hist / n, mi.Float(pmf) / sum(pmf), atol=1e-4)
+
+    # The reused samples are uniformly distributed within every bucket
+    assert dr.all((reused >= 0) & (reused < 1))
+    mean = dr.zeros(mi.Float, len(pmf))
+    dr.scatter_reduce(dr.ReduceOp.Add, mean, reused, index)
+    mean = dr.select(hist > 0, mean / hist, .5)
+    assert dr.allclose(mean, .5, atol=1e-3)
+
+    # The table is rebuilt when the PMF changes
+    x.pmf()[:] = mi.Float([1, 0, 0, 0, 0, 0, 1])
+    x.update()
+    index, pmf_value = x.sample_pmf(samples)
+    assert dr.all(dr.eq(index, 0) | dr.eq(index, 6))
+    assert dr.allclose(pmf_value, .5)
+    assert dr.allclose(dr.sum(mi.Float(dr.eq(index, 0))), n / 2, rtol=1e-3)
+
+
+def test20_irrcont_clustered_nodes(variants_vec_backends_once):
+    # Clustered nodes and zero-valued regions exercise cells of the
+    # interval guide tables that contain many or no entries
+    import numpy as np
+    nodes = [0, 1e-3, 2e-3, 3e-3, 4e-3, 0.5, 0.9, 0.901, 0.902, 4, 4.5, 10]
+    pdf   = [1, 4, 0, 0, 2, 3, 0, 0, 1, 5, 0, 1]
+    d = mi.IrregularContinuousDistribution(nodes, pdf)
+
+    x = dr.linspace(mi.Float, -1, 11, 2001)
+    assert dr.allclose(d.eval_pdf(x),
+                       np.interp(np.array(x), nodes, pdf, left=0, right=0),
+                       atol=1e-5)
+
+    # Sampling inverts the CDF
+    u = dr.linspace(mi.Float, 0, 1, 2001)
+    pos, pdf_value = d.sample_pdf(u)
+    assert dr.allclose(pos, d.sample(u))
+    assert dr.allclose(d.eval_cdf_normalized(pos), u, atol=1e-5)
+    assert dr.allclose(pdf_value, d.eval_pdf_normalized(pos), atol=1e-4)
+
+    # Same for a regular distribution with zero-valued regions
+    c = mi.ContinuousDistribution([-1, 1], [0, 0, 1, 0, 0, 0, 3, 2, 0, 0, 0])
+    pos = c.sample(u)
+    assert dr.allclose(c.eval_cdf_normalized(pos), u, atol=1e-5)
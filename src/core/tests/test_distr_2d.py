@@ -177,3 +177,51 @@ def test05_discrete_distribution_2d(variants_all_backends_once):
     assert allclose(d.sample([1, 0]), ([2, 0], .3, [1, 0]))
     assert allclose(d.sample([0, 6 / 10 - 1e-7]), ([0, 0], .1, [0, 1]))
     assert allclose(d.sample([0, 6 / 10 + 1e-7]), ([1, 1], .1, [0, 0]))
+
+
+@pytest.mark.parametrize("warp", ['MarginalDiscrete2D', 'MarginalContinuous2D'])
+def test06_marginal_serialization(variants_all_backends_once, warp):
+    # Warps restored from a stream must produce identical results
+    np.random.seed(0)
+    values = np.random.rand(2, 3, 7, 5).astype(np.float32) + 0.1
+    param_values = [[0, 1], [0, 0.5, 1]]
+
+    distr = getattr(mi, warp + '2')(values, param_values)
+    stream = mi.MemoryStream()
+    distr.write(stream)
+    stream.seek(0)
+    distr_2 = getattr(mi, warp + '2')(stream, [5, 7], param_values)
+
+    sample = mi.Vector2f(dr.linspace(mi.Float, 0, 1, 10), 0.3)
+    param = [0.3, 0.8]
+    assert dr.allclose(distr.sample(sample, param), distr_2.sample(sample, param))
+    assert dr.allclose(distr.eval(sample, param), distr_2.eval(sample, param))
+
+    # The resolution must match
+    stream.seek(0)
+    with pytest.raises(RuntimeError, match="don't match the resolution"):
+        getattr(mi, warp + '2')(stream, [5, 6], param_values)
+
+
+def test07_marginal_half_precision(variants_all_backends_once):
+    np.random.seed(0)
+    values = np.random.rand(7, 5).astype(np.float32) + 0.1
+    pos = mi.Vector2f(dr.linspace(mi.Float, 0, 1, 10), 0.3)
+
+    distr = mi.MarginalDiscrete2D0(values, normalize=False, enable_sampling=False)
+    ref = distr.eval(pos)
+    assert not distr.is_half_precision()
+    distr.set_half_precision()
+    assert distr.is_half_precision()
+    assert dr.allclose(distr.eval(pos), ref, rtol=1e-3)
+
+    # Half precision tables survive serialization
+    stream = mi.MemoryStream()
+    distr.write(stream)
+    stream.seek(0)
+    distr_2 = mi.MarginalDiscrete2D0(stream, [5, 7], normalize=False)
+    assert distr_2.is_half_precision()
+    assert dr.allclose(distr_2.eval(pos), distr.eval(pos))
+
+    with pytest.raises(RuntimeError, match="sampling is disabled"):
+        mi.MarginalDiscrete2D0(values).set_half_precision()
@@ -153,3 +153,40 @@ def test12_truncate_and_file_size(variant_scalar_rgb):
     assert fs.file_size(p) == 42
     assert fs.remove(p)
     assert not fs.exists(p)
+
+
+def test13_directory_entries(variant_scalar_rgb, tmp_path):
+    (tmp_path / 'a.txt').write_text('a')
+    (tmp_path / 'subdir').mkdir()
+
+    entries = sorted(str(e) for e in fs.directory_entries(str(tmp_path)))
+    assert entries == ['a.txt', 'subdir']
+    assert len(fs.directory_entries(str(tmp_path / 'missing'))) == 0
+
+
+def test14_file_resolver_cache(variant_scalar_rgb, tmp_path):
+    dir1, dir2 = tmp_path / 'dir1', tmp_path / 'dir2'
+    dir1.mkdir()
+    dir2.mkdir()
+    (dir2 / 'file.txt').write_text('2')
+
+    fr = mi.FileResolver()
+    fr.clear()
+    fr.append(str(dir1))
+    fr.append(str(dir2))
+    assert fr.resolve('file.txt') == fs.path(str(dir2 / 'file.txt'))
+
+    # Lookups are cached until the search paths change
+    (dir1 / 'file.txt').write_text('1')
+    assert fr.resolve('file.txt') == fs.path(str(dir2 / 'file.txt'))
+    fr.prepend(str(tmp_path))
+    assert fr.resolve('file.txt') == fs.path(str(dir1 / 'file.txt'))
+
+    # Directory listings rule out search paths that don't contain a file
+    fr.prefetch()
+    assert fr.resolve('missing.txt') == fs.path('missing.txt')
+    assert fr.resolve('dir2' + sep + 'file.txt') == fs.path(str(dir2 / 'file.txt'))
+    (dir2 / 'new.txt').write_text('new')
+    assert fr.resolve('new.txt') == fs.path('new.txt')
+    fr.clear_cache()
+    assert fr.resolve('new.txt') == fs.path(str(dir2 / 'new.txt'))
@@ -39,3 +39,43 @@ def test01_custom(variant_scalar_rgb):
         for app in appenders:
             logger.add_appender(app)
         logger.set_formatter(formatter)
+
+
+def test02_asynchronous(variant_scalar_rgb):
+    # Messages are queued and forwarded in order after a flush
+    messages = []
+
+    logger = mi.Thread.thread().logger()
+    formatter = logger.formatter()
+    appenders = []
+    while logger.appender_count() > 0:
+        app = logger.appender(0)
+        appenders.append(app)
+        logger.remove_appender(app)
+
+    try:
+        class MyFormatter(mi.Formatter):
+            def format(self, level, theClass, thread, filename, line, msg):
+                return msg
+
+        class MyAppender(mi.Appender):
+            def append(self, level, text):
+                messages.append(text)
+
+        logger.set_formatter(MyFormatter())
+        logger.add_appender(MyAppender())
+        logger.set_asynchronous(True)
+        assert logger.asynchronous()
+
+        for i in range(1000):
+            mi.Log(mi.LogLevel.Warn, "message %i" % i)
+        logger.flush()
+
+        assert len(messages) == 1000
+        assert all(m.endswith("message %i" % i) for i, m in enumerate(messages))
+    finally:
+        logger.set_asynchronous(False)
+        logger.clear_appenders()
+        for app in appenders:
+            logger.add_appender(app)
+        logger.set_formatter(formatter)
@@ -252,3 +252,22 @@ def test13_trailing_zeros_keys(variant_scalar_rgb):
     assert len(props.property_names()) == 2
     assert props[key1] == 4.0
     assert props[key2] == 8.0
+
+def test14_many_properties(variant_scalar_rgb):
+    props = mi.Properties()
+    # Insert in reverse order, enumeration follows the natural sort order
+    for i in reversed(range(100)):
+        props[f'prop_{i}'] = i
+
+    names = [f'prop_{i}' for i in range(100)]
+    assert props.property_names() == names
+    assert props.unqueried() == names
+
+    for i in range(0, 100, 2):
+        assert props[f'prop_{i}'] == i
+    assert props.unqueried() == names[1::2]
+
+    assert props.remove_property('prop_51')
+    assert not props.has_property('prop_51')
+    assert props['prop_99'] == 99
+    assert len(props.property_names()) == 99
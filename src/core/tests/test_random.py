@@ -91,3 +91,14 @@ def test07_permute_kensler_uniform(variant_scalar_rgb):
 
         mean = np.mean(histogram)
         assert dr.allclose(1.0 / sample_count, mean)
+
+
+def test08_philox_known_answers(variant_scalar_rgb):
+    # Known answer tests of the Random123 reference implementation
+    assert mi.philox_4x32([0, 0, 0, 0], [0, 0]) == \
+        [0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8]
+    assert mi.philox_4x32([0xffffffff] * 4, [0xffffffff] * 2) == \
+        [0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd]
+    assert mi.philox_4x32([0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344],
+                          [0xa4093822, 0x299f31d0]) == \
+        [0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1]
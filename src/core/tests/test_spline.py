@@ -150,3 +150,42 @@ def test_eval_2d(variant_scalar_rgb):
     assert dr.allclose(spline.eval_2d(nodes_x, nodes_y, values, 0, 1),     0)
     assert dr.allclose(spline.eval_2d(nodes_x, nodes_y, values, 1, 1),     1)
     assert dr.allclose(spline.eval_2d(nodes_x, nodes_y, values, 0.5, 0.5), 0.5)
+
+
+@pytest.mark.parametrize('cells', [0, 3, 64])
+def test_interval_index(variants_any_llvm, cells):
+    from mitsuba import spline
+    import numpy as np
+
+    # Clustered nodes, so that some cells contain several of them
+    nodes = np.array([0.0, 0.01, 0.02, 0.03, 0.5, 0.7, 0.71, 2.0], dtype=np.float32)
+    values = np.array([0.1, 0.3, 0.2, 0.6, 1.0, 0.8, 0.9, 0.4], dtype=np.float32)
+    cdf = np.array(spline.integrate_1d(nodes, values), dtype=np.float32)
+    increasing = np.cumsum(values).astype(np.float32)
+
+    index_nodes = spline.IntervalIndex(nodes, cells)
+    index_cdf = spline.IntervalIndex(cdf, cells)
+    index_inc = spline.IntervalIndex(increasing, cells)
+    assert index_nodes.size() == len(nodes)
+    assert index_nodes.cells() == (cells if cells > 0 else len(nodes) - 1)
+
+    # Many queries are evaluated at once, including ones outside of the range
+    x = dr.linspace(mi.Float, -0.5, 2.5, 1001)
+    assert dr.allclose(spline.eval_1d(nodes, values, x),
+                       spline.eval_1d(nodes, values, x, index=index_nodes))
+    _, offset_ref, weights_ref = spline.eval_spline_weights(nodes, x)
+    _, offset, weights = spline.eval_spline_weights(nodes, x, index=index_nodes)
+    assert dr.all(offset_ref == offset)
+    for w_ref, w in zip(weights_ref, weights):
+        assert dr.allclose(w_ref, w)
+
+    y = dr.linspace(mi.Float, 0, float(increasing[-1]), 1001)
+    assert dr.allclose(spline.invert_1d(nodes, increasing, y),
+                       spline.invert_1d(nodes, increasing, y, index=index_inc))
+
+    sample = dr.linspace(mi.Float, 0, 1, 1001)
+    assert dr.allclose(spline.sample_1d(nodes, values, cdf, sample),
+                       spline.sample_1d(nodes, values, cdf, sample, index=index_cdf))
+
+    with pytest.raises(RuntimeError, match='different size'):
+        spline.eval_1d(nodes, values, x, index=spline.IntervalIndex(nodes[:4]))
@@ -2,7 +2,8 @@ import os
 import pytest
 import drjit as dr
 
-from mitsuba.scalar_rgb import Stream, DummyStream, FileStream, MemoryStream, ZStream
+from mitsuba.scalar_rgb import Stream, DummyStream, FileStream, BufferedFileStream, \
+    MemoryStream, ZStream
 from mitsuba.scalar_rgb.test.util import tmpfile, make_tmpfile
 
 parameters = [
@@ -11,7 +12,8 @@ parameters = [
         (DummyStream, ()),
         (MemoryStream, (64,)),
         (FileStream, (make_tmpfile, FileStream.ERead)),
-        (FileStream, (make_tmpfile, FileStream.ETruncReadWrite))
+        (FileStream, (make_tmpfile, FileStream.ETruncReadWrite)),
+        (BufferedFileStream, (make_tmpfile, 4))
     ]
 ]
 
@@ -283,3 +285,62 @@ def test08_fstream(rw, tmpfile):
     else:
         with pytest.raises(RuntimeError):
             FileStream(new_name)
+
+
+@pytest.mark.parametrize('buffer_size', [1, 7, 1024])
+def test09_buffered_fstream(buffer_size, tmpfile):
+    s = FileStream(tmpfile, FileStream.ETruncReadWrite)
+    write_contents(s)
+    size = s.size()
+    s.close()
+
+    s = BufferedFileStream(tmpfile, buffer_size)
+    assert s.can_read() and not s.can_write()
+    assert s.size() == size
+    assert s.buffer_size() == buffer_size
+
+    # Reads that straddle the blocks, and seeks within and across them
+    check_contents(s)
+    assert s.tell() == size
+    check_contents(s)
+    s.seek(4)
+    assert s.read_int64() == 999
+    assert s.tell() == 12
+
+    s.seek(size - 1)
+    with pytest.raises(RuntimeError):
+        s.read_int64()
+
+    with pytest.raises(RuntimeError):
+        s.write_int64(42)
+
+    s.close()
+    assert not s.can_read()
+
+
+@pytest.mark.parametrize('stream_type', [ZStream.EDeflateStream, ZStream.EGZipStream,
+                                         ZStream.EZstdStream, ZStream.ELZ4Stream])
+def test10_zstream_formats(stream_type):
+    if not ZStream.has_backend(stream_type):
+        with pytest.raises(RuntimeError):
+            ZStream(MemoryStream(), stream_type)
+        pytest.skip('Compression format is not supported by this build')
+
+    stream = MemoryStream()
+    zstream = ZStream(stream, stream_type, threads=2)
+    assert zstream.stream_type() == stream_type
+    for i in range(1000):
+        write_contents(zstream)
+    zstream.close()
+
+    stream.seek(0)
+    detected = ZStream.detect_type(stream)
+    assert stream.tell() == 0
+    if stream_type != ZStream.EDeflateStream:
+        assert detected == stream_type
+
+    zstream = ZStream(stream, stream_type)
+    for i in range(1000):
+        check_contents(zstream)
+    with pytest.raises(RuntimeError):
+        zstream.read_int64()
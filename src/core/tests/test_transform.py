@@ -186,41 +186,98 @@ def test08_transform_chain(variants_all_rgb):
     assert T.to_frame(mi.Frame3f([1, 0, 0])).scale(4.0) == T.to_frame(mi.Frame3f([1, 0, 0])) @ T.scale(4.0)
 
 
-# def test08_atransform_construct(variant_scalar_rgb):
-#     t = mi.Transform4f.rotate([1, 0, 0], 30)
-#     a = AnimatedTransform(t)
-
-#     t0 = a.eval(0)
-#     assert t0 == t
-#     assert not t0.has_scale()
-#     # Animation is constant over time
-#     for v in [10, 200, 1e5]:
-#         assert np.all(t0 == a.eval(v))
-
-
-# def test10_atransform_interpolate_rotation(variant_scalar_rgb):
-#     a = AnimatedTransform()
-#     axis = np.array([1.0, 2.0, 3.0])
-#     axis /= la.norm(axis)
-
-#     trafo0 = mi.Transform4f.rotate(axis, 0)
-#     trafo1 = mi.Transform4f.rotate(axis, 30)
-#     trafo_mid = mi.Transform4f.rotate(axis, 15)
-#     a.append(2, trafo0)
-#     a.append(3, trafo1)
-
-#     assert dr.allclose(a.eval(-10).matrix, trafo0.matrix)
-#     assert dr.allclose(a.eval(2.5).matrix, trafo_mid.matrix)
-#     assert dr.allclose(a.eval( 10).matrix, trafo1.matrix)
-
-
-# def test11_atransform_interpolate_scale(variant_scalar_rgb):
-#     a = AnimatedTransform()
-#     trafo0 = mi.Transform4f.scale([1,2,3])
-#     trafo1 = mi.Transform4f.scale([4,5,6])
-#     trafo_mid = mi.Transform4f.scale([2.5, 3.5, 4.5])
-#     a.append(2, trafo0)
-#     a.append(3, trafo1)
-#     assert dr.allclose(a.eval(-10).matrix, trafo0.matrix)
-#     assert dr.allclose(a.eval(2.5).matrix, trafo_mid.matrix)
-#     assert dr.allclose(a.eval( 10).matrix, trafo1.matrix)
+def test09_atransform_construct(variant_scalar_rgb):
+    t = mi.Transform4f.rotate([1, 0, 0], 30)
+    a = mi.AnimatedTransform(t)
+
+    t0 = a.eval(0)
+    assert t0 == t
+    assert not t0.has_scale()
+    # Animation is constant over time
+    for v in [10, 200, 1e5]:
+        assert t0 == a.eval(v)
+
+
+def test10_atransform_interpolate_rotation(variant_scalar_rgb):
+    a = mi.AnimatedTransform()
+    axis = np.array([1.0, 2.0, 3.0])
+    axis /= la.norm(axis)
+
+    trafo0 = mi.Transform4f.rotate(axis, 0)
+    trafo1 = mi.Transform4f.rotate(axis, 30)
+    trafo_mid = mi.Transform4f.rotate(axis, 15)
+    a.append(2, trafo0)
+    a.append(3, trafo1)
+
+    assert dr.allclose(a.eval(-10).matrix, trafo0.matrix)
+    assert dr.allclose(a.eval(2.5).matrix, trafo_mid.matrix)
+    assert dr.allclose(a.eval( 10).matrix, trafo1.matrix)
+
+
+def test11_atransform_interpolate_scale(variant_scalar_rgb):
+    a = mi.AnimatedTransform()
+    trafo0 = mi.Transform4f.scale([1,2,3])
+    trafo1 = mi.Transform4f.scale([4,5,6])
+    trafo_mid = mi.Transform4f.scale([2.5, 3.5, 4.5])
+    a.append(2, trafo0)
+    a.append(3, trafo1)
+    assert dr.allclose(a.eval(-10).matrix, trafo0.matrix)
+    assert dr.allclose(a.eval(2.5).matrix, trafo_mid.matrix)
+    assert dr.allclose(a.eval( 10).matrix, trafo1.matrix)
+    assert a.has_scale()
+
+
+def test12_atransform_decomposition(variant_scalar_rgb):
+    # Keyframes with shear and a reflection are reproduced exactly
+    trafo0 = mi.Transform4f(mi.ScalarMatrix4f(
+        [[1, 0.5, 0, 1], [0, 2, 0.3, 2], [0.2, 0, -1, 3], [0, 0, 0, 1]]))
+    trafo1 = mi.Transform4f.translate([1, 2, 3]) @ \
+             mi.Transform4f.rotate([0, 1, 0], 170) @ mi.Transform4f.scale(2)
+
+    a = mi.AnimatedTransform()
+    a.append(0, trafo0)
+    a.append(1, trafo1)
+    a.append(3, trafo0)
+
+    assert len(a) == 3
+    assert dr.allclose(a.eval(0).matrix, trafo0.matrix, atol=1e-5)
+    assert dr.allclose(a.eval(1).matrix, trafo1.matrix, atol=1e-5)
+    assert dr.allclose(a.eval(3).matrix, trafo0.matrix, atol=1e-5)
+    t2 = a.eval(2)
+    assert dr.allclose(t2.matrix @ dr.transpose(t2.inverse_transpose),
+                       dr.identity(mi.Matrix4f), atol=1e-5)
+
+    # The scale/shear factor is upper triangular
+    c0 = a[0].scale @ mi.ScalarVector3f(1, 0, 0)
+    c1 = a[0].scale @ mi.ScalarVector3f(0, 1, 0)
+    assert c0.y == 0 and c0.z == 0 and c1.z == 0
+
+    # Keyframes must be monotonically increasing
+    with pytest.raises(RuntimeError, match='monotonically'):
+        a.append(2, trafo1)
+
+    # Resampling reproduces uniformly spaced keyframes and the interpolation
+    keys = a.resample()
+    assert len(keys) == 4
+    assert dr.allclose([k.time for k in keys], [0, 1, 2, 3])
+    mid = a.interpolate(2)
+    assert dr.allclose(keys[2].trans, mid.trans)
+    assert dr.allclose(keys[2].quat, mid.quat)
+
+
+def test13_atransform_eval_vectorized(variants_vec_rgb):
+    a = mi.AnimatedTransform()
+    a.append(0, mi.ScalarTransform4f.translate([0, 0, 0]))
+    a.append(1, mi.ScalarTransform4f.rotate([0, 0, 1], 90) @
+                mi.ScalarTransform4f.translate([1, 0, 0]))
+    a.append(2, mi.ScalarTransform4f.translate([0, 2, 0]))
+
+    # Each lane selects its own segment
+    time = mi.Float([-1, 0, 0.5, 1, 1.5, 2, 5])
+    p = a.eval(time) @ mi.Point3f(1, 0, 0)
+
+    h = 0.5 ** 0.5
+    ref = mi.Point3f([1, 1, h, 0, h, 1, 1],
+                     [0, 0, h + 0.5, 2, h + 1.5, 2, 2],
+                     0)
+    assert dr.allclose(p, ref, atol=1e-5)
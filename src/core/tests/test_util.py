@@ -26,3 +26,14 @@ def test01_mem_string(variant_scalar_rgb):
         assert mem_string(2 * 1024 ** 4, precise=True) == '2 TiB'
         assert mem_string(2 * 1024 ** 5, precise=True) == '2 PiB'
         assert mem_string(2 * 1024 ** 6, precise=True) == '2 EiB'
+
+
+def test02_numa_topology(variant_scalar_rgb):
+    from mitsuba.util import numa_topology, core_count
+
+    topology = numa_topology()
+    assert len(topology) > 0
+    cores = [c for node in topology for c in node]
+    assert len(cores) > 0
+    assert len(cores) == len(set(cores))
+    assert all(0 <= c for c in cores)
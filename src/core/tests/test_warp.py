@@ -213,3 +213,34 @@ def test_square_to_uniform_lune(variants_vec_rgb):
     inv = lambda v: mi.warp.uniform_spherical_lune_to_square(v, n1, n2)
 
     check_inverse(fwd, inv, atol=1e-4)
+
+
+def test_square_to_spherical_triangle(variants_vec_rgb):
+    a = dr.normalize(mi.Vector3f(1, 0.1, 0.2))
+    b = dr.normalize(mi.Vector3f(0.1, 1, 0.3))
+    c = dr.normalize(mi.Vector3f(0.2, 0.3, 1))
+
+    # One octant of the unit sphere
+    omega = mi.warp.spherical_triangle_solid_angle(
+        mi.Vector3f(1, 0, 0), mi.Vector3f(0, 1, 0), mi.Vector3f(0, 0, 1))
+    assert dr.allclose(omega, dr.pi / 2)
+
+    sampler = mi.load_dict({ 'type': 'independent' })
+    sampler.seed(0, 1 << 16)
+    d = mi.warp.square_to_spherical_triangle(sampler.next_2d(), a, b, c)
+    assert dr.allclose(dr.norm(d), 1)
+
+    # All directions lie within the triangle
+    for u, v in [(a, b), (b, c), (c, a)]:
+        assert dr.all(dr.dot(dr.cross(u, v), d) >= -1e-5)
+
+    # Uniformly distributed: the sub-triangle spanned by 'a', 'b' and the
+    # midpoint of 'b' and 'c' receives its share of the samples
+    m = dr.normalize(b + c)
+    inside = (dr.dot(dr.cross(a, b), d) >= 0) & \
+             (dr.dot(dr.cross(b, m), d) >= 0) & \
+             (dr.dot(dr.cross(m, a), d) >= 0)
+    fraction = dr.count(inside) / (1 << 16)
+    expected = mi.warp.spherical_triangle_solid_angle(a, b, m) / \
+               mi.warp.spherical_triangle_solid_angle(a, b, c)
+    assert dr.allclose(fraction, expected, atol=1e-2)
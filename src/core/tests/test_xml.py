@@ -425,3 +425,205 @@ def test31_python_plugins_parallel(variants_vec_backends_once_rgb):
         <bsdf type='dummy'/>
     </scene>
     """, parallel=True)
+
+
+def test32_compiled_scene(variant_scalar_rgb, tmp_path):
+    xml_path = str(tmp_path / 'scene.xml')
+    compiled_path = str(tmp_path / 'scene.miscene')
+
+    with open(xml_path, 'w') as f:
+        f.write("""<scene version="3.0.0">
+            <default name="radius" value="2"/>
+            <bsdf type="diffuse" id="my_bsdf">
+                <rgb name="reflectance" value="0.2, 0.4, 0.6"/>
+            </bsdf>
+            <alias id="my_bsdf" as="my_alias"/>
+            <shape type="sphere">
+                <float name="radius" value="$radius"/>
+                <transform name="to_world">
+                    <translate x="1" y="2" z="3"/>
+                </transform>
+                <ref id="my_alias"/>
+            </shape>
+            <emitter type="constant">
+                <spectrum name="radiance" value="400:1, 500:2, 600:3"/>
+            </emitter>
+        </scene>""")
+
+    mi.compile_file(xml_path, compiled_path, radius=3)
+
+    scene_ref = mi.load_file(xml_path, radius=3)
+    scene = mi.load_file(compiled_path)
+
+    params_ref = mi.traverse(scene_ref)
+    params = mi.traverse(scene)
+    assert set(params.keys()) == set(params_ref.keys())
+    for k in params.keys():
+        assert dr.allclose(params[k], params_ref[k])
+
+    assert dr.allclose(scene.bbox().min, scene_ref.bbox().min)
+    assert dr.allclose(scene.bbox().max, scene_ref.bbox().max)
+
+    with pytest.raises(Exception) as e:
+        mi.load_file(compiled_path, radius=2)
+    e.match('parameters cannot be specified')
+
+
+def test33_deduplicate(variant_scalar_rgb):
+    shape = """<shape type="sphere">
+                   <bsdf type="diffuse">
+                       <rgb name="reflectance" value="%s"/>
+                   </bsdf>
+               </shape>"""
+    scene_xml = ('<scene version="3.0.0">' + shape % '0.5' + shape % '0.5' +
+                 shape % '0.25' + '</scene>')
+
+    def unique_bsdfs(scene):
+        return len(set(id(s.bsdf()) for s in scene.shapes()))
+
+    scene = mi.load_string(scene_xml)
+    assert unique_bsdfs(scene) == 3
+
+    scene = mi.load_string(scene_xml, deduplicate=True)
+    assert len(scene.shapes()) == 3
+    assert unique_bsdfs(scene) == 2
+
+
+def test34_scene_updater(variant_scalar_rgb, tmp_path):
+    xml_path = str(tmp_path / 'scene.xml')
+
+    def write(albedo=0.5, offset=0):
+        with open(xml_path, 'w') as f:
+            f.write(f"""<scene version="3.0.0">
+                <bsdf type="diffuse" id="my_bsdf">
+                    <rgb name="reflectance" value="{albedo}"/>
+                </bsdf>
+                <shape type="sphere" id="my_sphere">
+                    <ref id="my_bsdf"/>
+                </shape>
+                <shape type="cube" id="my_cube">
+                    <transform name="to_world">
+                        <translate x="{offset}"/>
+                    </transform>
+                </shape>
+                <emitter type="constant"/>
+            </scene>""")
+        return xml_path
+
+    updater = mi.SceneUpdater(write())
+    scene = updater.scene()
+    shapes = { s.id(): s for s in scene.shapes() }
+    assert updater.update_file(write()) == []
+
+    # Inline textures are updated in place
+    changed = updater.update_file(write(albedo=0.25))
+    assert 'my_bsdf' in changed and 'my_cube' not in changed
+    assert updater.scene().ptr == scene.ptr
+    params = mi.traverse(scene)
+    key = [k for k in params.keys() if k.endswith('reflectance.value')][0]
+    assert dr.allclose(params[key], 0.25)
+
+    # Meshes receive new vertex positions, the scene updates its bounds
+    changed = updater.update_file(write(albedo=0.25, offset=10))
+    assert 'my_cube' in changed and 'my_bsdf' not in changed
+    assert updater.scene().ptr == scene.ptr
+    assert dr.allclose(scene.bbox().max, [11, 1, 1])
+
+    # A different plugin re-creates the shape and the scene
+    changed = updater.update('my_sphere', mi.Properties('disk'))
+    assert 'my_sphere' in changed
+    scene2 = updater.scene()
+    assert scene2.ptr != scene.ptr
+    shapes2 = { s.id(): s for s in scene2.shapes() }
+    assert shapes2['my_sphere'].class_().name() == 'Disk'
+    assert shapes2['my_sphere'].bsdf().ptr == shapes['my_sphere'].bsdf().ptr
+    assert shapes2['my_cube'].ptr == shapes['my_cube'].ptr
+
+    with pytest.raises(Exception) as e:
+        updater.update('my_unknown', mi.Properties())
+    e.match('unknown object')
+
+
+def test35_tensor_file(variants_all_rgb, tmp_path):
+    import numpy as np
+
+    data = np.arange(2 * 3 * 4, dtype=np.float32).reshape(2, 3, 4, 1)
+    path = str(tmp_path / 'density.npy')
+    np.save(path, data)
+
+    scene = mi.load_string(f"""
+        <volume version="3.0.0" type="gridvolume">
+            <boolean name="raw" value="true"/>
+            <tensor name="data" filename="{path}"/>
+        </volume>
+    """)
+    params = mi.traverse(scene)
+    assert dr.allclose(params['data'], data)
+
+    # Other data types are converted while loading
+    np.save(path, data.astype(np.float64))
+    volume = mi.load_dict({
+        'type': 'gridvolume',
+        'raw': True,
+        'data': {'type': 'tensor', 'filename': path}
+    })
+    assert dr.allclose(mi.traverse(volume)['data'], data)
+
+    with pytest.raises(Exception) as e:
+        mi.load_string(f"""
+            <volume version="3.0.0" type="gridvolume">
+                <tensor name="data" filename="{path}" field="unknown"/>
+            </volume>
+        """)
+    e.match('not found')
+
+
+@pytest.mark.parametrize('parallel', [False, True])
+def test36_streaming(variant_scalar_rgb, tmp_path, parallel):
+    xml_path = str(tmp_path / 'scene.xml')
+
+    with open(xml_path, 'w') as f:
+        f.write("""<?xml version="1.0"?>
+        <!-- A comment containing a <tag> -->
+        <scene version="3.0.0" id="my_scene">
+            <default name="radius" value="2"/>
+            <!-- <shape type="sphere"/> -->
+            <shape type="sphere">
+                <float name="radius" value="$radius"/>
+                <ref id="my_bsdf"/>
+            </shape>
+            <bsdf type="diffuse" id="my_bsdf">
+                <rgb name="reflectance" value="0.2, 0.4, 0.6"/>
+            </bsdf>
+            <alias id="my_bsdf" as="my_alias"/>
+        """)
+        for i in range(1000):
+            f.write(f"""
+            <shape type="sphere" id="sphere_{i}">
+                <point name="center" x="{i}" y="0" z="0"/>
+                <float name="radius" value='0.25'/>
+                <ref id="my_alias"/>
+            </shape>""")
+        f.write("""
+            <emitter type="constant"/>
+        </scene>""")
+
+    scene_ref = mi.load_file(xml_path, parallel=parallel, radius=3)
+    scene = mi.load_file(xml_path, parallel=parallel, streaming=True, radius=3)
+
+    params_ref = mi.traverse(scene_ref)
+    params = mi.traverse(scene)
+    assert set(params.keys()) == set(params_ref.keys())
+    for k in params.keys():
+        assert dr.allclose(params[k], params_ref[k])
+    assert dr.allclose(scene.bbox().max, scene_ref.bbox().max)
+
+    with open(xml_path, 'w') as f:
+        f.write("""<scene version="3.0.0">
+            <shape type="sphere">
+                <ref id="my_bsdf"/>
+            </shape>""")
+
+    with pytest.raises(Exception) as e:
+        mi.load_file(xml_path, parallel=parallel, streaming=True)
+    e.match('unexpected end of file')
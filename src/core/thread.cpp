@@ -32,6 +32,8 @@ static __declspec(thread) int this_thread_id;
 #endif
 static std::mutex task_mutex;
 static std::vector<Task *> registered_tasks;
+static std::atomic<bool> pin_threads { false };
+static thread_local int pinned_numa_node = -1;
 
 #if defined(_MSC_VER)
 namespace {
@@ -544,8 +546,83 @@ void Thread::set_thread_count(size_t count) {
     global_thread_count = count;
     // Main thread counts as one thread
     pool_set_size(nullptr, (uint32_t) (count - 1));
+
+    // Newly created workers don't inherit the placement of previous ones
+    if (pin_threads)
+        pin_worker_threads();
+}
+
+/// Restrict the calling thread to a single core, returns 'false' on failure
+static bool pin_current_thread(int core) {
+#if defined(__linux__)
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(core, &cpuset);
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset) == 0;
+#elif defined(_WIN32)
+    return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR) 1 << core) != 0;
+#else
+    /* CPU affinity not supported on OSX */
+    (void) core;
+    return false;
+#endif
+}
+
+void Thread::pin_worker_threads() {
+    pin_threads = true;
+
+    uint32_t worker_count = pool_size(nullptr);
+    if (worker_count == 0)
+        return;
+
+    /* Compact placement: fill the cores of one NUMA node before moving on to
+       the next one, so that the workers of small pools share a memory
+       controller and larger pools split into per-node groups. */
+    std::vector<std::pair<int, int>> slots; // (core, NUMA node)
+    std::vector<std::vector<int>> topology = util::numa_topology();
+    for (size_t node = 0; node < topology.size(); ++node)
+        for (int core : topology[node])
+            slots.emplace_back(core, (int) node);
+
+    /* nanothread doesn't expose its workers, so submit one more work unit
+       than there are workers and let every unit wait until all of them have
+       started. Each worker thus receives exactly one unit even if the
+       calling thread participates, which it does not pin. */
+    std::thread::id caller = std::this_thread::get_id();
+    std::atomic<uint32_t> arrived { 0 }, pinned { 0 }, failed { 0 };
+    uint32_t unit_count = worker_count + 1;
+
+    dr::parallel_for(
+        dr::blocked_range<uint32_t>(0, unit_count, 1),
+        [&](const dr::blocked_range<uint32_t> &) {
+            arrived++;
+            auto deadline = std::chrono::steady_clock::now() +
+                            std::chrono::milliseconds(500);
+            while (arrived < unit_count &&
+                   std::chrono::steady_clock::now() < deadline)
+                std::this_thread::yield();
+
+            if (std::this_thread::get_id() == caller || pinned_numa_node != -1)
+                return;
+
+            const auto &[core, node] = slots[pinned++ % slots.size()];
+            if (pin_current_thread(core))
+                pinned_numa_node = node;
+            else
+                failed++;
+        }
+    );
+
+    if (failed > 0)
+        Log(Warn, "Thread::pin_worker_threads(): could not set the affinity "
+                  "of %u worker threads.", (uint32_t) failed);
+    else
+        Log(Debug, "Pinned %u worker threads to cores on %zu NUMA node%s.",
+            (uint32_t) pinned, topology.size(), topology.size() > 1 ? "s" : "");
 }
 
+int Thread::numa_node() { return pinned_numa_node; }
+
 ThreadEnvironment::ThreadEnvironment() {
     Thread *thread = Thread::thread();
     Assert(thread);
@@ -0,0 +1,487 @@
+#include <mitsuba/core/tilecache.h>
+#include <mitsuba/core/bitmap.h>
+#include <mitsuba/core/hash.h>
+#include <mitsuba/core/logger.h>
+#include <mitsuba/core/profiler.h>
+#include <mitsuba/core/util.h>
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#if defined(_MSC_VER)
+#  pragma warning(push)
+#  pragma warning(disable : 4267) // conversion from 'size_t' to 'int', possible loss of data
+#endif
+
+#include <ImfInputFile.h>
+#include <ImfTiledInputFile.h>
+#include <ImfChannelList.h>
+#include <ImfFrameBuffer.h>
+#include <ImfHeader.h>
+#include <ImfTestFile.h>
+#include <ImathBox.h>
+
+#if defined(_MSC_VER)
+#  pragma warning(pop)
+#endif
+
+NAMESPACE_BEGIN(mitsuba)
+
+// -----------------------------------------------------------------------------
+//   TiledImage
+// -----------------------------------------------------------------------------
+
+static std::atomic<uint64_t> tiled_image_uid { 0 };
+
+struct TiledImage::TiledImagePrivate {
+    enum class Kind { TiledEXR, ScanlineEXR, Bitmap };
+
+    fs::path filename;
+    ScalarVector2u size;
+    uint32_t channel_count;
+    uint32_t tile_size;
+    bool raw;
+    uint64_t uid;
+    Kind kind;
+
+    /// Names of the EXR channels that are read
+    std::vector<std::string> channels;
+    /// Offset of the EXR data window
+    ScalarVector2i offset;
+
+    /// OpenEXR files are not thread-safe, serialize accesses
+    std::mutex mutex;
+    std::unique_ptr<Imf::TiledInputFile> tiled_file;
+    std::unique_ptr<Imf::InputFile> scanline_file;
+
+    /// Decode other formats into a float32 bitmap of 1 or 3 channels
+    ref<Bitmap> decode_bitmap() const {
+        ref<Bitmap> bitmap = new Bitmap(filename);
+        Bitmap::PixelFormat pixel_format;
+        switch (bitmap->pixel_format()) {
+            case Bitmap::PixelFormat::Y:
+            case Bitmap::PixelFormat::YA:
+                pixel_format = Bitmap::PixelFormat::Y;
+                break;
+
+            case Bitmap::PixelFormat::RGB:
+            case Bitmap::PixelFormat::RGBA:
+            case Bitmap::PixelFormat::XYZ:
+            case Bitmap::PixelFormat::XYZA:
+                pixel_format = Bitmap::PixelFormat::RGB;
+                break;
+
+            default:
+                Throw("TiledImage: \"%s\" needs to have a known pixel format "
+                      "(Y[A], RGB[A], XYZ[A] are supported).",
+                      filename.string());
+        }
+
+        if (raw)
+            bitmap->set_srgb_gamma(false);
+        return bitmap->convert(pixel_format, Struct::Type::Float32, false);
+    }
+
+    ScalarVector2u tile_resolution(uint32_t tx, uint32_t ty) const {
+        ScalarVector2u start(tx * tile_size, ty * tile_size);
+        return dr::minimum(size - start, tile_size);
+    }
+
+    /// Copy a tile out of a buffer of 'width' texels per row
+    ImageTile extract(const float *buffer, uint32_t width, uint32_t tx,
+                      uint32_t ty, uint32_t row_offset) const {
+        ImageTile tile;
+        tile.size = tile_resolution(tx, ty);
+        tile.channel_count = channel_count;
+        tile.data = std::unique_ptr<float[]>(
+            new float[(size_t) dr::prod(tile.size) * channel_count]);
+
+        size_t row_size = (size_t) tile.size.x() * channel_count;
+        for (uint32_t y = 0; y < tile.size.y(); ++y) {
+            const float *src = buffer + ((size_t) (ty * tile_size + y - row_offset) * width +
+                                         tx * tile_size) * channel_count;
+            memcpy(tile.data.get() + y * row_size, src, row_size * sizeof(float));
+        }
+        return tile;
+    }
+
+    /// Create an OpenEXR frame buffer that maps the given texel window
+    Imf::FrameBuffer frame_buffer(float *data, const ScalarVector2i &min,
+                                  uint32_t width) {
+        size_t x_stride = channel_count * sizeof(float),
+               y_stride = x_stride * width;
+        char *base = (char *) data - (ptrdiff_t) min.x() * x_stride -
+                     (ptrdiff_t) min.y() * y_stride;
+
+        Imf::FrameBuffer fb;
+        for (uint32_t c = 0; c < channel_count; ++c)
+            fb.insert(channels[c], Imf::Slice(Imf::FLOAT, base + c * sizeof(float),
+                                              x_stride, y_stride));
+        return fb;
+    }
+};
+
+TiledImage::TiledImage(const fs::path &filename, uint32_t tile_size, bool raw)
+    : d(new TiledImagePrivate()) {
+    if (tile_size == 0)
+        Throw("TiledImage: the tile size must be positive!");
+    if (!fs::exists(filename))
+        Throw("TiledImage: file \"%s\" does not exist!", filename.string());
+
+    d->filename  = filename;
+    d->tile_size = tile_size;
+    d->raw       = raw;
+    d->uid       = tiled_image_uid++;
+    d->offset    = 0;
+
+    bool is_tiled = false;
+    if (Imf::isOpenExrFile(filename.string().c_str(), is_tiled)) {
+        try {
+            const Imf::Header *header;
+            if (is_tiled) {
+                d->kind = TiledImagePrivate::Kind::TiledEXR;
+                d->tiled_file = std::make_unique<Imf::TiledInputFile>(
+                    filename.string().c_str());
+                header = &d->tiled_file->header();
+                d->tile_size = d->tiled_file->tileXSize();
+                if (d->tiled_file->tileYSize() != d->tile_size)
+                    Throw("TiledImage: \"%s\" uses non-square tiles (%ix%i), "
+                          "which are not supported!", filename.string(),
+                          d->tiled_file->tileXSize(), d->tiled_file->tileYSize());
+            } else {
+                d->kind = TiledImagePrivate::Kind::ScanlineEXR;
+                d->scanline_file = std::make_unique<Imf::InputFile>(
+                    filename.string().c_str());
+                header = &d->scanline_file->header();
+            }
+
+            const Imf::ChannelList &channels = header->channels();
+            if (channels.findChannel("R") && channels.findChannel("G") &&
+                channels.findChannel("B"))
+                d->channels = { "R", "G", "B" };
+            else if (channels.findChannel("Y"))
+                d->channels = { "Y" };
+            else if (channels.begin() != channels.end() &&
+                     ++channels.begin() == channels.end())
+                d->channels = { channels.begin().name() };
+            else
+                Throw("TiledImage: \"%s\" must either provide R, G, B, or Y "
+                      "channels, or a single channel!", filename.string());
+
+            const Imath::Box2i &dw = header->dataWindow();
+            d->offset = ScalarVector2i(dw.min.x, dw.min.y);
+            d->size = ScalarVector2u(dw.max.x - dw.min.x + 1,
+                                     dw.max.y - dw.min.y + 1);
+        } catch (const std::exception &e) {
+            Throw("TiledImage: could not open \"%s\": %s", filename.string(),
+                  e.what());
+        }
+    } else {
+        // The size is only known after decoding the entire image once
+        d->kind = TiledImagePrivate::Kind::Bitmap;
+        ref<Bitmap> bitmap = d->decode_bitmap();
+        d->size = bitmap->size();
+        d->channels.resize(bitmap->channel_count());
+    }
+
+    d->channel_count = (uint32_t) d->channels.size();
+    Log(Debug, "Opened tiled image \"%s\" (%ix%i, %i channel(s), %ix%i tiles)",
+        filename.filename().string(), d->size.x(), d->size.y(),
+        d->channel_count, d->tile_size, d->tile_size);
+}
+
+TiledImage::~TiledImage() { }
+
+const ScalarVector2u &TiledImage::size() const { return d->size; }
+uint32_t TiledImage::channel_count() const { return d->channel_count; }
+uint32_t TiledImage::tile_size() const { return d->tile_size; }
+uint64_t TiledImage::uid() const { return d->uid; }
+const fs::path &TiledImage::filename() const { return d->filename; }
+
+ScalarVector2u TiledImage::tile_count() const {
+    return (d->size + d->tile_size - 1u) / d->tile_size;
+}
+
+void TiledImage::read_tile(uint32_t tx, uint32_t ty,
+                           const TileCallback &callback) const {
+    ScopedPhase phase(ProfilerPhase::BitmapRead);
+    ScalarVector2u count = tile_count();
+    if (tx >= count.x() || ty >= count.y())
+        Throw("TiledImage::read_tile(): tile (%i, %i) is out of bounds!", tx, ty);
+
+    const uint32_t ts = d->tile_size, channels = d->channel_count;
+
+    switch (d->kind) {
+        case TiledImagePrivate::Kind::TiledEXR: {
+                ImageTile tile;
+                tile.size = d->tile_resolution(tx, ty);
+                tile.channel_count = channels;
+                tile.data = std::unique_ptr<float[]>(
+                    new float[(size_t) dr::prod(tile.size) * channels]);
+
+                ScalarVector2i min = d->offset + ScalarVector2i(tx * ts, ty * ts);
+                std::lock_guard<std::mutex> guard(d->mutex);
+                d->tiled_file->setFrameBuffer(
+                    d->frame_buffer(tile.data.get(), min, tile.size.x()));
+                d->tiled_file->readTile((int) tx, (int) ty);
+                callback(tx, ty, std::move(tile));
+            }
+            break;
+
+        case TiledImagePrivate::Kind::ScanlineEXR: {
+                // Decode the entire band of rows containing the tile
+                uint32_t rows = dr::minimum(ts, d->size.y() - ty * ts),
+                         width = d->size.x();
+                std::unique_ptr<float[]> band(
+                    new float[(size_t) rows * width * channels]);
+                {
+                    ScalarVector2i min = d->offset + ScalarVector2i(0, ty * ts);
+                    std::lock_guard<std::mutex> guard(d->mutex);
+                    d->scanline_file->setFrameBuffer(
+                        d->frame_buffer(band.get(), min, width));
+                    d->scanline_file->readPixels(min.y(), min.y() + (int) rows - 1);
+                }
+
+                for (uint32_t i = 0; i < count.x(); ++i) {
+                    if (i != tx)
+                        callback(i, ty, d->extract(band.get(), width, i, ty, ty * ts));
+                }
+                callback(tx, ty, d->extract(band.get(), width, tx, ty, ty * ts));
+            }
+            break;
+
+        case TiledImagePrivate::Kind::Bitmap: {
+                ref<Bitmap> bitmap = d->decode_bitmap();
+                const float *data = (const float *) bitmap->data();
+                for (uint32_t j = 0; j < count.y(); ++j) {
+                    for (uint32_t i = 0; i < count.x(); ++i) {
+                        if (i != tx || j != ty)
+                            callback(i, j, d->extract(data, d->size.x(), i, j, 0));
+                    }
+                }
+                callback(tx, ty, d->extract(data, d->size.x(), tx, ty, 0));
+            }
+            break;
+    }
+}
+
+std::string TiledImage::to_string() const {
+    std::ostringstream oss;
+    oss << "TiledImage[" << std::endl
+        << "  filename = \"" << d->filename.string() << "\"," << std::endl
+        << "  size = " << d->size << "," << std::endl
+        << "  channel_count = " << d->channel_count << "," << std::endl
+        << "  tile_size = " << d->tile_size << std::endl
+        << "]";
+    return oss.str();
+}
+
+// -----------------------------------------------------------------------------
+//   TileCache
+// -----------------------------------------------------------------------------
+
+namespace {
+    /// A tile held by the cache, along with its second-chance flag
+    struct CacheEntry {
+        ImageTile tile;
+        std::atomic<bool> referenced { false };
+    };
+
+    struct TileKey {
+        uint64_t uid;
+        uint32_t index;
+
+        bool operator==(const TileKey &other) const {
+            return uid == other.uid && index == other.index;
+        }
+    };
+
+    struct TileKeyHasher {
+        size_t operator()(const TileKey &key) const {
+            return hash_combine(std::hash<uint64_t>()(key.uid),
+                                std::hash<uint32_t>()(key.index));
+        }
+    };
+
+    /// Slot of the per-thread direct-mapped cache
+    struct ThreadSlot {
+        TileKey key { (uint64_t) -1, 0 };
+        uint64_t epoch = 0;
+        std::shared_ptr<CacheEntry> entry;
+    };
+
+    constexpr size_t ThreadCacheSize = 64;
+}
+
+struct TileCache::TileCachePrivate {
+    using LRUList = std::list<std::shared_ptr<CacheEntry>>;
+
+    mutable std::mutex mutex;
+    /// Most recently used tiles are at the front
+    LRUList lru;
+    std::unordered_map<TileKey, LRUList::iterator, TileKeyHasher> map;
+    std::unordered_map<const CacheEntry *, TileKey> keys;
+
+    size_t budget = (size_t) 1 << 30;
+    size_t resident_bytes = 0;
+
+    /// Incremented by clear() to invalidate the per-thread caches
+    std::atomic<uint64_t> epoch { 1 };
+
+    std::atomic<size_t> hits { 0 }, misses { 0 }, evictions { 0 };
+
+    /// Evict tiles until the budget is met (requires 'mutex' to be held)
+    void shrink() {
+        // Every tile receives at most one second chance per pass
+        size_t visits = 2 * lru.size();
+        while (resident_bytes > budget && lru.size() > 1 && visits-- > 0) {
+            auto it = std::prev(lru.end());
+            std::shared_ptr<CacheEntry> entry = *it;
+            if (entry->referenced.exchange(false)) {
+                lru.splice(lru.begin(), lru, it);
+                continue;
+            }
+            resident_bytes -= entry->tile.bytes();
+            auto key_it = keys.find(entry.get());
+            map.erase(key_it->second);
+            keys.erase(key_it);
+            lru.erase(it);
+            evictions++;
+        }
+    }
+
+    /// Insert a decoded tile (requires 'mutex' to be held)
+    std::shared_ptr<CacheEntry> insert(const TileKey &key, ImageTile &&tile) {
+        auto it = map.find(key);
+        if (it != map.end()) {
+            // Another thread decoded the same tile in the meantime
+            lru.splice(lru.begin(), lru, it->second);
+            return *it->second;
+        }
+        auto entry = std::make_shared<CacheEntry>();
+        entry->tile = std::move(tile);
+        resident_bytes += entry->tile.bytes();
+        lru.push_front(entry);
+        map.emplace(key, lru.begin());
+        keys.emplace(entry.get(), key);
+        return entry;
+    }
+};
+
+static thread_local ThreadSlot tile_cache_slots[ThreadCacheSize];
+
+TileCache::TileCache() : d(new TileCachePrivate()) { }
+TileCache::~TileCache() { }
+
+TileCache *TileCache::instance() {
+    static ref<TileCache> cache = new TileCache();
+    return cache.get();
+}
+
+TileCache::TilePtr TileCache::tile(const TiledImage *image, uint32_t tx,
+                                   uint32_t ty) {
+    TileKey key { image->uid(), ty * image->tile_count().x() + tx };
+    ThreadSlot &slot =
+        tile_cache_slots[TileKeyHasher()(key) % ThreadCacheSize];
+    uint64_t epoch = d->epoch.load(std::memory_order_relaxed);
+
+    // Fast path: lock-free lookup in the per-thread cache
+    if (slot.entry && slot.key == key && slot.epoch == epoch) {
+        slot.entry->referenced.store(true, std::memory_order_relaxed);
+        d->hits++;
+        return TilePtr(slot.entry, &slot.entry->tile);
+    }
+
+    std::shared_ptr<CacheEntry> entry;
+    {
+        std::lock_guard<std::mutex> guard(d->mutex);
+        auto it = d->map.find(key);
+        if (it != d->map.end()) {
+            d->lru.splice(d->lru.begin(), d->lru, it->second);
+            entry = *it->second;
+            d->hits++;
+        }
+    }
+
+    if (!entry) {
+        // Decode without holding the lock, other threads may still proceed
+        d->misses++;
+        std::vector<std::pair<uint32_t, ImageTile>> tiles;
+        image->read_tile(tx, ty, [&](uint32_t i, uint32_t j, ImageTile &&t) {
+            tiles.emplace_back(j * image->tile_count().x() + i, std::move(t));
+        });
+
+        std::lock_guard<std::mutex> guard(d->mutex);
+        // The requested tile comes last and thus ends up most recently used
+        for (auto &[index, t] : tiles)
+            entry = d->insert(TileKey{ key.uid, index }, std::move(t));
+        d->shrink();
+    }
+
+    slot.key = key;
+    slot.epoch = epoch;
+    slot.entry = entry;
+    return TilePtr(entry, &entry->tile);
+}
+
+void TileCache::set_budget(size_t bytes) {
+    std::lock_guard<std::mutex> guard(d->mutex);
+    d->budget = bytes;
+    d->shrink();
+}
+
+size_t TileCache::budget() const {
+    std::lock_guard<std::mutex> guard(d->mutex);
+    return d->budget;
+}
+
+TileCache::Statistics TileCache::statistics() const {
+    std::lock_guard<std::mutex> guard(d->mutex);
+    Statistics stats;
+    stats.hits           = d->hits;
+    stats.misses         = d->misses;
+    stats.evictions      = d->evictions;
+    stats.resident_tiles = d->lru.size();
+    stats.resident_bytes = d->resident_bytes;
+    stats.budget         = d->budget;
+    return stats;
+}
+
+void TileCache::reset_statistics() {
+    d->hits = 0;
+    d->misses = 0;
+    d->evictions = 0;
+}
+
+void TileCache::clear() {
+    std::lock_guard<std::mutex> guard(d->mutex);
+    d->lru.clear();
+    d->map.clear();
+    d->keys.clear();
+    d->resident_bytes = 0;
+    d->epoch++;
+}
+
+std::string TileCache::to_string() const {
+    Statistics stats = statistics();
+    size_t lookups = stats.hits + stats.misses;
+    std::ostringstream oss;
+    oss << "TileCache[" << std::endl
+        << "  budget = " << util::mem_string(stats.budget) << "," << std::endl
+        << "  resident = " << stats.resident_tiles << " tiles ("
+        << util::mem_string(stats.resident_bytes) << ")," << std::endl
+        << "  hits = " << stats.hits << "," << std::endl
+        << "  misses = " << stats.misses << "," << std::endl
+        << "  hit_rate = "
+        << (lookups > 0 ? 100.0 * (double) stats.hits / (double) lookups : 0.0)
+        << "%," << std::endl
+        << "  evictions = " << stats.evictions << std::endl
+        << "]";
+    return oss.str();
+}
+
+MI_IMPLEMENT_CLASS(TiledImage, Object)
+MI_IMPLEMENT_CLASS(TileCache, Object)
+
+NAMESPACE_END(mitsuba)
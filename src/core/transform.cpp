@@ -1,11 +1,52 @@
 #include <mitsuba/core/transform.h>
 #include <mitsuba/core/bbox.h>
+#include <mitsuba/core/string.h>
 
 NAMESPACE_BEGIN(mitsuba)
 
-// WARNING: the AnimatedTransform class is outdated and dysfunctional with the
-// latest version of Mitsuba 3. Please update this code before using it!
-#if 0
+using Keyframe = AnimatedTransform::Keyframe;
+
+/**
+ * Decompose a transformation into a translation vector, a rotation
+ * quaternion, and an upper triangular scale/shear matrix (i.e. T * R * S).
+ * The latter two are obtained via Gram-Schmidt orthogonalization of the
+ * columns of the linear part (QR decomposition).
+ */
+static Keyframe decompose(float time, const AnimatedTransform::Transform4f &trafo) {
+    using Matrix3f = AnimatedTransform::Matrix3f;
+    using Vector3f = AnimatedTransform::Vector3f;
+
+    Vector3f c[3], q[3];
+    for (size_t j = 0; j < 3; ++j)
+        c[j] = dr::head<3>(trafo.matrix.entry(j));
+
+    Matrix3f scale = dr::zeros<Matrix3f>();
+    for (size_t j = 0; j < 3; ++j) {
+        Vector3f u = c[j];
+        for (size_t i = 0; i < j; ++i) {
+            scale(i, j) = dr::dot(q[i], c[j]);
+            u -= scale(i, j) * q[i];
+        }
+        scale(j, j) = dr::norm(u);
+        if (!(scale(j, j) > 0.f))
+            Throw("AnimatedTransform::append(): the transformation is singular!");
+        q[j] = u / scale(j, j);
+    }
+
+    // Ensure that the orthogonal factor is a proper rotation
+    if (dr::dot(dr::cross(q[0], q[1]), q[2]) < 0.f) {
+        q[2] = -q[2];
+        scale(2, 2) = -scale(2, 2);
+    }
+
+    Matrix3f rot;
+    for (size_t i = 0; i < 3; ++i)
+        for (size_t j = 0; j < 3; ++j)
+            rot(i, j) = q[j][i];
+
+    return Keyframe(time, scale, dr::matrix_to_quat(rot),
+                    dr::head<3>(trafo.matrix.entry(3)));
+}
 
 AnimatedTransform::~AnimatedTransform() { }
 
@@ -14,11 +55,19 @@ void AnimatedTransform::append(const Keyframe &keyframe) {
         Throw("AnimatedTransform::append(): time values must be "
               "strictly monotonically increasing!");
 
+    Keyframe k = keyframe;
+
+    // Ensure that the rotation is interpolated along the shorter arc
+    if (!m_keyframes.empty() && dr::dot(m_keyframes.back().quat, k.quat) < 0.f)
+        k.quat = -k.quat;
+
     if (m_keyframes.empty())
-        m_transform = Transform4f(dr::transform_compose<Matrix4f>(
-            keyframe.scale, keyframe.quat, keyframe.trans));
+        m_transform = Transform4f(
+            dr::transform_compose<Matrix4f>(k.scale, k.quat, k.trans),
+            dr::transpose(dr::transform_compose_inverse<Matrix4f>(
+                k.scale, k.quat, k.trans)));
 
-    m_keyframes.push_back(keyframe);
+    m_keyframes.push_back(k);
 }
 
 void AnimatedTransform::append(Float time, const Transform4f &trafo) {
@@ -26,15 +75,56 @@ void AnimatedTransform::append(Float time, const Transform4f &trafo) {
         Throw("AnimatedTransform::append(): time values must be "
               "strictly monotonically increasing!");
 
-    /* Perform a polar decomposition into a 3x3 scale/shear matrix,
-       a rotation quaternion, and a translation vector. These will
-       all be interpolated independently. */
-    auto [M, Q, T] = dr::transform_decompose(trafo.matrix);
+    append(decompose(time, trafo));
+}
 
+Keyframe AnimatedTransform::interpolate(Float time) const {
     if (m_keyframes.empty())
-        m_transform = trafo;
+        return decompose(time, m_transform);
+
+    if (m_keyframes.size() == 1) {
+        Keyframe k = m_keyframes[0];
+        k.time = time;
+        return k;
+    }
+
+    size_t first = 0;
+    while (first + 2 < m_keyframes.size() && time >= m_keyframes[first + 1].time)
+        first++;
 
-    m_keyframes.push_back(Keyframe { time, M, Q, T });
+    const Keyframe &k0 = m_keyframes[first], &k1 = m_keyframes[first + 1];
+    Float t = dr::clamp((time - k0.time) / (k1.time - k0.time), 0.f, 1.f);
+
+    return Keyframe(time, k0.scale * (1.f - t) + k1.scale * t,
+                    dr::slerp(k0.quat, k1.quat, t),
+                    dr::fmadd(k1.trans - k0.trans, t, k0.trans));
+}
+
+std::vector<Keyframe> AnimatedTransform::resample(size_t max_keys) const {
+    if (m_keyframes.size() <= 1)
+        return { interpolate(m_keyframes.empty() ? 0.f : m_keyframes[0].time) };
+
+    Float start = m_keyframes.front().time,
+          end   = m_keyframes.back().time,
+          min_gap = dr::Infinity<Float>;
+
+    for (size_t i = 0; i + 1 < m_keyframes.size(); ++i)
+        min_gap = dr::minimum(min_gap, m_keyframes[i + 1].time - m_keyframes[i].time);
+
+    // Tolerate round-off when the keyframes are uniformly spaced
+    size_t segments = (size_t) dr::ceil((end - start) / min_gap - 1e-3f);
+    segments = std::max(std::min(segments, std::max(max_keys, (size_t) 2) - 1),
+                        (size_t) 1);
+
+    std::vector<Keyframe> result;
+    result.reserve(segments + 1);
+    for (size_t i = 0; i <= segments; ++i) {
+        Float time = i == segments
+            ? end : dr::fmadd(end - start, (Float) i / (Float) segments, start);
+        result.push_back(interpolate(time));
+    }
+
+    return result;
 }
 
 bool AnimatedTransform::has_scale() const {
@@ -52,8 +142,12 @@ typename AnimatedTransform::BoundingBox3f AnimatedTransform::translation_bounds(
         auto p = m_transform * Point3f(0.f);
         return BoundingBox3f(p, p);
     }
-    Throw("AnimatedTransform::translation_bounds() not implemented for"
-          " non-constant animation.");
+
+    // Translations are interpolated linearly, hence the keyframes suffice
+    BoundingBox3f result;
+    for (auto const &k: m_keyframes)
+        result.expand(Point3f(k.trans));
+    return result;
 }
 
 std::string AnimatedTransform::to_string() const {
@@ -82,6 +176,5 @@ std::ostream &operator<<(std::ostream &os, const AnimatedTransform &t) {
 }
 
 MI_IMPLEMENT_CLASS(AnimatedTransform, Object)
-#endif
 
 NAMESPACE_END(mitsuba)
@@ -5,12 +5,14 @@
 #include <mitsuba/core/string.h>
 #include <mitsuba/core/filesystem.h>
 #include <mitsuba/core/vector.h>
+#include <fstream>
 
 #if defined(__linux__)
 #  if !defined(_GNU_SOURCE)
 #    define _GNU_SOURCE
 #  endif
 #  include <dlfcn.h>
+#  include <sched.h>
 #  include <unistd.h>
 #  include <limits.h>
 #  include <sys/ioctl.h>
@@ -120,6 +122,52 @@ done:
 #endif
 }
 
+std::vector<std::vector<int>> numa_topology() {
+    std::vector<std::vector<int>> result;
+
+#if defined(__linux__)
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    bool has_affinity = sched_getaffinity(0, sizeof(cpu_set_t), &cpuset) == 0;
+
+    for (int node = 0; ; ++node) {
+        std::string fname =
+            tfm::format("/sys/devices/system/node/node%i/cpulist", node);
+        std::ifstream is(fname);
+        if (!is.good())
+            break;
+
+        // Parse a list of ranges, e.g. "0-15,32-47"
+        std::string line;
+        std::getline(is, line);
+        std::vector<int> cores;
+        for (const std::string &range : string::tokenize(line, ",")) {
+            auto bounds = string::tokenize(range, "-");
+            if (bounds.empty())
+                continue;
+            int first = std::stoi(bounds[0]),
+                last  = bounds.size() > 1 ? std::stoi(bounds[1]) : first;
+            for (int core = first; core <= last; ++core) {
+                if (!has_affinity || core >= CPU_SETSIZE || CPU_ISSET(core, &cpuset))
+                    cores.push_back(core);
+            }
+        }
+
+        if (!cores.empty())
+            result.push_back(std::move(cores));
+    }
+#endif
+
+    if (result.empty()) {
+        std::vector<int> cores(core_count());
+        for (size_t i = 0; i < cores.size(); ++i)
+            cores[i] = (int) i;
+        result.push_back(std::move(cores));
+    }
+
+    return result;
+}
+
 bool detect_debugger() {
 #if defined(__linux__)
     char exePath[PATH_MAX];
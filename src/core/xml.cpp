@@ -1,9 +1,12 @@
 #include <cctype>
+#include <cstring>
 #include <fstream>
 #include <set>
 #include <unordered_map>
+#include <unordered_set>
 #include <mutex>
 #include <map>
+#include <sstream>
 
 #include <mitsuba/core/class.h>
 #include <mitsuba/core/config.h>
@@ -11,11 +14,13 @@
 #include <mitsuba/core/fresolver.h>
 #include <mitsuba/core/logger.h>
 #include <mitsuba/core/math.h>
+#include <mitsuba/core/mmap.h>
 #include <mitsuba/core/object.h>
 #include <mitsuba/core/plugin.h>
 #include <mitsuba/core/profiler.h>
 #include <mitsuba/core/spectrum.h>
 #include <mitsuba/core/string.h>
+#include <mitsuba/core/tensor.h>
 #include <mitsuba/core/transform.h>
 #include <mitsuba/core/vector.h>
 #include <mitsuba/core/xml.h>
@@ -39,8 +44,8 @@ using Version = util::Version;
 
 // Set of supported XML tags
 enum class Tag {
-    Boolean, Integer, Float, String, Point, Vector, Spectrum, RGB,
-    Transform, Translate, Matrix, Rotate, Scale, LookAt, Object,
+    Boolean, Integer, Float, String, Point, Vector, Spectrum, RGB, Tensor,
+    Transform, Animation, Translate, Matrix, Rotate, Scale, LookAt, Object,
     NamedReference, Include, Alias, Default, Resource, Invalid
 };
 
@@ -92,6 +97,7 @@ void register_class(const Class *class_) {
         (*tags)["point"]         = Tag::Point;
         (*tags)["vector"]        = Tag::Vector;
         (*tags)["transform"]     = Tag::Transform;
+        (*tags)["animation"]     = Tag::Animation;
         (*tags)["translate"]     = Tag::Translate;
         (*tags)["matrix"]        = Tag::Matrix;
         (*tags)["rotate"]        = Tag::Rotate;
@@ -100,6 +106,7 @@ void register_class(const Class *class_) {
         (*tags)["ref"]           = Tag::NamedReference;
         (*tags)["spectrum"]      = Tag::Spectrum;
         (*tags)["rgb"]           = Tag::RGB;
+        (*tags)["tensor"]        = Tag::Tensor;
         (*tags)["include"]       = Tag::Include;
         (*tags)["alias"]         = Tag::Alias;
         (*tags)["default"]       = Tag::Default;
@@ -192,6 +199,15 @@ struct XMLObject {
     uint32_t scope = 0;
 };
 
+/// Records how a texture created by an <rgb> or <spectrum> tag can be rebuilt
+struct CompiledTexture {
+    bool spectrum = false;
+    bool within_emitter = false;
+    Color3f color;
+    Float const_value = 1;
+    std::vector<Float> wavelengths, values;
+};
+
 enum class ColorMode {
     Monochromatic,
     RGB,
@@ -216,10 +232,36 @@ struct XMLParseContext {
 
     std::unordered_map<std::string, XMLObject> instances;
     Transform4f transform;
+    /// Animated transformation of the enclosing <animation> element
+    ref<AnimatedTransform> animation;
     ColorMode color_mode;
     uint32_t id_counter = 0;
     uint32_t backend = 0;
 
+    /// When compiling a scene, records the origin of all parsed textures
+    std::unordered_map<const Object *, CompiledTexture> *textures = nullptr;
+
+    /// Instantiate structurally identical anonymous BSDFs and textures once?
+    bool deduplicate = false;
+    /// Maps the structural key of anonymous objects to their (first) id
+    std::unordered_map<std::string, std::string> dedup_ids;
+    /// Maps the description of <rgb> and <spectrum> tags to their texture
+    std::unordered_map<std::string, ref<Object>> dedup_textures;
+    /// Number of objects that were considered/merged during deduplication
+    size_t dedup_count = 0, dedup_merged = 0;
+
+    /// Estimated cost of instantiating an object and its dependencies
+    std::unordered_map<std::string, uint64_t> costs;
+
+    /// Start time and duration (in ms) of the instantiation of each object
+    struct TimelineEntry {
+        std::string id, plugin_name;
+        size_t start, duration;
+    };
+    std::vector<TimelineEntry> timeline;
+    std::mutex timeline_mutex;
+    Timer timer;
+
     XMLParseContext(const std::string &variant, bool parallel)
         : variant(variant), parallel(parallel) {
         color_mode = MI_INVOKE_VARIANT(variant, variant_to_color_mode);
@@ -233,6 +275,87 @@ struct XMLParseContext {
     }
 };
 
+/// Append the binary representation of a value to a deduplication key
+template <typename T> void append_key(std::string &key, const T &value) {
+    if constexpr (dr::is_static_array_v<T>) {
+        for (size_t i = 0; i < T::Size; ++i)
+            append_key(key, value.entry(i));
+    } else {
+        static_assert(std::is_trivially_copyable_v<T>, "Unsupported type!");
+        key.append((const char *) &value, sizeof(T));
+    }
+}
+
+static void append_key(std::string &key, const std::string &value) {
+    append_key(key, value.size());
+    key.append(value);
+}
+
+/**
+ * \brief Compute a key that uniquely identifies the class, plugin and
+ * properties of an object. Returns an empty string when the properties
+ * contain values that cannot be compared (e.g. pointers).
+ */
+static std::string structural_key(const Class *class_, Properties props) {
+    std::string key;
+    append_key(key, class_);
+    append_key(key, props.plugin_name());
+
+    for (const std::string &name : props.property_names()) {
+        auto type = props.type(name);
+        append_key(key, name);
+        append_key(key, type);
+
+        switch (type) {
+            case Properties::Type::Bool:
+                append_key(key, props.get<bool>(name));
+                break;
+
+            case Properties::Type::Long:
+                append_key(key, props.get<int64_t>(name));
+                break;
+
+            case Properties::Type::Float:
+                append_key(key, props.get<Float>(name));
+                break;
+
+            case Properties::Type::Array3f:
+                append_key(key, props.get<Properties::Array3f>(name));
+                break;
+
+            case Properties::Type::Color:
+                append_key(key, props.get<Color3f>(name));
+                break;
+
+            case Properties::Type::String:
+                append_key(key, props.string(name));
+                break;
+
+            case Properties::Type::NamedReference:
+                append_key(key, (const std::string &) props.named_reference(name));
+                break;
+
+            case Properties::Type::Transform3f:
+                append_key(key, props.get<Transform3f>(name).matrix);
+                break;
+
+            case Properties::Type::Transform4f:
+                append_key(key, props.get<Transform4f>(name).matrix);
+                break;
+
+            case Properties::Type::Object:
+                // Inline textures are deduplicated as well, compare pointers
+                append_key(key, props.object(name).get());
+                break;
+
+            default:
+                return std::string();
+        }
+    }
+
+    return key;
+}
+
 /// Helper function to check if attributes are fully specified
 static void check_attributes(XMLSource &src, const pugi::xml_node &node,
                              std::set<std::string> &&attrs, bool expect_all = true) {
@@ -392,6 +515,25 @@ void upgrade_tree(XMLSource &src, pugi::xml_node &node, const Version &version)
             Version(MI_VERSION));
 }
 
+/// Register a parsed object with the parse context
+static void add_instance(XMLSource &src, XMLParseContext &ctx,
+                         const std::string &id, const Properties &props,
+                         const Class *class_, ptrdiff_t location) {
+    auto &inst = ctx.instances[id];
+    inst.props = props;
+    inst.class_ = class_;
+    inst.offset = src.offset;
+    inst.src_id = src.id;
+#if defined(MI_ENABLE_LLVM) || defined(MI_ENABLE_CUDA)
+    // Deterministically assign a scope to each scene object
+    if (ctx.backend && ctx.parallel) {
+        jit_new_scope((JitBackend) ctx.backend);
+        inst.scope = jit_scope((JitBackend) ctx.backend);
+    }
+#endif
+    inst.location = location;
+}
+
 static std::pair<std::string, std::string> parse_xml(XMLSource &src, XMLParseContext &ctx,
                                                      pugi::xml_node &node, Tag parent_tag,
                                                      Properties &props, ParameterList &param,
@@ -442,6 +584,7 @@ static std::pair<std::string, std::string> parse_xml(XMLSource &src, XMLParseCon
         bool parent_is_object        = has_parent && parent_tag == Tag::Object;
         bool current_is_object       = tag == Tag::Object;
         bool parent_is_transform     = parent_tag == Tag::Transform;
+        bool parent_is_animation     = parent_tag == Tag::Animation;
         bool current_is_transform_op = tag == Tag::Translate || tag == Tag::Rotate ||
                                        tag == Tag::Scale || tag == Tag::LookAt ||
                                        tag == Tag::Matrix;
@@ -456,7 +599,12 @@ static std::pair<std::string, std::string> parse_xml(XMLSource &src, XMLParseCon
                 src.throw_error(node, "transform operations can only occur in a transform node");
         }
 
-        if (has_parent && !parent_is_object && !(parent_is_transform && current_is_transform_op))
+        if (parent_is_animation && tag != Tag::Transform)
+            src.throw_error(node, "animation nodes can only contain transform nodes");
+
+        if (has_parent && !parent_is_object &&
+            !(parent_is_transform && current_is_transform_op) &&
+            !(parent_is_animation && tag == Tag::Transform))
             src.throw_error(node, "node \"%s\" cannot occur as child of a property", node.name());
 
         auto version_attr = node.attribute("version");
@@ -538,19 +686,24 @@ static std::pair<std::string, std::string> parse_xml(XMLSource &src, XMLParseCon
                             props_nested.set_named_reference(arg_name, nested_id);
                     }
 
-                    auto &inst = ctx.instances[id];
-                    inst.props = props_nested;
-                    inst.class_ = it2->second;
-                    inst.offset = src.offset;
-                    inst.src_id = src.id;
-#if defined(MI_ENABLE_LLVM) || defined(MI_ENABLE_CUDA)
-                    // Deterministically assign a scope to each scene object
-                    if (ctx.backend && ctx.parallel) {
-                        jit_new_scope((JitBackend) ctx.backend);
-                        inst.scope = jit_scope((JitBackend) ctx.backend);
+                    // Refer to an identical anonymous object instead, if possible
+                    const std::string &alias = it2->second->alias();
+                    if (ctx.deduplicate && string::starts_with(id, "_unnamed_") &&
+                        (alias == "bsdf" || alias == "texture")) {
+                        std::string key = structural_key(it2->second, props_nested);
+                        if (!key.empty()) {
+                            ctx.dedup_count++;
+                            auto [it_key, inserted] =
+                                ctx.dedup_ids.try_emplace(std::move(key), id);
+                            if (!inserted) {
+                                ctx.dedup_merged++;
+                                return std::make_pair(name, it_key->second);
+                            }
+                        }
                     }
-#endif
-                    inst.location = node.offset_debug();
+
+                    add_instance(src, ctx, id, props_nested, it2->second,
+                                 node.offset_debug());
                     return std::make_pair(name, id);
                 }
                 break;
@@ -770,15 +923,53 @@ static std::pair<std::string, std::string> parse_xml(XMLSource &src, XMLParseCon
 
                     if (!within_spectrum) {
                         std::string name = node.attribute("name").value();
-                        ref<Object> obj = detail::create_texture_from_rgb(
-                            name, color, ctx.variant, within_emitter);
+                        ref<Object> obj;
+                        std::string key;
+                        if (ctx.deduplicate) {
+                            key = std::string("rgb") + (within_emitter ? "e" : "") +
+                                  (is_unbounded_spectrum(name) ? "u" : "");
+                            append_key(key, color);
+                            auto it_tex = ctx.dedup_textures.find(key);
+                            if (it_tex != ctx.dedup_textures.end())
+                                obj = it_tex->second;
+                        }
+
+                        if (!obj) {
+                            obj = detail::create_texture_from_rgb(
+                                name, color, ctx.variant, within_emitter);
+                            if (ctx.deduplicate)
+                                ctx.dedup_textures[key] = obj;
+                        }
+
                         props.set_object(name, obj);
+
+                        if (ctx.textures) {
+                            CompiledTexture &tex = (*ctx.textures)[obj.get()];
+                            tex.within_emitter = within_emitter;
+                            tex.color = color;
+                        }
                     } else {
                         props.set_color("color", color);
                     }
                 }
                 break;
 
+            case Tag::Tensor: {
+                    check_attributes(src, node, { "name", "filename", "field" }, false);
+                    if (node.attribute("name").empty() || node.attribute("filename").empty())
+                        src.throw_error(node, "'tensor' tag requires \"name\" and \"filename\" attributes");
+                    try {
+                        props.set_tensor_handle(
+                            node.attribute("name").value(),
+                            detail::load_tensor(node.attribute("filename").value(),
+                                                node.attribute("field").value(),
+                                                ctx.variant));
+                    } catch (const std::exception &e) {
+                        src.throw_error(node, "%s", e.what());
+                    }
+                }
+                break;
+
             case Tag::Spectrum: {
                     check_attributes(src, node, { "name", "value", "filename" }, false);
                     std::string name = node.attribute("name").value();
@@ -827,22 +1018,58 @@ static std::pair<std::string, std::string> parse_xml(XMLSource &src, XMLParseCon
                         }
                     }
 
-                    ref<Object> obj = detail::create_texture_from_spectrum(
-                        name, const_value, wavelengths, values, ctx.variant,
-                        within_emitter,
-                        ctx.color_mode == ColorMode::Spectral,
-                        ctx.color_mode == ColorMode::Monochromatic);
+                    // The values are rescaled in-place below, keep a copy
+                    CompiledTexture tex;
+                    if (ctx.textures) {
+                        tex.spectrum = true;
+                        tex.within_emitter = within_emitter;
+                        tex.const_value = const_value;
+                        tex.wavelengths = wavelengths;
+                        tex.values = values;
+                    }
+
+                    ref<Object> obj;
+                    std::string key;
+                    if (ctx.deduplicate) {
+                        key = std::string("spectrum") + (within_emitter ? "e" : "") +
+                              (is_unbounded_spectrum(name) ? "u" : "");
+                        append_key(key, const_value);
+                        key.append((const char *) wavelengths.data(), wavelengths.size() * sizeof(Float));
+                        key.append((const char *) values.data(), values.size() * sizeof(Float));
+                        auto it_tex = ctx.dedup_textures.find(key);
+                        if (it_tex != ctx.dedup_textures.end())
+                            obj = it_tex->second;
+                    }
+
+                    if (!obj) {
+                        obj = detail::create_texture_from_spectrum(
+                            name, const_value, wavelengths, values, ctx.variant,
+                            within_emitter,
+                            ctx.color_mode == ColorMode::Spectral,
+                            ctx.color_mode == ColorMode::Monochromatic);
+                        if (ctx.deduplicate)
+                            ctx.dedup_textures[key] = obj;
+                    }
 
                     props.set_object(name, obj);
+
+                    if (ctx.textures)
+                        (*ctx.textures)[obj.get()] = std::move(tex);
                 }
                 break;
 
             case Tag::Transform: {
-                    check_attributes(src, node, { "name" });
+                    check_attributes(src, node, { parent_is_animation ? "time" : "name" });
                     ctx.transform = Transform4f();
                 }
                 break;
 
+            case Tag::Animation: {
+                    check_attributes(src, node, { "name" });
+                    ctx.animation = new AnimatedTransform();
+                }
+                break;
+
             case Tag::Rotate: {
                     detail::expand_value_to_xyz(src, node);
                     check_attributes(src, node, { "angle", "x", "y", "z" }, false);
@@ -937,8 +1164,24 @@ static std::pair<std::string, std::string> parse_xml(XMLSource &src, XMLParseCon
         for (pugi::xml_node &ch: node.children())
             parse_xml(src, ctx, ch, tag, props, param, arg_counter, depth + 1);
 
-        if (tag == Tag::Transform)
+        if (tag == Tag::Transform && parent_is_animation) {
+            std::string time = node.attribute("time").value();
+            Float time_float;
+            try {
+                time_float = string::stof<Float>(time);
+            } catch (...) {
+                src.throw_error(node, "could not parse floating point value \"%s\"", time);
+            }
+            ctx.animation->append((float) time_float,
+                                  (AnimatedTransform::Transform4f) ctx.transform);
+        } else if (tag == Tag::Transform) {
             props.set_transform(node.attribute("name").value(), ctx.transform);
+        } else if (tag == Tag::Animation) {
+            if (ctx.animation->size() == 0)
+                src.throw_error(node, "animation must contain at least one transform node");
+            props.set_animated_transform(node.attribute("name").value(), ctx.animation);
+            ctx.animation = nullptr;
+        }
     } catch (const std::exception &e) {
         if (strstr(e.what(), "Error while loading") == nullptr)
             src.throw_error(node, "%s", e.what());
@@ -1007,6 +1250,77 @@ static std::string init_xml_parse_context_from_file(XMLParseContext &ctx,
     return scene_id;
 }
 
+static void log_deduplication(const XMLParseContext &ctx) {
+    if (!ctx.deduplicate)
+        return;
+    Log(Info, "Deduplication: merged %zu of %zu anonymous BSDFs and textures "
+        "(%.1f%%), %zu unique inline textures.", ctx.dedup_merged,
+        ctx.dedup_count,
+        ctx.dedup_count ? 100.0 * ctx.dedup_merged / ctx.dedup_count : 0.0,
+        ctx.dedup_textures.size());
+}
+
+/**
+ * \brief Estimate the cost of instantiating an object, including the longest
+ * chain of dependencies that must be instantiated before it.
+ *
+ * Loading the referenced files (meshes, images, volumes) dominates, hence the
+ * estimate is the size of the file referenced by the \c filename property in
+ * bytes, plus a small fixed cost per object.
+ */
+static uint64_t estimate_cost(XMLParseContext &ctx, const std::string &id) {
+    auto cached = ctx.costs.find(id);
+    if (cached != ctx.costs.end())
+        return cached->second;
+
+    auto it = ctx.instances.find(id);
+    if (it == ctx.instances.end())
+        return 0; // Reported by instantiate_node()
+
+    const XMLObject &inst = it->second;
+    if (!inst.alias.empty())
+        return estimate_cost(ctx, inst.alias);
+
+    // Guard against cyclic references
+    ctx.costs[id] = 0;
+
+    const Properties &props = inst.props;
+    uint64_t cost = 4096, dep_cost = 0;
+    if (props.has_property("filename") &&
+        props.type("filename") == Properties::Type::String) {
+        // Query a copy, which leaves the property unqueried for the plugin
+        fs::path path = Thread::thread()->file_resolver()->resolve(
+            Properties(props).string("filename"));
+        if (fs::exists(path))
+            cost += (uint64_t) fs::file_size(path);
+    }
+
+    for (auto &kv : props.named_references())
+        dep_cost = std::max(dep_cost, estimate_cost(ctx, kv.second));
+
+    cost += dep_cost;
+    ctx.costs[id] = cost;
+    return cost;
+}
+
+static void log_timeline(XMLParseContext &ctx) {
+    const Logger *logger = Thread::thread()->logger();
+    if (ctx.timeline.empty() || !logger || logger->log_level() > Debug)
+        return;
+
+    std::sort(ctx.timeline.begin(), ctx.timeline.end(),
+              [](const auto &a, const auto &b) { return a.start < b.start; });
+
+    std::ostringstream oss;
+    oss << "Load timeline (start, duration, object):" << std::endl;
+    for (const auto &e : ctx.timeline)
+        oss << tfm::format("  %8s %8s  %s (%s)",
+                           util::time_string((float) e.start),
+                           util::time_string((float) e.duration), e.id,
+                           e.plugin_name) << std::endl;
+    Log(Debug, "%s", oss.str());
+}
+
 static Task *instantiate_node(XMLParseContext &ctx,
                               const std::string &id,
                               ThreadEnvironment &env,
@@ -1028,10 +1342,24 @@ static Task *instantiate_node(XMLParseContext &ctx,
     const auto &named_references = props.named_references();
     uint32_t scope = inst.scope;
 
+    /* In parallel mode, submit the most expensive dependencies (e.g. a large
+       mesh) first, so that they don't end up on the critical path */
+    std::vector<size_t> order(named_references.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    if (ctx.parallel && order.size() > 1) {
+        std::vector<uint64_t> costs(order.size());
+        for (size_t i = 0; i < order.size(); ++i)
+            costs[i] = estimate_cost(ctx, named_references[i].second);
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return costs[a] > costs[b];
+        });
+    }
+
     // Recursive graph traversal to gather dependency tasks
     std::vector<Task *> deps;
-    for (auto &kv : named_references) {
-        const std::string& child_id = kv.second;
+    for (size_t i : order) {
+        const std::string& child_id = named_references[i].second;
         if (task_map.find(child_id) == task_map.end()) {
             Task *task = instantiate_node(ctx, child_id, env, task_map, false);
             task_map.insert({child_id, task});
@@ -1039,42 +1367,49 @@ static Task *instantiate_node(XMLParseContext &ctx,
         deps.push_back(task_map.find(child_id)->second);
     }
 
-    auto instantiate = [&ctx, &env, id, scope]() {
+    /* Resolve the records of the object and its children here. The task
+       must not look them up, since the streaming parser may concurrently add
+       further records (which leaves the existing ones in place) */
+    std::vector<std::pair<std::string, XMLObject *>> child_insts;
+    for (auto &kv : named_references) {
+        XMLObject *child = &ctx.instances.find(kv.second)->second;
+        while (!child->alias.empty())
+            child = &ctx.instances.find(child->alias)->second;
+        child_insts.emplace_back(kv.first, child);
+    }
+
+    auto instantiate = [&ctx, &env, inst_ptr = &inst, child_insts, scope, id]() {
         ScopedSetThreadEnvironment set_env(env);
         ScopedSetJITScope set_scope(ctx.parallel ? ctx.backend : 0u, scope);
 
-        auto it = ctx.instances.find(id);
-        if (it == ctx.instances.end())
-            Throw("reference to unknown object \"%s\"!", id);
-
-        auto &inst = it->second;
+        auto &inst = *inst_ptr;
         Properties &props = inst.props;
-        const auto &named_references = props.named_references();
 
         // Populate props with the already instantiated child objects
-        for (auto &kv : named_references) {
-            const std::string& child_id = kv.second;
-            auto it2 = ctx.instances.find(child_id);
-            if (it2 == ctx.instances.end())
-                Throw("reference to unknown object \"%s\"!", child_id);
-            ref<Object> obj = it2->second.object;
+        for (auto &[name, child] : child_insts) {
+            ref<Object> obj = child->object;
             Assert(obj);
 
             // Give the object a chance to recursively expand into sub-objects
             std::vector<ref<Object>> children = obj->expand();
             if (children.empty()) {
-                props.set_object(kv.first, obj, false);
+                props.set_object(name, obj, false);
             } else if (children.size() == 1) {
-                props.set_object(kv.first, children[0], false);
+                props.set_object(name, children[0], false);
             } else {
                 int ctr = 0;
                 for (auto c : children)
-                    props.set_object(kv.first + "_" + std::to_string(ctr++), c, false);
+                    props.set_object(name + "_" + std::to_string(ctr++), c, false);
             }
         }
 
         try {
+            size_t start = ctx.timer.value();
             inst.object = PluginManager::instance()->create_object(props, inst.class_);
+            size_t duration = ctx.timer.value() - start;
+
+            std::lock_guard<std::mutex> guard(ctx.timeline_mutex);
+            ctx.timeline.push_back({ id, props.plugin_name(), start, duration });
         } catch (const std::exception &e) {
             Throw("Error while loading \"%s\" (near %s): could not instantiate "
                   "%s plugin of type \"%s\": %s",
@@ -1118,6 +1453,7 @@ static Task *instantiate_node(XMLParseContext &ctx,
         }
         for (auto& kv : task_map)
             task_release(kv.second);
+        task_map.clear();
         if (eptr)
             std::rethrow_exception(eptr);
         instantiate();
@@ -1133,10 +1469,12 @@ static Task *instantiate_node(XMLParseContext &ctx,
     }
 }
 
-static ref<Object> instantiate_top_node(XMLParseContext &ctx, const std::string &id) {
-    ThreadEnvironment env;
-    std::unordered_map<std::string, Task*> task_map;
+/// Instantiate the top node, reusing the tasks that were already launched
+static ref<Object> instantiate_top_node(XMLParseContext &ctx, const std::string &id,
+                                        ThreadEnvironment &env,
+                                        std::unordered_map<std::string, Task *> &task_map) {
     instantiate_node(ctx, id, env, task_map, true);
+    log_timeline(ctx);
 #if defined(MI_ENABLE_LLVM) || defined(MI_ENABLE_CUDA)
     if (ctx.backend && ctx.parallel)
         jit_new_scope((JitBackend) ctx.backend);
@@ -1144,6 +1482,740 @@ static ref<Object> instantiate_top_node(XMLParseContext &ctx, const std::string
     return ctx.instances.find(id)->second.object;
 }
 
+static ref<Object> instantiate_top_node(XMLParseContext &ctx, const std::string &id) {
+    ThreadEnvironment env;
+    std::unordered_map<std::string, Task*> task_map;
+    return instantiate_top_node(ctx, id, env, task_map);
+}
+
+// =============================================================================
+// === Streaming loader
+// =============================================================================
+
+/// Reads a scene file in blocks, so that it never needs to be held in memory
+class XMLStreamReader {
+public:
+    static constexpr size_t BlockSize = 1 << 20;
+
+    XMLStreamReader(const fs::path &filename)
+        : m_stream(filename.native(), std::ios::in | std::ios::binary) {
+        if (!m_stream.good())
+            Throw("\"%s\": unable to open file!", filename);
+    }
+
+    /// Bytes of the file that are currently buffered
+    const std::string &buffer() const { return m_buffer; }
+
+    /// File offset of the first buffered byte
+    size_t base() const { return m_base; }
+
+    /// Read until at least \c size bytes are buffered, returns \c false at EOF
+    bool ensure(size_t size) {
+        while (m_buffer.size() < size && m_stream.good()) {
+            size_t old_size = m_buffer.size();
+            m_buffer.resize(old_size + BlockSize);
+            m_stream.read(m_buffer.data() + old_size, BlockSize);
+            m_buffer.resize(old_size + (size_t) m_stream.gcount());
+        }
+        return m_buffer.size() >= size;
+    }
+
+    /// Does the buffer contain the string \c str at position \c pos?
+    bool starts_with(size_t pos, const char *str) {
+        size_t len = strlen(str);
+        return ensure(pos + len) && m_buffer.compare(pos, len, str) == 0;
+    }
+
+    /// Find the next occurrence of \c str (returns \c npos at EOF)
+    size_t find(const char *str, size_t pos) {
+        size_t len = strlen(str);
+        while (true) {
+            size_t result = m_buffer.find(str, pos);
+            if (result != std::string::npos)
+                return result;
+            if (m_buffer.size() >= len)
+                pos = std::max(pos, m_buffer.size() - len + 1);
+            if (!ensure(m_buffer.size() + 1))
+                return std::string::npos;
+        }
+    }
+
+    /// Find the end of the tag starting at \c pos, skipping quoted values
+    size_t tag_end(size_t pos) {
+        char quote = 0;
+        for (size_t i = pos; ensure(i + 1); ++i) {
+            char c = m_buffer[i];
+            if (quote) {
+                if (c == quote)
+                    quote = 0;
+            } else if (c == '"' || c == '\'') {
+                quote = c;
+            } else if (c == '>') {
+                return i;
+            }
+        }
+        return std::string::npos;
+    }
+
+    /// Discard the first \c size buffered bytes
+    void consume(size_t size) {
+        m_buffer.erase(0, size);
+        m_base += size;
+    }
+
+private:
+    std::ifstream m_stream;
+    std::string m_buffer;
+    size_t m_base = 0;
+};
+
+/// Wait for the given tasks (ignoring failures) and release them
+static void release_tasks(std::unordered_map<std::string, Task *> &task_map) {
+    for (auto &kv : task_map) {
+        try {
+            task_wait(kv.second);
+        } catch (...) { }
+    }
+    for (auto &kv : task_map)
+        task_release(kv.second);
+    task_map.clear();
+}
+
+/// Have all objects (transitively) referenced by \c id already been parsed?
+static bool is_resolvable(const XMLParseContext &ctx, const std::string &id,
+                          const std::unordered_map<std::string, Task *> &task_map,
+                          std::unordered_set<std::string> &visited) {
+    if (task_map.find(id) != task_map.end() || !visited.insert(id).second)
+        return true;
+    auto it = ctx.instances.find(id);
+    if (it == ctx.instances.end())
+        return false;
+    if (!it->second.alias.empty())
+        return is_resolvable(ctx, it->second.alias, task_map, visited);
+    for (auto &kv : it->second.props.named_references()) {
+        if (!is_resolvable(ctx, kv.second, task_map, visited))
+            return false;
+    }
+    return true;
+}
+
+/**
+ * \brief Load a scene file without building a DOM of the entire document
+ *
+ * The file is read in blocks and scanned for the boundaries of the children
+ * of the root element. Consecutive children are gathered into batches of a
+ * few megabytes, each of which is parsed into a small temporary document and
+ * discarded once its objects have been registered. In parallel mode, objects
+ * whose references can be resolved are instantiated asynchronously while
+ * the remainder of the file is being parsed.
+ */
+static ref<Object> load_file_streaming(XMLParseContext &ctx,
+                                       const fs::path &filename,
+                                       ParameterList param) {
+    constexpr size_t BatchSize = 4 << 20;
+
+    XMLStreamReader reader(filename);
+    std::string src_id = filename.string();
+
+    auto throw_error = [&](size_t pos, const char *msg) {
+        Throw("Error while loading \"%s\" (at %s): %s.", src_id,
+              file_offset(filename, (ptrdiff_t) (reader.base() + pos)), msg);
+    };
+
+    // Root element, with the file offset of its start tag
+    std::string root_open, root_name, root_id;
+    size_t root_pos = 0;
+    pugi::xml_document root_doc;
+    XMLSource root_src{
+        src_id, root_doc,
+        [&](ptrdiff_t) { return file_offset(filename, (ptrdiff_t) root_pos); }
+    };
+    Version version;
+    Properties root_props;
+    size_t arg_counter = 0;
+
+    ThreadEnvironment env;
+    std::unordered_map<std::string, Task *> task_map;
+    std::vector<std::string> pending;
+
+    // Parse the children of the root element stored in [batch_start, end)
+    size_t pos = 0, batch_start = 0;
+    auto flush = [&](size_t end) {
+        std::string text = root_open +
+                           reader.buffer().substr(batch_start, end - batch_start) +
+                           "</" + root_name + ">";
+        size_t prefix = root_open.size(),
+               file_pos = reader.base() + batch_start;
+
+        pugi::xml_document doc;
+        XMLSource src{
+            src_id, doc,
+            [=](ptrdiff_t p) {
+                return file_offset(filename, p < (ptrdiff_t) prefix
+                                                 ? (ptrdiff_t) root_pos
+                                                 : (ptrdiff_t) (file_pos + p - prefix));
+            }
+        };
+
+        pugi::xml_parse_result result = doc.load_buffer(
+            text.data(), text.size(), pugi::parse_default | pugi::parse_comments);
+        if (!result)
+            Throw("Error while loading \"%s\" (at %s): %s", src.id,
+                  src.offset(result.offset), result.description());
+
+        pugi::xml_node root = doc.document_element();
+        upgrade_tree(src, root, version);
+
+        for (pugi::xml_node &ch : root.children()) {
+            if (strcmp(ch.name(), "path") == 0 && !task_map.empty())
+                src.throw_error(ch, "<path> elements must precede all objects "
+                                    "when streaming a scene");
+            auto [arg_name, nested_id] = parse_xml(
+                src, ctx, ch, Tag::Object, root_props, param, arg_counter, 1);
+            if (nested_id == root_id)
+                src.throw_error(ch, "cannot reference parent id \"%s\" in "
+                                    "nested object", nested_id);
+            if (!nested_id.empty()) {
+                root_props.set_named_reference(arg_name, nested_id);
+                if (ctx.parallel)
+                    pending.push_back(nested_id);
+            }
+        }
+
+        reader.consume(end);
+        pos -= end;
+        batch_start = pos;
+
+        if (!ctx.parallel)
+            return;
+
+        // Launch the objects whose references are all known by now
+        std::vector<std::string> deferred;
+        for (auto &id : pending) {
+            if (task_map.find(id) != task_map.end())
+                continue;
+            std::unordered_set<std::string> visited;
+            if (is_resolvable(ctx, id, task_map, visited))
+                task_map.insert({ id, instantiate_node(ctx, id, env, task_map, false) });
+            else
+                deferred.push_back(id);
+        }
+        pending.swap(deferred);
+    };
+
+    try {
+        int depth = 0;
+        while (true) {
+            size_t lt = reader.find("<", pos);
+            if (lt == std::string::npos)
+                throw_error(pos, depth == 0 ? "no root element"
+                                            : "unexpected end of file");
+
+            // Skip over declarations, comments, and CDATA sections
+            const char *terminator = nullptr;
+            if (reader.starts_with(lt, "<?"))
+                terminator = "?>";
+            else if (reader.starts_with(lt, "<!--"))
+                terminator = "-->";
+            else if (reader.starts_with(lt, "<![CDATA["))
+                terminator = "]]>";
+            else if (reader.starts_with(lt, "<!"))
+                terminator = ">";
+
+            if (terminator) {
+                size_t end = reader.find(terminator, lt);
+                if (end == std::string::npos)
+                    throw_error(lt, "unterminated markup");
+                pos = end + strlen(terminator);
+                continue;
+            }
+
+            size_t end = reader.tag_end(lt);
+            if (end == std::string::npos)
+                throw_error(lt, "unterminated tag");
+            pos = end + 1;
+
+            if (reader.starts_with(lt, "</")) {
+                if (--depth == 0) {
+                    flush(lt);
+                    break;
+                }
+            } else if (depth == 0) {
+                bool self_closing = reader.buffer()[end - 1] == '/';
+                root_open = reader.buffer().substr(lt, end - lt + 1);
+                root_pos = reader.base() + lt;
+
+                // Parse the attributes of the root element
+                std::string stub = root_open;
+                if (!self_closing)
+                    stub.insert(stub.size() - 1, "/");
+                if (!root_doc.load_buffer(stub.data(), stub.size()))
+                    throw_error(lt, "could not parse the root element");
+                pugi::xml_node root = root_doc.document_element();
+
+                root_name = root.name();
+                if (tag_class->find(class_key(root_name, ctx.variant)) == tag_class->end())
+                    root_src.throw_error(root, "root element \"%s\" must be an object",
+                                         root_name);
+                if (!root.attribute("version"))
+                    root_src.throw_error(root, "missing version attribute in root "
+                                               "element \"%s\"", root_name);
+                check_attributes(root_src, root, { "version", "type", "id" }, false);
+                try {
+                    version = root.attribute("version").value();
+                } catch (const std::exception &) {
+                    root_src.throw_error(root, "could not parse version number \"%s\"",
+                                         root.attribute("version").value());
+                }
+
+                std::string type = root_name == "scene" ? std::string("scene")
+                                                        : root.attribute("type").value();
+                if (type.empty())
+                    root_src.throw_error(root, "missing attribute \"type\" in "
+                                               "element \"%s\"", root_name);
+                root_id = root.attribute("id").value();
+                if (root_id.empty())
+                    root_id = tfm::format("_unnamed_%u", ctx.id_counter++);
+                else if (string::starts_with(root_id, "_"))
+                    root_src.throw_error(root, "invalid id \"%s\" in element \"%s\": "
+                                               "leading underscores are reserved for "
+                                               "internal identifiers.", root_id, root_name);
+                root_props.set_plugin_name(type);
+                root_props.set_id(root_id);
+
+                if (self_closing)
+                    break;
+                depth = 1;
+                batch_start = pos;
+            } else if (reader.buffer()[end - 1] != '/') {
+                depth++;
+            }
+
+            // Parse the children of the root in batches of a few megabytes
+            if (depth == 1 && pos - batch_start >= BatchSize)
+                flush(pos);
+        }
+
+        for (const auto& p : param) {
+            if (!std::get<2>(p))
+                Throw("Unused parameter \"%s\"!", std::get<0>(p));
+        }
+
+        if (ctx.instances.find(root_id) != ctx.instances.end())
+            root_src.throw_error(root_doc.document_element(),
+                                 "\"%s\" has duplicate id \"%s\"", root_name,
+                                 root_id);
+        root_src.offset = [filename, root_pos](ptrdiff_t) {
+            return file_offset(filename, (ptrdiff_t) root_pos);
+        };
+        add_instance(root_src, ctx, root_id, root_props,
+                     tag_class->find(class_key(root_name, ctx.variant))->second,
+                     (size_t) root_pos);
+
+        return instantiate_top_node(ctx, root_id, env, task_map);
+    } catch (...) {
+        release_tasks(task_map);
+        throw;
+    }
+}
+
+// =============================================================================
+// === Compiled scene format
+// =============================================================================
+
+/* A compiled scene stores the contents of 'XMLParseContext::instances' after
+   parsing, so that loading it skips the XML parser, include expansion and
+   parameter substitution. All values are stored in native byte order:
+
+     magic, version, variant, scene id, file resolver paths,
+     instance count, then for each instance:
+         id, alias, tag name, plugin name, source file, source offset,
+         property count, then for each property: tag, name, value
+
+   Strings are prefixed by their length (uint32_t). */
+
+static const char compiled_magic[8] = { 'M', 'I', 'S', 'C', 'E', 'N', 'E', '\0' };
+static const uint32_t compiled_version = 1;
+
+enum class CompiledTag : uint8_t {
+    Bool, Long, Float, Array3f, Color, String, NamedReference,
+    Transform3f, Transform4f, TextureRGB, TextureSpectrum
+};
+
+struct CompiledWriter {
+    std::vector<uint8_t> buffer;
+
+    template <typename T> void put(const T &value) {
+        static_assert(std::is_trivially_copyable_v<T>, "Unsupported type!");
+        const uint8_t *ptr = (const uint8_t *) &value;
+        buffer.insert(buffer.end(), ptr, ptr + sizeof(T));
+    }
+
+    template <typename T> void put_array(const T *value, size_t count) {
+        for (size_t i = 0; i < count; ++i)
+            put(value[i]);
+    }
+
+    void put_string(const std::string &value) {
+        put((uint32_t) value.size());
+        buffer.insert(buffer.end(), value.begin(), value.end());
+    }
+};
+
+struct CompiledReader {
+    const uint8_t *ptr, *end;
+    const fs::path &filename;
+
+    void check(size_t size) {
+        if ((size_t) (end - ptr) < size)
+            Throw("\"%s\": compiled scene file is truncated!", filename);
+    }
+
+    template <typename T> T get() {
+        check(sizeof(T));
+        T value;
+        std::memcpy(&value, ptr, sizeof(T));
+        ptr += sizeof(T);
+        return value;
+    }
+
+    template <typename T> void get_array(T *value, size_t count) {
+        check(sizeof(T) * count);
+        std::memcpy(value, ptr, sizeof(T) * count);
+        ptr += sizeof(T) * count;
+    }
+
+    std::string get_string() {
+        uint32_t size = get<uint32_t>();
+        check(size);
+        std::string value((const char *) ptr, size);
+        ptr += size;
+        return value;
+    }
+};
+
+/// Check whether the given file starts with the compiled scene header
+static bool is_compiled_file(const fs::path &filename) {
+    std::ifstream is(filename.native(), std::ios::binary);
+    char magic[sizeof(compiled_magic)];
+    if (!is.read(magic, sizeof(magic)))
+        return false;
+    return std::memcmp(magic, compiled_magic, sizeof(magic)) == 0;
+}
+
+static void write_compiled_file(const XMLParseContext &ctx,
+                                const std::string &scene_id,
+                                const fs::path &filename) {
+    CompiledWriter w;
+    w.put_array(compiled_magic, sizeof(compiled_magic));
+    w.put(compiled_version);
+    w.put_string(ctx.variant);
+    w.put_string(scene_id);
+
+    const FileResolver *fr = Thread::thread()->file_resolver();
+    w.put((uint32_t) fr->size());
+    for (const fs::path &path : *fr)
+        w.put_string(fs::absolute(path).string());
+
+    // Sort the instances to obtain a deterministic file (and JIT scopes)
+    std::vector<std::pair<const std::string *, const XMLObject *>> instances;
+    for (auto &[id, inst] : ctx.instances)
+        instances.emplace_back(&id, &inst);
+    std::sort(instances.begin(), instances.end(),
+              [](const auto &a, const auto &b) { return *a.first < *b.first; });
+
+    w.put((uint32_t) instances.size());
+    for (auto [id, inst] : instances) {
+        // The getters below mark properties as queried, work on a copy
+        Properties props = inst->props;
+
+        w.put_string(*id);
+        w.put_string(inst->alias);
+        w.put_string(inst->class_ ? inst->class_->alias() : "");
+        w.put_string(props.plugin_name());
+        w.put_string(inst->src_id);
+        w.put((uint64_t) inst->location);
+
+        std::vector<std::string> names = props.property_names();
+        w.put((uint32_t) names.size());
+
+        for (const std::string &name : names) {
+            switch (props.type(name)) {
+                case Properties::Type::Bool:
+                    w.put(CompiledTag::Bool);
+                    w.put_string(name);
+                    w.put((uint8_t) props.get<bool>(name));
+                    break;
+
+                case Properties::Type::Long:
+                    w.put(CompiledTag::Long);
+                    w.put_string(name);
+                    w.put(props.get<int64_t>(name));
+                    break;
+
+                case Properties::Type::Float:
+                    w.put(CompiledTag::Float);
+                    w.put_string(name);
+                    w.put(props.get<Float>(name));
+                    break;
+
+                case Properties::Type::Array3f: {
+                        auto value = props.get<Properties::Array3f>(name);
+                        w.put(CompiledTag::Array3f);
+                        w.put_string(name);
+                        w.put_array(value.data(), 3);
+                    }
+                    break;
+
+                case Properties::Type::Color: {
+                        auto value = props.get<Color3f>(name);
+                        w.put(CompiledTag::Color);
+                        w.put_string(name);
+                        w.put_array(value.data(), 3);
+                    }
+                    break;
+
+                case Properties::Type::String: {
+                        std::string value = props.string(name);
+                        // Store file references as absolute paths
+                        if (name == "filename") {
+                            fs::path path = fr->resolve(value);
+                            if (fs::exists(path))
+                                value = fs::absolute(path).string();
+                        }
+                        w.put(CompiledTag::String);
+                        w.put_string(name);
+                        w.put_string(value);
+                    }
+                    break;
+
+                case Properties::Type::NamedReference:
+                    w.put(CompiledTag::NamedReference);
+                    w.put_string(name);
+                    w.put_string((const std::string &) props.named_reference(name));
+                    break;
+
+                case Properties::Type::Transform3f: {
+                        auto value = props.get<Transform3f>(name);
+                        w.put(CompiledTag::Transform3f);
+                        w.put_string(name);
+                        for (size_t i = 0; i < 3; ++i)
+                            for (size_t j = 0; j < 3; ++j)
+                                w.put(value.matrix(i, j));
+                    }
+                    break;
+
+                case Properties::Type::Transform4f: {
+                        auto value = props.get<Transform4f>(name);
+                        w.put(CompiledTag::Transform4f);
+                        w.put_string(name);
+                        for (size_t i = 0; i < 4; ++i)
+                            for (size_t j = 0; j < 4; ++j)
+                                w.put(value.matrix(i, j));
+                    }
+                    break;
+
+                case Properties::Type::Object: {
+                        auto it = ctx.textures->find(props.object(name).get());
+                        if (it == ctx.textures->end())
+                            Throw("compile_file(): object \"%s\" contains the "
+                                  "property \"%s\" that cannot be compiled!",
+                                  *id, name);
+                        const CompiledTexture &tex = it->second;
+                        w.put(tex.spectrum ? CompiledTag::TextureSpectrum
+                                           : CompiledTag::TextureRGB);
+                        w.put_string(name);
+                        w.put((uint8_t) tex.within_emitter);
+                        if (tex.spectrum) {
+                            w.put(tex.const_value);
+                            w.put((uint32_t) tex.wavelengths.size());
+                            w.put_array(tex.wavelengths.data(), tex.wavelengths.size());
+                            w.put_array(tex.values.data(), tex.values.size());
+                        } else {
+                            w.put_array(tex.color.data(), 3);
+                        }
+                    }
+                    break;
+
+                default:
+                    Throw("compile_file(): object \"%s\" contains the property "
+                          "\"%s\" that cannot be compiled!", *id, name);
+            }
+        }
+    }
+
+    std::ofstream os(filename.native(), std::ios::binary | std::ios::trunc);
+    if (!os.write((const char *) w.buffer.data(), (std::streamsize) w.buffer.size()))
+        Throw("\"%s\": could not write compiled scene file!", filename);
+}
+
+static std::string init_xml_parse_context_from_compiled(XMLParseContext &ctx,
+                                                        const fs::path &filename) {
+    ref<MemoryMappedFile> mmap = new MemoryMappedFile(filename);
+    const uint8_t *data = (const uint8_t *) mmap->data();
+    CompiledReader r { data, data + mmap->size(), filename };
+
+    char magic[sizeof(compiled_magic)];
+    r.get_array(magic, sizeof(magic));
+    uint32_t version = r.get<uint32_t>();
+    if (std::memcmp(magic, compiled_magic, sizeof(magic)) != 0 ||
+        version != compiled_version)
+        Throw("\"%s\": unsupported compiled scene file!", filename);
+
+    std::string variant = r.get_string();
+    if (variant != ctx.variant)
+        Throw("\"%s\": the scene was compiled for variant \"%s\", which does "
+              "not match the requested variant \"%s\"!", filename, variant,
+              ctx.variant);
+
+    std::string scene_id = r.get_string();
+
+    // Restore the file resolver search paths of the compiled scene
+    ref<FileResolver> fr = Thread::thread()->file_resolver();
+    std::vector<fs::path> paths(r.get<uint32_t>());
+    for (fs::path &path : paths)
+        path = r.get_string();
+    for (auto it = paths.rbegin(); it != paths.rend(); ++it) {
+        if (!fr->contains(*it))
+            fr->prepend(*it);
+    }
+
+    uint32_t instance_count = r.get<uint32_t>();
+    for (uint32_t i = 0; i < instance_count; ++i) {
+        std::string id          = r.get_string(),
+                    alias       = r.get_string(),
+                    tag         = r.get_string(),
+                    plugin_name = r.get_string(),
+                    src_id      = r.get_string();
+        uint64_t location       = r.get<uint64_t>();
+
+        auto [it_inst, inserted] = ctx.instances.try_emplace(id);
+        if (!inserted)
+            Throw("\"%s\": duplicate id \"%s\"!", filename, id);
+
+        XMLObject &inst = it_inst->second;
+        inst.alias = alias;
+        inst.src_id = src_id;
+        inst.location = (size_t) location;
+        inst.offset = [src_id](ptrdiff_t pos) {
+            return detail::file_offset(src_id, pos);
+        };
+
+        if (!tag.empty()) {
+            auto it = tag_class->find(class_key(tag, ctx.variant));
+            if (it == tag_class->end())
+                Throw("\"%s\": could not retrieve class object for tag \"%s\" "
+                      "and variant \"%s\"", filename, tag, ctx.variant);
+            inst.class_ = it->second;
+        }
+
+        Properties &props = inst.props;
+        props.set_plugin_name(plugin_name);
+        props.set_id(id);
+
+        uint32_t prop_count = r.get<uint32_t>();
+        for (uint32_t j = 0; j < prop_count; ++j) {
+            CompiledTag prop_tag = r.get<CompiledTag>();
+            std::string name = r.get_string();
+
+            switch (prop_tag) {
+                case CompiledTag::Bool:
+                    props.set_bool(name, r.get<uint8_t>() != 0);
+                    break;
+
+                case CompiledTag::Long:
+                    props.set_long(name, r.get<int64_t>());
+                    break;
+
+                case CompiledTag::Float:
+                    props.set_float(name, r.get<Float>());
+                    break;
+
+                case CompiledTag::Array3f: {
+                        Properties::Array3f value;
+                        r.get_array(value.data(), 3);
+                        props.set_array3f(name, value);
+                    }
+                    break;
+
+                case CompiledTag::Color: {
+                        Color3f value;
+                        r.get_array(value.data(), 3);
+                        props.set_color(name, value);
+                    }
+                    break;
+
+                case CompiledTag::String:
+                    props.set_string(name, r.get_string());
+                    break;
+
+                case CompiledTag::NamedReference:
+                    props.set_named_reference(name, r.get_string());
+                    break;
+
+                case CompiledTag::Transform3f: {
+                        Matrix3f matrix;
+                        for (size_t k = 0; k < 3; ++k)
+                            for (size_t l = 0; l < 3; ++l)
+                                matrix(k, l) = r.get<Float>();
+                        props.set_transform3f(name, Transform3f(matrix));
+                    }
+                    break;
+
+                case CompiledTag::Transform4f: {
+                        Matrix4f matrix;
+                        for (size_t k = 0; k < 4; ++k)
+                            for (size_t l = 0; l < 4; ++l)
+                                matrix(k, l) = r.get<Float>();
+                        props.set_transform(name, Transform4f(matrix));
+                    }
+                    break;
+
+                case CompiledTag::TextureRGB: {
+                        bool within_emitter = r.get<uint8_t>() != 0;
+                        Color3f color;
+                        r.get_array(color.data(), 3);
+                        props.set_object(name, create_texture_from_rgb(
+                            name, color, ctx.variant, within_emitter));
+                    }
+                    break;
+
+                case CompiledTag::TextureSpectrum: {
+                        bool within_emitter = r.get<uint8_t>() != 0;
+                        Float const_value = r.get<Float>();
+                        std::vector<Float> wavelengths(r.get<uint32_t>()),
+                                           values(wavelengths.size());
+                        r.get_array(wavelengths.data(), wavelengths.size());
+                        r.get_array(values.data(), values.size());
+                        props.set_object(name, create_texture_from_spectrum(
+                            name, const_value, wavelengths, values, ctx.variant,
+                            within_emitter,
+                            ctx.color_mode == ColorMode::Spectral,
+                            ctx.color_mode == ColorMode::Monochromatic));
+                    }
+                    break;
+
+                default:
+                    Throw("\"%s\": invalid property tag %u!", filename,
+                          (uint32_t) prop_tag);
+            }
+        }
+
+#if defined(MI_ENABLE_LLVM) || defined(MI_ENABLE_CUDA)
+        if (ctx.backend && ctx.parallel) {
+            jit_new_scope((JitBackend) ctx.backend);
+            inst.scope = jit_scope((JitBackend) ctx.backend);
+        }
+#endif
+    }
+
+    if (ctx.instances.find(scene_id) == ctx.instances.end())
+        Throw("\"%s\": could not find the top-level object \"%s\"!", filename,
+              scene_id);
+
+    return scene_id;
+}
+
 ref<Object> create_texture_from_rgb(const std::string &name,
                                     Color<float, 3> color,
                                     const std::string &variant,
@@ -1266,6 +2338,23 @@ ref<Object> create_texture_from_spectrum(const std::string &name,
     }
 }
 
+template <typename Float, typename Spectrum>
+Properties::TensorHandle load_tensor_variant(const TensorFile *file,
+                                             const std::string &field) {
+    using TensorXf = typename CoreAliases<Float>::TensorXf;
+    return file->template tensor<TensorXf>(field);
+}
+
+Properties::TensorHandle load_tensor(const fs::path &filename,
+                                     const std::string &field,
+                                     const std::string &variant) {
+    fs::path path = Thread::thread()->file_resolver()->resolve(filename);
+    if (!fs::exists(path))
+        Throw("\"%s\": file does not exist!", path);
+    ref<TensorFile> file = new TensorFile(path);
+    return MI_INVOKE_VARIANT(variant, load_tensor_variant, file.get(), field);
+}
+
 std::vector<ref<Object>> expand_node(const ref<Object> &node) {
     std::vector<ref<Object>> sub_objects = node->expand();
     if (!sub_objects.empty())
@@ -1318,12 +2407,597 @@ std::vector<std::pair<std::string, Properties>> xml_to_properties(const fs::path
     }
 }
 
+// =============================================================================
+// === Incremental scene updates
+// =============================================================================
+
+/// Temporarily extends the file resolver of the current thread
+struct ScopedFileResolver {
+    ScopedFileResolver() : backup(Thread::thread()->file_resolver()) {
+        resolver = new FileResolver(*backup);
+        Thread::thread()->set_file_resolver(resolver.get());
+    }
+
+    ~ScopedFileResolver() { Thread::thread()->set_file_resolver(backup.get()); }
+
+    void append(const fs::path &path) {
+        if (!resolver->contains(path))
+            resolver->append(path);
+    }
+
+    ref<FileResolver> backup, resolver;
+};
+
+static std::string init_xml_parse_context_from_string(XMLParseContext &ctx,
+                                                      const std::string &string_,
+                                                      ParameterList param) {
+    // The parse context outlives this function, keep a copy of the string
+    auto string = std::make_shared<std::string>(string_);
+    pugi::xml_document doc;
+    pugi::xml_parse_result result = doc.load_buffer(string->c_str(), string->length(),
+                                                    pugi::parse_default |
+                                                    pugi::parse_comments);
+    detail::XMLSource src{
+        "<string>", doc,
+        [string](ptrdiff_t pos) { return detail::string_offset(*string, pos); }
+    };
+
+    if (!result) // There was a parser error
+        Throw("Error while loading \"%s\" (at %s): %s", src.id,
+              src.offset(result.offset), result.description());
+
+    pugi::xml_node root = doc.document_element();
+    Properties props;
+    size_t arg_counter = 0; // Unused
+    auto scene_id = parse_xml(src, ctx, root, Tag::Invalid, props,
+                              param, arg_counter, 0).second;
+
+    for (const auto& p : param) {
+        if (!std::get<2>(p))
+            Throw("Unused parameter \"%s\"!", std::get<0>(p));
+    }
+
+    return scene_id;
+}
+
+/// Copy the scene description of a parse context (without the objects)
+static std::unique_ptr<XMLParseContext> clone_context(const XMLParseContext &ctx) {
+    auto result = std::make_unique<XMLParseContext>(ctx.variant, false);
+    for (const auto &[id, inst] : ctx.instances) {
+        XMLObject &inst2 = result->instances[id];
+        inst2.props = inst.props;
+        inst2.class_ = inst.class_;
+        inst2.src_id = inst.src_id;
+        inst2.alias = inst.alias;
+        inst2.offset = inst.offset;
+        inst2.location = inst.location;
+    }
+    result->id_counter = ctx.id_counter;
+    return result;
+}
+
+/// Follow <alias> declarations to the object they refer to
+static const std::string &resolve_alias(const XMLParseContext &ctx,
+                                        const std::string &id) {
+    auto it = ctx.instances.find(id);
+    if (it == ctx.instances.end())
+        Throw("reference to unknown object \"%s\"!", id);
+    if (!it->second.alias.empty())
+        return resolve_alias(ctx, it->second.alias);
+    return it->first;
+}
+
+static bool is_anonymous(const std::string &id) {
+    return string::starts_with(id, "_unnamed_");
+}
+
+/// Maps inline textures to a description of the tag that created them
+using TextureKeys = std::unordered_map<const Object *, std::string>;
+
+static std::string texture_key(const CompiledTexture &tex) {
+    std::string key;
+    append_key(key, tex.spectrum);
+    append_key(key, tex.within_emitter);
+    append_key(key, tex.color);
+    append_key(key, tex.const_value);
+    append_key(key, tex.wavelengths.size());
+    key.append((const char *) tex.wavelengths.data(), tex.wavelengths.size() * sizeof(Float));
+    key.append((const char *) tex.values.data(), tex.values.size() * sizeof(Float));
+    return key;
+}
+
+/// Compute a key that identifies the value of a single property
+static std::string property_key(const Properties &props, const std::string &name,
+                                const TextureKeys &texture_keys) {
+    std::string key;
+    if (props.type(name) == Properties::Type::Object) {
+        const Object *obj = props.object(name).get();
+        auto it = texture_keys.find(obj);
+        if (it != texture_keys.end())
+            append_key(key, it->second);
+        else
+            append_key(key, obj);
+    } else {
+        Properties single;
+        single.copy_attribute(props, name, name);
+        key = structural_key(nullptr, single);
+        // Values that cannot be compared are considered as modified
+        if (key.empty())
+            append_key(key, &props);
+    }
+    return key;
+}
+
+/**
+ * \brief Compute a key that identifies an object along with all of its
+ * (nested) child objects, so that unchanged parts of a scene description can
+ * be recognized after it was parsed again
+ */
+static const std::string &update_key(const XMLParseContext &ctx,
+                                     const std::string &id_,
+                                     const TextureKeys &texture_keys,
+                                     std::unordered_map<std::string, std::string> &keys) {
+    const std::string &id = resolve_alias(ctx, id_);
+    auto it = keys.find(id);
+    if (it != keys.end())
+        return it->second;
+
+    const Properties &props = ctx.instances.find(id)->second.props;
+    std::string key;
+    append_key(key, ctx.instances.find(id)->second.class_);
+    append_key(key, props.plugin_name());
+
+    for (const std::string &name : props.property_names()) {
+        append_key(key, name);
+        if (props.type(name) == Properties::Type::NamedReference)
+            append_key(key, update_key(ctx, props.named_reference(name),
+                                       texture_keys, keys));
+        else
+            append_key(key, property_key(props, name, texture_keys));
+    }
+
+    return keys[id] = std::move(key);
+}
+
+/// Records the parameters and child objects exposed by \ref Object::traverse()
+struct ParameterCollector : public TraversalCallback {
+    void put_object(const std::string &name, Object *obj, uint32_t) override {
+        objects[name] = obj;
+    }
+
+    void put_parameter_impl(const std::string &name, void *ptr, uint32_t,
+                            const std::type_info &type) override {
+        params[name] = { ptr, &type };
+    }
+
+    std::unordered_map<std::string, Object *> objects;
+    std::unordered_map<std::string, std::pair<void *, const std::type_info *>> params;
+};
+
+/// Copy a parameter value if it has type \c T
+template <typename T, bool Opaque>
+bool copy_value(void *dst, const void *src, const std::type_info &type) {
+    if (type != typeid(T))
+        return false;
+
+    if (dst) {
+        T value = *(const T *) src;
+        // Avoid recompiling the kernels for every new value
+        if constexpr (Opaque)
+            dr::make_opaque(value);
+        *(T *) dst = value;
+    }
+
+    return true;
+}
+
+/**
+ * Copy a parameter exposed by \ref Object::traverse(). When \c dst is \c
+ * nullptr, only checks whether parameters of the given type are supported.
+ */
+template <typename Float, typename Spectrum>
+bool copy_parameter(void *dst, const void *src, const std::type_info &type) {
+    MI_IMPORT_CORE_TYPES()
+    using UnpolarizedSpectrum = unpolarized_spectrum_t<Spectrum>;
+    using FloatStorage = DynamicBuffer<Float>;
+    using UInt32Storage = DynamicBuffer<UInt32>;
+    constexpr bool JIT = dr::is_jit_v<Float>;
+
+    return copy_value<bool, false>(dst, src, type) ||
+           copy_value<int, false>(dst, src, type) ||
+           copy_value<uint32_t, false>(dst, src, type) ||
+           copy_value<ScalarFloat, false>(dst, src, type) ||
+           copy_value<ScalarColor3f, false>(dst, src, type) ||
+           copy_value<ScalarVector3f, false>(dst, src, type) ||
+           copy_value<ScalarPoint3f, false>(dst, src, type) ||
+           copy_value<ScalarTransform3f, false>(dst, src, type) ||
+           copy_value<ScalarTransform4f, false>(dst, src, type) ||
+           copy_value<Float, JIT>(dst, src, type) ||
+           copy_value<Color3f, JIT>(dst, src, type) ||
+           copy_value<Spectrum, JIT>(dst, src, type) ||
+           copy_value<UnpolarizedSpectrum, JIT>(dst, src, type) ||
+           copy_value<Vector3f, JIT>(dst, src, type) ||
+           copy_value<Point2f, JIT>(dst, src, type) ||
+           copy_value<Point3f, JIT>(dst, src, type) ||
+           copy_value<Transform3f, JIT>(dst, src, type) ||
+           copy_value<Transform4f, JIT>(dst, src, type) ||
+           copy_value<FloatStorage, false>(dst, src, type) ||
+           copy_value<UInt32Storage, false>(dst, src, type) ||
+           copy_value<TensorXf, false>(dst, src, type);
+}
+
+/**
+ * \brief Instantiate an object of a parsed scene description without
+ * modifying the description
+ *
+ * Child objects are taken from \ref XMLObject::object when \c fresh is \c
+ * nullptr. Otherwise, they are instantiated as well and recorded in \c fresh.
+ */
+static ref<Object> create_object(const XMLParseContext &ctx, const std::string &id,
+                                 std::unordered_map<std::string, ref<Object>> *fresh) {
+    const XMLObject &inst = ctx.instances.find(id)->second;
+    Properties props(inst.props);
+
+    for (auto &kv : inst.props.named_references()) {
+        const std::string &child_id = resolve_alias(ctx, kv.second);
+        ref<Object> obj;
+        if (fresh) {
+            auto it = fresh->find(child_id);
+            if (it == fresh->end())
+                it = fresh->emplace(child_id, create_object(ctx, child_id, fresh)).first;
+            obj = it->second;
+        } else {
+            obj = ctx.instances.find(child_id)->second.object;
+        }
+        Assert(obj);
+
+        std::vector<ref<Object>> children = obj->expand();
+        if (children.empty()) {
+            props.set_object(kv.first, obj, false);
+        } else if (children.size() == 1) {
+            props.set_object(kv.first, children[0], false);
+        } else {
+            int ctr = 0;
+            for (auto c : children)
+                props.set_object(kv.first + "_" + std::to_string(ctr++), c, false);
+        }
+    }
+
+    ref<Object> object;
+    try {
+        object = PluginManager::instance()->create_object(props, inst.class_);
+    } catch (const std::exception &e) {
+        Throw("Error while updating \"%s\" (near %s): could not instantiate "
+              "%s plugin of type \"%s\": %s",
+              inst.src_id, inst.offset(inst.location),
+              string::to_lower(inst.class_->name()), props.plugin_name(),
+              e.what());
+    }
+
+    auto unqueried = props.unqueried();
+    if (!unqueried.empty())
+        Throw("Error while updating \"%s\" (near %s): unreferenced %s %s in "
+              "%s plugin of type \"%s\"",
+              inst.src_id, inst.offset(inst.location),
+              unqueried.size() > 1 ? "properties" : "property", unqueried,
+              string::to_lower(inst.class_->name()), props.plugin_name());
+
+    return object;
+}
+
+/**
+ * \brief Applies the differences between two parsed versions of a scene
+ * description to the objects of the first one (see \ref SceneUpdater)
+ */
+struct SceneDiff {
+    enum class Status { Reused, Updated, Created };
+
+    SceneDiff(XMLParseContext &old_ctx, XMLParseContext &new_ctx,
+              const std::unordered_map<std::string, std::string> &old_keys,
+              const std::unordered_map<std::string, std::string> &new_keys,
+              TextureKeys &texture_keys)
+        : old_ctx(old_ctx), new_ctx(new_ctx), old_keys(old_keys),
+          new_keys(new_keys), texture_keys(texture_keys) { }
+
+    /// Update the scene, returns the ids of all updated or re-created objects
+    std::vector<std::string> apply(const std::string &new_root,
+                                   const std::string &old_root) {
+        for (const auto &[id, inst] : old_ctx.instances) {
+            auto it = old_keys.find(id);
+            if (inst.alias.empty() && is_anonymous(id) && it != old_keys.end())
+                pool[it->second].push_back(id);
+        }
+
+        correspond(new_root, old_root);
+        resolve(new_root);
+        return changed;
+    }
+
+protected:
+    /**
+     * Determine the previous version of each object. Objects with an \c id
+     * keep it, while anonymous objects are identified by the property name
+     * within their parent.
+     */
+    void correspond(const std::string &new_id, const std::string &old_id) {
+        if (!previous.emplace(new_id, old_id).second)
+            return;
+
+        const Properties &props = new_ctx.instances.find(new_id)->second.props;
+        const Properties *old_props =
+            old_id.empty() ? nullptr : &old_ctx.instances.find(old_id)->second.props;
+
+        for (auto &kv : props.named_references()) {
+            const std::string &child_id = resolve_alias(new_ctx, kv.second);
+            std::string old_child_id;
+            if (!is_anonymous(child_id)) {
+                if (old_ctx.instances.find(child_id) != old_ctx.instances.end())
+                    old_child_id = resolve_alias(old_ctx, child_id);
+            } else if (old_props && old_props->has_property(kv.first) &&
+                       old_props->type(kv.first) == Properties::Type::NamedReference) {
+                const std::string &id =
+                    resolve_alias(old_ctx, old_props->named_reference(kv.first));
+                if (is_anonymous(id))
+                    old_child_id = id;
+            }
+            correspond(child_id, old_child_id);
+        }
+    }
+
+    /// Can the new object \c new_id refer to the old object \c id?
+    bool available(const std::string &new_id, const std::string &id) const {
+        if (id.empty() || (is_anonymous(new_id) && used.find(id) != used.end()))
+            return false;
+        // Unreferenced objects were never instantiated
+        return (bool) old_ctx.instances.find(id)->second.object;
+    }
+
+    /// Update or create the new object \c id (after its child objects)
+    Status resolve(const std::string &id) {
+        auto it = status.find(id);
+        if (it != status.end())
+            return it->second;
+
+        const std::string &key = new_keys.find(id)->second;
+        std::string old_id = previous[id];
+
+        // Reuse unchanged objects along with all of their child objects
+        auto it_key = old_keys.find(old_id);
+        if (available(id, old_id) && it_key != old_keys.end() &&
+            it_key->second == key) {
+            reuse(id, old_id);
+            return Status::Reused;
+        }
+
+        if (is_anonymous(id)) {
+            auto it2 = pool.find(key);
+            if (it2 != pool.end()) {
+                for (const std::string &id2 : it2->second) {
+                    if (used.find(id2) == used.end()) {
+                        reuse(id, id2);
+                        return Status::Reused;
+                    }
+                }
+            }
+        }
+
+        XMLObject &inst = new_ctx.instances.find(id)->second;
+        std::vector<std::string> notify;
+        for (auto &kv : inst.props.named_references()) {
+            if (resolve(resolve_alias(new_ctx, kv.second)) == Status::Updated)
+                notify.push_back(kv.first);
+        }
+
+        Status result;
+        if (available(id, old_id) && update(id, old_id, notify)) {
+            used.insert(old_id);
+            result = Status::Updated;
+        } else {
+            inst.object = create_object(new_ctx, id, nullptr);
+            result = Status::Created;
+        }
+
+        status[id] = result;
+        changed.push_back(id);
+        return result;
+    }
+
+    /// Reuse the old object \c old_id and its children for \c id
+    void reuse(const std::string &id, const std::string &old_id) {
+        if (!status.emplace(id, Status::Reused).second)
+            return;
+
+        XMLObject &inst = new_ctx.instances.find(id)->second;
+        XMLObject &old_inst = old_ctx.instances.find(old_id)->second;
+        inst.object = old_inst.object;
+        used.insert(old_id);
+
+        for (const std::string &name : inst.props.property_names()) {
+            auto type = inst.props.type(name);
+            if (type == Properties::Type::NamedReference)
+                reuse(resolve_alias(new_ctx, inst.props.named_reference(name)),
+                      resolve_alias(old_ctx, old_inst.props.named_reference(name)));
+            else if (type == Properties::Type::Object)
+                replace_texture(inst.props, name, old_inst.props.object(name));
+        }
+    }
+
+    /// Refer to the existing version of an inline texture in the new description
+    void replace_texture(Properties &props, const std::string &name,
+                         const ref<Object> &obj) {
+        const Object *prev = props.object(name).get();
+        if (prev == obj.get())
+            return;
+
+        auto it = texture_keys.find(prev);
+        if (it != texture_keys.end()) {
+            texture_keys[obj.get()] = it->second;
+            texture_keys.erase(prev);
+        } else {
+            texture_keys.erase(obj.get());
+        }
+        props.set_object(name, obj, false);
+    }
+
+    bool copy(const ParameterCollector &src, const ParameterCollector &dst,
+              const std::string &name) {
+        auto it_src = src.params.find(name), it_dst = dst.params.find(name);
+        if (it_src == src.params.end() || it_dst == dst.params.end() ||
+            *it_src->second.second != *it_dst->second.second)
+            return false;
+
+        void *ptr_dst = it_dst->second.first;
+        const void *ptr_src = it_src->second.first;
+        const std::type_info &type = *it_dst->second.second;
+        return MI_INVOKE_VARIANT(new_ctx.variant, copy_parameter, ptr_dst,
+                                 ptr_src, type);
+    }
+
+    /// Copy all parameters of a temporary object into an existing one
+    void transfer(Object *src, Object *dst) {
+        ParameterCollector src_params, dst_params;
+        src->traverse(&src_params);
+        dst->traverse(&dst_params);
+
+        std::vector<std::string> keys;
+        for (auto &kv : dst_params.params) {
+            if (copy(src_params, dst_params, kv.first))
+                keys.push_back(kv.first);
+        }
+
+        for (auto &[name, obj] : dst_params.objects) {
+            auto it = src_params.objects.find(name);
+            if (it == src_params.objects.end() || !obj || !it->second ||
+                it->second == obj || it->second->class_() != obj->class_())
+                continue;
+            transfer(it->second, obj);
+            keys.push_back(name);
+        }
+
+        if (!keys.empty())
+            dst->parameters_changed(keys);
+    }
+
+    /**
+     * Try to update the old object \c old_id in place to match the new
+     * description of \c id. The child property names listed in \c notify
+     * refer to objects that were updated in place.
+     */
+    bool update(const std::string &id, const std::string &old_id,
+                const std::vector<std::string> &notify) {
+        XMLObject &inst = new_ctx.instances.find(id)->second;
+        const XMLObject &old_inst = old_ctx.instances.find(old_id)->second;
+        Properties &props = inst.props;
+        const Properties &old_props = old_inst.props;
+
+        std::vector<std::string> names = props.property_names(),
+                                 old_names = old_props.property_names();
+        if (inst.class_ != old_inst.class_ ||
+            props.plugin_name() != old_props.plugin_name() ||
+            std::set<std::string>(names.begin(), names.end()) !=
+                std::set<std::string>(old_names.begin(), old_names.end()))
+            return false;
+
+        Object *object = old_inst.object.get();
+        ParameterCollector old_params;
+        object->traverse(&old_params);
+
+        // Check that all modified properties can be updated in place
+        std::vector<std::string> params, textures;
+        bool geometry = false;
+        for (const std::string &name : names) {
+            auto type = props.type(name);
+            if (type != old_props.type(name))
+                return false;
+
+            if (type == Properties::Type::NamedReference) {
+                const std::string &child = resolve_alias(new_ctx, props.named_reference(name)),
+                                  &old_child = resolve_alias(old_ctx, old_props.named_reference(name));
+                if (new_ctx.instances.find(child)->second.object.get() !=
+                    old_ctx.instances.find(old_child)->second.object.get())
+                    return false;
+            } else if (property_key(props, name, texture_keys) !=
+                       property_key(old_props, name, texture_keys)) {
+                auto it_param = old_params.params.find(name);
+                auto it_obj = old_params.objects.find(name);
+                if (type == Properties::Type::Object) {
+                    if (it_obj == old_params.objects.end() ||
+                        it_obj->second != old_props.object(name).get() ||
+                        props.object(name)->class_() != it_obj->second->class_())
+                        return false;
+                    textures.push_back(name);
+                } else if (it_param != old_params.params.end() &&
+                           MI_INVOKE_VARIANT(new_ctx.variant, copy_parameter,
+                                             nullptr, nullptr, *it_param->second.second)) {
+                    params.push_back(name);
+                } else if ((name == "to_world" || name == "filename") &&
+                           old_params.params.find("vertex_positions") != old_params.params.end()) {
+                    // Meshes store transformed vertex positions
+                    geometry = true;
+                } else {
+                    return false;
+                }
+            }
+        }
+
+        std::vector<std::string> keys = notify;
+        if (!params.empty() || geometry) {
+            // Obtain the new parameter values from a temporary instance
+            std::unordered_map<std::string, ref<Object>> fresh;
+            ref<Object> temp = create_object(new_ctx, id, &fresh);
+            ParameterCollector new_params;
+            temp->traverse(&new_params);
+
+            if (geometry) {
+                params.clear();
+                for (auto &kv : old_params.params)
+                    params.push_back(kv.first);
+            }
+
+            for (const std::string &name : params) {
+                if (copy(new_params, old_params, name))
+                    keys.push_back(name);
+            }
+        }
+
+        for (const std::string &name : textures) {
+            transfer(props.object(name).get(), old_params.objects[name]);
+            keys.push_back(name);
+        }
+
+        // The existing inline textures now match the new description
+        for (const std::string &name : names) {
+            if (props.type(name) == Properties::Type::Object)
+                replace_texture(props, name, old_props.object(name));
+        }
+
+        inst.object = old_inst.object;
+        if (!keys.empty())
+            object->parameters_changed(keys);
+        return true;
+    }
+
+private:
+    XMLParseContext &old_ctx, &new_ctx;
+    const std::unordered_map<std::string, std::string> &old_keys, &new_keys;
+    TextureKeys &texture_keys;
+    /// Previous version (if any) of each new object
+    std::unordered_map<std::string, std::string> previous;
+    /// Anonymous old objects grouped by their key
+    std::unordered_map<std::string, std::vector<std::string>> pool;
+    /// Old objects that were reused or updated
+    std::unordered_set<std::string> used;
+    std::unordered_map<std::string, Status> status;
+    std::vector<std::string> changed;
+};
+
 NAMESPACE_END(detail)
 
 std::vector<ref<Object>> load_string(const std::string &string,
                                      const std::string &variant,
                                      ParameterList param,
-                                     bool parallel) {
+                                     bool parallel,
+                                     bool deduplicate) {
     ScopedPhase sp(ProfilerPhase::InitScene);
     pugi::xml_document doc;
     pugi::xml_parse_result result = doc.load_buffer(string.c_str(), string.length(),
@@ -1345,6 +3019,7 @@ std::vector<ref<Object>> load_string(const std::string &string,
     try {
         pugi::xml_node root = doc.document_element();
         detail::XMLParseContext ctx(variant, parallel);
+        ctx.deduplicate = deduplicate;
         Properties props;
         size_t arg_counter = 0; // Unused
         auto scene_id = detail::parse_xml(src, ctx, root, Tag::Invalid, props,
@@ -1354,6 +3029,7 @@ std::vector<ref<Object>> load_string(const std::string &string,
             if (!std::get<2>(p))
                 Throw("Unused parameter \"%s\"!", std::get<0>(p));
         }
+        detail::log_deduplication(ctx);
 
         ref<Object> top_node = detail::instantiate_top_node(ctx, scene_id);
         std::vector<ref<Object>> objects = detail::expand_node(top_node);
@@ -1370,7 +3046,9 @@ std::vector<ref<Object>> load_file(const fs::path &filename,
                                    const std::string &variant,
                                    ParameterList param,
                                    bool write_update,
-                                   bool parallel) {
+                                   bool parallel,
+                                   bool deduplicate,
+                                   bool streaming) {
     ScopedPhase sp(ProfilerPhase::InitScene);
 
     if (!fs::exists(filename))
@@ -1387,9 +3065,28 @@ std::vector<ref<Object>> load_file(const fs::path &filename,
 
     try {
         detail::XMLParseContext ctx(variant, parallel);
-        auto scene_id = detail::init_xml_parse_context_from_file(ctx, filename, param, write_update);
+        ctx.deduplicate = deduplicate;
+        ref<Object> top_node;
+        if (detail::is_compiled_file(filename)) {
+            if (!param.empty())
+                Throw("\"%s\": parameters cannot be specified when loading a "
+                      "compiled scene!", filename);
+            std::string scene_id =
+                detail::init_xml_parse_context_from_compiled(ctx, filename);
+            top_node = detail::instantiate_top_node(ctx, scene_id);
+        } else if (streaming) {
+            if (write_update)
+                Log(Warn, "\"%s\": updated scene files cannot be written when "
+                    "streaming, ignoring.", filename);
+            top_node = detail::load_file_streaming(ctx, filename, param);
+            detail::log_deduplication(ctx);
+        } else {
+            std::string scene_id = detail::init_xml_parse_context_from_file(
+                ctx, filename, param, write_update);
+            detail::log_deduplication(ctx);
+            top_node = detail::instantiate_top_node(ctx, scene_id);
+        }
 
-        ref<Object> top_node = detail::instantiate_top_node(ctx, scene_id);
         std::vector<ref<Object>> objects = detail::expand_node(top_node);
 
         Thread::thread()->set_file_resolver(fs_backup.get());
@@ -1404,5 +3101,201 @@ std::vector<ref<Object>> load_file(const fs::path &filename,
     }
 }
 
+void compile_file(const fs::path &filename,
+                  const fs::path &output,
+                  const std::string &variant,
+                  ParameterList param) {
+    if (!fs::exists(filename))
+        Throw("\"%s\": file does not exist!", filename);
+
+    Timer timer;
+    Log(Info, "Compiling XML file \"%s\" with variant \"%s\"..", filename, variant);
+
+    // Make a backup copy of the FileResolver, which will be restored after parsing
+    ref<FileResolver> fs_backup = Thread::thread()->file_resolver();
+    ref<FileResolver> fs = new FileResolver(*fs_backup);
+    fs->append(filename.parent_path());
+    Thread::thread()->set_file_resolver(fs.get());
+
+    try {
+        std::unordered_map<const Object *, detail::CompiledTexture> textures;
+        detail::XMLParseContext ctx(variant, false);
+        ctx.textures = &textures;
+
+        auto scene_id = detail::init_xml_parse_context_from_file(ctx, filename, param, false);
+        detail::write_compiled_file(ctx, scene_id, output);
+
+        Thread::thread()->set_file_resolver(fs_backup.get());
+
+        Log(Info, "Done compiling XML file \"%s\" to \"%s\" (took %s).",
+            filename, output, util::time_string((float) timer.value(), true));
+    } catch (...) {
+        Thread::thread()->set_file_resolver(fs_backup.get());
+        throw;
+    }
+}
+
+// =============================================================================
+// === SceneUpdater
+// =============================================================================
+
+struct SceneUpdater::SceneUpdaterPrivate {
+    std::string variant;
+    /// Directory of the original scene file
+    fs::path base;
+
+    /// Current scene description along with the instantiated objects
+    std::unique_ptr<detail::XMLParseContext> ctx;
+    std::string scene_id;
+    std::unordered_map<std::string, std::string> keys;
+    detail::TextureKeys texture_keys;
+    ref<Object> scene;
+
+    std::vector<std::string>
+    apply(std::unique_ptr<detail::XMLParseContext> new_ctx,
+          const std::string &new_scene_id,
+          const std::unordered_map<const Object *, detail::CompiledTexture> &textures) {
+        Timer timer;
+        for (auto &[obj, tex] : textures)
+            texture_keys[obj] = detail::texture_key(tex);
+
+        std::unordered_map<std::string, std::string> new_keys;
+        detail::update_key(*new_ctx, new_scene_id, texture_keys, new_keys);
+
+        detail::SceneDiff diff(*ctx, *new_ctx, keys, new_keys, texture_keys);
+        std::vector<std::string> changed = diff.apply(new_scene_id, scene_id);
+
+        // Forget about inline textures that are no longer referenced
+        detail::TextureKeys texture_keys_new;
+        for (auto &[id, inst] : new_ctx->instances) {
+            for (auto &kv : inst.props.objects(false)) {
+                auto it = texture_keys.find(kv.second.get());
+                if (it != texture_keys.end())
+                    texture_keys_new.insert(*it);
+            }
+        }
+
+        texture_keys = std::move(texture_keys_new);
+        keys = std::move(new_keys);
+        scene = new_ctx->instances.find(new_scene_id)->second.object;
+        scene_id = new_scene_id;
+        ctx = std::move(new_ctx);
+
+        Log(Info, "Updated %zu scene object%s (took %s).", changed.size(),
+            changed.size() == 1 ? "" : "s",
+            util::time_string((float) timer.value(), true));
+        return changed;
+    }
+};
+
+SceneUpdater::SceneUpdater(const fs::path &filename, const std::string &variant,
+                           ParameterList param)
+    : d(new SceneUpdaterPrivate()) {
+    ScopedPhase sp(ProfilerPhase::InitScene);
+
+    if (!fs::exists(filename))
+        Throw("\"%s\": file does not exist!", filename);
+    if (detail::is_compiled_file(filename))
+        Throw("\"%s\": compiled scenes cannot be updated incrementally!", filename);
+
+    Timer timer;
+    Log(Info, "Loading XML file \"%s\" with variant \"%s\"..", filename, variant);
+
+    d->variant = variant;
+    d->base = filename.parent_path();
+    detail::ScopedFileResolver resolver;
+    resolver.append(d->base);
+
+    auto ctx = std::make_unique<detail::XMLParseContext>(variant, true);
+    std::unordered_map<const Object *, detail::CompiledTexture> textures;
+    ctx->textures = &textures;
+    std::string scene_id =
+        detail::init_xml_parse_context_from_file(*ctx, filename, param, false);
+    ctx->textures = nullptr;
+
+    // Instantiation stores the child objects in the properties, which are
+    // needed in their original form to compare them against later versions
+    std::unordered_map<std::string, Properties> props;
+    for (auto &[id, inst] : ctx->instances)
+        props.emplace(id, inst.props);
+    d->scene = detail::instantiate_top_node(*ctx, scene_id);
+    for (auto &[id, p] : props)
+        ctx->instances.find(id)->second.props = std::move(p);
+
+    for (auto &[obj, tex] : textures)
+        d->texture_keys[obj] = detail::texture_key(tex);
+    detail::update_key(*ctx, scene_id, d->texture_keys, d->keys);
+    d->ctx = std::move(ctx);
+    d->scene_id = scene_id;
+
+    Log(Info, "Done loading XML file \"%s\" (took %s).",
+        filename, util::time_string((float) timer.value(), true));
+}
+
+SceneUpdater::~SceneUpdater() { }
+
+Object *SceneUpdater::scene() const { return d->scene.get(); }
+
+std::vector<std::string> SceneUpdater::update_file(const fs::path &filename,
+                                                   ParameterList param) {
+    ScopedPhase sp(ProfilerPhase::InitScene);
+
+    if (!fs::exists(filename))
+        Throw("\"%s\": file does not exist!", filename);
+
+    detail::ScopedFileResolver resolver;
+    resolver.append(d->base);
+    resolver.append(filename.parent_path());
+
+    auto ctx = std::make_unique<detail::XMLParseContext>(d->variant, false);
+    std::unordered_map<const Object *, detail::CompiledTexture> textures;
+    ctx->textures = &textures;
+    std::string scene_id =
+        detail::init_xml_parse_context_from_file(*ctx, filename, param, false);
+    ctx->textures = nullptr;
+
+    return d->apply(std::move(ctx), scene_id, textures);
+}
+
+std::vector<std::string> SceneUpdater::update_string(const std::string &string,
+                                                     ParameterList param) {
+    ScopedPhase sp(ProfilerPhase::InitScene);
+
+    detail::ScopedFileResolver resolver;
+    resolver.append(d->base);
+
+    auto ctx = std::make_unique<detail::XMLParseContext>(d->variant, false);
+    std::unordered_map<const Object *, detail::CompiledTexture> textures;
+    ctx->textures = &textures;
+    std::string scene_id =
+        detail::init_xml_parse_context_from_string(*ctx, string, param);
+    ctx->textures = nullptr;
+
+    return d->apply(std::move(ctx), scene_id, textures);
+}
+
+std::vector<std::string> SceneUpdater::update(const std::string &id,
+                                              const Properties &props) {
+    ScopedPhase sp(ProfilerPhase::InitScene);
+
+    detail::ScopedFileResolver resolver;
+    resolver.append(d->base);
+
+    std::unique_ptr<detail::XMLParseContext> ctx = detail::clone_context(*d->ctx);
+    if (ctx->instances.find(id) == ctx->instances.end())
+        Throw("SceneUpdater::update(): unknown object \"%s\"!", id);
+
+    Properties &target =
+        ctx->instances.find(detail::resolve_alias(*ctx, id))->second.props;
+    if (!props.plugin_name().empty())
+        target.set_plugin_name(props.plugin_name());
+    for (const std::string &name : props.property_names())
+        target.copy_attribute(props, name, name);
+
+    return d->apply(std::move(ctx), d->scene_id, {});
+}
+
+MI_IMPLEMENT_CLASS(SceneUpdater, Object)
+
 NAMESPACE_END(xml)
 NAMESPACE_END(mitsuba)
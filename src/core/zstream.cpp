@@ -1,13 +1,104 @@
 #include <mitsuba/core/zstream.h>
+#include <mitsuba/core/logger.h>
 #include <zlib.h>
+#include <cstring>
+#include <vector>
+
+#if defined(MI_HAS_ZSTD)
+#  include <zstd.h>
+#endif
+
+#if defined(MI_HAS_LZ4)
+#  include <lz4frame.h>
+#endif
 
 NAMESPACE_BEGIN(mitsuba)
 
-ZStream::ZStream(Stream *child_stream, EStreamType stream_type, int level)
-    : m_child_stream(child_stream),
-      m_deflate_stream(new z_stream()),
-      m_inflate_stream(new z_stream()),
+#if defined(MI_HAS_ZSTD)
+struct ZStream::ZstdState {
+    ZSTD_CCtx *cctx = ZSTD_createCCtx();
+    ZSTD_DCtx *dctx = ZSTD_createDCtx();
+
+    ~ZstdState() {
+        ZSTD_freeCCtx(cctx);
+        ZSTD_freeDCtx(dctx);
+    }
+};
+#else
+struct ZStream::ZstdState { };
+#endif
+
+#if defined(MI_HAS_LZ4)
+struct ZStream::LZ4State {
+    LZ4F_cctx *cctx = nullptr;
+    LZ4F_dctx *dctx = nullptr;
+    LZ4F_preferences_t prefs;
+    /// Output buffer, large enough for any call to the compression API
+    std::vector<uint8_t> buffer;
+    /// Was the frame header written?
+    bool started = false;
+
+    ~LZ4State() {
+        LZ4F_freeCompressionContext(cctx);
+        LZ4F_freeDecompressionContext(dctx);
+    }
+};
+
+/// Chunk size used when passing data to LZ4F_compressUpdate()
+static constexpr size_t kLZ4ChunkSize = 65536;
+#else
+struct ZStream::LZ4State { };
+#endif
+
+ZStream::ZStream(Stream *child_stream, EStreamType stream_type, int level,
+                 int threads)
+    : m_child_stream(child_stream), m_stream_type(stream_type),
       m_did_write(false) {
+    if (!has_backend(stream_type))
+        Throw("ZStream: the requested compression format is not supported "
+              "by this build of Mitsuba!");
+
+#if defined(MI_HAS_ZSTD)
+    if (stream_type == EZstdStream) {
+        m_zstd.reset(new ZstdState());
+        if (!m_zstd->cctx || !m_zstd->dctx)
+            Throw("Could not initialize zstd!");
+
+        size_t retval = ZSTD_CCtx_setParameter(
+            m_zstd->cctx, ZSTD_c_compressionLevel,
+            level == -1 ? ZSTD_CLEVEL_DEFAULT : level);
+        if (ZSTD_isError(retval))
+            Throw("Could not set the zstd compression level: %s",
+                  ZSTD_getErrorName(retval));
+
+        if (threads > 0) {
+            retval = ZSTD_CCtx_setParameter(m_zstd->cctx, ZSTD_c_nbWorkers,
+                                            threads);
+            if (ZSTD_isError(retval))
+                Log(Warn, "zstd was compiled without multithreading support, "
+                          "compressing on the calling thread.");
+        }
+        return;
+    }
+#endif
+
+#if defined(MI_HAS_LZ4)
+    if (stream_type == ELZ4Stream) {
+        m_lz4.reset(new LZ4State());
+        if (LZ4F_isError(LZ4F_createCompressionContext(&m_lz4->cctx, LZ4F_VERSION)) ||
+            LZ4F_isError(LZ4F_createDecompressionContext(&m_lz4->dctx, LZ4F_VERSION)))
+            Throw("Could not initialize LZ4!");
+
+        std::memset(&m_lz4->prefs, 0, sizeof(LZ4F_preferences_t));
+        m_lz4->prefs.compressionLevel = level == -1 ? 0 : level;
+        m_lz4->buffer.resize(LZ4F_compressBound(kLZ4ChunkSize, &m_lz4->prefs));
+        return;
+    }
+#endif
+
+    m_deflate_stream.reset(new z_stream());
+    m_inflate_stream.reset(new z_stream());
+
     m_deflate_stream->zalloc = Z_NULL;
     m_deflate_stream->zfree = Z_NULL;
     m_deflate_stream->opaque = Z_NULL;
@@ -31,9 +122,130 @@ ZStream::ZStream(Stream *child_stream, EStreamType stream_type, int level)
         Throw("Could not initialize ZLIB: error code %i", retval);
 }
 
+bool ZStream::has_backend(EStreamType stream_type) {
+    switch (stream_type) {
+        case EDeflateStream:
+        case EGZipStream:
+            return true;
+        case EZstdStream:
+#if defined(MI_HAS_ZSTD)
+            return true;
+#else
+            return false;
+#endif
+        case ELZ4Stream:
+#if defined(MI_HAS_LZ4)
+            return true;
+#else
+            return false;
+#endif
+        default:
+            return false;
+    }
+}
+
+ZStream::EStreamType ZStream::detect_type(Stream *stream) {
+    uint8_t magic[4] = { 0 };
+    size_t pos = stream->tell(),
+           count = std::min(sizeof(magic), stream->size() - pos);
+    stream->read(magic, count);
+    stream->seek(pos);
+
+    if (count >= 4 && magic[0] == 0x28 && magic[1] == 0xB5 &&
+        magic[2] == 0x2F && magic[3] == 0xFD)
+        return EZstdStream;
+    else if (count >= 4 && magic[0] == 0x04 && magic[1] == 0x22 &&
+             magic[2] == 0x4D && magic[3] == 0x18)
+        return ELZ4Stream;
+    else if (count >= 2 && magic[0] == 0x1F && magic[1] == 0x8B)
+        return EGZipStream;
+    else
+        return EDeflateStream;
+}
+
+void ZStream::refill(size_t size) {
+    size_t remaining = m_child_stream->size() - m_child_stream->tell();
+    m_inflate_pos = 0;
+    m_inflate_size = std::min(remaining, sizeof(m_inflate_buffer));
+    if (m_inflate_size == 0)
+        Throw("Read less data than expected (%i more bytes required)", size);
+    m_child_stream->read(m_inflate_buffer, m_inflate_size);
+}
+
+void ZStream::write_frames(const void *ptr, size_t size, int mode) {
+#if defined(MI_HAS_ZSTD)
+    if (m_zstd) {
+        ZSTD_EndDirective directive =
+            mode == 0 ? ZSTD_e_continue : (mode == 1 ? ZSTD_e_flush : ZSTD_e_end);
+        ZSTD_inBuffer in = { ptr, size, 0 };
+        bool done;
+
+        do {
+            ZSTD_outBuffer out = { m_deflate_buffer, sizeof(m_deflate_buffer), 0 };
+            size_t retval = ZSTD_compressStream2(m_zstd->cctx, &out, &in, directive);
+            if (ZSTD_isError(retval))
+                Throw("ZSTD_compressStream2(): %s", ZSTD_getErrorName(retval));
+
+            m_child_stream->write(m_deflate_buffer, out.pos);
+
+            // Otherwise, 'retval' is the amount of data that remains to be flushed
+            done = mode == 0 ? in.pos == in.size : retval == 0;
+        } while (!done);
+        return;
+    }
+#endif
+
+#if defined(MI_HAS_LZ4)
+    if (m_lz4) {
+        uint8_t *buffer = m_lz4->buffer.data();
+        size_t capacity = m_lz4->buffer.size(), output_size;
+
+        if (!m_lz4->started) {
+            output_size = LZ4F_compressBegin(m_lz4->cctx, buffer, capacity,
+                                             &m_lz4->prefs);
+            if (LZ4F_isError(output_size))
+                Throw("LZ4F_compressBegin(): %s", LZ4F_getErrorName(output_size));
+            m_child_stream->write(buffer, output_size);
+            m_lz4->started = true;
+        }
+
+        const uint8_t *src = (const uint8_t *) ptr;
+        while (size > 0) {
+            size_t chunk = std::min(size, kLZ4ChunkSize);
+            output_size = LZ4F_compressUpdate(m_lz4->cctx, buffer, capacity,
+                                              src, chunk, nullptr);
+            if (LZ4F_isError(output_size))
+                Throw("LZ4F_compressUpdate(): %s", LZ4F_getErrorName(output_size));
+            m_child_stream->write(buffer, output_size);
+            src += chunk;
+            size -= chunk;
+        }
+
+        if (mode != 0) {
+            output_size = mode == 1
+                ? LZ4F_flush(m_lz4->cctx, buffer, capacity, nullptr)
+                : LZ4F_compressEnd(m_lz4->cctx, buffer, capacity, nullptr);
+            if (LZ4F_isError(output_size))
+                Throw("%s(): %s", mode == 1 ? "LZ4F_flush" : "LZ4F_compressEnd",
+                      LZ4F_getErrorName(output_size));
+            m_child_stream->write(buffer, output_size);
+        }
+        return;
+    }
+#endif
+
+    (void) ptr; (void) size; (void) mode;
+}
+
 void ZStream::write(const void *ptr, size_t size) {
     Assert(m_child_stream != nullptr);
 
+    if (m_stream_type == EZstdStream || m_stream_type == ELZ4Stream) {
+        write_frames(ptr, size, 0);
+        m_did_write = true;
+        return;
+    }
+
     m_deflate_stream->avail_in = (uInt) size;
     m_deflate_stream->next_in = (uint8_t *) ptr;
 
@@ -60,6 +272,48 @@ void ZStream::read(void *ptr, size_t size) {
     Assert(m_child_stream != nullptr);
 
     uint8_t *targetPtr = (uint8_t *) ptr;
+
+#if defined(MI_HAS_ZSTD)
+    if (m_zstd) {
+        while (size > 0) {
+            if (m_inflate_pos == m_inflate_size)
+                refill(size);
+
+            ZSTD_inBuffer in = { m_inflate_buffer, m_inflate_size, m_inflate_pos };
+            ZSTD_outBuffer out = { targetPtr, size, 0 };
+            size_t retval = ZSTD_decompressStream(m_zstd->dctx, &out, &in);
+            if (ZSTD_isError(retval))
+                Throw("ZSTD_decompressStream(): %s", ZSTD_getErrorName(retval));
+
+            m_inflate_pos = in.pos;
+            targetPtr += out.pos;
+            size -= out.pos;
+        }
+        return;
+    }
+#endif
+
+#if defined(MI_HAS_LZ4)
+    if (m_lz4) {
+        while (size > 0) {
+            if (m_inflate_pos == m_inflate_size)
+                refill(size);
+
+            size_t in_size = m_inflate_size - m_inflate_pos, out_size = size;
+            size_t retval = LZ4F_decompress(m_lz4->dctx, targetPtr, &out_size,
+                                            m_inflate_buffer + m_inflate_pos,
+                                            &in_size, nullptr);
+            if (LZ4F_isError(retval))
+                Throw("LZ4F_decompress(): %s", LZ4F_getErrorName(retval));
+
+            m_inflate_pos += in_size;
+            targetPtr += out_size;
+            size -= out_size;
+        }
+        return;
+    }
+#endif
+
     while (size > 0) {
         if (m_inflate_stream->avail_in == 0) {
             size_t remaining = m_child_stream->size() - m_child_stream->tell();
@@ -101,7 +355,10 @@ void ZStream::read(void *ptr, size_t size) {
 void ZStream::flush() {
     Assert(m_child_stream != nullptr);
 
-    if (m_did_write) {
+    if (m_did_write && !m_deflate_stream) {
+        write_frames(nullptr, 0, 1);
+        m_child_stream->flush();
+    } else if (m_did_write) {
         m_deflate_stream->avail_in = 0;
         m_deflate_stream->next_in = NULL;
         int output_size = 0;
@@ -127,6 +384,15 @@ void ZStream::close() {
     if (!m_child_stream)
         return;
 
+    if (!m_deflate_stream) {
+        if (m_did_write)
+            write_frames(nullptr, 0, 2);
+        m_zstd.reset();
+        m_lz4.reset();
+        m_child_stream = nullptr;
+        return;
+    }
+
     if (m_did_write) {
         m_deflate_stream->avail_in = 0;
         m_deflate_stream->next_in = NULL;
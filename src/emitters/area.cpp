@@ -1,8 +1,10 @@
+#include <mitsuba/core/distr_2d.h>
 #include <mitsuba/core/properties.h>
 #include <mitsuba/core/warp.h>
 #include <mitsuba/core/spectrum.h>
 #include <mitsuba/render/emitter.h>
 #include <mitsuba/render/medium.h>
+#include <mitsuba/render/mesh.h>
 #include <mitsuba/render/shape.h>
 #include <mitsuba/render/texture.h>
 
@@ -22,6 +24,13 @@ Area light (:monosp:`area`)
    - Specifies the emitted radiance in units of power per unit area per unit steradian.
    - |exposed|, |differentiable|
 
+ * - joint_sampling
+   - |bool|
+   - When the radiance is textured and the parent shape is a mesh with texture
+     coordinates, sample positions proportionally to the emitted radiance per
+     unit *surface area* rather than per unit of texture space. See below for
+     details. (Default: true)
+
 This plugin implements an area light, i.e. a light source that emits
 diffuse illumination from the exterior of an arbitrary shape.
 Since the emission profile of an area light is completely diffuse, it
@@ -53,13 +62,30 @@ emitter shape and specify an :monosp:`area` instance as its child:
             }
         }
 
+When the radiance is given by a texture, emitter sampling by default draws
+texture coordinates according to the texture's own importance sampling
+scheme and maps them onto the shape. This neglects how much surface area the
+parameterization assigns to each texel, and texels that are not covered by
+any part of the shape produce wasted samples. For meshes with texture
+coordinates, the plugin therefore builds a joint distribution over a texel
+grid when the shape is attached or its parameters change: every triangle is
+clipped against the texels it overlaps, and each texel accumulates the
+surface area of the covered parts multiplied by an upper bound of the
+texture's luminance within the texel. Positions are then sampled uniformly
+within a texel chosen from this distribution, which makes the density
+proportional to the emitted radiance per unit surface area (up to the
+resolution of the grid). A small fraction of the mass is spread according
+to surface area alone, which guarantees that all emitting regions remain
+reachable.
+
  */
 
 template <typename Float, typename Spectrum>
 class AreaLight final : public Emitter<Float, Spectrum> {
 public:
     MI_IMPORT_BASE(Emitter, m_flags, m_shape, m_medium)
-    MI_IMPORT_TYPES(Scene, Shape, Texture)
+    MI_IMPORT_TYPES(Scene, Shape, Mesh, Texture)
+    using typename Base::LightBounds;
 
     AreaLight(const Properties &props) : Base(props) {
         if (props.has_property("to_world"))
@@ -68,6 +94,7 @@ public:
                   "shape.");
 
         m_radiance = props.texture_d65<Texture>("radiance", 1.f);
+        m_joint_sampling = props.get<bool>("joint_sampling", true);
 
         m_flags = +EmitterFlags::Surface;
         if (m_radiance->is_spatially_varying())
@@ -80,6 +107,17 @@ public:
         callback->put_object("radiance", m_radiance.get(), +ParamFlags::Differentiable);
     }
 
+    void set_shape(Shape *shape) override {
+        Base::set_shape(shape);
+        build_uv_distr();
+    }
+
+    void parameters_changed(const std::vector<std::string> &keys = {}) override {
+        // Both the texture and the parent mesh influence the joint distribution
+        build_uv_distr();
+        Base::parameters_changed(keys);
+    }
+
     Spectrum eval(const SurfaceInteraction3f &si, Mask active) const override {
         MI_MASKED_FUNCTION(ProfilerPhase::EndpointEvaluate, active);
 
@@ -138,7 +176,7 @@ public:
             si = SurfaceInteraction3f(ds, it.wavelengths);
         } else {
             // Importance sample the texture, then map onto the shape
-            auto [uv, pdf] = m_radiance->sample_position(sample, active);
+            auto [uv, pdf] = sample_uv(sample, active);
             active &= dr::neq(pdf, 0.f);
 
             si = m_shape->eval_parameterization(uv, +RayFlags::All, active);
@@ -189,7 +227,7 @@ public:
             SurfaceInteraction3f si = m_shape->eval_parameterization(ds.uv, +RayFlags::dPdUV, active);
             active &= si.is_valid();
 
-            value = m_radiance->pdf_position(ds.uv, active) * dr::sqr(ds.dist) /
+            value = pdf_uv(ds.uv, active) * dr::sqr(ds.dist) /
                     (dr::norm(dr::cross(si.dp_du, si.dp_dv)) * -dp);
         }
 
@@ -228,7 +266,7 @@ public:
             ps = m_shape->sample_position(time, sample, active);
         } else {
             // Importance sample texture
-            auto [uv, pdf] = m_radiance->sample_position(sample, active);
+            auto [uv, pdf] = sample_uv(sample, active);
             active &= dr::neq(pdf, 0.f);
 
             auto si = m_shape->eval_parameterization(uv, +RayFlags::All, active);
@@ -253,6 +291,19 @@ public:
 
     ScalarBoundingBox3f bbox() const override { return m_shape->bbox(); }
 
+    LightBounds light_bounds() const override {
+        LightBounds lb;
+        auto [axis, theta_o] = m_shape->normal_bounds();
+        lb.bbox    = m_shape->bbox();
+        lb.power   = dr::Pi<ScalarFloat> *
+                     (ScalarFloat) dr::slice(m_shape->surface_area()) *
+                     (ScalarFloat) dr::slice(m_radiance->mean());
+        lb.axis    = axis;
+        lb.theta_o = theta_o;
+        lb.theta_e = .5f * dr::Pi<ScalarFloat>;
+        return lb;
+    }
+
     std::string to_string() const override {
         std::ostringstream oss;
         oss << "AreaLight[" << std::endl
@@ -268,8 +319,224 @@ public:
     }
 
     MI_DECLARE_CLASS()
+private:
+    /// Sample texture coordinates, using the joint distribution if available
+    std::pair<Point2f, Float> sample_uv(const Point2f &sample, Mask active) const {
+        if (!m_uv_distr)
+            return m_radiance->sample_position(sample, active);
+
+        auto [pos, pdf, sample2] = m_uv_distr->sample(sample, active);
+        ScalarVector2f res(m_uv_res);
+        return { (Point2f(pos) + sample2) / res, pdf * dr::prod(res) };
+    }
+
+    /// Density of \ref sample_uv() with respect to the unit square
+    Float pdf_uv(const Point2f &uv, Mask active) const {
+        if (!m_uv_distr)
+            return m_radiance->pdf_position(uv, active);
+
+        ScalarVector2f res(m_uv_res);
+        Point2u pos = dr::minimum(Point2u(Point2i(dr::clamp(uv, 0.f, 1.f) * res)),
+                                  m_uv_res - 1u);
+        return m_uv_distr->pdf(pos, active) * dr::prod(res);
+    }
+
+    /**
+     * \brief Build the joint distribution of surface area and emission over a
+     * texel grid (see the plugin documentation)
+     *
+     * This only happens for textured emitters that are attached to meshes with
+     * texture coordinates; otherwise, \ref sample_uv() falls back to sampling
+     * the texture.
+     */
+    void build_uv_distr() {
+        m_uv_distr.reset();
+
+        if (!m_joint_sampling || !m_shape || !m_shape->is_mesh() ||
+            !m_radiance->is_spatially_varying())
+            return;
+
+        const Mesh *mesh = static_cast<const Mesh *>(m_shape);
+        if (!mesh->has_vertex_texcoords() || mesh->face_count() == 0)
+            return;
+
+        // Use the texture resolution, or a fixed grid for procedural textures
+        ScalarVector2i tex_res = m_radiance->resolution();
+        m_uv_res = dr::all(tex_res > 1) ? ScalarVector2u(tex_res)
+                                        : ScalarVector2u(256, 256);
+        ScalarVector2f res(m_uv_res);
+        uint32_t face_count = (uint32_t) mesh->face_count(),
+                 texel_count = dr::prod(m_uv_res);
+
+        // 1. Fetch the vertex positions and texture coordinates of all faces
+        std::vector<ScalarFloat> area(face_count), uv(face_count * 6);
+        if constexpr (dr::is_jit_v<Float>) {
+            UInt32 face = dr::arange<UInt32>(face_count);
+            Vector3u fi = mesh->face_indices(face);
+            Point3f p0 = mesh->vertex_position(fi[0]),
+                    p1 = mesh->vertex_position(fi[1]),
+                    p2 = mesh->vertex_position(fi[2]);
+            Float face_area = .5f * dr::norm(dr::cross(p1 - p0, p2 - p0));
+
+            dr::Array<Float, 6> face_uv;
+            for (size_t i = 0; i < 3; ++i) {
+                Point2f t = mesh->vertex_texcoord(fi[i]);
+                face_uv[2 * i] = t.x();
+                face_uv[2 * i + 1] = t.y();
+            }
+
+            auto &&area_h = dr::migrate(dr::detach(face_area), AllocType::Host);
+            auto &&uv_h = dr::migrate(dr::ravel(dr::detach(face_uv)), AllocType::Host);
+            dr::sync_thread();
+            memcpy(area.data(), area_h.data(), face_count * sizeof(ScalarFloat));
+            memcpy(uv.data(), uv_h.data(), face_count * 6 * sizeof(ScalarFloat));
+        } else {
+            for (uint32_t f = 0; f < face_count; ++f) {
+                ScalarVector3u fi = mesh->face_indices(f);
+                ScalarPoint3f p0 = mesh->vertex_position(fi[0]),
+                              p1 = mesh->vertex_position(fi[1]),
+                              p2 = mesh->vertex_position(fi[2]);
+                area[f] = .5f * dr::norm(dr::cross(p1 - p0, p2 - p0));
+                for (size_t i = 0; i < 3; ++i) {
+                    ScalarPoint2f t = mesh->vertex_texcoord(fi[i]);
+                    uv[6 * f + 2 * i] = t.x();
+                    uv[6 * f + 2 * i + 1] = t.y();
+                }
+            }
+        }
+
+        // 2. Rasterize the surface area of every face into the texel grid
+        std::vector<ScalarFloat> texel_area(texel_count, 0.f);
+        for (uint32_t f = 0; f < face_count; ++f) {
+            ScalarPoint2f t[3];
+            for (size_t i = 0; i < 3; ++i)
+                t[i] = ScalarPoint2f(uv[6 * f + 2 * i], uv[6 * f + 2 * i + 1]) * res;
+
+            // Surface area per unit of texel area
+            ScalarFloat uv_area = .5f * dr::abs(dr::cross(
+                ScalarVector3f(t[1].x() - t[0].x(), t[1].y() - t[0].y(), 0.f),
+                ScalarVector3f(t[2].x() - t[0].x(), t[2].y() - t[0].y(), 0.f)).z());
+            if (!(uv_area > 0.f) || !(area[f] > 0.f))
+                continue;
+            ScalarFloat jacobian = area[f] / uv_area;
+
+            ScalarPoint2f min = dr::minimum(dr::minimum(t[0], t[1]), t[2]),
+                          max = dr::maximum(dr::maximum(t[0], t[1]), t[2]);
+            ScalarPoint2i min_i = dr::maximum(ScalarPoint2i(dr::floor(min)), 0),
+                          max_i = dr::minimum(ScalarPoint2i(dr::ceil(max)),
+                                              ScalarPoint2i(m_uv_res));
+
+            for (int y = min_i.y(); y < max_i.y(); ++y) {
+                for (int x = min_i.x(); x < max_i.x(); ++x) {
+                    ScalarFloat overlap = clipped_area(t, ScalarPoint2f(x, y));
+                    texel_area[y * m_uv_res.x() + x] += jacobian * overlap;
+                }
+            }
+        }
+
+        /* 3. Bound the luminance within each texel by its values at the
+              texel corners, which is exact for bilinear interpolation */
+        ScalarVector2u corner_res = m_uv_res + 1u;
+        uint32_t corner_count = dr::prod(corner_res);
+        std::vector<ScalarFloat> corner_lum(corner_count);
+        Wavelength wavelengths = sample_wavelength<Float, Spectrum>(.5f).first;
+
+        if constexpr (dr::is_jit_v<Float>) {
+            UInt32 index = dr::arange<UInt32>(corner_count),
+                   y = index / corner_res.x(),
+                   x = index - y * corner_res.x();
+            SurfaceInteraction3f si = dr::zeros<SurfaceInteraction3f>(corner_count);
+            si.uv = Point2f(Float(x), Float(y)) / res;
+            si.wavelengths = wavelengths;
+            Float lum = luminance(m_radiance->eval(si), wavelengths);
+
+            auto &&lum_h = dr::migrate(dr::detach(lum), AllocType::Host);
+            dr::sync_thread();
+            memcpy(corner_lum.data(), lum_h.data(), corner_count * sizeof(ScalarFloat));
+        } else {
+            SurfaceInteraction3f si = dr::zeros<SurfaceInteraction3f>();
+            si.wavelengths = wavelengths;
+            for (uint32_t y = 0; y < corner_res.y(); ++y) {
+                for (uint32_t x = 0; x < corner_res.x(); ++x) {
+                    si.uv = ScalarPoint2f(x, y) / res;
+                    corner_lum[y * corner_res.x() + x] =
+                        luminance(m_radiance->eval(si), wavelengths);
+                }
+            }
+        }
+
+        // 4. Combine both and mix in a fraction proportional to the area alone
+        std::vector<ScalarFloat> texel_weight(texel_count);
+        double total_area = 0.0, total_weight = 0.0;
+        for (uint32_t y = 0; y < m_uv_res.y(); ++y) {
+            for (uint32_t x = 0; x < m_uv_res.x(); ++x) {
+                uint32_t i = y * corner_res.x() + x;
+                ScalarFloat lum = dr::maximum(
+                    dr::maximum(corner_lum[i], corner_lum[i + 1]),
+                    dr::maximum(corner_lum[i + corner_res.x()],
+                                corner_lum[i + corner_res.x() + 1]));
+                lum = dr::maximum(lum, 0.f);
+
+                uint32_t j = y * m_uv_res.x() + x;
+                texel_weight[j] = texel_area[j] * lum;
+                total_area += (double) texel_area[j];
+                total_weight += (double) texel_weight[j];
+            }
+        }
+
+        if (!(total_area > 0.0))
+            return;
+
+        ScalarFloat mean_lum = (ScalarFloat) (total_weight / total_area),
+                    offset = mean_lum > 0.f ? .1f * mean_lum : 1.f;
+        for (uint32_t j = 0; j < texel_count; ++j)
+            texel_weight[j] += texel_area[j] * offset;
+
+        m_uv_distr = std::make_unique<DiscreteDistribution2D<Float>>(
+            texel_weight.data(), m_uv_res);
+    }
+
+    /// Area of the intersection of a triangle and the unit texel at \c p
+    static ScalarFloat clipped_area(const ScalarPoint2f *t, const ScalarPoint2f &p) {
+        // Sutherland-Hodgman clipping against the four sides of the texel
+        std::array<ScalarPoint2f, 7> poly, tmp;
+        size_t n = 3;
+        for (size_t i = 0; i < 3; ++i)
+            poly[i] = t[i];
+
+        for (size_t side = 0; side < 4 && n > 0; ++side) {
+            size_t axis = side / 2;
+            ScalarFloat bound = p[axis] + (side & 1 ? 1.f : 0.f),
+                        sign  = side & 1 ? -1.f : 1.f;
+
+            size_t m = 0;
+            for (size_t i = 0; i < n; ++i) {
+                const ScalarPoint2f &a = poly[i], &b = poly[(i + 1) % n];
+                ScalarFloat da = sign * (a[axis] - bound),
+                            db = sign * (b[axis] - bound);
+                if (da >= 0.f)
+                    tmp[m++] = a;
+                if ((da >= 0.f) != (db >= 0.f))
+                    tmp[m++] = dr::lerp(a, b, da / (da - db));
+            }
+            poly = tmp;
+            n = m;
+        }
+
+        ScalarFloat result = 0.f;
+        for (size_t i = 0; i < n; ++i) {
+            const ScalarPoint2f &a = poly[i], &b = poly[(i + 1) % n];
+            result += a.x() * b.y() - a.y() * b.x();
+        }
+
+        return .5f * dr::abs(result);
+    }
+
 private:
     ref<Texture> m_radiance;
+    bool m_joint_sampling;
+    std::unique_ptr<DiscreteDistribution2D<Float>> m_uv_distr;
+    ScalarVector2u m_uv_res;
 };
 
 MI_IMPLEMENT_CLASS_VARIANT(AreaLight, Emitter)
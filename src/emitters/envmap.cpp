@@ -21,7 +21,7 @@ Environment emitter (:monosp:`envmap`)
 --------------------------------------
 
 .. pluginparameters::
- :extra-rows: 4
+ :extra-rows: 7
 
  * - filename
    - |string|
@@ -47,7 +47,35 @@ Environment emitter (:monosp:`envmap`)
    - |bool|
    - Compensate sampling for the presence of other Monte Carlo techniques that
      will be combined using multiple importance sampling (MIS)? This is
-     extremely cheap to do and can slightly reduce variance. (Default: false)
+     extremely cheap to do and can slightly reduce variance. See below for
+     details. (Default: false)
+
+ * - mis_compensation_fraction
+   - |float|
+   - Fraction of the mean luminance that is subtracted from the sampling
+     distribution when :monosp:`mis_compensation` is enabled. (Default: 1.0)
+
+ * - warp_update_interval
+   - |int|
+   - Rebuild the importance sampling warp only every N-th time that the
+     radiance data is updated (e.g. via :monosp:`mi.traverse()` during an
+     optimization). Until then, the previous warp is used, which remains
+     unbiased as long as it doesn't vanish where the updated radiance is
+     nonzero. (Default: 1, i.e. rebuild after every update)
+
+ * - product_sampling
+   - |bool|
+   - When sampling a direction from a surface point, importance sample the
+     product of the environment map and a conservative bound of the cosine
+     term with respect to the surface normal instead of the environment map
+     alone. See below for details. (Default: false)
+
+ * - product_defensive
+   - |float|
+   - Fraction of the cosine weight that is also given to directions below
+     the surface when :monosp:`product_sampling` is enabled. It must be
+     positive so that transmissive materials can still receive light from
+     behind. (Default: 0.1)
 
  * - data
    - |tensor|
@@ -79,6 +107,28 @@ High quality free light probes are available on
 `Bernhard Vogl's <http://dativ.at/lightprobes/>`_ website or
 `Polyhaven <https://polyhaven.com/hdris>`_.
 
+With :monosp:`product_sampling` enabled, the sample warping scheme descends
+the MIP hierarchy of the luminance map as usual but multiplies the mass of
+every node by an upper bound of the clamped cosine on the corresponding
+region of the sphere. Samples thus concentrate on bright regions that face
+the surface, which substantially reduces the variance of emitter sampling
+on surfaces lit by several bright sources, especially when some of them lie
+below the horizon. Every sample costs one cosine bound evaluation per level
+of the hierarchy. Interactions without a normal (e.g. in participating
+media) fall back to the standard strategy.
+
+With :monosp:`mis_compensation` enabled, the distribution used to sample
+directions toward the emitter is built from the luminance minus a fraction of
+its mean over the sphere (clamped to zero), following "MIS Compensation:
+Optimizing Sampling Techniques in Multiple Importance Sampling" by Karlík et
+al. Dim regions, which BSDF sampling already handles well, then no longer
+receive emitter samples. Their density is zero, so this is only unbiased when
+emitter sampling is combined with BSDF sampling via MIS, as done by the
+:ref:`path <integrator-path>` and :ref:`volpath <integrator-volpath>`
+integrators. Rays emitted by :monosp:`sample_ray()` (e.g. by the particle
+tracer) keep using the uncompensated distribution. Maps that are close to
+constant would lose almost all of their density, and are left uncompensated.
+
 .. tabs::
     .. code-tab:: xml
         :name: envmap-light
@@ -101,6 +151,7 @@ public:
     MI_IMPORT_TYPES(Scene, Shape, Texture)
 
     using Warp = Hierarchical2D<Float, 0>;
+    using FloatStorage = DynamicBuffer<Float>;
 
     /* In RGB variants: 3-channel array for R, G, and B components
        In spectral variants: 4-channel array for polynomial coefficients & scale */
@@ -160,28 +211,12 @@ public:
         /* "MIS Compensation: Optimizing Sampling Techniques in Multiple
            Importance Sampling" Ondrej Karlik, Martin Sik, Petr Vivoda, Tomas
            Skrivan, and Jaroslav Krivanek. SIGGRAPH Asia 2019 */
-        ScalarFloat luminance_offset = 0.f;
+        m_mis_compensation = 0.f;
         if (props.get<bool>("mis_compensation", false)) {
-            ScalarFloat min_lum = 0.f;
-            double lum_accum_d = 0.0;
-
-            for (size_t y = 0; y < bitmap->size().y(); ++y) {
-                for (size_t x = 0; x < bitmap->size().x(); ++x) {
-                    ScalarColor3f rgb = dr::load<ScalarVector3f>(in_ptr);
-                    ScalarFloat lum = mitsuba::luminance(rgb);
-                    min_lum = dr::minimum(min_lum, lum);
-                    lum_accum_d += (double) lum;
-                    in_ptr += 4;
-                }
-            }
-            in_ptr = (ScalarFloat *) bitmap->data();
-
-            luminance_offset = ScalarFloat(lum_accum_d / dr::prod(bitmap->size()));
-
-            /* Be wary of constant environment maps: average and minimum
-               should be sufficiently different */
-            if (luminance_offset - min_lum <= 0.01f * luminance_offset)
-                luminance_offset = 0.f; // disable
+            m_mis_compensation =
+                props.get<ScalarFloat>("mis_compensation_fraction", 1.f);
+            if (m_mis_compensation <= 0.f)
+                Throw("The MIS compensation fraction must be positive!");
         }
 
         size_t pixel_width = is_spectral_v<Spectrum> ? 4 : 3;
@@ -206,12 +241,10 @@ public:
                        which generally yields a fairly smooth spectrum. */
                     ScalarFloat scale = dr::max(rgb) * 2.f;
                     ScalarColor3f rgb_norm = rgb / dr::maximum(1e-8f, scale);
-                    coeff = dr::concat((ScalarColor3f) srgb_model_fetch(rgb_norm),
-                                       dr::Array<ScalarFloat, 1>(scale));
+                    // Converted into coefficients below (in a single batch)
+                    coeff = dr::concat(rgb_norm, dr::Array<ScalarFloat, 1>(scale));
                 }
 
-                lum = dr::maximum(lum - luminance_offset, 0.f);
-
                 *lum_ptr++ = lum * sin_theta;
                 dr::store(out_ptr, coeff);
                 in_ptr += pixel_width;
@@ -226,11 +259,24 @@ public:
             out_ptr += pixel_width;
         }
 
+        if constexpr (is_spectral_v<Spectrum>)
+            srgb_model_fetch((ScalarFloat *) bitmap_2->data(),
+                             bitmap_2->pixel_count(), pixel_width);
+
         size_t shape[3] = { (size_t) res.y(), (size_t) res.x(), pixel_width };
         m_data = TensorXf(bitmap_2->data(), 3, shape);
 
         m_scale = props.get<ScalarFloat>("scale", 1.f);
-        m_warp = Warp(luminance.get(), res);
+        build_warps(luminance.get(), res);
+
+        m_warp_update_interval = props.get<int>("warp_update_interval", 1);
+        if (m_warp_update_interval < 1)
+            Throw("The warp update interval must be at least 1!");
+
+        m_product_sampling = props.get<bool>("product_sampling", false);
+        m_product_defensive = props.get<ScalarFloat>("product_defensive", .1f);
+        if (m_product_defensive <= 0.f || m_product_defensive > 1.f)
+            Throw("The defensive weight of product sampling must be in (0, 1]!");
         m_d65 = Texture::D65(1.f);
         m_flags = EmitterFlags::Infinite | EmitterFlags::SpatiallyVarying;
         dr::set_attr(this, "flags", m_flags);
@@ -258,10 +304,49 @@ public:
                 dr::scatter(m_data.array(), v01, row_index + (res.x() - 1));
             }
 
-            auto&& data = dr::migrate(m_data.array(), AllocType::Host);
+            bool update_warp = m_update_count++ % m_warp_update_interval == 0;
+            ScalarFloat theta_scale = 1.f / (res.y() - 1) * dr::Pi<Float>;
 
-            if constexpr (dr::is_jit_v<Float>)
-                dr::sync_thread();
+            if constexpr (dr::is_jit_v<Float>) {
+                if (update_warp) {
+                    // Compute the luminance and build the warp on the device
+                    UInt32 index = dr::arange<UInt32>(dr::prod(res));
+                    PixelData coeff = dr::gather<PixelData>(m_data.array(), index);
+
+                    Float lum;
+                    if constexpr (is_monochromatic_v<Spectrum>) {
+                        lum = coeff.x();
+                    } else if constexpr (is_rgb_v<Spectrum>) {
+                        lum = mitsuba::luminance(Color3f(coeff.x(), coeff.y(), coeff.z()));
+                    } else {
+                        static_assert(is_spectral_v<Spectrum>);
+                        lum = srgb_model_mean(dr::head<3>(coeff)) * coeff.w();
+                    }
+
+                    Float sin_theta = dr::sin(Float(index / res.x()) * theta_scale),
+                          weight = dr::detach(lum * sin_theta);
+
+                    if (m_mis_compensation > 0.f) {
+                        // Same as mis_compensate(), without leaving the device
+                        Mask interior = dr::neq(index % res.x(), res.x() - 1);
+                        Float lum_sum = dr::sum(dr::select(interior, weight, 0.f)),
+                              sin_sum = dr::sum(dr::select(interior, sin_theta, 0.f)),
+                              offset  = m_mis_compensation * lum_sum / sin_sum,
+                              comp    = dr::maximum(weight - offset * sin_theta, 0.f),
+                              comp_sum = dr::sum(dr::select(interior, comp, 0.f));
+
+                        m_ray_warp = Warp(FloatStorage(weight), res);
+                        m_has_ray_warp = true;
+                        weight = dr::select(comp_sum > .01f * lum_sum, comp, weight);
+                    }
+
+                    m_warp = Warp(FloatStorage(weight), res);
+                }
+                Base::parameters_changed(keys);
+                return;
+            }
+
+            auto&& data = dr::migrate(m_data.array(), AllocType::Host);
 
             std::unique_ptr<ScalarFloat[]> luminance(
                 new ScalarFloat[dr::prod(res)]);
@@ -272,7 +357,6 @@ public:
             size_t pixel_width = is_spectral_v<Spectrum> ? 4 : 3;
             constexpr bool is_aligned = ScalarPixelData::Size == 4;
 
-            ScalarFloat theta_scale = 1.f / (res.y() - 1) * dr::Pi<Float>;
             for (size_t y = 0; y < res.y(); ++y) {
                 ScalarFloat sin_theta = dr::sin(y * theta_scale);
 
@@ -320,7 +404,8 @@ public:
                 }
             }
 
-            m_warp = Warp(luminance.get(), res);
+            if (update_warp)
+                build_warps(luminance.get(), res);
         }
         Base::parameters_changed(keys);
     }
@@ -362,8 +447,9 @@ public:
         // 1. Sample spatial component
         Point2f offset = warp::square_to_uniform_disk_concentric(sample2);
 
-        // 2. Sample directional component
-        auto [uv, pdf] = m_warp.sample(sample3, nullptr, active);
+        // 2. Sample directional component (not combined with other techniques)
+        const Warp &warp = m_has_ray_warp ? m_ray_warp : m_warp;
+        auto [uv, pdf] = warp.sample(sample3, nullptr, active);
         uv.x() += .5f / (m_data.shape(1) - 1);
 
         active &= pdf > 0.f;
@@ -407,7 +493,13 @@ public:
                      Mask active) const override {
         MI_MASKED_FUNCTION(ProfilerPhase::EndpointSampleDirection, active);
 
-        auto [uv, pdf] = m_warp.sample(sample, nullptr, active);
+        Point2f uv;
+        Float pdf;
+        if (m_product_sampling)
+            std::tie(uv, pdf) = m_warp.sample_product(
+                sample, product_weight(it), nullptr, active);
+        else
+            std::tie(uv, pdf) = m_warp.sample(sample, nullptr, active);
         uv.x() += .5f / (m_data.shape(1) - 1);
         active &= pdf > 0.f;
 
@@ -448,7 +540,7 @@ public:
         return { ds, weight & active };
     }
 
-    Float pdf_direction(const Interaction3f & /*it*/, const DirectionSample3f &ds,
+    Float pdf_direction(const Interaction3f &it, const DirectionSample3f &ds,
                         Mask active) const override {
         MI_MASKED_FUNCTION(ProfilerPhase::EndpointEvaluate, active);
 
@@ -463,7 +555,11 @@ public:
         Float inv_sin_theta = dr::safe_rsqrt(dr::maximum(
             dr::sqr(d.x()) + dr::sqr(d.z()), dr::sqr(dr::Epsilon<Float>)));
 
-        return m_warp.eval(uv) * inv_sin_theta * (1.f / (2.f * dr::sqr(dr::Pi<Float>)));
+        Float pdf = m_product_sampling
+                        ? m_warp.eval_product(uv, product_weight(it), nullptr, active)
+                        : m_warp.eval(uv, nullptr, active);
+
+        return pdf * inv_sin_theta * (1.f / (2.f * dr::sqr(dr::Pi<Float>)));
     }
 
     Spectrum eval_direction(const Interaction3f &it,
@@ -510,12 +606,118 @@ public:
         if (!m_filename.empty())
             oss << "  filename = \"" << m_filename << "\"," << std::endl;
         oss << "  res = \"" << res << "\"," << std::endl
+            << "  product_sampling = " << m_product_sampling << "," << std::endl
+            << "  mis_compensation = " << m_mis_compensation << "," << std::endl
             << "  bsphere = " << string::indent(m_bsphere) << std::endl
             << "]";
         return oss.str();
     }
 
 protected:
+    /**
+     * \brief Build the sampling warps from the luminance of the pixels,
+     * which is already weighted by the sine of their elevation
+     *
+     * With MIS compensation, \ref sample_ray() keeps using a warp of the
+     * uncompensated luminance.
+     */
+    void build_warps(ScalarFloat *lum, const ScalarVector2u &res) {
+        m_has_ray_warp = false;
+        if (m_mis_compensation > 0.f) {
+            Warp ray_warp(lum, res);
+            if (mis_compensate(lum, res)) {
+                m_ray_warp = std::move(ray_warp);
+                m_has_ray_warp = true;
+            }
+        }
+        m_warp = Warp(lum, res);
+    }
+
+    /**
+     * \brief Subtract the configured fraction of the mean luminance from the
+     * data of the warp and clamp negative values
+     *
+     * The mean is taken with respect to solid angle, and the last column
+     * (which duplicates the first one) is excluded. Returns \c false and
+     * leaves the data unchanged if less than 1% of the density would remain,
+     * which happens for nearly constant maps.
+     */
+    bool mis_compensate(ScalarFloat *lum, const ScalarVector2u &res) const {
+        ScalarFloat theta_scale = 1.f / (res.y() - 1) * dr::Pi<Float>;
+        double lum_sum = 0.0, sin_sum = 0.0, comp_sum = 0.0;
+
+        for (size_t y = 0; y < res.y(); ++y) {
+            ScalarFloat sin_theta = dr::sin(y * theta_scale);
+            for (size_t x = 0; x < res.x() - 1; ++x)
+                lum_sum += (double) lum[y * res.x() + x];
+            sin_sum += (double) sin_theta * (res.x() - 1);
+        }
+
+        ScalarFloat offset =
+            m_mis_compensation * ScalarFloat(lum_sum / sin_sum);
+
+        for (size_t y = 0; y < res.y(); ++y) {
+            ScalarFloat sin_theta = dr::sin(y * theta_scale);
+            for (size_t x = 0; x < res.x() - 1; ++x)
+                comp_sum += (double) dr::maximum(
+                    lum[y * res.x() + x] - offset * sin_theta, 0.f);
+        }
+
+        if (!(comp_sum > 0.01 * lum_sum))
+            return false;
+
+        for (size_t y = 0; y < res.y(); ++y) {
+            ScalarFloat sin_theta = dr::sin(y * theta_scale);
+            for (size_t x = 0; x < res.x(); ++x) {
+                ScalarFloat &value = lum[y * res.x() + x];
+                value = dr::maximum(value - offset * sin_theta, 0.f);
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * \brief Return the region weight function used by \ref
+     * Hierarchical2D::sample_product() for the reference point \c it
+     *
+     * The function bounds the cosine between the normal at \c it and all
+     * directions within a region of the warp's (u, v) domain. Since the
+     * regions are latitude-longitude boxes, the angular distance between
+     * their center and any other point is at most half the polar extent plus
+     * half the azimuthal extent on the widest parallel.
+     */
+    auto product_weight(const Interaction3f &it) const {
+        Normal3f n = m_to_world.value().inverse().transform_affine(it.n);
+        Mask has_normal = dr::squared_norm(n) > 0.f;
+        n = dr::normalize(dr::select(has_normal, n, Normal3f(0.f, 0.f, 1.f)));
+
+        ScalarFloat shift = .5f / (m_data.shape(1) - 1);
+
+        return [this, n, has_normal, shift](const Point2f &min, const Point2f &max) {
+            Float theta_0 = min.y() * dr::Pi<Float>,
+                  theta_1 = max.y() * dr::Pi<Float>,
+                  phi     = (.5f * (min.x() + max.x()) + shift) * dr::TwoPi<Float>;
+
+            Vector3f d = dr::sphdir(.5f * (theta_0 + theta_1), phi);
+            d = Vector3f(d.y(), d.z(), -d.x());
+
+            Float sin_max = dr::select(
+                theta_0 < .5f * dr::Pi<Float> && theta_1 > .5f * dr::Pi<Float>, 1.f,
+                dr::maximum(dr::sin(theta_0), dr::sin(theta_1)));
+
+            Float radius = .5f * (theta_1 - theta_0) +
+                           dr::minimum(sin_max * (max.x() - min.x()) * dr::Pi<Float>,
+                                       dr::Pi<Float>);
+
+            Float angle = dr::maximum(dr::safe_acos(dr::dot(n, d)) - radius, 0.f),
+                  cos_bound = dr::select(angle < .5f * dr::Pi<Float>, dr::cos(angle), 0.f);
+
+            return dr::select(has_normal,
+                              dr::lerp(m_product_defensive, 1.f, cos_bound), 1.f);
+        };
+    }
+
     UnpolarizedSpectrum eval_spectrum(Point2f uv, const Wavelength &wavelengths,
                                       Mask active, bool include_whitepoint = true) const {
         ScalarVector2u res = { m_data.shape(1), m_data.shape(0) };
@@ -582,8 +784,17 @@ protected:
     BoundingSphere3f m_bsphere;
     TensorXf m_data;
     Warp m_warp;
+    /// Uncompensated warp used by \ref sample_ray() (with MIS compensation)
+    Warp m_ray_warp;
+    bool m_has_ray_warp = false;
     ref<Texture> m_d65;
     Float m_scale;
+    int m_warp_update_interval;
+    size_t m_update_count = 0;
+    bool m_product_sampling;
+    ScalarFloat m_product_defensive;
+    /// Fraction of the mean luminance subtracted from \ref m_warp (or zero)
+    ScalarFloat m_mis_compensation;
 };
 
 MI_IMPLEMENT_CLASS_VARIANT(EnvironmentMapEmitter, Emitter)
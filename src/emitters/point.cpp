@@ -61,6 +61,7 @@ class PointLight final : public Emitter<Float, Spectrum> {
 public:
     MI_IMPORT_BASE(Emitter, m_flags, m_medium, m_needs_sample_3, m_to_world)
     MI_IMPORT_TYPES(Scene, Shape, Texture)
+    using typename Base::LightBounds;
 
     PointLight(const Properties &props) : Base(props) {
         if (props.has_property("position")) {
@@ -193,6 +194,14 @@ public:
         return ScalarBoundingBox3f(m_position.scalar());
     }
 
+    LightBounds light_bounds() const override {
+        LightBounds lb;
+        lb.bbox  = bbox();
+        lb.power = 4.f * dr::Pi<ScalarFloat> *
+                   (ScalarFloat) dr::slice(m_intensity->mean());
+        return lb;
+    }
+
     std::string to_string() const override {
         std::ostringstream oss;
         oss << "PointLight[" << std::endl
@@ -119,6 +119,7 @@ MI_VARIANT class Projector final : public Emitter<Float, Spectrum> {
 public:
     MI_IMPORT_BASE(Emitter, m_flags, m_to_world, m_needs_sample_3)
     MI_IMPORT_TYPES(Texture)
+    using typename Base::LightBounds;
 
     Projector(const Properties &props) : Base(props) {
         m_intensity_scale = dr::opaque<Float>(props.get<ScalarFloat>("scale", 1.f));
@@ -300,6 +301,26 @@ public:
         return ScalarBoundingBox3f();
     }
 
+    LightBounds light_bounds() const override {
+        // Light leaves through a cone around the optical axis that encloses the frustum
+        ScalarVector2i size = m_irradiance->resolution();
+        ScalarFloat tan_x = dr::tan(.5f * dr::deg_to_rad(m_x_fov)),
+                    tan_y = tan_x * size.y() / (ScalarFloat) size.x();
+
+        ScalarPoint3f p = m_to_world.scalar().translation();
+        LightBounds lb;
+        lb.bbox    = ScalarBoundingBox3f(p, p);
+        lb.power   = dr::Pi<ScalarFloat> *
+                     (ScalarFloat) dr::slice(m_intensity_scale) *
+                     (ScalarFloat) dr::slice(m_sensor_area) *
+                     (ScalarFloat) dr::slice(m_irradiance->mean());
+        lb.axis    = dr::normalize(m_to_world.scalar() *
+                                   ScalarVector3f(0.f, 0.f, 1.f));
+        lb.theta_o = 0.f;
+        lb.theta_e = dr::atan(dr::sqrt(dr::sqr(tan_x) + dr::sqr(tan_y)));
+        return lb;
+    }
+
     std::string to_string() const override {
         std::ostringstream oss;
         oss << "Projector[" << std::endl
@@ -86,6 +86,7 @@ class SpotLight final : public Emitter<Float, Spectrum> {
 public:
     MI_IMPORT_BASE(Emitter, m_flags, m_medium, m_to_world)
     MI_IMPORT_TYPES(Scene, Texture)
+    using typename Base::LightBounds;
 
     SpotLight(const Properties &props) : Base(props) {
         m_flags = +EmitterFlags::DeltaPosition;
@@ -259,6 +260,19 @@ public:
         return ScalarBoundingBox3f(p, p);
     }
 
+    LightBounds light_bounds() const override {
+        ScalarFloat cutoff = (ScalarFloat) dr::slice(m_cutoff_angle);
+        LightBounds lb;
+        lb.bbox    = bbox();
+        lb.power   = dr::TwoPi<ScalarFloat> * (1.f - dr::cos(cutoff)) *
+                     (ScalarFloat) dr::slice(m_intensity->mean());
+        lb.axis    = dr::normalize(m_to_world.scalar() *
+                                   ScalarVector3f(0.f, 0.f, 1.f));
+        lb.theta_o = 0.f;
+        lb.theta_e = cutoff;
+        return lb;
+    }
+
     std::string to_string() const override {
         std::ostringstream oss;
         oss << "SpotLight[" << std::endl
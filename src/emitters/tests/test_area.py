@@ -124,3 +124,49 @@ def test04_sample_direction(variants_vec_spectral, spectrum_key):
     assert dr.allclose(res, spec)
 
     assert dr.allclose(emitter.eval_direction(it, ds), spec)
+
+
+def test05_joint_sampling(variants_vec_rgb, tmp_path):
+    # Sample a textured mesh light whose texture coordinates only cover the
+    # left half of the texture and stretch over a 2x1 rectangle
+    import numpy as np
+
+    fname = str(tmp_path / 'quad.obj')
+    with open(fname, 'w') as f:
+        f.write('v 0 0 0\nv 2 0 0\nv 2 1 0\nv 0 1 0\n'
+                'vt 0 0\nvt 0.5 0\nvt 0.5 1\nvt 0 1\n'
+                'f 1/1 2/2 3/3\nf 1/1 3/3 4/4\n')
+
+    rng = np.random.default_rng(seed=0)
+    data = rng.random((8, 8, 3)).astype(np.float32)
+
+    def create(joint_sampling):
+        return mi.load_dict({
+            'type': 'obj',
+            'filename': fname,
+            'emitter': {
+                'type': 'area',
+                'joint_sampling': joint_sampling,
+                'radiance': { 'type': 'bitmap', 'bitmap': mi.Bitmap(data) }
+            }
+        }).emitter()
+
+    sampler = mi.load_dict({'type': 'independent'})
+    sampler.seed(0, 100000)
+    sample = sampler.next_2d()
+
+    # Every sample lands on the mesh and E[1 / pdf] is the surface area
+    ps, weight = create(True).sample_position(0, sample)
+    assert dr.all(weight > 0)
+    assert dr.allclose(dr.mean(weight), 2, rtol=1e-2)
+
+    # Texture-space sampling wastes the samples in the uncovered half
+    _, weight = create(False).sample_position(0, sample)
+    assert dr.mean(mi.Float(weight > 0)) < 0.7
+
+    # Densities of sampled directions are consistent with pdf_direction()
+    emitter = create(True)
+    it = dr.zeros(mi.SurfaceInteraction3f)
+    it.p = [0.7, 0.4, 1.0]
+    ds, _ = emitter.sample_direction(it, sample)
+    assert dr.allclose(ds.pdf, emitter.pdf_direction(it, ds), rtol=1e-3)
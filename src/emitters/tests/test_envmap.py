@@ -135,3 +135,133 @@ def test04_parameters_changed(variants_all):
 
     params = mi.traverse(emitter)
     assert dr.allclose(params['data'], 1)
+
+
+def test05_warp_update(variants_vec_backends_once_rgb):
+    import numpy as np
+
+    rng = np.random.default_rng(seed=0)
+    data = rng.random((31, 20, 3)).astype(np.float32)
+    emitter_ref = mi.load_dict({
+        "type" : "envmap",
+        "bitmap" : mi.Bitmap(data)
+    })
+    emitter = mi.load_dict({
+        "type" : "envmap",
+        "bitmap" : mi.Bitmap(np.ones((31, 20, 3), dtype=np.float32)),
+        "warp_update_interval" : 2
+    })
+
+    it = dr.zeros(mi.Interaction3f)
+    sampler = mi.load_dict({'type': 'independent'})
+    sampler.seed(0, 1000)
+    sample = sampler.next_2d()
+
+    def pdf(e):
+        ds, _ = emitter_ref.sample_direction(it, sample)
+        return e.pdf_direction(it, ds)
+
+    # The warp built on the device matches the one built while loading
+    params = mi.traverse(emitter)
+    params['data'] = mi.traverse(emitter_ref)['data']
+    params.update()
+    assert dr.allclose(pdf(emitter), pdf(emitter_ref), rtol=1e-3)
+
+    # The second update keeps the previous warp
+    params['data'] = dr.ones(mi.TensorXf, shape=dr.shape(params['data']))
+    params.update()
+    assert dr.allclose(pdf(emitter), pdf(emitter_ref), rtol=1e-3)
+
+    with pytest.raises(RuntimeError, match="warp update interval"):
+        mi.load_dict({
+            "type" : "envmap",
+            "bitmap" : mi.Bitmap(data),
+            "warp_update_interval" : 0
+        })
+
+
+def test06_product_sampling(variants_vec_backends_once_rgb):
+    import numpy as np
+
+    rng = np.random.default_rng(seed=0)
+    data = rng.random((31, 20, 3)).astype(np.float32)
+    emitter = mi.load_dict({
+        "type" : "envmap",
+        "bitmap" : mi.Bitmap(data),
+        "product_sampling" : True
+    })
+
+    it = dr.zeros(mi.Interaction3f)
+    it.n = mi.Normal3f(0, 0, 1)
+
+    sampler = mi.load_dict({'type': 'independent'})
+    sampler.seed(0, 100000)
+
+    # Densities of sampled directions are consistent with pdf_direction()
+    ds, w = emitter.sample_direction(it, sampler.next_2d())
+    assert dr.allclose(ds.pdf, emitter.pdf_direction(it, ds), rtol=1e-3)
+
+    # Most samples end up above the surface
+    assert dr.mean(mi.Float(ds.d.z > 0)) > 0.7
+
+    # The density integrates to one over the sphere
+    d = mi.warp.square_to_uniform_sphere(sampler.next_2d())
+    ds = dr.zeros(mi.DirectionSample3f)
+    ds.d = d
+    integral = dr.mean(emitter.pdf_direction(it, ds)) * 4 * dr.pi
+    assert dr.allclose(integral, 1, rtol=2e-2)
+
+
+def test07_mis_compensation(variants_vec_backends_once_rgb):
+    import numpy as np
+
+    # Bright upper hemisphere, dim lower hemisphere
+    data = np.full((31, 20, 3), 4, dtype=np.float32)
+    data[16:] = 0.1
+    emitter = mi.load_dict({
+        "type" : "envmap",
+        "bitmap" : mi.Bitmap(data),
+        "mis_compensation" : True
+    })
+
+    it = dr.zeros(mi.Interaction3f)
+    sampler = mi.load_dict({'type': 'independent'})
+    sampler.seed(0, 100000)
+
+    def check(emitter):
+        # Densities of sampled directions are consistent with pdf_direction()
+        ds, _ = emitter.sample_direction(it, sampler.next_2d())
+        assert dr.allclose(ds.pdf, emitter.pdf_direction(it, ds), rtol=1e-3)
+
+        # The density integrates to one and vanishes in the dim region
+        ds = dr.zeros(mi.DirectionSample3f)
+        ds.d = mi.warp.square_to_uniform_sphere(sampler.next_2d())
+        pdf = emitter.pdf_direction(it, ds)
+        assert dr.allclose(dr.mean(pdf) * 4 * dr.pi, 1, rtol=2e-2)
+        assert dr.all((ds.d.y > -0.2) | (pdf == 0))
+
+    check(emitter)
+
+    # The compensation is also applied when the warp is rebuilt
+    params = mi.traverse(emitter)
+    params['data'] = mi.TensorXf(params['data'])
+    params.update()
+    check(emitter)
+
+    # Nearly constant maps are left uncompensated
+    emitter = mi.load_dict({
+        "type" : "envmap",
+        "bitmap" : mi.Bitmap(np.ones((31, 20, 3), dtype=np.float32)),
+        "mis_compensation" : True
+    })
+    ds = dr.zeros(mi.DirectionSample3f)
+    ds.d = mi.warp.square_to_uniform_sphere(sampler.next_2d())
+    assert dr.allclose(emitter.pdf_direction(it, ds), 1 / (4 * dr.pi), rtol=1e-2)
+
+    with pytest.raises(RuntimeError, match="compensation fraction"):
+        mi.load_dict({
+            "type" : "envmap",
+            "bitmap" : mi.Bitmap(data),
+            "mis_compensation" : True,
+            "mis_compensation_fraction" : 0.0
+        })
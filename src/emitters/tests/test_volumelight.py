@@ -0,0 +1,123 @@
+import pytest
+import drjit as dr
+import mitsuba as mi
+
+
+def create_medium(albedo=0.0):
+    # Unit cube whose second half (along x) glows twice as much
+    return {
+        'type': 'heterogeneous',
+        'id': 'fire',
+        'albedo': albedo,
+        'sigma_t': {
+            'type': 'gridvolume',
+            'data': mi.TensorXf([2.0, 2.0], shape=[1, 1, 2]),
+            'filter_type': 'nearest'
+        },
+        'radiance': {
+            'type': 'gridvolume',
+            'data': mi.TensorXf([1.0, 2.0], shape=[1, 1, 2]),
+            'filter_type': 'nearest'
+        }
+    }
+
+
+def test01_create(variants_all_rgb):
+    emitter = mi.load_dict({
+        'type': 'volumelight',
+        'medium': create_medium()
+    })
+    assert emitter is not None
+    assert emitter.medium().is_emitter()
+    assert mi.has_flag(emitter.flags(), mi.EmitterFlags.SpatiallyVarying)
+
+    b = emitter.bbox()
+    assert dr.allclose(b.min, 0.0) and dr.allclose(b.max, 1.0)
+
+    with pytest.raises(RuntimeError, match='must be emissive'):
+        mi.load_dict({
+            'type': 'volumelight',
+            'medium': { 'type': 'homogeneous' }
+        })
+
+
+def test02_sample_position(variants_vec_rgb):
+    emitter = mi.load_dict({
+        'type': 'volumelight',
+        'resolution': 4,
+        'medium': create_medium()
+    })
+
+    n = 100000
+    sampler = mi.load_dict({'type': 'independent'})
+    sampler.seed(0, n)
+
+    ps, weight = emitter.sample_position(0.0, sampler.next_2d())
+    assert dr.all((ps.p >= 0.0) & (ps.p <= 1.0))
+    assert dr.allclose(emitter.pdf_position(ps), ps.pdf)
+    assert dr.allclose(weight, dr.rcp(ps.pdf))
+
+    # The brighter half of the medium is sampled more often, and the
+    # estimate of its volume remains unbiased
+    assert dr.count(ps.p.x > 0.5) > dr.count(ps.p.x < 0.5)
+    assert dr.allclose(dr.mean(weight, axis=None), 1.0, rtol=2e-2)
+
+
+def test03_sample_direction(variants_vec_rgb):
+    emitter = mi.load_dict({
+        'type': 'volumelight',
+        'medium': create_medium()
+    })
+
+    n = 100000
+    sampler = mi.load_dict({'type': 'independent'})
+    sampler.seed(0, n)
+
+    it = dr.zeros(mi.Interaction3f)
+    it.p = mi.Point3f(0.5, 0.5, -2.0)
+    ds, weight = emitter.sample_direction(it, sampler.next_2d())
+
+    assert dr.all(ds.delta)
+    assert dr.allclose(emitter.pdf_direction(it, ds), 0.0)
+    assert dr.allclose(weight, emitter.eval_direction(it, ds) / ds.pdf * dr.squared_norm(ds.p - it.p))
+
+    # Emitted power per unit solid angle: sigma_a * L_e integrated over the volume
+    assert dr.allclose(dr.mean(weight * dr.squared_norm(ds.p - it.p), axis=None),
+                       2.0 * 1.5, rtol=2e-2)
+
+
+@pytest.mark.parametrize('integrator', ['volpath', 'volpathmis'])
+def test04_render(variants_vec_rgb, integrator):
+    # Purely absorbing medium seen through a null boundary, with and without a
+    # volume light: L = L_e * (1 - exp(-sigma_t * d)) along the x axis
+    def render(use_light):
+        scene = {
+            'type': 'scene',
+            'integrator': { 'type': integrator, 'max_depth': 4 },
+            'sensor': {
+                'type': 'perspective',
+                'fov': 1,
+                'to_world': mi.ScalarTransform4f().look_at(
+                    origin=[0.5, 0.5, -10], target=[0.5, 0.5, 0], up=[0, 1, 0]),
+                'film': { 'type': 'hdrfilm', 'width': 4, 'height': 4 },
+                'sampler': { 'type': 'independent', 'sample_count': 1024 }
+            },
+            'fire': create_medium(),
+            'cube': {
+                'type': 'cube',
+                'to_world': mi.ScalarTransform4f().translate(0.5).scale(0.5),
+                'bsdf': { 'type': 'null' },
+                'interior': { 'type': 'ref', 'id': 'fire' }
+            }
+        }
+        if use_light:
+            scene['light'] = {
+                'type': 'volumelight',
+                'medium': { 'type': 'ref', 'id': 'fire' }
+            }
+        return mi.render(mi.load_dict(scene), seed=0)
+
+    ref = 1.5 * (1.0 - dr.exp(-2.0))
+    for use_light in [False, True]:
+        img = render(use_light)
+        assert dr.allclose(dr.mean(img, axis=None), ref, rtol=5e-2)
@@ -0,0 +1,392 @@
+#include <mitsuba/core/bbox.h>
+#include <mitsuba/core/distr_1d.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/spectrum.h>
+#include <mitsuba/core/warp.h>
+#include <mitsuba/render/emitter.h>
+#include <mitsuba/render/medium.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**!
+
+.. _emitter-volumelight:
+
+Volume light source (:monosp:`volumelight`)
+-------------------------------------------
+
+.. pluginparameters::
+
+ * - (Nested plugin)
+   - |medium|
+   - Emissive medium, e.g. a :ref:`heterogeneous <medium-heterogeneous>`
+     medium with a :monosp:`radiance` parameter. It can also be passed as a
+     reference.
+
+ * - resolution
+   - |int|
+   - Resolution of the grid along every axis of the medium's bounding box
+     that is used to importance sample the emission. (Default: 64)
+
+This emitter enables next event estimation of the light emitted by a
+participating medium. It doesn't emit any light itself: the emission is
+defined by the medium, and this plugin only provides a strategy to sample
+points within it.
+
+Points are chosen by first sampling a cell of a regular grid over the
+bounding box of the medium using an alias table, and then a uniform position
+within it. The weight of each cell bounds the emission (the product of the
+absorption coefficient and the emitted radiance) by the largest values of
+both quantities at its corners, which is conservative for linearly
+interpolated volumes at the same or a coarser resolution. A tenth of the mean
+weight is added to every cell, so that the estimates remain unbiased when the
+grid misses small features, or when the medium was modified after the
+distribution was built.
+
+Once a volume light references a medium, the :ref:`volpath
+<integrator-volpath>` and :ref:`volpathmis <integrator-volpathmis>`
+integrators no longer gather its emission at collisions along rays that
+follow an interaction where emitters were sampled. Instead, the transmittance
+along the shadow rays toward the sampled points is estimated by ratio
+tracking, which makes use of the majorant grid of the medium (if enabled).
+
+.. tabs::
+    .. code-tab:: xml
+        :name: volumelight
+
+        <medium type="heterogeneous" id="fire">
+            <volume name="sigma_t" type="gridvolume">
+                <string name="filename" value="density.vol"/>
+            </volume>
+            <volume name="radiance" type="gridvolume">
+                <string name="filename" value="temperature.vol"/>
+            </volume>
+        </medium>
+
+        <emitter type="volumelight">
+            <ref id="fire"/>
+        </emitter>
+
+    .. code-tab:: python
+
+        'fire': {
+            'type': 'heterogeneous',
+            'sigma_t': { 'type': 'gridvolume', 'filename': 'density.vol' },
+            'radiance': { 'type': 'gridvolume', 'filename': 'temperature.vol' }
+        },
+        'fire_light': {
+            'type': 'volumelight',
+            'medium': { 'type': 'ref', 'id': 'fire' }
+        }
+
+ */
+
+template <typename Float, typename Spectrum>
+class VolumeLight final : public Emitter<Float, Spectrum> {
+public:
+    MI_IMPORT_BASE(Emitter, m_flags, m_medium)
+    MI_IMPORT_TYPES(Scene, Medium)
+    using typename Base::LightBounds;
+
+    VolumeLight(const Properties &props) : Base(props) {
+        if (!m_medium)
+            Throw("A volume light requires a nested medium!");
+        if (!m_medium->is_emitter())
+            Throw("The medium of a volume light must be emissive!");
+
+        m_bbox = m_medium->bbox();
+        if (!m_bbox.valid())
+            Throw("The medium of a volume light must be bounded!");
+
+        int res = props.get<int>("resolution", 64);
+        if (res < 1)
+            Throw("The resolution of a volume light must be positive!");
+        m_res = ScalarVector3u((uint32_t) res);
+
+        build_distr();
+
+        m_flags = +EmitterFlags::SpatiallyVarying;
+        dr::set_attr(this, "flags", m_flags);
+    }
+
+    void set_scene(const Scene * /* scene */) override {
+        // Integrators now sample the emission of the medium using this emitter
+        m_medium->set_emitter(this);
+    }
+
+    std::pair<Ray3f, Spectrum> sample_ray(Float time, Float wavelength_sample,
+                                          const Point2f &sample2,
+                                          const Point2f &sample3,
+                                          Mask active) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::EndpointSampleRay, active);
+
+        auto [p, pdf] = sample_point(sample2, active);
+        auto [wavelengths, weight] =
+            sample_wavelength<Float, Spectrum>(wavelength_sample);
+
+        Vector3f d = warp::square_to_uniform_sphere(sample3);
+        UnpolarizedSpectrum spec = emission(p, -d, wavelengths, time, active);
+        weight *= depolarizer<Spectrum>(spec) * 4.f * dr::Pi<Float> / pdf;
+
+        return { Ray3f(p, d, time, wavelengths),
+                 weight & (active && pdf > 0.f) };
+    }
+
+    std::pair<DirectionSample3f, Spectrum>
+    sample_direction(const Interaction3f &it, const Point2f &sample,
+                     Mask active) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::EndpointSampleDirection, active);
+
+        auto [p, pdf] = sample_point(sample, active);
+
+        DirectionSample3f ds;
+        ds.p       = p;
+        ds.n       = 0.f;
+        ds.uv      = 0.f;
+        ds.time    = it.time;
+        ds.delta   = true;
+        ds.emitter = this;
+        ds.d       = ds.p - it.p;
+
+        Float dist2 = dr::squared_norm(ds.d);
+        ds.dist = dr::sqrt(dist2);
+        ds.d *= dr::rsqrt(dist2);
+
+        /* Density per unit solid angle and unit length along the direction.
+           The sample is marked as 'delta' since the emission isn't gathered
+           by BSDF and phase function sampling after this strategy was used */
+        ds.pdf = pdf * dist2;
+        active &= ds.pdf > 0.f;
+
+        UnpolarizedSpectrum spec =
+            emission(p, -ds.d, it.wavelengths, it.time, active) / ds.pdf;
+
+        return { ds, depolarizer<Spectrum>(spec) & active };
+    }
+
+    Float pdf_direction(const Interaction3f &, const DirectionSample3f &,
+                        Mask) const override {
+        return 0.f;
+    }
+
+    Spectrum eval_direction(const Interaction3f &it,
+                            const DirectionSample3f &ds,
+                            Mask active) const override {
+        UnpolarizedSpectrum spec =
+            emission(ds.p, -ds.d, it.wavelengths, it.time, active) *
+            dr::rcp(dr::squared_norm(ds.p - it.p));
+        return depolarizer<Spectrum>(spec);
+    }
+
+    std::pair<PositionSample3f, Float>
+    sample_position(Float time, const Point2f &sample,
+                    Mask active) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::EndpointSamplePosition, active);
+
+        auto [p, pdf] = sample_point(sample, active);
+
+        PositionSample3f ps = dr::zeros<PositionSample3f>();
+        ps.p     = p;
+        ps.time  = time;
+        ps.pdf   = pdf;
+        ps.delta = false;
+
+        return { ps, dr::select(active && pdf > 0.f, dr::rcp(pdf), 0.f) };
+    }
+
+    Float pdf_position(const PositionSample3f &ps, Mask active) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::EndpointEvaluate, active);
+
+        Vector3f p = (ps.p - m_bbox.min) / m_cell_extent;
+        active &= dr::all(p >= 0.f && p <= Vector3f(m_res));
+        Vector3u cell = dr::minimum(Vector3u(dr::maximum(p, 0.f)), m_res - 1u);
+        UInt32 index = (cell.z() * m_res.y() + cell.y()) * m_res.x() + cell.x();
+
+        return dr::select(active, m_distr.eval_pmf_normalized(index, active) *
+                                      m_inv_cell_volume, 0.f);
+    }
+
+    std::pair<Wavelength, Spectrum>
+    sample_wavelengths(const SurfaceInteraction3f & /* si */, Float sample,
+                       Mask /* active */) const override {
+        return sample_wavelength<Float, Spectrum>(sample);
+    }
+
+    Spectrum eval(const SurfaceInteraction3f &, Mask) const override {
+        return 0.f;
+    }
+
+    ScalarBoundingBox3f bbox() const override { return m_bbox; }
+
+    LightBounds light_bounds() const override {
+        LightBounds lb;
+        lb.bbox  = m_bbox;
+        lb.power = 4.f * dr::Pi<ScalarFloat> * m_power;
+        return lb;
+    }
+
+    std::string to_string() const override {
+        std::ostringstream oss;
+        oss << "VolumeLight[" << std::endl
+            << "  medium = " << string::indent(m_medium) << "," << std::endl
+            << "  bbox = " << string::indent(m_bbox) << "," << std::endl
+            << "  resolution = " << m_res << std::endl
+            << "]";
+        return oss.str();
+    }
+
+    MI_DECLARE_CLASS()
+private:
+    /**
+     * \brief Sample a world-space position within the medium
+     *
+     * Returns the position and its density per unit volume. Only two
+     * uniform variates are available: the one that is reused after choosing
+     * the cell provides the offsets along both the y axis (high-order bits)
+     * and the z axis (low-order bits).
+     */
+    std::pair<Point3f, Float> sample_point(const Point2f &sample,
+                                           Mask active) const {
+        auto [index, u, pmf] = m_distr.sample_reuse_pmf(sample.x(), active);
+
+        UInt32 slice = m_res.x() * m_res.y(),
+               z = index / slice,
+               y = (index - z * slice) / m_res.x(),
+               x = index - z * slice - y * m_res.x();
+
+        Float w = u * 4096.f;
+        Vector3f offset(sample.y(), u, w - dr::floor(w));
+        Point3f p = m_bbox.min +
+                    (Vector3f(Float(x), Float(y), Float(z)) + offset) * m_cell_extent;
+
+        return { p, pmf * m_inv_cell_volume };
+    }
+
+    /// Emission per unit length of the medium at \c p toward \c wi
+    UnpolarizedSpectrum emission(const Point3f &p, const Vector3f &wi,
+                                 const Wavelength &wavelengths, Float time,
+                                 Mask active) const {
+        MediumInteraction3f mei = dr::zeros<MediumInteraction3f>();
+        mei.p           = p;
+        mei.wi          = wi;
+        mei.sh_frame    = Frame3f(wi);
+        mei.time        = time;
+        mei.wavelengths = wavelengths;
+
+        auto [sigma_s, sigma_n, sigma_t] =
+            m_medium->get_scattering_coefficients(mei, active);
+        DRJIT_MARK_USED(sigma_n);
+
+        return dr::select(active, (sigma_t - sigma_s) *
+                                      m_medium->get_radiance(mei, active), 0.f);
+    }
+
+    /// Build the distribution of cells (see the plugin documentation)
+    void build_distr() {
+        ScalarVector3f extents = m_bbox.extents();
+        m_cell_extent = extents / ScalarVector3f(m_res);
+        ScalarFloat cell_volume = dr::prod(m_cell_extent);
+        m_inv_cell_volume = dr::rcp(cell_volume);
+
+        // 1. Evaluate the emitted radiance and absorption at the cell corners
+        ScalarVector3u corner_res = m_res + 1u;
+        uint32_t corner_count = dr::prod(corner_res),
+                 cell_count = dr::prod(m_res);
+        std::vector<ScalarFloat> corner_radiance(corner_count),
+                                 corner_absorption(corner_count);
+        Wavelength wavelengths = sample_wavelength<Float, Spectrum>(.5f).first;
+
+        if constexpr (dr::is_jit_v<Float>) {
+            UInt32 index = dr::arange<UInt32>(corner_count),
+                   slice = corner_res.x() * corner_res.y(),
+                   z = index / slice,
+                   y = (index - z * slice) / corner_res.x(),
+                   x = index - z * slice - y * corner_res.x();
+
+            MediumInteraction3f mei = dr::zeros<MediumInteraction3f>(corner_count);
+            mei.p = m_bbox.min + Vector3f(Float(x), Float(y), Float(z)) * m_cell_extent;
+            mei.wi = Vector3f(0.f, 0.f, 1.f);
+            mei.sh_frame = Frame3f(mei.wi);
+            mei.wavelengths = wavelengths;
+
+            auto [sigma_s, sigma_n, sigma_t] =
+                m_medium->get_scattering_coefficients(mei);
+            DRJIT_MARK_USED(sigma_n);
+            Float radiance = dr::max(m_medium->get_radiance(mei)),
+                  absorption = dr::max(sigma_t - sigma_s);
+
+            auto &&radiance_h = dr::migrate(dr::detach(radiance), AllocType::Host);
+            auto &&absorption_h = dr::migrate(dr::detach(absorption), AllocType::Host);
+            dr::sync_thread();
+            memcpy(corner_radiance.data(), radiance_h.data(),
+                   corner_count * sizeof(ScalarFloat));
+            memcpy(corner_absorption.data(), absorption_h.data(),
+                   corner_count * sizeof(ScalarFloat));
+        } else {
+            MediumInteraction3f mei = dr::zeros<MediumInteraction3f>();
+            mei.wi = Vector3f(0.f, 0.f, 1.f);
+            mei.sh_frame = Frame3f(mei.wi);
+            mei.wavelengths = wavelengths;
+
+            uint32_t i = 0;
+            for (uint32_t z = 0; z < corner_res.z(); ++z) {
+                for (uint32_t y = 0; y < corner_res.y(); ++y) {
+                    for (uint32_t x = 0; x < corner_res.x(); ++x, ++i) {
+                        mei.p = m_bbox.min + ScalarVector3f(x, y, z) * m_cell_extent;
+                        auto [sigma_s, sigma_n, sigma_t] =
+                            m_medium->get_scattering_coefficients(mei);
+                        DRJIT_MARK_USED(sigma_n);
+                        corner_radiance[i] = dr::max(m_medium->get_radiance(mei));
+                        corner_absorption[i] = dr::max(sigma_t - sigma_s);
+                    }
+                }
+            }
+        }
+
+        // 2. Bound the emission within each cell by the values at its corners
+        std::vector<ScalarFloat> weight(cell_count);
+        double total = 0.0;
+        uint32_t j = 0;
+        for (uint32_t z = 0; z < m_res.z(); ++z) {
+            for (uint32_t y = 0; y < m_res.y(); ++y) {
+                for (uint32_t x = 0; x < m_res.x(); ++x, ++j) {
+                    ScalarFloat radiance = 0.f, absorption = 0.f;
+                    for (uint32_t k = 0; k < 8; ++k) {
+                        uint32_t i = ((z + (k >> 2)) * corner_res.y() +
+                                      (y + ((k >> 1) & 1))) * corner_res.x() +
+                                     (x + (k & 1));
+                        radiance = dr::maximum(radiance, corner_radiance[i]);
+                        absorption = dr::maximum(absorption, corner_absorption[i]);
+                    }
+                    weight[j] = radiance * absorption;
+                    total += (double) weight[j];
+                }
+            }
+        }
+
+        // 3. Mix in a uniform fraction to sample the whole medium
+        ScalarFloat mean = (ScalarFloat) (total / cell_count),
+                    offset = mean > 0.f ? .1f * mean : 1.f;
+        for (ScalarFloat &w : weight)
+            w += offset;
+
+        m_power = (ScalarFloat) total * cell_volume;
+        m_distr = DiscreteDistribution<Float>(weight.data(), cell_count);
+        m_distr.set_alias_table(true);
+    }
+
+private:
+    ScalarBoundingBox3f m_bbox;
+    /// Resolution of the sampling grid
+    ScalarVector3u m_res;
+    ScalarVector3f m_cell_extent;
+    ScalarFloat m_inv_cell_volume;
+    /// Bound of the emitted power per steradian
+    ScalarFloat m_power;
+    /// Distribution of the cells of the sampling grid
+    DiscreteDistribution<Float> m_distr;
+};
+
+MI_IMPLEMENT_CLASS_VARIANT(VolumeLight, Emitter)
+MI_EXPORT_PLUGIN(VolumeLight, "Volume light")
+NAMESPACE_END(mitsuba)
@@ -1,12 +1,15 @@
 #include <mitsuba/core/bitmap.h>
 #include <mitsuba/core/filesystem.h>
 #include <mitsuba/core/fstream.h>
+#include <mitsuba/core/math.h>
 #include <mitsuba/core/spectrum.h>
 #include <mitsuba/core/string.h>
 #include <mitsuba/render/film.h>
 #include <mitsuba/render/fwd.h>
 #include <mitsuba/render/imageblock.h>
 
+#include <algorithm>
+#include <cstring>
 #include <mutex>
 
 NAMESPACE_BEGIN(mitsuba)
@@ -19,7 +22,7 @@ High dynamic range film (:monosp:`hdrfilm`)
 -------------------------------------------
 
 .. pluginparameters::
- :extra-rows: 7
+ :extra-rows: 8
 
  * - width, height
    - |int|
@@ -31,6 +34,13 @@ High dynamic range film (:monosp:`hdrfilm`)
      (for ILM's OpenEXR format), :monosp:`rgbe` (for Greg Ward's RGBE format), or
      :monosp:`pfm` (for the Portable Float Map format). (Default: :monosp:`openexr`)
 
+ * - compression
+   - |string|
+   - Compression method of OpenEXR output. Besides the lossless :monosp:`none`,
+     :monosp:`rle`, :monosp:`zips`, :monosp:`zip`, and :monosp:`piz` methods,
+     the lossy :monosp:`dwaa` and :monosp:`dwab` compressors produce much
+     smaller files, e.g. for previews. (Default: :monosp:`piz`)
+
  * - pixel_format
    - |string|
    - Specifies the desired pixel format of output images. The options are :monosp:`luminance`,
@@ -64,6 +74,13 @@ High dynamic range film (:monosp:`hdrfilm`)
      in JIT variants and can make sample accumulation quite a bit more expensive.
      (Default: |false|, i.e. disabled)
 
+ * - storage_format
+   - |string|
+   - Precision of the buffer that accumulates the samples over the course of
+     a rendering. The options are :monosp:`float32` and :monosp:`float16`.
+     The latter is only supported in JIT variants, see below.
+     (Default: :monosp:`float32`)
+
  * - (Nested plugin)
    - :paramtype:`rfilter`
    - Reconstruction filter that should be used by the film. (Default: :monosp:`gaussian`, a windowed
@@ -107,6 +124,19 @@ data. PFM output is restricted to :monosp:`float32`-valued images using the :mon
 :monosp:`luminance` pixel formats. Due to the superior accuracy and adoption of OpenEXR, the use of
 these two alternative formats is discouraged however.
 
+With :monosp:`storage_format=float16`, the long-lived film buffer only holds
+a half precision value and a half precision error term per channel, packed
+into 32 bits. This halves the memory footprint of the film compared to the
+default single precision storage, and more so when :monosp:`compensate` is
+enabled, which is useful for high-resolution films with many AOVs on the GPU.
+The samples of a rendering pass are still accumulated in a single precision
+image block, which is folded into the film when the pass is complete. The
+error term holds the rounding error of the half precision value, so that the
+stored values retain roughly 21 bits of precision. To stay within the range
+of half precision numbers, the channels are stored divided by the
+accumulated filter weight, which limits this mode to pixel values and
+weights (roughly the sample count per pixel) below 65504.
+
 When RGB(A) output is selected, the measured spectral power distributions are
 converted to linear RGB based on the CIE 1931 XYZ color matching curves and
 the ITU-R Rec. BT.709-3 primaries with a D65 white point.
@@ -138,6 +168,8 @@ public:
                    m_filter, m_flags)
     MI_IMPORT_TYPES(ImageBlock)
 
+    using UInt32Storage = DynamicBuffer<UInt32>;
+
     HDRFilm(const Properties &props) : Base(props) {
         std::string file_format = string::to_lower(
             props.string("file_format", "openexr"));
@@ -145,6 +177,7 @@ public:
             props.string("pixel_format", "rgb"));
         std::string component_format = string::to_lower(
             props.string("component_format", "float16"));
+        m_compression = string::to_lower(props.string("compression", "piz"));
 
         if (file_format == "openexr" || file_format == "exr")
             m_file_format = Bitmap::FileFormat::OpenEXR;
@@ -199,6 +232,14 @@ public:
                   "equal to \"float16\", \"float32\", or \"uint32\"."
                   " Found %s instead.", component_format);
 
+        const char *compressions[] = { "none", "rle",  "zips", "zip",
+                                       "piz",  "dwaa", "dwab" };
+        if (std::find(std::begin(compressions), std::end(compressions),
+                      m_compression) == std::end(compressions))
+            Throw("The \"compression\" parameter must be equal to \"none\", "
+                  "\"rle\", \"zips\", \"zip\", \"piz\", \"dwaa\", or "
+                  "\"dwab\". Found %s instead.", m_compression);
+
         if (m_file_format == Bitmap::FileFormat::RGBE) {
             if (m_pixel_format != Bitmap::PixelFormat::RGB) {
                 Log(Warn, "The RGBE format only supports pixel_format=\"rgb\"."
@@ -226,6 +267,17 @@ public:
 
         m_compensate = props.get<bool>("compensate", false);
 
+        std::string storage_format = string::to_lower(
+            props.string("storage_format", "float32"));
+        if (storage_format != "float32" && storage_format != "float16")
+            Throw("The \"storage_format\" parameter must either be equal to "
+                  "\"float32\" or \"float16\". Found %s instead.",
+                  storage_format);
+        m_half_storage = storage_format == "float16";
+        if (m_half_storage && !dr::is_jit_v<Float>)
+            Throw("storage_format=\"float16\" is only supported in JIT "
+                  "variants!");
+
         props.mark_queried("banner"); // no banner in Mitsuba 3
     }
 
@@ -258,10 +310,13 @@ public:
             channels[base_channels + i] = aovs[i];
 
         /* locked */ {
-            std::lock_guard<std::mutex> lock(m_mutex);
+            std::lock_guard<std::shared_mutex> lock(m_mutex);
             m_storage = new ImageBlock(m_crop_size, m_crop_offset,
                                        (uint32_t) channels.size());
             m_channels = channels;
+            if (m_half_storage)
+                m_packed = dr::zeros<UInt32Storage>(
+                    dr::width(m_storage->tensor().array()));
         }
 
         std::sort(channels.begin(), channels.end());
@@ -292,13 +347,19 @@ public:
 
     void put_block(const ImageBlock *block) override {
         Assert(m_storage != nullptr);
-        std::lock_guard<std::mutex> lock(m_mutex);
-        m_storage->put_block(block);
+        if (m_half_storage) {
+            std::lock_guard<std::shared_mutex> lock(m_mutex);
+            fold_block(block);
+        } else {
+            put_block_striped(m_storage, block, m_mutex);
+        }
     }
 
     void clear() override {
         if (m_storage)
             m_storage->clear();
+        if (m_half_storage && m_storage)
+            m_packed = dr::zeros<UInt32Storage>(dr::width(m_packed));
     }
 
     TensorXf develop(bool raw = false) const override {
@@ -306,7 +367,7 @@ public:
             Throw("No storage allocated, was prepare() called first?");
 
         if (raw) {
-            std::lock_guard<std::mutex> lock(m_mutex);
+            std::lock_guard<std::shared_mutex> lock(m_mutex);
             return m_storage->tensor();
         }
 
@@ -317,7 +378,7 @@ public:
             ScalarVector2i size;
 
             /* locked */ {
-                std::lock_guard<std::mutex> lock(m_mutex);
+                std::lock_guard<std::shared_mutex> lock(m_mutex);
                 data        = m_storage->tensor().array();
                 size        = m_storage->size();
                 source_ch   = (uint32_t) m_storage->channel_count();
@@ -421,7 +482,7 @@ public:
         if (!m_storage)
             Throw("No storage allocated, was prepare() called first?");
 
-        std::lock_guard<std::mutex> lock(m_mutex);
+        std::lock_guard<std::shared_mutex> lock(m_mutex);
         auto &&storage = dr::migrate(m_storage->tensor().array(), AllocType::Host);
 
         if constexpr (dr::is_jit_v<Float>)
@@ -543,7 +604,90 @@ public:
         return target;
     }
 
-    void write(const fs::path &path) const override {
+    ref<Bitmap> develop_preview(float exposure, bool aces,
+                                Struct::Type component_format) const override {
+        if (!m_storage)
+            Throw("No storage allocated, was prepare() called first?");
+
+        bool quantize = component_format == Struct::Type::UInt8;
+        if (!quantize && component_format != Struct::Type::Float16)
+            Throw("develop_preview(): the component format must either be "
+                  "UInt8 or Float16!");
+
+        bool alpha = has_flag(m_flags, FilmFlags::Alpha);
+        uint32_t target_ch = alpha ? 4 : 3,
+                 weight_ch = alpha ? 4 : 3;
+        ScalarFloat scale = dr::exp2((ScalarFloat) exposure);
+
+        ref<Bitmap> result =
+            new Bitmap(alpha ? Bitmap::PixelFormat::RGBA : Bitmap::PixelFormat::RGB,
+                       component_format, m_crop_size);
+        result->set_srgb_gamma(quantize);
+
+        if constexpr (dr::is_jit_v<Float>) {
+            using UInt8  = dr::replace_scalar_t<Float, uint8_t>;
+            using UInt16 = dr::replace_scalar_t<Float, uint16_t>;
+
+            Float data;
+            uint32_t source_ch, pixel_count;
+
+            /* locked */ {
+                std::lock_guard<std::shared_mutex> lock(m_mutex);
+                data        = m_storage->tensor().array();
+                source_ch   = (uint32_t) m_storage->channel_count();
+                pixel_count = dr::prod(m_storage->size());
+            }
+
+            // Only gather the color, alpha, and weight channels
+            UInt32 idx         = dr::arange<UInt32>(pixel_count * target_ch),
+                   pixel_idx   = idx / target_ch,
+                   channel_idx = dr::fmadd(pixel_idx, uint32_t(-(int) target_ch), idx);
+
+            Float weight = dr::gather<Float>(data, dr::fmadd(pixel_idx, source_ch, weight_ch)),
+                  value  = dr::gather<Float>(data, dr::fmadd(pixel_idx, source_ch, channel_idx));
+
+            value = preview_value(value, weight, dr::eq(channel_idx, 3u), scale,
+                                  aces, quantize);
+
+            size_t count = (size_t) pixel_count * target_ch;
+            if (quantize) {
+                UInt8 out = UInt8(UInt32(dr::fmadd(value, 255.f, .5f)));
+                auto &&host = dr::migrate(out, AllocType::Host);
+                dr::sync_thread();
+                std::memcpy(result->data(), host.data(), count);
+            } else {
+                UInt16 out = UInt16(math::float_to_half(Float32(value)));
+                auto &&host = dr::migrate(out, AllocType::Host);
+                dr::sync_thread();
+                std::memcpy(result->data(), host.data(), count * 2);
+            }
+        } else {
+            std::lock_guard<std::shared_mutex> lock(m_mutex);
+            const ScalarFloat *data = m_storage->tensor().array().data();
+            size_t source_ch = m_storage->channel_count(),
+                   pixel_count = dr::prod(m_storage->size());
+
+            uint8_t *out8 = (uint8_t *) result->data();
+            uint16_t *out16 = (uint16_t *) result->data();
+
+            for (size_t i = 0; i < pixel_count; ++i) {
+                const ScalarFloat *pixel = data + i * source_ch;
+                for (uint32_t c = 0; c < target_ch; ++c) {
+                    ScalarFloat value = preview_value(
+                        pixel[c], pixel[weight_ch], c == 3, scale, aces, quantize);
+                    size_t j = i * target_ch + c;
+                    if (quantize)
+                        out8[j] = (uint8_t) dr::fmadd(value, 255.f, .5f);
+                    else
+                        out16[j] = (uint16_t) math::float_to_half((float) value);
+                }
+            }
+        }
+
+        return result;
+    }
+
+    void write(const fs::path &path, bool write_async) const override {
         fs::path filename = path;
         std::string proper_extension;
         if (m_file_format == Bitmap::FileFormat::OpenEXR)
@@ -577,17 +721,27 @@ public:
                 source->channel_count(),
                 channel_names);
             source->convert(target);
+            source = target;
+        }
 
-            target->write(filename, m_file_format);
-        } else {
+        if (m_file_format == Bitmap::FileFormat::OpenEXR)
+            source->metadata().set_string("compression", m_compression);
+
+        if (write_async)
+            source->write_async(filename, m_file_format);
+        else
             source->write(filename, m_file_format);
-        }
     }
 
     void schedule_storage() override {
-        dr::schedule(m_storage->tensor());
+        if (m_half_storage)
+            dr::schedule(m_packed);
+        else
+            dr::schedule(m_storage->tensor());
     };
 
+    const ImageBlock *storage() const override { return m_storage.get(); }
+
     std::string to_string() const override {
         std::ostringstream oss;
         oss << "HDRFilm[" << std::endl
@@ -596,6 +750,7 @@ public:
             << "  crop_offset = " << m_crop_offset << "," << std::endl
             << "  sample_border = " << m_sample_border << "," << std::endl
             << "  compensate = " << m_compensate << "," << std::endl
+            << "  storage_format = " << (m_half_storage ? "float16" : "float32") << "," << std::endl
             << "  filter = " << m_filter << "," << std::endl
             << "  file_format = " << m_file_format << "," << std::endl
             << "  pixel_format = " << m_pixel_format << "," << std::endl
@@ -606,12 +761,126 @@ public:
 
     MI_DECLARE_CLASS()
 protected:
+    /// Index of the weight channel of the film storage
+    uint32_t weight_channel() const {
+        return has_flag(m_flags, FilmFlags::Alpha) ? 4 : 3;
+    }
+
+    /// Per-element mask and indices of the weight channel of the storage
+    std::pair<Mask, UInt32> weight_index(size_t size) const {
+        if constexpr (dr::is_jit_v<Float>) {
+            uint32_t channels = (uint32_t) m_channels.size();
+            UInt32 idx = dr::arange<UInt32>(size),
+                   pixel = idx / channels,
+                   channel = dr::fmadd(pixel, uint32_t(-(int) channels), idx);
+            return { dr::eq(channel, weight_channel()),
+                     dr::fmadd(pixel, channels, weight_channel()) };
+        } else {
+            DRJIT_MARK_USED(size);
+            return { false, 0u };
+        }
+    }
+
+    /// Decode values stored as a half precision value and error term
+    static Float unpack(const UInt32 &packed) {
+        return math::half_to_float(packed >> 16) +
+               math::half_to_float(packed & 0xFFFFu);
+    }
+
+    /// Encode values as a half precision value and error term
+    static UInt32 pack(const Float &value) {
+        UInt32 hi = math::float_to_half(value);
+        Float residual = value - math::half_to_float(hi);
+        return (hi << 16) | math::float_to_half(residual);
+    }
+
+    /// Reconstruct the accumulated (unnormalized) storage from \ref m_packed
+    Float unpack_storage() const {
+        if constexpr (dr::is_jit_v<Float>) {
+            auto [is_weight, w_idx] = weight_index(dr::width(m_packed));
+            Float value  = unpack(m_packed),
+                  weight = unpack(dr::gather<UInt32>(m_packed, w_idx));
+            return dr::select(is_weight, value, value * weight);
+        } else {
+            return 0.f;
+        }
+    }
+
+    /**
+     * \brief Add an image block to the half precision storage
+     *
+     * The block is first resampled into a single precision block that
+     * matches the storage (which simply references the data of blocks that
+     * already cover the same region). The channels are stored divided by
+     * the accumulated weight to keep them within the range of half precision
+     * values, and the storage tensor is replaced by an (unevaluated)
+     * reconstruction of the accumulated values for use by \ref develop() and
+     * related functions.
+     */
+    void fold_block(const ImageBlock *block) {
+        if constexpr (dr::is_jit_v<Float>) {
+            ref<ImageBlock> scratch =
+                new ImageBlock(m_storage->size(), m_storage->offset(),
+                               (uint32_t) m_storage->channel_count());
+            scratch->put_block(block);
+            const Float &values = scratch->tensor().array();
+
+            auto [is_weight, w_idx] = weight_index(dr::width(m_packed));
+            Float weight = dr::gather<Float>(values, w_idx) +
+                           unpack(dr::gather<UInt32>(m_packed, w_idx));
+            Float sum = unpack_storage() + values;
+
+            m_packed = pack(dr::select(
+                is_weight, sum,
+                dr::select(dr::eq(weight, 0.f), 0.f, sum / weight)));
+
+            TensorXf &tensor = m_storage->tensor();
+            tensor = TensorXf(unpack_storage(), tensor.ndim(),
+                              tensor.shape().data());
+        } else {
+            DRJIT_MARK_USED(block);
+        }
+    }
+
+    /// Normalize and tonemap a film value for \ref develop_preview()
+    template <typename Value, typename Mask>
+    static Value preview_value(Value value, const Value &weight,
+                               const Mask &is_alpha, ScalarFloat scale,
+                               bool aces, bool quantize) {
+        value /= dr::select(dr::eq(weight, 0.f), 1.f, weight);
+
+        Value color = value * scale;
+
+        // Fitted ACES filmic curve by Krzysztof Narkowicz
+        if (aces)
+            color = (color * dr::fmadd(color, 2.51f, .03f)) /
+                    dr::fmadd(color, dr::fmadd(color, 2.43f, .59f), .14f);
+
+        if (quantize) {
+            // Map NaNs and negative values to zero
+            value = dr::minimum(dr::select(value > 0.f, value, 0.f), 1.f);
+            color = dr::minimum(dr::select(color > 0.f, color, 0.f), 1.f);
+
+            // sRGB transfer function
+            color = dr::select(color <= 0.0031308f, color * 12.92f,
+                               dr::fmadd(dr::pow(color, 1.f / 2.4f), 1.055f,
+                                         -0.055f));
+        }
+
+        return dr::select(is_alpha, value, color);
+    }
+
     Bitmap::FileFormat m_file_format;
     Bitmap::PixelFormat m_pixel_format;
     Struct::Type m_component_format;
+    std::string m_compression;
     bool m_compensate;
     ref<ImageBlock> m_storage;
-    mutable std::mutex m_mutex;
+    /// Store the film in half precision? (see \ref fold_block())
+    bool m_half_storage;
+    /// Packed half precision values and error terms (JIT variants)
+    UInt32Storage m_packed;
+    mutable std::shared_mutex m_mutex;
     std::vector<std::string> m_channels;
 };
 
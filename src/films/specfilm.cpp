@@ -1,6 +1,7 @@
 #include <mitsuba/core/bitmap.h>
 #include <mitsuba/core/filesystem.h>
 #include <mitsuba/core/fstream.h>
+#include <mitsuba/core/math.h>
 #include <mitsuba/core/spectrum.h>
 #include <mitsuba/core/string.h>
 #include <mitsuba/render/film.h>
@@ -8,6 +9,7 @@
 #include <mitsuba/render/imageblock.h>
 #include <mitsuba/render/texture.h>
 #include <mitsuba/core/distr_1d.h>
+#include <drjit/half.h>
 
 #include <mutex>
 
@@ -21,7 +23,7 @@ Spectral film (:monosp:`specfilm`)
 ----------------------------------
 
 .. pluginparameters::
- :extra-rows: 6
+ :extra-rows: 7
 
  * - width, height
    - |int|
@@ -53,6 +55,11 @@ Spectral film (:monosp:`specfilm`)
      in JIT variants and can make sample accumulation quite a bit more expensive.
      (Default: |false|, i.e. disabled)
 
+ * - band_format
+   - |string|
+   - Precision of the precomputed band response table, either :monosp:`float32` or
+     :monosp:`float16`. The latter halves its memory footprint. (Default: :monosp:`float32`)
+
  * - (Nested plugin)
    - :paramtype:`rfilter`
    - Reconstruction filter that should be used by the film. (Default: :monosp:`gaussian`, a windowed
@@ -92,6 +99,11 @@ distribution with all the different SRFs using inverse transform sampling. Then
 samples across all the spectral ranges of wavelengths covered by the SRFs. These strategies greatly
 reduce the spectral noise that would appear if each channel were calculated independently.
 
+The responses of all bands (divided by the combined SRF) are precomputed on a regular wavelength
+grid with a spacing of at most 1 nm, and stored in a single table that interleaves the bands of each
+wavelength. Splatting a sample then only interpolates between two rows of this table, so that the
+cost of films with many bands stays low.
+
 .. subfigstart::
 .. subfigure:: ../../resources/data/docs/images/films/cbox_complete.png
    :caption: ``RGB`` spectral rendering
@@ -147,7 +159,9 @@ public:
     MI_IMPORT_BASE(Film, m_size, m_crop_size, m_crop_offset, m_sample_border,
                    m_filter, m_flags, m_srf, set_crop_window)
     MI_IMPORT_TYPES(ImageBlock, Texture)
-    using FloatStorage = DynamicBuffer<Float>;
+    using FloatStorage  = DynamicBuffer<Float>;
+    using UInt16        = dr::replace_scalar_t<Float, uint16_t>;
+    using UInt16Storage = DynamicBuffer<UInt16>;
 
     SpecFilm(const Properties &props) : Base(props) {
         if constexpr (!is_spectral_v<Spectrum>)
@@ -187,9 +201,18 @@ public:
 
         m_compensate = props.get<bool>("compensate", false);
 
+        std::string band_format = string::to_lower(
+            props.string("band_format", "float32"));
+        if (band_format != "float32" && band_format != "float16")
+            Throw("The \"band_format\" parameter must either be equal to "
+                  "\"float32\" or \"float16\". Found %s instead.",
+                  band_format);
+        m_half_bands = band_format == "float16";
+
         m_flags = FilmFlags::Spectral | FilmFlags::Special;
 
         compute_srf_sampling();
+        compute_band_table();
     }
 
     void traverse(TraversalCallback *callback) override {
@@ -198,6 +221,11 @@ public:
             callback->put_object(m_names[i], m_srfs[i].get(), +ParamFlags::NonDifferentiable);
     }
 
+    void parameters_changed(const std::vector<std::string> &keys) override {
+        Base::parameters_changed(keys);
+        compute_band_table();
+    }
+
     void compute_srf_sampling() {
         ScalarFloat resolution = dr::Infinity<ScalarFloat>;
         // Compute full range of wavelengths and resolution in the film
@@ -248,6 +276,76 @@ public:
         m_srf = PluginManager::instance()->create_object<Texture>(props);
     }
 
+    /**
+     * \brief Tabulate the responses of all bands divided by the combined SRF
+     *
+     * The table has one row per node of a regular wavelength grid that
+     * covers \ref m_range, each of which stores the values of all bands.
+     */
+    void compute_band_table() {
+        ScalarFloat resolution = 1.f;
+        for (auto srf : m_srfs)
+            resolution = dr::minimum(resolution, srf->spectral_resolution());
+
+        size_t bands = m_srfs.size(),
+               n_points = std::max((size_t) 2, (size_t) dr::ceil(
+                   (m_range.y() - m_range.x()) / resolution + 1));
+
+        std::vector<ScalarFloat> table(n_points * bands);
+        SurfaceInteraction3f si = dr::zeros<SurfaceInteraction3f>();
+
+        if constexpr (dr::is_jit_v<Float>) {
+            si.wavelengths = dr::linspace<Float>(m_range.x(), m_range.y(), n_points);
+            for (size_t j = 0; j < bands; ++j) {
+                FloatStorage values = m_srfs[j]->eval(si).x();
+                auto &&host = dr::migrate(values, AllocType::Host);
+                dr::sync_thread();
+                for (size_t k = 0; k < n_points; ++k)
+                    table[k * bands + j] = host.data()[k];
+            }
+        } else {
+            for (size_t k = 0; k < n_points; ++k) {
+                si.wavelengths = dr::lerp(m_range.x(), m_range.y(),
+                                          k / (ScalarFloat) (n_points - 1));
+                for (size_t j = 0; j < bands; ++j)
+                    table[k * bands + j] = m_srfs[j]->eval(si).x();
+            }
+        }
+
+        // The SRF is not necessarily normalized, cancel out multiplicative factors
+        for (size_t k = 0; k < n_points; ++k) {
+            ScalarFloat *row = table.data() + k * bands, sum = 0.f;
+            for (size_t j = 0; j < bands; ++j)
+                sum += row[j];
+            if (sum != 0.f) {
+                for (size_t j = 0; j < bands; ++j)
+                    row[j] /= sum;
+            }
+        }
+
+        m_table_size = (uint32_t) n_points;
+        if (m_half_bands) {
+            std::vector<uint16_t> half(table.size());
+            for (size_t i = 0; i < table.size(); ++i)
+                half[i] = dr::half::float32_to_float16((float) table[i]);
+            m_band_table_half = dr::load<UInt16Storage>(half.data(), half.size());
+            m_band_table = FloatStorage();
+        } else {
+            m_band_table = dr::load<FloatStorage>(table.data(), table.size());
+            m_band_table_half = UInt16Storage();
+        }
+    }
+
+    /// Look up the (normalized) response of band \c j in row \c row of the band table
+    Float band_response(const UInt32 &row, size_t j, Mask active) const {
+        UInt32 index = row + (uint32_t) j;
+        if (m_half_bands)
+            return Float(math::half_to_float(
+                UInt32(dr::gather<UInt16>(m_band_table_half, index, active))));
+        else
+            return dr::gather<Float>(m_band_table, index, active);
+    }
+
     size_t base_channels_count() const override {
         return m_srfs.size();
     }
@@ -261,7 +359,7 @@ public:
 
         /* locked */ {
             m_channels = sorted;
-            std::lock_guard<std::mutex> lock(m_mutex);
+            std::lock_guard<std::shared_mutex> lock(m_mutex);
             m_storage = new ImageBlock(m_crop_size, m_crop_offset,
                                        (uint32_t) m_channels.size());
         }
@@ -293,29 +391,38 @@ public:
                         Float* aovs, Float weight, Float /* alpha */, Mask /* active */) const override {
         aovs[m_channels.size() - 1] = weight;   // Set sample weight
 
-        SurfaceInteraction3f si = dr::zeros<SurfaceInteraction3f>();
-        si.wavelengths = wavelengths;
+        size_t bands = m_srfs.size();
+        for (size_t j = 0; j < bands; ++j)
+            aovs[j] = dr::zeros<Float>();
 
-        // The SRF is not necessarily normalized, cancel out multiplicative factors
-        UnpolarizedSpectrum inv_spec = m_srf->eval(si);
-        inv_spec = dr::select(dr::neq(inv_spec, 0.f), dr::rcp(inv_spec), 1.f);
-        UnpolarizedSpectrum values = spec * inv_spec;
+        ScalarFloat scale = (m_table_size - 1) / (m_range.y() - m_range.x());
 
-        for (size_t j = 0; j < m_srfs.size(); ++j) {
-            UnpolarizedSpectrum weights = m_srfs[j]->eval(si);
-            aovs[j] = dr::zeros<Float>();
+        for (size_t i = 0; i < Spectrum::Size; ++i) {
+            // Interpolate between the two rows of the band table around the wavelength
+            Float t = (wavelengths[i] - m_range.x()) * scale;
+            Mask valid = t >= 0.f && t <= (ScalarFloat) (m_table_size - 1);
 
-            for (size_t i = 0; i<Spectrum::Size; ++i)
-                aovs[j] = dr::fmadd(weights[i], values[i], aovs[j]);
+            UInt32 k = UInt32(dr::clamp(dr::floor2int<Int32>(t), 0,
+                                        (int32_t) m_table_size - 2));
+            Float f = t - Float(k);
+            UInt32 row0 = k * (uint32_t) bands,
+                   row1 = row0 + (uint32_t) bands;
+            Float value = dr::select(valid, spec[i], 0.f);
 
-            aovs[j] *= 1.f / Spectrum::Size;
+            for (size_t j = 0; j < bands; ++j) {
+                Float w = dr::lerp(band_response(row0, j, valid),
+                                   band_response(row1, j, valid), f);
+                aovs[j] = dr::fmadd(w, value, aovs[j]);
+            }
         }
+
+        for (size_t j = 0; j < bands; ++j)
+            aovs[j] *= 1.f / Spectrum::Size;
     }
 
     void put_block(const ImageBlock *block) override {
         Assert(m_storage != nullptr);
-        std::lock_guard<std::mutex> lock(m_mutex);
-        m_storage->put_block(block);
+        put_block_striped(m_storage, block, m_mutex);
     }
     
     void clear() override {
@@ -328,7 +435,7 @@ public:
             Throw("No storage allocated, was prepare() called first?");
 
         if (raw) {
-            std::lock_guard<std::mutex> lock(m_mutex);
+            std::lock_guard<std::shared_mutex> lock(m_mutex);
             return m_storage->tensor();
         }
 
@@ -339,7 +446,7 @@ public:
             ScalarVector2i size;
 
             /* locked */ {
-                std::lock_guard<std::mutex> lock(m_mutex);
+                std::lock_guard<std::shared_mutex> lock(m_mutex);
                 data         = m_storage->tensor().array();
                 size         = m_storage->size();
                 source_ch    = (uint32_t) m_storage->channel_count();
@@ -390,7 +497,7 @@ public:
         if (!m_storage)
             Throw("No storage allocated, was prepare() called first?");
 
-        std::lock_guard<std::mutex> lock(m_mutex);
+        std::lock_guard<std::shared_mutex> lock(m_mutex);
         auto &&storage = dr::migrate(m_storage->tensor().array(), AllocType::Host);
 
         if constexpr (dr::is_jit_v<Float>)
@@ -420,7 +527,7 @@ public:
         return target;
     }
 
-    void write(const fs::path &path) const override {
+    void write(const fs::path &path, bool write_async) const override {
         fs::path filename = path;
         std::string proper_extension = ".exr";
 
@@ -448,17 +555,21 @@ public:
                 source->channel_count(),
                 channel_names);
             source->convert(target);
+            source = target;
+        }
 
-            target->write(filename, m_file_format);
-        } else {
+        if (write_async)
+            source->write_async(filename, m_file_format);
+        else
             source->write(filename, m_file_format);
-        }
     }
 
     void schedule_storage() override {
         dr::schedule(m_storage->tensor());
     };
 
+    const ImageBlock *storage() const override { return m_storage.get(); }
+
     std::string to_string() const override {
         std::ostringstream oss;
         oss << "SpecFilm[" << std::endl
@@ -486,11 +597,19 @@ protected:
     Struct::Type m_component_format;
     bool m_compensate;
     ref<ImageBlock> m_storage;
-    mutable std::mutex m_mutex;
+    mutable std::shared_mutex m_mutex;
     std::vector<std::string> m_channels;
     std::vector<ref<Texture>> m_srfs;
     std::vector<std::string> m_names;
     ScalarVector2f m_range { dr::Infinity<ScalarFloat>, -dr::Infinity<ScalarFloat> };
+
+    /// Interleaved band responses (see \ref compute_band_table())
+    FloatStorage m_band_table;
+    /// Half precision version of \ref m_band_table (if \c band_format is \c float16)
+    UInt16Storage m_band_table_half;
+    /// Number of rows of the band table
+    uint32_t m_table_size = 0;
+    bool m_half_bands;
 };
 
 MI_IMPLEMENT_CLASS_VARIANT(SpecFilm, Film)
@@ -0,0 +1,501 @@
+#include <mitsuba/core/bitmap.h>
+#include <mitsuba/core/filesystem.h>
+#include <mitsuba/core/fstream.h>
+#include <mitsuba/core/profiler.h>
+#include <mitsuba/core/scanlinewriter.h>
+#include <mitsuba/core/spectrum.h>
+#include <mitsuba/core/string.h>
+#include <mitsuba/render/film.h>
+#include <mitsuba/render/fwd.h>
+#include <mitsuba/render/imageblock.h>
+
+#include <fstream>
+#include <map>
+#include <mutex>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**!
+
+.. _film-streamfilm:
+
+Streaming film (:monosp:`streamfilm`)
+-------------------------------------
+
+.. pluginparameters::
+
+ * - width, height
+   - |int|
+   - Width and height of the camera sensor in pixels. Default: 768, 576)
+
+ * - pixel_format
+   - |string|
+   - Specifies the desired pixel format of the output image. The options are
+     :monosp:`luminance`, :monosp:`luminance_alpha`, :monosp:`rgb`, and
+     :monosp:`rgba`. (Default: :monosp:`rgb`)
+
+ * - component_format
+   - |string|
+   - Specifies the floating point component format of the output image. The
+     options are :monosp:`float16` or :monosp:`float32`.
+     (Default: :monosp:`float16`)
+
+ * - band_height
+   - |int|
+   - Minimum number of finished rows that are developed and written to disk
+     at once. (Default: 32)
+
+ * - temp_dir
+   - |string|
+   - Directory of the intermediate file that receives the image while
+     rendering. It is moved to the final location by :monosp:`write()`, which
+     is cheapest when both reside on the same file system. (Default: the
+     current working directory)
+
+ * - crop_offset_x, crop_offset_y, crop_width, crop_height, sample_border
+   - |int|, |bool|
+   - See the :ref:`hdrfilm <film-hdrfilm>` plugin.
+
+ * - (Nested plugin)
+   - :paramtype:`rfilter`
+   - Reconstruction filter that should be used by the film. (Default: :monosp:`gaussian`, a windowed
+     Gaussian filter)
+
+This film produces the same OpenEXR output as :ref:`hdrfilm <film-hdrfilm>`
+but never holds the entire image in memory, which makes it suitable for
+gigapixel renders. Only the rows touched by blocks that are currently being
+rendered are resident. As soon as all blocks that contribute to a row (taking
+the border of the reconstruction filter into account) have been committed,
+the row is developed and appended to a scanline OpenEXR file on disk. The
+memory usage therefore scales with the width of the image times the block size
+and the number of threads instead of with the size of the image.
+
+The integrator hands out blocks in scanline order when this film is used.
+Every pixel must be rendered in a single pass, hence the
+:monosp:`samples_per_pass` and :monosp:`progressive_spp` integrator parameters
+are not supported. Since the image is not kept in memory, it also cannot be
+developed into a tensor or bitmap. This film is only available in scalar
+variants.
+
+.. tabs::
+    .. code-tab::  xml
+
+        <film type="streamfilm">
+            <integer name="width" value="100000"/>
+            <integer name="height" value="50000"/>
+        </film>
+
+    .. code-tab:: python
+
+        'type': 'streamfilm',
+        'width': 100000,
+        'height': 50000
+
+ */
+
+template <typename Float, typename Spectrum>
+class StreamFilm final : public Film<Float, Spectrum> {
+public:
+    MI_IMPORT_BASE(Film, m_size, m_crop_size, m_crop_offset, m_sample_border,
+                   m_filter, m_flags)
+    MI_IMPORT_TYPES(ImageBlock)
+
+    StreamFilm(const Properties &props) : Base(props) {
+        if constexpr (dr::is_jit_v<Float>)
+            Throw("The streaming film is only supported in scalar variants.");
+
+        std::string pixel_format = string::to_lower(
+            props.string("pixel_format", "rgb"));
+        std::string component_format = string::to_lower(
+            props.string("component_format", "float16"));
+
+        if (pixel_format == "luminance_alpha") {
+            m_pixel_format = Bitmap::PixelFormat::YA;
+            m_flags = +FilmFlags::Alpha;
+        } else if (pixel_format == "luminance" || is_monochromatic_v<Spectrum>) {
+            m_pixel_format = Bitmap::PixelFormat::Y;
+            m_flags = +FilmFlags::Empty;
+            if (pixel_format != "luminance")
+                Log(Warn,
+                    "Monochrome mode enabled, setting film output pixel format "
+                    "to 'luminance' (was %s).",
+                    pixel_format);
+        } else if (pixel_format == "rgb") {
+            m_pixel_format = Bitmap::PixelFormat::RGB;
+            m_flags = +FilmFlags::Empty;
+        } else if (pixel_format == "rgba") {
+            m_pixel_format = Bitmap::PixelFormat::RGBA;
+            m_flags = +FilmFlags::Alpha;
+        } else {
+            Throw("The \"pixel_format\" parameter must either be equal to "
+                  "\"luminance\", \"luminance_alpha\", \"rgb\", or \"rgba\". "
+                  "Found %s.", pixel_format);
+        }
+        m_flags |= +FilmFlags::Streaming;
+
+        if (component_format == "float16")
+            m_component_format = Struct::Type::Float16;
+        else if (component_format == "float32")
+            m_component_format = Struct::Type::Float32;
+        else
+            Throw("The \"component_format\" parameter must either be "
+                  "equal to \"float16\" or \"float32\". Found %s instead.",
+                  component_format);
+
+        m_band_height = props.get<uint32_t>("band_height", 32);
+        if (m_band_height == 0)
+            Throw("\"band_height\" must be positive!");
+
+        m_temp_dir = props.string("temp_dir", fs::current_path().string());
+
+        props.mark_queried("banner"); // no banner in Mitsuba 3
+    }
+
+    ~StreamFilm() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        discard();
+    }
+
+    size_t base_channels_count() const override {
+        bool to_y = m_pixel_format == Bitmap::PixelFormat::Y
+                 || m_pixel_format == Bitmap::PixelFormat::YA;
+        bool alpha = has_flag(m_flags, FilmFlags::Alpha);
+        return (to_y ? 1 : 3) + (uint32_t) alpha;
+    }
+
+    size_t prepare(const std::vector<std::string> &aovs) override {
+        bool alpha = has_flag(m_flags, FilmFlags::Alpha);
+        size_t base_channels = alpha ? 5 : 4;
+
+        std::vector<std::string> channels(base_channels + aovs.size());
+
+        // Add basic RGBAW channels to the film
+        const char *base_channel_names = alpha ? "RGBAW" : "RGBW";
+
+        for (size_t i = 0; i < base_channels; ++i)
+            channels[i] = std::string(1, base_channel_names[i]);
+
+        for (size_t i = 0; i < aovs.size(); ++i)
+            channels[base_channels + i] = aovs[i];
+
+        std::vector<std::string> sorted = channels;
+        std::sort(sorted.begin(), sorted.end());
+        auto it = std::unique(sorted.begin(), sorted.end());
+        if (it != sorted.end())
+            Throw("Film::prepare(): duplicate channel name \"%s\"", *it);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_channels = channels;
+        restart();
+
+        return m_channels.size();
+    }
+
+    ref<ImageBlock> create_block(const ScalarVector2u &size, bool normalize,
+                                 bool border) override {
+        bool warn = !is_spectral_v<Spectrum> && m_channels.size() <= 5;
+        bool default_config = size == ScalarVector2u(0);
+
+        return new ImageBlock(default_config ? m_crop_size : size,
+                              default_config ? m_crop_offset : ScalarPoint2u(0),
+                              (uint32_t) m_channels.size(), m_filter.get(),
+                              border /* border */,
+                              normalize /* normalize */,
+                              false /* coalesce */,
+                              false /* compensate */,
+                              warn /* warn_negative */,
+                              warn /* warn_invalid */);
+    }
+
+    void put_block(const ImageBlock *block) override {
+        ScopedPhase sp(ProfilerPhase::ImageBlockPut);
+
+        if constexpr (!dr::is_jit_v<Float>) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_writer)
+                Throw("No storage allocated, was prepare() called first?");
+
+            uint32_t channels = (uint32_t) m_channels.size();
+            if (block->channel_count() != channels)
+                Throw("StreamFilm::put_block(): mismatched channel counts! "
+                      "(%u, expected %u)", block->channel_count(), channels);
+
+            int border = (int) block->border_size(),
+                width  = (int) m_crop_size.x(),
+                height = (int) m_crop_size.y();
+
+            // Position of the block (without and with its border) on the crop window
+            ScalarVector2i offset(block->offset() - ScalarPoint2i(m_crop_offset)),
+                           origin = offset - border,
+                           size(block->size()),
+                           full_size = size + 2 * border;
+
+            int x0 = std::max(origin.x(), 0), x1 = std::min(origin.x() + full_size.x(), width),
+                y0 = std::max(origin.y(), 0), y1 = std::min(origin.y() + full_size.y(), height);
+
+            if (x0 < x1 && y0 < y1) {
+                if (y0 < (int) m_rows_written)
+                    Throw("StreamFilm::put_block(): received a block that "
+                          "overlaps rows that were already written to disk. "
+                          "This film requires blocks to be committed once "
+                          "and in scanline order.");
+
+                const ScalarFloat *data = block->tensor().data();
+                for (int y = y0; y < y1; ++y) {
+                    const ScalarFloat *src =
+                        data + ((size_t) (y - origin.y()) * full_size.x() +
+                                (x0 - origin.x())) * channels;
+                    ScalarFloat *dst = row(y) + (size_t) x0 * channels;
+                    for (size_t i = 0, n = (size_t) (x1 - x0) * channels; i < n; ++i)
+                        dst[i] += src[i];
+                }
+            }
+
+            // Record the pixels that were rendered by this block
+            int ext = m_extra_rows;
+            int cx0 = std::max(offset.x(), -ext), cx1 = std::min(offset.x() + size.x(), width + ext),
+                cy0 = std::max(offset.y(), -ext), cy1 = std::min(offset.y() + size.y(), height + ext);
+            if (cx0 < cx1) {
+                for (int y = cy0; y < cy1; ++y)
+                    m_coverage[y + ext] += (uint32_t) (cx1 - cx0);
+            }
+
+            if (border > m_radius)
+                m_radius = border;
+
+            // Find rows whose neighborhood has been rendered completely
+            uint32_t full_width = (uint32_t) (width + 2 * ext);
+            while ((int) m_rows_final < height) {
+                int r  = (int) m_rows_final,
+                    lo = std::max(r - m_radius, -ext),
+                    hi = std::min(r + m_radius, height - 1 + ext);
+                bool complete = true;
+                for (int y = lo; y <= hi && complete; ++y)
+                    complete = m_coverage[y + ext] == full_width;
+                if (!complete)
+                    break;
+                m_rows_final++;
+            }
+
+            if (m_rows_final - m_rows_written >= m_band_height ||
+                (m_rows_final == (uint32_t) height && m_rows_final > m_rows_written))
+                flush(m_rows_final);
+        } else {
+            DRJIT_MARK_USED(block);
+        }
+    }
+
+    void clear() override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_writer)
+            restart();
+    }
+
+    TensorXf develop(bool /* raw */ = false) const override {
+        Throw("StreamFilm::develop(): the image is streamed to disk and "
+              "cannot be developed in memory!");
+    }
+
+    ref<Bitmap> bitmap(bool /* raw */ = false) const override {
+        Throw("StreamFilm::bitmap(): the image is streamed to disk and "
+              "cannot be developed in memory!");
+    }
+
+    /* Most rows were already written while rendering, the remaining ones
+       are always flushed synchronously */
+    void write(const fs::path &path, bool /* write_async */) const override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_writer)
+            Throw("StreamFilm::write(): no image available, was prepare() "
+                  "called and was the image already written?");
+
+        fs::path filename = path;
+        std::string extension = string::to_lower(filename.extension().string());
+        if (extension != ".exr")
+            filename.replace_extension(".exr");
+
+        #if !defined(_WIN32)
+            Log(Info, "\U00002714  Developing \"%s\" ..", filename.string());
+        #else
+            Log(Info, "Developing \"%s\" ..", filename.string());
+        #endif
+
+        // Flush the remaining rows (they are incomplete if rendering was stopped)
+        uint32_t height = m_crop_size.y();
+        if (m_rows_final != height)
+            Log(Warn, "StreamFilm::write(): only %u of %u rows were rendered "
+                      "completely!", m_rows_final, height);
+        if (m_rows_written < height)
+            flush(height);
+
+        m_writer->close();
+        m_writer = nullptr;
+
+        if (fs::exists(filename))
+            fs::remove(filename);
+
+        if (!fs::rename(m_temp_path, filename)) {
+            // Different file systems, copy the file instead
+            {
+                std::ifstream src(m_temp_path.string(), std::ios::binary);
+                std::ofstream dst(filename.string(), std::ios::binary);
+                dst << src.rdbuf();
+                if (!src || !dst)
+                    Throw("StreamFilm::write(): could not copy \"%s\" to \"%s\"!",
+                          m_temp_path, filename);
+            }
+            fs::remove(m_temp_path);
+        }
+        m_temp_path = fs::path();
+    }
+
+    void schedule_storage() override { }
+
+    std::string to_string() const override {
+        std::ostringstream oss;
+        oss << "StreamFilm[" << std::endl
+            << "  size = " << m_size << "," << std::endl
+            << "  crop_size = " << m_crop_size << "," << std::endl
+            << "  crop_offset = " << m_crop_offset << "," << std::endl
+            << "  sample_border = " << m_sample_border << "," << std::endl
+            << "  filter = " << m_filter << "," << std::endl
+            << "  pixel_format = " << m_pixel_format << "," << std::endl
+            << "  component_format = " << m_component_format << "," << std::endl
+            << "  band_height = " << m_band_height << "," << std::endl
+            << "  temp_dir = \"" << m_temp_dir << "\"" << std::endl
+            << "]";
+        return oss.str();
+    }
+
+    MI_DECLARE_CLASS()
+
+protected:
+    /// Return the (zero-initialized) accumulation buffer of a resident row
+    ScalarFloat *row(int y) {
+        auto it = m_rows.find((uint32_t) y);
+        if (it == m_rows.end()) {
+            size_t n = (size_t) m_crop_size.x() * m_channels.size();
+            std::unique_ptr<ScalarFloat[]> buf(new ScalarFloat[n]);
+            std::fill(buf.get(), buf.get() + n, (ScalarFloat) 0);
+            it = m_rows.emplace((uint32_t) y, std::move(buf)).first;
+        }
+        return it->second.get();
+    }
+
+    /// Create the output bitmap for a band of the given number of rows
+    ref<Bitmap> create_band(uint32_t rows) const {
+        bool alpha = has_flag(m_flags, FilmFlags::Alpha),
+             to_y  = m_pixel_format == Bitmap::PixelFormat::Y ||
+                     m_pixel_format == Bitmap::PixelFormat::YA;
+        size_t base_ch = alpha ? 5 : 4;
+
+        std::vector<std::string> names;
+        if (to_y)
+            names.push_back("Y");
+        else
+            names.insert(names.end(), { "R", "G", "B" });
+        if (alpha)
+            names.push_back("A");
+        names.insert(names.end(), m_channels.begin() + base_ch, m_channels.end());
+
+        ref<Bitmap> band = new Bitmap(
+            Bitmap::PixelFormat::MultiChannel, m_component_format,
+            ScalarVector2u(m_crop_size.x(), rows), names.size(), names);
+
+        if (to_y)
+            band->struct_()->operator[](0).blend = {
+                { 0.212671f, "R" },
+                { 0.715160f, "G" },
+                { 0.072169f, "B" }
+            };
+
+        return band;
+    }
+
+    /// Develop the resident rows up to \c end and append them to the file
+    void flush(uint32_t end) const {
+        uint32_t start = m_rows_written, rows = end - start,
+                 channels = (uint32_t) m_channels.size();
+        size_t row_size = (size_t) m_crop_size.x() * channels;
+
+        std::unique_ptr<ScalarFloat[]> data(new ScalarFloat[row_size * rows]);
+        for (uint32_t y = start; y < end; ++y) {
+            ScalarFloat *dst = data.get() + (y - start) * row_size;
+            auto it = m_rows.find(y);
+            if (it != m_rows.end()) {
+                std::copy(it->second.get(), it->second.get() + row_size, dst);
+                m_rows.erase(it);
+            } else {
+                std::fill(dst, dst + row_size, (ScalarFloat) 0);
+            }
+        }
+
+        ref<Bitmap> source = new Bitmap(
+            Bitmap::PixelFormat::MultiChannel, struct_type_v<ScalarFloat>,
+            ScalarVector2u(m_crop_size.x(), rows), channels, m_channels,
+            (uint8_t *) data.get());
+        source->struct_()->operator[](has_flag(m_flags, FilmFlags::Alpha) ? 4 : 3)
+            .flags |= +Struct::Flags::Weight;
+
+        ref<Bitmap> band = create_band(rows);
+        source->convert(band);
+        m_writer->write_rows(band);
+
+        m_rows_written = end;
+        m_rows_final = std::max(m_rows_final, end);
+    }
+
+    /// Release the resident rows and start a new output file
+    void restart() {
+        discard();
+
+        int ext = m_sample_border ? (int) m_filter->border_size() : 0;
+        m_extra_rows = ext;
+        m_radius = (int) m_filter->border_size();
+        m_coverage.assign(m_crop_size.y() + 2 * ext, 0);
+        m_rows_final = m_rows_written = 0;
+
+        m_temp_path = fs::path(m_temp_dir) /
+                      tfm::format("mitsuba_streamfilm_%p.exr", (const void *) this);
+        m_writer = new ScanlineWriter(m_temp_path, m_crop_size,
+                                      create_band(1)->struct_());
+    }
+
+    /// Close and delete the intermediate file, if any
+    void discard() const {
+        m_rows.clear();
+        if (m_writer) {
+            m_writer->close();
+            m_writer = nullptr;
+        }
+        if (!m_temp_path.empty() && fs::exists(m_temp_path))
+            fs::remove(m_temp_path);
+        m_temp_path = fs::path();
+    }
+
+protected:
+    Bitmap::PixelFormat m_pixel_format;
+    Struct::Type m_component_format;
+    uint32_t m_band_height;
+    std::string m_temp_dir;
+    std::vector<std::string> m_channels;
+
+    /// Resident rows of the crop window, indexed by row
+    mutable std::map<uint32_t, std::unique_ptr<ScalarFloat[]>> m_rows;
+    /// Number of rendered pixels per row (including 'm_extra_rows' rows above and below)
+    std::vector<uint32_t> m_coverage;
+    /// Rows sampled outside of the crop window when 'sample_border' is set
+    int m_extra_rows = 0;
+    /// Largest block border seen so far (rows influenced by a pixel)
+    int m_radius = 0;
+    /// Number of leading rows that are complete / that were written to disk
+    mutable uint32_t m_rows_final = 0, m_rows_written = 0;
+
+    mutable ref<ScanlineWriter> m_writer;
+    mutable fs::path m_temp_path;
+    mutable std::mutex m_mutex;
+};
+
+MI_IMPLEMENT_CLASS_VARIANT(StreamFilm, Film)
+MI_EXPORT_PLUGIN(StreamFilm, "Streaming film")
+NAMESPACE_END(mitsuba)
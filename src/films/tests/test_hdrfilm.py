@@ -237,3 +237,118 @@ def test07_luminance_alpha_mono(variants_all):
     image = mi.TensorXf(film.bitmap())
 
     assert image.shape[2] == 2
+
+
+@pytest.mark.parametrize('aces', [False, True])
+def test08_develop_preview(variants_all_rgb, aces):
+    film = mi.load_dict({
+        'type': 'hdrfilm',
+        'pixel_format': 'rgba',
+        'width': 4,
+        'height': 3,
+        'rfilter': { 'type': 'box' }
+    })
+
+    res = film.size()
+    block = mi.ImageBlock(res, [0, 0], 8, film.rfilter())
+
+    if dr.is_jit_v(mi.Float):
+        pixel_idx = dr.arange(mi.UInt32, dr.prod(res))
+        x = mi.Float(pixel_idx % res[0])
+        y = mi.Float(pixel_idx // res[0])
+        block.put(mi.Point2f(x, y) + 0.5,
+                  [0.1 * x, 0.3 * y, 0.05, 0.5, 2.0, 7.0, 8.0, 9.0])
+    else:
+        for y in range(res[1]):
+            for x in range(res[0]):
+                block.put([x + 0.5, y + 0.5],
+                          [0.1 * x, 0.3 * y, 0.05, 0.5, 2.0, 7.0, 8.0, 9.0])
+
+    film.prepare(['aov.x', 'aov.y', 'aov.z'])
+    film.put_block(block)
+
+    # Reference: develop the color channels and tonemap them on the host
+    image = film.develop()
+    rgb = image[:, :, :3].array * 2.0
+    alpha = image[:, :, 3].array
+    if aces:
+        rgb = (rgb * (2.51 * rgb + 0.03)) / (rgb * (2.43 * rgb + 0.59) + 0.14)
+
+    preview = film.develop_preview(exposure=1.0, aces=aces,
+                                   component_format=mi.Struct.Type.Float16)
+    assert preview.pixel_format() == mi.Bitmap.PixelFormat.RGBA
+    assert not preview.srgb_gamma()
+    values = mi.TensorXf(preview.convert(component_format=mi.Struct.Type.Float32))
+    assert dr.allclose(values[:, :, :3].array, rgb, rtol=1e-3, atol=1e-3)
+    assert dr.allclose(values[:, :, 3].array, alpha, rtol=1e-3)
+
+    # 8 bit output is additionally clamped and sRGB-encoded
+    rgb = dr.clamp(rgb, 0.0, 1.0)
+    srgb = dr.select(rgb <= 0.0031308, rgb * 12.92,
+                     1.055 * dr.power(rgb, 1.0 / 2.4) - 0.055)
+
+    preview = film.develop_preview(exposure=1.0, aces=aces)
+    assert preview.srgb_gamma()
+    values = mi.TensorXf(preview.convert(component_format=mi.Struct.Type.Float32,
+                                         srgb_gamma=True))
+    assert dr.allclose(values[:, :, :3].array, srgb, atol=1.0 / 255)
+    assert dr.allclose(values[:, :, 3].array, alpha, atol=1.0 / 255)
+
+
+def test09_write_async(variants_all_rgb, tmpdir):
+    film = mi.load_dict({
+        'type': 'hdrfilm',
+        'width': 16,
+        'height': 12,
+        'pixel_format': 'rgb',
+        'filter': {'type': 'box'}
+    })
+
+    block = mi.ImageBlock(film.size(), [0, 0], 5, film.rfilter())
+    block.put([4.5, 3.5], [1.0, 2.0, 3.0, 1.0, 1.0])
+    film.prepare([])
+    film.put_block(block)
+
+    filename = str(tmpdir.join('test_image.exr'))
+    film.write(filename, write_async=True)
+    mi.Thread.wait_for_tasks()
+
+    img = mi.TensorXf(mi.Bitmap(filename))
+    assert dr.allclose(img, mi.TensorXf(film.bitmap()))
+
+
+def test10_half_storage(variants_vec_rgb):
+    def make_film(storage_format):
+        film = mi.load_dict({
+            'type': 'hdrfilm',
+            'width': 8,
+            'height': 4,
+            'pixel_format': 'rgba',
+            'storage_format': storage_format,
+            'filter': {'type': 'box'}
+        })
+        film.prepare([])
+        return film
+
+    film_f32, film_f16 = make_film('float32'), make_film('float16')
+    rng = mi.PCG32(size=32)
+
+    # Accumulate many passes with values outside of the half precision range
+    for i in range(64):
+        block = mi.ImageBlock(film_f32.size(), [0, 0], 5, film_f32.rfilter())
+        pos = mi.Point2f(dr.arange(mi.Float, 32) % 8, dr.arange(mi.Float, 32) // 8) + 0.5
+        value = rng.next_float32() * 1e5
+        block.put(pos, [value, value * 1e-3, value * 1e-6, 1.0, 1.0])
+        film_f32.put_block(block)
+        film_f16.put_block(block)
+
+    ref = film_f32.develop()
+    assert dr.allclose(film_f16.develop(), ref, rtol=1e-4)
+    assert dr.allclose(mi.TensorXf(film_f16.bitmap()), mi.TensorXf(film_f32.bitmap()),
+                       rtol=1e-4)
+
+    film_f16.clear()
+    assert dr.all(film_f16.develop().array == 0)
+
+    with pytest.raises(RuntimeError, match='storage_format'):
+        mi.load_dict({'type': 'hdrfilm', 'storage_format': 'float64'})
@@ -204,3 +204,43 @@ def test07_srf(variants_all_spectral):
 
     dr.allclose(params[key_range], [400, 800])
     dr.allclose(params[key_values], [0.1, 0.2, 0., 0.3, 0.4])
+
+
+@pytest.mark.parametrize('band_format', ['float32', 'float16'])
+def test08_band_table(variants_all_spectral, band_format):
+    film = mi.load_dict({
+        'type': 'specfilm',
+        'band_format': band_format,
+        'band1': {
+            'type': 'spectrum',
+            'value': [(400, 1.0), (700, 1.0)]
+        },
+        'band2': {
+            'type': 'spectrum',
+            'value': [(400, 0.0), (700, 3.0)]
+        },
+    })
+    film.prepare([])
+
+    wavelengths = [450.0, 500.0, 575.5, 650.0]
+    spec = mi.UnpolarizedSpectrum(2.0)
+    aovs = film.prepare_sample(spec, mi.Wavelength(wavelengths), 3)
+
+    # Each band receives its share of the combined response
+    expected = [0.0, 0.0]
+    for w in wavelengths:
+        b1, b2 = 1.0, 3.0 * (w - 400.0) / 300.0
+        expected[0] += 2.0 * b1 / (b1 + b2) / len(wavelengths)
+        expected[1] += 2.0 * b2 / (b1 + b2) / len(wavelengths)
+
+    rtol = 1e-3 if band_format == 'float32' else 2e-3
+    assert dr.allclose(aovs[0], expected[0], rtol=rtol)
+    assert dr.allclose(aovs[1], expected[1], rtol=rtol)
+    assert dr.allclose(aovs[2], 1.0)
+
+    with pytest.raises(RuntimeError, match='band_format'):
+        mi.load_dict({
+            'type': 'specfilm',
+            'band_format': 'float64',
+            'band1': { 'type': 'spectrum', 'value': 1.0 }
+        })
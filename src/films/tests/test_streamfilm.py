@@ -0,0 +1,103 @@
+import pytest
+import drjit as dr
+import mitsuba as mi
+
+
+def test01_construct(variant_scalar_rgb):
+    film = mi.load_dict({'type': 'streamfilm'})
+    assert film is not None
+    assert mi.has_flag(film.flags(), mi.FilmFlags.Streaming)
+
+    with pytest.raises(RuntimeError):
+        mi.load_dict({'type': 'streamfilm', 'pixel_format': 'xyz'})
+    with pytest.raises(RuntimeError):
+        mi.load_dict({'type': 'streamfilm', 'component_format': 'uint32'})
+
+
+@pytest.mark.parametrize('pixel_format', ['rgb', 'luminance_alpha'])
+def test02_matches_hdrfilm(variant_scalar_rgb, pixel_format, tmpdir):
+    import numpy as np
+
+    # Commit the same blocks in scanline order to both films
+    desc = {
+        'width': 45,
+        'height': 37,
+        'pixel_format': pixel_format,
+        'component_format': 'float32',
+        'filter': {'type': 'gaussian'}
+    }
+    films = [mi.load_dict(dict(desc, type=t, band_height=4) if t == 'streamfilm'
+                          else dict(desc, type=t))
+             for t in ['hdrfilm', 'streamfilm']]
+
+    rng = np.random.default_rng(seed=1234)
+    block_size = 8
+    channels = [film.prepare([]) for film in films][0]
+    for y in range(0, 37, block_size):
+        for x in range(0, 45, block_size):
+            size = [min(block_size, 45 - x), min(block_size, 37 - y)]
+            samples = rng.uniform(size=(32, 2)) * size + [x, y]
+            values = rng.uniform(size=(32, channels))
+            values[:, -1] = 1.0
+
+            for film in films:
+                block = film.create_block(size, False, True)
+                block.set_offset([x, y])
+                for p, v in zip(samples, values):
+                    block.put(p, v)
+                film.put_block(block)
+
+    paths = [str(tmpdir.join(name)) for name in ['ref.exr', 'stream.exr']]
+    for film, path in zip(films, paths):
+        film.write(path)
+
+    ref = np.array(mi.Bitmap(paths[0]))
+    out = np.array(mi.Bitmap(paths[1]))
+    assert ref.shape == out.shape
+    assert np.allclose(ref, out, atol=1e-5)
+
+    with pytest.raises(RuntimeError):
+        films[1].develop()
+
+
+def test03_out_of_order(variant_scalar_rgb):
+    film = mi.load_dict({'type': 'streamfilm', 'width': 16, 'height': 16,
+                         'band_height': 1, 'filter': {'type': 'box'}})
+    film.prepare([])
+
+    # Completing the upper half flushes its rows, which can't be revisited
+    block = film.create_block([16, 8], False, True)
+    film.put_block(block)
+    with pytest.raises(RuntimeError, match='scanline order'):
+        film.put_block(block)
+
+
+def test04_render(variant_scalar_rgb, tmpdir):
+    import numpy as np
+
+    def scene(film_type):
+        return mi.load_dict({
+            'type': 'scene',
+            'integrator': {'type': 'path', 'block_size': 8},
+            'sensor': {
+                'type': 'perspective',
+                'to_world': mi.ScalarTransform4f.look_at(origin=[0, 0, 4],
+                                                         target=[0, 0, 0],
+                                                         up=[0, 1, 0]),
+                'film': {'type': film_type, 'width': 40, 'height': 30,
+                         'component_format': 'float32'},
+                'sampler': {'type': 'independent', 'sample_count': 4}
+            },
+            'sphere': {'type': 'sphere'},
+            'light': {'type': 'constant'}
+        })
+
+    images = []
+    for film_type in ['hdrfilm', 'streamfilm']:
+        s = scene(film_type)
+        s.integrator().render(s, s.sensors()[0], seed=0, develop=False)
+        path = str(tmpdir.join(film_type + '.exr'))
+        s.sensors()[0].film().write(path)
+        images.append(np.array(mi.Bitmap(path)))
+
+    assert np.allclose(images[0], images[1], atol=1e-4)
@@ -1,6 +1,7 @@
 #include <mitsuba/render/bsdf.h>
 #include <mitsuba/render/integrator.h>
 #include <mitsuba/render/records.h>
+#include <chrono>
 
 NAMESPACE_BEGIN(mitsuba)
 
@@ -21,7 +22,10 @@ Arbitrary Output Variables integrator (:monosp:`aov`)
  * - (Nested plugin)
    - :paramtype:`integrator`
    - Sub-integrators (can have more than one) which will be sampled along the AOV integrator. Their
-     respective output will be put into distinct images.
+     respective output will be put into distinct images. The primary ray intersection computed by
+     the AOV integrator is shared with them, so that integrators like :ref:`path <integrator-path>`
+     do not need to trace the camera ray a second time (except within recorded loops in JIT
+     variants).
 
 
 This integrator returns one or more AOVs (Arbitrary Output Variables) describing the visible
@@ -73,6 +77,7 @@ Currently, the following AOVs types are available:
     - :monosp:`prim_index`: Primitive index (e.g. triangle index in the mesh).
     - :monosp:`shape_index`: Shape index.
     - :monosp:`boundary_test`: Boundary test.
+    - :monosp:`cost`: Work performed by the nested integrators (see below).
 
 Note that integer-valued AOVs (e.g. :monosp:`prim_index`, :monosp:`shape_index`)
 are meaningless whenever there is only partial pixel coverage or when using a
@@ -81,13 +86,24 @@ wide pixel reconstruction filter as it will result in fractional values.
 The :monosp:`albedo` AOV will evaluate the diffuse reflectance
 (\ref BSDF::eval_diffuse_reflectance) of the material. Note that depending on
 the material, this value might only be an approximation.
+
+The :monosp:`cost` AOV shows where the render time goes in the image, e.g. to
+find the objects (hair, volumes, glass) that are worth simplifying. It stores
+the average number of path vertices (:monosp:`<name>.V`), shadow rays
+(:monosp:`<name>.S`), and null-collision steps in participating media
+(:monosp:`<name>.N`) per sample, summed over the nested integrators that
+implement these counters (currently :ref:`path <integrator-path>` and
+:ref:`volpath <integrator-volpath>`). In scalar variants, the wall-clock time
+spent per sample (in microseconds) is additionally stored in
+:monosp:`<name>.T`. Note that the measured time includes the overhead of the
+AOV integrator itself.
  */
 
 template <typename Float, typename Spectrum>
 class AOVIntegrator final : public SamplingIntegrator<Float, Spectrum> {
 public:
     MI_IMPORT_BASE(SamplingIntegrator)
-    MI_IMPORT_TYPES(Scene, Sampler, Medium, BSDFPtr)
+    MI_IMPORT_TYPES(Scene, Sampler, Medium, BSDF, BSDFPtr)
 
     enum class Type {
         Albedo,
@@ -103,12 +119,15 @@ public:
         dUVdy,
         PrimIndex,
         ShapeIndex,
+        Cost,
         IntegratorRGBA
     };
 
     AOVIntegrator(const Properties &props) : Base(props) {
         std::vector<std::string> tokens = string::tokenize(props.string("aovs"));
 
+        m_cost_channels = 0;
+
         for (const std::string &token: tokens) {
             std::vector<std::string> item = string::tokenize(token, ":");
 
@@ -169,6 +188,18 @@ public:
             } else if (item[1] == "shape_index") {
                 m_aov_types.push_back(Type::ShapeIndex);
                 m_aov_names.push_back(item[0] + ".I");
+            } else if (item[1] == "cost") {
+                if (m_cost_channels > 0)
+                    Throw("Only a single cost AOV can be specified!");
+                m_aov_types.push_back(Type::Cost);
+                m_aov_names.push_back(item[0] + ".V");
+                m_aov_names.push_back(item[0] + ".S");
+                m_aov_names.push_back(item[0] + ".N");
+                m_cost_channels = 3;
+                if constexpr (!dr::is_jit_v<Float>) {
+                    m_aov_names.push_back(item[0] + ".T");
+                    m_cost_channels++;
+                }
             } else {
                 Throw("Invalid AOV type \"%s\"!", item[1]);
             }
@@ -179,10 +210,19 @@ public:
             if (!integrator)
                 Throw("Child objects must be of type 'SamplingIntegrator'!");
             m_aov_types.push_back(Type::IntegratorRGBA);
+
+            /* The cost counters of the nested integrator follow its other
+               AOVs, and are accumulated into the cost AOV */
+            bool cost = m_cost_channels > 0 && integrator->has_cost_counters();
+            if (cost)
+                integrator->set_cost_aovs(true);
+
             std::vector<std::string> aovs = integrator->aov_names();
-            for (auto name: aovs)
-                m_aov_names.push_back(kv.first + "." + name);
-            m_integrators.push_back({ integrator, aovs.size() });
+            size_t aov_count = aovs.size() - (cost ? 3 : 0);
+            for (size_t i = 0; i < aov_count; ++i)
+                m_aov_names.push_back(kv.first + "." + aovs[i]);
+            m_integrators.push_back({ integrator, aov_count });
+            m_integrator_cost.push_back(cost);
             m_aov_names.push_back(kv.first + ".R");
             m_aov_names.push_back(kv.first + ".G");
             m_aov_names.push_back(kv.first + ".B");
@@ -191,6 +231,40 @@ public:
 
         if (m_aov_names.empty())
             Log(Warn, "No AOVs were specified!");
+
+        /* Only compute the fields of the surface interaction that are needed
+           by the AOVs. E.g. depth and position outputs don't require the
+           construction of a shading frame. */
+        m_ray_flags = +RayFlags::Minimal;
+        for (Type type : m_aov_types) {
+            switch (type) {
+                case Type::UV:
+                    m_ray_flags = m_ray_flags | RayFlags::UV;
+                    break;
+
+                case Type::dPdU:
+                case Type::dPdV:
+                    m_ray_flags = m_ray_flags | RayFlags::dPdUV;
+                    break;
+
+                case Type::dUVdx:
+                case Type::dUVdy:
+                    m_ray_flags = m_ray_flags | RayFlags::Geometric;
+                    break;
+
+                case Type::ShadingNormal:
+                    m_ray_flags = m_ray_flags | RayFlags::ShadingFrame;
+                    break;
+
+                case Type::Albedo:
+                case Type::IntegratorRGBA:
+                    m_ray_flags = m_ray_flags | RayFlags::All;
+                    break;
+
+                default:
+                    break;
+            }
+        }
     }
 
     std::pair<Spectrum, Mask> sample(const Scene *scene,
@@ -201,11 +275,77 @@ public:
                                      Mask active) const override {
         MI_MASKED_FUNCTION(ProfilerPhase::SamplingIntegratorSample, active);
 
+        auto start = std::chrono::steady_clock::now();
+
         std::pair<Spectrum, Mask> result { 0.f, false };
 
         SurfaceInteraction3f si = scene->ray_intersect(
-            ray, RayFlags::All | RayFlags::BoundaryTest, true, active);
-        Mask valid_ray = active && si.is_valid();
+            ray, m_ray_flags | RayFlags::BoundaryTest, true, active);
+
+        auto spectrum_to_color3f = [](const Spectrum& spec, const Ray3f& ray, Mask active) {
+            DRJIT_MARK_USED(active);
+            UnpolarizedSpectrum spec_u = unpolarized_spectrum(spec);
+            if constexpr (is_monochromatic_v<Spectrum>)
+                return spec_u.x();
+            else if constexpr (is_rgb_v<Spectrum>)
+                return spec_u;
+            else {
+                static_assert(is_spectral_v<Spectrum>);
+                /// Note: this assumes that sensor used sample_rgb_spectrum() to generate 'ray.wavelengths'
+                auto pdf = pdf_rgb_spectrum(ray.wavelengths);
+                spec_u *= dr::select(dr::neq(pdf, 0.f), dr::rcp(pdf), 0.f);
+                return spectrum_to_srgb(spec_u, ray.wavelengths, active);
+            }
+        };
+
+        /* Nested integrators reuse the primary intersection instead of
+           tracing the camera ray once more (see sample_from_primary()) */
+        const SurfaceInteraction3f si_primary = si;
+        const Mask active_primary = active;
+        size_t ctr = 0;
+
+        // Output of the cost AOV, which is written once all nested integrators ran
+        Float *cost_aovs = nullptr;
+        Float cost[3] = { 0.f, 0.f, 0.f };
+
+        auto sample_nested = [&]() {
+            const auto &[integrator, aov_count] = m_integrators[ctr];
+            auto [spec, valid] = integrator->sample_from_primary(
+                scene, sampler, ray, si_primary, medium, aovs, active_primary);
+            aovs += aov_count;
+
+            /* The counters were written to the entries of the RGBA values,
+               which are overwritten below */
+            if (m_integrator_cost[ctr]) {
+                for (size_t i = 0; i < 3; ++i)
+                    cost[i] += aovs[i];
+            }
+
+            Color3f rgb = spectrum_to_color3f(spec, ray, active_primary);
+            *aovs++ = rgb.r();
+            *aovs++ = rgb.g();
+            *aovs++ = rgb.b();
+            *aovs++ = dr::select(valid, Float(1.f), Float(0.f));
+
+            // The first nested integrator provides the main image
+            if (ctr++ == 0)
+                result = { spec, valid };
+        };
+
+        auto put_cost = [&]() {
+            if (!cost_aovs)
+                return;
+            for (size_t i = 0; i < 3; ++i)
+                cost_aovs[i] = cost[i];
+            if constexpr (!dr::is_jit_v<Float>) {
+                std::chrono::duration<float, std::micro> elapsed =
+                    std::chrono::steady_clock::now() - start;
+                cost_aovs[3] = elapsed.count();
+            } else {
+                DRJIT_MARK_USED(start);
+            }
+        };
+
         active &= si.is_valid();
         if (dr::none_or<false>(active))
         {
@@ -278,41 +418,36 @@ public:
                         *aovs++ = 0;
                         break;
 
-                    case Type::IntegratorRGBA: {
-                        *aovs++ = 0; *aovs++ = 0; *aovs++ = 0;
-                        *aovs++ = 0;
-                        }
+                    case Type::Cost:
+                        cost_aovs = aovs;
+                        aovs += m_cost_channels;
+                        break;
+
+                    case Type::IntegratorRGBA:
+                        sample_nested();
                         break;
                 }
             }
+            put_cost();
             return result;
         }
             
   
         dr::masked(si, !si.is_valid()) = dr::zeros<SurfaceInteraction3f>();
-        size_t ctr = 0;
 
         BSDFContext ctx;
         BSDFPtr bsdf = si.bsdf(ray);
         
 
-        auto spectrum_to_color3f = [](const Spectrum& spec, const Ray3f& ray, Mask active) {
-            DRJIT_MARK_USED(active);
-            UnpolarizedSpectrum spec_u = unpolarized_spectrum(spec);
-            if constexpr (is_monochromatic_v<Spectrum>)
-                return spec_u.x();
-            else if constexpr (is_rgb_v<Spectrum>)
-                return spec_u;
-            else {
-                static_assert(is_spectral_v<Spectrum>);
-                /// Note: this assumes that sensor used sample_rgb_spectrum() to generate 'ray.wavelengths'
-                auto pdf = pdf_rgb_spectrum(ray.wavelengths);
-                spec_u *= dr::select(dr::neq(pdf, 0.f), dr::rcp(pdf), 0.f);
-                return spectrum_to_srgb(spec_u, ray.wavelengths, active);
-            }
-        };
-
         Mask isGlass = active && has_flag(bsdf->flags(), BSDFFlags::Transmission);
+
+        /* Refracting through dielectrics requires a shading frame, which the
+           AOVs might not have requested */
+        if (!has_flag(m_ray_flags, RayFlags::ShadingFrame) &&
+            dr::any_or<true>(isGlass) && has_transmission(scene))
+            dr::masked(si, isGlass) = scene->ray_intersect(
+                ray, +RayFlags::All, /* coherent = */ true, isGlass);
+
         Ray3f next_ray(ray);
         int i = 0;
         while (true)
@@ -361,6 +496,15 @@ public:
                             case Type::ShapeIndex:
                                 *aovs++ = 0;
                                 break;
+
+                            case Type::Cost:
+                                cost_aovs = aovs;
+                                aovs += m_cost_channels;
+                                break;
+
+                            case Type::IntegratorRGBA:
+                                sample_nested();
+                                break;
                         }
                     }
                     break;
@@ -397,6 +541,15 @@ public:
                         case Type::ShapeIndex:
                             *aovs++ = Float(si.shape->obj_num_id());
                             break;
+
+                        case Type::Cost:
+                            cost_aovs = aovs;
+                            aovs += m_cost_channels;
+                            break;
+
+                        case Type::IntegratorRGBA:
+                            sample_nested();
+                            break;
                     }
                 }
                 break;
@@ -405,6 +558,7 @@ public:
         }
         
         
+        put_cost();
 
         return result;
     }
@@ -438,9 +592,25 @@ public:
 
     MI_DECLARE_CLASS()
 private:
+    /// Does the scene contain any transmissive BSDF?
+    static bool has_transmission(const Scene *scene) {
+        for (const auto &shape : scene->shapes()) {
+            const BSDF *bsdf = shape->bsdf();
+            if (bsdf && has_flag(bsdf->flags(), BSDFFlags::Transmission))
+                return true;
+        }
+        return false;
+    }
+
     std::vector<Type> m_aov_types;
     std::vector<std::string> m_aov_names;
     std::vector<std::pair<ref<Base>, size_t>> m_integrators;
+    /// Do the nested integrators report cost counters?
+    std::vector<bool> m_integrator_cost;
+    /// Number of channels of the cost AOV (0 if disabled)
+    size_t m_cost_channels;
+    /// Fields of the surface interaction that are needed by the AOVs
+    uint32_t m_ray_flags;
 };
 
 MI_IMPLEMENT_CLASS_VARIANT(AOVIntegrator, SamplingIntegrator)
@@ -0,0 +1,673 @@
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/ray.h>
+#include <mitsuba/core/warp.h>
+#include <mitsuba/render/integrator.h>
+#include <mitsuba/render/bsdf.h>
+#include <mitsuba/render/emitter.h>
+#include <mitsuba/render/records.h>
+#include <mitsuba/render/sampler.h>
+#include <mitsuba/render/sensor.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**!
+
+.. _integrator-bdpt:
+
+Bidirectional path tracer (:monosp:`bdpt`)
+------------------------------------------
+
+.. pluginparameters::
+
+ * - max_depth
+   - |int|
+   - Specifies the longest path depth in the generated output image (where -1 corresponds to
+     :math:`\infty`). A value of 1 will only render directly visible light sources. 2 will lead
+     to single-bounce (direct-only) illumination, and so on. (Default: -1)
+
+ * - rr_depth
+   - |int|
+   - Specifies the minimum path depth, after which the implementation will start to use the
+     *russian roulette* path termination criterion. (Default: 5)
+
+ * - hide_emitters
+   - |bool|
+   - Hide directly visible emitters. (Default: no, i.e. |false|)
+
+ * - samples_per_pass
+   - |int|
+   - If specified, divides the workload in successive passes with :paramtype:`samples_per_pass`
+     samples per pixel.
+
+This integrator implements bidirectional path tracing [Veach and Guibas 1995]. Each sample
+traces a subpath starting from a light source and another one starting from the sensor, and
+considers all ways of joining them: the sensor subpath can hit an emitter, be connected to a
+point sampled on an emitter, or be connected to any vertex of the light subpath, while every
+vertex of the light subpath is additionally connected to the sensor (as done by the
+:ref:`particle tracer <integrator-ptracer>`). The contributions of these strategies are
+combined using multiple importance sampling (power heuristic), whose weights are evaluated
+incrementally along both subpaths following the formulation of [Georgiev et al. 2012].
+
+Compared to the :ref:`path tracer <integrator-path>`, this technique is considerably more
+robust in scenes where the emitters are hard to reach from the sensor, e.g. a room lit
+indirectly through a small gap or by a light source enclosed in a fixture. Caustics that are
+seen directly or through diffuse surfaces are also handled well. Paths that are specular on
+both sides of the diffuse vertex where the subpaths could be joined (e.g. reflected caustics
+from a point light seen through glass) still cannot be sampled; the :ref:`photon mapper
+<integrator-sppm>` can be used in such cases.
+
+Contributions of light subpaths are splatted onto the film at the position where they are
+seen by the sensor, which requires a sensor with a pinhole projection (such as the
+:ref:`perspective <sensor-perspective>` camera). The alpha channel is estimated from the
+sensor subpaths only.
+
+.. note:: This integrator is only available in scalar variants (``scalar_rgb``,
+   ``scalar_mono``, ...). It does not support media (volumes), spectral and polarized
+   variants, and arbitrary output variables (AOVs).
+
+.. tabs::
+    .. code-tab::  xml
+
+        <integrator type="bdpt">
+            <integer name="max_depth" value="8"/>
+        </integrator>
+
+    .. code-tab:: python
+
+        'type': 'bdpt',
+        'max_depth': 8
+
+ */
+
+template <typename Float, typename Spectrum>
+class BidirectionalPathIntegrator final : public AdjointIntegrator<Float, Spectrum> {
+public:
+    MI_IMPORT_BASE(AdjointIntegrator, m_hide_emitters, m_rr_depth, m_max_depth)
+    MI_IMPORT_TYPES(Scene, Sensor, Film, Sampler, ImageBlock, Emitter,
+                    EmitterPtr, BSDF, BSDFPtr)
+
+    /// Upper bound on the number of stored light subpath vertices
+    static constexpr uint32_t MaxVertices = 64;
+
+    /**
+     * \brief Vertex of a light subpath
+     *
+     * The partial MIS quantities \c d_vcm and \c d_vc follow the naming of
+     * [Georgiev et al. 2012]. \c throughput excludes the BSDF at the vertex.
+     */
+    struct LightVertex {
+        SurfaceInteraction3f si;
+        BSDFPtr bsdf;
+        Spectrum throughput;
+        Float d_vcm, d_vc;
+        uint32_t length;
+    };
+
+    BidirectionalPathIntegrator(const Properties &props) : Base(props) {
+        if constexpr (dr::is_jit_v<Float>)
+            Throw("The bidirectional path tracer is only supported in scalar "
+                  "variants.");
+        if constexpr (is_spectral_v<Spectrum> || is_polarized_v<Spectrum>)
+            Throw("The bidirectional path tracer is not supported in spectral "
+                  "and polarized variants.");
+    }
+
+    void sample(const Scene *scene, const Sensor *sensor, Sampler *sampler,
+                ImageBlock *block, ScalarFloat sample_scale) const override {
+        if constexpr (dr::is_jit_v<Float> || is_spectral_v<Spectrum> ||
+                      is_polarized_v<Spectrum>) {
+            DRJIT_MARK_USED(scene);
+            DRJIT_MARK_USED(sensor);
+            DRJIT_MARK_USED(sampler);
+            DRJIT_MARK_USED(block);
+            DRJIT_MARK_USED(sample_scale);
+            NotImplementedError("sample");
+        } else {
+            if (unlikely(m_max_depth == 0))
+                return;
+
+            Float time = sensor->shutter_open();
+            if (sensor->shutter_open_time() > 0.f)
+                time += sampler->next_1d() * sensor->shutter_open_time();
+
+            // 1. Light subpath, connected to the sensor at every vertex
+            LightVertex vertices[MaxVertices];
+            uint32_t vertex_count = trace_light_path(
+                scene, sensor, sampler, block, sample_scale, time, vertices);
+
+            // 2. Sensor subpath, connected to the emitters and light vertices
+            ScalarVector2f crop_size(sensor->film()->crop_size());
+            Point2f position_sample = sampler->next_2d();
+
+            Point2f aperture_sample(.5f);
+            if (sensor->needs_aperture_sample())
+                aperture_sample = sampler->next_2d();
+
+            auto [ray, ray_weight] = sensor->sample_ray(
+                time, sampler->next_1d(), position_sample, aperture_sample);
+
+            auto [result, alpha] = trace_camera_path(
+                scene, sensor, sampler, ray, ray_weight, vertices, vertex_count);
+
+            /* The sensor subpaths cover the crop window uniformly, hence they
+               can be splatted like the light subpaths (the weight channel is
+               not used) */
+            block->put(position_sample * crop_size + block->offset(),
+                       ray.wavelengths, result * sample_scale,
+                       alpha * sample_scale, /* weight = */ 0.f);
+        }
+    }
+
+    /**
+     * \brief Trace a subpath from a randomly chosen emitter
+     *
+     * Every vertex with a non-delta BSDF is connected to the sensor and
+     * recorded in \c vertices.
+     *
+     * \return The number of recorded vertices
+     */
+    uint32_t trace_light_path(const Scene *scene, const Sensor *sensor,
+                              Sampler *sampler, ImageBlock *block,
+                              ScalarFloat sample_scale, Float time,
+                              LightVertex *vertices) const {
+        // ------------------------ Emitter sampling -------------------------
+
+        auto [index, pick_weight, wavelength_sample] =
+            scene->sample_emitter(sampler->next_1d());
+        const Emitter *emitter = scene->emitters()[index].get();
+
+        Point2f position_sample  = sampler->next_2d(),
+                direction_sample = sampler->next_2d();
+
+        Ray3f ray;
+        Spectrum throughput;
+        Point3f p0;
+        Normal3f n0(0.f);
+        Point2f uv0(0.f);
+        Float cos0 = 1.f;
+
+        uint32_t flags = emitter->flags();
+        if (has_flag(flags, EmitterFlags::Surface) &&
+            !has_flag(flags, EmitterFlags::DeltaDirection)) {
+            /* Equivalent to AreaEmitter::sample_ray(), but the sampled
+               position and normal are needed for the MIS weights */
+            auto [ps, pos_weight] =
+                emitter->sample_position(time, position_sample);
+            Vector3f local = warp::square_to_cosine_hemisphere(direction_sample);
+
+            SurfaceInteraction3f si(ps, dr::zeros<Wavelength>());
+            auto [wavelengths, wav_weight] =
+                emitter->sample_wavelengths(si, wavelength_sample);
+            si.wavelengths = wavelengths;
+
+            ray = si.spawn_ray(si.to_world(local));
+            throughput = pos_weight * wav_weight * dr::Pi<ScalarFloat>;
+            p0 = ps.p;
+            n0 = ps.n;
+            uv0 = ps.uv;
+            cos0 = Frame3f::cos_theta(local);
+        } else {
+            std::tie(ray, throughput) = emitter->sample_ray(
+                time, wavelength_sample, position_sample, direction_sample);
+            p0 = ray.o;
+        }
+        throughput *= pick_weight;
+
+        bool delta = has_flag(flags, EmitterFlags::Delta),
+             finite = is_finite(emitter);
+
+        Float emission = emission_pdf(scene, emitter, n0, ray.d);
+        if (!(emission > 0.f) || dr::all(dr::eq(throughput, 0.f)))
+            return 0;
+
+        SurfaceInteraction3f si = scene->ray_intersect(ray);
+        if (!si.is_valid())
+            return 0;
+
+        // -------------------- MIS quantities of the first vertex ------------
+
+        DirectionSample3f ds(p0, n0, uv0, time, 0.f, delta, -ray.d,
+                             finite ? si.t : dr::Infinity<Float>, emitter);
+
+        Float d_vcm = mis(direct_pdf(scene, si, ds) * cos_light(ds) / emission),
+              d_vc  = delta ? 0.f : mis((finite ? cos0 : 1.f) / emission),
+              cos_in = mis(dr::abs(Frame3f::cos_theta(si.wi)));
+
+        d_vcm /= cos_in;
+        d_vc  /= cos_in;
+
+        // -------------------------- Path construction -----------------------
+
+        BSDFContext ctx(TransportMode::Importance);
+        uint32_t length = 1, vertex_count = 0;
+        Float eta = 1.f;
+
+        while (true) {
+            BSDFPtr bsdf = si.bsdf(ray);
+
+            if (has_flag(bsdf->flags(), BSDFFlags::Smooth)) {
+                LightVertex &v = vertices[vertex_count++];
+                v.si         = si;
+                v.bsdf       = bsdf;
+                v.throughput = throughput;
+                v.d_vcm      = d_vcm;
+                v.d_vc       = d_vc;
+                v.length     = length;
+
+                if (within_depth(length + 1))
+                    connect_sensor(scene, sensor, sampler, v, block,
+                                   sample_scale);
+
+                if (vertex_count == MaxVertices)
+                    break;
+            }
+
+            // Any use of the next vertex requires at least one more segment
+            if (!within_depth(length + 2))
+                break;
+
+            auto [bs, bsdf_val] = bsdf->sample(ctx, si, sampler->next_1d(),
+                                               sampler->next_2d());
+            Vector3f wo = si.to_world(bs.wo);
+
+            // Using geometric normals (wo points to the camera)
+            Float wi_dot_geo_n = dr::dot(si.n, -ray.d),
+                  wo_dot_geo_n = dr::dot(si.n, wo);
+
+            // Prevent light leaks due to shading normals
+            if (wi_dot_geo_n * Frame3f::cos_theta(si.wi) <= 0.f ||
+                wo_dot_geo_n * Frame3f::cos_theta(bs.wo) <= 0.f)
+                break;
+
+            // Adjoint BSDF for shading normals -- [Veach, p. 155]
+            Float correction = dr::abs((Frame3f::cos_theta(si.wi) * wo_dot_geo_n) /
+                                       (Frame3f::cos_theta(bs.wo) * wi_dot_geo_n));
+            throughput *= bsdf_val * correction;
+            eta *= bs.eta;
+
+            update_mis(si, bsdf, bs, TransportMode::Radiance, d_vcm, d_vc);
+
+            // Russian roulette
+            if ((int) length >= m_rr_depth) {
+                Float q = dr::minimum(
+                    dr::max(unpolarized_spectrum(throughput)) * dr::sqr(eta), .95f);
+                if (sampler->next_1d() >= q)
+                    break;
+                throughput *= dr::rcp(q);
+            }
+
+            if (dr::all(dr::eq(throughput, 0.f)))
+                break;
+
+            ray = si.spawn_ray(wo);
+            si = scene->ray_intersect(ray);
+            if (!si.is_valid())
+                break;
+
+            cos_in = mis(dr::abs(Frame3f::cos_theta(si.wi)));
+            d_vcm *= mis(dr::sqr(si.t)) / cos_in;
+            d_vc  /= cos_in;
+            length++;
+        }
+
+        return vertex_count;
+    }
+
+    /**
+     * \brief Trace a subpath from the sensor along \c ray and accumulate the
+     * contributions of all strategies that complete it
+     *
+     * \return The MIS-weighted radiance and alpha value
+     */
+    std::pair<Spectrum, Float>
+    trace_camera_path(const Scene *scene, const Sensor *sensor,
+                      Sampler *sampler, Ray3f ray, Spectrum throughput,
+                      const LightVertex *vertices,
+                      uint32_t vertex_count) const {
+        SurfaceInteraction3f si = scene->ray_intersect(ray);
+        Interaction3f prev_si = dr::zeros<Interaction3f>();
+        Spectrum result(0.f);
+        Float alpha = si.is_valid() ? 1.f : 0.f;
+
+        Float d_vcm = 0.f, d_vc = 0.f, eta = 1.f;
+        if (si.is_valid()) {
+            // Density of the first vertex w.r.t. area (same as in connect_sensor())
+            auto [sensor_ds, sensor_weight] =
+                sensor->sample_direction(si, Point2f(.5f));
+            Float pdf = dr::max(unpolarized_spectrum(sensor_weight)) *
+                        dr::abs(Frame3f::cos_theta(si.wi));
+            d_vcm = pdf > 0.f ? mis(dr::rcp(pdf)) : 0.f;
+        }
+
+        BSDFContext ctx;
+        uint32_t length = 1;
+
+        while (true) {
+            // ------------------------- Emitter hit --------------------------
+
+            EmitterPtr emitter = si.emitter(scene);
+            if (emitter && within_depth(length) &&
+                !(length == 1 && m_hide_emitters)) {
+                DirectionSample3f ds(scene, si, prev_si);
+                Spectrum radiance = emitter->eval(si);
+
+                if (length > 1 && dr::any(dr::neq(radiance, 0.f))) {
+                    Float pdf_direct = direct_pdf(scene, prev_si, ds) * cos_light(ds);
+                    if (is_finite(emitter))
+                        pdf_direct /= dr::sqr(ds.dist);
+
+                    Float w_camera =
+                        mis(pdf_direct) * d_vcm +
+                        mis(emission_pdf(scene, emitter, ds.n, -ds.d)) * d_vc;
+                    radiance /= 1.f + w_camera;
+                }
+
+                result += throughput * radiance;
+            }
+
+            if (!si.is_valid() || !within_depth(length + 1))
+                break;
+
+            BSDFPtr bsdf = si.bsdf(ray);
+
+            if (has_flag(bsdf->flags(), BSDFFlags::Smooth)) {
+                // ----------------------- Emitter sampling -------------------
+
+                result += throughput *
+                          connect_emitter(scene, sampler, si, bsdf, d_vcm, d_vc);
+
+                // -------------- Connections to the light subpath ------------
+
+                for (uint32_t i = 0; i < vertex_count; ++i) {
+                    if (!within_depth(vertices[i].length + length + 1))
+                        break;
+                    result += throughput * connect_vertices(scene, si, bsdf, d_vcm,
+                                                            d_vc, vertices[i]);
+                }
+            }
+
+            // ------------------------- BSDF sampling ------------------------
+
+            auto [bs, bsdf_weight] = bsdf->sample(ctx, si, sampler->next_1d(),
+                                                  sampler->next_2d());
+            throughput *= bsdf_weight;
+            eta *= bs.eta;
+
+            if (dr::all(dr::eq(throughput, 0.f)))
+                break;
+
+            update_mis(si, bsdf, bs, TransportMode::Importance, d_vcm, d_vc);
+
+            // Russian roulette
+            if ((int) length >= m_rr_depth) {
+                Float q = dr::minimum(
+                    dr::max(unpolarized_spectrum(throughput)) * dr::sqr(eta), .95f);
+                if (sampler->next_1d() >= q)
+                    break;
+                throughput *= dr::rcp(q);
+            }
+
+            prev_si = si;
+            ray = si.spawn_ray(si.to_world(bs.wo));
+            si = scene->ray_intersect(ray);
+
+            if (si.is_valid()) {
+                Float cos_in = mis(dr::abs(Frame3f::cos_theta(si.wi)));
+                d_vcm *= mis(dr::sqr(si.t)) / cos_in;
+                d_vc  /= cos_in;
+            }
+            length++;
+        }
+
+        return { result, alpha };
+    }
+
+    /// Connect a light subpath vertex to the sensor and splat the contribution
+    void connect_sensor(const Scene *scene, const Sensor *sensor,
+                        Sampler *sampler, const LightVertex &v,
+                        ImageBlock *block, ScalarFloat sample_scale) const {
+        const SurfaceInteraction3f &si = v.si;
+        auto [sensor_ds, sensor_weight] =
+            sensor->sample_direction(si, sampler->next_2d());
+        if (!(sensor_ds.pdf > 0.f))
+            return;
+
+        Vector3f wo = si.to_local(sensor_ds.d);
+
+        // Using geometric normals
+        Float wi_dot_geo_n = dr::dot(si.n, si.to_world(si.wi)),
+              wo_dot_geo_n = dr::dot(si.n, sensor_ds.d);
+
+        // Prevent light leaks due to shading normals
+        if (wi_dot_geo_n * Frame3f::cos_theta(si.wi) <= 0.f ||
+            wo_dot_geo_n * Frame3f::cos_theta(wo) <= 0.f)
+            return;
+
+        // Adjoint BSDF for shading normals -- [Veach, p. 155]
+        Float correction = dr::abs((Frame3f::cos_theta(si.wi) * wo_dot_geo_n) /
+                                   (Frame3f::cos_theta(wo) * wi_dot_geo_n));
+
+        BSDFContext ctx(TransportMode::Importance);
+        Spectrum value = v.throughput * sensor_weight * correction *
+                         v.bsdf->eval(ctx, si, wo);
+        if (dr::all(dr::eq(value, 0.f)))
+            return;
+
+        // Density of the sensor subpath generating this vertex
+        Float pdf_camera = dr::max(unpolarized_spectrum(sensor_weight)) *
+                           dr::abs(Frame3f::cos_theta(wo));
+        Float w_light =
+            mis(pdf_camera) *
+            (v.d_vcm + v.d_vc * mis(pdf_reverse(si, v.bsdf, wo,
+                                                TransportMode::Radiance)));
+
+        if (scene->ray_test(si.spawn_ray_to(sensor_ds.p)))
+            return;
+
+        block->put(sensor_ds.uv + block->offset(), si.wavelengths,
+                   value * (sample_scale / (1.f + w_light)), /* alpha = */ 0.f,
+                   /* weight = */ 0.f);
+    }
+
+    /// Connect a sensor subpath vertex to a point sampled on an emitter
+    Spectrum connect_emitter(const Scene *scene, Sampler *sampler,
+                             const SurfaceInteraction3f &si, const BSDFPtr &bsdf,
+                             Float d_vcm, Float d_vc) const {
+        auto [ds, emitter_weight] = scene->sample_emitter_direction(
+            si, sampler->next_2d(), true);
+        if (!(ds.pdf > 0.f) || dr::all(dr::eq(emitter_weight, 0.f)))
+            return 0.f;
+
+        BSDFContext ctx;
+        Vector3f wo = si.to_local(ds.d);
+        Spectrum bsdf_val = bsdf->eval(ctx, si, wo);
+        if (dr::all(dr::eq(bsdf_val, 0.f)))
+            return 0.f;
+
+        Float pdf_direct = direct_pdf(scene, si, ds),
+              pdf_bsdf   = bsdf->pdf(ctx, si, wo),
+              emission   = emission_pdf(scene, ds.emitter, ds.n, -ds.d);
+
+        Float w_light =
+            has_flag(ds.emitter->flags(), EmitterFlags::Delta)
+                ? 0.f : mis(pdf_bsdf / pdf_direct);
+        Float w_camera =
+            mis(emission * dr::abs(Frame3f::cos_theta(wo)) /
+                (pdf_direct * cos_light(ds))) *
+            (d_vcm + d_vc * mis(pdf_reverse(si, bsdf, wo,
+                                            TransportMode::Importance)));
+
+        return emitter_weight * bsdf_val / (w_light + 1.f + w_camera);
+    }
+
+    /// Connect a sensor subpath vertex to a light subpath vertex
+    Spectrum connect_vertices(const Scene *scene, const SurfaceInteraction3f &si,
+                              const BSDFPtr &bsdf, Float d_vcm, Float d_vc,
+                              const LightVertex &v) const {
+        Vector3f d = v.si.p - si.p;
+        Float dist2 = dr::squared_norm(d);
+        d /= dr::sqrt(dist2);
+
+        Vector3f wo_camera = si.to_local(d),
+                 wo_light  = v.si.to_local(-d);
+
+        // Using geometric normals (shading normal correction on the light side)
+        Float wi_dot_geo_n = dr::dot(v.si.n, v.si.to_world(v.si.wi)),
+              wo_dot_geo_n = dr::dot(v.si.n, -d);
+        if (wi_dot_geo_n * Frame3f::cos_theta(v.si.wi) <= 0.f ||
+            wo_dot_geo_n * Frame3f::cos_theta(wo_light) <= 0.f)
+            return 0.f;
+
+        Float correction = dr::abs((Frame3f::cos_theta(v.si.wi) * wo_dot_geo_n) /
+                                   (Frame3f::cos_theta(wo_light) * wi_dot_geo_n));
+
+        BSDFContext ctx_camera, ctx_light(TransportMode::Importance);
+        Spectrum value = v.throughput *
+                         bsdf->eval(ctx_camera, si, wo_camera) *
+                         v.bsdf->eval(ctx_light, v.si, wo_light) *
+                         (correction / dist2);
+        if (dr::all(dr::eq(value, 0.f)))
+            return 0.f;
+
+        // Densities of sampling each vertex from the other one (w.r.t. area)
+        Float pdf_camera = bsdf->pdf(ctx_camera, si, wo_camera) *
+                           dr::abs(Frame3f::cos_theta(wo_light)) / dist2,
+              pdf_light  = v.bsdf->pdf(ctx_light, v.si, wo_light) *
+                           dr::abs(Frame3f::cos_theta(wo_camera)) / dist2;
+
+        Float w_light =
+            mis(pdf_camera) *
+            (v.d_vcm + v.d_vc * mis(pdf_reverse(v.si, v.bsdf, wo_light,
+                                                TransportMode::Radiance)));
+        Float w_camera =
+            mis(pdf_light) *
+            (d_vcm + d_vc * mis(pdf_reverse(si, bsdf, wo_camera,
+                                            TransportMode::Importance)));
+
+        if (scene->ray_test(si.spawn_ray_to(v.si.p)))
+            return 0.f;
+
+        return value / (w_light + 1.f + w_camera);
+    }
+
+    /**
+     * \brief Update the partial MIS quantities of a subpath after sampling
+     * the BSDF at its last vertex
+     *
+     * \c reverse_mode is the transport mode of the opposite subpath, which is
+     * used to evaluate the density of sampling the incident direction.
+     */
+    void update_mis(const SurfaceInteraction3f &si, const BSDFPtr &bsdf,
+                    const BSDFSample3f &bs, TransportMode reverse_mode,
+                    Float &d_vcm, Float &d_vc) const {
+        Float cos_out = dr::abs(Frame3f::cos_theta(bs.wo));
+
+        if (has_flag(bs.sampled_type, BSDFFlags::Delta)) {
+            // Forward and reverse densities cancel out
+            d_vcm = 0.f;
+            d_vc *= mis(cos_out);
+        } else {
+            Float pdf_rev = pdf_reverse(si, bsdf, bs.wo, reverse_mode);
+            d_vc  = mis(cos_out / bs.pdf) * (d_vc * mis(pdf_rev) + d_vcm);
+            d_vcm = mis(dr::rcp(bs.pdf));
+        }
+    }
+
+    /// Density of sampling \c si.wi at \c si when arriving from \c wo
+    Float pdf_reverse(const SurfaceInteraction3f &si, const BSDFPtr &bsdf,
+                      const Vector3f &wo, TransportMode mode) const {
+        SurfaceInteraction3f si_rev(si);
+        si_rev.wi = wo;
+        BSDFContext ctx(mode);
+        return bsdf->pdf(ctx, si_rev, si.wi);
+    }
+
+    /**
+     * \brief Solid angle density of emitter sampling choosing \c ds from
+     * \c ref, including the emitter selection
+     *
+     * Delta emitters cannot be hit, hence only the ratio of their densities
+     * to those of the other strategies matters. Points are assigned a unit
+     * density w.r.t. area, and directions a unit density w.r.t. solid angle.
+     */
+    Float direct_pdf(const Scene *scene, const Interaction3f &ref,
+                     const DirectionSample3f &ds) const {
+        uint32_t flags = ds.emitter->flags();
+        if (has_flag(flags, EmitterFlags::Delta)) {
+            Float pdf = scene->pdf_emitter(ds.emitter->emitter_index());
+            if (has_flag(flags, EmitterFlags::DeltaPosition))
+                pdf *= dr::sqr(ds.dist);
+            return pdf;
+        }
+        return scene->pdf_emitter_direction(ref, ds);
+    }
+
+    /**
+     * \brief Density of an emitter emitting towards \c d from a point with
+     * normal \c n (w.r.t. area and solid angle), including the emitter
+     * selection
+     *
+     * Infinite emitters emit from a disk covering the scene bounding sphere.
+     * These densities are only used to compute MIS weights, which remain
+     * unbiased as long as they are evaluated consistently.
+     */
+    Float emission_pdf(const Scene *scene, const Emitter *emitter,
+                       const Normal3f &n, const Vector3f &d) const {
+        uint32_t flags = emitter->flags();
+        Float pdf = scene->pdf_emitter(emitter->emitter_index());
+
+        if (has_flag(flags, EmitterFlags::Surface))
+            pdf /= emitter->shape()->surface_area();
+        else if (!has_flag(flags, EmitterFlags::DeltaPosition))
+            pdf /= dr::Pi<ScalarFloat> *
+                   dr::sqr(scene->bbox().bounding_sphere().radius);
+
+        if (has_flag(flags, EmitterFlags::DeltaDirection))
+            return pdf;
+        else if (has_flag(flags, EmitterFlags::Surface))
+            return pdf * dr::maximum(dr::dot(n, d), 0.f) * dr::InvPi<ScalarFloat>;
+        else if (has_flag(flags, EmitterFlags::DeltaPosition))
+            return pdf * dr::InvFourPi<ScalarFloat>;
+
+        DirectionSample3f ds = dr::zeros<DirectionSample3f>();
+        ds.d = -d;
+        ds.emitter = emitter;
+        return pdf * emitter->pdf_direction(dr::zeros<Interaction3f>(), ds);
+    }
+
+    /// Cosine at the emitter end of a connection (1 for non-surface emitters)
+    Float cos_light(const DirectionSample3f &ds) const {
+        if (is_finite(ds.emitter) &&
+            has_flag(ds.emitter->flags(), EmitterFlags::Surface))
+            return dr::abs(dr::dot(ds.n, ds.d));
+        return 1.f;
+    }
+
+    /// Does the emitter have a position (i.e. is it not at infinity)?
+    static bool is_finite(const Emitter *emitter) {
+        return !has_flag(emitter->flags(), EmitterFlags::Infinite) &&
+               !has_flag(emitter->flags(), EmitterFlags::DeltaDirection);
+    }
+
+    /// Does a path of the given length respect the \c max_depth parameter?
+    bool within_depth(uint32_t length) const {
+        return m_max_depth < 0 || length <= (uint32_t) m_max_depth;
+    }
+
+    /// Power heuristic, applied to each factor of the density ratios
+    static Float mis(Float x) { return dr::sqr(x); }
+
+    std::string to_string() const override {
+        return tfm::format("BidirectionalPathIntegrator[\n"
+                           "  max_depth = %i,\n"
+                           "  rr_depth = %i\n"
+                           "]",
+                           m_max_depth, m_rr_depth);
+    }
+
+    MI_DECLARE_CLASS()
+};
+
+MI_IMPLEMENT_CLASS_VARIANT(BidirectionalPathIntegrator, AdjointIntegrator);
+MI_EXPORT_PLUGIN(BidirectionalPathIntegrator, "Bidirectional path tracer integrator");
+NAMESPACE_END(mitsuba)
@@ -47,8 +47,9 @@ public:
                                      Mask active) const override {
         MI_MASKED_FUNCTION(ProfilerPhase::SamplingIntegratorSample, active);
 
+        // Only the distance is needed, skip the shading frame
         SurfaceInteraction3f si = scene->ray_intersect(
-            ray_, RayFlags::All | RayFlags::BoundaryTest, true, active);
+            ray_, RayFlags::Minimal | RayFlags::BoundaryTest, true, active);
         dr::masked(si, !si.is_valid()) = dr::zeros<SurfaceInteraction3f>();
 
         Ray3f ray                     = Ray3f(ray_);
@@ -60,6 +61,9 @@ public:
             Mask isGlass = has_flag(bsdf->flags(), BSDFFlags::Transmission);
             if (dr::any_or<true>(isGlass))
             {
+                 // Sampling the BSDF requires a local frame
+                 si.sh_frame = Frame3f(si.n);
+                 si.wi = si.to_local(-ray_.d);
                  auto [bsdf_sample, color]
                  = bsdf->sample(bsdf_ctx, si, 0, 0, true);
                 Float eta = bsdf_sample.eta;
@@ -0,0 +1,775 @@
+#include <atomic>
+#include <mitsuba/core/ray.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/warp.h>
+#include <mitsuba/render/bsdf.h>
+#include <mitsuba/render/emitter.h>
+#include <mitsuba/render/integrator.h>
+#include <mitsuba/render/records.h>
+#include <mitsuba/render/sampler.h>
+#include <mitsuba/render/sensor.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**!
+
+.. _integrator-guided_path:
+
+Guided path tracer (:monosp:`guided_path`)
+------------------------------------------
+
+.. pluginparameters::
+
+ * - max_depth
+   - |int|
+   - Specifies the longest path depth in the generated output image (where -1
+     corresponds to :math:`\infty`). A value of 1 will only render directly
+     visible light sources. 2 will lead to single-bounce (direct-only)
+     illumination, and so on. (Default: -1)
+
+ * - rr_depth
+   - |int|
+   - Specifies the path depth, at which the implementation will begin to use
+     the *russian roulette* path termination criterion. (Default: 5)
+
+ * - hide_emitters
+   - |bool|
+   - Hide directly visible emitters. (Default: no, i.e. |false|)
+
+ * - training_iterations
+   - |int|
+   - Number of training passes that learn the guiding distribution before the
+     final render. Pass :math:`k` renders :math:`2^k` samples per pixel, which
+     are discarded afterwards. (Default: 5)
+
+ * - bsdf_sampling_fraction
+   - |float|
+   - Probability of sampling the BSDF instead of the guiding distribution at
+     each vertex. (Default: 0.5)
+
+ * - spatial_threshold
+   - |int|
+   - A spatial cell is subdivided once it receives more than
+     :math:`c \sqrt{2^k}` samples during training pass :math:`k`, where
+     :math:`c` is this parameter. (Default: 12000)
+
+ * - directional_threshold
+   - |float|
+   - Quadtree nodes containing more than this fraction of the energy of their
+     directional distribution are subdivided. (Default: 0.01)
+
+This integrator extends the :ref:`path tracer <integrator-path>` with the
+*practical path guiding* technique by Müller et al. ("Practical Path Guiding
+for Efficient Light-Transport Simulation", 2017). It learns an approximation
+of the incident radiance in the scene in a spatio-directional tree (SD-tree):
+a binary tree subdivides space, and each of its leaves stores a quadtree over
+the (cylindrically parameterized) sphere of directions.
+
+The distribution is learned during a number of training passes of
+exponentially increasing sample count. After each pass, the spatial tree is
+refined where enough samples were recorded, and the quadtrees are rebuilt so
+that their resolution follows the recorded energy. The final render then
+combines BSDF sampling and guided sampling using one-sample multiple
+importance sampling, which remains unbiased regardless of the quality of the
+learned distribution.
+
+Path guiding pays off in scenes with difficult indirect illumination, such as
+interiors lit through small openings, while it mainly introduces overhead in
+simple scenes.
+
+.. note:: This integrator is only available in scalar variants and does not
+   handle participating media.
+
+.. tabs::
+    .. code-tab::  xml
+        :name: guided-path-integrator
+
+        <integrator type="guided_path">
+            <integer name="max_depth" value="8"/>
+        </integrator>
+
+    .. code-tab:: python
+
+        'type': 'guided_path',
+        'max_depth': 8
+
+ */
+
+/// Atomically add a value to a floating point variable
+inline void atomic_add(std::atomic<float> &dst, float value) {
+    float current = dst.load(std::memory_order_relaxed);
+    while (!dst.compare_exchange_weak(current, current + value,
+                                      std::memory_order_relaxed))
+        ;
+}
+
+/**
+ * \brief Quadtree over the square [0, 1]^2 storing a directional distribution
+ *
+ * Every node has four children (quadrants), which are either leaves or refer
+ * to another node. Each node stores the recorded energy of its quadrants.
+ * Arbitrary threads may record data concurrently, but the tree structure
+ * must only be changed in between rendering passes.
+ */
+class DTree {
+public:
+    using Point2 = Point<float, 2>;
+
+    struct Node {
+        std::atomic<float> sum[4];
+        uint32_t child[4]; // 0: leaf
+
+        Node() {
+            for (int i = 0; i < 4; ++i) {
+                sum[i].store(0.f, std::memory_order_relaxed);
+                child[i] = 0;
+            }
+        }
+
+        Node(const Node &node) { *this = node; }
+
+        Node &operator=(const Node &node) {
+            for (int i = 0; i < 4; ++i) {
+                sum[i].store(node.sum[i].load(std::memory_order_relaxed),
+                             std::memory_order_relaxed);
+                child[i] = node.child[i];
+            }
+            return *this;
+        }
+
+        float total() const {
+            float result = 0.f;
+            for (int i = 0; i < 4; ++i)
+                result += sum[i].load(std::memory_order_relaxed);
+            return result;
+        }
+    };
+
+    DTree() : m_nodes(1), m_sample_count(0) { }
+
+    DTree(const DTree &tree) { *this = tree; }
+
+    DTree &operator=(const DTree &tree) {
+        m_nodes = tree.m_nodes;
+        m_sample_count.store(tree.sample_count(), std::memory_order_relaxed);
+        return *this;
+    }
+
+    /// Total energy recorded in the tree
+    float total() const { return m_nodes[0].total(); }
+
+    /// Number of samples recorded since the last call to \ref build()
+    uint32_t sample_count() const {
+        return m_sample_count.load(std::memory_order_relaxed);
+    }
+
+    void set_sample_count(uint32_t count) {
+        m_sample_count.store(count, std::memory_order_relaxed);
+    }
+
+    /// Number of nodes of the tree
+    size_t node_count() const { return m_nodes.size(); }
+
+    /// Record an energy sample at position \c p of the square
+    void record(Point2 p, float value) {
+        m_sample_count.fetch_add(1, std::memory_order_relaxed);
+
+        uint32_t index = 0;
+        while (true) {
+            uint32_t quadrant = select_quadrant(p);
+            Node &node = m_nodes[index];
+            atomic_add(node.sum[quadrant], value);
+            if (node.child[quadrant] == 0)
+                break;
+            index = node.child[quadrant];
+        }
+    }
+
+    /// Density of \ref sample() with respect to the area of the square
+    float pdf(Point2 p) const {
+        float density = 1.f;
+        uint32_t index = 0;
+        while (true) {
+            const Node &node = m_nodes[index];
+            float total = node.total();
+            if (!(total > 0.f))
+                return index == 0 ? 1.f : 0.f;
+
+            uint32_t quadrant = select_quadrant(p);
+            density *= 4.f * node.sum[quadrant].load(std::memory_order_relaxed) / total;
+            if (node.child[quadrant] == 0 || density == 0.f)
+                return density;
+            index = node.child[quadrant];
+        }
+    }
+
+    /// Warp a uniform sample on the square according to the stored energy
+    Point2 sample(Point2 u) const {
+        Point2 origin(0.f), result = u;
+        float scale = 1.f;
+        uint32_t index = 0;
+
+        while (true) {
+            const Node &node = m_nodes[index];
+            float s[4];
+            for (int i = 0; i < 4; ++i)
+                s[i] = node.sum[i].load(std::memory_order_relaxed);
+
+            float total = s[0] + s[1] + s[2] + s[3];
+            if (!(total > 0.f))
+                break;
+
+            // Select the horizontal half, then the vertical half given the former
+            uint32_t quadrant = 0;
+            float left = (s[0] + s[2]) / total;
+            if (u.x() < left) {
+                u.x() /= left;
+            } else {
+                u.x() = (u.x() - left) / (1.f - left);
+                quadrant |= 1;
+            }
+
+            float bottom_total = s[quadrant] + s[quadrant | 2],
+                  bottom = s[quadrant] / bottom_total;
+            if (u.y() < bottom) {
+                u.y() /= bottom;
+            } else {
+                u.y() = (u.y() - bottom) / (1.f - bottom);
+                quadrant |= 2;
+            }
+
+            u = dr::minimum(u, dr::OneMinusEpsilon<float>);
+            scale *= .5f;
+            origin += Point2((float) (quadrant & 1), (float) (quadrant >> 1)) * scale;
+            result = origin + u * scale;
+
+            if (node.child[quadrant] == 0)
+                break;
+            index = node.child[quadrant];
+        }
+
+        return result;
+    }
+
+    /**
+     * \brief Rebuild the tree structure from a tree with recorded energy
+     *
+     * Quadrants with more than \c threshold of the total energy are
+     * subdivided (up to \c max_depth levels), others become leaves. The
+     * energies of the resulting tree are cleared.
+     */
+    void build(const DTree &prev, float threshold, uint32_t max_depth = 20) {
+        struct Item {
+            uint32_t node, prev_node, depth;
+            float sum[4];
+        };
+
+        m_nodes.clear();
+        m_nodes.emplace_back();
+        m_sample_count.store(0, std::memory_order_relaxed);
+
+        float total = prev.total();
+        if (!(total > 0.f))
+            return;
+
+        std::vector<Item> stack;
+        Item root { 0, 0, 1, { } };
+        for (int i = 0; i < 4; ++i)
+            root.sum[i] = prev.m_nodes[0].sum[i].load(std::memory_order_relaxed);
+        stack.push_back(root);
+
+        while (!stack.empty()) {
+            Item item = stack.back();
+            stack.pop_back();
+
+            for (uint32_t i = 0; i < 4; ++i) {
+                if (item.depth >= max_depth || !(item.sum[i] / total > threshold))
+                    continue;
+
+                uint32_t child = (uint32_t) m_nodes.size();
+                m_nodes.emplace_back();
+                m_nodes[item.node].child[i] = child;
+
+                // Continue with the energies of the previous tree where available
+                Item next { child, (uint32_t) -1, item.depth + 1, { } };
+                uint32_t prev_child =
+                    item.prev_node != (uint32_t) -1
+                        ? prev.m_nodes[item.prev_node].child[i] : 0;
+
+                if (prev_child != 0) {
+                    next.prev_node = prev_child;
+                    for (int j = 0; j < 4; ++j)
+                        next.sum[j] = prev.m_nodes[prev_child].sum[j].load(
+                            std::memory_order_relaxed);
+                } else {
+                    for (int j = 0; j < 4; ++j)
+                        next.sum[j] = item.sum[i] * .25f;
+                }
+
+                stack.push_back(next);
+            }
+        }
+    }
+
+private:
+    /// Determine the quadrant of \c p and map it to the quadrant's square
+    static uint32_t select_quadrant(Point2 &p) {
+        uint32_t quadrant = 0;
+        for (int i = 0; i < 2; ++i) {
+            if (p[i] < .5f) {
+                p[i] *= 2.f;
+            } else {
+                p[i] = p[i] * 2.f - 1.f;
+                quadrant |= 1u << i;
+            }
+        }
+        return quadrant;
+    }
+
+private:
+    std::vector<Node> m_nodes;
+    std::atomic<uint32_t> m_sample_count;
+};
+
+/**
+ * \brief Spatial binary tree whose leaves refer to a pair of directional
+ * quadtrees: one that is sampled from, and one that records new data.
+ */
+class SDTree {
+public:
+    using Point2  = Point<float, 2>;
+    using Point3  = Point<float, 3>;
+    using Vector3 = Vector<float, 3>;
+    using BoundingBox3 = BoundingBox<Point3>;
+
+    struct Leaf {
+        DTree sampling, building;
+    };
+
+    SDTree(const BoundingBox3 &bbox) {
+        // Use a cube slightly larger than the scene so that cells stay regular
+        Vector3 extents = bbox.valid() ? bbox.extents() : Vector3(1.f);
+        float size = dr::max(extents) * 1.01f;
+        if (!(size > 0.f))
+            size = 1.f;
+        Point3 center = bbox.valid() ? bbox.center() : Point3(0.f);
+        m_bbox = BoundingBox3(center - size * .5f, center + size * .5f);
+
+        m_nodes.push_back({ 0, 0, 0 });
+        m_leaves.emplace_back();
+    }
+
+    /// Return the leaf containing the point \c p
+    Leaf &lookup(Point3 p) {
+        p = dr::clamp((p - m_bbox.min) / m_bbox.extents(), 0.f, 1.f);
+
+        uint32_t index = 0;
+        while (m_nodes[index].child != 0) {
+            const Node &node = m_nodes[index];
+            if (p[node.axis] < .5f) {
+                p[node.axis] *= 2.f;
+                index = node.child;
+            } else {
+                p[node.axis] = p[node.axis] * 2.f - 1.f;
+                index = node.child + 1;
+            }
+        }
+
+        return m_leaves[m_nodes[index].leaf];
+    }
+
+    /**
+     * \brief Subdivide cells that received more than \c threshold samples,
+     * then make the recorded data the new sampling distribution.
+     */
+    void refine(uint32_t threshold, float directional_threshold) {
+        std::vector<uint32_t> stack;
+        for (uint32_t i = 0; i < (uint32_t) m_nodes.size(); ++i)
+            if (m_nodes[i].child == 0)
+                stack.push_back(i);
+
+        while (!stack.empty()) {
+            uint32_t index = stack.back();
+            stack.pop_back();
+
+            uint32_t leaf = m_nodes[index].leaf,
+                     count = m_leaves[leaf].building.sample_count();
+            if (count <= threshold)
+                continue;
+
+            // Both halves inherit the recorded data, and half of the samples
+            m_leaves[leaf].building.set_sample_count(count / 2);
+            uint32_t child = (uint32_t) m_nodes.size(),
+                     axis  = (m_nodes[index].axis + 1) % 3;
+
+            Leaf copy = m_leaves[leaf];
+            m_leaves.push_back(copy);
+            m_nodes.push_back({ axis, 0, leaf });
+            m_nodes.push_back({ axis, 0, (uint32_t) m_leaves.size() - 1 });
+
+            m_nodes[index].child = child;
+            stack.push_back(child);
+            stack.push_back(child + 1);
+        }
+
+        for (Leaf &l : m_leaves) {
+            l.sampling = l.building;
+            l.building.build(l.sampling, directional_threshold);
+        }
+    }
+
+    size_t leaf_count() const { return m_leaves.size(); }
+
+    /// Average number of quadtree nodes per leaf
+    float average_dtree_size() const {
+        size_t count = 0;
+        for (const Leaf &l : m_leaves)
+            count += l.sampling.node_count();
+        return count / (float) m_leaves.size();
+    }
+
+private:
+    struct Node {
+        uint32_t axis;
+        uint32_t child; // 0: leaf, otherwise index of the first child
+        uint32_t leaf;
+    };
+
+    BoundingBox3 m_bbox;
+    std::vector<Node> m_nodes;
+    std::vector<Leaf> m_leaves;
+};
+
+template <typename Float, typename Spectrum>
+class GuidedPathIntegrator : public MonteCarloIntegrator<Float, Spectrum> {
+public:
+    MI_IMPORT_BASE(MonteCarloIntegrator, m_max_depth, m_rr_depth,
+                   m_hide_emitters, m_stop)
+    MI_IMPORT_TYPES(Scene, Sensor, Sampler, Medium, Emitter, EmitterPtr, BSDF,
+                    BSDFPtr)
+
+    GuidedPathIntegrator(const Properties &props) : Base(props) {
+        if constexpr (dr::is_jit_v<Float>)
+            Throw("The guided path tracer is only supported in scalar variants.");
+
+        m_training_iterations = props.get<uint32_t>("training_iterations", 5);
+        if (m_training_iterations > 16)
+            Throw("\"training_iterations\" must be at most 16.");
+
+        m_bsdf_fraction = props.get<ScalarFloat>("bsdf_sampling_fraction", .5f);
+        if (!(m_bsdf_fraction > 0.f && m_bsdf_fraction <= 1.f))
+            Throw("\"bsdf_sampling_fraction\" must be in (0, 1].");
+
+        m_spatial_threshold = props.get<uint32_t>("spatial_threshold", 12000);
+        m_directional_threshold =
+            props.get<ScalarFloat>("directional_threshold", .01f);
+
+        m_recording = false;
+    }
+
+    TensorXf render(Scene *scene,
+                    Sensor *sensor,
+                    uint32_t seed = 0,
+                    uint32_t spp = 0,
+                    bool develop = true,
+                    bool evaluate = true) override {
+        // The training passes override the sample count of the sampler
+        uint32_t final_spp = spp ? spp : sensor->sampler()->sample_count();
+
+        ScalarBoundingBox3f bbox = scene->bbox();
+        m_sdtree = std::make_unique<SDTree>(
+            SDTree::BoundingBox3(SDTree::Point3(bbox.min), SDTree::Point3(bbox.max)));
+
+        m_recording = true;
+        for (uint32_t i = 0; i < m_training_iterations; ++i) {
+            uint32_t iteration_spp = 1u << i;
+            Log(Info, "Path guiding: training iteration %u/%u (%u spp)", i + 1,
+                m_training_iterations, iteration_spp);
+
+            Base::render(scene, sensor, seed + i + 1, iteration_spp,
+                         false, true);
+            if (m_stop)
+                break;
+
+            m_sdtree->refine((uint32_t)(m_spatial_threshold *
+                                        dr::sqrt((float) iteration_spp)),
+                             m_directional_threshold);
+
+            Log(Debug, "Path guiding: %zu spatial cells, %.1f quadtree nodes "
+                       "per cell on average.", m_sdtree->leaf_count(),
+                m_sdtree->average_dtree_size());
+        }
+        m_recording = false;
+
+        return Base::render(scene, sensor, seed, final_spp, develop, evaluate);
+    }
+
+    std::pair<Spectrum, Bool> sample(const Scene *scene,
+                                     Sampler *sampler,
+                                     const RayDifferential3f &ray_,
+                                     const Medium * /* medium */,
+                                     Float * /* aovs */,
+                                     Bool active) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::SamplingIntegratorSample, active);
+
+        if constexpr (dr::is_jit_v<Float>) {
+            DRJIT_MARK_USED(scene);
+            DRJIT_MARK_USED(sampler);
+            DRJIT_MARK_USED(ray_);
+            NotImplementedError("sample");
+        } else {
+            if (unlikely(m_max_depth == 0 || !active))
+                return { 0.f, false };
+
+            Ray3f ray              = Ray3f(ray_);
+            Spectrum throughput    = 1.f;
+            Spectrum result        = 0.f;
+            Float eta              = 1.f;
+            uint32_t depth         = 0;
+
+            // If m_hide_emitters == false, the environment emitter will be visible
+            Mask valid_ray         = !m_hide_emitters && scene->environment() != nullptr;
+
+            // Variables caching information from the previous bounce
+            Interaction3f prev_si  = dr::zeros<Interaction3f>();
+            Float prev_bsdf_pdf    = 1.f;
+            Bool prev_bsdf_delta   = true;
+            BSDFContext bsdf_ctx;
+
+            // Path vertices whose incident radiance is recorded into the SD-tree
+            constexpr uint32_t MaxVertices = 64;
+            GuidingVertex vertices[MaxVertices];
+            uint32_t vertex_count = 0;
+
+            while (active) {
+                SurfaceInteraction3f si =
+                    scene->ray_intersect(ray, +RayFlags::All,
+                                         /* coherent = */ depth == 0);
+
+                // ---------------------- Direct emission ----------------------
+
+                if (si.emitter(scene) != nullptr) {
+                    DirectionSample3f ds(scene, si, prev_si);
+                    Float em_pdf = 0.f;
+
+                    if (!prev_bsdf_delta)
+                        em_pdf = scene->pdf_emitter_direction(prev_si, ds);
+
+                    // Compute MIS weight for emitter sample from previous bounce
+                    Float mis_bsdf = mis_weight(prev_bsdf_pdf, em_pdf);
+
+                    result = spec_fma(
+                        throughput,
+                        ds.emitter->eval(si, prev_bsdf_pdf > 0.f) * mis_bsdf,
+                        result);
+                }
+
+                // Continue tracing the path at this point?
+                if (!(depth + 1 < m_max_depth && si.is_valid()))
+                    break;
+
+                BSDFPtr bsdf = si.bsdf(ray);
+
+                // Guide sampling at vertices with a smooth BSDF component
+                bool smooth = has_flag(bsdf->flags(), BSDFFlags::Smooth);
+                SDTree::Leaf *leaf =
+                    smooth ? &m_sdtree->lookup(SDTree::Point3(si.p)) : nullptr;
+                bool guide = leaf && leaf->sampling.total() > 0.f &&
+                             m_bsdf_fraction < 1.f;
+
+                // ---------------------- Emitter sampling ----------------------
+
+                if (smooth) {
+                    auto [ds, em_weight] = scene->sample_emitter_direction(
+                        si, sampler->next_2d(), true);
+
+                    if (ds.pdf != 0.f) {
+                        Vector3f wo = si.to_local(ds.d);
+                        auto [bsdf_val, bsdf_pdf] = bsdf->eval_pdf(bsdf_ctx, si, wo);
+                        bsdf_val = si.to_world_mueller(bsdf_val, -wo, si.wi);
+
+                        Float pdf = guide ? mixture_pdf(leaf, ds.d, bsdf_pdf)
+                                          : bsdf_pdf;
+
+                        Float mis_em = ds.delta ? 1.f : mis_weight(ds.pdf, pdf);
+                        result = spec_fma(throughput, bsdf_val * em_weight * mis_em,
+                                          result);
+                    }
+                }
+
+                // -------- Sample a direction from the BSDF or the SD-tree --------
+
+                Float sample_1 = sampler->next_1d();
+                Point2f sample_2 = sampler->next_2d();
+
+                BSDFSample3f bs = dr::zeros<BSDFSample3f>();
+                Spectrum bsdf_weight = 0.f;
+                Float pdf = 0.f;
+
+                if (!guide) {
+                    std::tie(bs, bsdf_weight) =
+                        bsdf->sample(bsdf_ctx, si, sample_1, sample_2);
+                    pdf = bs.pdf;
+                } else {
+                    Float sample_sel = sampler->next_1d();
+                    Spectrum bsdf_val;
+                    Float bsdf_pdf;
+
+                    if (sample_sel < m_bsdf_fraction) {
+                        std::tie(bs, bsdf_weight) =
+                            bsdf->sample(bsdf_ctx, si, sample_1, sample_2);
+                        if (!(bs.pdf > 0.f))
+                            break;
+                    } else {
+                        SDTree::Point2 p = leaf->sampling.sample(SDTree::Point2(sample_2));
+                        bs = BSDFSample3f(si.to_local(
+                            warp::square_to_uniform_sphere(Point2f(p))));
+                        bs.sampled_type = +BSDFFlags::Glossy;
+                        bs.sampled_component = 0;
+                    }
+
+                    if (has_flag(bs.sampled_type, BSDFFlags::Delta)) {
+                        // Only the BSDF can generate directions of delta lobes
+                        bsdf_weight /= m_bsdf_fraction;
+                        pdf = bs.pdf;
+                    } else {
+                        std::tie(bsdf_val, bsdf_pdf) =
+                            bsdf->eval_pdf(bsdf_ctx, si, bs.wo);
+                        pdf = mixture_pdf(leaf, si.to_world(bs.wo), bsdf_pdf);
+                        bs.pdf = pdf;
+                        bsdf_weight = pdf > 0.f ? bsdf_val / pdf : Spectrum(0.f);
+                    }
+                }
+
+                if (!(pdf > 0.f))
+                    break;
+
+                bsdf_weight = si.to_world_mueller(bsdf_weight, -bs.wo, si.wi);
+                ray = si.spawn_ray(si.to_world(bs.wo));
+
+                // ------ Update loop variables based on current interaction ------
+
+                throughput *= bsdf_weight;
+                eta *= bs.eta;
+                valid_ray |= si.is_valid() &&
+                             !has_flag(bs.sampled_type, BSDFFlags::Null);
+
+                prev_si = si;
+                prev_bsdf_pdf = pdf;
+                prev_bsdf_delta = has_flag(bs.sampled_type, BSDFFlags::Delta);
+
+                Float throughput_lum = luminance(throughput);
+                if (m_recording && smooth && !prev_bsdf_delta &&
+                    vertex_count < MaxVertices && throughput_lum > 0.f)
+                    vertices[vertex_count++] = { leaf, SDTree::Vector3(ray.d),
+                                                 throughput_lum, luminance(result),
+                                                 pdf };
+
+                // -------------------- Stopping criterion ---------------------
+
+                depth++;
+
+                Float throughput_max = dr::max(unpolarized_spectrum(throughput));
+                Float rr_prob = dr::minimum(throughput_max * dr::sqr(eta), .95f);
+
+                if (depth >= m_rr_depth) {
+                    if (!(sampler->next_1d() < rr_prob))
+                        break;
+                    throughput *= dr::rcp(rr_prob);
+                }
+
+                if (throughput_max == 0.f)
+                    break;
+            }
+
+            /* Record the radiance that arrived at each vertex along its
+               sampled direction, in proportion to the density of that direction */
+            Float result_lum = luminance(result);
+            for (uint32_t i = 0; i < vertex_count; ++i) {
+                const GuidingVertex &v = vertices[i];
+                float radiance = (float) ((result_lum - v.result) / v.throughput);
+                if (radiance > 0.f && dr::isfinite(radiance))
+                    v.leaf->building.record(
+                        warp::uniform_sphere_to_square(v.direction),
+                        radiance / (float) v.pdf);
+            }
+
+            return {
+                /* spec  = */ valid_ray ? result : Spectrum(0.f),
+                /* valid = */ valid_ray
+            };
+        }
+    }
+
+    //! @}
+    // =============================================================
+
+    std::string to_string() const override {
+        return tfm::format("GuidedPathIntegrator[\n"
+            "  max_depth = %u,\n"
+            "  rr_depth = %u,\n"
+            "  training_iterations = %u,\n"
+            "  bsdf_sampling_fraction = %f,\n"
+            "  spatial_threshold = %u,\n"
+            "  directional_threshold = %f\n"
+            "]", m_max_depth, m_rr_depth, m_training_iterations,
+            m_bsdf_fraction, m_spatial_threshold, m_directional_threshold);
+    }
+
+    /// One-sample MIS density of combined BSDF and guided sampling
+    Float mixture_pdf(const SDTree::Leaf *leaf, const Vector3f &d,
+                      Float bsdf_pdf) const {
+        Float guide_pdf =
+            leaf->sampling.pdf(warp::uniform_sphere_to_square(SDTree::Vector3(d))) *
+            dr::InvFourPi<Float>;
+        return dr::lerp(guide_pdf, bsdf_pdf, m_bsdf_fraction);
+    }
+
+    /// Luminance-like scalar summary of a spectrum used to drive guiding
+    Float luminance(const Spectrum &value) const {
+        return dr::mean(unpolarized_spectrum(value));
+    }
+
+    /// Compute a multiple importance sampling weight using the power heuristic
+    Float mis_weight(Float pdf_a, Float pdf_b) const {
+        pdf_a *= pdf_a;
+        pdf_b *= pdf_b;
+        Float w = pdf_a / (pdf_a + pdf_b);
+        return dr::select(dr::isfinite(w), w, 0.f);
+    }
+
+    /**
+     * \brief Perform a Mueller matrix multiplication in polarized modes, and a
+     * fused multiply-add otherwise.
+     */
+    Spectrum spec_fma(const Spectrum &a, const Spectrum &b,
+                      const Spectrum &c) const {
+        if constexpr (is_polarized_v<Spectrum>)
+            return a * b + c;
+        else
+            return dr::fmadd(a, b, c);
+    }
+
+    MI_DECLARE_CLASS()
+private:
+    /// Path vertex whose incident radiance is recorded after the path ends
+    struct GuidingVertex {
+        SDTree::Leaf *leaf;
+        SDTree::Vector3 direction;
+        Float throughput; // Luminance of the throughput after the vertex
+        Float result;     // Luminance of the path contribution before the vertex
+        Float pdf;        // Density of the sampled direction
+    };
+
+    uint32_t m_training_iterations;
+    ScalarFloat m_bsdf_fraction;
+    uint32_t m_spatial_threshold;
+    ScalarFloat m_directional_threshold;
+
+    std::unique_ptr<SDTree> m_sdtree;
+    bool m_recording;
+};
+
+MI_IMPLEMENT_CLASS_VARIANT(GuidedPathIntegrator, MonteCarloIntegrator)
+MI_EXPORT_PLUGIN(GuidedPathIntegrator, "Guided path tracer integrator");
+NAMESPACE_END(mitsuba)
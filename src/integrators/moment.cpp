@@ -1,5 +1,7 @@
+#include <mitsuba/render/film.h>
 #include <mitsuba/render/integrator.h>
 #include <mitsuba/render/records.h>
+#include <mitsuba/render/sensor.h>
 
 NAMESPACE_BEGIN(mitsuba)
 
@@ -18,9 +20,37 @@ Moment integrator (:monosp:`moment`)
    - Sub-integrators (can have more than one) which will be sampled along the AOV integrator. Their
      respective XYZ output will be put into distinct images.
 
+ * - online
+   - |bool|
+   - Track the variance of every pixel with an online accumulator instead of writing the second
+     moments to the film (Default: |false|)
+
 This integrator returns one AOVs recording the second moment of the samples of the nested
 integrator.
 
+The variance of a pixel must then be computed after rendering, as the difference between the second
+moment and the squared first moment. This doubles the number of channels of the film, and the
+difference is prone to cancellation when the variance is small compared to the mean. When the
+:monosp:`online` parameter is set, the integrator instead accumulates the statistics of the
+luminance of every nested integrator for each pixel using Welford's algorithm (in scalar variants)
+or per-pass sums relative to the previous mean that are merged after every call to
+:monosp:`render()` (in JIT variants). The statistics are unweighted, i.e. they ignore the
+reconstruction filter, and they carry over between calls to :monosp:`render()` as long as the crop
+window of the film doesn't change, which suits progressive rendering loops. The second moment
+AOVs are omitted in this case. Instead, the following read-only parameters are exposed via
+:monosp:`mi.traverse()`:
+
+- :monosp:`relative_error`: a tensor of shape :monosp:`(height, width, n)` with the relative
+  standard error of the mean luminance of each pixel for each of the :monosp:`n` nested integrators
+  (infinite for pixels with less than two samples, zero for black pixels).
+
+- :monosp:`convergence`: the average relative error over all pixels and nested integrators. It is
+  updated after every call to :monosp:`render()` and can be polled to stop a progressive render
+  early.
+
+Updating the :monosp:`relative_error` parameter (e.g. by assigning any value to it followed by
+:monosp:`params.update()`) discards the accumulated statistics.
+
 .. tabs::
     .. code-tab:: xml
 
@@ -41,9 +71,12 @@ template <typename Float, typename Spectrum>
 class MomentIntegrator final : public SamplingIntegrator<Float, Spectrum> {
 public:
     MI_IMPORT_BASE(SamplingIntegrator)
-    MI_IMPORT_TYPES(Scene, Sampler, Medium)
+    MI_IMPORT_TYPES(Scene, Sensor, Sampler, Medium)
+    using FloatStorage = DynamicBuffer<Float>;
 
     MomentIntegrator(const Properties &props) : Base(props) {
+        m_online = props.get<bool>("online", false);
+
         // Get the nested integrators and their AOVs
         for (auto &kv : props.objects()) {
             Base *integrator = dynamic_cast<Base *>(kv.second.get());
@@ -60,9 +93,49 @@ public:
         }
 
         // For every AOV, add a corresponding "m2_" AOV
-        size_t aov_count = m_aov_names.size();
-        for (size_t i = 0; i < aov_count; i++)
-            m_aov_names.push_back("m2_" + m_aov_names[i]);
+        if (!m_online) {
+            size_t aov_count = m_aov_names.size();
+            for (size_t i = 0; i < aov_count; i++)
+                m_aov_names.push_back("m2_" + m_aov_names[i]);
+        }
+    }
+
+    TensorXf render(Scene *scene,
+                    Sensor *sensor,
+                    uint32_t seed = 0,
+                    uint32_t spp = 0,
+                    bool develop = true,
+                    bool evaluate = true) override {
+        if (!m_online)
+            return Base::render(scene, sensor, seed, spp, develop, evaluate);
+
+        // Restart the statistics when the crop window changed
+        const Film *film = sensor->film();
+        ScalarVector2u size = film->crop_size();
+        ScalarVector2i offset = ScalarVector2i(film->crop_offset());
+        if (dr::any(dr::neq(size, m_stats_size)) ||
+            dr::any(dr::neq(offset, m_stats_offset))) {
+            m_stats_size = size;
+            m_stats_offset = offset;
+            clear_statistics();
+        }
+
+        if constexpr (dr::is_jit_v<Float>) {
+            size_t entries = dr::prod(m_stats_size) * m_integrators.size();
+            m_batch_count = dr::zeros<FloatStorage>(entries);
+            m_batch_sum = dr::zeros<FloatStorage>(entries);
+            m_batch_sum_sqr = dr::zeros<FloatStorage>(entries);
+        }
+
+        TensorXf result = Base::render(scene, sensor, seed, spp, develop, evaluate);
+
+        if constexpr (dr::is_jit_v<Float>) {
+            merge_batch();
+            m_batch_count = m_batch_sum = m_batch_sum_sqr = FloatStorage();
+        }
+
+        update_relative_error();
+        return result;
     }
 
     std::pair<Spectrum, Mask> sample(const Scene *scene,
@@ -71,6 +144,34 @@ public:
                                      const Medium *medium,
                                      Float *aovs,
                                      Mask active) const override {
+        return sample_impl(scene, sampler, ray, nullptr, medium, aovs, active);
+    }
+
+    std::pair<Spectrum, Mask> sample_pixel(const Scene *scene,
+                                           Sampler *sampler,
+                                           const RayDifferential3f &ray,
+                                           const Vector2f &pos,
+                                           const Medium *medium,
+                                           Float *aovs,
+                                           Mask active) const override {
+        if (!m_online || dr::width(m_mean) == 0)
+            return sample(scene, sampler, ray, medium, aovs, active);
+
+        Vector2i p = dr::clamp(dr::floor2int<Vector2i>(pos) - m_stats_offset,
+                               ScalarVector2i(0),
+                               ScalarVector2i(m_stats_size) - 1);
+        UInt32 pixel = UInt32(p.y() * (int32_t) m_stats_size.x() + p.x());
+        return sample_impl(scene, sampler, ray, &pixel, medium, aovs, active);
+    }
+
+    /// Implementation of \ref sample(), which records the statistics of \c pixel (if given)
+    std::pair<Spectrum, Mask> sample_impl(const Scene *scene,
+                                          Sampler *sampler,
+                                          const RayDifferential3f &ray,
+                                          const UInt32 *pixel,
+                                          const Medium *medium,
+                                          Float *aovs,
+                                          Mask active) const {
         MI_MASKED_FUNCTION(ProfilerPhase::SamplingIntegratorSample, active);
 
         std::pair<Spectrum, Mask> result { 0.f, false };
@@ -99,9 +200,14 @@ public:
 
             *aovs++ = xyz.x(); *aovs++ = xyz.y(); *aovs++ = xyz.z();
 
-            // Write second moment AOVs
-            for (size_t j = 0; j < m_integrators[i].second + 3; j++)
-                *(aovs - j + offset - 1) = dr::sqr(*(aovs - j - 1));
+            if (m_online) {
+                if (pixel)
+                    record(*pixel, (uint32_t) i, xyz.y(), active);
+            } else {
+                // Write second moment AOVs
+                for (size_t j = 0; j < m_integrators[i].second + 3; j++)
+                    *(aovs - j + offset - 1) = dr::sqr(*(aovs - j - 1));
+            }
 
             if (i == 0)
                 result = result_sub;
@@ -119,6 +225,17 @@ public:
             callback->put_object("integrator_" + std::to_string(i),
                                  m_integrators[i].first.get(),
                                  +ParamFlags::Differentiable);
+        if (m_online) {
+            callback->put_parameter("relative_error", m_relative_error,
+                                    +ParamFlags::NonDifferentiable);
+            callback->put_parameter("convergence", m_convergence,
+                                    +ParamFlags::NonDifferentiable);
+        }
+    }
+
+    void parameters_changed(const std::vector<std::string> &keys) override {
+        if (string::contains(keys, "relative_error"))
+            clear_statistics();
     }
 
     std::string to_string() const override {
@@ -138,9 +255,107 @@ public:
     }
 
     MI_DECLARE_CLASS()
+private:
+    /// Add a luminance sample of nested integrator \c index to the statistics of \c pixel
+    void record(const UInt32 &pixel, uint32_t index, const Float &value,
+                Mask active) const {
+        UInt32 slot = pixel * (uint32_t) m_integrators.size() + index;
+
+        if constexpr (dr::is_jit_v<Float>) {
+            /* Accumulate the values relative to the mean of the previous
+               calls, which avoids cancellation in the sum of squares */
+            Float delta = value - dr::gather<Float>(m_mean, slot, active);
+            dr::scatter_reduce(ReduceOp::Add, m_batch_count, Float(1.f), slot, active);
+            dr::scatter_reduce(ReduceOp::Add, m_batch_sum, delta, slot, active);
+            dr::scatter_reduce(ReduceOp::Add, m_batch_sum_sqr, dr::sqr(delta),
+                               slot, active);
+        } else {
+            /* Welford's algorithm. Every pixel is rendered by a single
+               thread at a time, hence no synchronization is needed. */
+            if (!active)
+                return;
+            ScalarFloat &count = m_count.data()[slot],
+                        &mean = m_mean.data()[slot],
+                        &m2 = m_m2.data()[slot];
+            count += 1.f;
+            ScalarFloat delta = value - mean;
+            mean += delta / count;
+            m2 = dr::fmadd(delta, value - mean, m2);
+        }
+    }
+
+    /**
+     * \brief Merge the sums recorded during the last call to \ref render()
+     * into the statistics (JIT variants)
+     *
+     * Uses the pairwise update of Chan et al., where the mean of the new
+     * samples is offset by the previous mean.
+     */
+    void merge_batch() {
+        if constexpr (dr::is_jit_v<Float>) {
+            Float n_b = m_batch_count,
+                  n = m_count + n_b,
+                  inv_n = dr::select(n > 0.f, dr::rcp(n), 0.f),
+                  inv_n_b = dr::select(n_b > 0.f, dr::rcp(n_b), 0.f),
+                  delta = m_batch_sum * inv_n_b,
+                  m2_b = dr::maximum(dr::fnmadd(m_batch_sum, delta, m_batch_sum_sqr), 0.f);
+
+            m_m2 = m_m2 + m2_b + dr::sqr(delta) * m_count * n_b * inv_n;
+            m_mean = dr::fmadd(delta, n_b * inv_n, m_mean);
+            m_count = n;
+            dr::eval(m_count, m_mean, m_m2);
+        }
+    }
+
+    /// Recompute \ref m_relative_error and \ref m_convergence from the statistics
+    void update_relative_error() {
+        if (dr::width(m_count) == 0) {
+            m_relative_error = TensorXf();
+            m_convergence = dr::Infinity<ScalarFloat>;
+            return;
+        }
+
+        FloatStorage variance = m_m2 / ((m_count - 1.f) * m_count),
+                     error = dr::select(dr::neq(m_mean, 0.f),
+                                        dr::safe_sqrt(variance) / dr::abs(m_mean),
+                                        0.f);
+        error = dr::select(m_count < 2.f, dr::Infinity<ScalarFloat>, error);
+
+        size_t shape[3] = { m_stats_size.y(), m_stats_size.x(),
+                            m_integrators.size() };
+        m_relative_error = TensorXf(error, 3, shape);
+
+        if constexpr (dr::is_jit_v<Float>)
+            m_convergence = dr::slice(dr::mean(error));
+        else
+            m_convergence = dr::mean(error);
+    }
+
+    /// Discard the accumulated statistics
+    void clear_statistics() {
+        size_t entries = dr::prod(m_stats_size) * m_integrators.size();
+        m_count = dr::zeros<FloatStorage>(entries);
+        m_mean = dr::zeros<FloatStorage>(entries);
+        m_m2 = dr::zeros<FloatStorage>(entries);
+        update_relative_error();
+    }
+
 private:
     std::vector<std::string> m_aov_names;
     std::vector<std::pair<ref<Base>, size_t>> m_integrators;
+
+    /// Use the online accumulator instead of second moment AOVs?
+    bool m_online;
+    /// Crop window that the statistics refer to
+    ScalarVector2u m_stats_size { 0, 0 };
+    ScalarVector2i m_stats_offset { 0, 0 };
+    /// Per-pixel sample count, mean, and sum of squared deviations of the luminance
+    mutable FloatStorage m_count, m_mean, m_m2;
+    /// Sums of the current call to \ref render() (JIT variants)
+    mutable FloatStorage m_batch_count, m_batch_sum, m_batch_sum_sqr;
+    /// Relative standard error of each pixel and its average
+    TensorXf m_relative_error;
+    ScalarFloat m_convergence = dr::Infinity<ScalarFloat>;
 };
 
 MI_IMPLEMENT_CLASS_VARIANT(MomentIntegrator, SamplingIntegrator)
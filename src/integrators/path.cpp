@@ -1,6 +1,9 @@
 #include <tuple>
 #include <mitsuba/core/ray.h>
 #include <mitsuba/core/properties.h>
+#include <mitsuba/core/random.h>
+#include <mitsuba/core/timer.h>
+#include <mitsuba/core/util.h>
 #include <mitsuba/render/bsdf.h>
 #include <mitsuba/render/emitter.h>
 #include <mitsuba/render/integrator.h>
@@ -35,6 +38,73 @@ Path tracer (:monosp:`path`)
    - |bool|
    - Hide directly visible emitters. (Default: no, i.e. |false|)
 
+ * - packet_tracing
+   - |bool|
+   - Intersect the camera rays of neighboring pixels as packets, which can
+     speed up the first bounce when using Embree. Only has an effect in scalar
+     variants. (Default: no, i.e. |false|)
+
+ * - reorder_rays
+   - |bool|
+   - Sort the rays of a wavefront by direction octant and origin before every
+     bounce except the first to improve the coherence of ray traversal. Only
+     has an effect in JIT variants when loop recording is disabled (e.g. by
+     passing the '-W' command line flag). (Default: no, i.e. |false|)
+
+ * - sort_bsdfs
+   - |bool|
+   - Group the lanes of a wavefront by BSDF (using a counting sort) before
+     evaluating and sampling the BSDFs, and move the results back afterwards.
+     This makes shading more coherent in scenes with many materials. Only has
+     an effect in JIT variants when loop recording is disabled or ``staged``
+     is enabled. (Default: no, i.e. |false|)
+
+ * - staged
+   - |bool|
+   - Split every bounce into separately evaluated stages (intersection, next
+     event estimation and shading) and compact the queue of rays after each
+     bounce, so that terminated paths no longer occupy lanes. Only has an
+     effect in unpolarized JIT variants. The time spent in each stage is
+     logged at the ``Debug`` level. (Default: no, i.e. |false|)
+
+ * - split_calls
+   - |bool|
+   - In ``staged`` mode, evaluate the method calls on shapes, BSDFs and
+     emitters one instance at a time instead of recording them into the
+     kernels of the stages. Every plugin then gets its own small kernel,
+     which compiles much faster than a megakernel containing all materials
+     of the scene, and which Dr.Jit's kernel cache reuses in other scenes
+     containing the same plugin types. (Default: no, i.e. |false|)
+
+ * - emitter_samples
+   - |int|
+   - Number of emitter samples (shadow rays) taken at every path vertex. The
+     samples are combined with BSDF sampling using multiple importance
+     sampling. (Default: 1)
+
+ * - adaptive_emitter_samples
+   - |bool|
+   - Scale the number of emitter samples of a vertex by the largest component
+     of its path throughput (taking at least one sample), so that the
+     additional shadow rays are spent where they matter most, usually at the
+     first vertex. (Default: no, i.e. |false|)
+
+ * - adrrs
+   - |bool|
+   - Replace the throughput-based Russian roulette by adjoint-driven Russian
+     roulette and splitting (see below). (Default: no, i.e. |false|)
+
+ * - adrrs_spp
+   - |int|
+   - Number of samples per pixel of the prepass that provides the pixel
+     estimates used by adjoint-driven Russian roulette and splitting.
+     (Default: 4)
+
+ * - adrrs_max_split
+   - |int|
+   - Largest number of continuations a path can be split into at a single
+     vertex. (Default: 8)
+
 This integrator implements a basic path tracer and is a **good default choice**
 when there is no strong reason to prefer another method.
 
@@ -67,6 +137,49 @@ relies on multiple importance sampling to combine BSDF and emitter samples. The
 main difference in comparison to the former plugin is that it considers light
 paths of arbitrary length to compute both direct and indirect illumination.
 
+When ``adrrs`` is enabled, the path tracer first renders a cheap prepass whose
+(slightly blurred) pixel values serve as estimates of the final image.
+Following "Adjoint-Driven Russian Roulette and Splitting in Light Transport
+Simulation" by J. Vorba and J. Křivánek, every path vertex then compares its
+expected contribution to the estimate of its pixel: paths whose contribution
+falls below a weight window around the estimate are terminated with a
+proportional probability, while paths above the window are split into
+several continuations. This spends less time on paths that barely affect
+bright pixels and more time on dim regions of the image. Since no radiance
+cache is available, the mean brightness of the prepass stands in for the
+radiance arriving at a vertex. The decision is made from the first bounce
+onwards, and ``rr_depth`` is not used in this mode.
+
+Splitting is supported in scalar variants and in JIT variants rendering in
+wavefront mode (loop recording disabled) or with ``staged`` enabled, where
+split paths are duplicated into additional lanes of the ray queue. Other JIT
+variants only apply the roulette part of the technique.
+
+When the cost counters are enabled (e.g. by the ``cost`` AOV of the
+:ref:`aov <integrator-aov>` integrator), the ``staged`` implementation is not
+used, and paths aren't split in JIT variants.
+
+In staged mode, random numbers after the camera ray are drawn from a per-path
+random number generator, since the compacted ray queue no longer matches the
+lanes of the sampler.
+
+Taking several emitter samples per vertex (``emitter_samples``) is more
+efficient than rendering more samples per pixel when BSDF evaluations are
+expensive compared to shadow rays, or when large area lights cause noisy
+direct illumination. In staged mode, the lanes of the ray queue are
+replicated so that the shadow rays of all emitter samples are traced by a
+single ray test. Otherwise, the samples of a vertex are taken one after the
+other.
+
+In scenes with hundreds of materials, most of the start-up time of a JIT
+variant is spent compiling the calls to all BSDFs that are inlined into the
+kernels. With ``staged`` and ``split_calls`` enabled, the calls are instead
+evaluated per instance (this corresponds to disabling
+``JitFlag.VCallRecord`` in these stages), so that each kernel only contains
+the code of a single plugin. These kernels are found in Dr.Jit's on-disk
+kernel cache when a later scene uses the same plugins, provided that their
+parameters aren't baked into the kernels as literal constants.
+
 .. note:: This integrator does not handle participating media
 
 .. tabs::
@@ -87,38 +200,213 @@ paths of arbitrary length to compute both direct and indirect illumination.
 template <typename Float, typename Spectrum>
 class PathIntegrator : public MonteCarloIntegrator<Float, Spectrum> {
 public:
-    MI_IMPORT_BASE(MonteCarloIntegrator, m_max_depth, m_rr_depth, m_hide_emitters)
-    MI_IMPORT_TYPES(Scene, Sampler, Medium, Emitter, EmitterPtr, BSDF, BSDFPtr)
+    MI_IMPORT_BASE(MonteCarloIntegrator, m_max_depth, m_rr_depth,
+                   m_hide_emitters, m_stop, m_cost_aovs)
+    MI_IMPORT_TYPES(Scene, Sensor, Film, Sampler, Medium, Emitter, EmitterPtr,
+                    BSDF, BSDFPtr)
+
+    using CostCounters = typename Base::CostCounters;
+
+    using FloatStorage = DynamicBuffer<Float>;
+    using PCG32        = mitsuba::PCG32<UInt32>;
+
+    PathIntegrator(const Properties &props) : Base(props) {
+        m_reorder_rays = props.get<bool>("reorder_rays", false);
+        m_sort_bsdfs = props.get<bool>("sort_bsdfs", false);
+
+        m_emitter_samples = props.get<uint32_t>("emitter_samples", 1);
+        if (m_emitter_samples == 0)
+            Throw("\"emitter_samples\" must be greater than zero.");
+        m_adaptive_emitter_samples =
+            props.get<bool>("adaptive_emitter_samples", false);
+
+        m_staged = props.get<bool>("staged", false);
+        if (m_staged && (!dr::is_jit_v<Float> || is_polarized_v<Spectrum>))
+            Log(Warn, "PathIntegrator: staged execution is only supported in "
+                      "unpolarized JIT variants, ignoring the 'staged' "
+                      "parameter.");
+        m_split_calls = props.get<bool>("split_calls", false);
+        if (m_split_calls && !m_staged)
+            Log(Warn, "PathIntegrator: 'split_calls' requires 'staged', "
+                      "ignoring it.");
+
+        m_adrrs = props.get<bool>("adrrs", false);
+        m_adrrs_spp = props.get<uint32_t>("adrrs_spp", 4);
+        if (m_adrrs_spp == 0)
+            Throw("\"adrrs_spp\" must be greater than zero.");
+        m_adrrs_max_split = props.get<uint32_t>("adrrs_max_split", 8);
+        if (m_adrrs_max_split == 0)
+            Throw("\"adrrs_max_split\" must be greater than zero.");
+        m_adrrs_scale = 0.f;
+    }
+
+    TensorXf render(Scene *scene,
+                    Sensor *sensor,
+                    uint32_t seed = 0,
+                    uint32_t spp = 0,
+                    bool develop = true,
+                    bool evaluate = true) override {
+        if (!m_adrrs)
+            return Base::render(scene, sensor, seed, spp, develop, evaluate);
+
+        if constexpr (dr::is_jit_v<Float>) {
+            if (is_polarized_v<Spectrum> ||
+                (jit_flag(JitFlag::LoopRecord) && !m_staged))
+                Log(Warn, "PathIntegrator: path splitting requires an "
+                          "unpolarized variant in wavefront or staged mode, "
+                          "only applying adjoint-driven Russian roulette.");
+        }
+
+        // The prepass overrides the sample count of the sampler
+        uint32_t final_spp = spp ? spp : sensor->sampler()->sample_count();
+
+        Log(Info, "ADRRS: rendering a prepass with %u spp", m_adrrs_spp);
+        TensorXf image =
+            Base::render(scene, sensor, seed + 1, m_adrrs_spp, true, true);
+        if (m_stop)
+            return image;
 
-    PathIntegrator(const Properties &props) : Base(props) { }
+        update_pixel_estimate(sensor->film(), image);
+        image = TensorXf();
+
+        TensorXf result =
+            Base::render(scene, sensor, seed, final_spp, develop, evaluate);
+
+        m_pixel_estimate = FloatStorage();
+        return result;
+    }
 
     std::pair<Spectrum, Bool> sample(const Scene *scene,
                                      Sampler *sampler,
-                                     const RayDifferential3f &ray_,
+                                     const RayDifferential3f &ray,
                                      const Medium * /* medium */,
-                                     Float * /* aovs */,
+                                     Float *aovs,
                                      Bool active) const override {
         MI_MASKED_FUNCTION(ProfilerPhase::SamplingIntegratorSample, active);
+        return sample_path(scene, sampler, ray, nullptr, aovs, active);
+    }
 
-        if (unlikely(m_max_depth == 0))
-            return { 0.f, false };
+    std::pair<Spectrum, Bool> sample_from_primary(const Scene *scene,
+                                                  Sampler *sampler,
+                                                  const RayDifferential3f &ray,
+                                                  const SurfaceInteraction3f &si,
+                                                  const Medium * /* medium */,
+                                                  Float *aovs,
+                                                  Bool active) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::SamplingIntegratorSample, active);
+        return sample_path(scene, sampler, ray, nullptr, aovs, active, &si);
+    }
 
-        // --------------------- Configure loop state ----------------------
+    std::pair<Spectrum, Bool> sample_pixel(const Scene *scene,
+                                           Sampler *sampler,
+                                           const RayDifferential3f &ray,
+                                           const Vector2f &pos,
+                                           const Medium *medium,
+                                           Float *aovs,
+                                           Bool active) const override {
+        bool has_estimate = dr::width(m_pixel_estimate) > 0, staged = false;
+
+        /* Path splitting needs the staged implementation, which can run
+           within a regular wavefront (but not within a recorded loop). It
+           doesn't implement the cost counters */
+        if constexpr (dr::is_jit_v<Float> && !is_polarized_v<Spectrum>)
+            staged = m_max_depth > 0 && !m_cost_aovs &&
+                     (m_staged || (has_estimate && !jit_flag(JitFlag::LoopRecord)));
+
+        if (!has_estimate && !staged)
+            return sample(scene, sampler, ray, medium, aovs, active);
+
+        MI_MASKED_FUNCTION(ProfilerPhase::SamplingIntegratorSample, active);
+
+        // Look up the prepass estimate of the pixel
+        Float estimate = 0.f;
+        if (has_estimate) {
+            Vector2i p = dr::clamp(Vector2i(dr::floor(pos)) - m_estimate_offset,
+                                   ScalarVector2i(0), m_estimate_size - 1);
+            estimate = dr::gather<Float>(
+                m_pixel_estimate, UInt32(p.y() * m_estimate_size.x() + p.x()),
+                active);
+        }
+
+        if (staged)
+            return sample_staged(scene, sampler, ray,
+                                 has_estimate ? &estimate : nullptr, active);
+
+        return sample_path(scene, sampler, ray, &estimate, aovs, active);
+    }
 
-        Ray3f ray                     = Ray3f(ray_);
-        Spectrum throughput           = 1.f;
-        Spectrum result               = 0.f;
-        Float eta                     = 1.f;
-        UInt32 depth                  = 0;
+    /**
+     * \brief Estimate the radiance along a camera ray
+     *
+     * Uses adjoint-driven Russian roulette and splitting when the pixel
+     * estimate \c estimate is provided, and the throughput-based Russian
+     * roulette otherwise. When \c primary_si is provided, it is used as the
+     * first intersection of the path instead of tracing \c ray. The cost
+     * counters are written to \c aovs when they are enabled.
+     */
+    std::pair<Spectrum, Bool> sample_path(const Scene *scene,
+                                          Sampler *sampler,
+                                          const RayDifferential3f &ray,
+                                          const Float *estimate,
+                                          Float *aovs,
+                                          Bool active,
+                                          const SurfaceInteraction3f *primary_si = nullptr) const {
+        CostCounters cost;
+        if (unlikely(m_max_depth == 0)) {
+            if (m_cost_aovs)
+                Base::put_cost_aovs(aovs, cost);
+            return { 0.f, false };
+        }
 
         // If m_hide_emitters == false, the environment emitter will be visible
-        Mask valid_ray                = !m_hide_emitters && dr::neq(scene->environment(), nullptr);
+        Mask valid_ray = !m_hide_emitters && dr::neq(scene->environment(), nullptr);
+
+        Spectrum result = trace(scene, sampler, Ray3f(ray),
+                                /* throughput = */ 1.f, /* eta = */ 1.f,
+                                /* depth = */ 0, dr::zeros<Interaction3f>(),
+                                /* prev_bsdf_pdf = */ 1.f,
+                                /* prev_bsdf_delta = */ true, estimate,
+                                valid_ray, active, primary_si,
+                                m_cost_aovs ? &cost : nullptr);
+
+        if (m_cost_aovs)
+            Base::put_cost_aovs(aovs, cost);
+
+        return {
+            /* spec  = */ dr::select(valid_ray, result, 0.f),
+            /* valid = */ valid_ray
+        };
+    }
+
+    /**
+     * \brief Trace a path from the given loop state and return its radiance
+     *
+     * Besides being the main loop of \ref sample_path(), this function is
+     * invoked recursively for the additional continuations of split paths in
+     * scalar variants. The mask \c valid_ray is updated in place. The
+     * intersection \c primary_si, if provided, replaces the first ray
+     * intersection query of the path. It is ignored within recorded loops,
+     * whose body is traced only once for all iterations. The work performed
+     * by the path is added to \c cost, if provided.
+     */
+    Spectrum trace(const Scene *scene,
+                   Sampler *sampler,
+                   Ray3f ray,
+                   Spectrum throughput,
+                   Float eta,
+                   UInt32 depth,
+                   Interaction3f prev_si,
+                   Float prev_bsdf_pdf,
+                   Bool prev_bsdf_delta,
+                   const Float *estimate,
+                   Mask &valid_ray,
+                   Bool active,
+                   const SurfaceInteraction3f *primary_si = nullptr,
+                   CostCounters *cost = nullptr) const {
+        // --------------------- Configure loop state ----------------------
 
-        // Variables caching information from the previous bounce
-        Interaction3f prev_si         = dr::zeros<Interaction3f>();
-        Float         prev_bsdf_pdf   = 1.f;
-        Bool          prev_bsdf_delta = true;
-        BSDFContext   bsdf_ctx;
+        Spectrum result = 0.f;
+        BSDFContext bsdf_ctx;
 
         /* Set up a Dr.Jit loop. This optimizes away to a normal loop in scalar
            mode, and it generates either a a megakernel (default) or
@@ -126,27 +414,73 @@ public:
            passing the '-W' command line flag to the mitsuba binary or
            enabling/disabling the JitFlag.LoopRecord bit in Dr.Jit.
 
-           The first argument identifies the loop by name, which is helpful for
-           debugging. The subsequent list registers all variables that encode
-           the loop state variables. This is crucial: omitting a variable may
-           lead to undefined behavior. */
-        dr::Loop<Bool> loop("Path Tracer", sampler, ray, throughput, result,
-                            eta, depth, valid_ray, prev_si, prev_bsdf_pdf,
-                            prev_bsdf_delta, active);
+           The argument identifies the loop by name, which is helpful for
+           debugging. The subsequent calls to put() register all variables that
+           encode the loop state variables. This is crucial: omitting a
+           variable may lead to undefined behavior. */
+        dr::Loop<Bool> loop("Path Tracer");
+        loop.put(ray, throughput, result, eta, depth, valid_ray, prev_si,
+                 prev_bsdf_pdf, prev_bsdf_delta, active);
+        sampler->loop_put(loop);
+
+        // Counters of the path vertices and shadow rays (if requested)
+        UInt32 vertices = 0, shadow_rays = 0;
+        if (cost)
+            loop.put(vertices, shadow_rays);
+        loop.init();
 
         /* Inform the loop about the maximum number of loop iterations.
            This accelerates wavefront-style rendering by avoiding costly
            synchronization points that check the 'active' flag. */
         loop.set_max_iterations(m_max_depth);
 
+        /* Ray reordering requires access to the full wavefront between
+           bounces, which is only the case when the loop isn't recorded */
+        bool reorder = false;
+        if constexpr (dr::is_jit_v<Float>) {
+            if (m_reorder_rays) {
+                reorder = !jit_flag(JitFlag::LoopRecord);
+                if (!reorder)
+                    Log(Warn, "PathIntegrator: ray reordering requires "
+                              "wavefront mode (loop recording is enabled), "
+                              "ignoring the 'reorder_rays' parameter.");
+            }
+        }
+        // The same holds for grouping the lanes by BSDF
+        bool sort_bsdfs = false;
+        if constexpr (dr::is_jit_v<Float>) {
+            if (m_sort_bsdfs) {
+                sort_bsdfs = !jit_flag(JitFlag::LoopRecord);
+                if (!sort_bsdfs)
+                    Log(Warn, "PathIntegrator: sorting by BSDF requires "
+                              "wavefront mode (loop recording is enabled), "
+                              "ignoring the 'sort_bsdfs' parameter.");
+            }
+        }
+        if constexpr (dr::is_jit_v<Float>) {
+            if (jit_flag(JitFlag::LoopRecord))
+                primary_si = nullptr;
+        }
+
+        uint32_t iteration = 0;
+
         while (loop(active)) {
             /* dr::Loop implicitly masks all code in the loop using the 'active'
                flag, so there is no need to pass it to every function */
 
-            SurfaceInteraction3f si =
-                scene->ray_intersect(ray,
-                                     /* ray_flags = */ +RayFlags::All,
-                                     /* coherent = */ dr::eq(depth, 0u));
+            SurfaceInteraction3f si;
+            if (primary_si && iteration == 0)
+                si = *primary_si;
+            else if (reorder && iteration > 0)
+                si = ray_intersect_reordered(scene, ray, active);
+            else
+                si = scene->ray_intersect(ray,
+                                          /* ray_flags = */ +RayFlags::All,
+                                          /* coherent = */ dr::eq(depth, 0u));
+            iteration++;
+
+            if (cost)
+                vertices += dr::select(si.is_valid(), UInt32(1), UInt32(0));
 
             // ---------------------- Direct emission ----------------------
 
@@ -190,6 +524,10 @@ public:
             Spectrum em_weight = dr::zeros<Spectrum>();
             Vector3f wo = dr::zeros<Vector3f>();
 
+            // Number of emitter samples taken at this vertex
+            UInt32 em_count = emitter_sample_count(throughput);
+            Mask active_em_vertex = active_em;
+
             if (dr::any_or<true>(active_em)) {
                 // Sample the emitter
                 std::tie(ds, em_weight) = scene->sample_emitter_direction(
@@ -212,23 +550,48 @@ public:
             Float sample_1 = sampler->next_1d();
             Point2f sample_2 = sampler->next_2d();
 
-            auto [bsdf_val, bsdf_pdf, bsdf_sample, bsdf_weight]
-                = bsdf->eval_pdf_sample(bsdf_ctx, si, wo, sample_1, sample_2);
+            std::tuple<Spectrum, Float, BSDFSample3f, Spectrum> bsdf_result;
+            if (sort_bsdfs) {
+                auto [perm, inverse] = sort_by_bsdf(bsdf, active);
+                bsdf_result = call_permuted(
+                    perm, inverse,
+                    [&](const BSDFPtr &bsdf_p, const SurfaceInteraction3f &si_p,
+                        const Vector3f &wo_p, const Float &sample_1_p,
+                        const Point2f &sample_2_p, const Mask &active_p) {
+                        return bsdf_p->eval_pdf_sample(bsdf_ctx, si_p, wo_p, sample_1_p,
+                                                       sample_2_p, active_p);
+                    },
+                    bsdf, si, wo, sample_1, sample_2, active);
+            } else {
+                bsdf_result = bsdf->eval_pdf_sample(bsdf_ctx, si, wo, sample_1, sample_2);
+            }
+            auto [bsdf_val, bsdf_pdf, bsdf_sample, bsdf_weight] = bsdf_result;
 
             // --------------- Emitter sampling contribution ----------------
 
             if (dr::any_or<true>(active_em)) {
                 bsdf_val = si.to_world_mueller(bsdf_val, -wo, si.wi);
 
-                // Compute the MIS weight
-                Float mis_em =
-                    dr::select(ds.delta, 1.f, mis_weight(ds.pdf, bsdf_pdf));
+                // Compute the MIS weight (accounting for all emitter samples)
+                Float mis_em = dr::select(
+                    ds.delta, 1.f, mis_weight(ds.pdf * Float(em_count), bsdf_pdf));
 
                 // Accumulate, being careful with polarization (see spec_fma)
                 result[active_em] = spec_fma(
-                    throughput, bsdf_val * em_weight * mis_em, result);
+                    throughput,
+                    bsdf_val * em_weight * (mis_em / Float(em_count)), result);
             }
 
+            if (m_emitter_samples > 1 && dr::any_or<true>(active_em_vertex))
+                result[active_em_vertex] = spec_fma(
+                    throughput,
+                    extra_emitter_samples(scene, sampler, si, bsdf, bsdf_ctx,
+                                          em_count, active_em_vertex),
+                    result);
+
+            if (cost)
+                shadow_rays += dr::select(active_em_vertex, em_count, UInt32(0));
+
             // ---------------------- BSDF sampling ----------------------
 
             bsdf_weight = si.to_world_mueller(bsdf_weight, -bsdf_sample.wo, si.wi);
@@ -251,6 +614,9 @@ public:
 
             // ------ Update loop variables based on current interaction ------
 
+            Spectrum throughput_vertex = throughput;
+            Float eta_vertex = eta;
+
             throughput *= bsdf_weight;
             eta *= bsdf_sample.eta;
             valid_ray |= active && si.is_valid() &&
@@ -258,7 +624,9 @@ public:
 
             // Information about the current vertex needed by the next iteration
             prev_si = si;
-            prev_bsdf_pdf = bsdf_sample.pdf;
+            /* The power heuristic is invariant to scaling both PDFs, which
+               accounts for the emitter samples taken at this vertex */
+            prev_bsdf_pdf = bsdf_sample.pdf / Float(em_count);
             prev_bsdf_delta = has_flag(bsdf_sample.sampled_type, BSDFFlags::Delta);
 
             // -------------------- Stopping criterion ---------------------
@@ -267,9 +635,20 @@ public:
 
             Float throughput_max = dr::max(unpolarized_spectrum(throughput));
 
-            Float rr_prob = dr::minimum(throughput_max * dr::sqr(eta), .95f);
-            Mask rr_active = depth >= m_rr_depth,
-                 rr_continue = sampler->next_1d() < rr_prob;
+            Float rr_prob;
+            Mask rr_active;
+            UInt32 split = 1;
+            if (estimate) {
+                // Compare the vertex to the pixel estimate (no splits in JIT mode)
+                std::tie(rr_prob, split) = adrrs_decision(
+                    throughput_vertex, *estimate, !dr::is_jit_v<Float>);
+                rr_active = rr_prob < 1.f;
+                throughput *= dr::rcp(Float(split));
+            } else {
+                rr_prob = dr::minimum(throughput_max * dr::sqr(eta), .95f);
+                rr_active = depth >= m_rr_depth;
+            }
+            Mask rr_continue = sampler->next_1d() < rr_prob;
 
             /* Differentiable variants of the renderer require the the russian
                roulette sampling weight to be detached to avoid bias. This is a
@@ -278,12 +657,33 @@ public:
 
             active = active_next && (!rr_active || rr_continue) &&
                      dr::neq(throughput_max, 0.f);
+
+            if constexpr (!dr::is_jit_v<Float>) {
+                // Trace the remaining continuations of a split path
+                for (uint32_t k = 1; k < split && active_next; ++k) {
+                    auto [bs, bw] = bsdf->sample(bsdf_ctx, si, sampler->next_1d(),
+                                                 sampler->next_2d());
+                    if (!(bs.pdf > 0.f))
+                        continue;
+                    bw = si.to_world_mueller(bw, -bs.wo, si.wi);
+
+                    valid_ray |= !has_flag(bs.sampled_type, BSDFFlags::Null);
+                    result += trace(scene, sampler, si.spawn_ray(si.to_world(bs.wo)),
+                                    throughput_vertex * bw / (ScalarFloat) split,
+                                    eta_vertex * bs.eta, depth, si,
+                                    bs.pdf / Float(em_count),
+                                    has_flag(bs.sampled_type, BSDFFlags::Delta),
+                                    estimate, valid_ray, true, nullptr, cost);
+                }
+            }
         }
 
-        return {
-            /* spec  = */ dr::select(valid_ray, result, 0.f),
-            /* valid = */ valid_ray
-        };
+        if (cost) {
+            cost->vertices += vertices;
+            cost->shadow_rays += shadow_rays;
+        }
+
+        return result;
     }
 
     //! @}
@@ -292,8 +692,684 @@ public:
     std::string to_string() const override {
         return tfm::format("PathIntegrator[\n"
             "  max_depth = %u,\n"
-            "  rr_depth = %u\n"
-            "]", m_max_depth, m_rr_depth);
+            "  rr_depth = %u,\n"
+            "  reorder_rays = %s,\n"
+            "  sort_bsdfs = %s,\n"
+            "  emitter_samples = %u,\n"
+            "  adaptive_emitter_samples = %s,\n"
+            "  staged = %s,\n"
+            "  split_calls = %s,\n"
+            "  adrrs = %s,\n"
+            "  adrrs_spp = %u,\n"
+            "  adrrs_max_split = %u\n"
+            "]", m_max_depth, m_rr_depth, m_reorder_rays ? "true" : "false",
+            m_sort_bsdfs ? "true" : "false", m_emitter_samples,
+            m_adaptive_emitter_samples ? "true" : "false",
+            m_staged ? "true" : "false", m_split_calls ? "true" : "false",
+            m_adrrs ? "true" : "false", m_adrrs_spp, m_adrrs_max_split);
+    }
+
+    /**
+     * \brief Weight window of adjoint-driven Russian roulette and splitting
+     *
+     * Compares the expected contribution of a path vertex with the given
+     * throughput to the estimate of its pixel. Returns the survival
+     * probability and the number of continuations the path should be split
+     * into (always 1 unless \c allow_split is set).
+     */
+    std::pair<Float, UInt32> adrrs_decision(const Spectrum &throughput,
+                                            const Float &estimate,
+                                            bool allow_split) const {
+        // Ratio of the upper and lower bound of the window (as in the paper)
+        constexpr ScalarFloat WindowSize = 5.f;
+        constexpr ScalarFloat Lower = 2.f / (1.f + WindowSize),
+                              Upper = WindowSize * Lower;
+
+        /* Expected contribution relative to the pixel estimate. The mean
+           brightness of the prepass approximates the radiance arriving at
+           the vertex, so that a value of 1 corresponds to the window center. */
+        Float ratio = dr::detach(dr::mean(unpolarized_spectrum(throughput))) *
+                      m_adrrs_scale / estimate;
+
+        Float rr_prob = dr::select(ratio < Lower, ratio, 1.f);
+
+        UInt32 split = 1;
+        if (allow_split)
+            split = dr::select(
+                ratio > Upper,
+                dr::minimum(UInt32(dr::round(ratio)), m_adrrs_max_split), 1u);
+
+        return { rr_prob, split };
+    }
+
+    /**
+     * \brief Convert the developed prepass image into per-pixel estimates
+     *
+     * The image is averaged over its color channels and blurred with a 3x3
+     * box filter to reduce noise. Estimates are clamped from below to a small
+     * fraction of the mean brightness, so that the paths of (nearly) black
+     * pixels aren't split excessively.
+     */
+    void update_pixel_estimate(const Film *film, const TensorXf &image) {
+        size_t height = image.shape(0), width = image.shape(1),
+               channels = image.shape(2), pixel_count = width * height,
+               color_channels = channels >= 3 ? 3 : 1;
+
+        auto &&data = dr::migrate(image.array(), AllocType::Host);
+        if constexpr (dr::is_jit_v<Float>)
+            dr::sync_thread();
+        const ScalarFloat *ptr = data.data();
+
+        std::vector<ScalarFloat> value(pixel_count);
+        double sum = 0.0;
+        for (size_t i = 0; i < pixel_count; ++i) {
+            ScalarFloat v = 0.f;
+            for (size_t c = 0; c < color_channels; ++c)
+                v += ptr[i * channels + c];
+            v /= (ScalarFloat) color_channels;
+            value[i] = std::isfinite(v) ? std::max(v, 0.f) : 0.f;
+            sum += value[i];
+        }
+
+        ScalarFloat mean = (ScalarFloat) (sum / pixel_count);
+        if (!(mean > 0.f)) {
+            Log(Warn, "ADRRS: the prepass image is black, falling back to "
+                      "regular Russian roulette.");
+            m_pixel_estimate = FloatStorage();
+            return;
+        }
+
+        std::vector<ScalarFloat> estimate(pixel_count);
+        for (size_t y = 0; y < height; ++y) {
+            for (size_t x = 0; x < width; ++x) {
+                ScalarFloat v = 0.f;
+                uint32_t count = 0;
+                for (size_t yy = (y > 0 ? y - 1 : 0); yy <= std::min(y + 1, height - 1); ++yy) {
+                    for (size_t xx = (x > 0 ? x - 1 : 0); xx <= std::min(x + 1, width - 1); ++xx) {
+                        v += value[yy * width + xx];
+                        count++;
+                    }
+                }
+                estimate[y * width + x] = std::max(v / count, 1e-2f * mean);
+            }
+        }
+
+        m_pixel_estimate = dr::load<FloatStorage>(estimate.data(), pixel_count);
+        m_estimate_size = ScalarVector2i((int32_t) width, (int32_t) height);
+        m_estimate_offset = ScalarVector2i(film->crop_offset());
+        m_adrrs_scale = mean;
+    }
+
+    /**
+     * \brief Staged wavefront path tracer (JIT variants)
+     *
+     * Instead of a \c dr::Loop, this function runs an ordinary loop whose
+     * bounces are split into three stages that are each evaluated as
+     * separate kernels: ray intersection, next event estimation (including
+     * emission found by the previous bounce) and shading (BSDF sampling and
+     * path termination). After every bounce, terminated paths are removed
+     * from the queue of rays using \c dr::compress(), so later bounces don't
+     * pay for idle lanes. Contributions are accumulated into the lane of the
+     * camera ray that started the path.
+     *
+     * When a pixel estimate is provided, the queue is instead rebuilt from
+     * the copy counts of adjoint-driven Russian roulette and splitting (see
+     * \ref expand_lanes()), which also duplicates the lanes of split paths.
+     *
+     * Since lanes no longer match those of the sampler after the first
+     * compaction, all random numbers after the camera ray are drawn from a
+     * PCG32 instance carried by each path. Copies of a split path re-seed it
+     * with a different stream. The time spent in each stage is logged at the
+     * end (log level \c Debug).
+     *
+     * When \c split_calls is set, method calls on plugin instances are
+     * evaluated one instance at a time, which gives each plugin a separate
+     * (and separately cached) kernel.
+     */
+    std::pair<Spectrum, Bool> sample_staged(const Scene *scene,
+                                            Sampler *sampler,
+                                            const RayDifferential3f &ray_,
+                                            const Float *estimate_,
+                                            Bool active) const {
+        if constexpr (dr::is_jit_v<Float> && !is_polarized_v<Spectrum>) {
+            uint32_t size = (uint32_t) dr::width(ray_);
+            constexpr size_t Channels = dr::size_v<UnpolarizedSpectrum>;
+
+            // Don't record the calls to all instances into a single kernel
+            dr::scoped_set_flag split_scope(
+                JitFlag::VCallRecord,
+                jit_flag(JitFlag::VCallRecord) && !m_split_calls);
+
+            // Per-camera-ray accumulators that are written using the 'origin' lane
+            Float result_buf = dr::zeros<Float>(size * Channels);
+            Mask valid_ray = dr::full<Mask>(
+                !m_hide_emitters && scene->environment() != nullptr, size);
+
+            // Path state, the width changes with every compaction
+            UInt32 origin = dr::arange<UInt32>(size);
+            Ray3f ray = Ray3f(ray_);
+            Spectrum throughput = dr::full<Spectrum>(1.f, size);
+            Float eta = dr::full<Float>(1.f, size),
+                  estimate = dr::zeros<Float>(size);
+            UInt32 depth = dr::zeros<UInt32>(size);
+            Interaction3f prev_si = dr::zeros<Interaction3f>(size);
+            Float prev_bsdf_pdf = dr::full<Float>(1.f, size);
+            Mask prev_bsdf_delta = dr::full<Mask>(true, size);
+            BSDFContext bsdf_ctx;
+
+            if (estimate_)
+                estimate += *estimate_;
+
+            PCG32 rng;
+            rng.seed(1, UInt64(UInt32(sampler->next_1d(active) * 4294967296.f)),
+                     UInt64(origin));
+
+            auto next_2d = [&rng]() {
+                Float x = rng.template next_float<Float>();
+                return Point2f(x, rng.template next_float<Float>());
+            };
+
+            // Time spent in the individual stages (in milliseconds)
+            enum Stage { Intersect, NextEvent, Shade, Compact, StageCount };
+            size_t stage_time[StageCount] = { };
+            Timer timer;
+            std::vector<uint32_t> queue_size;
+
+            // Drop the inactive camera rays before the first bounce
+            Mask alive = active && dr::full<Mask>(true, size);
+            dr::eval(alive, rng.state, rng.inc, estimate);
+            UInt32 index = dr::compress(alive), copy;
+            gather_state(index, origin, ray, throughput, eta, estimate, depth,
+                         prev_si, prev_bsdf_pdf, prev_bsdf_delta, rng);
+            stage_time[Compact] += timer.reset();
+
+            while (dr::width(index) > 0) {
+                queue_size.push_back((uint32_t) dr::width(index));
+
+                // ---------------------- Intersection ----------------------
+
+                SurfaceInteraction3f si = scene->ray_intersect(
+                    ray, +RayFlags::All, /* coherent = */ dr::eq(depth, 0u));
+                dr::eval(si);
+                stage_time[Intersect] += timer.reset();
+
+                // ------------------ Next event estimation -------------------
+
+                if (dr::any_or<true>(dr::neq(si.emitter(scene), nullptr))) {
+                    DirectionSample3f ds(scene, si, prev_si);
+                    Float em_pdf = 0.f;
+
+                    if (dr::any_or<true>(!prev_bsdf_delta))
+                        em_pdf = scene->pdf_emitter_direction(prev_si, ds,
+                                                              !prev_bsdf_delta);
+
+                    Float mis_bsdf = mis_weight(prev_bsdf_pdf, em_pdf);
+                    Spectrum value = throughput * mis_bsdf *
+                        ds.emitter->eval(si, prev_bsdf_pdf > 0.f);
+                    dr::scatter_reduce(ReduceOp::Add, result_buf, value, origin);
+                }
+
+                Mask active_next = (depth + 1 < m_max_depth) && si.is_valid();
+                BSDFPtr bsdf = si.bsdf(ray);
+
+                dr::scatter(valid_ray, Mask(true), origin,
+                            si.is_valid() &&
+                                dr::neq(bsdf->flags(), (uint32_t) BSDFFlags::Null));
+
+                Mask active_em = active_next && has_flag(bsdf->flags(), BSDFFlags::Smooth);
+
+                // Permutation that groups the lanes by BSDF (if enabled)
+                UInt32 perm, inverse;
+                if (m_sort_bsdfs)
+                    std::tie(perm, inverse) = sort_by_bsdf(bsdf, active_next);
+
+                UInt32 em_count = emitter_sample_count(throughput);
+
+                if (dr::any_or<true>(active_em) && m_emitter_samples > 1) {
+                    /* Replicate the lanes once per emitter sample, so that a
+                       single ray test traces the shadow rays of all samples */
+                    uint32_t n = m_emitter_samples,
+                             width = (uint32_t) dr::width(index);
+                    UInt32 lane = dr::arange<UInt32>(width * n),
+                           src = lane / n,
+                           slot = lane - src * n,
+                           dst = dr::arange<UInt32>(width) * n;
+
+                    Point2f sample_em(dr::empty<Float>(width * n),
+                                      dr::empty<Float>(width * n));
+                    for (uint32_t k = 0; k < n; ++k) {
+                        Point2f sample_k = next_2d();
+                        dr::scatter(sample_em.x(), sample_k.x(), dst + k);
+                        dr::scatter(sample_em.y(), sample_k.y(), dst + k);
+                    }
+
+                    SurfaceInteraction3f si_em = dr::gather<SurfaceInteraction3f>(si, src);
+                    BSDFPtr bsdf_em = dr::gather<BSDFPtr>(bsdf, src);
+                    Float count_em = Float(dr::gather<UInt32>(em_count, src));
+                    Mask active_e = dr::gather<Mask>(active_em, src) &&
+                                    slot < dr::gather<UInt32>(em_count, src);
+
+                    auto [ds, em_weight] = scene->sample_emitter_direction(
+                        si_em, sample_em, true, active_e);
+                    active_e &= dr::neq(ds.pdf, 0.f);
+
+                    Vector3f wo = si_em.to_local(ds.d);
+                    auto [bsdf_val, bsdf_pdf] =
+                        bsdf_em->eval_pdf(bsdf_ctx, si_em, wo, active_e);
+
+                    Float mis_em = dr::select(
+                        ds.delta, 1.f, mis_weight(ds.pdf * count_em, bsdf_pdf));
+                    dr::scatter_reduce(
+                        ReduceOp::Add, result_buf,
+                        dr::gather<Spectrum>(throughput, src) * bsdf_val *
+                            em_weight * (mis_em / count_em),
+                        dr::gather<UInt32>(origin, src), active_e);
+                } else if (dr::any_or<true>(active_em)) {
+                    auto [ds, em_weight] = scene->sample_emitter_direction(
+                        si, next_2d(), true, active_em);
+                    active_em &= dr::neq(ds.pdf, 0.f);
+
+                    Vector3f wo = si.to_local(ds.d);
+                    Spectrum bsdf_val;
+                    Float bsdf_pdf;
+                    if (m_sort_bsdfs)
+                        std::tie(bsdf_val, bsdf_pdf) = call_permuted(
+                            perm, inverse,
+                            [&](const BSDFPtr &bsdf_p, const SurfaceInteraction3f &si_p,
+                                const Vector3f &wo_p, const Mask &active_p) {
+                                return bsdf_p->eval_pdf(bsdf_ctx, si_p, wo_p, active_p);
+                            },
+                            bsdf, si, wo, active_em);
+                    else
+                        std::tie(bsdf_val, bsdf_pdf) =
+                            bsdf->eval_pdf(bsdf_ctx, si, wo, active_em);
+
+                    Float mis_em =
+                        dr::select(ds.delta, 1.f, mis_weight(ds.pdf, bsdf_pdf));
+                    dr::scatter_reduce(ReduceOp::Add, result_buf,
+                                       throughput * bsdf_val * em_weight * mis_em,
+                                       origin, active_em);
+                }
+
+                dr::eval(result_buf, valid_ray, rng.state, rng.inc);
+                stage_time[NextEvent] += timer.reset();
+
+                // ------------------------- Shading --------------------------
+
+                Float sample_1 = rng.template next_float<Float>();
+                Point2f sample_2 = next_2d();
+                BSDFSample3f bsdf_sample;
+                Spectrum bsdf_weight;
+                if (m_sort_bsdfs)
+                    std::tie(bsdf_sample, bsdf_weight) = call_permuted(
+                        perm, inverse,
+                        [&](const BSDFPtr &bsdf_p, const SurfaceInteraction3f &si_p,
+                            const Float &sample_1_p, const Point2f &sample_2_p,
+                            const Mask &active_p) {
+                            return bsdf_p->sample(bsdf_ctx, si_p, sample_1_p,
+                                                  sample_2_p, active_p);
+                        },
+                        bsdf, si, sample_1, sample_2, active_next);
+                else
+                    std::tie(bsdf_sample, bsdf_weight) =
+                        bsdf->sample(bsdf_ctx, si, sample_1, sample_2, active_next);
+
+                Spectrum throughput_vertex = throughput;
+                Float eta_vertex = eta;
+                throughput *= bsdf_weight;
+                eta *= bsdf_sample.eta;
+
+                // Decide how many copies of each path continue
+                UInt32 count;
+                if (estimate_) {
+                    auto [rr_prob, split] =
+                        adrrs_decision(throughput_vertex, estimate, true);
+                    Mask survive = active_next &&
+                                   rng.template next_float<Float>() < rr_prob &&
+                                   dr::neq(dr::max(throughput_vertex), 0.f);
+                    // The sampled direction is only used by the first copy
+                    throughput_vertex *= dr::select(
+                        survive, dr::rcp(rr_prob * Float(split)), 0.f);
+                    throughput = throughput_vertex * bsdf_weight;
+                    count = dr::select(survive, split, 0u);
+                } else {
+                    Float throughput_max = dr::max(throughput);
+                    Float rr_prob = dr::minimum(throughput_max * dr::sqr(eta), .95f);
+                    Mask rr_active = depth + 1 >= m_rr_depth,
+                         rr_continue = rng.template next_float<Float>() < rr_prob;
+                    dr::masked(throughput, rr_active) *= dr::rcp(rr_prob);
+                    count = dr::select(
+                        active_next && (!rr_active || rr_continue) &&
+                            dr::neq(throughput_max, 0.f), 1u, 0u);
+                }
+
+                ray = si.spawn_ray(si.to_world(bsdf_sample.wo));
+                depth += 1;
+                prev_si = si;
+                prev_bsdf_pdf = bsdf_sample.pdf / Float(em_count);
+                prev_bsdf_delta = has_flag(bsdf_sample.sampled_type, BSDFFlags::Delta);
+
+                dr::eval(count, ray, throughput, eta, depth, prev_si,
+                         prev_bsdf_pdf, prev_bsdf_delta, rng.state, rng.inc);
+                if (estimate_)
+                    dr::eval(throughput_vertex, eta_vertex);
+                stage_time[Shade] += timer.reset();
+
+                // ------------------------ Compaction ------------------------
+
+                if (!estimate_) {
+                    index = dr::compress(dr::neq(count, 0u));
+                    gather_state(index, origin, ray, throughput, eta, depth,
+                                 prev_si, prev_bsdf_pdf, prev_bsdf_delta, rng);
+                } else {
+                    std::tie(index, copy) = expand_lanes(count);
+                    gather_state(index, origin, ray, throughput,
+                                 throughput_vertex, eta, eta_vertex, estimate,
+                                 depth, prev_si, prev_bsdf_pdf,
+                                 prev_bsdf_delta, si, rng);
+
+                    /* Copies of a split path continue with a fresh random
+                       stream and resample the direction at the current vertex */
+                    Mask fresh = dr::neq(copy, 0u);
+                    if (dr::any(fresh)) {
+                        PCG32 rng_fresh;
+                        rng_fresh.seed(1, UInt64(rng.next_uint32()),
+                                       UInt64(dr::arange<UInt32>((uint32_t) dr::width(index))));
+                        dr::masked(rng.state, fresh) = rng_fresh.state;
+                        dr::masked(rng.inc, fresh) = rng_fresh.inc;
+
+                        BSDFPtr bsdf_fresh = si.bsdf();
+                        Float sample_1_fresh = rng.template next_float<Float>();
+                        auto [bs, bw] = bsdf_fresh->sample(
+                            bsdf_ctx, si, sample_1_fresh, next_2d(), fresh);
+
+                        dr::masked(ray, fresh) = si.spawn_ray(si.to_world(bs.wo));
+                        dr::masked(throughput, fresh) = throughput_vertex * bw;
+                        dr::masked(eta, fresh) = eta_vertex * bs.eta;
+                        dr::masked(prev_bsdf_pdf, fresh) =
+                            bs.pdf / Float(dr::gather<UInt32>(em_count, index));
+                        dr::masked(prev_bsdf_delta, fresh) =
+                            has_flag(bs.sampled_type, BSDFFlags::Delta);
+                    }
+                }
+
+                dr::eval(index, origin, ray, throughput, eta, estimate, depth,
+                         prev_si, prev_bsdf_pdf, prev_bsdf_delta, rng.state,
+                         rng.inc);
+                stage_time[Compact] += timer.reset();
+            }
+
+            std::string sizes;
+            for (size_t i = 0; i < queue_size.size(); ++i)
+                sizes += (i > 0 ? ", " : "") + std::to_string(queue_size[i]);
+
+            Log(Debug, "Staged wavefront: %u bounces, intersect %s, next event "
+                       "%s, shade %s, compaction %s (queue sizes: %s)",
+                (uint32_t) queue_size.size(),
+                util::time_string((float) stage_time[Intersect]),
+                util::time_string((float) stage_time[NextEvent]),
+                util::time_string((float) stage_time[Shade]),
+                util::time_string((float) stage_time[Compact]), sizes);
+
+            Spectrum result =
+                dr::gather<Spectrum>(result_buf, dr::arange<UInt32>(size));
+
+            return {
+                /* spec  = */ dr::select(valid_ray, result, 0.f),
+                /* valid = */ valid_ray
+            };
+        } else {
+            DRJIT_MARK_USED(scene);
+            DRJIT_MARK_USED(sampler);
+            DRJIT_MARK_USED(ray_);
+            DRJIT_MARK_USED(estimate_);
+            DRJIT_MARK_USED(active);
+            Throw("sample_staged(): only supported in unpolarized JIT variants.");
+        }
+    }
+
+    /**
+     * \brief Expand per-lane copy counts into a list of source lanes
+     *
+     * Returns the index of the source lane of every entry in the new
+     * wavefront, and the number of the copy (0 for the first one).
+     */
+    std::pair<UInt32, UInt32> expand_lanes(const UInt32 &count) const {
+        dr::eval(count);
+        auto &&count_host = dr::migrate(count, AllocType::Host);
+        if constexpr (dr::is_jit_v<Float>)
+            dr::sync_thread();
+        const uint32_t *count_ptr = (const uint32_t *) count_host.data();
+
+        std::vector<uint32_t> index, copy;
+        size_t n = dr::width(count);
+        for (size_t i = 0; i < n; ++i) {
+            for (uint32_t k = 0; k < count_ptr[i]; ++k) {
+                index.push_back((uint32_t) i);
+                copy.push_back(k);
+            }
+        }
+
+        return { dr::load<UInt32>(index.data(), index.size()),
+                 dr::load<UInt32>(copy.data(), copy.size()) };
+    }
+
+    /// Gather the given state variables (and PCG32 instances) from \c index
+    template <typename... Ts>
+    void gather_state(const UInt32 &index, Ts &...values) const {
+        auto gather_one = [&index](auto &value) {
+            using T = std::decay_t<decltype(value)>;
+            if constexpr (std::is_same_v<T, PCG32>) {
+                value.state = dr::gather<UInt64>(value.state, index);
+                value.inc   = dr::gather<UInt64>(value.inc, index);
+            } else {
+                value = dr::gather<T>(value, index);
+            }
+        };
+        (gather_one(values), ...);
+    }
+
+    /**
+     * \brief Intersect a wavefront of rays after sorting them for coherence
+     *
+     * Active rays are bucketed by direction octant and then by a coarse Morton
+     * code of their origin within the scene bounds. The sorted rays are traced
+     * and the preliminary intersections are moved back to their original
+     * lanes, so the result matches an ordinary call to \ref
+     * Scene::ray_intersect(). This must only be called in wavefront mode.
+     */
+    SurfaceInteraction3f ray_intersect_reordered(const Scene *scene,
+                                                 const Ray3f &ray,
+                                                 Mask active) const {
+        if constexpr (dr::is_jit_v<Float>) {
+            constexpr uint32_t MortonBits  = 3,
+                               CellCount   = 1u << MortonBits,
+                               BucketCount = (8u << (3 * MortonBits)) + 1;
+            constexpr JitBackend Backend = dr::is_cuda_v<Float>
+                                               ? JitBackend::CUDA
+                                               : JitBackend::LLVM;
+
+            // Grid cell of the ray origin within the scene bounds
+            const ScalarBoundingBox3f &bbox = scene->bbox();
+            ScalarVector3f scale =
+                dr::select(bbox.extents() > 0.f,
+                           ScalarFloat(CellCount) / bbox.extents(), 0.f);
+            Vector3u cell = Vector3u(dr::clamp(
+                Vector3i((ray.o - bbox.min) * scale), 0, (int32_t) CellCount - 1));
+
+            // Interleave the cell coordinates, the octant forms the upper bits
+            UInt32 key = dr::select(ray.d.x() < 0.f, 1u, 0u) |
+                         dr::select(ray.d.y() < 0.f, 2u, 0u) |
+                         dr::select(ray.d.z() < 0.f, 4u, 0u);
+            key <<= 3 * MortonBits;
+            for (uint32_t i = 0; i < MortonBits; ++i)
+                for (uint32_t j = 0; j < 3; ++j)
+                    key |= ((cell[j] >> i) & 1u) << (3 * i + j);
+
+            // Inactive lanes go into a separate bucket at the end
+            key = dr::select(active, key, BucketCount - 1);
+            dr::eval(key);
+
+            uint32_t size = (uint32_t) dr::width(key);
+            UInt32 perm = dr::empty<UInt32>(size);
+            uint32_t *offsets = (uint32_t *) jit_malloc(
+                dr::is_cuda_v<Float> ? AllocType::HostPinned : AllocType::Host,
+                (BucketCount * 4 + 1) * sizeof(uint32_t));
+            jit_mkperm(Backend, key.data(), size, BucketCount, perm.data(), offsets);
+            jit_free(offsets);
+
+            /* The loop masks gathers and scatters using the state of the
+               current lane, which is meaningless for the permuted arrays.
+               Temporarily replace it with an all-true mask. */
+            Mask all_lanes = dr::full<Mask>(true, size);
+            jit_var_mask_push(Backend, all_lanes.index(), 0);
+
+            Ray3f ray_sorted   = dr::gather<Ray3f>(ray, perm);
+            Mask active_sorted = dr::gather<Mask>(active, perm);
+
+            PreliminaryIntersection3f pi_sorted = scene->ray_intersect_preliminary(
+                ray_sorted, /* coherent = */ true, active_sorted);
+
+            UInt32 inverse = dr::empty<UInt32>(size);
+            dr::scatter(inverse, dr::arange<UInt32>(size), perm);
+            PreliminaryIntersection3f pi =
+                dr::gather<PreliminaryIntersection3f>(pi_sorted, inverse);
+
+            jit_var_mask_pop(Backend);
+
+            return pi.compute_surface_interaction(ray, +RayFlags::All, active);
+        } else {
+            return scene->ray_intersect(ray, +RayFlags::All, false, active);
+        }
+    }
+
+    /**
+     * \brief Compute a permutation that groups the lanes of a wavefront by BSDF
+     *
+     * The lanes are sorted by the registry ID of their BSDF using a counting
+     * sort, so that every BSDF processes a contiguous range of lanes.
+     * Inactive lanes are moved to the front. Returns the permutation and its
+     * inverse. This must only be called in wavefront mode.
+     */
+    std::pair<UInt32, UInt32> sort_by_bsdf(const BSDFPtr &bsdf,
+                                           const Mask &active) const {
+        if constexpr (dr::is_jit_v<Float>) {
+            constexpr JitBackend Backend = dr::is_cuda_v<Float>
+                                               ? JitBackend::CUDA
+                                               : JitBackend::LLVM;
+
+            // ID 0 is reserved for null pointers
+            UInt32 key = dr::select(active, dr::reinterpret_array<UInt32>(bsdf), 0u);
+            dr::eval(key);
+
+            uint32_t size = (uint32_t) dr::width(key),
+                     bucket_count = jit_registry_get_max(
+                         Backend, BSDFPtr::CallSupport::Domain) + 1;
+            UInt32 perm = dr::empty<UInt32>(size);
+            uint32_t *offsets = (uint32_t *) jit_malloc(
+                dr::is_cuda_v<Float> ? AllocType::HostPinned : AllocType::Host,
+                (bucket_count * 4 + 1) * sizeof(uint32_t));
+            jit_mkperm(Backend, key.data(), size, bucket_count, perm.data(), offsets);
+            jit_free(offsets);
+
+            UInt32 inverse = dr::empty<UInt32>(size);
+            dr::scatter(inverse, dr::arange<UInt32>(size), perm);
+            return { perm, inverse };
+        } else {
+            DRJIT_MARK_USED(bsdf);
+            DRJIT_MARK_USED(active);
+            Throw("sort_by_bsdf(): only supported in JIT variants.");
+        }
+    }
+
+    /**
+     * \brief Invoke \c func on the arguments permuted by \c perm, and move
+     * the elements of the resulting (tuple-like) value back to their lanes
+     */
+    template <typename Func, typename... Args>
+    auto call_permuted(const UInt32 &perm, const UInt32 &inverse, Func &&func,
+                       const Args &...args) const {
+        if constexpr (dr::is_jit_v<Float>) {
+            constexpr JitBackend Backend = dr::is_cuda_v<Float>
+                                               ? JitBackend::CUDA
+                                               : JitBackend::LLVM;
+
+            /* As in ray_intersect_reordered(), the mask of the loop doesn't
+               apply to the permuted arrays */
+            Mask all_lanes = dr::full<Mask>(true, dr::width(perm));
+            jit_var_mask_push(Backend, all_lanes.index(), 0);
+
+            auto result_p = func(dr::gather<Args>(args, perm)...);
+            auto result = std::apply(
+                [&](const auto &...values) {
+                    return std::make_tuple(
+                        dr::gather<std::decay_t<decltype(values)>>(values, inverse)...);
+                },
+                result_p);
+
+            jit_var_mask_pop(Backend);
+            return result;
+        } else {
+            DRJIT_MARK_USED(perm);
+            DRJIT_MARK_USED(inverse);
+            return func(args...);
+        }
+    }
+
+    /**
+     * \brief Number of emitter samples of a vertex with the given path
+     * throughput (see \c emitter_samples and \c adaptive_emitter_samples)
+     */
+    UInt32 emitter_sample_count(const Spectrum &throughput) const {
+        if (!m_adaptive_emitter_samples)
+            return dr::full<UInt32>(m_emitter_samples, dr::width(throughput));
+
+        Float t = dr::detach(dr::max(unpolarized_spectrum(throughput)));
+        UInt32 count = UInt32(dr::ceil(
+            dr::clamp(t, 0.f, 1.f) * (ScalarFloat) m_emitter_samples));
+        return dr::maximum(count, 1u);
+    }
+
+    /**
+     * \brief Take the emitter samples \c 1, ..., <tt>count - 1</tt> of a
+     * vertex and return the sum of their MIS-weighted contributions
+     *
+     * The first sample is combined with BSDF sampling by the caller. Every
+     * sample is divided by \c count.
+     */
+    Spectrum extra_emitter_samples(const Scene *scene, Sampler *sampler,
+                                   const SurfaceInteraction3f &si,
+                                   const BSDFPtr &bsdf,
+                                   const BSDFContext &bsdf_ctx,
+                                   const UInt32 &count, Mask active) const {
+        Spectrum result = 0.f;
+
+        for (uint32_t i = 1; i < m_emitter_samples; ++i) {
+            Mask active_i = active && i < count;
+            if (dr::none_or<false>(active_i))
+                break; // early exit for scalar mode
+
+            auto [ds, em_weight] = scene->sample_emitter_direction(
+                si, sampler->next_2d(), true, active_i);
+            active_i &= dr::neq(ds.pdf, 0.f);
+
+            // Recompute the contribution with AD (see the first sample)
+            if (dr::grad_enabled(si.p)) {
+                ds.d = dr::normalize(ds.p - si.p);
+                Spectrum em_val = scene->eval_emitter_direction(si, ds, active_i);
+                em_weight = dr::select(dr::neq(ds.pdf, 0), em_val / ds.pdf, 0);
+            }
+
+            Vector3f wo = si.to_local(ds.d);
+            auto [bsdf_val, bsdf_pdf] = bsdf->eval_pdf(bsdf_ctx, si, wo, active_i);
+            bsdf_val = si.to_world_mueller(bsdf_val, -wo, si.wi);
+
+            Float mis_em = dr::select(
+                ds.delta, 1.f, mis_weight(ds.pdf * Float(count), bsdf_pdf));
+            result[active_i] += bsdf_val * em_weight * (mis_em / Float(count));
+        }
+
+        return result;
     }
 
     /// Compute a multiple importance sampling weight using the power heuristic
@@ -316,7 +1392,35 @@ public:
             return dr::fmadd(a, b, c);
     }
 
+    bool has_cost_counters() const override { return true; }
+
     MI_DECLARE_CLASS()
+private:
+    bool m_reorder_rays;
+    /// Group the lanes of a wavefront by BSDF before shading?
+    bool m_sort_bsdfs;
+    /// Trace paths using \ref sample_staged() in JIT variants?
+    bool m_staged;
+    /// Evaluate the calls of \ref sample_staged() one instance at a time?
+    bool m_split_calls;
+
+    /// Number of emitter samples per path vertex
+    uint32_t m_emitter_samples;
+    /// Scale the number of emitter samples by the path throughput?
+    bool m_adaptive_emitter_samples;
+
+    /// Use adjoint-driven Russian roulette and splitting?
+    bool m_adrrs;
+    /// Samples per pixel of the ADRRS prepass
+    uint32_t m_adrrs_spp;
+    /// Largest number of continuations of a split path
+    uint32_t m_adrrs_max_split;
+
+    /// Per-pixel estimates of the current render (empty outside of it)
+    FloatStorage m_pixel_estimate;
+    ScalarVector2i m_estimate_size, m_estimate_offset;
+    /// Mean brightness of the prepass image
+    ScalarFloat m_adrrs_scale;
 };
 
 MI_IMPLEMENT_CLASS_VARIANT(PathIntegrator, MonteCarloIntegrator)
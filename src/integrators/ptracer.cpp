@@ -37,6 +37,14 @@ Particle tracer (:monosp:`ptracer`)
    - If specified, divides the workload in successive passes with :paramtype:`samples_per_pass`
      samples per pixel.
 
+ * - splat_replicas
+   - |int|
+   - Number of copies of the image that the contributions are spread over in JIT variants.
+     Light paths are connected to random positions on the film, whose accumulation uses atomic
+     memory operations. When many of them target the same pixels (e.g. a focused caustic), these
+     operations contend, which is reduced by splatting into several copies that are summed
+     at the end. Higher values require proportionally more memory. (Default: 4)
+
 This integrator traces rays starting from light sources and attempts to connect them
 to the sensor at each bounce.
 It does not support media (volumes).
@@ -0,0 +1,531 @@
+#include <atomic>
+#include <mitsuba/core/math.h>
+#include <mitsuba/core/plugin.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/random.h>
+#include <mitsuba/core/ray.h>
+#include <mitsuba/render/bsdf.h>
+#include <mitsuba/render/emitter.h>
+#include <mitsuba/render/film.h>
+#include <mitsuba/render/imageblock.h>
+#include <mitsuba/render/integrator.h>
+#include <mitsuba/render/records.h>
+#include <mitsuba/render/sampler.h>
+#include <mitsuba/render/sensor.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**!
+
+.. _integrator-radiance_cache:
+
+Radiance cache (:monosp:`radiance_cache`)
+-----------------------------------------
+
+.. pluginparameters::
+
+ * - max_depth
+   - |int|
+   - Specifies the longest path depth in the generated output image (where -1
+     corresponds to :math:`\infty`). (Default: -1)
+
+ * - rr_depth
+   - |int|
+   - Specifies the path depth, at which the implementation will begin to use
+     the *russian roulette* path termination criterion. (Default: 5)
+
+ * - hide_emitters
+   - |bool|
+   - Hide directly visible emitters. (Default: no, i.e. |false|)
+
+ * - samples_per_pass
+   - |int|
+   - Number of samples per pixel rendered in every pass. The cache is updated
+     in between passes, and the total sample count of the sensor's sampler
+     determines the number of passes. (Default: 4)
+
+ * - cell_size
+   - |float|
+   - Edge length of the cache cells. The default value of zero selects 1/100
+     of the diagonal of the scene's bounding box. (Default: 0)
+
+ * - cache_size
+   - |int|
+   - Number of entries of the hash table storing the cache, rounded up to the
+     next power of two. (Default: 1048576)
+
+ * - train_fraction
+   - |float|
+   - Fraction of the paths that ignore the cache and continue to update it,
+     even when the cache already holds an estimate. (Default: 0.1)
+
+ * - min_samples
+   - |int|
+   - Number of training samples a cache cell must have received before it is
+     used. (Default: 4)
+
+This integrator is a fast, *biased* variant of the :ref:`path tracer
+<integrator-path>` meant for previews of scenes with substantial diffuse
+interreflection. It caches the radiance reflected by surfaces in a hash grid
+over world space, where every cell additionally distinguishes the octant of
+the surface normal. Camera paths follow delta interactions until the first
+smooth surface, where they account for direct illumination using multiple
+importance sampling and sample one more direction using the BSDF. At the next
+smooth surface, they terminate and look up the reflected radiance in the
+cache instead of tracing the remainder of the path.
+
+The cache is built progressively: a small fraction of the paths
+(``train_fraction``), as well as all paths reaching cells with fewer than
+``min_samples`` samples, continue as regular path tracing and record the
+radiance reflected at the lookup point into the cache. The samples recorded
+during one pass become visible to the next one. The first pass therefore
+corresponds to a regular path tracer, while the following passes mostly trace
+paths of length two.
+
+The cache stores the average over all directions and positions within a cell,
+which blurs glossy indirect reflections and indirect illumination varying at
+scales below ``cell_size``. The image converges to a biased solution as the
+sample count grows, and the bias shrinks with the cell size (at the cost of
+more training samples).
+
+.. note:: This integrator does not support participating media, and it is not
+   available in spectral and polarized variants.
+
+.. tabs::
+    .. code-tab::  xml
+        :name: radiance-cache-integrator
+
+        <integrator type="radiance_cache">
+            <float name="cell_size" value="0.05"/>
+        </integrator>
+
+    .. code-tab:: python
+
+        'type': 'radiance_cache',
+        'cell_size': 0.05
+
+ */
+
+/// Atomically add a value to a floating point variable
+inline void atomic_add(std::atomic<float> &dst, float value) {
+    float current = dst.load(std::memory_order_relaxed);
+    while (!dst.compare_exchange_weak(current, current + value,
+                                      std::memory_order_relaxed))
+        ;
+}
+
+template <typename Float, typename Spectrum>
+class RadianceCacheIntegrator : public MonteCarloIntegrator<Float, Spectrum> {
+public:
+    MI_IMPORT_BASE(MonteCarloIntegrator, m_max_depth, m_rr_depth,
+                   m_hide_emitters, m_stop)
+    MI_IMPORT_TYPES(Scene, Sensor, Film, Sampler, ImageBlock, Medium, Emitter,
+                    EmitterPtr, BSDF, BSDFPtr)
+
+    using FloatStorage = DynamicBuffer<Float>;
+    static constexpr size_t Channels = UnpolarizedSpectrum::Size;
+
+    RadianceCacheIntegrator(const Properties &props) : Base(props) {
+        if constexpr (is_spectral_v<Spectrum> || is_polarized_v<Spectrum>)
+            Throw("The radiance cache is not supported in spectral and "
+                  "polarized variants.");
+
+        m_samples_per_pass = props.get<uint32_t>("samples_per_pass", 4);
+        if (m_samples_per_pass == 0)
+            Throw("\"samples_per_pass\" must be positive.");
+
+        m_cell_size = props.get<ScalarFloat>("cell_size", 0.f);
+        if (m_cell_size < 0.f)
+            Throw("\"cell_size\" must be non-negative.");
+
+        uint32_t cache_size = props.get<uint32_t>("cache_size", 1u << 20);
+        if (cache_size == 0)
+            Throw("\"cache_size\" must be positive.");
+        m_table_size = math::round_to_power_of_two(cache_size);
+
+        m_train_fraction = props.get<ScalarFloat>("train_fraction", .1f);
+        if (!(m_train_fraction > 0.f && m_train_fraction <= 1.f))
+            Throw("\"train_fraction\" must be in (0, 1].");
+
+        m_min_samples = props.get<uint32_t>("min_samples", 4);
+    }
+
+    TensorXf render(Scene *scene,
+                    Sensor *sensor,
+                    uint32_t seed = 0,
+                    uint32_t spp = 0,
+                    bool develop = true,
+                    bool evaluate = true) override {
+        Film *film = sensor->film();
+
+        if (spp == 0)
+            spp = sensor->sampler()->sample_count();
+        uint32_t spp_per_pass = std::min(spp, m_samples_per_pass),
+                 n_passes     = (spp + spp_per_pass - 1) / spp_per_pass;
+
+        ScalarBoundingBox3f bbox = scene->bbox();
+        ScalarFloat cell_size = m_cell_size > 0.f
+                                    ? m_cell_size
+                                    : dr::norm(bbox.extents()) / 100.f;
+        m_origin = bbox.min;
+        m_inv_cell_size = dr::opaque<Float>(1.f / cell_size);
+
+        m_cache_value = dr::zeros<FloatStorage>(Channels * m_table_size);
+        m_cache_count = dr::zeros<FloatStorage>(m_table_size);
+        clear_training();
+
+        TensorXf accum;
+        for (uint32_t pass = 0; pass < n_passes; ++pass) {
+            Log(Debug, "Radiance cache pass %u/%u.", pass + 1, n_passes);
+
+            Base::render(scene, sensor, sample_tea_32(seed, pass).first,
+                         spp_per_pass, /* develop = */ false, evaluate);
+            if (m_stop)
+                break;
+
+            update_cache();
+
+            // Pool the samples of all passes (i.e. average their images)
+            TensorXf raw = film->develop(/* raw = */ true);
+            accum = pass == 0 ? raw : accum + raw;
+            if constexpr (dr::is_jit_v<Float>)
+                dr::eval(accum.array());
+        }
+
+        // Release the cache
+        m_cache_value = m_cache_count = m_train_value = m_train_count =
+            FloatStorage();
+        m_train_scalar.reset();
+
+        if (dr::width(accum.array()) > 0) {
+            film->clear();
+            ref<ImageBlock> block =
+                new ImageBlock(accum, ScalarPoint2i(film->crop_offset()),
+                               nullptr, false);
+            film->put_block(block);
+        }
+
+        return develop ? film->develop() : TensorXf();
+    }
+
+    std::pair<Spectrum, Bool> sample(const Scene *scene,
+                                     Sampler *sampler,
+                                     const RayDifferential3f &ray_,
+                                     const Medium * /* medium */,
+                                     Float * /* aovs */,
+                                     Bool active) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::SamplingIntegratorSample, active);
+
+        if (unlikely(m_max_depth == 0))
+            return { 0.f, false };
+
+        Ray3f ray(ray_);
+        Spectrum throughput = 1.f, result = 0.f;
+        Float eta = 1.f;
+        UInt32 depth = 0;
+
+        // If m_hide_emitters == false, the environment emitter will be visible
+        Mask valid_ray = !m_hide_emitters && dr::neq(scene->environment(), nullptr);
+
+        // Variables related to the previous vertex, needed for MIS
+        Interaction3f prev_si = dr::zeros<Interaction3f>();
+        Float prev_bsdf_pdf = 1.f;
+        Bool prev_bsdf_delta = true;
+
+        /* Number of smooth vertices along the path. The cache is queried at
+           the second one. Training paths store the cell, throughput and
+           radiance found at that vertex, which later yields the radiance
+           reflected there. */
+        UInt32 smooth_count = 0, train_cell = 0;
+        Bool train = false;
+        Spectrum train_throughput = 0.f, train_result = 0.f;
+
+        BSDFContext bsdf_ctx;
+
+        dr::Loop<Bool> loop("Radiance Cache", sampler, ray, throughput, result,
+                            eta, depth, valid_ray, prev_si, prev_bsdf_pdf,
+                            prev_bsdf_delta, smooth_count, train_cell, train,
+                            train_throughput, train_result, active);
+        loop.set_max_iterations(m_max_depth);
+
+        while (loop(active)) {
+            SurfaceInteraction3f si =
+                scene->ray_intersect(ray, +RayFlags::All,
+                                     /* coherent = */ dr::eq(depth, 0u));
+
+            // ---------------------- Direct emission ----------------------
+
+            if (dr::any_or<true>(dr::neq(si.emitter(scene), nullptr))) {
+                DirectionSample3f ds(scene, si, prev_si);
+                Float em_pdf = 0.f;
+
+                if (dr::any_or<true>(!prev_bsdf_delta))
+                    em_pdf = scene->pdf_emitter_direction(prev_si, ds,
+                                                          !prev_bsdf_delta);
+
+                // Compute MIS weight for emitter sample from previous bounce
+                Float mis_bsdf = mis_weight(prev_bsdf_pdf, em_pdf);
+
+                result = spec_fma(
+                    throughput,
+                    ds.emitter->eval(si, prev_bsdf_pdf > 0.f) * mis_bsdf,
+                    result);
+            }
+
+            // Continue tracing the path at this point?
+            Bool active_next = (depth + 1 < m_max_depth) && si.is_valid();
+
+            if (dr::none_or<false>(active_next))
+                break; // early exit for scalar mode
+
+            BSDFPtr bsdf = si.bsdf(ray);
+            Mask smooth = has_flag(bsdf->flags(), BSDFFlags::Smooth);
+
+            // ------------------------ Cache lookup ------------------------
+
+            Mask active_cache = active_next && smooth && dr::eq(smooth_count, 1u);
+            if (dr::any_or<true>(active_cache)) {
+                UInt32 cell = cell_index(si);
+                Float count = dr::gather<Float>(m_cache_count, cell, active_cache);
+
+                Mask use_cache = active_cache && count >= (ScalarFloat) m_min_samples &&
+                                 sampler->next_1d(active_cache) >= m_train_fraction;
+
+                UnpolarizedSpectrum cached =
+                    dr::gather<UnpolarizedSpectrum>(m_cache_value, cell, use_cache);
+                result[use_cache] = spec_fma(
+                    throughput, depolarizer<Spectrum>(cached / count), result);
+
+                // The remaining paths continue and record their radiance
+                Mask train_here = active_cache && !use_cache;
+                dr::masked(train_cell, train_here) = cell;
+                dr::masked(train_throughput, train_here) = throughput;
+                dr::masked(train_result, train_here) = result;
+                train |= train_here;
+
+                active_next &= !use_cache;
+            }
+
+            dr::masked(smooth_count, active_next && smooth) += 1;
+
+            // ---------------------- Emitter sampling ----------------------
+
+            Mask active_em = active_next && smooth;
+
+            DirectionSample3f ds = dr::zeros<DirectionSample3f>();
+            Spectrum em_weight = dr::zeros<Spectrum>();
+            Vector3f wo = dr::zeros<Vector3f>();
+
+            if (dr::any_or<true>(active_em)) {
+                std::tie(ds, em_weight) = scene->sample_emitter_direction(
+                    si, sampler->next_2d(), true, active_em);
+                active_em &= dr::neq(ds.pdf, 0.f);
+                wo = si.to_local(ds.d);
+            }
+
+            // ------ Evaluate BSDF * cos(theta) and sample direction -------
+
+            Float sample_1 = sampler->next_1d();
+            Point2f sample_2 = sampler->next_2d();
+
+            auto [bsdf_val, bsdf_pdf, bsdf_sample, bsdf_weight] =
+                bsdf->eval_pdf_sample(bsdf_ctx, si, wo, sample_1, sample_2);
+
+            // --------------- Emitter sampling contribution ----------------
+
+            if (dr::any_or<true>(active_em)) {
+                bsdf_val = si.to_world_mueller(bsdf_val, -wo, si.wi);
+
+                // Compute the MIS weight
+                Float mis_em =
+                    dr::select(ds.delta, 1.f, mis_weight(ds.pdf, bsdf_pdf));
+
+                result[active_em] = spec_fma(
+                    throughput, bsdf_val * em_weight * mis_em, result);
+            }
+
+            // ---------------------- BSDF sampling ----------------------
+
+            bsdf_weight = si.to_world_mueller(bsdf_weight, -bsdf_sample.wo, si.wi);
+            ray = si.spawn_ray(si.to_world(bsdf_sample.wo));
+
+            // ------ Update loop variables based on current interaction ------
+
+            throughput *= bsdf_weight;
+            eta *= bsdf_sample.eta;
+            valid_ray |= active && si.is_valid() &&
+                         !has_flag(bsdf_sample.sampled_type, BSDFFlags::Null);
+
+            prev_si = si;
+            prev_bsdf_pdf = bsdf_sample.pdf;
+            prev_bsdf_delta = has_flag(bsdf_sample.sampled_type, BSDFFlags::Delta);
+
+            // -------------------- Stopping criterion ---------------------
+
+            dr::masked(depth, si.is_valid()) += 1;
+
+            Float throughput_max = dr::max(unpolarized_spectrum(throughput));
+
+            Float rr_prob = dr::minimum(throughput_max * dr::sqr(eta), .95f);
+            Mask rr_active = depth >= m_rr_depth,
+                 rr_continue = sampler->next_1d() < rr_prob;
+
+            throughput[rr_active] *= dr::rcp(rr_prob);
+
+            active = active_next && (!rr_active || rr_continue) &&
+                     dr::neq(throughput_max, 0.f);
+        }
+
+        // ------------------- Record training samples --------------------
+
+        if (dr::any_or<true>(train)) {
+            UnpolarizedSpectrum throughput_u = unpolarized_spectrum(train_throughput),
+                                reflected = unpolarized_spectrum(result - train_result);
+            reflected = dr::select(dr::neq(throughput_u, 0.f),
+                                   reflected / throughput_u, 0.f);
+            record(train_cell, reflected,
+                   train && dr::all(dr::isfinite(reflected)));
+        }
+
+        return {
+            /* spec  = */ dr::select(valid_ray, result, 0.f),
+            /* valid = */ valid_ray
+        };
+    }
+
+    //! @}
+    // =============================================================
+
+    std::string to_string() const override {
+        return tfm::format("RadianceCacheIntegrator[\n"
+                           "  max_depth = %i,\n"
+                           "  rr_depth = %i,\n"
+                           "  samples_per_pass = %u,\n"
+                           "  cell_size = %f,\n"
+                           "  cache_size = %u,\n"
+                           "  train_fraction = %f,\n"
+                           "  min_samples = %u\n"
+                           "]",
+                           m_max_depth, m_rr_depth, m_samples_per_pass,
+                           m_cell_size, m_table_size, m_train_fraction,
+                           m_min_samples);
+    }
+
+    MI_DECLARE_CLASS()
+
+protected:
+    /**
+     * \brief Hash table entry of the cell containing \c si
+     *
+     * Besides the position, the hash accounts for the octant of the normal
+     * facing the incident direction, which separates the two sides of thin
+     * surfaces as well as differently oriented surfaces within a cell.
+     */
+    UInt32 cell_index(const SurfaceInteraction3f &si) const {
+        Vector3u c(dr::floor2int<Vector3i>((si.p - m_origin) * m_inv_cell_size));
+        Normal3f n = dr::mulsign(si.n, dr::dot(si.n, si.to_world(si.wi)));
+        UInt32 octant = dr::select(n.x() > 0.f, 1u, 0u) |
+                        dr::select(n.y() > 0.f, 2u, 0u) |
+                        dr::select(n.z() > 0.f, 4u, 0u);
+        return ((c.x() * 73856093u) ^ (c.y() * 19349663u) ^
+                (c.z() * 83492791u) ^ (octant * 2654435761u)) &
+               (m_table_size - 1);
+    }
+
+    /// Record a sample of the reflected radiance into the training buffers
+    void record(const UInt32 &cell, const UnpolarizedSpectrum &value,
+                const Mask &active) const {
+        if constexpr (dr::is_jit_v<Float>) {
+            for (size_t k = 0; k < Channels; ++k)
+                dr::scatter_reduce(ReduceOp::Add, m_train_value, value[k],
+                                   cell * (uint32_t) Channels + (uint32_t) k,
+                                   active);
+            dr::scatter_reduce(ReduceOp::Add, m_train_count, Float(1.f), cell,
+                               active);
+        } else {
+            if (!active)
+                return;
+            std::atomic<float> *entry = m_train_scalar.get() + (Channels + 1) * cell;
+            for (size_t k = 0; k < Channels; ++k)
+                atomic_add(entry[k], value[k]);
+            atomic_add(entry[Channels], 1.f);
+        }
+    }
+
+    /// Reset the buffers receiving the training samples of a pass
+    void clear_training() {
+        if constexpr (dr::is_jit_v<Float>) {
+            m_train_value = dr::zeros<FloatStorage>(Channels * m_table_size);
+            m_train_count = dr::zeros<FloatStorage>(m_table_size);
+            dr::make_opaque(m_train_value, m_train_count);
+        } else {
+            size_t size = (Channels + 1) * (size_t) m_table_size;
+            m_train_scalar.reset(new std::atomic<float>[size]);
+            for (size_t i = 0; i < size; ++i)
+                m_train_scalar[i].store(0.f, std::memory_order_relaxed);
+        }
+    }
+
+    /// Merge the training samples of the last pass into the cache
+    void update_cache() {
+        if constexpr (dr::is_jit_v<Float>) {
+            m_cache_value = m_cache_value + m_train_value;
+            m_cache_count = m_cache_count + m_train_count;
+            dr::eval(m_cache_value, m_cache_count);
+        } else {
+            std::vector<ScalarFloat> value(Channels * m_table_size),
+                                     count(m_table_size);
+            for (uint32_t i = 0; i < m_table_size; ++i) {
+                const std::atomic<float> *entry =
+                    m_train_scalar.get() + (Channels + 1) * i;
+                for (size_t k = 0; k < Channels; ++k)
+                    value[Channels * i + k] = m_cache_value[Channels * i + k] +
+                                              entry[k].load(std::memory_order_relaxed);
+                count[i] = m_cache_count[i] +
+                           entry[Channels].load(std::memory_order_relaxed);
+            }
+            m_cache_value = dr::load<FloatStorage>(value.data(), value.size());
+            m_cache_count = dr::load<FloatStorage>(count.data(), count.size());
+        }
+
+        clear_training();
+    }
+
+    Float mis_weight(Float pdf_a, Float pdf_b) const {
+        pdf_a *= pdf_a;
+        pdf_b *= pdf_b;
+        Float w = pdf_a / (pdf_a + pdf_b);
+        return dr::select(dr::isfinite(w), w, 0.f);
+    }
+
+    /// Multiply-add that is careful with polarization (see path.cpp)
+    template <typename T>
+    T spec_fma(const T &a, const T &b, const T &c) const {
+        if constexpr (is_polarized_v<Spectrum>)
+            return a * b + c; // Mueller matrix multiplication
+        else
+            return dr::fmadd(a, b, c);
+    }
+
+private:
+    uint32_t m_samples_per_pass;
+    ScalarFloat m_cell_size;
+    uint32_t m_table_size;
+    ScalarFloat m_train_fraction;
+    uint32_t m_min_samples;
+
+    // Radiance sums and sample counts from the previous passes
+    ScalarPoint3f m_origin;
+    Float m_inv_cell_size;
+    FloatStorage m_cache_value;
+    FloatStorage m_cache_count;
+
+    // Training samples recorded during the current pass
+    mutable FloatStorage m_train_value;
+    mutable FloatStorage m_train_count;
+    std::unique_ptr<std::atomic<float>[]> m_train_scalar;
+};
+
+MI_IMPLEMENT_CLASS_VARIANT(RadianceCacheIntegrator, MonteCarloIntegrator)
+MI_EXPORT_PLUGIN(RadianceCacheIntegrator, "Radiance cache integrator");
+NAMESPACE_END(mitsuba)
@@ -0,0 +1,616 @@
+#include <mitsuba/core/math.h>
+#include <mitsuba/core/plugin.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/random.h>
+#include <mitsuba/core/ray.h>
+#include <mitsuba/core/thread.h>
+#include <mitsuba/render/bsdf.h>
+#include <mitsuba/render/emitter.h>
+#include <mitsuba/render/film.h>
+#include <mitsuba/render/imageblock.h>
+#include <mitsuba/render/integrator.h>
+#include <mitsuba/render/records.h>
+#include <mitsuba/render/sampler.h>
+#include <mitsuba/render/sensor.h>
+#include <nanothread/nanothread.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**!
+
+.. _integrator-sppm:
+
+Stochastic progressive photon mapper (:monosp:`sppm`)
+-----------------------------------------------------
+
+.. pluginparameters::
+
+ * - max_depth
+   - |int|
+   - Specifies the longest path depth of the camera and photon subpaths
+     (where -1 corresponds to :math:`\infty`). (Default: -1)
+
+ * - rr_depth
+   - |int|
+   - Specifies the photon path depth, at which the implementation will begin
+     to use the *russian roulette* path termination criterion. (Default: 5)
+
+ * - hide_emitters
+   - |bool|
+   - Hide directly visible emitters. (Default: no, i.e. |false|)
+
+ * - photon_count
+   - |int|
+   - Number of photons emitted from the light sources in every pass.
+     (Default: 250000)
+
+ * - samples_per_pass
+   - |int|
+   - Number of camera samples per pixel rendered in every pass. The total
+     sample count of the sensor's sampler determines the number of passes.
+     (Default: 1)
+
+ * - initial_radius
+   - |float|
+   - Radius of the density estimation in the first pass. The default value
+     of zero selects 1/500 of the diagonal of the scene's bounding box.
+     (Default: 0)
+
+ * - alpha
+   - |float|
+   - Controls how quickly the radius shrinks from one pass to the next. Values
+     close to 1 shrink it slowly (reducing noise faster), values close to 0
+     reduce the bias faster. (Default: 0.7)
+
+This integrator implements progressive photon mapping in the probabilistic
+formulation by Knaus and Zwicker ("Progressive Photon Mapping: A
+Probabilistic Approach", 2011). Every pass first traces a new set of photons
+from the light sources and stores them in a hash grid. It then renders the
+image using camera paths that follow specular (delta) interactions and
+estimate the reflected radiance at the first smooth surface by looking up
+the photons in its vicinity. Direct illumination is computed using emitter
+sampling instead. The radius of the density estimate shrinks from one pass to
+the next, so that the average of all passes converges to the correct
+solution.
+
+Photon mapping excels at caustics, especially those seen via specular
+reflections or refractions (e.g. a pool floor seen through the water
+surface), which unidirectional path tracers essentially cannot render. In
+scenes without such paths, it is usually less efficient than the :ref:`path
+tracer <integrator-path>` and introduces some blurring bias.
+
+The photon map is constructed in parallel without locks: in scalar variants,
+every block of photons is traced into a separate buffer, and in JIT variants,
+photons are sorted into the grid cells using atomic counters.
+
+.. note:: This integrator does not support participating media, and it is not
+   available in spectral and polarized variants.
+
+.. tabs::
+    .. code-tab::  xml
+        :name: sppm-integrator
+
+        <integrator type="sppm">
+            <integer name="photon_count" value="1000000"/>
+        </integrator>
+
+    .. code-tab:: python
+
+        'type': 'sppm',
+        'photon_count': 1000000
+
+ */
+
+template <typename Float, typename Spectrum>
+class StochasticPPMIntegrator : public MonteCarloIntegrator<Float, Spectrum> {
+public:
+    MI_IMPORT_BASE(MonteCarloIntegrator, m_max_depth, m_rr_depth,
+                   m_hide_emitters, m_stop)
+    MI_IMPORT_TYPES(Scene, Sensor, Film, Sampler, ImageBlock, Medium, Emitter,
+                    EmitterPtr, BSDF, BSDFPtr)
+
+    using FloatStorage  = DynamicBuffer<Float>;
+    using UInt32Storage = DynamicBuffer<UInt32>;
+
+    /// Photon recorded at a smooth surface (used by scalar variants)
+    struct Photon {
+        Point3f p;
+        Vector3f wi;
+        Normal3f n;
+        UnpolarizedSpectrum power;
+    };
+
+    /// Photons recorded along one bounce of all photon paths (JIT variants)
+    struct PhotonBatch {
+        Point3f p;
+        Vector3f wi;
+        Normal3f n;
+        UnpolarizedSpectrum power;
+        Mask active;
+    };
+
+    StochasticPPMIntegrator(const Properties &props) : Base(props) {
+        if constexpr (is_spectral_v<Spectrum> || is_polarized_v<Spectrum>)
+            Throw("The photon mapper is not supported in spectral and "
+                  "polarized variants.");
+
+        m_photon_count = props.get<uint32_t>("photon_count", 250000);
+        if (m_photon_count == 0)
+            Throw("\"photon_count\" must be positive.");
+
+        m_samples_per_pass = props.get<uint32_t>("samples_per_pass", 1);
+        if (m_samples_per_pass == 0)
+            Throw("\"samples_per_pass\" must be positive.");
+
+        m_initial_radius = props.get<ScalarFloat>("initial_radius", 0.f);
+        if (m_initial_radius < 0.f)
+            Throw("\"initial_radius\" must be non-negative.");
+
+        m_alpha = props.get<ScalarFloat>("alpha", .7f);
+        if (!(m_alpha > 0.f && m_alpha < 1.f))
+            Throw("\"alpha\" must be in (0, 1).");
+
+        // Roughly two grid cells per photon path
+        m_table_size = math::round_to_power_of_two(2 * m_photon_count);
+    }
+
+    TensorXf render(Scene *scene,
+                    Sensor *sensor,
+                    uint32_t seed = 0,
+                    uint32_t spp = 0,
+                    bool develop = true,
+                    bool evaluate = true) override {
+        Film *film = sensor->film();
+
+        if (spp == 0)
+            spp = sensor->sampler()->sample_count();
+        uint32_t spp_per_pass = std::min(spp, m_samples_per_pass),
+                 n_passes     = (spp + spp_per_pass - 1) / spp_per_pass;
+
+        ScalarBoundingBox3f bbox = scene->bbox();
+        m_origin = bbox.min;
+        ScalarFloat radius_sqr =
+            dr::sqr(m_initial_radius > 0.f ? m_initial_radius
+                                           : dr::norm(bbox.extents()) / 500.f);
+
+        TensorXf accum;
+        for (uint32_t pass = 0; pass < n_passes; ++pass) {
+            // Radius reduction of Knaus and Zwicker, Eq. (15)
+            if (pass > 0)
+                radius_sqr *= (pass + m_alpha) / (pass + 1.f);
+
+            uint32_t pass_seed = sample_tea_32(seed, pass).first;
+
+            Log(Debug, "Photon mapping pass %u/%u: tracing %u photons (radius %g).",
+                pass + 1, n_passes, m_photon_count, dr::sqrt(radius_sqr));
+
+            build_photon_map(scene, sensor, pass_seed, dr::sqrt(radius_sqr));
+
+            Base::render(scene, sensor, pass_seed, spp_per_pass,
+                         /* develop = */ false, evaluate);
+            if (m_stop)
+                break;
+
+            // Pool the samples of all passes (i.e. average their images)
+            TensorXf raw = film->develop(/* raw = */ true);
+            accum = pass == 0 ? raw : accum + raw;
+            if constexpr (dr::is_jit_v<Float>)
+                dr::eval(accum.array());
+        }
+
+        // Release the photon map
+        m_photon_p = m_photon_wi = m_photon_n = m_photon_power = FloatStorage();
+        m_cell_offset = UInt32Storage();
+
+        if (dr::width(accum.array()) > 0) {
+            film->clear();
+            ref<ImageBlock> block =
+                new ImageBlock(accum, ScalarPoint2i(film->crop_offset()),
+                               nullptr, false);
+            film->put_block(block);
+        }
+
+        return develop ? film->develop() : TensorXf();
+    }
+
+    std::pair<Spectrum, Bool> sample(const Scene *scene,
+                                     Sampler *sampler,
+                                     const RayDifferential3f &ray_,
+                                     const Medium * /* medium */,
+                                     Float * /* aovs */,
+                                     Bool active) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::SamplingIntegratorSample, active);
+
+        if (unlikely(m_max_depth == 0))
+            return { 0.f, false };
+
+        Ray3f ray(ray_);
+        Spectrum throughput = 1.f, result = 0.f;
+        UInt32 depth = 0;
+
+        // If m_hide_emitters == false, the environment emitter will be visible
+        Mask valid_ray = !m_hide_emitters && dr::neq(scene->environment(), nullptr);
+
+        BSDFContext bsdf_ctx, delta_ctx;
+        delta_ctx.type_mask = +BSDFFlags::Delta;
+
+        /* The camera path only continues along delta components, since the
+           photon map accounts for all other interactions */
+        dr::Loop<Bool> loop("Photon Mapper", sampler, ray, throughput, result,
+                            depth, valid_ray, active);
+        loop.set_max_iterations(m_max_depth);
+
+        while (loop(active)) {
+            SurfaceInteraction3f si =
+                scene->ray_intersect(ray, +RayFlags::All,
+                                     /* coherent = */ dr::eq(depth, 0u));
+
+            // ---------------------- Direct emission ----------------------
+
+            /* Emitters are only hit directly or via delta interactions, which
+               emitter sampling cannot handle. No MIS weight is needed. */
+            EmitterPtr emitter = si.emitter(scene);
+            Mask active_e = active && dr::neq(emitter, nullptr) &&
+                            !(dr::eq(depth, 0u) && m_hide_emitters);
+            if (dr::any_or<true>(active_e))
+                result[active_e] =
+                    spec_fma(throughput, emitter->eval(si, active_e), result);
+
+            Bool active_next = (depth + 1 < (uint32_t) m_max_depth) && si.is_valid();
+            valid_ray |= active && si.is_valid();
+
+            if (dr::none_or<false>(active_next))
+                break; // early exit for scalar mode
+
+            BSDFPtr bsdf = si.bsdf(ray);
+
+            // ------------ Direct and photon-mapped illumination ------------
+
+            Mask active_smooth = active_next && has_flag(bsdf->flags(), BSDFFlags::Smooth);
+            if (dr::any_or<true>(active_smooth)) {
+                auto [ds, em_weight] = scene->sample_emitter_direction(
+                    si, sampler->next_2d(active_smooth), true, active_smooth);
+                Mask active_em = active_smooth && dr::neq(ds.pdf, 0.f);
+
+                Spectrum bsdf_val =
+                    bsdf->eval(bsdf_ctx, si, si.to_local(ds.d), active_em);
+                result[active_em] = spec_fma(throughput, bsdf_val * em_weight, result);
+
+                UnpolarizedSpectrum indirect =
+                    estimate_radiance(si, bsdf, active_smooth);
+                result[active_smooth] = spec_fma(
+                    throughput, depolarizer<Spectrum>(indirect), result);
+            }
+
+            // ------------------ Follow delta components -------------------
+
+            Mask active_delta = active_next && has_flag(bsdf->flags(), BSDFFlags::Delta);
+            auto [bs, bsdf_weight] =
+                bsdf->sample(delta_ctx, si, sampler->next_1d(active_delta),
+                             sampler->next_2d(active_delta), active_delta);
+
+            throughput *= bsdf_weight;
+            ray = si.spawn_ray(si.to_world(bs.wo));
+            depth[si.is_valid()] += 1;
+
+            active = active_delta &&
+                     dr::any(dr::neq(unpolarized_spectrum(throughput), 0.f));
+        }
+
+        return {
+            /* spec  = */ dr::select(valid_ray, result, 0.f),
+            /* valid = */ valid_ray
+        };
+    }
+
+    //! @}
+    // =============================================================
+
+    std::string to_string() const override {
+        return tfm::format("StochasticPPMIntegrator[\n"
+                           "  max_depth = %i,\n"
+                           "  rr_depth = %i,\n"
+                           "  photon_count = %u,\n"
+                           "  samples_per_pass = %u,\n"
+                           "  initial_radius = %f,\n"
+                           "  alpha = %f\n"
+                           "]",
+                           m_max_depth, m_rr_depth, m_photon_count,
+                           m_samples_per_pass, m_initial_radius, m_alpha);
+    }
+
+    MI_DECLARE_CLASS()
+
+protected:
+    /// Hash grid cell of the given integer coordinates
+    UInt32 cell_hash(const Vector3i &cell) const {
+        Vector3u c(cell);
+        return ((c.x() * 73856093u) ^ (c.y() * 19349663u) ^ (c.z() * 83492791u)) &
+               (m_table_size - 1);
+    }
+
+    /// Hash grid cell containing the given position
+    UInt32 cell_hash(const Point3f &p) const {
+        return cell_hash(dr::floor2int<Vector3i>((p - m_origin) * m_inv_cell_size));
+    }
+
+    /**
+     * \brief Trace photons from the emitters and sort them into the hash grid
+     *
+     * The grid cells have twice the size of the density estimation radius,
+     * so that every lookup visits at most 2x2x2 cells.
+     */
+    void build_photon_map(const Scene *scene, const Sensor *sensor,
+                          uint32_t seed, ScalarFloat radius) {
+        ScalarFloat scale = 1.f / m_photon_count;
+        ref<Sampler> sampler = PluginManager::instance()->create_object<Sampler>(
+            Properties("independent"));
+        Float time = sensor->shutter_open();
+
+        /* Opaque values avoid recompiling the camera pass kernel whenever the
+           radius changes */
+        m_radius = dr::opaque<Float>(radius);
+        m_inv_cell_size = dr::opaque<Float>(.5f / radius);
+
+        if constexpr (dr::is_jit_v<Float>) {
+            sampler->seed(seed, m_photon_count);
+
+            std::vector<PhotonBatch> batches;
+            trace_photons(scene, sampler, time, scale,
+                [&](const Point3f &p, const Vector3f &wi, const Normal3f &n,
+                    const UnpolarizedSpectrum &power, const Mask &active) {
+                    PhotonBatch batch{ p, wi, n, power, active };
+                    dr::schedule(batch.p, batch.wi, batch.n, batch.power,
+                                 batch.active);
+                    batches.push_back(std::move(batch));
+                });
+
+            // Count the photons per cell
+            UInt32 counts = dr::zeros<UInt32>(m_table_size + 1);
+            for (const PhotonBatch &b : batches)
+                dr::scatter_reduce(ReduceOp::Add, counts, UInt32(1),
+                                   cell_hash(b.p), b.active);
+
+            m_cell_offset = dr::prefix_sum(counts, /* exclusive = */ true);
+            uint32_t total = (uint32_t) dr::slice(m_cell_offset, m_table_size);
+            uint32_t size = std::max(total, 1u);
+
+            m_photon_p     = dr::zeros<FloatStorage>(3 * size);
+            m_photon_wi    = dr::zeros<FloatStorage>(3 * size);
+            m_photon_n     = dr::zeros<FloatStorage>(3 * size);
+            m_photon_power = dr::zeros<FloatStorage>(UnpolarizedSpectrum::Size * size);
+
+            // Place each photon in its cell using an atomic cursor per cell
+            UInt32 cursor = dr::zeros<UInt32>(m_table_size + 1);
+            for (const PhotonBatch &b : batches) {
+                UInt32 hash = cell_hash(b.p),
+                       slot = dr::gather<UInt32>(m_cell_offset, hash, b.active) +
+                              dr::scatter_inc(cursor, hash, b.active);
+                dr::scatter(m_photon_p, b.p, slot, b.active);
+                dr::scatter(m_photon_wi, b.wi, slot, b.active);
+                dr::scatter(m_photon_n, b.n, slot, b.active);
+                dr::scatter(m_photon_power, b.power, slot, b.active);
+            }
+
+            dr::eval(m_cell_offset, m_photon_p, m_photon_wi, m_photon_n,
+                     m_photon_power);
+            Log(Debug, "Stored %u photons.", total);
+        } else {
+            // Every block of photons is recorded in a separate buffer
+            uint32_t grain_size = 4096,
+                     n_blocks = (m_photon_count + grain_size - 1) / grain_size;
+            std::vector<std::vector<Photon>> blocks(n_blocks);
+
+            ThreadEnvironment env;
+            dr::parallel_for(
+                dr::blocked_range<uint32_t>(0, n_blocks, 1),
+                [&](const dr::blocked_range<uint32_t> &range) {
+                    ScopedSetThreadEnvironment set_env(env);
+                    ref<Sampler> local_sampler = sampler->clone();
+
+                    for (uint32_t i = range.begin(); i != range.end(); ++i) {
+                        local_sampler->seed(seed + i);
+                        std::vector<Photon> &photons = blocks[i];
+                        uint32_t count = std::min(grain_size,
+                                                  m_photon_count - i * grain_size);
+
+                        for (uint32_t j = 0; j < count; ++j) {
+                            trace_photons(scene, local_sampler, time, scale,
+                                [&](const Point3f &p, const Vector3f &wi,
+                                    const Normal3f &n,
+                                    const UnpolarizedSpectrum &power,
+                                    bool active) {
+                                    if (active)
+                                        photons.push_back({ p, wi, n, power });
+                                });
+                            local_sampler->advance();
+                        }
+                    }
+                });
+
+            // Counting sort of the photons by cell
+            std::vector<uint32_t> offset(m_table_size + 1, 0);
+            for (const std::vector<Photon> &photons : blocks)
+                for (const Photon &photon : photons)
+                    offset[cell_hash(photon.p) + 1]++;
+            for (uint32_t i = 0; i < m_table_size; ++i)
+                offset[i + 1] += offset[i];
+
+            uint32_t total = offset[m_table_size],
+                     size = std::max(total, 1u);
+            constexpr size_t Channels = UnpolarizedSpectrum::Size;
+            std::vector<ScalarFloat> p(3 * size, 0.f), wi(3 * size, 0.f),
+                n(3 * size, 0.f), power(Channels * size, 0.f);
+
+            std::vector<uint32_t> cursor(offset.begin(), offset.end() - 1);
+            for (const std::vector<Photon> &photons : blocks) {
+                for (const Photon &photon : photons) {
+                    uint32_t slot = cursor[cell_hash(photon.p)]++;
+                    for (size_t k = 0; k < 3; ++k) {
+                        p[3 * slot + k]  = photon.p[k];
+                        wi[3 * slot + k] = photon.wi[k];
+                        n[3 * slot + k]  = photon.n[k];
+                    }
+                    for (size_t k = 0; k < Channels; ++k)
+                        power[Channels * slot + k] = photon.power[k];
+                }
+            }
+
+            m_cell_offset  = dr::load<UInt32Storage>(offset.data(), offset.size());
+            m_photon_p     = dr::load<FloatStorage>(p.data(), p.size());
+            m_photon_wi    = dr::load<FloatStorage>(wi.data(), wi.size());
+            m_photon_n     = dr::load<FloatStorage>(n.data(), n.size());
+            m_photon_power = dr::load<FloatStorage>(power.data(), power.size());
+            Log(Debug, "Stored %u photons.", total);
+        }
+    }
+
+    /**
+     * \brief Trace photon paths and report each smooth interaction
+     *
+     * The function \c store receives the position, incident direction
+     * (pointing away from the surface), geometric normal and power of each
+     * photon. Interactions directly following emission are skipped since
+     * direct illumination is computed using emitter sampling.
+     */
+    template <typename StoreFn>
+    void trace_photons(const Scene *scene, Sampler *sampler, Float time,
+                       ScalarFloat scale, StoreFn &&store) const {
+        auto [ray, throughput, emitter] = scene->sample_emitter_ray(
+            time, sampler->next_1d(), sampler->next_2d(), sampler->next_2d());
+        DRJIT_MARK_USED(emitter);
+
+        UnpolarizedSpectrum power = unpolarized_spectrum(throughput) * scale;
+        Mask active = dr::any(dr::neq(power, 0.f));
+        Float eta = 1.f;
+        BSDFContext ctx(TransportMode::Importance);
+
+        for (uint32_t depth = 1; depth < m_max_depth; ++depth) {
+            SurfaceInteraction3f si = scene->ray_intersect(ray, active);
+            active &= si.is_valid();
+            if (dr::none(active))
+                break;
+
+            BSDFPtr bsdf = si.bsdf(ray);
+            if (depth > 1)
+                store(si.p, -ray.d, si.n, power,
+                      active && has_flag(bsdf->flags(), BSDFFlags::Smooth));
+
+            auto [bs, bsdf_val] = bsdf->sample(ctx, si, sampler->next_1d(active),
+                                               sampler->next_2d(active), active);
+
+            // Using geometric normals (wo points to the camera)
+            Float wi_dot_geo_n = dr::dot(si.n, -ray.d),
+                  wo_dot_geo_n = dr::dot(si.n, si.to_world(bs.wo));
+
+            // Prevent light leaks due to shading normals
+            active &= (wi_dot_geo_n * Frame3f::cos_theta(si.wi) > 0.f) &&
+                      (wo_dot_geo_n * Frame3f::cos_theta(bs.wo) > 0.f);
+
+            // Adjoint BSDF for shading normals -- [Veach, p. 155]
+            Float correction = dr::abs((Frame3f::cos_theta(si.wi) * wo_dot_geo_n) /
+                                       (Frame3f::cos_theta(bs.wo) * wi_dot_geo_n));
+            power *= unpolarized_spectrum(bsdf_val) * correction;
+            eta *= bs.eta;
+
+            // Russian roulette
+            if (depth >= m_rr_depth) {
+                Float q = dr::minimum(dr::max(power) / scale * dr::sqr(eta), .95f);
+                active &= sampler->next_1d(active) < q;
+                power *= dr::rcp(q);
+            }
+
+            active &= dr::any(dr::neq(power, 0.f));
+            ray = si.spawn_ray(si.to_world(bs.wo));
+
+            if constexpr (dr::is_jit_v<Float>) {
+                sampler->schedule_state();
+                dr::eval(ray, power, eta, active);
+            }
+        }
+    }
+
+    /**
+     * \brief Estimate the radiance reflected towards \c si.wi from the
+     * photons within the current radius of \c si.p
+     */
+    UnpolarizedSpectrum estimate_radiance(const SurfaceInteraction3f &si,
+                                          const BSDFPtr &bsdf,
+                                          Mask active) const {
+        BSDFContext ctx;
+        Float radius_sqr = dr::sqr(m_radius);
+
+        // Lower corner of the 2x2x2 cells overlapping the search sphere
+        Vector3i base = dr::floor2int<Vector3i>(
+            (si.p - m_origin) * m_inv_cell_size - .5f);
+
+        /* Iterate over the photons of all eight cells within a single loop.
+           When the current cell is exhausted ('index == end'), the loop moves
+           on to the next one ('cell') */
+        UnpolarizedSpectrum result = 0.f;
+        UInt32 cell = 0, index = 0, end = 0;
+
+        dr::Loop<Mask> loop("Photon Lookup", active, cell, index, end, result);
+        while (loop(active)) {
+            Mask next_cell = index >= end;
+            if (dr::any_or<true>(next_cell)) {
+                Vector3i offset(Int32(cell & 1u), Int32((cell >> 1) & 1u),
+                                Int32(cell >> 2));
+                UInt32 hash = cell_hash(base + offset);
+                dr::masked(index, next_cell) =
+                    dr::gather<UInt32>(m_cell_offset, hash, next_cell);
+                dr::masked(end, next_cell) =
+                    dr::gather<UInt32>(m_cell_offset, hash + 1u, next_cell);
+                dr::masked(cell, next_cell) = cell + 1u;
+            }
+
+            Mask active_p = active && index < end;
+            Point3f p = dr::gather<Point3f>(m_photon_p, index, active_p);
+            Normal3f n = dr::gather<Normal3f>(m_photon_n, index, active_p);
+
+            // Skip photons of other cells (hash collisions) and other surfaces
+            active_p &= dr::squared_norm(p - si.p) < radius_sqr &&
+                        dr::dot(n, si.n) > .9f;
+
+            if (dr::any_or<true>(active_p)) {
+                Vector3f wo = si.to_local(
+                    dr::gather<Vector3f>(m_photon_wi, index, active_p));
+                UnpolarizedSpectrum power = dr::gather<UnpolarizedSpectrum>(
+                    m_photon_power, index, active_p);
+
+                // The photon power already includes the foreshortening term
+                Float cos_theta = dr::abs(Frame3f::cos_theta(wo));
+                UnpolarizedSpectrum value = unpolarized_spectrum(
+                    bsdf->eval(ctx, si, wo, active_p));
+                result[active_p] += value * power *
+                    dr::select(cos_theta > 0.f, dr::rcp(cos_theta), 0.f);
+            }
+
+            dr::masked(index, index < end) = index + 1u;
+            active &= cell < 8u || index < end;
+        }
+
+        return result * dr::rcp(dr::Pi<Float> * radius_sqr);
+    }
+
+private:
+    uint32_t m_photon_count;
+    uint32_t m_samples_per_pass;
+    ScalarFloat m_initial_radius;
+    ScalarFloat m_alpha;
+    uint32_t m_table_size;
+
+    // Photon map of the current pass
+    ScalarPoint3f m_origin;
+    Float m_radius;
+    Float m_inv_cell_size;
+    UInt32Storage m_cell_offset;
+    FloatStorage m_photon_p;
+    FloatStorage m_photon_wi;
+    FloatStorage m_photon_n;
+    FloatStorage m_photon_power;
+};
+
+MI_IMPLEMENT_CLASS_VARIANT(StochasticPPMIntegrator, MonteCarloIntegrator)
+MI_EXPORT_PLUGIN(StochasticPPMIntegrator, "Stochastic progressive photon mapper");
+NAMESPACE_END(mitsuba)
@@ -103,9 +103,10 @@ public:
             Vector3f current_basis = mueller::stokes_basis(-ray.d);
             Vector3f vertical = sensor->world_transform() * Vector3f(0.f, 1.f, 0.f);
             Vector3f target_basis = dr::cross(ray.d, vertical);
-            spec = mueller::rotate_stokes_basis(-ray.d,
-                                                 current_basis,
-                                                 target_basis) * spec;
+            auto [c, s] = mueller::stokes_basis_rotation(-ray.d,
+                                                         current_basis,
+                                                         target_basis);
+            spec = mueller::rotate_rows(spec, c, s);
 
             auto const &stokes = spec.entry(0);
             for (int i = 0; i < 4; ++i) {
@@ -953,6 +953,86 @@ def test04_render_custom_op(variants_all_ad_rgb):
         mi.util.write_bitmap(filename, error)
         assert False
 
+
+def test05_frozen(variants_all_ad_rgb):
+    scene = mi.load_dict(mi.cornell_box())
+    params = mi.traverse(scene)
+    key = 'red.reflectance.value'
+
+    grads = []
+    for frozen in [False, True]:
+        integrator = mi.load_dict({ 'type': 'prb', 'frozen': frozen })
+        for i in range(2):
+            dr.enable_grad(params[key])
+            params.update()
+            image = mi.render(scene, params, integrator=integrator, seed=0, spp=4)
+            dr.backward(dr.mean(image))
+            grads.append(dr.grad(params[key]))
+            dr.disable_grad(params[key])
+        assert integrator.frozen_steady == frozen
+
+        # A different sample count leaves the steady state
+        integrator.render_backward(scene, params, image, seed=0, spp=2)
+        assert not integrator.frozen_steady
+
+    for g in grads[1:]:
+        assert dr.allclose(g, grads[0])
+
+def test06_memory_budget(variants_all_ad_rgb):
+    scene = mi.load_dict(mi.cornell_box())
+    params = mi.traverse(scene)
+    key = 'red.reflectance.value'
+    sensor = scene.sensors()[0]
+    grad_in = dr.full(mi.TensorXf, 1.0, (256, 256, 3))
+
+    grads = []
+    for budget in [0, 8]:
+        integrator = mi.load_dict({ 'type': 'prbvolpath', 'memory_budget': budget })
+        passes = integrator.split_passes(sensor, 16)
+        assert sum(passes) == 16
+        assert (len(passes) > 1) == (budget > 0)
+
+        dr.enable_grad(params[key])
+        params.update()
+        integrator.render_backward(scene, params, grad_in, seed=0, spp=16)
+        grads.append(dr.grad(params[key]))
+        dr.disable_grad(params[key])
+
+    assert dr.allclose(grads[0], grads[1], rtol=5e-2)
+
+def test07_local_reduction(variants_all_ad_rgb):
+    scene = mi.cornell_box()
+    scene['red']['reflectance'] = {
+        'type': 'bitmap',
+        'data': dr.full(mi.TensorXf, 0.5, (4, 4, 3)),
+        'filter_type': 'nearest'
+    }
+    scene = mi.load_dict(scene)
+    params = mi.traverse(scene)
+    key = 'red.reflectance.data'
+    grad_in = dr.full(mi.TensorXf, 1.0, (256, 256, 3))
+
+    integrator = mi.load_dict({ 'type': 'prb' })
+    assert not integrator.reduce_locally(params, 256 * 256)
+
+    dr.enable_grad(params[key])
+    assert integrator.reduce_locally(params, 256 * 256)
+    assert not integrator.reduce_locally(params, 64)
+
+    grads = []
+    for mode in ['auto', 'false']:
+        integrator = mi.load_dict({ 'type': 'prb', 'local_reduction': mode })
+        dr.enable_grad(params[key])
+        params.update()
+        integrator.render_backward(scene, params, grad_in, seed=0, spp=4)
+        grads.append(dr.grad(params[key]))
+        dr.disable_grad(params[key])
+
+    assert dr.allclose(grads[0], grads[1], rtol=1e-3)
+
+    with pytest.raises(Exception, match='local_reduction'):
+        mi.load_dict({ 'type': 'prb', 'local_reduction': 'always' })
+
 # -------------------------------------------------------------------
 #                      Generate reference images
 # -------------------------------------------------------------------
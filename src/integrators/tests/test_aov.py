@@ -175,4 +175,76 @@ def test05_check_aov_film(variants_all_rgb):
     bitmap_aov = film.bitmap(raw=False)
 
     # Make sure radiance is consistent
-    assert(np.allclose(bitmap_aov.split()[0][1],bitmap_path.split()[0][1]))
\ No newline at end of file
+    assert(np.allclose(bitmap_aov.split()[0][1],bitmap_path.split()[0][1]))
+
+def test06_radiance_consistent_wavefront(variants_vec_backends_once_rgb):
+    # In wavefront mode, the nested path tracer reuses the primary
+    # intersection of the AOV integrator instead of tracing it again
+    scene = mi.load_file(find_resource('resources/data/scenes/cbox/cbox.xml'))
+
+    path_integrator = mi.load_dict({
+        'type': 'path',
+        'max_depth': 6
+    })
+
+    aov_integrator = mi.load_dict({
+        'type': 'aov',
+        'aovs': 'nn:sh_normal',
+        'my_image': path_integrator
+    })
+
+    loop_record = dr.flag(dr.JitFlag.LoopRecord)
+    dr.set_flag(dr.JitFlag.LoopRecord, False)
+
+    try:
+        spp = 4
+        path_image = path_integrator.render(scene, seed=0, spp=spp)
+        aovs_image = aov_integrator.render(scene, seed=0, spp=spp)
+    finally:
+        dr.set_flag(dr.JitFlag.LoopRecord, loop_record)
+
+    assert dr.allclose(path_image, aovs_image[:,:,:3], rtol=1e-4, atol=1e-4)
+
+
+def test07_cost_aov(variants_all_rgb):
+    scene = mi.load_file(find_resource('resources/data/scenes/cbox/cbox.xml'))
+
+    path_integrator = mi.load_dict({
+        'type': 'path',
+        'max_depth': 6
+    })
+
+    spp = 4
+    path_image = path_integrator.render(scene, seed=0, spp=spp)
+
+    aov_integrator = mi.load_dict({
+        'type': 'aov',
+        'aovs': 'cc:cost',
+        'my_image': path_integrator
+    })
+    assert path_integrator.cost_aovs()
+
+    names = aov_integrator.aov_names()
+    has_time = not dr.is_jit_v(mi.Float)
+    assert names[:3] == ['cc.V', 'cc.S', 'cc.N']
+    assert ('cc.T' in names) == has_time
+    assert 'my_image.cost.V' not in names
+
+    aovs_image = aov_integrator.render(scene, seed=0, spp=spp)
+
+    # The counters don't affect the rendered image
+    assert dr.allclose(path_image, aovs_image[:, :, :3])
+
+    base = aovs_image.shape[2] - len(names)
+    vertices = aovs_image[:, :, base]
+    shadow_rays = aovs_image[:, :, base + 1]
+    null_steps = aovs_image[:, :, base + 2]
+
+    assert dr.all(vertices.array >= 0) and dr.all(vertices.array <= 6)
+    assert dr.mean(vertices.array) > 1
+    assert dr.mean(shadow_rays.array) > 0
+    assert dr.all(shadow_rays.array <= vertices.array + 1e-3)
+    assert dr.all(dr.eq(null_steps.array, 0))
+
+    if has_time:
+        assert dr.mean(aovs_image[:, :, base + 3].array) > 0
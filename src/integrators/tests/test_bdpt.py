@@ -0,0 +1,101 @@
+import pytest
+import drjit as dr
+import mitsuba as mi
+
+
+def make_scene(emitter):
+    return mi.load_dict({
+        'type': 'scene',
+        'sensor': {
+            'type': 'perspective',
+            'to_world': mi.ScalarTransform4f.look_at(origin=[0, 0, 4],
+                                                     target=[0, 0, 0],
+                                                     up=[0, 1, 0]),
+            'film': {
+                'type': 'hdrfilm',
+                'width': 16,
+                'height': 16,
+                'rfilter': { 'type': 'box' }
+            }
+        },
+        'sphere': {
+            'type': 'sphere',
+            'bsdf': { 'type': 'roughplastic' }
+        },
+        'floor': {
+            'type': 'rectangle',
+            'to_world': mi.ScalarTransform4f.translate([0, -1, 0]) @
+                        mi.ScalarTransform4f.rotate([1, 0, 0], -90) @
+                        mi.ScalarTransform4f.scale(5),
+            'bsdf': { 'type': 'diffuse' }
+        },
+        **emitter
+    })
+
+
+EMITTERS = {
+    'point': {
+        'emitter': {
+            'type': 'point',
+            'position': [0, 3, 2],
+            'intensity': { 'type': 'rgb', 'value': 10.0 }
+        }
+    },
+    'area': {
+        'light': {
+            'type': 'rectangle',
+            'to_world': mi.ScalarTransform4f.translate([0, 3, 0]) @
+                        mi.ScalarTransform4f.rotate([1, 0, 0], 90),
+            'emitter': {
+                'type': 'area',
+                'radiance': { 'type': 'rgb', 'value': 5.0 }
+            }
+        }
+    },
+    'constant': {
+        'emitter': { 'type': 'constant' }
+    }
+}
+
+
+@pytest.mark.parametrize('emitter', list(EMITTERS))
+def test01_bdpt_matches_path(variant_scalar_rgb, emitter):
+    scene = make_scene(EMITTERS[emitter])
+
+    image_path = mi.load_dict({
+        'type': 'path',
+        'max_depth': 4
+    }).render(scene, seed=0, spp=256)
+
+    image_bdpt = mi.load_dict({
+        'type': 'bdpt',
+        'max_depth': 4
+    }).render(scene, seed=0, spp=256)
+
+    # All strategies are weighted to form a single unbiased estimator
+    mean_path = dr.mean(image_path.array)
+    mean_bdpt = dr.mean(image_bdpt.array)
+    assert dr.allclose(mean_path, mean_bdpt, rtol=5e-2)
+
+
+def test02_direct_only(variant_scalar_rgb):
+    # With max_depth=2, light paths only connect their first vertex to the sensor
+    scene = make_scene(EMITTERS['area'])
+
+    image_direct = mi.load_dict({
+        'type': 'path',
+        'max_depth': 2
+    }).render(scene, seed=0, spp=256)
+
+    image_bdpt = mi.load_dict({
+        'type': 'bdpt',
+        'max_depth': 2
+    }).render(scene, seed=0, spp=256)
+
+    assert dr.allclose(dr.mean(image_direct.array),
+                       dr.mean(image_bdpt.array), rtol=5e-2)
+
+
+def test03_unsupported_variant(variant_scalar_spectral):
+    with pytest.raises(RuntimeError, match='spectral'):
+        mi.load_dict({'type': 'bdpt'})
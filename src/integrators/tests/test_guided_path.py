@@ -0,0 +1,63 @@
+import pytest
+import drjit as dr
+import mitsuba as mi
+
+
+def make_scene():
+    return mi.load_dict({
+        'type': 'scene',
+        'sensor': {
+            'type': 'perspective',
+            'to_world': mi.ScalarTransform4f.look_at(origin=[0, 0, 4],
+                                                     target=[0, 0, 0],
+                                                     up=[0, 1, 0]),
+            'film': {
+                'type': 'hdrfilm',
+                'width': 16,
+                'height': 16,
+                'rfilter': { 'type': 'box' }
+            }
+        },
+        'sphere': {
+            'type': 'sphere',
+            'bsdf': { 'type': 'diffuse' }
+        },
+        'floor': {
+            'type': 'rectangle',
+            'to_world': mi.ScalarTransform4f.translate([0, -1, 0]) @
+                        mi.ScalarTransform4f.rotate([1, 0, 0], -90) @
+                        mi.ScalarTransform4f.scale(5),
+            'bsdf': { 'type': 'roughconductor' }
+        },
+        'emitter': {
+            'type': 'point',
+            'position': [0, 3, 2],
+            'intensity': { 'type': 'rgb', 'value': 10.0 }
+        }
+    })
+
+
+def test01_guided_matches_path(variant_scalar_rgb):
+    scene = make_scene()
+
+    image_path = mi.load_dict({
+        'type': 'path',
+        'max_depth': 4
+    }).render(scene, seed=0, spp=64)
+
+    image_guided = mi.load_dict({
+        'type': 'guided_path',
+        'max_depth': 4,
+        'training_iterations': 4,
+        'spatial_threshold': 100
+    }).render(scene, seed=0, spp=64)
+
+    # Guiding only changes the sampling strategy, the mean must agree
+    mean_path = dr.mean(image_path.array)
+    mean_guided = dr.mean(image_guided.array)
+    assert dr.allclose(mean_path, mean_guided, rtol=5e-2)
+
+
+def test02_invalid_parameters(variant_scalar_rgb):
+    with pytest.raises(RuntimeError):
+        mi.load_dict({'type': 'guided_path', 'bsdf_sampling_fraction': 0.0})
@@ -0,0 +1,101 @@
+import pytest
+import drjit as dr
+import mitsuba as mi
+
+
+def make_scene():
+    return mi.load_dict({
+        'type': 'scene',
+        'sensor': {
+            'type': 'perspective',
+            'to_world': mi.ScalarTransform4f.look_at(origin=[0, 0, 4],
+                                                     target=[0, 0, 0],
+                                                     up=[0, 1, 0]),
+            'film': {
+                'type': 'hdrfilm',
+                'width': 8,
+                'height': 8,
+                'rfilter': { 'type': 'box' }
+            }
+        },
+        'sphere': {
+            'type': 'sphere',
+            'bsdf': { 'type': 'diffuse' }
+        },
+        'emitter': { 'type': 'constant' }
+    })
+
+
+def test01_aovs(variants_all_rgb):
+    integrator = mi.load_dict({
+        'type': 'moment',
+        'nested': { 'type': 'path' }
+    })
+    assert integrator.aov_names() == ['nested.X', 'nested.Y', 'nested.Z',
+                                      'm2_nested.X', 'm2_nested.Y', 'm2_nested.Z']
+
+    integrator = mi.load_dict({
+        'type': 'moment',
+        'online': True,
+        'nested': { 'type': 'path' }
+    })
+    assert integrator.aov_names() == ['nested.X', 'nested.Y', 'nested.Z']
+
+
+def test02_online_matches_moments(variant_scalar_rgb):
+    scene = make_scene()
+    spp = 16
+
+    # Variance from the second moment AOVs (the box filter weighs all samples equally)
+    image = mi.load_dict({
+        'type': 'moment',
+        'nested': { 'type': 'path' }
+    }).render(scene, seed=0, spp=spp)
+    assert image.shape == (8, 8, 9)
+
+    # Channels: R, G, B, X, Y, Z, m2_X, m2_Y, m2_Z
+    m1 = [image.array[9 * i + 4] for i in range(64)]
+    m2 = [image.array[9 * i + 7] for i in range(64)]
+
+    integrator = mi.load_dict({
+        'type': 'moment',
+        'online': True,
+        'nested': { 'type': 'path' }
+    })
+    integrator.render(scene, seed=0, spp=spp)
+    params = mi.traverse(integrator)
+    error = params['relative_error']
+    assert error.shape == (8, 8, 1)
+
+    for i in range(64):
+        variance = max(m2[i] - m1[i] * m1[i], 0) * spp / (spp - 1)
+        expected = (variance / spp) ** 0.5 / m1[i] if m1[i] != 0 else 0
+        assert dr.allclose(error.array[i], expected, rtol=1e-2, atol=1e-4)
+
+
+def test03_convergence(variants_all_rgb):
+    scene = make_scene()
+    integrator = mi.load_dict({
+        'type': 'moment',
+        'online': True,
+        'nested': { 'type': 'path' }
+    })
+    params = mi.traverse(integrator)
+    assert params['convergence'] == float('inf')
+
+    integrator.render(scene, seed=0, spp=4)
+    params = mi.traverse(integrator)
+    error_4 = params['convergence']
+    assert error_4 > 0 and error_4 < float('inf')
+
+    # The statistics accumulate across calls to render()
+    for i in range(1, 4):
+        integrator.render(scene, seed=i, spp=4)
+    params = mi.traverse(integrator)
+    error_16 = params['convergence']
+    assert dr.allclose(error_16, error_4 / 2, rtol=0.2)
+
+    # Updating the error discards the statistics
+    params['relative_error'] = params['relative_error']
+    params.update()
+    assert mi.traverse(integrator)['convergence'] == float('inf')
@@ -0,0 +1,397 @@
+import pytest
+import drjit as dr
+import mitsuba as mi
+import numpy as np
+
+from mitsuba.scalar_rgb.test.util import find_resource
+
+
+def test01_packet_tracing_consistent(variant_scalar_rgb):
+    scene = mi.load_file(find_resource('resources/data/scenes/cbox/cbox.xml'))
+
+    spp = 4
+    image = mi.load_dict({
+        'type': 'path',
+        'max_depth': 4
+    }).render(scene, seed=0, spp=spp)
+
+    image_packet = mi.load_dict({
+        'type': 'path',
+        'max_depth': 4,
+        'packet_tracing': True
+    }).render(scene, seed=0, spp=spp)
+
+    # Camera rays traced in packets must be continued with the same samples
+    assert dr.allclose(image, image_packet, rtol=1e-3, atol=1e-3)
+
+
+def test02_reorder_rays_consistent(variants_vec_backends_once_rgb):
+    scene = mi.load_file(find_resource('resources/data/scenes/cbox/cbox.xml'))
+
+    loop_record = dr.flag(dr.JitFlag.LoopRecord)
+    dr.set_flag(dr.JitFlag.LoopRecord, False)
+
+    try:
+        spp = 4
+        image = mi.load_dict({
+            'type': 'path',
+            'max_depth': 6
+        }).render(scene, seed=0, spp=spp)
+
+        image_reordered = mi.load_dict({
+            'type': 'path',
+            'max_depth': 6,
+            'reorder_rays': True
+        }).render(scene, seed=0, spp=spp)
+    finally:
+        dr.set_flag(dr.JitFlag.LoopRecord, loop_record)
+
+    # Reordering only changes the order in which rays are traced
+    assert dr.allclose(image, image_reordered, rtol=1e-4, atol=1e-4)
+
+
+def test03_adaptive_sampling(variants_all_rgb):
+    scene = mi.load_dict({
+        'type': 'scene',
+        'sensor': {
+            'type': 'perspective',
+            'film': {
+                'type': 'hdrfilm',
+                'width': 16,
+                'height': 16,
+                'rfilter': { 'type': 'box' }
+            }
+        },
+        'emitter': { 'type': 'constant' }
+    })
+
+    # Directly visible constant emitter: every sample has the same value
+    image = mi.load_dict({
+        'type': 'path',
+        'adaptive_threshold': 0.01,
+        'adaptive_min_spp': 4
+    }).render(scene, seed=0, spp=64)
+
+    assert dr.allclose(image, 1.0)
+
+    with pytest.raises(RuntimeError):
+        mi.load_dict({'type': 'path', 'adaptive_threshold': -1.0})
+
+
+def test04_progressive_rendering(variants_all_rgb, tmp_path):
+    scene = mi.load_dict({
+        'type': 'scene',
+        'sensor': {
+            'type': 'perspective',
+            'film': {
+                'type': 'hdrfilm',
+                'width': 16,
+                'height': 16,
+                'rfilter': { 'type': 'box' }
+            }
+        },
+        'emitter': { 'type': 'constant' }
+    })
+
+    snapshot = str(tmp_path / 'snapshot.exr')
+    image = mi.load_dict({
+        'type': 'path',
+        'progressive_spp': 2,
+        'snapshot_interval': 1e-6,
+        'snapshot_path': snapshot
+    }).render(scene, seed=0, spp=8)
+
+    # Every pass is committed to the film, so the estimate stays normalized
+    assert dr.allclose(image, 1.0)
+
+    mi.Thread.wait_for_tasks()
+    assert dr.allclose(mi.TensorXf(mi.Bitmap(snapshot)), 1.0)
+
+    with pytest.raises(RuntimeError):
+        mi.load_dict({'type': 'path', 'snapshot_interval': 1.0})
+
+
+@pytest.mark.parametrize("loop_record", [True, False])
+def test05_adrrs_unbiased(variants_all_rgb, loop_record):
+    scene = mi.load_file(find_resource('resources/data/scenes/cbox/cbox.xml'))
+
+    if not dr.is_jit_v(mi.Float) and not loop_record:
+        pytest.skip("Loop recording only applies to JIT variants")
+
+    flag = dr.flag(dr.JitFlag.LoopRecord)
+    dr.set_flag(dr.JitFlag.LoopRecord, loop_record)
+
+    try:
+        spp = 16
+        image = mi.load_dict({
+            'type': 'path',
+            'max_depth': 6
+        }).render(scene, seed=0, spp=spp)
+
+        image_adrrs = mi.load_dict({
+            'type': 'path',
+            'max_depth': 6,
+            'adrrs': True,
+            'adrrs_spp': 2
+        }).render(scene, seed=1, spp=spp)
+    finally:
+        dr.set_flag(dr.JitFlag.LoopRecord, flag)
+
+    # Roulette and splitting only change the noise, not the expected value
+    assert dr.allclose(dr.mean(image.array), dr.mean(image_adrrs.array),
+                       rtol=5e-2)
+
+    with pytest.raises(RuntimeError):
+        mi.load_dict({'type': 'path', 'adrrs_max_split': 0})
+
+
+def test06_staged_wavefront(variants_vec_backends_once_rgb):
+    scene = mi.load_file(find_resource('resources/data/scenes/cbox/cbox.xml'))
+
+    spp = 16
+    image = mi.load_dict({
+        'type': 'path',
+        'max_depth': 8
+    }).render(scene, seed=0, spp=spp)
+
+    image_staged = mi.load_dict({
+        'type': 'path',
+        'max_depth': 8,
+        'staged': True
+    }).render(scene, seed=1, spp=spp)
+
+    # Staged execution uses different random numbers, compare the mean only
+    assert dr.allclose(dr.mean(image.array), dr.mean(image_staged.array),
+                       rtol=5e-2)
+
+
+def test07_checkpoint_resume(variants_all_rgb, tmp_path):
+    scene = mi.load_dict({
+        'type': 'scene',
+        'sensor': {
+            'type': 'perspective',
+            'film': {
+                'type': 'hdrfilm',
+                'width': 16,
+                'height': 16,
+                'rfilter': { 'type': 'box' }
+            }
+        },
+        'emitter': { 'type': 'constant' }
+    })
+
+    checkpoint = tmp_path / 'render.ckpt'
+
+    def integrator(**kwargs):
+        return mi.load_dict({
+            'type': 'path',
+            'progressive_spp': 2,
+            'checkpoint_interval': 1e-6,
+            'checkpoint_path': str(checkpoint),
+            **kwargs
+        })
+
+    # An exhausted time budget interrupts the render after the first pass
+    integrator(timeout=1e-6).render(scene, seed=3, spp=8)
+    assert checkpoint.exists()
+
+    # A checkpoint of a different configuration is ignored
+    image = integrator().render(scene, seed=4, spp=8)
+    assert dr.allclose(image, 1.0)
+    assert not checkpoint.exists()
+
+    # The same configuration resumes, and removes the checkpoint once done
+    integrator(timeout=1e-6).render(scene, seed=3, spp=8)
+    image = integrator().render(scene, seed=3, spp=8)
+    assert dr.allclose(image, 1.0)
+    assert not checkpoint.exists()
+
+    with pytest.raises(RuntimeError):
+        mi.load_dict({'type': 'path', 'checkpoint_interval': 1.0})
+
+
+def test08_sample_budget(variants_all_rgb):
+    scene = mi.load_dict({
+        'type': 'scene',
+        'sensor': {
+            'type': 'perspective',
+            'film': {
+                'type': 'hdrfilm',
+                'width': 16,
+                'height': 16,
+                'rfilter': { 'type': 'box' }
+            }
+        },
+        'emitter': { 'type': 'constant' }
+    })
+
+    integrator = mi.load_dict({'type': 'path'})
+    film = scene.sensors()[0].film()
+
+    # Left half: full sample count, right half: a quarter of it
+    budget = np.ones((16, 16), dtype=np.float32)
+    budget[:, 8:] = 0.25
+    integrator.set_sample_budget(mi.TensorXf(budget))
+    assert integrator.has_sample_budget()
+
+    image = integrator.render(scene, seed=0, spp=16)
+    assert dr.allclose(image, 1.0)
+
+    # With a box filter, the weight channel counts the samples of every pixel
+    weight = np.array(film.develop(raw=True))[..., -1]
+    assert np.all(weight[:, :8] == 16)
+    assert np.all(weight[:, 8:] == 4)
+
+    # Region of interest around the top left corner
+    integrator.set_sample_budget(mi.ScalarPoint2f(0, 0), 4, 4, 0.0)
+    assert integrator.budget_sample_count(mi.ScalarPoint2i(0, 0), 16) == 16
+    assert integrator.budget_sample_count(mi.ScalarPoint2i(15, 15), 16) == 1
+
+    integrator.render(scene, seed=0, spp=16)
+    weight = np.array(film.develop(raw=True))[..., -1]
+    assert weight[0, 0] == 16 and weight[15, 15] == 1
+
+    integrator.clear_sample_budget()
+    assert not integrator.has_sample_budget()
+
+
+def test09_sort_bsdfs_consistent(variants_vec_backends_once_rgb):
+    scene = mi.load_file(find_resource('resources/data/scenes/cbox/cbox.xml'))
+    spp = 4
+
+    # Sorting by BSDF only changes the order in which the lanes are shaded
+    for staged in [False, True]:
+        loop_record = dr.flag(dr.JitFlag.LoopRecord)
+        dr.set_flag(dr.JitFlag.LoopRecord, staged)
+
+        try:
+            image = mi.load_dict({
+                'type': 'path',
+                'max_depth': 6,
+                'staged': staged
+            }).render(scene, seed=0, spp=spp)
+
+            image_sorted = mi.load_dict({
+                'type': 'path',
+                'max_depth': 6,
+                'staged': staged,
+                'sort_bsdfs': True
+            }).render(scene, seed=0, spp=spp)
+        finally:
+            dr.set_flag(dr.JitFlag.LoopRecord, loop_record)
+
+        assert dr.allclose(image, image_sorted, rtol=1e-4, atol=1e-4)
+
+
+def test10_primary_ray_cache(variants_vec_backends_once_rgb):
+    scene = mi.load_file(find_resource('resources/data/scenes/cbox/cbox.xml'))
+    spp = 16
+
+    image = mi.load_dict({
+        'type': 'path',
+        'max_depth': 6
+    }).render(scene, seed=0, spp=spp)
+
+    integrator = mi.load_dict({
+        'type': 'path',
+        'max_depth': 6,
+        'progressive_spp': 4,
+        'primary_ray_cache': 2
+    })
+
+    # The second render reuses the camera rays and intersections of the first
+    image_cached = integrator.render(scene, seed=0, spp=spp)
+    image_reused = integrator.render(scene, seed=0, spp=spp)
+    assert dr.allclose(image_cached, image_reused)
+
+    integrator.clear_primary_ray_cache()
+    image_rebuilt = integrator.render(scene, seed=0, spp=spp)
+    assert dr.allclose(image_cached, image_rebuilt)
+
+    # The jitter patterns only change the antialiasing, compare the mean
+    assert dr.allclose(dr.mean(image.array), dr.mean(image_cached.array),
+                       rtol=5e-2)
+
+
+@pytest.mark.parametrize('integrator', ['path', 'volpath'])
+def test11_emitter_samples(variants_vec_backends_once_rgb, integrator):
+    scene = mi.load_file(find_resource('resources/data/scenes/cbox/cbox.xml'))
+
+    spp = 16
+    image = mi.load_dict({
+        'type': integrator,
+        'max_depth': 4
+    }).render(scene, seed=0, spp=spp)
+
+    means = []
+    for adaptive in [False, True]:
+        image_em = mi.load_dict({
+            'type': integrator,
+            'max_depth': 4,
+            'emitter_samples': 4,
+            'adaptive_emitter_samples': adaptive
+        }).render(scene, seed=1, spp=spp)
+        means.append(dr.mean(image_em.array))
+
+    # Additional emitter samples only reduce the noise of direct illumination
+    for mean in means:
+        assert dr.allclose(dr.mean(image.array), mean, rtol=5e-2)
+
+    with pytest.raises(RuntimeError):
+        mi.load_dict({'type': integrator, 'emitter_samples': 0})
+
+
+def test12_staged_emitter_samples(variants_vec_backends_once_rgb):
+    scene = mi.load_file(find_resource('resources/data/scenes/cbox/cbox.xml'))
+
+    spp = 16
+    image = mi.load_dict({
+        'type': 'path',
+        'max_depth': 4
+    }).render(scene, seed=0, spp=spp)
+
+    # The shadow rays of all emitter samples are traced as one wavefront
+    image_staged = mi.load_dict({
+        'type': 'path',
+        'max_depth': 4,
+        'staged': True,
+        'emitter_samples': 4
+    }).render(scene, seed=1, spp=spp)
+
+    assert dr.allclose(dr.mean(image.array), dr.mean(image_staged.array),
+                       rtol=5e-2)
+
+
+@pytest.mark.parametrize('integrator', ['path', 'prb'])
+def test13_render_ensemble(variants_vec_backends_once_rgb, integrator):
+    scene = mi.load_file(find_resource('resources/data/scenes/cbox/cbox.xml'))
+    integrator = mi.load_dict({'type': integrator, 'max_depth': 4})
+
+    spp = 16
+    image = integrator.render(scene, seed=0, spp=spp)
+    ensemble = integrator.render_ensemble(scene, 3, seed=1, spp=spp)
+    assert ensemble.shape == (3, *image.shape)
+
+    # The members are independent renderings of the same image
+    members = [ensemble[i] for i in range(3)]
+    for member in members:
+        assert dr.allclose(dr.mean(image.array), dr.mean(member.array),
+                           rtol=5e-2)
+    assert not dr.allclose(members[0], members[1])
+
+
+def test14_staged_split_calls(variants_vec_backends_once_rgb):
+    scene = mi.load_file(find_resource('resources/data/scenes/cbox/cbox.xml'))
+
+    images = []
+    for split_calls in [False, True]:
+        images.append(mi.load_dict({
+            'type': 'path',
+            'max_depth': 4,
+            'staged': True,
+            'split_calls': split_calls
+        }).render(scene, seed=0, spp=8))
+
+    # Evaluating the calls per instance doesn't change the result
+    assert dr.allclose(images[0], images[1], rtol=1e-4, atol=1e-4)
+    assert dr.flag(dr.JitFlag.VCallRecord)
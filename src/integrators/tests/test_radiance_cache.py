@@ -0,0 +1,83 @@
+import pytest
+import drjit as dr
+import mitsuba as mi
+
+
+def make_scene():
+    return mi.load_dict({
+        'type': 'scene',
+        'sensor': {
+            'type': 'perspective',
+            'to_world': mi.ScalarTransform4f.look_at(origin=[0, 0, 4],
+                                                     target=[0, 0, 0],
+                                                     up=[0, 1, 0]),
+            'film': {
+                'type': 'hdrfilm',
+                'width': 16,
+                'height': 16,
+                'rfilter': { 'type': 'box' }
+            }
+        },
+        'sphere': {
+            'type': 'sphere',
+            'bsdf': { 'type': 'diffuse' }
+        },
+        'floor': {
+            'type': 'rectangle',
+            'to_world': mi.ScalarTransform4f.translate([0, -1, 0]) @
+                        mi.ScalarTransform4f.rotate([1, 0, 0], -90) @
+                        mi.ScalarTransform4f.scale(5),
+            'bsdf': { 'type': 'diffuse' }
+        },
+        'light': {
+            'type': 'rectangle',
+            'to_world': mi.ScalarTransform4f.translate([0, 3, 0]) @
+                        mi.ScalarTransform4f.rotate([1, 0, 0], 90),
+            'emitter': {
+                'type': 'area',
+                'radiance': { 'type': 'rgb', 'value': 5.0 }
+            }
+        }
+    })
+
+
+def test01_matches_path(variants_all_rgb):
+    scene = make_scene()
+
+    image_path = mi.load_dict({
+        'type': 'path',
+        'max_depth': 6
+    }).render(scene, seed=0, spp=256)
+
+    image_cache = mi.load_dict({
+        'type': 'radiance_cache',
+        'max_depth': 6,
+        'samples_per_pass': 16
+    }).render(scene, seed=0, spp=256)
+
+    # The cache is biased, but the overall brightness should match
+    assert dr.allclose(dr.mean(image_path.array),
+                       dr.mean(image_cache.array), rtol=5e-2)
+
+
+def test02_direct_only(variants_all_rgb):
+    # Paths never reach the cache lookup at the second smooth vertex
+    scene = make_scene()
+
+    image_direct = mi.load_dict({
+        'type': 'path',
+        'max_depth': 2
+    }).render(scene, seed=0, spp=64)
+
+    image_cache = mi.load_dict({
+        'type': 'radiance_cache',
+        'max_depth': 2
+    }).render(scene, seed=0, spp=64)
+
+    assert dr.allclose(dr.mean(image_direct.array),
+                       dr.mean(image_cache.array), rtol=2e-2)
+
+
+def test03_unsupported_variant(variant_scalar_spectral):
+    with pytest.raises(RuntimeError, match='spectral'):
+        mi.load_dict({'type': 'radiance_cache'})
@@ -0,0 +1,89 @@
+import pytest
+import drjit as dr
+import mitsuba as mi
+
+
+def make_scene(glass=False):
+    scene = {
+        'type': 'scene',
+        'sensor': {
+            'type': 'perspective',
+            'to_world': mi.ScalarTransform4f.look_at(origin=[0, 0, 4],
+                                                     target=[0, 0, 0],
+                                                     up=[0, 1, 0]),
+            'film': {
+                'type': 'hdrfilm',
+                'width': 16,
+                'height': 16,
+                'rfilter': { 'type': 'box' }
+            }
+        },
+        'sphere': {
+            'type': 'sphere',
+            'bsdf': { 'type': 'dielectric' if glass else 'diffuse' }
+        },
+        'floor': {
+            'type': 'rectangle',
+            'to_world': mi.ScalarTransform4f.translate([0, -1, 0]) @
+                        mi.ScalarTransform4f.rotate([1, 0, 0], -90) @
+                        mi.ScalarTransform4f.scale(5),
+            'bsdf': { 'type': 'diffuse' }
+        },
+        'emitter': {
+            'type': 'point',
+            'position': [0, 3, 2],
+            'intensity': { 'type': 'rgb', 'value': 10.0 }
+        }
+    }
+    return mi.load_dict(scene)
+
+
+def test01_sppm_matches_path(variants_all_rgb):
+    if mi.variant().endswith('polarized_rgb'):
+        pytest.skip('The photon mapper does not support polarized variants')
+
+    scene = make_scene()
+    image_path = mi.load_dict({
+        'type': 'path',
+        'max_depth': 6
+    }).render(scene, seed=0, spp=256)
+
+    image_sppm = mi.load_dict({
+        'type': 'sppm',
+        'max_depth': 6,
+        'photon_count': 100000,
+        'initial_radius': 0.05
+    }).render(scene, seed=0, spp=64)
+
+    # Both estimators converge to the same image (up to the blurring bias)
+    mean_path = dr.mean(image_path.array)
+    mean_sppm = dr.mean(image_sppm.array)
+    assert dr.allclose(mean_path, mean_sppm, rtol=5e-2)
+
+
+def test02_caustic(variants_all_rgb):
+    if mi.variant().endswith('polarized_rgb'):
+        pytest.skip('The photon mapper does not support polarized variants')
+
+    # The path tracer cannot render the caustic of a point light through glass
+    scene = make_scene(glass=True)
+    image_path = mi.load_dict({'type': 'path'}).render(scene, seed=0, spp=16)
+    image_sppm = mi.load_dict({
+        'type': 'sppm',
+        'photon_count': 100000,
+        'initial_radius': 0.05
+    }).render(scene, seed=0, spp=16)
+
+    assert dr.mean(image_sppm.array)[0] > 1.05 * dr.mean(image_path.array)[0]
+
+
+def test03_invalid_parameters(variant_scalar_rgb):
+    with pytest.raises(RuntimeError):
+        mi.load_dict({'type': 'sppm', 'photon_count': 0})
+    with pytest.raises(RuntimeError):
+        mi.load_dict({'type': 'sppm', 'alpha': 1.5})
+
+
+def test04_unsupported_variant(variant_scalar_spectral):
+    with pytest.raises(RuntimeError, match='spectral'):
+        mi.load_dict({'type': 'sppm'})
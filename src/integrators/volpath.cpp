@@ -36,6 +36,17 @@ Volumetric path tracer (:monosp:`volpath`)
    - |bool|
    - Hide directly visible emitters. (Default: no, i.e. |false|)
 
+ * - emitter_samples
+   - |int|
+   - Number of emitter samples taken at every surface and medium interaction.
+     (Default: 1)
+
+ * - adaptive_emitter_samples
+   - |bool|
+   - Scale the number of emitter samples of an interaction by the largest
+     component of its path throughput (taking at least one sample), as in
+     the :ref:`path tracer <integrator-path>`. (Default: no, i.e. |false|)
+
 This plugin provides a volumetric path tracer that can be used to compute approximate solutions
 of the radiative transfer equation. Its implementation makes use of multiple importance sampling
 to combine BSDF and phase function sampling with direct illumination sampling strategies. On
@@ -48,6 +59,14 @@ has a :ref:`null <bsdf-null>` or :ref:`thin dielectric <bsdf-thindielectric>` BS
 to it (as compared to, say, a :ref:`dielectric <bsdf-dielectric>` or
 :ref:`roughdielectric <bsdf-roughdielectric>` BSDF).
 
+Shadow rays evaluate the transmittance of :ref:`homogeneous <medium-homogeneous>` media in closed
+form instead of tracking collisions through them, which is both faster and noise-free.
+
+The emission of media with a :monosp:`radiance` volume is gathered at every tentative collision
+along the path. When a :ref:`volume light <emitter-volumelight>` references such a medium, this
+only happens on camera rays and after phase function or BSDF samples that didn't use emitter
+sampling, since the emission is then accounted for by the shadow rays toward it.
+
 .. note:: This integrator does not implement good sampling strategies to render
     participating media with a spectrally varying extinction coefficient. For these cases,
     it is better to use the more advanced :ref:`volumetric path tracer with
@@ -73,11 +92,19 @@ template <typename Float, typename Spectrum>
 class VolumetricPathIntegrator : public MonteCarloIntegrator<Float, Spectrum> {
 
 public:
-    MI_IMPORT_BASE(MonteCarloIntegrator, m_max_depth, m_rr_depth, m_hide_emitters)
+    MI_IMPORT_BASE(MonteCarloIntegrator, m_max_depth, m_rr_depth, m_hide_emitters,
+                   m_cost_aovs)
     MI_IMPORT_TYPES(Scene, Sampler, Emitter, EmitterPtr, BSDF, BSDFPtr,
                      Medium, MediumPtr, PhaseFunctionContext)
 
+    using CostCounters = typename Base::CostCounters;
+
     VolumetricPathIntegrator(const Properties &props) : Base(props) {
+        m_emitter_samples = props.get<uint32_t>("emitter_samples", 1);
+        if (m_emitter_samples == 0)
+            Throw("\"emitter_samples\" must be greater than zero.");
+        m_adaptive_emitter_samples =
+            props.get<bool>("adaptive_emitter_samples", false);
     }
 
     MI_INLINE
@@ -96,7 +123,7 @@ public:
                                      Sampler *sampler,
                                      const RayDifferential3f &ray_,
                                      const Medium *initial_medium,
-                                     Float * /* aovs */,
+                                     Float *aovs,
                                      Mask active) const override {
         MI_MASKED_FUNCTION(ProfilerPhase::SamplingIntegratorSample, active);
 
@@ -127,14 +154,22 @@ public:
         Interaction3f last_scatter_event = dr::zeros<Interaction3f>();
         Float last_scatter_direction_pdf = 1.f;
 
+        // Counters of the work performed along the path (if requested)
+        CostCounters cost;
+        UInt32 *null_steps = m_cost_aovs ? &cost.null_steps : nullptr;
+
         /* Set up a Dr.Jit loop (optimizes away to a normal loop in scalar mode,
            generates wavefront or megakernel renderer based on configuration).
            Register everything that changes as part of the loop here */
-        dr::Loop<Mask> loop("Volpath integrator",
-                            /* loop state: */ active, depth, ray, throughput,
-                            result, si, mei, medium, eta, last_scatter_event,
-                            last_scatter_direction_pdf, needs_intersection,
-                            specular_chain, valid_ray, sampler);
+        dr::Loop<Mask> loop("Volpath integrator");
+        loop.put(/* loop state: */ active, depth, ray, throughput,
+                 result, si, mei, medium, eta, last_scatter_event,
+                 last_scatter_direction_pdf, needs_intersection,
+                 specular_chain, valid_ray);
+        sampler->loop_put(loop);
+        if (m_cost_aovs)
+            loop.put(cost.vertices, cost.shadow_rays, cost.null_steps);
+        loop.init();
 
         while (loop(active)) {
             // ----------------- Handle termination of paths ------------------
@@ -184,12 +219,29 @@ public:
                 escaped_medium = active_medium && !mei.is_valid();
                 active_medium &= mei.is_valid();
 
+                /* Collision estimate of the emission of the medium, unless
+                   a volume light already sampled it at the previous vertex */
+                Mask emissive = active_medium && medium->is_emitter() &&
+                                (specular_chain || dr::eq(medium->emitter(), nullptr)) &&
+                                !(dr::eq(depth, 0u) && m_hide_emitters);
+                if (dr::any_or<true>(emissive)) {
+                    Spectrum emitted = depolarizer<Spectrum>(
+                        (mei.sigma_t - mei.sigma_s) * medium->get_radiance(mei, emissive));
+                    if (dr::any_or<true>(not_spectral))
+                        dr::masked(emitted, not_spectral) /=
+                            index_spectrum(mei.combined_extinction, channel);
+                    dr::masked(result, emissive) += throughput * emitted;
+                }
+
                 // Handle null and real scatter events
                 Mask null_scatter = sampler->next_1d(active_medium) >= index_spectrum(mei.sigma_t, channel) / index_spectrum(mei.combined_extinction, channel);
 
                 act_null_scatter |= null_scatter && active_medium;
                 act_medium_scatter |= !act_null_scatter && active_medium;
 
+                if (m_cost_aovs)
+                    cost.null_steps += dr::select(act_null_scatter, UInt32(1), UInt32(0));
+
                 if (dr::any_or<true>(is_spectral && act_null_scatter))
                     dr::masked(throughput, is_spectral && act_null_scatter) *=
                         mei.sigma_n * index_spectrum(mei.combined_extinction, channel) /
@@ -203,6 +255,9 @@ public:
             active &= depth < (uint32_t) m_max_depth;
             act_medium_scatter &= active;
 
+            if (m_cost_aovs)
+                cost.vertices += dr::select(act_medium_scatter, UInt32(1), UInt32(0));
+
             if (dr::any_or<true>(act_null_scatter)) {
                 dr::masked(ray.o, act_null_scatter) = mei.p;
                 dr::masked(si.t, act_null_scatter) = si.t - mei.t;
@@ -225,11 +280,18 @@ public:
                 specular_chain |= act_medium_scatter && !sample_emitters;
 
                 Mask active_e = act_medium_scatter && sample_emitters;
-                if (dr::any_or<true>(active_e)) {
-                    auto [emitted, ds] = sample_emitter(mei, scene, sampler, medium, channel, active_e);
-                    auto [phase_val, phase_pdf] = phase->eval_pdf(phase_ctx, mei, ds.d, active_e);
-                    dr::masked(result, active_e) += throughput * phase_val * emitted *
-                                                    mis_weight(ds.pdf, dr::select(ds.delta, 0.f, phase_pdf));
+                UInt32 em_count = emitter_sample_count(throughput);
+                for (uint32_t i = 0; i < m_emitter_samples; ++i) {
+                    Mask active_i = active_e && i < em_count;
+                    if (dr::none_or<false>(active_i))
+                        break;
+                    auto [emitted, ds] = sample_emitter(mei, scene, sampler, medium, channel, active_i, null_steps);
+                    if (m_cost_aovs)
+                        cost.shadow_rays += dr::select(active_i, UInt32(1), UInt32(0));
+                    auto [phase_val, phase_pdf] = phase->eval_pdf(phase_ctx, mei, ds.d, active_i);
+                    dr::masked(result, active_i) += throughput * phase_val * emitted *
+                                                    mis_weight(ds.pdf * Float(em_count), dr::select(ds.delta, 0.f, phase_pdf)) /
+                                                    Float(em_count);
                 }
 
                 // ------------------ Phase function sampling -----------------
@@ -242,7 +304,8 @@ public:
                 Ray3f new_ray  = mei.spawn_ray(wo);
                 dr::masked(ray, act_medium_scatter) = new_ray;
                 needs_intersection |= act_medium_scatter;
-                dr::masked(last_scatter_direction_pdf, act_medium_scatter) = phase_pdf;
+                // The power heuristic is invariant to scaling both PDFs
+                dr::masked(last_scatter_direction_pdf, act_medium_scatter) = phase_pdf / Float(em_count);
                 dr::masked(throughput, act_medium_scatter) *= phase_weight;
             }
 
@@ -273,24 +336,34 @@ public:
                 }
             }
             active_surface &= si.is_valid();
+            if (m_cost_aovs)
+                cost.vertices += dr::select(active_surface, UInt32(1), UInt32(0));
+
             if (dr::any_or<true>(active_surface)) {
                 // --------------------- Emitter sampling ---------------------
                 BSDFContext ctx;
                 BSDFPtr bsdf  = si.bsdf(ray);
                 Mask active_e = active_surface && has_flag(bsdf->flags(), BSDFFlags::Smooth) && (depth + 1 < (uint32_t) m_max_depth);
 
-                if (likely(dr::any_or<true>(active_e))) {
-                    auto [emitted, ds] = sample_emitter(si, scene, sampler, medium, channel, active_e);
+                UInt32 em_count = emitter_sample_count(throughput);
+                for (uint32_t i = 0; i < m_emitter_samples; ++i) {
+                    Mask active_i = active_e && i < em_count;
+                    if (dr::none_or<false>(active_i))
+                        break;
+                    auto [emitted, ds] = sample_emitter(si, scene, sampler, medium, channel, active_i, null_steps);
+                    if (m_cost_aovs)
+                        cost.shadow_rays += dr::select(active_i, UInt32(1), UInt32(0));
 
                     // Query the BSDF for that emitter-sampled direction
                     Vector3f wo       = si.to_local(ds.d);
-                    Spectrum bsdf_val = bsdf->eval(ctx, si, wo, active_e);
+                    Spectrum bsdf_val = bsdf->eval(ctx, si, wo, active_i);
                     bsdf_val = si.to_world_mueller(bsdf_val, -wo, si.wi);
 
                     // Determine probability of having sampled that same
                     // direction using BSDF sampling.
-                    Float bsdf_pdf = bsdf->pdf(ctx, si, wo, active_e);
-                    result[active_e] += throughput * bsdf_val * mis_weight(ds.pdf, dr::select(ds.delta, 0.f, bsdf_pdf)) * emitted;
+                    Float bsdf_pdf = bsdf->pdf(ctx, si, wo, active_i);
+                    result[active_i] += throughput * bsdf_val * mis_weight(ds.pdf * Float(em_count), dr::select(ds.delta, 0.f, bsdf_pdf)) *
+                                        emitted / Float(em_count);
                 }
 
                 // ----------------------- BSDF sampling ----------------------
@@ -310,7 +383,7 @@ public:
 
                 // update the last scatter PDF event if we encountered a non-null scatter event
                 dr::masked(last_scatter_event, non_null_bsdf) = si;
-                dr::masked(last_scatter_direction_pdf, non_null_bsdf) = bs.pdf;
+                dr::masked(last_scatter_direction_pdf, non_null_bsdf) = bs.pdf / Float(em_count);
 
                 valid_ray |= non_null_bsdf;
                 specular_chain |= non_null_bsdf && has_flag(bs.sampled_type, BSDFFlags::Delta);
@@ -321,16 +394,41 @@ public:
             }
             active &= (active_surface | active_medium);
         }
+
+        if (m_cost_aovs)
+            Base::put_cost_aovs(aovs, cost);
+
         return { result, valid_ray };
     }
 
 
-    /// Samples an emitter in the scene and evaluates its attenuated contribution
+    /**
+     * \brief Distance travelled within the bounds of \c medium when
+     * following \c ray up to the distance \c t_end
+     *
+     * This is the distance along which the control extinction of residual
+     * ratio tracking applies.
+     */
+    Float control_distance(MediumPtr medium, const Ray3f &ray, Float t_end,
+                           Mask active) const {
+        auto [aabb_its, mint, maxt] = medium->intersect_aabb(ray);
+        Float t = dr::minimum(t_end, maxt) - dr::maximum(mint, 0.f);
+        return dr::select(active && aabb_its, dr::maximum(t, 0.f), 0.f);
+    }
+
+    /**
+     * \brief Samples an emitter in the scene and evaluates its attenuated
+     * contribution
+     *
+     * The number of null-collision steps taken to estimate the transmittance
+     * is added to \c null_steps, if provided.
+     */
     template <typename Interaction>
     std::tuple<Spectrum, DirectionSample3f>
     sample_emitter(const Interaction &ref_interaction, const Scene *scene,
                    Sampler *sampler, MediumPtr medium,
-                   UInt32 channel, Mask active) const {
+                   UInt32 channel, Mask active,
+                   UInt32 *null_steps = nullptr) const {
         Spectrum transmittance(1.0f);
 
         auto [ds, emitter_val] = scene->sample_emitter_direction(ref_interaction, sampler->next_2d(active), false, active);
@@ -353,10 +451,14 @@ public:
         SurfaceInteraction3f si = dr::zeros<SurfaceInteraction3f>();
         Mask needs_intersection = true;
 
+        UInt32 steps = 0;
+
         dr::Loop<Mask> loop("Volpath integrator emitter sampling");
         loop.put(active, ray, total_dist, needs_intersection, medium, si,
                  transmittance);
         sampler->loop_put(loop);
+        if (null_steps)
+            loop.put(steps);
         loop.init();
         while (loop(dr::detach(active))) {
             Float remaining_dist = max_dist - total_dist;
@@ -369,6 +471,31 @@ public:
             Mask active_medium  = active && dr::neq(medium, nullptr);
             Mask active_surface = active && !active_medium;
 
+            /* The transmittance of homogeneous media up to the next surface
+               has a closed form, hence no collisions need to be tracked */
+            Mask homogeneous = active_medium && medium->is_homogeneous();
+            if (dr::any_or<true>(homogeneous)) {
+                Mask intersect = needs_intersection && homogeneous;
+                if (dr::any_or<true>(intersect))
+                    dr::masked(si, intersect) = scene->ray_intersect(ray, intersect);
+                needs_intersection &= !homogeneous;
+
+                MediumInteraction3f mei = dr::zeros<MediumInteraction3f>();
+                mei.p           = ray.o;
+                mei.time        = ray.time;
+                mei.wavelengths = ray.wavelengths;
+                UnpolarizedSpectrum sigma_t;
+                std::tie(std::ignore, std::ignore, sigma_t) =
+                    medium->get_scattering_coefficients(mei, homogeneous);
+
+                dr::masked(transmittance, homogeneous) *= dr::exp(
+                    -sigma_t * control_distance(medium, ray, dr::minimum(remaining_dist, si.t), homogeneous));
+
+                // Continue with the surface interaction (if any)
+                escaped_medium = homogeneous;
+                active_medium &= !homogeneous;
+            }
+
             if (dr::any_or<true>(active_medium)) {
                 auto mei = medium->sample_interaction(ray, sampler->next_1d(active_medium), channel, active_medium);
                 dr::masked(ray.maxt, active_medium && medium->is_homogeneous() && mei.is_valid()) = dr::minimum(mei.t, remaining_dist);
@@ -379,6 +506,13 @@ public:
                 dr::masked(mei.t, active_medium && (si.t < mei.t)) = dr::Infinity<Float>;
                 needs_intersection &= !active_medium;
 
+                /* Residual ratio tracking: the transmittance of the control
+                   extinction along the traversed part of the medium's bounds
+                   is accounted for analytically (zero unless enabled) */
+                UnpolarizedSpectrum sigma_c = medium->get_control_extinction(mei, active_medium);
+                dr::masked(transmittance, active_medium) *=
+                    dr::exp(-sigma_c * control_distance(medium, ray, dr::minimum(remaining_dist, dr::minimum(mei.t, si.t)), active_medium));
+
                 Mask is_spectral = medium->has_spectral_extinction() && active_medium;
                 Mask not_spectral = !is_spectral && active_medium;
                 if (dr::any_or<true>(is_spectral)) {
@@ -393,21 +527,24 @@ public:
                 dr::masked(total_dist, active_medium && (mei.t > remaining_dist) && mei.is_valid()) = ds.dist;
                 dr::masked(mei.t, active_medium && (mei.t > remaining_dist)) = dr::Infinity<Float>;
 
-                escaped_medium = active_medium && !mei.is_valid();
+                escaped_medium |= active_medium && !mei.is_valid();
                 active_medium &= mei.is_valid();
                 is_spectral &= active_medium;
                 not_spectral &= active_medium;
 
                 dr::masked(total_dist, active_medium) += mei.t;
 
+                if (null_steps)
+                    steps += dr::select(active_medium, UInt32(1), UInt32(0));
+
                 if (dr::any_or<true>(active_medium)) {
                     dr::masked(ray.o, active_medium)    = mei.p;
                     dr::masked(si.t, active_medium) = si.t - mei.t;
 
                     if (dr::any_or<true>(is_spectral))
-                        dr::masked(transmittance, is_spectral) *= mei.sigma_n;
+                        dr::masked(transmittance, is_spectral) *= mei.sigma_n + sigma_c;
                     if (dr::any_or<true>(not_spectral))
-                        dr::masked(transmittance, not_spectral) *= mei.sigma_n / mei.combined_extinction;
+                        dr::masked(transmittance, not_spectral) *= (mei.sigma_n + sigma_c) / mei.combined_extinction;
                 }
             }
 
@@ -441,18 +578,38 @@ public:
                 dr::masked(medium, has_medium_trans) = si.target_medium(ray.d);
             }
         }
+
+        if (null_steps)
+            *null_steps += steps;
+
         return { transmittance * emitter_val, ds };
     }
 
     //! @}
     // =============================================================
 
+    /// Number of emitter samples of an interaction with the given throughput
+    UInt32 emitter_sample_count(const Spectrum &throughput) const {
+        if (!m_adaptive_emitter_samples)
+            return m_emitter_samples;
+
+        Float t = dr::detach(dr::max(unpolarized_spectrum(throughput)));
+        UInt32 count = UInt32(dr::ceil(
+            dr::clamp(t, 0.f, 1.f) * (ScalarFloat) m_emitter_samples));
+        return dr::maximum(count, 1u);
+    }
+
+    bool has_cost_counters() const override { return true; }
+
     std::string to_string() const override {
         return tfm::format("VolumetricSimplePathIntegrator[\n"
                            "  max_depth = %i,\n"
-                           "  rr_depth = %i\n"
+                           "  rr_depth = %i,\n"
+                           "  emitter_samples = %u,\n"
+                           "  adaptive_emitter_samples = %s\n"
                            "]",
-                           m_max_depth, m_rr_depth);
+                           m_max_depth, m_rr_depth, m_emitter_samples,
+                           m_adaptive_emitter_samples ? "true" : "false");
     }
 
     Float mis_weight(Float pdf_a, Float pdf_b) const {
@@ -463,6 +620,11 @@ public:
     };
 
     MI_DECLARE_CLASS()
+private:
+    /// Number of emitter samples per interaction
+    uint32_t m_emitter_samples;
+    /// Scale the number of emitter samples by the path throughput?
+    bool m_adaptive_emitter_samples;
 };
 
 MI_IMPLEMENT_CLASS_VARIANT(VolumetricPathIntegrator, MonteCarloIntegrator);
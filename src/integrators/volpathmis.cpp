@@ -50,6 +50,9 @@ and is only marginally slower than the :ref:`simple volumetric path tracer <inte
 Similar to the simple volumetric path tracer, this integrator has special
 support for index-matched transmission events.
 
+Emissive media are handled as in the :ref:`simple volumetric path tracer <integrator-volpath>`,
+with collision estimates weighted by the spectral MIS weights of the path.
+
 .. warning:: This integrator does not support forward-mode differentiation.
 
 .. tabs::
@@ -225,6 +228,20 @@ public:
                 active_medium &= mei.is_valid();
                 is_spectral &= active_medium;
                 not_spectral &= active_medium;
+
+                /* Collision estimate of the emission of the medium, unless
+                   a volume light already sampled it at the previous vertex */
+                Mask emissive = active_medium && medium->is_emitter() &&
+                                (specular_chain || dr::eq(medium->emitter(), nullptr)) &&
+                                !(dr::eq(depth, 0u) && m_hide_emitters);
+                if (dr::any_or<true>(emissive)) {
+                    WeightMatrix p_over_f_e = p_over_f;
+                    update_weights(p_over_f_e, mei.combined_extinction, 1.f, channel,
+                                   not_spectral && emissive);
+                    Spectrum emitted = depolarizer<Spectrum>(
+                        (mei.sigma_t - mei.sigma_s) * medium->get_radiance(mei, emissive));
+                    dr::masked(result, emissive) += mis_weight(p_over_f_e) * emitted;
+                }
             }
 
             if (dr::any_or<true>(active_medium)) {
@@ -374,6 +391,20 @@ public:
         return { result, valid_ray };
     }
 
+    /**
+     * \brief Distance travelled within the bounds of \c medium when
+     * following \c ray up to the distance \c t_end
+     *
+     * This is the distance along which the control extinction of residual
+     * ratio tracking applies.
+     */
+    Float control_distance(MediumPtr medium, const Ray3f &ray, Float t_end,
+                           Mask active) const {
+        auto [aabb_its, mint, maxt] = medium->intersect_aabb(ray);
+        Float t = dr::minimum(t_end, maxt) - dr::maximum(mint, 0.f);
+        return dr::select(active && aabb_its, dr::maximum(t, 0.f), 0.f);
+    }
+
     template <typename Interaction>
     std::tuple<WeightMatrix, WeightMatrix, Spectrum, DirectionSample3f>
     sample_emitter(const Interaction &ref_interaction, const Scene *scene,
@@ -429,6 +460,15 @@ public:
                 dr::masked(mei.t, active_medium && (si.t < mei.t)) = dr::Infinity<Float>;
                 needs_intersection &= !active_medium;
 
+                /* Residual ratio tracking: the transmittance of the control
+                   extinction along the traversed part of the medium's bounds
+                   is accounted for analytically (zero unless enabled) */
+                UnpolarizedSpectrum sigma_c = medium->get_control_extinction(mei, active_medium);
+                UnpolarizedSpectrum tr_c = dr::exp(
+                    -sigma_c * control_distance(medium, ray, dr::minimum(remaining_dist, dr::minimum(mei.t, si.t)), active_medium));
+                update_weights(p_over_f_nee, 1.f, tr_c, channel, active_medium);
+                update_weights(p_over_f_uni, 1.f, tr_c, channel, active_medium);
+
                 Mask is_spectral = medium->has_spectral_extinction() && active_medium;
                 Mask not_spectral = !is_spectral && active_medium;
                 if (dr::any_or<true>(is_spectral)) {
@@ -453,13 +493,14 @@ public:
                     dr::masked(ray.o, active_medium) = mei.p;
                     // Update si.t since we continue the ray into the same direction
                     dr::masked(si.t, active_medium) = si.t - mei.t;
+                    UnpolarizedSpectrum sigma_rn = mei.sigma_n + sigma_c;
                     if (dr::any_or<true>(is_spectral)) {
-                        update_weights(p_over_f_nee, 1.f, mei.sigma_n, channel, is_spectral);
-                        update_weights(p_over_f_uni, mei.sigma_n / mei.combined_extinction, mei.sigma_n, channel, is_spectral);
+                        update_weights(p_over_f_nee, 1.f, sigma_rn, channel, is_spectral);
+                        update_weights(p_over_f_uni, mei.sigma_n / mei.combined_extinction, sigma_rn, channel, is_spectral);
                     }
                     if (dr::any_or<true>(not_spectral)) {
-                        update_weights(p_over_f_nee, 1.f, mei.sigma_n / mei.combined_extinction, channel, not_spectral);
-                        update_weights(p_over_f_uni, mei.sigma_n, mei.sigma_n, channel, not_spectral);
+                        update_weights(p_over_f_nee, 1.f, sigma_rn / mei.combined_extinction, channel, not_spectral);
+                        update_weights(p_over_f_uni, mei.sigma_n, sigma_rn, channel, not_spectral);
                     }
                 }
             }
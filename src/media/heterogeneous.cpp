@@ -31,6 +31,14 @@ Heterogeneous medium (:monosp:`heterogeneous`)
    - Extinction coefficient in inverse scene units (Default: 1).
    - |exposed|, |differentiable|
 
+ * - radiance
+   - |float|, |spectrum| or |volume|
+   - Radiance emitted by the medium. The emission per unit length is the
+     product of this value and the absorption coefficient, hence optically
+     thick regions glow with the given radiance. See below for details.
+     (Default: none, i.e. no emission)
+   - |exposed|, |differentiable|
+
  * - scale
    - |float|
    - Optional scale factor that will be applied to the extinction parameter.
@@ -46,6 +54,33 @@ Heterogeneous medium (:monosp:`heterogeneous`)
      render time. This can reduce render time up to 50% when rendering objects
      with subsurface scattering.
 
+ * - majorant_resolution
+   - |int|
+   - Resolution of a coarse grid of per-supervoxel majorants along every axis of
+     the extinction volume. Free-flight distances are then sampled against the
+     local majorant of each supervoxel that the ray traverses, which avoids
+     many null interactions in volumes of strongly varying density. A value of
+     zero disables the grid and uses a single global majorant. (Default: 0)
+
+ * - empty_space_skipping
+   - |bool|
+   - When a majorant grid is used, clip rays to the bounds of its non-empty
+     supervoxels and let free flights leap over blocks of empty supervoxels
+     instead of visiting them one by one. Each supervoxel stores the
+     chessboard distance to the nearest non-empty one, which is computed once
+     when the medium is created or its parameters change. (Default: |true|)
+
+ * - transmittance_estimator
+   - |string|
+   - Estimator of the transmittance along shadow rays. With :monosp:`ratio`,
+     every tentative collision is weighted by its null-collision probability.
+     With :monosp:`residual_ratio`, the minimum of the extinction volume acts
+     as a control extinction whose transmittance is evaluated in closed form,
+     and only the remaining residual is ratio tracked. This reduces the
+     variance of shadow rays through dense media with a nonzero floor of
+     density. Microflake phase functions fall back to plain ratio tracking.
+     (Default: :monosp:`ratio`)
+
  * - (Nested plugin)
    - |phase|
    - A nested phase function that describes the directional scattering properties of
@@ -68,6 +103,14 @@ meters and the coefficients are in inverse millimeters, set scale to 1000.
 Both the albedo and the extinction coefficient can either be constant or textured,
 and both parameters are allowed to be spectrally varying.
 
+Media with a :monosp:`radiance` parameter emit light, e.g. to render fire and
+explosions. The :ref:`volpath <integrator-volpath>` and :ref:`volpathmis
+<integrator-volpathmis>` integrators gather the emission at every tentative
+collision along the paths. This works well for directly visible emission,
+but scattered light from a small emissive region is then only found by
+chance. Adding a :ref:`volume light <emitter-volumelight>` that references
+the medium enables next event estimation of the emission.
+
 .. tabs::
     .. code-tab:: xml
         :name: lst-heterogeneous
@@ -149,39 +192,190 @@ template <typename Float, typename Spectrum>
 class HeterogeneousMedium final : public Medium<Float, Spectrum> {
 public:
     MI_IMPORT_BASE(Medium, m_is_homogeneous, m_has_spectral_extinction,
-                    m_phase_function)
+                    m_is_emitter, m_phase_function, m_transmittance_estimator)
     MI_IMPORT_TYPES(Scene, Sampler, Texture, Volume)
 
+    using FloatStorage = DynamicBuffer<Float>;
+    using UInt32Storage = DynamicBuffer<UInt32>;
+    using Mask3 = dr::mask_t<Vector3f>;
+
     HeterogeneousMedium(const Properties &props) : Base(props) {
         m_is_homogeneous = false;
         m_albedo = props.volume<Volume>("albedo", 0.75f);
         m_sigmat = props.volume<Volume>("sigma_t", 1.f);
+        if (props.has_property("radiance")) {
+            m_radiance = props.volume<Volume>("radiance", 0.f);
+            m_is_emitter = true;
+        }
 
         m_scale = props.get<ScalarFloat>("scale", 1.0f);
         m_has_spectral_extinction = props.get<bool>("has_spectral_extinction", true);
 
-        m_max_density = dr::opaque<Float>(m_scale * m_sigmat->max());
+        int majorant_res = props.get<int>("majorant_resolution", 0);
+        if (majorant_res < 0)
+            Throw("The majorant resolution must be non-negative!");
+        m_majorant_res = ScalarVector3i(majorant_res);
+        m_empty_space_skipping = props.get<bool>("empty_space_skipping", true);
+
+        update_majorants();
 
         dr::set_attr(this, "is_homogeneous", m_is_homogeneous);
         dr::set_attr(this, "has_spectral_extinction", m_has_spectral_extinction);
+        dr::set_attr(this, "is_emitter", m_is_emitter);
     }
 
     void traverse(TraversalCallback *callback) override {
         callback->put_parameter("scale", m_scale,        +ParamFlags::NonDifferentiable);
         callback->put_object("albedo",   m_albedo.get(), +ParamFlags::Differentiable);
         callback->put_object("sigma_t",  m_sigmat.get(), +ParamFlags::Differentiable);
+        if (m_radiance)
+            callback->put_object("radiance", m_radiance.get(), +ParamFlags::Differentiable);
         Base::traverse(callback);
     }
 
     void parameters_changed(const std::vector<std::string> &/*keys*/ = {}) override {
-        m_max_density = dr::opaque<Float>(m_scale * m_sigmat->max());
+        update_majorants();
     }
 
     UnpolarizedSpectrum
-    get_majorant(const MediumInteraction3f & /* mi */,
+    get_majorant(const MediumInteraction3f &mi,
                  Mask active) const override {
         MI_MASKED_FUNCTION(ProfilerPhase::MediumEvaluate, active);
-        return m_max_density;
+        return local_majorant(mi.p, active);
+    }
+
+    UnpolarizedSpectrum
+    get_control_extinction(const MediumInteraction3f & /* mi */,
+                           Mask active) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::MediumEvaluate, active);
+        return dr::select(active, m_control_extinction, 0.f);
+    }
+
+    MediumInteraction3f sample_interaction(const Ray3f &ray, Float sample,
+                                           UInt32 channel,
+                                           Mask active) const override {
+        if (!has_majorant_grid())
+            return Base::sample_interaction(ray, sample, channel, active);
+
+        MI_MASKED_FUNCTION(ProfilerPhase::MediumSample, active);
+        DRJIT_MARK_USED(channel); // The majorant is spectrally uniform
+
+        MediumInteraction3f mei = dr::zeros<MediumInteraction3f>();
+        mei.wi          = -ray.d;
+        mei.sh_frame    = Frame3f(mei.wi);
+        mei.time        = ray.time;
+        mei.wavelengths = ray.wavelengths;
+
+        auto [aabb_its, mint, maxt] = intersect_aabb(ray);
+        aabb_its &= (dr::isfinite(mint) || dr::isfinite(maxt));
+        active &= aabb_its;
+        dr::masked(mint, !active) = 0.f;
+        dr::masked(maxt, !active) = dr::Infinity<Float>;
+
+        mint = dr::maximum(0.f, mint);
+        maxt = dr::minimum(ray.maxt, maxt);
+        active &= mint < maxt;
+
+        /* Step through the supervoxels with a 3D DDA, working in the local
+           coordinates of the majorant grid. Affine maps preserve the ray
+           parameter, hence distances 't' along the local ray are world-space
+           distances. */
+        Ray3f local_ray = m_sigmat->to_local().transform_affine(ray);
+        Vector3f res  = Vector3f(m_majorant_res),
+                 d    = local_ray.d * res;
+        Vector3f p    = Vector3f(local_ray(mint)) * res;
+
+        Vector3i cell = dr::clamp(dr::floor2int<Vector3i>(p), 0,
+                                  m_majorant_res - 1);
+        Vector3i step = dr::select(d >= 0.f, Vector3i(1), Vector3i(-1)),
+                 next = cell + dr::select(d >= 0.f, Vector3i(1), Vector3i(0));
+        Mask3 valid_d = dr::neq(d, 0.f);
+        Vector3f inv_d   = dr::select(valid_d, dr::rcp(d), 0.f),
+                 t_next  = dr::select(valid_d,
+                                      mint + (Vector3f(next) - p) * inv_d,
+                                      dr::Infinity<Float>),
+                 t_delta = dr::select(valid_d, dr::abs(inv_d),
+                                      dr::Infinity<Float>);
+
+        Float tau       = -dr::log(1.f - sample),
+              t         = mint,
+              sampled_t = dr::Infinity<Float>,
+              majorant  = 0.f;
+        Mask valid_mi = false;
+
+        dr::Loop<Mask> loop("HeterogeneousMedium::sample_interaction", active,
+                            cell, t_next, tau, t, sampled_t, majorant,
+                            valid_mi);
+
+        while (loop(active)) {
+            UInt32 index = linear_index(cell);
+            majorant = dr::gather<Float>(m_majorant_grid, index, active);
+            Vector3i cell_prev = cell;
+
+            Float t_exit = dr::minimum(dr::min(t_next), maxt),
+                  tau_segment = majorant * dr::maximum(t_exit - t, 0.f);
+
+            // Did the free flight end within this supervoxel?
+            Mask hit = active && majorant > 0.f && tau_segment >= tau;
+            dr::masked(sampled_t, hit) = t + tau / majorant;
+            valid_mi |= hit;
+
+            // Otherwise advance to the next supervoxel along the ray
+            Mask advance = active && !hit;
+            dr::masked(tau, advance) -= tau_segment;
+            dr::masked(t, advance) = dr::maximum(t, t_exit);
+
+            Mask step_x = t_next.x() <= t_next.y() && t_next.x() <= t_next.z(),
+                 step_y = !step_x && t_next.y() <= t_next.z(),
+                 step_z = !step_x && !step_y;
+            Mask3 step_mask(step_x, step_y, step_z);
+            dr::masked(cell, advance && step_mask) += step;
+            dr::masked(t_next, advance && step_mask) += t_delta;
+
+            if (has_skip_grid()) {
+                /* All supervoxels within a chessboard distance of 'skip' are
+                   empty, hence leap to the exit of that block of supervoxels
+                   and restart the DDA from there */
+                Int32 skip = Int32(dr::gather<UInt32>(m_skip_grid, index, active));
+                Mask leap = advance && skip > 0;
+                if (dr::any_or<true>(leap)) {
+                    Vector3f lo = Vector3f(cell_prev - skip),
+                             hi = Vector3f(cell_prev + skip + 1);
+                    Vector3f t_block = dr::select(
+                        valid_d, mint + (dr::select(d >= 0.f, hi, lo) - p) * inv_d,
+                        dr::Infinity<Float>);
+                    Float t_leap = dr::minimum(dr::min(t_block), maxt);
+
+                    /* Supervoxel that the ray enters at 't_leap', breaking ties
+                       on cell boundaries towards the direction of travel */
+                    Vector3f p_leap = p + d * (t_leap - mint);
+                    Vector3i cell_leap =
+                        dr::select(d >= 0.f, dr::floor2int<Vector3i>(p_leap),
+                                   dr::ceil2int<Vector3i>(p_leap) - 1);
+                    Vector3f next_leap = Vector3f(
+                        cell_leap + dr::select(d >= 0.f, Vector3i(1), Vector3i(0)));
+
+                    dr::masked(t, leap) = dr::maximum(t, t_leap);
+                    dr::masked(cell, leap) = cell_leap;
+                    dr::masked(t_next, leap) = dr::select(
+                        valid_d, mint + (next_leap - p) * inv_d, dr::Infinity<Float>);
+                    dr::masked(t_exit, leap) = dr::maximum(t_exit, t_leap);
+                }
+            }
+
+            active = advance && t_exit < maxt &&
+                     dr::all(cell >= 0 && cell < m_majorant_res);
+        }
+
+        mei.t      = dr::select(valid_mi, sampled_t, dr::Infinity<Float>);
+        mei.p      = ray(dr::select(valid_mi, sampled_t, maxt));
+        mei.medium = this;
+        mei.mint   = mint;
+
+        std::tie(mei.sigma_s, mei.sigma_n, mei.sigma_t) =
+            get_scattering_coefficients(mei, valid_mi);
+        mei.combined_extinction = majorant;
+        return mei;
     }
 
     std::tuple<UnpolarizedSpectrum, UnpolarizedSpectrum, UnpolarizedSpectrum>
@@ -194,13 +388,30 @@ public:
             sigmat *= m_phase_function->projected_area(mi, active);
 
         auto sigmas = sigmat * m_albedo->eval(mi, active);
-        auto sigman = m_max_density - sigmat;
+        auto sigman = local_majorant(mi.p, active) - sigmat;
         return { sigmas, sigman, sigmat };
     }
 
+    UnpolarizedSpectrum get_radiance(const MediumInteraction3f &mi,
+                                     Mask active) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::MediumEvaluate, active);
+        if (!m_radiance)
+            return dr::zeros<UnpolarizedSpectrum>();
+        return m_radiance->eval(mi, active);
+    }
+
+    ScalarBoundingBox3f bbox() const override { return m_sigmat->bbox(); }
+
     std::tuple<Mask, Float, Float>
     intersect_aabb(const Ray3f &ray) const override {
-        return m_sigmat->bbox().ray_intersect(ray);
+        if (!has_skip_grid())
+            return m_sigmat->bbox().ray_intersect(ray);
+
+        /* Clip against the bounds of the non-empty supervoxels. Affine maps
+           preserve the ray parameter, hence the local distances are valid. */
+        Ray3f local_ray = m_sigmat->to_local().transform_affine(ray);
+        auto [hit, mint, maxt] = m_occupied_bbox.ray_intersect(local_ray);
+        return { hit && m_occupied, mint, maxt };
     }
 
     std::string to_string() const override {
@@ -208,17 +419,160 @@ public:
         oss << "HeterogeneousMedium[" << std::endl
             << "  albedo  = " << string::indent(m_albedo) << std::endl
             << "  sigma_t = " << string::indent(m_sigmat) << std::endl
-            << "  scale   = " << string::indent(m_scale) << std::endl
+            << "  radiance = " << (m_radiance ? string::indent(m_radiance) : "none") << std::endl
+            << "  scale   = " << string::indent(m_scale) << "," << std::endl
+            << "  majorant_resolution = " << m_majorant_res << "," << std::endl
+            << "  empty_space_skipping = " << m_empty_space_skipping << "," << std::endl
+            << "  transmittance_estimator = "
+            << (m_transmittance_estimator == TransmittanceEstimator::ResidualRatioTracking
+                    ? "residual_ratio" : "ratio") << std::endl
             << "]";
         return oss.str();
     }
 
     MI_DECLARE_CLASS()
+private:
+    bool has_majorant_grid() const { return dr::all(m_majorant_res > 0); }
+    bool has_skip_grid() const { return has_majorant_grid() && m_empty_space_skipping; }
+
+    /**
+     * Recompute the global majorant, the majorant grid (if enabled) and the
+     * control extinction of residual ratio tracking (if enabled)
+     */
+    void update_majorants() {
+        m_max_density = dr::opaque<Float>(m_scale * m_sigmat->max());
+
+        /* The projected area of microflake phase functions modulates the
+           extinction, which would invalidate a constant lower bound */
+        ScalarFloat control = 0.f;
+        if (m_transmittance_estimator == TransmittanceEstimator::ResidualRatioTracking &&
+            !has_flag(m_phase_function->flags(), PhaseFunctionFlags::Microflake))
+            control = m_scale * m_sigmat->min();
+        m_control_extinction = dr::opaque<Float>(control);
+
+        if (has_majorant_grid()) {
+            std::vector<ScalarFloat> majorants =
+                m_sigmat->max_per_supervoxel(m_majorant_res);
+            for (ScalarFloat &m : majorants)
+                m *= m_scale;
+            m_majorant_grid = dr::load<FloatStorage>(majorants.data(),
+                                                     majorants.size());
+            if (m_empty_space_skipping)
+                update_skip_grid(majorants);
+        }
+    }
+
+    /**
+     * Compute the bounds of the non-empty supervoxels and, for every empty
+     * supervoxel, the number of surrounding layers of supervoxels that are
+     * guaranteed to be empty as well
+     */
+    void update_skip_grid(const std::vector<ScalarFloat> &majorants) {
+        const ScalarVector3i res = m_majorant_res;
+        const uint32_t cap = (uint32_t) dr::max(res);
+        auto index = [&](int32_t x, int32_t y, int32_t z) {
+            return ((size_t) z * res.y() + y) * res.x() + x;
+        };
+
+        /* Chessboard distance to the nearest non-empty supervoxel, computed
+           exactly by a forward and a backward chamfer pass over the 26-
+           neighborhood */
+        std::vector<uint32_t> dist(majorants.size());
+        ScalarPoint3i lo(res), hi(-1);
+        for (int32_t z = 0; z < res.z(); ++z) {
+            for (int32_t y = 0; y < res.y(); ++y) {
+                for (int32_t x = 0; x < res.x(); ++x) {
+                    bool occupied = majorants[index(x, y, z)] > 0.f;
+                    dist[index(x, y, z)] = occupied ? 0u : cap;
+                    if (occupied) {
+                        lo = dr::minimum(lo, ScalarPoint3i(x, y, z));
+                        hi = dr::maximum(hi, ScalarPoint3i(x, y, z));
+                    }
+                }
+            }
+        }
+
+        auto relax = [&](int32_t x, int32_t y, int32_t z, int32_t sign) {
+            uint32_t &value = dist[index(x, y, z)];
+            for (int32_t dz = -1; dz <= 0; ++dz) {
+                for (int32_t dy = -1; dy <= 1; ++dy) {
+                    for (int32_t dx = -1; dx <= 1; ++dx) {
+                        // Only visit neighbors that precede the current one
+                        if (dz == 0 && (dy > 0 || (dy == 0 && dx >= 0)))
+                            continue;
+                        int32_t nx = x + sign * dx, ny = y + sign * dy,
+                                nz = z + sign * dz;
+                        if (nx < 0 || ny < 0 || nz < 0 || nx >= res.x() ||
+                            ny >= res.y() || nz >= res.z())
+                            continue;
+                        value = std::min(value, dist[index(nx, ny, nz)] + 1);
+                    }
+                }
+            }
+        };
+
+        for (int32_t z = 0; z < res.z(); ++z)
+            for (int32_t y = 0; y < res.y(); ++y)
+                for (int32_t x = 0; x < res.x(); ++x)
+                    relax(x, y, z, 1);
+        for (int32_t z = res.z() - 1; z >= 0; --z)
+            for (int32_t y = res.y() - 1; y >= 0; --y)
+                for (int32_t x = res.x() - 1; x >= 0; --x)
+                    relax(x, y, z, -1);
+
+        // Supervoxels at distance 'd' are surrounded by 'd - 1' empty layers
+        for (uint32_t &value : dist)
+            value = value > 0 ? value - 1 : 0;
+        m_skip_grid = dr::load<UInt32Storage>(dist.data(), dist.size());
+
+        m_occupied = dr::all(hi >= lo);
+        ScalarVector3f inv_res = dr::rcp(ScalarVector3f(res));
+        m_occupied_bbox = m_occupied
+            ? ScalarBoundingBox3f(ScalarPoint3f(lo) * inv_res,
+                                  ScalarPoint3f(hi + 1) * inv_res)
+            : ScalarBoundingBox3f(ScalarPoint3f(0.f), ScalarPoint3f(1.f));
+    }
+
+    /// Flat index of a supervoxel in the majorant grid (x varies fastest)
+    UInt32 linear_index(const Vector3i &cell) const {
+        return UInt32((cell.z() * m_majorant_res.y() + cell.y()) *
+                          m_majorant_res.x() + cell.x());
+    }
+
+    /// Majorant of the supervoxel containing the world-space position \c p
+    Float local_majorant(const Point3f &p, Mask active) const {
+        if (!has_majorant_grid())
+            return m_max_density;
+
+        Point3f p_local = m_sigmat->to_local() * p;
+        Vector3i cell = dr::clamp(
+            dr::floor2int<Vector3i>(Vector3f(p_local) * Vector3f(m_majorant_res)), 0,
+            m_majorant_res - 1);
+        return dr::gather<Float>(m_majorant_grid, linear_index(cell), active);
+    }
+
 private:
     ref<Volume> m_sigmat, m_albedo;
+    /// Emitted radiance (only set for emissive media)
+    ref<Volume> m_radiance;
     ScalarFloat m_scale;
 
     Float m_max_density;
+    /// Control extinction of residual ratio tracking (zero when disabled)
+    Float m_control_extinction;
+
+    /// Resolution of the majorant grid (zero when disabled)
+    ScalarVector3i m_majorant_res;
+    /// Per-supervoxel majorants, already multiplied by \ref m_scale
+    FloatStorage m_majorant_grid;
+
+    bool m_empty_space_skipping;
+    /// Number of empty layers of supervoxels surrounding every supervoxel
+    UInt32Storage m_skip_grid;
+    /// Local-space bounds of the non-empty supervoxels
+    ScalarBoundingBox3f m_occupied_bbox;
+    /// Whether any supervoxel is non-empty
+    bool m_occupied = true;
 };
 
 MI_IMPLEMENT_CLASS_VARIANT(HeterogeneousMedium, Medium)
@@ -46,6 +46,14 @@ Homogeneous medium (:monosp:`homogeneous`)
      render time. This can reduce render time up to 50% when rendering objects
      with subsurface scattering.
 
+ * - transmittance_estimator
+   - |string|
+   - Estimator of the transmittance along shadow rays. With :monosp:`ratio`,
+     every tentative collision is weighted by its null-collision probability.
+     With :monosp:`residual_ratio`, the transmittance of the extinction is
+     evaluated in closed form, which makes shadow rays through this medium
+     noise-free. (Default: :monosp:`ratio`)
+
  * - (Nested plugin)
    - |phase|
    - A nested phase function that describes the directional scattering properties of
@@ -131,7 +139,8 @@ However, it supports the use of a spatially varying albedo.
 template <typename Float, typename Spectrum>
 class HomogeneousMedium final : public Medium<Float, Spectrum> {
 public:
-    MI_IMPORT_BASE(Medium, m_is_homogeneous, m_has_spectral_extinction, m_phase_function)
+    MI_IMPORT_BASE(Medium, m_is_homogeneous, m_has_spectral_extinction, m_phase_function,
+                   m_transmittance_estimator)
     MI_IMPORT_TYPES(Scene, Sampler, Texture, Volume)
 
     HomogeneousMedium(const Properties &props) : Base(props) {
@@ -167,6 +176,16 @@ public:
         return eval_sigmat(mi, active) & active;
     }
 
+    UnpolarizedSpectrum
+    get_control_extinction(const MediumInteraction3f &mi,
+                           Mask active) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::MediumEvaluate, active);
+        if (m_transmittance_estimator != TransmittanceEstimator::ResidualRatioTracking)
+            return 0.f;
+        // The extinction is constant, hence it is its own control extinction
+        return eval_sigmat(mi, active) & active;
+    }
+
     std::tuple<UnpolarizedSpectrum, UnpolarizedSpectrum, UnpolarizedSpectrum>
     get_scattering_coefficients(const MediumInteraction3f &mi,
                                 Mask active) const override {
@@ -0,0 +1,197 @@
+import pytest
+import drjit as dr
+import mitsuba as mi
+
+
+def create_medium(majorant_resolution):
+    # Unit cube whose first half (along x) is empty
+    return mi.load_dict({
+        'type': 'heterogeneous',
+        'sigma_t': {
+            'type': 'gridvolume',
+            'data': mi.TensorXf([0.0, 4.0], shape=[1, 1, 2]),
+            'filter_type': 'nearest'
+        },
+        'majorant_resolution': majorant_resolution
+    })
+
+
+@pytest.mark.parametrize('majorant_resolution', [0, 2])
+def test01_free_flight_transmittance(variants_vec_rgb, majorant_resolution):
+    medium = create_medium(majorant_resolution)
+
+    n = 1000000
+    sampler = mi.load_dict({'type': 'independent'})
+    sampler.seed(0, n)
+
+    ray = mi.Ray3f(mi.Point3f(-1, 0.5, 0.5), mi.Vector3f(1, 0, 0))
+    mei = medium.sample_interaction(ray, sampler.next_1d(), 0, True)
+    valid = mei.is_valid()
+
+    # Probability of crossing the cube without a tentative collision
+    escaped = dr.count(~valid) / n
+    # The global majorant spans the whole cube, the local one only its dense half
+    optical_depth = 4.0 * (0.5 if majorant_resolution > 0 else 1.0)
+    assert dr.allclose(escaped, dr.exp(-optical_depth), rtol=5e-2)
+
+    if majorant_resolution > 0:
+        # Free flights skip the empty half of the medium
+        assert dr.all(dr.select(valid, mei.p.x >= 0.5, True))
+        assert dr.allclose(dr.select(valid, mei.combined_extinction[0], 4.0), 4.0)
+        assert dr.allclose(dr.select(valid, mei.sigma_n[0], 0.0), 0.0)
+
+
+def test02_local_majorant(variants_all_rgb):
+    medium = create_medium(2)
+
+    mei = dr.zeros(mi.MediumInteraction3f)
+    mei.p = mi.Point3f(0.25, 0.5, 0.5)
+    assert dr.allclose(medium.get_majorant(mei)[0], 0.0)
+    mei.p = mi.Point3f(0.75, 0.5, 0.5)
+    assert dr.allclose(medium.get_majorant(mei)[0], 4.0)
+
+
+@pytest.mark.parametrize('estimator', ['ratio', 'residual_ratio'])
+def test03_control_extinction(variants_all_rgb, estimator):
+    medium = mi.load_dict({
+        'type': 'heterogeneous',
+        'sigma_t': {
+            'type': 'gridvolume',
+            'data': mi.TensorXf([1.0, 4.0], shape=[1, 1, 2]),
+            'filter_type': 'nearest'
+        },
+        'scale': 2.0,
+        'transmittance_estimator': estimator
+    })
+
+    mei = dr.zeros(mi.MediumInteraction3f)
+    mei.p = mi.Point3f(0.25, 0.5, 0.5)
+    expected = 2.0 if estimator == 'residual_ratio' else 0.0
+    assert dr.allclose(medium.get_control_extinction(mei)[0], expected)
+
+    # The control extinction never exceeds the extinction
+    mei.p = mi.Point3f(0.75, 0.5, 0.5)
+    _, _, sigma_t = medium.get_scattering_coefficients(mei)
+    assert dr.all(medium.get_control_extinction(mei)[0] <= sigma_t[0])
+
+
+def test04_invalid_estimator(variant_scalar_rgb):
+    with pytest.raises(RuntimeError, match='Invalid transmittance estimator'):
+        mi.load_dict({
+            'type': 'heterogeneous',
+            'transmittance_estimator': 'delta'
+        })
+
+
+@pytest.mark.parametrize('integrator', ['volpath', 'volpathmis'])
+def test05_residual_ratio_tracking(variants_vec_rgb, integrator):
+    # Shadow rays through a slab with a nonzero floor of density
+    def render(estimator):
+        scene = mi.load_dict({
+            'type': 'scene',
+            'integrator': {'type': integrator, 'max_depth': 2},
+            'sensor': {
+                'type': 'perspective',
+                'fov': 10,
+                'to_world': mi.ScalarTransform4f.look_at(
+                    origin=[0.5, 0.5, 4], target=[0.5, 0.5, 0.5], up=[0, 1, 0]),
+                'film': {'type': 'hdrfilm', 'width': 8, 'height': 8},
+                'sampler': {'type': 'independent', 'sample_count': 256}
+            },
+            'emitter': {'type': 'constant'},
+            'medium': {
+                'type': 'heterogeneous',
+                'albedo': 0.5,
+                'sigma_t': {
+                    'type': 'gridvolume',
+                    'data': mi.TensorXf([2.0, 3.0, 2.5, 2.0], shape=[1, 2, 2]),
+                },
+                'transmittance_estimator': estimator
+            },
+            'cube': {
+                'type': 'cube',
+                'to_world': mi.ScalarTransform4f.translate(0.5).scale(0.5),
+                'bsdf': {'type': 'null'},
+                'interior': {'type': 'ref', 'id': 'medium'}
+            }
+        })
+        return mi.render(scene, seed=0)
+
+    # Both estimators are unbiased
+    ratio, residual = render('ratio'), render('residual_ratio')
+    assert dr.allclose(dr.mean(ratio), dr.mean(residual), rtol=5e-2)
+
+
+def test06_empty_space_bounds(variants_all_rgb):
+    medium = create_medium(2)
+
+    # Rays are clipped to the non-empty half of the unit cube
+    ray = mi.Ray3f(mi.Point3f(-1, 0.5, 0.5), mi.Vector3f(1, 0, 0))
+    hit, mint, maxt = medium.intersect_aabb(ray)
+    assert dr.all(hit)
+    assert dr.allclose(mint, 1.5)
+    assert dr.allclose(maxt, 2.0)
+
+    # Rays that only traverse the empty half miss the medium
+    ray = mi.Ray3f(mi.Point3f(0.25, 0.5, -1), mi.Vector3f(0, 0, 1))
+    hit, _, _ = medium.intersect_aabb(ray)
+    assert dr.none(hit)
+
+
+@pytest.mark.parametrize('empty_space_skipping', [False, True])
+def test07_empty_space_skipping(variants_vec_rgb, empty_space_skipping):
+    # A single dense voxel in the corner of an otherwise empty grid
+    data = [0.0] * 64
+    data[-1] = 8.0
+    medium = mi.load_dict({
+        'type': 'heterogeneous',
+        'sigma_t': {
+            'type': 'gridvolume',
+            'data': mi.TensorXf(data, shape=[4, 4, 4]),
+            'filter_type': 'nearest'
+        },
+        'majorant_resolution': 4,
+        'empty_space_skipping': empty_space_skipping
+    })
+
+    n = 1000000
+    sampler = mi.load_dict({'type': 'independent'})
+    sampler.seed(0, n)
+
+    # Diagonal ray that leaps over the empty supervoxels before reaching the
+    # dense one, which it crosses along a length of sqrt(3) / 4
+    ray = mi.Ray3f(mi.Point3f(-0.5), dr.normalize(mi.Vector3f(1)))
+    mei = medium.sample_interaction(ray, sampler.next_1d(), 0, True)
+    valid = mei.is_valid()
+
+    escaped = dr.count(~valid) / n
+    assert dr.allclose(escaped, dr.exp(-8.0 * dr.sqrt(3) / 4), rtol=5e-2)
+    assert dr.all(dr.select(valid, dr.all(mei.p >= 0.75 - 1e-5), True))
+
+
+def test08_emission(variants_all_rgb):
+    medium = create_medium(0)
+    assert not medium.is_emitter()
+
+    medium = mi.load_dict({
+        'type': 'heterogeneous',
+        'sigma_t': {
+            'type': 'gridvolume',
+            'data': mi.TensorXf([0.0, 4.0], shape=[1, 1, 2]),
+            'filter_type': 'nearest'
+        },
+        'radiance': {
+            'type': 'gridvolume',
+            'data': mi.TensorXf([1.0, 2.0], shape=[1, 1, 2]),
+            'filter_type': 'nearest'
+        }
+    })
+    assert medium.is_emitter()
+    assert medium.emitter() is None
+
+    mei = dr.zeros(mi.MediumInteraction3f)
+    mei.p = mi.Point3f(0.75, 0.5, 0.5)
+    assert dr.allclose(medium.get_radiance(mei), 2.0)
+
+    b = medium.bbox()
+    assert dr.allclose(b.min, 0.0) and dr.allclose(b.max, 1.0)
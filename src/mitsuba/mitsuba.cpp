@@ -10,9 +10,13 @@
 #include <mitsuba/core/util.h>
 #include <mitsuba/core/vector.h>
 #include <mitsuba/core/xml.h>
+#include <mitsuba/render/distributed.h>
 #include <mitsuba/render/integrator.h>
 #include <mitsuba/render/records.h>
+#include <mitsuba/render/renderstats.h>
 #include <mitsuba/render/scene.h>
+#include <deque>
+#include <future>
 
 #if !defined(_WIN32)
 #  include <signal.h>
@@ -47,6 +51,19 @@ Options:
     -t <count>, --threads <count>
         Render with the specified number of threads.
 
+    -p, --pin-threads
+        Pin the worker threads to individual cores, grouped by NUMA node.
+
+    --stats
+        Print statistics about the kernels launched by the render (JIT
+        variants only): launch counts, timings, kernel cache hits, virtual
+        function call targets, and peak memory usage.
+
+    --memory
+        Print the memory used by the scene per category (shapes, textures,
+        volumes, acceleration data structure, films, ..) and per object
+        once rendering has finished.
+
     -D <key>=<value>, --define <key>=<value>
         Define a constant that can referenced as "$key" within the scene
         description.
@@ -59,12 +76,55 @@ Options:
         When specified, Mitsuba will update the scene's XML description
         to the latest version.
 
+    -d, --deduplicate
+        Instantiate structurally identical anonymous BSDFs and textures
+        only once and report the deduplication ratio.
+
+    --stream
+        Read the scene file incrementally instead of loading it into memory
+        as a whole, and instantiate objects while the file is being read.
+        Recommended for very large scene files.
+
     -a <path1>;<path2>;.., --append <path1>;<path2>
         Add one or more entries to the resource search path.
 
     -o <filename>, --output <filename>
         Write the output image to the file "filename".
 
+    --pipeline <count>
+        When rendering several scenes (e.g. the frames of an animation),
+        load up to "count" of the following scenes on background threads
+        while the current one renders, and write the output images
+        asynchronously. Files that consecutive scenes have in common (PLY
+        meshes in JIT modes, bitmap textures) are only loaded once while
+        the scenes exist at the same time. Memory usage grows with the
+        number of scenes that are held concurrently.
+
+    -x <filename>, --compile <filename>
+        Instead of rendering, write the resolved scene to "filename" in a
+        binary format that loads considerably faster. The compiled scene
+        can be passed to Mitsuba like an XML file, but only works with
+        the variant used to compile it.
+
+    -c <port>, --coordinator <port>
+        Distribute the rendering of each scene over remote workers that
+        connect to the given TCP port (e.g. using the -w argument below).
+        Slow tiles are re-issued to idle workers. Only the coordinator
+        writes the output image.
+
+    -w <host>:<port>, --worker <host>:<port>
+        Connect to the specified coordinator and render the tiles that it
+        hands out. The worker must load the same scene as the coordinator.
+
+    --server <port>
+        Instead of rendering the scenes once, keep them loaded and serve
+        render jobs submitted by clients (e.g. mitsuba.RenderClient in
+        Python) that connect to the given TCP port. Each scene is
+        registered under its filename without the extension, and clients
+        may load further ones. Jobs select the scene, sensor, sample count
+        and parameter overrides, and they receive the rendered image. The
+        server runs until a client asks it to shut down.
+
  === The following options are only relevant for JIT (CUDA/LLVM) modes ===
 
     -O [0-5]
@@ -81,6 +141,18 @@ Options:
         series of wavefronts. Specify twice to unroll both loops *and*
         virtual function calls.
 
+    --devices <list>
+        Render each scene on several CUDA devices at once, given as a
+        comma-separated list of device IDs or "all". Every device loads
+        its own copy of the scene, and sample passes are distributed
+        among them (CUDA modes only).
+
+    --hybrid
+        Render each scene on the CPU and the GPU at the same time, using
+        the LLVM variant that corresponds to the selected CUDA variant.
+        Sample passes are assigned in proportion to the measured speed of
+        both sides (CUDA modes only).
+
     -V <width>
         Override the vector width of the LLVM backend ('width' must be
         a power of two). Values of 4/8/16 cause SSE/NEON, AVX, or AVX512
@@ -105,7 +177,9 @@ void scene_static_accel_shutdown() {
 }
 
 template <typename Float, typename Spectrum>
-void render(Object *scene_, size_t sensor_i, fs::path filename) {
+void render(Object *scene_, size_t sensor_i, fs::path filename,
+            int coordinator_port, std::string worker_address,
+            bool memory_report, bool write_async) {
     auto *scene = dynamic_cast<Scene<Float, Spectrum> *>(scene_);
     if (!scene)
         Throw("Root element of the input file must be a <scene> tag!");
@@ -119,23 +193,169 @@ void render(Object *scene_, size_t sensor_i, fs::path filename) {
     if (!integrator)
         Throw("No integrator specified for scene: %s", scene);
 
+    if (!worker_address.empty()) {
+        auto sep = worker_address.rfind(':');
+        if (sep == std::string::npos)
+            Throw("-w/--worker: expected a <host>:<port> pair!");
+        ref<RenderWorker<Float, Spectrum>> worker =
+            new RenderWorker<Float, Spectrum>(
+                worker_address.substr(0, sep),
+                (uint16_t) std::stoi(worker_address.substr(sep + 1)));
+        size_t tiles = worker->run(scene);
+        Log(Info, "Rendered %i tile%s for %s.", tiles, tiles == 1 ? "" : "s",
+            worker_address);
+        return;
+    }
+
     /* critical section */ {
         std::lock_guard<std::mutex> guard(develop_callback_mutex);
         develop_callback = [&]() { film->write(filename); };
     }
 
-    integrator->render(scene, (uint32_t) sensor_i,
-                       0 /* seed */,
-                       0 /* spp */,
-                       false /* develop */,
-                       true /* evaluate */);
+    if (coordinator_port >= 0) {
+        ref<RenderCoordinator<Float, Spectrum>> coordinator =
+            new RenderCoordinator<Float, Spectrum>((uint16_t) coordinator_port);
+        coordinator->render(scene, (uint32_t) sensor_i,
+                            0 /* seed */,
+                            0 /* spp */,
+                            false /* develop */);
+        coordinator->shutdown();
+    } else {
+        integrator->render(scene, (uint32_t) sensor_i,
+                           0 /* seed */,
+                           0 /* spp */,
+                           false /* develop */,
+                           true /* evaluate */);
+    }
+
+    Profiler::print_report();
+
+    if constexpr (dr::is_jit_v<Float>) {
+        if (RenderStats::enabled())
+            Log(Info, "%s", RenderStats::last().to_string());
+    }
+
+    if (memory_report)
+        Log(Info, "%s", scene->memory_report());
 
     /* critical section */ {
         std::lock_guard<std::mutex> guard(develop_callback_mutex);
         develop_callback = nullptr;
     }
 
-    film->write(filename);
+    film->write(filename, write_async);
+}
+
+/// Load a scene file, which must expand into a single object
+static ref<Object> load_scene(const fs::path &filename, const std::string &mode,
+                              const xml::ParameterList &params, bool update,
+                              bool dedup, bool stream) {
+    std::vector<ref<Object>> parsed =
+        xml::load_file(filename, mode, params, update, true, dedup, stream);
+
+    if (parsed.size() != 1)
+        Throw("Root element of the input file is expanded into "
+              "multiple objects, only a single object is expected!");
+
+    return parsed[0];
+}
+
+/**
+ * \brief Start loading a scene file on a background thread (used by the
+ * --pipeline mode)
+ *
+ * The file is resolved relative to the search path \c fr extended by the
+ * directory of the scene file, like in the sequential mode.
+ */
+static std::future<ref<Object>>
+load_scene_async(const fs::path &filename, const FileResolver *fr,
+                 const std::string &mode, const xml::ParameterList &params,
+                 bool update, bool dedup, bool stream) {
+    ref<FileResolver> fr2 = new FileResolver(*fr);
+    fs::path scene_dir = filename.parent_path();
+    if (!fr2->contains(scene_dir))
+        fr2->append(scene_dir);
+
+    // Capture an environment that uses the scene's search path
+    ref<Thread> thread = Thread::thread();
+    ref<FileResolver> fr_prev = thread->file_resolver();
+    thread->set_file_resolver(fr2);
+    ThreadEnvironment env;
+    thread->set_file_resolver(fr_prev);
+
+    bool jit = string::starts_with(mode, "cuda_") ||
+               string::starts_with(mode, "llvm_");
+
+    return std::async(std::launch::async, [=]() mutable {
+        ScopedSetThreadEnvironment set_env(env);
+        ref<Object> scene =
+            load_scene(filename, mode, params, update, dedup, stream);
+
+#if defined(MI_ENABLE_CUDA) || defined(MI_ENABLE_LLVM)
+        // Make the scene data available to the rendering thread
+        if (jit)
+            jit_sync_thread();
+#else
+        DRJIT_MARK_USED(jit);
+#endif
+        return scene;
+    });
+}
+
+static RenderParameterList render_parameters(const xml::ParameterList &params) {
+    RenderParameterList defines;
+    for (const auto &[key, value, used] : params)
+        defines.emplace_back(key, value);
+    return defines;
+}
+
+template <typename Float, typename Spectrum>
+void render_devices(const fs::path &scene_file, const std::vector<int> &devices,
+                    const xml::ParameterList &params, size_t sensor_i,
+                    const fs::path &filename) {
+    ref<MultiDeviceRenderer<Float, Spectrum>> renderer =
+        new MultiDeviceRenderer<Float, Spectrum>(scene_file, devices,
+                                                 render_parameters(params));
+    renderer->render((uint32_t) sensor_i, 0 /* seed */, 0 /* spp */,
+                     0 /* spp_per_pass */, false /* develop */);
+
+    Profiler::print_report();
+    renderer->scene()->sensors()[sensor_i]->film()->write(filename);
+}
+
+template <typename Float, typename Spectrum>
+void render_hybrid(const fs::path &scene_file, const std::string &mode,
+                   const xml::ParameterList &params, size_t sensor_i,
+                   const fs::path &filename) {
+    ref<HybridRenderer> renderer =
+        new HybridRenderer(scene_file, "llvm_" + mode.substr(5), mode,
+                           render_parameters(params));
+    renderer->render((uint32_t) sensor_i);
+
+    Profiler::print_report();
+
+    // The contributions of both sides are merged into the film of the GPU
+    auto *scene = static_cast<Scene<Float, Spectrum> *>(renderer->scene(1));
+    scene->sensors()[sensor_i]->film()->write(filename);
+}
+
+template <typename Float, typename Spectrum>
+void serve(const std::vector<std::pair<std::string, ref<Object>>> &scenes,
+           int port) {
+    ref<RenderServer<Float, Spectrum>> server =
+        new RenderServer<Float, Spectrum>((uint16_t) port);
+
+    for (const auto &[id, obj] : scenes) {
+        auto *scene = dynamic_cast<Scene<Float, Spectrum> *>(obj.get());
+        if (!scene)
+            Throw("Root element of the input file must be a <scene> tag!");
+        server->add_scene(id, scene);
+        Log(Info, "Serving scene \"%s\".", id);
+    }
+
+    server->run();
+    Log(Info, "Render server shut down after %i request%s.",
+        server->jobs_completed(), server->jobs_completed() == 1 ? "" : "s");
 }
 
 #if !defined(_WIN32)
@@ -166,7 +386,17 @@ int main(int argc, char *argv[]) {
     auto arg_define    = parser.add(StringVec{ "-D", "--define" }, true);
     auto arg_sensor_i  = parser.add(StringVec{ "-s", "--sensor" }, true);
     auto arg_output    = parser.add(StringVec{ "-o", "--output" }, true);
+    auto arg_compile   = parser.add(StringVec{ "-x", "--compile" }, true);
+    auto arg_coord     = parser.add(StringVec{ "-c", "--coordinator" }, true);
+    auto arg_worker    = parser.add(StringVec{ "-w", "--worker" }, true);
+    auto arg_server    = parser.add(StringVec{ "--server" }, true);
     auto arg_update    = parser.add(StringVec{ "-u", "--update" }, false);
+    auto arg_dedup     = parser.add(StringVec{ "-d", "--deduplicate" }, false);
+    auto arg_stream    = parser.add(StringVec{ "--stream" }, false);
+    auto arg_pin       = parser.add(StringVec{ "-p", "--pin-threads" }, false);
+    auto arg_stats     = parser.add(StringVec{ "--stats" }, false);
+    auto arg_memory    = parser.add(StringVec{ "--memory" }, false);
+    auto arg_pipeline  = parser.add(StringVec{ "--pipeline" }, true);
     auto arg_help      = parser.add(StringVec{ "-h", "--help" });
     auto arg_mode      = parser.add(StringVec{ "-m", "--mode" }, true);
     auto arg_paths     = parser.add(StringVec{ "-a" }, true);
@@ -177,6 +407,8 @@ int main(int argc, char *argv[]) {
     auto arg_wavefront = parser.add(StringVec{ "-W" });
     auto arg_source    = parser.add(StringVec{ "-S" });
     auto arg_vec_width = parser.add(StringVec{ "-V" }, true);
+    auto arg_devices   = parser.add(StringVec{ "--devices" }, true);
+    auto arg_hybrid    = parser.add(StringVec{ "--hybrid" });
 
     xml::ParameterList params;
     std::string error_msg, mode;
@@ -239,6 +471,10 @@ int main(int argc, char *argv[]) {
             }
         }
         Thread::set_thread_count(thread_count);
+        if (*arg_pin)
+            Thread::pin_worker_threads();
+
+        RenderStats::set_enabled(*arg_stats);
 
         while (arg_define && *arg_define) {
             std::string value = arg_define->as_string();
@@ -258,7 +494,7 @@ int main(int argc, char *argv[]) {
 #endif
 
 #if defined(MI_ENABLE_LLVM)
-        if (llvm)
+        if (llvm || (cuda && *arg_hybrid))
             jit_init((uint32_t) JitBackend::LLVM);
 #endif
 
@@ -304,13 +540,56 @@ int main(int argc, char *argv[]) {
         if (!cuda && !llvm &&
             (*arg_optim_lev || *arg_wavefront || *arg_source || *arg_vec_width))
             Throw("Specified an argument that only makes sense in a JIT (LLVM/CUDA) mode!");
+        if (!cuda && *arg_devices)
+            Throw("The --devices argument is only supported in CUDA modes!");
+        if (!cuda && *arg_hybrid)
+            Throw("The --hybrid argument is only supported in CUDA modes!");
+        if (*arg_devices && *arg_hybrid)
+            Throw("The --devices and --hybrid arguments are mutually exclusive!");
+
+        // An empty list selects all devices
+        std::vector<int> devices;
+        if (*arg_devices && arg_devices->as_string() != "all") {
+            for (const std::string &id :
+                 string::tokenize(arg_devices->as_string(), ","))
+                devices.push_back(std::stoi(id));
+            if (devices.empty())
+                Throw("--devices: expected a list of device IDs!");
+        }
 
         Profiler::static_initialization();
-        color_management_static_initialization(cuda, llvm);
+        color_management_static_initialization(cuda, llvm || *arg_hybrid);
 
         MI_INVOKE_VARIANT(mode, scene_static_accel_initialization);
 
         size_t sensor_i  = (*arg_sensor_i ? arg_sensor_i->as_int() : 0);
+        int coordinator_port = (*arg_coord ? arg_coord->as_int() : -1);
+        std::string worker_address = (*arg_worker ? arg_worker->as_string() : "");
+        int server_port = (*arg_server ? arg_server->as_int() : -1);
+        if (coordinator_port >= 0 && !worker_address.empty())
+            Throw("The -c/--coordinator and -w/--worker arguments are mutually exclusive!");
+        if (server_port >= 0 && (coordinator_port >= 0 ||
+                                 !worker_address.empty() || *arg_compile))
+            Throw("The --server argument cannot be combined with -c, -w or -x!");
+        if ((*arg_devices || *arg_hybrid) &&
+            (coordinator_port >= 0 || !worker_address.empty() ||
+             server_port >= 0 || *arg_compile))
+            Throw("The --devices and --hybrid arguments cannot be combined "
+                  "with -c, -w, -x or --server!");
+
+        // Number of scenes that are loaded ahead of the one being rendered
+        size_t pipeline = 0;
+        if (*arg_pipeline) {
+            int depth = arg_pipeline->as_int();
+            if (depth < 1)
+                Throw("--pipeline: the number of scenes must be positive!");
+            if (coordinator_port >= 0 || !worker_address.empty() ||
+                server_port >= 0 || *arg_compile || *arg_devices ||
+                *arg_hybrid)
+                Throw("The --pipeline argument cannot be combined with -c, "
+                      "-w, -x, --server, --devices or --hybrid!");
+            pipeline = (size_t) depth;
+        }
 
         // Append the mitsuba directory to the FileResolver search path list
         ref<Thread> thread = Thread::thread();
@@ -340,6 +619,12 @@ int main(int argc, char *argv[]) {
 #endif
         }
 
+        std::vector<std::pair<std::string, ref<Object>>> served;
+
+        // Scenes loading in the background (--pipeline), and the next to load
+        std::deque<std::future<ref<Object>>> pending;
+        const ArgParser::Arg *arg_load = arg_extra;
+
         while (arg_extra && *arg_extra) {
             fs::path filename(arg_extra->as_string());
             ref<FileResolver> fr2 = new FileResolver(*fr);
@@ -350,21 +635,74 @@ int main(int argc, char *argv[]) {
             if (!fr2->contains(scene_dir))
                 fr2->append(scene_dir);
 
+            if (*arg_compile) {
+                if (arg_extra->next())
+                    Throw("-x/--compile: expected a single scene file!");
+                xml::compile_file(arg_extra->as_string(),
+                                  arg_compile->as_string(), mode, params);
+                break;
+            }
+
             if (*arg_output)
                 filename = arg_output->as_string();
 
-            // Try and parse a scene from the passed file.
-            std::vector<ref<Object>> parsed =
-                xml::load_file(arg_extra->as_string(), mode, params,
-                               *arg_update, true);
+            if (*arg_devices) {
+                // Every device loads its own replica of the scene
+                MI_INVOKE_VARIANT(mode, render_devices,
+                                  fs::path(arg_extra->as_string()), devices,
+                                  params, sensor_i, filename);
+                arg_extra = arg_extra->next();
+                continue;
+            }
+
+            if (*arg_hybrid) {
+                // The scene is loaded in an LLVM and a CUDA variant
+                MI_INVOKE_VARIANT(mode, render_hybrid,
+                                  fs::path(arg_extra->as_string()), mode,
+                                  params, sensor_i, filename);
+                arg_extra = arg_extra->next();
+                continue;
+            }
 
-            if (parsed.size() != 1)
-                Throw("Root element of the input file is expanded into "
-                      "multiple objects, only a single object is expected!");
+            // Try and parse a scene from the passed file.
+            ref<Object> scene;
+            if (pipeline > 0) {
+                /* Keep the following scenes loading while this one renders.
+                   The front of the queue is the current scene */
+                while (arg_load && *arg_load && pending.size() <= pipeline) {
+                    pending.push_back(load_scene_async(
+                        arg_load->as_string(), fr, mode, params, *arg_update,
+                        *arg_dedup, *arg_stream));
+                    arg_load = arg_load->next();
+                }
+                scene = pending.front().get();
+                pending.pop_front();
+            } else {
+                scene = load_scene(arg_extra->as_string(), mode, params,
+                                   *arg_update, *arg_dedup, *arg_stream);
+            }
 
-            MI_INVOKE_VARIANT(mode, render, parsed[0].get(), sensor_i, filename);
+            if (server_port >= 0) {
+                std::string id = fs::path(arg_extra->as_string()).filename()
+                                     .replace_extension("").string();
+                for (const auto &entry : served)
+                    if (entry.first == id)
+                        Throw("--server: the scene identifier \"%s\" is not "
+                              "unique!", id);
+                served.emplace_back(id, scene);
+            } else {
+                MI_INVOKE_VARIANT(mode, render, scene.get(), sensor_i,
+                                  filename, coordinator_port, worker_address,
+                                  (bool) *arg_memory, pipeline > 0);
+            }
             arg_extra = arg_extra->next();
         }
+
+        // Complete the pending asynchronous writes of output images
+        Thread::wait_for_tasks();
+
+        if (server_port >= 0)
+            MI_INVOKE_VARIANT(mode, serve, served, server_port);
     } catch (const std::exception &e) {
         error_msg = std::string("Caught a critical exception: ") + e.what();
     } catch (...) {
@@ -372,6 +710,10 @@ int main(int argc, char *argv[]) {
     }
 
     if (!error_msg.empty()) {
+        // Write out any queued log messages before reporting the error
+        if (Thread::thread()->logger())
+            Thread::thread()->logger()->flush();
+
         /* Strip zero-width spaces from the message (Mitsuba uses these
            to properly format chains of multiple exceptions) */
         const std::string zerowidth_space = "\xe2\x80\x8b";
@@ -1,4 +1,5 @@
 #include <mitsuba/core/properties.h>
+#include <mitsuba/core/string.h>
 #include <mitsuba/core/warp.h>
 #include <mitsuba/render/phase.h>
 #include <mitsuba/render/volume.h>
@@ -24,6 +25,19 @@ SGGX phase function (:monosp:`sggx`)
      with six channels.
    - |exposed|, |differentiable|
 
+ * - direction
+   - |volume|
+   - Alternatively to ``S``, a volume containing the symmetry axis of a
+     rotationally symmetric distribution (see below), e.g. as a
+     :ref:`gridvolume <volume-gridvolume>` with three channels.
+   - |exposed|, |differentiable|
+
+ * - sigma_axis, sigma_perp
+   - |float| or |volume|
+   - Projected area of the distribution along and perpendicular to
+     ``direction``. (Default: 1.0)
+   - |exposed|, |differentiable|
+
 This plugin implements the SGGX phase function :cite:`Heitz2015SGGX`.
 The SGGX phase function is an anisotropic microflake phase function :cite:`Jakob10`.
 This phase function can be useful to model fibers or surface-like structures using volume rendering.
@@ -34,6 +48,15 @@ Due to it's symmetry, the matrix :math:`S` is fully specified by providing the e
 :math:`S_{xx}`, :math:`S_{yy}`, :math:`S_{zz}`, :math:`S_{xy}`, :math:`S_{xz}` and :math:`S_{yz}`.
 It is the responsibility of the user to ensure that these parameters describe a valid positive definite matrix.
 
+Microflake volumes of fibers or surface-like structures are usually well described by a distribution
+that is rotationally symmetric around an axis :math:`\omega`. Such distributions can be specified more
+compactly using the ``direction``, ``sigma_axis`` and ``sigma_perp`` parameters, from which the matrix
+:math:`S = \sigma_{\text{axis}}^2\,\omega\omega^T + \sigma_{\text{perp}}^2\,(I - \omega\omega^T)` is
+reconstructed on the fly. Fiber-like distributions have a small ``sigma_axis`` and surface-like
+distributions a small ``sigma_perp``. Since the direction need not be normalized, its three channels
+(and the projected areas) can be stored using the ``uint8`` storage format of the
+:ref:`gridvolume <volume-gridvolume>` plugin, which reduces the footprint of a voxel from 24 to 5 bytes.
+
 .. tabs::
     .. code-tab:: xml
 
@@ -51,6 +74,29 @@ It is the responsibility of the user to ensure that these parameters describe a
             'filename': 'volume.vol'
         }
 
+The compact parametrization of a fiber-like medium with 8 bit directions is specified as follows:
+
+.. tabs::
+    .. code-tab:: xml
+
+        <phase type='sggx'>
+            <volume type="gridvolume" name="direction">
+                <string name="filename" value="directions.vol"/>
+                <string name="storage" value="uint8"/>
+            </volume>
+            <float name="sigma_axis" value="0.1"/>
+        </phase>
+
+    .. code-tab:: python
+
+        'type': 'sggx',
+        'direction': {
+            'type': 'gridvolume',
+            'filename': 'directions.vol',
+            'storage': 'uint8'
+        },
+        'sigma_axis': 0.1
+
 */
 template <typename Float, typename Spectrum>
 class SGGXPhaseFunction final : public PhaseFunction<Float, Spectrum> {
@@ -61,20 +107,41 @@ public:
 
     SGGXPhaseFunction(const Properties &props) : Base(props) {
         // m_diffuse    = props.get<bool>("diffuse", false);
-        m_ndf_params = props.volume<Volume>("S");
+        if (props.has_property("direction")) {
+            if (props.has_property("S"))
+                Throw("The parameters \"S\" and \"direction\" can't be "
+                      "specified at the same time!");
+            m_direction  = props.volume<Volume>("direction");
+            m_sigma_axis = props.volume<Volume>("sigma_axis", 1.f);
+            m_sigma_perp = props.volume<Volume>("sigma_perp", 1.f);
+        } else {
+            m_ndf_params = props.volume<Volume>("S");
+        }
         m_flags =
             PhaseFunctionFlags::Anisotropic | PhaseFunctionFlags::Microflake;
         dr::set_attr(this, "flags", m_flags);
     }
 
     void traverse(TraversalCallback *callback) override {
-        callback->put_object("S", m_ndf_params.get(), +ParamFlags::Differentiable);
+        if (m_ndf_params) {
+            callback->put_object("S", m_ndf_params.get(), +ParamFlags::Differentiable);
+        } else {
+            callback->put_object("direction", m_direction.get(), +ParamFlags::Differentiable);
+            callback->put_object("sigma_axis", m_sigma_axis.get(), +ParamFlags::Differentiable);
+            callback->put_object("sigma_perp", m_sigma_perp.get(), +ParamFlags::Differentiable);
+        }
     }
 
     MI_INLINE
     dr::Array<Float, 6> eval_ndf_params(const MediumInteraction3f &mi,
                                         Mask active) const {
-        return m_ndf_params->eval_6(mi, active);
+        if (m_ndf_params)
+            return m_ndf_params->eval_6(mi, active);
+
+        // Decode the compact parametrization
+        return sggx_from_axis(m_direction->eval_3(mi, active),
+                              m_sigma_axis->eval_1(mi, active),
+                              m_sigma_perp->eval_1(mi, active));
     }
 
     std::tuple<Vector3f, Spectrum, Float> sample(const PhaseFunctionContext & /* ctx */,
@@ -128,18 +195,25 @@ public:
 
     std::string to_string() const override {
         std::ostringstream oss;
-        oss << "SGGXPhaseFunction[" << std::endl
-            << "  ndf_params = " << m_ndf_params
-            << std::endl
-            // << "  diffuse = " << m_diffuse << std::endl
-            << "]";
+        oss << "SGGXPhaseFunction[" << std::endl;
+        if (m_ndf_params)
+            oss << "  ndf_params = " << string::indent(m_ndf_params) << std::endl;
+        else
+            oss << "  direction = " << string::indent(m_direction) << "," << std::endl
+                << "  sigma_axis = " << string::indent(m_sigma_axis) << "," << std::endl
+                << "  sigma_perp = " << string::indent(m_sigma_perp) << std::endl;
+        // oss << "  diffuse = " << m_diffuse << std::endl;
+        oss << "]";
         return oss.str();
     }
 
     MI_DECLARE_CLASS()
 private:
     // bool m_diffuse;
+    /// Full SGGX matrices (6 channels)
     ref<Volume> m_ndf_params;
+    /// Compact parametrization of rotationally symmetric distributions
+    ref<Volume> m_direction, m_sigma_axis, m_sigma_perp;
 };
 
 MI_IMPLEMENT_CLASS_VARIANT(SGGXPhaseFunction, PhaseFunction)
@@ -61,3 +61,41 @@ def test03_chi2_skewed(variants_vec_backends_once_rgb, tmpdir):
     )
 
     assert chi2.run()
+
+
+def test04_direction(variants_vec_backends_once_rgb):
+    # Fiber-like distribution around a tilted axis
+    w = dr.normalize(mi.ScalarVector3f(1, 2, 3))
+    sigma_axis, sigma_perp = 0.2, 0.9
+    S = [sigma_perp**2 + (sigma_axis**2 - sigma_perp**2) * w[i] * w[j]
+         for i, j in [(0, 0), (1, 1), (2, 2), (0, 1), (0, 2), (1, 2)]]
+
+    full = mi.load_dict({
+        'type': 'sggx',
+        'S': {
+            'type': 'gridvolume',
+            'data': mi.TensorXf(S, [1, 1, 1, 6])
+        }
+    })
+    compact = mi.load_dict({
+        'type': 'sggx',
+        'direction': {
+            'type': 'gridvolume',
+            'data': mi.TensorXf(list(2 * w), [1, 1, 1, 3])
+        },
+        'sigma_axis': sigma_axis,
+        'sigma_perp': sigma_perp
+    })
+
+    sampler = mi.load_dict({'type': 'independent'})
+    sampler.seed(0, 64)
+    mei = dr.zeros(mi.MediumInteraction3f, 64)
+    mei.p = mi.Point3f(0.5)
+    mei.wi = mi.warp.square_to_uniform_sphere(sampler.next_2d())
+    mei.sh_frame = mi.Frame3f(mei.wi)
+    wo = mi.warp.square_to_uniform_sphere(sampler.next_2d())
+    ctx = mi.PhaseFunctionContext(sampler)
+
+    assert dr.allclose(full.projected_area(mei), compact.projected_area(mei))
+    assert dr.allclose(full.eval_pdf(ctx, mei, wo)[1],
+                       compact.eval_pdf(ctx, mei, wo)[1], rtol=1e-4)
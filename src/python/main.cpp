@@ -22,13 +22,19 @@ MI_PY_DECLARE(MemoryMappedFile);
 MI_PY_DECLARE(Stream);
 MI_PY_DECLARE(DummyStream);
 MI_PY_DECLARE(FileStream);
+MI_PY_DECLARE(BufferedFileStream);
 MI_PY_DECLARE(MemoryStream);
 MI_PY_DECLARE(ZStream);
+MI_PY_DECLARE(SocketStream);
+MI_PY_DECLARE(ServerSocket);
+MI_PY_DECLARE(Profiler);
 MI_PY_DECLARE(ProgressReporter);
 MI_PY_DECLARE(rfilter);
 MI_PY_DECLARE(Thread);
+MI_PY_DECLARE(TileCache);
 MI_PY_DECLARE(Timer);
 MI_PY_DECLARE(util);
+MI_PY_DECLARE(SceneUpdater);
 
 // render
 MI_PY_DECLARE(BSDFContext);
@@ -36,11 +42,15 @@ MI_PY_DECLARE(EmitterExtras);
 MI_PY_DECLARE(RayFlags);
 MI_PY_DECLARE(MicrofacetType);
 MI_PY_DECLARE(PhaseFunctionExtras);
+MI_PY_DECLARE(RenderStats);
+MI_PY_DECLARE(RenderClient);
+MI_PY_DECLARE(HybridRenderer);
 MI_PY_DECLARE(Spiral);
 MI_PY_DECLARE(Sensor);
 MI_PY_DECLARE(VolumeGrid);
 MI_PY_DECLARE(FilmFlags);
 MI_PY_DECLARE(DiscontinuityFlags);
+MI_PY_DECLARE(optix);
 
 PYBIND11_MODULE(mitsuba_ext, m) {
     // Temporarily change the module name (for pydoc)
@@ -129,22 +139,32 @@ PYBIND11_MODULE(mitsuba_ext, m) {
     MI_PY_IMPORT(MemoryMappedFile);
     MI_PY_IMPORT(DummyStream);
     MI_PY_IMPORT(FileStream);
+    MI_PY_IMPORT(BufferedFileStream);
     MI_PY_IMPORT(MemoryStream);
     MI_PY_IMPORT(ZStream);
+    MI_PY_IMPORT(SocketStream);
+    MI_PY_IMPORT(ServerSocket);
+    MI_PY_IMPORT(Profiler);
     MI_PY_IMPORT(ProgressReporter);
     MI_PY_IMPORT(Thread);
+    MI_PY_IMPORT(TileCache);
     MI_PY_IMPORT(Timer);
     MI_PY_IMPORT(util);
+    MI_PY_IMPORT(SceneUpdater);
 
     MI_PY_IMPORT(BSDFContext);
     MI_PY_IMPORT(EmitterExtras);
     MI_PY_IMPORT(RayFlags);
     MI_PY_IMPORT(MicrofacetType);
     MI_PY_IMPORT(PhaseFunctionExtras);
+    MI_PY_IMPORT(RenderStats);
+    MI_PY_IMPORT(RenderClient);
+    MI_PY_IMPORT(HybridRenderer);
     MI_PY_IMPORT(Spiral);
     MI_PY_IMPORT(Sensor);
     MI_PY_IMPORT(FilmFlags);
     MI_PY_IMPORT(DiscontinuityFlags);
+    MI_PY_IMPORT(optix);
 
     // Register a cleanup callback function to wait for pending tasks
     auto atexit = py::module_::import("atexit");
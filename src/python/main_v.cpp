@@ -75,7 +75,7 @@ MI_PY_DECLARE(sample_tea);
 MI_PY_DECLARE(spline);
 MI_PY_DECLARE(Spectrum);
 MI_PY_DECLARE(Transform);
-// MI_PY_DECLARE(AnimatedTransform);
+MI_PY_DECLARE(AnimatedTransform);
 MI_PY_DECLARE(vector);
 MI_PY_DECLARE(warp);
 MI_PY_DECLARE(xml);
@@ -101,8 +101,13 @@ MI_PY_DECLARE(MicroflakeDistribution);
 #if defined(MI_ENABLE_CUDA)
 MI_PY_DECLARE(OptixDenoiser);
 #endif // defined(MI_ENABLE_CUDA)
+MI_PY_DECLARE(octree);
 MI_PY_DECLARE(PositionSample);
 MI_PY_DECLARE(PhaseFunction);
+MI_PY_DECLARE(RenderCoordinator);
+MI_PY_DECLARE(RenderWorker);
+MI_PY_DECLARE(RenderServer);
+MI_PY_DECLARE(MultiDeviceRenderer);
 MI_PY_DECLARE(DirectionSample);
 MI_PY_DECLARE(Sampler);
 MI_PY_DECLARE(Scene);
@@ -114,6 +119,7 @@ MI_PY_DECLARE(srgb);
 MI_PY_DECLARE(Texture);
 MI_PY_DECLARE(Volume);
 MI_PY_DECLARE(VolumeGrid);
+MI_PY_DECLARE(SparseVolumeGrid);
 
 #define MODULE_NAME MI_MODULE_NAME(mitsuba, MI_VARIANT_NAME)
 
@@ -169,7 +175,7 @@ PYBIND11_MODULE(MODULE_NAME, m) {
     MI_PY_IMPORT_SUBMODULE(spline);
     MI_PY_IMPORT(Spectrum);
     MI_PY_IMPORT(Transform);
-    // MI_PY_IMPORT(AnimatedTransform);
+    MI_PY_IMPORT(AnimatedTransform);
     MI_PY_IMPORT(Hierarchical2D);
     MI_PY_IMPORT(Marginal2D);
     MI_PY_IMPORT(vector);
@@ -201,7 +207,12 @@ PYBIND11_MODULE(MODULE_NAME, m) {
 #if defined(MI_ENABLE_CUDA)
     MI_PY_IMPORT(OptixDenoiser);
 #endif // defined(MI_ENABLE_CUDA)
+    MI_PY_IMPORT(octree);
     MI_PY_IMPORT(PhaseFunction);
+    MI_PY_IMPORT(RenderCoordinator);
+    MI_PY_IMPORT(RenderWorker);
+    MI_PY_IMPORT(RenderServer);
+    MI_PY_IMPORT(MultiDeviceRenderer);
     MI_PY_IMPORT(Sampler);
     MI_PY_IMPORT(Sensor);
     MI_PY_IMPORT(ShapeKDTree);
@@ -209,6 +220,7 @@ PYBIND11_MODULE(MODULE_NAME, m) {
     MI_PY_IMPORT(Texture);
     MI_PY_IMPORT(Volume);
     MI_PY_IMPORT(VolumeGrid);
+    MI_PY_IMPORT(SparseVolumeGrid);
 
     py::object mitsuba_ext = py::module::import("mitsuba.mitsuba_ext");
     cast_object = (Caster) (void *)((py::capsule) mitsuba_ext.attr("cast_object"));
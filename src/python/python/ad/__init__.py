@@ -3,3 +3,4 @@ from .integrators import *
 from .optimizers import *
 from .guiding import *
 from .projective import *
+from .schedule import *
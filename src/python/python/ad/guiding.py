@@ -157,245 +157,28 @@ class OcSpaceDistr(BaseGuidingDistr):
         self.scale_mass = scale_mass
         self.debug_logs = debug_logs
 
-    @staticmethod
-    def aabbs(buffer: mi.Float, node_idx: mi.UInt32):
-        """
-        Returns the front bottom left corner and back top right corner points
-        of the AABB with index `node_idx`.
-        """
-        idx = node_idx * 2
-        aabb_min = dr.gather(mi.Point3f, buffer, idx)
-        aabb_max = dr.gather(mi.Point3f, buffer, idx + 1)
-
-        return (aabb_min, aabb_max)
-
-    @staticmethod
-    def split_offset(x_offset, y_offset, z_offset):
-        """
-        Computes the node offset for a split.
-        """
-        return x_offset * 1 + y_offset * 2 + z_offset * 4
-
-    @staticmethod
-    def split(
-            buffer: mi.Float,
-            aabb_min: mi.Point3f,
-            aabb_max: mi.Point3f,
-            aabb_middle: mi.Point3f,
-            node_idx: mi.UInt32
-        ):
-        """
-        Splits an AABB into 8 sub-nodes. The results are written to `buffer`.
-        """
-
-        def write_aabb(aabb_min: mi.Point3f, aabb_max: mi.Point3f, offset: int):
-            buffer_offset = dr.opaque(mi.UInt32, dr.width(node_idx) * 6 * offset)
-
-            dr.scatter(buffer, aabb_min.x, node_idx * 6 + buffer_offset + 0)
-            dr.scatter(buffer, aabb_min.y, node_idx * 6 + buffer_offset + 1)
-            dr.scatter(buffer, aabb_min.z, node_idx * 6 + buffer_offset + 2)
-
-            dr.scatter(buffer, aabb_max.x, node_idx * 6 + buffer_offset + 3)
-            dr.scatter(buffer, aabb_max.y, node_idx * 6 + buffer_offset + 4)
-            dr.scatter(buffer, aabb_max.z, node_idx * 6 + buffer_offset + 5)
-
-        x = [aabb_min.x, aabb_middle.x, aabb_max.x]
-        y = [aabb_min.y, aabb_middle.y, aabb_max.y]
-        z = [aabb_min.z, aabb_middle.z, aabb_max.z]
-
-        part_min = dr.zeros(mi.Vector3f, dr.width(node_idx))
-        part_max = dr.zeros(mi.Vector3f, dr.width(node_idx))
-        for i in range(2):
-            for j in range(2):
-                for k in range(2):
-                    part_min.x = x[i+0]; part_min.y = y[j+0]; part_min.z = z[k+0]
-                    part_max.x = x[i+1]; part_max.y = y[j+1]; part_max.z = z[k+1]
-                    offset = OcSpaceDistr.split_offset(i, j, k)
-                    write_aabb(part_min, part_max, offset)
-
     def construct_octree(self, points, log=False):
         """
         Octree construction/partitioning for the given `input` points.
-        """
 
-        ###### OVERVIEW ######
-        # This method is made of 6 phases:
-        #    * Split non-leave nodes into 8
-        #    * Figure out indices of points/samples after the split
-        #    * Determine which of the split nodes are leaves
-        #    * Write leave nodes to special buffer
-        #    * Nodes that are still not leaves must be copied back to a buffer
-        #      for the next iterations
-        #    * Figure out indices of points/samples that are still not in leaves
-        #
-        # These phases are repeated until we only have leaves left.
-
-        # Holds the list of AABBs that needs to be split
-        # This is a flat buffer with the following structure:
-        # [
-        #  aabb_min_x[0], aabb_min_y[0], aabb_min_z[0],
-        #  aabb_max_x[0], aabb_max_y[0], aabb_max_z[0],
-        #  aabb_min_x[1], aabb_min_y[1], aabb_min_z[1],
-        #  aabb_max_x[1], aabb_max_y[1], aabb_max_z[1],
-        #  ...
-        #  aabb_min_x[N - 1], aabb_min_y[N - 1], aabb_min_z[N - 1],
-        #  aabb_max_x[N - 1], aabb_max_y[N - 1], aabb_max_z[N - 1],
-        # ]
-        aabb_buffer = dr.zeros(mi.Float, self.max_leaf_count * 6)
-
-        # Same as `aabb_buffer` but is filled for the next iteration
-        aabb_buffer_next = dr.zeros(mi.Float, self.max_leaf_count * 6)
-
-        leaves = dr.zeros(mi.Float, self.max_leaf_count * 6)
-        leaves_count = mi.UInt32(0)
-        dr.make_opaque(leaves_count)
-
-        # Magic value to mark invalidated points
-        INVALID_IDX = mi.UInt32(0xffffffff)
-        points_idx = dr.full(mi.UInt32, dr.slice(INVALID_IDX), dr.width(points))
-
-        #########################
-        # Initialize root nodes #
-        #########################
-        active_node_count = self.prepartition_x_slices
-
-        idx = dr.arange(mi.UInt32, active_node_count)
-        zero_vec = dr.zeros(mi.Vector3f, active_node_count)
-        one_vec = dr.ones(mi.Vector3f, active_node_count)
-        dr.scatter(aabb_buffer, zero_vec, idx * 2 + 0)
-        dr.scatter(aabb_buffer, one_vec,  idx * 2 + 1)
-
-        x = dr.linspace(mi.Float, 0, 1, active_node_count + 1)
-        idx_x_min = dr.arange(mi.UInt32, active_node_count) # Skip 0
-        idx_x_max = dr.arange(mi.UInt32, 1, active_node_count + 1)
-
-        dr.scatter(aabb_buffer, dr.gather(mi.Float, x, idx_x_min), idx * 6 + 0)
-        dr.scatter(aabb_buffer, dr.gather(mi.Float, x, idx_x_max), idx * 6 + 3)
-
-        points_idx = dr.binary_search(
-            0, active_node_count,
-            lambda index: dr.gather(mi.Float, x, index) < points.x
-        ) - 1
-        active = dr.neq(points_idx, INVALID_IDX)
-
-        dr.eval(aabb_buffer, aabb_buffer_next, points_idx, leaves, active, leaves_count)
+        The points are copied to the host once, and the octree is then built
+        by a native builder (``mi.build_guiding_octree()``) with a single pass
+        over the points per level. Starting from ``prepartition_x_slices``
+        slabs along the X axis, every node is split into 8 children until
+        each child contains at most one point (from the third level onwards)
+        or ``max_depth`` is reached.
+        """
 
         if self.debug_logs:
             mi.Log(mi.LogLevel.Debug, "Building octree guiding distribution:")
 
-        loop_iter = 0
-        while True:
-            loop_iter += 1
-
-            #########################################################################
-            # Split each node (`aabb_buffer`) into 8 sub-nodes (`aabb_buffer_next`) #
-            #########################################################################
-            idx = dr.arange(mi.UInt32, active_node_count)
-            aabb_min, aabb_max = OcSpaceDistr.aabbs(aabb_buffer, idx)
-            aabb_middle = (aabb_min + aabb_max) * 0.5
-            OcSpaceDistr.split(
-                aabb_buffer_next, aabb_min, aabb_max, aabb_middle, idx)
-
-            #########################################
-            # Update `points_idx` for new sub-nodes #
-            #########################################
-            aabb_middle_pt = dr.gather(mi.Point3f, aabb_middle, points_idx, active)
-            x_offset = dr.select(points.x > aabb_middle_pt.x, 1, 0)
-            y_offset = dr.select(points.y > aabb_middle_pt.y, 1, 0)
-            z_offset = dr.select(points.z > aabb_middle_pt.z, 1, 0)
-            offset = OcSpaceDistr.split_offset(x_offset, y_offset, z_offset)
-            active_node_count_opaque = dr.opaque(mi.UInt32, active_node_count)
-            points_idx[active] = points_idx + offset * active_node_count_opaque
-
-            ####################################
-            # Determine which nodes are leaves #
-            ####################################
-            points_count = dr.zeros(mi.UInt32, active_node_count * 8)
-            ones = dr.ones(mi.UInt32, dr.width(points))
-            dr.scatter_reduce(dr.ReduceOp.Add, points_count, ones, points_idx, active)
-            is_leaf = (
-                ((loop_iter >= 3) & (points_count <= 1)) |
-                (loop_iter >= self.max_depth)
-            )
-
-            #########################
-            # Updates leaves buffer #
-            #########################
-            new_leaf_count = dr.count(is_leaf)
-            if new_leaf_count > 0:
-                leaf_idx = dr.compress(is_leaf)
-                leaf_aabb_min = dr.gather(mi.Point3f, aabb_buffer_next, leaf_idx * 2 + 0)
-                leaf_aabb_max = dr.gather(mi.Point3f, aabb_buffer_next, leaf_idx * 2 + 1)
-
-                idx = dr.arange(mi.UInt32, new_leaf_count)
-                dr.scatter(leaves, leaf_aabb_min, leaves_count * 2 + idx * 2 + 0)
-                dr.scatter(leaves, leaf_aabb_max, leaves_count * 2 + idx * 2 + 1)
-
-                leaves_count += dr.opaque(mi.UInt32, new_leaf_count)
-
-            #############################################
-            # Update `aabb_buffer` (for next iteration) #
-            #############################################
-            new_active_node_count = active_node_count * 8 - new_leaf_count
-            if new_active_node_count > 0:
-                idx = dr.compress(~is_leaf)
-                aabb_next_min = dr.gather(mi.Point3f, aabb_buffer_next, idx * 2 + 0)
-                aabb_next_max = dr.gather(mi.Point3f, aabb_buffer_next, idx * 2 + 1)
-
-                idx = dr.arange(mi.UInt32, new_active_node_count)
-                dr.scatter(aabb_buffer, aabb_next_min, idx * 2 + 0)
-                dr.scatter(aabb_buffer, aabb_next_max, idx * 2 + 1)
-
-            ######################################
-            # Update `points_idx` for new buffer #
-            ######################################
-            point_in_leaf = dr.gather(mi.Mask, is_leaf, points_idx, active)
-
-            # Invalidate points that are now in leaves
-            points_idx[active & point_in_leaf] = INVALID_IDX
-            active &= dr.neq(points_idx, INVALID_IDX)
-
-            is_new_leaf_int = dr.zeros(mi.UInt32, active_node_count * 8)
-            is_new_leaf_int[is_leaf] = 1
-            cumulative_new_leaf_count = dr.cumsum(is_new_leaf_int)
-            leaf_count_before_point_idx = dr.gather(mi.UInt32, cumulative_new_leaf_count, points_idx, active)
-            points_idx[active & (~point_in_leaf)] = points_idx - leaf_count_before_point_idx
-
-            active_node_count = new_active_node_count
-
-            ###########################
-            # Early exit & evaluation #
-            ###########################
-            dr.eval(aabb_buffer, aabb_buffer_next, points_idx, leaves, active, leaves_count)
-            leaves_count_scalar = dr.slice(leaves_count)
-
-            if self.debug_logs:
-                mi.Log(mi.LogLevel.Debug,
-                       f"l{loop_iter:2d}: ttl_leaf = {leaves_count_scalar:6d}, "
-                       f"N_leaf_new = {new_leaf_count:6d}, N_node_new = "
-                       f"{new_active_node_count:6d}")
-
-            if active_node_count == 0:
-                break
-
-            if leaves_count_scalar + active_node_count * 8 > self.max_leaf_count:
-                raise RuntimeError(
-                    "OcSpaceDistr: Number of leaf nodes exceeds "
-                    "'max_leaf_count'. Please increase 'max_leaf_count' or "
-                    "increase 'mass_contruction_thres'."
-                )
+        aabb_min, aabb_max = mi.build_guiding_octree(
+            points, self.prepartition_x_slices, self.max_depth,
+            self.max_leaf_count)
 
         if self.debug_logs:
-            mi.Log(mi.LogLevel.Debug, "Finished building octree.")
-
-        # Finalize
-        del (aabb_buffer, aabb_buffer_next, points_idx, is_new_leaf_int,
-             cumulative_new_leaf_count, leaf_count_before_point_idx, point_in_leaf,
-             active, active_node_count, new_active_node_count, new_leaf_count)
-
-        idx = dr.arange(mi.UInt32, leaves_count_scalar)
-        aabb_min = dr.gather(mi.Point3f, leaves, idx * 2 + 0)
-        aabb_max = dr.gather(mi.Point3f, leaves, idx * 2 + 1)
+            mi.Log(mi.LogLevel.Debug,
+                   f"Finished building octree ({dr.width(aabb_min)} leaves).")
 
         return aabb_min, aabb_max
 
@@ -23,11 +23,57 @@ class ADIntegrator(mi.CppADIntegrator):
          the *russian roulette* path termination criterion. For example, if set to
          1, then path generation many randomly cease after encountering directly
          visible surfaces. (Default: 5)
+     * - frozen
+       - |bool|
+       - Reduce the Python overhead of repeated optimization iterations that
+         render the same configuration (see below). (Default: false)
+     * - dynamic_film_size
+       - |bool|
+       - Don't embed the film resolution into the generated ray generation
+         code, so that kernels are reused when it changes between iterations
+         (e.g. with :py:class:`mitsuba.ad.ResolutionSchedule`). (Default: false)
+     * - local_reduction
+       - |string|
+       - Pre-reduce the gradients that the adjoint pass of
+         :py:meth:`render_backward()` accumulates via atomic scatter-reductions
+         within each warp (CUDA) or SIMD vector (LLVM). Must be ``true``,
+         ``false``, or ``auto`` (see below). (Default: auto)
+
+    In an optimization loop, most iterations retrace the same sequence of
+    kernels and only update the parameter buffers. Dr.Jit then reuses the
+    compiled kernels from its cache, and a significant part of the iteration
+    time is spent in Python. When ``frozen`` is enabled, the integrator
+    remembers the configuration (scene, sensor, film size and sample count) of
+    the previous iteration. While it stays the same, it only collects the
+    young generations of the Python garbage collector where a full collection
+    would otherwise be performed to release cyclically referenced variables
+    before evaluating a kernel; the variables traced within the current
+    iteration all live in these generations. A change of configuration
+    automatically reverts to the full collection for that iteration.
+
+    In the adjoint pass, many lanes may accumulate gradients into the same
+    entries of a texture or volume at once, which serializes their atomic
+    updates. When ``local_reduction`` is set to ``auto``, the lanes of a warp
+    (or SIMD vector) first add up their contributions to the same entry
+    whenever a differentiated tensor with at least three dimensions (i.e. a
+    texture or a volume) has fewer entries than an eighth of the wavefront
+    size. Larger tensors receive few colliding updates, which don't justify
+    the cost of the reduction.
     """
 
     def __init__(self, props = mi.Properties()):
         super().__init__(props)
 
+        self.frozen = props.get('frozen', False)
+        self.frozen_key = None
+        self.frozen_steady = False
+        self.dynamic_film_size = props.get('dynamic_film_size', False)
+
+        local_reduction = str(props.get('local_reduction', 'auto')).lower()
+        if local_reduction not in ['true', 'false', 'auto']:
+            raise Exception("\"local_reduction\" must be set to true, false or auto!")
+        self.local_reduction = local_reduction
+
         max_depth = props.get('max_depth', 6)
         if max_depth < 0 and max_depth != -1:
             raise Exception("\"max_depth\" must be set to -1 (infinite) or a value >= 0")
@@ -43,6 +89,50 @@ class ADIntegrator(mi.CppADIntegrator):
         return f'{type(self).__name__}[max_depth = {self.max_depth},' \
                f' rr_depth = { self.rr_depth }]'
 
+    def freeze(self, scene: mi.Scene, sensor: mi.Sensor, spp: int):
+        """
+        Check whether a differentiable rendering pass uses the same
+        configuration as the previous one (only when ``frozen`` is enabled)
+        """
+        if not self.frozen:
+            return
+
+        key = (id(scene), id(sensor), len(scene.shapes()),
+               tuple(sensor.film().crop_size()), spp)
+        self.frozen_steady = key == self.frozen_key
+        self.frozen_key = key
+
+    def reduce_locally(self, params: Any, wavefront_size: int) -> bool:
+        """
+        Decide whether the atomic scatter-reductions of an adjoint pass
+        should be reduced locally first (see the ``local_reduction``
+        parameter)
+        """
+        if self.local_reduction != 'auto':
+            return self.local_reduction == 'true'
+
+        def small_tensor(value) -> bool:
+            if isinstance(value, mi.SceneParameters):
+                return any(small_tensor(value[k]) for k in value.keys())
+            elif isinstance(value, dict):
+                return any(small_tensor(v) for v in value.values())
+            elif isinstance(value, (list, tuple)):
+                return any(small_tensor(v) for v in value)
+            return dr.is_tensor_v(value) and len(dr.shape(value)) >= 3 and \
+                dr.grad_enabled(value) and dr.width(value.array) * 8 <= wavefront_size
+
+        return small_tensor(params)
+
+    def collect(self):
+        """
+        Release unreferenced Python objects (and the Dr.Jit variables they
+        hold) before a kernel launch
+        """
+        if self.frozen_steady:
+            gc.collect(1)
+        else:
+            gc.collect()
+
     def render(self: mi.SamplingIntegrator,
                scene: mi.Scene,
                sensor: Union[int, mi.Sensor] = 0,
@@ -55,25 +145,112 @@ class ADIntegrator(mi.CppADIntegrator):
             raise Exception("develop=True must be specified when "
                             "invoking AD integrators")
 
+        collect_stats = mi.RenderStats.begin()
+        try:
+            if isinstance(sensor, int):
+                sensor = scene.sensors()[sensor]
+
+            film = sensor.film()
+
+            # Disable derivatives in all of the following
+            with dr.suspend_grad():
+                # Prepare the film and sample generator for rendering
+                sampler, spp = self.prepare(
+                    sensor=sensor,
+                    seed=seed,
+                    spp=spp,
+                    aovs=self.aov_names()
+                )
+                self.freeze(scene, sensor, spp)
+
+                # Generate a set of rays starting at the sensor
+                ray, weight, pos = self.sample_rays(scene, sensor, sampler)
+
+                # Launch the Monte Carlo sampling process in primal mode
+                L, valid, aovs, _ = self.sample(
+                    mode=dr.ADMode.Primal,
+                    scene=scene,
+                    sampler=sampler,
+                    ray=ray,
+                    depth=mi.UInt32(0),
+                    δL=None,
+                    δaovs=None,
+                    state_in=None,
+                    active=mi.Bool(True)
+                )
+
+                # Prepare an ImageBlock as specified by the film
+                block = film.create_block()
+
+                # Only use the coalescing feature when rendering enough samples
+                block.set_coalesce(block.coalesce() and spp >= 4)
+
+                # Accumulate into the image block
+                ADIntegrator._splat_to_block(
+                    block, film, pos,
+                    value=L * weight,
+                    weight=1.0,
+                    alpha=dr.select(valid, mi.Float(1), mi.Float(0)),
+                    aovs=aovs,
+                    wavelengths=ray.wavelengths
+                )
+
+                # Explicitly delete any remaining unused variables
+                del sampler, ray, weight, pos, L, valid
+                self.collect()
+
+                # Perform the weight division and return an image tensor
+                film.put_block(block)
+
+                image = film.develop()
+
+                # Launch the remaining kernels so that they appear in the stats
+                if collect_stats:
+                    dr.eval(image)
+
+                return image
+        finally:
+            if collect_stats:
+                mi.RenderStats.end(vcall_targets())
+
+    def render_ensemble(self: mi.SamplingIntegrator,
+                        scene: mi.Scene,
+                        ensemble_size: int,
+                        sensor: Union[int, mi.Sensor] = 0,
+                        seed: int = 0,
+                        spp: int = 0) -> mi.TensorXf:
+        """
+        Render ``ensemble_size`` statistically independent images within a
+        single wavefront and return them as a tensor of shape
+        ``(ensemble_size, height, width, channels)``.
+
+        The members are stacked vertically in one image block (separated by
+        rows that absorb the footprint of the reconstruction filter) and
+        developed one after the other.
+        """
+
+        if ensemble_size < 1:
+            raise Exception("render_ensemble(): the ensemble size must be "
+                            "positive!")
+
         if isinstance(sensor, int):
             sensor = scene.sensors()[sensor]
 
         film = sensor.film()
 
-        # Disable derivatives in all of the following
         with dr.suspend_grad():
-            # Prepare the film and sample generator for rendering
             sampler, spp = self.prepare(
                 sensor=sensor,
                 seed=seed,
                 spp=spp,
-                aovs=self.aov_names()
+                aovs=self.aov_names(),
+                ensemble_size=ensemble_size
             )
+            self.freeze(scene, sensor, spp)
 
-            # Generate a set of rays starting at the sensor
-            ray, weight, pos = self.sample_rays(scene, sensor, sampler)
+            ray, weight, pos = self.sample_rays(scene, sensor, sampler,
+                                                ensemble_size)
 
-            # Launch the Monte Carlo sampling process in primal mode
             L, valid, aovs, _ = self.sample(
                 mode=dr.ADMode.Primal,
                 scene=scene,
@@ -86,13 +263,25 @@ class ADIntegrator(mi.CppADIntegrator):
                 active=mi.Bool(True)
             )
 
-            # Prepare an ImageBlock as specified by the film
-            block = film.create_block()
-
-            # Only use the coalescing feature when rendering enough samples
+            crop_size = film.crop_size()
+            film_size = mi.ScalarVector2u(crop_size)
+            border_size = film.rfilter().border_size()
+            gap = border_size
+            if film.sample_border():
+                film_size += 2 * border_size
+                gap *= 2
+            stride = crop_size[1] + gap
+
+            # Shift the samples of every member to its rows of the block
+            member = dr.arange(mi.UInt32, dr.width(pos)) // \
+                dr.opaque(mi.UInt32, dr.prod(film_size) * spp)
+            pos.y += mi.Float(member * stride)
+
+            block = film.create_block(
+                size=[crop_size[0], stride * ensemble_size - gap])
+            block.set_offset(film.crop_offset())
             block.set_coalesce(block.coalesce() and spp >= 4)
 
-            # Accumulate into the image block
             ADIntegrator._splat_to_block(
                 block, film, pos,
                 value=L * weight,
@@ -102,14 +291,39 @@ class ADIntegrator(mi.CppADIntegrator):
                 wavelengths=ray.wavelengths
             )
 
-            # Explicitly delete any remaining unused variables
-            del sampler, ray, weight, pos, L, valid
-            gc.collect()
+            del sampler, ray, weight, pos, L, valid, member
+            self.collect()
+
+            # Launch the rendering kernel
+            tensor = block.tensor()
+            dr.eval(tensor)
+
+            # Develop the members, which are contiguous ranges of the block
+            channels = block.channel_count()
+            size = crop_size[0] * crop_size[1] * channels
+            index = dr.arange(mi.UInt32, size)
+            images = []
+            for i in range(ensemble_size):
+                values = dr.gather(mi.Float, tensor.array,
+                                   index + i * stride * crop_size[0] * channels)
+                member_block = mi.ImageBlock(
+                    mi.TensorXf(values, (crop_size[1], crop_size[0], channels)),
+                    offset=film.crop_offset(),
+                    rfilter=film.rfilter())
+                film.clear()
+                film.put_block(member_block)
+                image = film.develop()
+                dr.eval(image)
+                images.append(image)
 
-            # Perform the weight division and return an image tensor
-            film.put_block(block)
+            result = dr.zeros(mi.Float, dr.width(images[0].array) * ensemble_size)
+            index = dr.arange(mi.UInt32, dr.width(images[0].array))
+            for i, image in enumerate(images):
+                dr.scatter(result, image.array, index + i * dr.width(image.array))
 
-            return film.develop()
+            result = mi.TensorXf(result, (ensemble_size, *images[0].shape))
+            dr.eval(result)
+            return result
 
     def render_forward(self: mi.SamplingIntegrator,
                        scene: mi.Scene,
@@ -127,6 +341,7 @@ class ADIntegrator(mi.CppADIntegrator):
         with dr.suspend_grad():
             # Prepare the film and sample generator for rendering
             sampler, spp = self.prepare(sensor, seed, spp, self.aov_names())
+            self.freeze(scene, sensor, spp)
 
             # Generate a set of rays starting at the sensor, keep track of
             # derivatives wrt. sample positions ('pos') if there are any
@@ -180,6 +395,7 @@ class ADIntegrator(mi.CppADIntegrator):
         with dr.suspend_grad():
             # Prepare the film and sample generator for rendering
             sampler, spp = self.prepare(sensor, seed, spp, self.aov_names())
+            self.freeze(scene, sensor, spp)
 
             # Generate a set of rays starting at the sensor, keep track of
             # derivatives wrt. sample positions ('pos') if there are any
@@ -213,7 +429,7 @@ class ADIntegrator(mi.CppADIntegrator):
                 film.put_block(block)
 
                 del valid
-                gc.collect()
+                self.collect()
 
                 # This step launches a kernel
                 dr.schedule(block.tensor())
@@ -227,7 +443,7 @@ class ADIntegrator(mi.CppADIntegrator):
 
             # We don't need any of the outputs here
             del ray, weight, pos, block, sampler
-            gc.collect()
+            self.collect()
 
             # Run kernel representing side effects of the above
             dr.eval()
@@ -237,10 +453,14 @@ class ADIntegrator(mi.CppADIntegrator):
         scene: mi.Scene,
         sensor: mi.Sensor,
         sampler: mi.Sampler,
+        ensemble_size: int = 1
     ) -> Tuple[mi.RayDifferential3f, mi.Spectrum, mi.Vector2f, mi.Float]:
         """
         Sample a 2D grid of primary rays for a given sensor
 
+        When ``ensemble_size`` is larger than one, the grid is repeated for
+        every member of an ensemble (see ``render_ensemble()``).
+
         Returns a tuple containing
 
         - the set of sampled rays
@@ -260,7 +480,7 @@ class ADIntegrator(mi.CppADIntegrator):
         spp = sampler.sample_count()
 
         # Compute discrete sample position
-        idx = dr.arange(mi.UInt32, dr.prod(film_size) * spp)
+        idx = dr.arange(mi.UInt32, dr.prod(film_size) * spp * ensemble_size)
 
         # Try to avoid a division by an unknown constant if we can help it
         log_spp = dr.log2i(spp)
@@ -269,10 +489,18 @@ class ADIntegrator(mi.CppADIntegrator):
         else:
             idx //= dr.opaque(mi.UInt32, spp)
 
+        if ensemble_size > 1:
+            idx %= dr.opaque(mi.UInt32, dr.prod(film_size))
+
         # Compute the position on the image plane
         pos = mi.Vector2i()
-        pos.y = idx // film_size[0]
-        pos.x = dr.fma(-film_size[0], pos.y, idx)
+        if self.dynamic_film_size:
+            width = dr.opaque(mi.UInt32, film_size[0])
+            pos.y = idx // width
+            pos.x = idx - mi.UInt32(pos.y) * width
+        else:
+            pos.y = idx // film_size[0]
+            pos.x = dr.fma(-film_size[0], pos.y, idx)
 
         if film.sample_border():
             pos -= border_size
@@ -285,6 +513,9 @@ class ADIntegrator(mi.CppADIntegrator):
         # Re-scale the position to [0, 1]^2
         scale = dr.rcp(mi.ScalarVector2f(film.crop_size()))
         offset = -mi.ScalarVector2f(film.crop_offset()) * scale
+        if self.dynamic_film_size:
+            scale, offset = mi.Vector2f(scale), mi.Vector2f(offset)
+            dr.make_opaque(scale, offset)
         pos_adjusted = dr.fma(pos_f, scale, offset)
 
         aperture_sample = mi.Vector2f(0.0)
@@ -316,7 +547,8 @@ class ADIntegrator(mi.CppADIntegrator):
                 sensor: mi.Sensor,
                 seed: int = 0,
                 spp: int = 0,
-                aovs: list = []):
+                aovs: list = [],
+                ensemble_size: int = 1):
         """
         Given a sensor and a desired number of samples per pixel, this function
         computes the necessary number of Monte Carlo samples and then suitably
@@ -340,6 +572,10 @@ class ADIntegrator(mi.CppADIntegrator):
             Optional parameter to override the number of samples per pixel for the
             primal rendering step. The value provided within the original scene
             specification takes precedence if ``spp=0``.
+
+        Parameter ``ensemble_size`` (``int``):
+            Number of independent images rendered by the same wavefront (see
+            ``render_ensemble()``).
         """
 
         film = sensor.film()
@@ -356,7 +592,7 @@ class ADIntegrator(mi.CppADIntegrator):
         if film.sample_border():
             film_size += 2 * film.rfilter().border_size()
 
-        wavefront_size = dr.prod(film_size) * spp
+        wavefront_size = dr.prod(film_size) * spp * ensemble_size
 
         if wavefront_size > 2**32:
             raise Exception(
@@ -493,8 +729,94 @@ class RBIntegrator(ADIntegrator):
     """
     Abstract base class of radiative-backpropagation style differentiable
     integrators.
+
+    .. pluginparameters::
+
+     * - memory_budget
+       - |float|
+       - Upper bound (in MiB) for the per-sample state of a differentiable
+         rendering pass. When the estimate returned by ``lane_state()``
+         multiplied with the number of samples exceeds it, the work is split
+         into several passes that render fewer samples per pixel each.
+         (Default: 0, i.e. no limit)
+
+    Like the sampling process itself, the split trades memory for compute: the
+    adjoint pass recomputes the primal path state of each pass instead of
+    storing it for the full wavefront, and every pass adds the launch and
+    tracing cost of its kernels.
     """
 
+    def __init__(self, props = mi.Properties()):
+        super().__init__(props)
+
+        self.memory_budget = props.get('memory_budget', 0.0)
+        if self.memory_budget < 0:
+            raise Exception("\"memory_budget\" must be set to a value >= 0!")
+
+    def lane_state(self) -> list:
+        """
+        Return single-lane instances of the variables that make up the state of
+        a sample during a differentiable rendering pass. This is used to
+        estimate the memory footprint of a pass when a ``memory_budget`` is
+        specified, and subclasses with a larger path state should extend it.
+        """
+        return [
+            dr.zeros(mi.RayDifferential3f),               # Primary ray
+            dr.zeros(mi.Vector2f), dr.zeros(mi.Spectrum), # Position, weight
+            dr.zeros(mi.Spectrum), dr.zeros(mi.Spectrum), # L, δL
+            dr.zeros(mi.Spectrum), mi.Float(0),           # Throughput, η
+            mi.UInt32(0), mi.UInt32(0), mi.UInt64(0),     # Depth, sampler state
+            mi.Bool(False)                                # Active mask
+        ]
+
+    def split_passes(self, sensor: mi.Sensor, spp: int) -> List[int]:
+        """
+        Split the requested number of samples per pixel into passes that
+        respect the ``memory_budget``. Returns the sample count of every pass.
+        """
+        if spp == 0:
+            spp = sensor.sampler().sample_count()
+
+        if self.memory_budget <= 0 or spp <= 1:
+            return [spp]
+
+        def lane_bytes(value):
+            if isinstance(value, (list, tuple)):
+                return sum(lane_bytes(v) for v in value)
+            elif hasattr(value, 'DRJIT_STRUCT'):
+                return sum(lane_bytes(getattr(value, k))
+                           for k in value.DRJIT_STRUCT.keys())
+            elif dr.is_array_v(value):
+                if dr.depth_v(value) > 1:
+                    return sum(lane_bytes(v) for v in value)
+                return dr.itemsize_v(value)
+            return 0
+
+        film = sensor.film()
+        film_size = film.crop_size()
+        if film.sample_border():
+            film_size += 2 * film.rfilter().border_size()
+
+        sample_bytes = lane_bytes(self.lane_state())
+        pixel_bytes = float(dr.prod(film_size) * sample_bytes)
+        budget = self.memory_budget * 1024 * 1024
+
+        spp_per_pass = max(1, min(spp, int(budget // pixel_bytes)))
+        n_passes = (spp + spp_per_pass - 1) // spp_per_pass
+        if n_passes == 1:
+            return [spp]
+
+        passes = [spp // n_passes + (1 if i < spp % n_passes else 0)
+                  for i in range(n_passes)]
+
+        mi.Log(mi.LogLevel.Info,
+               f'{type(self).__name__}: splitting {spp} samples per pixel '
+               f'into {n_passes} passes ({sample_bytes} bytes of state per '
+               f'sample, estimated peak memory per pass: '
+               f'{passes[0] * pixel_bytes / (1024 * 1024):.1f} MiB)')
+
+        return passes
+
     def render_forward(self: mi.SamplingIntegrator,
                        scene: mi.Scene,
                        params: Any,
@@ -560,12 +882,26 @@ class RBIntegrator(ADIntegrator):
         if isinstance(sensor, int):
             sensor = scene.sensors()[sensor]
 
+        # Split the work into multiple passes to respect the memory budget
+        passes = self.split_passes(sensor, spp)
+        if len(passes) > 1:
+            result_grad = None
+            for i, spp_i in enumerate(passes):
+                seed_i = seed if i == 0 else mi.sample_tea_32(seed, i)[0]
+                grad_i = self.render_forward(scene, params, sensor,
+                                             seed_i, spp_i)
+                grad_i *= spp_i / sum(passes)
+                result_grad = grad_i if result_grad is None else result_grad + grad_i
+                dr.eval(result_grad)
+            return result_grad
+
         film = sensor.film()
 
         # Disable derivatives in all of the following
         with dr.suspend_grad():
             # Prepare the film and sample generator for rendering
             sampler, spp = self.prepare(sensor, seed, spp, self.aov_names())
+            self.freeze(scene, sensor, spp)
 
             # Generate a set of rays starting at the sensor, keep track of
             # derivatives wrt. sample positions ('pos') if there are any
@@ -622,7 +958,7 @@ class RBIntegrator(ADIntegrator):
             # Probably a little overkill, but why not.. If there are any
             # DrJit arrays to be collected by Python's cyclic GC, then
             # freeing them may enable loop simplifications in dr.eval().
-            gc.collect()
+            self.collect()
 
             result_grad = film.develop()
 
@@ -688,12 +1024,24 @@ class RBIntegrator(ADIntegrator):
         if isinstance(sensor, int):
             sensor = scene.sensors()[sensor]
 
+        # Split the work into multiple passes to respect the memory budget.
+        # Every pass back-propagates its share of the gradient image.
+        passes = self.split_passes(sensor, spp)
+        if len(passes) > 1:
+            for i, spp_i in enumerate(passes):
+                seed_i = seed if i == 0 else mi.sample_tea_32(seed, i)[0]
+                self.render_backward(scene, params,
+                                     grad_in * (spp_i / sum(passes)),
+                                     sensor, seed_i, spp_i)
+            return
+
         film = sensor.film()
 
         # Disable derivatives in all of the following
         with dr.suspend_grad():
             # Prepare the film and sample generator for rendering
             sampler, spp = self.prepare(sensor, seed, spp, self.aov_names())
+            self.freeze(scene, sensor, spp)
 
             # Generate a set of rays starting at the sensor, keep track of
             # derivatives wrt. sample positions ('pos') if there are any
@@ -728,7 +1076,7 @@ class RBIntegrator(ADIntegrator):
                 # Probably a little overkill, but why not.. If there are any
                 # DrJit arrays to be collected by Python's cyclic GC, then
                 # freeing them may enable loop simplifications in dr.eval().
-                gc.collect()
+                self.collect()
 
                 image = film.develop()
 
@@ -773,27 +1121,29 @@ class RBIntegrator(ADIntegrator):
                 active=mi.Bool(True)
             )
 
-            # Launch Monte Carlo sampling in backward AD mode (2)
-            L_2, valid_2, aovs_2, state_out_2 = self.sample(
-                mode=dr.ADMode.Backward,
-                scene=scene,
-                sampler=sampler,
-                ray=ray,
-                depth=mi.UInt32(0),
-                δL=δL,
-                δaovs=δaovs,
-                state_in=state_out,
-                active=mi.Bool(True)
-            )
+            local = self.reduce_locally(params, dr.width(ray))
+            with dr.scoped_set_flag(dr.JitFlag.AtomicReduceLocal, local):
+                # Launch Monte Carlo sampling in backward AD mode (2)
+                L_2, valid_2, aovs_2, state_out_2 = self.sample(
+                    mode=dr.ADMode.Backward,
+                    scene=scene,
+                    sampler=sampler,
+                    ray=ray,
+                    depth=mi.UInt32(0),
+                    δL=δL,
+                    δaovs=δaovs,
+                    state_in=state_out,
+                    active=mi.Bool(True)
+                )
 
-            # We don't need any of the outputs here
-            del L_2, valid_2, aovs_2, state_out, state_out_2, \
-                δL, δaovs, ray, weight, pos, sampler
+                # We don't need any of the outputs here
+                del L_2, valid_2, aovs_2, state_out, state_out_2, \
+                    δL, δaovs, ray, weight, pos, sampler
 
-            gc.collect()
+                self.collect()
 
-            # Run kernel representing side effects of the above
-            dr.eval()
+                # Run kernel representing side effects of the above
+                dr.eval()
 
 
 class PSIntegrator(ADIntegrator):
@@ -850,6 +1200,13 @@ class PSIntegrator(ADIntegrator):
         # suppress outliers. If set to 0, no transform will be applied.
         self.scale_mass = 0.
 
+        ##### PRIMARILY VISIBLE SILHOUETTE #####
+        # The silhouette edges of a mesh are cached per sensor. Only the edges
+        # adjacent to vertices that moved by more than this distance since the
+        # edges were last evaluated are re-tested. If set to 0, any motion
+        # triggers an update.
+        self.silhouette_tolerance = 0.
+
         ##### MESH PROJECTION #####
         # Mesh projection algorithm {'hybrid', 'walk', 'jump'}
         self.proj_mesh_algo = 'hybrid'
@@ -1324,3 +1681,14 @@ def mis_weight(pdf_a, pdf_b):
     b2 = dr.sqr(pdf_b)
     w = a2 / (a2 + b2)
     return dr.detach(dr.select(dr.isfinite(w), w, 0))
+
+
+def vcall_targets():
+    """
+    Return the number of instances that virtual function calls of each domain
+    (shapes, BSDFs, ...) may dispatch to in the current JIT variant. This is
+    recorded by :py:class:`mitsuba.RenderStats`.
+    """
+    return [(name, getattr(mi, name + 'Ptr').registry_get_max_())
+            for name in ('Shape', 'BSDF', 'Emitter', 'Sensor', 'Medium',
+                         'PhaseFunction')]
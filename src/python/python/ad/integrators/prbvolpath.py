@@ -39,6 +39,12 @@ class PRBVolpathIntegrator(RBIntegrator):
        - |bool|
        - Hide directly visible emitters. (Default: no, i.e. |false|)
 
+     * - memory_budget
+       - |float|
+       - Upper bound (in MiB) for the estimated state of all samples of a
+         differentiable rendering pass. Larger sample counts are automatically
+         split into several passes. (Default: 0, i.e. no limit)
+
 
     This class implements a volumetric Path Replay Backpropagation (PRB) integrator
     with the following properties:
@@ -59,6 +65,15 @@ class PRBVolpathIntegrator(RBIntegrator):
     See the paper :cite:`Vicini2021` for details on PRB and differentiable delta
     tracking.
 
+    The adjoint pass replays the path of every sample instead of storing its
+    vertices, hence its memory usage is dominated by the per-sample path state
+    (ray, surface and medium interactions, throughput, etc.) of the whole
+    wavefront. In dense volumes with many samples per pixel, this can exceed
+    the available device memory. Specifying a ``memory_budget`` bounds it by
+    rendering the gradients in several passes, which each replay a subset of the
+    samples. The number of passes and the estimated peak memory per pass are
+    reported in the log (at the ``Info`` level).
+
     .. warning::
         This integrator is not supported in variants which track polarization
         states.
@@ -77,6 +92,17 @@ class PRBVolpathIntegrator(RBIntegrator):
         self.handle_null_scattering = False
         self.is_prepared = False
 
+    def lane_state(self):
+        return super().lane_state() + [
+            dr.zeros(mi.SurfaceInteraction3f), # Surface interaction
+            dr.zeros(mi.Interaction3f),        # Last scattering event
+            dr.zeros(mi.MediumPtr),            # Current medium
+            mi.Float(0),                       # Last direction PDF
+            mi.UInt32(0),                      # Channel
+            mi.Bool(False), mi.Bool(False),    # Intersection & specular chain
+            mi.Bool(False)                     # Valid ray
+        ]
+
     def prepare_scene(self, scene):
         if self.is_prepared:
             return
@@ -52,6 +52,122 @@ class SolveCholesky(dr.CustomOp):
         return "Cholesky solve"
 
 
+class SolveConjugateGradient(dr.CustomOp):
+    """
+    DrJIT custom operator to solve a linear system using the conjugate gradient
+    method (see :py:class:`ConjugateGradientSolver`).
+    """
+
+    def eval(self, solver, u):
+        self.solver = solver
+        return solver.solve(u, 'primal')
+
+    def forward(self):
+        # The system matrix is symmetric, the adjoint solve is thus identical
+        self.set_grad_out(self.solver.solve(self.grad_in('u'), 'grad'))
+
+    def backward(self):
+        self.set_grad_in('u', self.solver.solve(self.grad_out(), 'grad'))
+
+    def name(self):
+        return "Conjugate gradient solve"
+
+
+class ConjugateGradientSolver():
+    """
+    Jacobi-preconditioned conjugate gradient solver for sparse symmetric
+    positive definite linear systems with three right-hand sides.
+
+    The solver is implemented with Dr.Jit and runs on the device of the current
+    variant, hence solutions don't need to be transferred to an external
+    library. The sparsity pattern and preconditioner are built once, and every
+    solve is warm-started from the previous solution of the same kind, which
+    typically only changes slightly between two iterations of an optimization.
+
+    The number of iterations is fixed, and converged systems are frozen on the
+    device instead of being checked on the host. A solve therefore never
+    synchronizes with the host, and its kernels are queued asynchronously like
+    those of any other Dr.Jit computation.
+    """
+
+    def __init__(self, n_rows, rows, cols, data, iterations=200, tolerance=1e-6):
+        """
+        Parameter ``n_rows`` (``int``):
+            Size of the linear system.
+
+        Parameters ``rows``, ``cols``, ``data`` (``mitsuba.UInt``, ``mitsuba.UInt``, ``mitsuba.Float``):
+            Entries of the system matrix in coordinate (COO) format, without
+            duplicates.
+
+        Parameter ``iterations`` (``int``):
+            Number of conjugate gradient iterations per solve.
+
+        Parameter ``tolerance`` (``float``):
+            Relative residual below which a solution is considered converged.
+        """
+        self.n_rows = n_rows
+        self.rows = rows
+        self.cols = cols
+        self.data = data
+        self.iterations = iterations
+        self.tolerance = tolerance
+
+        diag = dr.zeros(mi.Float, n_rows)
+        dr.scatter_reduce(dr.ReduceOp.Add, diag,
+                          dr.select(dr.eq(rows, cols), data, 0), rows)
+        self.inv_diag = dr.rcp(diag)
+        dr.eval(self.inv_diag)
+
+        # Previous solutions used as initial guesses
+        self.guesses = {}
+
+    def matvec(self, x):
+        """Multiply the system matrix with the columns of ``x``"""
+        y = dr.zeros(mi.Point3f, self.n_rows)
+        dr.scatter_reduce(dr.ReduceOp.Add, y,
+                          dr.gather(mi.Point3f, x, self.cols) * self.data,
+                          self.rows)
+        return y
+
+    def solve(self, b, key=None):
+        """
+        Solve the linear system for the right-hand sides ``b``
+        (``mitsuba.TensorXf`` of shape ``(n_rows, 3)``).
+
+        Solutions that share the same ``key`` warm-start each other.
+        """
+        def dot(a, b):
+            c = a * b
+            return mi.Point3f(dr.sum(c.x), dr.sum(c.y), dr.sum(c.z))
+
+        b = dr.unravel(mi.Point3f, b.array)
+        x = self.guesses.get(key)
+        if x is None:
+            x = b * self.inv_diag
+
+        r = b - self.matvec(x)
+        z = r * self.inv_diag
+        p = mi.Point3f(z)
+        rz = dot(r, z)
+        threshold = dot(b, b) * self.tolerance ** 2
+        dr.eval(x, r, p, rz, threshold)
+
+        for _ in range(self.iterations):
+            Ap = self.matvec(p)
+            active = rz > threshold
+            alpha = dr.select(active, rz / dot(p, Ap), 0)
+            x += alpha * p
+            r -= alpha * Ap
+            z = r * self.inv_diag
+            rz_new = dot(r, z)
+            p = z + dr.select(active, rz_new / rz, 0) * p
+            rz = rz_new
+            dr.eval(x, r, p, rz)
+
+        self.guesses[key] = x
+        return mi.TensorXf(dr.ravel(x), (self.n_rows, 3))
+
+
 class LargeSteps():
     """
     Implementation of the algorithm described in the paper "Large Steps in
@@ -69,8 +185,15 @@ class LargeSteps():
     cartesian and differential representations. Both transformations are
     differentiable, meshes can therefore be optimized by using the differential
     form as a latent variable.
+
+    The linear system is either solved using the Cholesky factorization of the
+    external ``cholespy`` package, or with Mitsuba's own conjugate gradient
+    solver (see :py:class:`ConjugateGradientSolver`). The latter doesn't
+    require any transfers between Dr.Jit and another library or
+    synchronization with the host, at the cost of an approximate solution.
     """
-    def __init__(self, verts, faces, lambda_=19.0):
+    def __init__(self, verts, faces, lambda_=19.0, solver='auto',
+                 cg_iterations=200, cg_tolerance=1e-6):
         """
         Build the system matrix and its Cholesky factorization.
 
@@ -85,13 +208,26 @@ class LargeSteps():
             on the surface. this value should increase with the tesselation of
             the mesh.
 
+        Parameter ``solver`` (``str``):
+            Linear solver: ``'cholesky'`` (requires ``cholespy``), ``'cg'``
+            (conjugate gradient solver), or ``'auto'`` to use the former when
+            ``cholespy`` is installed.
+
+        Parameters ``cg_iterations``, ``cg_tolerance`` (``int``, ``float``):
+            Number of iterations and relative tolerance of the conjugate
+            gradient solver.
         """
-        if mi.variant().endswith('double'):
-            from cholespy import CholeskySolverD as CholeskySolver
-        else:
-            from cholespy import CholeskySolverF as CholeskySolver
+        if solver == 'auto':
+            try:
+                import cholespy
+                solver = 'cholesky'
+            except ImportError:
+                solver = 'cg'
+
+        if solver not in ['cholesky', 'cg']:
+            raise Exception("LargeSteps: \"solver\" must be set to "
+                            "\"auto\", \"cholesky\", or \"cg\"!")
 
-        from cholespy import MatrixType
         import numpy as np
 
         v = verts.numpy().reshape((-1,3))
@@ -116,9 +252,23 @@ class LargeSteps():
 
         dr.scatter_reduce(dr.ReduceOp.Add, data.array, mi.Float64(values), mi.UInt(inverse_idx))
 
-        self.solver = CholeskySolver(self.n_verts, self.rows, self.cols, data, MatrixType.COO)
         self.data = mi.TensorXf(data)
 
+        if solver == 'cg':
+            self.solver = ConjugateGradientSolver(
+                self.n_verts, mi.UInt(self.rows.array), mi.UInt(self.cols.array),
+                self.data.array, cg_iterations, cg_tolerance)
+            self.solve_op = SolveConjugateGradient
+        else:
+            if mi.variant().endswith('double'):
+                from cholespy import CholeskySolverD as CholeskySolver
+            else:
+                from cholespy import CholeskySolverF as CholeskySolver
+            from cholespy import MatrixType
+
+            self.solver = CholeskySolver(self.n_verts, self.rows, self.cols, data, MatrixType.COO)
+            self.solve_op = SolveCholesky
+
     def to_differential(self, v):
         """
         Convert vertex coordinates to their differential form: u = (I + λL) v.
@@ -146,7 +296,8 @@ class LargeSteps():
         λL)⁻¹ u.
 
         This is done by solving the linear system (I + λL) v = u using the
-        previously computed Cholesky factorization.
+        previously computed Cholesky factorization, or the conjugate gradient
+        solver.
 
         This method is typically called at each iteration of the optimization,
         to update the mesh coordinates before rendering.
@@ -157,5 +308,5 @@ class LargeSteps():
         Returns ``mitsuba.Float`:
             Vertex coordinates of the mesh.
         """
-        v_unique = dr.unravel(mi.Point3f, dr.custom(SolveCholesky, self.solver, mi.TensorXf(u, (self.n_verts, 3))).array)
+        v_unique = dr.unravel(mi.Point3f, dr.custom(self.solve_op, self.solver, mi.TensorXf(u, (self.n_verts, 3))).array)
         return dr.ravel(dr.gather(mi.Point3f, v_unique, self.inverse))
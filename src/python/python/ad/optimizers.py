@@ -1,7 +1,9 @@
 from contextlib import contextmanager
 from collections import defaultdict
+import sys
 import drjit as dr
 import mitsuba as mi
+from .schedule import resample
 
 class Optimizer:
     """
@@ -108,6 +110,66 @@ class Optimizer:
         """
         pass
 
+    def resample(self, key: str, shape) -> None:
+        """
+        Change the resolution of a tensor-valued parameter of shape
+        ``(height, width[, channels])`` (e.g. a bitmap texture).
+
+        The parameter is resampled using :py:func:`mitsuba.ad.resample()`.
+        Optimizers that support it resample their internal state as well,
+        so that the optimization continues smoothly at the new resolution
+        (e.g. in a coarse-to-fine schedule, see
+        :py:class:`mitsuba.ad.ResolutionSchedule`). Otherwise, the state is
+        reset.
+
+        Parameter ``key`` (``str``):
+            The key of the parameter.
+
+        Parameter ``shape`` (``tuple``):
+            The new height and width.
+        """
+        p = self.variables[key]
+        if not dr.is_tensor_v(p) or len(dr.shape(p)) < 2:
+            raise Exception('Optimizer.resample(): only tensors with at least '
+                            'two dimensions can be resampled!')
+
+        old_shape = dr.shape(p)
+        value = type(p)(resample(p, shape))
+        dr.enable_grad(value)
+        self.variables[key] = value
+
+        if dr.shape(value) != old_shape:
+            self.resample_state(key, old_shape)
+
+    def resample_state(self, key, old_shape):
+        """
+        Adapts the internal state associated with a parameter after its
+        resolution changed (see :py:meth:`resample()`). The default
+        implementation resets it.
+        """
+        self.reset(key)
+
+
+def _resample_moment(value, old_shape, new_shape, power):
+    """
+    Resample a moment of the gradients of a tensor-valued parameter (stored as
+    a tensor or as a flat array) after the parameter's resolution changed.
+
+    The gradient of an entry is roughly proportional to the image area that it
+    covers. The moment is therefore scaled by the ratio of the old and new
+    entry areas raised to ``power`` (i.e. 1 for the first moment and 2 for the
+    second moment), which preserves the direction and the magnitude of the
+    updates of optimizers like Adam.
+    """
+    scale = ((old_shape[0] * old_shape[1]) /
+             (new_shape[0] * new_shape[1])) ** power
+    if dr.is_tensor_v(value):
+        return resample(value, new_shape[:2]) * scale
+
+    Float = dr.detached_t(mi.Float)
+    tensor = dr.detached_t(mi.TensorXf)(Float(value), old_shape)
+    return type(value)(resample(tensor, new_shape[:2]).array * scale)
+
 
 class SGD(Optimizer):
     """
@@ -184,6 +246,13 @@ class SGD(Optimizer):
 
         dr.eval()
 
+    def resample_state(self, key, old_shape):
+        """Resamples the velocity of a parameter whose resolution changed"""
+        if self.momentum == 0:
+            return
+        self.state[key] = _resample_moment(self.state[key], old_shape,
+                                           dr.shape(self.variables[key]), 1)
+
     def reset(self, key):
         """Zero-initializes the internal state associated with a parameter"""
         if self.momentum == 0:
@@ -223,9 +292,32 @@ class Adam(Optimizer):
 
     Enabling ``mask_updates`` avoids these two issues. This is similar to
     `PyTorch's SparseAdam optimizer <https://pytorch.org/docs/1.9.0/generated/torch.optim.SparseAdam.html>`_.
+
+    When optimizing many small parameters, the per-parameter work of a step
+    (uploading the bias-corrected learning rate, allocating new moment
+    buffers) can dominate. With ``fused=True``, the optimizer uploads the
+    learning rates of all parameters at once, writes the moments into their
+    existing buffers, and evaluates the updates of all parameters in a single
+    ``dr.eval()`` (Dr.Jit merges the updates of parameters with the same size
+    into one kernel). The optimizer state of each parameter is then stored as a
+    flat array. Combined with ``half_moments=True``, the moments are
+    furthermore stored in half precision, which halves their memory
+    footprint. Since the second moment is kept as its square root, this works
+    well as long as gradient magnitudes stay above :math:`\approx 10^{-4}`.
+
+    Large parameters (e.g. a :math:`512^3` volume grid or the vertex positions
+    of a dense mesh) are often only partially observed by a given view. With
+    ``sparse=True``, each step first compacts the indices and values of the
+    nonzero gradient entries (see :py:meth:`sparse_grad()`), and then only
+    gathers, updates and scatters back the moments and parameter values of
+    those entries. This implies ``mask_updates=True``, and avoids the
+    full-size temporary moment buffers and update kernels of a regular step.
+    The gradient itself is still accumulated into a dense buffer by Dr.Jit's
+    automatic differentiation.
     """
     def __init__(self, lr, beta_1=0.9, beta_2=0.999, epsilon=1e-8,
-                 mask_updates=False, uniform=False, params: dict=None):
+                 mask_updates=False, uniform=False, fused=False,
+                 half_moments=False, sparse=False, params: dict=None):
         """
         Parameter ``lr``:
             learning rate
@@ -246,22 +338,50 @@ class Adam(Optimizer):
             the second moment estimates at the current step instead of the
             per-element second moments.
 
+        Parameter ``fused``:
+            if enabled, all parameters are updated together, and the moments
+            are updated in place (see above)
+
+        Parameter ``half_moments``:
+            if enabled, the moments are stored in half precision. This
+            requires ``fused=True``.
+
+        Parameter ``sparse``:
+            if enabled, only the entries with nonzero gradients are updated,
+            using compact index and value buffers (see above). This cannot be
+            combined with ``fused=True``.
+
         Parameter ``params`` (:py:class:`dict`):
             Optional dictionary-like object containing parameters to optimize.
         """
         assert 0 <= beta_1 < 1 and 0 <= beta_2 < 1 \
             and lr > 0 and epsilon > 0
 
+        if half_moments and not fused:
+            raise Exception('Adam: half_moments=True requires fused=True!')
+        if sparse and fused:
+            raise Exception('Adam: sparse=True cannot be combined with fused=True!')
+
         self.beta_1 = beta_1
         self.beta_2 = beta_2
         self.epsilon = epsilon
         self.mask_updates = mask_updates
         self.uniform = uniform
+        self.fused = fused
+        self.half_moments = half_moments
+        self.sparse = sparse
         self.t = defaultdict(lambda: 0)
         super().__init__(lr, params)
 
     def step(self):
         """Take a gradient step"""
+        if self.fused:
+            self.step_fused()
+            return
+        elif self.sparse:
+            self.step_sparse()
+            return
+
         for k, p in self.variables.items():
             self.t[k] += 1
             lr_scale = dr.sqrt(1 - self.beta_2 ** self.t[k]) / (1 - self.beta_1 ** self.t[k])
@@ -301,12 +421,168 @@ class Adam(Optimizer):
 
         dr.eval()
 
+    def step_fused(self):
+        """Take a gradient step for all parameters at once (``fused=True``)"""
+        Float = dr.detached_t(mi.Float)
+
+        keys = []
+        for k, p in self.variables.items():
+            g_p = dr.grad(p)
+            if dr.shape(g_p) == 0:
+                continue
+            elif dr.width(Adam.flatten(g_p)) != dr.width(self.state[k][0]):
+                # Reset state if data size has changed
+                self.reset(k)
+            self.t[k] += 1
+            keys.append(k)
+
+        if len(keys) == 0:
+            return
+
+        # Upload the bias-corrected learning rates of all parameters at once.
+        # The array is opaque so that the rates don't end up in the kernels.
+        lr_t = Float([self.lr[k] * (1 - self.beta_2 ** self.t[k]) ** 0.5 /
+                      (1 - self.beta_1 ** self.t[k]) for k in keys])
+        dr.make_opaque(lr_t)
+
+        for i, k in enumerate(keys):
+            p = self.variables[k]
+            g_p = Adam.flatten(dr.detach(dr.grad(p)))
+            m_tp, v_tp = self.state[k]
+
+            # Half precision moments store the square root of 'v'
+            m_prev = Float(m_tp)
+            v_prev = dr.sqr(Float(v_tp)) if self.half_moments else Float(v_tp)
+
+            m_t = self.beta_1 * m_prev + (1 - self.beta_1) * g_p
+            v_t = self.beta_2 * v_prev + (1 - self.beta_2) * dr.sqr(g_p)
+            if self.mask_updates:
+                nonzero = dr.neq(g_p, 0.)
+                m_t = dr.select(nonzero, m_t, m_prev)
+                v_t = dr.select(nonzero, v_t, v_prev)
+
+            # Write the new moments into the existing state buffers
+            index = dr.arange(dr.uint32_array_t(Float), dr.width(g_p))
+            dr.scatter(m_tp, type(m_tp)(m_t), index)
+            dr.scatter(v_tp, type(v_tp)(dr.sqrt(v_t) if self.half_moments
+                                        else v_t), index)
+
+            lr_k = dr.gather(Float, lr_t, dr.uint32_array_t(Float)(i))
+            if self.uniform:
+                step = lr_k * m_t / (dr.sqrt(dr.max(v_t)) + self.epsilon)
+            else:
+                step = lr_k * m_t / (dr.sqrt(v_t) + self.epsilon)
+            if self.mask_updates:
+                step = dr.select(nonzero, step, 0.)
+
+            u = Adam.unflatten(p, Adam.flatten(dr.detach(p)) - step)
+            dr.enable_grad(u)
+            self.variables[k] = u
+            dr.schedule(self.variables[k])
+
+        dr.eval()
+
+    def step_sparse(self):
+        """Take a gradient step that only updates the entries with nonzero
+        gradients (``sparse=True``)"""
+        Float = dr.detached_t(mi.Float)
+
+        for k, p in self.variables.items():
+            g_p = dr.grad(p)
+            if dr.shape(g_p) == 0:
+                continue
+            elif dr.width(Adam.flatten(g_p)) != dr.width(self.state[k][0]):
+                # Reset state if data size has changed
+                self.reset(k)
+
+            self.t[k] += 1
+            lr_t = dr.opaque(Float, self.lr[k] * (1 - self.beta_2 ** self.t[k]) ** 0.5 /
+                             (1 - self.beta_1 ** self.t[k]), shape=1)
+
+            index, g_s = Adam.sparse_grad(p)
+            if dr.width(index) == 0:
+                continue
+
+            m_tp, v_tp = self.state[k]
+            m_t = self.beta_1 * dr.gather(Float, m_tp, index) + (1 - self.beta_1) * g_s
+            v_t = self.beta_2 * dr.gather(Float, v_tp, index) + (1 - self.beta_2) * dr.sqr(g_s)
+            dr.scatter(m_tp, m_t, index)
+            dr.scatter(v_tp, v_t, index)
+
+            if self.uniform:
+                step = lr_t * m_t / (dr.sqrt(dr.max(v_tp)) + self.epsilon)
+            else:
+                step = lr_t * m_t / (dr.sqrt(v_t) + self.epsilon)
+
+            value = Float(Adam.flatten(dr.detach(p)))
+            dr.scatter_reduce(dr.ReduceOp.Add, value, -step, index)
+
+            u = Adam.unflatten(p, value)
+            dr.enable_grad(u)
+            self.variables[k] = u
+            dr.schedule(self.variables[k], self.state[k])
+
+        dr.eval()
+
+    @staticmethod
+    def sparse_grad(value):
+        """
+        Return the gradient of a parameter in a compact form.
+
+        Returns the flat indices of the entries with a nonzero gradient, and
+        the corresponding gradient values (see :py:meth:`flatten()` for the
+        order of the entries).
+        """
+        g = Adam.flatten(dr.detach(dr.grad(value)))
+        index = dr.compress(dr.neq(g, 0.))
+        return index, dr.gather(type(g), g, index)
+
+    @staticmethod
+    def flatten(value):
+        """Return the entries of a (detached) parameter as a flat array"""
+        if dr.is_tensor_v(value):
+            return value.array
+        elif dr.depth_v(value) > 1:
+            return dr.ravel(value)
+        return value
+
+    @staticmethod
+    def unflatten(p, value):
+        """Convert a flat array into a parameter of the same type as ``p``"""
+        if dr.is_tensor_v(p):
+            value = dr.detached_t(p)(value, dr.shape(p))
+        elif dr.depth_v(p) > 1:
+            value = dr.unravel(dr.detached_t(p), value)
+        return type(p)(value)
+
+    def resample_state(self, key, old_shape):
+        """Resamples the moments of a parameter whose resolution changed"""
+        new_shape = dr.shape(self.variables[key])
+        m_t, v_t = self.state[key]
+
+        # Half precision moments store the square root of 'v'
+        self.state[key] = (
+            _resample_moment(m_t, old_shape, new_shape, 1),
+            _resample_moment(v_t, old_shape, new_shape,
+                             1 if self.half_moments else 2))
+
     def reset(self, key):
         """Zero-initializes the internal state associated with a parameter"""
         p = self.variables[key]
-        shape = dr.shape(p) if p.IsTensor else dr.width(p)
-        self.state[key] = (dr.zeros(dr.detached_t(p), shape),
-                           dr.zeros(dr.detached_t(p), shape))
+        if self.fused or self.sparse:
+            # Flat moments, optionally stored in half precision
+            Float = dr.detached_t(mi.Float)
+            if self.half_moments:
+                Float = getattr(sys.modules[Float.__module__], 'Float16', None)
+                if Float is None:
+                    raise Exception('Adam: half precision arrays are not '
+                                    'supported by this version of Dr.Jit!')
+            width = dr.width(Adam.flatten(dr.detach(p)))
+            self.state[key] = (dr.zeros(Float, width), dr.zeros(Float, width))
+        else:
+            shape = dr.shape(p) if p.IsTensor else dr.width(p)
+            self.state[key] = (dr.zeros(dr.detached_t(p), shape),
+                               dr.zeros(dr.detached_t(p), shape))
         self.t[key] = 0
 
     def __repr__(self):
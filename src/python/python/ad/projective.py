@@ -18,6 +18,9 @@ class ProjectiveDetail():
         self.primary_distributions = []
         self.primary_shape_distribution = None
 
+        # Cached silhouettes of meshes as seen from each sensor
+        self.silhouette_cache = {}
+
         # Guiding data structre
         self.guiding_distr = None
 
@@ -39,16 +42,84 @@ class ProjectiveDetail():
         viewpoint = mi.ScalarPoint3f(dr.slice(sensor.world_transform() @ mi.Point3f(0)))
         shapes_weight = []
 
+        # The sensor is stored along with its cache, so that its `id()` can't
+        # be reused by another object
+        key = id(sensor)
+        if key not in self.silhouette_cache:
+            self.silhouette_cache[key] = (sensor, {})
+        cache = self.silhouette_cache[key][1]
+
         for i in range(len(silhouette_shapes)):
-            indices, weights = silhouette_shapes[i].precompute_silhouette(viewpoint)
+            shape = silhouette_shapes[i]
+            if shape.is_mesh():
+                entry = cache.setdefault(id(shape), { 'shape': shape })
+                self.update_mesh_silhouette(entry, viewpoint)
+                indices, distr = entry['indices'], entry['distr']
+            else:
+                indices, weights = shape.precompute_silhouette(viewpoint)
+                distr = mi.DiscreteDistribution(weights)
 
             self.primary_indices.append(indices)
-            shapes_weight.append(silhouette_shapes[i].silhouette_sampling_weight())
-            self.primary_distributions.append(mi.DiscreteDistribution(weights))
+            shapes_weight.append(shape.silhouette_sampling_weight())
+            self.primary_distributions.append(distr)
 
         shapes_weight = mi.Float(shapes_weight)
         self.primary_shape_distribution = mi.DiscreteDistribution(shapes_weight)
 
+    def update_mesh_silhouette(self, entry: dict, viewpoint: mi.ScalarPoint3f):
+        """
+        Update the cached silhouette of a mesh as seen from ``viewpoint``.
+
+        The cache entry stores the silhouette weight of every directed edge of
+        the mesh along with the vertex positions that were used to compute
+        them. If the viewpoint didn't change, only the edges whose adjacent
+        faces contain a vertex that moved by more than the integrator's
+        ``silhouette_tolerance`` are evaluated again.
+        """
+        mesh = entry['shape']
+        dedge_count = mesh.face_count() * 3
+        positions = mesh.vertex_position(dr.arange(mi.UInt32, mesh.vertex_count()))
+
+        if 'viewpoint' not in entry or \
+           dr.any(dr.neq(entry['viewpoint'], viewpoint)) or \
+           dr.width(entry['positions']) != dr.width(positions) or \
+           dr.width(entry['weights']) != dedge_count:
+            entry['viewpoint'] = viewpoint
+            entry['positions'] = positions
+            entry['weights'] = mesh.silhouette_edge_weight(
+                viewpoint, dr.arange(mi.UInt32, dedge_count))
+        else:
+            tolerance = getattr(self.parent, 'silhouette_tolerance', 0.)
+            moved = dr.norm(positions - entry['positions']) > tolerance
+            if not dr.any(moved):
+                return
+
+            # Faces with a moved vertex invalidate their own edges as well as
+            # the opposite edges of the neighboring faces
+            face_count = mesh.face_count()
+            fi = mesh.face_indices(dr.arange(mi.UInt32, face_count))
+            face_moved = dr.gather(mi.Bool, moved, fi.x) | \
+                         dr.gather(mi.Bool, moved, fi.y) | \
+                         dr.gather(mi.Bool, moved, fi.z)
+
+            dedges = dr.arange(mi.UInt32, dedge_count)
+            dedge_oppo = mesh.opposite_dedge(dedges)
+            has_oppo = dr.neq(dedge_oppo, 0xFFFFFFFF)
+            dirty = dr.gather(mi.Bool, face_moved, dedges // 3) | \
+                    dr.gather(mi.Bool, face_moved, dedge_oppo // 3, has_oppo)
+
+            dirty_dedges = dr.compress(dirty)
+            dr.scatter(entry['weights'],
+                       mesh.silhouette_edge_weight(viewpoint, dirty_dedges),
+                       dirty_dedges)
+            entry['positions'] = dr.select(moved, positions, entry['positions'])
+
+        dr.eval(entry['weights'], entry['positions'])
+        weights = entry['weights']
+        entry['indices'] = dr.compress(weights > 0)
+        entry['distr'] = mi.DiscreteDistribution(
+            dr.gather(mi.Float, weights, entry['indices']))
+
     def sample_primarily_visible_silhouette(self,
                                             scene: mi.Scene,
                                             viewpoint: mi.Point3f,
@@ -0,0 +1,218 @@
+from __future__ import annotations as __annotations__ # Delayed parsing of type annotations
+
+import mitsuba as mi
+import drjit as dr
+
+
+def resample(value, shape):
+    """
+    Resample a tensor of shape ``(height, width[, channels])`` to a new height
+    and width.
+
+    Each entry of the result bilinearly interpolates the four closest entries
+    of the input (when upsampling), or averages the corresponding block of
+    entries (when downsampling by integer factors).
+
+    Parameter ``value`` (``mi.TensorXf``):
+        The tensor to resample.
+
+    Parameter ``shape`` (``tuple``):
+        The new height and width.
+
+    Returns the resampled tensor (detached from the AD graph).
+    """
+    value = dr.detach(value)
+    Float = type(value.array)
+    UInt32 = dr.uint32_array_t(Float)
+
+    h, w = value.shape[0], value.shape[1]
+    h2, w2 = int(shape[0]), int(shape[1])
+    channels = 1
+    for c in value.shape[2:]:
+        channels *= c
+
+    if h2 < 1 or w2 < 1:
+        raise Exception('resample(): the new height and width must be positive!')
+    if (h2, w2) == (h, w):
+        return type(value)(value)
+
+    idx = dr.arange(UInt32, h2 * w2 * channels)
+    ch = idx % channels
+    pixel = idx // channels
+    y = pixel // w2
+    x = pixel - y * w2
+
+    def at(yy, xx):
+        return dr.gather(Float, value.array, (yy * w + xx) * channels + ch)
+
+    if h % h2 == 0 and w % w2 == 0:
+        # Box filter for integer downsampling factors
+        fy, fx = h // h2, w // w2
+        result = dr.zeros(Float, h2 * w2 * channels)
+        for i in range(fy):
+            for j in range(fx):
+                result += at(y * fy + i, x * fx + j)
+        result *= 1.0 / (fy * fx)
+    else:
+        def coords(i, n, n2):
+            t = dr.clamp((Float(i) + 0.5) * (n / n2) - 0.5, 0, n - 1)
+            i0 = UInt32(dr.floor(t))
+            return i0, dr.minimum(i0 + 1, n - 1), t - Float(i0)
+
+        y0, y1, ty = coords(y, h, h2)
+        x0, x1, tx = coords(x, w, w2)
+        result = dr.lerp(dr.lerp(at(y0, x0), at(y0, x1), tx),
+                         dr.lerp(at(y1, x0), at(y1, x1), tx), ty)
+
+    return type(value)(result, (h2, w2) + tuple(value.shape[2:]))
+
+
+class ResolutionSchedule:
+    """
+    Coarse-to-fine schedule of an inverse rendering optimization
+
+    Early iterations of an optimization mostly recover the coarse structure of
+    the parameters, which doesn't require full resolution renderings with many
+    samples per pixel. This class splits an optimization into a sequence of
+    stages that each specify
+
+    - ``iterations``: the number of iterations of the stage,
+    - ``scale``: the resolution of the film relative to its original size
+      (Default: 1),
+    - ``spp``: the sample count of the differentiable renderings
+      (Default: the sample count of the sensor),
+    - ``textures``: an optional dictionary that maps the keys of tensor-valued
+      parameters (e.g. bitmap textures) to their new height and width.
+
+    The optimization loop calls :py:meth:`step()` at the beginning of every
+    iteration. When a new stage begins, it resizes the film of the sensor,
+    and resamples the textures along with the state of the optimizer (see
+    :py:meth:`mitsuba.ad.Optimizer.resample()`). Reference images can be
+    resampled to the current film resolution via :py:meth:`target()`.
+
+    .. code-block:: python
+
+        schedule = mi.ad.ResolutionSchedule(sensor, [
+            { 'iterations': 100, 'scale': 0.25, 'spp': 4,
+              'textures': { key: (128, 128) } },
+            { 'iterations': 100, 'scale': 0.5, 'spp': 8,
+              'textures': { key: (256, 256) } },
+            { 'iterations': 100, 'spp': 16,
+              'textures': { key: (512, 512) } },
+        ])
+
+        for it in range(schedule.iterations):
+            schedule.step(it, opt, params)
+            image = mi.render(scene, params, sensor=sensor, spp=schedule.spp,
+                              seed=it, integrator=integrator)
+            loss = dr.mean(dr.sqr(image - schedule.target(image_ref)))
+            ...
+
+    Differentiable integrators generate different kernels for every film
+    resolution. Set their ``dynamic_film_size`` parameter to reuse the ray
+    generation code across the stages of the schedule.
+    """
+
+    def __init__(self, sensor: mi.Sensor, stages: list):
+        """
+        Parameter ``sensor`` (``mi.Sensor``):
+            Sensor whose film resolution is changed by the schedule.
+
+        Parameter ``stages`` (``list``):
+            List of dictionaries describing the stages (see above).
+        """
+        if len(stages) == 0:
+            raise Exception('ResolutionSchedule: at least one stage is required!')
+
+        self.sensor = sensor
+        self.full_size = mi.ScalarVector2u(sensor.film().size())
+        self.stages = []
+        for stage in stages:
+            unknown = set(stage.keys()) - {'iterations', 'scale', 'spp', 'textures'}
+            if len(unknown) > 0:
+                raise Exception(f'ResolutionSchedule: unknown stage entries {sorted(unknown)}!')
+            stage = dict(stage)
+            stage.setdefault('scale', 1.0)
+            stage.setdefault('spp', 0)
+            stage.setdefault('textures', {})
+            if stage['iterations'] < 1 or not (0 < stage['scale'] <= 1):
+                raise Exception('ResolutionSchedule: stages require a positive '
+                                'iteration count and a scale in (0, 1]!')
+            self.stages.append(stage)
+
+        self.stage = -1
+        self.targets = {}
+
+    @property
+    def iterations(self) -> int:
+        """Total number of iterations of all stages"""
+        return sum(stage['iterations'] for stage in self.stages)
+
+    @property
+    def spp(self) -> int:
+        """Sample count of the current stage (0: use the sensor's sample count)"""
+        return self.stages[max(self.stage, 0)]['spp']
+
+    def stage_index(self, it: int) -> int:
+        """Return the index of the stage that contains iteration ``it``"""
+        for i, stage in enumerate(self.stages):
+            if it < stage['iterations']:
+                return i
+            it -= stage['iterations']
+        return len(self.stages) - 1
+
+    def size(self, index: int = None) -> mi.ScalarVector2u:
+        """Return the film resolution of a stage (the current one by default)"""
+        scale = self.stages[self.stage if index is None else index]['scale']
+        return mi.ScalarVector2u(
+            max(1, round(self.full_size[0] * scale)),
+            max(1, round(self.full_size[1] * scale)))
+
+    def step(self, it: int, opt: mi.ad.Optimizer = None,
+             params: mi.SceneParameters = None) -> bool:
+        """
+        Apply the stage of iteration ``it``.
+
+        Parameter ``opt`` (:py:class:`mitsuba.ad.Optimizer`):
+            Optimizer whose textures are resampled when a new stage begins.
+
+        Parameter ``params`` (:py:class:`mitsuba.python.util.SceneParameters`):
+            Scene parameters that receive the resampled textures.
+
+        Returns ``True`` when a new stage began.
+        """
+        index = self.stage_index(it)
+        if index == self.stage:
+            return False
+        self.stage = index
+        stage = self.stages[index]
+
+        sensor_params = mi.traverse(self.sensor)
+        size = self.size()
+        if dr.any(dr.neq(sensor_params['film.size'], size)):
+            sensor_params['film.size'] = size
+            sensor_params.update()
+
+        for key, shape in stage['textures'].items():
+            if opt is None:
+                raise Exception('ResolutionSchedule.step(): an optimizer is '
+                                'required to resample textures!')
+            opt.resample(key, shape)
+            if params is not None:
+                params[key] = opt[key]
+
+        if params is not None:
+            params.update()
+
+        return True
+
+    def target(self, image: mi.TensorXf) -> mi.TensorXf:
+        """
+        Resample a reference image to the film resolution of the current stage.
+        The result is cached for subsequent iterations of the stage.
+        """
+        size = self.size()
+        key = (id(image), size[0], size[1])
+        if key not in self.targets:
+            self.targets = { key: resample(image, (size[1], size[0])) }
+        return self.targets[key]
@@ -568,7 +568,7 @@ def EmitterAdapter(emitter_type, extra):
     return sample_functor, pdf_functor
 
 
-def MicrofacetAdapter(md_type, alpha, sample_visible=False):
+def MicrofacetAdapter(md_type, alpha, sample_visible=False, vndf_sampling=None):
     """
     Adapter for testing microfacet distribution sampling techniques
     (separately from BSDF models, which are also tested)
@@ -579,7 +579,10 @@ def MicrofacetAdapter(md_type, alpha, sample_visible=False):
         if len(args) == 1:
             angle = args[0] * dr.pi / 180
             wi = mi.Vector3f([dr.sin(angle), 0, dr.cos(angle)])
-        return mi.MicrofacetDistribution(md_type, alpha, sample_visible), wi
+        dist = mi.MicrofacetDistribution(md_type, alpha, sample_visible)
+        if vndf_sampling is not None:
+            dist.set_vndf_sampling(vndf_sampling)
+        return dist, wi
 
     def sample_functor(sample, *args):
         dist, wi = instantiate(args)
@@ -56,3 +56,35 @@ def test03_non_unique_vertices(variants_all_ad_rgb):
     lambda_ = 25
     ls = mi.ad.LargeSteps(params['vertex_positions'], params['faces'], lambda_)
     assert ls.n_verts == 4
+
+
+def test04_conjugate_gradient(variants_all_ad_rgb):
+    # Closed octahedron
+    mesh = mi.Mesh("MyMesh", 6, 8)
+    params = mi.traverse(mesh)
+    params['vertex_positions'] = [1, 0, 0, -1, 0, 0, 0, 1, 0,
+                                  0, -1, 0, 0, 0, 1, 0, 0, -1]
+    params['faces'] = [0, 2, 4, 2, 1, 4, 1, 3, 4, 3, 0, 4,
+                       2, 0, 5, 1, 2, 5, 3, 1, 5, 0, 3, 5]
+    params.update()
+
+    lambda_ = 25
+    ls = mi.ad.LargeSteps(params['vertex_positions'], params['faces'], lambda_,
+                          solver='cg')
+    assert isinstance(ls.solver, mi.ad.largesteps.ConjugateGradientSolver)
+
+    initial = params['vertex_positions']
+    u = ls.to_differential(initial)
+    assert dr.allclose(initial, ls.from_differential(u), atol=1e-5)
+
+    # Warm-started solves of a perturbed system
+    u += 0.1
+    v = ls.from_differential(u)
+    assert dr.allclose(ls.to_differential(v), u, atol=1e-4)
+
+    # The gradient is propagated through the solve
+    dr.enable_grad(u)
+    v = ls.from_differential(u)
+    dr.backward(dr.sum(v))
+    assert dr.allclose(ls.to_differential(dr.detach(dr.grad(u))),
+                       dr.ones(mi.Float, dr.width(u)), atol=1e-4)
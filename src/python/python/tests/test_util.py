@@ -312,3 +312,127 @@ def test06_variant_context():
     except RuntimeError:
         pass
     assert mi.variant() == "scalar_rgb"
+
+
+def test07_scene_signature(variants_all_rgb):
+    def make_scene(reflectance, shape='sphere'):
+        return mi.load_dict({
+            'type': 'scene',
+            'integrator': { 'type': 'path' },
+            'sensor': {
+                'type': 'perspective',
+                'film': { 'type': 'hdrfilm', 'width': 8, 'height': 8 }
+            },
+            'shape': {
+                'type': shape,
+                'bsdf': { 'type': 'diffuse', 'reflectance': { 'type': 'rgb', 'value': reflectance } }
+            }
+        })
+
+    sig = mi.util.scene_signature(make_scene([0.1, 0.2, 0.3]))
+
+    # Parameter values do not affect the signature
+    assert mi.util.scene_signature(make_scene([0.5, 0.5, 0.5])) == sig
+
+    # .. but the plugin graph and the sample count do
+    assert mi.util.scene_signature(make_scene([0.1, 0.2, 0.3], 'cube')) != sig
+    assert mi.util.scene_signature(make_scene([0.1, 0.2, 0.3]), spp=3) != sig
+
+
+def test08_prepare(variants_vec_backends_once_rgb, tmp_path):
+    import json, os
+    scene = mi.load_dict(mi.cornell_box())
+
+    record = mi.util.prepare(scene, spp=1, record_dir=str(tmp_path))
+    assert record['signature'] == mi.util.scene_signature(scene, spp=1)
+    assert len(record['kernels']) > 0
+
+    with open(os.path.join(str(tmp_path), record['signature'] + '.json')) as f:
+        assert json.load(f)['signature'] == record['signature']
+
+    # The second pass finds all kernels in the cache
+    record = mi.util.prepare(scene, spp=1)
+    assert all(k['cache_hit'] for k in record['kernels'])
+
+
+def test09_render_batch(variants_all_rgb):
+    def make_scene(reflectance, shape='sphere'):
+        return {
+            'type': 'scene',
+            'integrator': { 'type': 'path' },
+            'sensor': {
+                'type': 'perspective',
+                'to_world': mi.ScalarTransform4f.look_at(origin=[0, 0, 4],
+                                                         target=[0, 0, 0],
+                                                         up=[0, 1, 0]),
+                'film': { 'type': 'hdrfilm', 'width': 8, 'height': 6 }
+            },
+            'shape': {
+                'type': shape,
+                'bsdf': { 'type': 'diffuse', 'reflectance': { 'type': 'rgb', 'value': reflectance } }
+            },
+            'emitter': { 'type': 'constant' }
+        }
+
+    reflectances = [[0.1, 0.2, 0.3], [0.5, 0.5, 0.5], [0.9, 0.1, 0.1]]
+    descs = [make_scene(r) for r in reflectances]
+
+    # Scenes can be specified as dictionaries or as loaded scenes
+    descs[1] = mi.load_dict(descs[1])
+
+    images = mi.render_batch(descs, seed=3, spp=4)
+    assert images.shape == (3, 6, 8, 3)
+
+    for i, r in enumerate(reflectances):
+        scene = mi.load_dict(make_scene(r))
+        ref = mi.render(scene, seed=3 + i, spp=4)
+        assert dr.allclose(images[i].array, ref.array)
+
+    # All scenes must share the same structure
+    with pytest.raises(Exception, match='same structure'):
+        mi.render_batch([make_scene([0.5] * 3), make_scene([0.5] * 3, 'cube')])
+
+
+def test10_interactive_session(variants_all_rgb):
+    scene = mi.load_dict({
+        'type': 'scene',
+        'integrator': { 'type': 'path' },
+        'sensor': {
+            'type': 'perspective',
+            'to_world': mi.ScalarTransform4f.look_at(origin=[0, 0, 4],
+                                                     target=[0, 0, 0],
+                                                     up=[0, 1, 0]),
+            'film': { 'type': 'hdrfilm', 'width': 8, 'height': 6 }
+        },
+        'shape': { 'type': 'sphere' },
+        'emitter': { 'type': 'constant' }
+    })
+
+    session = mi.InteractiveSession(scene, seed=5, spp_per_pass=2,
+                                    target_time=0)
+    assert session.step() == 1
+    assert session.step() == 2
+    assert session.spp == 4
+
+    # The estimate is the average of the passes
+    ref = (mi.render(scene, seed=5, spp=2) + mi.render(scene, seed=6, spp=2)) * 0.5
+    image = session.image()
+    assert dr.allclose(image.array, ref.array)
+
+    # Downsampled readback of a region
+    preview = mi.TensorXf(session.preview(scale=2, crop=(2, 0, 4, 6)))
+    assert preview.shape == (3, 2, 3)
+    block = (image[0, 2] + image[0, 3] + image[1, 2] + image[1, 3]) * 0.25
+    assert dr.allclose(preview[0, 0].array, block.array)
+
+    with pytest.raises(Exception, match='invalid region'):
+        session.preview(crop=(6, 0, 4, 6))
+
+    # Moving the camera restarts the accumulation
+    session.set_camera(mi.ScalarTransform4f.look_at(origin=[0, 0, 5],
+                                                    target=[0, 0, 0],
+                                                    up=[0, 1, 0]))
+    assert session.passes == 0
+    assert session.step() == 1
+    assert dr.allclose(session.image().array,
+                       mi.render(scene, seed=5, spp=2).array)
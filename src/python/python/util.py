@@ -8,7 +8,7 @@ import mitsuba as mi
 
 import typing
 if typing.TYPE_CHECKING:
-    from typing import Any, Optional, Union
+    from typing import Any, Optional, Sequence, Union
 
 class SceneParameters(Mapping):
     """
@@ -217,13 +217,11 @@ class SceneParameters(Mapping):
         for key in self.keys():
             dr.schedule(self.__get_value(key))
 
-        # Notify nodes from bottom to top
+        # Notify nodes from bottom to top (nodes at the same depth in parallel)
         work_list = [(d, n, k) for (d, n), k in self.nodes_to_update.items()]
-        work_list = reversed(sorted(work_list, key=lambda x: x[0]))
-        out = []
-        for _, node, keys in work_list:
-            node.parameters_changed(list(keys))
-            out.append((node, keys))
+        work_list = list(reversed(sorted(work_list, key=lambda x: x[0])))
+        mi.parameters_changed_batch([(d, n, list(k)) for d, n, k in work_list])
+        out = [(node, keys) for _, node, keys in work_list]
 
         self.nodes_to_update.clear()
         self.update_candidates.clear()
@@ -522,6 +520,438 @@ def render(scene: mi.Scene,
     return dr.custom(_RenderOp, scene, sensor, params, integrator,
                      (seed, seed_grad), (spp, spp_grad))
 
+# ------------------------------------------------------------------------------
+#                               Kernel warm-up
+# ------------------------------------------------------------------------------
+
+def scene_signature(scene: mi.Scene,
+                    integrator: mi.Integrator = None,
+                    sensor: Union[int, mi.Sensor] = 0,
+                    spp: int = 0) -> str:
+    """
+    Compute a hash of the configuration that determines which kernels are
+    generated when rendering ``scene``.
+
+    The hash covers the active variant, the structure of the plugin graph
+    (class and traversal name of every object, name and type of every
+    parameter, shape of tensors), the film size and the sample count. Plugin
+    parameter values are deliberately excluded, since changing them does not
+    require new kernels. The arguments are interpreted as in
+    :py:func:`mitsuba.render()`.
+
+    Returns a hexadecimal string (e.g. to name files that are associated with
+    the configuration).
+    """
+    import hashlib
+
+    if integrator is None:
+        integrator = scene.integrator()
+    if isinstance(sensor, int):
+        sensor = scene.sensors()[sensor]
+
+    entries = []
+
+    class SignatureTraversal(mi.TraversalCallback):
+        def __init__(self, name, visited):
+            mi.TraversalCallback.__init__(self)
+            self.name = name
+            self.visited = visited
+
+        def put_parameter(self, name, ptr, flags, cpptype=None):
+            entry = ('parameter', self.name + '.' + name,
+                     type(ptr).__name__, int(flags))
+            if dr.is_tensor_v(ptr):
+                entry += (tuple(ptr.shape),)
+            entries.append(entry)
+
+        def put_object(self, name, node, flags):
+            if node is None:
+                return
+            name = self.name + '.' + name
+            if node in self.visited:
+                # Shared objects are part of the structure, too
+                entries.append(('reference', name, self.visited[node]))
+                return
+            visit(node, name, self.visited)
+
+    def visit(node, name, visited):
+        visited[node] = name
+        entries.append(('object', name, node.class_().name()))
+        node.traverse(SignatureTraversal(name, visited))
+
+    visited = {}
+    for name, node in [('scene', scene), ('integrator', integrator),
+                       ('sensor', sensor)]:
+        if node in visited:
+            entries.append(('reference', name, visited[node]))
+        else:
+            visit(node, name, visited)
+
+    film = sensor.film()
+    if spp == 0:
+        spp = sensor.sampler().sample_count()
+    entries.append(('variant', mi.variant()))
+    entries.append(('film', tuple(film.crop_size()), tuple(film.crop_offset())))
+    entries.append(('spp', spp))
+
+    return hashlib.sha256(repr(entries).encode()).hexdigest()[:32]
+
+
+def prepare(scene: mi.Scene,
+            integrator: mi.Integrator = None,
+            sensor: Union[int, mi.Sensor] = 0,
+            spp: int = 0,
+            record_dir: str = None) -> dict:
+    """
+    Warm up the kernels needed to render ``scene`` in a JIT variant.
+
+    This function performs a single rendering pass with the given
+    configuration while recording the kernel history. Dr.Jit stores the
+    compiled kernels in its in-memory and persistent on-disk cache, so that
+    subsequent renders of the same configuration (also in other processes
+    sharing the cache) skip the costly compilation step. The arguments are
+    interpreted as in :py:func:`mitsuba.render()`.
+
+    Returns a dictionary with the :py:func:`scene_signature()` of the
+    configuration and a list of the kernels that were launched, including
+    whether each of them was already present in the kernel cache. When
+    ``record_dir`` is specified, the dictionary is additionally written to
+    the JSON file ``<record_dir>/<signature>.json``. A render service can thus
+    run this function once per configuration (e.g. when deploying a new scene)
+    and later check whether a record for the signature exists to decide if
+    the cache is warm.
+    """
+    import json, os
+
+    if not mi.variant().startswith(('cuda_', 'llvm_')):
+        raise Exception('prepare(): kernel warm-up requires a JIT variant!')
+
+    if integrator is None:
+        integrator = scene.integrator()
+    if isinstance(sensor, int):
+        sensor = scene.sensors()[sensor]
+
+    signature = scene_signature(scene, integrator, sensor, spp)
+
+    with dr.scoped_set_flag(dr.JitFlag.KernelHistory, True):
+        dr.kernel_history_clear()
+        with dr.suspend_grad():
+            image = integrator.render(scene, sensor=sensor, seed=0, spp=spp)
+            dr.eval(image)
+        dr.sync_thread()
+        history = dr.kernel_history()
+
+    keys = ['hash', 'type', 'size', 'cache_hit', 'cache_disk',
+            'codegen_time', 'backend_time', 'execution_time']
+    kernels = []
+    for entry in history:
+        kernels.append({ k: (str(entry[k]) if k in ('hash', 'type') else entry[k])
+                         for k in keys if k in entry })
+
+    record = {
+        'signature': signature,
+        'variant': mi.variant(),
+        'kernels': kernels
+    }
+
+    if record_dir is not None:
+        os.makedirs(record_dir, exist_ok=True)
+        with open(os.path.join(record_dir, signature + '.json'), 'w') as f:
+            json.dump(record, f, indent=2)
+
+    return record
+
+# ------------------------------------------------------------------------------
+#                              Batched rendering
+# ------------------------------------------------------------------------------
+
+def render_batch(scenes: Sequence[Union[mi.Scene, dict]],
+                 integrator: mi.Integrator = None,
+                 sensor: int = 0,
+                 seed: int = 0,
+                 spp: int = 0) -> mi.TensorXf:
+    """
+    Render a batch of small scenes that share the same plugin structure.
+
+    This function targets workloads like synthetic dataset generation, which
+    render a large number of small and independent scenes. Compared to loading
+    and rendering the scenes one after the other, it
+
+    - loads the next scene of the batch (when it is specified as a dictionary),
+      including the construction of its acceleration data structure, on a
+      background thread while the current scene is being rendered, and
+
+    - verifies that all scenes have the same :py:func:`scene_signature()`
+      (e.g. textures of the same resolution), so that the kernels generated
+      for the first scene are found in the kernel cache for all others.
+
+    Parameter ``scenes``:
+        List of scenes (``mi.Scene``) or scene dictionaries, which are loaded
+        using :py:func:`mitsuba.load_dict()`.
+
+    Parameter ``integrator`` (``mi.Integrator``):
+        Optional parameter to override the rendering technique used for all
+        scenes. By default, the integrator of every scene is used.
+
+    Parameter ``sensor`` (``int``):
+        Index of the sensor of every scene that is used for rendering.
+
+    Parameter ``seed`` (``int``):
+        Seed of the first scene. The scene at index ``i`` uses ``seed + i``.
+
+    Parameter ``spp`` (``int``):
+        Optional parameter to override the number of samples per pixel.
+
+    Returns a tensor of shape ``(N, height, width, channels)``, where ``N`` is
+    the number of scenes.
+    """
+    from concurrent.futures import ThreadPoolExecutor
+
+    if len(scenes) == 0:
+        raise Exception('render_batch(): the batch is empty!')
+
+    load_dict = mi.load_dict
+    env = mi.ThreadEnvironment()
+
+    def load(desc):
+        if isinstance(desc, mi.Scene):
+            return desc
+        with mi.ScopedSetThreadEnvironment(env):
+            scene = load_dict(desc)
+            # Hand over a fully built scene to the rendering thread
+            if dr.is_jit_v(mi.Float):
+                dr.sync_thread()
+            return scene
+
+    images, signature = [], None
+    with ThreadPoolExecutor(max_workers=1) as executor:
+        pending = executor.submit(load, scenes[0])
+        for i in range(len(scenes)):
+            scene = pending.result()
+            if i + 1 < len(scenes):
+                pending = executor.submit(load, scenes[i + 1])
+
+            integrator_i = integrator if integrator is not None else scene.integrator()
+            if integrator_i is None:
+                raise Exception('render_batch(): scene %i does not specify an '
+                                'integrator!' % i)
+            sensor_i = scene.sensors()[sensor]
+
+            signature_i = scene_signature(scene, integrator_i, sensor_i, spp)
+            if signature is None:
+                signature = signature_i
+            elif signature_i != signature:
+                raise Exception('render_batch(): scene %i does not have the '
+                                'same structure as the first scene!' % i)
+
+            with dr.suspend_grad():
+                images.append(integrator_i.render(scene, sensor=sensor_i,
+                                                  seed=seed + i, spp=spp))
+
+    # Stack the images along a new leading dimension
+    Tensor = type(images[0])
+    Float = type(images[0].array)
+    UInt32 = dr.uint32_array_t(Float)
+    size = dr.width(images[0].array)
+
+    result = dr.zeros(Float, size * len(images))
+    index = dr.arange(UInt32, size)
+    for i, image in enumerate(images):
+        dr.scatter(result, image.array, index + i * size)
+
+    return Tensor(result, shape=(len(images),) + tuple(images[0].shape))
+
+# ------------------------------------------------------------------------------
+#                          Interactive preview loop
+# ------------------------------------------------------------------------------
+
+class InteractiveSession:
+    """
+    Progressive rendering loop for interactive previews.
+
+    The session renders ``scene`` in short passes and accumulates them into a
+    running estimate, which a viewer can display after every call to
+    :py:meth:`step()`. Moving the camera with :py:meth:`set_camera()` (or
+    editing the scene and calling :py:meth:`restart()`) discards the estimate,
+    while the scene, its acceleration data structure and the generated
+    kernels are reused by the following passes.
+
+    When ``target_time`` is positive, the number of samples per pixel of a
+    pass is adapted (in powers of two, between 1 and ``max_spp_per_pass``) so
+    that a pass takes about this long, which bounds the latency between a
+    camera move and the next displayed image. Passes with different sample
+    counts are weighted accordingly in the estimate.
+
+    :py:meth:`preview()` only reads back a region of the estimate, optionally
+    downsampled on the device, so that the transfer to the host stays small
+    for large films.
+
+    Parameter ``scene`` (``mi.Scene``):
+        The scene to render.
+
+    Parameter ``integrator`` (``mi.Integrator``):
+        Optional parameter to override the integrator of the scene.
+
+    Parameter ``sensor`` (``int``, ``mi.Sensor``):
+        Sensor (or index of the sensor of the scene) used for rendering.
+
+    Parameter ``seed`` (``int``):
+        Seed of the first pass. Later passes increment it.
+
+    Parameter ``spp_per_pass`` (``int``):
+        Samples per pixel of the first pass after a restart.
+
+    Parameter ``max_spp_per_pass`` (``int``):
+        Upper bound on the samples per pixel of a pass.
+
+    Parameter ``target_time`` (``float``):
+        Desired duration of a pass in seconds (0: fixed sample count).
+    """
+
+    def __init__(self,
+                 scene: mi.Scene,
+                 integrator: mi.Integrator = None,
+                 sensor: Union[int, mi.Sensor] = 0,
+                 seed: int = 0,
+                 spp_per_pass: int = 1,
+                 max_spp_per_pass: int = 64,
+                 target_time: float = 0.05):
+        if integrator is None:
+            integrator = scene.integrator()
+        if isinstance(sensor, int):
+            sensor = scene.sensors()[sensor]
+        if spp_per_pass < 1 or max_spp_per_pass < spp_per_pass:
+            raise Exception('InteractiveSession(): invalid samples per pass!')
+
+        self.scene = scene
+        self.integrator = integrator
+        self.sensor = sensor
+        self.seed = seed
+        self.spp_per_pass = spp_per_pass
+        self.max_spp_per_pass = max_spp_per_pass
+        self.target_time = target_time
+        self.pass_time = 0.0
+
+        self._params = None
+        self.restart()
+
+    def restart(self) -> None:
+        """
+        Discard the current estimate, e.g. after editing the scene.
+        """
+        self._sum = None
+        self._spp = 0
+        self._passes = 0
+
+    def set_camera(self, to_world: mi.ScalarTransform4f) -> None:
+        """
+        Move the sensor to a new pose and restart the accumulation.
+        """
+        if self._params is None:
+            self._params = traverse(self.sensor)
+        self._params['to_world'] = to_world
+        self._params.update()
+        self.restart()
+
+    @property
+    def passes(self) -> int:
+        """Number of passes accumulated since the last restart"""
+        return self._passes
+
+    @property
+    def spp(self) -> int:
+        """Samples per pixel accumulated since the last restart"""
+        return self._spp
+
+    def step(self) -> int:
+        """
+        Render one pass, add it to the estimate and return the number of
+        passes accumulated since the last restart.
+        """
+        import time
+
+        spp = self.spp_per_pass
+        start = time.perf_counter()
+        with dr.suspend_grad():
+            image = self.integrator.render(self.scene, sensor=self.sensor,
+                                           seed=self.seed + self._passes,
+                                           spp=spp)
+            if self._sum is None:
+                self._sum = image * spp
+            else:
+                self._sum = dr.fma(image, spp, self._sum)
+            dr.eval(self._sum)
+        if dr.is_jit_v(mi.Float):
+            dr.sync_thread()
+        self.pass_time = time.perf_counter() - start
+
+        self._spp += spp
+        self._passes += 1
+
+        # Adapt the sample count of the next pass to the time budget
+        if self.target_time > 0:
+            if self.pass_time > self.target_time and spp > 1:
+                self.spp_per_pass = spp // 2
+            elif self.pass_time * 2 < self.target_time and \
+                    spp * 2 <= self.max_spp_per_pass:
+                self.spp_per_pass = spp * 2
+
+        return self._passes
+
+    def image(self) -> mi.TensorXf:
+        """
+        Return the current estimate (of shape ``(height, width, channels)``)
+        """
+        if self._sum is None:
+            raise Exception('InteractiveSession.image(): no pass was rendered '
+                            'since the last restart!')
+        return self._sum / self._spp
+
+    def preview(self,
+                scale: int = 1,
+                crop: Optional[Sequence[int]] = None) -> mi.Bitmap:
+        """
+        Read back a region of the current estimate.
+
+        Parameter ``scale`` (``int``):
+            Downsampling factor. Every output pixel is the average of a block
+            of ``scale x scale`` pixels, computed on the device.
+
+        Parameter ``crop`` (``Sequence[int]``):
+            Optional region ``(x, y, width, height)`` of the film to read back
+            (e.g. the part that is visible in the viewer). By default, the
+            entire film is returned.
+
+        Returns a bitmap with linear values, which can be converted for
+        display using :py:func:`convert_to_bitmap()`.
+        """
+        image = self.image()
+        height, width, channels = image.shape
+        x, y, w, h = crop if crop is not None else (0, 0, width, height)
+        if scale < 1 or x < 0 or y < 0 or w < scale or h < scale or \
+                x + w > width or y + h > height:
+            raise Exception('InteractiveSession.preview(): invalid region!')
+
+        Float = type(image.array)
+        UInt32 = dr.uint32_array_t(Float)
+        w, h = w // scale, h // scale
+
+        index = dr.arange(UInt32, w * h * channels)
+        channel = index % channels
+        pixel = index // channels
+        px = (pixel % w) * scale + x
+        py = (pixel // w) * scale + y
+
+        value = dr.zeros(Float, w * h * channels)
+        for dy in range(scale):
+            for dx in range(scale):
+                offset = ((py + dy) * width + px + dx) * channels + channel
+                value += dr.gather(Float, image.array, offset)
+        value *= 1.0 / (scale * scale)
+
+        Tensor = type(image)
+        return mi.Bitmap(Tensor(value, shape=(h, w, channels)))
+
 # ------------------------------------------------------------------------------
 
 def convert_to_bitmap(data, uint8_srgb=True):
@@ -0,0 +1,475 @@
+#include <mitsuba/render/bvh.h>
+#include <mitsuba/render/kdtree.h>
+#include <mitsuba/core/mmap.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/thread.h>
+#include <mitsuba/core/timer.h>
+#include <nanothread/nanothread.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/// Node of the intermediate binary BVH
+template <typename BoundingBox> struct BVHBuildNode {
+    /// Bounds of all primitives below this node
+    BoundingBox bbox;
+    /// Inner node: index of the left child (right child follows), leaf: first primitive
+    uint32_t offset = 0;
+    /// Number of primitives (0 for inner nodes)
+    uint32_t prim_count = 0;
+};
+
+MI_VARIANT struct ShapeBVH<Float, Spectrum>::BuildContext {
+    ThreadEnvironment env;
+    detail::ConcurrentVector<BVHBuildNode<ScalarBoundingBox3f>> nodes;
+    std::vector<ScalarBoundingBox3f> prim_bbox;
+    std::vector<Index> &indices;
+    /* Keep some statistics about the build process */
+    std::atomic<size_t> leaf_count {0};
+    std::atomic<size_t> max_depth {0};
+
+    BuildContext(std::vector<Index> &indices) : indices(indices) { }
+};
+
+MI_VARIANT ShapeBVH<Float, Spectrum>::ShapeBVH(const Properties &props) {
+    /* BVH construction: number of children per node (4 or 8) */
+    m_width = props.get<uint32_t>("bvh_width", 4);
+    if (m_width != 4 && m_width != 8)
+        Throw("ShapeBVH: \"bvh_width\" must be 4 or 8 (got %i)", m_width);
+
+    /* BVH construction: largest number of primitives per leaf */
+    m_max_leaf_size = props.get<uint32_t>("bvh_max_leaf_size", 4);
+    if (m_max_leaf_size == 0)
+        Throw("ShapeBVH: \"bvh_max_leaf_size\" must be greater than zero");
+
+    /* BVH construction: number of bins used by the binned SAH builder */
+    m_bin_count = props.get<uint32_t>("bvh_bins", 16);
+    if (m_bin_count < 2 || m_bin_count > MI_BVH_MAX_BINS)
+        Throw("ShapeBVH: \"bvh_bins\" must be in [2, %i]", MI_BVH_MAX_BINS);
+
+    /* BVH construction: Relative cost of a shape intersection and a node
+       traversal operation in the surface area heuristic. */
+    m_intersection_cost = props.get<ScalarFloat>("bvh_intersection_cost", 1.f);
+    m_traversal_cost    = props.get<ScalarFloat>("bvh_traversal_cost", 1.2f);
+
+    m_primitive_map.push_back(0);
+}
+
+MI_VARIANT void ShapeBVH<Float, Spectrum>::clear() {
+    m_shapes.clear();
+    m_instances.clear();
+    m_primitive_map.clear();
+    m_primitive_map.push_back(0);
+    m_bbox.reset();
+    m_nodes.reset();
+    m_indices.reset();
+    m_node_count = 0;
+    m_index_count = 0;
+}
+
+MI_VARIANT void ShapeBVH<Float, Spectrum>::add_shape(Shape *shape) {
+    Assert(!ready());
+    m_primitive_map.push_back(m_primitive_map.back() +
+                              shape->primitive_count());
+    m_shapes.push_back(shape);
+    m_bbox.expand(shape->bbox());
+
+    const Shape *shapegroup = shape->instanced_shapegroup();
+    if (shapegroup || !m_instances.empty()) {
+        m_instances.resize(m_shapes.size());
+        if (shapegroup) {
+            const ScalarTransform4f &to_object = shape->to_object_scalar();
+            InstanceRecord &rec = m_instances.back();
+            for (size_t i = 0; i < 3; ++i)
+                for (size_t j = 0; j < 4; ++j)
+                    rec.to_object[i][j] = to_object.matrix(i, j);
+            rec.shapegroup = shapegroup;
+        }
+    }
+}
+
+MI_VARIANT void ShapeBVH<Float, Spectrum>::build_recursive(BuildContext &ctx,
+                                                          Index node_index,
+                                                          Index begin,
+                                                          Index end,
+                                                          Size depth) const {
+    Index *indices = ctx.indices.data();
+    Size prim_count = end - begin;
+
+    ScalarBoundingBox3f bbox, centroid_bbox;
+    for (Index i = begin; i < end; ++i) {
+        const ScalarBoundingBox3f &prim_bbox = ctx.prim_bbox[indices[i]];
+        bbox.expand(prim_bbox);
+        centroid_bbox.expand(prim_bbox.center());
+    }
+
+    BVHBuildNode<ScalarBoundingBox3f> &node = ctx.nodes[node_index];
+    node.bbox = bbox;
+
+    size_t max_depth = ctx.max_depth.load();
+    while (depth > max_depth && !ctx.max_depth.compare_exchange_weak(max_depth, depth))
+        ;
+
+    auto make_leaf = [&]() {
+        node.offset = begin;
+        node.prim_count = prim_count;
+        ctx.leaf_count++;
+    };
+
+    if (prim_count == 1 || depth + 1 >= MI_BVH_MAXDEPTH) {
+        make_leaf();
+        return;
+    }
+
+    /* ==================================================================== */
+    /*                              Binning                                 */
+    /* ==================================================================== */
+
+    struct Bin {
+        ScalarBoundingBox3f bbox;
+        Size count = 0;
+    };
+
+    ScalarVector3f extents = centroid_bbox.extents();
+    ScalarFloat best_cost  = dr::Infinity<ScalarFloat>;
+    int best_axis          = -1;
+    Size best_split        = 0;
+
+    for (int axis = 0; axis < 3; ++axis) {
+        if (!(extents[axis] > 0.f))
+            continue;
+
+        Bin bins[MI_BVH_MAX_BINS];
+        ScalarFloat scale  = m_bin_count / extents[axis],
+                    offset = centroid_bbox.min[axis];
+
+        for (Index i = begin; i < end; ++i) {
+            const ScalarBoundingBox3f &prim_bbox = ctx.prim_bbox[indices[i]];
+            Size bin = std::min((Size) ((prim_bbox.center()[axis] - offset) * scale),
+                                m_bin_count - 1);
+            bins[bin].bbox.expand(prim_bbox);
+            bins[bin].count++;
+        }
+
+        /* Sweep from the right to compute suffix areas, then from the left */
+        ScalarFloat right_area[MI_BVH_MAX_BINS];
+        Size right_count[MI_BVH_MAX_BINS];
+        ScalarBoundingBox3f acc;
+        Size count = 0;
+        for (Size i = m_bin_count - 1; i > 0; --i) {
+            acc.expand(bins[i].bbox);
+            count += bins[i].count;
+            right_area[i]  = count > 0 ? acc.surface_area() : 0.f;
+            right_count[i] = count;
+        }
+
+        acc.reset();
+        count = 0;
+        for (Size i = 1; i < m_bin_count; ++i) {
+            acc.expand(bins[i - 1].bbox);
+            count += bins[i - 1].count;
+            if (count == 0 || right_count[i] == 0)
+                continue;
+
+            ScalarFloat cost = acc.surface_area() * count +
+                               right_area[i] * right_count[i];
+            if (cost < best_cost) {
+                best_cost  = cost;
+                best_axis  = axis;
+                best_split = i;
+            }
+        }
+    }
+
+    /* Compare against the cost of creating a leaf node */
+    ScalarFloat leaf_cost = m_intersection_cost * prim_count;
+    if (best_axis >= 0) {
+        ScalarFloat area = bbox.surface_area();
+        best_cost = area > 0.f ? m_traversal_cost + m_intersection_cost * best_cost / area
+                               : leaf_cost;
+        if (best_cost >= leaf_cost && prim_count <= m_max_leaf_size) {
+            make_leaf();
+            return;
+        }
+    }
+
+    /* ==================================================================== */
+    /*                            Partitioning                              */
+    /* ==================================================================== */
+
+    Index mid = begin;
+    if (best_axis >= 0) {
+        ScalarFloat scale  = m_bin_count / extents[best_axis],
+                    offset = centroid_bbox.min[best_axis];
+        mid = (Index) (std::partition(
+            indices + begin, indices + end, [&](Index prim) {
+                Size bin = std::min(
+                    (Size) ((ctx.prim_bbox[prim].center()[best_axis] - offset) * scale),
+                    m_bin_count - 1);
+                return bin < best_split;
+            }) - indices);
+    }
+
+    if (mid == begin || mid == end) {
+        /* All centroids coincide: fall back to an object median split */
+        if (prim_count <= m_max_leaf_size) {
+            make_leaf();
+            return;
+        }
+        mid = begin + prim_count / 2;
+    }
+
+    /* ==================================================================== */
+    /*                              Recursion                               */
+    /* ==================================================================== */
+
+    Index children = ctx.nodes.grow_by(2);
+    node.offset = children;
+    node.prim_count = 0;
+
+    if (prim_count > MI_BVH_PARALLEL_THRESHOLD) {
+        Task *left_task = dr::do_async([&, children, begin, mid, depth]() {
+            ScopedSetThreadEnvironment env(ctx.env);
+            build_recursive(ctx, children, begin, mid, depth + 1);
+        });
+        build_recursive(ctx, children + 1, mid, end, depth + 1);
+        task_wait_and_release(left_task);
+    } else {
+        build_recursive(ctx, children, begin, mid, depth + 1);
+        build_recursive(ctx, children + 1, mid, end, depth + 1);
+    }
+}
+
+MI_VARIANT template <size_t Width>
+typename ShapeBVH<Float, Spectrum>::Index
+ShapeBVH<Float, Spectrum>::emit_node(const BuildContext &ctx, Index bin_node,
+                                     std::vector<BVHNode<Width>> &nodes) const {
+    auto &build_nodes = const_cast<BuildContext &>(ctx).nodes;
+
+    Index result = (Index) nodes.size();
+    nodes.emplace_back();
+
+    /* Gather up to 'Width' children by repeatedly opening the inner child
+       with the largest surface area */
+    Index children[Width];
+    size_t child_count = 0;
+
+    const BVHBuildNode<ScalarBoundingBox3f> &root = build_nodes[bin_node];
+    if (root.prim_count > 0) {
+        children[child_count++] = bin_node;
+    } else {
+        children[child_count++] = root.offset;
+        children[child_count++] = root.offset + 1;
+
+        while (child_count < Width) {
+            int best = -1;
+            ScalarFloat best_area = -1.f;
+            for (size_t i = 0; i < child_count; ++i) {
+                const auto &c = build_nodes[children[i]];
+                if (c.prim_count == 0 && c.bbox.surface_area() > best_area) {
+                    best_area = c.bbox.surface_area();
+                    best = (int) i;
+                }
+            }
+            if (best < 0)
+                break;
+
+            Index offset = build_nodes[children[best]].offset;
+            children[best] = offset;
+            children[child_count++] = offset + 1;
+        }
+    }
+
+    /* Set up the quantization grid */
+    BVHNode<Width> node;
+    memset(&node, 0, sizeof(BVHNode<Width>));
+
+    const ScalarBoundingBox3f &bbox = root.bbox;
+    for (size_t axis = 0; axis < 3; ++axis) {
+        int exponent;
+        std::frexp((bbox.max[axis] - bbox.min[axis]) / 255.f, &exponent);
+        ScalarFloat scale = std::ldexp(ScalarFloat(1), exponent);
+        if (bbox.min[axis] + 255 * scale < bbox.max[axis])
+            scale *= 2;
+        node.origin[axis] = bbox.min[axis];
+        node.scale[axis]  = scale;
+    }
+
+    for (size_t i = 0; i < child_count; ++i) {
+        const BVHBuildNode<ScalarBoundingBox3f> child = build_nodes[children[i]];
+
+        /* Conservatively quantize the child bounds */
+        for (size_t axis = 0; axis < 3; ++axis) {
+            ScalarFloat origin = node.origin[axis],
+                        scale  = node.scale[axis];
+
+            int lo = (int) std::floor((child.bbox.min[axis] - origin) / scale),
+                hi = (int) std::ceil((child.bbox.max[axis] - origin) / scale);
+            lo = std::min(std::max(lo, 0), 255);
+            hi = std::min(std::max(hi, 0), 255);
+
+            while (lo > 0 && origin + lo * scale > child.bbox.min[axis])
+                --lo;
+            while (hi < 255 && origin + hi * scale < child.bbox.max[axis])
+                ++hi;
+
+            node.bounds[axis][i]     = (uint8_t) lo;
+            node.bounds[axis + 3][i] = (uint8_t) hi;
+        }
+
+        node.child_mask |= 1u << i;
+        if (child.prim_count > 0) {
+            node.child[i] = child.offset;
+            node.prim_count[i] = child.prim_count;
+        } else {
+            node.child[i] = emit_node<Width>(ctx, children[i], nodes);
+            node.prim_count[i] = 0;
+        }
+    }
+
+    /* 'nodes' may have been reallocated during the recursion */
+    nodes[result] = node;
+
+    return result;
+}
+
+MI_VARIANT template <size_t Width>
+void ShapeBVH<Float, Spectrum>::collapse(const BuildContext &ctx) {
+    std::vector<BVHNode<Width>> nodes;
+    nodes.reserve((Size) ctx.nodes.size() / 2 + 1);
+
+    if (primitive_count() > 0)
+        emit_node<Width>(ctx, 0, nodes);
+    else
+        nodes.emplace_back(); // Single node without any children
+
+    m_node_count = (Size) nodes.size();
+    m_node_size  = sizeof(BVHNode<Width>);
+    m_nodes.reset(new uint8_t[m_node_count * m_node_size]);
+    memcpy(m_nodes.get(), nodes.data(), m_node_count * m_node_size);
+}
+
+MI_VARIANT void ShapeBVH<Float, Spectrum>::build() {
+    if (ready())
+        Throw("The BVH has already been built!");
+
+    Timer timer;
+    Size prim_count = primitive_count();
+    Log(Info, "Building a %i-wide SAH BVH (%i primitives) ..", m_width,
+        prim_count);
+
+    std::vector<Index> indices(prim_count);
+    BuildContext ctx(indices);
+    ctx.prim_bbox.resize(prim_count);
+
+    /* Precompute primitive bounding boxes */
+    dr::parallel_for(
+        dr::blocked_range<Size>(0u, prim_count, MI_KD_GRAIN_SIZE),
+        [&](const dr::blocked_range<Size> &range) {
+            for (Size i = range.begin(); i != range.end(); ++i) {
+                indices[i] = i;
+                ctx.prim_bbox[i] = bbox(i);
+            }
+        }
+    );
+
+    ctx.nodes.reserve(2 * std::max(prim_count / m_max_leaf_size, 1u));
+    ctx.nodes.grow_by(1);
+
+    if (prim_count == 0) {
+        Log(Warn, "BVH contains no geometry!");
+        m_bbox = ScalarBoundingBox3f(ScalarPoint3f(0.f));
+    } else {
+        build_recursive(ctx, 0, 0, prim_count, 0);
+    }
+
+    Size bin_node_count = (Size) ctx.nodes.size(); // lower 32 bits: size
+
+    if (m_width == 8)
+        collapse<8>(ctx);
+    else
+        collapse<4>(ctx);
+
+    m_index_count = prim_count;
+    m_indices.reset(new Index[m_index_count]);
+    memcpy(m_indices.get(), indices.data(), m_index_count * sizeof(Index));
+
+    ctx.nodes.release();
+
+    Log(Debug, "BVH statistics:");
+    Log(Debug, "   Binary build nodes  : %i", bin_node_count);
+    Log(Debug, "   Wide nodes          : %i (%s)", m_node_count,
+        util::mem_string(m_node_count * m_node_size));
+    Log(Debug, "   Leaf nodes          : %i", ctx.leaf_count.load());
+    Log(Debug, "   Binary tree depth   : %i", ctx.max_depth.load());
+
+    Log(Info, "Finished. (%s of storage, took %s)",
+        util::mem_string(m_index_count * sizeof(Index) +
+                         m_node_count * m_node_size),
+        util::time_string((float) timer.value())
+    );
+}
+
+MI_VARIANT bool ShapeBVH<Float, Spectrum>::read_cache(const fs::path &filename,
+                                                      uint64_t key) {
+    detail::AccelCacheHeader header;
+    header.key = key;
+    header.node_size = (uint32_t) (m_width == 8 ? sizeof(BVHNode<8>)
+                                                : sizeof(BVHNode<4>));
+
+    const void *node_data, *index_data;
+    ref<MemoryMappedFile> mmap =
+        detail::accel_cache_read(filename, header, node_data, index_data);
+    if (!mmap || header.node_count == 0)
+        return false;
+
+    m_node_count  = header.node_count;
+    m_index_count = header.index_count;
+    m_node_size   = header.node_size;
+    m_nodes.reset(new uint8_t[m_node_count * m_node_size]);
+    m_indices.reset(new Index[m_index_count]);
+    memcpy(m_nodes.get(), node_data, m_node_count * m_node_size);
+    memcpy(m_indices.get(), index_data, m_index_count * sizeof(Index));
+
+    for (size_t i = 0; i < 3; ++i) {
+        m_bbox.min[i] = (ScalarFloat) header.bbox_min[i];
+        m_bbox.max[i] = (ScalarFloat) header.bbox_max[i];
+    }
+
+    Log(Info, "Loaded a %i-wide SAH BVH (%i primitives, %s) from \"%s\"",
+        m_width, primitive_count(),
+        util::mem_string(m_index_count * sizeof(Index) +
+                         m_node_count * m_node_size),
+        filename.string());
+    return true;
+}
+
+MI_VARIANT void ShapeBVH<Float, Spectrum>::write_cache(const fs::path &filename,
+                                                       uint64_t key) const {
+    Assert(ready());
+    detail::AccelCacheHeader header;
+    header.key         = key;
+    header.node_size   = (uint32_t) m_node_size;
+    header.node_count  = m_node_count;
+    header.index_count = m_index_count;
+    for (size_t i = 0; i < 3; ++i) {
+        header.bbox_min[i] = (double) m_bbox.min[i];
+        header.bbox_max[i] = (double) m_bbox.max[i];
+    }
+    detail::accel_cache_write(filename, header, m_nodes.get(), m_indices.get());
+}
+
+MI_VARIANT std::string ShapeBVH<Float, Spectrum>::to_string() const {
+    std::ostringstream oss;
+    oss << "ShapeBVH[" << std::endl
+        << "  width = " << m_width << "," << std::endl
+        << "  shapes = [" << std::endl;
+    for (auto shape : m_shapes)
+        oss << "    " << string::indent(shape, 4)
+            << "," << std::endl;
+    oss << "  ]" << std::endl << "]";
+    return oss.str();
+}
+
+MI_IMPLEMENT_CLASS_VARIANT(ShapeBVH, Object)
+MI_INSTANTIATE_CLASS(ShapeBVH)
+NAMESPACE_END(mitsuba)
@@ -0,0 +1,1793 @@
+#include <mitsuba/render/distributed.h>
+#include <mitsuba/core/logger.h>
+#include <mitsuba/core/mstream.h>
+#include <mitsuba/core/progress.h>
+#include <mitsuba/core/random.h>
+#include <mitsuba/core/sstream.h>
+#include <mitsuba/core/string.h>
+#include <mitsuba/core/thread.h>
+#include <mitsuba/core/timer.h>
+#include <mitsuba/core/util.h>
+#include <mitsuba/core/xml.h>
+#include <mitsuba/core/zstream.h>
+#include <mitsuba/render/film.h>
+#include <mitsuba/render/imageblock.h>
+#include <mitsuba/render/integrator.h>
+#include <mitsuba/render/scene.h>
+#include <mitsuba/render/sensor.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <thread>
+
+NAMESPACE_BEGIN(mitsuba)
+
+NAMESPACE_BEGIN(detail)
+
+/// Identifies the messages exchanged between coordinator and workers
+enum class RenderMessage : uint32_t {
+    /// Worker -> coordinator: variant name of the worker
+    Hello = 0x4d495748,
+    /// Coordinator -> worker: tile to be rendered
+    Tile,
+    /// Worker -> coordinator: tile identification followed by an ImageBlock
+    Result,
+    /// Coordinator -> worker: no more work, disconnect. Client -> server:
+    /// terminate the server once the pending requests are completed
+    Shutdown,
+    /// Client -> server: load a scene (identifier, filename, definitions)
+    LoadScene,
+    /// Client -> server: release a scene (identifier)
+    RemoveScene,
+    /// Client -> server: render a scene (identifier, sensor, spp, seed,
+    /// parameter overrides)
+    RenderJob,
+    /// Server -> client: request completed, followed by an optional image
+    Done,
+    /// Server -> client: request failed, followed by an error message
+    Error
+};
+
+/**
+ * Send a message consisting of a type tag and a payload, which is compressed
+ * using \ref ZStream. The compressed size is transmitted up front, since the
+ * receiver must not decompress past the end of the message.
+ */
+static void send_message(SocketStream *stream, RenderMessage type,
+                         const MemoryStream *payload = nullptr) {
+    uint64_t raw_size = payload ? (uint64_t) payload->size() : 0;
+    ref<MemoryStream> compressed = new MemoryStream();
+
+    if (raw_size > 0) {
+        ref<ZStream> zstream = new ZStream(compressed);
+        zstream->write(payload->raw_buffer(), raw_size);
+        zstream->close();
+    }
+
+    stream->write((uint32_t) type);
+    stream->write(raw_size);
+    stream->write((uint64_t) compressed->size());
+    stream->write(compressed->raw_buffer(), compressed->size());
+}
+
+/// Receive a message sent by \ref send_message() and decompress its payload
+static RenderMessage receive_message(SocketStream *stream,
+                                     ref<MemoryStream> &payload) {
+    uint32_t type;
+    uint64_t raw_size, compressed_size;
+    stream->read(type);
+    stream->read(raw_size);
+    stream->read(compressed_size);
+
+    std::unique_ptr<uint8_t[]> buffer(new uint8_t[compressed_size + 1]);
+    stream->read(buffer.get(), compressed_size);
+
+    payload = new MemoryStream(std::max((size_t) raw_size, (size_t) 1));
+    payload->set_byte_order(Stream::ENetworkByteOrder);
+
+    if (raw_size > 0) {
+        ref<MemoryStream> compressed =
+            new MemoryStream(buffer.get(), (size_t) compressed_size);
+        ref<ZStream> zstream = new ZStream(compressed);
+
+        std::unique_ptr<uint8_t[]> raw(new uint8_t[raw_size]);
+        zstream->read(raw.get(), raw_size);
+        payload->write(raw.get(), raw_size);
+        payload->seek(0);
+    }
+
+    return (RenderMessage) type;
+}
+
+/// Create an empty message payload
+static ref<MemoryStream> new_payload() {
+    ref<MemoryStream> payload = new MemoryStream();
+    payload->set_byte_order(Stream::ENetworkByteOrder);
+    return payload;
+}
+
+/// Serialize a list of (name, value) pairs
+static void write_parameters(Stream *stream, const RenderParameterList &list) {
+    stream->write((uint32_t) list.size());
+    for (const auto &[name, value] : list) {
+        stream->write(name);
+        stream->write(value);
+    }
+}
+
+/// Deserialize a list of (name, value) pairs
+static RenderParameterList read_parameters(Stream *stream) {
+    uint32_t size;
+    stream->read(size);
+    RenderParameterList list(size);
+    for (auto &[name, value] : list) {
+        stream->read(name);
+        stream->read(value);
+    }
+    return list;
+}
+
+/**
+ * Traversal callback that locates a scene parameter by its name, which
+ * follows the naming convention of mi.traverse(). Besides the parameter
+ * itself, it records the chain of objects leading to it.
+ */
+struct ParameterLookup : public TraversalCallback {
+    ParameterLookup(const std::string &key) : key(key) { }
+
+    void put_object(const std::string &name, Object *obj, uint32_t) override {
+        std::string path = prefix.empty() ? name : prefix + "." + name;
+        if (ptr || !obj || !string::starts_with(key, path + "."))
+            return;
+
+        std::string prev = prefix;
+        prefix = path;
+        objects.emplace_back(obj, name);
+        obj->traverse(this);
+        if (!ptr)
+            objects.pop_back();
+        prefix = prev;
+    }
+
+    void put_parameter_impl(const std::string &name, void *p, uint32_t,
+                            const std::type_info &t) override {
+        if (!ptr && (prefix.empty() ? name : prefix + "." + name) == key) {
+            ptr = p;
+            type = &t;
+            param = name;
+        }
+    }
+
+    std::string key, prefix, param;
+    void *ptr = nullptr;
+    const std::type_info *type = nullptr;
+    /// Objects along the path to the parameter and the names they were given
+    std::vector<std::pair<ref<Object>, std::string>> objects;
+};
+
+/**
+ * Applies parameter overrides to a scene and notifies the affected objects
+ * (and their ancestors) using \ref Object::parameters_changed(). The
+ * previous values are restored by \ref restore().
+ */
+template <typename Float, typename Spectrum>
+class ParameterOverrides {
+public:
+    MI_IMPORT_TYPES(Scene)
+
+    ParameterOverrides(Scene *scene) : m_scene(scene) { }
+
+    void set(const std::string &key, const std::string &value) {
+        ParameterLookup lookup(key);
+        m_scene->traverse(&lookup);
+        if (!lookup.ptr)
+            Throw("unknown scene parameter \"%s\"", key);
+
+        std::vector<ScalarFloat> v;
+        for (const std::string &token : string::tokenize(value, ", \t\n"))
+            v.push_back(string::stof<ScalarFloat>(token));
+
+        std::function<void()> undo;
+        bool found =
+            assign<Float>(lookup, v, undo) ||
+            assign<ScalarFloat>(lookup, v, undo) ||
+            assign<Color3f>(lookup, v, undo) ||
+            assign<UnpolarizedSpectrum>(lookup, v, undo) ||
+            assign<Vector3f>(lookup, v, undo) ||
+            assign<Point3f>(lookup, v, undo) ||
+            assign<Transform4f>(lookup, v, undo) ||
+            assign<ScalarTransform4f>(lookup, v, undo) ||
+            assign<int>(lookup, v, undo) ||
+            assign<uint32_t>(lookup, v, undo) ||
+            assign<bool>(lookup, v, undo);
+        if (!found)
+            Throw("scene parameter \"%s\" has an unsupported type (%s)", key,
+                  lookup.type->name());
+
+        m_undo.push_back(std::move(undo));
+        m_changed.push_back(std::move(lookup.objects));
+        m_changed_params.push_back(lookup.param);
+        notify(m_changed.size() - 1);
+    }
+
+    void restore() {
+        for (size_t i = m_undo.size(); i-- > 0; ) {
+            m_undo[i]();
+            notify(i);
+        }
+        m_undo.clear();
+        m_changed.clear();
+        m_changed_params.clear();
+    }
+
+protected:
+    /// Assign the value if the parameter has type \c T
+    template <typename T>
+    bool assign(const ParameterLookup &lookup, const std::vector<ScalarFloat> &v,
+                std::function<void()> &undo) {
+        if (*lookup.type != typeid(T))
+            return false;
+
+        T value;
+        if constexpr (std::is_same_v<T, Transform4f> ||
+                      std::is_same_v<T, ScalarTransform4f>) {
+            check_size(lookup, v, 16);
+            ScalarMatrix4f m;
+            for (size_t i = 0; i < 4; ++i)
+                for (size_t j = 0; j < 4; ++j)
+                    m(i, j) = v[4 * i + j];
+            value = T(typename T::Matrix(m));
+        } else if constexpr (dr::is_static_array_v<T>) {
+            check_size(lookup, v, dr::array_size_v<T>);
+            for (size_t i = 0; i < dr::array_size_v<T>; ++i)
+                value[i] = v[i];
+        } else {
+            check_size(lookup, v, 1);
+            value = (T) v[0];
+        }
+
+        // Avoid recompiling the kernels for every new value
+        if constexpr (dr::is_jit_v<Float> && !std::is_arithmetic_v<T> &&
+                      !std::is_same_v<T, ScalarTransform4f>)
+            dr::make_opaque(value);
+
+        T &target = *(T *) lookup.ptr;
+        T prev = target;
+        target = value;
+        undo = [&target, prev]() { target = prev; };
+        return true;
+    }
+
+    static void check_size(const ParameterLookup &lookup,
+                           const std::vector<ScalarFloat> &v, size_t size) {
+        if (v.size() != size)
+            Throw("scene parameter \"%s\" expects %u value%s, got %u",
+                  lookup.key, size, size == 1 ? "" : "s", v.size());
+    }
+
+    /// Inform the owner of the i-th changed parameter and its ancestors
+    void notify(size_t i) {
+        std::string key = m_changed_params[i];
+        const auto &objects = m_changed[i];
+        for (auto it = objects.rbegin(); it != objects.rend(); ++it) {
+            it->first->parameters_changed({ key });
+            key = it->second;
+        }
+        m_scene->parameters_changed({ key });
+    }
+
+private:
+    ref<Scene> m_scene;
+    std::vector<std::function<void()>> m_undo;
+    std::vector<std::vector<std::pair<ref<Object>, std::string>>> m_changed;
+    std::vector<std::string> m_changed_params;
+};
+
+NAMESPACE_END(detail)
+
+// =============================================================
+//! RenderCoordinator
+// =============================================================
+
+template <typename Float, typename Spectrum>
+struct RenderCoordinatorPrivate {
+    MI_IMPORT_CORE_TYPES()
+
+    struct Tile {
+        ScalarPoint2u offset;
+        ScalarVector2u size;
+        /// Number of times that this tile was handed out
+        uint32_t issues = 0;
+        /// Time (in ms) at which the tile was last handed out
+        size_t issue_time = 0;
+        bool done = false;
+    };
+
+    struct Result {
+        uint32_t tile;
+        ref<MemoryStream> payload;
+    };
+
+    // Configuration
+    ref<ServerSocket> server;
+    uint32_t tile_size;
+    float reissue_factor;
+    uint32_t max_issues;
+
+    // Connection management
+    std::thread accept_thread;
+    std::vector<std::thread> threads;
+    ThreadEnvironment env;
+    size_t workers = 0;
+    bool stop = false;
+
+    // State of the current render job
+    mutable std::mutex mutex;
+    std::condition_variable cv;
+    bool active = false;
+    uint32_t job = 0, sensor_index = 0, seed = 0, spp = 0;
+    ScalarVector2u film_size;
+    std::vector<Tile> tiles;
+    std::deque<uint32_t> queue;
+    std::vector<size_t> durations;
+    std::deque<Result> results;
+    size_t remaining = 0, reissued = 0;
+    Timer timer;
+
+    /**
+     * Pick the next tile for an idle worker. Must be called with the mutex
+     * held. Returns -1 if there is currently nothing to do.
+     */
+    int next_tile() {
+        if (!active)
+            return -1;
+
+        while (!queue.empty()) {
+            uint32_t index = queue.front();
+            queue.pop_front();
+            if (!tiles[index].done)
+                return (int) index;
+        }
+
+        if (durations.empty())
+            return -1;
+
+        // Re-issue the oldest straggler that is in flight for too long
+        std::vector<size_t> sorted(durations);
+        std::nth_element(sorted.begin(), sorted.begin() + sorted.size() / 2,
+                         sorted.end());
+        size_t median = sorted[sorted.size() / 2],
+               now    = timer.value(),
+               limit  = std::max((size_t) (reissue_factor * median), (size_t) 1);
+
+        int best = -1;
+        for (uint32_t i = 0; i < (uint32_t) tiles.size(); ++i) {
+            const Tile &t = tiles[i];
+            if (t.done || t.issues == 0 || t.issues >= max_issues ||
+                now - t.issue_time < limit)
+                continue;
+            if (best < 0 || t.issue_time < tiles[best].issue_time)
+                best = (int) i;
+        }
+
+        if (best >= 0)
+            reissued++;
+
+        return best;
+    }
+};
+
+MI_VARIANT
+RenderCoordinator<Float, Spectrum>::RenderCoordinator(uint16_t port,
+                                                      uint32_t tile_size,
+                                                      float reissue_factor,
+                                                      uint32_t max_issues)
+    : d(new RenderCoordinatorPrivate<Float, Spectrum>()) {
+    if (tile_size == 0)
+        Throw("RenderCoordinator: the tile size must be positive!");
+    if (reissue_factor <= 0.f)
+        Throw("RenderCoordinator: the reissue factor must be positive!");
+
+    d->server = new ServerSocket(port);
+    d->tile_size = tile_size;
+    d->reissue_factor = reissue_factor;
+    d->max_issues = std::max(max_issues, 1u);
+
+    Log(Info, "Waiting for render workers on port %i ..", d->server->port());
+
+    d->accept_thread = std::thread([this]() {
+        ScopedSetThreadEnvironment set_env(d->env);
+        while (true) {
+            ref<SocketStream> stream;
+            try {
+                stream = d->server->accept();
+            } catch (const std::exception &e) {
+                Log(Warn, "RenderCoordinator: %s", e.what());
+                continue;
+            }
+            if (!stream)
+                break;
+
+            std::lock_guard<std::mutex> guard(d->mutex);
+            if (d->stop)
+                break;
+            d->threads.emplace_back(&RenderCoordinator::serve, this, stream);
+        }
+    });
+}
+
+MI_VARIANT RenderCoordinator<Float, Spectrum>::~RenderCoordinator() {
+    shutdown();
+}
+
+MI_VARIANT void RenderCoordinator<Float, Spectrum>::shutdown() {
+    /* critical section */ {
+        std::lock_guard<std::mutex> guard(d->mutex);
+        if (d->stop)
+            return;
+        d->stop = true;
+        d->cv.notify_all();
+    }
+
+    d->server->close();
+    if (d->accept_thread.joinable())
+        d->accept_thread.join();
+
+    for (auto &thread : d->threads)
+        thread.join();
+    d->threads.clear();
+}
+
+MI_VARIANT void
+RenderCoordinator<Float, Spectrum>::serve(ref<SocketStream> stream) {
+    ScopedSetThreadEnvironment set_env(d->env);
+    using Tile = typename RenderCoordinatorPrivate<Float, Spectrum>::Tile;
+
+    try {
+        ref<MemoryStream> payload;
+        if (detail::receive_message(stream, payload) != detail::RenderMessage::Hello)
+            Throw("unexpected handshake");
+        std::string variant;
+        payload->read(variant);
+        if (variant != detail::get_variant<Float, Spectrum>())
+            Throw("variant mismatch (worker uses \"%s\", expected \"%s\")",
+                  variant, detail::get_variant<Float, Spectrum>());
+    } catch (const std::exception &e) {
+        Log(Warn, "Rejecting render worker %s: %s", stream->peer(), e.what());
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(d->mutex);
+    d->workers++;
+    Log(Info, "Render worker %s connected.", stream->peer());
+
+    int tile = -1;
+    uint32_t job = 0;
+
+    try {
+        while (true) {
+            tile = -1;
+            while (!d->stop && (tile = d->next_tile()) < 0)
+                d->cv.wait_for(lock, std::chrono::milliseconds(50));
+            if (tile < 0)
+                break;
+
+            Tile &t = d->tiles[tile];
+            t.issues++;
+            t.issue_time = d->timer.value();
+            job = d->job;
+
+            ref<MemoryStream> message = detail::new_payload();
+            message->write(job);
+            message->write((uint32_t) tile);
+            message->write(d->sensor_index);
+            message->write(d->film_size.x());
+            message->write(d->film_size.y());
+            message->write(t.offset.x());
+            message->write(t.offset.y());
+            message->write(t.size.x());
+            message->write(t.size.y());
+            message->write(d->seed * (uint32_t) d->tiles.size() + (uint32_t) tile);
+            message->write(d->spp);
+            size_t start = t.issue_time;
+
+            lock.unlock();
+            detail::send_message(stream, detail::RenderMessage::Tile, message);
+
+            ref<MemoryStream> payload;
+            if (detail::receive_message(stream, payload) != detail::RenderMessage::Result)
+                Throw("expected a tile result");
+            uint32_t result_job, result_tile;
+            payload->read(result_job);
+            payload->read(result_tile);
+            if (result_job != job || result_tile != (uint32_t) tile)
+                Throw("received a result for the wrong tile");
+            lock.lock();
+
+            Tile &t2 = d->tiles[tile];
+            if (d->active && d->job == job && !t2.done) {
+                t2.done = true;
+                d->durations.push_back(d->timer.value() - start);
+                d->results.push_back({ (uint32_t) tile, payload });
+                d->remaining--;
+                d->cv.notify_all();
+            }
+            tile = -1;
+        }
+
+        lock.unlock();
+        detail::send_message(stream, detail::RenderMessage::Shutdown);
+        lock.lock();
+    } catch (const std::exception &e) {
+        if (!lock.owns_lock())
+            lock.lock();
+        Log(Warn, "Lost render worker %s: %s", stream->peer(), e.what());
+
+        // Give the tile back, unless another worker finished it already
+        if (tile >= 0 && d->active && d->job == job && !d->tiles[tile].done)
+            d->queue.push_front((uint32_t) tile);
+        d->cv.notify_all();
+    }
+
+    d->workers--;
+}
+
+MI_VARIANT typename RenderCoordinator<Float, Spectrum>::TensorXf
+RenderCoordinator<Float, Spectrum>::render(Scene *scene, uint32_t sensor_index,
+                                           uint32_t seed, uint32_t spp,
+                                           bool develop) {
+    if (sensor_index >= scene->sensors().size())
+        Throw("RenderCoordinator::render(): sensor index %i is out of bounds!",
+              sensor_index);
+    if (!scene->integrator())
+        Throw("RenderCoordinator::render(): the scene has no integrator!");
+
+    Sensor *sensor = scene->sensors()[sensor_index].get();
+    ref<Film> film = sensor->film();
+    film->prepare(scene->integrator()->aov_names());
+
+    ScalarVector2u crop_size = film->crop_size();
+    ScalarPoint2u crop_offset = film->crop_offset();
+    uint32_t ts = d->tile_size;
+    ScalarVector2u tile_count = (crop_size + ts - 1) / ts;
+
+    std::unique_lock<std::mutex> lock(d->mutex);
+    d->tiles.clear();
+    d->queue.clear();
+    d->durations.clear();
+    d->results.clear();
+
+    for (uint32_t y = 0; y < tile_count.y(); ++y) {
+        for (uint32_t x = 0; x < tile_count.x(); ++x) {
+            typename RenderCoordinatorPrivate<Float, Spectrum>::Tile tile;
+            ScalarPoint2u rel(x * ts, y * ts);
+            tile.offset = crop_offset + rel;
+            tile.size = dr::minimum(ScalarVector2u(ts), crop_size - rel);
+            d->queue.push_back((uint32_t) d->tiles.size());
+            d->tiles.push_back(tile);
+        }
+    }
+
+    d->job++;
+    d->sensor_index = sensor_index;
+    d->seed = seed;
+    d->spp = spp;
+    d->film_size = film->size();
+    d->remaining = d->tiles.size();
+    d->reissued = 0;
+    d->active = true;
+    d->timer.reset();
+    d->cv.notify_all();
+
+    size_t total = d->tiles.size(), merged = 0;
+    Log(Info, "Distributing %i tiles to %i worker%s ..", total, d->workers,
+        d->workers == 1 ? "" : "s");
+
+    ref<ProgressReporter> progress;
+    Logger *logger = mitsuba::Thread::thread()->logger();
+    if (logger && Info >= logger->log_level())
+        progress = new ProgressReporter("Rendering");
+
+    Timer timer;
+    while (merged < total) {
+        if (d->stop) {
+            d->active = false;
+            Throw("RenderCoordinator::render(): shut down before completion!");
+        }
+
+        if (d->results.empty()) {
+            d->cv.wait_for(lock, std::chrono::milliseconds(50));
+            continue;
+        }
+
+        auto result = d->results.front();
+        d->results.pop_front();
+        lock.unlock();
+
+        // Merge on the calling thread, which owns the JIT state of the film
+        ref<ImageBlock> block = new ImageBlock(result.payload.get());
+        film->put_block(block);
+        merged++;
+
+        if (progress)
+            progress->update(merged / (ScalarFloat) total);
+
+        lock.lock();
+    }
+
+    d->active = false;
+    size_t reissued = d->reissued;
+    lock.unlock();
+
+    Log(Info, "Distributed rendering finished. (took %s, %i tile%s re-issued)",
+        util::time_string((float) timer.value(), true), reissued,
+        reissued == 1 ? "" : "s");
+
+    if (develop)
+        return film->develop();
+    else
+        return { };
+}
+
+MI_VARIANT uint16_t RenderCoordinator<Float, Spectrum>::port() const {
+    return d->server->port();
+}
+
+MI_VARIANT size_t RenderCoordinator<Float, Spectrum>::worker_count() const {
+    std::lock_guard<std::mutex> guard(d->mutex);
+    return d->workers;
+}
+
+MI_VARIANT size_t RenderCoordinator<Float, Spectrum>::reissued_count() const {
+    std::lock_guard<std::mutex> guard(d->mutex);
+    return d->reissued;
+}
+
+MI_VARIANT std::string RenderCoordinator<Float, Spectrum>::to_string() const {
+    std::ostringstream oss;
+    oss << "RenderCoordinator[" << std::endl
+        << "  port = " << port() << "," << std::endl
+        << "  tile_size = " << d->tile_size << "," << std::endl
+        << "  reissue_factor = " << d->reissue_factor << "," << std::endl
+        << "  max_issues = " << d->max_issues << "," << std::endl
+        << "  workers = " << worker_count() << std::endl
+        << "]";
+    return oss.str();
+}
+
+// =============================================================
+//! RenderWorker
+// =============================================================
+
+MI_VARIANT
+RenderWorker<Float, Spectrum>::RenderWorker(const std::string &host,
+                                            uint16_t port)
+    : m_tiles_rendered(0) {
+    m_stream = new SocketStream(host, port);
+
+    ref<MemoryStream> message = detail::new_payload();
+    message->write(std::string(detail::get_variant<Float, Spectrum>()));
+    detail::send_message(m_stream, detail::RenderMessage::Hello, message);
+}
+
+MI_VARIANT RenderWorker<Float, Spectrum>::~RenderWorker() { }
+
+MI_VARIANT size_t RenderWorker<Float, Spectrum>::run(Scene *scene) {
+    if (!scene->integrator())
+        Throw("RenderWorker::run(): the scene has no integrator!");
+
+    // Remember the crop windows of all sensors so that they can be restored
+    std::vector<std::pair<ScalarPoint2u, ScalarVector2u>> crop_windows;
+    for (auto &sensor : scene->sensors())
+        crop_windows.emplace_back(sensor->film()->crop_offset(),
+                                  sensor->film()->crop_size());
+
+    auto restore = [&]() {
+        for (size_t i = 0; i < crop_windows.size(); ++i) {
+            Sensor *sensor = scene->sensors()[i].get();
+            sensor->film()->set_crop_window(crop_windows[i].first,
+                                            crop_windows[i].second);
+            sensor->parameters_changed();
+        }
+    };
+
+    size_t tiles = 0;
+    try {
+        while (true) {
+            ref<MemoryStream> payload;
+            detail::RenderMessage type =
+                detail::receive_message(m_stream, payload);
+            if (type == detail::RenderMessage::Shutdown)
+                break;
+            else if (type != detail::RenderMessage::Tile)
+                Throw("RenderWorker::run(): received an unexpected message!");
+
+            uint32_t job, tile, sensor_index, seed, spp;
+            ScalarVector2u film_size, size;
+            ScalarPoint2u offset;
+            payload->read(job);
+            payload->read(tile);
+            payload->read(sensor_index);
+            payload->read(film_size.x());
+            payload->read(film_size.y());
+            payload->read(offset.x());
+            payload->read(offset.y());
+            payload->read(size.x());
+            payload->read(size.y());
+            payload->read(seed);
+            payload->read(spp);
+
+            if (sensor_index >= scene->sensors().size())
+                Throw("RenderWorker::run(): sensor index %i is out of bounds!",
+                      sensor_index);
+
+            Sensor *sensor = scene->sensors()[sensor_index].get();
+            Film *film = sensor->film();
+            if (film->size() != film_size)
+                Throw("RenderWorker::run(): film size mismatch (%s, expected "
+                      "%s). Was the same scene loaded?", film->size(), film_size);
+
+            film->set_crop_window(offset, size);
+            sensor->parameters_changed();
+
+            scene->integrator()->render(scene, sensor, seed, spp,
+                                        false /* develop */,
+                                        true /* evaluate */);
+
+            ref<ImageBlock> block =
+                new ImageBlock(film->develop(true), ScalarPoint2i(offset),
+                               nullptr, false);
+
+            ref<MemoryStream> message = detail::new_payload();
+            message->write(job);
+            message->write(tile);
+            block->write(message);
+            detail::send_message(m_stream, detail::RenderMessage::Result, message);
+
+            tiles++;
+            m_tiles_rendered++;
+        }
+    } catch (...) {
+        restore();
+        throw;
+    }
+
+    restore();
+    m_stream->close();
+    return tiles;
+}
+
+MI_VARIANT std::string RenderWorker<Float, Spectrum>::to_string() const {
+    std::ostringstream oss;
+    oss << "RenderWorker[" << std::endl
+        << "  coordinator = \"" << m_stream->peer() << "\"," << std::endl
+        << "  tiles_rendered = " << m_tiles_rendered << std::endl
+        << "]";
+    return oss.str();
+}
+
+// =============================================================
+//! RenderServer
+// =============================================================
+
+template <typename Float, typename Spectrum>
+struct RenderServerPrivate {
+    MI_IMPORT_TYPES(Scene)
+
+    struct Request {
+        uint32_t type;
+        ref<MemoryStream> payload;
+        bool done = false;
+        detail::RenderMessage reply_type = detail::RenderMessage::Done;
+        ref<MemoryStream> reply;
+    };
+
+    // Configuration
+    ref<ServerSocket> server;
+    size_t max_queued;
+
+    // Connection management
+    std::thread accept_thread;
+    std::vector<std::thread> threads;
+    std::vector<ref<SocketStream>> streams;
+    ThreadEnvironment env;
+    bool stop = false;
+
+    // Request queue
+    mutable std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<std::shared_ptr<Request>> queue;
+    size_t completed = 0;
+    /// Number of replies that are ready but not yet sent
+    size_t sending = 0;
+
+    // Resident scenes (only modified by the thread executing the requests)
+    std::map<std::string, ref<Scene>> scenes;
+};
+
+MI_VARIANT
+RenderServer<Float, Spectrum>::RenderServer(uint16_t port, size_t max_queued)
+    : d(new RenderServerPrivate<Float, Spectrum>()) {
+    if (max_queued == 0)
+        Throw("RenderServer: the queue length must be positive!");
+
+    d->server = new ServerSocket(port);
+    d->max_queued = max_queued;
+
+    Log(Info, "Render server listening on port %i ..", d->server->port());
+
+    d->accept_thread = std::thread([this]() {
+        ScopedSetThreadEnvironment set_env(d->env);
+        while (true) {
+            ref<SocketStream> stream;
+            try {
+                stream = d->server->accept();
+            } catch (const std::exception &e) {
+                Log(Warn, "RenderServer: %s", e.what());
+                continue;
+            }
+            if (!stream)
+                break;
+
+            std::lock_guard<std::mutex> guard(d->mutex);
+            if (d->stop)
+                break;
+            d->streams.push_back(stream);
+            d->threads.emplace_back(&RenderServer::serve, this, stream);
+        }
+    });
+}
+
+MI_VARIANT RenderServer<Float, Spectrum>::~RenderServer() {
+    shutdown();
+
+    /* Disconnect the remaining clients once all replies have been sent, which
+       wakes up the threads waiting for their next request */
+    std::unique_lock<std::mutex> lock(d->mutex);
+    d->cv.wait(lock, [&]() { return d->sending == 0; });
+    for (auto &stream : d->streams)
+        stream->close();
+    lock.unlock();
+
+    for (auto &thread : d->threads)
+        thread.join();
+}
+
+MI_VARIANT void RenderServer<Float, Spectrum>::shutdown() {
+    /* critical section */ {
+        std::lock_guard<std::mutex> guard(d->mutex);
+        d->stop = true;
+        d->cv.notify_all();
+    }
+
+    d->server->close();
+    if (d->accept_thread.joinable())
+        d->accept_thread.join();
+}
+
+MI_VARIANT void
+RenderServer<Float, Spectrum>::serve(ref<SocketStream> stream) {
+    ScopedSetThreadEnvironment set_env(d->env);
+    using Request = typename RenderServerPrivate<Float, Spectrum>::Request;
+    Log(Info, "Render client %s connected.", stream->peer());
+
+    try {
+        while (true) {
+            ref<MemoryStream> payload;
+            detail::RenderMessage type = detail::receive_message(stream, payload);
+
+            auto request = std::make_shared<Request>();
+            request->type = (uint32_t) type;
+            request->payload = payload;
+
+            std::unique_lock<std::mutex> lock(d->mutex);
+            if (d->stop || d->queue.size() >= d->max_queued) {
+                request->reply_type = detail::RenderMessage::Error;
+                request->reply = detail::new_payload();
+                request->reply->write(std::string(
+                    d->stop ? "the server is shutting down"
+                            : "the request queue is full"));
+                d->sending++;
+            } else {
+                d->queue.push_back(request);
+                d->cv.notify_all();
+                d->cv.wait(lock, [&]() { return request->done; });
+            }
+            lock.unlock();
+
+            bool sent = false;
+            try {
+                detail::send_message(stream, request->reply_type, request->reply);
+                sent = true;
+            } catch (...) { }
+
+            lock.lock();
+            d->sending--;
+            d->cv.notify_all();
+            lock.unlock();
+
+            if (!sent)
+                Throw("could not send the reply");
+            if (type == detail::RenderMessage::Shutdown)
+                break;
+        }
+    } catch (const std::exception &e) {
+        Log(Info, "Render client %s disconnected (%s).", stream->peer(), e.what());
+    }
+}
+
+MI_VARIANT void RenderServer<Float, Spectrum>::run() {
+    std::unique_lock<std::mutex> lock(d->mutex);
+
+    // Complete all pending requests, even after a shutdown
+    while (true) {
+        d->cv.wait(lock, [&]() { return d->stop || !d->queue.empty(); });
+        if (d->queue.empty())
+            break;
+
+        auto request = d->queue.front();
+        d->queue.pop_front();
+        lock.unlock();
+
+        ref<MemoryStream> reply = detail::new_payload();
+        detail::RenderMessage reply_type = detail::RenderMessage::Done;
+        try {
+            execute(request->type, request->payload, reply);
+        } catch (const std::exception &e) {
+            Log(Warn, "RenderServer: %s", e.what());
+            reply = detail::new_payload();
+            reply->write(std::string(e.what()));
+            reply_type = detail::RenderMessage::Error;
+        }
+
+        lock.lock();
+        request->reply = reply;
+        request->reply_type = reply_type;
+        request->done = true;
+        d->sending++;
+        d->completed++;
+
+        // Requests arriving after a shutdown request are rejected
+        if (request->type == (uint32_t) detail::RenderMessage::Shutdown)
+            d->stop = true;
+        d->cv.notify_all();
+    }
+    lock.unlock();
+
+    shutdown();
+}
+
+MI_VARIANT void RenderServer<Float, Spectrum>::execute(uint32_t type,
+                                                       MemoryStream *payload,
+                                                       MemoryStream *reply) {
+    switch ((detail::RenderMessage) type) {
+        case detail::RenderMessage::LoadScene: {
+                std::string id, filename;
+                payload->read(id);
+                payload->read(filename);
+                load_scene(id, filename, detail::read_parameters(payload));
+            }
+            break;
+
+        case detail::RenderMessage::RemoveScene: {
+                std::string id;
+                payload->read(id);
+                remove_scene(id);
+            }
+            break;
+
+        case detail::RenderMessage::RenderJob: {
+                ref<Bitmap> bitmap = render_job(payload);
+
+                /* OpenEXR records absolute stream offsets, hence the image is
+                   first written into a separate stream */
+                ref<MemoryStream> image = new MemoryStream();
+                bitmap->write(image, Bitmap::FileFormat::OpenEXR);
+                reply->write((uint64_t) image->size());
+                reply->write(image->raw_buffer(), image->size());
+            }
+            break;
+
+        case detail::RenderMessage::Shutdown:
+            Log(Info, "Render server: shutdown requested by a client.");
+            break;
+
+        default:
+            Throw("unexpected request type %u", type);
+    }
+}
+
+MI_VARIANT ref<Bitmap>
+RenderServer<Float, Spectrum>::render_job(MemoryStream *payload) {
+    std::string id;
+    uint32_t sensor_index, spp, seed;
+    payload->read(id);
+    payload->read(sensor_index);
+    payload->read(spp);
+    payload->read(seed);
+    RenderParameterList overrides = detail::read_parameters(payload);
+
+    auto it = d->scenes.find(id);
+    if (it == d->scenes.end())
+        Throw("unknown scene \"%s\"", id);
+    Scene *scene = it->second.get();
+
+    if (sensor_index >= scene->sensors().size())
+        Throw("sensor index %i is out of bounds!", sensor_index);
+    if (!scene->integrator())
+        Throw("the scene \"%s\" has no integrator!", id);
+
+    Sensor *sensor = scene->sensors()[sensor_index].get();
+    detail::ParameterOverrides<Float, Spectrum> params(scene);
+
+    Timer timer;
+    ref<Bitmap> bitmap;
+    try {
+        for (const auto &[key, value] : overrides)
+            params.set(key, value);
+
+        scene->integrator()->render(scene, sensor, seed, spp,
+                                    false /* develop */,
+                                    true /* evaluate */);
+        bitmap = sensor->film()->bitmap();
+    } catch (...) {
+        params.restore();
+        throw;
+    }
+    params.restore();
+
+    Log(Info, "Rendered scene \"%s\" with %i override%s (took %s).", id,
+        overrides.size(), overrides.size() == 1 ? "" : "s",
+        util::time_string((float) timer.value(), true));
+
+    return bitmap;
+}
+
+MI_VARIANT void
+RenderServer<Float, Spectrum>::add_scene(const std::string &id, Scene *scene) {
+    if (!scene)
+        Throw("RenderServer::add_scene(): the scene must not be null!");
+    std::lock_guard<std::mutex> guard(d->mutex);
+    d->scenes[id] = scene;
+}
+
+MI_VARIANT void
+RenderServer<Float, Spectrum>::load_scene(const std::string &id,
+                                          const fs::path &filename,
+                                          const RenderParameterList &defines) {
+    xml::ParameterList params;
+    for (const auto &[key, value] : defines)
+        params.emplace_back(key, value, false);
+
+    Timer timer;
+    std::vector<ref<Object>> parsed = xml::load_file(
+        filename, detail::get_variant<Float, Spectrum>(), params);
+
+    Scene *scene = parsed.size() == 1 ? dynamic_cast<Scene *>(parsed[0].get())
+                                      : nullptr;
+    if (!scene)
+        Throw("the root element of \"%s\" must be a <scene> tag!",
+              filename.string());
+
+    add_scene(id, scene);
+    Log(Info, "Loaded scene \"%s\" from \"%s\" (took %s).", id,
+        filename.string(), util::time_string((float) timer.value(), true));
+}
+
+MI_VARIANT void
+RenderServer<Float, Spectrum>::remove_scene(const std::string &id) {
+    std::lock_guard<std::mutex> guard(d->mutex);
+    if (d->scenes.erase(id) == 0)
+        Throw("unknown scene \"%s\"", id);
+}
+
+MI_VARIANT std::vector<std::string>
+RenderServer<Float, Spectrum>::scene_ids() const {
+    std::lock_guard<std::mutex> guard(d->mutex);
+    std::vector<std::string> result;
+    for (const auto &[id, scene] : d->scenes)
+        result.push_back(id);
+    return result;
+}
+
+MI_VARIANT uint16_t RenderServer<Float, Spectrum>::port() const {
+    return d->server->port();
+}
+
+MI_VARIANT size_t RenderServer<Float, Spectrum>::jobs_completed() const {
+    std::lock_guard<std::mutex> guard(d->mutex);
+    return d->completed;
+}
+
+MI_VARIANT std::string RenderServer<Float, Spectrum>::to_string() const {
+    std::ostringstream oss;
+    oss << "RenderServer[" << std::endl
+        << "  port = " << port() << "," << std::endl
+        << "  max_queued = " << d->max_queued << "," << std::endl
+        << "  scenes = [";
+    std::vector<std::string> ids = scene_ids();
+    for (size_t i = 0; i < ids.size(); ++i)
+        oss << "\"" << ids[i] << "\"" << (i + 1 < ids.size() ? ", " : "");
+    oss << "]," << std::endl
+        << "  jobs_completed = " << jobs_completed() << std::endl
+        << "]";
+    return oss.str();
+}
+
+// =============================================================
+//! RenderClient
+// =============================================================
+
+RenderClient::RenderClient(const std::string &host, uint16_t port) {
+    m_stream = new SocketStream(host, port);
+}
+
+RenderClient::~RenderClient() { }
+
+ref<MemoryStream> RenderClient::request(uint32_t type,
+                                        const MemoryStream *payload) {
+    detail::send_message(m_stream, (detail::RenderMessage) type, payload);
+
+    ref<MemoryStream> reply;
+    detail::RenderMessage reply_type = detail::receive_message(m_stream, reply);
+    if (reply_type == detail::RenderMessage::Error) {
+        std::string message;
+        reply->read(message);
+        Throw("RenderClient: %s", message);
+    } else if (reply_type != detail::RenderMessage::Done) {
+        Throw("RenderClient: received an unexpected message!");
+    }
+    return reply;
+}
+
+void RenderClient::load_scene(const std::string &id,
+                              const std::string &filename,
+                              const RenderParameterList &defines) {
+    ref<MemoryStream> message = detail::new_payload();
+    message->write(id);
+    message->write(filename);
+    detail::write_parameters(message, defines);
+    request((uint32_t) detail::RenderMessage::LoadScene, message);
+}
+
+void RenderClient::remove_scene(const std::string &id) {
+    ref<MemoryStream> message = detail::new_payload();
+    message->write(id);
+    request((uint32_t) detail::RenderMessage::RemoveScene, message);
+}
+
+ref<Bitmap> RenderClient::render(const std::string &id,
+                                 const RenderParameterList &overrides,
+                                 uint32_t sensor_index, uint32_t spp,
+                                 uint32_t seed) {
+    ref<MemoryStream> message = detail::new_payload();
+    message->write(id);
+    message->write(sensor_index);
+    message->write(spp);
+    message->write(seed);
+    detail::write_parameters(message, overrides);
+
+    ref<MemoryStream> reply =
+        request((uint32_t) detail::RenderMessage::RenderJob, message);
+
+    uint64_t size;
+    reply->read(size);
+    ref<MemoryStream> image = new MemoryStream((size_t) size);
+    image->write(reply->raw_buffer() + reply->tell(), (size_t) size);
+    image->seek(0);
+    return new Bitmap(image, Bitmap::FileFormat::OpenEXR);
+}
+
+void RenderClient::shutdown_server() {
+    request((uint32_t) detail::RenderMessage::Shutdown, nullptr);
+}
+
+std::string RenderClient::to_string() const {
+    std::ostringstream oss;
+    oss << "RenderClient[" << std::endl
+        << "  server = \"" << m_stream->peer() << "\"" << std::endl
+        << "]";
+    return oss.str();
+}
+
+// =============================================================
+//! MultiDeviceRenderer
+// =============================================================
+
+template <typename Float, typename Spectrum>
+struct MultiDeviceRendererPrivate {
+    MI_IMPORT_TYPES(Scene)
+    using DeviceStats = typename MultiDeviceRenderer<Float, Spectrum>::DeviceStats;
+
+    std::vector<int> devices;
+    std::vector<ref<Scene>> scenes;
+    std::vector<DeviceStats> stats;
+    float efficiency = 0.f;
+    ThreadEnvironment env;
+
+    /// Run \c func(i) for every device on a thread bound to that device
+    template <typename Func> void run(Func func) {
+        std::vector<std::string> errors(devices.size());
+        auto run_device = [&](size_t i) {
+            try {
+#if defined(MI_ENABLE_CUDA)
+                jit_cuda_set_device(devices[i]);
+#endif
+                func(i);
+            } catch (const std::exception &e) {
+                errors[i] = e.what();
+            }
+        };
+
+        // The primary device uses the calling thread
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < devices.size(); ++i)
+            threads.emplace_back([&, i]() {
+                ScopedSetThreadEnvironment set_env(env);
+                run_device(i);
+            });
+        run_device(0);
+        for (std::thread &t : threads)
+            t.join();
+
+        for (size_t i = 0; i < devices.size(); ++i)
+            if (!errors[i].empty())
+                Throw("MultiDeviceRenderer: error on device %i: %s",
+                      devices[i], errors[i]);
+    }
+};
+
+MI_VARIANT MultiDeviceRenderer<Float, Spectrum>::MultiDeviceRenderer(
+    const fs::path &filename, const std::vector<int> &devices,
+    const RenderParameterList &defines)
+    : d(new MultiDeviceRendererPrivate<Float, Spectrum>()) {
+    if constexpr (!dr::is_cuda_v<Float>)
+        Throw("MultiDeviceRenderer: this class requires a CUDA variant!");
+
+    int device_count = 0;
+#if defined(MI_ENABLE_CUDA)
+    device_count = jit_cuda_device_count();
+#endif
+    d->devices = devices;
+    if (d->devices.empty())
+        for (int i = 0; i < device_count; ++i)
+            d->devices.push_back(i);
+    if (d->devices.empty())
+        Throw("MultiDeviceRenderer: no CUDA devices found!");
+    for (size_t i = 0; i < d->devices.size(); ++i) {
+        if (d->devices[i] < 0 || d->devices[i] >= device_count)
+            Throw("MultiDeviceRenderer: invalid CUDA device %i (%i device%s "
+                  "available)!", d->devices[i], device_count,
+                  device_count == 1 ? "" : "s");
+        for (size_t j = 0; j < i; ++j)
+            if (d->devices[i] == d->devices[j])
+                Throw("MultiDeviceRenderer: CUDA device %i was specified "
+                      "more than once!", d->devices[i]);
+    }
+
+    xml::ParameterList params;
+    for (const auto &[key, value] : defines)
+        params.emplace_back(key, value, false);
+
+    Timer timer;
+    d->scenes.resize(d->devices.size());
+    d->stats.resize(d->devices.size());
+    d->run([&](size_t i) {
+        /* Load sequentially on this thread: the worker threads of the
+           parallel scene loader are not bound to the device */
+        std::vector<ref<Object>> parsed = xml::load_file(
+            filename, detail::get_variant<Float, Spectrum>(), params,
+            false /* update_scene */, false /* parallel */);
+        Scene *scene = parsed.size() == 1
+                           ? dynamic_cast<Scene *>(parsed[0].get())
+                           : nullptr;
+        if (!scene)
+            Throw("the root element of \"%s\" must be a <scene> tag!",
+                  filename.string());
+        if (!scene->integrator())
+            Throw("no integrator specified for scene \"%s\"",
+                  filename.string());
+        d->scenes[i] = scene;
+        d->stats[i].device = d->devices[i];
+    });
+
+    Log(Info, "Loaded %zu replica%s of \"%s\" (took %s).",
+        d->devices.size(), d->devices.size() == 1 ? "" : "s",
+        filename.string(), util::time_string((float) timer.value(), true));
+}
+
+MI_VARIANT MultiDeviceRenderer<Float, Spectrum>::~MultiDeviceRenderer() {
+    // Release every replica on the thread of its device
+    if (!d->scenes.empty())
+        d->run([&](size_t i) { d->scenes[i] = nullptr; });
+}
+
+MI_VARIANT typename MultiDeviceRenderer<Float, Spectrum>::TensorXf
+MultiDeviceRenderer<Float, Spectrum>::render(uint32_t sensor_index,
+                                             uint32_t seed, uint32_t spp,
+                                             uint32_t spp_per_pass,
+                                             bool develop) {
+    size_t device_count = d->devices.size();
+    if (sensor_index >= d->scenes[0]->sensors().size())
+        Throw("MultiDeviceRenderer: sensor index %u is out of bounds!",
+              sensor_index);
+
+    Sensor *primary = d->scenes[0]->sensors()[sensor_index].get();
+    if (spp == 0)
+        spp = primary->sampler()->sample_count();
+    if (spp_per_pass == 0)
+        spp_per_pass = std::max(1u, spp / (4 * (uint32_t) device_count));
+    spp_per_pass = std::min(spp, spp_per_pass);
+    uint32_t n_passes = (spp + spp_per_pass - 1) / spp_per_pass;
+
+    for (DeviceStats &s : d->stats)
+        s = DeviceStats{ s.device };
+
+    std::atomic<uint32_t> next_pass(0);
+    std::vector<TensorXf> accum(device_count);
+    std::vector<std::vector<ScalarFloat>> host(device_count);
+    std::vector<std::vector<size_t>> shape(device_count);
+
+    Timer timer;
+    d->run([&](size_t i) {
+        Scene *scene = d->scenes[i].get();
+        Sensor *sensor = scene->sensors()[sensor_index].get();
+        Film *film = sensor->film();
+        DeviceStats &stats = d->stats[i];
+
+        while (true) {
+            uint32_t pass = next_pass++;
+            if (pass >= n_passes)
+                break;
+            uint32_t pass_spp = std::min(spp_per_pass, spp - pass * spp_per_pass);
+
+            Timer pass_timer;
+            scene->integrator()->render(scene, sensor,
+                                        sample_tea_32(seed, pass).first,
+                                        pass_spp, false /* develop */,
+                                        true /* evaluate */);
+
+            TensorXf raw = film->develop(/* raw = */ true);
+            accum[i] = stats.passes == 0 ? raw : accum[i] + raw;
+            dr::eval(accum[i].array());
+            dr::sync_thread();
+
+            stats.busy_time += pass_timer.value() / 1000.f;
+            stats.passes++;
+            stats.spp += pass_spp;
+        }
+
+        // Results of the other devices are transferred via host memory
+        if (i > 0 && stats.passes > 0) {
+            shape[i].assign(accum[i].shape(),
+                            accum[i].shape() + accum[i].ndim());
+            auto &&values = dr::migrate(accum[i].array(), AllocType::Host);
+            dr::sync_thread();
+            host[i].assign(values.data(),
+                           values.data() + dr::width(accum[i].array()));
+            accum[i] = TensorXf();
+        }
+    });
+    float wall_time = timer.value() / 1000.f;
+
+    // Merge the accumulated film contents into the film of the primary device
+    TensorXf &merged = accum[0];
+    for (size_t i = 1; i < device_count; ++i) {
+        if (host[i].empty())
+            continue;
+        TensorXf values(dr::load<FloatStorage>(host[i].data(), host[i].size()),
+                        shape[i].size(), shape[i].data());
+        merged = dr::width(merged.array()) > 0 ? merged + values : values;
+    }
+    dr::eval(merged.array());
+
+    Film *film = primary->film();
+    film->clear();
+    ref<ImageBlock> block = new ImageBlock(
+        merged, ScalarPoint2i(film->crop_offset()), nullptr, false);
+    film->put_block(block);
+
+    // Report the load distribution and scaling efficiency
+    uint64_t pixel_count = dr::prod(film->crop_size());
+    float max_throughput = 0.f;
+    for (DeviceStats &s : d->stats) {
+        s.utilization = wall_time > 0.f ? s.busy_time / wall_time : 0.f;
+        s.throughput = s.busy_time > 0.f
+                           ? (float) ((double) s.spp * pixel_count / s.busy_time)
+                           : 0.f;
+        max_throughput = std::max(max_throughput, s.throughput);
+
+        Log(Info, "Device %i: %u pass%s, %u spp (%.1f%%), %.2f Msamples/s, "
+                  "%.1f%% busy.", s.device, s.passes, s.passes == 1 ? "" : "es",
+            s.spp, 100.f * s.spp / spp, s.throughput * 1e-6f,
+            100.f * s.utilization);
+    }
+
+    float throughput = (float) ((double) spp * pixel_count / wall_time),
+          speedup    = max_throughput > 0.f ? throughput / max_throughput : 0.f;
+    d->efficiency = speedup / device_count;
+
+    Log(Info, "Rendered %u spp in %u passes on %zu device%s (took %s): "
+              "%.2fx speedup over the fastest device, %.1f%% scaling "
+              "efficiency.", spp, n_passes, device_count,
+        device_count == 1 ? "" : "s",
+        util::time_string(wall_time * 1000.f, true), speedup,
+        100.f * d->efficiency);
+
+    return develop ? film->develop() : TensorXf();
+}
+
+MI_VARIANT const std::vector<int> &
+MultiDeviceRenderer<Float, Spectrum>::devices() const {
+    return d->devices;
+}
+
+MI_VARIANT typename MultiDeviceRenderer<Float, Spectrum>::Scene *
+MultiDeviceRenderer<Float, Spectrum>::scene(size_t index) const {
+    if (index >= d->scenes.size())
+        Throw("MultiDeviceRenderer: replica index %zu is out of bounds!", index);
+    return d->scenes[index].get();
+}
+
+MI_VARIANT const std::vector<typename MultiDeviceRenderer<Float, Spectrum>::DeviceStats> &
+MultiDeviceRenderer<Float, Spectrum>::device_stats() const {
+    return d->stats;
+}
+
+MI_VARIANT float MultiDeviceRenderer<Float, Spectrum>::scaling_efficiency() const {
+    return d->efficiency;
+}
+
+MI_VARIANT std::string MultiDeviceRenderer<Float, Spectrum>::to_string() const {
+    std::ostringstream oss;
+    oss << "MultiDeviceRenderer[" << std::endl
+        << "  devices = [";
+    for (size_t i = 0; i < d->devices.size(); ++i)
+        oss << d->devices[i] << (i + 1 < d->devices.size() ? ", " : "");
+    oss << "]" << std::endl
+        << "]";
+    return oss.str();
+}
+
+// =============================================================
+//! HybridRenderer
+// =============================================================
+
+NAMESPACE_BEGIN(detail)
+
+/// Scene replica of one side of a \ref HybridRenderer
+struct HybridBackend {
+    virtual ~HybridBackend() = default;
+
+    /// Return the scene of this side
+    virtual Object *scene() const = 0;
+
+    /// Return the default sample count of a sensor
+    virtual uint32_t sample_count(uint32_t sensor_index) const = 0;
+
+    /// Return the number of pixels rendered for a sensor
+    virtual uint64_t pixel_count(uint32_t sensor_index) const = 0;
+
+    /// Render a pass and accumulate the raw film contents
+    virtual void render_pass(uint32_t sensor_index, uint32_t seed,
+                             uint32_t spp) = 0;
+
+    /// Move the accumulated film contents into host memory
+    virtual std::vector<float> release(std::vector<size_t> &shape) = 0;
+
+    /// Add film contents of the other side and develop the merged image
+    virtual ref<Bitmap> develop(uint32_t sensor_index,
+                                const std::vector<float> &values,
+                                const std::vector<size_t> &shape) = 0;
+};
+
+template <typename Float, typename Spectrum>
+struct HybridBackendImpl : HybridBackend {
+    MI_IMPORT_TYPES(Scene, Sensor, Film, ImageBlock)
+
+    HybridBackendImpl(Scene *scene) : m_scene(scene) { }
+
+    Object *scene() const override { return m_scene.get(); }
+
+    Sensor *sensor(uint32_t sensor_index) const {
+        if (sensor_index >= m_scene->sensors().size())
+            Throw("HybridRenderer: sensor index %u is out of bounds!",
+                  sensor_index);
+        return m_scene->sensors()[sensor_index].get();
+    }
+
+    uint32_t sample_count(uint32_t sensor_index) const override {
+        return (uint32_t) sensor(sensor_index)->sampler()->sample_count();
+    }
+
+    uint64_t pixel_count(uint32_t sensor_index) const override {
+        return dr::prod(sensor(sensor_index)->film()->crop_size());
+    }
+
+    void render_pass(uint32_t sensor_index, uint32_t seed,
+                     uint32_t spp) override {
+        Sensor *sensor = this->sensor(sensor_index);
+        m_scene->integrator()->render(m_scene.get(), sensor, seed, spp,
+                                      false /* develop */,
+                                      true /* evaluate */);
+
+        TensorXf raw = sensor->film()->develop(/* raw = */ true);
+        m_accum = dr::width(m_accum.array()) == 0 ? raw : m_accum + raw;
+        dr::eval(m_accum.array());
+        dr::sync_thread();
+    }
+
+    std::vector<float> release(std::vector<size_t> &shape) override {
+        size_t size = dr::width(m_accum.array());
+        if (size == 0)
+            return { };
+
+        shape.assign(m_accum.shape(), m_accum.shape() + m_accum.ndim());
+        auto &&values = dr::migrate(m_accum.array(), AllocType::Host);
+        if constexpr (dr::is_jit_v<Float>)
+            dr::sync_thread();
+        std::vector<float> result(values.data(), values.data() + size);
+        m_accum = TensorXf();
+        return result;
+    }
+
+    ref<Bitmap> develop(uint32_t sensor_index,
+                        const std::vector<float> &values,
+                        const std::vector<size_t> &shape) override {
+        Film *film = sensor(sensor_index)->film();
+
+        // The film storage is only allocated once this side rendered a pass
+        if (dr::width(m_accum.array()) == 0)
+            film->prepare(m_scene->integrator()->aov_names());
+
+        if (!values.empty()) {
+            std::vector<ScalarFloat> tmp(values.begin(), values.end());
+            TensorXf other(dr::load<FloatStorage>(tmp.data(), tmp.size()),
+                           shape.size(), shape.data());
+            m_accum = dr::width(m_accum.array()) == 0 ? other : m_accum + other;
+        }
+
+        film->clear();
+        if (dr::width(m_accum.array()) > 0) {
+            ref<ImageBlock> block = new ImageBlock(
+                m_accum, ScalarPoint2i(film->crop_offset()), nullptr, false);
+            film->put_block(block);
+        }
+        m_accum = TensorXf();
+        return film->bitmap();
+    }
+
+    ref<Scene> m_scene;
+    TensorXf m_accum;
+};
+
+template <typename Float, typename Spectrum>
+HybridBackend *load_hybrid_backend(const fs::path &filename,
+                                   const xml::ParameterList &params) {
+    using Scene = mitsuba::Scene<Float, Spectrum>;
+    std::vector<ref<Object>> parsed = xml::load_file(
+        filename, get_variant<Float, Spectrum>(), params);
+    Scene *scene = parsed.size() == 1 ? dynamic_cast<Scene *>(parsed[0].get())
+                                      : nullptr;
+    if (!scene)
+        Throw("the root element of \"%s\" must be a <scene> tag!",
+              filename.string());
+    if (!scene->integrator())
+        Throw("no integrator specified for scene \"%s\"", filename.string());
+    return new HybridBackendImpl<Float, Spectrum>(scene);
+}
+
+NAMESPACE_END(detail)
+
+struct HybridRendererPrivate {
+    std::vector<std::unique_ptr<detail::HybridBackend>> backends;
+    std::vector<HybridRenderer::BackendStats> stats;
+    ThreadEnvironment env;
+
+    /// Run \c func(i) for the CPU and GPU side on separate threads
+    template <typename Func> void run(Func func) {
+        std::vector<std::string> errors(backends.size());
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < backends.size(); ++i)
+            threads.emplace_back([&, i]() {
+                ScopedSetThreadEnvironment set_env(env);
+                try {
+                    func(i);
+                } catch (const std::exception &e) {
+                    errors[i] = e.what();
+                }
+            });
+        for (std::thread &t : threads)
+            t.join();
+
+        for (size_t i = 0; i < backends.size(); ++i)
+            if (!errors[i].empty())
+                Throw("HybridRenderer: error in variant \"%s\": %s",
+                      stats[i].variant, errors[i]);
+    }
+};
+
+HybridRenderer::HybridRenderer(const fs::path &filename,
+                               const std::string &cpu_variant,
+                               const std::string &gpu_variant,
+                               const RenderParameterList &defines)
+    : d(new HybridRendererPrivate()) {
+    if (!string::starts_with(cpu_variant, "llvm_"))
+        Throw("HybridRenderer: \"%s\" is not an LLVM variant!", cpu_variant);
+    if (!string::starts_with(gpu_variant, "cuda_"))
+        Throw("HybridRenderer: \"%s\" is not a CUDA variant!", gpu_variant);
+    // Both films must use the same channels to be merged
+    if (cpu_variant.substr(5) != gpu_variant.substr(5))
+        Throw("HybridRenderer: the variants \"%s\" and \"%s\" use different "
+              "color representations!", cpu_variant, gpu_variant);
+
+#if defined(MI_ENABLE_LLVM) && defined(MI_ENABLE_CUDA)
+    for (JitBackend backend : { JitBackend::LLVM, JitBackend::CUDA }) {
+        if (!jit_has_backend(backend))
+            jit_init((uint32_t) backend);
+        if (!jit_has_backend(backend))
+            Throw("HybridRenderer: the %s backend could not be initialized!",
+                  backend == JitBackend::LLVM ? "LLVM" : "CUDA");
+    }
+#endif
+
+    xml::ParameterList params;
+    for (const auto &[key, value] : defines)
+        params.emplace_back(key, value, false);
+
+    Timer timer;
+    d->backends.resize(2);
+    d->stats.resize(2);
+    d->stats[0].variant = cpu_variant;
+    d->stats[1].variant = gpu_variant;
+    d->run([&](size_t i) {
+        const std::string &variant = d->stats[i].variant;
+        d->backends[i].reset(MI_INVOKE_VARIANT(
+            variant, detail::load_hybrid_backend, filename, params));
+    });
+
+    Log(Info, "Loaded \"%s\" in the variants %s and %s (took %s).",
+        filename.string(), cpu_variant, gpu_variant,
+        util::time_string((float) timer.value(), true));
+}
+
+HybridRenderer::~HybridRenderer() { }
+
+ref<Bitmap> HybridRenderer::render(uint32_t sensor_index, uint32_t seed,
+                                   uint32_t spp, float pass_time) {
+    detail::HybridBackend *gpu = d->backends[1].get();
+    if (spp == 0)
+        spp = gpu->sample_count(sensor_index);
+    uint64_t pixel_count = gpu->pixel_count(sensor_index);
+    size_t n = d->backends.size();
+
+    for (BackendStats &s : d->stats)
+        s = BackendStats{ s.variant };
+
+    // Scheduler state, the speed of a side is measured in spp per second
+    std::mutex mutex;
+    uint32_t remaining = spp, n_passes = 0;
+    std::vector<double> speed(n, 0.0);
+    std::vector<bool> active(n, true);
+
+    /* Return the index and sample count of the next pass of side 'i' (or a
+       sample count of zero if this side should stop) */
+    auto acquire = [&](size_t i) -> std::pair<uint32_t, uint32_t> {
+        std::lock_guard<std::mutex> guard(mutex);
+        if (remaining == 0)
+            return { 0, 0 };
+
+        // The first pass of each side measures its speed
+        uint32_t pass_spp = 1;
+        if (speed[i] > 0.0) {
+            double total_speed = 0.0, max_speed = 0.0;
+            for (size_t j = 0; j < n; ++j) {
+                if (!active[j])
+                    continue;
+                total_speed += speed[j];
+                max_speed = std::max(max_speed, speed[j]);
+            }
+
+            /* Limit the pass to this side's share of the remaining samples,
+               so that both sides finish at about the same time. A slower
+               side that cannot complete a single sample per pixel in this
+               time would delay the render and stops. */
+            double share = remaining * speed[i] / total_speed;
+            if (share < 1.0 && speed[i] < max_speed) {
+                active[i] = false;
+                return { 0, 0 };
+            }
+
+            double target = std::min(speed[i] * pass_time, share);
+            pass_spp = (uint32_t) std::max(1.0, std::min(target, (double) remaining));
+        }
+
+        remaining -= pass_spp;
+        return { n_passes++, pass_spp };
+    };
+
+    Timer timer;
+    d->run([&](size_t i) {
+        BackendStats &stats = d->stats[i];
+        try {
+            while (true) {
+                auto [pass, pass_spp] = acquire(i);
+                if (pass_spp == 0)
+                    break;
+
+                Timer pass_timer;
+                d->backends[i]->render_pass(sensor_index,
+                                            sample_tea_32(seed, pass).first,
+                                            pass_spp);
+                float time = pass_timer.value() / 1000.f;
+
+                std::lock_guard<std::mutex> guard(mutex);
+                speed[i] = pass_spp / std::max(time, 1e-4f);
+                stats.busy_time += time;
+                stats.passes++;
+                stats.spp += pass_spp;
+            }
+        } catch (...) {
+            // Let the other side finish quickly
+            std::lock_guard<std::mutex> guard(mutex);
+            remaining = 0;
+            throw;
+        }
+    });
+    float wall_time = timer.value() / 1000.f;
+
+    // Merge the contributions on the GPU side
+    std::vector<size_t> shape;
+    std::vector<float> values = d->backends[0]->release(shape);
+    ref<Bitmap> bitmap = gpu->develop(sensor_index, values, shape);
+
+    for (BackendStats &s : d->stats) {
+        s.utilization = wall_time > 0.f ? s.busy_time / wall_time : 0.f;
+        s.throughput = s.busy_time > 0.f
+                           ? (float) ((double) s.spp * pixel_count / s.busy_time)
+                           : 0.f;
+        Log(Info, "%s: %u pass%s, %u spp (%.1f%%), %.2f Msamples/s, %.1f%% "
+                  "busy.", s.variant, s.passes, s.passes == 1 ? "" : "es",
+            s.spp, 100.f * s.spp / spp, s.throughput * 1e-6f,
+            100.f * s.utilization);
+    }
+
+    Log(Info, "Rendered %u spp in %u passes on the CPU and GPU (took %s).",
+        spp, n_passes, util::time_string(wall_time * 1000.f, true));
+
+    return bitmap;
+}
+
+Object *HybridRenderer::scene(size_t index) const {
+    if (index >= d->backends.size())
+        Throw("HybridRenderer: scene index %zu is out of bounds!", index);
+    return d->backends[index]->scene();
+}
+
+const std::vector<HybridRenderer::BackendStats> &
+HybridRenderer::backend_stats() const {
+    return d->stats;
+}
+
+std::string HybridRenderer::to_string() const {
+    std::ostringstream oss;
+    oss << "HybridRenderer[" << std::endl
+        << "  cpu_variant = \"" << d->stats[0].variant << "\"," << std::endl
+        << "  gpu_variant = \"" << d->stats[1].variant << "\"" << std::endl
+        << "]";
+    return oss.str();
+}
+
+MI_IMPLEMENT_CLASS(RenderClient, Object)
+MI_IMPLEMENT_CLASS(HybridRenderer, Object)
+MI_IMPLEMENT_CLASS_VARIANT(RenderCoordinator, Object)
+MI_IMPLEMENT_CLASS_VARIANT(RenderWorker, Object)
+MI_IMPLEMENT_CLASS_VARIANT(RenderServer, Object)
+MI_IMPLEMENT_CLASS_VARIANT(MultiDeviceRenderer, Object)
+MI_INSTANTIATE_CLASS(RenderCoordinator)
+MI_INSTANTIATE_CLASS(RenderWorker)
+MI_INSTANTIATE_CLASS(RenderServer)
+MI_INSTANTIATE_CLASS(MultiDeviceRenderer)
+NAMESPACE_END(mitsuba)
@@ -22,6 +22,11 @@ void Emitter<Float, Spectrum>::parameters_changed(const std::vector<std::string>
     Base::parameters_changed(keys);
 }
 
+MI_VARIANT typename Emitter<Float, Spectrum>::LightBounds
+Emitter<Float, Spectrum>::light_bounds() const {
+    return LightBounds();
+}
+
 MI_IMPLEMENT_CLASS_VARIANT(Emitter, Endpoint, "emitter")
 MI_INSTANTIATE_CLASS(Emitter)
 NAMESPACE_END(mitsuba)
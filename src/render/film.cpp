@@ -1,6 +1,8 @@
 #include <mitsuba/render/film.h>
 #include <mitsuba/core/plugin.h>
 #include <mitsuba/core/properties.h>
+#include <mitsuba/core/profiler.h>
+#include <mitsuba/render/imageblock.h>
 
 NAMESPACE_BEGIN(mitsuba)
 
@@ -52,6 +54,62 @@ MI_VARIANT Film<Float, Spectrum>::Film(const Properties &props) : Object() {
 
 MI_VARIANT Film<Float, Spectrum>::~Film() { }
 
+MI_VARIANT void Film<Float, Spectrum>::put_block_striped(ImageBlock *storage,
+                                                        const ImageBlock *block,
+                                                        std::shared_mutex &mutex) {
+    ScopedPhase sp(ProfilerPhase::ImageBlockPut);
+
+    if constexpr (dr::is_jit_v<Float>) {
+        std::lock_guard<std::shared_mutex> guard(mutex);
+        storage->put_block(block);
+    } else {
+        std::shared_lock<std::shared_mutex> guard(mutex);
+
+        // Region of the storage (in pixels) overlapped by the block
+        ScalarVector2i target_size(storage->size() + 2 * storage->border_size()),
+                       start(block->offset() - storage->offset()),
+                       end;
+        start -= (int) block->border_size() - (int) storage->border_size();
+        end = start + ScalarVector2i(block->size() + 2 * block->border_size());
+
+        start = dr::maximum(start, 0);
+        end   = dr::minimum(end, target_size);
+        if (dr::any(start >= end))
+            return;
+
+        // Find the (deduplicated) locks of all overlapped tiles
+        ScalarVector2i t0 = start / (int) TileLockSize,
+                       t1 = (end - 1) / (int) TileLockSize;
+        uint32_t tiles_x = (uint32_t) (target_size.x() + TileLockSize - 1) / TileLockSize;
+
+        uint64_t mask = 0;
+        static_assert(TileLockCount <= 64);
+        for (int y = t0.y(); y <= t1.y(); ++y)
+            for (int x = t0.x(); x <= t1.x(); ++x)
+                mask |= 1ull << (((uint32_t) y * tiles_x + (uint32_t) x) % TileLockCount);
+
+        // Acquire them in increasing order to avoid deadlocks
+        struct TileGuard {
+            std::mutex *locks;
+            uint64_t mask;
+            ~TileGuard() {
+                for (uint32_t i = 0; i < TileLockCount; ++i) {
+                    if (mask & (1ull << i))
+                        locks[i].unlock();
+                }
+            }
+        };
+
+        for (uint32_t i = 0; i < TileLockCount; ++i) {
+            if (mask & (1ull << i))
+                m_tile_locks[i].lock();
+        }
+
+        TileGuard tile_guard{ m_tile_locks, mask };
+        storage->put_block(block);
+    }
+}
+
 MI_VARIANT void Film<Float, Spectrum>::traverse(TraversalCallback *callback) {
     callback->put_parameter("size", m_size, +ParamFlags::NonDifferentiable);
     callback->put_parameter("crop_size", m_crop_size, +ParamFlags::NonDifferentiable);
@@ -83,6 +141,12 @@ Film<Float, Spectrum>::prepare_sample(const UnpolarizedSpectrum & /* spec */,
     NotImplementedError("prepare_sample");
 }
 
+MI_VARIANT ref<Bitmap>
+Film<Float, Spectrum>::develop_preview(float /* exposure */, bool /* aces */,
+                                       Struct::Type /* component_format */) const {
+    NotImplementedError("develop_preview");
+}
+
 MI_VARIANT const typename Film<Float, Spectrum>::Texture *
 Film<Float, Spectrum>::sensor_response_function() {
     return m_srf.get();
@@ -1,10 +1,41 @@
 #include <mitsuba/render/imageblock.h>
 #include <mitsuba/core/bitmap.h>
 #include <mitsuba/core/profiler.h>
+#include <mitsuba/core/stream.h>
 #include <drjit/loop.h>
 
 NAMESPACE_BEGIN(mitsuba)
 
+/**
+ * Accumulate a sample into a (clipped) footprint of pixels using rows of a
+ * tabulated filter weight table. When \c Taps is nonzero, it specifies the
+ * footprint size at compile time so that the loops over pixels are fully
+ * unrolled. The innermost loop updates the contiguous channels of a pixel.
+ */
+template <uint32_t Taps, typename Scalar>
+MI_INLINE void put_tabulated(Scalar *ptr, const Scalar *values,
+                             uint32_t channel_count, uint32_t row_stride,
+                             const Scalar *weights_x, const Scalar *weights_y,
+                             uint32_t count_x = Taps, uint32_t count_y = Taps) {
+    if constexpr (Taps != 0) {
+        count_x = Taps;
+        count_y = Taps;
+    }
+
+    for (uint32_t y = 0; y < count_y; ++y) {
+        Scalar *ptr_row = ptr + y * row_stride;
+
+        for (uint32_t x = 0; x < count_x; ++x) {
+            Scalar weight = weights_x[x] * weights_y[y];
+
+            for (uint32_t k = 0; k < channel_count; ++k)
+                ptr_row[k] = dr::fmadd(values[k], weight, ptr_row[k]);
+
+            ptr_row += channel_count;
+        }
+    }
+}
+
 MI_VARIANT
 ImageBlock<Float, Spectrum>::ImageBlock(const ScalarVector2u &size,
                                         const ScalarPoint2i &offset,
@@ -65,6 +96,62 @@ ImageBlock<Float, Spectrum>::ImageBlock(const TensorXf &tensor,
         m_tensor = TensorXf(tensor.array(), 3, tensor.shape().data());
 }
 
+MI_VARIANT
+ImageBlock<Float, Spectrum>::ImageBlock(Stream *stream)
+    : m_rfilter(nullptr), m_normalize(false), m_coalesce(dr::is_jit_v<Float>),
+      m_compensate(false), m_warn_negative(false), m_warn_invalid(false) {
+    using Array = typename TensorXf::Array;
+
+    uint32_t precision;
+    stream->read(precision);
+    if (precision != (uint32_t) sizeof(ScalarFloat))
+        Throw("ImageBlock(Stream*): precision mismatch (stream uses %u-byte "
+              "floats, expected %u)", precision, (uint32_t) sizeof(ScalarFloat));
+
+    int32_t offset_x, offset_y;
+    uint32_t size_x, size_y;
+    stream->read(offset_x);
+    stream->read(offset_y);
+    stream->read(size_x);
+    stream->read(size_y);
+    stream->read(m_border_size);
+    stream->read(m_channel_count);
+
+    m_offset = ScalarPoint2i(offset_x, offset_y);
+    m_size = ScalarVector2u(size_x, size_y);
+
+    ScalarVector2u size_ext = m_size + 2 * m_border_size;
+
+    size_t size_flat = m_channel_count * dr::prod(size_ext),
+           shape[3]  = { size_ext.y(), size_ext.x(), m_channel_count };
+
+    std::unique_ptr<ScalarFloat[]> data(new ScalarFloat[size_flat]);
+    stream->read_array(data.get(), size_flat);
+
+    m_tensor = TensorXf(dr::load<Array>(data.get(), size_flat), 3, shape);
+}
+
+MI_VARIANT void ImageBlock<Float, Spectrum>::write(Stream *stream) const {
+    stream->write((uint32_t) sizeof(ScalarFloat));
+    stream->write((int32_t) m_offset.x());
+    stream->write((int32_t) m_offset.y());
+    stream->write((uint32_t) m_size.x());
+    stream->write((uint32_t) m_size.y());
+    stream->write(m_border_size);
+    stream->write(m_channel_count);
+
+    ScalarVector2u size_ext = m_size + 2 * m_border_size;
+    size_t size_flat = m_channel_count * dr::prod(size_ext);
+
+    if constexpr (dr::is_jit_v<Float>) {
+        auto &&data = dr::migrate(m_tensor.array(), AllocType::Host);
+        dr::sync_thread();
+        stream->write_array(data.data(), size_flat);
+    } else {
+        stream->write_array(m_tensor.data(), size_flat);
+    }
+}
+
 MI_VARIANT ImageBlock<Float, Spectrum>::~ImageBlock() { }
 
 MI_VARIANT void ImageBlock<Float, Spectrum>::clear() {
@@ -79,6 +166,11 @@ MI_VARIANT void ImageBlock<Float, Spectrum>::clear() {
 
     if (m_compensate)
         m_tensor_compensation = TensorXf(dr::zeros<Array>(size_flat), 3, shape);
+
+    if constexpr (dr::is_jit_v<Float>) {
+        if (m_replicas > 1)
+            m_tensor_replicas = dr::zeros<Float>(size_flat * m_replicas);
+    }
 }
 
 MI_VARIANT void
@@ -98,9 +190,32 @@ ImageBlock<Float, Spectrum>::set_size(const ScalarVector2u &size) {
     if (m_compensate)
         m_tensor_compensation = TensorXf(dr::zeros<Array>(size_flat), 3, shape);
 
+    if constexpr (dr::is_jit_v<Float>) {
+        if (m_replicas > 1)
+            m_tensor_replicas = dr::zeros<Float>(size_flat * m_replicas);
+    }
+
     m_size = size;
 }
 
+MI_VARIANT void ImageBlock<Float, Spectrum>::set_replicas(uint32_t value) {
+    if (value == 0)
+        Throw("ImageBlock::set_replicas(): the number of replicas must be positive!");
+
+    if constexpr (dr::is_jit_v<Float>) {
+        if (value == m_replicas)
+            return;
+
+        // Fold the contents of the current copies into the image
+        tensor();
+
+        m_replicas = value;
+        m_tensor_replicas =
+            value > 1 ? dr::zeros<Float>(m_tensor.array().size() * value)
+                      : Float();
+    }
+}
+
 MI_VARIANT typename ImageBlock<Float, Spectrum>::TensorXf &ImageBlock<Float, Spectrum>::tensor() {
     if constexpr (dr::is_jit_v<Float>) {
         if (m_compensate) {
@@ -108,6 +223,17 @@ MI_VARIANT typename ImageBlock<Float, Spectrum>::TensorXf &ImageBlock<Float, Spe
             m_tensor.array() += comp;
             comp = dr::zeros<Float>(comp.size());
         }
+
+        if (m_replicas > 1 && !m_tensor_replicas.is_literal()) {
+            size_t size_flat = m_tensor.array().size();
+            UInt32 index = dr::arange<UInt32>(size_flat);
+
+            Float &array = m_tensor.array();
+            for (uint32_t i = 0; i < m_replicas; ++i)
+                array += dr::gather<Float>(m_tensor_replicas,
+                                           index + (uint32_t) (i * size_flat));
+            m_tensor_replicas = dr::zeros<Float>(size_flat * m_replicas);
+        }
     }
     return m_tensor;
 }
@@ -116,13 +242,30 @@ MI_VARIANT const typename ImageBlock<Float, Spectrum>::TensorXf &ImageBlock<Floa
     return const_cast<ImageBlock&>(*this).tensor();
 }
 
+MI_VARIANT std::pair<size_t, size_t> ImageBlock<Float, Spectrum>::memory_usage() const {
+    size_t bytes = (dr::width(m_tensor.array()) +
+                    dr::width(m_tensor_compensation.array()) +
+                    (m_replicas > 1 ? dr::width(m_tensor_replicas) : 0)) *
+                   sizeof(ScalarFloat);
+    if constexpr (dr::is_cuda_v<Float>)
+        return { 0, bytes };
+    else
+        return { bytes, 0 };
+}
+
 MI_VARIANT void ImageBlock<Float, Spectrum>::accum(Float value, UInt32 index, Bool active) {
     if constexpr (dr::is_jit_v<Float>) {
         if (m_compensate)
             dr::scatter_reduce_kahan(m_tensor.array(),
                                      m_tensor_compensation.array(),
                                      value, index, active);
-        else
+        else if (m_replicas > 1) {
+            // Lane-dependent copy of the image (see set_replicas())
+            UInt32 lane = dr::arange<UInt32>(dr::width(value, index, active));
+            index += (lane % m_replicas) * (uint32_t) m_tensor.array().size();
+            dr::scatter_reduce(ReduceOp::Add, m_tensor_replicas,
+                               value, index, active);
+        } else
             dr::scatter_reduce(ReduceOp::Add, m_tensor.array(),
                                value, index, active);
     } else {
@@ -257,6 +400,93 @@ MI_VARIANT void ImageBlock<Float, Spectrum>::put(const Point2f &pos,
         }
     }
 
+    // ===================================================================
+    // 0. Tabulated filter weights in scalar variants
+    // ===================================================================
+
+    if constexpr (!JIT) {
+        if (m_rfilter->has_weight_table()) {
+            if (unlikely(!active))
+                return;
+
+            uint32_t taps = m_rfilter->weight_taps();
+            int n = (int) taps / 2;
+
+            // Look up the weight table rows for the subpixel offset
+            Point2i pos_i = dr::floor2int<Point2i>(pos);
+            Point2f frac  = pos - Point2f(pos_i);
+
+            const ScalarFloat *table = m_rfilter->weight_table().data(),
+                              *weights_x = table + m_rfilter->weight_table_row(frac.x()) * taps,
+                              *weights_y = table + m_rfilter->weight_table_row(frac.y()) * taps;
+
+            // Top left pixel of the footprint, and the taps within the buffer
+            ScalarVector2i p0(pos_i - n + ((int) m_border_size - m_offset));
+            ScalarVector2i lo = dr::maximum(-p0, 0),
+                           hi = dr::minimum(ScalarVector2i(size) - p0, (int) taps);
+
+            if (dr::any(lo >= hi))
+                return;
+
+            // Normalize sample contribution if desired
+            if (unlikely(m_normalize)) {
+                ScalarFloat wx = 0.f, wy = 0.f;
+                for (uint32_t i = 0; i < taps; ++i) {
+                    wx += weights_x[i];
+                    wy += weights_y[i];
+                }
+
+                ScalarFloat factor = wx * wy;
+                if (unlikely(factor == 0))
+                    return;
+                factor = dr::rcp(factor);
+
+                ScalarFloat *values_n =
+                    (ScalarFloat *) alloca(sizeof(ScalarFloat) * m_channel_count);
+                for (uint32_t k = 0; k < m_channel_count; ++k)
+                    values_n[k] = values[k] * factor;
+                values = values_n;
+            }
+
+            ScalarFloat *ptr =
+                m_tensor.array().data() +
+                ((size_t) (p0.y() + lo.y()) * size.x() + (p0.x() + lo.x())) *
+                    m_channel_count;
+            uint32_t row_stride = size.x() * m_channel_count;
+
+            weights_x += lo.x();
+            weights_y += lo.y();
+
+            // Use fully unrolled loops when the footprint is not clipped
+            if (dr::all(lo == 0) && dr::all(hi == (int) taps)) {
+                switch (taps) {
+                    case 3:
+                        put_tabulated<3>(ptr, values, m_channel_count,
+                                         row_stride, weights_x, weights_y);
+                        return;
+
+                    case 5:
+                        put_tabulated<5>(ptr, values, m_channel_count,
+                                         row_stride, weights_x, weights_y);
+                        return;
+
+                    case 7:
+                        put_tabulated<7>(ptr, values, m_channel_count,
+                                         row_stride, weights_x, weights_y);
+                        return;
+
+                    default:
+                        break;
+                }
+            }
+
+            put_tabulated<0>(ptr, values, m_channel_count, row_stride,
+                             weights_x, weights_y, (uint32_t) (hi.x() - lo.x()),
+                             (uint32_t) (hi.y() - lo.y()));
+            return;
+        }
+    }
+
     // ===================================================================
     // 1. Non-coalesced accumulation method (see ImageBlock constructor)
     // ===================================================================
@@ -439,6 +669,19 @@ MI_VARIANT void ImageBlock<Float, Spectrum>::put(const Point2f &pos,
         // Evaluate filters weights along the X and Y axes
         Point2f rel_f = Point2f(pos_i) + .5f - pos;
 
+        /* Alternatively, gather them from a tabulated weight table. The
+           table lookup is not differentiable with respect to 'pos'. */
+        bool tabulate = m_rfilter->has_weight_table();
+        if constexpr (dr::is_diff_v<Float>)
+            tabulate = tabulate && !dr::grad_enabled(pos);
+
+        UInt32 row_x, row_y;
+        if (tabulate) {
+            Point2f frac = pos - dr::floor(pos);
+            row_x = m_rfilter->weight_table_row(frac.x()) * count;
+            row_y = m_rfilter->weight_table_row(frac.y()) * count;
+        }
+
         if (!record_loop) {
             // ===========================================================
             // 2.1. Unroll the complete loop
@@ -449,8 +692,14 @@ MI_VARIANT void ImageBlock<Float, Spectrum>::put(const Point2f &pos,
                   *weights_y = (Float *) alloca(sizeof(Float) * count);
 
             for (uint32_t i = 0; i < count; ++i) {
-                Float weight_x = m_rfilter->eval(rel_f.x());
-                Float weight_y = m_rfilter->eval(rel_f.y());
+                Float weight_x, weight_y;
+                if (tabulate) {
+                    weight_x = dr::gather<Float>(m_rfilter->weight_table(), row_x + i, active);
+                    weight_y = dr::gather<Float>(m_rfilter->weight_table(), row_y + i, active);
+                } else {
+                    weight_x = m_rfilter->eval(rel_f.x());
+                    weight_y = m_rfilter->eval(rel_f.y());
+                }
 
                 new (weights_x + i) Float(weight_x);
                 new (weights_y + i) Float(weight_y);
@@ -507,14 +756,18 @@ MI_VARIANT void ImageBlock<Float, Spectrum>::put(const Point2f &pos,
             dr::Loop<Mask> loop_1("ImageBlock::put() [1]", ys, index);
 
             while (loop_1(ys < count)) {
-                Float weight_y = m_rfilter->eval(rel_f.y() + Float(ys));
+                Float weight_y =
+                    tabulate ? dr::gather<Float>(m_rfilter->weight_table(), row_y + ys, active)
+                             : m_rfilter->eval(rel_f.y() + Float(ys));
                 Mask active_1 = active && (y + ys < size.y());
 
                 UInt32 xs = 0;
                 dr::Loop<Mask> loop_2("ImageBlock::put() [2]", xs, index);
 
                 while (loop_2(xs < count)) {
-                    Float weight_x = m_rfilter->eval(rel_f.x() + Float(xs)),
+                    Float weight_x =
+                        tabulate ? dr::gather<Float>(m_rfilter->weight_table(), row_x + xs, active)
+                                 : m_rfilter->eval(rel_f.x() + Float(xs)),
                           weight = weight_x * weight_y;
 
                     Mask active_2 = active_1 && (x + xs < size.x());
@@ -763,6 +1016,7 @@ MI_VARIANT std::string ImageBlock<Float, Spectrum>::to_string() const {
         << "  border_size = " << m_border_size << "," << std::endl
         << "  normalize = " << m_normalize << "," << std::endl
         << "  coalesce = " << m_coalesce << "," << std::endl
+        << "  replicas = " << m_replicas << "," << std::endl
         << "  compensate = " << m_compensate << "," << std::endl
         << "  warn_negative = " << m_warn_negative << "," << std::endl
         << "  warn_invalid = " << m_warn_invalid << "," << std::endl
@@ -1,15 +1,21 @@
+#include <chrono>
 #include <mutex>
 
 #include <drjit/morton.h>
+#include <mitsuba/core/bitmap.h>
 #include <mitsuba/core/fwd.h>
 #include <mitsuba/core/profiler.h>
 #include <mitsuba/core/progress.h>
+#include <mitsuba/core/qmc.h>
+#include <mitsuba/core/random.h>
 #include <mitsuba/core/spectrum.h>
 #include <mitsuba/core/timer.h>
 #include <mitsuba/core/util.h>
 #include <mitsuba/core/fstream.h>
 #include <mitsuba/render/film.h>
 #include <mitsuba/render/integrator.h>
+#include <mitsuba/render/raystats.h>
+#include <mitsuba/render/renderstats.h>
 #include <mitsuba/render/sampler.h>
 #include <mitsuba/render/sensor.h>
 #include <mitsuba/render/spiral.h>
@@ -41,6 +47,65 @@ Integrator<Float, Spectrum>::render(Scene *scene,
                   seed, spp, develop, evaluate);
 }
 
+MI_VARIANT typename Integrator<Float, Spectrum>::TensorXf
+Integrator<Float, Spectrum>::render_ensemble(Scene *scene,
+                                             uint32_t ensemble_size,
+                                             Sensor *sensor,
+                                             uint32_t seed,
+                                             uint32_t spp) {
+    if (ensemble_size == 0)
+        Throw("render_ensemble(): the ensemble size must be positive!");
+
+    std::vector<TensorXf> images;
+    for (uint32_t i = 0; i < ensemble_size; ++i)
+        images.push_back(render(scene, sensor, seed + i, spp, true, true));
+
+    return stack_images(images);
+}
+
+MI_VARIANT typename Integrator<Float, Spectrum>::TensorXf
+Integrator<Float, Spectrum>::render_ensemble(Scene *scene,
+                                             uint32_t ensemble_size,
+                                             uint32_t sensor_index,
+                                             uint32_t seed,
+                                             uint32_t spp) {
+    if (sensor_index >= scene->sensors().size())
+        Throw("Scene::render_ensemble(): sensor index %i is out of bounds!",
+              sensor_index);
+
+    return render_ensemble(scene, ensemble_size,
+                           scene->sensors()[sensor_index].get(), seed, spp);
+}
+
+MI_VARIANT typename Integrator<Float, Spectrum>::TensorXf
+Integrator<Float, Spectrum>::stack_images(const std::vector<TensorXf> &images) {
+    using FloatStorage = DynamicBuffer<Float>;
+    using UInt32Storage = DynamicBuffer<UInt32>;
+
+    const TensorXf &first = images[0];
+    size_t size = dr::width(first.array());
+
+    FloatStorage values = dr::empty<FloatStorage>(size * images.size());
+    for (size_t i = 0; i < images.size(); ++i) {
+        const TensorXf &image = images[i];
+        if (image.ndim() != 3 || image.shape(0) != first.shape(0) ||
+            image.shape(1) != first.shape(1) || image.shape(2) != first.shape(2))
+            Throw("stack_images(): the images must have the same shape!");
+
+        if constexpr (dr::is_jit_v<Float>)
+            dr::scatter(values, image.array(),
+                        dr::arange<UInt32Storage>((uint32_t) size) +
+                            (uint32_t) (i * size));
+        else
+            std::memcpy(values.data() + i * size, image.array().data(),
+                        size * sizeof(ScalarFloat));
+    }
+
+    size_t stacked_shape[4] = { images.size(), first.shape(0), first.shape(1),
+                                first.shape(2) };
+    return TensorXf(values, 4, stacked_shape);
+}
+
 MI_VARIANT typename Integrator<Float, Spectrum>::TensorXf
 Integrator<Float, Spectrum>::render_forward(Scene* scene,
                                             void* /*params*/,
@@ -106,6 +171,10 @@ MI_VARIANT SamplingIntegrator<Float, Spectrum>::SamplingIntegrator(const Propert
         m_block_size = block_size;
     }
 
+    /* Intersect the camera rays of neighboring pixels as packets. Only has
+       an effect in scalar variants. */
+    m_packet_tracing = props.get<bool>("packet_tracing", false);
+
     m_samples_per_pass = props.get<uint32_t>("samples_per_pass", (uint32_t) -1);
     if (m_samples_per_pass != (uint32_t) -1) {
         Log(Warn, "The 'samples_per_pass' is deprecated, as a poor choice of "
@@ -113,6 +182,68 @@ MI_VARIANT SamplingIntegrator<Float, Spectrum>::SamplingIntegrator(const Propert
                   "Please leave it undefined; Mitsuba will then automatically "
                   "choose the necessary number of passes.");
     }
+
+    /* Adaptive sampling: stop sampling a pixel once the relative standard
+       error of its mean luminance falls below this threshold (0: disabled) */
+    m_adaptive_threshold = props.get<ScalarFloat>("adaptive_threshold", 0.f);
+    if (m_adaptive_threshold < 0.f)
+        Throw("\"adaptive_threshold\" must be a positive value (or 0 to disable)");
+
+    // Number of samples per pixel taken between convergence checks
+    m_adaptive_min_spp = props.get<uint32_t>("adaptive_min_spp", 16);
+    if (m_adaptive_min_spp < 2)
+        Throw("\"adaptive_min_spp\" must be at least 2");
+
+    if (m_adaptive_threshold > 0.f && m_packet_tracing)
+        Log(Warn, "Adaptive sampling is not supported in combination with "
+                  "'packet_tracing', all pixels will receive the full sample count.");
+
+    /* Progressive rendering: render the image in passes of this many samples
+       per pixel, each of which is committed to the film (0: disabled) */
+    m_progressive_spp = props.get<uint32_t>("progressive_spp", 0);
+    if (m_progressive_spp > 0 && m_samples_per_pass != (uint32_t) -1)
+        Throw("\"progressive_spp\" and \"samples_per_pass\" cannot be "
+              "specified at the same time.");
+    if (m_progressive_spp > 0 && m_adaptive_threshold > 0.f)
+        Throw("Progressive rendering is not supported in combination with "
+              "adaptive sampling.");
+
+    /* Cache the camera rays and their first intersections for this many
+       deterministic jitter patterns, which successive passes cycle through.
+       Only has an effect in JIT variants (0: disabled) */
+    m_primary_ray_cache = props.get<uint32_t>("primary_ray_cache", 0);
+    if (m_primary_ray_cache > 0) {
+        if constexpr (is_spectral_v<Spectrum>)
+            Throw("\"primary_ray_cache\" is not supported in spectral variants.");
+        if (m_adaptive_threshold > 0.f)
+            Throw("\"primary_ray_cache\" is not supported in combination "
+                  "with adaptive sampling.");
+    }
+
+    // Periodically write the current estimate to disk in progressive mode
+    m_snapshot_interval = props.get<ScalarFloat>("snapshot_interval", 0.f);
+    m_snapshot_path = props.get<std::string>("snapshot_path", "");
+    if (m_snapshot_interval > 0.f) {
+        if (m_progressive_spp == 0)
+            Throw("\"snapshot_interval\" requires progressive rendering "
+                  "(set \"progressive_spp\").");
+        if (m_snapshot_path.empty())
+            Throw("\"snapshot_interval\" requires a \"snapshot_path\".");
+    }
+
+    /* Periodically checkpoint the accumulated film in progressive mode. A
+       later render with the same configuration resumes from the checkpoint */
+    m_checkpoint_interval = props.get<ScalarFloat>("checkpoint_interval", 0.f);
+    m_checkpoint_path = props.get<std::string>("checkpoint_path", "");
+    m_resume = props.get<bool>("resume", true);
+    m_budget_size = 0u;
+    if (m_checkpoint_interval > 0.f || !m_checkpoint_path.empty()) {
+        if (m_progressive_spp == 0)
+            Throw("Checkpoints require progressive rendering (set "
+                  "\"progressive_spp\").");
+        if (m_checkpoint_path.empty())
+            Throw("\"checkpoint_interval\" requires a \"checkpoint_path\".");
+    }
 }
 
 MI_VARIANT SamplingIntegrator<Float, Spectrum>::~SamplingIntegrator() { }
@@ -125,6 +256,7 @@ SamplingIntegrator<Float, Spectrum>::render(Scene *scene,
                                             bool develop,
                                             bool evaluate) {
     ScopedPhase sp(ProfilerPhase::Render);
+    ScopedRenderStats<Float, Spectrum> stats;
     m_stop = false;
 
     // Render on a larger film if the 'high quality edges' feature is enabled
@@ -139,7 +271,11 @@ SamplingIntegrator<Float, Spectrum>::render(Scene *scene,
         sampler->set_sample_count(spp);
     spp = sampler->sample_count();
 
-    uint32_t spp_per_pass = (m_samples_per_pass == (uint32_t) -1)
+    bool progressive = m_progressive_spp > 0;
+
+    uint32_t spp_per_pass = progressive
+                                ? std::min(m_progressive_spp, spp)
+                                : (m_samples_per_pass == (uint32_t) -1)
                                     ? spp
                                     : std::min(m_samples_per_pass, spp);
 
@@ -149,12 +285,38 @@ SamplingIntegrator<Float, Spectrum>::render(Scene *scene,
 
     uint32_t n_passes = spp / spp_per_pass;
 
+    /* Streaming films write finished rows to disk, which requires every pixel
+       to be rendered exactly once and in scanline order */
+    bool streaming = has_flag(film->flags(), FilmFlags::Streaming);
+    if (streaming && (progressive || n_passes > 1))
+        Throw("Streaming films only support single-pass rendering (remove "
+              "the \"samples_per_pass\" and \"progressive_spp\" parameters).");
+
     // Determine output channels and prepare the film with this information
     size_t n_channels = film->prepare(aov_names());
 
     // Start the render timer (used for timeouts & log messages)
     m_render_timer.reset();
 
+    /* In progressive mode, the timeout becomes a time budget that is enforced
+       between passes. Disable it while rendering so that a pass is never
+       interrupted halfway, which would leave the film unevenly sampled. */
+    struct TimeoutRestore {
+        float &timeout, value;
+        ~TimeoutRestore() { timeout = value; }
+    } timeout_restore { m_timeout, m_timeout };
+
+    float budget = m_timeout;
+    if (progressive)
+        m_timeout = -1.f;
+
+    ProgressiveState state;
+    state.seed = seed;
+    state.spp_per_pass = spp_per_pass;
+
+    // Number of passes restored from a checkpoint
+    uint32_t first_pass = 0;
+
     TensorXf result;
     if constexpr (!dr::is_jit_v<Float>) {
         // Render on the CPU using a spiral pattern
@@ -165,8 +327,14 @@ SamplingIntegrator<Float, Spectrum>::render(Scene *scene,
             n_passes > 1 ? tfm::format(" %u passes,", n_passes) : "", n_threads,
             n_threads == 1 ? "" : "s");
 
-        if (m_timeout > 0.f)
-            Log(Info, "Timeout specified: %.2f seconds.", m_timeout);
+        if (budget > 0.f)
+            Log(Info, "%s specified: %.2f seconds.",
+                progressive ? "Time budget" : "Timeout", budget);
+
+        if (has_sample_budget() && m_packet_tracing)
+            Log(Warn, "Sample budgets are not supported in combination with "
+                      "'packet_tracing', all pixels will receive the full "
+                      "sample count.");
 
         // If no block size was specified, find size that is good for parallelization
         uint32_t block_size = m_block_size;
@@ -181,7 +349,22 @@ SamplingIntegrator<Float, Spectrum>::render(Scene *scene,
             }
         }
 
-        Spiral spiral(film_size, film->crop_offset(), block_size, n_passes);
+        /* In progressive mode, passes are rendered one after the other, each
+           by a spiral that only covers a single pass */
+        uint32_t spiral_passes = progressive ? 1 : n_passes,
+                 outer_passes  = progressive ? n_passes : 1;
+
+        Spiral spiral(film_size, film->crop_offset(), block_size, spiral_passes);
+        if (streaming)
+            spiral.set_scanline_order();
+
+        /* Subdivide the blocks rendered last, so that a few expensive blocks
+           don't leave most of the threads idle at the end of the render */
+        if (spiral.block_count() > n_threads)
+            spiral.set_straggler_blocks(n_threads);
+
+        if (progressive)
+            first_pass = read_checkpoint(film, n_passes, state);
 
         std::mutex mutex;
         ref<ProgressReporter> progress;
@@ -190,58 +373,98 @@ SamplingIntegrator<Float, Spectrum>::render(Scene *scene,
             progress = new ProgressReporter("Rendering");
 
         // Total number of blocks to be handled, including multiple passes.
-        uint32_t total_blocks = spiral.block_count() * n_passes,
-                 blocks_done = 0;
+        uint32_t pass_blocks  = spiral.total_block_count(),
+                 total_blocks = pass_blocks * outer_passes,
+                 blocks_done  = pass_blocks * first_pass;
 
-        // Grain size for parallelization
-        uint32_t grain_size = std::max(total_blocks / (4 * n_threads), 1u);
+        // Per-worker block timings (used to report the load balance)
+        std::vector<BlockTimings> timings(n_threads);
 
         // Avoid overlaps in RNG seeding RNG when a seed is manually specified
         seed *= dr::prod(film_size);
 
-        ThreadEnvironment env;
-        dr::parallel_for(
-            dr::blocked_range<uint32_t>(0, total_blocks, grain_size),
-            [&](const dr::blocked_range<uint32_t> &range) {
-                ScopedSetThreadEnvironment set_env(env);
-                // Fork a non-overlapping sampler for the current worker
-                ref<Sampler> sampler = sensor->sampler()->fork();
-
-                ref<ImageBlock> block = film->create_block(
-                    ScalarVector2u(block_size) /* size */,
-                    false /* normalize */,
-                    true /* border */);
-
-                std::unique_ptr<Float[]> aovs(new Float[n_channels]);
-
-                // Render up to 'grain_size' image blocks
-                for (uint32_t i = range.begin();
-                     i != range.end() && !should_stop(); ++i) {
-                    auto [offset, size, block_id] = spiral.next_block();
-                    Assert(dr::prod(size) != 0);
+        RayStatistics::reset();
 
-                    if (film->sample_border())
-                        offset -= film->rfilter()->border_size();
+        ThreadEnvironment env;
+        for (uint32_t pass = first_pass; pass < outer_passes && !should_stop(); ++pass) {
+            if (pass > first_pass)
+                spiral.reset();
+
+            // Decorrelate the random number sequences of progressive passes
+            uint32_t pass_seed =
+                seed + pass * spiral.block_count() * block_size * block_size;
+
+            /* Every worker keeps fetching blocks from the spiral until none
+               are left, which dynamically balances the load between them */
+            dr::parallel_for(
+                dr::blocked_range<uint32_t>(0, n_threads, 1),
+                [&](const dr::blocked_range<uint32_t> &range) {
+                    ScopedSetThreadEnvironment set_env(env);
+                    // Fork a non-overlapping sampler for the current worker
+                    ref<Sampler> sampler = sensor->sampler()->fork();
+
+                    ref<ImageBlock> block = film->create_block(
+                        ScalarVector2u(block_size) /* size */,
+                        false /* normalize */,
+                        true /* border */);
+
+                    std::unique_ptr<Float[]> aovs(new Float[n_channels]);
+                    BlockTimings &worker_timings = timings[range.begin()];
+
+                    while (!should_stop()) {
+                        auto [offset, size, block_id, block_size_] =
+                            spiral.next_block();
+                        if (dr::prod(size) == 0)
+                            break;
+
+                        if (film->sample_border())
+                            offset -= film->rfilter()->border_size();
+
+                        block->set_size(size);
+                        block->set_offset(offset);
+
+                        auto start = std::chrono::steady_clock::now();
+
+                        render_block(scene, sensor, sampler, block, aovs.get(),
+                                     spp_per_pass, pass_seed, block_id,
+                                     block_size_);
+
+                        film->put_block(block);
+
+                        float time = std::chrono::duration<float, std::milli>(
+                            std::chrono::steady_clock::now() - start).count();
+                        worker_timings.add(time);
+
+                        Log(Trace, "Block %u (%ux%u at [%i, %i]) took %s.",
+                            block_id, size.x(), size.y(), offset.x(),
+                            offset.y(), util::time_string(time, true));
+
+                        /* Critical section: update progress bar */
+                        if (progress) {
+                            std::lock_guard<std::mutex> lock(mutex);
+                            blocks_done++;
+                            progress->update(blocks_done / (float) total_blocks);
+                        }
+                    }
+                }
+            );
 
-                    block->set_size(size);
-                    block->set_offset(offset);
+            if (progressive && !progressive_pass_done(film, pass, n_passes,
+                                                      budget, state))
+                break;
 
-                    render_block(scene, sensor, sampler, block, aovs.get(),
-                                 spp_per_pass, seed, block_id, block_size);
+            // Let the next pass benefit from the emitters observed so far
+            scene->update_emitter_cache();
+        }
 
-                    film->put_block(block);
+        log_block_timings(timings);
 
-                    /* Critical section: update progress bar */
-                    if (progress) {
-                        std::lock_guard<std::mutex> lock(mutex);
-                        blocks_done++;
-                        progress->update(blocks_done / (float) total_blocks);
-                    }
-                }
-            }
-        );
+        std::string ray_stats =
+            RayStatistics::report((float) m_render_timer.value());
+        if (!ray_stats.empty())
+            Log(Info, "%s", ray_stats);
 
-        if (develop)
+        if (develop && !streaming)
             result = film->develop();
     } else {
         size_t wavefront_size = (size_t) film_size.x() *
@@ -264,72 +487,182 @@ SamplingIntegrator<Float, Spectrum>::render(Scene *scene,
                 wavefront_size, n_passes);
         }
 
+        state.spp_per_pass = spp_per_pass;
+
         dr::sync_thread(); // Separate from scene initialization (for timings)
 
         Log(Info, "Starting render job (%ux%u, %u sample%s%s)",
             film_size.x(), film_size.y(), spp, spp == 1 ? "" : "s",
             n_passes > 1 ? tfm::format(", %u passes", n_passes) : "");
 
-        if (n_passes > 1 && !evaluate) {
+        /* Sample budgets are handled by the adaptive rendering loop, which
+           compacts the wavefront to the pixels that still require samples */
+        bool adaptive = (m_adaptive_threshold > 0.f || has_sample_budget()) &&
+                        !has_flag(film->flags(), FilmFlags::Special);
+
+        if (adaptive && progressive)
+            Throw("Sample budgets are not supported in combination with "
+                  "progressive rendering in this variant.");
+
+        // Passes may need to be repeated when geometry is paged in
+        GeometryCache<Float, Spectrum> *cache = scene->geometry_cache();
+        if (cache && adaptive)
+            Throw("Sample budgets are not supported in combination with "
+                  "the 'geometry_budget' scene parameter.");
+
+        if (m_primary_ray_cache > 0) {
+            if (adaptive || cache)
+                Throw("\"primary_ray_cache\" is not supported in combination "
+                      "with sample budgets or the 'geometry_budget' scene "
+                      "parameter.");
+            if (sensor->shutter_open_time() > 0.f)
+                Throw("\"primary_ray_cache\" is not supported in combination "
+                      "with motion blur (sensor with a nonzero shutter open "
+                      "time).");
+        }
+
+        if ((n_passes > 1 || adaptive || cache) && !evaluate) {
             Log(Warn, "render(): forcing 'evaluate=true' since multi-pass "
                       "rendering was requested.");
             evaluate = true;
         }
 
-        // Inform the sampler about the passes (needed in vectorized modes)
-        sampler->set_samples_per_wavefront(spp_per_pass);
+        Timer timer;
 
-        // Seed the underlying random number generators, if applicable
-        sampler->seed(seed, (uint32_t) wavefront_size);
+        if (adaptive) {
+            ref<ImageBlock> block = film->create_block();
+            block->set_offset(film->crop_offset());
 
-        // Allocate a large image block that will receive the entire rendering
-        ref<ImageBlock> block = film->create_block();
-        block->set_offset(film->crop_offset());
+            // Samples aren't laid out uniformly, which rules out coalescing
+            block->set_coalesce(false);
 
-        // Only use the ImageBlock coalescing feature when rendering enough samples
-        block->set_coalesce(block->coalesce() && spp_per_pass >= 4);
+            std::unique_ptr<Float[]> aovs(new Float[n_channels]);
+            render_adaptive(scene, sensor, sampler, block, aovs.get(),
+                            film_size, seed, spp);
+            film->put_block(block);
+        } else {
+            // In progressive mode, every pass is committed to the film right away
+            bool commit_passes = progressive && n_passes > 1;
 
-        // Compute discrete sample position
-        UInt32 idx = dr::arange<UInt32>((uint32_t) wavefront_size);
+            if (commit_passes)
+                first_pass = read_checkpoint(film, n_passes, state);
 
-        // Try to avoid a division by an unknown constant if we can help it
-        uint32_t log_spp_per_pass = dr::log2i(spp_per_pass);
-        if ((1u << log_spp_per_pass) == spp_per_pass)
-            idx >>= dr::opaque<UInt32>(log_spp_per_pass);
-        else
-            idx /= dr::opaque<UInt32>(spp_per_pass);
+            /* The sampler state is not part of a checkpoint. A resumed render
+               therefore switches to an unrelated set of random number streams,
+               so that it doesn't repeat the sample sequences of the first one */
+            uint32_t sampler_seed =
+                first_pass > 0 ? sample_tea_32(seed, first_pass).first : seed;
 
-        // Compute the position on the image plane
-        Vector2i pos;
-        pos.y() = idx / film_size[0];
-        pos.x() = dr::fnmadd(film_size[0], pos.y(), idx);
+            // Inform the sampler about the passes (needed in vectorized modes)
+            sampler->set_samples_per_wavefront(spp_per_pass);
 
-        if (film->sample_border())
-            pos -= film->rfilter()->border_size();
+            // Seed the underlying random number generators, if applicable
+            sampler->seed(sampler_seed, (uint32_t) wavefront_size);
+            for (uint32_t i = 0; i < first_pass; ++i)
+                sampler->advance();
 
-        pos += film->crop_offset();
+            // Allocate a large image block that will receive the entire rendering
+            ref<ImageBlock> block = film->create_block();
+            block->set_offset(film->crop_offset());
 
-        // Scale factor that will be applied to ray differentials
-        ScalarFloat diff_scale_factor = dr::rsqrt((ScalarFloat) spp);
+            // Only use the ImageBlock coalescing feature when rendering enough samples
+            block->set_coalesce(block->coalesce() && spp_per_pass >= 4);
 
-        Timer timer;
-        std::unique_ptr<Float[]> aovs(new Float[n_channels]);
+            // Compute discrete sample position
+            UInt32 idx = dr::arange<UInt32>((uint32_t) wavefront_size);
 
-        // Potentially render multiple passes
-        for (size_t i = 0; i < n_passes; i++) {
-            render_sample(scene, sensor, sampler, block, aovs.get(), pos,
-                          diff_scale_factor);
+            // Try to avoid a division by an unknown constant if we can help it
+            uint32_t log_spp_per_pass = dr::log2i(spp_per_pass);
+            if ((1u << log_spp_per_pass) == spp_per_pass)
+                idx >>= dr::opaque<UInt32>(log_spp_per_pass);
+            else
+                idx /= dr::opaque<UInt32>(spp_per_pass);
 
-            if (n_passes > 1) {
-                sampler->advance(); // Will trigger a kernel launch of size 1
-                sampler->schedule_state();
-                dr::eval(block->tensor());
+            // Compute the position on the image plane
+            Vector2i pos;
+            pos.y() = idx / film_size[0];
+            pos.x() = dr::fnmadd(film_size[0], pos.y(), idx);
+
+            if (film->sample_border())
+                pos -= film->rfilter()->border_size();
+
+            pos += film->crop_offset();
+
+            // Scale factor that will be applied to ray differentials
+            ScalarFloat diff_scale_factor = dr::rsqrt((ScalarFloat) spp);
+
+            std::unique_ptr<Float[]> aovs(new Float[n_channels]);
+
+            ref<Sampler> paged_sampler;
+            ref<ImageBlock> pass_block;
+            if (cache) {
+                pass_block = film->create_block();
+                pass_block->set_offset(film->crop_offset());
+                pass_block->set_coalesce(block->coalesce());
+            }
+
+            // Potentially render multiple passes
+            for (uint32_t i = first_pass; i < n_passes; i++) {
+                if (cache) {
+                    /* Repeat the pass with the same random numbers until it
+                       only intersected geometry that is resident on the device */
+                    ref<Sampler> pass_sampler;
+                    while (true) {
+                        pass_sampler = sampler->clone();
+                        pass_block->clear();
+                        cache->begin_pass();
+                        render_sample(scene, sensor, pass_sampler, pass_block,
+                                      aovs.get(), pos, diff_scale_factor);
+                        dr::eval(pass_block->tensor());
+                        if (cache->end_pass())
+                            break;
+                        scene->parameters_changed();
+                    }
+                    paged_sampler = pass_sampler;
+                    sampler = paged_sampler;
+                    block->put_block(pass_block);
+                } else if (m_primary_ray_cache > 0) {
+                    render_sample_cached(scene, sensor, sampler, block,
+                                         aovs.get(), pos, diff_scale_factor,
+                                         spp_per_pass, i);
+                } else {
+                    render_sample(scene, sensor, sampler, block, aovs.get(),
+                                  pos, diff_scale_factor);
+                }
+
+                if (n_passes > 1) {
+                    sampler->advance(); // Will trigger a kernel launch of size 1
+                    sampler->schedule_state();
+
+                    if (commit_passes) {
+                        film->put_block(block);
+                        film->schedule_storage();
+                        dr::eval();
+                        block->clear();
+
+                        if (!progressive_pass_done(film, i, n_passes, budget,
+                                                   state))
+                            break;
+                    } else {
+                        dr::eval(block->tensor());
+                    }
+
+                    // Let the next pass benefit from the emitters observed so far
+                    if (i + 1 < n_passes)
+                        scene->update_emitter_cache();
+                }
             }
+
+            if (!commit_passes)
+                film->put_block(block);
+
+            if (cache)
+                Log(Info, "%s", cache->stats());
         }
 
-        film->put_block(block);
+        bool single_pass = n_passes == 1 && !adaptive;
 
-        if (n_passes == 1 && jit_flag(JitFlag::VCallRecord) &&
+        if (single_pass && jit_flag(JitFlag::VCallRecord) &&
             jit_flag(JitFlag::LoopRecord)) {
             Log(Info, "Computation graph recorded. (took %s)",
                 util::time_string((float) timer.reset(), true));
@@ -345,7 +678,7 @@ SamplingIntegrator<Float, Spectrum>::render(Scene *scene,
         if (evaluate) {
             dr::eval();
 
-            if (n_passes == 1 && jit_flag(JitFlag::VCallRecord) &&
+            if (single_pass && jit_flag(JitFlag::VCallRecord) &&
                 jit_flag(JitFlag::LoopRecord)) {
                 Log(Info, "Code generation finished. (took %s)",
                     util::time_string((float) timer.value(), true));
@@ -366,6 +699,139 @@ SamplingIntegrator<Float, Spectrum>::render(Scene *scene,
     return result;
 }
 
+MI_VARIANT typename SamplingIntegrator<Float, Spectrum>::TensorXf
+SamplingIntegrator<Float, Spectrum>::render_ensemble(Scene *scene,
+                                                     uint32_t ensemble_size,
+                                                     Sensor *sensor,
+                                                     uint32_t seed,
+                                                     uint32_t spp) {
+    if constexpr (!dr::is_jit_v<Float>) {
+        // Blocks are rendered in parallel anyways, render one member at a time
+        return Base::render_ensemble(scene, ensemble_size, sensor, seed, spp);
+    } else {
+        ScopedPhase sp(ProfilerPhase::Render);
+        ScopedRenderStats<Float, Spectrum> stats;
+        m_stop = false;
+
+        if (ensemble_size == 0)
+            Throw("render_ensemble(): the ensemble size must be positive!");
+
+        Film *film = sensor->film();
+        if (has_flag(film->flags(), FilmFlags::Streaming))
+            Throw("render_ensemble(): streaming films are not supported!");
+        if (scene->geometry_cache())
+            Throw("render_ensemble(): not supported in combination with the "
+                  "'geometry_budget' scene parameter.");
+
+        ScalarVector2u crop_size = film->crop_size(), film_size = crop_size;
+        uint32_t border_size = film->rfilter()->border_size();
+        if (film->sample_border())
+            film_size += 2 * border_size;
+
+        Sampler *sampler = sensor->sampler();
+        if (spp)
+            sampler->set_sample_count(spp);
+        spp = sampler->sample_count();
+
+        // All members are rendered by a single wavefront
+        size_t member_size = (size_t) dr::prod(film_size) * (size_t) spp,
+               wavefront_size = member_size * ensemble_size;
+        if (wavefront_size > 0xffffffffu)
+            Throw("render_ensemble(): the ensemble involves %zu Monte Carlo "
+                  "samples, which exceeds the upper limit of 2^32 = 4294967296 "
+                  "for this variant. Please render fewer members or use fewer "
+                  "samples per pixel.", wavefront_size);
+
+        size_t n_channels = film->prepare(aov_names());
+        m_render_timer.reset();
+
+        Log(Info, "Starting ensemble render job (%u x %ux%u, %u sample%s)",
+            ensemble_size, film_size.x(), film_size.y(), spp,
+            spp == 1 ? "" : "s");
+
+        sampler->set_samples_per_wavefront(spp);
+        sampler->seed(seed, (uint32_t) wavefront_size);
+
+        /* The members are stacked vertically within a single image block,
+           separated by rows that absorb the footprint of the reconstruction
+           filter (samples splatted there are discarded) */
+        uint32_t gap = film->sample_border() ? 2 * border_size : border_size,
+                 stride = crop_size.y() + gap;
+        ref<ImageBlock> block = film->create_block(
+            ScalarVector2u(crop_size.x(), stride * ensemble_size - gap),
+            false /* normalize */, false /* border */);
+        block->set_offset(film->crop_offset());
+        block->set_coalesce(block->coalesce() && spp >= 4);
+
+        // Compute the member and the discrete sample position
+        UInt32 idx = dr::arange<UInt32>((uint32_t) wavefront_size);
+
+        uint32_t log_spp = dr::log2i(spp);
+        if ((1u << log_spp) == spp)
+            idx >>= dr::opaque<UInt32>(log_spp);
+        else
+            idx /= dr::opaque<UInt32>(spp);
+
+        uint32_t pixel_count = dr::prod(film_size);
+        UInt32 member = idx / dr::opaque<UInt32>(pixel_count);
+        idx -= member * pixel_count;
+
+        Vector2i pos;
+        pos.y() = idx / film_size[0];
+        pos.x() = dr::fnmadd(film_size[0], pos.y(), idx);
+
+        if (film->sample_border())
+            pos -= border_size;
+
+        pos += film->crop_offset();
+
+        Vector2f splat_offset(0.f, Float(member * stride));
+
+        ScalarFloat diff_scale_factor = dr::rsqrt((ScalarFloat) spp);
+        std::unique_ptr<Float[]> aovs(new Float[n_channels]);
+
+        CameraSample cs = sample_camera_ray(sensor, sampler, pos,
+                                            diff_scale_factor);
+        render_camera_sample(scene, sensor, sampler, block, aovs.get(), pos,
+                             cs, true, &splat_offset);
+
+        // Launch the rendering kernel
+        dr::eval(block->tensor());
+
+        /* Develop the members one after the other. Since the rows of the
+           block are contiguous, each member is a contiguous range */
+        size_t channels = block->channel_count(),
+               values = (size_t) crop_size.x() * crop_size.y() * channels;
+        UInt32 range = dr::arange<UInt32>((uint32_t) values);
+
+        std::vector<TensorXf> images;
+        for (uint32_t i = 0; i < ensemble_size; ++i) {
+            uint32_t offset = (uint32_t) (i * stride * crop_size.x() * channels);
+            size_t shape[3] = { crop_size.y(), crop_size.x(), channels };
+            TensorXf tensor(dr::gather<Float>(block->tensor().array(),
+                                              range + offset), 3, shape);
+
+            ref<ImageBlock> member_block = new ImageBlock(
+                tensor, film->crop_offset(), film->rfilter());
+            film->clear();
+            film->put_block(member_block);
+
+            TensorXf image = film->develop();
+            dr::eval(image);
+            images.push_back(image);
+        }
+
+        TensorXf result = stack_images(images);
+        dr::eval(result);
+        dr::sync_thread();
+
+        Log(Info, "Rendering finished. (took %s)",
+            util::time_string((float) m_render_timer.value(), true));
+
+        return result;
+    }
+}
+
 MI_VARIANT void SamplingIntegrator<Float, Spectrum>::render_block(const Scene *scene,
                                                                    const Sensor *sensor,
                                                                    Sampler *sampler,
@@ -385,6 +851,20 @@ MI_VARIANT void SamplingIntegrator<Float, Spectrum>::render_block(const Scene *s
         // Scale down ray differentials when tracing multiple rays per pixel
         Float diff_scale_factor = dr::rsqrt((Float) sample_count);
 
+        if (m_packet_tracing) {
+            render_block_packet(scene, sensor, sampler, block, aovs,
+                                sample_count, seed, block_size);
+            return;
+        }
+
+        // Track the luminance statistics of each pixel for adaptive sampling
+        bool adaptive = m_adaptive_threshold > 0.f &&
+                        !has_flag(sensor->film()->flags(), FilmFlags::Special);
+
+        bool budget = has_sample_budget() &&
+                      !has_flag(sensor->film()->flags(), FilmFlags::Special);
+        ScalarPoint2i crop_offset(sensor->film()->crop_offset());
+
         // Clear block (it's being reused)
         block->clear();
 
@@ -395,11 +875,32 @@ MI_VARIANT void SamplingIntegrator<Float, Spectrum>::render_block(const Scene *s
             if (dr::any(pos >= block->size()))
                 continue;
 
-            Point2f pos_f = Point2f(Point2i(pos) + block->offset());
-            for (uint32_t j = 0; j < sample_count && !should_stop(); ++j) {
+            Point2i pos_i = Point2i(pos) + block->offset();
+            Point2f pos_f = Point2f(pos_i);
+
+            uint32_t pixel_spp = sample_count;
+            Float pixel_diff_scale_factor = diff_scale_factor;
+            if (budget) {
+                pixel_spp = budget_sample_count(pos_i - crop_offset, sample_count);
+                pixel_diff_scale_factor = dr::rsqrt((Float) pixel_spp);
+            }
+
+            ScalarFloat lum_sum = 0.f, lum_sum_sqr = 0.f;
+            for (uint32_t j = 0; j < pixel_spp && !should_stop(); ++j) {
                 render_sample(scene, sensor, sampler, block, aovs, pos_f,
-                              diff_scale_factor);
+                              pixel_diff_scale_factor);
                 sampler->advance();
+
+                if (adaptive) {
+                    // The first three channels hold the sample's RGB value
+                    Float lum = luminance(Color3f(aovs[0], aovs[1], aovs[2]));
+                    lum_sum += lum;
+                    lum_sum_sqr += lum * lum;
+
+                    if ((j + 1) % m_adaptive_min_spp == 0 &&
+                        adaptive_converged(lum_sum, lum_sum_sqr, j + 1))
+                        break;
+                }
             }
         }
     } else {
@@ -416,6 +917,484 @@ MI_VARIANT void SamplingIntegrator<Float, Spectrum>::render_block(const Scene *s
     }
 }
 
+MI_VARIANT void
+SamplingIntegrator<Float, Spectrum>::render_block_packet(const Scene *scene,
+                                                         const Sensor *sensor,
+                                                         Sampler *sampler,
+                                                         ImageBlock *block,
+                                                         Float *aovs,
+                                                         uint32_t sample_count,
+                                                         uint32_t seed,
+                                                         uint32_t block_size) const {
+    if constexpr (!dr::is_array_v<Float>) {
+        constexpr uint32_t PacketSize = 16;
+
+        uint32_t pixel_count = block_size * block_size;
+        Float diff_scale_factor = dr::rsqrt((Float) sample_count);
+
+        block->clear();
+
+        ref<Sampler> samplers[PacketSize];
+        for (uint32_t k = 0; k < PacketSize; ++k)
+            samplers[k] = sampler->fork();
+
+        Point2f pixels[PacketSize];
+        CameraSample samples[PacketSize];
+        Ray3f rays[PacketSize];
+        PreliminaryIntersection3f pis[PacketSize];
+
+        uint32_t i = 0;
+        while (i < pixel_count && !should_stop()) {
+            // Gather the next group of pixels that lie within the block
+            uint32_t count = 0;
+            for (; i < pixel_count && count < PacketSize; ++i) {
+                Point2u pos = dr::morton_decode<Point2u>(i);
+                if (dr::any(pos >= block->size()))
+                    continue;
+                samplers[count]->seed(seed + i);
+                pixels[count++] = Point2f(Point2i(pos) + block->offset());
+            }
+
+            for (uint32_t j = 0; j < sample_count && !should_stop(); ++j) {
+                for (uint32_t k = 0; k < count; ++k) {
+                    samples[k] = sample_camera_ray(sensor, samplers[k], pixels[k],
+                                                   diff_scale_factor);
+                    rays[k] = Ray3f(samples[k].ray);
+                }
+
+                scene->ray_intersect_preliminary_packet(rays, pis, count);
+
+                // Continue every path in scalar form
+                for (uint32_t k = 0; k < count; ++k) {
+                    scene->set_pending_intersection(&rays[k], &pis[k]);
+                    render_camera_sample(scene, sensor, samplers[k], block, aovs,
+                                         pixels[k], samples[k]);
+                    scene->set_pending_intersection(nullptr);
+                    samplers[k]->advance();
+                }
+            }
+        }
+    } else {
+        DRJIT_MARK_USED(scene);
+        DRJIT_MARK_USED(sensor);
+        DRJIT_MARK_USED(sampler);
+        DRJIT_MARK_USED(block);
+        DRJIT_MARK_USED(aovs);
+        DRJIT_MARK_USED(sample_count);
+        DRJIT_MARK_USED(seed);
+        DRJIT_MARK_USED(block_size);
+        Throw("Not implemented for JIT arrays.");
+    }
+}
+
+MI_VARIANT void
+SamplingIntegrator<Float, Spectrum>::render_adaptive(const Scene *scene,
+                                                     const Sensor *sensor,
+                                                     Sampler *sampler,
+                                                     ImageBlock *block,
+                                                     Float *aovs,
+                                                     const ScalarVector2u &film_size,
+                                                     uint32_t seed,
+                                                     uint32_t spp) const {
+    if constexpr (dr::is_jit_v<Float>) {
+        const Film *film = sensor->film();
+        uint32_t pixel_count = dr::prod(film_size);
+
+        // Scale factor that will be applied to ray differentials
+        ScalarFloat diff_scale_factor = dr::rsqrt((ScalarFloat) spp);
+
+        bool converge = m_adaptive_threshold > 0.f;
+
+        // Per-pixel sum of the luminance and squared luminance of all samples
+        Float lum_sum, lum_sum_sqr;
+        if (converge) {
+            lum_sum     = dr::zeros<Float>(pixel_count);
+            lum_sum_sqr = dr::zeros<Float>(pixel_count);
+        }
+
+        // Number of samples that each pixel receives at most
+        std::vector<uint32_t> pixel_spp;
+        if (has_sample_budget()) {
+            ScalarVector2i border(0);
+            if (film->sample_border())
+                border = ScalarVector2i(film->rfilter()->border_size());
+
+            pixel_spp.resize(pixel_count);
+            for (uint32_t i = 0; i < pixel_count; ++i) {
+                ScalarPoint2i p((int) (i % film_size.x()), (int) (i / film_size.x()));
+                pixel_spp[i] = budget_sample_count(p - border, spp);
+            }
+        }
+
+        /* Pixels that still require samples. All of them have received the
+           same number of samples so far ('spp_done'). */
+        std::vector<uint32_t> active_pixels(pixel_count);
+        for (uint32_t i = 0; i < pixel_count; ++i)
+            active_pixels[i] = i;
+
+        uint32_t spp_done = 0, round = 0;
+        size_t samples_taken = 0;
+
+        while (spp_done < spp && !active_pixels.empty() && !should_stop()) {
+            uint32_t round_spp    = spp - spp_done,
+                     active_count = (uint32_t) active_pixels.size();
+
+            if (converge)
+                round_spp = std::min(round_spp, m_adaptive_min_spp);
+
+            // Don't exceed the budget of any of the active pixels
+            if (!pixel_spp.empty()) {
+                for (uint32_t p : active_pixels)
+                    round_spp = std::min(round_spp, pixel_spp[p] - spp_done);
+            }
+
+            size_t wavefront_size = (size_t) active_count * round_spp;
+
+            if (wavefront_size > 0xffffffffu)
+                Throw("render_adaptive(): the wavefront size exceeds the upper "
+                      "limit of 2^32 samples, try reducing 'adaptive_min_spp'.");
+
+            // Use a different seed in every round to avoid correlations
+            sampler->set_samples_per_wavefront(round_spp);
+            sampler->seed(seed + round, (uint32_t) wavefront_size);
+
+            // Compute the pixel index of every sample in the compacted wavefront
+            UInt32 active_idx = dr::load<UInt32>(active_pixels.data(), active_count),
+                   idx = dr::arange<UInt32>((uint32_t) wavefront_size) /
+                         dr::opaque<UInt32>(round_spp),
+                   pixel_idx = dr::gather<UInt32>(active_idx, idx);
+
+            // Compute the position on the image plane
+            Vector2i pos;
+            pos.y() = pixel_idx / film_size[0];
+            pos.x() = dr::fnmadd(film_size[0], pos.y(), pixel_idx);
+
+            if (film->sample_border())
+                pos -= film->rfilter()->border_size();
+
+            pos += film->crop_offset();
+
+            render_sample(scene, sensor, sampler, block, aovs, pos,
+                          diff_scale_factor);
+
+            if (converge) {
+                // The first three channels hold the sample's RGB value
+                Float lum = dr::detach(luminance(Color3f(aovs[0], aovs[1], aovs[2])));
+                dr::scatter_reduce(ReduceOp::Add, lum_sum, lum, pixel_idx);
+                dr::scatter_reduce(ReduceOp::Add, lum_sum_sqr, lum * lum, pixel_idx);
+                dr::eval(block->tensor(), lum_sum, lum_sum_sqr);
+            } else {
+                dr::eval(block->tensor());
+            }
+
+            spp_done += round_spp;
+            samples_taken += wavefront_size;
+            round++;
+
+            if (spp_done >= spp)
+                break;
+
+            // Remove converged pixels and pixels that exhausted their budget
+            std::vector<ScalarFloat> sum, sum_sqr;
+            if (converge) {
+                auto &&sum_host     = dr::migrate(lum_sum, AllocType::Host);
+                auto &&sum_sqr_host = dr::migrate(lum_sum_sqr, AllocType::Host);
+                dr::sync_thread();
+
+                const ScalarFloat *sum_ptr     = (const ScalarFloat *) sum_host.data(),
+                                  *sum_sqr_ptr = (const ScalarFloat *) sum_sqr_host.data();
+                sum.assign(sum_ptr, sum_ptr + pixel_count);
+                sum_sqr.assign(sum_sqr_ptr, sum_sqr_ptr + pixel_count);
+            }
+
+            size_t remaining = 0;
+            for (size_t i = 0; i < active_pixels.size(); ++i) {
+                uint32_t p = active_pixels[i];
+                if (!pixel_spp.empty() && pixel_spp[p] <= spp_done)
+                    continue;
+                if (converge && adaptive_converged(sum[p], sum_sqr[p], spp_done))
+                    continue;
+                active_pixels[remaining++] = p;
+            }
+            active_pixels.resize(remaining);
+
+            Log(Debug, "Adaptive sampling: %u/%u pixels active after %u samples.",
+                (uint32_t) remaining, pixel_count, spp_done);
+        }
+
+        Log(Info, "Adaptive sampling: %.1f samples per pixel on average (%u rounds).",
+            samples_taken / (double) pixel_count, round);
+    } else {
+        DRJIT_MARK_USED(scene);
+        DRJIT_MARK_USED(sensor);
+        DRJIT_MARK_USED(sampler);
+        DRJIT_MARK_USED(block);
+        DRJIT_MARK_USED(aovs);
+        DRJIT_MARK_USED(film_size);
+        DRJIT_MARK_USED(seed);
+        DRJIT_MARK_USED(spp);
+        Throw("Not implemented for scalar variants.");
+    }
+}
+
+MI_VARIANT void SamplingIntegrator<Float, Spectrum>::log_block_timings(
+    const std::vector<BlockTimings> &timings) const {
+    BlockTimings total;
+    float busy_max = 0.f;
+    for (const BlockTimings &t : timings) {
+        total.count += t.count;
+        total.busy += t.busy;
+        total.max = std::max(total.max, t.max);
+        busy_max = std::max(busy_max, t.busy);
+    }
+
+    if (total.count == 0)
+        return;
+
+    // Ratio of the busiest worker's time to the average (1: perfect balance)
+    float busy_avg  = total.busy / timings.size(),
+          imbalance = busy_avg > 0.f ? busy_max / busy_avg : 1.f;
+
+    Log(Debug, "Block timings: %u blocks, average %s, maximum %s, load "
+               "imbalance %.2f (busiest worker / average).",
+        total.count, util::time_string(total.busy / total.count, true),
+        util::time_string(total.max, true), imbalance);
+}
+
+MI_VARIANT bool
+SamplingIntegrator<Float, Spectrum>::progressive_pass_done(const Film *film,
+                                                           uint32_t pass,
+                                                           uint32_t n_passes,
+                                                           float budget,
+                                                           ProgressiveState &state) const {
+    uint32_t passes_done = pass + 1;
+    if (passes_done == n_passes) {
+        // The render is complete, the checkpoint is no longer needed
+        if (!m_checkpoint_path.empty() && fs::exists(m_checkpoint_path))
+            fs::remove(m_checkpoint_path);
+        return false;
+    }
+
+    bool proceed = !m_stop;
+
+    if (proceed && m_snapshot_interval > 0.f &&
+        state.snapshot_timer.value() > 1000.f * m_snapshot_interval) {
+        // The bitmap is referenced by the asynchronous task until it is written
+        film->bitmap()->write_async(m_snapshot_path);
+        state.snapshot_timer.reset();
+        Log(Debug, "Wrote snapshot after %u/%u passes to \"%s\".",
+            passes_done, n_passes, m_snapshot_path);
+    }
+
+    if (proceed && budget > 0.f) {
+        // Don't start a pass that is expected to exceed the time budget
+        float elapsed   = (float) m_render_timer.value(),
+              pass_time = elapsed / passes_done;
+
+        if (elapsed + pass_time > 1000.f * budget) {
+            Log(Info, "Time budget exhausted after %u/%u passes.",
+                passes_done, n_passes);
+            proceed = false;
+        }
+    }
+
+    // Always checkpoint an unfinished render, so that it can be resumed
+    if (!m_checkpoint_path.empty() &&
+        (!proceed || (m_checkpoint_interval > 0.f &&
+                      state.checkpoint_timer.value() >
+                          1000.f * m_checkpoint_interval))) {
+        write_checkpoint(film, passes_done, n_passes, state);
+        state.checkpoint_timer.reset();
+    }
+
+    return proceed;
+}
+
+NAMESPACE_BEGIN(detail)
+/// Identifies checkpoint files written by SamplingIntegrator::write_checkpoint()
+static const uint32_t kCheckpointMagic = 0x4b43494d; // 'MICK'
+static const uint32_t kCheckpointVersion = 1;
+NAMESPACE_END(detail)
+
+MI_VARIANT void
+SamplingIntegrator<Float, Spectrum>::write_checkpoint(const Film *film,
+                                                      uint32_t passes_done,
+                                                      uint32_t n_passes,
+                                                      const ProgressiveState &state) const {
+    Timer timer;
+    ref<ImageBlock> block =
+        new ImageBlock(film->develop(true /* raw */),
+                       ScalarPoint2i(film->crop_offset()), nullptr, false);
+
+    fs::path path(m_checkpoint_path),
+             tmp_path(m_checkpoint_path + ".tmp");
+
+    /* critical section */ {
+        ref<FileStream> stream = new FileStream(tmp_path, FileStream::ETruncReadWrite);
+        stream->write(detail::kCheckpointMagic);
+        stream->write(detail::kCheckpointVersion);
+        stream->write(std::string(detail::get_variant<Float, Spectrum>()));
+        stream->write(state.seed);
+        stream->write(state.spp_per_pass);
+        stream->write(n_passes);
+        stream->write(passes_done);
+        block->write(stream);
+        stream->close();
+    }
+
+    if (fs::exists(path))
+        fs::remove(path);
+    if (!fs::rename(tmp_path, path))
+        Throw("Could not move the checkpoint to \"%s\"!", path);
+
+    Log(Info, "Wrote checkpoint after %u/%u passes to \"%s\". (took %s)",
+        passes_done, n_passes, path, util::time_string((float) timer.value()));
+}
+
+MI_VARIANT uint32_t
+SamplingIntegrator<Float, Spectrum>::read_checkpoint(Film *film,
+                                                     uint32_t n_passes,
+                                                     const ProgressiveState &state) const {
+    fs::path path(m_checkpoint_path);
+    if (!m_resume || m_checkpoint_path.empty() || !fs::exists(path))
+        return 0;
+
+    uint32_t passes_done = 0;
+    try {
+        ref<FileStream> stream = new FileStream(path);
+
+        uint32_t magic, version, seed, spp_per_pass, passes;
+        std::string variant;
+        stream->read(magic);
+        stream->read(version);
+        if (magic != detail::kCheckpointMagic || version != detail::kCheckpointVersion)
+            Throw("not a checkpoint file (or an unsupported version)");
+
+        stream->read(variant);
+        stream->read(seed);
+        stream->read(spp_per_pass);
+        stream->read(passes);
+        stream->read(passes_done);
+
+        if (variant != detail::get_variant<Float, Spectrum>())
+            Throw("written by variant \"%s\"", variant);
+        if (seed != state.seed || spp_per_pass != state.spp_per_pass ||
+            passes != n_passes)
+            Throw("written with seed=%u, %u passes of %u spp (expected seed=%u, "
+                  "%u passes of %u spp)", seed, passes, spp_per_pass,
+                  state.seed, n_passes, state.spp_per_pass);
+        if (passes_done == 0 || passes_done >= n_passes)
+            Throw("invalid pass count %u", passes_done);
+
+        ref<ImageBlock> block = new ImageBlock(stream.get());
+        if (block->size() != film->crop_size() ||
+            block->offset() != ScalarPoint2i(film->crop_offset()))
+            Throw("covers a different crop window (%s at %s)", block->size(),
+                  block->offset());
+
+        film->put_block(block);
+    } catch (const std::exception &e) {
+        Log(Warn, "Ignoring checkpoint \"%s\" of a different render: %s",
+            path, e.what());
+        film->clear();
+        return 0;
+    }
+
+    Log(Info, "Resuming from checkpoint \"%s\" after %u/%u passes.", path,
+        passes_done, n_passes);
+
+    return passes_done;
+}
+
+MI_VARIANT bool
+SamplingIntegrator<Float, Spectrum>::adaptive_converged(ScalarFloat sum,
+                                                        ScalarFloat sum_sqr,
+                                                        uint32_t sample_count) const {
+    if (sample_count < 2)
+        return false;
+
+    ScalarFloat inv_n    = 1.f / (ScalarFloat) sample_count,
+                mean     = sum * inv_n,
+                variance = std::max(sum_sqr * inv_n - mean * mean, 0.f) *
+                           sample_count / (sample_count - 1.f),
+                std_err  = std::sqrt(variance * inv_n);
+
+    // Small offset to avoid sampling nearly black pixels indefinitely
+    return std_err <= m_adaptive_threshold * (mean + 1e-3f);
+}
+
+MI_VARIANT void
+SamplingIntegrator<Float, Spectrum>::set_sample_budget(const TensorXf &budget) {
+    clear_sample_budget();
+
+    size_t size = budget.array().size();
+    if (size == 0)
+        return;
+
+    if (!(budget.ndim() == 2 || (budget.ndim() == 3 && budget.shape(2) == 1)))
+        Throw("set_sample_budget(): expected a tensor of shape (height, width) "
+              "or (height, width, 1)!");
+
+    m_budget_size = ScalarVector2u((uint32_t) budget.shape(1),
+                                   (uint32_t) budget.shape(0));
+    m_budget.resize(size);
+
+    if constexpr (dr::is_jit_v<Float>) {
+        auto &&data = dr::migrate(budget.array(), AllocType::Host);
+        dr::sync_thread();
+        memcpy(m_budget.data(), data.data(), size * sizeof(ScalarFloat));
+    } else {
+        memcpy(m_budget.data(), budget.data(), size * sizeof(ScalarFloat));
+    }
+
+    for (ScalarFloat &value : m_budget)
+        value = dr::clamp(value, (ScalarFloat) 0, (ScalarFloat) 1);
+}
+
+MI_VARIANT void
+SamplingIntegrator<Float, Spectrum>::set_sample_budget(const ScalarPoint2f &center,
+                                                       ScalarFloat radius,
+                                                       ScalarFloat falloff,
+                                                       ScalarFloat min_fraction) {
+    if (radius < 0.f || falloff < 0.f)
+        Throw("set_sample_budget(): the radius and falloff must be positive!");
+
+    clear_sample_budget();
+    m_budget_roi.center       = center;
+    m_budget_roi.radius       = radius;
+    m_budget_roi.falloff      = falloff;
+    m_budget_roi.min_fraction = dr::clamp(min_fraction, (ScalarFloat) 0, (ScalarFloat) 1);
+}
+
+MI_VARIANT void SamplingIntegrator<Float, Spectrum>::clear_sample_budget() {
+    m_budget.clear();
+    m_budget_size = 0u;
+    m_budget_roi = BudgetROI();
+}
+
+MI_VARIANT uint32_t
+SamplingIntegrator<Float, Spectrum>::budget_sample_count(const ScalarPoint2i &pixel,
+                                                         uint32_t spp) const {
+    ScalarFloat fraction = 1.f;
+
+    if (!m_budget.empty()) {
+        ScalarPoint2u p(dr::clamp(pixel, 0, ScalarPoint2i(m_budget_size) - 1));
+        fraction = m_budget[p.y() * m_budget_size.x() + p.x()];
+    } else if (m_budget_roi.radius >= 0.f) {
+        // Distance between the pixel center and the region of interest
+        ScalarFloat dist = dr::norm(ScalarPoint2f(pixel) + .5f - m_budget_roi.center),
+                    t    = m_budget_roi.falloff > 0.f
+                               ? (dist - m_budget_roi.radius) / m_budget_roi.falloff
+                               : (dist > m_budget_roi.radius ? 1 : 0);
+
+        t = dr::clamp(t, (ScalarFloat) 0, (ScalarFloat) 1);
+        t = t * t * (3.f - 2.f * t); // smoothstep
+        fraction = dr::lerp((ScalarFloat) 1, m_budget_roi.min_fraction, t);
+    }
+
+    return std::max(1u, (uint32_t) dr::round(fraction * spp));
+}
+
 MI_VARIANT void
 SamplingIntegrator<Float, Spectrum>::render_sample(const Scene *scene,
                                                    const Sensor *sensor,
@@ -425,13 +1404,59 @@ SamplingIntegrator<Float, Spectrum>::render_sample(const Scene *scene,
                                                    const Vector2f &pos,
                                                    ScalarFloat diff_scale_factor,
                                                    Mask active) const {
+    CameraSample cs =
+        sample_camera_ray(sensor, sampler, pos, diff_scale_factor, active);
+    render_camera_sample(scene, sensor, sampler, block, aovs, pos, cs, active);
+}
+
+MI_VARIANT std::pair<Spectrum, typename SamplingIntegrator<Float, Spectrum>::Mask>
+SamplingIntegrator<Float, Spectrum>::sample_pixel(const Scene *scene,
+                                                  Sampler *sampler,
+                                                  const RayDifferential3f &ray,
+                                                  const Vector2f & /* pos */,
+                                                  const Medium *medium,
+                                                  Float *aovs,
+                                                  Mask active) const {
+    return sample(scene, sampler, ray, medium, aovs, active);
+}
+
+MI_VARIANT std::pair<Spectrum, typename SamplingIntegrator<Float, Spectrum>::Mask>
+SamplingIntegrator<Float, Spectrum>::sample_from_primary(const Scene *scene,
+                                                         Sampler *sampler,
+                                                         const RayDifferential3f &ray,
+                                                         const SurfaceInteraction3f & /* si */,
+                                                         const Medium *medium,
+                                                         Float *aovs,
+                                                         Mask active) const {
+    return sample(scene, sampler, ray, medium, aovs, active);
+}
+
+MI_VARIANT void SamplingIntegrator<Float, Spectrum>::set_cost_aovs(bool value) {
+    if (value && !has_cost_counters())
+        Throw("%s does not implement the cost counters!", class_()->name());
+    m_cost_aovs = value;
+}
+
+MI_VARIANT std::vector<std::string>
+SamplingIntegrator<Float, Spectrum>::aov_names() const {
+    if (m_cost_aovs)
+        return { "cost.V", "cost.S", "cost.N" };
+    return { };
+}
+
+MI_VARIANT typename SamplingIntegrator<Float, Spectrum>::CameraSample
+SamplingIntegrator<Float, Spectrum>::sample_camera_ray(const Sensor *sensor,
+                                                       Sampler *sampler,
+                                                       const Vector2f &pos,
+                                                       ScalarFloat diff_scale_factor,
+                                                       Mask active) const {
     const Film *film = sensor->film();
-    const bool has_alpha = has_flag(film->flags(), FilmFlags::Alpha);
-    const bool box_filter = film->rfilter()->is_box_filter();
 
     ScalarVector2f scale = 1.f / ScalarVector2f(film->crop_size()),
                    offset = -ScalarVector2f(film->crop_offset()) * scale;
 
+    sampler->set_pixel(Point2u(dr::floor2int<Point2i>(pos)));
+
     Vector2f sample_pos   = pos + sampler->next_2d(active),
              adjusted_pos = dr::fmadd(sample_pos, scale, offset);
 
@@ -453,12 +1478,34 @@ SamplingIntegrator<Float, Spectrum>::render_sample(const Scene *scene,
     if (ray.has_differentials)
         ray.scale_differential(diff_scale_factor);
 
+    if constexpr (!dr::is_jit_v<Float>)
+        MI_RAY_STAT(CameraRays, 1);
+
+    return { sample_pos, ray, ray_weight };
+}
+
+MI_VARIANT void
+SamplingIntegrator<Float, Spectrum>::render_camera_sample(const Scene *scene,
+                                                          const Sensor *sensor,
+                                                          Sampler *sampler,
+                                                          ImageBlock *block,
+                                                          Float *aovs,
+                                                          const Vector2f &pos,
+                                                          const CameraSample &cs,
+                                                          Mask active,
+                                                          const Vector2f *splat_offset) const {
+    const Film *film = sensor->film();
+    const bool has_alpha = has_flag(film->flags(), FilmFlags::Alpha);
+    const bool box_filter = film->rfilter()->is_box_filter();
+
+    const RayDifferential3f &ray = cs.ray;
+    const Vector2f &sample_pos = cs.sample_pos;
     const Medium *medium = sensor->medium();
 
-    auto [spec, valid] = sample(scene, sampler, ray, medium,
+    auto [spec, valid] = sample_pixel(scene, sampler, ray, pos, medium,
                aovs + (has_alpha ? 5 : 4) /* skip R,G,B,[A],W */, active);
 
-    UnpolarizedSpectrum spec_u = unpolarized_spectrum(ray_weight * spec);
+    UnpolarizedSpectrum spec_u = unpolarized_spectrum(cs.ray_weight * spec);
 
     if (unlikely(has_flag(film->flags(), FilmFlags::Special))) {
         film->prepare_sample(spec_u, ray.wavelengths, aovs,
@@ -487,7 +1534,120 @@ SamplingIntegrator<Float, Spectrum>::render_sample(const Scene *scene,
     }
 
     // With box filter, ignore random offset to prevent numerical instabilities
-    block->put(box_filter ? pos : sample_pos, aovs, active);
+    Vector2f splat_pos = box_filter ? pos : sample_pos;
+    if (splat_offset)
+        splat_pos += *splat_offset;
+
+    block->put(splat_pos, aovs, active);
+}
+
+MI_VARIANT void
+SamplingIntegrator<Float, Spectrum>::render_sample_cached(const Scene *scene,
+                                                          const Sensor *sensor,
+                                                          Sampler *sampler,
+                                                          ImageBlock *block,
+                                                          Float *aovs,
+                                                          const Vector2f &pos,
+                                                          ScalarFloat diff_scale_factor,
+                                                          uint32_t spp_per_pass,
+                                                          uint32_t pass) {
+    if constexpr (dr::is_jit_v<Float>) {
+        const Film *film = sensor->film();
+        PrimaryRayCache &cache = m_primary_cache;
+
+        Transform4f to_world = sensor->world_transform();
+        if (cache.scene != scene || cache.sensor != sensor ||
+            cache.crop_offset != film->crop_offset() ||
+            cache.crop_size != film->crop_size() ||
+            cache.spp_per_pass != spp_per_pass ||
+            !dr::all_nested(dr::eq(cache.to_world.matrix, to_world.matrix))) {
+            cache = PrimaryRayCache();
+            cache.scene        = scene;
+            cache.sensor       = sensor;
+            cache.to_world     = to_world;
+            cache.crop_offset  = film->crop_offset();
+            cache.crop_size    = film->crop_size();
+            cache.spp_per_pass = spp_per_pass;
+            cache.samples.resize(m_primary_ray_cache);
+            cache.pi.resize(m_primary_ray_cache);
+            cache.ready.resize(m_primary_ray_cache, false);
+        }
+
+        uint32_t slot = pass % m_primary_ray_cache;
+        if (!cache.ready[slot]) {
+            ScalarVector2f scale = 1.f / ScalarVector2f(film->crop_size()),
+                           offset = -ScalarVector2f(film->crop_offset()) * scale;
+
+            /* All pixels share the same (0, 2)-sequence, whose samples are
+               distributed over the patterns. Random digit scrambling
+               decorrelates the pixels while preserving the stratification. */
+            UInt32 lane = dr::arange<UInt32>((uint32_t) dr::width(pos)),
+                   index = lane % spp_per_pass + slot * spp_per_pass;
+
+            Point2u pixel = dr::reinterpret_array<Point2u>(dr::floor2int<Point2i>(pos));
+            auto [s0, s1] = sample_tea_32(pixel.x(), pixel.y());
+
+            CameraSample &cs = cache.samples[slot];
+            Vector2f jitter(radical_inverse_2(index, s0), sobol_2(index, s1));
+            cs.sample_pos = pos + dr::minimum(jitter, dr::OneMinusEpsilon<Float>);
+            Vector2f adjusted_pos = dr::fmadd(cs.sample_pos, scale, offset);
+
+            // Permute the aperture samples so that they don't depend on the jitter
+            Point2f aperture_sample(.5f);
+            if (sensor->needs_aperture_sample()) {
+                auto [s2, s3] = sample_tea_32(s0, s1);
+                UInt32 index_ap = permute_kensler(
+                    index, m_primary_ray_cache * spp_per_pass, s2);
+                aperture_sample = dr::minimum(
+                    Point2f(radical_inverse_2(index_ap, s2), sobol_2(index_ap, s3)),
+                    dr::OneMinusEpsilon<Float>);
+            }
+
+            std::tie(cs.ray, cs.ray_weight) = sensor->sample_ray_differential(
+                sensor->shutter_open(), 0.f, adjusted_pos, aperture_sample);
+
+            if (cs.ray.has_differentials)
+                cs.ray.scale_differential(diff_scale_factor);
+
+            cache.pi[slot] = scene->ray_intersect_preliminary(cs.ray, true);
+            dr::eval(cs.sample_pos, cs.ray, cs.ray_weight, cache.pi[slot]);
+            cache.ready[slot] = true;
+
+            Log(Debug, "Cached the camera rays of jitter pattern %u.", slot);
+        }
+
+        // Consume the sampler dimensions of sample_camera_ray()
+        sampler->set_pixel(Point2u(dr::floor2int<Point2i>(pos)));
+        sampler->next_2d();
+        if (sensor->needs_aperture_sample())
+            sampler->next_2d();
+
+        const CameraSample &cs = cache.samples[slot];
+        Ray3f ray(cs.ray);
+        scene->set_pending_intersection(&ray, &cache.pi[slot]);
+        try {
+            render_camera_sample(scene, sensor, sampler, block, aovs, pos, cs);
+        } catch (...) {
+            scene->set_pending_intersection(nullptr);
+            throw;
+        }
+        scene->set_pending_intersection(nullptr);
+    } else {
+        DRJIT_MARK_USED(scene);
+        DRJIT_MARK_USED(sensor);
+        DRJIT_MARK_USED(sampler);
+        DRJIT_MARK_USED(block);
+        DRJIT_MARK_USED(aovs);
+        DRJIT_MARK_USED(pos);
+        DRJIT_MARK_USED(diff_scale_factor);
+        DRJIT_MARK_USED(spp_per_pass);
+        DRJIT_MARK_USED(pass);
+        Throw("render_sample_cached(): only supported in JIT variants!");
+    }
+}
+
+MI_VARIANT void SamplingIntegrator<Float, Spectrum>::clear_primary_ray_cache() {
+    m_primary_cache = PrimaryRayCache();
 }
 
 MI_VARIANT std::pair<Spectrum, typename SamplingIntegrator<Float, Spectrum>::Mask>
@@ -537,6 +1697,10 @@ MI_VARIANT AdjointIntegrator<Float, Spectrum>::AdjointIntegrator(const Propertie
     m_max_depth = props.get<int>("max_depth", -1);
     if (m_max_depth < 0 && m_max_depth != -1)
         Throw("\"max_depth\" must be set to -1 (infinite) or a value >= 0");
+
+    m_splat_replicas = props.get<uint32_t>("splat_replicas", 4);
+    if (m_splat_replicas == 0)
+        Throw("\"splat_replicas\" must be set to a value greater than zero!");
 }
 
 MI_VARIANT AdjointIntegrator<Float, Spectrum>::~AdjointIntegrator() { }
@@ -549,6 +1713,7 @@ AdjointIntegrator<Float, Spectrum>::render(Scene *scene,
                                            bool develop,
                                            bool evaluate) {
     ScopedPhase sp(ProfilerPhase::Render);
+    ScopedRenderStats<Float, Spectrum> stats;
     m_stop = false;
 
     Film *film = sensor->film();
@@ -605,8 +1770,9 @@ AdjointIntegrator<Float, Spectrum>::render(Scene *scene,
             n_passes > 1 ? tfm::format(" %d passes,", n_passes) : "", n_threads,
             n_threads == 1 ? "" : "s");
 
-        if (m_timeout > 0.f)
-            Log(Info, "Timeout specified: %.2f seconds.", m_timeout);
+        if (budget > 0.f)
+            Log(Info, "%s specified: %.2f seconds.",
+                progressive ? "Time budget" : "Timeout", budget);
 
         // Split up all samples between threads
         size_t grain_size =
@@ -615,6 +1781,11 @@ AdjointIntegrator<Float, Spectrum>::render(Scene *scene,
         std::mutex mutex;
         ref<ProgressReporter> progress = new ProgressReporter("Rendering");
 
+        /* Image blocks that are not in use by a worker. Each worker splats
+           into its own block, which is reused by later work items of the
+           same thread. All blocks are merged into the film at the end. */
+        std::vector<ref<ImageBlock>> blocks;
+
         size_t total_samples = samples_per_pass * n_passes;
 
         seed *= (uint32_t) total_samples / (uint32_t) grain_size;
@@ -632,15 +1803,23 @@ AdjointIntegrator<Float, Spectrum>::render(Scene *scene,
                 // Fork a non-overlapping sampler for the current worker
                 ref<Sampler> sampler = sensor->sampler()->clone();
 
-                ref<ImageBlock> block = film->create_block(
-                    ScalarVector2u(0) /* use crop size */,
-                    true /* normalize */,
-                    false /* border */);
-
-                block->set_offset(film->crop_offset());
+                ref<ImageBlock> block;
+                /* locked */ {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!blocks.empty()) {
+                        block = blocks.back();
+                        blocks.pop_back();
+                    }
+                }
 
-                // Clear block (it's being reused)
-                block->clear();
+                if (!block) {
+                    block = film->create_block(
+                        ScalarVector2u(0) /* use crop size */,
+                        true /* normalize */,
+                        false /* border */);
+                    block->set_offset(film->crop_offset());
+                    block->clear();
+                }
 
                 sampler->seed(seed +
                               (uint32_t) range.begin() / (uint32_t) grain_size);
@@ -660,15 +1839,18 @@ AdjointIntegrator<Float, Spectrum>::render(Scene *scene,
                 }
                 total_samples += ctr;
 
-                // When all samples are done for this range, commit to the film
+                // Return the block, it is committed to the film at the end
                 /* locked */ {
                     std::lock_guard<std::mutex> lock(mutex);
                     progress->update(samples_done / (ScalarFloat) total_samples);
-                    film->put_block(block);
+                    blocks.push_back(block);
                 }
             }
         );
 
+        for (ImageBlock *block : blocks)
+            film->put_block(block);
+
         if (develop)
             result = film->develop();
     } else {
@@ -716,6 +1898,9 @@ AdjointIntegrator<Float, Spectrum>::render(Scene *scene,
            (they are highly irregular in any particle tracing-based method) */
         block->set_coalesce(false);
 
+        // Spread the atomic writes targeting frequently hit pixels
+        block->set_replicas(m_splat_replicas);
+
         Timer timer;
         for (size_t i = 0; i < n_passes; i++) {
             sample(scene, sensor, sampler, block, sample_scale);
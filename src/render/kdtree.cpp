@@ -1,9 +1,91 @@
 #include <mitsuba/render/kdtree.h>
 #include <mitsuba/render/mesh.h>
 #include <mitsuba/core/properties.h>
+#include <mitsuba/core/fstream.h>
+#include <mitsuba/core/mmap.h>
 
 NAMESPACE_BEGIN(mitsuba)
 
+NAMESPACE_BEGIN(detail)
+
+static const char accel_cache_magic[4] = { 'M', 'I', 'A', 'C' };
+static const uint32_t accel_cache_version = 1;
+
+void accel_cache_write(const fs::path &filename, AccelCacheHeader header,
+                       const void *nodes, const void *indices) {
+    memcpy(header.magic, accel_cache_magic, sizeof(accel_cache_magic));
+    header.version = accel_cache_version;
+    header.padding = 0;
+
+    /* Write to a temporary file first and move it into place afterwards, so
+       that concurrent readers never observe a partially written cache */
+    fs::path tmp_filename = fs::path(filename.string() + ".tmp");
+    try {
+        ref<FileStream> stream =
+            new FileStream(tmp_filename, FileStream::ETruncReadWrite);
+        stream->write(&header, sizeof(AccelCacheHeader));
+        stream->write(nodes, (size_t) header.node_count * header.node_size);
+        stream->write(indices, (size_t) header.index_count * sizeof(uint32_t));
+        stream->close();
+    } catch (const std::exception &e) {
+        Log(Warn, "Could not write acceleration data structure cache \"%s\": %s",
+            filename.string(), e.what());
+        fs::remove(tmp_filename);
+        return;
+    }
+
+    if (!fs::rename(tmp_filename, filename)) {
+        Log(Warn, "Could not move acceleration data structure cache to \"%s\"",
+            filename.string());
+        fs::remove(tmp_filename);
+    }
+}
+
+ref<MemoryMappedFile> accel_cache_read(const fs::path &filename,
+                                       AccelCacheHeader &header,
+                                       const void *&node_data,
+                                       const void *&index_data) {
+    if (!fs::is_regular_file(filename))
+        return nullptr;
+
+    ref<MemoryMappedFile> mmap;
+    try {
+        mmap = new MemoryMappedFile(filename);
+    } catch (const std::exception &e) {
+        Log(Warn, "Could not map acceleration data structure cache \"%s\": %s",
+            filename.string(), e.what());
+        return nullptr;
+    }
+
+    if (mmap->size() < sizeof(AccelCacheHeader))
+        return nullptr;
+
+    AccelCacheHeader file_header;
+    memcpy(&file_header, mmap->data(), sizeof(AccelCacheHeader));
+
+    size_t expected_size = sizeof(AccelCacheHeader) +
+        (size_t) file_header.node_count * file_header.node_size +
+        (size_t) file_header.index_count * sizeof(uint32_t);
+
+    if (memcmp(file_header.magic, accel_cache_magic, sizeof(accel_cache_magic)) != 0 ||
+        file_header.version != accel_cache_version ||
+        file_header.key != header.key ||
+        file_header.node_size != header.node_size ||
+        mmap->size() != expected_size) {
+        Log(Debug, "Ignoring stale acceleration data structure cache \"%s\"",
+            filename.string());
+        return nullptr;
+    }
+
+    header = file_header;
+    const uint8_t *ptr = (const uint8_t *) mmap->data() + sizeof(AccelCacheHeader);
+    node_data  = ptr;
+    index_data = ptr + (size_t) header.node_count * header.node_size;
+    return mmap;
+}
+
+NAMESPACE_END(detail)
+
 template <typename B, typename I, typename C, typename D>
 thread_local typename TShapeKDTree<B, I, C, D>::LocalBuildContext
     TShapeKDTree<B, I, C, D>::BuildTask::m_local = {};
@@ -48,6 +130,12 @@ MI_VARIANT ShapeKDTree<Float, Spectrum>::ShapeKDTree(const Properties &props)
     if (props.has_property("kd_exact_primitive_threshold"))
         set_exact_primitive_threshold(props.get<int>("kd_exact_primitive_threshold"));
 
+    /* kd-tree construction: Memory budget (in MiB) for the temporary edge
+       event lists of the O(n log n) builder. Subtrees that would exceed it
+       are built using min-max binning (default: unlimited) */
+    if (props.has_property("kd_build_memory"))
+        set_build_memory_budget((size_t) props.get<int>("kd_build_memory") * 1024 * 1024);
+
     m_primitive_map.push_back(0);
 }
 
@@ -76,6 +164,53 @@ MI_VARIANT void ShapeKDTree<Float, Spectrum>::build() {
     );
 }
 
+MI_VARIANT bool ShapeKDTree<Float, Spectrum>::read_cache(const fs::path &filename,
+                                                         uint64_t key) {
+    detail::AccelCacheHeader header;
+    header.key = key;
+    header.node_size = (uint32_t) sizeof(KDNode);
+
+    const void *node_data, *index_data;
+    ref<MemoryMappedFile> mmap =
+        detail::accel_cache_read(filename, header, node_data, index_data);
+    if (!mmap)
+        return false;
+
+    m_node_count  = header.node_count;
+    m_index_count = header.index_count;
+    m_nodes.reset(new KDNode[m_node_count]);
+    m_indices.reset(new Index[m_index_count]);
+    memcpy((void *) m_nodes.get(), node_data, m_node_count * sizeof(KDNode));
+    memcpy(m_indices.get(), index_data, m_index_count * sizeof(Index));
+
+    for (size_t i = 0; i < 3; ++i) {
+        m_bbox.min[i] = (ScalarFloat) header.bbox_min[i];
+        m_bbox.max[i] = (ScalarFloat) header.bbox_max[i];
+    }
+
+    Log(Info, "Loaded a SAH kd-tree (%i primitives, %s) from \"%s\"",
+        primitive_count(),
+        util::mem_string(m_index_count * sizeof(Index) +
+                         m_node_count * sizeof(KDNode)),
+        filename.string());
+    return true;
+}
+
+MI_VARIANT void ShapeKDTree<Float, Spectrum>::write_cache(const fs::path &filename,
+                                                          uint64_t key) const {
+    Assert(ready());
+    detail::AccelCacheHeader header;
+    header.key         = key;
+    header.node_size   = (uint32_t) sizeof(KDNode);
+    header.node_count  = m_node_count;
+    header.index_count = m_index_count;
+    for (size_t i = 0; i < 3; ++i) {
+        header.bbox_min[i] = (double) m_bbox.min[i];
+        header.bbox_max[i] = (double) m_bbox.max[i];
+    }
+    detail::accel_cache_write(filename, header, m_nodes.get(), m_indices.get());
+}
+
 MI_VARIANT void ShapeKDTree<Float, Spectrum>::add_shape(Shape *shape) {
     Assert(!ready());
     m_primitive_map.push_back(m_primitive_map.back() +
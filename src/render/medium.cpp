@@ -7,7 +7,9 @@
 
 NAMESPACE_BEGIN(mitsuba)
 
-MI_VARIANT Medium<Float, Spectrum>::Medium() : m_is_homogeneous(false), m_has_spectral_extinction(true) {}
+MI_VARIANT Medium<Float, Spectrum>::Medium()
+    : m_is_homogeneous(false), m_has_spectral_extinction(true),
+      m_transmittance_estimator(TransmittanceEstimator::RatioTracking) {}
 
 MI_VARIANT Medium<Float, Spectrum>::Medium(const Properties &props) : m_id(props.id()) {
 
@@ -27,8 +29,19 @@ MI_VARIANT Medium<Float, Spectrum>::Medium(const Properties &props) : m_id(props
     }
 
     m_sample_emitters = props.get<bool>("sample_emitters", true);
+
+    std::string estimator = props.string("transmittance_estimator", "ratio");
+    if (estimator == "ratio")
+        m_transmittance_estimator = TransmittanceEstimator::RatioTracking;
+    else if (estimator == "residual_ratio")
+        m_transmittance_estimator = TransmittanceEstimator::ResidualRatioTracking;
+    else
+        Throw("Invalid transmittance estimator \"%s\", must be one of: "
+              "\"ratio\" or \"residual_ratio\"!", estimator);
     dr::set_attr(this, "use_emitter_sampling", m_sample_emitters);
     dr::set_attr(this, "phase_function", m_phase_function.get());
+    dr::set_attr(this, "is_emitter", m_is_emitter);
+    dr::set_attr(this, "emitter", m_emitter);
 }
 
 MI_VARIANT Medium<Float, Spectrum>::~Medium() {}
@@ -37,6 +50,33 @@ MI_VARIANT void Medium<Float, Spectrum>::traverse(TraversalCallback *callback) {
     callback->put_object("phase_function", m_phase_function.get(), +ParamFlags::Differentiable);
 }
 
+MI_VARIANT
+typename Medium<Float, Spectrum>::ScalarBoundingBox3f
+Medium<Float, Spectrum>::bbox() const {
+    return ScalarBoundingBox3f();
+}
+
+MI_VARIANT
+typename Medium<Float, Spectrum>::UnpolarizedSpectrum
+Medium<Float, Spectrum>::get_control_extinction(const MediumInteraction3f & /* mi */,
+                                                Mask /* active */) const {
+    return dr::zeros<UnpolarizedSpectrum>();
+}
+
+MI_VARIANT
+typename Medium<Float, Spectrum>::UnpolarizedSpectrum
+Medium<Float, Spectrum>::get_radiance(const MediumInteraction3f & /* mi */,
+                                      Mask /* active */) const {
+    return dr::zeros<UnpolarizedSpectrum>();
+}
+
+MI_VARIANT void Medium<Float, Spectrum>::set_emitter(const Emitter *emitter) {
+    if (m_emitter && m_emitter != emitter)
+        Throw("Only a single emitter can sample the emission of a medium");
+    m_emitter = emitter;
+    dr::set_attr(this, "emitter", m_emitter);
+}
+
 MI_VARIANT
 typename Medium<Float, Spectrum>::MediumInteraction3f
 Medium<Float, Spectrum>::sample_interaction(const Ray3f &ray, Float sample,
@@ -1,4 +1,5 @@
 #include <mitsuba/core/fstream.h>
+#include <mitsuba/core/thread.h>
 #include <mitsuba/core/timer.h>
 #include <mitsuba/core/transform.h>
 #include <mitsuba/core/util.h>
@@ -9,6 +10,12 @@
 #include <mitsuba/render/mesh.h>
 #include <mitsuba/render/records.h>
 #include <mitsuba/render/scene.h>
+#include <drjit/half.h>
+#include <nanothread/nanothread.h>
+#include <array>
+#include <cstring>
+#include <deque>
+#include <unordered_map>
 
 #if defined(MI_ENABLE_EMBREE)
     #include <embree3/rtcore.h>
@@ -29,6 +36,9 @@ MI_VARIANT Mesh<Float, Spectrum>::Mesh(const Properties &props) : Base(props) {
        appearance. Default: ``false`` */
     m_face_normals = props.get<bool>("face_normals", false);
     m_flip_normals = props.get<bool>("flip_normals", false);
+    m_compact_attributes = props.get<bool>("compact_vertex_attributes", false);
+    m_alias_sampling = props.get<bool>("alias_sampling", false);
+    m_opacity_bake_resolution = props.get<uint32_t>("opacity_bake_resolution", 0);
 
     m_discontinuity_types = (uint32_t) DiscontinuityFlags::PerimeterType;
     dr::set_attr(this, "silhouette_discontinuity_types", m_discontinuity_types);
@@ -56,8 +66,19 @@ Mesh<Float, Spectrum>::Mesh(const std::string &name, ScalarSize vertex_count,
 
 MI_VARIANT
 void Mesh<Float, Spectrum>::initialize() {
+    if (m_compact_attributes)
+        compact_vertex_attributes();
+
+    update_motion_keys();
+    if (m_motion_keys > 1 && (m_emitter || m_sensor))
+        Throw("Deforming meshes cannot be emitters or sensors: %s", m_name);
+
+    if (m_opacity_bake_resolution > 0)
+        bake_opacity();
+
 #if defined(MI_ENABLE_LLVM) && !defined(MI_ENABLE_EMBREE)
     m_vertex_positions_ptr = m_vertex_positions.data();
+    m_vertex_motion_positions_ptr = m_vertex_motion_positions.data();
     m_faces_ptr = m_faces.data();
 #endif
     if (m_emitter || m_sensor)
@@ -81,8 +102,11 @@ MI_VARIANT void Mesh<Float, Spectrum>::traverse(TraversalCallback *callback) {
 
     callback->put_parameter("faces",            m_faces,            +ParamFlags::NonDifferentiable);
     callback->put_parameter("vertex_positions", m_vertex_positions, ParamFlags::Differentiable | ParamFlags::Discontinuous);
-    callback->put_parameter("vertex_normals",   m_vertex_normals,   ParamFlags::Differentiable | ParamFlags::Discontinuous);
-    callback->put_parameter("vertex_texcoords", m_vertex_texcoords, +ParamFlags::Differentiable);
+    callback->put_parameter("vertex_motion_positions", m_vertex_motion_positions, +ParamFlags::NonDifferentiable);
+    if (!m_compact_attributes) {
+        callback->put_parameter("vertex_normals",   m_vertex_normals,   ParamFlags::Differentiable | ParamFlags::Discontinuous);
+        callback->put_parameter("vertex_texcoords", m_vertex_texcoords, +ParamFlags::Differentiable);
+    }
 
     // We arbitrarily chose to show all attributes as being differentiable here.
     for (auto &[name, attribute]: m_mesh_attributes)
@@ -102,15 +126,29 @@ MI_VARIANT void Mesh<Float, Spectrum>::parameters_changed(const std::vector<std:
         mesh_attributes_changed = true;
         m_face_count = m_faces.size() / 3;
     }
-    if (has_vertex_normals() && m_vertex_normals.size() != m_vertex_count * 3) {
-        Log(Debug, "parameters_changed(): Vertex normal count changed, updating it.");
-        mesh_attributes_changed = true;
-        m_vertex_normals = dr::zeros<FloatStorage>(m_vertex_count * 3);
-    }
-    if (has_vertex_texcoords() && m_vertex_texcoords.size() != m_vertex_count * 2) {
-        Log(Debug, "parameters_changed(): Vertex count has changed, but no UVs were specified, resetting them.");
-        mesh_attributes_changed = true;
-        m_vertex_texcoords = dr::zeros<FloatStorage>(m_vertex_count * 2);
+    if (m_compact_attributes) {
+        if (has_vertex_normals() && m_vertex_normals_compact.size() != m_vertex_count) {
+            Log(Debug, "parameters_changed(): Vertex normal count changed, updating it.");
+            mesh_attributes_changed = true;
+            m_vertex_normals_compact = DynamicBuffer<UInt32>();
+            m_vertex_normals = dr::zeros<FloatStorage>(m_vertex_count * 3);
+        }
+        if (has_vertex_texcoords() && m_vertex_texcoords_compact.size() != m_vertex_count) {
+            Log(Debug, "parameters_changed(): Vertex count has changed, but no UVs were specified, resetting them.");
+            mesh_attributes_changed = true;
+            m_vertex_texcoords_compact = dr::zeros<DynamicBuffer<UInt32>>(m_vertex_count);
+        }
+    } else {
+        if (has_vertex_normals() && m_vertex_normals.size() != m_vertex_count * 3) {
+            Log(Debug, "parameters_changed(): Vertex normal count changed, updating it.");
+            mesh_attributes_changed = true;
+            m_vertex_normals = dr::zeros<FloatStorage>(m_vertex_count * 3);
+        }
+        if (has_vertex_texcoords() && m_vertex_texcoords.size() != m_vertex_count * 2) {
+            Log(Debug, "parameters_changed(): Vertex count has changed, but no UVs were specified, resetting them.");
+            mesh_attributes_changed = true;
+            m_vertex_texcoords = dr::zeros<FloatStorage>(m_vertex_count * 2);
+        }
     }
     for (auto &[name, attribute]: m_mesh_attributes) {
         size_t expected_size = attribute.size * (attribute.type == MeshAttributeType::Vertex ? m_vertex_count : m_face_count);
@@ -128,11 +166,28 @@ MI_VARIANT void Mesh<Float, Spectrum>::parameters_changed(const std::vector<std:
             build_directed_edges();
     }
 
+    if (m_opacity_bake_resolution > 0 &&
+        (keys.empty() || string::contains(keys, "faces") ||
+         string::contains(keys, "vertex_texcoords") || mesh_attributes_changed))
+        bake_opacity();
+
+    if (keys.empty() || string::contains(keys, "vertex_motion_positions") ||
+        m_vertex_motion_positions.size() != (m_motion_keys - 1) * m_vertex_count * 3) {
+        mesh_attributes_changed = true;
+        update_motion_keys();
+    }
+
     if (keys.empty() || string::contains(keys, "vertex_positions") || mesh_attributes_changed) {
         recompute_bbox();
 
-        if (has_vertex_normals())
+        if (has_vertex_normals()) {
+            // Compact normals are recomputed in floating point and re-encoded
+            if (m_compact_attributes && m_vertex_normals.size() != m_vertex_count * 3)
+                m_vertex_normals = dr::zeros<FloatStorage>(m_vertex_count * 3);
             recompute_vertex_normals();
+            if (m_compact_attributes)
+                compact_vertex_attributes();
+        }
 
         if (!m_area_pmf.empty() || m_emitter || m_sensor)
             build_pmf();
@@ -150,6 +205,7 @@ MI_VARIANT void Mesh<Float, Spectrum>::parameters_changed(const std::vector<std:
 
 #if defined(MI_ENABLE_LLVM) && !defined(MI_ENABLE_EMBREE)
         m_vertex_positions_ptr = m_vertex_positions.data();
+        m_vertex_motion_positions_ptr = m_vertex_motion_positions.data();
         m_faces_ptr = m_faces.data();
 #endif
         mark_dirty();
@@ -183,8 +239,17 @@ Mesh<Float, Spectrum>::bbox(ScalarIndex index) const {
                   v1 = vertex_position(fi[1]),
                   v2 = vertex_position(fi[2]);
 
-    return typename Mesh<Float, Spectrum>::ScalarBoundingBox3f(dr::minimum(dr::minimum(v0, v1), v2),
-                                                               dr::maximum(dr::maximum(v0, v1), v2));
+    ScalarBoundingBox3f result(dr::minimum(dr::minimum(v0, v1), v2),
+                               dr::maximum(dr::maximum(v0, v1), v2));
+
+    // Deforming meshes: bound the triangle over all keyframes
+    for (ScalarSize k = 0; k + 1 < m_motion_keys; ++k) {
+        for (size_t i = 0; i < 3; ++i)
+            result.expand(dr::gather<ScalarPoint3f>(
+                m_vertex_motion_positions, k * m_vertex_count + fi[i]));
+    }
+
+    return result;
 }
 
 
@@ -204,8 +269,11 @@ MI_VARIANT void Mesh<Float, Spectrum>::write_ply(const std::string &filename) co
 
 MI_VARIANT void Mesh<Float, Spectrum>::write_ply(Stream *stream) const {
     auto&& vertex_positions = dr::migrate(m_vertex_positions, AllocType::Host);
-    auto&& vertex_normals   = dr::migrate(m_vertex_normals, AllocType::Host);
-    auto&& vertex_texcoords = dr::migrate(m_vertex_texcoords, AllocType::Host);
+    FloatStorage normals_decoded   = decoded_vertex_normals(),
+                 texcoords_decoded = decoded_vertex_texcoords();
+
+    auto&& vertex_normals   = dr::migrate(normals_decoded, AllocType::Host);
+    auto&& vertex_texcoords = dr::migrate(texcoords_decoded, AllocType::Host);
     auto&& faces = dr::migrate(m_faces, AllocType::Host);
 
     std::vector<std::pair<std::string, MeshAttribute>> vertex_attributes;
@@ -317,6 +385,87 @@ MI_VARIANT void Mesh<Float, Spectrum>::write_ply(Stream *stream) const {
     }
 }
 
+/// Number of blocks used to process \c size elements in parallel
+static size_t parallel_block_count(size_t size) {
+    return std::max<size_t>(
+        1, std::min<size_t>(size / 16384, 4 * Thread::thread_count()));
+}
+
+/**
+ * \brief Stable parallel LSD radix sort of \c keys, where only the lowest
+ * \c key_bits bits are considered. The entries of \c values are permuted
+ * alongside.
+ */
+static void radix_sort(std::vector<uint64_t> &keys,
+                       std::vector<uint32_t> &values,
+                       uint32_t key_bits) {
+    constexpr uint32_t RadixBits = 8, BucketCount = 1u << RadixBits;
+
+    size_t size        = keys.size(),
+           block_count = parallel_block_count(size),
+           block_size  = (size + block_count - 1) / block_count;
+
+    std::vector<uint64_t> keys_tmp(size);
+    std::vector<uint32_t> values_tmp(size);
+    std::vector<size_t> offsets(block_count * BucketCount);
+    ThreadEnvironment env;
+
+    for (uint32_t shift = 0; shift < key_bits; shift += RadixBits) {
+        // 1. Histogram of the current digit within every block
+        dr::parallel_for(
+            dr::blocked_range<size_t>(0, block_count, 1),
+            [&](const dr::blocked_range<size_t> &range) {
+                ScopedSetThreadEnvironment set_env(env);
+                for (size_t b = range.begin(); b != range.end(); ++b) {
+                    size_t *hist = offsets.data() + b * BucketCount;
+                    std::fill(hist, hist + BucketCount, 0);
+                    size_t end = std::min(size, (b + 1) * block_size);
+                    for (size_t i = b * block_size; i < end; ++i)
+                        hist[(keys[i] >> shift) & (BucketCount - 1)]++;
+                }
+            }
+        );
+
+        // 2. Exclusive prefix sum in digit-major order (keeps the sort stable)
+        size_t sum = 0;
+        for (uint32_t d = 0; d < BucketCount; ++d) {
+            for (size_t b = 0; b < block_count; ++b) {
+                size_t count = offsets[b * BucketCount + d];
+                offsets[b * BucketCount + d] = sum;
+                sum += count;
+            }
+        }
+
+        // 3. Scatter the entries of every block to their new position
+        dr::parallel_for(
+            dr::blocked_range<size_t>(0, block_count, 1),
+            [&](const dr::blocked_range<size_t> &range) {
+                ScopedSetThreadEnvironment set_env(env);
+                for (size_t b = range.begin(); b != range.end(); ++b) {
+                    size_t *offset = offsets.data() + b * BucketCount;
+                    size_t end = std::min(size, (b + 1) * block_size);
+                    for (size_t i = b * block_size; i < end; ++i) {
+                        size_t j = offset[(keys[i] >> shift) & (BucketCount - 1)]++;
+                        keys_tmp[j]   = keys[i];
+                        values_tmp[j] = values[i];
+                    }
+                }
+            }
+        );
+
+        keys.swap(keys_tmp);
+        values.swap(values_tmp);
+    }
+}
+
+/// Number of bits needed to represent the indices of \c count elements
+static uint32_t index_bits(size_t count) {
+    uint32_t bits = 1;
+    while (bits < 32 && (1ull << bits) < count)
+        bits++;
+    return bits;
+}
+
 MI_VARIANT void Mesh<Float, Spectrum>::recompute_vertex_normals() {
     if (!has_vertex_normals())
         Throw("Storing new normals in a Mesh that didn't have normals at "
@@ -326,52 +475,96 @@ MI_VARIANT void Mesh<Float, Spectrum>::recompute_vertex_normals() {
        by Grit Thuermer and Charles A. Wuethrich, JGT 1998, Vol 3 */
 
     if constexpr (!dr::is_dynamic_v<Float>) {
-        size_t invalid_counter = 0;
-        std::vector<InputNormal3f> normals(m_vertex_count, dr::zeros<InputNormal3f>());
-
-        for (ScalarSize i = 0; i < m_face_count; ++i) {
-            auto fi = face_indices(i);
-            Assert(fi[0] < m_vertex_count &&
-                   fi[1] < m_vertex_count &&
-                   fi[2] < m_vertex_count);
-
-            InputPoint3f v[3] = { vertex_position(fi[0]),
-                                  vertex_position(fi[1]),
-                                  vertex_position(fi[2]) };
-
-            InputVector3f side_0 = v[1] - v[0],
-                          side_1 = v[2] - v[0];
-            InputNormal3f n = dr::cross(side_0, side_1);
-            InputFloat length_sqr = dr::squared_norm(n);
-            if (likely(length_sqr > 0)) {
-                n *= dr::rsqrt(length_sqr);
-
-                // Use DrJit to compute the face angles at the same time
-                auto side1 = transpose(dr::Array<dr::Packet<InputFloat, 3>, 3>{ side_0, v[2] - v[1], v[0] - v[2] });
-                auto side2 = transpose(dr::Array<dr::Packet<InputFloat, 3>, 3>{ side_1, v[0] - v[1], v[1] - v[2] });
-                InputVector3f face_angles = unit_angle(dr::normalize(side1), dr::normalize(side2));
-
-                for (size_t j = 0; j < 3; ++j)
-                    normals[fi[j]] += n * face_angles[j];
-            }
-        }
+        size_t corner_count = (size_t) m_face_count * 3,
+               block_count  = parallel_block_count(m_face_count),
+               block_size   = (m_face_count + block_count - 1) / block_count;
+
+        /* 1. Compute the angle-weighted face normal contributed by every
+              corner, and key the corner by its vertex index */
+        std::vector<InputNormal3f> contribution(corner_count);
+        std::vector<uint64_t> keys(corner_count);
+        std::vector<uint32_t> corners(corner_count);
+        ThreadEnvironment env;
+
+        dr::parallel_for(
+            dr::blocked_range<size_t>(0, m_face_count, block_size),
+            [&](const dr::blocked_range<size_t> &range) {
+                ScopedSetThreadEnvironment set_env(env);
+                for (size_t i = range.begin(); i != range.end(); ++i) {
+                    auto fi = face_indices((ScalarIndex) i);
+                    Assert(fi[0] < m_vertex_count &&
+                           fi[1] < m_vertex_count &&
+                           fi[2] < m_vertex_count);
+
+                    InputPoint3f v[3] = { vertex_position(fi[0]),
+                                          vertex_position(fi[1]),
+                                          vertex_position(fi[2]) };
+
+                    InputVector3f side_0 = v[1] - v[0],
+                                  side_1 = v[2] - v[0];
+                    InputNormal3f n = dr::cross(side_0, side_1);
+                    InputFloat length_sqr = dr::squared_norm(n);
+                    InputVector3f face_angles = 0.f;
+                    if (likely(length_sqr > 0)) {
+                        n *= dr::rsqrt(length_sqr);
+
+                        // Use DrJit to compute the face angles at the same time
+                        auto side1 = transpose(dr::Array<dr::Packet<InputFloat, 3>, 3>{ side_0, v[2] - v[1], v[0] - v[2] });
+                        auto side2 = transpose(dr::Array<dr::Packet<InputFloat, 3>, 3>{ side_1, v[0] - v[1], v[1] - v[2] });
+                        face_angles = unit_angle(dr::normalize(side1), dr::normalize(side2));
+                    } else {
+                        n = 0.f;
+                    }
 
-        for (ScalarSize i = 0; i < m_vertex_count; i++) {
-            InputNormal3f n = normals[i];
-            InputFloat length = dr::norm(n);
-            if (likely(length != 0.f)) {
-                n /= length;
-            } else {
-                n = InputNormal3f(1, 0, 0); // Choose some bogus value
-                invalid_counter++;
+                    for (size_t j = 0; j < 3; ++j) {
+                        contribution[3 * i + j] = n * face_angles[j];
+                        keys[3 * i + j]         = fi[j];
+                        corners[3 * i + j]      = (uint32_t) (3 * i + j);
+                    }
+                }
             }
+        );
+
+        /* 2. Group the corners by vertex. The sort is stable, hence the
+              contributions are accumulated in the order of the faces. */
+        radix_sort(keys, corners, index_bits(m_vertex_count));
+
+        // 3. Accumulate and normalize the contributions of every vertex
+        std::atomic<size_t> invalid_counter(0);
+        block_count = parallel_block_count(m_vertex_count);
+        block_size  = (m_vertex_count + block_count - 1) / block_count;
+
+        dr::parallel_for(
+            dr::blocked_range<size_t>(0, m_vertex_count, block_size),
+            [&](const dr::blocked_range<size_t> &range) {
+                ScopedSetThreadEnvironment set_env(env);
+                size_t pos = std::lower_bound(keys.begin(), keys.end(),
+                                              (uint64_t) range.begin()) - keys.begin(),
+                       invalid = 0;
+
+                for (size_t i = range.begin(); i != range.end(); ++i) {
+                    InputNormal3f n = dr::zeros<InputNormal3f>();
+                    for (; pos < corner_count && keys[pos] == i; ++pos)
+                        n += contribution[corners[pos]];
+
+                    InputFloat length = dr::norm(n);
+                    if (likely(length != 0.f)) {
+                        n /= length;
+                    } else {
+                        n = InputNormal3f(1, 0, 0); // Choose some bogus value
+                        invalid++;
+                    }
 
-            dr::store(m_vertex_normals.data() + 3 * i, n);
-        }
+                    dr::store(m_vertex_normals.data() + 3 * i, n);
+                }
+
+                invalid_counter += invalid;
+            }
+        );
 
         if (invalid_counter > 0)
             Log(Warn, "\"%s\": computed vertex normals (%i invalid vertices!)",
-                m_name, invalid_counter);
+                m_name, (size_t) invalid_counter);
     } else {
         // The following is JITed into two separate kernel launches
 
@@ -413,6 +606,142 @@ MI_VARIANT void Mesh<Float, Spectrum>::recompute_vertex_normals() {
     }
 }
 
+/// Octahedral encoding of a unit vector using 2x16 bit fixed point
+template <typename Normal3>
+static uint32_t encode_octahedral(const Normal3 &n_) {
+    Normal3 n = n_ / (dr::abs(n_.x()) + dr::abs(n_.y()) + dr::abs(n_.z()));
+    float x = n.x(), y = n.y();
+
+    // Fold the lower hemisphere onto the upper one
+    if (n.z() < 0.f) {
+        float fx = (1.f - dr::abs(y)) * (x >= 0.f ? 1.f : -1.f),
+              fy = (1.f - dr::abs(x)) * (y >= 0.f ? 1.f : -1.f);
+        x = fx;
+        y = fy;
+    }
+
+    auto quantize = [](float v) {
+        return (uint32_t) dr::clamp(dr::round((v * .5f + .5f) * 65535.f), 0.f, 65535.f);
+    };
+
+    return quantize(x) | (quantize(y) << 16);
+}
+
+MI_VARIANT void Mesh<Float, Spectrum>::compact_vertex_attributes() {
+    if (dr::width(m_vertex_normals) != 0) {
+        auto&& vertex_normals = dr::migrate(m_vertex_normals, AllocType::Host);
+        if constexpr (dr::is_jit_v<Float>)
+            dr::sync_thread();
+
+        const InputFloat *ptr = vertex_normals.data();
+        std::unique_ptr<uint32_t[]> packed(new uint32_t[m_vertex_count]);
+        for (size_t i = 0; i < m_vertex_count; ++i)
+            packed[i] = encode_octahedral(dr::load<InputNormal3f>(ptr + 3 * i));
+
+        m_vertex_normals_compact =
+            dr::load<DynamicBuffer<UInt32>>(packed.get(), m_vertex_count);
+        m_vertex_normals = FloatStorage();
+    }
+
+    if (dr::width(m_vertex_texcoords) != 0) {
+        auto&& vertex_texcoords = dr::migrate(m_vertex_texcoords, AllocType::Host);
+        if constexpr (dr::is_jit_v<Float>)
+            dr::sync_thread();
+
+        const InputFloat *ptr = vertex_texcoords.data();
+        std::unique_ptr<uint32_t[]> packed(new uint32_t[m_vertex_count]);
+        for (size_t i = 0; i < m_vertex_count; ++i)
+            packed[i] = (uint32_t) dr::half::float32_to_float16(ptr[2 * i]) |
+                        ((uint32_t) dr::half::float32_to_float16(ptr[2 * i + 1]) << 16);
+
+        m_vertex_texcoords_compact =
+            dr::load<DynamicBuffer<UInt32>>(packed.get(), m_vertex_count);
+        m_vertex_texcoords = FloatStorage();
+    }
+}
+
+MI_VARIANT typename Mesh<Float, Spectrum>::FloatStorage
+Mesh<Float, Spectrum>::decoded_vertex_normals() const {
+    if (!m_compact_attributes || !has_vertex_normals())
+        return m_vertex_normals;
+
+    FloatStorage result = dr::zeros<FloatStorage>(m_vertex_count * 3);
+    if constexpr (dr::is_jit_v<Float>) {
+        UInt32 index = dr::arange<UInt32>(m_vertex_count);
+        auto n = vertex_normal(index);
+        for (size_t i = 0; i < 3; ++i)
+            dr::scatter(result, n[i], index * 3 + (uint32_t) i);
+        dr::eval(result);
+    } else {
+        for (ScalarIndex i = 0; i < m_vertex_count; ++i)
+            dr::store(result.data() + 3 * i, vertex_normal(i));
+    }
+    return result;
+}
+
+MI_VARIANT typename Mesh<Float, Spectrum>::FloatStorage
+Mesh<Float, Spectrum>::decoded_vertex_texcoords() const {
+    if (!m_compact_attributes || !has_vertex_texcoords())
+        return m_vertex_texcoords;
+
+    FloatStorage result = dr::zeros<FloatStorage>(m_vertex_count * 2);
+    if constexpr (dr::is_jit_v<Float>) {
+        UInt32 index = dr::arange<UInt32>(m_vertex_count);
+        auto uv = vertex_texcoord(index);
+        for (size_t i = 0; i < 2; ++i)
+            dr::scatter(result, uv[i], index * 2 + (uint32_t) i);
+        dr::eval(result);
+    } else {
+        for (ScalarIndex i = 0; i < m_vertex_count; ++i)
+            dr::store(result.data() + 2 * i, vertex_texcoord(i));
+    }
+    return result;
+}
+
+MI_VARIANT std::pair<typename Mesh<Float, Spectrum>::ScalarVector3f,
+                     typename Mesh<Float, Spectrum>::ScalarFloat>
+Mesh<Float, Spectrum>::normal_bounds() const {
+    if (m_face_count == 0)
+        return Base::normal_bounds();
+
+    auto&& vertex_positions = dr::migrate(m_vertex_positions, AllocType::Host);
+    auto&& faces = dr::migrate(m_faces, AllocType::Host);
+    if constexpr (dr::is_jit_v<Float>)
+        dr::sync_thread();
+
+    const InputFloat *pos_p = vertex_positions.data();
+    const ScalarIndex *idx_p = faces.data();
+
+    auto face_normal = [&](ScalarIndex f) {
+        ScalarPoint3u fi = dr::load<ScalarPoint3u>(idx_p + 3 * f);
+        ScalarPoint3f p0 = dr::load<ScalarPoint3f>(pos_p + 3 * fi[0]),
+                      p1 = dr::load<ScalarPoint3f>(pos_p + 3 * fi[1]),
+                      p2 = dr::load<ScalarPoint3f>(pos_p + 3 * fi[2]);
+        return dr::cross(p1 - p0, p2 - p0);
+    };
+
+    /* Use the area-weighted average normal as axis, and the largest angle to
+       any face normal as half-angle. This cone is not minimal, but it's tight
+       for the (near-)planar meshes commonly used as area lights. */
+    ScalarVector3f axis(0.f);
+    for (ScalarIndex f = 0; f < m_face_count; ++f)
+        axis += face_normal(f);
+
+    if (!(dr::norm(axis) > 0.f))
+        return Base::normal_bounds();
+    axis = dr::normalize(axis);
+
+    ScalarFloat cos_theta = 1.f;
+    for (ScalarIndex f = 0; f < m_face_count; ++f) {
+        ScalarVector3f n = face_normal(f);
+        ScalarFloat length = dr::norm(n);
+        if (length > 0.f)
+            cos_theta = dr::minimum(cos_theta, dr::dot(axis, n) / length);
+    }
+
+    return { axis, dr::safe_acos(cos_theta) };
+}
+
 MI_VARIANT void Mesh<Float, Spectrum>::recompute_bbox() {
     auto&& vertex_positions = dr::migrate(m_vertex_positions, AllocType::Host);
     if constexpr (dr::is_jit_v<Float>)
@@ -424,6 +753,139 @@ MI_VARIANT void Mesh<Float, Spectrum>::recompute_bbox() {
     for (ScalarSize i = 0; i < m_vertex_count; ++i)
         m_bbox.expand(
             ScalarPoint3f(ptr[3 * i + 0], ptr[3 * i + 1], ptr[3 * i + 2]));
+
+    // Deforming meshes: expand the bounds over all keyframes
+    if (m_motion_keys > 1) {
+        auto&& motion_positions = dr::migrate(m_vertex_motion_positions, AllocType::Host);
+        if constexpr (dr::is_jit_v<Float>)
+            dr::sync_thread();
+
+        const InputFloat *motion_ptr = motion_positions.data();
+        for (size_t i = 0; i < (size_t) (m_motion_keys - 1) * m_vertex_count; ++i)
+            m_bbox.expand(ScalarPoint3f(motion_ptr[3 * i + 0], motion_ptr[3 * i + 1],
+                                        motion_ptr[3 * i + 2]));
+    }
+}
+
+MI_VARIANT void Mesh<Float, Spectrum>::update_motion_keys() {
+    size_t size = m_vertex_motion_positions.size(),
+           key_size = (size_t) m_vertex_count * 3;
+
+    if (size > 0 && (key_size == 0 || size % key_size != 0))
+        Throw("Mesh \"%s\": the size of the vertex keyframe buffer (%zu) must "
+              "be a multiple of the size of the vertex position buffer (%zu)!",
+              m_name, size, key_size);
+
+    m_motion_keys = (ScalarSize) (1 + (key_size ? size / key_size : 0));
+}
+
+MI_VARIANT void Mesh<Float, Spectrum>::migrate_buffers(AllocType type) {
+    if constexpr (dr::is_jit_v<Float>) {
+        auto migrate = [type](auto &buf) {
+            if (buf.size() > 0)
+                buf = dr::migrate(buf, type);
+        };
+
+        migrate(m_vertex_positions);
+        migrate(m_vertex_motion_positions);
+        migrate(m_vertex_normals);
+        migrate(m_vertex_texcoords);
+        migrate(m_vertex_normals_compact);
+        migrate(m_vertex_texcoords_compact);
+        migrate(m_faces);
+        migrate(m_accel_faces);
+        migrate(m_E2E);
+        for (auto &[name, attribute] : m_mesh_attributes)
+            migrate(attribute.buf);
+
+#if defined(MI_ENABLE_LLVM) && !defined(MI_ENABLE_EMBREE)
+        m_vertex_positions_ptr = m_vertex_positions.data();
+        m_vertex_motion_positions_ptr = m_vertex_motion_positions.data();
+        m_faces_ptr = m_faces.data();
+#endif
+
+        dr::sync_thread();
+        mark_dirty();
+    } else {
+        DRJIT_MARK_USED(type);
+    }
+}
+
+MI_VARIANT void Mesh<Float, Spectrum>::bake_opacity() {
+    m_accel_faces = DynamicBuffer<UInt32>();
+
+    /* Only consider (partially) transparent BSDFs. The null BSDFs of medium
+       transitions, emitters and sensors must remain intersectable. */
+    if (m_opacity_bake_resolution == 0 || m_face_count == 0 || !m_bsdf ||
+        !has_flag(m_bsdf->flags(), BSDFFlags::Null) || m_emitter || m_sensor ||
+        is_medium_transition())
+        return;
+
+    dr::suspend_grad<Float> scope;
+    uint32_t res = m_opacity_bake_resolution;
+
+    // Is the BSDF transparent at all grid points of the given triangle(s)?
+    auto is_transparent = [&](const UInt32 &face) {
+        Ray3f ray(Point3f(0.f), Vector3f(0.f, 0.f, 1.f));
+        Mask transparent = true;
+
+        for (uint32_t i = 0; i <= res; ++i) {
+            for (uint32_t j = 0; i + j <= res; ++j) {
+                PreliminaryIntersection3f pi =
+                    dr::zeros<PreliminaryIntersection3f>();
+                pi.t = 0.f;
+                pi.prim_uv = Point2f(i / (ScalarFloat) res, j / (ScalarFloat) res);
+                pi.prim_index = face;
+
+                SurfaceInteraction3f si =
+                    compute_surface_interaction(ray, pi, +RayFlags::All, 0);
+                si.wi = Vector3f(0.f, 0.f, 1.f);
+                if constexpr (is_spectral_v<Spectrum>)
+                    si.wavelengths = Wavelength(550.f);
+
+                UnpolarizedSpectrum value = unpolarized_spectrum(
+                    m_bsdf->eval_null_transmission(si));
+                transparent &= dr::all(value >= 1.f);
+            }
+        }
+
+        return transparent;
+    };
+
+    std::vector<uint8_t> transparent(m_face_count);
+    if constexpr (dr::is_jit_v<Float>) {
+        UInt32 flags = dr::select(
+            is_transparent(dr::arange<UInt32>(m_face_count)), 1u, 0u);
+        auto &&flags_host = dr::migrate(flags, AllocType::Host);
+        dr::sync_thread();
+        for (ScalarIndex f = 0; f < m_face_count; ++f)
+            transparent[f] = flags_host.data()[f] != 0;
+    } else {
+        for (ScalarIndex f = 0; f < m_face_count; ++f)
+            transparent[f] = is_transparent(f);
+    }
+
+    auto &&faces = dr::migrate(m_faces, AllocType::Host);
+    if constexpr (dr::is_jit_v<Float>)
+        dr::sync_thread();
+
+    std::vector<ScalarIndex> accel_faces(faces.data(),
+                                         faces.data() + m_face_count * 3);
+    ScalarSize removed = 0;
+    for (ScalarIndex f = 0; f < m_face_count; ++f) {
+        if (!transparent[f])
+            continue;
+        // Degenerate triangles are never intersected
+        accel_faces[3 * f + 1] = accel_faces[3 * f + 2] = accel_faces[3 * f];
+        removed++;
+    }
+
+    Log(Debug, "Mesh \"%s\": excluded %u/%u fully transparent triangles from "
+        "the acceleration data structure", m_name, removed, m_face_count);
+
+    if (removed > 0)
+        m_accel_faces = dr::load<DynamicBuffer<UInt32>>(accel_faces.data(),
+                                                        accel_faces.size());
 }
 
 MI_VARIANT void Mesh<Float, Spectrum>::build_pmf() {
@@ -466,6 +928,9 @@ MI_VARIANT void Mesh<Float, Spectrum>::build_pmf() {
 
         m_area_pmf = DiscreteDistribution<Float>(dr::detach(face_surface_area));
     }
+
+    if (m_alias_sampling)
+        m_area_pmf.set_alias_table(true);
 }
 
 MI_VARIANT void Mesh<Float, Spectrum>::build_directed_edges() {
@@ -478,82 +943,101 @@ MI_VARIANT void Mesh<Float, Spectrum>::build_directed_edges() {
     if constexpr (dr::is_array_v<Float>)
         dr::sync_thread();
 
-    std::vector<ScalarIndex> V2E(m_vertex_count, m_invalid_dedge);
-    std::vector<ScalarIndex> E2E(m_face_count * 3, m_invalid_dedge);
-
-    /* For an edge e1 = (v1, v2), tmp is defined as:
-    /     tmp[e1].first  = v2,
-    /     tmp[e1].second = (next edge e_k that also starts from v1) or (m_invalid_dedge)
-    */
-    std::vector<std::pair<ScalarIndex, ScalarIndex>> tmp(m_face_count * 3);
+    size_t dedge_count = (size_t) m_face_count * 3,
+           block_count = parallel_block_count(m_face_count),
+           block_size  = (m_face_count + block_count - 1) / block_count;
+    uint32_t vertex_bits = index_bits(m_vertex_count);
 
-    // 1. Fill `tmp` and `V2E`
     const ScalarIndex *face_data = faces.data();
-    for (ScalarIndex f = 0; f < m_face_count; f++) {
-        ScalarPoint3u triangle_indices =
-            dr::load<ScalarPoint3u>(face_data + 3 * f);
-        for (ScalarIndex i = 0; i < 3; i++) {
-            ScalarIndex idx_cur = triangle_indices[i],
-                        idx_nxt = triangle_indices[(i + 1) % 3],
-                        edge_id = 3 * f + i;
-            if (idx_cur == idx_nxt)
-                continue;
-
-            tmp[edge_id] = std::make_pair(idx_nxt, m_invalid_dedge);
-            if (V2E[idx_cur] != m_invalid_dedge) {
-                ScalarIndex last_edge_idx = V2E[idx_cur];
-
-                while (tmp[last_edge_idx].second != m_invalid_dedge)
-                    last_edge_idx = tmp[last_edge_idx].second;
-
-                if (tmp[last_edge_idx].second == m_invalid_dedge)
-                    tmp[last_edge_idx].second = edge_id;
-            } else {
-                V2E[idx_cur] = edge_id;
+    std::vector<ScalarIndex> E2E(dedge_count, m_invalid_dedge);
+    ThreadEnvironment env;
+
+    /* 1. Key every directed edge e = (v1, v2) by its undirected edge
+          (min(v1, v2), max(v1, v2)) */
+    std::vector<uint64_t> keys(dedge_count);
+    std::vector<uint32_t> dedges(dedge_count);
+
+    dr::parallel_for(
+        dr::blocked_range<size_t>(0, m_face_count, block_size),
+        [&](const dr::blocked_range<size_t> &range) {
+            ScopedSetThreadEnvironment set_env(env);
+            for (size_t f = range.begin(); f != range.end(); ++f) {
+                ScalarPoint3u tri = dr::load<ScalarPoint3u>(face_data + 3 * f);
+                for (ScalarIndex i = 0; i < 3; i++) {
+                    ScalarIndex idx_cur = tri[i],
+                                idx_nxt = tri[(i + 1) % 3];
+                    keys[3 * f + i] =
+                        ((uint64_t) std::min(idx_cur, idx_nxt) << vertex_bits) |
+                        (uint64_t) std::max(idx_cur, idx_nxt);
+                    dedges[3 * f + i] = (uint32_t) (3 * f + i);
+                }
             }
         }
-    }
+    );
 
-    // 2. Manifold check & assign `E2E`
-    std::vector<bool> non_manifold(m_vertex_count, false);
-    for (ScalarIndex f = 0; f < m_face_count; f++) {
-        ScalarPoint3u tri = dr::load<ScalarPoint3u>(face_data + 3 * f);
-        for (ScalarIndex i = 0; i < 3; i++) {
-            ScalarIndex idx_cur = tri[i],
-                        idx_nxt = tri[(i + 1) % 3],
-                        edge_id_cur = 3 * f + i;
-            if (idx_cur == idx_nxt)
-                continue;
+    // 2. Sort the directed edges so that the ones of every edge are adjacent
+    radix_sort(keys, dedges, 2 * vertex_bits);
+
+    // Directed edges from the first to the second vertex of the edge key
+    auto is_forward = [&](uint32_t dedge) {
+        ScalarIndex f = dedge / 3, i = dedge % 3;
+        return face_data[3 * f + i] < face_data[3 * f + (i + 1) % 3];
+    };
+
+    /* 3. Manifold check & assign `E2E`. Every block is extended to start
+          and end at the boundary between two edges. */
+    std::vector<size_t> block_start(block_count + 1, dedge_count);
+    for (size_t b = 0; b < block_count; ++b) {
+        size_t i = std::min(dedge_count, b * 3 * block_size);
+        while (i > 0 && i < dedge_count && keys[i] == keys[i - 1])
+            i++;
+        block_start[b] = i;
+    }
 
-            ScalarIndex it = V2E[idx_nxt], edge_id_opp = m_invalid_dedge;
-            while (it != m_invalid_dedge) {
-                if (tmp[it].first == idx_cur) {
-                    if (edge_id_opp == m_invalid_dedge) {
-                        edge_id_opp = it;
-                    } else {
-                        non_manifold[idx_cur] = true;
-                        non_manifold[idx_nxt] = true;
-                        edge_id_opp           = m_invalid_dedge;
-                        break;
+    std::vector<std::vector<ScalarIndex>> non_manifold(block_count);
+    dr::parallel_for(
+        dr::blocked_range<size_t>(0, block_count, 1),
+        [&](const dr::blocked_range<size_t> &range) {
+            ScopedSetThreadEnvironment set_env(env);
+            for (size_t b = range.begin(); b != range.end(); ++b) {
+                size_t end = std::max(block_start[b], block_start[b + 1]);
+                for (size_t i = block_start[b], j; i < end; i = j) {
+                    uint64_t key = keys[i];
+                    size_t forward = 0;
+                    for (j = i; j < dedge_count && keys[j] == key; ++j)
+                        forward += is_forward(dedges[j]) ? 1 : 0;
+
+                    ScalarIndex v1 = (ScalarIndex) (key >> vertex_bits),
+                                v2 = (ScalarIndex) (key & ((1ull << vertex_bits) - 1)),
+                                backward = (ScalarIndex) (j - i - forward);
+
+                    // Skip degenerate edges
+                    if (v1 == v2)
+                        continue;
+
+                    if (forward == 1 && backward == 1) {
+                        E2E[dedges[i]]     = dedges[i + 1];
+                        E2E[dedges[i + 1]] = dedges[i];
+                    } else if ((forward > 1 && backward > 0) ||
+                               (backward > 1 && forward > 0)) {
+                        // More than two faces share this edge
+                        non_manifold[b].push_back(v1);
+                        non_manifold[b].push_back(v2);
                     }
                 }
-                it = tmp[it].second;
-            }
-
-            if (edge_id_opp != m_invalid_dedge && edge_id_cur < edge_id_opp) {
-                E2E[edge_id_cur] = edge_id_opp;
-                E2E[edge_id_opp] = edge_id_cur;
             }
         }
-    }
+    );
 
-    // 3. Log
+    // 4. Log
+    std::vector<bool> is_non_manifold(m_vertex_count, false);
     ScalarIndex non_manifold_count = 0;
-    std::vector<bool> boundary(m_vertex_count, false);
-    for (ScalarIndex i = 0; i < m_vertex_count; i++) {
-        if (non_manifold[i]) {
-            non_manifold_count++;
-            continue;
+    for (const std::vector<ScalarIndex> &vertices : non_manifold) {
+        for (ScalarIndex v : vertices) {
+            if (!is_non_manifold[v]) {
+                is_non_manifold[v] = true;
+                non_manifold_count++;
+            }
         }
     }
 
@@ -622,17 +1106,434 @@ Mesh<Float, Spectrum>::build_indirect_silhouette_distribution() {
 MI_VARIANT
 ref<Mesh<Float, Spectrum>>
 Mesh<Float, Spectrum>::merge(const Mesh *other) const {
-    if (other->emitter() != m_emitter || other->sensor() != m_sensor ||
-        other->bsdf() != m_bsdf ||
-        other->interior_medium() != m_interior_medium ||
-        other->exterior_medium() != m_exterior_medium ||
-        other->has_vertex_normals() != has_vertex_normals() ||
-        other->has_vertex_texcoords() != has_vertex_texcoords() ||
-        other->has_face_normals() != has_face_normals() ||
-        other->has_mesh_attributes() || has_mesh_attributes())
-        Throw("Mesh::merge(): the two meshes are incompatible (%s and %s)!",
-              to_string(), other->to_string());
+    return merge(std::vector<const Mesh *>{ this, other });
+}
+
+MI_VARIANT
+ref<Mesh<Float, Spectrum>>
+Mesh<Float, Spectrum>::merge(const std::vector<const Mesh *> &meshes) {
+    if (meshes.empty())
+        Throw("Mesh::merge(): no meshes were specified!");
+
+    const Mesh *first = meshes[0];
+    std::vector<std::pair<std::string, size_t>> attributes = first->mesh_attributes();
+
+    // 1. Check compatibility and compute the size of the merged mesh
+    std::vector<size_t> vertex_offset(meshes.size()), face_offset(meshes.size());
+    size_t vertex_count = 0, face_count = 0;
+    ScalarBoundingBox3f bbox;
+
+    for (size_t i = 0; i < meshes.size(); ++i) {
+        const Mesh *mesh = meshes[i];
+        if (mesh->emitter() != first->emitter() ||
+            mesh->sensor() != first->sensor() ||
+            mesh->bsdf() != first->bsdf() ||
+            mesh->interior_medium() != first->interior_medium() ||
+            mesh->exterior_medium() != first->exterior_medium() ||
+            mesh->has_vertex_normals() != first->has_vertex_normals() ||
+            mesh->has_vertex_texcoords() != first->has_vertex_texcoords() ||
+            mesh->has_face_normals() != first->has_face_normals() ||
+            mesh->mesh_attributes() != attributes)
+            Throw("Mesh::merge(): the two meshes are incompatible (%s and %s)!",
+                  first->to_string(), mesh->to_string());
+
+        if (mesh->m_motion_keys > 1)
+            Throw("Mesh::merge(): deforming meshes cannot be merged (%s)!",
+                  mesh->to_string());
+
+        vertex_offset[i] = vertex_count;
+        face_offset[i]   = face_count;
+        vertex_count    += mesh->m_vertex_count;
+        face_count      += mesh->m_face_count;
+        bbox.expand(mesh->m_bbox);
+    }
+
+    if (vertex_count > 0xFFFFFFFFull || face_count > 0xFFFFFFFFull)
+        Throw("Mesh::merge(): the merged mesh is too large (%zu vertices, "
+              "%zu faces)!", vertex_count, face_count);
+
+    bool has_normals   = first->has_vertex_normals(),
+         has_texcoords = first->has_vertex_texcoords();
+
+    /* 2. Collect the buffers of all meshes on the host. Compact vertex
+          attributes are decoded, and the buffers of the JIT variants are
+          migrated (which may require a copy). */
+    struct Source {
+        const FloatStorage *positions = nullptr, *normals = nullptr,
+                           *texcoords = nullptr;
+        const DynamicBuffer<UInt32> *faces = nullptr;
+        std::vector<const FloatStorage *> attributes;
+    };
+
+    std::deque<FloatStorage> float_storage;
+    std::deque<DynamicBuffer<UInt32>> index_storage;
+
+    auto host_buffer = [](const auto &buf, auto &storage) {
+        if constexpr (dr::is_jit_v<Float>)
+            return &storage.emplace_back(dr::migrate(buf, AllocType::Host));
+        else
+            return &buf;
+    };
+
+    std::vector<Source> sources(meshes.size());
+    for (size_t i = 0; i < meshes.size(); ++i) {
+        const Mesh *mesh = meshes[i];
+        Source &source = sources[i];
+        source.positions = host_buffer(mesh->m_vertex_positions, float_storage);
+        source.faces = host_buffer(mesh->m_faces, index_storage);
+
+        if (has_normals)
+            source.normals = host_buffer(
+                mesh->m_compact_attributes
+                    ? float_storage.emplace_back(mesh->decoded_vertex_normals())
+                    : mesh->m_vertex_normals, float_storage);
+
+        if (has_texcoords)
+            source.texcoords = host_buffer(
+                mesh->m_compact_attributes
+                    ? float_storage.emplace_back(mesh->decoded_vertex_texcoords())
+                    : mesh->m_vertex_texcoords, float_storage);
+
+        for (const auto &[name, size] : attributes)
+            source.attributes.push_back(host_buffer(
+                mesh->m_mesh_attributes.find(name)->second.buf, float_storage));
+    }
+
+    if constexpr (dr::is_jit_v<Float>)
+        dr::sync_thread();
+
+    // 3. Fill the buffers of the merged mesh in parallel
+    std::vector<InputFloat> positions(vertex_count * 3),
+                            normals(has_normals ? vertex_count * 3 : 0),
+                            texcoords(has_texcoords ? vertex_count * 2 : 0);
+    std::vector<ScalarIndex> faces(face_count * 3);
+    std::vector<std::vector<InputFloat>> attribute_data(attributes.size());
+
+    for (size_t j = 0; j < attributes.size(); ++j) {
+        const MeshAttribute &attribute =
+            first->m_mesh_attributes.find(attributes[j].first)->second;
+        size_t count = attribute.type == MeshAttributeType::Vertex
+                           ? vertex_count : face_count;
+        attribute_data[j].resize(count * attribute.size);
+    }
+
+    auto copy = [](const FloatStorage *source, size_t size,
+                   std::vector<InputFloat> &target, size_t offset) {
+        const InputFloat *ptr = source->data();
+        std::copy(ptr, ptr + size, target.data() + offset);
+    };
+
+    ThreadEnvironment env;
+    dr::parallel_for(
+        dr::blocked_range<size_t>(
+            0, meshes.size(),
+            std::max<size_t>(1, meshes.size() / (4 * Thread::thread_count()))),
+        [&](const dr::blocked_range<size_t> &range) {
+            ScopedSetThreadEnvironment set_env(env);
+            for (size_t i = range.begin(); i != range.end(); ++i) {
+                const Mesh *mesh = meshes[i];
+                const Source &source = sources[i];
+                size_t vo = vertex_offset[i], fo = face_offset[i],
+                       vc = mesh->m_vertex_count, fc = mesh->m_face_count;
+
+                copy(source.positions, vc * 3, positions, vo * 3);
+                if (has_normals)
+                    copy(source.normals, vc * 3, normals, vo * 3);
+                if (has_texcoords)
+                    copy(source.texcoords, vc * 2, texcoords, vo * 2);
+
+                for (size_t j = 0; j < attributes.size(); ++j) {
+                    const MeshAttribute &attribute =
+                        mesh->m_mesh_attributes.find(attributes[j].first)->second;
+                    size_t offset = attribute.type == MeshAttributeType::Vertex
+                                        ? vo : fo;
+                    copy(source.attributes[j],
+                         (attribute.type == MeshAttributeType::Vertex ? vc : fc) *
+                             attribute.size,
+                         attribute_data[j], offset * attribute.size);
+                }
+
+                // Shift the vertex indices by the offset of the mesh
+                const ScalarIndex *face_ptr = source.faces->data();
+                ScalarIndex *target = faces.data() + fo * 3;
+                for (size_t k = 0; k < fc * 3; ++k)
+                    target[k] = face_ptr[k] + (ScalarIndex) vo;
+            }
+        }
+    );
+
+    // 4. Create the merged mesh
+    Properties props;
+    if (first->m_bsdf)
+        props.set_object("bsdf", (Object *) first->m_bsdf.get());
+    if (first->m_interior_medium)
+        props.set_object("interior", (Object *) first->m_interior_medium.get());
+    if (first->m_exterior_medium)
+        props.set_object("exterior", (Object *) first->m_exterior_medium.get());
+    if (first->m_sensor)
+        props.set_object("sensor", (Object *) first->m_sensor.get());
+    if (first->m_emitter)
+        props.set_object("emitter", (Object *) first->m_emitter.get());
+    props.set_bool("face_normals", first->m_face_normals);
+    props.set_bool("compact_vertex_attributes", first->m_compact_attributes);
+    props.set_bool("alias_sampling", first->m_alias_sampling);
+
+    std::string name = first->m_name;
+    if (meshes.size() == 2)
+        name += " + " + meshes[1]->m_name;
+    else if (meshes.size() > 2)
+        name += tfm::format(" + %zu other meshes", meshes.size() - 1);
+
+    ref<Mesh> result = new Mesh(name, (ScalarSize) vertex_count,
+                                (ScalarSize) face_count, props, has_normals,
+                                has_texcoords);
+
+    result->m_vertex_positions =
+        dr::load<FloatStorage>(positions.data(), positions.size());
+    if (has_normals)
+        result->m_vertex_normals =
+            dr::load<FloatStorage>(normals.data(), normals.size());
+    if (has_texcoords)
+        result->m_vertex_texcoords =
+            dr::load<FloatStorage>(texcoords.data(), texcoords.size());
+    result->m_faces =
+        dr::load<DynamicBuffer<UInt32>>(faces.data(), faces.size());
+
+    for (size_t j = 0; j < attributes.size(); ++j) {
+        const MeshAttribute &attribute =
+            first->m_mesh_attributes.find(attributes[j].first)->second;
+        FloatStorage buffer = dr::load<FloatStorage>(attribute_data[j].data(),
+                                                     attribute_data[j].size());
+        result->m_mesh_attributes.insert(
+            { attributes[j].first, { attribute.size, attribute.type, buffer } });
+    }
+
+    result->m_bbox = bbox;
+    result->initialize();
+
+    return result;
+}
+
+MI_VARIANT
+ref<Mesh<Float, Spectrum>>
+Mesh<Float, Spectrum>::subdivide(uint32_t max_levels,
+                                 ScalarFloat max_edge_length,
+                                 bool smooth) const {
+    if (m_motion_keys > 1)
+        Throw("Mesh::subdivide(): deforming meshes cannot be subdivided (%s)!",
+              m_name);
+
+    // 1. Collect the buffers of the control cage on the host
+    auto to_host = [](const auto &buf) {
+        using Buffer = std::decay_t<decltype(buf)>;
+        Buffer host = buf;
+        if constexpr (dr::is_jit_v<Float>) {
+            host = dr::migrate(buf, AllocType::Host);
+            dr::sync_thread();
+        }
+        return std::vector<dr::scalar_t<Buffer>>(host.data(),
+                                                 host.data() + host.size());
+    };
+
+    bool has_texcoords = has_vertex_texcoords();
+    std::vector<InputFloat> positions = to_host(m_vertex_positions),
+                            texcoords;
+    if (has_texcoords)
+        texcoords = to_host(decoded_vertex_texcoords());
+    std::vector<ScalarIndex> faces = to_host(m_faces);
+
+    std::vector<std::pair<std::string, size_t>> attributes = mesh_attributes();
+    std::vector<std::vector<InputFloat>> attribute_data;
+    for (const auto &[name, size] : attributes)
+        attribute_data.push_back(to_host(m_mesh_attributes.find(name)->second.buf));
+
+    /* 2. Weld the vertices by position. Vertices are duplicated along UV and
+          normal seams, which would otherwise turn into boundaries of the
+          control cage. The subdivision rules operate on the welded vertices,
+          while the UV coordinates and attributes are interpolated along the
+          original ones. */
+    size_t vertex_count = m_vertex_count, face_count = m_face_count;
+    std::vector<uint32_t> weld(vertex_count);
+    std::vector<InputPoint3f> points;
+    {
+        struct Hasher {
+            size_t operator()(const std::array<uint32_t, 3> &k) const {
+                return std::hash<uint64_t>()(
+                    ((uint64_t) k[0] << 32 | k[1]) ^ ((uint64_t) k[2] * 0x9e3779b97f4a7c15ull));
+            }
+        };
+        std::unordered_map<std::array<uint32_t, 3>, uint32_t, Hasher> lookup;
+        for (size_t i = 0; i < vertex_count; ++i) {
+            std::array<uint32_t, 3> key;
+            std::memcpy(key.data(), positions.data() + 3 * i, sizeof(key));
+            auto [it, inserted] = lookup.try_emplace(key, (uint32_t) points.size());
+            if (inserted)
+                points.push_back(dr::load<InputPoint3f>(positions.data() + 3 * i));
+            weld[i] = it->second;
+        }
+    }
+
+    auto edge_key = [](uint32_t a, uint32_t b) {
+        return a < b ? ((uint64_t) a << 32 | b) : ((uint64_t) b << 32 | a);
+    };
+
+    uint32_t level = 0;
+    for (; level < max_levels; ++level) {
+        /* 3. Find the edges of the welded mesh along with the opposite
+              vertices of their (up to two) adjacent faces */
+        struct Edge {
+            uint32_t a, b, opposite[2], count = 0;
+        };
+        std::unordered_map<uint64_t, uint32_t> edge_index;
+        std::vector<Edge> edges;
+        std::vector<uint32_t> face_edges(face_count * 3);
+        InputFloat longest = 0.f;
+
+        for (size_t i = 0; i < face_count; ++i) {
+            for (size_t j = 0; j < 3; ++j) {
+                uint32_t a = weld[faces[3 * i + j]],
+                         b = weld[faces[3 * i + (j + 1) % 3]],
+                         c = weld[faces[3 * i + (j + 2) % 3]];
+                auto [it, inserted] =
+                    edge_index.try_emplace(edge_key(a, b), (uint32_t) edges.size());
+                if (inserted) {
+                    edges.push_back(Edge{ a, b, { 0, 0 } });
+                    longest = dr::maximum(longest, dr::norm(points[a] - points[b]));
+                }
+                Edge &edge = edges[it->second];
+                if (edge.count < 2)
+                    edge.opposite[edge.count] = c;
+                edge.count++;
+                face_edges[3 * i + j] = it->second;
+            }
+        }
+
+        if (max_edge_length > 0.f && longest <= max_edge_length)
+            break;
+
+        if (face_count * 4 > 0xFFFFFFFFull)
+            Throw("Mesh::subdivide(): the subdivided mesh \"%s\" is too large!",
+                  m_name);
+
+        /* 4. Loop subdivision rules: reposition the existing vertices, and
+              insert a new vertex on every edge. Edges with a single adjacent
+              face (or more than two) are treated as creases. */
+        size_t point_count = points.size();
+        std::vector<InputPoint3f> sum(point_count, InputPoint3f(0.f)),
+                                  crease_sum(point_count, InputPoint3f(0.f));
+        std::vector<uint32_t> valence(point_count, 0), crease_valence(point_count, 0);
+
+        for (const Edge &edge : edges) {
+            sum[edge.a] += points[edge.b];
+            sum[edge.b] += points[edge.a];
+            valence[edge.a]++;
+            valence[edge.b]++;
+            if (edge.count != 2) {
+                crease_sum[edge.a] += points[edge.b];
+                crease_sum[edge.b] += points[edge.a];
+                crease_valence[edge.a]++;
+                crease_valence[edge.b]++;
+            }
+        }
+
+        std::vector<InputPoint3f> points_new(point_count + edges.size());
+        for (size_t i = 0; i < point_count; ++i) {
+            InputPoint3f p = points[i];
+            if (smooth && crease_valence[i] == 2) {
+                p = .75f * p + .125f * crease_sum[i];
+            } else if (smooth && crease_valence[i] == 0 && valence[i] >= 3) {
+                InputFloat n = (InputFloat) valence[i],
+                           beta = valence[i] == 3 ? (3.f / 16.f) : 3.f / (8.f * n);
+                p = (1.f - n * beta) * p + beta * sum[i];
+            }
+            // Corners and non-manifold vertices remain in place
+            points_new[i] = p;
+        }
+
+        for (size_t i = 0; i < edges.size(); ++i) {
+            const Edge &edge = edges[i];
+            InputPoint3f p = .5f * (points[edge.a] + points[edge.b]);
+            if (smooth && edge.count == 2)
+                p = .75f * p + .125f * (points[edge.opposite[0]] +
+                                        points[edge.opposite[1]]);
+            points_new[point_count + i] = p;
+        }
+
+        /* 5. Split the faces into four. The midpoints are shared by the
+              faces of an (unwelded) edge, hence seams are preserved. */
+        std::unordered_map<uint64_t, uint32_t> midpoints;
+        std::vector<ScalarIndex> faces_new(face_count * 12);
+        std::vector<uint32_t> weld_new(weld);
+        size_t vertex_count_new = vertex_count;
+
+        auto midpoint = [&](uint32_t a, uint32_t b, uint32_t edge) {
+            auto [it, inserted] =
+                midpoints.try_emplace(edge_key(a, b), (uint32_t) vertex_count_new);
+            if (inserted) {
+                weld_new.push_back((uint32_t) point_count + edge);
+                if (has_texcoords)
+                    for (size_t k = 0; k < 2; ++k)
+                        texcoords.push_back(.5f * (texcoords[2 * a + k] +
+                                                   texcoords[2 * b + k]));
+                for (size_t j = 0; j < attributes.size(); ++j) {
+                    const MeshAttribute &attribute =
+                        m_mesh_attributes.find(attributes[j].first)->second;
+                    if (attribute.type != MeshAttributeType::Vertex)
+                        continue;
+                    std::vector<InputFloat> &data = attribute_data[j];
+                    for (size_t k = 0; k < attribute.size; ++k)
+                        data.push_back(.5f * (data[attribute.size * a + k] +
+                                              data[attribute.size * b + k]));
+                }
+                vertex_count_new++;
+            }
+            return (ScalarIndex) it->second;
+        };
+
+        for (size_t i = 0; i < face_count; ++i) {
+            const ScalarIndex *v = faces.data() + 3 * i;
+            ScalarIndex m[3];
+            for (size_t j = 0; j < 3; ++j)
+                m[j] = midpoint(v[j], v[(j + 1) % 3], face_edges[3 * i + j]);
+
+            ScalarIndex *f = faces_new.data() + 12 * i;
+            f[0] = v[0]; f[1]  = m[0]; f[2]  = m[2];
+            f[3] = v[1]; f[4]  = m[1]; f[5]  = m[0];
+            f[6] = v[2]; f[7]  = m[2]; f[8]  = m[1];
+            f[9] = m[0]; f[10] = m[1]; f[11] = m[2];
+        }
+
+        // The four faces inherit the face attributes of their parent
+        for (size_t j = 0; j < attributes.size(); ++j) {
+            const MeshAttribute &attribute =
+                m_mesh_attributes.find(attributes[j].first)->second;
+            if (attribute.type != MeshAttributeType::Face)
+                continue;
+            const std::vector<InputFloat> &data = attribute_data[j];
+            std::vector<InputFloat> data_new(data.size() * 4);
+            for (size_t i = 0; i < face_count; ++i)
+                for (size_t c = 0; c < 4; ++c)
+                    std::copy(data.begin() + attribute.size * i,
+                              data.begin() + attribute.size * (i + 1),
+                              data_new.begin() + attribute.size * (4 * i + c));
+            attribute_data[j] = std::move(data_new);
+        }
+
+        if (vertex_count_new > 0xFFFFFFFFull)
+            Throw("Mesh::subdivide(): the subdivided mesh \"%s\" is too large!",
+                  m_name);
+
+        points.swap(points_new);
+        faces.swap(faces_new);
+        weld.swap(weld_new);
+        vertex_count = vertex_count_new;
+        face_count *= 4;
+    }
 
+    Log(Debug, "Subdivided mesh \"%s\" %u times (%zu -> %zu faces)", m_name,
+        level, (size_t) m_face_count, face_count);
+
+    // 6. Create the subdivided mesh
     Properties props;
     if (m_bsdf)
         props.set_object("bsdf", (Object *) m_bsdf.get());
@@ -645,44 +1546,38 @@ Mesh<Float, Spectrum>::merge(const Mesh *other) const {
     if (m_emitter)
         props.set_object("emitter", (Object *) m_emitter.get());
     props.set_bool("face_normals", m_face_normals);
+    props.set_bool("flip_normals", m_flip_normals);
+    props.set_bool("compact_vertex_attributes", m_compact_attributes);
+    props.set_bool("alias_sampling", m_alias_sampling);
 
-    ref<Mesh> result = new Mesh(
-        m_name + " + " + other->m_name, m_vertex_count + other->vertex_count(),
-        m_face_count + other->face_count(), props, has_vertex_normals(),
-        has_vertex_texcoords());
-
-    result->m_vertex_positions =
-        dr::concat(m_vertex_positions, other->m_vertex_positions);
+    ref<Mesh> result = new Mesh(m_name, (ScalarSize) vertex_count,
+                                (ScalarSize) face_count, props,
+                                has_vertex_normals(), has_texcoords);
 
-    if (has_vertex_normals())
-        result->m_vertex_normals =
-            dr::concat(m_vertex_normals, other->m_vertex_normals);
+    positions.resize(vertex_count * 3);
+    for (size_t i = 0; i < vertex_count; ++i)
+        dr::store(positions.data() + 3 * i, points[weld[i]]);
 
-    if (has_vertex_texcoords())
+    result->m_vertex_positions =
+        dr::load<FloatStorage>(positions.data(), positions.size());
+    if (has_texcoords)
         result->m_vertex_texcoords =
-            dr::concat(m_vertex_texcoords, other->m_vertex_texcoords);
-
-    result->m_faces = dr::concat(m_faces, other->m_faces);
-    result->m_bbox = m_bbox;
-    result->m_bbox.expand(other->m_bbox);
-
-    if constexpr (dr::is_jit_v<Float>) {
-        UInt32 threshold = dr::opaque<UInt32>(face_count() * 3),
-               offset    = dr::opaque<UInt32>(vertex_count()),
-               index     = dr::arange<UInt32>(result->face_count() * 3);
-
-        result->m_faces = dr::select(index < threshold, result->m_faces,
-                                     result->m_faces + offset);
-
-        dr::eval(result->m_faces, result->m_vertex_positions,
-                 result->m_vertex_normals, result->m_vertex_texcoords);
-    } else {
-        uint32_t  offset = vertex_count(),
-                 *ptr    = result->m_faces.data() + face_count() * 3;
-        for (size_t i = 0; i < other->face_count() * 3; ++i)
-            *ptr++ += offset;
+            dr::load<FloatStorage>(texcoords.data(), texcoords.size());
+    result->m_faces =
+        dr::load<DynamicBuffer<UInt32>>(faces.data(), faces.size());
+
+    for (size_t j = 0; j < attributes.size(); ++j) {
+        const MeshAttribute &attribute =
+            m_mesh_attributes.find(attributes[j].first)->second;
+        FloatStorage buffer = dr::load<FloatStorage>(attribute_data[j].data(),
+                                                     attribute_data[j].size());
+        result->m_mesh_attributes.insert(
+            { attributes[j].first, { attribute.size, attribute.type, buffer } });
     }
 
+    result->recompute_bbox();
+    if (result->has_vertex_normals())
+        result->recompute_vertex_normals();
     result->initialize();
 
     return result;
@@ -702,7 +1597,8 @@ MI_VARIANT void Mesh<Float, Spectrum>::build_parameterization() {
                  props, false, false);
     mesh->m_faces = m_faces;
 
-    auto&& vertex_texcoords = dr::migrate(m_vertex_texcoords, AllocType::Host);
+    FloatStorage texcoords_decoded = decoded_vertex_texcoords();
+    auto&& vertex_texcoords = dr::migrate(texcoords_decoded, AllocType::Host);
     if constexpr (dr::is_jit_v<Float>)
         dr::sync_thread();
 
@@ -757,19 +1653,26 @@ Mesh<Float, Spectrum>::sample_position(Float time, const Point2f &sample_, Mask
         m_area_pmf.sample_reuse(sample.y(), active);
 
     Vector3u fi = face_indices(face_idx, active);
+    PositionSample3f ps = face_position_sample(
+        fi, warp::square_to_uniform_triangle(sample), active);
+    ps.time  = time;
+    ps.pdf   = m_area_pmf.normalization();
+    ps.delta = false;
 
+    return ps;
+}
+
+MI_VARIANT typename Mesh<Float, Spectrum>::PositionSample3f
+Mesh<Float, Spectrum>::face_position_sample(const Vector3u &fi, const Point2f &b,
+                                            Mask active) const {
     Point3f p0 = vertex_position(fi[0], active),
             p1 = vertex_position(fi[1], active),
             p2 = vertex_position(fi[2], active);
 
     Vector3f e0 = p1 - p0, e1 = p2 - p0;
-    Point2f b = warp::square_to_uniform_triangle(sample);
 
-    PositionSample3f ps;
-    ps.p     = dr::fmadd(e0, b.x(), dr::fmadd(e1, b.y(), p0));
-    ps.time  = time;
-    ps.pdf   = m_area_pmf.normalization();
-    ps.delta = false;
+    PositionSample3f ps = dr::zeros<PositionSample3f>();
+    ps.p = dr::fmadd(e0, b.x(), dr::fmadd(e1, b.y(), p0));
 
     if (has_vertex_texcoords()) {
         Point2f uv0 = vertex_texcoord(fi[0], active),
@@ -801,6 +1704,113 @@ Mesh<Float, Spectrum>::sample_position(Float time, const Point2f &sample_, Mask
     return ps;
 }
 
+MI_VARIANT Float
+Mesh<Float, Spectrum>::solid_angle(const Point3f &p,
+                                   std::vector<Float> *face_solid_angles,
+                                   Mask active) const {
+    Float total = 0.f;
+    for (ScalarIndex f = 0; f < m_face_count; ++f) {
+        Vector3u fi = face_indices(UInt32(f), active);
+        Vector3f a = dr::normalize(vertex_position(fi[0], active) - p),
+                 b = dr::normalize(vertex_position(fi[1], active) - p),
+                 c = dr::normalize(vertex_position(fi[2], active) - p);
+
+        Float omega = dr::select(
+            dr::abs(dr::dot(a, dr::cross(b, c))) > 1e-6f,
+            warp::spherical_triangle_solid_angle(a, b, c), 0.f);
+
+        if (face_solid_angles)
+            face_solid_angles->push_back(omega);
+        total += omega;
+    }
+    return total;
+}
+
+MI_VARIANT typename Mesh<Float, Spectrum>::DirectionSample3f
+Mesh<Float, Spectrum>::sample_direction(const Interaction3f &it,
+                                        const Point2f &sample_,
+                                        Mask active) const {
+    MI_MASK_ARGUMENT(active);
+
+    if (!solid_angle_sampling())
+        return Base::sample_direction(it, sample_, active);
+
+    std::vector<Float> omega;
+    Float total = solid_angle(it.p, &omega, active);
+    Mask spherical = active && total > SolidAngleThreshold;
+
+    DirectionSample3f result =
+        Base::sample_direction(it, sample_, active && !spherical);
+
+    if (dr::none_or<false>(spherical))
+        return result;
+
+    // Select a face proportionally to its solid angle and reuse the sample
+    Point2f sample = sample_;
+    Float target = sample.x() * total, cdf = 0.f, cdf_face = 0.f,
+          omega_face = omega.back();
+    UInt32 face = m_face_count - 1;
+    Mask found = false;
+
+    for (ScalarIndex f = 0; f < m_face_count; ++f) {
+        Mask select = !found && target < cdf + omega[f];
+        dr::masked(face, select) = f;
+        dr::masked(cdf_face, select) = cdf;
+        dr::masked(omega_face, select) = omega[f];
+        found |= select;
+        cdf += omega[f];
+    }
+
+    sample.x() = dr::clamp((target - cdf_face) / omega_face, 0.f,
+                           dr::OneMinusEpsilon<Float>);
+
+    Vector3u fi = face_indices(face, spherical);
+    Point3f p0 = vertex_position(fi[0], spherical),
+            p1 = vertex_position(fi[1], spherical),
+            p2 = vertex_position(fi[2], spherical);
+
+    Vector3f d = warp::square_to_spherical_triangle(
+        sample, dr::normalize(p0 - it.p), dr::normalize(p1 - it.p),
+        dr::normalize(p2 - it.p));
+
+    // Intersect the sampled direction with the plane of the face
+    Vector3f e0 = p1 - p0, e1 = p2 - p0, n = dr::cross(e0, e1);
+    Vector3f q = dr::fmadd(d, dr::dot(p0 - it.p, n) / dr::dot(d, n), it.p) - p0;
+
+    // .. and compute its barycentric coordinates
+    Float d00 = dr::squared_norm(e0), d01 = dr::dot(e0, e1),
+          d11 = dr::squared_norm(e1), d20 = dr::dot(q, e0),
+          d21 = dr::dot(q, e1),
+          inv_det = dr::rcp(dr::fmsub(d00, d11, d01 * d01));
+    Point2f b = dr::clamp(Point2f(dr::fmsub(d11, d20, d01 * d21) * inv_det,
+                                  dr::fmsub(d00, d21, d01 * d20) * inv_det),
+                          0.f, 1.f);
+
+    DirectionSample3f ds(face_position_sample(fi, b, spherical));
+    ds.time  = it.time;
+    ds.pdf   = dr::rcp(total);
+    ds.delta = false;
+    ds.d     = ds.p - it.p;
+    ds.dist  = dr::norm(ds.d);
+    ds.d    /= ds.dist;
+
+    dr::masked(result, spherical) = ds;
+    return result;
+}
+
+MI_VARIANT Float Mesh<Float, Spectrum>::pdf_direction(const Interaction3f &it,
+                                                       const DirectionSample3f &ds,
+                                                       Mask active) const {
+    MI_MASK_ARGUMENT(active);
+
+    Float pdf = Base::pdf_direction(it, ds, active);
+    if (!solid_angle_sampling())
+        return pdf;
+
+    Float total = solid_angle(it.p, nullptr, active);
+    return dr::select(total > SolidAngleThreshold, dr::rcp(total), pdf);
+}
+
 MI_VARIANT
 
 typename Mesh<Float, Spectrum>::SurfaceInteraction3f
@@ -1262,41 +2272,49 @@ Mesh<Float, Spectrum>::precompute_silhouette(
 
         return std::make_tuple(out_indices, out_weights);
     } else {
-        UInt32 dedge_curr = dr::arange<UInt32>(m_face_count * 3);
-        auto [face_idx, e] = dr::idivmod(dedge_curr, 3u);
-        Vector3u fi = face_indices(face_idx);
-        Point3f p0 = vertex_position(pick_vertex(fi, e + 0u)),
-                p1 = vertex_position(pick_vertex(fi, e + 1u));
+        Float weight = silhouette_edge_weight(
+            viewpoint, dr::arange<UInt32>(m_face_count * 3));
 
-        Normal3f n = face_normal(face_idx);
-        Vector3f to_p0 = dr::normalize(p0 - viewpoint);
-        Vector3f to_p1 = dr::normalize(p1 - viewpoint);
+        UInt32 valid_indices = dr::compress(weight > 0.f);
+        Float valid_weight = dr::gather<Float>(weight, valid_indices);
 
-        // The arclength weight is not perfect for perspective
-        // cameras. But it is a close approximation.
-        Float weight = unit_angle(to_p0, to_p1);
+        return std::make_tuple(valid_indices, valid_weight);
+    }
+}
 
-        UInt32 dedge_oppo = opposite_dedge(dedge_curr);
-        Mask has_opposite = dr::neq(dedge_oppo, m_invalid_dedge);
+MI_VARIANT Float
+Mesh<Float, Spectrum>::silhouette_edge_weight(const ScalarPoint3f &viewpoint,
+                                              const UInt32 &dedge_curr,
+                                              Mask active) const {
+    auto [face_idx, e] = dr::idivmod(dedge_curr, 3u);
+    Vector3u fi = face_indices(face_idx, active);
+    Point3f p0 = vertex_position(pick_vertex(fi, e + 0u), active),
+            p1 = vertex_position(pick_vertex(fi, e + 1u), active);
 
-        auto face_idx_oppo = dr::idiv(dedge_oppo, 3u);
-        Normal3f n_oppo = face_normal(face_idx_oppo, has_opposite);
+    Normal3f n = face_normal(face_idx, active);
+    Vector3f to_p0 = dr::normalize(p0 - viewpoint);
+    Vector3f to_p1 = dr::normalize(p1 - viewpoint);
 
-        Mask greater_dedge_idx = dedge_oppo > dedge_curr;
-        Mask not_flat = dr::abs(dr::dot(n, n_oppo)) < 1.f;
-        Mask only_one_visible_face =
-            dr::dot(to_p0, n) * dr::dot(to_p0, n_oppo) <= 0.f;
+    // The arclength weight is not perfect for perspective
+    // cameras. But it is a close approximation.
+    Float weight = unit_angle(to_p0, to_p1);
 
-        Mask valid = !has_opposite || (greater_dedge_idx &&
-                                       only_one_visible_face &&
-                                       not_flat);
+    UInt32 dedge_oppo = opposite_dedge(dedge_curr, active);
+    Mask has_opposite = active && dr::neq(dedge_oppo, m_invalid_dedge);
 
-        UInt32 valid_indices = dr::compress(valid);
-        dr::masked(weight, !valid) = 0.f;
-        Float valid_weight = dr::gather<Float>(weight, valid_indices);
+    auto face_idx_oppo = dr::idiv(dedge_oppo, 3u);
+    Normal3f n_oppo = face_normal(face_idx_oppo, has_opposite);
 
-        return std::make_tuple(valid_indices, valid_weight);
-    }
+    Mask greater_dedge_idx = dedge_oppo > dedge_curr;
+    Mask not_flat = dr::abs(dr::dot(n, n_oppo)) < 1.f;
+    Mask only_one_visible_face =
+        dr::dot(to_p0, n) * dr::dot(to_p0, n_oppo) <= 0.f;
+
+    Mask valid = !has_opposite || (greater_dedge_idx &&
+                                   only_one_visible_face &&
+                                   not_flat);
+
+    return dr::select(active && valid, weight, 0.f);
 }
 
 MI_VARIANT typename Mesh<Float, Spectrum>::SilhouetteSample3f
@@ -1387,9 +2405,9 @@ Mesh<Float, Spectrum>::compute_surface_interaction(const Ray3f &ray,
 
     Vector3u fi = face_indices(pi.prim_index, active);
 
-    Point3f p0 = vertex_position(fi[0], active),
-            p1 = vertex_position(fi[1], active),
-            p2 = vertex_position(fi[2], active);
+    Point3f p0 = vertex_position_at(fi[0], ray.time, active),
+            p1 = vertex_position_at(fi[1], ray.time, active),
+            p2 = vertex_position_at(fi[2], ray.time, active);
 
     Float t = pi.t;
     Point2f prim_uv = pi.prim_uv;
@@ -1452,13 +2470,18 @@ Mesh<Float, Spectrum>::compute_surface_interaction(const Ray3f &ray,
 
     si.t = dr::select(active, t, dr::Infinity<Float>);
 
-    // Face normal
-    si.n = face_normal(pi.prim_index, active);
+    // Face normal (of the triangle at the time of the ray if it deforms)
+    if (m_motion_keys > 1)
+        si.n = dr::normalize(dr::cross(p1 - p0, p2 - p0));
+    else
+        si.n = face_normal(pi.prim_index, active);
 
     // Texture coordinates (if available)
     si.uv = Point2f(b1, b2);
 
-    std::tie(si.dp_du, si.dp_dv) = coordinate_system(si.n);
+    // Fallback for meshes without (or with degenerate) texture coordinates
+    if (likely(has_flag(ray_flags, RayFlags::dPdUV)))
+        std::tie(si.dp_du, si.dp_dv) = coordinate_system(si.n);
 
     Vector3f dp0 = p1 - p0,
              dp1 = p2 - p0;
@@ -1571,11 +2594,7 @@ MI_VARIANT void Mesh<Float, Spectrum>::add_attribute(const std::string& name,
     // In spectral modes, convert RGB color to srgb model coefs if attribute name contains 'color'
     if constexpr (is_spectral_v<Spectrum>) {
         if (dim == 3 && name.find("color") != std::string::npos) {
-            InputFloat *ptr = (InputFloat *) data.data();
-            for (size_t i = 0; i < count; ++i) {
-                dr::store(ptr, srgb_model_fetch(dr::load<Color<InputFloat, 3>>(ptr)));
-                ptr += 3;
-            }
+            srgb_model_fetch((InputFloat *) data.data(), count);
         }
     }
 
@@ -1714,6 +2733,14 @@ MI_VARIANT typename Mesh<Float, Spectrum>::ScalarBoundingBox3f
 Mesh<Float, Spectrum>::bbox(ScalarIndex index, const ScalarBoundingBox3f &clip) const {
     using ScalarPoint3d = mitsuba::Point<double, 3>;
 
+    /* The triangle of a deforming mesh sweeps through space over time, hence
+       clip its time-expanded bounds instead of the triangle itself */
+    if (m_motion_keys > 1) {
+        ScalarBoundingBox3f result = bbox(index);
+        result.clip(clip);
+        return result;
+    }
+
     // Reserve room for some additional vertices
     ScalarPoint3d vertices1[max_vertices], vertices2[max_vertices];
     size_t n_vertices = 3;
@@ -1768,6 +2795,9 @@ MI_VARIANT std::string Mesh<Float, Spectrum>::to_string() const {
         << "  face_count = " << m_face_count << "," << std::endl
         << "  faces = [" << util::mem_string(face_data_bytes() * m_face_count) << " of face data]," << std::endl;
 
+    if (m_motion_keys > 1)
+        oss << "  motion_keys = " << m_motion_keys << "," << std::endl;
+
     if (!m_area_pmf.empty())
         oss << "  surface_area = " << m_area_pmf.sum() << "," << std::endl;
 
@@ -1790,12 +2820,12 @@ MI_VARIANT std::string Mesh<Float, Spectrum>::to_string() const {
 }
 
 MI_VARIANT size_t Mesh<Float, Spectrum>::vertex_data_bytes() const {
-    size_t vertex_data_bytes = 3 * sizeof(InputFloat);
+    size_t vertex_data_bytes = 3 * sizeof(InputFloat) * m_motion_keys;
 
     if (has_vertex_normals())
-        vertex_data_bytes += 3 * sizeof(InputFloat);
+        vertex_data_bytes += m_compact_attributes ? sizeof(uint32_t) : 3 * sizeof(InputFloat);
     if (has_vertex_texcoords())
-        vertex_data_bytes += 2 * sizeof(InputFloat);
+        vertex_data_bytes += m_compact_attributes ? sizeof(uint32_t) : 2 * sizeof(InputFloat);
 
     for (const auto&[name, attribute]: m_mesh_attributes)
         if (attribute.type == MeshAttributeType::Vertex)
@@ -1818,16 +2848,37 @@ MI_VARIANT size_t Mesh<Float, Spectrum>::face_data_bytes() const {
 MI_VARIANT RTCGeometry Mesh<Float, Spectrum>::embree_geometry(RTCDevice device) {
     RTCGeometry geom = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_TRIANGLE);
 
+    if (m_motion_keys > RTC_MAX_TIME_STEP_COUNT)
+        Throw("Mesh \"%s\": Embree supports at most %i keyframes (got %u)!",
+              m_name, RTC_MAX_TIME_STEP_COUNT, m_motion_keys);
+
+    // Keyframes are uniformly distributed over the default time range [0, 1]
+    rtcSetGeometryTimeStepCount(geom, m_motion_keys);
+
     rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3,
                                m_vertex_positions.data(), 0, 3 * sizeof(InputFloat),
                                m_vertex_count);
+    for (ScalarSize k = 1; k < m_motion_keys; ++k)
+        rtcSetSharedGeometryBuffer(
+            geom, RTC_BUFFER_TYPE_VERTEX, k, RTC_FORMAT_FLOAT3,
+            m_vertex_motion_positions.data(),
+            (size_t) (k - 1) * m_vertex_count * 3 * sizeof(InputFloat),
+            3 * sizeof(InputFloat), m_vertex_count);
     rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_INDEX, 0, RTC_FORMAT_UINT3,
-                               m_faces.data(), 0, 3 * sizeof(ScalarIndex),
+                               accel_faces().data(), 0, 3 * sizeof(ScalarIndex),
                                m_face_count);
 
     rtcCommitGeometry(geom);
     return geom;
 }
+
+MI_VARIANT void Mesh<Float, Spectrum>::embree_update_geometry(RTCGeometry geom) {
+    rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3,
+                               m_vertex_positions.data(), 0, 3 * sizeof(InputFloat),
+                               m_vertex_count);
+    rtcUpdateGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 0);
+    rtcCommitGeometry(geom);
+}
 #endif
 
 #if defined(MI_ENABLE_CUDA)
@@ -1842,8 +2893,21 @@ MI_VARIANT void Mesh<Float, Spectrum>::optix_build_input(OptixBuildInput &build_
     build_input.triangleArray.indexFormat      = OPTIX_INDICES_FORMAT_UNSIGNED_INT3;
     build_input.triangleArray.numVertices      = m_vertex_count;
     build_input.triangleArray.vertexBuffers    = (CUdeviceptr*) &m_vertex_buffer_ptr;
+
+    // Deforming meshes provide one vertex buffer per motion key
+    if (m_motion_keys > 1) {
+        uint8_t *motion = (uint8_t *) m_vertex_motion_positions.data();
+        m_vertex_motion_buffer_ptrs.resize(m_motion_keys);
+        m_vertex_motion_buffer_ptrs[0] = m_vertex_buffer_ptr;
+        for (ScalarSize k = 1; k < m_motion_keys; ++k)
+            m_vertex_motion_buffer_ptrs[k] =
+                motion + (size_t) (k - 1) * m_vertex_count * 3 * sizeof(InputFloat);
+        build_input.triangleArray.vertexBuffers =
+            (CUdeviceptr*) m_vertex_motion_buffer_ptrs.data();
+    }
+
     build_input.triangleArray.numIndexTriplets = m_face_count;
-    build_input.triangleArray.indexBuffer      = (CUdeviceptr) m_faces.data();
+    build_input.triangleArray.indexBuffer      = (CUdeviceptr) accel_faces().data();
     build_input.triangleArray.flags            = &triangle_input_flags;
     build_input.triangleArray.numSbtRecords    = 1;
 }
@@ -9,6 +9,40 @@
 
 NAMESPACE_BEGIN(mitsuba)
 
+/// Disk cache settings (see \ref optix_configure_cache())
+static bool optix_cache_configured = false;
+static std::string optix_cache_path;
+static size_t optix_cache_max_size = 0;
+
+static void optix_apply_cache_settings() {
+    if (!optix_cache_configured)
+        return;
+
+    OptixDeviceContext context = jit_optix_context();
+    if (optix_cache_path.empty()) {
+        jit_optix_check(optixDeviceContextSetCacheEnabled(context, 0));
+        Log(Debug, "OptiX module cache disabled.");
+        return;
+    }
+
+    jit_optix_check(optixDeviceContextSetCacheLocation(context, optix_cache_path.c_str()));
+    if (optix_cache_max_size > 0)
+        jit_optix_check(optixDeviceContextSetCacheDatabaseSizes(
+            context, optix_cache_max_size, optix_cache_max_size / 2));
+    jit_optix_check(optixDeviceContextSetCacheEnabled(context, 1));
+    Log(Debug, "OptiX module cache: \"%s\"", optix_cache_path);
+}
+
+void optix_configure_cache(const std::string &path, size_t max_size) {
+    optix_cache_configured = true;
+    optix_cache_path = path;
+    optix_cache_max_size = max_size;
+
+    // Apply the settings immediately if OptiX is already initialized
+    if (optixAccelBuild)
+        optix_apply_cache_settings();
+}
+
 void optix_initialize() {
     if (optixAccelBuild)
         return;
@@ -21,6 +55,7 @@ void optix_initialize() {
     L(optixAccelBuild);
     L(optixAccelCompact);
     L(optixBuiltinISModuleGet);
+    L(optixConvertPointerToTraversableHandle);
     L(optixDenoiserCreate);
     L(optixDenoiserDestroy);
     L(optixDenoiserComputeMemoryResources);
@@ -32,8 +67,13 @@ void optix_initialize() {
     L(optixTaskExecute);
     L(optixProgramGroupCreate);
     L(optixSbtRecordPackHeader);
+    L(optixDeviceContextSetCacheEnabled);
+    L(optixDeviceContextSetCacheLocation);
+    L(optixDeviceContextSetCacheDatabaseSizes);
 
     #undef L
+
+    optix_apply_cache_settings();
 }
 
 scoped_optix_context::scoped_optix_context() {
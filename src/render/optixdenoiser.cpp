@@ -16,10 +16,23 @@ static OptixImage2D optixImage2DfromTensor(
              pixel_format };
 }
 
+/// Return the window of an image starting at pixel (x, y) with size (w, h)
+static OptixImage2D optixImage2DWindow(const OptixImage2D &image,
+                                       uint32_t x, uint32_t y,
+                                       uint32_t w, uint32_t h) {
+    OptixImage2D window = image;
+    window.data += (CUdeviceptr) y * image.rowStrideInBytes +
+                   (CUdeviceptr) x * image.pixelStrideInBytes;
+    window.width = w;
+    window.height = h;
+    return window;
+}
+
 MI_VARIANT OptixDenoiser<Float, Spectrum>::OptixDenoiser(
-    const ScalarVector2u &input_size, bool albedo, bool normals, bool temporal)
-    : m_input_size(input_size), m_options({ albedo, normals }),
-      m_temporal(temporal) {
+    const ScalarVector2u &input_size, bool albedo, bool normals, bool temporal,
+    const ScalarVector2u &tile_size)
+    : m_input_size(input_size), m_tile_size(input_size), m_overlap(0),
+      m_options({ albedo, normals }), m_temporal(temporal) {
     if constexpr (!dr::is_cuda_v<Float>)
         Throw("OptixDenoiser is only available in CUDA mode!");
 
@@ -38,17 +51,30 @@ MI_VARIANT OptixDenoiser<Float, Spectrum>::OptixDenoiser(
     jit_optix_check(
         optixDenoiserCreate(context, model_kind, &m_options, &m_denoiser));
 
+    // Tiling is only needed if the tiles are smaller than the input
+    if (dr::all(dr::neq(tile_size, 0u)))
+        m_tile_size = dr::minimum(tile_size, input_size);
+    bool tiled = m_tile_size != input_size;
+
     OptixDenoiserSizes sizes = {};
     jit_optix_check(optixDenoiserComputeMemoryResources(
-        m_denoiser, input_size.x(), input_size.y(), &sizes));
+        m_denoiser, m_tile_size.x(), m_tile_size.y(), &sizes));
+
+    // Tiles are extended by an overlap region on each side
+    ScalarVector2u setup_size = m_input_size;
+    if (tiled) {
+        m_overlap = sizes.overlapWindowSizeInPixels;
+        setup_size = dr::minimum(m_tile_size + 2u * m_overlap, m_input_size);
+    }
 
     CUstream stream = jit_cuda_stream();
-    m_state_size = (uint32_t) sizes.stateSizeInBytes;
+    m_state_size = sizes.stateSizeInBytes;
     m_state = jit_malloc(AllocType::Device, m_state_size);
-    m_scratch_size = (uint32_t) sizes.withoutOverlapScratchSizeInBytes;
+    m_scratch_size = tiled ? sizes.withOverlapScratchSizeInBytes
+                           : sizes.withoutOverlapScratchSizeInBytes;
     m_scratch = jit_malloc(AllocType::Device, m_scratch_size);
-    jit_optix_check(optixDenoiserSetup(m_denoiser, stream, input_size.x(),
-                                       input_size.y(), m_state, m_state_size,
+    jit_optix_check(optixDenoiserSetup(m_denoiser, stream, setup_size.x(),
+                                       setup_size.y(), m_state, m_state_size,
                                        m_scratch, m_scratch_size));
     m_hdr_intensity = jit_malloc(AllocType::Device, sizeof(float));
 }
@@ -142,9 +168,46 @@ OptixDenoiser<Float, Spectrum>::operator()(
             previous_denoised, input_pixel_format);
     }
 
-    jit_optix_check(optixDenoiserInvoke(m_denoiser, stream, &params, m_state,
-                                        m_state_size, &guide_layer, &layers, 1,
-                                        0, 0, m_scratch, m_scratch_size));
+    if (m_tile_size == m_input_size) {
+        jit_optix_check(optixDenoiserInvoke(
+            m_denoiser, stream, &params, m_state, m_state_size, &guide_layer,
+            &layers, 1, 0, 0, m_scratch, m_scratch_size));
+    } else {
+        /* Denoise each tile separately. The input windows include the
+           overlap region (clipped to the image), while the output of each
+           invocation only covers the tile itself. */
+        auto window = [](const OptixImage2D &image, uint32_t x, uint32_t y,
+                         uint32_t w, uint32_t h) {
+            return image.data ? optixImage2DWindow(image, x, y, w, h) : image;
+        };
+
+        for (uint32_t y = 0; y < m_input_size.y(); y += m_tile_size.y()) {
+            for (uint32_t x = 0; x < m_input_size.x(); x += m_tile_size.x()) {
+                uint32_t tile_w = std::min(m_tile_size.x(), m_input_size.x() - x),
+                         tile_h = std::min(m_tile_size.y(), m_input_size.y() - y),
+                         in_x = (uint32_t) std::max((int) x - (int) m_overlap, 0),
+                         in_y = (uint32_t) std::max((int) y - (int) m_overlap, 0),
+                         in_w = std::min(x + tile_w + m_overlap, m_input_size.x()) - in_x,
+                         in_h = std::min(y + tile_h + m_overlap, m_input_size.y()) - in_y;
+
+                OptixDenoiserLayer tile_layers = {};
+                tile_layers.input = window(layers.input, in_x, in_y, in_w, in_h);
+                tile_layers.previousOutput =
+                    window(layers.previousOutput, in_x, in_y, in_w, in_h);
+                tile_layers.output = window(layers.output, x, y, tile_w, tile_h);
+
+                OptixDenoiserGuideLayer tile_guide_layer = {};
+                tile_guide_layer.albedo = window(guide_layer.albedo, in_x, in_y, in_w, in_h);
+                tile_guide_layer.normal = window(guide_layer.normal, in_x, in_y, in_w, in_h);
+                tile_guide_layer.flow = window(guide_layer.flow, in_x, in_y, in_w, in_h);
+
+                jit_optix_check(optixDenoiserInvoke(
+                    m_denoiser, stream, &params, m_state, m_state_size,
+                    &tile_guide_layer, &tile_layers, 1, x - in_x, y - in_y,
+                    m_scratch, m_scratch_size));
+            }
+        }
+    }
 
     size_t shape[3] = { noisy.shape(0), noisy.shape(1), noisy.shape(2) };
     return TensorXf(std::move(output_data), 3, shape);
@@ -270,7 +333,8 @@ std::string OptixDenoiser<Float, Spectrum>::to_string() const {
         << "  input_size = " << m_input_size << "," << std::endl
         << "  albedo = " << m_options.guideAlbedo << "," << std::endl
         << "  normals = " << m_options.guideNormal << "," << std::endl
-        << "  temporal = " << m_temporal << std::endl
+        << "  temporal = " << m_temporal << "," << std::endl
+        << "  tile_size = " << m_tile_size << std::endl
         << "]";
     return oss.str();
 }
@@ -0,0 +1,61 @@
+#include <mitsuba/render/distributed.h>
+#include <mitsuba/python/python.h>
+
+extern py::object cast_object(Object *o);
+
+MI_PY_EXPORT(RenderClient) {
+    MI_PY_CLASS(RenderClient, Object)
+        .def(py::init<const std::string &, uint16_t>(), "host"_a, "port"_a,
+             D(RenderClient, RenderClient),
+             py::call_guard<py::gil_scoped_release>())
+        .def("load_scene", &RenderClient::load_scene, "id"_a, "filename"_a,
+             "defines"_a = RenderParameterList(), D(RenderClient, load_scene),
+             py::call_guard<py::gil_scoped_release>())
+        .def("remove_scene", &RenderClient::remove_scene, "id"_a,
+             D(RenderClient, remove_scene),
+             py::call_guard<py::gil_scoped_release>())
+        .def("render", &RenderClient::render, "id"_a,
+             "overrides"_a = RenderParameterList(), "sensor_index"_a = 0,
+             "spp"_a = 0, "seed"_a = 0, D(RenderClient, render),
+             py::call_guard<py::gil_scoped_release>())
+        .def("shutdown_server", &RenderClient::shutdown_server,
+             D(RenderClient, shutdown_server),
+             py::call_guard<py::gil_scoped_release>());
+}
+
+MI_PY_EXPORT(HybridRenderer) {
+    using BackendStats = HybridRenderer::BackendStats;
+
+    auto cls = MI_PY_CLASS(HybridRenderer, Object)
+        .def(py::init<const fs::path &, const std::string &,
+                      const std::string &, const RenderParameterList &>(),
+             "filename"_a, "cpu_variant"_a = "llvm_ad_rgb",
+             "gpu_variant"_a = "cuda_ad_rgb",
+             "defines"_a = RenderParameterList(),
+             D(HybridRenderer, HybridRenderer),
+             py::call_guard<py::gil_scoped_release>())
+        .def("render", &HybridRenderer::render, "sensor_index"_a = 0,
+             "seed"_a = 0, "spp"_a = 0, "pass_time"_a = 0.5f,
+             D(HybridRenderer, render),
+             py::call_guard<py::gil_scoped_release>())
+        .def("scene",
+             [](const HybridRenderer &r, size_t index) {
+                 return cast_object(r.scene(index));
+             }, "index"_a, D(HybridRenderer, scene))
+        .def_method(HybridRenderer, backend_stats);
+
+    py::class_<BackendStats>(cls, "BackendStats",
+                             D(HybridRenderer, BackendStats))
+        .def_readonly("variant", &BackendStats::variant,
+                      D(HybridRenderer, BackendStats, variant))
+        .def_readonly("passes", &BackendStats::passes,
+                      D(HybridRenderer, BackendStats, passes))
+        .def_readonly("spp", &BackendStats::spp,
+                      D(HybridRenderer, BackendStats, spp))
+        .def_readonly("busy_time", &BackendStats::busy_time,
+                      D(HybridRenderer, BackendStats, busy_time))
+        .def_readonly("utilization", &BackendStats::utilization,
+                      D(HybridRenderer, BackendStats, utilization))
+        .def_readonly("throughput", &BackendStats::throughput,
+                      D(HybridRenderer, BackendStats, throughput));
+}
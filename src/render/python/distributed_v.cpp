@@ -0,0 +1,89 @@
+#include <mitsuba/render/distributed.h>
+#include <mitsuba/render/scene.h>
+#include <mitsuba/python/python.h>
+
+MI_PY_EXPORT(RenderCoordinator) {
+    MI_PY_IMPORT_TYPES(RenderCoordinator, Scene)
+    MI_PY_CLASS(RenderCoordinator, Object)
+        .def(py::init<uint16_t, uint32_t, float, uint32_t>(),
+             "port"_a = 0, "tile_size"_a = 64, "reissue_factor"_a = 2.f,
+             "max_issues"_a = 3, D(RenderCoordinator, RenderCoordinator))
+        .def("render", &RenderCoordinator::render, "scene"_a,
+             "sensor_index"_a = 0, "seed"_a = 0, "spp"_a = 0,
+             "develop"_a = true, D(RenderCoordinator, render),
+             py::call_guard<py::gil_scoped_release>())
+        .def("shutdown", &RenderCoordinator::shutdown,
+             D(RenderCoordinator, shutdown),
+             py::call_guard<py::gil_scoped_release>())
+        .def_method(RenderCoordinator, port)
+        .def_method(RenderCoordinator, worker_count)
+        .def_method(RenderCoordinator, reissued_count);
+}
+
+MI_PY_EXPORT(RenderWorker) {
+    MI_PY_IMPORT_TYPES(RenderWorker, Scene)
+    MI_PY_CLASS(RenderWorker, Object)
+        .def(py::init<const std::string &, uint16_t>(), "host"_a, "port"_a,
+             D(RenderWorker, RenderWorker),
+             py::call_guard<py::gil_scoped_release>())
+        .def("run", &RenderWorker::run, "scene"_a, D(RenderWorker, run),
+             py::call_guard<py::gil_scoped_release>());
+}
+
+MI_PY_EXPORT(RenderServer) {
+    MI_PY_IMPORT_TYPES(RenderServer, Scene)
+    MI_PY_CLASS(RenderServer, Object)
+        .def(py::init<uint16_t, size_t>(), "port"_a = 0, "max_queued"_a = 64,
+             D(RenderServer, RenderServer))
+        .def("add_scene", &RenderServer::add_scene, "id"_a, "scene"_a,
+             D(RenderServer, add_scene))
+        .def("load_scene", &RenderServer::load_scene, "id"_a, "filename"_a,
+             "defines"_a = RenderParameterList(), D(RenderServer, load_scene),
+             py::call_guard<py::gil_scoped_release>())
+        .def("remove_scene", &RenderServer::remove_scene, "id"_a,
+             D(RenderServer, remove_scene))
+        .def("run", &RenderServer::run, D(RenderServer, run),
+             py::call_guard<py::gil_scoped_release>())
+        .def("shutdown", &RenderServer::shutdown, D(RenderServer, shutdown),
+             py::call_guard<py::gil_scoped_release>())
+        .def_method(RenderServer, scene_ids)
+        .def_method(RenderServer, port)
+        .def_method(RenderServer, jobs_completed);
+}
+
+MI_PY_EXPORT(MultiDeviceRenderer) {
+    MI_PY_IMPORT_TYPES(MultiDeviceRenderer, Scene)
+    using DeviceStats = typename MultiDeviceRenderer::DeviceStats;
+
+    auto cls = MI_PY_CLASS(MultiDeviceRenderer, Object)
+        .def(py::init<const fs::path &, const std::vector<int> &,
+                      const RenderParameterList &>(),
+             "filename"_a, "devices"_a = std::vector<int>(),
+             "defines"_a = RenderParameterList(),
+             D(MultiDeviceRenderer, MultiDeviceRenderer),
+             py::call_guard<py::gil_scoped_release>())
+        .def("render", &MultiDeviceRenderer::render, "sensor_index"_a = 0,
+             "seed"_a = 0, "spp"_a = 0, "spp_per_pass"_a = 0,
+             "develop"_a = true, D(MultiDeviceRenderer, render),
+             py::call_guard<py::gil_scoped_release>())
+        .def("scene", &MultiDeviceRenderer::scene, "index"_a = 0,
+             D(MultiDeviceRenderer, scene))
+        .def_method(MultiDeviceRenderer, devices)
+        .def_method(MultiDeviceRenderer, device_stats)
+        .def_method(MultiDeviceRenderer, scaling_efficiency);
+
+    py::class_<DeviceStats>(cls, "DeviceStats",
+                            D(MultiDeviceRenderer, DeviceStats))
+        .def_readonly("device", &DeviceStats::device,
+                      D(MultiDeviceRenderer, DeviceStats, device))
+        .def_readonly("passes", &DeviceStats::passes,
+                      D(MultiDeviceRenderer, DeviceStats, passes))
+        .def_readonly("spp", &DeviceStats::spp,
+                      D(MultiDeviceRenderer, DeviceStats, spp))
+        .def_readonly("busy_time", &DeviceStats::busy_time,
+                      D(MultiDeviceRenderer, DeviceStats, busy_time))
+        .def_readonly("utilization", &DeviceStats::utilization,
+                      D(MultiDeviceRenderer, DeviceStats, utilization))
+        .def_readonly("throughput", &DeviceStats::throughput,
+                      D(MultiDeviceRenderer, DeviceStats, throughput));
+}
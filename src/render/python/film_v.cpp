@@ -38,8 +38,14 @@ public:
         PYBIND11_OVERRIDE_PURE(ref<Bitmap>, Film, bitmap, raw);
     }
 
-    void write(const fs::path &path) const override {
-        PYBIND11_OVERRIDE_PURE(void, Film, write, path);
+    ref<Bitmap> develop_preview(float exposure, bool aces,
+                                Struct::Type component_format) const override {
+        PYBIND11_OVERRIDE(ref<Bitmap>, Film, develop_preview, exposure, aces,
+                          component_format);
+    }
+
+    void write(const fs::path &path, bool write_async) const override {
+        PYBIND11_OVERRIDE_PURE(void, Film, write, path, write_async);
     }
 
     void schedule_storage() override {
@@ -80,14 +86,16 @@ MI_PY_EXPORT(Film) {
     m.def("has_flag", [](uint32_t flags, FilmFlags f) {return has_flag(flags, f);});
     m.def("has_flag", [](UInt32   flags, FilmFlags f) {return has_flag(flags, f);});
 
-    MI_PY_TRAMPOLINE_CLASS(PyFilm, Film, Object)
+    auto film = MI_PY_TRAMPOLINE_CLASS(PyFilm, Film, Object)
         .def(py::init<const Properties &>(), "props"_a)
         .def_method(Film, prepare, "aovs"_a)
         .def_method(Film, put_block, "block"_a)
         .def_method(Film, clear)
         .def_method(Film, develop, "raw"_a = false)
         .def_method(Film, bitmap, "raw"_a = false)
-        .def_method(Film, write, "path"_a)
+        .def_method(Film, develop_preview, "exposure"_a = 0.f, "aces"_a = false,
+                    "component_format"_a = Struct::Type::UInt8)
+        .def_method(Film, write, "path"_a, "write_async"_a = false)
         .def_method(Film, sample_border)
         .def_method(Film, base_channels_count)
         // Make sure to return a copy of those members as they might also be
@@ -120,5 +128,8 @@ MI_PY_EXPORT(Film) {
         .def_method(Film, sensor_response_function)
         .def_method(Film, flags);
 
+    // Exports the developed image
+    bind_dlpack(film, "develop");
+
     MI_PY_REGISTER_OBJECT("register_film", Film)
 }
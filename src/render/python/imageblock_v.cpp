@@ -1,10 +1,11 @@
 #include <mitsuba/core/bitmap.h>
+#include <mitsuba/core/stream.h>
 #include <mitsuba/render/imageblock.h>
 #include <mitsuba/python/python.h>
 
 MI_PY_EXPORT(ImageBlock) {
     MI_PY_IMPORT_TYPES(ImageBlock, ReconstructionFilter)
-    MI_PY_CLASS(ImageBlock, Object)
+    auto block = MI_PY_CLASS(ImageBlock, Object)
         .def(py::init<const ScalarVector2u &, const ScalarPoint2i &, uint32_t,
                       const ReconstructionFilter *, bool, bool, bool,
                       bool, bool, bool>(),
@@ -21,6 +22,8 @@ MI_PY_EXPORT(ImageBlock) {
              "coalesce"_a = dr::is_jit_v<Float>, "compensate"_a = false,
              "warn_negative"_a = std::is_scalar_v<Float>,
              "warn_invalid"_a  = std::is_scalar_v<Float>)
+        .def(py::init<Stream *>(), "stream"_a, D(ImageBlock, ImageBlock, 3))
+        .def("write", &ImageBlock::write, "stream"_a, D(ImageBlock, write))
         .def("put_block", &ImageBlock::put_block, D(ImageBlock, put_block),
              "block"_a)
         .def("put",
@@ -51,6 +54,8 @@ MI_PY_EXPORT(ImageBlock) {
         .def_method(ImageBlock, set_coalesce)
         .def_method(ImageBlock, compensate)
         .def_method(ImageBlock, set_compensate)
+        .def_method(ImageBlock, replicas)
+        .def_method(ImageBlock, set_replicas, "value"_a)
         .def_method(ImageBlock, width)
         .def_method(ImageBlock, height)
         .def_method(ImageBlock, rfilter)
@@ -66,4 +71,6 @@ MI_PY_EXPORT(ImageBlock) {
         .def("tensor", py::overload_cast<>(&ImageBlock::tensor),
              py::return_value_policy::reference_internal,
              D(ImageBlock, tensor));
+
+    bind_dlpack(block, "tensor");
 }
@@ -72,6 +72,15 @@ public:
             scene, sensor, seed, spp, develop, evaluate);
     }
 
+    TensorXf render_ensemble(Scene *scene,
+                             uint32_t ensemble_size,
+                             Sensor *sensor,
+                             uint32_t seed,
+                             uint32_t spp) override {
+        PYBIND11_OVERRIDE(TensorXf, SamplingIntegrator, render_ensemble,
+            scene, ensemble_size, sensor, seed, spp);
+    }
+
     TensorXf render_forward(Scene* scene,
                             void* params,
                             Sensor *sensor,
@@ -211,6 +220,15 @@ public:
         PYBIND11_OVERRIDE(TensorXf, Base, render, scene, sensor, seed, spp, develop, evaluate);
     }
 
+    TensorXf render_ensemble(Scene *scene,
+                             uint32_t ensemble_size,
+                             Sensor *sensor,
+                             uint32_t seed,
+                             uint32_t spp) override {
+        PYBIND11_OVERRIDE(TensorXf, Base, render_ensemble, scene, ensemble_size,
+                          sensor, seed, spp);
+    }
+
     TensorXf render_forward(Scene* scene,
                             void* params,
                             Sensor *sensor,
@@ -317,6 +335,28 @@ MI_PY_EXPORT(Integrator) {
             },
             D(Integrator, render, 2), "scene"_a, "sensor"_a = 0,
             "seed"_a = 0, "spp"_a = 0, "develop"_a = true, "evaluate"_a = true)
+        .def(
+            "render_ensemble",
+            [&](Integrator *integrator, Scene *scene, uint32_t ensemble_size,
+                Sensor *sensor, uint32_t seed, uint32_t spp) {
+                py::gil_scoped_release release;
+                ScopedSignalHandler sh(integrator);
+                return integrator->render_ensemble(scene, ensemble_size,
+                                                   sensor, seed, spp);
+            },
+            D(Integrator, render_ensemble), "scene"_a, "ensemble_size"_a,
+            "sensor"_a, "seed"_a = 0, "spp"_a = 0)
+        .def(
+            "render_ensemble",
+            [&](Integrator *integrator, Scene *scene, uint32_t ensemble_size,
+                uint32_t sensor, uint32_t seed, uint32_t spp) {
+                py::gil_scoped_release release;
+                ScopedSignalHandler sh(integrator);
+                return integrator->render_ensemble(scene, ensemble_size,
+                                                   sensor, seed, spp);
+            },
+            D(Integrator, render_ensemble, 2), "scene"_a, "ensemble_size"_a,
+            "sensor"_a = 0, "seed"_a = 0, "spp"_a = 0)
         .def_method(Integrator, cancel)
         .def_method(Integrator, should_stop)
         .def_method(Integrator, aov_names);
@@ -378,6 +418,21 @@ MI_PY_EXPORT(Integrator) {
             },
             "scene"_a, "params"_a, "grad_in"_a, "sensor"_a = 0, "seed"_a = 0,
             "spp"_a = 0)
+        .def("set_sample_budget",
+             py::overload_cast<const TensorXf &>(&SamplingIntegrator::set_sample_budget),
+             "budget"_a, D(SamplingIntegrator, set_sample_budget))
+        .def("set_sample_budget",
+             py::overload_cast<const ScalarPoint2f &, ScalarFloat, ScalarFloat,
+                               ScalarFloat>(&SamplingIntegrator::set_sample_budget),
+             "center"_a, "radius"_a, "falloff"_a, "min_fraction"_a = 0.f,
+             D(SamplingIntegrator, set_sample_budget, 2))
+        .def_method(SamplingIntegrator, clear_sample_budget)
+        .def_method(SamplingIntegrator, clear_primary_ray_cache)
+        .def_method(SamplingIntegrator, set_cost_aovs, "value"_a)
+        .def_method(SamplingIntegrator, cost_aovs)
+        .def_method(SamplingIntegrator, has_cost_counters)
+        .def_method(SamplingIntegrator, has_sample_budget)
+        .def_method(SamplingIntegrator, budget_sample_count, "pixel"_a, "spp"_a)
         .def_readwrite("hide_emitters", &PySamplingIntegrator::m_hide_emitters);
 
     MI_PY_REGISTER_OBJECT("register_integrator", Integrator)
@@ -13,7 +13,8 @@ MI_PY_EXPORT(RayFlags) {
         .def_value(RayFlags, FollowShape)
         .def_value(RayFlags, DetachShape)
         .def_value(RayFlags, All)
-        .def_value(RayFlags, AllNonDifferentiable);
+        .def_value(RayFlags, AllNonDifferentiable)
+        .def_value(RayFlags, Geometric);
 
         MI_PY_DECLARE_ENUM_OPERATORS(RayFlags, e)
 }
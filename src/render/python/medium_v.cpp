@@ -20,6 +20,10 @@ public:
         PYBIND11_OVERRIDE_PURE(UnpolarizedSpectrum, Medium, get_majorant, mi, active);
     }
 
+    UnpolarizedSpectrum get_control_extinction(const MediumInteraction3f &mi, Mask active = true) const override {
+        PYBIND11_OVERRIDE(UnpolarizedSpectrum, Medium, get_control_extinction, mi, active);
+    }
+
     std::tuple<UnpolarizedSpectrum, UnpolarizedSpectrum, UnpolarizedSpectrum>
     get_scattering_coefficients(const MediumInteraction3f &mi, Mask active = true) const override {
         using Return = std::tuple<UnpolarizedSpectrum, UnpolarizedSpectrum, UnpolarizedSpectrum>;
@@ -34,6 +38,14 @@ public:
         PYBIND11_OVERRIDE(void, Medium, traverse, cb);
     }
 
+    UnpolarizedSpectrum get_radiance(const MediumInteraction3f &mi, Mask active = true) const override {
+        PYBIND11_OVERRIDE(UnpolarizedSpectrum, Medium, get_radiance, mi, active);
+    }
+
+    ScalarBoundingBox3f bbox() const override {
+        PYBIND11_OVERRIDE(ScalarBoundingBox3f, Medium, bbox, );
+    }
+
     void parameters_changed(const std::vector<std::string> &keys) override {
         PYBIND11_OVERRIDE(void, Medium, parameters_changed, keys);
     }
@@ -41,6 +53,7 @@ public:
     using Medium::m_sample_emitters;
     using Medium::m_is_homogeneous;
     using Medium::m_has_spectral_extinction;
+    using Medium::m_is_emitter;
 };
 
 template <typename Ptr, typename Cls> void bind_medium_generic(Cls &cls) {
@@ -58,11 +71,22 @@ template <typename Ptr, typename Cls> void bind_medium_generic(Cls &cls) {
        .def("has_spectral_extinction",
             [](Ptr ptr) { return ptr->has_spectral_extinction(); },
             D(Medium, has_spectral_extinction))
+       .def("is_emitter",
+            [](Ptr ptr) { return ptr->is_emitter(); },
+            D(Medium, is_emitter))
+       .def("emitter",
+            [](Ptr ptr) { return ptr->emitter(); },
+            D(Medium, emitter))
        .def("get_majorant",
             [](Ptr ptr, const MediumInteraction3f &mi, Mask active) {
                 return ptr->get_majorant(mi, active); },
             "mi"_a, "active"_a=true,
             D(Medium, get_majorant))
+       .def("get_control_extinction",
+            [](Ptr ptr, const MediumInteraction3f &mi, Mask active) {
+                return ptr->get_control_extinction(mi, active); },
+            "mi"_a, "active"_a=true,
+            D(Medium, get_control_extinction))
        .def("intersect_aabb",
             [](Ptr ptr, const Ray3f &ray) {
                 return ptr->intersect_aabb(ray); },
@@ -83,7 +107,12 @@ template <typename Ptr, typename Cls> void bind_medium_generic(Cls &cls) {
             [](Ptr ptr, const MediumInteraction3f &mi, Mask active = true) {
                 return ptr->get_scattering_coefficients(mi, active); },
             "mi"_a, "active"_a=true,
-            D(Medium, get_scattering_coefficients));
+            D(Medium, get_scattering_coefficients))
+       .def("get_radiance",
+            [](Ptr ptr, const MediumInteraction3f &mi, Mask active = true) {
+                return ptr->get_radiance(mi, active); },
+            "mi"_a, "active"_a=true,
+            D(Medium, get_radiance));
 
     if constexpr (dr::is_array_v<Ptr>)
         bind_drjit_ptr_array(cls);
@@ -117,6 +146,14 @@ MI_PY_EXPORT(Medium) {
                     dr::set_attr(&medium, "has_spectral_extinction", value);
                 }
             )
+            .def_property("m_is_emitter",
+                [](PyMedium &medium){ return medium.m_is_emitter; },
+                [](PyMedium &medium, bool value){
+                    medium.m_is_emitter = value;
+                    dr::set_attr(&medium, "is_emitter", value);
+                }
+            )
+            .def_method(Medium, bbox)
             .def("__repr__", &Medium::to_string);
 
     bind_medium_generic<Medium *>(medium);
@@ -6,4 +6,9 @@ MI_PY_EXPORT(MicrofacetType) {
     py::enum_<MicrofacetType>(m, "MicrofacetType", D(MicrofacetType), py::arithmetic())
         .def_value(MicrofacetType, Beckmann)
         .def_value(MicrofacetType, GGX);
+
+    py::enum_<VNDFSampling>(m, "VNDFSampling", D(VNDFSampling))
+        .def_value(VNDFSampling, Heitz)
+        .def_value(VNDFSampling, SphericalCaps)
+        .def_value(VNDFSampling, BoundedSphericalCaps);
 }
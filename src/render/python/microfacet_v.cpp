@@ -23,6 +23,8 @@ MI_PY_EXPORT(MicrofacetDistribution) {
         .def_method(MicrofacetDistribution, alpha_u)
         .def_method(MicrofacetDistribution, alpha_v)
         .def_method(MicrofacetDistribution, sample_visible)
+        .def_method(MicrofacetDistribution, vndf_sampling)
+        .def_method(MicrofacetDistribution, set_vndf_sampling, "method"_a)
         .def_method(MicrofacetDistribution, is_anisotropic)
         .def_method(MicrofacetDistribution, is_isotropic)
         .def_method(MicrofacetDistribution, scale_alpha, "value"_a)
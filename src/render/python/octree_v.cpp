@@ -0,0 +1,45 @@
+#include <mitsuba/render/octree.h>
+#include <mitsuba/python/python.h>
+
+MI_PY_EXPORT(octree) {
+    MI_PY_IMPORT_TYPES()
+
+    m.def("build_guiding_octree",
+        [](const Point3f &points, uint32_t x_slices, uint32_t max_depth,
+           uint32_t max_leaf_count) {
+            using FloatStorage = DynamicBuffer<Float>;
+
+            // Copy the points to the host once
+            auto &&x = dr::migrate(FloatStorage(dr::detach(points.x())), AllocType::Host);
+            auto &&y = dr::migrate(FloatStorage(dr::detach(points.y())), AllocType::Host);
+            auto &&z = dr::migrate(FloatStorage(dr::detach(points.z())), AllocType::Host);
+            if constexpr (dr::is_jit_v<Float>)
+                dr::sync_thread();
+
+            std::vector<ScalarBoundingBox3f> leaves;
+            {
+                py::gil_scoped_release release;
+                leaves = build_guiding_octree<ScalarFloat>(
+                    x.data(), y.data(), z.data(), dr::width(points), x_slices,
+                    max_depth, max_leaf_count);
+            }
+
+            size_t n = leaves.size();
+            std::unique_ptr<ScalarFloat[]> data(new ScalarFloat[n * 6]);
+            for (size_t i = 0; i < n; ++i) {
+                for (size_t j = 0; j < 3; ++j) {
+                    data[j * n + i]       = leaves[i].min[j];
+                    data[(j + 3) * n + i] = leaves[i].max[j];
+                }
+            }
+
+            auto load = [&](size_t j) {
+                return dr::load<FloatStorage>(data.get() + j * n, n);
+            };
+
+            return std::make_pair(Point3f(load(0), load(1), load(2)),
+                                  Point3f(load(3), load(4), load(5)));
+        },
+        "points"_a, "x_slices"_a, "max_depth"_a, "max_leaf_count"_a,
+        D(build_guiding_octree));
+}
@@ -0,0 +1,52 @@
+#include <mitsuba/render/raystats.h>
+#include <mitsuba/render/renderstats.h>
+#include <mitsuba/python/python.h>
+
+MI_PY_EXPORT(RenderStats) {
+    py::class_<RenderStats>(m, "RenderStats", D(RenderStats))
+        .def_static_method(RenderStats, set_enabled, "value"_a)
+        .def_static_method(RenderStats, enabled)
+        .def_static_method(RenderStats, begin)
+        .def_static_method(RenderStats, end, "vcall_targets"_a)
+        .def_static("last", []() {
+            RenderStats stats = RenderStats::last();
+            py::list kernels;
+            for (const RenderStats::Kernel &k : stats.kernels) {
+                py::dict d;
+                d["type"]            = k.type;
+                d["hash"]            = k.hash;
+                d["size"]            = k.size;
+                d["operation_count"] = k.operation_count;
+                d["cache_hit"]       = k.cache_hit;
+                d["cache_disk"]      = k.cache_disk;
+                d["codegen_time"]    = k.codegen_time;
+                d["backend_time"]    = k.backend_time;
+                d["execution_time"]  = k.execution_time;
+                kernels.append(d);
+            }
+            py::dict vcall_targets;
+            for (auto &[domain, count] : stats.vcall_targets)
+                vcall_targets[py::str(domain)] = count;
+
+            py::dict result;
+            result["kernels"]       = kernels;
+            result["vcall_targets"] = vcall_targets;
+            result["render_time"]   = stats.render_time;
+            result["peak_memory"]   = stats.peak_memory;
+            result["cache_misses"]  = stats.cache_misses();
+            return result;
+        }, D(RenderStats, last))
+        .def_static("report", []() { return RenderStats::last().to_string(); },
+                    D(RenderStats, to_string));
+
+    py::class_<RayStatistics> rs(m, "RayStatistics", D(RayStatistics));
+    py::enum_<RayStatistics::Counter>(rs, "Counter", D(RayStatistics, Counter))
+        .value("CameraRays",     RayStatistics::CameraRays, D(RayStatistics, CameraRays))
+        .value("IntersectRays",  RayStatistics::IntersectRays, D(RayStatistics, IntersectRays))
+        .value("ShadowRays",     RayStatistics::ShadowRays, D(RayStatistics, ShadowRays))
+        .value("NodeVisits",     RayStatistics::NodeVisits, D(RayStatistics, NodeVisits))
+        .value("PrimitiveTests", RayStatistics::PrimitiveTests, D(RayStatistics, PrimitiveTests));
+    rs.def_static_method(RayStatistics, reset)
+      .def_static_method(RayStatistics, value, "counter"_a)
+      .def_static_method(RayStatistics, report, "time"_a);
+}
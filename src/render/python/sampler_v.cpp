@@ -21,6 +21,10 @@ public:
 
     void advance() override { PYBIND11_OVERRIDE(void, Sampler, advance); }
 
+    void set_pixel(const Point2u &pixel) override {
+        PYBIND11_OVERRIDE(void, Sampler, set_pixel, pixel);
+    }
+
     Float next_1d(Mask active = true) override {
         PYBIND11_OVERRIDE_PURE(Float, Sampler, next_1d, active);
     }
@@ -60,6 +64,7 @@ MI_PY_EXPORT(Sampler) {
         .def_method(Sampler, schedule_state)
         .def_method(Sampler, loop_put, "loop"_a)
         .def_method(Sampler, seed, "seed"_a, "wavefront_size"_a = (uint32_t) -1)
+        .def_method(Sampler, set_pixel, "pixel"_a)
         .def_method(Sampler, next_1d, "active"_a = true)
         .def_method(Sampler, next_2d, "active"_a = true);
 
@@ -146,5 +146,8 @@ MI_PY_EXPORT(Scene) {
              },
              D(Scene, integrator))
         .def_method(Scene, shapes_grad_enabled)
+        .def_method(Scene, update_emitter_cache)
+        .def_method(Scene, memory_usage)
+        .def_method(Scene, memory_report, "max_objects"_a = 20)
         .def("__repr__", &Scene::to_string);
 }
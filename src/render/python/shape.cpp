@@ -1,4 +1,5 @@
 #include <mitsuba/render/shape.h>
+#include <mitsuba/render/optix_api.h>
 #include <mitsuba/core/properties.h>
 #include <mitsuba/python/python.h>
 
@@ -23,7 +24,17 @@ MI_PY_EXPORT(DiscontinuityFlags) {
         .def_value(ShapeType, Rectangle)
         .def_value(ShapeType, SDFGrid)
         .def_value(ShapeType, Sphere)
+        .def_value(ShapeType, Spheres)
         .def_value(ShapeType, Other);
 
         MI_PY_DECLARE_ENUM_OPERATORS(ShapeType, shape_types)
 }
+
+MI_PY_EXPORT(optix) {
+#if defined(MI_ENABLE_CUDA)
+    m.def("optix_configure_cache", &optix_configure_cache, "path"_a,
+          "max_size"_a = 0, D(optix_configure_cache));
+#else
+    DRJIT_MARK_USED(m);
+#endif
+}
@@ -221,6 +221,7 @@ MI_PY_EXPORT(Shape) {
             &Shape::bbox, py::const_), D(Shape, bbox, 3), "index"_a, "clip"_a)
         .def_method(Shape, id)
         .def_method(Shape, is_mesh)
+        .def_method(Shape, is_animated)
         .def_method(Shape, parameters_grad_enabled)
         .def_method(Shape, primitive_count)
         .def_method(Shape, effective_primitive_count)
@@ -251,6 +252,27 @@ MI_PY_EXPORT(Shape) {
         .def_method(Mesh, face_count)
         .def_method(Mesh, has_vertex_normals)
         .def_method(Mesh, has_vertex_texcoords)
+        .def_method(Mesh, has_compact_vertex_attributes)
+        .def_method(Mesh, motion_key_count)
+        .def_method(Mesh, decoded_vertex_normals)
+        .def_method(Mesh, decoded_vertex_texcoords)
+        // The buffers share their memory with the mesh and can be passed to
+        // other frameworks via DLPack without copies
+        .def("vertex_positions_buffer",
+             [](Mesh &m) { return m.vertex_positions_buffer(); },
+             D(Mesh, vertex_positions_buffer))
+        .def("vertex_motion_positions_buffer",
+             [](Mesh &m) { return m.vertex_motion_positions_buffer(); },
+             D(Mesh, vertex_motion_positions_buffer))
+        .def("vertex_normals_buffer",
+             [](Mesh &m) { return m.vertex_normals_buffer(); },
+             D(Mesh, vertex_normals_buffer))
+        .def("vertex_texcoords_buffer",
+             [](Mesh &m) { return m.vertex_texcoords_buffer(); },
+             D(Mesh, vertex_texcoords_buffer))
+        .def("faces_buffer",
+             [](Mesh &m) { return m.faces_buffer(); },
+             D(Mesh, faces_buffer))
         .def("write_ply",
              py::overload_cast<const std::string &>(&Mesh::write_ply, py::const_),
              "filename"_a, D(Mesh, write_ply))
@@ -262,6 +284,9 @@ MI_PY_EXPORT(Shape) {
         .def("vertex_position", [](const Mesh &m, UInt32 index, Mask active) {
                 return m.vertex_position(index, active);
              }, D(Mesh, vertex_position), "index"_a, "active"_a = true)
+        .def("vertex_position_at", [](const Mesh &m, UInt32 index, Float time, Mask active) {
+                return m.vertex_position_at(index, time, active);
+             }, D(Mesh, vertex_position_at), "index"_a, "time"_a, "active"_a = true)
         .def("vertex_normal", [](const Mesh &m, UInt32 index, Mask active) {
                 return m.vertex_normal(index, active);
              }, D(Mesh, vertex_normal), "index"_a, "active"_a = true)
@@ -271,6 +296,11 @@ MI_PY_EXPORT(Shape) {
         .def("face_indices", [](const Mesh &m, UInt32 index, Mask active) {
                 return m.face_indices(index, active);
              }, D(Mesh, face_indices), "index"_a, "active"_a = true)
+        .def("opposite_dedge", [](const Mesh &m, UInt32 index, Mask active) {
+                return m.opposite_dedge(index, active);
+             }, D(Mesh, opposite_dedge), "index"_a, "active"_a = true)
+        .def_method(Mesh, silhouette_edge_weight, "viewpoint"_a, "dedge"_a,
+                    "active"_a = true)
         .def("ray_intersect_triangle", &Mesh::ray_intersect_triangle,
              "index"_a, "ray"_a, "active"_a = true,
              D(Mesh, ray_intersect_triangle));
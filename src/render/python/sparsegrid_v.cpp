@@ -0,0 +1,59 @@
+#include <mitsuba/render/sparsegrid.h>
+#include <mitsuba/render/volumegrid.h>
+#include <mitsuba/core/filesystem.h>
+#include <mitsuba/core/stream.h>
+#include <pybind11/numpy.h>
+#include <mitsuba/python/python.h>
+
+MI_PY_EXPORT(SparseVolumeGrid) {
+    MI_PY_IMPORT_TYPES(SparseVolumeGrid, VolumeGrid)
+    MI_PY_CLASS(SparseVolumeGrid, Object)
+        .def(py::init<const fs::path &>(), "path"_a,
+            py::call_guard<py::gil_scoped_release>())
+        .def(py::init<Stream *>(), "stream"_a,
+            py::call_guard<py::gil_scoped_release>())
+        .def(py::init<const VolumeGrid *, ScalarFloat>(), "grid"_a,
+            "threshold"_a = 0.f, D(SparseVolumeGrid, SparseVolumeGrid, 3),
+            py::call_guard<py::gil_scoped_release>())
+        .def(py::init([](const ScalarVector3u &size,
+                         py::array_t<ScalarUInt32> coords,
+                         py::array_t<ScalarFloat> values) {
+            coords = py::array::ensure(coords, py::array::c_style);
+            values = py::array::ensure(values, py::array::c_style);
+            if (coords.ndim() != 2 || coords.shape()[1] != 3)
+                throw py::type_error("Expected an array of voxel coordinates "
+                                     "with shape (N, 3)");
+            if (values.ndim() != 1 && values.ndim() != 2)
+                throw py::type_error("Expected an array of voxel values with "
+                                     "shape (N,) or (N, channels)");
+            if (values.shape()[0] != coords.shape()[0])
+                throw py::type_error("The number of voxel coordinates and "
+                                     "values must match");
+
+            ScalarUInt32 channel_count =
+                values.ndim() == 2 ? (ScalarUInt32) values.shape()[1] : 1;
+            return new SparseVolumeGrid(size, channel_count, coords.data(),
+                                        values.data(), coords.shape()[0]);
+        }), "size"_a, "coords"_a, "values"_a, D(SparseVolumeGrid, SparseVolumeGrid, 4))
+
+        .def_method(SparseVolumeGrid, size)
+        .def_method(SparseVolumeGrid, channel_count)
+        .def_method(SparseVolumeGrid, root_size)
+        .def_method(SparseVolumeGrid, node_count)
+        .def_method(SparseVolumeGrid, leaf_count)
+        .def_method(SparseVolumeGrid, max)
+        .def("max_per_channel",
+            [] (const SparseVolumeGrid *grid) {
+                std::vector<ScalarFloat> max_values(grid->channel_count());
+                grid->max_per_channel(max_values.data());
+                return max_values;
+            },
+            D(SparseVolumeGrid, max_per_channel))
+        .def_method(SparseVolumeGrid, occupancy)
+        .def_method(SparseVolumeGrid, buffer_size)
+        .def("write", py::overload_cast<Stream *>(&SparseVolumeGrid::write, py::const_),
+            "stream"_a, D(SparseVolumeGrid, write), py::call_guard<py::gil_scoped_release>())
+        .def("write", py::overload_cast<const fs::path &>(
+                &SparseVolumeGrid::write, py::const_), "path"_a, D(SparseVolumeGrid, write, 2),
+                py::call_guard<py::gil_scoped_release>());
+}
@@ -9,6 +9,9 @@ MI_PY_EXPORT(Spiral) {
             D(Spiral, Spiral))
         .def_method(Spiral, max_block_size)
         .def_method(Spiral, block_count)
+        .def_method(Spiral, total_block_count)
+        .def_method(Spiral, set_straggler_blocks, "count"_a)
+        .def_method(Spiral, set_scanline_order)
         .def_method(Spiral, reset)
         .def_method(Spiral, next_block);
 }
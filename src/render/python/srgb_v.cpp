@@ -3,7 +3,9 @@
 
 MI_PY_EXPORT(srgb) {
     MI_PY_IMPORT_TYPES()
-    m.def("srgb_model_fetch", &srgb_model_fetch, D(srgb_model_fetch))
+    m.def("srgb_model_fetch",
+          py::overload_cast<const Color<float, 3> &>(&srgb_model_fetch),
+          D(srgb_model_fetch))
     // .def("srgb_model_eval_rgb", &srgb_model_eval_rgb, D(srgb_model_eval_rgb))
     .def("srgb_model_eval",
         &srgb_model_eval<unpolarized_spectrum_t<Spectrum>, dr::Array<Float, 3>>,
@@ -12,4 +14,9 @@ MI_PY_EXPORT(srgb) {
         &srgb_model_mean<dr::Array<Float, 3>>,
         D(srgb_model_mean))
       ;
+
+    if constexpr (dr::is_jit_v<Float>)
+        m.def("srgb_model_fetch",
+              [](const Color3f &c) { return srgb_model_fetch(c); },
+              "c"_a, D(srgb_model_fetch, 2));
 }
@@ -39,6 +39,10 @@ public:
         PYBIND11_OVERRIDE_PURE(ScalarFloat, Volume, max);
     }
 
+    ScalarFloat min() const override {
+        PYBIND11_OVERRIDE(ScalarFloat, Volume, min);
+    }
+
     ScalarVector3i resolution() const override {
         PYBIND11_OVERRIDE(ScalarVector3i, Volume, resolution);
     }
@@ -56,8 +60,10 @@ MI_PY_EXPORT(Volume) {
         .def(py::init<const Properties &>(), "props"_a)
         .def_method(Volume, resolution)
         .def_method(Volume, bbox)
+        .def_method(Volume, to_local)
         .def_method(Volume, channel_count)
         .def_method(Volume, max)
+        .def_method(Volume, min)
         .def("max_per_channel",
             [] (const Volume *volume) {
                 std::vector<ScalarFloat> max_values(volume->channel_count());
@@ -65,6 +71,7 @@ MI_PY_EXPORT(Volume) {
                 return max_values;
             },
             D(Volume, max_per_channel))
+        .def_method(Volume, max_per_supervoxel, "resolution"_a)
         .def_method(Volume, eval, "it"_a, "active"_a = true)
         .def_method(Volume, eval_1, "it"_a, "active"_a = true)
         .def_method(Volume, eval_3, "it"_a, "active"_a = true)
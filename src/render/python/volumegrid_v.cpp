@@ -54,6 +54,7 @@ MI_PY_EXPORT(VolumeGrid) {
                 volgrid->set_max_per_channel(max_values.data());
             },
             D(VolumeGrid, set_max_per_channel))
+        .def_method(VolumeGrid, is_memory_mapped)
         .def_method(VolumeGrid, bytes_per_voxel)
         .def_method(VolumeGrid, buffer_size)
         .def("write", py::overload_cast<Stream *>(&VolumeGrid::write, py::const_),
@@ -62,8 +63,8 @@ MI_PY_EXPORT(VolumeGrid) {
                 &VolumeGrid::write, py::const_), "path"_a, D(VolumeGrid, write, 2),
                 py::call_guard<py::gil_scoped_release>())
 
-        .def(py::init<const fs::path &>(), "path"_a,
-            py::call_guard<py::gil_scoped_release>())
+        .def(py::init<const fs::path &, bool>(), "path"_a, "memory_map"_a = true,
+            D(VolumeGrid, VolumeGrid), py::call_guard<py::gil_scoped_release>())
         .def(py::init<Stream *>(), "stream"_a,
             py::call_guard<py::gil_scoped_release>())
 
@@ -89,7 +90,7 @@ MI_PY_EXPORT(VolumeGrid) {
                 result["typestr"] = py::bytes(code);
             #endif
 
-            result["data"] = py::make_tuple(size_t(grid.data()), false);
+            result["data"] = py::make_tuple(size_t(grid.data()), grid.is_memory_mapped());
             result["version"] = 3;
             return py::object(result);
         });
@@ -0,0 +1,82 @@
+#include <mitsuba/render/raystats.h>
+#include <mitsuba/core/util.h>
+#include <sstream>
+#include <algorithm>
+
+#if defined(MI_ENABLE_RAY_STATISTICS)
+#  include <mutex>
+#  include <vector>
+#endif
+
+NAMESPACE_BEGIN(mitsuba)
+
+#if defined(MI_ENABLE_RAY_STATISTICS)
+thread_local RayStatisticsRecord *ray_statistics_record = nullptr;
+
+/* Records are never released so that the counters of threads that have
+   already exited remain part of the totals */
+static std::mutex ray_statistics_mutex;
+static std::vector<RayStatisticsRecord *> ray_statistics_records;
+
+RayStatisticsRecord *ray_statistics_register_thread() {
+    RayStatisticsRecord *record = new RayStatisticsRecord();
+    ray_statistics_record = record;
+    std::lock_guard<std::mutex> guard(ray_statistics_mutex);
+    ray_statistics_records.push_back(record);
+    return record;
+}
+#endif
+
+void RayStatistics::reset() {
+#if defined(MI_ENABLE_RAY_STATISTICS)
+    std::lock_guard<std::mutex> guard(ray_statistics_mutex);
+    for (RayStatisticsRecord *record : ray_statistics_records)
+        for (uint32_t i = 0; i < CounterCount; ++i)
+            record->value[i].store(0, std::memory_order_relaxed);
+#endif
+}
+
+uint64_t RayStatistics::value(Counter counter) {
+#if defined(MI_ENABLE_RAY_STATISTICS)
+    std::lock_guard<std::mutex> guard(ray_statistics_mutex);
+    uint64_t sum = 0;
+    for (RayStatisticsRecord *record : ray_statistics_records)
+        sum += record->value[counter].load(std::memory_order_relaxed);
+    return sum;
+#else
+    (void) counter;
+    return 0;
+#endif
+}
+
+std::string RayStatistics::report(float time) {
+#if defined(MI_ENABLE_RAY_STATISTICS)
+    uint64_t camera    = value(CameraRays),
+             intersect = value(IntersectRays),
+             shadow    = value(ShadowRays),
+             nodes     = value(NodeVisits),
+             prims     = value(PrimitiveTests),
+             rays      = intersect + shadow;
+
+    if (rays == 0)
+        return "";
+
+    auto per_ray = [rays](uint64_t value) { return value / (double) rays; };
+
+    std::ostringstream oss;
+    oss << "Ray statistics:" << std::endl
+        << "  Camera rays     : " << camera << std::endl
+        << "  Indirect rays   : " << (intersect - std::min(camera, intersect)) << std::endl
+        << "  Shadow rays     : " << shadow << std::endl
+        << "  Node visits     : " << nodes << " (" << per_ray(nodes) << " per ray)" << std::endl
+        << "  Primitive tests : " << prims << " (" << per_ray(prims) << " per ray)" << std::endl
+        << "  Throughput      : " << (rays / (double) std::max(time, 1.f) * 1e-3)
+        << " Mrays/s over " << util::time_string(time) << std::endl;
+    return oss.str();
+#else
+    (void) time;
+    return "";
+#endif
+}
+
+NAMESPACE_END(mitsuba)
@@ -0,0 +1,186 @@
+#include <mitsuba/render/renderstats.h>
+#include <mitsuba/core/timer.h>
+#include <mitsuba/core/util.h>
+#include <mutex>
+#include <sstream>
+#include <iomanip>
+
+#if defined(MI_ENABLE_LLVM) || defined(MI_ENABLE_CUDA)
+#  include <drjit-core/jit.h>
+#endif
+
+#if defined(__linux__) || defined(__APPLE__)
+#  include <sys/resource.h>
+#elif defined(_WIN32)
+#  include <windows.h>
+#  include <psapi.h>
+#  pragma comment(lib, "psapi.lib")
+#endif
+
+NAMESPACE_BEGIN(mitsuba)
+
+static std::mutex stats_mutex;
+static bool stats_enabled = false;
+static int stats_depth = 0;
+static bool stats_history_flag = false;
+static Timer stats_timer;
+static RenderStats stats_last;
+
+/// Peak resident set size of the process in bytes
+static size_t peak_memory_usage() {
+#if defined(__linux__) || defined(__APPLE__)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+#  if defined(__APPLE__)
+    return (size_t) usage.ru_maxrss;
+#  else
+    return (size_t) usage.ru_maxrss * 1024;
+#  endif
+#elif defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return 0;
+    return (size_t) counters.PeakWorkingSetSize;
+#else
+    return 0;
+#endif
+}
+
+void RenderStats::set_enabled(bool value) {
+    std::lock_guard<std::mutex> guard(stats_mutex);
+    stats_enabled = value;
+}
+
+bool RenderStats::enabled() {
+    std::lock_guard<std::mutex> guard(stats_mutex);
+    return stats_enabled;
+}
+
+bool RenderStats::begin() {
+#if defined(MI_ENABLE_LLVM) || defined(MI_ENABLE_CUDA)
+    std::lock_guard<std::mutex> guard(stats_mutex);
+    if (!stats_enabled || stats_depth++ > 0)
+        return false;
+
+    // Discard kernels launched before this render() call
+    stats_history_flag = jit_flag(JitFlag::KernelHistory);
+    jit_set_flag(JitFlag::KernelHistory, true);
+    jit_kernel_history_clear();
+    stats_timer.reset();
+    return true;
+#else
+    return false;
+#endif
+}
+
+void RenderStats::end(const std::vector<std::pair<std::string, uint32_t>> &vcall_targets) {
+#if defined(MI_ENABLE_LLVM) || defined(MI_ENABLE_CUDA)
+    std::lock_guard<std::mutex> guard(stats_mutex);
+    if (stats_depth == 0)
+        return;
+    stats_depth = 0;
+
+    jit_sync_all_devices();
+
+    RenderStats stats;
+    stats.render_time = (float) stats_timer.value();
+    stats.vcall_targets = vcall_targets;
+    stats.peak_memory = peak_memory_usage();
+
+    KernelHistoryEntry *history = jit_kernel_history();
+    for (KernelHistoryEntry *e = history; e && e->backend != JitBackend::None; ++e) {
+        Kernel k;
+        switch (e->type) {
+            case KernelType::JIT:         k.type = "JIT"; break;
+            case KernelType::Reduce:      k.type = "Reduce"; break;
+            case KernelType::VCallReduce: k.type = "VCallReduce"; break;
+            default:                      k.type = "Other"; break;
+        }
+        if (e->type == KernelType::JIT) {
+            std::ostringstream oss;
+            oss << std::hex << std::setfill('0') << std::setw(16) << e->hash[1]
+                << std::setw(16) << e->hash[0];
+            k.hash = oss.str();
+        }
+        k.size            = e->size;
+        k.operation_count = e->operation_count;
+        k.cache_hit       = e->cache_hit;
+        k.cache_disk      = e->cache_disk;
+        k.codegen_time    = e->codegen_time;
+        k.backend_time    = e->backend_time;
+        k.execution_time  = e->execution_time;
+        stats.kernels.push_back(k);
+        free(e->ir);
+    }
+    free(history);
+
+    jit_set_flag(JitFlag::KernelHistory, stats_history_flag);
+    stats_last = std::move(stats);
+#else
+    (void) vcall_targets;
+#endif
+}
+
+RenderStats RenderStats::last() {
+    std::lock_guard<std::mutex> guard(stats_mutex);
+    return stats_last;
+}
+
+size_t RenderStats::cache_misses() const {
+    size_t count = 0;
+    for (const Kernel &k : kernels)
+        count += k.type == "JIT" && !k.cache_hit;
+    return count;
+}
+
+std::string RenderStats::to_string() const {
+    float codegen_time = 0.f, backend_time = 0.f, execution_time = 0.f;
+    size_t jit_kernels = 0;
+    for (const Kernel &k : kernels) {
+        codegen_time   += k.codegen_time;
+        backend_time   += k.backend_time;
+        execution_time += k.execution_time;
+        jit_kernels    += k.type == "JIT";
+    }
+
+    std::ostringstream oss;
+    oss << "Render statistics:" << std::endl
+        << "  Render time         : " << util::time_string(render_time, true) << std::endl
+        << "  Kernel launches     : " << kernels.size() << " (" << jit_kernels
+        << " JIT, " << cache_misses() << " compiled)" << std::endl
+        << "  Code generation     : " << util::time_string(codegen_time, true) << std::endl
+        << "  Backend compilation : " << util::time_string(backend_time, true) << std::endl
+        << "  Kernel execution    : " << util::time_string(execution_time, true) << std::endl
+        << "  Peak memory (host)  : " << util::mem_string(peak_memory) << std::endl;
+
+    if (!vcall_targets.empty()) {
+        oss << "  Virtual call targets:";
+        for (auto &[domain, count] : vcall_targets)
+            if (count > 0)
+                oss << " " << domain << "=" << count;
+        oss << std::endl;
+    }
+
+    if (!kernels.empty()) {
+        oss << "  Kernels:" << std::endl;
+        for (size_t i = 0; i < kernels.size(); ++i) {
+            const Kernel &k = kernels[i];
+            oss << "    " << std::setw(3) << i << ": " << std::left
+                << std::setw(11) << k.type << std::right << " size="
+                << std::setw(9) << k.size << ", ops=" << std::setw(6)
+                << k.operation_count << ", "
+                << (k.cache_hit ? (k.cache_disk ? "disk cache" : "cache hit ")
+                                : "compiled  ")
+                << ", exec=" << util::time_string(k.execution_time, true);
+            if (!k.cache_hit)
+                oss << ", compile="
+                    << util::time_string(k.codegen_time + k.backend_time, true);
+            oss << std::endl;
+        }
+    }
+
+    return oss.str();
+}
+
+NAMESPACE_END(mitsuba)
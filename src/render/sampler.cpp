@@ -54,6 +54,8 @@ MI_VARIANT void Sampler<Float, Spectrum>::advance() {
     m_sample_index++;
 }
 
+MI_VARIANT void Sampler<Float, Spectrum>::set_pixel(const Point2u &) { }
+
 MI_VARIANT Float Sampler<Float, Spectrum>::next_1d(Mask) {
     NotImplementedError("next_1d");
 }
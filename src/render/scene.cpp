@@ -3,13 +3,20 @@
 #include <mitsuba/render/bsdf.h>
 #include <mitsuba/render/medium.h>
 #include <mitsuba/render/mesh.h>
+#include <mitsuba/render/raystats.h>
 #include <mitsuba/render/scene.h>
 #include <mitsuba/render/integrator.h>
+#include <mitsuba/render/imageblock.h>
+#include <mitsuba/core/util.h>
+#include <unordered_set>
 
 #if defined(MI_ENABLE_EMBREE)
 #  include "scene_embree.inl"
 #else
 #  include <mitsuba/render/kdtree.h>
+#  include <mitsuba/core/hash.h>
+#  include <mitsuba/core/string.h>
+#  include <mitsuba/render/bvh.h>
 #  include "scene_native.inl"
 #endif
 
@@ -20,6 +27,13 @@
 NAMESPACE_BEGIN(mitsuba)
 
 MI_VARIANT Scene<Float, Spectrum>::Scene(const Properties &props) {
+    m_use_light_tree = props.get<bool>("light_tree", false);
+    m_use_light_culling = props.get<bool>("light_culling", false);
+    m_use_alias_table = props.get<bool>("alias_sampling", false);
+    m_use_emitter_cache = props.get<bool>("emitter_cache", false);
+    m_emitter_cache_resolution = props.get<uint32_t>("emitter_cache_resolution", 16);
+    m_emitter_cache_fraction = props.get<ScalarFloat>("emitter_cache_fraction", .5f);
+
     int id = 0;
     for (auto &[k, v] : props.objects()) {
         Scene *scene           = dynamic_cast<Scene *>(v.get());
@@ -66,10 +80,40 @@ MI_VARIANT Scene<Float, Spectrum>::Scene(const Properties &props) {
         }
     }
 
+    for (size_t i = 0; i < m_emitters.size(); ++i)
+        m_emitters[i]->set_emitter_index((uint32_t) i);
+
     // Create sensors' shapes (environment sensors)
     for (Sensor *sensor: m_sensors)
         sensor->set_scene(this);
 
+    /* Select the levels of detail of the shapes based on their distance to
+       the first sensor. The choice is fixed for the entire rendering, which
+       keeps the geometry consistent across all rays. */
+    if (!m_sensors.empty()) {
+        ScalarPoint3f viewpoint(
+            dr::slice(m_sensors[0]->world_transform().translation()));
+        for (Shape *shape : m_shapes)
+            shape->select_lod(viewpoint);
+    }
+
+    /* Out-of-core rendering: keep at most 'geometry_budget' MiB of the
+       geometry of shape groups in device memory */
+    ScalarFloat geometry_budget = props.get<ScalarFloat>("geometry_budget", 0.f);
+    if (geometry_budget < 0.f)
+        Throw("Scene: 'geometry_budget' must be >= 0!");
+    if (geometry_budget > 0.f) {
+        if constexpr (!dr::is_cuda_v<Float>)
+            Log(Warn, "Scene: 'geometry_budget' is only supported in CUDA "
+                      "variants and will be ignored.");
+        else if (m_shapegroups.empty())
+            Log(Warn, "Scene: 'geometry_budget' has no effect since the scene "
+                      "doesn't contain any shape groups.");
+        else
+            m_geometry_cache = std::make_unique<GeometryCache<Float, Spectrum>>(
+                m_shapegroups, (size_t) (geometry_budget * 1024.0 * 1024.0));
+    }
+
     if constexpr (dr::is_cuda_v<Float>)
         accel_init_gpu(props);
     else
@@ -115,11 +159,44 @@ void Scene<Float, Spectrum>::update_emitter_sampling_distribution() {
             sample_weights[i] = m_emitters[i]->sampling_weight();
         m_emitter_distr = std::make_unique<DiscreteDistribution<Float>>(
             sample_weights.get(), n_emitters);
+        if (m_use_alias_table)
+            m_emitter_distr->set_alias_table(true);
     } else {
         // By default use uniform sampling with constant PMF
         m_emitter_pmf = m_emitters.empty() ? 0.f : (1.f / n_emitters);
         m_emitter_distr = nullptr;
     }
+
+    /* The light tree chooses emitters based on the reference point. It is
+       only used by the direction sampling routines, the methods above remain
+       available for position-independent emitter sampling. Without
+       'light_tree', 'light_culling' still uses it to skip emitters whose
+       bounds exclude the reference point. */
+    if ((m_use_light_tree || m_use_light_culling) && n_emitters > 1) {
+        m_light_tree = std::make_unique<LightTree<Float, Spectrum>>(
+            m_emitters, !m_use_light_tree);
+        if (m_light_tree->tree_size() == 0) {
+            Log(Warn, "Scene: none of the emitters supports the light tree, "
+                      "falling back to regular emitter sampling.");
+            m_light_tree = nullptr;
+        }
+    } else {
+        m_light_tree = nullptr;
+    }
+
+    /* The emitter cache learns which emitters illuminate the different
+       regions of the scene. Its statistics are discarded when the emitters
+       change. */
+    if (m_use_emitter_cache && n_emitters > 1 && m_bbox.valid()) {
+        std::vector<ScalarFloat> weights(n_emitters);
+        for (size_t i = 0; i < n_emitters; ++i)
+            weights[i] = m_emitters[i]->sampling_weight();
+        m_emitter_cache = std::make_unique<EmitterSelectionCache<Float, Spectrum>>(
+            m_bbox, m_emitter_cache_resolution, m_emitter_cache_fraction, weights);
+    } else {
+        m_emitter_cache = nullptr;
+    }
+
     // Clear emitter's dirty flag
     for (auto &e : m_emitters)
         e->set_dirty(false);
@@ -165,6 +242,8 @@ MI_VARIANT Scene<Float, Spectrum>::~Scene() {
         accel_release_cpu();
 
     // Trigger deallocation of all instances
+    m_geometry_cache = nullptr;
+    m_emitter_cache = nullptr;
     m_emitters.clear();
     m_shapes.clear();
     m_shapegroups.clear();
@@ -181,11 +260,63 @@ MI_VARIANT Scene<Float, Spectrum>::~Scene() {
 
 // -----------------------------------------------------------------------
 
+/// Per-thread result of a packet-traced ray (see \ref Scene::set_pending_intersection())
+template <typename Float, typename Spectrum> struct PendingIntersection {
+    MI_IMPORT_TYPES()
+    Ray3f ray;
+    PreliminaryIntersection3f pi;
+    bool valid = false;
+
+    static PendingIntersection &get() {
+        static thread_local PendingIntersection instance;
+        return instance;
+    }
+
+    /// Return and discard the pending result if it matches \c r
+    bool take(const Ray3f &r, PreliminaryIntersection3f &out) {
+        if (!valid || r.o != ray.o || r.d != ray.d || r.maxt != ray.maxt ||
+            r.time != ray.time)
+            return false;
+        out = pi;
+        valid = false;
+        return true;
+    }
+
+    /// Lanes of \c r that exactly match the pending rays (JIT variants)
+    Mask match(const Ray3f &r, Mask active) const {
+        if (dr::width(r.o) != dr::width(ray.o))
+            return false;
+        return active && dr::all(dr::eq(r.o, ray.o) && dr::eq(r.d, ray.d)) &&
+               dr::eq(r.maxt, ray.maxt) && dr::eq(r.time, ray.time);
+    }
+};
+
 MI_VARIANT typename Scene<Float, Spectrum>::SurfaceInteraction3f
 Scene<Float, Spectrum>::ray_intersect(const Ray3f &ray, uint32_t ray_flags, Mask coherent, Mask active) const {
     MI_MASKED_FUNCTION(ProfilerPhase::RayIntersect, active);
     DRJIT_MARK_USED(coherent);
 
+    if constexpr (!dr::is_jit_v<Float>) {
+        PreliminaryIntersection3f pi;
+        if (unlikely(PendingIntersection<Float, Spectrum>::get().take(ray, pi)))
+            return pi.compute_surface_interaction(ray, ray_flags, active);
+        MI_RAY_STAT(IntersectRays, 1);
+    } else {
+        const PendingIntersection<Float, Spectrum> &pending =
+            PendingIntersection<Float, Spectrum>::get();
+        if (unlikely(pending.valid)) {
+            // Only trace the lanes that don't match a pending ray
+            Mask reuse = pending.match(ray, active);
+            PreliminaryIntersection3f pi;
+            if constexpr (dr::is_cuda_v<Float>)
+                pi = ray_intersect_preliminary_gpu(ray, active && !reuse);
+            else
+                pi = ray_intersect_preliminary_cpu(ray, coherent, active && !reuse);
+            dr::masked(pi, reuse) = pending.pi;
+            return pi.compute_surface_interaction(ray, ray_flags, active);
+        }
+    }
+
     if constexpr (dr::is_cuda_v<Float>)
         return ray_intersect_gpu(ray, ray_flags, active);
     else
@@ -195,17 +326,73 @@ Scene<Float, Spectrum>::ray_intersect(const Ray3f &ray, uint32_t ray_flags, Mask
 MI_VARIANT typename Scene<Float, Spectrum>::PreliminaryIntersection3f
 Scene<Float, Spectrum>::ray_intersect_preliminary(const Ray3f &ray, Mask coherent, Mask active) const {
     DRJIT_MARK_USED(coherent);
+
+    if constexpr (!dr::is_jit_v<Float>) {
+        PreliminaryIntersection3f pi;
+        if (unlikely(PendingIntersection<Float, Spectrum>::get().take(ray, pi)))
+            return pi;
+        MI_RAY_STAT(IntersectRays, 1);
+    } else {
+        const PendingIntersection<Float, Spectrum> &pending =
+            PendingIntersection<Float, Spectrum>::get();
+        if (unlikely(pending.valid)) {
+            Mask reuse = pending.match(ray, active);
+            PreliminaryIntersection3f pi;
+            if constexpr (dr::is_cuda_v<Float>)
+                pi = ray_intersect_preliminary_gpu(ray, active && !reuse);
+            else
+                pi = ray_intersect_preliminary_cpu(ray, coherent, active && !reuse);
+            dr::masked(pi, reuse) = pending.pi;
+            return pi;
+        }
+    }
+
     if constexpr (dr::is_cuda_v<Float>)
         return ray_intersect_preliminary_gpu(ray, active);
     else
         return ray_intersect_preliminary_cpu(ray, coherent, active);
 }
 
+MI_VARIANT void
+Scene<Float, Spectrum>::ray_intersect_preliminary_packet(const Ray3f *rays,
+                                                         PreliminaryIntersection3f *pi,
+                                                         size_t count) const {
+    ScopedPhase scope_phase(ProfilerPhase::RayIntersect);
+    if constexpr (!dr::is_jit_v<Float>) {
+        MI_RAY_STAT(IntersectRays, count);
+        ray_intersect_preliminary_packet_cpu(rays, pi, count);
+    } else {
+        DRJIT_MARK_USED(rays);
+        DRJIT_MARK_USED(pi);
+        DRJIT_MARK_USED(count);
+        Throw("ray_intersect_preliminary_packet(): only supported in scalar variants!");
+    }
+}
+
+MI_VARIANT void
+Scene<Float, Spectrum>::set_pending_intersection(const Ray3f *ray,
+                                                 const PreliminaryIntersection3f *pi) const {
+    PendingIntersection<Float, Spectrum> &pending =
+        PendingIntersection<Float, Spectrum>::get();
+    pending.valid = ray && pi;
+    if (pending.valid) {
+        pending.ray = *ray;
+        pending.pi = *pi;
+    } else {
+        // Don't keep JIT variables alive beyond their use
+        pending.ray = Ray3f();
+        pending.pi = PreliminaryIntersection3f();
+    }
+}
+
 MI_VARIANT typename Scene<Float, Spectrum>::Mask
 Scene<Float, Spectrum>::ray_test(const Ray3f &ray, Mask coherent, Mask active) const {
     MI_MASKED_FUNCTION(ProfilerPhase::RayTest, active);
     DRJIT_MARK_USED(coherent);
 
+    if constexpr (!dr::is_jit_v<Float>)
+        MI_RAY_STAT(ShadowRays, 1);
+
     if constexpr (dr::is_cuda_v<Float>)
         return ray_test_gpu(ray, active);
     else
@@ -273,13 +460,7 @@ Scene<Float, Spectrum>::sample_emitter_ray(Float time, Float sample1,
     Spectrum weight;
     EmitterPtr emitter;
 
-    // Potentially disable inlining of emitter sampling (if there is just a single emitter)
-    bool vcall_inline = true;
-    if constexpr (dr::is_jit_v<Float>)
-         vcall_inline = jit_flag(JitFlag::VCallInline);
-
-    size_t emitter_count = m_emitters.size();
-    if (emitter_count > 1 || (emitter_count == 1 && !vcall_inline)) {
+    if (!single_emitter_call() && !m_emitters.empty()) {
         auto [index, emitter_weight, sample_1_re] = sample_emitter(sample1, active);
         emitter = dr::gather<EmitterPtr>(m_emitters_dr, index, active);
 
@@ -287,7 +468,7 @@ Scene<Float, Spectrum>::sample_emitter_ray(Float time, Float sample1,
             emitter->sample_ray(time, sample_1_re, sample2, sample3, active);
 
         weight *= emitter_weight;
-    } else if (emitter_count == 1) {
+    } else if (!m_emitters.empty()) {
         std::tie(ray, weight) =
             m_emitters[0]->sample_ray(time, sample1, sample2, sample3, active);
     } else {
@@ -308,23 +489,52 @@ Scene<Float, Spectrum>::sample_emitter_direction(const Interaction3f &ref, const
     DirectionSample3f ds;
     Spectrum spec;
 
-    // Potentially disable inlining of emitter sampling (if there is just a single emitter)
-    bool vcall_inline = true;
-    if constexpr (dr::is_jit_v<Float>)
-         vcall_inline = jit_flag(JitFlag::VCallInline);
+    if (!single_emitter_call() && !m_emitters.empty()) {
+        /* With the emitter cache, a fraction of the samples chooses the
+           emitter using the learned distribution of the region around 'ref' */
+        Mask learned = false;
+        if (m_emitter_cache) {
+            ScalarFloat fraction = m_emitter_cache->fraction();
+            learned = active && sample.x() < fraction;
+            sample.x() = dr::select(learned, sample.x() / fraction,
+                                    (sample.x() - fraction) / (1.f - fraction));
+        }
 
-    size_t emitter_count = m_emitters.size();
-    if (emitter_count > 1 || (emitter_count == 1 && !vcall_inline)) {
-        // Randomly pick an emitter
-        auto [index, emitter_weight, sample_x_re] = sample_emitter(sample.x(), active);
-        sample.x() = sample_x_re;
+        // Randomly pick an emitter (depending on 'ref' if a light tree is used)
+        UInt32 index;
+        Float emitter_pmf, emitter_weight;
+        if (m_light_tree) {
+            std::tie(index, emitter_pmf, sample.x()) =
+                m_light_tree->sample(ref.p, sample.x(), active);
+            emitter_weight = dr::select(emitter_pmf > 0.f, dr::rcp(emitter_pmf), 0.f);
+        } else {
+            std::tie(index, emitter_weight, sample.x()) =
+                sample_emitter(sample.x(), active);
+            emitter_pmf = pdf_emitter(index, active);
+        }
+
+        if (m_emitter_cache) {
+            auto [learned_index, learned_sample] =
+                m_emitter_cache->sample(ref.p, sample.x(), learned);
+            dr::masked(index, learned) = learned_index;
+            dr::masked(sample.x(), learned) = learned_sample;
+
+            // Probability of the combination of both strategies
+            if (m_light_tree)
+                dr::masked(emitter_pmf, learned) =
+                    m_light_tree->pmf(ref.p, index, learned);
+            else
+                dr::masked(emitter_pmf, learned) = pdf_emitter(index, learned);
+            emitter_pmf = m_emitter_cache->mix(ref.p, index, emitter_pmf, active);
+            emitter_weight = dr::select(emitter_pmf > 0.f, dr::rcp(emitter_pmf), 0.f);
+        }
 
         // Sample a direction towards the emitter
         EmitterPtr emitter = dr::gather<EmitterPtr>(m_emitters_dr, index, active);
         std::tie(ds, spec) = emitter->sample_direction(ref, sample, active);
 
         // Account for the discrete probability of sampling this emitter
-        ds.pdf *= pdf_emitter(index, active);
+        ds.pdf *= emitter_pmf;
         spec *= emitter_weight;
 
         active &= dr::neq(ds.pdf, 0.f);
@@ -334,8 +544,14 @@ Scene<Float, Spectrum>::sample_emitter_direction(const Interaction3f &ref, const
             Mask occluded = ray_test(ref.spawn_ray_to(ds.p), active);
             dr::masked(spec, occluded) = 0.f;
             dr::masked(ds.pdf, occluded) = 0.f;
+
+            // Report the unoccluded contribution to the emitter cache
+            if (m_emitter_cache)
+                m_emitter_cache->record(
+                    ref.p, index, dr::mean(unpolarized_spectrum(spec)),
+                    active && !occluded);
         }
-    } else if (emitter_count == 1) {
+    } else if (!m_emitters.empty()) {
         // Sample a direction towards the (single) emitter
         std::tie(ds, spec) = m_emitters[0]->sample_direction(ref, sample, active);
 
@@ -360,17 +576,47 @@ Scene<Float, Spectrum>::pdf_emitter_direction(const Interaction3f &ref,
                                               const DirectionSample3f &ds,
                                               Mask active) const {
     MI_MASK_ARGUMENT(active);
+
+    /* Call the (single) emitter directly. The Dr.Jit registry may contain
+       further emitters of other scenes, which would prevent it from
+       inlining the virtual function call */
+    if (single_emitter_call()) {
+        active &= dr::neq(ds.emitter, nullptr);
+        return dr::select(active, m_emitters[0]->pdf_direction(ref, ds, active), 0.f);
+    }
+
     Float emitter_pmf;
-    if (m_emitter_distr == nullptr)
+    if (m_light_tree)
+        emitter_pmf = m_light_tree->pmf(ref.p, ds.emitter->emitter_index(), active);
+    else if (m_emitter_distr == nullptr)
         emitter_pmf = m_emitter_pmf;
     else
         emitter_pmf = ds.emitter->sampling_weight() * m_emitter_distr->normalization();
+
+    if (m_emitter_cache)
+        emitter_pmf = m_emitter_cache->mix(ref.p, ds.emitter->emitter_index(),
+                                           emitter_pmf, active);
+
     return ds.emitter->pdf_direction(ref, ds, active) * emitter_pmf;
 }
 
+MI_VARIANT void Scene<Float, Spectrum>::update_emitter_cache() {
+    if (m_emitter_cache)
+        m_emitter_cache->update();
+}
+
 MI_VARIANT Spectrum Scene<Float, Spectrum>::eval_emitter_direction(
     const Interaction3f &ref, const DirectionSample3f &ds, Mask active) const {
     MI_MASK_ARGUMENT(active);
+
+    // Call the (single) emitter directly, see pdf_emitter_direction()
+    if (single_emitter_call()) {
+        active &= dr::neq(ds.emitter, nullptr);
+        return dr::select(active,
+                          m_emitters[0]->eval_direction(ref, ds, active),
+                          0.f);
+    }
+
     return ds.emitter->eval_direction(ref, ds, active);
 }
 
@@ -481,6 +727,175 @@ MI_VARIANT void Scene<Float, Spectrum>::traverse(TraversalCallback *callback) {
     }
 }
 
+/// Return the host and device memory used by the storage of a parameter
+template <typename T> std::pair<size_t, size_t> parameter_memory(const T &value) {
+    if constexpr (dr::is_tensor_v<T>) {
+        return parameter_memory(value.array());
+    } else if constexpr (dr::array_depth_v<T> > 1) {
+        std::pair<size_t, size_t> result { 0, 0 };
+        for (size_t i = 0; i < value.size(); ++i) {
+            auto [host, device] = parameter_memory(value.entry(i));
+            result.first += host;
+            result.second += device;
+        }
+        return result;
+    } else if constexpr (dr::is_dynamic_v<T>) {
+        size_t bytes = dr::width(value) * sizeof(dr::scalar_t<T>);
+        if constexpr (dr::is_cuda_v<T>)
+            return { 0, bytes };
+        else
+            return { bytes, 0 };
+    } else {
+        return { sizeof(T), 0 };
+    }
+}
+
+/**
+ * Traversal callback that sums up the storage of the parameters exposed by
+ * each object of a scene graph. Objects that are referenced several times
+ * are only counted once.
+ */
+template <typename Float, typename Spectrum>
+struct MemoryCollector : public TraversalCallback {
+    MI_IMPORT_TYPES()
+    using FloatStorage = DynamicBuffer<Float>;
+    using UInt32Storage = DynamicBuffer<UInt32>;
+    using MemoryRecord = typename Scene<Float, Spectrum>::MemoryRecord;
+
+    void put_object(const std::string &name, Object *obj, uint32_t) override {
+        if (!obj || !visited.insert(obj).second)
+            return;
+
+        // Categorize objects by their base class (e.g. Mesh -> Shape)
+        const Class *class_ = obj->class_();
+        while (class_->parent() && class_->parent()->parent())
+            class_ = class_->parent();
+
+        std::string path = prefix.empty() ? name : prefix + "." + name,
+                    prev_prefix = path;
+        size_t prev_index = index;
+
+        std::swap(prefix, prev_prefix);
+        index = records.size();
+        records.emplace_back(path, class_->name(), 0, 0);
+        obj->traverse(this);
+        std::swap(prefix, prev_prefix);
+        index = prev_index;
+    }
+
+    void put_parameter_impl(const std::string &, void *ptr, uint32_t,
+                            const std::type_info &type) override {
+        if (index == (size_t) -1)
+            return;
+
+        // Other parameter types only account for negligible amounts of memory
+        add<FloatStorage>(ptr, type) || add<UInt32Storage>(ptr, type) ||
+            add<TensorXf>(ptr, type) || add<Float>(ptr, type) ||
+            add<UInt32>(ptr, type) || add<Color3f>(ptr, type) ||
+            add<Vector3f>(ptr, type) || add<Point3f>(ptr, type) ||
+            add<UnpolarizedSpectrum>(ptr, type);
+    }
+
+    template <typename T> bool add(const void *ptr, const std::type_info &type) {
+        if (type != typeid(T))
+            return false;
+        auto [host, device] = parameter_memory(*(const T *) ptr);
+        std::get<2>(records[index]) += host;
+        std::get<3>(records[index]) += device;
+        return true;
+    }
+
+    std::vector<MemoryRecord> records;
+    std::unordered_set<const Object *> visited;
+    std::string prefix;
+    /// Record of the object whose parameters are being traversed
+    size_t index = (size_t) -1;
+};
+
+MI_VARIANT std::vector<typename Scene<Float, Spectrum>::MemoryRecord>
+Scene<Float, Spectrum>::memory_usage() {
+    MemoryCollector<Float, Spectrum> collector;
+    traverse(&collector);
+    std::vector<MemoryRecord> records = std::move(collector.records);
+
+    for (size_t i = 0; i < m_sensors.size(); ++i) {
+        const ImageBlock *block = m_sensors[i]->film()->storage();
+        if (!block)
+            continue;
+        std::string id = m_sensors[i]->id();
+        if (id.empty() || string::starts_with(id, "_unnamed_"))
+            id = tfm::format("sensor_%zu", i);
+        auto [host, device] = block->memory_usage();
+        records.emplace_back(id + ".film", "ImageBlock", host, device);
+    }
+
+    if (m_accel) {
+        if constexpr (dr::is_cuda_v<Float>)
+            records.emplace_back("accel", "Accel", 0, accel_memory_gpu());
+        else
+            records.emplace_back("accel", "Accel", accel_memory_cpu(), 0);
+    }
+
+    return records;
+}
+
+MI_VARIANT std::string Scene<Float, Spectrum>::memory_report(size_t max_objects) {
+    std::vector<MemoryRecord> records = memory_usage();
+
+    auto total = [](const MemoryRecord &r) {
+        return std::get<2>(r) + std::get<3>(r);
+    };
+
+    // Sum up the records of each category
+    std::vector<MemoryRecord> categories;
+    size_t host = 0, device = 0;
+    for (const MemoryRecord &r : records) {
+        auto it = std::find_if(categories.begin(), categories.end(),
+            [&](const MemoryRecord &c) { return std::get<0>(c) == std::get<1>(r); });
+        if (it == categories.end())
+            it = categories.insert(categories.end(),
+                                   MemoryRecord(std::get<1>(r), "", 0, 0));
+        std::get<2>(*it) += std::get<2>(r);
+        std::get<3>(*it) += std::get<3>(r);
+        host += std::get<2>(r);
+        device += std::get<3>(r);
+    }
+
+    auto by_size = [&](const MemoryRecord &a, const MemoryRecord &b) {
+        return total(a) > total(b);
+    };
+    std::stable_sort(categories.begin(), categories.end(), by_size);
+    std::stable_sort(records.begin(), records.end(), by_size);
+
+    std::ostringstream oss;
+    oss << "Scene memory usage: " << util::mem_string(host) << " (host), "
+        << util::mem_string(device) << " (device)" << std::endl
+        << std::endl
+        << tfm::format("  %-40s %12s %12s", "Category", "Host", "Device")
+        << std::endl;
+    for (const MemoryRecord &c : categories)
+        oss << tfm::format("  %-40s %12s %12s", std::get<0>(c),
+                           util::mem_string(std::get<2>(c)),
+                           util::mem_string(std::get<3>(c))) << std::endl;
+
+    oss << std::endl
+        << tfm::format("  %-40s %12s %12s", "Object", "Host", "Device")
+        << std::endl;
+    for (size_t i = 0; i < std::min(max_objects, records.size()); ++i) {
+        const MemoryRecord &r = records[i];
+        if (total(r) == 0)
+            break;
+        std::string name = std::get<0>(r) + " (" + std::get<1>(r) + ")";
+        oss << tfm::format("  %-40s %12s %12s", name,
+                           util::mem_string(std::get<2>(r)),
+                           util::mem_string(std::get<3>(r))) << std::endl;
+    }
+    if (records.size() > max_objects)
+        oss << "  .. (" << records.size() - max_objects << " more)" << std::endl;
+
+    return oss.str();
+}
+
 MI_VARIANT void Scene<Float, Spectrum>::parameters_changed(const std::vector<std::string> &/*keys*/) {
     if (m_environment)
         m_environment->set_scene(this); // TODO use parameters_changed({"scene"})
@@ -582,6 +997,9 @@ MI_VARIANT void Scene<Float, Spectrum>::accel_parameters_changed_gpu() {
 MI_VARIANT void Scene<Float, Spectrum>::accel_release_gpu() {
     NotImplementedError("accel_release_gpu");
 }
+MI_VARIANT size_t Scene<Float, Spectrum>::accel_memory_gpu() const {
+    NotImplementedError("accel_memory_gpu");
+}
 MI_VARIANT typename Scene<Float, Spectrum>::PreliminaryIntersection3f
 Scene<Float, Spectrum>::ray_intersect_preliminary_gpu(const Ray3f &, Mask) const {
     NotImplementedError("ray_intersect_preliminary_gpu");
@@ -1,6 +1,8 @@
 #include <embree3/rtcore.h>
+#include <mitsuba/core/thread.h>
 #include <nanothread/nanothread.h>
 #include <thread>
+#include <atomic>
 
 NAMESPACE_BEGIN(mitsuba)
 
@@ -16,69 +18,199 @@ struct EmbreeState {
     std::vector<int> geometries;
     DynamicBuffer<UInt32> shapes_registry_ids;
     bool is_nested_scene = false;
-};
 
-static void embree_error_callback(void * /*user_ptr */, RTCError code, const char *str) {
-    Log(Warn, "Embree device error %i: %s.", (int) code, str);
-}
-
-/// Wraps rtcOccluded16 when Dr.Jit operates on vectors of length 32
-void rtcOccluded32(const int *valid, RTCScene scene,
-                   RTCIntersectContext *context, uint32_t *in) {
-    constexpr size_t N = 16, M = 2;
-
-    RTC_ALIGN(N * 4) uint32_t tmp[N * 12];
+    /// Refit the BVH instead of rebuilding it when only vertex positions change
+    bool accel_update = false;
+    /// Rebuild once the estimated cost of the refitted BVH exceeds this factor
+    float accel_update_threshold = 1.5f;
+    /// Per-shape state recorded at the last full build (used for refitting)
+    std::vector<const void *> build_faces;
+    std::vector<uint32_t> build_vertex_count;
+    std::vector<ScalarBoundingBox3f> build_bbox;
+};
 
-    for (size_t i = 0; i < M; ++i) {
-        uint32_t *ptr_in  = in + N * i,
-                 *ptr_tmp = tmp;
+/**
+ * \brief Try to update the geometries of instances in place after a change
+ * to their transformations
+ *
+ * This is only possible when all modified shapes are instances with a static
+ * transformation, whose shape group did not change. The top-level BVH is then
+ * recommitted without recreating the geometries of the scene.
+ *
+ * Returns \c false when the geometries must be recreated.
+ */
+MI_VARIANT bool embree_update_transforms(EmbreeState<Float> &s,
+                                         const std::vector<ref<Shape<Float, Spectrum>>> &shapes) {
+    if (s.geometries.size() != shapes.size())
+        return false;
+
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        if (shapes[i]->dirty() && !shapes[i]->is_instance())
+            return false;
+    }
 
-        for (size_t j = 0; j < 12; ++j) {
-            memcpy(ptr_tmp, ptr_in, N * sizeof(uint32_t));
-            ptr_in += N * M;
-            ptr_tmp += N;
-        }
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        if (!shapes[i]->dirty())
+            continue;
+        RTCGeometry geom = rtcGetGeometry(s.accel, s.geometries[i]);
+        if (!shapes[i]->embree_update_transform(geom))
+            return false;
+    }
 
-        static_assert(sizeof(tmp) == sizeof(RTCRay16));
-        rtcOccluded16(valid + N * i, scene, context, (RTCRay16 *) tmp);
+    return true;
+}
 
-        memcpy(in + N * (i + M * 8), tmp + N * 8, N * sizeof(uint32_t));
+/**
+ * \brief Try to refit the Embree BVH after a change to mesh vertex positions
+ *
+ * Refitting is only possible when all modified shapes are meshes whose
+ * topology did not change since the last full build, or instances whose
+ * transformation can be updated in place (see \ref embree_update_transforms()). Embree does not expose
+ * the cost of the refitted BVH, hence it is estimated from how far each
+ * shape has moved away from the position it had when the BVH was built: the
+ * primitive-weighted surface area of the union of the build-time and current
+ * bounding boxes relative to the one of the current bounding boxes. This
+ * stays close to 1 for deformations in place and grows as shapes drift
+ * apart from the tree's original spatial partitioning.
+ *
+ * Returns \c false when a full rebuild is required.
+ */
+MI_VARIANT bool embree_refit(EmbreeState<Float> &s,
+                             const std::vector<ref<Shape<Float, Spectrum>>> &shapes) {
+    using Mesh = mitsuba::Mesh<Float, Spectrum>;
+    using ScalarBoundingBox3f = typename EmbreeState<Float>::ScalarBoundingBox3f;
+
+    if (s.geometries.size() != shapes.size())
+        return false;
+
+    double cost_refit = 0.0, cost_current = 0.0;
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        Shape<Float, Spectrum> *shape = shapes[i];
+        ScalarBoundingBox3f bbox = shape->bbox();
+        double weight = (double) shape->primitive_count();
+
+        ScalarBoundingBox3f bbox_union = bbox;
+        bbox_union.expand(s.build_bbox[i]);
+        cost_refit   += weight * (double) bbox_union.surface_area();
+        cost_current += weight * (double) bbox.surface_area();
+
+        if (!shape->dirty() || shape->is_instance())
+            continue;
+
+        // The keyframe count of deforming meshes might have changed
+        if (!shape->is_mesh() || shape->is_animated())
+            return false;
+
+        Mesh *mesh = (Mesh *) shape;
+        if (mesh->vertex_count() != s.build_vertex_count[i] ||
+            (const void *) mesh->faces_buffer().data() != s.build_faces[i])
+            return false;
     }
-}
 
-/// Wraps rtcIntersect16 when Dr.Jit operates on vectors of length 32
-void rtcIntersect32(const int *valid, RTCScene scene,
-                    RTCIntersectContext *context, uint32_t *in) {
-    constexpr size_t N = 16, M = 2;
+    if (cost_current > 0.0 && cost_refit > s.accel_update_threshold * cost_current) {
+        Log(Debug, "Embree: estimated refit cost exceeds the threshold "
+                   "(%.2f > %.2f), rebuilding the BVH.",
+            cost_refit / cost_current, s.accel_update_threshold);
+        return false;
+    }
 
-    RTC_ALIGN(N * 4) uint32_t tmp[N * 20];
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        if (!shapes[i]->dirty())
+            continue;
+        RTCGeometry geom = rtcGetGeometry(s.accel, s.geometries[i]);
+        if (shapes[i]->is_instance()) {
+            if (!shapes[i]->embree_update_transform(geom))
+                return false;
+        } else {
+            ((Mesh *) shapes[i].get())->embree_update_geometry(geom);
+        }
+    }
 
-    for (size_t i = 0; i < M; ++i) {
-        uint32_t *ptr_in  = in + N * i,
-                 *ptr_tmp = tmp;
+    return true;
+}
 
-        for (size_t j = 0; j < 20; ++j) {
-            memcpy(ptr_tmp, ptr_in, N * sizeof(uint32_t));
-            ptr_in += N * M;
-            ptr_tmp += N;
-        }
+static void embree_error_callback(void * /*user_ptr */, RTCError code, const char *str) {
+    Log(Warn, "Embree device error %i: %s.", (int) code, str);
+}
 
-        memcpy(tmp + N * 17, in + N * (i + M * 17), N * sizeof(uint32_t));
+/// Memory currently allocated by the Embree device (shared by all scenes)
+static std::atomic<int64_t> embree_memory { 0 };
 
-        static_assert(sizeof(tmp) == sizeof(RTCRayHit16));
-        rtcIntersect16(valid + N * i, scene, context, (RTCRayHit16 *) tmp);
+static bool embree_memory_callback(void * /* user_ptr */, ssize_t bytes,
+                                   bool /* post */) {
+    embree_memory += (int64_t) bytes;
+    return true;
+}
 
-        memcpy(in + N * (i + M * 8), tmp + N * 8, N * sizeof(uint32_t));
+/**
+ * \brief Wraps rtcOccludedNp for Dr.Jit vector widths without a matching
+ * Embree packet function (e.g. 32)
+ *
+ * Dr.Jit passes the rays in SoA layout with a stride of \c N elements per
+ * field, which matches \c RTCRayNp. The fields are therefore handed to
+ * Embree's stream API by pointer without repacking. Since streams lack a
+ * validity mask, disabled lanes receive an empty ray segment.
+ */
+template <size_t N>
+void rtcOccludedStream(const int *valid, RTCScene scene,
+                       RTCIntersectContext *context, uint32_t *in) {
+    float *tfar = (float *) (in + N * 8);
+    for (size_t i = 0; i < N; ++i) {
+        if (!valid[i])
+            tfar[i] = -dr::Infinity<float>;
+    }
 
-        ptr_in  = in + N * (i + M * 12);
-        ptr_tmp = tmp + N * 12;
+    RTCRayNp ray;
+    ray.org_x = (float *) (in + N * 0);
+    ray.org_y = (float *) (in + N * 1);
+    ray.org_z = (float *) (in + N * 2);
+    ray.tnear = (float *) (in + N * 3);
+    ray.dir_x = (float *) (in + N * 4);
+    ray.dir_y = (float *) (in + N * 5);
+    ray.dir_z = (float *) (in + N * 6);
+    ray.time  = (float *) (in + N * 7);
+    ray.tfar  = tfar;
+    ray.mask  = in + N * 9;
+    ray.id    = in + N * 10;
+    ray.flags = in + N * 11;
+
+    rtcOccludedNp(scene, context, &ray, (unsigned int) N);
+}
 
-        for (int j = 0; j < 8; ++j) {
-            memcpy(ptr_in, ptr_tmp, N * sizeof(uint32_t));
-            ptr_in += N * 2;
-            ptr_tmp += N;
-        }
+/// Wraps rtcIntersectNp, see \ref rtcOccludedStream() for details
+template <size_t N>
+void rtcIntersectStream(const int *valid, RTCScene scene,
+                        RTCIntersectContext *context, uint32_t *in) {
+    float *tfar = (float *) (in + N * 8);
+    for (size_t i = 0; i < N; ++i) {
+        if (!valid[i])
+            tfar[i] = -dr::Infinity<float>;
     }
+
+    RTCRayHitNp rh;
+    rh.ray.org_x = (float *) (in + N * 0);
+    rh.ray.org_y = (float *) (in + N * 1);
+    rh.ray.org_z = (float *) (in + N * 2);
+    rh.ray.tnear = (float *) (in + N * 3);
+    rh.ray.dir_x = (float *) (in + N * 4);
+    rh.ray.dir_y = (float *) (in + N * 5);
+    rh.ray.dir_z = (float *) (in + N * 6);
+    rh.ray.time  = (float *) (in + N * 7);
+    rh.ray.tfar  = tfar;
+    rh.ray.mask  = in + N * 9;
+    rh.ray.id    = in + N * 10;
+    rh.ray.flags = in + N * 11;
+
+    rh.hit.Ng_x      = (float *) (in + N * 12);
+    rh.hit.Ng_y      = (float *) (in + N * 13);
+    rh.hit.Ng_z      = (float *) (in + N * 14);
+    rh.hit.u         = (float *) (in + N * 15);
+    rh.hit.v         = (float *) (in + N * 16);
+    rh.hit.primID    = in + N * 17;
+    rh.hit.geomID    = in + N * 18;
+    rh.hit.instID[0] = in + N * 19;
+
+    rtcIntersectNp(scene, context, &rh, (unsigned int) N);
 }
 
 MI_VARIANT void
@@ -95,6 +227,8 @@ Scene<Float, Spectrum>::accel_init_cpu(const Properties &props) {
             "threads=%i,user_threads=%i", embree_threads, embree_threads);
         embree_device = rtcNewDevice(config_str.c_str());
         rtcSetDeviceErrorFunction(embree_device, embree_error_callback, nullptr);
+        rtcSetDeviceMemoryMonitorFunction(embree_device, embree_memory_callback,
+                                          nullptr);
     }
 
     Timer timer;
@@ -110,9 +244,18 @@ Scene<Float, Spectrum>::accel_init_cpu(const Properties &props) {
         }
     }
 
+    /* Dynamic scene mode: when only the vertex positions of meshes change,
+       refit the existing BVH rather than rebuilding it from scratch */
+    s.accel_update = props.get<bool>("accel_update", false);
+    s.accel_update_threshold =
+        props.get<ScalarFloat>("accel_update_threshold", 1.5f);
+    if (s.accel_update_threshold < 1.f)
+        Throw("Scene: 'accel_update_threshold' must be >= 1!");
+
     s.accel = rtcNewScene(embree_device);
     rtcSetSceneBuildQuality(s.accel, RTC_BUILD_QUALITY_HIGH);
-    rtcSetSceneFlags(s.accel, RTC_SCENE_FLAG_NONE);
+    rtcSetSceneFlags(s.accel, s.accel_update ? RTC_SCENE_FLAG_DYNAMIC
+                                             : RTC_SCENE_FLAG_NONE);
 
     ScopedPhase phase(ProfilerPhase::InitAccel);
     accel_parameters_changed_cpu();
@@ -140,14 +283,56 @@ MI_VARIANT void Scene<Float, Spectrum>::accel_parameters_changed_cpu() {
 
     EmbreeState<Float> &s = *(EmbreeState<Float> *) m_accel;
 
-    for (int geo : s.geometries)
-        rtcDetachGeometry(s.accel, geo);
-    s.geometries.clear();
+    bool refit = !s.geometries.empty();
+    for (auto &shapegroup : m_shapegroups)
+        refit &= !shapegroup->dirty();
+    if (refit)
+        refit = s.accel_update ? embree_refit<Float, Spectrum>(s, m_shapes)
+                               : embree_update_transforms<Float, Spectrum>(s, m_shapes);
+
+    if (!refit) {
+        for (int geo : s.geometries)
+            rtcDetachGeometry(s.accel, geo);
+        s.geometries.clear();
+
+        /* Create the geometries in parallel, which includes building the
+           BVHs of the instanced shape groups. They are then attached in
+           order, so that the geometry IDs match the shape indices. */
+        std::vector<RTCGeometry> geoms(m_shapes.size());
+        ThreadEnvironment env;
+        dr::parallel_for(
+            dr::blocked_range<size_t>(0, m_shapes.size(), 16),
+            [&](const dr::blocked_range<size_t> &range) {
+                ScopedSetThreadEnvironment set_env(env);
+                for (size_t i = range.begin(); i != range.end(); ++i) {
+                    Shape *shape = m_shapes[i];
+                    RTCGeometry geom = shape->embree_geometry(embree_device);
+                    if (s.accel_update && shape->is_mesh()) {
+                        rtcSetGeometryBuildQuality(geom, RTC_BUILD_QUALITY_REFIT);
+                        rtcCommitGeometry(geom);
+                    }
+                    geoms[i] = geom;
+                }
+            }
+        );
 
-    for (Shape *shape : m_shapes) {
-        RTCGeometry geom = shape->embree_geometry(embree_device);
-        s.geometries.push_back(rtcAttachGeometry(s.accel, geom));
-        rtcReleaseGeometry(geom);
+        for (RTCGeometry geom : geoms) {
+            s.geometries.push_back(rtcAttachGeometry(s.accel, geom));
+            rtcReleaseGeometry(geom);
+        }
+
+        if (s.accel_update) {
+            s.build_faces.clear();
+            s.build_vertex_count.clear();
+            s.build_bbox.clear();
+            for (Shape *shape : m_shapes) {
+                Mesh *mesh = shape->is_mesh() ? (Mesh *) shape : nullptr;
+                s.build_faces.push_back(
+                    mesh ? (const void *) mesh->faces_buffer().data() : nullptr);
+                s.build_vertex_count.push_back(mesh ? mesh->vertex_count() : 0);
+                s.build_bbox.push_back(shape->bbox());
+            }
+        }
     }
 
     // Ensure shape data pointers are fully evaluated before building the BVH
@@ -214,6 +399,11 @@ MI_VARIANT void Scene<Float, Spectrum>::accel_release_cpu() {
     }
 }
 
+MI_VARIANT size_t Scene<Float, Spectrum>::accel_memory_cpu() const {
+    // Embree only reports the memory of the device, i.e. of all scenes
+    return (size_t) std::max(embree_memory.load(), (int64_t) 0);
+}
+
 MI_VARIANT typename Scene<Float, Spectrum>::PreliminaryIntersection3f
 Scene<Float, Spectrum>::ray_intersect_preliminary_cpu(const Ray3f &ray,
                                                       Mask coherent,
@@ -284,7 +474,8 @@ Scene<Float, Spectrum>::ray_intersect_preliminary_cpu(const Ray3f &ray,
             case 4:  func_ptr = (void *) rtcIntersect4;  break;
             case 8:  func_ptr = (void *) rtcIntersect8;  break;
             case 16: func_ptr = (void *) rtcIntersect16; break;
-            case 32: func_ptr = (void *) rtcIntersect32; break;
+            case 32: func_ptr = (void *) rtcIntersectStream<32>; break;
+            case 64: func_ptr = (void *) rtcIntersectStream<64>; break;
             default:
                 Throw("ray_intersect_preliminary_cpu(): Dr.Jit is "
                       "configured for vectors of width %u, which is not "
@@ -347,6 +538,90 @@ Scene<Float, Spectrum>::ray_intersect_preliminary_cpu(const Ray3f &ray,
     }
 }
 
+MI_VARIANT void
+Scene<Float, Spectrum>::ray_intersect_preliminary_packet_cpu(const Ray3f *rays,
+                                                             PreliminaryIntersection3f *pi,
+                                                             size_t count) const {
+    if constexpr (!dr::is_jit_v<Float>) {
+        EmbreeState<Float> &s = *(EmbreeState<Float> *) m_accel;
+
+        RTCIntersectContext context;
+        rtcInitIntersectContext(&context);
+        context.flags = RTC_INTERSECT_CONTEXT_FLAG_COHERENT;
+
+        /* Submit the rays as a single SoA stream, which lets Embree form
+           packets of coherent rays internally */
+        std::unique_ptr<float[]> data_f(new float[count * 14]);
+        std::unique_ptr<uint32_t[]> data_u(new uint32_t[count * 6]);
+
+        RTCRayHitNp rh;
+        float **fields_f[14] = { &rh.ray.org_x, &rh.ray.org_y, &rh.ray.org_z,
+                                 &rh.ray.tnear, &rh.ray.dir_x, &rh.ray.dir_y,
+                                 &rh.ray.dir_z, &rh.ray.time,  &rh.ray.tfar,
+                                 &rh.hit.Ng_x,  &rh.hit.Ng_y,  &rh.hit.Ng_z,
+                                 &rh.hit.u,     &rh.hit.v };
+        for (size_t i = 0; i < 14; ++i)
+            *fields_f[i] = data_f.get() + count * i;
+        unsigned int **fields_u[6] = { &rh.ray.mask,   &rh.ray.id,
+                                       &rh.ray.flags,  &rh.hit.primID,
+                                       &rh.hit.geomID, &rh.hit.instID[0] };
+        for (size_t i = 0; i < 6; ++i)
+            *fields_u[i] = data_u.get() + count * i;
+
+        for (size_t j = 0; j < count; ++j) {
+            const Ray3f &ray = rays[j];
+
+            rh.ray.org_x[j]  = (float) ray.o.x();
+            rh.ray.org_y[j]  = (float) ray.o.y();
+            rh.ray.org_z[j]  = (float) ray.o.z();
+            rh.ray.tnear[j]  = 0.f;
+            rh.ray.dir_x[j]  = (float) ray.d.x();
+            rh.ray.dir_y[j]  = (float) ray.d.y();
+            rh.ray.dir_z[j]  = (float) ray.d.z();
+            rh.ray.time[j]   = (float) ray.time;
+            // Be careful with 'ray.maxt' in double precision variants
+            rh.ray.tfar[j]   = (float) dr::minimum(ray.maxt, (Float) dr::Largest<float>);
+            rh.ray.mask[j]   = 0;
+            rh.ray.id[j]     = 0;
+            rh.ray.flags[j]  = 0;
+            rh.hit.geomID[j] = (uint32_t) -1;
+        }
+
+        rtcIntersectNp(s.accel, &context, &rh, (unsigned int) count);
+
+        for (size_t j = 0; j < count; ++j) {
+            PreliminaryIntersection3f &p = pi[j];
+            p = dr::zeros<PreliminaryIntersection3f>();
+
+            if (rh.hit.geomID[j] != (uint32_t) -1) {
+                uint32_t shape_index = rh.hit.geomID[j];
+                uint32_t inst_index  = rh.hit.instID[0][j];
+
+                // If the hit is not on an instance
+                bool hit_instance = inst_index != RTC_INVALID_GEOMETRY_ID;
+                uint32_t index = hit_instance ? inst_index : shape_index;
+
+                ShapePtr shape = m_shapes[index];
+                if (hit_instance)
+                    p.instance = shape;
+                else
+                    p.shape = shape;
+
+                p.shape_index = shape_index;
+                p.t = rh.ray.tfar[j];
+                p.prim_index = rh.hit.primID[j];
+                p.prim_uv = Point2f(rh.hit.u[j], rh.hit.v[j]);
+            }
+        }
+    } else {
+        DRJIT_MARK_USED(rays);
+        DRJIT_MARK_USED(pi);
+        DRJIT_MARK_USED(count);
+        Throw("ray_intersect_preliminary_packet_cpu() should only be called "
+              "in scalar mode.");
+    }
+}
+
 MI_VARIANT typename Scene<Float, Spectrum>::SurfaceInteraction3f
 Scene<Float, Spectrum>::ray_intersect_cpu(const Ray3f &ray, uint32_t ray_flags, Mask coherent, Mask active) const {
     if constexpr (!dr::is_cuda_v<Float>) {
@@ -402,7 +677,8 @@ Scene<Float, Spectrum>::ray_test_cpu(const Ray3f &ray, Mask coherent, Mask activ
             case 4:  func_ptr = (void *) rtcOccluded4;  break;
             case 8:  func_ptr = (void *) rtcOccluded8;  break;
             case 16: func_ptr = (void *) rtcOccluded16; break;
-            case 32: func_ptr = (void *) rtcOccluded32; break;
+            case 32: func_ptr = (void *) rtcOccludedStream<32>; break;
+            case 64: func_ptr = (void *) rtcOccludedStream<64>; break;
             default:
                 Throw("ray_test_cpu(): Dr.Jit is configured for vectors of "
                       "width %u, which is not supported by Embree!", jit_width);
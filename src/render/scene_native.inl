@@ -3,19 +3,182 @@ NAMESPACE_BEGIN(mitsuba)
 template <typename Float, typename Spectrum>
 struct NativeState {
     MI_IMPORT_CORE_TYPES()
-    ShapeKDTree<Float, Spectrum> *accel;
+    ShapeKDTree<Float, Spectrum> *accel = nullptr;
+    ShapeBVH<Float, Spectrum> *bvh = nullptr;
     DynamicBuffer<UInt32> shapes_registry_ids;
+
+    /// Directory of the on-disk acceleration data structure cache (if enabled)
+    fs::path cache_dir;
+    /// Hash of the build-related scene parameters (part of the cache key)
+    uint64_t params_hash = 0;
+
+    /**
+     * \brief Top-level BVH over the scene's instances (if enabled)
+     *
+     * When the scene contains instances, \ref accel or \ref bvh only store
+     * the remaining shapes and the two index maps below translate shape
+     * indices of either data structure back to indices into the scene's
+     * shape list. Both maps are empty otherwise.
+     */
+    ShapeBVH<Float, Spectrum> *instances = nullptr;
+    std::vector<uint32_t> geometry_ids, instance_ids;
+
+    /// Trace a scalar ray using whichever acceleration data structure is active
+    template <bool ShadowRay, typename ScalarRay3f>
+    MI_INLINE auto ray_intersect_geometry(const ScalarRay3f &ray) const {
+        if (bvh)
+            return bvh->template ray_intersect_scalar<ShadowRay>(ray);
+        else
+            return accel->template ray_intersect_scalar<ShadowRay>(ray);
+    }
+
+    /// Trace a scalar ray through the scene geometry and instances
+    template <bool ShadowRay, typename ScalarRay3f>
+    MI_INLINE auto ray_intersect_scalar(ScalarRay3f ray) const {
+        if (likely(instance_ids.empty()))
+            return ray_intersect_geometry<ShadowRay>(ray);
+
+        decltype(ray_intersect_geometry<ShadowRay>(ray)) pi;
+        if (!geometry_ids.empty()) {
+            pi = ray_intersect_geometry<ShadowRay>(ray);
+            if (pi.is_valid()) {
+                if constexpr (ShadowRay)
+                    return pi;
+                pi.shape_index = geometry_ids[pi.shape_index];
+                ray.maxt = pi.t;
+            }
+        }
+
+        auto pi_inst = instances->template ray_intersect_scalar<ShadowRay>(ray);
+        if (pi_inst.is_valid()) {
+            if constexpr (!ShadowRay) {
+                // Instance hits store the instance's shape index in 'shape'
+                using ShapePtr = decltype(pi_inst.shape);
+                pi_inst.shape = (ShapePtr) (size_t) instance_ids[(size_t) pi_inst.shape];
+            }
+            return pi_inst;
+        }
+
+        return pi;
+    }
+
+    /// Release the acceleration data structure
+    void release() {
+        if (instances) {
+            instances->clear();
+            instances->dec_ref();
+            instances = nullptr;
+        }
+        if (bvh) {
+            bvh->clear();
+            bvh->dec_ref();
+            bvh = nullptr;
+        }
+        if (accel) {
+            accel->clear();
+            accel->dec_ref();
+            accel = nullptr;
+        }
+    }
 };
 
-MI_VARIANT void Scene<Float, Spectrum>::accel_init_cpu(const Properties &props) {
-    ShapeKDTree *kdtree = new ShapeKDTree(props);
-    kdtree->inc_ref();
+/**
+ * \brief Compute the key identifying a native acceleration data structure
+ * in the on-disk cache
+ *
+ * The key combines the build parameters with a content hash of the geometry:
+ * the vertex positions (including keyframes) and faces of meshes, and the
+ * string representation (which includes transforms/parameters) of all other
+ * shapes.
+ */
+template <typename Float, typename Spectrum>
+uint64_t accel_cache_key(const std::vector<ref<Shape<Float, Spectrum>>> &shapes,
+                         uint64_t seed) {
+    using Mesh = mitsuba::Mesh<Float, Spectrum>;
 
     if constexpr (dr::is_llvm_v<Float>) {
-        m_accel = new NativeState<Float, Spectrum>();
-        NativeState<Float, Spectrum> &s = *(NativeState<Float, Spectrum> *) m_accel;
-        s.accel = kdtree;
+        for (auto &shape : shapes) {
+            if (shape->is_mesh()) {
+                Mesh *mesh = (Mesh *) shape.get();
+                dr::eval(mesh->vertex_positions_buffer(),
+                         mesh->vertex_motion_positions_buffer(),
+                         mesh->faces_buffer());
+            }
+        }
+        dr::sync_thread();
+    }
+
+    uint64_t key = hash_buffer(&seed, sizeof(uint64_t));
+    for (auto &shape : shapes) {
+        std::string class_name = shape->class_()->name();
+        key = hash_buffer(class_name.data(), class_name.size(), key);
+
+        uint32_t prim_count = shape->primitive_count();
+        key = hash_buffer(&prim_count, sizeof(uint32_t), key);
+
+        if (shape->is_mesh()) {
+            Mesh *mesh = (Mesh *) shape.get();
+            auto &positions = mesh->vertex_positions_buffer();
+            auto &motion = mesh->vertex_motion_positions_buffer();
+            auto &faces = mesh->faces_buffer();
+            key = hash_buffer(positions.data(),
+                              positions.size() * sizeof(dr::scalar_t<Float>), key);
+            if (motion.size() > 0)
+                key = hash_buffer(motion.data(),
+                                  motion.size() * sizeof(dr::scalar_t<Float>), key);
+            key = hash_buffer(faces.data(), faces.size() * sizeof(uint32_t), key);
+        } else {
+            std::string desc = shape->to_string();
+            key = hash_buffer(desc.data(), desc.size(), key);
+        }
+    }
+    return key;
+}
+
+MI_VARIANT void Scene<Float, Spectrum>::accel_init_cpu(const Properties &props) {
+    m_accel = new NativeState<Float, Spectrum>();
+    NativeState<Float, Spectrum> &s = *(NativeState<Float, Spectrum> *) m_accel;
+
+    /* The native backend supports two acceleration data structures: the SAH
+       kd-tree (default), and a wide BVH with quantized nodes */
+    std::string accel = props.string("accel", "kdtree");
+    if (accel == "kdtree") {
+        s.accel = new ShapeKDTree(props);
+        s.accel->inc_ref();
+    } else if (accel == "bvh") {
+        s.bvh = new ShapeBVH(props);
+        s.bvh->inc_ref();
+    } else {
+        Throw("Scene: unsupported acceleration data structure \"%s\" "
+              "(must be \"kdtree\" or \"bvh\")", accel);
+    }
+
+    /* Optionally cache built acceleration data structures on disk. Cache
+       entries are keyed by a hash of the geometry and build parameters */
+    std::string cache_dir = props.string("accel_cache", "");
+    if (!cache_dir.empty()) {
+        s.cache_dir = fs::path(cache_dir);
+        if (!fs::exists(s.cache_dir) && !fs::create_directory(s.cache_dir))
+            Throw("Scene: could not create the acceleration data structure "
+                  "cache directory \"%s\"", cache_dir);
+
+        std::string params = accel + ";" + std::to_string(sizeof(ScalarFloat));
+        for (const std::string &name : props.property_names()) {
+            if (string::starts_with(name, "kd_") ||
+                string::starts_with(name, "bvh_"))
+                params += ";" + name + "=" + props.as_string(name);
+        }
+        s.params_hash = hash_buffer(params.data(), params.size());
+    }
 
+    /* Instances are by default moved into a dedicated top-level BVH, which
+       descends directly into the referenced shape groups */
+    if (props.get<bool>("accel_instances", true)) {
+        s.instances = new ShapeBVH(props);
+        s.instances->inc_ref();
+    }
+
+    if constexpr (dr::is_llvm_v<Float>) {
         // Get shapes registry ids
         if (!m_shapes.empty()) {
             std::unique_ptr<uint32_t[]> data(new uint32_t[m_shapes.size()]);
@@ -26,8 +189,6 @@ MI_VARIANT void Scene<Float, Spectrum>::accel_init_cpu(const Properties &props)
         } else {
             s.shapes_registry_ids = dr::zeros<DynamicBuffer<UInt32>>();
         }
-    } else {
-        m_accel = kdtree;
     }
 
     accel_parameters_changed_cpu();
@@ -38,17 +199,68 @@ MI_VARIANT void Scene<Float, Spectrum>::accel_parameters_changed_cpu() {
     if constexpr (dr::is_llvm_v<Float>)
         dr::sync_thread();
 
-    ShapeKDTree *kdtree;
-    if constexpr (dr::is_llvm_v<Float>)
-        kdtree = ((NativeState<Float, Spectrum> *) m_accel)->accel;
-    else
-        kdtree = (ShapeKDTree *) m_accel;
+    NativeState<Float, Spectrum> &s = *(NativeState<Float, Spectrum> *) m_accel;
 
-    kdtree->clear();
-    for (Shape *shape : m_shapes)
-        kdtree->add_shape(shape);
     ScopedPhase phase(ProfilerPhase::InitAccel);
-    kdtree->build();
+
+    /* Partition the shapes into regular geometry and instances, the latter
+       are (optionally) placed into a separate top-level BVH */
+    std::vector<ref<Shape>> geometry;
+    s.geometry_ids.clear();
+    s.instance_ids.clear();
+    for (size_t i = 0; i < m_shapes.size(); ++i) {
+        if (s.instances && m_shapes[i]->instanced_shapegroup()) {
+            s.instance_ids.push_back((uint32_t) i);
+        } else {
+            s.geometry_ids.push_back((uint32_t) i);
+            geometry.push_back(m_shapes[i]);
+        }
+    }
+
+    if (s.instances) {
+        s.instances->clear();
+        for (uint32_t i : s.instance_ids)
+            s.instances->add_shape(m_shapes[i]);
+        if (!s.instance_ids.empty())
+            s.instances->build();
+    }
+
+    if (s.instance_ids.empty())
+        s.geometry_ids.clear();
+
+    uint64_t cache_key = 0;
+    fs::path cache_file;
+    if (!s.cache_dir.empty() && !geometry.empty()) {
+        cache_key = accel_cache_key<Float, Spectrum>(geometry, s.params_hash);
+        cache_file = s.cache_dir / tfm::format("accel_%016llx.bin",
+                                               (unsigned long long) cache_key);
+    }
+
+    /* Skip the build entirely if all shapes are instances. The geometry
+       data structure is only traversed when 'geometry_ids' is non-empty. */
+    bool build_geometry = !geometry.empty() || s.instance_ids.empty();
+
+    if (s.bvh) {
+        s.bvh->clear();
+        for (Shape *shape : geometry)
+            s.bvh->add_shape(shape);
+        if (build_geometry &&
+            (cache_file.empty() || !s.bvh->read_cache(cache_file, cache_key))) {
+            s.bvh->build();
+            if (!cache_file.empty())
+                s.bvh->write_cache(cache_file, cache_key);
+        }
+    } else {
+        s.accel->clear();
+        for (Shape *shape : geometry)
+            s.accel->add_shape(shape);
+        if (build_geometry &&
+            (cache_file.empty() || !s.accel->read_cache(cache_file, cache_key))) {
+            s.accel->build();
+            if (!cache_file.empty())
+                s.accel->write_cache(cache_file, cache_key);
+        }
+    }
 
     /* Set up a callback on the handle variable to release the Embree
        acceleration data structure (IAS) when this variable is freed. This
@@ -59,7 +271,7 @@ MI_VARIANT void Scene<Float, Spectrum>::accel_parameters_changed_cpu() {
         // Prevents the IAS to be released when updating the scene parameters
         if (m_accel_handle.index())
             jit_var_set_callback(m_accel_handle.index(), nullptr, nullptr);
-        m_accel_handle = dr::opaque<UInt64>(kdtree);
+        m_accel_handle = dr::opaque<UInt64>(m_accel);
         jit_var_set_callback(
             m_accel_handle.index(),
             [](uint32_t /* index */, int free, void *payload) {
@@ -69,8 +281,7 @@ MI_VARIANT void Scene<Float, Spectrum>::accel_parameters_changed_cpu() {
                         Log(Debug, "Free KDTree..");
                         NativeState<Float, Spectrum> *s =
                             (NativeState<Float, Spectrum> *) payload;
-                        s->accel->clear();
-                        s->accel->dec_ref();
+                        s->release();
                         delete s;
                     });
                     Thread::register_task(task);
@@ -93,12 +304,30 @@ MI_VARIANT void Scene<Float, Spectrum>::accel_release_cpu() {
            ray tracing calls are pending. */
         m_accel_handle = 0;
     } else {
-        ((ShapeKDTree *) m_accel)->dec_ref();
+        NativeState<Float, Spectrum> *s = (NativeState<Float, Spectrum> *) m_accel;
+        s->release();
+        delete s;
     }
 
     m_accel = nullptr;
 }
 
+MI_VARIANT size_t Scene<Float, Spectrum>::accel_memory_cpu() const {
+    const NativeState<Float, Spectrum> *s =
+        (const NativeState<Float, Spectrum> *) m_accel;
+    if (!s)
+        return 0;
+
+    size_t bytes = (s->geometry_ids.size() + s->instance_ids.size()) * sizeof(uint32_t);
+    if (s->accel)
+        bytes += s->accel->memory_usage();
+    if (s->bvh)
+        bytes += s->bvh->memory_usage();
+    if (s->instances)
+        bytes += s->instances->memory_usage();
+    return bytes;
+}
+
 #if defined(_MSC_VER)
 #  pragma pack(push, 1)
 #endif
@@ -121,12 +350,57 @@ void kdtree_trace_func_wrapper(const int *valid, void *ptr,
                                void* /* context */, uint8_t *args) {
     MI_IMPORT_TYPES()
     using ScalarRay3f = Ray<ScalarPoint3f, Spectrum>;
-    using ShapeKDTree = ShapeKDTree<Float, Spectrum>;
-
     NativeState<Float, Spectrum> *s = (NativeState<Float, Spectrum> *) ptr;
-    const ShapeKDTree *kdtree = s->accel;
     using RayHit = RayHitT<ScalarFloat>;
 
+    /* Without a BVH or instances, trace the whole packet through the
+       kd-tree at once so that its inner nodes are traversed using SIMD */
+    if constexpr (Width > 1) {
+        if (!s->bvh && s->instance_ids.empty()) {
+            ScalarRay3f rays[Width];
+            bool active[Width];
+            PreliminaryIntersection<ScalarFloat, Shape> pis[Width];
+
+            for (size_t i = 0; i < Width; i++) {
+                active[i] = valid[i] != 0;
+                if (!active[i])
+                    continue;
+
+                ScalarRay3f &ray = rays[i];
+                ray.o[0] = ((ScalarFloat*) &args[offsetof(RayHit, o_x) * Width])[i];
+                ray.o[1] = ((ScalarFloat*) &args[offsetof(RayHit, o_y) * Width])[i];
+                ray.o[2] = ((ScalarFloat*) &args[offsetof(RayHit, o_z) * Width])[i];
+                ray.d[0] = ((ScalarFloat*) &args[offsetof(RayHit, d_x) * Width])[i];
+                ray.d[1] = ((ScalarFloat*) &args[offsetof(RayHit, d_y) * Width])[i];
+                ray.d[2] = ((ScalarFloat*) &args[offsetof(RayHit, d_z) * Width])[i];
+                ray.maxt = ((ScalarFloat*) &args[offsetof(RayHit, tfar) * Width])[i];
+                ray.time = ((ScalarFloat*) &args[offsetof(RayHit, time) * Width])[i];
+            }
+
+            s->accel->template ray_intersect_packet<ShadowRay, Width>(rays, active, pis);
+
+            for (size_t i = 0; i < Width; i++) {
+                const auto &pi = pis[i];
+                if (!active[i] || !pi.is_valid())
+                    continue;
+
+                ScalarFloat& ray_maxt = ((ScalarFloat*) &args[offsetof(RayHit, tfar) * Width])[i];
+                if constexpr (ShadowRay) {
+                    ray_maxt = 0.f;
+                } else {
+                    ray_maxt = pi.t;
+                    ((ScalarFloat*) &args[offsetof(RayHit, u) * Width])[i] = pi.prim_uv[0];
+                    ((ScalarFloat*) &args[offsetof(RayHit, v) * Width])[i] = pi.prim_uv[1];
+                    ((uint32_t*) &args[offsetof(RayHit, prim_id) * Width])[i] = pi.prim_index;
+                    ((uint32_t*) &args[offsetof(RayHit, geom_id) * Width])[i] = pi.shape_index;
+                    ((uint32_t*) &args[offsetof(RayHit, inst_id) * Width])[i] =
+                        pi.instance ? (uint32_t) (size_t) pi.shape : (uint32_t) -1;
+                }
+            }
+            return;
+        }
+    }
+
     for (size_t i = 0; i < Width; i++) {
         if (valid[i] == 0)
             continue;
@@ -147,11 +421,11 @@ void kdtree_trace_func_wrapper(const int *valid, void *ptr,
         ScalarRay3f ray = ScalarRay3f(ray_o, ray_d, ray_maxt, ray_time, wavelength_t<Spectrum>());
 
         if constexpr (ShadowRay) {
-            bool hit = kdtree->template ray_intersect_scalar<true>(ray).is_valid();
+            bool hit = s->template ray_intersect_scalar<true>(ray).is_valid();
             if (hit)
                 ray_maxt = 0.f;
         } else {
-            auto pi = kdtree->template ray_intersect_scalar<false>(ray);
+            auto pi = s->template ray_intersect_scalar<false>(ray);
             if (pi.is_valid()) {
                 ScalarFloat& prim_u = ((ScalarFloat*) &args[offsetof(RayHit, u) * Width])[i];
                 ScalarFloat& prim_v = ((ScalarFloat*) &args[offsetof(RayHit, v) * Width])[i];
@@ -176,12 +450,12 @@ MI_VARIANT typename Scene<Float, Spectrum>::PreliminaryIntersection3f
 Scene<Float, Spectrum>::ray_intersect_preliminary_cpu(const Ray3f &ray,
                                                       Mask coherent,
                                                       Mask active) const {
+    NativeState<Float, Spectrum> *s = (NativeState<Float, Spectrum> *) m_accel;
     if constexpr (!dr::is_array_v<Float>) {
         DRJIT_MARK_USED(coherent);
-        const ShapeKDTree *kdtree = (const ShapeKDTree *) m_accel;
-        return kdtree->template ray_intersect_preliminary<false>(ray, active);
+        DRJIT_MARK_USED(active);
+        return s->template ray_intersect_scalar<false>(ray);
     } else {
-        NativeState<Float, Spectrum> *s = (NativeState<Float, Spectrum> *) m_accel;
         void *func_ptr = nullptr,
              *scene_ptr = m_accel;
 
@@ -245,6 +519,15 @@ Scene<Float, Spectrum>::ray_intersect_preliminary_cpu(const Ray3f &ray,
     }
 }
 
+MI_VARIANT void
+Scene<Float, Spectrum>::ray_intersect_preliminary_packet_cpu(const Ray3f *rays,
+                                                             PreliminaryIntersection3f *pi,
+                                                             size_t count) const {
+    // No packet traversal in the native backend, trace the rays one by one
+    for (size_t i = 0; i < count; ++i)
+        pi[i] = ray_intersect_preliminary_cpu(rays[i], true, true);
+}
+
 MI_VARIANT typename Scene<Float, Spectrum>::SurfaceInteraction3f
 Scene<Float, Spectrum>::ray_intersect_cpu(const Ray3f &ray, uint32_t ray_flags,
                                           Mask coherent, Mask active) const {
@@ -266,8 +549,10 @@ Scene<Float, Spectrum>::ray_test_cpu(const Ray3f &ray,
                                      Mask coherent, Mask active) const {
     if constexpr (!dr::is_jit_v<Float>) {
         DRJIT_MARK_USED(coherent);
-        const ShapeKDTree *kdtree = (const ShapeKDTree *) m_accel;
-        return kdtree->template ray_intersect_preliminary<true>(ray, active).is_valid();
+        DRJIT_MARK_USED(active);
+        const NativeState<Float, Spectrum> *s =
+            (const NativeState<Float, Spectrum> *) m_accel;
+        return s->template ray_intersect_scalar<true>(ray).is_valid();
     } else {
         void *func_ptr = nullptr, *scene_ptr = m_accel;
 
@@ -308,14 +593,31 @@ Scene<Float, Spectrum>::ray_test_cpu(const Ray3f &ray,
 
 MI_VARIANT typename Scene<Float, Spectrum>::SurfaceInteraction3f
 Scene<Float, Spectrum>::ray_intersect_naive_cpu(const Ray3f &ray, Mask active) const {
-    const ShapeKDTree *kdtree;
-    if constexpr (dr::is_llvm_v<Float>)
-        kdtree = ((NativeState<Float, Spectrum> *) m_accel)->accel;
-    else
-        kdtree = (const ShapeKDTree *) m_accel;
+    const NativeState<Float, Spectrum> *s =
+        (const NativeState<Float, Spectrum> *) m_accel;
+
+    PreliminaryIntersection3f pi;
+    if (s->instance_ids.empty() || !s->geometry_ids.empty()) {
+        pi = s->bvh ? s->bvh->template ray_intersect_naive<false>(ray, active)
+                    : s->accel->template ray_intersect_naive<false>(ray, active);
+    }
+
+    if constexpr (!dr::is_array_v<Float>) {
+        if (!s->instance_ids.empty()) {
+            Ray3f ray2(ray);
+            if (pi.is_valid()) {
+                pi.shape_index = s->geometry_ids[pi.shape_index];
+                ray2.maxt = pi.t;
+            }
 
-    PreliminaryIntersection3f pi =
-        kdtree->template ray_intersect_naive<false>(ray, active);
+            PreliminaryIntersection3f pi_inst =
+                s->instances->template ray_intersect_naive<false>(ray2, active);
+            if (pi_inst.is_valid()) {
+                pi_inst.shape = (ShapePtr) (size_t) s->instance_ids[(size_t) pi_inst.shape];
+                pi = pi_inst;
+            }
+        }
+    }
 
     return pi.compute_surface_interaction(ray, +RayFlags::All, active);
 }
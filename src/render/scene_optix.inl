@@ -32,9 +32,20 @@ struct OptixSceneState {
     struct InstanceData {
         void* buffer = nullptr;  // Device-visible storage for IAS
         void* inputs = nullptr;  // Device-visible storage for OptixInstance array
+        size_t size = 0;         // Combined size of both buffers
+        size_t buffer_size = 0;  // Size of the IAS storage
+        void* temp_buffer = nullptr; // Scratch memory of an updatable IAS
+        size_t temp_size = 0;
+        uint32_t update_count = 0;   // Number of in-place updates since the last build
     } ias_data;
+    /// Instances of the last IAS build (if the IAS can be updated)
+    std::vector<OptixInstance> ias_instances;
     size_t config_index;
     uint32_t sbt_jit_index;
+    /// Number of in-place GAS updates between full rebuilds (0: always rebuild)
+    uint32_t accel_update_interval = 0;
+    /// Number of in-place IAS updates between full rebuilds
+    uint32_t ias_update_interval = 16;
 };
 
 /**
@@ -53,19 +64,36 @@ struct OptixConfig {
     OptixModule main_module;
     OptixModule bspline_curve_module; /// Built-in module for B-spline curves
     OptixModule linear_curve_module; /// Built-in module for linear curves
+    OptixModule sphere_module; /// Built-in module for sphere clouds
+    /// Program groups of all shape types (\c nullptr if not used by the config)
     OptixProgramGroup program_groups[PROGRAM_GROUP_COUNT];
     char *custom_shapes_program_names[2 * OPTIX_SHAPE_TYPE_COUNT];
     uint32_t pipeline_jit_index;
 };
 
-// Array storing previously initialized optix configurations
-static constexpr int32_t OPTIX_CONFIG_COUNT = 32;
-static OptixConfig optix_configs[OPTIX_CONFIG_COUNT] = {};
+// Map storing previously initialized optix configurations
+static std::unordered_map<size_t, OptixConfig> optix_configs;
 
+/**
+ * \brief Return the OptiX configuration that supports the given features
+ *
+ * The bits of \c shape_types specify which entries of \ref
+ * OPTIX_SHAPE_ORDER occur in the scene. Program groups are only created for
+ * these shape types (and for meshes if \c has_meshes is set).
+ */
 size_t init_optix_config(bool has_meshes, bool has_others, bool has_instances,
-                         bool has_bspline_curves, bool has_linear_curves) {
+                         bool has_bspline_curves, bool has_linear_curves,
+                         bool has_spheres, bool has_motion,
+                         uint32_t shape_types) {
+    auto has_type = [shape_types](OptixShapeType type) {
+        return (shape_types & (1u << (uint32_t) type)) != 0;
+    };
+
     // Compute config index in optix_configs based on required set of features
     size_t config_index =
+        ((size_t) shape_types << 7) +
+        (has_motion ? 64 : 0) +
+        (has_spheres ? 32 : 0) +
         (has_bspline_curves ? 16 : 0) +
         (has_linear_curves ? 8 : 0) +
         (has_instances ? 4 : 0) +
@@ -94,7 +122,8 @@ size_t init_optix_config(bool has_meshes, bool has_others, bool has_instances,
         module_compile_options.debugLevel       = OPTIX_COMPILE_DEBUG_LEVEL_FULL;
     #endif
 
-        config.pipeline_compile_options.usesMotionBlur     = false;
+        // Animated instances and deforming meshes require motion blur support
+        config.pipeline_compile_options.usesMotionBlur     = has_motion;
         config.pipeline_compile_options.numPayloadValues   = 6;
         config.pipeline_compile_options.numAttributeValues = 2; // the minimum legal value
         config.pipeline_compile_options.pipelineLaunchParamsVariableName = "params";
@@ -102,7 +131,7 @@ size_t init_optix_config(bool has_meshes, bool has_others, bool has_instances,
         bool at_least_two_gas = [&]() {
             uint32_t counter = 0;
             for (bool has_gas : { has_meshes, has_bspline_curves,
-                                  has_linear_curves, has_others })
+                                  has_linear_curves, has_spheres, has_others })
                 if (has_gas)
                     if (++counter >= 2)
                         return true;
@@ -136,6 +165,8 @@ size_t init_optix_config(bool has_meshes, bool has_others, bool has_instances,
             prim_flags |= OPTIX_PRIMITIVE_TYPE_FLAGS_ROUND_CUBIC_BSPLINE;
         if (has_linear_curves)
             prim_flags |= OPTIX_PRIMITIVE_TYPE_FLAGS_ROUND_LINEAR;
+        if (has_spheres)
+            prim_flags |= OPTIX_PRIMITIVE_TYPE_FLAGS_SPHERE;
 
         config.pipeline_compile_options.usesPrimitiveTypeFlags = prim_flags;
 
@@ -200,7 +231,7 @@ size_t init_optix_config(bool has_meshes, bool has_others, bool has_instances,
                   "compilation state is: %#06x", compilation_state);
 
         // =====================================================
-        // Load built-in Optix modules for curves
+        // Load built-in Optix modules for curves and spheres
         // =====================================================
 
         if (has_bspline_curves) {
@@ -229,22 +260,42 @@ size_t init_optix_config(bool has_meshes, bool has_others, bool has_instances,
                                         &config.pipeline_compile_options,
                                         &options, &config.linear_curve_module));
         }
+        if (has_spheres) {
+            OptixBuiltinISOptions options = {};
+            options.builtinISModuleType = OPTIX_PRIMITIVE_TYPE_SPHERE;
+            options.usesMotionBlur      = false;
+            // buildFlags must match the flags used in OptixAccelBuildOptions (shapes.h)
+            options.buildFlags          = OPTIX_BUILD_FLAG_ALLOW_COMPACTION |
+                                          OPTIX_BUILD_FLAG_PREFER_FAST_TRACE;
+            jit_optix_check(
+                optixBuiltinISModuleGet(config.context, &module_compile_options,
+                                        &config.pipeline_compile_options,
+                                        &options, &config.sphere_module));
+        }
 
         // =====================================================
         // Create program groups (raygen provided by Dr.Jit..)
         // =====================================================
 
+        /* Only the program groups of the shape types that occur in the scene
+           are created, the remaining entries of 'pgd' stay unused. */
         OptixProgramGroupOptions program_group_options = {};
         OptixProgramGroupDesc pgd[PROGRAM_GROUP_COUNT] {};
+        bool pgd_used[PROGRAM_GROUP_COUNT] {};
 
         pgd[0].kind                         = OPTIX_PROGRAM_GROUP_KIND_MISS;
         pgd[0].miss.module                  = config.main_module;
         pgd[0].miss.entryFunctionName       = "__miss__ms";
+        pgd_used[0] = true;
         pgd[1].kind                         = OPTIX_PROGRAM_GROUP_KIND_HITGROUP;
         pgd[1].hitgroup.moduleCH            = config.main_module;
         pgd[1].hitgroup.entryFunctionNameCH = "__closesthit__mesh";
+        pgd_used[1] = has_meshes;
 
         for (size_t i = 0; i < OPTIX_SHAPE_TYPE_COUNT; i++) {
+            if (!has_type(OPTIX_SHAPE_ORDER[i]))
+                continue;
+            pgd_used[2+i] = true;
             pgd[2+i].kind = OPTIX_PROGRAM_GROUP_KIND_HITGROUP;
 
             OptixShapeType optix_shape_type = OPTIX_SHAPE_ORDER[i];
@@ -265,6 +316,8 @@ size_t init_optix_config(bool has_meshes, bool has_others, bool has_instances,
                         pgd[2 + i].hitgroup.moduleIS = config.bspline_curve_module; break;
                     case LinearCurve:
                         pgd[2 + i].hitgroup.moduleIS = config.linear_curve_module; break;
+                    case Spheres:
+                        pgd[2 + i].hitgroup.moduleIS = config.sphere_module; break;
                     default:
                         Throw("Unknown builtin OptiX shape type: \"%s\"!",
                               OPTIX_SHAPE_TYPE_NAMES[optix_shape_type]);
@@ -274,17 +327,27 @@ size_t init_optix_config(bool has_meshes, bool has_others, bool has_instances,
                 pgd[2+i].hitgroup.moduleIS = config.main_module;
         }
 
+        OptixProgramGroupDesc pgd_compact[PROGRAM_GROUP_COUNT];
+        OptixProgramGroup pg_compact[PROGRAM_GROUP_COUNT];
+        uint32_t pg_count = 0;
+        for (size_t i = 0; i < PROGRAM_GROUP_COUNT; i++)
+            if (pgd_used[i])
+                pgd_compact[pg_count++] = pgd[i];
+
         optix_log_size = sizeof(optix_log);
         check_log(optixProgramGroupCreate(
             config.context,
-            pgd,
-            PROGRAM_GROUP_COUNT,
+            pgd_compact,
+            pg_count,
             &program_group_options,
             optix_log,
             &optix_log_size,
-            config.program_groups
+            pg_compact
         ));
 
+        for (size_t i = 0, j = 0; i < PROGRAM_GROUP_COUNT; i++)
+            config.program_groups[i] = pgd_used[i] ? pg_compact[j++] : nullptr;
+
         // Create this variable in the JIT scope 0 to ensure a consistent
         // ordering in the generated PTX kernel (e.g. for other scenes).
         uint32_t scope = jit_scope(JitBackend::CUDA);
@@ -292,7 +355,7 @@ size_t init_optix_config(bool has_meshes, bool has_others, bool has_instances,
         config.pipeline_jit_index = jit_optix_configure_pipeline(
             &config.pipeline_compile_options,
             config.main_module,
-            config.program_groups, PROGRAM_GROUP_COUNT
+            pg_compact, pg_count
         );
         jit_set_scope(JitBackend::CUDA, scope);
     }
@@ -311,6 +374,19 @@ MI_VARIANT void Scene<Float, Spectrum>::accel_init_gpu(const Properties &props)
         m_accel = new OptixSceneState();
         OptixSceneState &s = *(OptixSceneState *) m_accel;
 
+        int interval = props.get<int>("accel_rebuild_interval", 16);
+        if (interval < 1)
+            Throw("Scene: 'accel_rebuild_interval' must be >= 1!");
+
+        /* Dynamic scene mode: refit the mesh GAS in place when only vertex
+           positions change, and fully rebuild it every few updates */
+        if (props.get<bool>("accel_update", false))
+            s.accel_update_interval = (uint32_t) interval;
+
+        /* The IAS is always updated in place when only the transformations
+           of instances change */
+        s.ias_update_interval = (uint32_t) interval;
+
         // Check if another scene was passed to the constructor
         Scene *other_scene = nullptr;
         for (auto &[k, v] : props.objects()) {
@@ -371,26 +447,40 @@ MI_VARIANT void Scene<Float, Spectrum>::accel_init_gpu(const Properties &props)
             bool has_instances = false;
             bool has_bspline_curves = false;
             bool has_linear_curves = false;
+            bool has_spheres = false;
+            bool has_motion = false;
+            uint32_t shape_types = 0; // See OPTIX_SHAPE_ORDER
 
             for (auto& shape : m_shapes) {
                 uint32_t type = shape->shape_type();
+                if (!shape->is_mesh() && !shape->is_instance())
+                    shape_types |= 1u << get_shape_descr_idx(shape.get());
 
                 has_meshes           |= (type == +ShapeType::Mesh);
                 has_instances        |= (type == +ShapeType::Instance);
                 has_bspline_curves   |= (type == +ShapeType::BSplineCurve);
                 has_linear_curves    |= (type == +ShapeType::LinearCurve);
+                has_spheres          |= (type == +ShapeType::Spheres);
                 has_others           |= !shape->is_mesh() && !shape->is_instance();
+                has_motion           |= shape->is_animated();
             }
 
             for (auto& shape : m_shapegroups) {
-                has_meshes |= shape->has_meshes();
+                has_meshes |= shape->has_meshes() || shape->proxy();
                 has_bspline_curves |= shape->has_bspline_curves();
                 has_linear_curves |= shape->has_linear_curves();
+                has_spheres |= shape->has_spheres();
                 has_others |= shape->has_others();
+                has_motion |= shape->is_animated();
+
+                for (auto& shape2 : shape->shapes())
+                    if (!shape2->is_mesh() && !shape2->is_instance())
+                        shape_types |= 1u << get_shape_descr_idx(shape2.get());
             }
 
             s.config_index = init_optix_config(has_meshes, has_others,
-                has_instances, has_bspline_curves, has_linear_curves);
+                has_instances, has_bspline_curves, has_linear_curves, has_spheres,
+                has_motion, shape_types);
             const OptixConfig &config = optix_configs[s.config_index];
 
             // =====================================================
@@ -445,21 +535,84 @@ MI_VARIANT void Scene<Float, Spectrum>::accel_parameters_changed_gpu() {
         const OptixConfig &config = optix_configs[s.config_index];
 
         if (!m_shapes.empty()) {
-            // Build geometry acceleration structures for all the shapes
-            build_gas(config.context, m_shapes, s.accel);
-            for (auto& shapegroup: m_shapegroups)
-                shapegroup->optix_build_gas(config.context);
+            /* When only the transformations of static instances changed, the
+               GAS are left untouched and the IAS is updated in place */
+            bool update_ias = s.ias_data.temp_buffer != nullptr &&
+                              s.ias_data.update_count < s.ias_update_interval;
+            for (auto &shapegroup : m_shapegroups)
+                update_ias &= !shapegroup->dirty();
+            for (auto &shape : m_shapes) {
+                if (shape->dirty())
+                    update_ias &= shape->is_instance() && !shape->is_animated();
+            }
+
+            if (!update_ias) {
+                // Build geometry acceleration structures for all the shapes
+                build_gas(config.context, m_shapes, s.accel, s.accel_update_interval);
+                for (auto& shapegroup: m_shapegroups)
+                    shapegroup->optix_build_gas(config.context);
+            }
 
             // Gather information about the instance acceleration structures to be built
             std::vector<OptixInstance> ias;
             prepare_ias(config.context, m_shapes, 0, s.accel, 0u, ScalarTransform4f(), ias);
 
+            // An update requires the same instances, up to their transformations
+            if (update_ias)
+                update_ias = ias.size() == s.ias_instances.size();
+            for (size_t i = 0; i < ias.size() && update_ias; ++i) {
+                const OptixInstance &a = ias[i], &b = s.ias_instances[i];
+                update_ias = a.instanceId == b.instanceId &&
+                             a.sbtOffset == b.sbtOffset &&
+                             a.visibilityMask == b.visibilityMask &&
+                             a.flags == b.flags &&
+                             a.traversableHandle == b.traversableHandle;
+            }
+
             // If we expect only a single IAS, no need to build the "master" IAS
             if (config.pipeline_compile_options.traversableGraphFlags == OPTIX_TRAVERSABLE_GRAPH_FLAG_ALLOW_SINGLE_GAS) {
                 if (ias.size() != 1)
                     Throw("OPTIX_TRAVERSABLE_GRAPH_FLAG_ALLOW_SINGLE_GAS used but found multiple IASs.");
                 s.ias_data = {};
                 s.ias_handle = ias[0].traversableHandle;
+            } else if (update_ias) {
+                // Write the new transformations and refit the IAS in place
+                OptixAccelBuildOptions accel_options = {};
+                accel_options.buildFlags = OPTIX_BUILD_FLAG_PREFER_FAST_TRACE |
+                                           OPTIX_BUILD_FLAG_ALLOW_UPDATE;
+                accel_options.operation  = OPTIX_BUILD_OPERATION_UPDATE;
+                accel_options.motionOptions.numKeys = 0;
+
+                size_t ias_data_size = ias.size() * sizeof(OptixInstance);
+                void* d_ias = jit_malloc(AllocType::HostPinned, ias_data_size);
+                jit_memcpy_async(JitBackend::CUDA, d_ias, ias.data(), ias_data_size);
+                jit_memcpy_async(JitBackend::CUDA, s.ias_data.inputs, d_ias, ias_data_size);
+                jit_free(d_ias);
+
+                OptixBuildInput build_input;
+                build_input.type = OPTIX_BUILD_INPUT_TYPE_INSTANCES;
+                build_input.instanceArray.instances = (CUdeviceptr)s.ias_data.inputs;
+                build_input.instanceArray.numInstances = (unsigned int) ias.size();
+
+                scoped_optix_context guard;
+
+                jit_optix_check(optixAccelBuild(
+                    config.context,
+                    (CUstream) jit_cuda_stream(),
+                    &accel_options,
+                    &build_input,
+                    1, // num build inputs
+                    (CUdeviceptr)s.ias_data.temp_buffer,
+                    s.ias_data.temp_size,
+                    (CUdeviceptr)s.ias_data.buffer,
+                    s.ias_data.buffer_size,
+                    &s.ias_handle,
+                    0, // emitted property list
+                    0  // num emitted properties
+                ));
+
+                s.ias_data.update_count++;
+                s.ias_instances = std::move(ias);
             } else {
                 // Build a "master" IAS that contains all the IAS of the scene (meshes,
                 // custom shapes, instances, ...)
@@ -468,12 +621,20 @@ MI_VARIANT void Scene<Float, Spectrum>::accel_parameters_changed_gpu() {
                 accel_options.operation  = OPTIX_BUILD_OPERATION_BUILD;
                 accel_options.motionOptions.numKeys = 0;
 
+                // Instances with a static transformation can later be updated in place
+                bool allow_update = false;
+                for (auto &shape : m_shapes)
+                    allow_update |= shape->is_instance() && !shape->is_animated();
+                if (allow_update)
+                    accel_options.buildFlags |= OPTIX_BUILD_FLAG_ALLOW_UPDATE;
+
                 size_t ias_data_size = ias.size() * sizeof(OptixInstance);
                 void* d_ias = jit_malloc(AllocType::HostPinned, ias_data_size);
                 jit_memcpy_async(JitBackend::CUDA, d_ias, ias.data(), ias_data_size);
 
                 jit_free(s.ias_data.buffer);
                 jit_free(s.ias_data.inputs);
+                jit_free(s.ias_data.temp_buffer);
                 s.ias_data = {};
                 s.ias_data.inputs = jit_malloc_migrate(d_ias, AllocType::Device, 1);
 
@@ -491,10 +652,15 @@ MI_VARIANT void Scene<Float, Spectrum>::accel_parameters_changed_gpu() {
                     &buffer_sizes
                 ));
 
-                void* d_temp_buffer
-                    = jit_malloc(AllocType::Device, buffer_sizes.tempSizeInBytes);
+                size_t temp_size = buffer_sizes.tempSizeInBytes;
+                if (allow_update)
+                    temp_size = std::max(temp_size, buffer_sizes.tempUpdateSizeInBytes);
+
+                void* d_temp_buffer = jit_malloc(AllocType::Device, temp_size);
                 s.ias_data.buffer
                     = jit_malloc(AllocType::Device, buffer_sizes.outputSizeInBytes);
+                s.ias_data.buffer_size = buffer_sizes.outputSizeInBytes;
+                s.ias_data.size = ias_data_size + buffer_sizes.outputSizeInBytes;
 
                 scoped_optix_context guard;
 
@@ -505,7 +671,7 @@ MI_VARIANT void Scene<Float, Spectrum>::accel_parameters_changed_gpu() {
                     &build_input,
                     1, // num build inputs
                     (CUdeviceptr)d_temp_buffer,
-                    buffer_sizes.tempSizeInBytes,
+                    temp_size,
                     (CUdeviceptr)s.ias_data.buffer,
                     buffer_sizes.outputSizeInBytes,
                     &s.ias_handle,
@@ -513,7 +679,15 @@ MI_VARIANT void Scene<Float, Spectrum>::accel_parameters_changed_gpu() {
                     0  // num emitted properties
                 ));
 
-                jit_free(d_temp_buffer);
+                // Keep the scratch memory around for in-place updates
+                if (allow_update) {
+                    s.ias_data.temp_buffer = d_temp_buffer;
+                    s.ias_data.temp_size = temp_size;
+                    s.ias_instances = std::move(ias);
+                } else {
+                    jit_free(d_temp_buffer);
+                    s.ias_instances.clear();
+                }
             }
         }
 
@@ -536,6 +710,7 @@ MI_VARIANT void Scene<Float, Spectrum>::accel_parameters_changed_gpu() {
                     auto* s = (OptixSceneState *)payload;
                     jit_free(s->ias_data.buffer);
                     jit_free(s->ias_data.inputs);
+                    jit_free(s->ias_data.temp_buffer);
                     delete s;
                 }
             },
@@ -569,12 +744,24 @@ MI_VARIANT void Scene<Float, Spectrum>::accel_release_gpu() {
     }
 }
 
+MI_VARIANT size_t Scene<Float, Spectrum>::accel_memory_gpu() const {
+    const OptixSceneState *s = (const OptixSceneState *) m_accel;
+    if (!s)
+        return 0;
+
+    size_t bytes = s->ias_data.size;
+    for (const OptixAccelData::HandleData *h :
+         { &s->accel.meshes, &s->accel.motion_meshes, &s->accel.bspline_curves,
+           &s->accel.linear_curves, &s->accel.spheres, &s->accel.custom_shapes })
+        bytes += h->buffer_size + h->temp_size;
+    return bytes;
+}
+
 MI_VARIANT void Scene<Float, Spectrum>::static_accel_initialization_gpu() { }
 MI_VARIANT void Scene<Float, Spectrum>::static_accel_shutdown_gpu() {
     if constexpr (dr::is_cuda_v<Float>) {
         Log(Debug, "Scene static GPU acceleration shutdown ..");
-        for (size_t j = 0; j < OPTIX_CONFIG_COUNT; j++) {
-            OptixConfig &config = optix_configs[j];
+        for (auto &[index, config] : optix_configs) {
             if (config.pipeline_jit_index) {
                 /* Decrease the reference count of the pipeline JIT variable.
                    This will trigger the release of the OptiX pipeline data
@@ -654,6 +841,9 @@ Scene<Float, Spectrum>::ray_intersect_preliminary_gpu(const Ray3f &ray,
         pi.shape[!active]    = nullptr;
         pi.instance[!active] = nullptr;
 
+        if (m_geometry_cache)
+            m_geometry_cache->record(pi.shape, active);
+
         return pi;
     } else {
         DRJIT_MARK_USED(ray);
@@ -679,6 +869,11 @@ Scene<Float, Spectrum>::ray_intersect_gpu(const Ray3f &ray, uint32_t ray_flags,
 MI_VARIANT typename Scene<Float, Spectrum>::Mask
 Scene<Float, Spectrum>::ray_test_gpu(const Ray3f &ray, Mask active) const {
     if constexpr (dr::is_cuda_v<Float>) {
+        /* Shadow rays must report the shape groups they need as well, which
+           requires the closest-hit program */
+        if (m_geometry_cache)
+            return ray_intersect_preliminary_gpu(ray, active).is_valid();
+
         OptixSceneState &s = *(OptixSceneState *) m_accel;
         const OptixConfig &config = optix_configs[s.config_index];
 
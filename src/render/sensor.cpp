@@ -2,8 +2,10 @@
 
 #include <mitsuba/core/plugin.h>
 #include <mitsuba/core/logger.h>
+#include <mitsuba/render/emitter.h>
 #include <mitsuba/render/film.h>
 #include <mitsuba/render/sampler.h>
+#include <mitsuba/render/scene.h>
 
 NAMESPACE_BEGIN(mitsuba)
 
@@ -71,6 +73,22 @@ MI_VARIANT Sensor<Float, Spectrum>::Sensor(const Properties &props) : Base(props
             m_srf = m_film->sensor_response_function();
         }
     }
+
+    std::string wavelength_sampling =
+        string::to_lower(props.string("wavelength_sampling", "rgb"));
+    if (wavelength_sampling == "emitters") {
+        if constexpr (!is_spectral_v<Spectrum>)
+            Throw("Sensor(): emitter-driven wavelength sampling should be used "
+                  "in combination with a spectral variant");
+        if (m_srf != nullptr)
+            Log(Warn, "Sensor(): 'wavelength_sampling' is ignored when a "
+                      "spectral response function is specified.");
+        else
+            m_emitter_wavelengths = true;
+    } else if (wavelength_sampling != "rgb") {
+        Throw("Sensor(): invalid wavelength sampling strategy \"%s\", must be "
+              "\"rgb\" or \"emitters\"!", wavelength_sampling);
+    }
 }
 
 MI_VARIANT Sensor<Float, Spectrum>::~Sensor() {}
@@ -113,6 +131,32 @@ Sensor<Float, Spectrum>::sample_wavelengths(const SurfaceInteraction3f& /*si*/,
                     math::sample_shifted<Wavelength>(sample),
                     active);
         }
+
+        if (m_emitter_wavelengths) {
+            /* Defensive mixture with the RGB importance spectrum, so that
+               wavelengths with little emission (e.g. shifted by a
+               dispersive interface) are still sampled */
+            constexpr ScalarFloat RGBFraction = .25f;
+
+            Wavelength u = math::sample_shifted<Wavelength>(sample);
+            dr::mask_t<Wavelength> is_rgb = u < RGBFraction;
+
+            Wavelength u_rgb = dr::minimum(u * (1.f / RGBFraction),
+                                           dr::OneMinusEpsilon<Float>),
+                       u_emitter = dr::maximum(
+                           (u - RGBFraction) * (1.f / (1.f - RGBFraction)), 0.f);
+
+            Wavelength wavelengths = dr::select(
+                is_rgb, sample_rgb_spectrum(u_rgb).first,
+                m_wavelength_distr.sample(u_emitter, active));
+
+            Wavelength pdf = dr::fmadd(
+                RGBFraction, pdf_rgb_spectrum(wavelengths),
+                (1.f - RGBFraction) *
+                    m_wavelength_distr.eval_pdf_normalized(wavelengths, active));
+
+            return { wavelengths, dr::select(pdf > 0.f, dr::rcp(pdf), 0.f) };
+        }
     } else {
         DRJIT_MARK_USED(active);
     }
@@ -120,6 +164,89 @@ Sensor<Float, Spectrum>::sample_wavelengths(const SurfaceInteraction3f& /*si*/,
     return sample_wavelength<Float, Spectrum>(sample);
 }
 
+MI_VARIANT void Sensor<Float, Spectrum>::set_scene(const Scene *scene) {
+    Base::set_scene(scene);
+
+    if constexpr (is_spectral_v<Spectrum>) {
+        if (!m_emitter_wavelengths)
+            return;
+
+        // Table with a 5nm spacing, estimated using 4*1024 wavelengths per emitter
+        constexpr size_t Nodes = 95, Samples = 1024;
+        const ScalarFloat step = (ScalarFloat) (MI_CIE_MAX - MI_CIE_MIN) / (Nodes - 1);
+
+        std::vector<ScalarFloat> emission(Nodes, 0.f), hist(Nodes);
+        for (const Emitter *emitter : scene->emitters()) {
+            std::fill(hist.begin(), hist.end(), 0.f);
+
+            // Splat the importance weights of the emitter's own wavelength samples
+            auto splat = [&](ScalarFloat lambda, ScalarFloat weight) {
+                ScalarFloat x = (lambda - (ScalarFloat) MI_CIE_MIN) / step;
+                if (!(weight > 0.f) || !(x >= 0.f) || x > Nodes - 1)
+                    return;
+                size_t i = std::min((size_t) x, Nodes - 2);
+                ScalarFloat t = x - (ScalarFloat) i;
+                hist[i]     += (1.f - t) * weight;
+                hist[i + 1] += t * weight;
+            };
+
+            SurfaceInteraction3f si = dr::zeros<SurfaceInteraction3f>(Samples);
+            si.uv = Point2f(.5f);
+
+            if constexpr (dr::is_jit_v<Float>) {
+                using FloatStorage = DynamicBuffer<Float>;
+                Float u = (dr::arange<Float>(Samples) + .5f) * (1.f / Samples);
+                auto [wavelengths, weight] = emitter->sample_wavelengths(si, u);
+                UnpolarizedSpectrum value = unpolarized_spectrum(weight);
+
+                for (size_t j = 0; j < dr::size_v<Wavelength>; ++j) {
+                    auto &&lambda = dr::migrate(FloatStorage(dr::detach(wavelengths[j])), AllocType::Host);
+                    auto &&w = dr::migrate(FloatStorage(dr::detach(value[j])), AllocType::Host);
+                    dr::sync_thread();
+                    for (size_t i = 0; i < Samples; ++i)
+                        splat(lambda.data()[i], w.data()[i]);
+                }
+            } else {
+                for (size_t i = 0; i < Samples; ++i) {
+                    auto [wavelengths, weight] =
+                        emitter->sample_wavelengths(si, (i + .5f) / Samples);
+                    UnpolarizedSpectrum value = unpolarized_spectrum(weight);
+                    for (size_t j = 0; j < dr::size_v<Wavelength>; ++j)
+                        splat(wavelengths[j], value[j]);
+                }
+            }
+
+            // Normalize, so that every emitter contributes equally
+            ScalarFloat sum = 0.f;
+            for (ScalarFloat h : hist)
+                sum += h;
+            if (sum > 0.f) {
+                for (size_t i = 0; i < Nodes; ++i)
+                    emission[i] += hist[i] / sum;
+            }
+        }
+
+        // Weight by the RGB importance spectrum
+        ScalarFloat sum = 0.f;
+        for (size_t i = 0; i < Nodes; ++i) {
+            emission[i] *= pdf_rgb_spectrum((ScalarFloat) MI_CIE_MIN + i * step);
+            sum += emission[i];
+        }
+
+        if (!(sum > 0.f)) {
+            Log(Warn, "Sensor::set_scene(): the scene doesn't contain any "
+                      "emission, falling back to RGB wavelength sampling.");
+            m_emitter_wavelengths = false;
+            return;
+        }
+
+        m_wavelength_distr = ContinuousDistribution<Wavelength>(
+            ScalarVector2f(MI_CIE_MIN, MI_CIE_MAX), emission.data(), Nodes);
+    } else {
+        DRJIT_MARK_USED(scene);
+    }
+}
+
 // =============================================================================
 // ProjectiveCamera interface
 // =============================================================================
@@ -19,8 +19,12 @@
 NAMESPACE_BEGIN(mitsuba)
 
 MI_VARIANT Shape<Float, Spectrum>::Shape(const Properties &props) : m_id(props.id()) {
-    m_to_world =
-        (ScalarTransform4f) props.get<ScalarTransform4f>("to_world", ScalarTransform4f());
+    /* Animated transformations are only supported by instances, which query
+       them separately. Other shapes report them as unreferenced properties. */
+    if (!props.has_property("to_world") ||
+        props.type("to_world") != Properties::Type::AnimatedTransform)
+        m_to_world = (ScalarTransform4f) props.get<ScalarTransform4f>(
+            "to_world", ScalarTransform4f());
     m_to_object = m_to_world.scalar().inverse();
 
     for (auto &[name, obj] : props.objects(false)) {
@@ -311,6 +315,10 @@ MI_VARIANT RTCGeometry Shape<Float, Spectrum>::embree_geometry(RTCDevice device)
         Throw("embree_geometry() should only be called in CPU mode.");
     }
 }
+
+MI_VARIANT bool Shape<Float, Spectrum>::embree_update_transform(RTCGeometry) {
+    return false;
+}
 #endif
 
 #if defined(MI_ENABLE_CUDA)
@@ -331,6 +339,11 @@ void Shape<Float, Spectrum>::optix_fill_hitgroup_records(std::vector<HitGroupSbt
     };
 
     size_t program_group_idx = (is_mesh() ? 1 : 2 + get_shape_descr_idx(this));
+    if (!program_groups[program_group_idx])
+        Throw("The OptiX configuration of the scene lacks the program of "
+              "shape \"%s\". This can happen when a scene reuses the "
+              "configuration of another scene with different shape types.",
+              class_()->name());
     // Setup the hitgroup record and copy it to the hitgroup records array
     jit_optix_check(optixSbtRecordPackHeader(program_groups[program_group_idx],
                                              &hitgroup_records.back()));
@@ -486,6 +499,22 @@ bool Shape<Float, Spectrum>::ray_test_scalar(const ScalarRay3f & /*ray*/) const
     NotImplementedError("ray_intersect_test_scalar");
 }
 
+MI_VARIANT
+std::tuple<typename Shape<Float, Spectrum>::ScalarFloat,
+           typename Shape<Float, Spectrum>::ScalarPoint2f,
+           typename Shape<Float, Spectrum>::ScalarUInt32,
+           typename Shape<Float, Spectrum>::ScalarUInt32>
+Shape<Float, Spectrum>::ray_intersect_primitive_scalar(ScalarIndex /*prim_index*/,
+                                                       const ScalarRay3f &ray) const {
+    return ray_intersect_preliminary_scalar(ray);
+}
+
+MI_VARIANT
+bool Shape<Float, Spectrum>::ray_test_primitive_scalar(ScalarIndex /*prim_index*/,
+                                                       const ScalarRay3f &ray) const {
+    return ray_test_scalar(ray);
+}
+
 MI_VARIANT typename Shape<Float, Spectrum>::SurfaceInteraction3f
 Shape<Float, Spectrum>::compute_surface_interaction(const Ray3f & /*ray*/,
                                                     const PreliminaryIntersection3f &/*pi*/,
@@ -559,6 +588,12 @@ MI_VARIANT Float Shape<Float, Spectrum>::surface_area() const {
     NotImplementedError("surface_area");
 }
 
+MI_VARIANT std::pair<typename Shape<Float, Spectrum>::ScalarVector3f,
+                     typename Shape<Float, Spectrum>::ScalarFloat>
+Shape<Float, Spectrum>::normal_bounds() const {
+    return { ScalarVector3f(0.f, 0.f, 1.f), dr::Pi<ScalarFloat> };
+}
+
 MI_VARIANT typename Shape<Float, Spectrum>::ScalarBoundingBox3f
 Shape<Float, Spectrum>::bbox(ScalarIndex) const {
     return bbox();
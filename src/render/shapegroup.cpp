@@ -1,4 +1,5 @@
 #include <mitsuba/core/properties.h>
+#include <mitsuba/render/mesh.h>
 #include <mitsuba/render/shapegroup.h>
 #include <mitsuba/render/optix_api.h>
 
@@ -15,6 +16,8 @@ MI_VARIANT ShapeGroup<Float, Spectrum>::ShapeGroup(const Properties &props) {
     m_has_others = false;
     m_has_bspline_curves = false;
     m_has_linear_curves = false;
+    m_has_spheres = false;
+    m_has_motion = false;
 
     // Add children to the underlying data structure
     for (auto &kv : props.objects()) {
@@ -52,8 +55,13 @@ MI_VARIANT ShapeGroup<Float, Spectrum>::ShapeGroup(const Properties &props) {
                 bool is_linear = (type == +ShapeType::LinearCurve);
                 m_has_linear_curves |= is_linear;
 
-                bool is_other = !is_mesh && !is_bspline && !is_linear;
+                bool is_spheres = (type == +ShapeType::Spheres);
+                m_has_spheres |= is_spheres;
+
+                bool is_other = !is_mesh && !is_bspline && !is_linear && !is_spheres;
                 m_has_others |= is_other;
+
+                m_has_motion |= shape->is_animated();
             }
         } else {
             Throw("Tried to add an unsupported object of type \"%s\"", kv.second);
@@ -154,22 +162,105 @@ ShapeGroup<Float, Spectrum>::primitive_count() const {
     return count;
 }
 
+MI_VARIANT void ShapeGroup<Float, Spectrum>::enable_paging() {
+    if (m_proxy)
+        return;
+
+    // Triangulated box that encloses all shapes of the group
+    float positions[8 * 3];
+    for (uint32_t i = 0; i < 8; ++i) {
+        ScalarPoint3f p = m_bbox.corner(i);
+        for (uint32_t j = 0; j < 3; ++j)
+            positions[3 * i + j] = (float) p[j];
+    }
+
+    const uint32_t faces[12 * 3] = {
+        0, 2, 6, 0, 6, 4,   1, 5, 7, 1, 7, 3,   0, 4, 5, 0, 5, 1,
+        2, 3, 7, 2, 7, 6,   0, 1, 3, 0, 3, 2,   4, 6, 7, 4, 7, 5
+    };
+
+    ref<Mesh> proxy = new Mesh(m_id + "_proxy", 8, 12);
+    proxy->vertex_positions_buffer() =
+        dr::load<typename Mesh::FloatStorage>(positions, 8 * 3);
+    proxy->faces_buffer() = dr::load<DynamicBuffer<UInt32>>(faces, 12 * 3);
+    proxy->recompute_bbox();
+    proxy->initialize();
+    proxy->mark_as_instance();
+    m_proxy = proxy.get();
+}
+
+MI_VARIANT void ShapeGroup<Float, Spectrum>::set_resident(bool resident) {
+    if (resident == m_resident)
+        return;
+
+    if (!m_proxy)
+        Throw("ShapeGroup::set_resident(): paging is not enabled for \"%s\"!", m_id);
+
+    AllocType type = resident ? AllocType::Device : AllocType::HostPinned;
+    for (auto &s : m_shapes) {
+        if (s->is_mesh())
+            static_cast<Mesh *>(s.get())->migrate_buffers(type);
+    }
+
+    m_resident = resident;
+    m_dirty = true;
+}
+
+MI_VARIANT size_t ShapeGroup<Float, Spectrum>::geometry_bytes() const {
+    size_t bytes = 0;
+    for (auto &s : m_shapes) {
+        if (s->is_mesh()) {
+            const Mesh *mesh = static_cast<const Mesh *>(s.get());
+            bytes += mesh->vertex_count() * mesh->vertex_data_bytes() +
+                     mesh->face_count() * mesh->face_data_bytes();
+        }
+    }
+
+#if defined(MI_ENABLE_CUDA)
+    if constexpr (dr::is_cuda_v<Float>)
+        bytes += m_accel.meshes.buffer_size + m_accel.motion_meshes.buffer_size;
+#endif
+
+    return bytes;
+}
+
 #if defined(MI_ENABLE_CUDA)
 MI_VARIANT void ShapeGroup<Float, Spectrum>::optix_prepare_ias(
     const OptixDeviceContext &context, std::vector<OptixInstance> &instances,
     uint32_t instance_id, const ScalarTransform4f &transf) {
-    prepare_ias(context, m_shapes, m_sbt_offset, m_accel, instance_id, transf, instances);
+    if (m_resident) {
+        prepare_ias(context, m_shapes, m_sbt_offset, m_accel, instance_id,
+                    transf, instances);
+    } else {
+        std::vector<ref<Base>> proxy = { m_proxy };
+        prepare_ias(context, proxy, m_proxy_sbt_offset, m_proxy_accel,
+                    instance_id, transf, instances);
+    }
 }
 
 MI_VARIANT void ShapeGroup<Float, Spectrum>::optix_fill_hitgroup_records(std::vector<HitGroupSbtRecord> &hitgroup_records,
                                                                          const OptixProgramGroup *program_groups) {
     m_sbt_offset = (uint32_t) hitgroup_records.size();
     fill_hitgroup_records(m_shapes, hitgroup_records, program_groups);
+
+    if (m_proxy) {
+        m_proxy_sbt_offset = (uint32_t) hitgroup_records.size();
+        m_proxy->optix_fill_hitgroup_records(hitgroup_records, program_groups);
+    }
 }
 
 MI_VARIANT void ShapeGroup<Float, Spectrum>::optix_prepare_geometry() { }
 
 MI_VARIANT void ShapeGroup<Float, Spectrum>::optix_build_gas(const OptixDeviceContext& context) {
+    if (m_proxy && !m_proxy_accel.meshes.handle)
+        build_gas(context, std::vector<ref<Base>>{ m_proxy }, m_proxy_accel);
+
+    if (!m_resident) {
+        // Release the GAS of the paged-out shapes
+        build_gas(context, std::vector<ref<Base>>(), m_accel);
+        return;
+    }
+
     if (m_dirty) {
         build_gas(context, m_shapes, m_accel);
         for (auto &s : m_shapes)
@@ -182,6 +273,7 @@ MI_VARIANT void ShapeGroup<Float, Spectrum>::optix_build_gas(const OptixDeviceCo
 MI_VARIANT RTCGeometry ShapeGroup<Float, Spectrum>::embree_geometry(RTCDevice device) {
     DRJIT_MARK_USED(device);
     if constexpr (!dr::is_cuda_v<Float>) {
+        std::lock_guard<std::mutex> guard(m_embree_mutex);
         if (m_dirty) {
             if (m_embree_scene == nullptr)
                 m_embree_scene = rtcNewScene(device);
@@ -0,0 +1,329 @@
+#include <mitsuba/render/sparsegrid.h>
+#include <mitsuba/render/volumegrid.h>
+#include <mitsuba/core/stream.h>
+#include <mitsuba/core/logger.h>
+#include <mitsuba/core/fstream.h>
+#include <mitsuba/core/util.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+MI_VARIANT
+SparseVolumeGrid<Float, Spectrum>::SparseVolumeGrid(Stream *stream) { read(stream); }
+
+MI_VARIANT
+SparseVolumeGrid<Float, Spectrum>::SparseVolumeGrid(const fs::path &filename) {
+    ref<FileStream> fs = new FileStream(filename);
+    read(fs);
+}
+
+MI_VARIANT
+SparseVolumeGrid<Float, Spectrum>::SparseVolumeGrid(const VolumeGrid *grid,
+                                                    ScalarFloat threshold) {
+    initialize(grid->size(), (ScalarUInt32) grid->channel_count());
+
+    const ScalarFloat *data = grid->data();
+    const size_t channels = m_channel_count;
+
+    // Visit the grid one leaf-sized brick at a time
+    ScalarVector3u bricks = (m_size + (LeafDim - 1)) / LeafDim;
+    for (uint32_t bz = 0; bz < bricks.z(); ++bz) {
+        for (uint32_t by = 0; by < bricks.y(); ++by) {
+            for (uint32_t bx = 0; bx < bricks.x(); ++bx) {
+                ScalarVector3u origin = ScalarVector3u(bx, by, bz) * LeafDim,
+                               end    = dr::minimum(origin + LeafDim, m_size);
+
+                bool occupied = false;
+                for (uint32_t z = origin.z(); z < end.z() && !occupied; ++z) {
+                    for (uint32_t y = origin.y(); y < end.y() && !occupied; ++y) {
+                        const ScalarFloat *ptr =
+                            data + ((z * (size_t) m_size.y() + y) * m_size.x() +
+                                    origin.x()) * channels;
+                        for (size_t i = 0; i < (end.x() - origin.x()) * channels; ++i) {
+                            if (dr::abs(ptr[i]) > threshold) {
+                                occupied = true;
+                                break;
+                            }
+                        }
+                    }
+                }
+                if (!occupied)
+                    continue;
+
+                ScalarUInt32 leaf = allocate_leaf(origin);
+                ScalarFloat *target = m_values.data() + (size_t) leaf * LeafSize * channels;
+                for (uint32_t z = origin.z(); z < end.z(); ++z) {
+                    for (uint32_t y = origin.y(); y < end.y(); ++y) {
+                        const ScalarFloat *ptr =
+                            data + ((z * (size_t) m_size.y() + y) * m_size.x() +
+                                    origin.x()) * channels;
+                        size_t offset = (((z - origin.z()) * LeafDim) +
+                                         (y - origin.y())) * LeafDim * channels;
+                        std::copy(ptr, ptr + (end.x() - origin.x()) * channels,
+                                  target + offset);
+                    }
+                }
+            }
+        }
+    }
+
+    update_statistics();
+    Log(Debug, "Converted a dense %s volume grid into %zu sparse leaves (%.2f%% occupancy)",
+        m_size, leaf_count(), occupancy() * 100.f);
+}
+
+MI_VARIANT
+SparseVolumeGrid<Float, Spectrum>::SparseVolumeGrid(const ScalarVector3u &size,
+                                                    ScalarUInt32 channel_count,
+                                                    const ScalarUInt32 *coords,
+                                                    const ScalarFloat *values,
+                                                    size_t count) {
+    initialize(size, channel_count);
+
+    const size_t channels = m_channel_count;
+    for (size_t i = 0; i < count; ++i) {
+        ScalarVector3u voxel(coords[3 * i], coords[3 * i + 1], coords[3 * i + 2]);
+        if (dr::any(voxel >= m_size))
+            Throw("SparseVolumeGrid: voxel %s lies outside of the grid "
+                  "resolution %s!", voxel, m_size);
+
+        ScalarUInt32 leaf = allocate_leaf(voxel);
+        ScalarVector3u local = voxel & (LeafDim - 1);
+        size_t offset = ((size_t) leaf * LeafSize +
+                         (local.z() * LeafDim + local.y()) * LeafDim + local.x()) * channels;
+        std::copy(values + i * channels, values + (i + 1) * channels,
+                  m_values.data() + offset);
+    }
+
+    update_statistics();
+}
+
+MI_VARIANT
+void SparseVolumeGrid<Float, Spectrum>::initialize(const ScalarVector3u &size,
+                                                   ScalarUInt32 channel_count) {
+    if (dr::any(dr::eq(size, 0u)) || channel_count == 0)
+        Throw("SparseVolumeGrid: invalid resolution %s with %u channel(s)!",
+              size, channel_count);
+
+    const uint32_t node_extent = LeafDim * NodeDim;
+    m_size = size;
+    m_channel_count = channel_count;
+    m_root_size = (size + (node_extent - 1)) / node_extent;
+    m_bbox = ScalarBoundingBox3f(ScalarPoint3f(0.f), ScalarPoint3f(1.f));
+    m_root.assign(dr::prod(m_root_size), InvalidIndex);
+    m_nodes.clear();
+    m_values.clear();
+    m_leaf_origin.clear();
+}
+
+MI_VARIANT
+typename SparseVolumeGrid<Float, Spectrum>::ScalarUInt32
+SparseVolumeGrid<Float, Spectrum>::allocate_leaf(const ScalarVector3u &voxel) {
+    ScalarVector3u r = voxel >> (LeafLog2 + NodeLog2),
+                   c = (voxel >> LeafLog2) & (NodeDim - 1);
+
+    ScalarUInt32 &node = m_root[(r.z() * m_root_size.y() + r.y()) * m_root_size.x() + r.x()];
+    if (node == InvalidIndex) {
+        node = (ScalarUInt32) node_count();
+        m_nodes.resize(m_nodes.size() + NodeSize, InvalidIndex);
+    }
+
+    ScalarUInt32 &leaf = m_nodes[(size_t) node * NodeSize +
+                                 (c.z() * NodeDim + c.y()) * NodeDim + c.x()];
+    if (leaf == InvalidIndex) {
+        leaf = (ScalarUInt32) leaf_count();
+        m_leaf_origin.push_back(voxel & ~(LeafDim - 1));
+        m_values.resize(m_values.size() + LeafSize * m_channel_count, 0.f);
+    }
+
+    return leaf;
+}
+
+MI_VARIANT
+void SparseVolumeGrid<Float, Spectrum>::update_statistics() {
+    const size_t channels = m_channel_count;
+
+    // Recover the leaf origins by walking the tree
+    m_leaf_origin.assign(m_values.size() / (LeafSize * channels), ScalarVector3u(0u));
+    for (uint32_t rz = 0; rz < m_root_size.z(); ++rz) {
+        for (uint32_t ry = 0; ry < m_root_size.y(); ++ry) {
+            for (uint32_t rx = 0; rx < m_root_size.x(); ++rx) {
+                ScalarUInt32 node = m_root[(rz * m_root_size.y() + ry) * m_root_size.x() + rx];
+                if (node == InvalidIndex)
+                    continue;
+                for (uint32_t i = 0; i < NodeSize; ++i) {
+                    ScalarUInt32 leaf = m_nodes[(size_t) node * NodeSize + i];
+                    if (leaf == InvalidIndex)
+                        continue;
+                    ScalarVector3u c(i % NodeDim, (i / NodeDim) % NodeDim,
+                                     i / (NodeDim * NodeDim));
+                    m_leaf_origin[leaf] =
+                        (ScalarVector3u(rx, ry, rz) * NodeDim + c) * LeafDim;
+                }
+            }
+        }
+    }
+
+    m_max = -dr::Infinity<ScalarFloat>;
+    m_max_per_channel.assign(channels, -dr::Infinity<ScalarFloat>);
+    m_leaf_max.assign(leaf_count(), -dr::Infinity<ScalarFloat>);
+
+    const ScalarFloat *ptr = m_values.data();
+    for (size_t leaf = 0; leaf < leaf_count(); ++leaf) {
+        for (size_t i = 0; i < LeafSize; ++i) {
+            for (size_t j = 0; j < channels; ++j) {
+                ScalarFloat val = *ptr++;
+                m_leaf_max[leaf]     = dr::maximum(m_leaf_max[leaf], val);
+                m_max_per_channel[j] = dr::maximum(m_max_per_channel[j], val);
+            }
+        }
+        m_max = dr::maximum(m_max, m_leaf_max[leaf]);
+    }
+
+    // Unallocated voxels take on the background value
+    if (leaf_count() * LeafSize < dr::prod(ScalarVector3f(m_size))) {
+        m_max = dr::maximum(m_max, 0.f);
+        for (size_t j = 0; j < channels; ++j)
+            m_max_per_channel[j] = dr::maximum(m_max_per_channel[j], 0.f);
+    }
+}
+
+MI_VARIANT
+void SparseVolumeGrid<Float, Spectrum>::read(Stream *stream) {
+    char header[3];
+    stream->read(header, 3);
+
+    if (header[0] != 'S' || header[1] != 'V' || header[2] != 'L')
+        Throw("Invalid sparse volume file!");
+    uint8_t version;
+    stream->read(version);
+
+    if (version != 1)
+        Throw("Invalid version, currently only version 1 is supported (found %d)", version);
+
+    int32_t data_type;
+    stream->read(data_type);
+    if (data_type != 1)
+        Throw("Wrong type, currently only type == 1 (Float32) data is "
+              "supported (found type = %d)", data_type);
+
+    int32_t size_x, size_y, size_z, channel_count;
+    stream->read(size_x);
+    stream->read(size_y);
+    stream->read(size_z);
+    stream->read(channel_count);
+    initialize(ScalarVector3u(size_x, size_y, size_z), (ScalarUInt32) channel_count);
+
+    float dims[6];
+    stream->read_array(dims, 6);
+    m_bbox = ScalarBoundingBox3f(ScalarPoint3f(dims[0], dims[1], dims[2]),
+                                 ScalarPoint3f(dims[3], dims[4], dims[5]));
+
+    uint32_t n_nodes, n_leaves;
+    stream->read(n_nodes);
+    stream->read(n_leaves);
+
+    stream->read_array(m_root.data(), m_root.size());
+    m_nodes.resize((size_t) n_nodes * NodeSize);
+    stream->read_array(m_nodes.data(), m_nodes.size());
+
+    for (uint32_t node : m_root)
+        if (node != InvalidIndex && node >= n_nodes)
+            Throw("Invalid sparse volume file: corrupt root table!");
+    for (uint32_t leaf : m_nodes)
+        if (leaf != InvalidIndex && leaf >= n_leaves)
+            Throw("Invalid sparse volume file: corrupt internal node!");
+
+    size_t value_count = (size_t) n_leaves * LeafSize * m_channel_count;
+    m_values.resize(value_count);
+    if constexpr (std::is_same<ScalarFloat, float>::value) {
+        stream->read_array(m_values.data(), value_count);
+    } else {
+        std::vector<float> input(value_count);
+        stream->read_array(input.data(), value_count);
+        for (size_t i = 0; i < value_count; ++i)
+            m_values[i] = input[i];
+    }
+
+    update_statistics();
+    Log(Debug, "Loaded sparse volume data from file: dimensions %s, %u leaves, "
+        "max value %f", m_size, n_leaves, m_max);
+}
+
+MI_VARIANT
+void SparseVolumeGrid<Float, Spectrum>::max_per_channel(ScalarFloat *out) const {
+    for (size_t i = 0; i < m_channel_count; ++i)
+        out[i] = m_max_per_channel[i];
+}
+
+MI_VARIANT
+typename SparseVolumeGrid<Float, Spectrum>::ScalarFloat
+SparseVolumeGrid<Float, Spectrum>::occupancy() const {
+    return dr::minimum(1.f, (ScalarFloat) (leaf_count() * LeafSize) /
+                                dr::prod(ScalarVector3f(m_size)));
+}
+
+MI_VARIANT
+size_t SparseVolumeGrid<Float, Spectrum>::buffer_size() const {
+    return (m_root.size() + m_nodes.size()) * sizeof(ScalarUInt32) +
+           m_values.size() * sizeof(ScalarFloat);
+}
+
+MI_VARIANT
+void SparseVolumeGrid<Float, Spectrum>::write(const fs::path &path) const {
+    ref<FileStream> fs = new FileStream(path, FileStream::ETruncReadWrite);
+    write(fs);
+}
+
+MI_VARIANT
+void SparseVolumeGrid<Float, Spectrum>::write(Stream *stream) const {
+    stream->write("SVL", 3);
+    stream->write(uint8_t(1)); // file format version
+    stream->write(int32_t(1)); // data_type
+    stream->write(int32_t(m_size.x()));
+    stream->write(int32_t(m_size.y()));
+    stream->write(int32_t(m_size.z()));
+    stream->write(int32_t(m_channel_count));
+
+    stream->write(float(m_bbox.min.x()));
+    stream->write(float(m_bbox.min.y()));
+    stream->write(float(m_bbox.min.z()));
+    stream->write(float(m_bbox.max.x()));
+    stream->write(float(m_bbox.max.y()));
+    stream->write(float(m_bbox.max.z()));
+
+    stream->write(uint32_t(node_count()));
+    stream->write(uint32_t(leaf_count()));
+    stream->write_array(m_root.data(), m_root.size());
+    stream->write_array(m_nodes.data(), m_nodes.size());
+
+    if constexpr (std::is_same<ScalarFloat, float>::value)
+        stream->write_array(m_values.data(), m_values.size());
+    else {
+        // Need to convert data to single precision before writing to disk
+        std::vector<float> output(m_values.size());
+        for (size_t i = 0; i < m_values.size(); ++i)
+            output[i] = m_values[i];
+        stream->write_array(output.data(), output.size());
+    }
+}
+
+MI_VARIANT
+std::string SparseVolumeGrid<Float, Spectrum>::to_string() const {
+    std::ostringstream oss;
+    oss << "SparseVolumeGrid[" << std::endl
+        << "  size = " << m_size << "," << std::endl
+        << "  channels = " << m_channel_count << "," << std::endl
+        << "  nodes = " << node_count() << "," << std::endl
+        << "  leaves = " << leaf_count() << "," << std::endl
+        << "  occupancy = " << occupancy() << "," << std::endl
+        << "  max = " << m_max << "," << std::endl
+        << "  data = [ " << util::mem_string(buffer_size())
+        << " of volume data ]" << std::endl
+        << "]";
+    return oss.str();
+}
+
+MI_IMPLEMENT_CLASS_VARIANT(SparseVolumeGrid, Object)
+MI_INSTANTIATE_CLASS(SparseVolumeGrid)
+
+NAMESPACE_END(mitsuba)
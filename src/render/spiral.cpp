@@ -1,73 +1,124 @@
+#include <drjit/morton.h>
 #include <mitsuba/core/bitmap.h>
 #include <mitsuba/render/spiral.h>
 #include <mitsuba/mitsuba.h>
+#include <algorithm>
 
 NAMESPACE_BEGIN(mitsuba)
 
 Spiral::Spiral(const Vector2u &size, const Vector2u &offset,
                uint32_t block_size, uint32_t passes)
-    : m_size(size), m_offset(offset), m_passes_left(passes),
+    : m_counter(0), m_size(size), m_offset(offset), m_passes(std::max(passes, 1u)),
       m_block_size(block_size) {
 
-    m_blocks = (size + (block_size - 1)) / block_size;
-    m_block_count = dr::prod(m_blocks);
+    Vector2u blocks = (size + (block_size - 1)) / block_size;
+    m_block_count = dr::prod(blocks);
+    m_blocks_ordered.reserve(m_block_count);
 
-    reset();
-}
-
-void Spiral::reset() {
-    m_block_counter = 0;
-    direction = Direction::Right;
-    m_position = Vector2u(m_blocks / 2);
-    m_steps_left = 1;
-    m_spiral_size = 1;
-}
-
-std::tuple<Spiral::Vector2i, Spiral::Vector2u, uint32_t> Spiral::next_block() {
     // Reimplementation of the spiraling block generator by Adam Arbree.
-    std::lock_guard<std::mutex> lock(m_mutex);
-
-    if (m_block_counter == m_block_count) {
-        if (m_passes_left > 1) {
-            --m_passes_left;
-            reset();
-        } else {
-            return { 0, 0, (uint32_t) -1 };
-        }
-    }
-
-    // Calculate a unique identifier per block
-    uint32_t block_id =
-        m_block_counter + (m_passes_left - 1) * m_block_count;
+    enum class Direction { Right, Down, Left, Up };
+    Direction direction = Direction::Right;
+    Point2i position = Point2i(blocks / 2);
+    uint32_t steps_left = 1, spiral_size = 1;
 
-    Vector2u offset = m_position * m_block_size,
-             size   = dr::minimum(m_block_size, m_size - offset);
+    for (uint32_t i = 0; i < m_block_count; ++i) {
+        Vector2u block_offset = Vector2u(position) * m_block_size,
+                 block_size_  = dr::minimum(m_block_size, m_size - block_offset);
 
-    Assert(dr::all(offset <= m_size));
+        Assert(dr::all(block_offset <= m_size));
+        m_blocks_ordered.push_back({ block_offset, block_size_, i, m_block_size });
 
-    ++m_block_counter;
+        if (i + 1 == m_block_count)
+            break;
 
-    if (m_block_counter != m_block_count) {
         // Prepare the next block's position along the spiral.
         do {
             switch (direction) {
-                case Direction::Right: ++m_position.x(); break;
-                case Direction::Down:  ++m_position.y(); break;
-                case Direction::Left:  --m_position.x(); break;
-                case Direction::Up:    --m_position.y(); break;
+                case Direction::Right: ++position.x(); break;
+                case Direction::Down:  ++position.y(); break;
+                case Direction::Left:  --position.x(); break;
+                case Direction::Up:    --position.y(); break;
             }
 
-            if (--m_steps_left == 0) {
+            if (--steps_left == 0) {
                 direction = Direction(((int) direction + 1) % 4);
                 if (direction == Direction::Left ||
                     direction == Direction::Right)
-                    ++m_spiral_size;
-                m_steps_left = m_spiral_size;
+                    ++spiral_size;
+                steps_left = spiral_size;
             }
-        } while (dr::any(m_position < 0 || m_position >= m_blocks));
+        } while (dr::any(position < 0 || position >= Point2i(blocks)));
+    }
+
+    m_last_pass = m_blocks_ordered;
+}
+
+void Spiral::set_straggler_blocks(uint32_t count) {
+    count = std::min(count, m_block_count);
+
+    m_last_pass.clear();
+    m_last_pass.insert(m_last_pass.end(), m_blocks_ordered.begin(),
+                       m_blocks_ordered.end() - count);
+
+    /* Only power-of-two blocks can be split without changing the Morton
+       order (and therefore the seeds) of their pixels */
+    bool can_split = m_block_size >= 4 &&
+                     (m_block_size & (m_block_size - 1)) == 0;
+
+    for (uint32_t i = m_block_count - count; i < m_block_count; ++i) {
+        const Block &b = m_blocks_ordered[i];
+        if (!can_split) {
+            m_last_pass.push_back(b);
+            continue;
+        }
+
+        uint32_t half = b.block_size / 2;
+        for (uint32_t q = 0; q < 4; ++q) {
+            Vector2u rel = dr::morton_decode<Vector2u>(q) * half;
+            if (dr::any(rel >= b.size))
+                continue;
+
+            m_last_pass.push_back({ b.offset + rel,
+                                    dr::minimum(half, b.size - rel),
+                                    4 * b.id + q, half });
+        }
+    }
+}
+
+void Spiral::set_scanline_order() {
+    std::sort(m_blocks_ordered.begin(), m_blocks_ordered.end(),
+              [](const Block &a, const Block &b) {
+                  return a.offset.y() < b.offset.y() ||
+                         (a.offset.y() == b.offset.y() && a.offset.x() < b.offset.x());
+              });
+    m_last_pass = m_blocks_ordered;
+}
+
+void Spiral::reset() {
+    m_counter = 0;
+}
+
+std::tuple<Spiral::Vector2i, Spiral::Vector2u, uint32_t, uint32_t>
+Spiral::next_block() {
+    uint32_t index   = m_counter.fetch_add(1, std::memory_order_relaxed),
+             regular = m_block_count * (m_passes - 1);
+
+    const Block *block;
+    uint32_t id_offset = 0;
+
+    if (index < regular) {
+        // Earlier passes receive the higher identifiers
+        uint32_t pass = index / m_block_count;
+        block = &m_blocks_ordered[index - pass * m_block_count];
+        id_offset = (m_passes - 1 - pass) * m_block_count;
+    } else if (index - regular < m_last_pass.size()) {
+        block = &m_last_pass[index - regular];
+    } else {
+        return { 0, 0, (uint32_t) -1, 0 };
     }
 
-    return { offset + m_offset, size, block_id };
+    return { Vector2i(block->offset + m_offset), block->size,
+             block->id + id_offset, block->block_size };
 }
 
 MI_IMPLEMENT_CLASS(Spiral, Object)
@@ -3,7 +3,10 @@
 #include <mitsuba/core/properties.h>
 #include <mitsuba/render/texture.h>
 #include <mitsuba/render/srgb.h>
+#include <drjit/packet.h>
 #include <rgb2spec.h>
+#include <nanothread/nanothread.h>
+#include <algorithm>
 #include <mutex>
 
 NAMESPACE_BEGIN(mitsuba)
@@ -11,9 +14,8 @@ NAMESPACE_BEGIN(mitsuba)
 static RGB2Spec *model = nullptr;
 static std::mutex model_mutex;
 
-dr::Array<float, 3> srgb_model_fetch(const Color<float, 3> &c) {
-    using Array3f = dr::Array<float, 3>;
-
+/// Load the spectral upsampling model on first use
+static RGB2Spec *srgb_model() {
     if (unlikely(model == nullptr)) {
         std::lock_guard<std::mutex> lock(model_mutex);
         if (model == nullptr) {
@@ -26,14 +28,99 @@ dr::Array<float, 3> srgb_model_fetch(const Color<float, 3> &c) {
             atexit([]{ rgb2spec_free(model); });
         }
     }
+    return model;
+}
+
+dr::Array<float, 3> srgb_model_fetch(const Color<float, 3> &c) {
+    using Array3f = dr::Array<float, 3>;
+
+    RGB2Spec *m = srgb_model();
 
     float rgb[3] = { (float) c.r(), (float) c.g(), (float) c.b() };
     float out[3];
-    rgb2spec_fetch(model, rgb, out);
+    rgb2spec_fetch(m, rgb, out);
 
     return Array3f(out[0], out[1], out[2]);
 }
 
+uint32_t srgb_model_tables(const float **scale, const float **data) {
+    RGB2Spec *m = srgb_model();
+    *scale = m->scale;
+    *data = m->data;
+    return m->res;
+}
+
+template <typename Value>
+static void srgb_model_fetch_array(Value *data, size_t count, size_t stride,
+                                   double *mean) {
+    using FloatP = dr::Packet<float, 8>;
+    constexpr size_t Width = FloatP::Size;
+    constexpr size_t BlockSize = 16384;
+
+    RGB2Spec *m = srgb_model();
+    const float *scale = m->scale, *table = m->data;
+
+    size_t block_count = (count + BlockSize - 1) / BlockSize;
+    std::vector<double> block_mean(block_count, 0.0);
+
+    dr::parallel_for(
+        dr::blocked_range<size_t>(0, block_count, 1),
+        [&](const dr::blocked_range<size_t> &range) {
+            alignas(64) float buf[3][Width];
+
+            for (size_t b = range.begin(); b != range.end(); ++b) {
+                size_t end = std::min(count, (b + 1) * BlockSize);
+                double sum = 0.0;
+
+                for (size_t i = b * BlockSize; i < end; i += Width) {
+                    size_t n = std::min(Width, end - i);
+
+                    // Transpose a packet of colors (padding with black)
+                    for (size_t j = 0; j < Width; ++j)
+                        for (size_t k = 0; k < 3; ++k)
+                            buf[k][j] = j < n ? (float) data[(i + j) * stride + k] : 0.f;
+
+                    Color<FloatP, 3> c(dr::load<FloatP>(buf[0]),
+                                       dr::load<FloatP>(buf[1]),
+                                       dr::load<FloatP>(buf[2]));
+
+                    dr::Array<FloatP, 3> coeff =
+                        detail::srgb_model_fetch(c, m->res, scale, table);
+
+                    if (mean) {
+                        dr::store(buf[0], srgb_model_mean(coeff));
+                        for (size_t j = 0; j < n; ++j)
+                            sum += (double) buf[0][j];
+                    }
+
+                    for (size_t k = 0; k < 3; ++k)
+                        dr::store(buf[k], coeff[k]);
+                    for (size_t j = 0; j < n; ++j)
+                        for (size_t k = 0; k < 3; ++k)
+                            data[(i + j) * stride + k] = (Value) buf[k][j];
+                }
+
+                block_mean[b] = sum;
+            }
+        }
+    );
+
+    if (mean) {
+        double sum = 0.0;
+        for (double v : block_mean)
+            sum += v;
+        *mean = count > 0 ? sum / (double) count : 0.0;
+    }
+}
+
+void srgb_model_fetch(float *data, size_t count, size_t stride, double *mean) {
+    srgb_model_fetch_array(data, count, stride, mean);
+}
+
+void srgb_model_fetch(double *data, size_t count, size_t stride, double *mean) {
+    srgb_model_fetch_array(data, count, stride, mean);
+}
+
 #if 0
 Color<float, 3> srgb_model_eval_rgb(const dr::Array<float, 3> &coeff) {
     using Array3f = dr::Array<float, 3>;
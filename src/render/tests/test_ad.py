@@ -1,4 +1,5 @@
 import pytest
+import sys
 import drjit as dr
 import mitsuba as mi
 
@@ -462,3 +463,172 @@ def test07_masked_updates(variants_all_ad_rgb, opt):
 
         prev_x = mi.Float(params['x'])
         prev_state = [mi.Float(vv) for vv in ensure_iterable(opt.state['x'])]
+
+
+@pytest.mark.parametrize('half_moments', [False, True])
+def test08_fused_adam(variants_all_ad_rgb, half_moments):
+    if half_moments and not hasattr(sys.modules[dr.detached_t(mi.Float).__module__], 'Float16'):
+        pytest.skip('Half precision arrays are not supported')
+
+    params = {
+        'a': mi.Float([1.0, 2.0, 3.0]),
+        'b': mi.Color3f(0.5, 0.25, 0.75),
+        'c': mi.TensorXf(dr.arange(mi.Float, 6), shape=(2, 3))
+    }
+    grads = {
+        'a': mi.Float([-1, 1, 2]),
+        'b': mi.Color3f(0.5, -0.5, 1),
+        'c': mi.TensorXf(mi.Float([1, -2, 3, -4, 5, -6]), shape=(2, 3))
+    }
+
+    opts = [mi.ad.Adam(lr=0.1, params=params),
+            mi.ad.Adam(lr=0.1, params=params, fused=True, half_moments=half_moments)]
+
+    for _ in range(5):
+        for opt in opts:
+            for k, g in grads.items():
+                dr.set_grad(opt[k], g)
+            opt.step()
+
+    for k in params:
+        assert type(opts[1][k]) is type(params[k])
+        assert dr.shape(opts[1][k]) == dr.shape(params[k])
+        assert dr.allclose(opts[0][k], opts[1][k], rtol=1e-2 if half_moments else 1e-5)
+
+    # A size change resets the state
+    opts[1]['a'] = mi.Float([1.0, 2.0])
+    assert dr.width(opts[1].state['a'][0]) == 2
+    assert dr.all(dr.eq(mi.Float(opts[1].state['a'][0]), 0))
+
+    with pytest.raises(Exception, match='requires fused=True'):
+        mi.ad.Adam(lr=0.1, half_moments=True)
+
+
+@pytest.mark.parametrize('fused', [False, True])
+def test09_resample_optimizer_state(variants_all_ad_rgb, fused):
+    value = mi.TensorXf(dr.arange(mi.Float, 2 * 2 * 3), shape=(2, 2, 3))
+    opt = mi.ad.Adam(lr=0.1, fused=fused, params={'tex': value})
+
+    dr.set_grad(opt['tex'], mi.TensorXf(dr.full(mi.Float, 4, 12), shape=(2, 2, 3)))
+    opt.step()
+    step_coarse = dr.detach(value) - opt['tex']
+
+    # Upsample by a factor of two in each dimension
+    opt.resample('tex', (4, 4))
+    assert dr.shape(opt['tex']) == (4, 4, 3)
+    assert dr.grad_enabled(opt['tex'])
+    m_t, v_t = opt.state['tex']
+    assert dr.allclose(mi.ad.Adam.flatten(m_t), 0.1)
+    assert dr.allclose(mi.ad.Adam.flatten(v_t), 0.001)
+
+    # Constant gradients with a quarter of the magnitude yield the same step
+    before = mi.TensorXf(dr.detach(opt['tex']))
+    dr.set_grad(opt['tex'], mi.TensorXf(dr.full(mi.Float, 1, 48), shape=(4, 4, 3)))
+    opt.step()
+    step_fine = before - opt['tex']
+    assert dr.allclose(step_fine.array, step_coarse.array[0], rtol=1e-4)
+
+    # Downsampling by integer factors averages the entries
+    down = mi.ad.resample(mi.TensorXf(dr.arange(mi.Float, 16), shape=(4, 4)), (2, 2))
+    assert dr.allclose(down.array, [2.5, 4.5, 10.5, 12.5])
+
+    with pytest.raises(Exception, match='resampled'):
+        mi.ad.Adam(lr=0.1, params={'a': mi.Float(1, 2)}).resample('a', (2, 2))
+
+
+def test10_resolution_schedule(variants_all_ad_rgb):
+    scene = mi.load_dict({
+        'type': 'scene',
+        'sensor': {
+            'type': 'perspective',
+            'film': { 'type': 'hdrfilm', 'width': 16, 'height': 8 }
+        },
+        'rect': {
+            'type': 'rectangle',
+            'to_world': mi.ScalarTransform4f.translate([0, 0, 3]),
+            'bsdf': {
+                'type': 'diffuse',
+                'reflectance': {
+                    'type': 'bitmap',
+                    'data': dr.full(mi.TensorXf, 0.5, (8, 8, 3)),
+                }
+            }
+        },
+        'emitter': { 'type': 'constant' }
+    })
+    key = 'rect.bsdf.reflectance.data'
+    params = mi.traverse(scene)
+    opt = mi.ad.Adam(lr=0.05)
+    opt[key] = params[key]
+
+    sensor = scene.sensors()[0]
+    schedule = mi.ad.ResolutionSchedule(sensor, [
+        { 'iterations': 2, 'scale': 0.25, 'spp': 2, 'textures': { key: (4, 4) } },
+        { 'iterations': 2, 'scale': 0.5, 'spp': 4, 'textures': { key: (8, 8) } },
+        { 'iterations': 1 }
+    ])
+    assert schedule.iterations == 5
+
+    integrator = mi.load_dict({ 'type': 'prb', 'dynamic_film_size': True })
+    reference = dr.full(mi.TensorXf, 0.25, (8, 16, 3))
+
+    sizes = []
+    for it in range(schedule.iterations):
+        changed = schedule.step(it, opt, params)
+        assert changed == (it in [0, 2, 4])
+        image = mi.render(scene, params, sensor=sensor, spp=schedule.spp,
+                          seed=it, integrator=integrator)
+        sizes.append(tuple(image.shape))
+        assert dr.shape(params[key])[:2] == ((4, 4) if it < 2 else (8, 8))
+
+        loss = dr.mean(dr.sqr(image - schedule.target(reference)))
+        dr.backward(loss)
+        opt.step()
+        params.update(opt)
+
+    assert sizes == [(2, 4, 3)] * 2 + [(4, 8, 3)] * 2 + [(8, 16, 3)]
+
+    with pytest.raises(Exception, match='unknown stage'):
+        mi.ad.ResolutionSchedule(sensor, [{ 'iterations': 1, 'res': 2 }])
+
+
+@pytest.mark.parametrize('uniform', [False, True])
+def test11_sparse_adam(variants_all_ad_rgb, uniform):
+    params = {
+        'a': mi.Float([1.0, 2.0, 3.0, 4.0]),
+        'b': mi.TensorXf(dr.arange(mi.Float, 6), shape=(2, 3))
+    }
+    grads = [
+        {'a': mi.Float([-1, 0, 2, 0]),
+         'b': mi.TensorXf(mi.Float([1, 0, 0, -4, 5, 0]), shape=(2, 3))},
+        {'a': mi.Float([0, 0, 1, 3]),
+         'b': mi.TensorXf(mi.Float([0, 0, 0, 0, 0, 0]), shape=(2, 3))}
+    ]
+
+    opts = [mi.ad.Adam(lr=0.1, params=params, uniform=uniform, mask_updates=True),
+            mi.ad.Adam(lr=0.1, params=params, uniform=uniform, sparse=True)]
+
+    index, values = mi.ad.Adam.sparse_grad(dr.detach(params['a']))
+    assert dr.width(index) == 0
+
+    for i in range(4):
+        for opt in opts:
+            for k, g in grads[i % 2].items():
+                dr.set_grad(opt[k], g)
+            if i == 0:
+                index, values = mi.ad.Adam.sparse_grad(opt['b'])
+                assert dr.all(index == [0, 3, 4])
+                assert dr.all(values == [1, -4, 5])
+            opt.step()
+
+    for k in params:
+        assert type(opts[1][k]) is type(params[k])
+        assert dr.shape(opts[1][k]) == dr.shape(params[k])
+        assert dr.grad_enabled(opts[1][k])
+        assert dr.allclose(opts[0][k], opts[1][k])
+
+    # Entries that never received a gradient are left untouched
+    assert dr.all(opts[1]['a'][1] == 2.0)
+
+    with pytest.raises(Exception, match='cannot be combined'):
+        mi.ad.Adam(lr=0.1, sparse=True, fused=True)
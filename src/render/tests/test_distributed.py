@@ -0,0 +1,163 @@
+import pytest
+import threading
+import numpy as np
+import drjit as dr
+import mitsuba as mi
+
+
+def make_scene(res=(40, 24)):
+    return mi.load_dict({
+        'type': 'scene',
+        'integrator': { 'type': 'path' },
+        'sensor': {
+            'type': 'perspective',
+            'film': {
+                'type': 'hdrfilm',
+                'width': res[0],
+                'height': res[1],
+                'rfilter': { 'type': 'box' }
+            },
+            'sampler': { 'type': 'independent', 'sample_count': 4 }
+        },
+        'emitter': { 'type': 'constant', 'radiance': 0.5 }
+    })
+
+
+def run_worker(port, results):
+    scene = make_scene()
+    worker = mi.RenderWorker('localhost', port)
+    results.append(worker.run(scene))
+
+
+@pytest.mark.parametrize('worker_count', [1, 3])
+def test01_loopback_render(variants_all_rgb, worker_count):
+    # A constant environment without geometry gives the same value everywhere,
+    # hence the distributed render must match it exactly in every pixel
+    scene = make_scene()
+    coordinator = mi.RenderCoordinator(tile_size=16)
+
+    results = []
+    threads = [threading.Thread(target=run_worker,
+                                args=(coordinator.port(), results))
+               for i in range(worker_count)]
+    for t in threads:
+        t.start()
+
+    image = coordinator.render(scene, 0, seed=0, spp=2)
+    coordinator.shutdown()
+    for t in threads:
+        t.join()
+
+    assert dr.all(mi.ScalarVector3u(image.shape) == [24, 40, 3])
+    assert dr.allclose(image, 0.5)
+
+    # 3x2 tiles in total, each of them merged exactly once
+    assert sum(results) >= 6
+    assert sum(results) == 6 + coordinator.reissued_count()
+
+
+def test02_render_server(variants_all_rgb):
+    server = mi.RenderServer()
+    server.add_scene('env', make_scene())
+    assert server.scene_ids() == ['env']
+
+    images, errors = [], []
+    def client_thread():
+        client = mi.RenderClient('localhost', server.port())
+        images.append(client.render('env', spp=2))
+        images.append(client.render(
+            'env', overrides=[('emitter.radiance.value', '2')], spp=2))
+        images.append(client.render('env', spp=2))
+        for args in [('unknown',), ('env', [('emitter.unknown', '1')])]:
+            try:
+                client.render(*args)
+            except RuntimeError as e:
+                errors.append(str(e))
+        client.shutdown_server()
+
+    thread = threading.Thread(target=client_thread)
+    thread.start()
+    server.run()
+    thread.join()
+
+    # Overrides only apply to a single job
+    values = [np.mean(np.array(img)) for img in images]
+    assert np.allclose(values, [0.5, 2.0, 0.5])
+
+    assert len(errors) == 2
+    assert 'unknown scene' in errors[0]
+    assert 'unknown scene parameter' in errors[1]
+    assert server.jobs_completed() == 6
+
+
+def test03_multi_device_render(variant_cuda_ad_rgb, tmp_path):
+    filename = str(tmp_path / 'scene.xml')
+    with open(filename, 'w') as f:
+        f.write('''<scene version="3.0.0">
+            <integrator type="path"/>
+            <sensor type="perspective">
+                <film type="hdrfilm">
+                    <integer name="width" value="40"/>
+                    <integer name="height" value="24"/>
+                    <rfilter type="box"/>
+                </film>
+                <sampler type="independent"/>
+            </sensor>
+            <emitter type="constant">
+                <float name="radiance" value="$radiance"/>
+            </emitter>
+        </scene>''')
+
+    renderer = mi.MultiDeviceRenderer(filename, devices=[0],
+                                      defines=[('radiance', '0.5')])
+    assert renderer.devices() == [0]
+
+    # The last pass only renders the remaining samples
+    image = renderer.render(seed=0, spp=7, spp_per_pass=2)
+    assert dr.all(mi.ScalarVector3u(image.shape) == [24, 40, 3])
+    assert dr.allclose(image, 0.5)
+
+    stats = renderer.device_stats()
+    assert len(stats) == 1
+    assert stats[0].passes == 4 and stats[0].spp == 7
+    assert 0 < renderer.scaling_efficiency() <= 1.0001
+
+
+def test04_multi_device_requires_cuda(variant_scalar_rgb, tmp_path):
+    with pytest.raises(RuntimeError, match='CUDA variant'):
+        mi.MultiDeviceRenderer(str(tmp_path / 'scene.xml'))
+
+
+def test05_hybrid_render(variant_cuda_ad_rgb, tmp_path):
+    if 'llvm_ad_rgb' not in mi.variants():
+        pytest.skip('llvm_ad_rgb mode not enabled')
+
+    filename = str(tmp_path / 'scene.xml')
+    with open(filename, 'w') as f:
+        f.write('''<scene version="3.0.0">
+            <integrator type="path"/>
+            <sensor type="perspective">
+                <film type="hdrfilm">
+                    <integer name="width" value="40"/>
+                    <integer name="height" value="24"/>
+                    <rfilter type="box"/>
+                </film>
+                <sampler type="independent"/>
+            </sensor>
+            <emitter type="constant">
+                <float name="radiance" value="0.5"/>
+            </emitter>
+        </scene>''')
+
+    renderer = mi.HybridRenderer(filename, 'llvm_ad_rgb', 'cuda_ad_rgb')
+    image = np.array(renderer.render(seed=0, spp=16, pass_time=0.01))
+    assert image.shape == (24, 40, 3)
+    assert np.allclose(image, 0.5)
+
+    # Every sample is rendered by exactly one side
+    stats = renderer.backend_stats()
+    assert [s.variant for s in stats] == ['llvm_ad_rgb', 'cuda_ad_rgb']
+    assert sum(s.spp for s in stats) == 16
+
+    with pytest.raises(RuntimeError, match='color representations'):
+        mi.HybridRenderer(filename, 'llvm_ad_rgb', 'cuda_ad_spectral')
@@ -257,3 +257,105 @@ def test06_error_compensation(variants_any_cuda, compensate):
         print(2**24 + 1024)
         print(2**24)
         assert ib.tensor().array[0] ==  2**24 + (1024 if compensate else 0)
+
+
+def test07_serialize(variants_all_rgb):
+    # ImageBlock::write() followed by ImageBlock(Stream) should round-trip
+    rfilter = mi.load_dict({ 'type' : 'gaussian' })
+    block = mi.ImageBlock([5, 4], [3, 7], 3, rfilter=rfilter, border=True)
+    block.put([5.5, 9.5], [1.0, 2.0, 3.0])
+
+    stream = mi.MemoryStream()
+    block.write(stream)
+    stream.seek(0)
+    block2 = mi.ImageBlock(stream)
+
+    assert dr.all(block2.offset() == [3, 7])
+    assert dr.all(block2.size() == [5, 4])
+    assert block2.border_size() == block.border_size()
+    assert block2.channel_count() == 3
+    assert dr.allclose(block2.tensor(), block.tensor())
+
+    # Merging the deserialized block must match merging the original one
+    target = mi.ImageBlock([10, 12], [0, 0], 3)
+    target2 = mi.ImageBlock([10, 12], [0, 0], 3)
+    target.put_block(block)
+    target2.put_block(block2)
+    assert dr.allclose(target.tensor(), target2.tensor())
+
+
+@pytest.mark.parametrize("filter_name", ['gaussian', 'lanczos', 'tent'])
+@pytest.mark.parametrize("normalize", [ False, True ])
+@pytest.mark.parametrize("coalesce", [ False, True ])
+def test08_put_tabulated(variants_all_rgb, filter_name, normalize, coalesce):
+    # Splatting with a tabulated weight table should closely match
+    # the result obtained by evaluating the filter
+    rfilter = mi.load_dict({ 'type' : filter_name })
+    rfilter_t = mi.load_dict({ 'type' : filter_name, 'tabulate' : True })
+
+    assert not rfilter.has_weight_table()
+    assert rfilter_t.has_weight_table()
+    assert rfilter_t.weight_taps() == 2 * math.ceil(rfilter.radius() - 0.5) + 1
+
+    blocks = []
+    for rf in [rfilter, rfilter_t]:
+        block = mi.ImageBlock([8, 7], [1, 2], 2, rfilter=rf, border=True,
+                              normalize=normalize, coalesce=coalesce,
+                              warn_negative=False)
+
+        # Includes positions whose footprint is clipped by the image boundary
+        for pos in [[1.3, 2.1], [4.71, 5.5], [6.02, 4.93], [8.9, 8.8]]:
+            block.put(pos, [1.0, 2.0])
+        blocks.append(block.tensor())
+
+    assert dr.allclose(blocks[0], blocks[1], atol=5e-2)
+
+
+@pytest.mark.parametrize("filter_name", ['box', 'gaussian'])
+def test09_replicas(variants_vec_rgb, filter_name):
+    # Splatting into several copies of the image must not change the result
+    rfilter = mi.load_dict({ 'type' : filter_name })
+    sampler = mi.load_dict({ 'type' : 'independent' })
+    sampler.seed(0, 1024)
+
+    # Most samples target the same few pixels
+    pos = dr.select(sampler.next_1d() < 0.8, mi.Point2f(3.5, 2.5),
+                    sampler.next_2d() * mi.Point2f(8, 7))
+
+    blocks = []
+    for replicas in [1, 4]:
+        block = mi.ImageBlock([8, 7], [0, 0], 2, rfilter=rfilter,
+                              coalesce=False)
+        block.set_replicas(replicas)
+        assert block.replicas() == replicas
+        block.put(pos, [mi.Float(1.0), mi.Float(2.0)])
+        blocks.append(block.tensor())
+
+    assert dr.allclose(blocks[0], blocks[1])
+
+
+def test10_dlpack(variants_all_rgb):
+    block = mi.ImageBlock([4, 3], [0, 0], 2)
+    block.tensor().array += 1.0
+    assert block.__dlpack_device__() == block.tensor().__dlpack_device__()
+
+    torch = pytest.importorskip("torch")
+    if dr.is_cuda_v(mi.Float) and not torch.cuda.is_available():
+        pytest.skip("PyTorch wasn't built with CUDA support")
+
+    # The exported tensor shares the memory of the image block
+    tensor = torch.from_dlpack(block)
+    assert tuple(tensor.shape) == (3, 4, 2)
+    assert torch.all(tensor == 1.0)
+
+    film = mi.load_dict({ 'type': 'hdrfilm', 'width': 4, 'height': 3 })
+    film.prepare([])
+    assert tuple(torch.from_dlpack(film).shape) == (3, 4, 3)
+
+    mesh = mi.Mesh('MyMesh', 3, 1)
+    params = mi.traverse(mesh)
+    params['vertex_positions'] = [-1, -1, 0, 1, -1, 0, -1, 1, 0]
+    params['faces'] = [0, 1, 2]
+    params.update()
+    positions = torch.from_dlpack(mesh.vertex_positions_buffer())
+    assert positions.tolist() == [-1, -1, 0, 1, -1, 0, -1, 1, 0]
@@ -113,3 +113,208 @@ def test02_depth_scalar_bunny(variant_scalar_rgb):
             res_shadow = scene.ray_test(r)
             assert dr.all(res_shadow == res_naive.is_valid())
             compare_results(res_naive, res)
+
+
+@fresolver_append_path
+@pytest.mark.parametrize("width", [4, 8])
+def test03_depth_scalar_bunny_bvh(variant_scalar_rgb, width):
+    if mi.MI_ENABLE_EMBREE:
+        pytest.skip("EMBREE enabled")
+
+    scene = mi.load_dict({
+        'type': 'scene',
+        'accel': 'bvh',
+        'bvh_width': width,
+        'shape': {
+            "type" : "ply",
+            "filename" : "resources/data/common/meshes/bunny_lowres.ply",
+        }
+    })
+    b = scene.bbox()
+
+    n = 64
+    inv_n = 1.0 / (n - 1)
+    wavelengths = []
+
+    for x in range(n):
+        for y in range(n):
+            o = [b.min[0] * (1 - x * inv_n) + b.max[0] * x * inv_n,
+                 b.min[1] * (1 - y * inv_n) + b.max[1] * y * inv_n,
+                 b.min[2] - 1]
+            d = [0, 0, 1]
+            r = mi.Ray3f(o, d, 0.5, wavelengths)
+            r.maxt = 100
+
+            res_naive  = scene.ray_intersect_naive(r)
+            res        = scene.ray_intersect(r)
+            res_shadow = scene.ray_test(r)
+            assert dr.all(res_shadow == res_naive.is_valid())
+            compare_results(res_naive, res)
+
+
+@fresolver_append_path
+@pytest.mark.parametrize("accel", ['kdtree', 'bvh'])
+def test04_accel_cache(variant_scalar_rgb, tmp_path, accel):
+    if mi.MI_ENABLE_EMBREE:
+        pytest.skip("EMBREE enabled")
+
+    def load():
+        return mi.load_dict({
+            'type': 'scene',
+            'accel': accel,
+            'accel_cache': str(tmp_path),
+            'shape': {
+                "type" : "ply",
+                "filename" : "resources/data/common/meshes/bunny_lowres.ply",
+            }
+        })
+
+    scene_built = load()
+    assert len(list(tmp_path.glob('accel_*.bin'))) == 1
+    scene_cached = load()
+    assert len(list(tmp_path.glob('accel_*.bin'))) == 1
+
+    b = scene_built.bbox()
+    n = 32
+    inv_n = 1.0 / (n - 1)
+    for x in range(n):
+        for y in range(n):
+            o = [b.min[0] * (1 - x * inv_n) + b.max[0] * x * inv_n,
+                 b.min[1] * (1 - y * inv_n) + b.max[1] * y * inv_n,
+                 b.min[2] - 1]
+            r = mi.Ray3f(o, [0, 0, 1], 0.5, [])
+            r.maxt = 100
+
+            compare_results(scene_built.ray_intersect(r),
+                            scene_cached.ray_intersect(r))
+
+
+@pytest.mark.parametrize("accel", ['kdtree', 'bvh'])
+def test05_instance_accel(variant_scalar_rgb, accel):
+    if mi.MI_ENABLE_EMBREE:
+        pytest.skip("EMBREE enabled")
+
+    from mitsuba import ScalarTransform4f as T
+
+    def load(accel_instances):
+        scene = {
+            'type': 'scene',
+            'accel': accel,
+            'accel_instances': accel_instances,
+            'group': {
+                'type': 'shapegroup',
+                'sphere': { 'type': 'sphere', 'radius': 0.3 },
+                'rect': {
+                    'type': 'rectangle',
+                    'to_world': T.translate([0, 0, 0.5]) @ T.scale(0.4)
+                }
+            },
+            'floor': {
+                'type': 'rectangle',
+                'to_world': T.translate([0, 0, 1]) @ T.scale(4)
+            }
+        }
+        for i in range(4):
+            for j in range(4):
+                scene[f'inst_{i}_{j}'] = {
+                    'type': 'instance',
+                    'group': { 'type': 'ref', 'id': 'group' },
+                    'to_world': T.translate([i - 1.5, j - 1.5, 0.1 * i])
+                                @ T.rotate([0, 0, 1], 15 * j)
+                }
+        return mi.load_dict(scene)
+
+    scene_ref = load(False)
+    scene = load(True)
+
+    n = 48
+    inv_n = 1.0 / (n - 1)
+    for x in range(n):
+        for y in range(n):
+            o = [4 * x * inv_n - 2, 4 * y * inv_n - 2, -2]
+            r = mi.Ray3f(o, dr.normalize(mi.Vector3f(0.1, 0.05, 1)))
+
+            res_ref = scene_ref.ray_intersect(r)
+            res = scene.ray_intersect(r)
+            compare_results(res_ref, res)
+            assert str(res.instance) == str(res_ref.instance)
+
+            res_naive = scene.ray_intersect_naive(r)
+            compare_results(res_naive, res)
+            assert dr.all(scene.ray_test(r) == res_ref.is_valid())
+
+
+@fresolver_append_path
+def test06_build_memory_budget(variant_scalar_rgb):
+    if mi.MI_ENABLE_EMBREE:
+        pytest.skip("EMBREE enabled")
+
+    # A tiny budget forces the builder to use min-max binning throughout
+    scene = mi.load_dict({
+        'type': 'scene',
+        'kd_build_memory': 1,
+        'kd_exact_primitive_threshold': 1000000,
+        'shape': {
+            "type" : "ply",
+            "filename" : "resources/data/common/meshes/bunny_lowres.ply",
+        }
+    })
+
+    b = scene.bbox()
+    n = 32
+    inv_n = 1.0 / (n - 1)
+    for x in range(n):
+        for y in range(n):
+            o = [b.min[0] * (1 - x * inv_n) + b.max[0] * x * inv_n,
+                 b.min[1] * (1 - y * inv_n) + b.max[1] * y * inv_n,
+                 b.min[2] - 1]
+            r = mi.Ray3f(o, [0, 0, 1], 0.5, [])
+            r.maxt = 100
+
+            compare_results(scene.ray_intersect_naive(r),
+                            scene.ray_intersect(r))
+
+
+@fresolver_append_path
+def test07_packet_traversal(variants_any_llvm):
+    if mi.MI_ENABLE_EMBREE:
+        pytest.skip("EMBREE enabled")
+
+    # Rays leave the center of the bunny in all directions, so that the
+    # lanes of a packet disagree about the traversal order
+    scene = mi.load_dict({
+        'type': 'scene',
+        'shape': {
+            "type" : "ply",
+            "filename" : "resources/data/common/meshes/bunny_lowres.ply",
+        }
+    })
+
+    n = 1024
+    sampler = mi.load_dict({'type': 'independent'})
+    sampler.seed(0, n)
+    d = mi.warp.square_to_uniform_sphere(sampler.next_2d())
+    o = scene.bbox().center()
+    rays = mi.Ray3f(o, d)
+
+    res = scene.ray_intersect_preliminary(rays)
+    res_shadow = scene.ray_test(rays)
+    assert dr.all(res_shadow == res.is_valid())
+
+    # Compare against the scalar traversal one ray at a time
+    scene_ref = mi.scalar_rgb.load_dict({
+        'type': 'scene',
+        'shape': {
+            "type" : "ply",
+            "filename" : "resources/data/common/meshes/bunny_lowres.ply",
+        }
+    })
+
+    for i in range(n):
+        ray = mi.scalar_rgb.Ray3f([o[0], o[1], o[2]],
+                                  [d.x[i], d.y[i], d.z[i]])
+        res_ref = scene_ref.ray_intersect_preliminary(ray)
+        assert res_ref.is_valid() == res.is_valid()[i]
+        if res_ref.is_valid():
+            assert dr.allclose(res.t[i], res_ref.t)
+            assert res.prim_index[i] == res_ref.prim_index
@@ -250,3 +250,35 @@ def test03_kernel_launches_optimization(variants_all_ad_rgb):
         # Make sure that kernels are reused after the 2nd iteration
         for k in range(len(histories[1])):
             assert histories[1][k]['hash'] == histories[2][k]['hash']
+
+
+@pytest.mark.parametrize('integrator_name', integrator_name)
+def test04_render_stats(variants_vec_rgb, integrator_name):
+    """
+    Tests that the render statistics capture the kernels of a render() call
+    """
+    scene = mi.load_file(find_resource('resources/data/scenes/cbox/cbox.xml'))
+    integrator = mi.load_dict({
+        'type': integrator_name,
+        'max_depth': 3
+    })
+
+    mi.RenderStats.set_enabled(True)
+    try:
+        integrator.render(scene, seed=0, spp=2)
+        stats_1 = mi.RenderStats.last()
+        integrator.render(scene, seed=0, spp=2)
+        stats_2 = mi.RenderStats.last()
+    finally:
+        mi.RenderStats.set_enabled(False)
+
+    for stats in (stats_1, stats_2):
+        jit_kernels = [k for k in stats['kernels'] if k['type'] == 'JIT']
+        assert len(jit_kernels) == 2
+        assert stats['render_time'] > 0
+        assert stats['peak_memory'] > 0
+        assert stats['vcall_targets']['BSDF'] > 0
+
+    # The second render reuses the kernels of the first one
+    assert stats_2['cache_misses'] == 0
+    assert 'Kernel launches' in mi.RenderStats.report()
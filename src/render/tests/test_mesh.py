@@ -1,6 +1,7 @@
 import pytest
 import drjit as dr
 import mitsuba as mi
+import numpy as np
 
 from mitsuba.scalar_rgb.test.util import fresolver_append_path
 
@@ -1221,3 +1222,389 @@ def test33_rebuild_area_pmf(variants_vec_rgb):
     surface_area_after = mesh.surface_area()
 
     assert surface_area_after == 4 * surface_area_before
+
+
+def test34_load_large_obj(variant_scalar_rgb, tmp_path):
+    # A file that is large enough to be parsed in several chunks
+    n = 400
+    x, y = np.meshgrid(np.arange(n, dtype=np.float32),
+                       np.arange(n, dtype=np.float32))
+    idx = np.arange(n * n).reshape(n, n) + 1
+    quads = np.stack([idx[:-1, :-1], idx[:-1, 1:],
+                      idx[1:, 1:], idx[1:, :-1]], axis=-1).reshape(-1, 4)
+
+    filepath = str(tmp_path / 'test_mesh-test34_load_large_obj.obj')
+    with open(filepath, 'w') as f:
+        for xi, yi in zip(x.ravel(), y.ravel()):
+            f.write(f'v {xi:.1f} {yi:.1f} 0.0\n')
+        f.write('vn 0 0 1\n')
+        for q in quads:
+            f.write('f %i//1 %i//1 %i//1 %i//1\n' % tuple(q))
+
+    mesh = mi.load_dict({'type': 'obj', 'filename': filepath})
+    assert mesh.vertex_count() == n * n
+    assert mesh.face_count() == 2 * (n - 1) ** 2
+
+    params = mi.traverse(mesh)
+    positions = np.array(params['vertex_positions']).reshape(-1, 3)
+    assert np.allclose(positions[:, 0], x.ravel())
+    assert np.allclose(positions[:, 1], y.ravel())
+
+    faces = np.array(params['faces']).reshape(-1, 2, 3)
+    assert np.all(faces[:, 0] == quads[:, [0, 1, 2]] - 1)
+    assert np.all(faces[:, 1] == quads[:, [0, 2, 3]] - 1)
+
+
+@pytest.mark.parametrize('layout', ['direct', 'converted'])
+def test35_load_binary_ply(variants_all_rgb, tmp_path, layout):
+    # Binary PLY files that can (or cannot) be read without conversion
+    n = 3000
+    rng = np.random.default_rng(seed=0)
+    positions = rng.random((n, 3)).astype(np.float32)
+    faces = rng.integers(0, n, (2 * n, 3)).astype(np.uint32)
+
+    vtype, ftype, ptype = ('float', 'uint', np.float32) if layout == 'direct' \
+        else ('double', 'int', np.float64)
+
+    filepath = str(tmp_path / f'test_mesh-test35_load_binary_ply_{layout}.ply')
+    with open(filepath, 'wb') as f:
+        f.write(('ply\nformat binary_little_endian 1.0\n'
+                 f'element vertex {n}\n'
+                 f'property {vtype} x\nproperty {vtype} y\nproperty {vtype} z\n'
+                 f'element face {2 * n}\n'
+                 f'property list uchar {ftype} vertex_indices\n'
+                 'end_header\n').encode())
+        f.write(positions.astype(ptype).tobytes())
+        face_data = np.zeros(2 * n, dtype=[('count', np.uint8), ('i', np.uint32, 3)])
+        face_data['count'] = 3
+        face_data['i'] = faces
+        f.write(face_data.tobytes())
+
+    mesh = mi.load_dict({'type': 'ply', 'filename': filepath})
+    params = mi.traverse(mesh)
+    assert mesh.vertex_count() == n
+    assert mesh.face_count() == 2 * n
+    assert np.allclose(np.array(params['vertex_positions']), positions.ravel())
+    assert np.all(np.array(params['faces']) == faces.ravel())
+    assert dr.allclose(mesh.bbox().min, positions.min(axis=0))
+    assert dr.allclose(mesh.bbox().max, positions.max(axis=0))
+
+
+def test36_load_ascii_ply(variant_scalar_rgb, tmp_path):
+    n = 2000
+    rng = np.random.default_rng(seed=0)
+    positions = rng.random((n, 3)).astype(np.float32)
+    colors = rng.integers(0, 256, (n, 3))
+    faces = rng.integers(0, n, (n, 3))
+
+    filepath = str(tmp_path / 'test_mesh-test36_load_ascii_ply.ply')
+    with open(filepath, 'w') as f:
+        f.write('ply\nformat ascii 1.0\n'
+                f'element vertex {n}\n'
+                'property float x\nproperty float y\nproperty float z\n'
+                'property uchar red\nproperty uchar green\nproperty uchar blue\n'
+                f'element face {n}\n'
+                'property list uchar int vertex_indices\n'
+                'end_header\n')
+        for p, c in zip(positions, colors):
+            f.write('%.9g %.9g %.9g %i %i %i\n' % (*p, *c))
+        f.write('\n')  # Blank lines are ignored
+        for i in faces:
+            f.write('3 %i %i %i\r\n' % tuple(i))
+
+    mesh = mi.load_dict({'type': 'ply', 'filename': filepath})
+    params = mi.traverse(mesh)
+    assert mesh.vertex_count() == n
+    assert mesh.face_count() == n
+    assert np.allclose(np.array(params['vertex_positions']), positions.ravel())
+    srgb = colors.ravel() / 255.0
+    linear = np.where(srgb <= 0.04045, srgb / 12.92, ((srgb + 0.055) / 1.055) ** 2.4)
+    assert np.allclose(np.array(params['vertex_color']), linear, atol=1e-5)
+    assert np.all(np.array(params['faces']) == faces.ravel())
+
+    # Non-triangular faces and truncated files are reported
+    with open(filepath, 'a') as f:
+        f.write('4 0 1 2 3\n')
+    with pytest.raises(RuntimeError, match='trailing tokens'):
+        mi.load_dict({'type': 'ply', 'filename': filepath})
+
+
+def test37_serialized_shape_index(variant_scalar_rgb, tmp_path):
+    # Write a .serialized file (version 4) containing several meshes
+    import struct, zlib
+
+    meshes = []
+    offsets = []
+    filepath = str(tmp_path / 'test_mesh-test37_serialized_shape_index.serialized')
+    with open(filepath, 'wb') as f:
+        for i in range(4):
+            positions = np.array([[0, 0, i], [1, 0, i], [0, 1, i]], dtype=np.float32)
+            faces = np.array([[0, 1, 2]], dtype=np.uint32)
+            payload = struct.pack('<I', 0x1000) + f'mesh{i}'.encode() + b'\0' + \
+                struct.pack('<QQ', 3, 1) + positions.tobytes() + faces.tobytes()
+            offsets.append(f.tell())
+            f.write(struct.pack('<HH', 0x041C, 0x0004))
+            f.write(zlib.compress(payload))
+            meshes.append(positions)
+        f.write(struct.pack(f'<{len(offsets)}QI', *offsets, len(offsets)))
+
+    for i in [2, 0, 3, 1]:
+        mesh = mi.load_dict({'type': 'serialized', 'filename': filepath,
+                             'shape_index': i})
+        positions = np.array(mi.traverse(mesh)['vertex_positions'])
+        assert np.allclose(positions, meshes[i].ravel())
+
+    with pytest.raises(RuntimeError, match='out of range'):
+        mi.load_dict({'type': 'serialized', 'filename': filepath,
+                      'shape_index': 4})
+
+
+def test38_compact_vertex_attributes(variants_all_rgb, np_rng):
+    n = 100
+    positions = np_rng.random((n, 3))
+    normals = np_rng.normal(size=(n, 3))
+    normals /= np.linalg.norm(normals, axis=1)[:, None]
+    texcoords = np_rng.random((n, 2))
+    faces = np_rng.integers(0, n, (n, 3))
+
+    def create_mesh(compact):
+        props = mi.Properties()
+        props['compact_vertex_attributes'] = compact
+        mesh = mi.Mesh('MyMesh', n, n, props, True, True)
+        params = mi.traverse(mesh)
+        params['vertex_positions'] = positions.ravel()
+        params['vertex_normals'] = normals.ravel()
+        params['vertex_texcoords'] = texcoords.ravel()
+        params['faces'] = faces.ravel()
+        mesh.initialize()
+        return mesh
+
+    mesh, mesh_compact = create_mesh(False), create_mesh(True)
+
+    assert not mesh.has_compact_vertex_attributes()
+    assert mesh_compact.has_compact_vertex_attributes()
+    assert mesh_compact.has_vertex_normals()
+    assert mesh_compact.has_vertex_texcoords()
+    assert 'vertex_normals' not in mi.traverse(mesh_compact)
+
+    index = dr.arange(mi.UInt32, n)
+    assert dr.allclose(mesh.vertex_normal(index),
+                       mesh_compact.vertex_normal(index), atol=1e-3)
+    assert dr.allclose(mesh.vertex_texcoord(index),
+                       mesh_compact.vertex_texcoord(index), atol=1e-3)
+    assert dr.allclose(mesh.vertex_normals_buffer(),
+                       mesh_compact.decoded_vertex_normals(), atol=1e-3)
+
+    # Moving the vertices recomputes and re-encodes the normals
+    params = mi.traverse(mesh_compact)
+    params['vertex_positions'] = 2 * positions.ravel()
+    params.update()
+    assert dr.allclose(dr.norm(mesh_compact.vertex_normal(index)), 1, atol=1e-4)
+
+
+def test39_recompute_normals_large_mesh(variants_all_rgb, np_rng):
+    # Height field that is large enough to be processed in several blocks
+    res = 200
+    x, y = np.meshgrid(np.linspace(0, 1, res), np.linspace(0, 1, res))
+    positions = np.stack([x.ravel(), y.ravel(),
+                          0.05 * np_rng.random(res * res)], axis=1)
+    i = (np.arange(res - 1)[:, None] * res + np.arange(res - 1)[None, :]).ravel()
+    faces = np.concatenate([np.stack([i, i + 1, i + res + 1], axis=1),
+                            np.stack([i, i + res + 1, i + res], axis=1)])
+
+    mesh = mi.Mesh('MyMesh', res * res, len(faces), has_vertex_normals=True)
+    params = mi.traverse(mesh)
+    params['vertex_positions'] = positions.ravel()
+    params['faces'] = faces.ravel()
+    params.update()
+
+    # Reference: angle-weighted face normals
+    v = positions[faces]
+    n = np.cross(v[:, 1] - v[:, 0], v[:, 2] - v[:, 0])
+    n /= np.linalg.norm(n, axis=1)[:, None]
+    normals = np.zeros_like(positions)
+    for k in range(3):
+        d0 = v[:, (k + 1) % 3] - v[:, k]
+        d1 = v[:, (k + 2) % 3] - v[:, k]
+        cos_angle = np.sum(d0 * d1, axis=1) / (np.linalg.norm(d0, axis=1) *
+                                               np.linalg.norm(d1, axis=1))
+        angle = np.arccos(np.clip(cos_angle, -1, 1))
+        np.add.at(normals, faces[:, k], n * angle[:, None])
+    normals /= np.linalg.norm(normals, axis=1)[:, None]
+
+    result = np.array(params['vertex_normals']).reshape(-1, 3)
+    assert np.allclose(result, normals, atol=1e-4)
+
+
+def test40_deformation_motion_blur(variants_all_rgb):
+    mesh = mi.Mesh('MyMesh', 3, 1)
+    params = mi.traverse(mesh)
+    params['vertex_positions'] = [-1, -1, 0, 1, -1, 0, -1, 1, 0]
+    params['faces'] = [0, 1, 2]
+    params.update()
+    assert mesh.motion_key_count() == 1
+
+    # Two further keyframes: the triangle moves up and then shrinks
+    params['vertex_motion_positions'] = [-1, -1, 2, 1, -1, 2, -1, 1, 2,
+                                         -1, -1, 2, 0, -1, 2, -1, 0, 2]
+    params.update()
+    assert mesh.motion_key_count() == 3
+    assert mesh.is_animated()
+    assert dr.allclose(mesh.bbox().min, [-1, -1, 0])
+    assert dr.allclose(mesh.bbox().max, [1, 1, 2])
+
+    scene = mi.load_dict({'type': 'scene', 'mesh': mesh})
+
+    for time, hit, t in [(0.0, True, 1.0), (0.25, True, 2.0),
+                         (0.5, True, 3.0), (1.0, False, 0.0)]:
+        ray = mi.Ray3f(o=[0.1, -0.5, -1], d=[0, 0, 1], time=time, wavelengths=[])
+        si = scene.ray_intersect(ray)
+        assert dr.all(si.is_valid() == hit)
+        if hit:
+            assert dr.allclose(si.t, t)
+            assert dr.allclose(si.p, [0.1, -0.5, t - 1])
+            assert dr.allclose(dr.abs(si.n), [0, 0, 1])
+        assert dr.all(scene.ray_test(ray) == hit)
+
+    # The keyframe buffer must contain entire keyframes
+    params['vertex_motion_positions'] = [0, 0, 0]
+    with pytest.raises(RuntimeError, match='keyframe'):
+        params.update()
+
+
+def test41_incremental_silhouette(variants_all_ad_rgb):
+    # Closed octahedron whose edges are shared by two faces each
+    mesh = mi.Mesh('MyMesh', 6, 8)
+    params = mi.traverse(mesh)
+    params['vertex_positions'] = [1, 0, 0, -1, 0, 0, 0, 1, 0,
+                                  0, -1, 0, 0, 0, 1, 0, 0, -1]
+    params['faces'] = [0, 2, 4, 2, 1, 4, 1, 3, 4, 3, 0, 4,
+                       2, 0, 5, 1, 2, 5, 3, 1, 5, 0, 3, 5]
+    dr.enable_grad(params['vertex_positions'])
+    params.update()
+
+    scene = mi.load_dict({ 'type': 'scene', 'mesh': mesh })
+    sensor = mi.load_dict({
+        'type': 'perspective',
+        'to_world': mi.ScalarTransform4f.look_at(origin=[0.3, 0.2, 4],
+                                                 target=[0, 0, 0],
+                                                 up=[0, 1, 0])
+    })
+    viewpoint = mi.ScalarPoint3f(dr.slice(sensor.world_transform() @ mi.Point3f(0)))
+    dedges = dr.arange(mi.UInt32, mesh.face_count() * 3)
+
+    indices, weights = mesh.precompute_silhouette(viewpoint)
+    edge_weights = mesh.silhouette_edge_weight(viewpoint, dedges)
+    assert dr.all(dr.eq(dr.gather(mi.Float, edge_weights, indices), weights))
+    assert dr.allclose(dr.sum(edge_weights), dr.sum(weights))
+
+    class Parent:
+        silhouette_tolerance = 1e-3
+    proj = mi.ad.ProjectiveDetail(Parent())
+    proj.init_primarily_visible_silhouette(scene, sensor)
+    assert dr.all(dr.eq(proj.primary_indices[0], indices))
+
+    # Displacing one vertex only updates the edges of its adjacent faces
+    positions = mi.Float(params['vertex_positions'])
+    positions[4 * 3 + 0] = 0.5
+    params['vertex_positions'] = positions
+    params.update()
+
+    proj.init_primarily_visible_silhouette(scene, sensor)
+    indices, weights = mesh.precompute_silhouette(viewpoint)
+    entry = list(proj.silhouette_cache[id(sensor)][1].values())[0]
+    assert dr.all(dr.eq(proj.primary_indices[0], indices))
+    assert dr.allclose(entry['weights'],
+                       mesh.silhouette_edge_weight(viewpoint, dedges))
+
+    # Motion below the tolerance keeps the cached silhouette
+    positions[4 * 3 + 0] = 0.5001
+    params['vertex_positions'] = positions
+    params.update()
+    proj.init_primarily_visible_silhouette(scene, sensor)
+    assert dr.allclose(entry['positions'].x[4], 0.5)
+
+
+def test42_opacity_bake(variants_all_rgb, tmp_path):
+    # Two quads at x < 0 and x > 0, whose texture coordinates map to a
+    # transparent and an opaque texel of the opacity mask, respectively
+    filepath = str(tmp_path / 'test_mesh-test42_opacity_bake.ply')
+    vertices = [(-2, -1, 0, 0.0, 0.0), (-1, -1, 0, 0.4, 0.0),
+                (-1,  1, 0, 0.4, 1.0), (-2,  1, 0, 0.0, 1.0),
+                ( 1, -1, 0, 0.6, 0.0), ( 2, -1, 0, 1.0, 0.0),
+                ( 2,  1, 0, 1.0, 1.0), ( 1,  1, 0, 0.6, 1.0)]
+    faces = [(0, 1, 2), (0, 2, 3), (4, 5, 6), (4, 6, 7)]
+    with open(filepath, 'w') as f:
+        f.write('ply\nformat ascii 1.0\n'
+                f'element vertex {len(vertices)}\n'
+                'property float x\nproperty float y\nproperty float z\n'
+                'property float u\nproperty float v\n'
+                f'element face {len(faces)}\n'
+                'property list uchar int vertex_indices\n'
+                'end_header\n')
+        for v in vertices:
+            f.write('%g %g %g %g %g\n' % v)
+        for i in faces:
+            f.write('3 %i %i %i\n' % i)
+
+    def load(resolution):
+        return mi.load_dict({
+            'type': 'scene',
+            'shape': {
+                'type': 'ply',
+                'filename': filepath,
+                'opacity_bake_resolution': resolution,
+                'bsdf': {
+                    'type': 'mask',
+                    'opacity': {
+                        'type': 'bitmap',
+                        'data': mi.TensorXf([0, 1], shape=(1, 2, 1)),
+                        'filter_type': 'nearest',
+                        'raw': True
+                    },
+                    'material': { 'type': 'diffuse' }
+                }
+            }
+        })
+
+    scene, scene_baked = load(0), load(4)
+    for x, opaque in [(-1.5, False), (1.5, True)]:
+        ray = mi.Ray3f(mi.Point3f(x, 0, -1), mi.Vector3f(0, 0, 1))
+        assert dr.all(scene.ray_test(ray))
+        assert dr.all(dr.eq(scene_baked.ray_test(ray), opaque))
+
+
+def test43_solid_angle_sampling(variants_vec_rgb, tmp_path):
+    # A quad light next to the reference point is sampled by solid angle
+    filepath = str(tmp_path / 'test_mesh-test43_solid_angle_sampling.obj')
+    with open(filepath, 'w') as f:
+        f.write('v -1 -1 0\nv 1 -1 0\nv 1 1 0\nv -1 1 0\n'
+                'f 1 2 3\nf 1 3 4\n')
+    mesh = mi.load_dict({ 'type': 'obj', 'filename': filepath })
+    rectangle = mi.load_dict({ 'type': 'rectangle' })
+
+    sampler = mi.load_dict({ 'type': 'independent' })
+    sampler.seed(0, 1 << 16)
+    it = dr.zeros(mi.Interaction3f, 1 << 16)
+    it.p = [0.3, -0.2, 0.5]
+    sample = sampler.next_2d()
+    ds = mesh.sample_direction(it, sample)
+
+    # Same density as the spherical rectangle of the equivalent shape
+    assert dr.allclose(ds.pdf, rectangle.sample_direction(it, sample).pdf, rtol=1e-4)
+    assert dr.allclose(ds.pdf, mesh.pdf_direction(it, ds))
+    assert dr.allclose(ds.p.z, 0, atol=1e-5)
+    assert dr.all((dr.abs(ds.p.x) <= 1 + 1e-5) & (dr.abs(ds.p.y) <= 1 + 1e-5))
+    assert dr.allclose(ds.d, dr.normalize(ds.p - it.p), atol=1e-5)
+
+    # Uniform in solid angle: compare the share of the first face
+    corners = [dr.normalize(mi.Vector3f(x, y, 0) - it.p)
+               for x, y in [(-1, -1), (1, -1), (1, 1)]]
+    omega = mi.warp.spherical_triangle_solid_angle(*corners)
+    fraction = dr.count(ds.p.y < ds.p.x) / (1 << 16)
+    assert dr.allclose(fraction, omega * ds.pdf[0], atol=1e-2)
+
+    # Distant reference points use area sampling
+    it.p = [0, 0, 100]
+    ds = mesh.sample_direction(it, sample)
+    assert dr.allclose(ds.pdf, dr.squared_norm(ds.p - it.p) / (4 * dr.abs(ds.d.z)))
@@ -307,3 +307,55 @@ def test06_chi2(variants_vec_backends_once, md_type_name, alpha, sample_visible,
     )
 
     assert chi2.run()
+
+
+@pytest.mark.parametrize("vndf_sampling", ['Heitz', 'SphericalCaps'])
+@pytest.mark.parametrize("angle", [15, 80])
+def test07_chi2_vndf_sampling(variants_vec_backends_once, vndf_sampling, angle):
+    method = getattr(mi.VNDFSampling, vndf_sampling)
+    sample_func, pdf_func = mi.chi2.MicrofacetAdapter(
+        mi.MicrofacetType.GGX, 0.3, True, method)
+
+    chi2 = mi.chi2.ChiSquareTest(
+        domain=mi.chi2.SphericalDomain(),
+        sample_func=lambda *args: sample_func(*(list(args) + [angle])),
+        pdf_func=lambda *args: pdf_func(*(list(args) + [angle])),
+        sample_dim=2,
+        res=128,
+        ires=32
+    )
+
+    assert chi2.run()
+
+
+def test08_vndf_sampling_methods(variants_vec_backends_once):
+    mdf = mi.MicrofacetDistribution(mi.MicrofacetType.GGX, 0.2, 0.5)
+    assert mdf.vndf_sampling() == mi.VNDFSampling.SphericalCaps
+
+    n = 100000
+    sampler = mi.load_dict({'type': 'independent'})
+    sampler.seed(0, n)
+    u = sampler.next_2d()
+    wi = dr.normalize(mi.Vector3f(0.6, 0.3, 0.5))
+
+    # The spherical caps sample the same density as the original method
+    normals = []
+    for method in [mi.VNDFSampling.Heitz, mi.VNDFSampling.SphericalCaps]:
+        mdf.set_vndf_sampling(method)
+        m, pdf = mdf.sample(wi, u)
+        assert dr.allclose(dr.norm(m), 1)
+        assert dr.allclose(pdf, mdf.pdf(wi, m), rtol=1e-3)
+        normals.append(m)
+    assert dr.allclose(dr.mean(normals[0]), dr.mean(normals[1]), atol=5e-3)
+
+    # The bounded variant is unbiased over the reflected directions
+    mdf.set_vndf_sampling(mi.VNDFSampling.BoundedSphericalCaps)
+    m, pdf = mdf.sample(wi, u)
+    assert dr.allclose(pdf, mdf.pdf(wi, m), rtol=1e-3)
+
+    wo = mi.reflect(wi, m)
+    pdf_wo = pdf / (4 * dr.dot(wi, m))
+    valid = (mi.Frame3f.cos_theta(wo) > 0) & (pdf_wo > 0)
+    assert dr.mean(dr.select(valid, 1, 0)) > 0.9
+    area = dr.mean(dr.select(valid, mi.Frame3f.cos_theta(wo) / pdf_wo, 0))
+    assert dr.allclose(area, dr.pi, rtol=2e-2)
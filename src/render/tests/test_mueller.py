@@ -193,3 +193,37 @@ def test09_circular(variant_scalar_rgb):
     # Light that is already circularly polarized is unchanged.
     dr.allclose(L @ Array4f([1, 0, 0, -1]), Array4f([0.5, 0, 0, -1]))
     dr.allclose(R @ Array4f([1, 0, 0, +1]), Array4f([0.5, 0, 0, +1]))
+
+
+def test10_structured_rotations(variant_scalar_rgb):
+    # The rotations only update the affected rows and columns, compare them
+    # against dense matrix products for a general Mueller matrix
+    M = mi.mueller.linear_retarder(0.3) @ \
+        mi.mueller.rotated_element(0.4, mi.mueller.linear_polarizer(0.8)) @ \
+        mi.mueller.specular_reflection(0.7, 1.5)
+
+    w = [0, 0, 1]
+    b_00 = mi.mueller.stokes_basis(w)
+
+    def rotate_vector(v, axis, angle):
+        return mi.Transform4f.rotate(axis, angle) @ v
+
+    R_in  = mi.mueller.rotator(30 * dr.pi / 180)
+    R_out = mi.mueller.rotator(-110 * dr.pi / 180)
+    b_in  = rotate_vector(b_00, w, 30.0)
+    b_out = rotate_vector(b_00, w, -110.0)
+
+    assert dr.allclose(mi.mueller.rotate_stokes_basis(w, b_00, b_in), R_in, atol=1e-5)
+    assert dr.allclose(mi.mueller.rotate_stokes_basis(w, b_00, b_out), R_out, atol=1e-5)
+
+    assert dr.allclose(
+        mi.mueller.rotate_mueller_basis(M, w, b_00, b_in, w, b_00, b_out),
+        R_out @ M @ dr.transpose(R_in), atol=1e-5)
+
+    assert dr.allclose(
+        mi.mueller.rotate_mueller_basis_collinear(M, w, b_00, b_in),
+        R_in @ M @ dr.transpose(R_in), atol=1e-5)
+
+    assert dr.allclose(mi.mueller.rotated_element(0.25, M),
+                       dr.transpose(mi.mueller.rotator(0.25)) @ M @
+                       mi.mueller.rotator(0.25), atol=1e-5)
@@ -0,0 +1,33 @@
+import pytest
+import drjit as dr
+import mitsuba as mi
+
+
+def test01_build_guiding_octree(variants_all_ad_rgb):
+    sampler = mi.load_dict({ 'type': 'independent' })
+    sampler.seed(0, 1000)
+    points = mi.Point3f(sampler.next_1d(), sampler.next_1d(), sampler.next_1d())
+
+    lower, upper = mi.build_guiding_octree(points, x_slices=4, max_depth=6,
+                                           max_leaf_count=200000)
+    assert dr.width(lower) == dr.width(upper) and dr.width(lower) > 0
+    assert dr.all(lower.x <= upper.x) and dr.all(lower.y <= upper.y)
+
+    # The leaves tile the unit cube
+    extents = upper - lower
+    assert dr.allclose(dr.sum(extents.x * extents.y * extents.z), 1)
+
+    # Every point lies in exactly one leaf, and leaves above the maximum
+    # depth contain at most one point
+    lower_np, upper_np, points_np = lower.numpy(), upper.numpy(), points.numpy()
+    inside = ((points_np[:, None, :] > lower_np[None, :, :]) &
+              (points_np[:, None, :] <= upper_np[None, :, :])).all(axis=2)
+    assert (inside.sum(axis=1) == 1).all()
+
+    min_extent = 0.25 * 0.5 ** 5
+    count = inside.sum(axis=0)
+    large = (upper_np - lower_np)[:, 0] > min_extent * 1.5
+    assert (count[large] <= 1).all()
+
+    with pytest.raises(RuntimeError, match='max_leaf_count'):
+        mi.build_guiding_octree(points, x_slices=4, max_depth=6, max_leaf_count=100)
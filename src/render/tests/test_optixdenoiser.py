@@ -94,7 +94,8 @@ def test01_denoiser_construct(variants_any_cuda):
 
     assert (
         "OptixDenoiser[\n  input_size = [33, 18],\n  albedo = 0,\n  " +
-        "normals = 0,\n  temporal = 0\n]" == str(mi.OptixDenoiser(input_res))
+        "normals = 0,\n  temporal = 0,\n  tile_size = [33, 18]\n]" ==
+        str(mi.OptixDenoiser(input_res))
     )
 
     with pytest.raises(Exception) as e:
@@ -241,3 +242,20 @@ def test05_denoiser_denoise_multichannel_bitmap_runs(variant_cuda_ad_rgb):
     dr.eval(denoised)
 
     assert True
+
+
+def test06_denoiser_denoise_tiled(variant_cuda_ad_rgb):
+    noisy = mi.TensorXf(mi.Bitmap(find_resource("resources/data/tests/denoiser/noisy.exr")))
+    size = mi.ScalarVector2u(noisy.shape[1], noisy.shape[0])
+
+    denoiser = mi.OptixDenoiser(size)
+    denoised = denoiser(noisy)
+
+    # Tiles that do not evenly divide the image
+    tile_size = size // 3 + 1
+    denoiser_tiled = mi.OptixDenoiser(size, tile_size=tile_size)
+    assert f"tile_size = {tile_size}" in str(denoiser_tiled)
+    denoised_tiled = denoiser_tiled(noisy)
+
+    assert denoised_tiled.shape == denoised.shape
+    assert dr.allclose(denoised_tiled.array, denoised.array, rtol=5e-2, atol=5e-2)
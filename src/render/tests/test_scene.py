@@ -315,3 +315,394 @@ def test11_sample_silhouette_bijective(variants_vec_rgb):
     out = scene.invert_silhouette_sample(ss)
     assert dr.all(dr.neq(ss.discontinuity_type, mi.DiscontinuityFlags.Empty.value))
     assert dr.allclose(valid_samples, valid_out, atol=1e-6)
+
+
+@fresolver_append_path
+@pytest.mark.parametrize("offset", [0.1, 10.0])
+def test12_accel_update_refit(variant_scalar_rgb, offset):
+    if not mi.MI_ENABLE_EMBREE:
+        pytest.skip("Refitting is only supported by the Embree backend")
+
+    scene = mi.load_dict({
+        'type': 'scene',
+        'accel_update': True,
+        'rect': {
+            'type': 'rectangle',
+            'to_world': mi.ScalarTransform4f.scale(0.5),
+        },
+        'mesh': {
+            'type': 'obj',
+            'filename': 'resources/data/common/meshes/rectangle.obj',
+        },
+    })
+
+    # Move the mesh along the ray direction, small offsets are refitted while
+    # large ones exceed the quality threshold and trigger a rebuild
+    params = mi.traverse(scene)
+    key = 'mesh.vertex_positions'
+    positions = dr.unravel(mi.Point3f, params[key])
+    positions.z += offset
+    params[key] = dr.ravel(positions)
+    params.update()
+
+    ray = mi.Ray3f(mi.Point3f(0.7, 0.7, -10), mi.Vector3f(0, 0, 1))
+    si = scene.ray_intersect(ray)
+    assert dr.allclose(si.t, 10 + offset)
+
+    ray = mi.Ray3f(mi.Point3f(0.1, 0.1, -10), mi.Vector3f(0, 0, 1))
+    si = scene.ray_intersect(ray)
+    assert dr.allclose(si.t, 10)
+
+
+@fresolver_append_path
+def test13_accel_update_optix(variants_vec_rgb):
+    if not mi.variant().startswith('cuda'):
+        pytest.skip("Only relevant for the OptiX backend")
+
+    scene = mi.load_dict({
+        'type': 'scene',
+        'accel_update': True,
+        'accel_rebuild_interval': 3,
+        'mesh': {
+            'type': 'obj',
+            'filename': 'resources/data/common/meshes/rectangle.obj',
+        },
+    })
+
+    params = mi.traverse(scene)
+    key = 'mesh.vertex_positions'
+    ray = mi.Ray3f(mi.Point3f(0.5, 0.5, -10), mi.Vector3f(0, 0, 1))
+
+    # Alternate between in-place updates and periodic full rebuilds
+    for i in range(1, 8):
+        positions = dr.unravel(mi.Point3f, params[key])
+        positions.z += 0.25
+        params[key] = dr.ravel(positions)
+        params.update()
+
+        si = scene.ray_intersect(ray)
+        assert dr.allclose(si.t, 10 + 0.25 * i)
+
+
+def test14_light_tree_emitter_sampling(variants_vec_rgb):
+    def make_scene(light_tree):
+        scene_dict = {
+            'type': 'scene',
+            'light_tree': light_tree,
+            'constant': {'type': 'constant', 'radiance': 0.1},
+            'spot': {
+                'type': 'spot',
+                'to_world': mi.ScalarTransform4f.look_at(
+                    origin=[0, 0, 4], target=[0, 0, 0], up=[0, 1, 0]),
+                'intensity': 5.0,
+            },
+        }
+        for i in range(8):
+            scene_dict[f'point_{i}'] = {
+                'type': 'point',
+                'position': [2 * (i % 4) - 3, 2 * (i // 4) - 1, 1],
+                'intensity': 1.0 + i,
+            }
+        for i in range(2):
+            scene_dict[f'rect_{i}'] = {
+                'type': 'rectangle',
+                'to_world': mi.ScalarTransform4f.translate([4 * i - 2, 0, 3]) @
+                            mi.ScalarTransform4f.rotate([1, 0, 0], 180),
+                'emitter': {'type': 'area', 'radiance': 2.0},
+            }
+        return mi.load_dict(scene_dict)
+
+    scene_ref, scene_tree = make_scene(False), make_scene(True)
+
+    n = 100000
+    sampler = mi.load_dict({'type': 'independent'})
+    sampler.seed(0, n)
+
+    si = dr.zeros(mi.SurfaceInteraction3f, n)
+    si.p = mi.Point3f(0.5, 0.2, 0)
+    si.n = mi.Vector3f(0, 0, 1)
+    sample = sampler.next_2d()
+
+    results = []
+    for scene in [scene_ref, scene_tree]:
+        ds, spec = scene.sample_emitter_direction(si, sample, False)
+        valid = ds.pdf > 0
+
+        # The light tree PMF must be reproducible when evaluating the PDF
+        pdf = scene.pdf_emitter_direction(si, ds, valid)
+        assert dr.allclose(dr.select(valid, pdf, 0), dr.select(valid, ds.pdf, 0),
+                           rtol=1e-3)
+
+        results.append(dr.sum(spec) / n)
+
+    # Both strategies estimate the same (unoccluded) incident radiance
+    assert dr.allclose(results[0], results[1], rtol=2e-2)
+
+
+def test15_light_culling(variants_vec_rgb):
+    def make_scene(light_culling):
+        scene_dict = {
+            'type': 'scene',
+            'light_culling': light_culling,
+            'point': {'type': 'point', 'position': [0, 0, 3]},
+            'projector': {
+                'type': 'projector',
+                'to_world': mi.ScalarTransform4f.look_at(
+                    origin=[0, 0, 4], target=[0, 0, 0], up=[0, 1, 0]),
+                'fov': 30,
+            },
+        }
+        # Half of the spot lights face away from the reference point
+        for i in range(6):
+            target = [0, 0, 0] if i % 2 == 0 else [0, 0, 8]
+            scene_dict[f'spot_{i}'] = {
+                'type': 'spot',
+                'to_world': mi.ScalarTransform4f.look_at(
+                    origin=[i - 2.5, 0, 4], target=target, up=[0, 1, 0]),
+                'cutoff_angle': 40,
+            }
+        return mi.load_dict(scene_dict)
+
+    n = 100000
+    sampler = mi.load_dict({'type': 'independent'})
+    sampler.seed(0, n)
+
+    si = dr.zeros(mi.SurfaceInteraction3f, n)
+    si.p = mi.Point3f(0.2, 0.1, 0)
+    si.n = mi.Vector3f(0, 0, 1)
+    sample = sampler.next_2d()
+
+    results, hits = [], []
+    for scene in [make_scene(False), make_scene(True)]:
+        ds, spec = scene.sample_emitter_direction(si, sample, False)
+        valid = ds.pdf > 0
+
+        pdf = scene.pdf_emitter_direction(si, ds, valid)
+        assert dr.allclose(dr.select(valid, pdf, 0), dr.select(valid, ds.pdf, 0),
+                           rtol=1e-3)
+
+        results.append(dr.sum(spec) / n)
+        hits.append(dr.mean(mi.Float(dr.any(spec > 0))))
+
+    # Culling doesn't change the estimate but avoids wasted samples
+    assert dr.allclose(results[0], results[1], rtol=2e-2)
+    assert hits[0][0] < 0.7 and hits[1][0] > 0.95
+
+
+def test16_geometry_paging(variants_vec_rgb):
+    if not mi.variant().startswith('cuda'):
+        pytest.skip("Only relevant for the OptiX backend")
+
+    def make_scene(budget):
+        scene_dict = {
+            'type': 'scene',
+            'geometry_budget': budget,
+            'sensor': {
+                'type': 'perspective',
+                'to_world': mi.ScalarTransform4f.look_at(
+                    origin=[0, 0, 8], target=[0, 0, 0], up=[0, 1, 0]),
+                'film': { 'type': 'hdrfilm', 'width': 32, 'height': 32 },
+            },
+            'emitter': { 'type': 'constant' },
+        }
+        for i in range(3):
+            scene_dict[f'group_{i}'] = {
+                'type': 'shapegroup',
+                'shape': { 'type': 'cube', 'bsdf': { 'type': 'diffuse' } },
+            }
+            scene_dict[f'instance_{i}'] = {
+                'type': 'instance',
+                'shapegroup': { 'type': 'ref', 'id': f'group_{i}' },
+                'to_world': mi.ScalarTransform4f.translate([3 * i - 3, 0, 0]),
+            }
+        return mi.load_dict(scene_dict)
+
+    integrator = mi.load_dict({ 'type': 'path', 'samples_per_pass': 4 })
+    image_ref = integrator.render(make_scene(0.0), seed=0, spp=8)
+
+    # Only a fraction of the groups fit into the budget, passes are repeated
+    image = integrator.render(make_scene(1e-3), seed=0, spp=8)
+    assert dr.allclose(image, image_ref)
+
+
+def test17_batched_parameter_update(variants_all_rgb):
+    scene_dict = { 'type': 'scene' }
+    for i in range(16):
+        scene_dict[f'sphere_{i}'] = {
+            'type': 'sphere',
+            'to_world': mi.ScalarTransform4f.translate([3 * i, 0, 0]),
+        }
+    scene = mi.load_dict(scene_dict)
+
+    params = mi.traverse(scene)
+    for i in range(16):
+        params[f'sphere_{i}.to_world'] = mi.Transform4f.translate([3 * i, 2, 0])
+    updated = params.update()
+
+    # Every sphere and the scene (last) are notified exactly once
+    nodes = [node for node, _ in updated]
+    assert len(nodes) == 17
+    assert nodes[-1] == scene
+
+    for i in [0, 5, 15]:
+        ray = mi.Ray3f(mi.Point3f(3 * i, 2, -5), mi.Vector3f(0, 0, 1))
+        si = scene.ray_intersect(ray)
+        assert dr.all(si.is_valid())
+        assert dr.allclose(si.p, [3 * i, 2, -1])
+
+
+def test18_single_emitter_direct_call(variants_vec_rgb):
+    # A second scene registers further emitters with Dr.Jit
+    other = mi.load_dict({ 'type': 'scene', 'light': { 'type': 'constant' } })
+    scene = mi.load_dict({
+        'type': 'scene',
+        'light': {
+            'type': 'constant',
+            'radiance': { 'type': 'rgb', 'value': 3.0 }
+        }
+    })
+    emitter = scene.emitters()[0]
+
+    it = dr.zeros(mi.Interaction3f, 4)
+    it.p = mi.Point3f([0, 1, 0, -1], [0, 0, 1, 0], 0)
+    it.wavelengths = []
+    ds, _ = scene.sample_emitter_direction(it, mi.Point2f(0.5), False)
+    ds.emitter = dr.select(mi.Bool([True, True, False, True]),
+                           ds.emitter, dr.zeros(mi.EmitterPtr, 4))
+    assert dr.all(ds.pdf > 0)
+
+    valid = mi.Bool([True, True, False, True])
+    pdf_ref = dr.select(valid, emitter.pdf_direction(it, ds), 0)
+    value_ref = dr.select(valid, emitter.eval_direction(it, ds), 0)
+
+    for inline in [True, False]:
+        with dr.scoped_set_flag(dr.JitFlag.VCallInline, inline):
+            pdf = scene.pdf_emitter_direction(it, ds)
+            value = scene.eval_emitter_direction(it, ds)
+        assert dr.allclose(pdf, pdf_ref)
+        assert dr.allclose(value, value_ref)
+
+
+def test19_emitter_cache(variants_vec_rgb):
+    from mitsuba import ScalarTransform4f as T
+
+    def light(x):
+        return {
+            'type': 'rectangle',
+            'to_world': T.translate([x, 0, 2]) @ T.scale(0.1) @
+                        T.rotate([1, 0, 0], 180),
+            'emitter': {'type': 'area', 'radiance': 1.0},
+        }
+
+    # The second light is hidden from the reference point by an occluder
+    scene = mi.load_dict({
+        'type': 'scene',
+        'emitter_cache': True,
+        'visible': light(2),
+        'occluded': light(-2),
+        'occluder': {
+            'type': 'rectangle',
+            'to_world': T.translate([-1, 0, 1]) @ T.scale(0.5),
+        },
+    })
+
+    n = 100000
+    sampler = mi.load_dict({'type': 'independent'})
+    sampler.seed(0, n)
+
+    si = dr.zeros(mi.SurfaceInteraction3f, n)
+    si.n = mi.Vector3f(0, 0, 1)
+
+    def estimate():
+        ds, spec = scene.sample_emitter_direction(si, sampler.next_2d(), True)
+        valid = ds.pdf > 0
+
+        pdf = scene.pdf_emitter_direction(si, ds, valid)
+        assert dr.allclose(dr.select(valid, pdf, 0), dr.select(valid, ds.pdf, 0),
+                           rtol=1e-3)
+
+        return dr.mean(mi.Float(valid)), dr.sum(spec.x) / n
+
+    hits_before, value_before = estimate()
+    scene.update_emitter_cache()
+    hits_after, value_after = estimate()
+
+    # Half of the samples now choose the visible emitter on purpose
+    assert dr.allclose(hits_before, 0.5, atol=1e-2)
+    assert dr.allclose(hits_after, 0.75, atol=1e-2)
+    assert dr.allclose(value_before, value_after, rtol=2e-2)
+
+
+def test20_memory_usage(variants_all_rgb):
+    scene = mi.load_dict({
+        'type': 'scene',
+        'sensor': {
+            'type': 'perspective',
+            'film': {'type': 'hdrfilm', 'width': 16, 'height': 8},
+        },
+        'mesh': {
+            'type': 'obj',
+            'filename': 'resources/data/tests/obj/cbox_smallbox.obj',
+            'bsdf': {
+                'type': 'diffuse',
+                'reflectance': {
+                    'type': 'bitmap',
+                    'data': mi.TensorXf(dr.zeros(mi.Float, 4 * 4 * 3), shape=(4, 4, 3)),
+                },
+            },
+        },
+    })
+
+    records = scene.memory_usage()
+    categories = set(r[1] for r in records)
+    assert 'Shape' in categories
+    assert 'Texture' in categories
+    assert 'Accel' in categories
+    assert 'ImageBlock' in categories
+
+    for name, category, host, device in records:
+        if category == 'Texture':
+            assert host + device >= 4 * 4 * 3 * 4
+
+    report = scene.memory_report()
+    assert 'Category' in report
+    assert 'mesh' in report
+
+
+def test21_instance_transform_update(variants_all_rgb):
+    T = mi.ScalarTransform4f
+    scene = mi.load_dict({
+        'type': 'scene',
+        'accel_rebuild_interval': 2,
+        'group': {
+            'type': 'shapegroup',
+            'shape': { 'type': 'rectangle', 'to_world': T.scale(0.25) }
+        },
+        'instance_0': {
+            'type': 'instance',
+            'group': { 'type': 'ref', 'id': 'group' },
+            'to_world': T.translate([-1, 0, 0])
+        },
+        'instance_1': {
+            'type': 'instance',
+            'group': { 'type': 'ref', 'id': 'group' },
+            'to_world': T.translate([1, 0, 0])
+        },
+    })
+
+    params = mi.traverse(scene)
+    key = 'instance_0.to_world'
+
+    # Alternate between in-place updates and periodic full rebuilds
+    for i in range(1, 6):
+        params[key] = mi.Transform4f.translate([-1, i, 0.5 * i])
+        params.update()
+
+        si = scene.ray_intersect(mi.Ray3f([-1, i, -10], [0, 0, 1]))
+        assert dr.all(si.is_valid())
+        assert dr.allclose(si.t, 10 + 0.5 * i)
+
+        # The previous location is empty, the other instance didn't move
+        assert dr.none(scene.ray_test(mi.Ray3f([-1, i - 1, -10], [0, 0, 1])))
+        si = scene.ray_intersect(mi.Ray3f([1, 0, -10], [0, 0, 1]))
+        assert dr.allclose(si.t, 10)
@@ -0,0 +1,54 @@
+import pytest
+import drjit as dr
+import mitsuba as mi
+import numpy as np
+import os
+
+
+def sparse_data(np_rng, shape=(20, 40, 24, 1)):
+    # Mostly empty grid with a single dense blob
+    data = np.zeros(shape, dtype=np.float32)
+    data[2:9, 20:35, 3:10, :] = np_rng.random((7, 15, 7, shape[3]))
+    return data
+
+
+def test01_dense_conversion(variants_all_scalar, np_rng):
+    data = sparse_data(np_rng)
+    sparse = mi.SparseVolumeGrid(mi.VolumeGrid(data))
+
+    assert dr.allclose([24, 40, 20], sparse.size())
+    assert sparse.channel_count() == 1
+    assert sparse.node_count() == 1
+    # The blob spans 2 x 3 x 2 leaves of 8^3 voxels
+    assert sparse.leaf_count() == 12
+    assert sparse.occupancy() < 0.5
+    assert dr.allclose(sparse.max(), np.max(data))
+
+
+def test02_active_voxels(variants_all_scalar):
+    coords = np.array([[0, 0, 0], [300, 5, 7], [301, 5, 7]], dtype=np.uint32)
+    values = np.array([[1, 2, 3], [4, 5, 6], [7, 8, 9]], dtype=np.float32)
+    sparse = mi.SparseVolumeGrid([512, 16, 16], coords, values)
+
+    assert sparse.channel_count() == 3
+    assert dr.allclose([4, 1, 1], sparse.root_size())
+    assert sparse.node_count() == 2
+    assert sparse.leaf_count() == 2
+    assert dr.allclose([7, 8, 9], sparse.max_per_channel())
+
+    with pytest.raises(RuntimeError):
+        mi.SparseVolumeGrid([16, 16, 16], coords, values)
+
+
+def test03_read_write(variants_all_scalar, tmpdir, np_rng):
+    tmp_file = os.path.join(str(tmpdir), "out.svol")
+    data = sparse_data(np_rng, (20, 40, 24, 3))
+    sparse = mi.SparseVolumeGrid(mi.VolumeGrid(data))
+    sparse.write(tmp_file)
+
+    loaded = mi.SparseVolumeGrid(tmp_file)
+    assert dr.allclose(loaded.size(), sparse.size())
+    assert loaded.channel_count() == 3
+    assert loaded.leaf_count() == sparse.leaf_count()
+    assert loaded.node_count() == sparse.node_count()
+    assert dr.allclose(loaded.max_per_channel(), sparse.max_per_channel())
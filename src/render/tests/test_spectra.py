@@ -139,3 +139,19 @@ def test07_cie1931_srgb_roundtrip(variants_vec_spectral):
 
     assert dr.allclose(mi.xyz_to_srgb(xyz), srgb)
     assert dr.allclose(mi.srgb_to_xyz(srgb), xyz, atol=1e-6)
+
+
+def test08_rgb2spec_fetch_vectorized(variants_vec_spectral):
+    import numpy as np
+    rng = np.random.default_rng(seed=0)
+    rgb = rng.random((100, 3))
+    rgb[:4] = [[0, 0, 0], [1, 1, 1], [0.5, 0.5, 0.5], [1, 0, 0]]
+
+    coeff = mi.srgb_model_fetch(mi.Color3f(rgb[:, 0], rgb[:, 1], rgb[:, 2]))
+    for i in range(rgb.shape[0]):
+        ref = mi.srgb_model_fetch(mi.ScalarColor3f(rgb[i]))
+        for j in range(3):
+            if np.isfinite(ref[j]):
+                assert dr.allclose(dr.slice(coeff[j], i), ref[j], rtol=1e-4, atol=1e-5)
+            else:
+                assert dr.slice(coeff[j], i) == ref[j]
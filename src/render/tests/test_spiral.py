@@ -49,10 +49,11 @@ def test02_small_film(variant_scalar_rgb):
     f = make_film(15, 12)
     s = mi.Spiral(f.size(), f.crop_offset())
 
-    (bo, bs, bi) = s.next_block()
+    (bo, bs, bi, bb) = s.next_block()
     assert dr.all(bo == [0, 0])
     assert dr.all(bs == [15, 12])
     assert dr.all(bi == 0)
+    assert bb == 32
     # The whole image is covered by a single block
     assert dr.all(s.next_block()[1] == 0)
 
@@ -77,3 +78,29 @@ def test03_normal_film(variant_scalar_rgb):
     # Resetting and re-querying the blocks should yield the exact same results.
     s.reset()
     check_first_blocks(extract_blocks(s), expected, n_total=110)
+
+
+def test04_straggler_blocks(variant_scalar_rgb):
+    f = make_film(318, 322)
+    s = mi.Spiral(f.size(), f.crop_offset(), passes=2)
+    s.set_straggler_blocks(8)
+
+    blocks = extract_blocks(s, max_blocks=1000)
+    assert len(blocks) == s.total_block_count()
+    assert len(blocks) > 2 * s.block_count()
+
+    # Every pixel must be covered exactly once per pass, and the pixel seeds
+    # (block_id * block_size^2 + i) of sub-blocks must match their parents
+    coverage = np.zeros((322, 318), dtype=np.int32)
+    seeds = set()
+    for (bo, bs, bi, bb) in blocks:
+        x, y = int(bo[0]), int(bo[1])
+        coverage[y:y+int(bs[1]), x:x+int(bs[0])] += 1
+        seeds.add((bi * bb * bb, bb))
+        assert bb in (16, 32)
+    assert np.all(coverage == 2)
+
+    # Sub-block seed ranges don't overlap with any other block
+    ranges = sorted(seeds)
+    for (a, ba), (b, _) in zip(ranges, ranges[1:]):
+        assert a + ba * ba <= b
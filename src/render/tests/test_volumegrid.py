@@ -46,3 +46,29 @@ def test03_max_per_channel(variants_all_scalar, tmpdir, np_rng):
     grid = mi.VolumeGrid(tmp_file)
     mi_max_per_channel = grid.max_per_channel()
     assert dr.allclose(np_max_per_channel, mi_max_per_channel)
+
+
+@pytest.mark.parametrize('channels', [1, 3, 6, 5])
+def test04_memory_mapped(variants_all_scalar, tmpdir, np_rng, channels):
+    tmp_file = os.path.join(str(tmpdir), "out.vol")
+    # Large enough to be split into several blocks, with a ragged tail
+    data = np_rng.random((23, 61, 73, channels))
+    mi.VolumeGrid(data).write(tmp_file)
+
+    mapped = mi.VolumeGrid(tmp_file)
+    copied = mi.VolumeGrid(tmp_file, memory_map=False)
+    assert not copied.is_memory_mapped()
+    # Double precision variants need to convert the data
+    assert mapped.is_memory_mapped() == ('double' not in mi.variant())
+
+    assert dr.allclose(np.array(mapped), np.array(copied))
+    assert dr.allclose(np.array(mapped).reshape(data.shape), data)
+    assert dr.allclose(mapped.max(), np.max(data))
+    assert dr.allclose(mapped.max_per_channel(),
+                       np.max(data.reshape(-1, channels), axis=0))
+    assert dr.allclose(copied.max_per_channel(), mapped.max_per_channel())
+
+    # The grid can be written back to disk
+    tmp_file_2 = os.path.join(str(tmpdir), "out2.vol")
+    mapped.write(tmp_file_2)
+    assert dr.allclose(np.array(mi.VolumeGrid(tmp_file_2)), np.array(copied))
@@ -80,7 +80,7 @@ Texture<Float, Spectrum>::D65(ref<Texture> texture) {
         return texture;
     } else {
         std::vector<std::string> plugins = {
-            "srgb", "bitmap", "checkerboard", "mesh_attribute"
+            "srgb", "bitmap", "checkerboard", "mesh_attribute", "udim"
         };
         if (string::contains(plugins, texture->class_()->name())) {
             Properties props("d65");
@@ -51,11 +51,19 @@ Volume<Float, Spectrum>::eval_gradient(const Interaction3f & /*it*/, Mask /*acti
 MI_VARIANT typename Volume<Float, Spectrum>::ScalarFloat
 Volume<Float, Spectrum>::max() const { NotImplementedError("max"); }
 
+MI_VARIANT typename Volume<Float, Spectrum>::ScalarFloat
+Volume<Float, Spectrum>::min() const { NotImplementedError("min"); }
+
 MI_VARIANT void
 Volume<Float, Spectrum>::max_per_channel(ScalarFloat * /*out*/) const {
     NotImplementedError("max_per_channel");
 }
 
+MI_VARIANT std::vector<typename Volume<Float, Spectrum>::ScalarFloat>
+Volume<Float, Spectrum>::max_per_supervoxel(const ScalarVector3i &resolution) const {
+    return std::vector<ScalarFloat>((size_t) dr::prod(resolution), max());
+}
+
 MI_VARIANT typename Volume<Float, Spectrum>::ScalarVector3i
 Volume<Float, Spectrum>::resolution() const {
     return ScalarVector3i(1, 1, 1);
@@ -2,7 +2,12 @@
 #include <mitsuba/core/stream.h>
 #include <mitsuba/core/logger.h>
 #include <mitsuba/core/fstream.h>
+#include <mitsuba/core/mmap.h>
+#include <mitsuba/core/mstream.h>
 #include <mitsuba/core/util.h>
+#include <drjit/packet.h>
+#include <nanothread/nanothread.h>
+#include <mutex>
 
 NAMESPACE_BEGIN(mitsuba)
 
@@ -10,9 +15,30 @@ MI_VARIANT
 VolumeGrid<Float, Spectrum>::VolumeGrid(Stream *stream) { read(stream); }
 
 MI_VARIANT
-VolumeGrid<Float, Spectrum>::VolumeGrid(const fs::path &filename) {
-    ref<FileStream> fs = new FileStream(filename);
-    read(fs);
+VolumeGrid<Float, Spectrum>::VolumeGrid(const fs::path &filename,
+                                        bool memory_map) {
+    /* The voxel data can be accessed directly within a memory-mapped file if
+       it matches the in-memory representation (single precision values in
+       little endian byte order). This avoids an intermediate copy. */
+    if (!memory_map || !std::is_same_v<ScalarFloat, float> ||
+        Stream::host_byte_order() != Stream::ELittleEndian) {
+        ref<FileStream> fs = new FileStream(filename);
+        read(fs);
+        return;
+    }
+
+    m_mmap = new MemoryMappedFile(filename);
+    ref<MemoryStream> ms = new MemoryStream(m_mmap->data(), m_mmap->size());
+    read_header(ms);
+
+    size_t expected = HeaderSize + buffer_size();
+    if (m_mmap->size() < expected)
+        Throw("Volume file \"%s\" is truncated: expected %zu bytes, found %zu",
+              filename.string(), expected, m_mmap->size());
+
+    update_max();
+    Log(Debug, "Mapped grid volume data from file: dimensions %s, max value %f",
+        m_size, m_max);
 }
 
 MI_VARIANT
@@ -26,7 +52,7 @@ VolumeGrid<Float, Spectrum>::VolumeGrid(ScalarVector3u size,
 }
 
 MI_VARIANT
-void VolumeGrid<Float, Spectrum>::read(Stream *stream) {
+void VolumeGrid<Float, Spectrum>::read_header(Stream *stream) {
     char header[3];
     stream->read(header, 3);
 
@@ -62,26 +88,76 @@ void VolumeGrid<Float, Spectrum>::read(Stream *stream) {
     stream->read_array(dims, 6);
     m_bbox = ScalarBoundingBox3f(ScalarPoint3f(dims[0], dims[1], dims[2]),
                                  ScalarPoint3f(dims[3], dims[4], dims[5]));
+}
 
-    m_max = -dr::Infinity<ScalarFloat>;
-    m_max_per_channel.resize(m_channel_count, -dr::Infinity<ScalarFloat>);
-
-    m_data = std::unique_ptr<ScalarFloat[]>(new ScalarFloat[size * m_channel_count]);
-    size_t k = 0;
-    for (size_t i = 0; i < size; ++i) {
-        for (size_t j = 0; j < m_channel_count; ++j) {
-            float val;
-            stream->read(val);
-            m_data[k] = val;
-            m_max     = dr::maximum(m_max, val);
-            m_max_per_channel[j] = dr::maximum(m_max_per_channel[j], val);
-            ++k;
-        }
+MI_VARIANT
+void VolumeGrid<Float, Spectrum>::read(Stream *stream) {
+    read_header(stream);
+
+    size_t count = dr::prod(m_size) * m_channel_count;
+    m_data = std::unique_ptr<ScalarFloat[]>(new ScalarFloat[count]);
+    if constexpr (std::is_same_v<ScalarFloat, float>) {
+        stream->read_array(m_data.get(), count);
+    } else {
+        // Need to convert data from single precision after reading it
+        std::unique_ptr<float[]> input(new float[count]);
+        stream->read_array(input.get(), count);
+        for (size_t i = 0; i < count; ++i)
+            m_data[i] = (ScalarFloat) input[i];
     }
+
+    update_max();
     Log(Debug, "Loaded grid volume data from file: dimensions %s, max value %f",
         m_size, m_max);
 }
 
+MI_VARIANT
+void VolumeGrid<Float, Spectrum>::update_max() {
+    /* Packets of 24 values are aligned with the voxels of grids storing 1, 2,
+       3, 4 or 6 channels, hence every lane maps to a fixed channel */
+    constexpr size_t Width = 24, BlockSize = Width * 4096;
+    using PacketF = dr::Packet<ScalarFloat, Width>;
+
+    const ScalarFloat *values = data();
+    const size_t channels = m_channel_count;
+    const size_t count = dr::prod(m_size) * channels;
+    const size_t blocks = (count + BlockSize - 1) / BlockSize;
+    const bool vectorize = Width % channels == 0;
+
+    m_max_per_channel.assign(channels, -dr::Infinity<ScalarFloat>);
+    std::mutex mutex;
+
+    dr::parallel_for(
+        dr::blocked_range<size_t>(0, blocks, 1),
+        [&](const dr::blocked_range<size_t> &range) {
+            std::vector<ScalarFloat> local(channels, -dr::Infinity<ScalarFloat>);
+            for (size_t block = range.begin(); block != range.end(); ++block) {
+                size_t i   = block * BlockSize,
+                       end = std::min(i + BlockSize, count);
+
+                if (vectorize) {
+                    PacketF max = -dr::Infinity<ScalarFloat>;
+                    for (; i + Width <= end; i += Width)
+                        max = dr::maximum(max, dr::load<PacketF>(values + i));
+                    for (size_t j = 0; j < Width; ++j)
+                        local[j % channels] = dr::maximum(local[j % channels], max[j]);
+                }
+
+                for (; i < end; ++i)
+                    local[i % channels] = dr::maximum(local[i % channels], values[i]);
+            }
+
+            std::lock_guard<std::mutex> guard(mutex);
+            for (size_t j = 0; j < channels; ++j)
+                m_max_per_channel[j] = dr::maximum(m_max_per_channel[j], local[j]);
+        }
+    );
+
+    m_max = -dr::Infinity<ScalarFloat>;
+    for (size_t j = 0; j < channels; ++j)
+        m_max = dr::maximum(m_max, m_max_per_channel[j]);
+}
+
 MI_VARIANT
 void VolumeGrid<Float, Spectrum>::max_per_channel(ScalarFloat *out) const {
     for (size_t i=0; i<m_channel_count; ++i)
@@ -112,12 +188,12 @@ void VolumeGrid<Float, Spectrum>::write(Stream *stream) const {
     stream->write(float(m_bbox.max.z()));
 
     if constexpr (std::is_same<ScalarFloat, float>::value)
-        stream->write_array(m_data.get(), dr::prod(m_size) * m_channel_count);
+        stream->write_array(data(), dr::prod(m_size) * m_channel_count);
     else {
         // Need to convert data to single precision before writing to disk
         std::vector<float> output(dr::prod(m_size) * m_channel_count);
         for (size_t i = 0; i < dr::prod(m_size) * m_channel_count; ++i)
-            output[i] = m_data[i];
+            output[i] = data()[i];
         stream->write_array(output.data(), dr::prod(m_size) * m_channel_count);
     }
 }
@@ -135,7 +211,7 @@ std::string VolumeGrid<Float, Spectrum>::to_string() const {
     oss << std::endl;
     oss << "  ],"  << std::endl
         << "  data = [ " << util::mem_string(buffer_size())
-        << " of volume data ]" << std::endl
+        << " of " << (m_mmap ? "memory-mapped " : "") << "volume data ]" << std::endl
         << "]";
     return oss.str();
 }
@@ -0,0 +1,241 @@
+#include <mitsuba/core/profiler.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/spectrum.h>
+#include <mitsuba/core/qmc.h>
+#include <mitsuba/render/sampler.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**!
+
+.. _sampler-halton:
+
+Scrambled Halton sampler (:monosp:`halton`)
+-------------------------------------------
+
+.. pluginparameters::
+
+ * - sample_count
+   - |int|
+   - Number of samples per pixel (Default: 4)
+
+ * - seed
+   - |int|
+   - Seed offset (Default: 0)
+
+ * - scramble
+   - |int|
+   - Permutation that is applied to the digits of the sequence. The default
+     value of -1 selects the deterministic Faure permutations, any other
+     value builds pseudorandom permutations seeded by it. (Default: -1)
+
+This plugin implements a sampler based on the Halton sequence, whose
+dimension :math:`i` is given by the radical inverse of the sample index in
+the :math:`i`-th prime base. The digits are furthermore run through a
+permutation (Faure permutations by default), which avoids the correlations
+between the higher dimensions of the plain Halton sequence. Every pixel
+applies an independent random toroidal shift (Cranley-Patterson rotation)
+to each dimension, and the sample count can be arbitrary.
+
+The radical inverse is evaluated using precomputed tables that process
+several digits per lookup. The first 256 dimensions use the Halton
+sequence, higher dimensions fall back to independent random numbers.
+
+.. tabs::
+    .. code-tab:: xml
+        :name: halton-sampler
+
+        <sampler type="halton">
+            <integer name="sample_count" value="64"/>
+        </sampler>
+
+    .. code-tab:: python
+
+        'type': 'halton',
+        'sample_count': 64
+
+ */
+
+template <typename Float, typename Spectrum>
+class HaltonSampler final : public Sampler<Float, Spectrum> {
+public:
+    MI_IMPORT_BASE(Sampler, m_sample_count, m_base_seed, seeded,
+                   m_samples_per_wavefront, m_dimension_index,
+                   current_sample_index, compute_per_sequence_seed)
+    MI_IMPORT_TYPES()
+
+    using UInt32Storage = DynamicBuffer<UInt32>;
+    using FloatStorage  = DynamicBuffer<Float>;
+
+    HaltonSampler(const Properties &props) : Base(props) {
+        // The 256th prime number is 1619
+        m_inverse = new RadicalInverse(1619, props.get<int>("scramble", -1));
+
+        if constexpr (dr::is_jit_v<Float>) {
+            /* Concatenate the digit tables of all bases. The dimension of a
+               sample is generally not known while tracing the kernel (e.g.
+               within a loop), hence all of them must be accessible. */
+            size_t bases = m_inverse->bases(), size = 0;
+            std::vector<uint32_t> offsets(bases), sizes(bases);
+            std::vector<ScalarFloat> corrections(bases);
+
+            for (size_t i = 0; i < bases; ++i) {
+                offsets[i] = (uint32_t) size;
+                sizes[i] = m_inverse->digit_table_size(i);
+                size += sizes[i];
+
+                ScalarFloat recip = ScalarFloat(1) / (ScalarFloat) m_inverse->base(i);
+                corrections[i] = recip * (ScalarFloat) m_inverse->permutation(i)[0] /
+                                 (ScalarFloat(1) - recip);
+            }
+
+            std::unique_ptr<uint32_t[]> values(new uint32_t[size]);
+            for (size_t i = 0; i < bases; ++i) {
+                const uint16_t *table = m_inverse->digit_table(i);
+                for (uint32_t j = 0; j < sizes[i]; ++j)
+                    values[offsets[i] + j] = table[j];
+            }
+
+            m_tables      = dr::load<UInt32Storage>(values.get(), size);
+            m_offsets     = dr::load<UInt32Storage>(offsets.data(), bases);
+            m_sizes       = dr::load<UInt32Storage>(sizes.data(), bases);
+            m_corrections = dr::load<FloatStorage>(corrections.data(), bases);
+        }
+    }
+
+    ref<Sampler<Float, Spectrum>> fork() override {
+        HaltonSampler *sampler           = new HaltonSampler(this);
+        sampler->m_sample_count          = m_sample_count;
+        sampler->m_samples_per_wavefront = m_samples_per_wavefront;
+        sampler->m_base_seed             = m_base_seed;
+        return sampler;
+    }
+
+    ref<Sampler<Float, Spectrum>> clone() override {
+        return new HaltonSampler(*this);
+    }
+
+    void seed(uint32_t seed, uint32_t wavefront_size) override {
+        Base::seed(seed, wavefront_size);
+        m_scramble_seed = compute_per_sequence_seed(seed);
+    }
+
+    Float next_1d(Mask /*active*/ = true) override {
+        Assert(seeded());
+        return sample(m_dimension_index++);
+    }
+
+    Point2f next_2d(Mask /*active*/ = true) override {
+        Assert(seeded());
+        Float x = sample(m_dimension_index++),
+              y = sample(m_dimension_index++);
+        return Point2f(x, y);
+    }
+
+    void schedule_state() override {
+        Base::schedule_state();
+        dr::schedule(m_scramble_seed);
+    }
+
+    std::string to_string() const override {
+        std::ostringstream oss;
+        oss << "HaltonSampler [" << std::endl
+            << "  sample_count = " << m_sample_count << "," << std::endl
+            << "  scramble = " << m_inverse->scramble() << std::endl
+            << "]";
+        return oss.str();
+    }
+
+    MI_DECLARE_CLASS()
+
+private:
+    HaltonSampler(const HaltonSampler &sampler) : Base(sampler) {
+        m_inverse       = sampler.m_inverse;
+        m_tables        = sampler.m_tables;
+        m_offsets       = sampler.m_offsets;
+        m_sizes         = sampler.m_sizes;
+        m_corrections   = sampler.m_corrections;
+        m_scramble_seed = sampler.m_scramble_seed;
+    }
+
+    /// Create an unseeded sampler that shares the tables of \c parent
+    HaltonSampler(const HaltonSampler *parent) : Base(Properties()) {
+        m_inverse     = parent->m_inverse;
+        m_tables      = parent->m_tables;
+        m_offsets     = parent->m_offsets;
+        m_sizes       = parent->m_sizes;
+        m_corrections = parent->m_corrections;
+    }
+
+    /// Return the rotated sample of the current index in the given dimension
+    Float sample(const UInt32 &dim) const {
+        UInt32 index = current_sample_index();
+        uint32_t bases = (uint32_t) m_inverse->bases();
+
+        Float value;
+        if constexpr (!dr::is_jit_v<Float>) {
+            if (dim < bases)
+                value = m_inverse->template eval_scrambled<Float>(dim, (uint64_t) index);
+            else
+                value = Float(sample_tea_float32(index, m_scramble_seed ^ dim));
+        } else {
+            value = radical_inverse_jit(dr::minimum(dim, bases - 1), index);
+            value = dr::select(dim < bases, value,
+                               Float(sample_tea_float32(index, m_scramble_seed ^ dim)));
+        }
+
+        // Per-sequence toroidal shift
+        value += Float(sample_tea_float32(m_scramble_seed, dim));
+        value = dr::select(value >= 1.f, value - 1.f, value);
+        return dr::minimum(value, dr::OneMinusEpsilon<Float>);
+    }
+
+    /**
+     * \brief Evaluate the scrambled radical inverse in wavefront mode
+     *
+     * Equivalent to \ref RadicalInverse::eval_scrambled(), except that the
+     * base may differ between lanes. The number of digit groups follows
+     * from the sample count, so that no horizontal reduction is needed.
+     */
+    Float radical_inverse_jit(const UInt32 &base_index, UInt32 index) const {
+        UInt32 offset = dr::gather<UInt32>(m_offsets, base_index),
+               size   = dr::gather<UInt32>(m_sizes, base_index);
+        Float recip = 1.f / Float(size),
+              factor(1.f), value(0.f);
+
+        /* The smallest table (base 67) requires the most groups. Surplus
+           groups process scrambled leading zeros like the correction below */
+        uint32_t groups = 1;
+        for (uint64_t n = 67; n < m_sample_count; n *= 67)
+            groups++;
+
+        for (uint32_t i = 0; i < groups; ++i) {
+            UInt32 next = index / size,
+                   digits = index - next * size;
+            factor *= recip;
+            value = dr::fmadd(
+                Float(dr::gather<UInt32>(m_tables, offset + digits)), factor,
+                value);
+            index = next;
+        }
+
+        Float correction = dr::gather<Float>(m_corrections, base_index);
+        return dr::fmadd(correction, factor, value);
+    }
+
+    ref<RadicalInverse> m_inverse;
+
+    /// Concatenated digit tables of all bases (wavefront mode)
+    UInt32Storage m_tables;
+    /// Offset and size of the digit table of each base (wavefront mode)
+    UInt32Storage m_offsets, m_sizes;
+    /// Contribution of the scrambled leading zeros of each base (wavefront mode)
+    FloatStorage m_corrections;
+
+    /// Per-sequence scramble seed
+    UInt32 m_scramble_seed;
+};
+
+MI_IMPLEMENT_CLASS_VARIANT(HaltonSampler, Sampler)
+MI_EXPORT_PLUGIN(HaltonSampler, "Scrambled Halton Sampler");
+NAMESPACE_END(mitsuba)
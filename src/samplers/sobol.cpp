@@ -0,0 +1,236 @@
+#include <mitsuba/core/profiler.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/spectrum.h>
+#include <mitsuba/core/qmc.h>
+#include <mitsuba/render/sampler.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**!
+
+.. _sampler-sobol:
+
+Owen-scrambled Sobol' sampler (:monosp:`sobol`)
+-----------------------------------------------
+
+.. pluginparameters::
+
+ * - sample_count
+   - |int|
+   - Number of samples per pixel (Default: 4)
+
+ * - seed
+   - |int|
+   - Seed offset (Default: 0)
+
+ * - blue_noise
+   - |bool|
+   - Correlate the sequences of neighboring pixels so that the remaining
+     error is distributed as blue noise in screen space (Default: |false|)
+
+This plugin implements a padded 2D Sobol' sampler following the approach
+described by Burley :cite:`Burley2020Practical`. Every 2D sample dimension is
+drawn from the first two dimensions of the Sobol' sequence (a (0, 2)-sequence
+in base 2), whose values are decorrelated by applying a nested uniform (Owen)
+scramble. The order of the points is furthermore shuffled independently for
+every dimension by Owen-scrambling the sample index, which avoids the
+correlations between dimensions that would otherwise result from the padding.
+
+All operations are hash-based and only require a handful of integer
+instructions per sample, making this sampler only marginally slower than the
+:ref:`ldsampler <sampler-ldsampler>` plugin. Unlike the latter, it neither
+requires the sample count to be a power of two nor to be a square number, and
+any prefix of ``2^m`` samples of a pixel is well stratified. This makes it a
+good choice for progressive rendering.
+
+When the ``blue_noise`` parameter is enabled, the pixels of the film are
+traversed in a randomized hierarchical Z-order (Morton) curve, and every pixel
+receives a consecutive block of samples of one shared sequence. Neighboring
+pixels hence obtain sample sets that are complementary to each other, which
+pushes the Monte Carlo error towards high spatial frequencies
+:cite:`Ahmed2020Screen`. Note that the scalar variants never change the seed
+of this shared sequence between passes, hence this mode should there only be
+used when all samples of a pixel are generated in a single pass.
+
+.. tabs::
+    .. code-tab:: xml
+        :name: sobol-sampler
+
+        <sampler type="sobol">
+            <integer name="sample_count" value="64"/>
+            <boolean name="blue_noise" value="true"/>
+        </sampler>
+
+    .. code-tab:: python
+
+        'type': 'sobol',
+        'sample_count': 64,
+        'blue_noise': True
+
+ */
+
+template <typename Float, typename Spectrum>
+class SobolSampler final : public Sampler<Float, Spectrum> {
+public:
+    MI_IMPORT_BASE(Sampler, m_sample_count, m_base_seed, seeded,
+                   m_samples_per_wavefront, m_dimension_index,
+                   current_sample_index, compute_per_sequence_seed)
+    MI_IMPORT_TYPES()
+
+    SobolSampler(const Properties &props) : Base(props) {
+        m_blue_noise = props.get<bool>("blue_noise", false);
+    }
+
+    ref<Sampler<Float, Spectrum>> fork() override {
+        SobolSampler *sampler            = new SobolSampler(Properties());
+        sampler->m_sample_count          = m_sample_count;
+        sampler->m_samples_per_wavefront = m_samples_per_wavefront;
+        sampler->m_base_seed             = m_base_seed;
+        sampler->m_blue_noise            = m_blue_noise;
+        return sampler;
+    }
+
+    ref<Sampler<Float, Spectrum>> clone() override {
+        return new SobolSampler(*this);
+    }
+
+    void seed(uint32_t seed, uint32_t wavefront_size) override {
+        Base::seed(seed, wavefront_size);
+        m_scramble_seed = compute_per_sequence_seed(seed);
+
+        /* The sequence shared by all pixels in blue noise mode can only
+           depend on the seed in wavefront mode, since the scalar rendering
+           code seeds every pixel separately. */
+        if constexpr (dr::is_jit_v<Float>)
+            m_shared_seed = sample_tea_32(m_base_seed, seed).first;
+        else
+            m_shared_seed = sample_tea_32(m_base_seed, 0u).first;
+
+        m_has_pixel = false;
+    }
+
+    void set_pixel(const Point2u &pixel) override {
+        if (!m_blue_noise)
+            return;
+
+        /* Number of levels of the Z-order curve that fit into a 32 bit
+           sample index alongside the samples of every pixel */
+        uint32_t log_stride = dr::log2i(
+                     math::round_to_power_of_two(std::max(m_sample_count, 2u))),
+                 levels = std::min(16u, (32u - log_stride) / 2u);
+
+        // Pixels that are further apart use independently scrambled sequences
+        Point2u tile = pixel >> levels;
+        UInt32 tile_seed =
+            sample_tea_32(m_shared_seed ^ tile.x(), tile.y()).first;
+
+        UInt32 rank = 0u;
+        for (int l = (int) levels - 1; l >= 0; --l) {
+            Point2u cell = pixel >> (uint32_t)(l + 1);
+            UInt32 digit = (((pixel.y() >> (uint32_t) l) & 1u) << 1) |
+                            ((pixel.x() >> (uint32_t) l) & 1u);
+
+            /* Randomly permute the traversal order of the four children
+               of every cell (reflections and a transposition) */
+            UInt32 hash = sample_tea_32(tile_seed + (uint32_t) l,
+                                        (cell.y() << 16) ^ cell.x(), 2).first;
+            digit ^= hash & 3u;
+            digit = dr::select(dr::eq(hash & 4u, 0u), digit,
+                               ((digit & 1u) << 1) | (digit >> 1));
+
+            rank = (rank << 2) | digit;
+        }
+
+        m_pixel_offset = rank << log_stride;
+        m_pixel_seed = tile_seed;
+        m_has_pixel = true;
+    }
+
+    Float next_1d(Mask /*active*/ = true) override {
+        Assert(seeded());
+
+        auto [index, seed_index, seed_x, seed_y] = next_seeds();
+        UInt32 i = owen_scramble_2(index, seed_index);
+
+        return to_float(owen_scramble_2(reverse_bits_32(i), seed_x));
+    }
+
+    Point2f next_2d(Mask /*active*/ = true) override {
+        Assert(seeded());
+
+        auto [index, seed_index, seed_x, seed_y] = next_seeds();
+        UInt32 i = owen_scramble_2(index, seed_index);
+
+        return Point2f(to_float(owen_scramble_2(reverse_bits_32(i), seed_x)),
+                       to_float(owen_scramble_2(sobol_2_bits(i), seed_y)));
+    }
+
+    void schedule_state() override {
+        Base::schedule_state();
+        dr::schedule(m_scramble_seed, m_pixel_offset, m_pixel_seed);
+    }
+
+    std::string to_string() const override {
+        std::ostringstream oss;
+        oss << "SobolSampler [" << std::endl
+            << "  sample_count = " << m_sample_count << "," << std::endl
+            << "  blue_noise = " << m_blue_noise << std::endl
+            << "]";
+        return oss.str();
+    }
+
+    MI_DECLARE_CLASS()
+
+private:
+    SobolSampler(const SobolSampler &sampler) : Base(sampler) {
+        m_scramble_seed = sampler.m_scramble_seed;
+        m_pixel_offset  = sampler.m_pixel_offset;
+        m_pixel_seed    = sampler.m_pixel_seed;
+        m_shared_seed   = sampler.m_shared_seed;
+        m_blue_noise    = sampler.m_blue_noise;
+        m_has_pixel     = sampler.m_has_pixel;
+    }
+
+    /// Return the sample index and the scramble seeds of the next dimension
+    std::tuple<UInt32, UInt32, UInt32, UInt32> next_seeds() {
+        UInt32 index = current_sample_index(),
+               seed  = m_scramble_seed;
+
+        if (m_has_pixel) {
+            index += m_pixel_offset;
+            seed = m_pixel_seed;
+        }
+
+        auto [seed_index, seed_x] = sample_tea_32(seed, m_dimension_index++);
+        UInt32 seed_y = sample_tea_32(seed_x, seed_index, 2).first;
+
+        return { index, seed_index, seed_x, seed_y };
+    }
+
+    /// Convert a 32 bit fixed point value into a floating point value in [0, 1)
+    static Float to_float(const UInt32 &value) {
+        if constexpr (std::is_same_v<ScalarFloat, double>)
+            return Float(value) * Float(0x1p-32);
+        else
+            return dr::reinterpret_array<Float>(dr::sr<9>(value) | 0x3f800000u) - 1.f;
+    }
+
+    /// Per-sequence scramble seed
+    UInt32 m_scramble_seed;
+
+    /// Offset of the samples of the current pixel in the shared sequence
+    UInt32 m_pixel_offset;
+
+    /// Scramble seed of the shared sequence in the vicinity of the current pixel
+    UInt32 m_pixel_seed;
+
+    /// Seed of the sequence shared by all pixels in blue noise mode
+    uint32_t m_shared_seed = 0;
+
+    bool m_blue_noise;
+    bool m_has_pixel = false;
+};
+
+MI_IMPLEMENT_CLASS_VARIANT(SobolSampler, Sampler)
+MI_EXPORT_PLUGIN(SobolSampler, "Owen-scrambled Sobol' Sampler");
+NAMESPACE_END(mitsuba)
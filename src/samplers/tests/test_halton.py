@@ -0,0 +1,83 @@
+import pytest
+import drjit as dr
+import mitsuba as mi
+
+from .utils import check_deep_copy_sampler_scalar, check_deep_copy_sampler_wavefront
+
+
+def test01_halton_scalar(variant_scalar_rgb):
+    sampler = mi.load_dict({
+        "type" : "halton",
+        "sample_count" : 1024,
+    })
+    sampler.seed(0)
+
+    hist_1d = [0] * 16
+    hist_2d = [0] * 64
+    for i in range(1024):
+        # Base 2: every aligned prefix is stratified, also after rotation
+        hist_1d[int(sampler.next_1d() * 16)] += 1
+        # Bases 3 and 5
+        p = sampler.next_2d()
+        hist_2d[int(p.y * 8) * 8 + int(p.x * 8)] += 1
+        sampler.advance()
+
+    assert all(abs(h - 64) <= 1 for h in hist_1d)
+    assert all(abs(h - 16) <= 4 for h in hist_2d)
+
+
+def test02_halton_wavefront(variants_vec_backends_once):
+    sampler = mi.load_dict({
+        "type" : "halton",
+        "sample_count" : 1024,
+    })
+    sampler.set_samples_per_wavefront(1024)
+    sampler.seed(0, 1024)
+
+    hist_1d = dr.zeros(mi.UInt32, 16)
+    dr.scatter_reduce(dr.ReduceOp.Add, hist_1d, mi.UInt32(1),
+                      mi.UInt32(sampler.next_1d() * 16))
+
+    p = sampler.next_2d()
+    hist_2d = dr.zeros(mi.UInt32, 64)
+    dr.scatter_reduce(dr.ReduceOp.Add, hist_2d, mi.UInt32(1),
+                      mi.UInt32(p.y * 8) * 8 + mi.UInt32(p.x * 8))
+
+    assert dr.all(dr.abs(mi.Float(hist_1d) - 64) <= 1)
+    assert dr.all(dr.abs(mi.Float(hist_2d) - 16) <= 4)
+
+
+def test03_halton_high_dimensions(variants_vec_backends_once):
+    sampler = mi.load_dict({
+        "type" : "halton",
+        "sample_count" : 256,
+        "scramble" : 7
+    })
+    sampler.set_samples_per_wavefront(256)
+    sampler.seed(0, 256)
+
+    # Dimensions beyond the precomputed bases fall back to random numbers
+    for i in range(300):
+        v = sampler.next_1d()
+        assert dr.all((v >= 0) & (v < 1))
+        assert dr.allclose(dr.mean(v), 0.5, atol=0.1)
+
+
+def test04_copy_sampler_scalar(variants_any_scalar):
+    sampler = mi.load_dict({
+        "type" : "halton",
+        "sample_count" : 1024,
+    })
+    sampler.seed(0)
+
+    check_deep_copy_sampler_scalar(sampler)
+
+
+def test05_copy_sampler_wavefront(variants_vec_backends_once):
+    sampler = mi.load_dict({
+        "type" : "halton",
+        "sample_count" : 1024,
+    })
+    sampler.seed(0, 1024)
+
+    check_deep_copy_sampler_wavefront(sampler)
@@ -0,0 +1,65 @@
+import pytest
+import drjit as dr
+import mitsuba as mi
+
+from .utils import check_deep_copy_sampler_scalar, check_deep_copy_sampler_wavefront
+
+def test01_construct(variant_scalar_rgb):
+    sampler = mi.load_dict({
+        "type": "philox",
+        "sample_count": 58
+    })
+    assert sampler is not None
+    assert sampler.sample_count() == 58
+
+
+def test02_sample_vs_philox(variant_scalar_rgb):
+    sampler = mi.load_dict({
+        "type": "philox",
+        "sample_count": 8
+    })
+    sampler.seed(3)
+
+    def ref(sample, dim):
+        return [v / 2**32 for v in mi.philox_4x32([0, sample, dim, 0x8a5cd789], [0, 3])]
+
+    for sample in range(3):
+        for dim in range(0, 10, 2):
+            v = ref(sample, dim)
+            assert dr.allclose(sampler.next_1d(), v[0], rtol=1e-6, atol=1e-6)
+            v = ref(sample, dim + 1)
+            assert dr.allclose(sampler.next_2d(), [v[0], v[1]], rtol=1e-6, atol=1e-6)
+        sampler.advance()
+
+
+def test03_wavefront_matches_scalar_layout(variants_vec_backends_once):
+    sampler = mi.load_dict({
+        "type": "philox",
+        "sample_count": 4
+    })
+    sampler.set_samples_per_wavefront(4)
+    sampler.seed(0, 16)
+
+    # Lanes of the same sequence differ only in their sample index
+    idx = dr.arange(mi.UInt32, 16)
+    v = mi.philox_4x32([idx // 4, idx % 4, mi.UInt32(0), mi.UInt32(0x8a5cd789)],
+                       [mi.UInt32(0), mi.UInt32(0)])
+    assert dr.allclose(sampler.next_1d(), mi.Float(v[0] >> 9) / 2**23)
+
+
+def test04_copy_sampler_scalar(variants_any_scalar):
+    sampler = mi.load_dict({
+        "type": "philox",
+        "sample_count": 1024
+    })
+
+    check_deep_copy_sampler_scalar(sampler)
+
+
+def test05_copy_sampler_wavefront(variants_vec_backends_once):
+    sampler = mi.load_dict({
+        "type": "philox",
+        "sample_count": 1024
+    })
+
+    check_deep_copy_sampler_wavefront(sampler)
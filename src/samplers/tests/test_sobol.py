@@ -0,0 +1,82 @@
+import pytest
+import drjit as dr
+import mitsuba as mi
+
+from .utils import ( check_uniform_scalar_sampler, check_uniform_wavefront_sampler,
+                     check_deep_copy_sampler_scalar, check_deep_copy_sampler_wavefront )
+
+def test01_sobol_scalar(variant_scalar_rgb):
+    sampler = mi.load_dict({
+        "type" : "sobol",
+        "sample_count" : 1024,
+    })
+    sampler.seed(0)
+
+    check_uniform_scalar_sampler(sampler)
+
+
+def test02_sobol_wavefront(variants_vec_backends_once):
+    sampler = mi.load_dict({
+        "type" : "sobol",
+        "sample_count" : 1024,
+    })
+    sampler.seed(0, 1024)
+
+    check_uniform_wavefront_sampler(sampler)
+
+
+def test03_sobol_arbitrary_sample_count(variant_scalar_rgb):
+    sampler = mi.load_dict({
+        "type" : "sobol",
+        "sample_count" : 24,
+    })
+    assert sampler.sample_count() == 24
+
+    # Any prefix of 2^m samples should be stratified
+    sampler.seed(0)
+    hist = [0] * 16
+    for i in range(16):
+        hist[int(sampler.next_1d() * 16)] += 1
+        sampler.advance()
+    assert hist == [1] * 16
+
+
+def test04_sobol_blue_noise(variant_scalar_rgb):
+    sampler = mi.load_dict({
+        "type" : "sobol",
+        "sample_count" : 4,
+        "blue_noise" : True
+    })
+
+    # The samples of an aligned block of 2x2 pixels should jointly be stratified
+    for block in [[0, 0], [6, 2], [14, 8]]:
+        hist = [0] * 16
+        for i in range(4):
+            pixel = mi.Point2u(block[0] + i % 2, block[1] + i // 2)
+            sampler.seed(pixel.y * 16 + pixel.x)
+            for j in range(4):
+                sampler.set_pixel(pixel)
+                p = sampler.next_2d()
+                hist[int(p.y * 4) * 4 + int(p.x * 4)] += 1
+                sampler.advance()
+        assert hist == [1] * 16
+
+
+def test05_copy_sampler_scalar(variants_any_scalar):
+    sampler = mi.load_dict({
+        "type" : "sobol",
+        "sample_count" : 1024,
+    })
+    sampler.seed(0)
+
+    check_deep_copy_sampler_scalar(sampler)
+
+
+def test06_copy_sampler_wavefront(variants_vec_backends_once):
+    sampler = mi.load_dict({
+        "type" : "sobol",
+        "sample_count" : 1024,
+    })
+    sampler.seed(0, 1024)
+
+    check_deep_copy_sampler_wavefront(sampler)
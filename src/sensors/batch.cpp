@@ -19,6 +19,23 @@ Batch sensor (:monosp:`batch`)
    - Sensor Response Function that defines the :ref:`spectral sensitivity <explanation_srf_sensor>`
      of the sensor (Default: :monosp:`none`)
 
+ * - wavelength_sampling
+   - |string|
+   - Strategy used to sample the wavelengths in spectral variants. :monosp:`rgb` importance
+     samples the sensitivity of an RGB film, and :monosp:`emitters` additionally follows the
+     emission spectra of the scene's emitters. Ignored when a sensor response function is
+     specified. (Default: :monosp:`rgb`)
+
+ * - atlas
+   - |bool|
+   - Keep the resolution and crop window of every sub-sensor's film and pack
+     the views into an atlas (Default: |false|)
+
+ * - atlas_width
+   - |int|
+   - Width of the atlas in pixels. By default, a width that yields a roughly
+     square atlas is chosen.
+
 This meta-sensor groups multiple sub-sensors so that they can be rendered
 simultaneously. This reduces tracing overheads in applications that need to
 render many viewpoints, particularly in the context of differentiable
@@ -31,6 +48,19 @@ sub-sensors. In addition, all of the sub-sensors' films, samplers and shutter
 timings are typically ignored and superseded by the film, sampler and shutter
 timings specified for the `batch` sensor itself.
 
+Rigs with many cameras of different resolutions can instead enable the
+``atlas`` parameter. Every view then keeps the resolution and crop window of
+its own film, and the views are packed into the rows (shelves) of an atlas in
+the order in which they are specified: a view is placed to the right of its
+predecessor, or at the beginning of a new row if it doesn't fit into the
+remaining width. The film of the `batch` sensor is resized to the atlas, and
+its contents can be sliced into the individual views using the offsets that
+are listed by this plugin's string representation. All views are rendered in
+the same wavefront and sampled via a single indexed virtual function call.
+Since every lane of the wavefront corresponds to a pixel of the atlas, the
+tight packing keeps the number of lanes spent on unused atlas pixels (which
+receive a zero-valued sample) small regardless of how the view sizes differ.
+
 .. tabs::
     .. code-tab:: xml
         :name: batch-sensor
@@ -109,20 +139,31 @@ public:
         if (m_sensors.empty())
             Throw("BatchSensor: at least one child sensor must be specified!");
 
-        ScalarPoint2u size = m_film->size();
-        uint32_t sub_size = size.x() / (uint32_t) m_sensors.size();
-        if (sub_size * (uint32_t) m_sensors.size() != size.x())
-            Throw("BatchSensor: the horizontal resolution (currently %u) must "
-                  "be divisible by the number of child sensors (%zu)!",
-                  size.x(), m_sensors.size());
+        m_atlas = props.get<bool>("atlas", false);
+        uint32_t atlas_width = props.get<uint32_t>("atlas_width", 0);
 
         m_needs_sample_3 = false;
-        for (size_t i = 0; i < m_sensors.size(); ++i) {
-            m_sensors[i]->film()->set_size(ScalarPoint2u(sub_size, size.y()));
-            m_sensors[i]->parameters_changed();
-            m_needs_sample_3 |= m_sensors[i]->needs_aperture_sample();
+        if (m_atlas) {
+            build_atlas(atlas_width);
+        } else {
+            ScalarPoint2u size = m_film->size();
+            uint32_t sub_size = size.x() / (uint32_t) m_sensors.size();
+            if (sub_size * (uint32_t) m_sensors.size() != size.x())
+                Throw("BatchSensor: the horizontal resolution (currently %u) must "
+                      "be divisible by the number of child sensors (%zu)!",
+                      size.x(), m_sensors.size());
+
+            for (size_t i = 0; i < m_sensors.size(); ++i) {
+                m_sensors[i]->film()->set_size(ScalarPoint2u(sub_size, size.y()));
+                m_sensors[i]->parameters_changed();
+                m_view_offset.emplace_back((uint32_t) i * sub_size, 0u);
+                m_view_size.emplace_back(sub_size, size.y());
+            }
         }
 
+        for (size_t i = 0; i < m_sensors.size(); ++i)
+            m_needs_sample_3 |= m_sensors[i]->needs_aperture_sample();
+
         m_sensors_dr = dr::load<DynamicBuffer<SensorPtr>>(m_sensors.data(),
                                                           m_sensors.size());
     }
@@ -133,18 +174,14 @@ public:
                Mask active = true) const override {
         MI_MASKED_FUNCTION(ProfilerPhase::EndpointSampleRay, active);
 
-        Float  idx_f = position_sample.x() * (ScalarFloat) m_sensors.size();
-        UInt32 idx_u = UInt32(idx_f);
-
-        UInt32 index = dr::minimum(idx_u, (uint32_t) (m_sensors.size() - 1));
+        auto [index, position_sample_2, valid] =
+            lookup_view(position_sample, active);
         SensorPtr sensor = dr::gather<SensorPtr>(m_sensors_dr, index, active);
 
-
-        Point2f position_sample_2(idx_f - Float(idx_u), position_sample.y());
-
         auto [ray, spec] =
             sensor->sample_ray(time, wavelength_sample, position_sample_2,
-                               aperture_sample, active);
+                               aperture_sample, active && valid);
+        dr::masked(spec, !valid) = 0.f;
 
         /* The `m_last_index` variable **needs** to be updated after the
          * virtual function call above. In recorded JIT modes, the tracing will
@@ -164,17 +201,14 @@ public:
 
         MI_MASKED_FUNCTION(ProfilerPhase::EndpointSampleRay, active);
 
-        Float  idx_f = position_sample.x() * (ScalarFloat) m_sensors.size();
-        UInt32 idx_u = UInt32(idx_f);
-
-        UInt32 index = dr::minimum(idx_u, (uint32_t) (m_sensors.size() - 1));
+        auto [index, position_sample_2, valid] =
+            lookup_view(position_sample, active);
         SensorPtr sensor = dr::gather<SensorPtr>(m_sensors_dr, index, active);
 
-        Point2f position_sample_2(idx_f - Float(idx_u), position_sample.y());
-
         auto [ray, spec] = sensor->sample_ray_differential(
             time, wavelength_sample, position_sample_2, aperture_sample,
-            active);
+            active && valid);
+        dr::masked(spec, !valid) = 0.f;
 
         /* The `m_last_index` variable **needs** to be updated after the
          * virtual function call above. In recorded JIT modes, the tracing will
@@ -202,7 +236,7 @@ public:
                 Mask active_i = active && dr::eq(m_last_index, i);
                 auto [rv_1, rv_2] =
                     m_sensors[i]->sample_direction(it, sample, active_i);
-                rv_1.uv.x() += i * m_sensors[i]->film()->size().x();
+                to_atlas(rv_1, rv_2, i);
                 result_1[active_i] = rv_1;
                 result_2[active_i] = rv_2;
             }
@@ -214,7 +248,7 @@ public:
             for (size_t i = 0; i < m_sensors.size(); ++i) {
                 auto [rv_1, rv_2] =
                     m_sensors[i]->sample_direction(it, sample_, active);
-                rv_1.uv.x() += i * m_sensors[i]->film()->size().x();
+                to_atlas(rv_1, rv_2, i);
 
                 Mask active_i = active && dr::neq(rv_1.pdf, 0.f);
                 valid_count += dr::select(active_i, 1u, 0u);
@@ -268,11 +302,160 @@ public:
         return result;
     }
 
+    std::string to_string() const override {
+        std::ostringstream oss;
+        oss << "BatchSensor[" << std::endl
+            << "  atlas = " << m_atlas << "," << std::endl
+            << "  film_size = " << m_film->size() << "," << std::endl
+            << "  views = [" << std::endl;
+        for (size_t i = 0; i < m_sensors.size(); ++i)
+            oss << "    { offset = " << m_view_offset[i] << ", size = "
+                << m_view_size[i] << " }" << (i + 1 < m_sensors.size() ? "," : "")
+                << std::endl;
+        oss << "  ]" << std::endl
+            << "]";
+        return oss.str();
+    }
+
     MI_DECLARE_CLASS()
+private:
+    /**
+     * Pack the views into the shelves of an atlas (in the order in which they
+     * were specified) and resize the film accordingly
+     */
+    void build_atlas(uint32_t width) {
+        uint64_t area = 0;
+        uint32_t max_width = 0;
+        for (auto &sensor : m_sensors) {
+            ScalarVector2u size = sensor->film()->crop_size();
+            area += (uint64_t) dr::prod(size);
+            max_width = std::max(max_width, size.x());
+        }
+
+        // By default, aim for a roughly square atlas
+        if (width == 0)
+            width = (uint32_t) std::ceil(std::sqrt((double) area));
+        width = std::max(width, max_width);
+
+        uint32_t x = 0, y = 0, shelf_height = 0;
+        std::vector<uint32_t> shelf_y, view_keys;
+        for (auto &sensor : m_sensors) {
+            ScalarVector2u size = sensor->film()->crop_size();
+
+            // Start a new shelf if the view doesn't fit into the current one
+            if (shelf_y.empty() || x + size.x() > width) {
+                y += shelf_height;
+                x = shelf_height = 0;
+                shelf_y.push_back(y);
+            }
+
+            m_view_offset.emplace_back(x, y);
+            m_view_size.push_back(size);
+            view_keys.push_back((uint32_t) (shelf_y.size() - 1) * width + x);
+
+            x += size.x();
+            shelf_height = std::max(shelf_height, size.y());
+        }
+
+        ScalarVector2u atlas_size(width, y + shelf_height);
+        m_film->set_size(atlas_size);
+
+        std::vector<uint32_t> rects;
+        for (size_t i = 0; i < m_sensors.size(); ++i) {
+            rects.insert(rects.end(), { m_view_offset[i].x(), m_view_offset[i].y(),
+                                        m_view_size[i].x(), m_view_size[i].y() });
+        }
+
+        m_shelf_y   = dr::load<DynamicBuffer<UInt32>>(shelf_y.data(), shelf_y.size());
+        m_view_keys = dr::load<DynamicBuffer<UInt32>>(view_keys.data(), view_keys.size());
+        m_view_rects = dr::load<DynamicBuffer<UInt32>>(rects.data(), rects.size());
+        m_atlas_width = width;
+
+        Log(Debug, "BatchSensor: packed %zu views into a %ux%u atlas (%.1f%% "
+                   "of the pixels are used).", m_sensors.size(), atlas_size.x(),
+            atlas_size.y(), 100.0 * area / (double) dr::prod(atlas_size));
+    }
+
+    /// Map the film position of a direction sample of view \c i onto the film of this sensor
+    void to_atlas(DirectionSample3f &ds, Spectrum &weight, size_t i) const {
+        ScalarPoint2f lo(m_view_offset[i]),
+                      hi = lo + ScalarVector2f(m_view_size[i]);
+
+        // Sub-sensors report positions relative to their full film
+        ds.uv += lo - ScalarPoint2f(m_sensors[i]->film()->crop_offset());
+
+        if (m_atlas) {
+            Mask outside = dr::any(ds.uv < lo || ds.uv >= hi);
+            dr::masked(ds.pdf, outside) = 0.f;
+            dr::masked(weight, outside) = 0.f;
+        }
+    }
+
+    /**
+     * Determine the view that contains a position on the film, along with the
+     * position relative to the view and whether it lies within the view at
+     * all (unused pixels of an atlas don't).
+     */
+    std::tuple<UInt32, Point2f, Mask> lookup_view(const Point2f &position_sample,
+                                                  Mask active) const {
+        if (!m_atlas) {
+            Float  idx_f = position_sample.x() * (ScalarFloat) m_sensors.size();
+            UInt32 idx_u = UInt32(idx_f);
+
+            UInt32 index = dr::minimum(idx_u, (uint32_t) (m_sensors.size() - 1));
+            return { index,
+                     Point2f(idx_f - Float(idx_u), position_sample.y()),
+                     true };
+        }
+
+        ScalarVector2u film_size = m_film->size();
+        Point2f pos = position_sample * ScalarVector2f(film_size);
+        Point2u pixel = Point2u(dr::clamp(Point2i(dr::floor2int<Point2i>(pos)), 0,
+                                          ScalarPoint2i(film_size) - 1));
+
+        uint32_t shelf_count = (uint32_t) dr::width(m_shelf_y),
+                 view_count  = (uint32_t) m_sensors.size();
+
+        UInt32 shelf = dr::binary_search<UInt32>(
+            0, shelf_count,
+            [&](UInt32 idx) DRJIT_INLINE_LAMBDA {
+                return dr::gather<UInt32>(m_shelf_y, idx, active) <= pixel.y();
+            }
+        ) - 1;
+
+        UInt32 key = shelf * m_atlas_width + pixel.x();
+        UInt32 index = dr::binary_search<UInt32>(
+            0, view_count,
+            [&](UInt32 idx) DRJIT_INLINE_LAMBDA {
+                return dr::gather<UInt32>(m_view_keys, idx, active) <= key;
+            }
+        ) - 1;
+
+        Vector4u rect = dr::gather<Vector4u>(m_view_rects, index, active);
+        Point2u offset(rect.x(), rect.y());
+        Vector2u size(rect.z(), rect.w());
+
+        Mask valid = dr::all(pixel - offset < size);
+
+        return { index, (pos - Point2f(offset)) / Vector2f(size), valid };
+    }
+
 private:
     std::vector<ref<Base>> m_sensors;
     DynamicBuffer<SensorPtr> m_sensors_dr;
     mutable UInt32 m_last_index;
+
+    /// Pack views with individual resolutions into an atlas?
+    bool m_atlas;
+
+    /// Position and resolution of every view on the film
+    std::vector<ScalarPoint2u> m_view_offset;
+    std::vector<ScalarVector2u> m_view_size;
+
+    /// Lookup structures of the atlas (y offset of each shelf, the key
+    /// <tt>shelf * width + x</tt> of each view, and the view rectangles)
+    DynamicBuffer<UInt32> m_shelf_y, m_view_keys, m_view_rects;
+    uint32_t m_atlas_width = 0;
 };
 
 MI_IMPLEMENT_CLASS_VARIANT(BatchSensor, Sensor)
@@ -48,6 +48,13 @@ Distant radiancemeter sensor (:monosp:`distant`)
    - Sensor Response Function that defines the :ref:`spectral sensitivity <explanation_srf_sensor>`
      of the sensor (Default: :monosp:`none`)
 
+ * - wavelength_sampling
+   - |string|
+   - Strategy used to sample the wavelengths in spectral variants. :monosp:`rgb` importance
+     samples the sensitivity of an RGB film, and :monosp:`emitters` additionally follows the
+     emission spectra of the scene's emitters. Ignored when a sensor response function is
+     specified. (Default: :monosp:`rgb`)
+
 This sensor plugin implements a distant directional sensor which records
 radiation leaving the scene in a given direction. It records the spectral
 radiance leaving the scene in the specified direction. It is the adjoint to the
@@ -183,6 +190,7 @@ public:
     }
 
     void set_scene(const Scene *scene) override {
+        Base::set_scene(scene);
         m_bsphere = scene->bbox().bounding_sphere();
         m_bsphere.radius =
             dr::maximum(math::RayEpsilon<Float>,
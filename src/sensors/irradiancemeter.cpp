@@ -21,6 +21,13 @@ Irradiance meter (:monosp:`irradiancemeter`)
    - Sensor Response Function that defines the :ref:`spectral sensitivity <explanation_srf_sensor>`
      of the sensor (Default: :monosp:`none`)
 
+ * - wavelength_sampling
+   - |string|
+   - Strategy used to sample the wavelengths in spectral variants. :monosp:`rgb` importance
+     samples the sensitivity of an RGB film, and :monosp:`emitters` additionally follows the
+     emission spectra of the scene's emitters. Ignored when a sensor response function is
+     specified. (Default: :monosp:`rgb`)
+
 This sensor plugin implements an irradiance meter, which measures
 the incident power per unit area over a shape which it is attached to.
 This sensor is used with films of 1 by 1 pixels.
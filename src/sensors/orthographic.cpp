@@ -31,6 +31,13 @@ Orthographic camera (:monosp:`orthographic`)
    - Sensor Response Function that defines the :ref:`spectral sensitivity <explanation_srf_sensor>`
      of the sensor (Default: :monosp:`none`)
 
+ * - wavelength_sampling
+   - |string|
+   - Strategy used to sample the wavelengths in spectral variants. :monosp:`rgb` importance
+     samples the sensitivity of an RGB film, and :monosp:`emitters` additionally follows the
+     emission spectra of the scene's emitters. Ignored when a sensor response function is
+     specified. (Default: :monosp:`rgb`)
+
 
 .. subfigstart::
 .. subfigure:: ../../resources/data/docs/images/render/sensor_orthographic.jpg
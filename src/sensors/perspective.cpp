@@ -65,6 +65,13 @@ Perspective pinhole camera (:monosp:`perspective`)
    - Sensor Response Function that defines the :ref:`spectral sensitivity <explanation_srf_sensor>`
      of the sensor (Default: :monosp:`none`)
 
+ * - wavelength_sampling
+   - |string|
+   - Strategy used to sample the wavelengths in spectral variants. :monosp:`rgb` importance
+     samples the sensitivity of an RGB film, and :monosp:`emitters` additionally follows the
+     emission spectra of the scene's emitters. Ignored when a sensor response function is
+     specified. (Default: :monosp:`rgb`)
+
  * - x_fov
    - |float|
    - Denotes the camera's field of view in degrees along the horizontal axis.
@@ -0,0 +1,244 @@
+#include <mitsuba/core/fwd.h>
+#include <mitsuba/core/plugin.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/warp.h>
+#include <mitsuba/render/film.h>
+#include <mitsuba/render/fwd.h>
+#include <mitsuba/render/sensor.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**!
+
+.. _sensor-probes:
+
+Probe array (:monosp:`probes`)
+------------------------------
+
+.. pluginparameters::
+
+ * - origins
+   - |tensor|
+   - Tensor of shape ``(N, 3)`` with the world-space positions of the probes.
+   - |exposed|
+
+ * - directions
+   - |tensor|
+   - Tensor of shape ``(N, 3)`` with the viewing direction (``radiance`` mode)
+     or surface normal (``irradiance`` mode) of every probe.
+   - |exposed|
+
+ * - mode
+   - |string|
+   - Quantity measured by the probes: ``radiance`` along a ray, like the
+     :ref:`radiancemeter <sensor-radiancemeter>` plugin, or ``irradiance``
+     at a point, like the :ref:`irradiancemeter <sensor-irradiancemeter>`
+     plugin. (Default: ``radiance``)
+
+ * - srf
+   - |spectrum|
+   - Sensor Response Function that defines the :ref:`spectral sensitivity <explanation_srf_sensor>`
+     of the sensor (Default: :monosp:`none`)
+
+ * - wavelength_sampling
+   - |string|
+   - Strategy used to sample the wavelengths in spectral variants. :monosp:`rgb` importance
+     samples the sensitivity of an RGB film, and :monosp:`emitters` additionally follows the
+     emission spectra of the scene's emitters. Ignored when a sensor response function is
+     specified. (Default: :monosp:`rgb`)
+
+This sensor simulates a large collection of point probes (e.g. lidar returns
+or sensor arrays) at once. Instead of creating a separate radiance or
+irradiance meter with a 1x1 film per probe and rendering the scene once for
+each of them, all probes are rendered within a single wavefront.
+
+Every probe corresponds to one pixel of a film of resolution ``N`` by 1, which
+is created automatically (using a :ref:`box <rfilter-box>` filter) unless a
+film is specified explicitly. Rendering hence directly returns a tensor of
+shape ``(1, N, channels)`` holding the measurement of every probe. The probe
+positions and directions are exposed as scene parameters and can be updated
+between renders without reloading the scene; the film is resized when the
+number of probes changes.
+
+This plugin is incompatible with the particle tracer.
+
+.. tabs::
+    .. code-tab:: python
+
+        'type': 'probes',
+        'mode': 'radiance',
+        'origins': mi.TensorXf(origins),       # shape (N, 3)
+        'directions': mi.TensorXf(directions)  # shape (N, 3)
+
+*/
+
+MI_VARIANT class ProbeArray final : public Sensor<Float, Spectrum> {
+public:
+    MI_IMPORT_BASE(Sensor, m_film, m_resolution, m_needs_sample_2,
+                   m_needs_sample_3, sample_wavelengths)
+    MI_IMPORT_TYPES(ReconstructionFilter)
+
+    using FloatStorage = DynamicBuffer<Float>;
+
+    ProbeArray(const Properties &props) : Base(props) {
+        std::string mode = props.string("mode", "radiance");
+        if (mode == "radiance")
+            m_irradiance = false;
+        else if (mode == "irradiance")
+            m_irradiance = true;
+        else
+            Throw("ProbeArray: invalid mode \"%s\", must be \"radiance\" or "
+                  "\"irradiance\"!", mode);
+
+        m_origins    = load_points(props, "origins");
+        m_directions = load_points(props, "directions");
+
+        bool has_film = false;
+        for (auto &[name, obj] : props.objects(false))
+            has_film |= dynamic_cast<Film *>(obj.get()) != nullptr;
+
+        if (!has_film) {
+            // Replace the default film by one with a pixel per probe
+            auto pmgr = PluginManager::instance();
+            Properties props_film("hdrfilm");
+            props_film.set_int("width", 1);
+            props_film.set_int("height", 1);
+            props_film.set_object(
+                "rfilter",
+                pmgr->create_object<ReconstructionFilter>(Properties("box")));
+            m_film = static_cast<Film *>(pmgr->create_object<Film>(props_film));
+        }
+
+        if (m_film->rfilter()->radius() > 0.5f + math::RayEpsilon<Float>)
+            Log(Warn, "This sensor should be used with a reconstruction filter "
+                      "with a radius of 0.5 or lower (e.g. default box)");
+
+        update();
+
+        // The position sample selects the probe, the aperture sample is only
+        // needed to sample the hemisphere of irradiance probes
+        m_needs_sample_2 = true;
+        m_needs_sample_3 = m_irradiance;
+    }
+
+    std::pair<Ray3f, Spectrum> sample_ray(Float time, Float wavelength_sample,
+                                          const Point2f &position_sample,
+                                          const Point2f &aperture_sample,
+                                          Mask active) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::EndpointSampleRay, active);
+
+        // 1. Look up the probe
+        UInt32 index = dr::minimum(UInt32(position_sample.x() * (ScalarFloat) m_count),
+                                   m_count - 1);
+        Point3f o  = dr::gather<Point3f>(m_origins, index, active);
+        Vector3f d = dr::normalize(dr::gather<Vector3f>(m_directions, index, active));
+
+        // 2. Sample spectrum
+        auto [wavelengths, wav_weight] =
+            sample_wavelengths(dr::zeros<SurfaceInteraction3f>(),
+                               wavelength_sample,
+                               active);
+
+        // 3. Sample the hemisphere around the normal of irradiance probes
+        if (m_irradiance) {
+            d = Frame3f(d).to_world(
+                warp::square_to_cosine_hemisphere(aperture_sample));
+            wav_weight *= dr::Pi<ScalarFloat>;
+        }
+
+        Ray3f ray(o + d * math::RayEpsilon<Float>, d, time, wavelengths);
+        return { ray, wav_weight };
+    }
+
+    std::pair<RayDifferential3f, Spectrum>
+    sample_ray_differential(Float time, Float wavelength_sample,
+                            const Point2f &position_sample,
+                            const Point2f &aperture_sample,
+                            Mask active) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::EndpointSampleRay, active);
+
+        auto [ray, weight] = sample_ray(time, wavelength_sample,
+                                        position_sample, aperture_sample,
+                                        active);
+
+        // Probes are points, hence there are no differentials
+        RayDifferential3f ray_diff(ray);
+        ray_diff.has_differentials = false;
+
+        return { ray_diff, weight };
+    }
+
+    ScalarBoundingBox3f bbox() const override {
+        // Return an invalid bounding box
+        return ScalarBoundingBox3f();
+    }
+
+    void traverse(TraversalCallback *callback) override {
+        Base::traverse(callback);
+        callback->put_parameter("origins",    m_origins,    +ParamFlags::NonDifferentiable);
+        callback->put_parameter("directions", m_directions, +ParamFlags::NonDifferentiable);
+    }
+
+    void parameters_changed(const std::vector<std::string> &keys) override {
+        if (keys.empty() || string::contains(keys, "origins") ||
+            string::contains(keys, "directions"))
+            update();
+        Base::parameters_changed(keys);
+    }
+
+    std::string to_string() const override {
+        std::ostringstream oss;
+        oss << "ProbeArray[" << std::endl
+            << "  mode = " << (m_irradiance ? "irradiance" : "radiance") << "," << std::endl
+            << "  probe_count = " << m_count << "," << std::endl
+            << "  film = " << string::indent(m_film) << std::endl
+            << "]";
+        return oss.str();
+    }
+
+    MI_DECLARE_CLASS()
+
+private:
+    /// Load a tensor of shape (N, 3) into a flat buffer
+    static FloatStorage load_points(const Properties &props, const std::string &name) {
+        if (!props.has_property(name))
+            Throw("ProbeArray: the \"%s\" parameter must be specified!", name);
+
+        const TensorXf *tensor = props.tensor<TensorXf>(name);
+        if (tensor->ndim() != 2 || tensor->shape(1) != 3)
+            Throw("ProbeArray: \"%s\" must be a tensor of shape (N, 3)!", name);
+
+        return FloatStorage(tensor->array());
+    }
+
+    /// Check the probe arrays and size the film accordingly
+    void update() {
+        size_t count = dr::width(m_origins) / 3;
+        if (count == 0 || dr::width(m_origins) != 3 * count)
+            Throw("ProbeArray: expected a non-empty array of 3D origins!");
+        if (dr::width(m_directions) != dr::width(m_origins))
+            Throw("ProbeArray: the number of directions (%zu) does not match "
+                  "the number of origins (%zu)!",
+                  dr::width(m_directions) / 3, count);
+        if (count > 0xffffffffu)
+            Throw("ProbeArray: too many probes!");
+
+        m_count = (uint32_t) count;
+        if (m_film->size() != ScalarVector2u(m_count, 1u))
+            m_film->set_size(ScalarVector2u(m_count, 1u));
+        m_resolution = ScalarVector2f(m_film->crop_size());
+    }
+
+    /// Probe positions and directions (flattened arrays of 3D vectors)
+    FloatStorage m_origins, m_directions;
+
+    /// Number of probes
+    uint32_t m_count = 0;
+
+    /// Measure irradiance instead of radiance?
+    bool m_irradiance;
+};
+
+MI_IMPLEMENT_CLASS_VARIANT(ProbeArray, Sensor)
+MI_EXPORT_PLUGIN(ProbeArray, "ProbeArray");
+NAMESPACE_END(mitsuba)
@@ -35,6 +35,13 @@ Radiance meter (:monosp:`radiancemeter`)
    - Sensor Response Function that defines the :ref:`spectral sensitivity <explanation_srf_sensor>`
      of the sensor (Default: :monosp:`none`)
 
+ * - wavelength_sampling
+   - |string|
+   - Strategy used to sample the wavelengths in spectral variants. :monosp:`rgb` importance
+     samples the sensitivity of an RGB film, and :monosp:`emitters` additionally follows the
+     emission spectra of the scene's emitters. Ignored when a sensor response function is
+     specified. (Default: :monosp:`rgb`)
+
 This sensor plugin implements a simple radiance meter, which measures
 the incident power per unit area per unit solid angle along a
 certain ray. It can be thought of as the limit of a standard
@@ -106,3 +106,47 @@ def test02_sample_ray(variants_vec_spectral, s_open, s_time):
     print(f"{ray.d=}")
     print(f"{direction=}")
     assert dr.allclose(ray.d, direction, atol=1e-7)
+
+
+def test03_atlas(variants_all_rgb):
+    def sensor(o, d, width, height):
+        return {
+            'type': 'perspective',
+            'to_world': mi.ScalarTransform4f.look_at(
+                origin=o,
+                target=[o[i] + d[i] for i in range(3)],
+                up=[0, 1, 0]
+            ),
+            'film': { 'type': 'hdrfilm', 'width': width, 'height': height }
+        }
+
+    scene = mi.load_dict({
+        'type': 'scene',
+        'sensor': {
+            'type': 'batch',
+            'atlas': True,
+            'sensor_0': sensor(origins[0], directions[0], 64, 32),
+            'sensor_1': sensor(origins[1], directions[1], 32, 48),
+            'film': {
+                'type': 'hdrfilm',
+                'width': 1,
+                'height': 1,
+                'rfilter': { 'type': 'box' }
+            }
+        },
+        'emitter': { 'type': 'constant' }
+    })
+
+    # The second view doesn't fit next to the first one and starts a new shelf
+    film = scene.sensors()[0].film()
+    assert dr.all(film.size() == [64, 80])
+
+    image = mi.render(scene, spp=4)
+    assert image.shape[0] == 80 and image.shape[1] == 64
+
+    image = mi.TensorXf(image)
+    assert dr.allclose(image[:32, :, :3], 1.0)
+    assert dr.allclose(image[32:, :32, :3], 1.0)
+
+    # Unused atlas pixels receive zero-valued samples
+    assert dr.allclose(image[32:, 32:, :3], 0.0)
@@ -198,3 +198,39 @@ def test05_spectrum_sampling(variants_vec_spectral):
                 }
             }
         })
+
+
+def test06_emitter_wavelength_sampling(variants_vec_spectral):
+    scene = mi.load_dict({
+        'type': 'scene',
+        'sensor': {
+            'type': 'perspective',
+            'wavelength_sampling': 'emitters'
+        },
+        'emitter': {
+            'type': 'constant',
+            'radiance': {
+                'type': 'spectrum',
+                'value': [(540, 0.0), (550, 1.0), (560, 1.0), (570, 0.0)]
+            }
+        }
+    })
+    camera = scene.sensors()[0]
+
+    n = 10000
+    sample = (dr.arange(mi.Float, n) + 0.5) / n
+    wavelengths, weight = camera.sample_wavelengths(dr.zeros(mi.SurfaceInteraction3f), sample)
+    assert dr.all_nested((wavelengths >= mi.MI_CIE_MIN) & (wavelengths <= mi.MI_CIE_MAX))
+
+    # Most wavelengths follow the emission spectrum
+    inside = (wavelengths >= 535) & (wavelengths <= 575)
+    assert dr.mean(dr.mean(dr.select(inside, 1.0, 0.0))) > 0.6
+
+    # The weights are unbiased inverse densities over the CIE range
+    assert dr.allclose(dr.mean(dr.mean(weight)), mi.MI_CIE_MAX - mi.MI_CIE_MIN, rtol=2e-2)
+
+    with pytest.raises(RuntimeError, match=r'wavelength sampling'):
+        mi.load_dict({
+            'type': 'perspective',
+            'wavelength_sampling': 'uniform'
+        })
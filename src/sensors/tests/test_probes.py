@@ -0,0 +1,79 @@
+import pytest
+import drjit as dr
+import mitsuba as mi
+
+
+def probes_dict(mode, origins, directions):
+    return {
+        'type': 'probes',
+        'mode': mode,
+        'origins': mi.TensorXf(origins),
+        'directions': mi.TensorXf(directions),
+    }
+
+
+def test01_construct(variants_all_rgb, np_rng):
+    origins = np_rng.random((10, 3))
+    directions = np_rng.random((10, 3)) - 0.5
+    sensor = mi.load_dict(probes_dict('radiance', origins, directions))
+
+    # The film is automatically sized to one pixel per probe
+    assert dr.all(sensor.film().size() == [10, 1])
+
+    with pytest.raises(RuntimeError, match='tensor of shape'):
+        mi.load_dict(probes_dict('radiance', origins[:, :2], directions[:, :2]))
+
+    with pytest.raises(RuntimeError, match='does not match'):
+        mi.load_dict(probes_dict('radiance', origins, directions[:5]))
+
+    with pytest.raises(RuntimeError, match='invalid mode'):
+        mi.load_dict(probes_dict('flux', origins, directions))
+
+
+def test02_sample_ray(variant_scalar_rgb, np_rng):
+    origins = np_rng.random((8, 3))
+    directions = np_rng.random((8, 3)) - 0.5
+    sensor = mi.load_dict(probes_dict('radiance', origins, directions))
+
+    for i in range(8):
+        ray, _ = sensor.sample_ray(0.0, 0.5, [(i + 0.5) / 8, 0.5], [0.5, 0.5])
+        d = mi.ScalarVector3f(directions[i])
+        assert dr.allclose(ray.o, origins[i], atol=1e-4)
+        assert dr.allclose(ray.d, dr.normalize(d))
+
+    # Irradiance probes sample the hemisphere around the normal
+    sensor = mi.load_dict(probes_dict('irradiance', origins, directions))
+    for i in range(8):
+        ray, weight = sensor.sample_ray(0.0, 0.5, [(i + 0.5) / 8, 0.5],
+                                        np_rng.random(2))
+        n = dr.normalize(mi.ScalarVector3f(directions[i]))
+        assert dr.dot(ray.d, n) >= 0
+        assert dr.allclose(weight, dr.pi)
+
+
+@pytest.mark.parametrize('mode, expected', [('radiance', 1.0),
+                                            ('irradiance', dr.pi)])
+def test03_render(variants_vec_rgb, mode, expected, np_rng):
+    n = 32
+    origins = np_rng.random((n, 3))
+    directions = np_rng.random((n, 3)) - 0.5
+
+    scene = mi.load_dict({
+        'type': 'scene',
+        'sensor': probes_dict(mode, origins, directions),
+        'emitter': {'type': 'constant'},
+        'integrator': {'type': 'path'},
+    })
+
+    image = mi.render(scene, spp=16)
+    assert image.shape == (1, n, 3)
+    assert dr.allclose(image, expected, rtol=1e-3)
+
+    # Changing the number of probes resizes the film
+    params = mi.traverse(scene)
+    params['sensor.origins'] = mi.Float(origins[:n // 2].ravel())
+    params['sensor.directions'] = mi.Float(directions[:n // 2].ravel())
+    params.update()
+
+    image = mi.render(scene, spp=16)
+    assert image.shape == (1, n // 2, 3)
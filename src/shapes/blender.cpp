@@ -1,7 +1,13 @@
+#include <mitsuba/core/hash.h>
+#include <mitsuba/core/string.h>
+#include <mitsuba/core/thread.h>
 #include <mitsuba/core/util.h>
 #include <mitsuba/render/mesh.h>
 #include <drjit/color.h>
+#include <nanothread/nanothread.h>
 #include <array>
+#include <atomic>
+#include <memory>
 
 // Blender Mesh format types for the exporter
 NAMESPACE_BEGIN(blender)
@@ -68,6 +74,15 @@ Blender mesh loader
 This plugins converts a Blender Mesh to mitsuba's mesh layout. It is used in the Blender exporter Add-on.
 It expects as input pointers to Blender mesh data structures, see GeometryExporter.save_mesh
 in the mitsuba2-blender addon for an example.
+
+The triangles are processed in parallel. Corners that share a Blender vertex, normal and UV
+are merged into a single vertex using a concurrent hash table, and the vertex data is written
+directly into buffers of its final size.
+
+When only the vertex positions of the Blender mesh change (e.g. during an animation preview),
+the mesh can be updated without reloading it. Set the ``blender_vertex_positions`` parameter
+to the flattened (untransformed) positions of all vertices of the Blender mesh and call
+``params.update()``. The split vertices and the mesh topology are kept as they are.
  */
 
 template <typename Float, typename Spectrum>
@@ -90,8 +105,6 @@ public:
     using typename Base::FloatStorage;
     using Version = util::Version;
 
-    using ScalarIndex3 = std::array<ScalarIndex, 3>;
-
     /**
     * This constructor created a Mesh object from the part of a blender mesh assigned to a certain material.
     * This allows exporting meshes with multiple materials.
@@ -188,255 +201,403 @@ public:
             }
         }
 
-        // Temporary buffers for vertices, normals, etc.
-        std::vector<std::array<InputFloat, 3>> tmp_vertices; // Store as vector for alignment issues
-        std::vector<std::array<InputFloat, 3>> tmp_normals; // Same here
-        std::vector<InputVector2f> tmp_uvs;
-        std::vector<std::vector<InputFloat>> tmp_cols; // And same here
-        std::vector<ScalarIndex3> tmp_triangles;
-
-        tmp_vertices.reserve(vertex_count);
-        if (!m_face_normals)
-            tmp_normals.reserve(vertex_count);
-        tmp_triangles.reserve(loop_tri_count);
-
-        if (has_uvs)
-            tmp_uvs.reserve(vertex_count);
-        if (has_cols) {
-            tmp_cols.reserve(cols.size());
-            for (size_t p = 0; p < cols.size(); p++) {
-                tmp_cols.push_back(std::vector<InputFloat>());
-                tmp_cols[p].reserve(3 * vertex_count);
-            }
-        }
-
-        ScalarIndex vertex_ctr = 0;
-
-        // Hash map key to define a unique vertex
-        struct Key {
-            InputNormal3f normal;
-            bool smooth{ false };
-            size_t poly{ 0 }; // store the polygon face for flat shading, since
-                              // comparing normals is ambiguous due to numerical
-                              // precision
-            InputVector2f uv{ 0.0f, 0.0f };
-            bool operator==(const Key &other) const {
-                return (smooth ? normal == other.normal : poly == other.poly) &&
-                       uv == other.uv;
-            }
-            bool operator!=(const Key &other) const {
-                return (smooth ? normal != other.normal : poly != other.poly) ||
-                       uv != other.uv;
-            }
+        auto vertex_coords = [&](size_t vert_index) -> const float * {
+            if (version <= Version(3, 0, 0))
+                return verts_old_2[vert_index].co; // Blender 2.xx - 3.0
+            else if (version >= Version(3, 1, 0) && version <= Version(3, 4, 0))
+                return verts_old_3[vert_index].co; // Blender 3.1 - 3.4
+            else
+                return verts[vert_index];          // Blender 3.5+
         };
 
-        // Hash map entry
-        struct VertexBinding {
-            Key key;
-            // Index of the vertex in the vertex array
-            ScalarIndex value{ 0 };
-            VertexBinding *next{ nullptr };
-            bool is_init{ false };
+        /* 1. Gather the corners of all triangles of the given material in
+              parallel, along with their (transformed) normal and UV */
+        size_t corner_count = loop_tri_count * 3,
+               block_count  = std::max<size_t>(
+                   1, std::min<size_t>(loop_tri_count / 16384,
+                                       4 * Thread::thread_count())),
+               block_size   = (loop_tri_count + block_count - 1) / block_count;
+
+        std::vector<Corner> corners(corner_count);
+        std::vector<uint8_t> valid(loop_tri_count, 0);
+        std::atomic<size_t> invalid_vertex(0);
+        std::atomic<bool> invalid_normal(false);
+        ThreadEnvironment env;
+
+        auto parallel_blocks = [&](auto &&func) {
+            dr::parallel_for(
+                dr::blocked_range<size_t>(0, block_count, 1),
+                [&](const dr::blocked_range<size_t> &range) {
+                    ScopedSetThreadEnvironment set_env(env);
+                    for (size_t b = range.begin(); b != range.end(); ++b)
+                        func(b, b * block_size,
+                             std::min(loop_tri_count, (b + 1) * block_size));
+                }
+            );
         };
 
-        // Hash Map to avoid adding duplicate vertices
-        std::vector<VertexBinding> vertex_map(vertex_count);
-
-        size_t duplicates_ctr = 0;
-        for (size_t tri_loop_id = 0; tri_loop_id < loop_tri_count; tri_loop_id++) {
-            int face_id;
-            if (version >= Version(3, 6, 0))
-                face_id = polys[tri_loop_id];
-             else
-                face_id = tri_loops_old[tri_loop_id].poly;
-
-            // We only export the part of the mesh corresponding to the given
-            // material id
-            if (version >= Version(3, 4, 0) && mat_indices != nullptr && mat_indices[face_id] != mat_nr)
-                continue;
-            else if (version < Version(3, 4, 0)) {
-                if (polys_old[face_id].mat_nr != mat_nr)
-                    continue;
-            }
-
-            ScalarIndex3 triangle;
-
-            int v0, v1, v2;
-            if (version >= Version(3, 6, 0)) {
-                const unsigned int *tri_loop = tri_loops[tri_loop_id];
-                v0 = loops[tri_loop[0]];
-                v1 = loops[tri_loop[1]];
-                v2 = loops[tri_loop[2]];
-            } else {
-                const blender::MLoopTri &tri_loop = tri_loops_old[tri_loop_id];
-                v0 = loops_old[tri_loop.tri[0]].v;
-                v1 = loops_old[tri_loop.tri[1]].v;
-                v2 = loops_old[tri_loop.tri[2]].v;
-            }
-
-            const float *co_0, *co_1, *co_2;
-            if (version <= Version(3, 0, 0)) {
-                // Blender 2.xx - 3.0
-                co_0 = verts_old_2[v0].co;
-                co_1 = verts_old_2[v1].co;
-                co_2 = verts_old_2[v2].co;
-            } else if (version >= Version(3, 1, 0) && version <= Version(3, 4, 0)) {
-                // Blender 3.1 - 3.4
-                co_0 = verts_old_3[v0].co;
-                co_1 = verts_old_3[v1].co;
-                co_2 = verts_old_3[v2].co;
-            } else {
-                // Blender 3.5+
-                co_0 = verts[v0];
-                co_1 = verts[v1];
-                co_2 = verts[v2];
-            }
+        parallel_blocks([&](size_t, size_t begin, size_t end) {
+            for (size_t tri_loop_id = begin; tri_loop_id < end; tri_loop_id++) {
+                int face_id;
+                if (version >= Version(3, 6, 0))
+                    face_id = polys[tri_loop_id];
+                else
+                    face_id = tri_loops_old[tri_loop_id].poly;
 
-            dr::Array<InputPoint3f, 3> face_points;
-            face_points[0] = InputPoint3f(co_0[0], co_0[1], co_0[2]);
-            face_points[1] = InputPoint3f(co_1[0], co_1[1], co_1[2]);
-            face_points[2] = InputPoint3f(co_2[0], co_2[1], co_2[2]);
+                // We only export the part of the mesh corresponding to the given
+                // material id
+                if (version >= Version(3, 4, 0) && mat_indices != nullptr && mat_indices[face_id] != mat_nr)
+                    continue;
+                else if (version < Version(3, 4, 0)) {
+                    if (polys_old[face_id].mat_nr != mat_nr)
+                        continue;
+                }
 
-            InputNormal3f normal(0.f);
-            bool smooth_face;
-            if (version >= Version(3, 6, 0)) {
-                // Blender 3.6+ layout
-                smooth_face = sharp_faces == nullptr || !sharp_faces[face_id];
-            } else {
-                smooth_face = blender::ME_SMOOTH & polys_old[face_id].flag;
-            }
-            if (!smooth_face && !m_face_normals) {
-                // Flat shading, use per face normals (only if the mesh is not globally flat)
-                const InputVector3f e1 = face_points[1] - face_points[0];
-                const InputVector3f e2 = face_points[2] - face_points[0];
-                normal = m_to_world.scalar().transform_affine(dr::cross(e1, e2));
-                if(unlikely(dr::all(dr::eq(normal, 0.f))))
-                    continue; // Degenerate triangle, ignore it
-                else
-                    normal = dr::normalize(normal);
-            }
+                Corner *corner = corners.data() + 3 * tri_loop_id;
+                for (int i = 0; i < 3; i++) {
+                    if (version >= Version(3, 6, 0)) {
+                        corner[i].loop = tri_loops[tri_loop_id][i];
+                        corner[i].vertex = loops[corner[i].loop];
+                    } else {
+                        corner[i].loop = tri_loops_old[tri_loop_id].tri[i];
+                        corner[i].vertex = loops_old[corner[i].loop].v;
+                    }
 
-            InputFloat color_factor = dr::rcp(255.f);
+                    if (unlikely(corner[i].vertex >= vertex_count)) {
+                        invalid_vertex = corner[i].vertex + 1;
+                        break;
+                    }
+                }
+                if (unlikely(invalid_vertex != 0))
+                    break;
 
-            for (int i = 0; i < 3; i++) {
-                size_t loop_index, vert_index;
+                bool smooth_face;
                 if (version >= Version(3, 6, 0)) {
-                    const int *tri_loop = (const int *) tri_loops[tri_loop_id];
-                    loop_index = tri_loop[i];
-                    vert_index = loops[loop_index];
+                    // Blender 3.6+ layout
+                    smooth_face = sharp_faces == nullptr || !sharp_faces[face_id];
                 } else {
-                    loop_index = tri_loops_old[tri_loop_id].tri[i];
-                    vert_index = loops_old[loop_index].v;
+                    smooth_face = blender::ME_SMOOTH & polys_old[face_id].flag;
                 }
 
-                if (unlikely((vert_index >= vertex_count)))
-                    fail("reference to invalid vertex %i!", vert_index);
+                InputNormal3f face_normal(0.f);
+                if (!smooth_face && !m_face_normals) {
+                    // Flat shading, use per face normals (only if the mesh is not globally flat)
+                    const float *co[3] = { vertex_coords(corner[0].vertex),
+                                           vertex_coords(corner[1].vertex),
+                                           vertex_coords(corner[2].vertex) };
+                    const InputVector3f e1(co[1][0] - co[0][0], co[1][1] - co[0][1], co[1][2] - co[0][2]);
+                    const InputVector3f e2(co[2][0] - co[0][0], co[2][1] - co[0][1], co[2][2] - co[0][2]);
+                    face_normal = m_to_world.scalar().transform_affine(dr::cross(e1, e2));
+                    if (unlikely(dr::all(dr::eq(face_normal, 0.f))))
+                        continue; // Degenerate triangle, ignore it
+                    else
+                        face_normal = dr::normalize(face_normal);
+                }
 
-                Key vert_key;
-                if (smooth_face || m_face_normals) {
-                    if (version <= Version(3, 0, 0)) {
-                        // Blender 2.xx - 3.0
-                        const short *no = verts_old_2[vert_index].no;
+                for (int i = 0; i < 3; i++) {
+                    InputNormal3f normal = face_normal;
+                    if (smooth_face || m_face_normals) {
                         // Store per vertex normals if the face is smooth or if the mesh is globally flat
-                        normal = m_to_world.scalar().transform_affine(InputNormal3f(no[0], no[1], no[2]));
+                        if (version <= Version(3, 0, 0)) {
+                            // Blender 2.xx - 3.0
+                            const short *no = verts_old_2[corner[i].vertex].no;
+                            normal = m_to_world.scalar().transform_affine(InputNormal3f(no[0], no[1], no[2]));
+                        } else {
+                            const float *no = normals[corner[i].vertex];
+                            normal = m_to_world.scalar().transform_affine(InputNormal3f(no[0], no[1], no[2]));
+                        }
+
+                        if (unlikely(dr::all(dr::eq(normal, 0.f))))
+                            invalid_normal = true;
+                        else
+                            normal = dr::normalize(normal);
+                        corner[i].poly = Corner::Smooth;
                     } else {
-                        const float *no = normals[vert_index];
-                        // Store per vertex normals if the face is smooth or if the mesh is globally flat
-                        normal = m_to_world.scalar().transform_affine(InputNormal3f(no[0], no[1], no[2]));
+                        // Flat shading: store the referenced polygon (face)
+                        corner[i].poly = (uint32_t) face_id;
                     }
 
-                    if(unlikely(dr::all(dr::eq(normal, 0.f))))
-                        fail("invalid normals!");
-                    else
-                        normal = dr::normalize(normal);
-                    vert_key.smooth = true;
-                } else {
-                    // vert_key.smooth = false (default), flat shading
-                    // Store the referenced polygon (face)
-                    vert_key.poly = face_id;
+                    corner[i].normal[0] = normal.x();
+                    corner[i].normal[1] = normal.y();
+                    corner[i].normal[2] = normal.z();
+
+                    if (has_uvs) {
+                        const float *uv;
+                        if (version <= Version(3, 4, 0)) {
+                            // Blender 2.xx - 3.4
+                            uv = ((const blender::MLoopUV *) uv_ptr)[corner[i].loop].uv;
+                        } else {
+                            // Blender 3.5+
+                            uv = ((const float (*)[2]) uv_ptr)[corner[i].loop];
+                        }
+                        corner[i].uv[0] = uv[0];
+                        corner[i].uv[1] = 1.0f - uv[1];
+                    }
                 }
 
-                vert_key.normal = normal;
+                valid[tri_loop_id] = 1;
+            }
+        });
+
+        if (invalid_vertex != 0)
+            fail("reference to invalid vertex %i!", invalid_vertex - 1);
+        if (invalid_normal)
+            fail("invalid normals!");
+
+        /* 2. Find the unique vertices using a lock-free hash table over the
+              corners. Every entry stores the smallest index of the corners
+              sharing its key, so that vertices are numbered in the order of
+              their first occurrence, independently of the thread count */
+        constexpr uint32_t Empty = (uint32_t) -1;
+        size_t table_size = 1;
+        while (table_size < 2 * corner_count)
+            table_size <<= 1;
+
+        std::unique_ptr<std::atomic<uint32_t>[]> table(
+            new std::atomic<uint32_t>[table_size]);
+        std::vector<uint32_t> slots(corner_count);
+
+        dr::parallel_for(
+            dr::blocked_range<size_t>(0, table_size, 1u << 16),
+            [&](const dr::blocked_range<size_t> &range) {
+                for (size_t i = range.begin(); i != range.end(); ++i)
+                    table[i].store(Empty, std::memory_order_relaxed);
+            }
+        );
+
+        parallel_blocks([&](size_t, size_t begin, size_t end) {
+            for (size_t tri_loop_id = begin; tri_loop_id < end; tri_loop_id++) {
+                if (!valid[tri_loop_id])
+                    continue;
+
+                for (uint32_t c = 3 * (uint32_t) tri_loop_id;
+                     c < 3 * (uint32_t) tri_loop_id + 3; ++c) {
+                    size_t slot = corners[c].hash() & (table_size - 1);
+                    while (true) {
+                        uint32_t entry = table[slot].load();
+                        if (entry == Empty &&
+                            table[slot].compare_exchange_strong(entry, c))
+                            break;
+
+                        // 'entry' now refers to a corner that occupies the slot
+                        if (corners[entry] == corners[c]) {
+                            while (c < entry &&
+                                   !table[slot].compare_exchange_weak(entry, c)) { }
+                            break;
+                        }
 
-                if (has_uvs) {
-                    if (version <= Version(3, 4, 0)) {
-                        // Blender 2.xx - 3.4
-                        const blender::MLoopUV *uvs = (const blender::MLoopUV *) uv_ptr;
-                        const blender::MLoopUV &loop_uv = uvs[loop_index];
-                        const InputVector2f uv(loop_uv.uv[0], 1.0f - loop_uv.uv[1]);
-                        vert_key.uv = uv;
-                    } else {
-                        // Blender 3.5+
-                        const float (*uvs)[2] = (const float (*)[2]) uv_ptr;
-                        const InputVector2f uv(uvs[loop_index][0], 1.0f - uvs[loop_index][1]);
-                        vert_key.uv = uv;
+                        slot = (slot + 1) & (table_size - 1);
                     }
+                    slots[c] = (uint32_t) slot;
                 }
+            }
+        });
+
+        /* 3. Number the unique vertices and the triangles with a prefix sum
+              over the blocks */
+        std::vector<size_t> block_vertex_offset(block_count + 1, 0),
+                            block_face_offset(block_count + 1, 0);
+        parallel_blocks([&](size_t b, size_t begin, size_t end) {
+            for (size_t tri_loop_id = begin; tri_loop_id < end; tri_loop_id++) {
+                if (!valid[tri_loop_id])
+                    continue;
+                block_face_offset[b + 1]++;
+                for (uint32_t c = 3 * (uint32_t) tri_loop_id;
+                     c < 3 * (uint32_t) tri_loop_id + 3; ++c)
+                    block_vertex_offset[b + 1] += table[slots[c]].load() == c;
+            }
+        });
 
-                // Vertex index in the blender mesh is the map index
-                VertexBinding *map_entry = &vertex_map[vert_index];
-                while (vert_key != map_entry->key && map_entry->next != nullptr)
-                    map_entry = map_entry->next;
+        for (size_t b = 0; b < block_count; ++b) {
+            block_vertex_offset[b + 1] += block_vertex_offset[b];
+            block_face_offset[b + 1] += block_face_offset[b];
+        }
 
-                if (map_entry->is_init && map_entry->key == vert_key) {
-                    triangle[i] = map_entry->value;
-                    duplicates_ctr++;
-                } else {
-                    if (map_entry->is_init) {
-                        // Add a new entry
-                        map_entry->next = new VertexBinding();
-                        map_entry       = map_entry->next;
-                    }
-                    ScalarSize vert_id = vertex_ctr++;
-                    map_entry->key     = vert_key;
-                    map_entry->value   = vert_id;
-                    map_entry->is_init = true;
-                    // Add stuff to the temporary buffers
-                    InputPoint3f pt = m_to_world.scalar().transform_affine(face_points[i]);
-                    tmp_vertices.push_back({pt.x(), pt.y(), pt.z()});
+        size_t vertex_ctr = block_vertex_offset[block_count],
+               face_ctr   = block_face_offset[block_count];
+
+        Log(Info, "%s: Removed %i duplicates", m_name, 3 * face_ctr - vertex_ctr);
+
+        if (vertex_ctr == 0)
+            return;
+
+        /* 4. Write the vertex data and the faces directly into buffers of
+              their final size */
+        std::vector<InputFloat> positions(vertex_ctr * 3),
+                                vertex_normals(m_face_normals ? 0 : vertex_ctr * 3),
+                                texcoords(has_uvs ? vertex_ctr * 2 : 0);
+        std::vector<std::vector<InputFloat>> colors(
+            cols.size(), std::vector<InputFloat>(vertex_ctr * 3));
+        std::vector<ScalarIndex> faces(face_ctr * 3), source(vertex_ctr);
+        std::vector<uint32_t> vertex_ids(corner_count);
+
+        InputFloat color_factor = dr::rcp(255.f);
+
+        // Numbering of the unique vertices, in the order of the corners
+        parallel_blocks([&](size_t b, size_t begin, size_t end) {
+            size_t vertex_id = block_vertex_offset[b];
+            for (size_t tri_loop_id = begin; tri_loop_id < end; tri_loop_id++) {
+                if (!valid[tri_loop_id])
+                    continue;
+
+                for (uint32_t c = 3 * (uint32_t) tri_loop_id;
+                     c < 3 * (uint32_t) tri_loop_id + 3; ++c) {
+                    if (table[slots[c]].load() != c)
+                        continue;
+
+                    const Corner &corner = corners[c];
+                    vertex_ids[c] = (uint32_t) vertex_id;
+                    source[vertex_id] = corner.vertex;
+
+                    const float *co = vertex_coords(corner.vertex);
+                    InputPoint3f pt = m_to_world.scalar().transform_affine(
+                        InputPoint3f(co[0], co[1], co[2]));
+                    dr::store(positions.data() + 3 * vertex_id, pt);
                     if (!m_face_normals)
-                        tmp_normals.push_back({normal.x(), normal.y(), normal.z()});
+                        std::copy(corner.normal, corner.normal + 3,
+                                  vertex_normals.data() + 3 * vertex_id);
                     if (has_uvs)
-                        tmp_uvs.push_back(vert_key.uv);
-                    if (has_cols) {
-                        for (size_t p = 0; p < cols.size(); p++) {
-                            const blender::MLoopCol &loop_col = cols[p].second[loop_index];
-                            // Blender stores vertex colors in sRGB space
-                            tmp_cols[p].push_back(dr::srgb_to_linear(loop_col.r * color_factor));
-                            tmp_cols[p].push_back(dr::srgb_to_linear(loop_col.g * color_factor));
-                            tmp_cols[p].push_back(dr::srgb_to_linear(loop_col.b * color_factor));
-                        }
+                        std::copy(corner.uv, corner.uv + 2,
+                                  texcoords.data() + 2 * vertex_id);
+
+                    for (size_t p = 0; p < cols.size(); p++) {
+                        const blender::MLoopCol &loop_col = cols[p].second[corner.loop];
+                        // Blender stores vertex colors in sRGB space
+                        InputFloat *col = colors[p].data() + 3 * vertex_id;
+                        col[0] = dr::srgb_to_linear(loop_col.r * color_factor);
+                        col[1] = dr::srgb_to_linear(loop_col.g * color_factor);
+                        col[2] = dr::srgb_to_linear(loop_col.b * color_factor);
                     }
-                    triangle[i] = vert_id;
+
+                    vertex_id++;
                 }
             }
-            tmp_triangles.push_back(triangle);
-        }
-        Log(Info, "%s: Removed %i duplicates", m_name, duplicates_ctr);
+        });
 
-        if (vertex_ctr == 0)
-            return;
+        // Faces reference the vertex of the first corner sharing their key
+        parallel_blocks([&](size_t b, size_t begin, size_t end) {
+            ScalarIndex *face = faces.data() + 3 * block_face_offset[b];
+            for (size_t tri_loop_id = begin; tri_loop_id < end; tri_loop_id++) {
+                if (!valid[tri_loop_id])
+                    continue;
+
+                for (uint32_t c = 3 * (uint32_t) tri_loop_id;
+                     c < 3 * (uint32_t) tri_loop_id + 3; ++c)
+                    *face++ = vertex_ids[table[slots[c]].load()];
+            }
+        });
 
-        m_face_count = (ScalarSize) tmp_triangles.size();
-        m_faces = dr::load<DynamicBuffer<UInt32>>(tmp_triangles.data(), m_face_count * 3);
+        m_face_count = (ScalarSize) face_ctr;
+        m_faces = dr::load<DynamicBuffer<UInt32>>(faces.data(), m_face_count * 3);
 
-        m_vertex_count = vertex_ctr;
-        m_vertex_positions = dr::load<FloatStorage>(tmp_vertices.data(), m_vertex_count * 3);
+        m_vertex_count = (ScalarSize) vertex_ctr;
+        m_vertex_positions = dr::load<FloatStorage>(positions.data(), m_vertex_count * 3);
         if (!m_face_normals)
-            m_vertex_normals = dr::load<FloatStorage>(tmp_normals.data(), m_vertex_count * 3);
+            m_vertex_normals = dr::load<FloatStorage>(vertex_normals.data(), m_vertex_count * 3);
 
         if (has_uvs)
-            m_vertex_texcoords = dr::load<FloatStorage>(tmp_uvs.data(), m_vertex_count * 2);
+            m_vertex_texcoords = dr::load<FloatStorage>(texcoords.data(), m_vertex_count * 2);
 
-        if (has_cols) {
-            for (size_t p = 0; p < cols.size(); p++)
-                add_attribute(cols[p].first, 3, tmp_cols[p]);
-        }
+        for (size_t p = 0; p < cols.size(); p++)
+            add_attribute(cols[p].first, 3, colors[p]);
+
+        m_blender_vertex_count = (ScalarSize) vertex_count;
+        m_blender_vertex_indices =
+            dr::load<DynamicBuffer<UInt32>>(source.data(), m_vertex_count);
 
         initialize();
     }
 
+    void traverse(TraversalCallback *callback) override {
+        Base::traverse(callback);
+        callback->put_parameter("blender_vertex_positions", m_blender_vertex_positions, +ParamFlags::NonDifferentiable);
+    }
+
+    void parameters_changed(const std::vector<std::string> &keys) override {
+        if (string::contains(keys, "blender_vertex_positions") &&
+            dr::width(m_blender_vertex_positions) != 0) {
+            /* Incremental update of a mesh whose topology did not change:
+               map the new Blender vertex positions to the (split) vertices */
+            if (dr::width(m_blender_vertex_positions) != 3 * (size_t) m_blender_vertex_count)
+                Throw("Error while updating Blender mesh \"%s\": expected %u "
+                      "vertex positions, got %zu!", m_name,
+                      m_blender_vertex_count,
+                      dr::width(m_blender_vertex_positions) / 3);
+
+            if constexpr (dr::is_jit_v<Float>) {
+                using StoragePoint3f = Point<dr::replace_scalar_t<Float, InputFloat>, 3>;
+                Point3f p(dr::gather<StoragePoint3f>(m_blender_vertex_positions,
+                                                     m_blender_vertex_indices));
+                p = m_to_world.value().transform_affine(p);
+                dr::scatter(m_vertex_positions, StoragePoint3f(p),
+                            dr::arange<UInt32>(m_vertex_count));
+            } else {
+                ScalarTransform4f to_world = m_to_world.scalar();
+                const InputFloat *blender_positions = m_blender_vertex_positions.data();
+                const ScalarIndex *indices = m_blender_vertex_indices.data();
+                for (ScalarIndex i = 0; i < m_vertex_count; ++i) {
+                    InputPoint3f p = dr::load<InputPoint3f>(blender_positions + 3 * indices[i]);
+                    dr::store(m_vertex_positions.data() + 3 * i,
+                              InputPoint3f(to_world.transform_affine(p)));
+                }
+            }
+
+            // Release the Blender positions, they are not needed anymore
+            m_blender_vertex_positions = FloatStorage();
+
+            std::vector<std::string> mesh_keys = keys;
+            mesh_keys.push_back("vertex_positions");
+            Base::parameters_changed(mesh_keys);
+        } else {
+            Base::parameters_changed(keys);
+        }
+    }
+
     MI_DECLARE_CLASS()
+private:
+    /// A triangle corner, i.e. a reference to a Blender vertex through a loop
+    struct Corner {
+        /// Polygon index of the corners of smooth shaded faces
+        static constexpr uint32_t Smooth = (uint32_t) -1;
+
+        /// Blender vertex and loop index
+        uint32_t vertex = 0, loop = 0;
+        /// Polygon of flat shaded corners, used instead of the normal since
+        /// comparing normals is ambiguous due to numerical precision
+        uint32_t poly = Smooth;
+        float normal[3] { 0.f, 0.f, 0.f };
+        float uv[2] { 0.f, 0.f };
+
+        /// Do both corners map to the same Mitsuba vertex?
+        bool operator==(const Corner &other) const {
+            if (vertex != other.vertex || poly != other.poly ||
+                uv[0] != other.uv[0] || uv[1] != other.uv[1])
+                return false;
+            return poly != Smooth || (normal[0] == other.normal[0] &&
+                                      normal[1] == other.normal[1] &&
+                                      normal[2] == other.normal[2]);
+        }
+
+        /// Hash of the fields that are compared by operator==
+        size_t hash() const {
+            // Adding zero maps -0 to +0, which compare equal
+            float values[5] = { uv[0] + 0.f, uv[1] + 0.f, 0.f, 0.f, 0.f };
+            if (poly == Smooth)
+                for (int i = 0; i < 3; ++i)
+                    values[2 + i] = normal[i] + 0.f;
+
+            uint32_t key[7] = { vertex, poly };
+            memcpy(key + 2, values, sizeof(values));
+            return (size_t) hash_buffer(key, sizeof(key));
+        }
+    };
+
+    /// Flattened Blender vertex positions, set to update the vertex positions
+    FloatStorage m_blender_vertex_positions;
+    /// Blender vertex referenced by every vertex of the mesh
+    DynamicBuffer<UInt32> m_blender_vertex_indices;
+    /// Number of vertices of the Blender mesh
+    ScalarSize m_blender_vertex_count = 0;
 };
 
 MI_IMPLEMENT_CLASS_VARIANT(BlenderMesh, Mesh)
@@ -7,6 +7,7 @@
 #include <mitsuba/core/fresolver.h>
 #include <mitsuba/core/mmap.h>
 #include <mitsuba/core/timer.h>
+#include <mitsuba/render/curve.h>
 #include <mitsuba/render/fwd.h>
 #include <mitsuba/render/interaction.h>
 #include <mitsuba/render/shape.h>
@@ -39,6 +40,19 @@ B-spline curve (:monosp:`bsplinecurve`)
    - Specifies a linear object-to-world transformation. Note that the control
      points' raddii are invariant to this transformation!
 
+ * - simplify_ratio
+   - |float|
+   - Keep a random subset of one in this many curves, see below. (Default: 1, i.e. all curves)
+
+ * - simplify_seed
+   - |int|
+   - Seed of the random selection of the simplified curves. (Default: 0)
+
+ * - simplify_widen
+   - |bool|
+   - Scale the radii of the curves that remain after the simplification to
+     preserve their appearance from a distance. (Default: |true|)
+
  * - silhouette_sampling_weight
    - |float|
    - Weight associated with this shape when sampling silhoeuttes in the scene. (Default: 1)
@@ -119,6 +133,15 @@ points and increasing radii::
             'filename': 'curves.txt'
         },
 
+Dense fur or hair that only covers a small part of the image can be
+stochastically simplified to reduce the memory and traversal cost of thin
+curves: with :monosp:`simplify_ratio=k`, only a random subset of one in
+:monosp:`k` curves is loaded, and the radii of these curves are scaled so that
+their total projected area is preserved (following "Stochastic Simplification
+of Aggregate Detail" by Cook et al.). The simplified versions can be used as
+the coarser :ref:`levels of detail <shape-instance-lod>` of an instance, which
+then selects one of them based on its distance to the sensor.
+
 .. note:: The backfaces of the curves are culled. It is therefore impossible to
           intersect a curve with a ray, whose origin lies inside the curve.
           In addition, prior to the NVIDIA v531.18 drivers for Windows and
@@ -145,11 +168,11 @@ public:
     using UInt32Storage = DynamicBuffer<UInt32>;
 
     BSplineCurve(const Properties &props) : Base(props) {
-#if !defined(MI_ENABLE_EMBREE)
-        if constexpr (!dr::is_jit_v<Float>)
-            Throw("The B-spline curve is only available with Embree in scalar "
-                  "variants!");
-#endif
+        ScalarFloat simplify_ratio = props.get<ScalarFloat>("simplify_ratio", 1.f);
+        uint32_t simplify_seed = props.get<uint32_t>("simplify_seed", 0);
+        bool simplify_widen = props.get<bool>("simplify_widen", true);
+        if (!(simplify_ratio >= 1.f))
+            Throw("The \"simplify_ratio\" parameter must be >= 1!");
 
         auto fs = Thread::thread()->file_resolver();
         fs::path file_path = fs->resolve(props.string("filename"));
@@ -258,6 +281,15 @@ public:
             fail("Empty B-spline file: no control points were read!");
         finish_curve();
 
+        if (simplify_ratio > 1.f) {
+            size_t curve_count = curve_1st_idx.size();
+            simplify_curves(vertices, radius, curve_1st_idx, simplify_ratio,
+                            simplify_seed, simplify_widen);
+            segment_count = vertices.size() - 3 * curve_1st_idx.size();
+            Log(Debug, "\"%s\": kept %zu of %zu curves", m_name,
+                curve_1st_idx.size(), curve_count);
+        }
+
         m_control_point_count = (ScalarSize) vertices.size();
 
         std::unique_ptr<ScalarIndex[]> indices = std::make_unique<ScalarIndex[]>(segment_count);
@@ -331,6 +363,7 @@ public:
         m_shape_type = ShapeType::BSplineCurve;
         dr::set_attr(this, "shape_type", m_shape_type);
 
+        update_host_pointers();
         initialize();
     }
 
@@ -344,6 +377,7 @@ public:
     void parameters_changed(const std::vector<std::string> &keys) override {
         if (keys.empty() || string::contains(keys, "control_points")) {
             recompute_bbox();
+            update_host_pointers();
             mark_dirty();
         }
         Base::parameters_changed();
@@ -894,8 +928,10 @@ public:
             cubic_interpolation(v_local, prim_idx, active);
         Vector3f dc_dv_normalized = dr::normalize(dc_dv);
 
+        // The local frame is only needed for the UV coordinates
         Vector3f u_rot, u_rad;
-        std::tie(u_rot, u_rad) = local_frame(dc_dv_normalized);
+        if (IsDiff || need_uv)
+            std::tie(u_rot, u_rad) = local_frame(dc_dv_normalized);
 
         if constexpr (IsDiff) {
             // Compute attached interaction point (w.r.t curve parameters)
@@ -978,7 +1014,9 @@ public:
             (dr::squared_norm(dc_dv) - correction) * rad_vec -
             (dr_dv * radius) * dc_dv
         );
-        si.n = si.sh_frame.n = n;
+        si.n = n;
+        if (likely(has_flag(ray_flags, RayFlags::ShadingFrame)))
+            si.sh_frame.n = n;
 
         if (need_uv) {
             Float u = dr::atan2(dr::dot(u_rot, rad_vec_normalized),
@@ -1057,6 +1095,52 @@ public:
     }
 #endif
 
+    // =============================================================
+    //! @{ \name Native backend (kd-tree / BVH) support
+    // =============================================================
+
+    ScalarBoundingBox3f bbox(ScalarIndex index) const override {
+        return bbox(index, ScalarBoundingBox3f(
+                               ScalarPoint3f(-dr::Infinity<ScalarFloat>),
+                               ScalarPoint3f(dr::Infinity<ScalarFloat>)));
+    }
+
+    ScalarBoundingBox3f bbox(ScalarIndex index,
+                             const ScalarBoundingBox3f &clip) const override {
+        HostSegment seg = host_segment(index);
+        auto [chord_error, radius_error] = piece_error(seg);
+
+        /* Bound the pieces of the segment individually: every piece lies
+           within a known distance of the chord between its end points */
+        ScalarBoundingBox3f result;
+        auto [a, da, dda, ra, dra, ddra] = eval_segment(seg, 0.);
+        for (uint32_t k = 1; k <= Pieces; ++k) {
+            auto [b, db, ddb, rb, drb, ddrb] = eval_segment(seg, k / (double) Pieces);
+            double radius = std::max(ra, rb) + radius_error + chord_error;
+            expand_swept_sphere_bbox(result, ScalarPoint3f(a), ScalarPoint3f(b),
+                                     (ScalarFloat) radius, clip);
+            a = b;
+            ra = rb;
+        }
+        return result;
+    }
+
+    std::tuple<ScalarFloat, ScalarPoint2f, ScalarUInt32, ScalarUInt32>
+    ray_intersect_primitive_scalar(ScalarIndex index,
+                                   const ScalarRay3f &ray) const override {
+        auto [t, v] = intersect_segment<false>(index, ray);
+        return { t, ScalarPoint2f(v, 0.f), (ScalarUInt32) -1, index };
+    }
+
+    bool ray_test_primitive_scalar(ScalarIndex index,
+                                   const ScalarRay3f &ray) const override {
+        return intersect_segment<true>(index, ray).first !=
+               dr::Infinity<ScalarFloat>;
+    }
+
+    //! @}
+    // =============================================================
+
     ScalarBoundingBox3f bbox() const override {
         return m_bbox;
     }
@@ -1091,6 +1175,225 @@ private:
         *start_ = start;
     }
 
+    // =============================================================
+    //! @{ \name Native backend (kd-tree / BVH) helpers
+    // =============================================================
+
+    using Point3d  = Point<double, 3>;
+    using Vector3d = Vector<double, 3>;
+
+    /// Number of pieces that are used to bound and intersect a segment
+    static constexpr uint32_t Pieces = 8;
+    using PieceD = dr::Packet<double, Pieces>;
+
+    /// Control points and radii of a segment, in double precision
+    struct HostSegment {
+        Point3d p[4];
+        double r[4];
+    };
+
+    /**
+     * \brief Make the control points and segment indices accessible to the
+     * scalar intersection routines of the native backend
+     */
+    void update_host_pointers() {
+        if constexpr (!dr::is_cuda_v<Float>) {
+            if constexpr (dr::is_jit_v<Float>) {
+                dr::eval(m_control_points, m_indices);
+                dr::sync_thread();
+            }
+            m_host_control_points = m_control_points.data();
+            m_host_indices = m_indices.data();
+        }
+    }
+
+    HostSegment host_segment(ScalarIndex index) const {
+        const InputFloat *c = m_host_control_points + 4 * m_host_indices[index];
+        HostSegment seg;
+        for (int i = 0; i < 4; ++i) {
+            seg.p[i] = Point3d(c[4 * i + 0], c[4 * i + 1], c[4 * i + 2]);
+            seg.r[i] = c[4 * i + 3];
+        }
+        return seg;
+    }
+
+    /**
+     * \brief Evaluate the center of the swept sphere and its radius, along
+     * with their first two derivatives (an arbitrary number of parameter
+     * values can be evaluated at once using a packet type)
+     */
+    template <typename Value>
+    static std::tuple<Point<Value, 3>, Vector<Value, 3>, Vector<Value, 3>,
+                      Value, Value, Value>
+    eval_segment(const HostSegment &seg, const Value &v) {
+        Value v2 = v * v, v3 = v2 * v;
+        Value b[4]   = { (-v3 + 3. * v2 - 3. * v + 1.) / 6.,
+                         (3. * v3 - 6. * v2 + 4.) / 6.,
+                         (-3. * v3 + 3. * v2 + 3. * v + 1.) / 6.,
+                         v3 / 6. },
+              db[4]  = { (-3. * v2 + 6. * v - 3.) / 6.,
+                         (9. * v2 - 12. * v) / 6.,
+                         (-9. * v2 + 6. * v + 3.) / 6.,
+                         v2 / 2. },
+              ddb[4] = { 1. - v, 3. * v - 2., 1. - 3. * v, v };
+
+        Point<Value, 3> c(0.);
+        Vector<Value, 3> dc(0.), ddc(0.);
+        Value r(0.), dr_(0.), ddr(0.);
+        for (int i = 0; i < 4; ++i) {
+            Vector<Value, 3> p(seg.p[i]);
+            c   += b[i] * p;
+            dc  += db[i] * p;
+            ddc += ddb[i] * p;
+            r   += b[i] * seg.r[i];
+            dr_ += db[i] * seg.r[i];
+            ddr += ddb[i] * seg.r[i];
+        }
+
+        return { c, dc, ddc, r, dr_, ddr };
+    }
+
+    /**
+     * \brief Bound the distance between the pieces of a segment and their
+     * chords, and the deviation of their radius from a linear interpolation
+     *
+     * Both bounds follow from the second derivative, which is linear in the
+     * curve parameter and hence maximal at one end of the segment.
+     */
+    static std::pair<double, double> piece_error(const HostSegment &seg) {
+        auto [c0, dc0, ddc0, r0, dr0, ddr0] = eval_segment(seg, 0.);
+        auto [c1, dc1, ddc1, r1, dr1, ddr1] = eval_segment(seg, 1.);
+        double scale = 1. / (8. * Pieces * Pieces);
+        return { scale * std::max(dr::norm(ddc0), dr::norm(ddc1)),
+                 scale * std::max(std::abs(ddr0), std::abs(ddr1)) };
+    }
+
+    /**
+     * \brief Intersect a ray with the swept sphere of a segment
+     *
+     * Candidate pieces are found by testing the ray against all pieces of the
+     * segment at once (bounded by round cones around their chords). The
+     * intersections with the candidates are then refined by solving for the
+     * ray distance \c t and curve parameter \c v of a point on the surface
+     * using Newton's method. Back faces are culled.
+     *
+     * \return The distance along the ray (or infinity) and the curve parameter
+     */
+    template <bool ShadowRay>
+    std::pair<ScalarFloat, ScalarFloat>
+    intersect_segment(ScalarIndex index, const ScalarRay3f &ray) const {
+        using Point3P = Point<PieceD, 3>;
+        using Vector3P = Vector<PieceD, 3>;
+
+        HostSegment seg = host_segment(index);
+        auto [chord_error, radius_error] = piece_error(seg);
+
+        Point3d o(ray.o);
+        Vector3d d(ray.d);
+        double maxt = (double) ray.maxt, d_norm = dr::norm(d);
+
+        // 1. Find the pieces that are close to the ray
+        PieceD v0 = dr::arange<PieceD>() / (double) Pieces,
+               v1 = v0 + 1. / Pieces;
+        auto [a, da, dda, ra, dra, ddra] = eval_segment(seg, v0);
+        auto [b, db, ddb, rb, drb, ddrb] = eval_segment(seg, v1);
+
+        PieceD radius = dr::maximum(ra, rb) + radius_error + chord_error;
+        auto [dist_sqr, t_closest, s_closest] = ray_segment_closest_points(
+            Point3P(o), Vector3P(d), PieceD(maxt), a, b);
+
+        auto candidate = dist_sqr <= dr::sqr(radius);
+        if (dr::none(candidate))
+            return { dr::Infinity<ScalarFloat>, 0.f };
+
+        // Start at the point where the ray enters the bounding round cone
+        PieceD t_start = dr::maximum(
+            t_closest - dr::safe_sqrt(dr::sqr(radius) - dist_sqr) / d_norm, 0.),
+               v_start = v0 + s_closest / Pieces;
+
+        // 2. Refine the candidates
+        double t_best = maxt, v_best = 0.;
+        bool hit = false;
+        for (uint32_t k = 0; k < Pieces; ++k) {
+            if (!candidate.entry(k) || !(t_start.entry(k) < t_best))
+                continue;
+
+            double t = t_start.entry(k), v = v_start.entry(k);
+            if (!refine_intersection(seg, o, d, t, v) || !(t > 0. && t < t_best))
+                continue;
+
+            t_best = t;
+            v_best = v;
+            hit = true;
+
+            if constexpr (ShadowRay)
+                break;
+        }
+
+        if (!hit)
+            return { dr::Infinity<ScalarFloat>, 0.f };
+
+        return { (ScalarFloat) t_best, (ScalarFloat) v_best };
+    }
+
+    /**
+     * \brief Solve for the intersection of a ray with the swept sphere near
+     * the initial guess <tt>(t, v)</tt>
+     *
+     * A surface point lies on the sphere with parameter \c v, and its
+     * direction from the center is orthogonal to the derivative of the
+     * sphere family with respect to \c v (envelope condition).
+     *
+     * \return \c true if the iteration converged to a front facing surface
+     * point within the segment
+     */
+    static bool refine_intersection(const HostSegment &seg, const Point3d &o,
+                                    const Vector3d &d, double &t, double &v) {
+        constexpr int MaxIterations = 16;
+        constexpr double Tolerance = 1e-7;
+
+        for (int i = 0; i < MaxIterations; ++i) {
+            auto [c, dc, ddc, r, dr_, ddr] = eval_segment(seg, v);
+            Vector3d q = o + t * d - c;
+
+            double f1  = dr::dot(q, q) - r * r,
+                   f2  = dr::dot(q, dc) + r * dr_,
+                   j00 = 2. * dr::dot(q, d),
+                   j01 = -2. * f2,
+                   j10 = dr::dot(d, dc),
+                   j11 = -dr::dot(dc, dc) + dr::dot(q, ddc) + dr_ * dr_ + r * ddr,
+                   det = j00 * j11 - j01 * j10;
+
+            if (det == 0. || !std::isfinite(det))
+                return false;
+
+            double dt = (f1 * j11 - f2 * j01) / det,
+                   dv = (j00 * f2 - j10 * f1) / det;
+            t -= dt;
+            v = dr::clamp(v - dv, -0.5, 1.5);
+
+            double scale = r + dr::norm(dc);
+            if (std::abs(dt) * dr::norm(d) <= Tolerance * scale &&
+                std::abs(dv) <= Tolerance) {
+                if (v < 0. || v > 1.)
+                    return false;
+
+                // Check the residual and cull back faces
+                std::tie(c, dc, ddc, r, dr_, ddr) = eval_segment(seg, v);
+                q = o + t * d - c;
+                Vector3d n = (dr::dot(dc, dc) - dr::dot(q, ddc)) * q - r * dr_ * dc;
+
+                return std::abs(dr::norm(q) - r) <= 1e-4 * scale &&
+                       dr::dot(n, d) < 0.;
+            }
+        }
+
+        return false;
+    }
+
+    //! @}
+    // =============================================================
+
     void recompute_bbox() {
         auto&& control_points = dr::migrate(m_control_points, AllocType::Host);
         if constexpr (dr::is_jit_v<Float>)
@@ -1297,6 +1600,10 @@ private:
 
     static constexpr float silhouette_offset = 5e-3f;
 
+    /// Host pointers to the curve data used by the native backend
+    const InputFloat *m_host_control_points = nullptr;
+    const ScalarIndex *m_host_indices = nullptr;
+
 #if defined(MI_ENABLE_CUDA)
     // For OptiX build input
     mutable CUdeviceptr* m_vertex_buffer_ptr = nullptr;
@@ -732,22 +732,30 @@ public:
         si.t = dr::select(active, si.t, dr::Infinity<Float>);
 
         // si.uv
-        Float phi = dr::atan2(local.y(), local.x());
-        dr::masked(phi, phi < 0.f) += dr::TwoPi<Float>;
-        si.uv = Point2f(phi * dr::InvTwoPi<Float>, local.z());
-        // si.dp_duv & si.n
-        Vector3f dp_du = dr::TwoPi<Float> * Vector3f(-local.y(), local.x(), 0.f);
-        Vector3f dp_dv = Vector3f(0.f, 0.f, 1.f);
-        si.dp_du = to_world.transform_affine(dp_du);
-        si.dp_dv = to_world.transform_affine(dp_dv);
-        si.n = Normal3f(dr::normalize(dr::cross(si.dp_du, si.dp_dv)));
+        if (likely(has_flag(ray_flags, RayFlags::UV))) {
+            Float phi = dr::atan2(local.y(), local.x());
+            dr::masked(phi, phi < 0.f) += dr::TwoPi<Float>;
+            si.uv = Point2f(phi * dr::InvTwoPi<Float>, local.z());
+        }
+
+        // si.n (and si.dp_duv, which the normal is derived from)
+        Vector3f dp_du = to_world.transform_affine(
+            dr::TwoPi<Float> * Vector3f(-local.y(), local.x(), 0.f));
+        Vector3f dp_dv = to_world.transform_affine(Vector3f(0.f, 0.f, 1.f));
+        si.n = Normal3f(dr::normalize(dr::cross(dp_du, dp_dv)));
+
+        if (likely(has_flag(ray_flags, RayFlags::dPdUV))) {
+            si.dp_du = dp_du;
+            si.dp_dv = dp_dv;
+        }
 
         if (m_flip_normals)
             si.n = -si.n;
-        si.sh_frame.n = si.n;
+        if (likely(has_flag(ray_flags, RayFlags::ShadingFrame)))
+            si.sh_frame.n = si.n;
 
         if (likely(need_dn_duv)) {
-            si.dn_du = si.dp_du / (radius * (m_flip_normals ? -1.f : 1.f));
+            si.dn_du = dp_du / (radius * (m_flip_normals ? -1.f : 1.f));
             si.dn_dv = Vector3f(0.f);
         }
 
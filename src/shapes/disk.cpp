@@ -160,6 +160,11 @@ public:
         );
     }
 
+    std::pair<ScalarVector3f, ScalarFloat> normal_bounds() const override {
+        ScalarNormal3f n = m_to_world.scalar() * ScalarNormal3f(0.f, 0.f, 1.f);
+        return { dr::normalize(ScalarVector3f(n)), 0.f };
+    }
+
     Float surface_area() const override {
         // First compute height of the ellipse
         Float h = dr::sqrt(dr::sqr(m_dv) - dr::sqr(dr::dot(m_dv * m_frame.t, m_frame.s)));
@@ -509,8 +514,9 @@ public:
             }
         }
 
-        si.n          = m_frame.n;
-        si.sh_frame.n = m_frame.n;
+        si.n = m_frame.n;
+        if (likely(has_flag(ray_flags, RayFlags::ShadingFrame)))
+            si.sh_frame.n = m_frame.n;
 
         si.dn_du = si.dn_dv = dr::zeros<Vector3f>();
         si.shape    = this;
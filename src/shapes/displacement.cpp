@@ -0,0 +1,256 @@
+#include <mitsuba/render/mesh.h>
+#include <mitsuba/render/texture.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/timer.h>
+#include <mitsuba/core/util.h>
+#include <array>
+#include <cstring>
+#include <unordered_map>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**!
+
+.. _shape-displacement:
+
+Displaced mesh (:monosp:`displacement`)
+---------------------------------------
+
+.. pluginparameters::
+
+ * - (Nested plugin)
+   - |shape|
+   - One or more triangle meshes with texture coordinates that specify the
+     base surface.
+
+ * - displacement
+   - |texture|
+   - Scalar displacement texture, which is evaluated at the UV coordinates
+     of the tessellated mesh.
+
+ * - scale
+   - |float|
+   - Scale factor of the displacement texture. (Default: 1)
+
+ * - levels
+   - |int|
+   - Maximum number of subdivision steps that are applied before displacing
+     the vertices. (Default: 4)
+
+ * - max_edge_length
+   - |float|
+   - When set, a mesh is only subdivided until none of its edges is longer
+     than this value. (Default: 0, i.e. always apply ``levels`` subdivision
+     steps)
+
+ * - smooth
+   - |bool|
+   - Refine the base mesh using Loop subdivision (see the :ref:`subdivision
+     <shape-subdivision>` shape)? Otherwise, the triangles are tessellated
+     without changing the shape of the base mesh. (Default: false)
+
+Unlike the :ref:`normalmap <bsdf-normalmap>` and :ref:`bumpmap
+<bsdf-bumpmap>` BSDFs, which only perturb the shading normals, this plugin
+displaces the actual geometry of a mesh. The base mesh is tessellated when
+the scene is loaded, and every vertex of the tessellation is then moved along
+the normal of the base surface by the texture value times ``scale``.
+
+Vertices that are shared by several faces but were duplicated in the mesh
+(e.g. along seams of the UV parameterization) are displaced by their average
+displacement, hence the displaced surface remains watertight. The vertex
+normals of the base mesh (if any) are recomputed afterwards.
+
+The number of triangles grows by a factor of 4 with every subdivision step.
+The resolution of the tessellation should therefore be matched to the
+feature size of the displacement texture via ``max_edge_length``.
+
+.. tabs::
+    .. code-tab:: xml
+        :name: displacement-shape
+
+        <shape type="displacement">
+            <float name="scale" value="0.05"/>
+            <float name="max_edge_length" value="0.005"/>
+            <integer name="levels" value="8"/>
+            <texture type="bitmap" name="displacement">
+                <string name="filename" value="height.exr"/>
+                <boolean name="raw" value="true"/>
+            </texture>
+
+            <shape type="ply">
+                <string name="filename" value="base.ply"/>
+            </shape>
+        </shape>
+
+    .. code-tab:: python
+
+        'type': 'displacement',
+        'scale': 0.05,
+        'max_edge_length': 0.005,
+        'levels': 8,
+        'displacement': {
+            'type': 'bitmap',
+            'filename': 'height.exr',
+            'raw': True
+        },
+        'base': {
+            'type': 'ply',
+            'filename': 'base.ply'
+        }
+ */
+
+template <typename Float, typename Spectrum>
+class DisplacementShape final : public Shape<Float, Spectrum> {
+public:
+    MI_IMPORT_BASE(Shape)
+    MI_IMPORT_TYPES(Mesh, Texture)
+
+    using InputFloat    = typename Mesh::InputFloat;
+    using InputPoint3f  = typename Mesh::InputPoint3f;
+    using InputVector3f = typename Mesh::InputVector3f;
+    using FloatStorage  = typename Mesh::FloatStorage;
+    using ScalarIndex   = typename Mesh::ScalarIndex;
+
+    DisplacementShape(const Properties &props) {
+        m_displacement = props.texture<Texture>("displacement");
+        m_scale = props.get<ScalarFloat>("scale", 1.f);
+        uint32_t levels = props.get<uint32_t>("levels", 4);
+        ScalarFloat max_edge_length = props.get<ScalarFloat>("max_edge_length", 0.f);
+        bool smooth = props.get<bool>("smooth", false);
+        if (max_edge_length < 0.f)
+            Throw("The \"max_edge_length\" parameter must be non-negative!");
+
+        Timer timer;
+        for (auto [unused, object] : props.objects()) {
+            if (dynamic_cast<Texture *>(object.get()))
+                continue;
+
+            const Mesh *base = dynamic_cast<const Mesh *>(object.get());
+            if (!base)
+                Throw("Only triangle meshes can be displaced (got %s)!",
+                      object->to_string());
+            if (!base->has_vertex_texcoords())
+                Throw("The displaced mesh \"%s\" must have texture coordinates!",
+                      base->id());
+
+            ref<Mesh> mesh = base->subdivide(levels, max_edge_length, smooth);
+            displace(mesh);
+            m_objects.push_back(mesh);
+        }
+
+        if (m_objects.empty())
+            Throw("The displacement shape requires at least one nested mesh!");
+
+        if (m_objects.size() == 1)
+            m_objects[0]->set_id(props.id());
+
+        Log(Debug, "Displaced %zu meshes (took %s)", m_objects.size(),
+            util::time_string((float) timer.value()));
+    }
+
+    std::vector<ref<Object>> expand() const override {
+        return m_objects;
+    }
+
+    ScalarBoundingBox3f bbox() const override { return ScalarBoundingBox3f(); }
+
+    MI_DECLARE_CLASS()
+
+private:
+    /// Move the vertices of \c mesh along the normals of the surface
+    void displace(Mesh *mesh) const {
+        dr::suspend_grad<Float> scope;
+        size_t vertex_count = mesh->vertex_count(),
+               face_count   = mesh->face_count();
+
+        // 1. Evaluate the displacement texture at every vertex
+        auto eval_displacement = [&](const UInt32 &index) {
+            SurfaceInteraction3f si = dr::zeros<SurfaceInteraction3f>();
+            si.p  = mesh->vertex_position(index);
+            si.uv = mesh->vertex_texcoord(index);
+            return m_displacement->eval_1(si);
+        };
+
+        std::vector<InputFloat> displacement(vertex_count);
+        if constexpr (dr::is_jit_v<Float>) {
+            Float values =
+                eval_displacement(dr::arange<UInt32>((uint32_t) vertex_count));
+            auto &&values_host = dr::migrate(dr::detach(values), AllocType::Host);
+            dr::sync_thread();
+            for (size_t i = 0; i < vertex_count; ++i)
+                displacement[i] = (InputFloat) values_host.data()[i];
+        } else {
+            for (ScalarIndex i = 0; i < vertex_count; ++i)
+                displacement[i] = (InputFloat) eval_displacement(i);
+        }
+
+        auto &&positions_host = dr::migrate(mesh->vertex_positions_buffer(), AllocType::Host);
+        auto &&faces_host = dr::migrate(mesh->faces_buffer(), AllocType::Host);
+        if constexpr (dr::is_jit_v<Float>)
+            dr::sync_thread();
+        std::vector<InputFloat> positions(positions_host.data(),
+                                          positions_host.data() + vertex_count * 3);
+        const ScalarIndex *faces = faces_host.data();
+
+        // 2. Weld the vertices by position
+        struct Hasher {
+            size_t operator()(const std::array<uint32_t, 3> &k) const {
+                return std::hash<uint64_t>()(
+                    ((uint64_t) k[0] << 32 | k[1]) ^ ((uint64_t) k[2] * 0x9e3779b97f4a7c15ull));
+            }
+        };
+        std::unordered_map<std::array<uint32_t, 3>, uint32_t, Hasher> lookup;
+        std::vector<uint32_t> weld(vertex_count);
+        for (size_t i = 0; i < vertex_count; ++i) {
+            std::array<uint32_t, 3> key;
+            std::memcpy(key.data(), positions.data() + 3 * i, sizeof(key));
+            weld[i] = lookup.try_emplace(key, (uint32_t) lookup.size()).first->second;
+        }
+
+        /* 3. Accumulate the area-weighted face normals and the displacement
+              of the welded vertices */
+        size_t point_count = lookup.size();
+        std::vector<InputVector3f> normals(point_count, InputVector3f(0.f));
+        std::vector<InputFloat> sum(point_count, 0.f);
+        std::vector<uint32_t> count(point_count, 0);
+
+        for (size_t i = 0; i < face_count; ++i) {
+            const ScalarIndex *f = faces + 3 * i;
+            InputPoint3f p0 = dr::load<InputPoint3f>(positions.data() + 3 * f[0]),
+                         p1 = dr::load<InputPoint3f>(positions.data() + 3 * f[1]),
+                         p2 = dr::load<InputPoint3f>(positions.data() + 3 * f[2]);
+            InputVector3f n = dr::cross(p1 - p0, p2 - p0);
+            for (size_t j = 0; j < 3; ++j)
+                normals[weld[f[j]]] += n;
+        }
+
+        for (size_t i = 0; i < vertex_count; ++i) {
+            sum[weld[i]] += displacement[i];
+            count[weld[i]]++;
+        }
+
+        // 4. Displace the vertices
+        for (size_t i = 0; i < vertex_count; ++i) {
+            uint32_t k = weld[i];
+            InputFloat length = dr::norm(normals[k]);
+            if (length == 0.f)
+                continue;
+            InputFloat offset = (InputFloat) m_scale * sum[k] / (InputFloat) count[k];
+            InputPoint3f p = dr::load<InputPoint3f>(positions.data() + 3 * i);
+            dr::store(positions.data() + 3 * i, p + normals[k] * (offset / length));
+        }
+
+        mesh->vertex_positions_buffer() =
+            dr::load<FloatStorage>(positions.data(), positions.size());
+        mesh->parameters_changed({ "vertex_positions" });
+    }
+
+private:
+    ref<Texture> m_displacement;
+    ScalarFloat m_scale;
+    std::vector<ref<Object>> m_objects;
+};
+
+MI_IMPLEMENT_CLASS_VARIANT(DisplacementShape, Shape)
+MI_EXPORT_PLUGIN(DisplacementShape, "Displaced mesh");
+NAMESPACE_END(mitsuba)
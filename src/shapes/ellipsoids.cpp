@@ -0,0 +1,816 @@
+#include <mitsuba/core/fwd.h>
+#include <mitsuba/core/math.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/string.h>
+#include <mitsuba/core/transform.h>
+#include <mitsuba/core/util.h>
+#include <mitsuba/core/timer.h>
+#include <mitsuba/render/fwd.h>
+#include <mitsuba/render/interaction.h>
+#include <mitsuba/render/shape.h>
+#include <mitsuba/render/srgb.h>
+
+#if defined(MI_ENABLE_EMBREE)
+#include <embree3/rtcore.h>
+#endif
+
+#if defined(MI_ENABLE_CUDA)
+#include "optix/ellipsoids.cuh"
+#endif
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**!
+
+.. _shape-ellipsoids:
+
+Ellipsoid cloud (:monosp:`ellipsoids`)
+--------------------------------------
+
+.. pluginparameters::
+ :extra-rows: 2
+
+ * - centers
+   - |tensor|
+   - Tensor of shape ``(N, 3)`` with the centers of the ellipsoids.
+
+ * - scales
+   - |tensor|
+   - Tensor of shape ``(N, 3)`` with the standard deviations of the Gaussian
+     associated with every ellipsoid, along its three principal axes.
+
+ * - quaternions
+   - |tensor|
+   - Tensor of shape ``(N, 4)`` with the orientation of every ellipsoid, given
+     as a unit quaternion with components ``(x, y, z, w)``. The quaternions
+     are normalized when the shape is loaded. (Default: no rotation)
+
+ * - opacities
+   - |tensor|
+   - Tensor of shape ``(N)`` or ``(N, 1)`` with the opacity of every
+     ellipsoid. (Default: 1.0)
+
+ * - extent
+   - |float|
+   - Number of standard deviations covered by the ellipsoids. (Default: 3.0)
+
+ * - particle_*
+   - |tensor|
+   - Optional per-ellipsoid attributes, given as tensors of shape ``(N)``,
+     ``(N, 1)`` or ``(N, 3)``. They can be looked up using the
+     :ref:`mesh_attribute <texture-meshattribute>` texture.
+   - |exposed|, |differentiable|
+
+ * - to_world
+   - |transform|
+   - Specifies a linear object-to-world transformation that is applied to the
+     centers. Note that the orientations and scales are invariant to this
+     transformation!
+
+ * - ellipsoid_count
+   - |int|
+   - Total number of ellipsoids
+   - |exposed|
+
+ * - data
+   - :paramtype:`float[]`
+   - Flattened ellipsoid buffer pre-multiplied by the object-to-world
+     transformation. Each ellipsoid in the buffer is structured as follows:
+     center_x, center_y, center_z, opacity, quat_x, quat_y, quat_z, quat_w,
+     scale_x, scale_y, scale_z, (unused)
+   - |exposed|
+
+This shape plugin describes a large collection of oriented ellipsoids as a
+single shape, e.g. the anisotropic Gaussians of a splat-based scene
+reconstruction. As with the :ref:`spheres <shape-spheres>` plugin, all
+ellipsoids are stored in one buffer and are intersected as the primitives of a
+single shape. Every ellipsoid only occupies 12 floats, and its bounding box is
+computed from its orientation, which is much tighter than the bounding box of
+its enclosing sphere for elongated or flat ellipsoids.
+
+The surface of an ellipsoid is the level set of its Gaussian at ``extent``
+standard deviations. Rays are intersected with it after being transformed into
+the space where the ellipsoid is a unit sphere. Embree and OptiX trace the
+ellipsoids as custom primitives, and the other variants use the kd-tree.
+
+Splat-based rendering is supported through the built-in ``splat_alpha``
+attribute. For a ray entering an ellipsoid, it evaluates the opacity of the
+ellipsoid weighted by the largest value of its Gaussian along the ray, and it
+is zero when the ray leaves the ellipsoid. Using this attribute as the opacity
+of a :ref:`mask <bsdf-mask>` BSDF blends the Gaussians hit by a ray
+stochastically in front-to-back order, which accumulates their contributions
+as in splat rasterization without sorting them.
+
+.. tabs::
+    .. code-tab:: python
+
+        'splats': {
+            'type': 'ellipsoids',
+            'centers': mi.TensorXf(centers),           # shape (N, 3)
+            'scales': mi.TensorXf(scales),             # shape (N, 3)
+            'quaternions': mi.TensorXf(quaternions),   # shape (N, 4)
+            'opacities': mi.TensorXf(opacities),       # shape (N)
+            'particle_color': mi.TensorXf(colors),     # shape (N, 3)
+            'bsdf': {
+                'type': 'mask',
+                'opacity': {
+                    'type': 'mesh_attribute',
+                    'name': 'splat_alpha'
+                },
+                'material': {
+                    'type': 'diffuse',
+                    'reflectance': {
+                        'type': 'mesh_attribute',
+                        'name': 'particle_color'
+                    }
+                }
+            }
+        }
+
+.. note:: This plugin is only available from Python, since tensor-valued
+          properties can't be specified in XML scene descriptions.
+ */
+
+template <typename Float, typename Spectrum>
+class Ellipsoids final : public Shape<Float, Spectrum> {
+public:
+    MI_IMPORT_BASE(Shape, m_to_world, m_is_instance, initialize, mark_dirty,
+                   get_children_string)
+    MI_IMPORT_TYPES()
+
+    using typename Base::ScalarIndex;
+    using typename Base::ScalarSize;
+
+    using InputFloat = float;
+    using FloatStorage = DynamicBuffer<dr::replace_scalar_t<Float, InputFloat>>;
+
+    /// Number of floats per ellipsoid in the data buffer
+    static constexpr size_t Stride = 12;
+
+    /// Per-ellipsoid attribute
+    struct ParticleAttribute {
+        size_t size;
+        FloatStorage buf;
+    };
+
+    Ellipsoids(const Properties &props) : Base(props) {
+        ScopedPhase phase(ProfilerPhase::LoadGeometry);
+        Timer timer;
+
+        m_extent = props.get<ScalarFloat>("extent", 3.f);
+        if (!(m_extent > 0.f))
+            Throw("Ellipsoids: \"extent\" must be positive!");
+
+        // 1. Centers, orientations, scales and opacities
+        const TensorXf *centers = tensor_property(props, "centers");
+        if (centers->ndim() != 2 || centers->shape(1) != 3)
+            Throw("Ellipsoids: \"centers\" must be a tensor of shape (N, 3)!");
+
+        size_t count = centers->shape(0);
+        if (count == 0)
+            Throw("Ellipsoids: expected at least one ellipsoid!");
+        if (count > 0xffffffffu)
+            Throw("Ellipsoids: too many ellipsoids!");
+        m_ellipsoid_count = (ScalarSize) count;
+
+        const TensorXf *scales = tensor_property(props, "scales");
+        if (scales->ndim() != 2 || scales->shape(0) != count ||
+            scales->shape(1) != 3)
+            Throw("Ellipsoids: \"scales\" must be a tensor of shape (N, 3) "
+                  "with N = %zu!", count);
+
+        const TensorXf *quaternions = nullptr;
+        if (props.has_property("quaternions")) {
+            quaternions = tensor_property(props, "quaternions");
+            if (quaternions->ndim() != 2 || quaternions->shape(0) != count ||
+                quaternions->shape(1) != 4)
+                Throw("Ellipsoids: \"quaternions\" must be a tensor of shape "
+                      "(N, 4) with N = %zu!", count);
+        }
+
+        const TensorXf *opacities = nullptr;
+        if (props.has_property("opacities")) {
+            opacities = tensor_property(props, "opacities");
+            if (dr::width(opacities->array()) != count ||
+                opacities->ndim() > 2 ||
+                (opacities->ndim() == 2 && opacities->shape(1) != 1))
+                Throw("Ellipsoids: \"opacities\" must be a tensor of shape (N) "
+                      "or (N, 1) with N = %zu!", count);
+        }
+
+        auto &&centers_host = dr::migrate(centers->array(), AllocType::Host);
+        auto &&scales_host  = dr::migrate(scales->array(), AllocType::Host);
+        auto &&quats_host   = quaternions
+                                  ? dr::migrate(quaternions->array(), AllocType::Host)
+                                  : DynamicBuffer<Float>();
+        auto &&opacities_host = opacities
+                                    ? dr::migrate(opacities->array(), AllocType::Host)
+                                    : DynamicBuffer<Float>();
+        if constexpr (dr::is_jit_v<Float>)
+            dr::sync_thread();
+
+        const ScalarFloat *c_ptr = centers_host.data(),
+                          *s_ptr = scales_host.data(),
+                          *q_ptr = quaternions ? quats_host.data() : nullptr,
+                          *o_ptr = opacities ? opacities_host.data() : nullptr;
+        const ScalarTransform4f &to_world = m_to_world.scalar();
+
+        std::unique_ptr<InputFloat[]> data =
+            std::make_unique<InputFloat[]>(count * Stride);
+        for (size_t i = 0; i < count; ++i) {
+            ScalarPoint3f p = to_world.transform_affine(
+                ScalarPoint3f(c_ptr[3 * i + 0], c_ptr[3 * i + 1], c_ptr[3 * i + 2]));
+            ScalarVector3f s(s_ptr[3 * i + 0], s_ptr[3 * i + 1], s_ptr[3 * i + 2]);
+            ScalarVector4f q = q_ptr ? ScalarVector4f(q_ptr[4 * i + 0], q_ptr[4 * i + 1],
+                                                      q_ptr[4 * i + 2], q_ptr[4 * i + 3])
+                                     : ScalarVector4f(0.f, 0.f, 0.f, 1.f);
+            ScalarFloat opacity = o_ptr ? o_ptr[i] : 1.f;
+
+            ScalarFloat q_norm = dr::norm(q);
+            if (unlikely(!dr::all(dr::isfinite(p)) || !dr::all(dr::isfinite(s)) ||
+                         dr::any(s <= 0.f) || !(q_norm > 0.f) ||
+                         !dr::isfinite(q_norm) || !dr::isfinite(opacity)))
+                Throw("Ellipsoids: ellipsoid %zu has an invalid center, scale "
+                      "or orientation!", i);
+            q /= q_norm;
+
+            InputFloat *e = data.get() + Stride * i;
+            dr::store(e + 0, dr::Array<InputFloat, 4>(
+                (InputFloat) p.x(), (InputFloat) p.y(), (InputFloat) p.z(),
+                (InputFloat) opacity));
+            dr::store(e + 4, dr::Array<InputFloat, 4>(q));
+            dr::store(e + 8, dr::Array<InputFloat, 4>(
+                (InputFloat) s.x(), (InputFloat) s.y(), (InputFloat) s.z(), 0.f));
+        }
+        m_data = dr::load<FloatStorage>(data.get(), count * Stride);
+
+        // 2. Per-ellipsoid attributes
+        for (const std::string &name : props.property_names()) {
+            if (!string::starts_with(name, "particle_"))
+                continue;
+            if (props.type(name) != Properties::Type::Tensor)
+                Throw("Ellipsoids: attribute \"%s\" must be a tensor!", name);
+            add_attribute(name, *props.tensor<TensorXf>(name));
+        }
+
+        update_host_pointers();
+        recompute_bbox();
+
+        Log(Debug, "Ellipsoids: read %u ellipsoids (%s in %s)", m_ellipsoid_count,
+            util::mem_string(count * Stride * sizeof(InputFloat)),
+            util::time_string((float) timer.value()));
+
+        initialize();
+    }
+
+    ~Ellipsoids() {
+#if defined(MI_ENABLE_CUDA)
+        if (m_device_bboxes)
+            jit_free(m_device_bboxes);
+#endif
+    }
+
+    ScalarSize primitive_count() const override { return m_ellipsoid_count; }
+
+    ScalarBoundingBox3f bbox() const override { return m_bbox; }
+
+    SurfaceInteraction3f compute_surface_interaction(const Ray3f &ray,
+                                                     const PreliminaryIntersection3f &pi,
+                                                     uint32_t ray_flags,
+                                                     uint32_t recursion_depth,
+                                                     Mask active) const override {
+        MI_MASK_ARGUMENT(active);
+
+        // Early exit when tracing isn't necessary
+        if (!m_is_instance && recursion_depth > 0)
+            return dr::zeros<SurfaceInteraction3f>();
+
+        bool need_dn_duv = has_flag(ray_flags, RayFlags::dNSdUV) ||
+                           has_flag(ray_flags, RayFlags::dNGdUV);
+        bool need_dp_duv = has_flag(ray_flags, RayFlags::dPdUV) || need_dn_duv;
+        bool need_uv     = has_flag(ray_flags, RayFlags::UV) || need_dp_duv;
+
+        auto [center, opacity, quat, radii] = gather_ellipsoid(pi.prim_index, active);
+        DRJIT_MARK_USED(opacity);
+
+        SurfaceInteraction3f si = dr::zeros<SurfaceInteraction3f>();
+        si.t = dr::select(active, pi.t, dr::Infinity<Float>);
+
+        /* Position on the unit sphere obtained by mapping the ellipsoid to
+           its local frame and dividing by its radii. Re-project onto the
+           ellipsoid to improve accuracy */
+        Vector3f local =
+            dr::normalize(rotate(quat, ray(pi.t) - center, true) / radii);
+        si.p = center + rotate(quat, local * radii);
+
+        Vector3f n_unnormalized = rotate(quat, local / radii);
+        Float inv_n_norm = dr::rsqrt(dr::squared_norm(n_unnormalized));
+        si.n = si.sh_frame.n = n_unnormalized * inv_n_norm;
+
+        Vector3f dl_du, dl_dv;
+        if (likely(need_uv)) {
+            Float rd_2  = dr::sqr(local.x()) + dr::sqr(local.y()),
+                  theta = unit_angle_z(local),
+                  phi   = dr::atan2(local.y(), local.x());
+
+            dr::masked(phi, phi < 0.f) += 2.f * dr::Pi<Float>;
+
+            si.uv = Point2f(phi * dr::InvTwoPi<Float>, theta * dr::InvPi<Float>);
+            if (likely(need_dp_duv)) {
+                dl_du = Vector3f(-local.y(), local.x(), 0.f);
+
+                Float rd      = dr::sqrt(rd_2),
+                      inv_rd  = dr::rcp(rd),
+                      cos_phi = local.x() * inv_rd,
+                      sin_phi = local.y() * inv_rd;
+
+                dl_dv = Vector3f(local.z() * cos_phi,
+                                 local.z() * sin_phi,
+                                 -rd);
+
+                Mask singularity_mask = active && dr::eq(rd, 0.f);
+                if (unlikely(dr::any_or<true>(singularity_mask)))
+                    dl_dv[singularity_mask] = Vector3f(1.f, 0.f, 0.f);
+
+                dl_du *= dr::TwoPi<Float>;
+                dl_dv *= dr::Pi<Float>;
+
+                si.dp_du = rotate(quat, dl_du * radii);
+                si.dp_dv = rotate(quat, dl_dv * radii);
+            }
+        }
+
+        if (need_dn_duv) {
+            // Derivative of the normalized gradient of the implicit function
+            Vector3f dnu_du = rotate(quat, dl_du / radii),
+                     dnu_dv = rotate(quat, dl_dv / radii);
+            si.dn_du = (dnu_du - si.n * dr::dot(si.n, dnu_du)) * inv_n_norm;
+            si.dn_dv = (dnu_dv - si.n * dr::dot(si.n, dnu_dv)) * inv_n_norm;
+        }
+
+        si.shape    = this;
+        si.instance = nullptr;
+
+        return si;
+    }
+
+    // =============================================================
+    //! @{ \name Per-ellipsoid attributes
+    // =============================================================
+
+    Mask has_attribute(const std::string &name, Mask active) const override {
+        if (name == "splat_alpha")
+            return true;
+        if (m_attributes.find(name) == m_attributes.end())
+            return Base::has_attribute(name, active);
+        return true;
+    }
+
+    UnpolarizedSpectrum eval_attribute(const std::string &name,
+                                       const SurfaceInteraction3f &si,
+                                       Mask active) const override {
+        if (name == "splat_alpha")
+            return splat_alpha(si, active);
+
+        const auto &it = m_attributes.find(name);
+        if (it == m_attributes.end())
+            return Base::eval_attribute(name, si, active);
+
+        const ParticleAttribute &attr = it->second;
+        if (attr.size == 1) {
+            return dr::gather<Float>(attr.buf, si.prim_index, active);
+        } else {
+            Color3f value = dr::gather<Color3f>(attr.buf, si.prim_index, active);
+            if constexpr (is_monochromatic_v<Spectrum>)
+                return luminance(value);
+            else if constexpr (is_spectral_v<Spectrum>)
+                return srgb_model_eval<UnpolarizedSpectrum>(value, si.wavelengths);
+            else
+                return value;
+        }
+    }
+
+    Float eval_attribute_1(const std::string &name,
+                           const SurfaceInteraction3f &si,
+                           Mask active) const override {
+        if (name == "splat_alpha")
+            return splat_alpha(si, active);
+
+        const auto &it = m_attributes.find(name);
+        if (it == m_attributes.end())
+            return Base::eval_attribute_1(name, si, active);
+
+        const ParticleAttribute &attr = it->second;
+        if (attr.size == 1) {
+            return dr::gather<Float>(attr.buf, si.prim_index, active);
+        } else {
+            if constexpr (dr::is_jit_v<Float>)
+                return 0.f;
+            else
+                Throw("eval_attribute_1(): Attribute \"%s\" requested but had size %u.",
+                      name, attr.size);
+        }
+    }
+
+    Color3f eval_attribute_3(const std::string &name,
+                             const SurfaceInteraction3f &si,
+                             Mask active) const override {
+        if (name == "splat_alpha")
+            return Color3f(splat_alpha(si, active));
+
+        const auto &it = m_attributes.find(name);
+        if (it == m_attributes.end())
+            return Base::eval_attribute_3(name, si, active);
+
+        const ParticleAttribute &attr = it->second;
+        if (attr.size == 3) {
+            return dr::gather<Color3f>(attr.buf, si.prim_index, active);
+        } else {
+            if constexpr (dr::is_jit_v<Float>)
+                return 0.f;
+            else
+                Throw("eval_attribute_3(): Attribute \"%s\" requested but had size %u.",
+                      name, attr.size);
+        }
+    }
+
+    //! @}
+    // =============================================================
+
+    void traverse(TraversalCallback *callback) override {
+        Base::traverse(callback);
+        callback->put_parameter("ellipsoid_count", m_ellipsoid_count, +ParamFlags::NonDifferentiable);
+        callback->put_parameter("data",            m_data,            +ParamFlags::NonDifferentiable);
+        for (auto &[name, attr] : m_attributes)
+            callback->put_parameter(name, attr.buf, +ParamFlags::Differentiable);
+    }
+
+    void parameters_changed(const std::vector<std::string> &keys) override {
+        if (keys.empty() || string::contains(keys, "data")) {
+            if (dr::width(m_data) != Stride * (size_t) m_ellipsoid_count)
+                Throw("Ellipsoids: the number of ellipsoids can't be changed "
+                      "by updating the \"data\" buffer!");
+            update_host_pointers();
+            recompute_bbox();
+            mark_dirty();
+        }
+        Base::parameters_changed();
+    }
+
+#if defined(MI_ENABLE_EMBREE)
+    RTCGeometry embree_geometry(RTCDevice device) override {
+        RTCGeometry geom = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_USER);
+        rtcSetGeometryUserPrimitiveCount(geom, m_ellipsoid_count);
+        rtcSetGeometryUserData(geom, (void *) this);
+        rtcSetGeometryBoundsFunction(geom, embree_bounds, nullptr);
+        rtcSetGeometryIntersectFunction(geom, embree_intersect);
+        rtcSetGeometryOccludedFunction(geom, embree_occluded);
+        rtcCommitGeometry(geom);
+        return geom;
+    }
+#endif
+
+#if defined(MI_ENABLE_CUDA)
+    using Base::m_optix_data_ptr;
+
+    void optix_prepare_geometry() override {
+        if constexpr (dr::is_cuda_v<Float>) {
+            if (!m_optix_data_ptr)
+                m_optix_data_ptr =
+                    jit_malloc(AllocType::Device, sizeof(OptixEllipsoidsData));
+
+            dr::eval(m_data); // Make sure the buffer is evaluated
+            OptixEllipsoidsData data = { (float *) m_data.data(), m_extent };
+            jit_memcpy(JitBackend::CUDA, m_optix_data_ptr, &data,
+                       sizeof(OptixEllipsoidsData));
+        }
+    }
+
+    void optix_build_input(OptixBuildInput &build_input) const override {
+        build_input.type = OPTIX_BUILD_INPUT_TYPE_CUSTOM_PRIMITIVES;
+        build_input.customPrimitiveArray.aabbBuffers   = (CUdeviceptr *) &m_device_bboxes;
+        build_input.customPrimitiveArray.numPrimitives = m_ellipsoid_count;
+        build_input.customPrimitiveArray.strideInBytes = 6 * sizeof(float);
+        build_input.customPrimitiveArray.flags         = optix_geometry_flags;
+        build_input.customPrimitiveArray.numSbtRecords = 1;
+    }
+#endif
+
+    // =============================================================
+    //! @{ \name Native backend (kd-tree / BVH) support
+    // =============================================================
+
+    ScalarBoundingBox3f bbox(ScalarIndex index) const override {
+        auto [center, quat, radii] = host_ellipsoid(index);
+
+        /* Tight bounds of the rotated ellipsoid: the extent along axis i is
+           the norm of the i-th row of R * diag(radii) */
+        ScalarVector3f extents(0.f);
+        for (size_t j = 0; j < 3; ++j) {
+            ScalarVector3f axis(0.f);
+            axis[j] = radii[j];
+            extents += dr::sqr(rotate(quat, axis));
+        }
+        extents = dr::sqrt(extents);
+
+        return ScalarBoundingBox3f(center - extents, center + extents);
+    }
+
+    std::tuple<ScalarFloat, ScalarPoint2f, ScalarUInt32, ScalarUInt32>
+    ray_intersect_primitive_scalar(ScalarIndex index,
+                                   const ScalarRay3f &ray) const override {
+        return { intersect_ellipsoid(index, ray), ScalarPoint2f(0.f),
+                 (ScalarUInt32) -1, index };
+    }
+
+    bool ray_test_primitive_scalar(ScalarIndex index,
+                                   const ScalarRay3f &ray) const override {
+        return intersect_ellipsoid(index, ray) != dr::Infinity<ScalarFloat>;
+    }
+
+    //! @}
+    // =============================================================
+
+    std::string to_string() const override {
+        std::ostringstream oss;
+        oss << "Ellipsoids[" << std::endl
+            << "  ellipsoid_count = " << m_ellipsoid_count << "," << std::endl
+            << "  extent = " << m_extent << "," << std::endl
+            << "  attributes = [";
+        size_t i = 0;
+        for (const auto &[name, attr] : m_attributes)
+            oss << (i++ > 0 ? ", " : "") << name;
+        oss << "]," << std::endl
+            << "  " << string::indent(get_children_string()) << std::endl
+            << "]";
+        return oss.str();
+    }
+
+    MI_DECLARE_CLASS()
+
+private:
+    /// Look up a tensor-valued property
+    static const TensorXf *tensor_property(const Properties &props,
+                                           const std::string &name) {
+        if (!props.has_property(name))
+            Throw("Ellipsoids: the \"%s\" parameter must be specified!", name);
+        return props.tensor<TensorXf>(name);
+    }
+
+    void add_attribute(const std::string &name, const TensorXf &tensor) {
+        size_t dim = tensor.ndim() == 2 ? tensor.shape(1) : 1;
+        if (tensor.ndim() > 2 || (dim != 1 && dim != 3) ||
+            tensor.shape(0) != m_ellipsoid_count)
+            Throw("Ellipsoids: attribute \"%s\" must be a tensor of shape (N), "
+                  "(N, 1) or (N, 3) with N = %u!", name, m_ellipsoid_count);
+
+        auto &&values = dr::migrate(tensor.array(), AllocType::Host);
+        if constexpr (dr::is_jit_v<Float>)
+            dr::sync_thread();
+
+        std::vector<InputFloat> data(values.data(),
+                                     values.data() + m_ellipsoid_count * dim);
+
+        // In spectral modes, convert RGB color to srgb model coefs if attribute name contains 'color'
+        if constexpr (is_spectral_v<Spectrum>) {
+            if (dim == 3 && name.find("color") != std::string::npos) {
+                srgb_model_fetch(data.data(), m_ellipsoid_count);
+            }
+        }
+
+        m_attributes.insert(
+            { name, { dim, dr::load<FloatStorage>(data.data(), data.size()) } });
+    }
+
+    /**
+     * \brief Rotate a vector by a unit quaternion <tt>(x, y, z, w)</tt>, or by
+     * its inverse when \c inverse is set
+     */
+    template <typename Vector4, typename Vector3>
+    static Vector3 rotate(const Vector4 &q, const Vector3 &v, bool inverse = false) {
+        Vector3 qv(q.x(), q.y(), q.z());
+        if (inverse)
+            qv = -qv;
+        Vector3 t = 2.f * dr::cross(qv, v);
+        return v + q.w() * t + dr::cross(qv, t);
+    }
+
+    /// Fetch the center, opacity, orientation and radii of the ellipsoids
+    std::tuple<Point3f, Float, Vector4f, Vector3f>
+    gather_ellipsoid(const UInt32 &index, Mask active) const {
+        UInt32 offset = index * (uint32_t) (Stride / 4);
+        Vector4f c = dr::gather<Vector4f>(m_data, offset, active),
+                 q = dr::gather<Vector4f>(m_data, offset + 1, active),
+                 s = dr::gather<Vector4f>(m_data, offset + 2, active);
+        return { Point3f(c.x(), c.y(), c.z()), c.w(), q,
+                 Vector3f(s.x(), s.y(), s.z()) * m_extent };
+    }
+
+    /**
+     * \brief Evaluate the \c splat_alpha attribute
+     *
+     * The largest value of a Gaussian along a ray is reached at the point of
+     * the ray that is closest to its center with respect to the Mahalanobis
+     * distance. It is evaluated when the ray enters the ellipsoid, and
+     * exiting rays receive a value of zero so that every ellipsoid is only
+     * accounted for once along a ray.
+     */
+    Float splat_alpha(const SurfaceInteraction3f &si, Mask active) const {
+        auto [center, opacity, quat, radii] = gather_ellipsoid(si.prim_index, active);
+        Vector3f sigma = radii / m_extent,
+                 d = -si.to_world(si.wi);
+
+        Vector3f x  = rotate(quat, si.p - center, true) / sigma,
+                 dl = rotate(quat, d, true) / sigma;
+
+        Float dist2 = dr::squared_norm(x) -
+                      dr::sqr(dr::dot(x, dl)) / dr::squared_norm(dl);
+        Float alpha = opacity * dr::exp(-.5f * dr::maximum(dist2, 0.f));
+
+        return dr::select(active && dr::dot(d, si.n) < 0.f,
+                          dr::clamp(alpha, 0.f, 1.f), 0.f);
+    }
+
+    /// Recompute the bounding boxes of the shape and of its ellipsoids
+    void recompute_bbox() {
+        std::unique_ptr<float[]> aabbs;
+        if constexpr (dr::is_cuda_v<Float>)
+            aabbs = std::make_unique<float[]>(6 * (size_t) m_ellipsoid_count);
+
+        m_bbox.reset();
+        for (ScalarSize i = 0; i < m_ellipsoid_count; ++i) {
+            ScalarBoundingBox3f b = bbox(i);
+            m_bbox.expand(b);
+            if constexpr (dr::is_cuda_v<Float>) {
+                float *out = aabbs.get() + 6 * i;
+                for (size_t k = 0; k < 3; ++k) {
+                    out[k]     = (float) b.min[k];
+                    out[k + 3] = (float) b.max[k];
+                }
+            }
+        }
+
+#if defined(MI_ENABLE_CUDA)
+        if constexpr (dr::is_cuda_v<Float>) {
+            size_t size = 6 * sizeof(float) * m_ellipsoid_count;
+            if (!m_device_bboxes)
+                m_device_bboxes = jit_malloc(AllocType::Device, size);
+            jit_memcpy(JitBackend::CUDA, m_device_bboxes, aabbs.get(), size);
+        }
+#endif
+    }
+
+    /**
+     * \brief Make the ellipsoid data accessible to the scalar routines that
+     * compute bounding boxes and intersections
+     */
+    void update_host_pointers() {
+        if constexpr (dr::is_jit_v<Float>) {
+            dr::eval(m_data);
+            m_host_data_storage = dr::migrate(m_data, AllocType::Host);
+            dr::sync_thread();
+            m_host_data = m_host_data_storage.data();
+        } else {
+            m_host_data = m_data.data();
+        }
+    }
+
+    /// Return the center, orientation and radii of an ellipsoid (host data)
+    std::tuple<ScalarPoint3f, ScalarVector4f, ScalarVector3f>
+    host_ellipsoid(ScalarIndex index) const {
+        const InputFloat *e = m_host_data + Stride * index;
+        return { ScalarPoint3f(e[0], e[1], e[2]),
+                 ScalarVector4f(e[4], e[5], e[6], e[7]),
+                 ScalarVector3f(e[8], e[9], e[10]) * m_extent };
+    }
+
+    /**
+     * \brief Intersect a ray with an ellipsoid (native backend and Embree)
+     *
+     * The ray is mapped to the space where the ellipsoid is a unit sphere,
+     * which preserves the distances along it, and is then intersected as in
+     * the \c spheres plugin.
+     * \return The distance along the ray, or infinity
+     */
+    ScalarFloat intersect_ellipsoid(ScalarIndex index, const ScalarRay3f &ray) const {
+        using Vector3d = Vector<double, 3>;
+        using Vector4d = Vector<double, 4>;
+
+        auto [center, quat_, radii_] = host_ellipsoid(index);
+        Vector4d quat(quat_);
+        Vector3d radii(radii_);
+        double maxt = ray.maxt;
+
+        Vector3d l = rotate(quat, Vector3d(ray.o) - Vector3d(center), true) / radii,
+                 d = rotate(quat, Vector3d(ray.d), true) / radii;
+
+        // Move the origin to the plane that contains the center and that is
+        // perpendicular to the ray direction
+        double plane_t = dr::dot(-l, d) / dr::squared_norm(d);
+        Vector3d o = l + plane_t * d;
+        if (dr::squared_norm(o) > 1.)
+            return dr::Infinity<ScalarFloat>;
+
+        auto [solution_found, near_t, far_t] = math::solve_quadratic(
+            dr::squared_norm(d), 2. * dr::dot(o, d), dr::squared_norm(o) - 1.);
+        near_t += plane_t;
+        far_t += plane_t;
+
+        // NaN-aware conditionals
+        if (!solution_found || !(near_t <= maxt && far_t >= 0.) ||
+            (near_t < 0. && far_t > maxt))
+            return dr::Infinity<ScalarFloat>;
+
+        return (ScalarFloat) (near_t < 0. ? far_t : near_t);
+    }
+
+#if defined(MI_ENABLE_EMBREE)
+    static void embree_bounds(const RTCBoundsFunctionArguments *args) {
+        const Ellipsoids *shape = (const Ellipsoids *) args->geometryUserPtr;
+        ScalarBoundingBox3f b = shape->bbox(args->primID);
+        RTCBounds *out = args->bounds_o;
+        out->lower_x = (float) b.min.x(); out->upper_x = (float) b.max.x();
+        out->lower_y = (float) b.min.y(); out->upper_y = (float) b.max.y();
+        out->lower_z = (float) b.min.z(); out->upper_z = (float) b.max.z();
+    }
+
+    /// Construct the ray of lane \c i of an Embree ray packet
+    static ScalarRay3f embree_ray(RTCRayN *rays, unsigned int N, unsigned int i) {
+        ScalarFloat tnear = RTCRayN_tnear(rays, N, i);
+        ScalarVector3f d(RTCRayN_dir_x(rays, N, i), RTCRayN_dir_y(rays, N, i),
+                         RTCRayN_dir_z(rays, N, i));
+        ScalarPoint3f o(RTCRayN_org_x(rays, N, i), RTCRayN_org_y(rays, N, i),
+                        RTCRayN_org_z(rays, N, i));
+        ScalarRay3f ray(o + tnear * d, d, RTCRayN_time(rays, N, i));
+        ray.maxt = RTCRayN_tfar(rays, N, i) - tnear;
+        return ray;
+    }
+
+    static void embree_intersect(const RTCIntersectFunctionNArguments *args) {
+        const Ellipsoids *shape = (const Ellipsoids *) args->geometryUserPtr;
+        RTCRayN *rays = RTCRayHitN_RayN(args->rayhit, args->N);
+        RTCHitN *hits = RTCRayHitN_HitN(args->rayhit, args->N);
+
+        for (unsigned int i = 0; i < args->N; ++i) {
+            if (!args->valid[i])
+                continue;
+            ScalarRay3f ray = embree_ray(rays, args->N, i);
+            ScalarFloat t = shape->intersect_ellipsoid(args->primID, ray);
+            if (t == dr::Infinity<ScalarFloat>)
+                continue;
+
+            RTCRayN_tfar(rays, args->N, i) = RTCRayN_tnear(rays, args->N, i) + t;
+            RTCHitN_u(hits, args->N, i)      = 0.f;
+            RTCHitN_v(hits, args->N, i)      = 0.f;
+            RTCHitN_Ng_x(hits, args->N, i)   = 0.f;
+            RTCHitN_Ng_y(hits, args->N, i)   = 0.f;
+            RTCHitN_Ng_z(hits, args->N, i)   = 0.f;
+            RTCHitN_primID(hits, args->N, i) = args->primID;
+            RTCHitN_geomID(hits, args->N, i) = args->geomID;
+            RTCHitN_instID(hits, args->N, i, 0) = args->context->instID[0];
+        }
+    }
+
+    static void embree_occluded(const RTCOccludedFunctionNArguments *args) {
+        const Ellipsoids *shape = (const Ellipsoids *) args->geometryUserPtr;
+        for (unsigned int i = 0; i < args->N; ++i) {
+            if (!args->valid[i])
+                continue;
+            ScalarRay3f ray = embree_ray(args->ray, args->N, i);
+            if (shape->intersect_ellipsoid(args->primID, ray) !=
+                dr::Infinity<ScalarFloat>)
+                RTCRayN_tfar(args->ray, args->N, i) = -dr::Infinity<float>;
+        }
+    }
+#endif
+
+private:
+    ScalarBoundingBox3f m_bbox;
+
+    ScalarSize m_ellipsoid_count = 0;
+
+    /// Number of standard deviations covered by the ellipsoids
+    ScalarFloat m_extent;
+
+    /// Ellipsoid buffer (see the \c data parameter for its layout)
+    mutable FloatStorage m_data;
+
+    /// Per-ellipsoid attributes
+    std::unordered_map<std::string, ParticleAttribute> m_attributes;
+
+    /// Host copy of the ellipsoid data (JIT variants)
+    FloatStorage m_host_data_storage;
+    /// Host pointer to the ellipsoid data
+    const InputFloat *m_host_data = nullptr;
+
+#if defined(MI_ENABLE_CUDA)
+    static constexpr uint32_t optix_geometry_flags[1] = { OPTIX_GEOMETRY_FLAG_NONE };
+
+    /// Per-ellipsoid bounding boxes used to build the OptiX GAS
+    void *m_device_bboxes = nullptr;
+#endif
+};
+
+MI_IMPLEMENT_CLASS_VARIANT(Ellipsoids, Shape)
+MI_EXPORT_PLUGIN(Ellipsoids, "Ellipsoid cloud intersection primitive");
+NAMESPACE_END(mitsuba)
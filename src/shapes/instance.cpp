@@ -11,6 +11,10 @@
     #include <embree3/rtcore.h>
 #endif
 
+#if defined(MI_ENABLE_CUDA)
+    #include <drjit-core/optix.h>
+#endif
+
 NAMESPACE_BEGIN(mitsuba)
 
 /**!
@@ -24,13 +28,38 @@ Instance (:monosp:`instance`)
 
  * - (Nested plugin)
    - :paramtype:`shapegroup`
-   - A reference to a shape group that should be instantiated.
+   - A reference to a shape group that should be instantiated. Several shape groups named
+     ``lod_0``, ``lod_1``, etc. can be specified to provide levels of detail (see below).
+
+ * - lod_distances
+   - |string|
+   - Comma-separated list of increasing distances at which the instance switches to the next
+     coarser level of detail. One distance per level except the finest one must be provided.
+     (Default: none)
 
  * - to_world
-   - |transform|
-   - Specifies a linear object-to-world transformation. (Default: none (i.e. object space = world space))
+   - |transform| or |animation|
+   - Specifies a linear object-to-world transformation, which may also be
+     animated over time (see below). (Default: none (i.e. object space = world space))
    - |exposed|, |differentiable|, |discontinuous|
 
+ * - bsdf
+   - |bsdf|
+   - Optional BSDF that replaces the materials of all shapes within the shape group for this
+     instance. (Default: none, i.e. use the materials of the shape group)
+   - |exposed|, |differentiable|
+
+ * - uv_offset
+   - |vector|
+   - Offset that is added to the texture coordinates of the instanced shapes. The third
+     component is ignored. (Default: [0, 0, 0])
+   - |exposed|
+
+ * - instance_*
+   - |texture|
+   - Per-instance attributes, which can be accessed by the materials of the shape group using the
+     :ref:`mesh_attribute <texture-meshattribute>` texture (e.g. a constant ``instance_color``).
+
 This plugin implements a geometry instance used to efficiently replicate geometry many times. For
 details on how to create instances, refer to the :ref:`shape-shapegroup` plugin.
 
@@ -43,47 +72,258 @@ details on how to create instances, refer to the :ref:`shape-shapegroup` plugin.
 
 .. warning::
 
-    - Note that it is not possible to assign a different material to each instance — the material
-      assignment specified within the shape group is the one that matters.
     - Shape groups cannot be used to replicate shapes with attached emitters, sensors, or
       subsurface scattering models.
 
+Instances of the same shape group can be varied without duplicating its geometry and
+acceleration data structure. The ``bsdf`` parameter replaces the materials of the shape group,
+``uv_offset`` shifts the texture coordinates (e.g. to select a different tile of a
+:ref:`udim <texture-udim>` texture), and nested textures whose name starts with ``instance_``
+define attributes that the shared materials look up at shading time:
+
+.. tabs::
+    .. code-tab:: xml
+        :name: instance-overrides
+
+        <shapegroup id="tree">
+            <shape type="ply">
+                <string name="filename" value="tree.ply"/>
+                <bsdf type="diffuse">
+                    <texture type="mesh_attribute" name="reflectance">
+                        <string name="name" value="instance_color"/>
+                    </texture>
+                </bsdf>
+            </shape>
+        </shapegroup>
+
+        <shape type="instance">
+            <ref id="tree"/>
+            <rgb name="instance_color" value="0.2, 0.5, 0.1"/>
+        </shape>
+
+        <shape type="instance">
+            <ref id="tree"/>
+            <vector name="uv_offset" x="1" y="0"/>
+            <bsdf type="roughconductor"/>
+        </shape>
+
+    .. code-tab:: python
+
+        'tree': {
+            'type': 'shapegroup',
+            'shape': {
+                'type': 'ply',
+                'filename': 'tree.ply',
+                'bsdf': {
+                    'type': 'diffuse',
+                    'reflectance': {
+                        'type': 'mesh_attribute',
+                        'name': 'instance_color'
+                    }
+                }
+            }
+        },
+        'instance_1': {
+            'type': 'instance',
+            'group': { 'type': 'ref', 'id': 'tree' },
+            'instance_color': { 'type': 'rgb', 'value': [0.2, 0.5, 0.1] }
+        },
+        'instance_2': {
+            'type': 'instance',
+            'group': { 'type': 'ref', 'id': 'tree' },
+            'uv_offset': [1, 0, 0],
+            'bsdf': { 'type': 'roughconductor' }
+        }
+
+.. _shape-instance-lod:
+
+Distant instances can use simplified versions of their geometry to save memory and traversal
+time. The levels of detail are given as separate shape groups, ordered from the finest
+(``lod_0``) to the coarsest one, which were e.g. generated by a mesh simplification tool. When
+the scene is created, each instance selects the level that corresponds to the distance between
+the first sensor and its bounding box: level :math:`i` is used from the :math:`i`-th entry of
+``lod_distances`` onwards. Since the selection happens once per instance, the geometry is the
+same for all rays of a rendering, including the rays of light paths, and the Embree and OptiX
+backends simply reference the acceleration data structure of the selected level. The selection
+isn't updated when the sensor moves later on.
+
+.. tabs::
+    .. code-tab:: xml
+        :name: instance-lod
+
+        <shape type="instance">
+            <ref id="tree_high" name="lod_0"/>
+            <ref id="tree_medium" name="lod_1"/>
+            <ref id="tree_low" name="lod_2"/>
+            <string name="lod_distances" value="20, 100"/>
+        </shape>
+
+    .. code-tab:: python
+
+        'type': 'instance',
+        'lod_0': { 'type': 'ref', 'id': 'tree_high' },
+        'lod_1': { 'type': 'ref', 'id': 'tree_medium' },
+        'lod_2': { 'type': 'ref', 'id': 'tree_low' },
+        'lod_distances': '20, 100'
+
+.. _shape-instance-motion:
+
+The ``to_world`` transformation can be specified as a keyframe animation
+to render motion blur. The instance is then evaluated at the time of each
+ray, which the sensor samples within its shutter interval (see the
+``shutter_open`` and ``shutter_close`` parameters of the sensors), hence a
+single rendering suffices. Each keyframe is decomposed into a scale/shear,
+rotation and translation component, which are interpolated independently.
+The Embree and OptiX backends trace animated instances using their native
+motion blur support, Embree furthermore requires all keyframe times to lie
+within :math:`[0, 1]`.
+
+.. tabs::
+    .. code-tab:: xml
+        :name: instance-motion-blur
+
+        <shape type="instance">
+            <ref id="my_shapegroup"/>
+            <animation name="to_world">
+                <transform time="0">
+                    <translate x="-1"/>
+                </transform>
+                <transform time="1">
+                    <rotate y="1" angle="45"/>
+                    <translate x="1"/>
+                </transform>
+            </animation>
+        </shape>
+
+    .. code-tab:: python
+
+        animation = mi.AnimatedTransform()
+        animation.append(0, mi.ScalarTransform4f.translate([-1, 0, 0]))
+        animation.append(1, mi.ScalarTransform4f.translate([1, 0, 0]) @
+                            mi.ScalarTransform4f.rotate([0, 1, 0], 45))
+
+        'type': 'instance',
+        'group': {
+            'type': 'ref',
+            'id': 'my_shapegroup'
+        },
+        'to_world': animation
+
  */
 
 template <typename Float, typename Spectrum>
 class Instance final: public Shape<Float, Spectrum> {
 public:
     MI_IMPORT_BASE(Shape, m_id, m_to_world, m_to_object, m_shape_type,
-                   mark_dirty)
-    MI_IMPORT_TYPES(BSDF)
+                   m_bsdf, m_texture_attributes, mark_dirty)
+    MI_IMPORT_TYPES(BSDF, Texture)
 
     using typename Base::ScalarSize;
     using typename Base::ScalarIndex;
     using ShapeGroup_ = ShapeGroup<Float, Spectrum>;
 
     Instance(const Properties &props) : Base(props) {
+        bool has_bsdf = false;
+        std::vector<std::pair<std::string, ShapeGroup_ *>> groups;
         for (auto &kv : props.objects()) {
             Base *shape = dynamic_cast<Base *>(kv.second.get());
             if (shape && shape->is_shapegroup()) {
-                if (m_shapegroup)
-                    Throw("Only a single shapegroup can be specified per instance.");
-                m_shapegroup = (ShapeGroup_*) shape;
+                groups.emplace_back(kv.first, (ShapeGroup_ *) shape);
+            } else if (dynamic_cast<BSDF *>(kv.second.get())) {
+                // Already registered by the base class
+                has_bsdf = true;
+            } else if (dynamic_cast<Texture *>(kv.second.get())) {
+                if (!string::starts_with(kv.first, "instance_"))
+                    Throw("Invalid instance attribute name \"%s\": must start "
+                          "with \"instance_\".", kv.first);
             } else {
-                Throw("Only a shapegroup can be specified in an instance.");
+                Throw("Only a shapegroup, a BSDF, and textures can be specified "
+                      "in an instance.");
             }
         }
 
-        if (!m_shapegroup)
+        if (groups.empty())
             Throw("A reference to a 'shapegroup' must be specified!");
 
+        if (props.has_property("lod_distances")) {
+            for (const auto &s : string::tokenize(props.string("lod_distances"), " ,")) {
+                try {
+                    m_lod_distances.push_back(string::stof<ScalarFloat>(s));
+                } catch (...) {
+                    Throw("Could not parse floating point value '%s'", s);
+                }
+                if (m_lod_distances.size() > 1 &&
+                    m_lod_distances.back() <= m_lod_distances[m_lod_distances.size() - 2])
+                    Throw("The entries of 'lod_distances' must be increasing!");
+            }
+
+            // Order the levels of detail by the index in their name
+            m_lods.resize(m_lod_distances.size() + 1);
+            for (auto &[name, group] : groups) {
+                size_t index = m_lods.size();
+                if (string::starts_with(name, "lod_"))
+                    index = (size_t) std::strtoul(name.c_str() + 4, nullptr, 10);
+                if (index >= m_lods.size() || m_lods[index])
+                    Throw("Instance: expected %zu shape groups named \"lod_0\" to "
+                          "\"lod_%zu\" (one more than 'lod_distances'), got "
+                          "\"%s\"!", m_lods.size(), m_lods.size() - 1, name);
+                m_lods[index] = group;
+            }
+            for (size_t i = 0; i < m_lods.size(); ++i) {
+                if (!m_lods[i])
+                    Throw("Instance: the shape group \"lod_%zu\" is missing!", i);
+            }
+        } else if (groups.size() > 1) {
+            Throw("Only a single shapegroup can be specified per instance "
+                  "(unless 'lod_distances' is given).");
+        }
+
+        m_shapegroup = groups[0].second;
+        if (!m_lods.empty())
+            m_shapegroup = m_lods[0];
+
+        /* Instances only have a BSDF when it overrides the materials of the
+           shape group, see SurfaceInteraction::bsdf() */
+        if (!has_bsdf) {
+            m_bsdf = nullptr;
+            dr::set_attr(this, "bsdf", m_bsdf.get());
+        }
+
+        ScalarVector3f uv_offset = props.get<ScalarVector3f>("uv_offset", 0.f);
+        m_uv_offset = ScalarVector2f(uv_offset.x(), uv_offset.y());
+        m_has_uv_offset = uv_offset.x() != 0.f || uv_offset.y() != 0.f;
+
+        if (props.has_property("to_world") &&
+            props.type("to_world") == Properties::Type::AnimatedTransform) {
+            ref<AnimatedTransform> animation = props.animated_transform("to_world");
+            m_to_world = (ScalarTransform4f) animation->eval(
+                animation->size() > 0 ? (*animation)[0].time : 0.f);
+            m_to_object = m_to_world.scalar().inverse();
+            if (animation->size() > 1)
+                m_animation = animation;
+        }
+
         m_shape_type = ShapeType::Instance;
         dr::set_attr(this, "shape_type", m_shape_type);
 
-        dr::make_opaque(m_to_world, m_to_object);
+        dr::make_opaque(m_to_world, m_to_object, m_uv_offset);
     }
 
+#if defined(MI_ENABLE_CUDA)
+    ~Instance() {
+        jit_free(m_optix_motion_transforms);
+    }
+#endif
+
     void traverse(TraversalCallback *callback) override {
-        callback->put_parameter("to_world", *m_to_world.ptr(), +ParamFlags::NonDifferentiable);
+        // The keyframes of animated instances can't be modified
+        if (!m_animation)
+            callback->put_parameter("to_world", *m_to_world.ptr(), +ParamFlags::NonDifferentiable);
+        callback->put_parameter("uv_offset", m_uv_offset, +ParamFlags::NonDifferentiable);
+        if (m_bsdf)
+            callback->put_object("bsdf", m_bsdf.get(), +ParamFlags::Differentiable);
+        for (auto &[name, texture] : m_texture_attributes)
+            callback->put_object(name, texture.get(), +ParamFlags::Differentiable);
     }
 
     void parameters_changed(const std::vector<std::string> &keys) override {
@@ -93,17 +333,44 @@ public:
             m_to_object = m_to_world.value().inverse();
             mark_dirty();
         }
+        if (keys.empty() || string::contains(keys, "uv_offset")) {
+            m_has_uv_offset = true;
+            dr::make_opaque(m_uv_offset);
+        }
         Base::parameters_changed();
     }
 
     ScalarBoundingBox3f bbox() const override {
-        const ScalarBoundingBox3f &bbox = m_shapegroup->bbox();
+        /* Cover all levels of detail, since the bounds are queried before
+           one of them is selected */
+        ScalarBoundingBox3f bbox = m_shapegroup->bbox();
+        for (const auto &lod : m_lods)
+            bbox.expand(lod->bbox());
 
         // If the shape group is empty, return the invalid bbox
         if (!bbox.valid())
             return bbox;
 
         ScalarBoundingBox3f result;
+        if (m_animation) {
+            /* The rotated and scaled box remains within a sphere around the
+               (linearly interpolated) translation, whose radius is bounded by
+               the keyframes due to the convexity of the norm. */
+            ScalarFloat radius = 0.f;
+            for (size_t k = 0; k < m_animation->size(); ++k) {
+                const auto &scale = (*m_animation)[k].scale;
+                for (int i = 0; i < 8; ++i)
+                    radius = dr::maximum(
+                        radius, (ScalarFloat) dr::norm(
+                                    scale * AnimatedTransform::Vector3f(bbox.corner(i))));
+            }
+
+            auto translation = m_animation->translation_bounds();
+            result.expand(ScalarPoint3f(translation.min) - radius);
+            result.expand(ScalarPoint3f(translation.max) + radius);
+            return result;
+        }
+
         for (int i = 0; i < 8; ++i)
             result.expand(m_to_world.scalar() * bbox.corner(i));
         return result;
@@ -130,7 +397,8 @@ public:
                                    dr::mask_t<FloatP> active) const {
         MI_MASK_ARGUMENT(active);
         if constexpr (!dr::is_array_v<FloatP>) {
-            return m_shapegroup->ray_intersect_preliminary_scalar(m_to_object.scalar().transform_affine(ray));
+            return m_shapegroup->ray_intersect_preliminary_scalar(
+                to_object_at(ray.time).transform_affine(ray));
         } else {
             Throw("Instance::ray_intersect_preliminary() should only be called with scalar types.");
         }
@@ -143,7 +411,8 @@ public:
         MI_MASK_ARGUMENT(active);
 
         if constexpr (!dr::is_array_v<FloatP>) {
-            return m_shapegroup->ray_test_scalar(m_to_object.scalar().transform_affine(ray));
+            return m_shapegroup->ray_test_scalar(
+                to_object_at(ray.time).transform_affine(ray));
         } else {
             Throw("Instance::ray_test_impl() should only be called with scalar types.");
         }
@@ -158,8 +427,14 @@ public:
                                                      Mask active) const override {
         MI_MASK_ARGUMENT(active);
 
-        const Transform4f& to_world  = m_to_world.value();
-        const Transform4f& to_object = m_to_object.value();
+        Transform4f to_world, to_object;
+        if (m_animation) {
+            to_world  = m_animation->eval(ray.time, active);
+            to_object = to_world.inverse();
+        } else {
+            to_world  = m_to_world.value();
+            to_object = m_to_object.value();
+        }
 
         constexpr bool IsDiff = dr::is_diff_v<Float>;
         bool grad_enabled = dr::grad_enabled(to_world);
@@ -241,6 +516,9 @@ public:
             si.dn_dv -= tn * dr::dot(tn, si.dn_dv);
         }
 
+        if (m_has_uv_offset)
+            si.uv += m_uv_offset;
+
         si.instance = this;
 
         return si;
@@ -263,15 +541,56 @@ public:
         DRJIT_MARK_USED(device);
         if constexpr (!dr::is_cuda_v<Float>) {
             RTCGeometry instance = m_shapegroup->embree_geometry(device);
-            rtcSetGeometryTimeStepCount(instance, 1);
-            dr::Matrix<ScalarFloat32, 4> matrix(m_to_world.scalar().matrix);
-            rtcSetGeometryTransform(instance, 0, RTC_FORMAT_FLOAT4X4_COLUMN_MAJOR, &matrix);
+            if (m_animation) {
+                // Embree interpolates the motion keys according to the ray time
+                std::vector<AnimatedTransform::Keyframe> keys = m_animation->resample();
+                if (keys.front().time < 0.f || keys.back().time > 1.f)
+                    Throw("Instance: Embree only supports animated transformations "
+                          "with keyframe times within [0, 1]!");
+
+                rtcSetGeometryTimeStepCount(instance, (unsigned int) keys.size());
+                rtcSetGeometryTimeRange(instance, keys.front().time, keys.back().time);
+                for (size_t i = 0; i < keys.size(); ++i) {
+                    const AnimatedTransform::Keyframe &k = keys[i];
+                    RTCQuaternionDecomposition qd;
+                    rtcInitQuaternionDecomposition(&qd);
+                    qd.scale_x = k.scale(0, 0);
+                    qd.scale_y = k.scale(1, 1);
+                    qd.scale_z = k.scale(2, 2);
+                    qd.skew_xy = k.scale(0, 1);
+                    qd.skew_xz = k.scale(0, 2);
+                    qd.skew_yz = k.scale(1, 2);
+                    qd.quaternion_r = k.quat.w();
+                    qd.quaternion_i = k.quat.x();
+                    qd.quaternion_j = k.quat.y();
+                    qd.quaternion_k = k.quat.z();
+                    qd.translation_x = k.trans.x();
+                    qd.translation_y = k.trans.y();
+                    qd.translation_z = k.trans.z();
+                    rtcSetGeometryTransformQuaternion(instance, (unsigned int) i, &qd);
+                }
+            } else {
+                rtcSetGeometryTimeStepCount(instance, 1);
+                dr::Matrix<ScalarFloat32, 4> matrix(m_to_world.scalar().matrix);
+                rtcSetGeometryTransform(instance, 0, RTC_FORMAT_FLOAT4X4_COLUMN_MAJOR, &matrix);
+            }
             rtcCommitGeometry(instance);
             return instance;
         } else {
             Throw("embree_geometry() should only be called in CPU mode.");
         }
     }
+
+    bool embree_update_transform(RTCGeometry geom) override {
+        // The instanced BVH must be unchanged
+        if (m_animation || m_shapegroup->dirty())
+            return false;
+
+        dr::Matrix<ScalarFloat32, 4> matrix(m_to_world.scalar().matrix);
+        rtcSetGeometryTransform(geom, 0, RTC_FORMAT_FLOAT4X4_COLUMN_MAJOR, &matrix);
+        rtcCommitGeometry(geom);
+        return true;
+    }
 #endif
 
 #if defined(MI_ENABLE_CUDA)
@@ -279,8 +598,61 @@ public:
                                    std::vector<OptixInstance>& instances,
                                    uint32_t instance_id,
                                    const ScalarTransform4f& transf) override {
-        m_shapegroup->optix_prepare_ias(context, instances, instance_id,
-                                        transf * m_to_world.scalar());
+        if (!m_animation) {
+            m_shapegroup->optix_prepare_ias(context, instances, instance_id,
+                                            transf * m_to_world.scalar());
+            return;
+        }
+
+        /* Wrap the traversables of the shape group into SRT motion transforms,
+           which OptiX interpolates according to the ray time */
+        size_t first = instances.size();
+        m_shapegroup->optix_prepare_ias(context, instances, instance_id, transf);
+        size_t count = instances.size() - first;
+
+        jit_free(m_optix_motion_transforms);
+        m_optix_motion_transforms = nullptr;
+        if (count == 0)
+            return;
+
+        std::vector<AnimatedTransform::Keyframe> keys = m_animation->resample();
+        size_t stride = sizeof(OptixSRTMotionTransform) +
+                        (keys.size() - 2) * sizeof(OptixSRTData);
+        stride = (stride + OPTIX_TRANSFORM_BYTE_ALIGNMENT - 1) /
+                 OPTIX_TRANSFORM_BYTE_ALIGNMENT * OPTIX_TRANSFORM_BYTE_ALIGNMENT;
+
+        std::vector<uint8_t> data(stride * count, 0);
+        for (size_t i = 0; i < count; ++i) {
+            OptixSRTMotionTransform *t =
+                (OptixSRTMotionTransform *) (data.data() + i * stride);
+            t->child = instances[first + i].traversableHandle;
+            t->motionOptions.numKeys   = (unsigned short) keys.size();
+            t->motionOptions.flags     = OPTIX_MOTION_FLAG_NONE;
+            t->motionOptions.timeBegin = keys.front().time;
+            t->motionOptions.timeEnd   = keys.back().time;
+
+            for (size_t j = 0; j < keys.size(); ++j) {
+                const AnimatedTransform::Keyframe &k = keys[j];
+                t->srtData[j] = OptixSRTData {
+                    k.scale(0, 0), k.scale(0, 1), k.scale(0, 2), 0.f,
+                    k.scale(1, 1), k.scale(1, 2), 0.f,
+                    k.scale(2, 2), 0.f,
+                    k.quat.x(), k.quat.y(), k.quat.z(), k.quat.w(),
+                    k.trans.x(), k.trans.y(), k.trans.z()
+                };
+            }
+        }
+
+        void *d_data = jit_malloc(AllocType::HostPinned, data.size());
+        jit_memcpy_async(JitBackend::CUDA, d_data, data.data(), data.size());
+        m_optix_motion_transforms = jit_malloc_migrate(d_data, AllocType::Device, 1);
+
+        for (size_t i = 0; i < count; ++i)
+            jit_optix_check(optixConvertPointerToTraversableHandle(
+                context,
+                (CUdeviceptr) ((uint8_t *) m_optix_motion_transforms + i * stride),
+                OPTIX_TRAVERSABLE_TYPE_SRT_MOTION_TRANSFORM,
+                &instances[first + i].traversableHandle));
     }
 
     virtual void optix_fill_hitgroup_records(std::vector<HitGroupSbtRecord> &,
@@ -297,9 +669,52 @@ public:
         return dr::grad_enabled(m_to_world) || m_shapegroup->parameters_grad_enabled();
     }
 
+    const Shape *instanced_shapegroup() const override {
+        // The instance BVH of the native backend assumes static transformations
+        return m_animation ? nullptr : m_shapegroup.get();
+    }
+
+    bool is_animated() const override { return (bool) m_animation; }
+
+    void select_lod(const ScalarPoint3f &viewpoint) override {
+        if (m_lods.empty())
+            return;
+
+        ScalarFloat distance = bbox().distance(viewpoint);
+        size_t index = 0;
+        while (index < m_lod_distances.size() && distance >= m_lod_distances[index])
+            ++index;
+
+        if (m_shapegroup != m_lods[index]) {
+            Log(Debug, "Instance \"%s\": using level of detail %zu (distance %f)",
+                m_id, index, distance);
+            m_shapegroup = m_lods[index];
+        }
+    }
+
     MI_DECLARE_CLASS()
 private:
+    /// Return the world-to-object transformation at the given time
+    ScalarTransform4f to_object_at(ScalarFloat time) const {
+        if (m_animation)
+            return m_animation->eval(time).inverse();
+        return m_to_object.scalar();
+    }
+
    ref<ShapeGroup_> m_shapegroup;
+   /// Levels of detail ordered from the finest to the coarsest one (if any)
+   std::vector<ref<ShapeGroup_>> m_lods;
+   /// Distances at which the next coarser level of detail is used
+   std::vector<ScalarFloat> m_lod_distances;
+   /// Animated object-to-world transformation (if any)
+   ref<AnimatedTransform> m_animation;
+   /// Offset added to the texture coordinates of the instanced shapes
+   Vector2f m_uv_offset;
+   bool m_has_uv_offset;
+#if defined(MI_ENABLE_CUDA)
+   /// Device memory of the OptiX motion transforms
+   void *m_optix_motion_transforms = nullptr;
+#endif
 };
 
 MI_IMPLEMENT_CLASS_VARIANT(Instance, Shape)
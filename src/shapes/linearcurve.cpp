@@ -7,6 +7,7 @@
 #include <mitsuba/core/fresolver.h>
 #include <mitsuba/core/mmap.h>
 #include <mitsuba/core/timer.h>
+#include <mitsuba/render/curve.h>
 #include <mitsuba/render/fwd.h>
 #include <mitsuba/render/interaction.h>
 #include <mitsuba/render/shape.h>
@@ -38,6 +39,19 @@ Linear curve (:monosp:`linearcurve`)
    - Specifies a linear object-to-world transformation. Note that the control
      points' raddii are invariant to this transformation!
 
+ * - simplify_ratio
+   - |float|
+   - Keep a random subset of one in this many curves, see below. (Default: 1, i.e. all curves)
+
+ * - simplify_seed
+   - |int|
+   - Seed of the random selection of the simplified curves. (Default: 0)
+
+ * - simplify_widen
+   - |bool|
+   - Scale the radii of the curves that remain after the simplification to
+     preserve their appearance from a distance. (Default: |true|)
+
  * - control_point_count
    - |int|
    - Total number of control points
@@ -109,6 +123,15 @@ points and increasing radii::
             'filename': 'curves.txt'
         },
 
+Dense fur or hair that only covers a small part of the image can be
+stochastically simplified to reduce the memory and traversal cost of thin
+curves: with :monosp:`simplify_ratio=k`, only a random subset of one in
+:monosp:`k` curves is loaded, and the radii of these curves are scaled so that
+their total projected area is preserved (following "Stochastic Simplification
+of Aggregate Detail" by Cook et al.). The simplified versions can be used as
+the coarser :ref:`levels of detail <shape-instance-lod>` of an instance, which
+then selects one of them based on its distance to the sensor.
+
 .. note:: The backfaces of the curves are culled. It is therefore impossible to
           intersect the curve with a ray that's origin is inside of the curve.
  */
@@ -132,11 +155,11 @@ public:
     using Index = typename CoreAliases::UInt32;
 
     LinearCurve(const Properties &props) : Base(props) {
-#if !defined(MI_ENABLE_EMBREE)
-        if constexpr (!dr::is_jit_v<Float>)
-            Throw("The linear curve is only available with Embree in scalar "
-                  "variants!");
-#endif
+        ScalarFloat simplify_ratio = props.get<ScalarFloat>("simplify_ratio", 1.f);
+        uint32_t simplify_seed = props.get<uint32_t>("simplify_seed", 0);
+        bool simplify_widen = props.get<bool>("simplify_widen", true);
+        if (!(simplify_ratio >= 1.f))
+            Throw("The \"simplify_ratio\" parameter must be >= 1!");
 
         auto fs = Thread::thread()->file_resolver();
         fs::path file_path = fs->resolve(props.string("filename"));
@@ -245,6 +268,15 @@ public:
             fail("Empty curve file: no control points were read!");
         finish_curve();
 
+        if (simplify_ratio > 1.f) {
+            size_t curve_count = curve_1st_idx.size();
+            simplify_curves(vertices, radius, curve_1st_idx, simplify_ratio,
+                            simplify_seed, simplify_widen);
+            segment_count = vertices.size() - curve_1st_idx.size();
+            Log(Debug, "\"%s\": kept %zu of %zu curves", m_name,
+                curve_1st_idx.size(), curve_count);
+        }
+
         m_control_point_count = (ScalarSize) vertices.size();
 
         std::unique_ptr<ScalarIndex[]> indices = std::make_unique<ScalarIndex[]>(segment_count);
@@ -308,6 +340,7 @@ public:
         m_shape_type = ShapeType::LinearCurve;
         dr::set_attr(this, "shape_type", m_shape_type);
 
+        update_host_pointers();
         initialize();
     }
 
@@ -343,13 +376,15 @@ public:
         Point3f p0 = Point3f(c0.x(), c0.y(), c0.z()),
                 p1 = Point3f(c1.x(), c1.y(), c1.z());
 
-        Vector3f u_rot, u_rad;
-        std::tie(u_rot, u_rad) = local_frame(dr::normalize(p1 - p0));
-        
         Point3f c = p0 * (1.f - v_local) + p1 * v_local;
-        si.n = si.sh_frame.n = dr::normalize(si.p - c);
+        si.n = dr::normalize(si.p - c);
+        if (likely(has_flag(ray_flags, RayFlags::ShadingFrame)))
+            si.sh_frame.n = si.n;
 
         if (need_uv) {
+            Vector3f u_rot, u_rad;
+            std::tie(u_rot, u_rad) = local_frame(dr::normalize(p1 - p0));
+
             Vector3f rad_vec = si.p - c;
             Vector3f rad_vec_normalized = dr::normalize(rad_vec);
 
@@ -378,6 +413,7 @@ public:
     void parameters_changed(const std::vector<std::string> &keys) override {
         if (keys.empty() || string::contains(keys, "control_points")) {
             recompute_bbox();
+            update_host_pointers();
             mark_dirty();
         }
         Base::parameters_changed();
@@ -435,6 +471,59 @@ public:
     }
 #endif
 
+    // =============================================================
+    //! @{ \name Native backend (kd-tree / BVH) support
+    // =============================================================
+
+    ScalarBoundingBox3f bbox(ScalarIndex index) const override {
+        auto [p0, r0, p1, r1] = host_segment(index);
+        ScalarBoundingBox3f bbox(p0 - r0, p0 + r0);
+        bbox.expand(ScalarBoundingBox3f(p1 - r1, p1 + r1));
+        return bbox;
+    }
+
+    ScalarBoundingBox3f bbox(ScalarIndex index,
+                             const ScalarBoundingBox3f &clip) const override {
+        /* Bound pieces of the segment individually, which yields a much
+           tighter box than clipping the bounding box of the entire segment
+           when the segment is not aligned with the coordinate axes */
+        auto [p0, r0, p1, r1] = host_segment(index);
+
+        ScalarBoundingBox3f result;
+        ScalarPoint3f a = p0;
+        ScalarFloat ra = r0;
+        for (uint32_t k = 1; k <= BBoxSubdivisions; ++k) {
+            ScalarFloat v = k / (ScalarFloat) BBoxSubdivisions;
+            ScalarPoint3f b = dr::lerp(p0, p1, v);
+            ScalarFloat rb = dr::lerp(r0, r1, v);
+            expand_swept_sphere_bbox(result, a, b, dr::maximum(ra, rb), clip);
+            a = b;
+            ra = rb;
+        }
+        return result;
+    }
+
+    std::tuple<ScalarFloat, ScalarPoint2f, ScalarUInt32, ScalarUInt32>
+    ray_intersect_primitive_scalar(ScalarIndex index,
+                                   const ScalarRay3f &ray) const override {
+        auto [p0, r0, p1, r1] = host_segment(index);
+        auto [t, v] = intersect_round_cone(ray.o, ray.d, p0, r0, p1, r1);
+
+        if (!(t > 0.f && t < ray.maxt))
+            t = dr::Infinity<ScalarFloat>;
+
+        return { t, ScalarPoint2f(v, 0.f), (ScalarUInt32) -1, index };
+    }
+
+    bool ray_test_primitive_scalar(ScalarIndex index,
+                                   const ScalarRay3f &ray) const override {
+        return std::get<0>(ray_intersect_primitive_scalar(index, ray)) !=
+               dr::Infinity<ScalarFloat>;
+    }
+
+    //! @}
+    // =============================================================
+
     ScalarBoundingBox3f bbox() const override {
         return m_bbox;
     }
@@ -488,6 +577,29 @@ private:
         }
     }
 
+    /**
+     * \brief Make the control points and segment indices accessible to the
+     * scalar intersection routines of the native backend
+     */
+    void update_host_pointers() {
+        if constexpr (!dr::is_cuda_v<Float>) {
+            if constexpr (dr::is_jit_v<Float>) {
+                dr::eval(m_control_points, m_indices);
+                dr::sync_thread();
+            }
+            m_host_control_points = m_control_points.data();
+            m_host_indices = m_indices.data();
+        }
+    }
+
+    /// Return the end points and radii of a segment (native backend only)
+    std::tuple<ScalarPoint3f, ScalarFloat, ScalarPoint3f, ScalarFloat>
+    host_segment(ScalarIndex index) const {
+        const InputFloat *c = m_host_control_points + 4 * m_host_indices[index];
+        return { ScalarPoint3f(c[0], c[1], c[2]), (ScalarFloat) c[3],
+                 ScalarPoint3f(c[4], c[5], c[6]), (ScalarFloat) c[7] };
+    }
+
     std::tuple<Vector3f, Vector3f>
     local_frame(const Vector3f &dc_dv_normalized) const {
         // Define consistent local frame
@@ -513,6 +625,13 @@ private:
     mutable UInt32Storage m_indices;
     mutable FloatStorage m_control_points;
 
+    /// Number of pieces bounded individually by \ref bbox(ScalarIndex, const ScalarBoundingBox3f &)
+    static constexpr uint32_t BBoxSubdivisions = 4;
+
+    /// Host pointers to the curve data used by the native backend
+    const InputFloat *m_host_control_points = nullptr;
+    const ScalarIndex *m_host_indices = nullptr;
+
 #if defined(MI_ENABLE_CUDA)
     // For OptiX build input
     mutable void* m_vertex_buffer_ptr = nullptr;
@@ -11,14 +11,14 @@ public:
     MI_IMPORT_TYPES(BSDF, Medium, Emitter, Sensor, Mesh)
 
     MergeShape(const Properties &props) {
-        std::unordered_map<Key, ref<Mesh>, key_hasher> tbl;
+        std::unordered_map<Key, std::vector<ref<Mesh>>, key_hasher> tbl;
         size_t visited = 0, ignored = 0;
         Timer timer;
 
         for (auto [unused, shape] : props.objects()) {
             ref<Mesh> mesh(dynamic_cast<Mesh *>(shape.get()));
 
-            if (!mesh || mesh->has_mesh_attributes()) {
+            if (!mesh) {
                 m_objects.push_back(shape);
                 ignored++;
                 continue;
@@ -33,18 +33,25 @@ public:
             key.has_normals = mesh->has_vertex_normals();
             key.has_texcoords = mesh->has_vertex_texcoords();
             key.has_face_normals = mesh->has_face_normals();
+            key.attributes = mesh->mesh_attributes();
 
-            auto [it, success] = tbl.try_emplace(key, mesh);
-            if (!success)
-                it->second = it->second->merge(mesh);
-
+            tbl[key].push_back(mesh);
             visited++;
         }
 
+        /* Merge every group in a single pass, since a sequence of pairwise
+           merges would copy the data of the first meshes over and over */
         for (auto &kv : tbl) {
+            ref<Mesh> mesh = kv.second[0];
+            if (kv.second.size() > 1) {
+                std::vector<const Mesh *> meshes(kv.second.begin(),
+                                                 kv.second.end());
+                mesh = Mesh::merge(meshes);
+            }
+
             if (tbl.size() == 1)
-                kv.second->set_id(props.id());
-            m_objects.push_back(kv.second);
+                mesh->set_id(props.id());
+            m_objects.push_back(mesh);
         }
 
         Log(Info, "Collapsed %zu into %zu meshes. (took %s, %zu objects ignored)",
@@ -69,6 +76,7 @@ private:
         bool has_normals;
         bool has_texcoords;
         bool has_face_normals;
+        std::vector<std::pair<std::string, size_t>> attributes;
 
         bool operator==(const Key &o) const {
             return bsdf == o.bsdf &&
@@ -78,7 +86,8 @@ private:
                    sensor == o.sensor &&
                    has_normals == o.has_normals &&
                    has_texcoords == o.has_texcoords &&
-                   has_face_normals == o.has_face_normals;
+                   has_face_normals == o.has_face_normals &&
+                   attributes == o.attributes;
         }
     };
 
@@ -96,6 +105,8 @@ private:
                         (k.has_face_normals ? 4 : 0);
             hash_combine(seed, k.bsdf, k.interior_medium, k.exterior_medium,
                          k.emitter, k.sensor, flags);
+            for (const auto &[name, size] : k.attributes)
+                hash_combine(seed, name, size);
             return seed;
         }
     };
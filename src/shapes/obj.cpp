@@ -6,6 +6,8 @@
 #include <mitsuba/core/util.h>
 #include <mitsuba/core/timer.h>
 #include <mitsuba/core/profiler.h>
+#include <mitsuba/core/thread.h>
+#include <nanothread/nanothread.h>
 
 #include <array>
 
@@ -41,6 +43,26 @@ Wavefront OBJ mesh loader (:monosp:`obj`)
    - Is the mesh inverted, i.e. should the normal vectors be flipped? (Default:|false|, i.e.
      the normals point outside)
 
+ * - compact_vertex_attributes
+   - |bool|
+   - Store vertex normals (octahedral encoding, 2x16 bits) and texture coordinates (half
+     precision) in compact form, which reduces the memory footprint of the mesh. They are
+     then no longer exposed as (differentiable) scene parameters. (Default: |false|)
+
+ * - alias_sampling
+   - |bool|
+   - Select triangles for surface sampling (e.g. of area emitters) using an alias table,
+     which takes constant time instead of a binary search over the triangles. The mapping
+     of samples to triangles is no longer monotonic, which reduces the benefit of
+     stratified samplers. (Default: |false|)
+
+ * - opacity_bake_resolution
+   - |int|
+   - When larger than zero and the mesh uses a transparent BSDF (e.g. :ref:`mask <bsdf-mask>`),
+     triangles whose opacity is zero at all points of a grid with this many segments per edge
+     are excluded from the acceleration data structure. Rays then pass through them without
+     invoking the BSDF. (Default: 0, i.e. disabled)
+
  * - to_world
    - |transform|
    - Specifies an optional linear object-to-world transformation.
@@ -83,7 +105,8 @@ Wavefront OBJ mesh loader (:monosp:`obj`)
 
 This plugin implements a simple loader for Wavefront OBJ files. It handles
 meshes containing triangles and quadrilaterals, and it also imports vertex normals
-and texture coordinates.
+and texture coordinates. Large files are split into chunks that are parsed
+in parallel.
 
 Loading an ordinary OBJ file is as simple as writing:
 
@@ -127,6 +150,90 @@ void advance(const char **start_, const char *end, const char (&delim)[N]) {
     *start_ = start;
 }
 
+/**
+ * \brief Open-addressing hash map (with linear probing) that assigns
+ * consecutive IDs to unique (position, texcoord, normal) index triplets
+ *
+ * OBJ position indices start at 1, hence all-zero keys mark empty slots.
+ */
+class VertexMap {
+public:
+    using Key = std::array<uint32_t, 3>;
+
+    VertexMap(size_t size_guess) {
+        size_t capacity = math::round_to_power_of_two(
+            std::max<size_t>(2 * size_guess, 16));
+        m_keys.resize(capacity, Key{{ 0, 0, 0 }});
+        m_values.resize(capacity);
+    }
+
+    /// Return the ID of \c key and whether it was newly inserted
+    std::pair<uint32_t, bool> insert(const Key &key) {
+        size_t mask = m_keys.size() - 1,
+               slot = hash(key) & mask;
+
+        while (true) {
+            const Key &k = m_keys[slot];
+            if (k == key)
+                return { m_values[slot], false };
+            else if (k[0] == 0)
+                break;
+            slot = (slot + 1) & mask;
+        }
+
+        uint32_t id = m_size++;
+        m_keys[slot] = key;
+        m_values[slot] = id;
+
+        // Keep the load factor below 1/2
+        if (2 * (size_t) m_size > m_keys.size())
+            rehash(2 * m_keys.size());
+
+        return { id, true };
+    }
+
+    /// Return the number of unique keys
+    uint32_t size() const { return m_size; }
+
+private:
+    static size_t hash(const Key &key) {
+        uint64_t h = key[0];
+        h = h * 0x9e3779b97f4a7c15ull + key[1];
+        h = h * 0x9e3779b97f4a7c15ull + key[2];
+
+        // MurmurHash3 finalizer
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdull;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ull;
+        h ^= h >> 33;
+        return (size_t) h;
+    }
+
+    void rehash(size_t capacity) {
+        std::vector<Key> keys(capacity, Key{{ 0, 0, 0 }});
+        std::vector<uint32_t> values(capacity);
+        size_t mask = capacity - 1;
+
+        for (size_t i = 0; i < m_keys.size(); ++i) {
+            if (m_keys[i][0] == 0)
+                continue;
+            size_t slot = hash(m_keys[i]) & mask;
+            while (keys[slot][0] != 0)
+                slot = (slot + 1) & mask;
+            keys[slot] = m_keys[i];
+            values[slot] = m_values[i];
+        }
+
+        m_keys.swap(keys);
+        m_values.swap(values);
+    }
+
+    std::vector<Key> m_keys;
+    std::vector<uint32_t> m_values;
+    uint32_t m_size = 0;
+};
+
 template <typename Float, typename Spectrum>
 class OBJMesh final : public Mesh<Float, Spectrum> {
 public:
@@ -168,19 +275,18 @@ public:
 
         using ScalarIndex3 = std::array<ScalarIndex, 3>;
 
-        struct VertexBinding {
-            ScalarIndex3 key {{ 0, 0, 0 }};
-            ScalarIndex value { 0 };
-            VertexBinding *next { nullptr };
+        /// Geometry found within a contiguous range of lines of the file
+        struct Chunk {
+            const char *begin, *end;
+            std::vector<InputVector3f> vertices;
+            std::vector<InputNormal3f> normals;
+            std::vector<InputVector2f> texcoords;
+            /// (position, texcoord, normal) indices of all triangle corners
+            std::vector<ScalarIndex3> corners;
+            ScalarBoundingBox3f bbox;
+            std::exception_ptr error;
         };
 
-        /// Temporary buffers for vertices, normals, and texture coordinates
-        std::vector<InputVector3f> vertices;
-        std::vector<InputNormal3f> normals;
-        std::vector<InputVector2f> texcoords;
-        std::vector<ScalarIndex3> triangles;
-        std::vector<VertexBinding> vertex_map;
-
  #if !defined(_WIN32)
         ref<MemoryMappedFile> mmap = new MemoryMappedFile(file_path);
         size_t file_size           = mmap->size();
@@ -194,191 +300,246 @@ public:
         const char *ptr = tmp.get();
 #endif
 
-        size_t vertex_guess = file_size / 100;
-        const char *eof     = ptr + file_size;
-        char buf[1025];
-
-        vertices.reserve(vertex_guess);
-        normals.reserve(vertex_guess);
-        texcoords.reserve(vertex_guess);
-        triangles.reserve(vertex_guess * 2);
-        vertex_map.resize(vertex_guess);
-
-        ScalarIndex vertex_ctr = 0;
+        const char *eof = ptr + file_size;
 
         Timer timer;
 
-        while (ptr < eof) {
-            // Determine the offset of the next newline
-            const char *next = ptr;
-            advance<false>(&next, eof, "\n");
-
-            // Copy buf into a 0-terminated buffer
-            size_t size = next - ptr;
-            if (size >= sizeof(buf) - 1)
-                fail("file contains an excessively long line! (%i characters)", size);
-            memcpy(buf, ptr, size);
-            buf[size] = '\0';
-
-            // Skip whitespace
-            const char *cur = buf, *eol = buf + size;
-            advance<true>(&cur, eol, " \t\r");
-
-            bool parse_error = false;
-            if (cur[0] == 'v' && (cur[1] == ' ' || cur[1] == '\t')) {
-                // Vertex position
-                InputPoint3f p;
-                cur += 2;
-                for (size_t i = 0; i < 3; ++i) {
-                    const char *orig = cur;
-                    p[i] = string::strtof<InputFloat>(cur, (char **) &cur);
-                    parse_error |= cur == orig;
-                }
-                p = m_to_world.scalar().transform_affine(p);
-                if (unlikely(!all(dr::isfinite(p))))
-                    fail("mesh contains invalid vertex position data");
-                m_bbox.expand(p);
-                vertices.push_back(p);
-            } else if (cur[0] == 'v' && cur[1] == 'n' && (cur[2] == ' ' || cur[2] == '\t')) {
-                if (!m_face_normals) {
-                    cur += 3;
-                    // Vertex normal
-                    InputNormal3f n;
+        /* Split the file into chunks that end at line boundaries. Since OBJ
+           indices are global, the chunks can be parsed independently. */
+        size_t chunk_count = std::max<size_t>(1, std::min<size_t>(
+            file_size / MinChunkSize, 4 * Thread::thread_count()));
+
+        std::vector<Chunk> chunks(chunk_count);
+        for (size_t i = 0; i < chunk_count; ++i) {
+            const char *begin = i == 0 ? ptr : chunks[i - 1].end;
+            const char *end   = eof;
+            if (i + 1 < chunk_count) {
+                end = std::max(begin, ptr + file_size / chunk_count * (i + 1));
+                advance<false>(&end, eof, "\n");
+                end = std::min(end + 1, eof);
+            }
+            chunks[i].begin = begin;
+            chunks[i].end   = end;
+        }
+
+        auto parse_chunk = [&](Chunk &chunk) {
+            size_t vertex_guess = (chunk.end - chunk.begin) / 100;
+            chunk.vertices.reserve(vertex_guess);
+            chunk.normals.reserve(vertex_guess);
+            chunk.texcoords.reserve(vertex_guess);
+            chunk.corners.reserve(vertex_guess * 6);
+
+            const char *line = chunk.begin, *end = chunk.end;
+            char buf[1025];
+
+            while (line < end) {
+                // Determine the offset of the next newline
+                const char *next = line;
+                advance<false>(&next, end, "\n");
+
+                // Copy buf into a 0-terminated buffer
+                size_t size = next - line;
+                if (size >= sizeof(buf) - 1)
+                    fail("file contains an excessively long line! (%i characters)", size);
+                memcpy(buf, line, size);
+                buf[size] = '\0';
+
+                // Skip whitespace
+                const char *cur = buf, *eol = buf + size;
+                advance<true>(&cur, eol, " \t\r");
+
+                bool parse_error = false;
+                if (cur[0] == 'v' && (cur[1] == ' ' || cur[1] == '\t')) {
+                    // Vertex position
+                    InputPoint3f p;
+                    cur += 2;
                     for (size_t i = 0; i < 3; ++i) {
                         const char *orig = cur;
-                        n[i] = string::strtof<InputFloat>(cur, (char **) &cur);
+                        p[i] = string::strtof<InputFloat>(cur, (char **) &cur);
                         parse_error |= cur == orig;
                     }
-                    n = dr::normalize(m_to_world.scalar().transform_affine(n));
-                    if (unlikely(!all(dr::isfinite(n))))
-                        fail("mesh contains invalid vertex normal data");
-                    normals.push_back(n);
-                }
-            } else if (cur[0] == 'v' && cur[1] == 't' && (cur[2] == ' ' || cur[2] == '\t')) {
-                // Texture coordinate
-                InputVector2f uv;
-                cur += 3;
-                for (size_t i = 0; i < 2; ++i) {
-                    const char *orig = cur;
-                    uv[i] = string::strtof<InputFloat>(cur, (char **) &cur);
-                    parse_error |= cur == orig;
-                }
-                if (flip_tex_coords)
-                    uv.y() = 1.f - uv.y();
-
-                texcoords.push_back(uv);
-            } else if (cur[0] == 'f' && (cur[1] == ' ' || cur[1] == '\t')) {
-                // Face specification
-                cur += 2;
-                size_t vertex_index = 0;
-                size_t type_index = 0;
-                ScalarIndex3 key {{ (ScalarIndex) 0, (ScalarIndex) 0, (ScalarIndex) 0 }};
-                ScalarIndex3 tri;
-
-                while (true) {
-                    const char *next2;
-                    ScalarIndex value = (ScalarIndex) strtoul(cur, (char **) &next2, 10);
-                    if (cur == next2)
-                        break;
-
-                    if (type_index < 3) {
-                        key[type_index] = value;
-                    } else {
-                        parse_error = true;
-                        break;
+                    p = m_to_world.scalar().transform_affine(p);
+                    if (unlikely(!all(dr::isfinite(p))))
+                        fail("mesh contains invalid vertex position data");
+                    chunk.bbox.expand(p);
+                    chunk.vertices.push_back(p);
+                } else if (cur[0] == 'v' && cur[1] == 'n' && (cur[2] == ' ' || cur[2] == '\t')) {
+                    if (!m_face_normals) {
+                        cur += 3;
+                        // Vertex normal
+                        InputNormal3f n;
+                        for (size_t i = 0; i < 3; ++i) {
+                            const char *orig = cur;
+                            n[i] = string::strtof<InputFloat>(cur, (char **) &cur);
+                            parse_error |= cur == orig;
+                        }
+                        n = dr::normalize(m_to_world.scalar().transform_affine(n));
+                        if (unlikely(!all(dr::isfinite(n))))
+                            fail("mesh contains invalid vertex normal data");
+                        chunk.normals.push_back(n);
                     }
-
-                    while (*next2 == '/') {
-                        type_index++;
-                        next2++;
+                } else if (cur[0] == 'v' && cur[1] == 't' && (cur[2] == ' ' || cur[2] == '\t')) {
+                    // Texture coordinate
+                    InputVector2f uv;
+                    cur += 3;
+                    for (size_t i = 0; i < 2; ++i) {
+                        const char *orig = cur;
+                        uv[i] = string::strtof<InputFloat>(cur, (char **) &cur);
+                        parse_error |= cur == orig;
                     }
+                    if (flip_tex_coords)
+                        uv.y() = 1.f - uv.y();
+
+                    chunk.texcoords.push_back(uv);
+                } else if (cur[0] == 'f' && (cur[1] == ' ' || cur[1] == '\t')) {
+                    // Face specification
+                    cur += 2;
+                    size_t vertex_index = 0;
+                    size_t type_index = 0;
+                    ScalarIndex3 key {{ (ScalarIndex) 0, (ScalarIndex) 0, (ScalarIndex) 0 }};
+                    ScalarIndex3 first = key, prev = key;
+
+                    while (true) {
+                        const char *next2;
+                        ScalarIndex value = (ScalarIndex) strtoul(cur, (char **) &next2, 10);
+                        if (cur == next2)
+                            break;
+
+                        if (type_index < 3) {
+                            key[type_index] = value;
+                        } else {
+                            parse_error = true;
+                            break;
+                        }
 
-                    if (*next2 == ' ' || *next2 == '\t' || *next2 == '\0' || *next2 == '\r') {
-                        type_index = 0;
-                        size_t map_index = key[0] - 1;
-
-                        if (unlikely(map_index >= vertices.size()))
-                            fail("reference to invalid vertex %i!", key[0]);
-                        if (unlikely(vertex_map.size() < vertices.size()))
-                            vertex_map.resize(vertices.size());
+                        while (*next2 == '/') {
+                            type_index++;
+                            next2++;
+                        }
 
-                        // Hash table lookup
-                        VertexBinding *entry = &vertex_map[map_index];
-                        while (entry->key != key && entry->next != nullptr)
-                            entry = entry->next;
+                        if (*next2 == ' ' || *next2 == '\t' || *next2 == '\0' || *next2 == '\r') {
+                            type_index = 0;
 
-                        ScalarIndex id;
-                        if (entry->key == key) {
-                            // Hit
-                            id = entry->value;
-                        } else {
-                            // Miss
-                            if (entry->key != ScalarIndex3{{0, 0, 0}}) {
-                                entry->next = new VertexBinding();
-                                entry = entry->next;
+                            // Triangulate polygons as a fan around the first corner
+                            if (vertex_index == 0) {
+                                first = key;
+                            } else if (vertex_index >= 2) {
+                                chunk.corners.push_back(first);
+                                chunk.corners.push_back(prev);
+                                chunk.corners.push_back(key);
                             }
-                            entry->key = key;
-                            id = entry->value = vertex_ctr++;
-                        }
-
-                        if (vertex_index < 3) {
-                            tri[vertex_index] = id;
-                        } else {
-                            tri[1] = tri[2];
-                            tri[2] = id;
+                            prev = key;
+                            vertex_index++;
                         }
-                        vertex_index++;
 
-                        if (vertex_index >= 3)
-                            triangles.push_back(tri);
+                        cur = next2;
                     }
+                }
+
+                if (unlikely(parse_error))
+                    fail("could not parse line \"%s\"", buf);
+                line = next + 1;
+            }
+        };
 
-                    cur = next2;
+        ThreadEnvironment env;
+        dr::parallel_for(
+            dr::blocked_range<size_t>(0, chunk_count, 1),
+            [&](const dr::blocked_range<size_t> &range) {
+                ScopedSetThreadEnvironment set_env(env);
+                for (size_t i = range.begin(); i != range.end(); ++i) {
+                    try {
+                        parse_chunk(chunks[i]);
+                    } catch (...) {
+                        chunks[i].error = std::current_exception();
+                    }
                 }
             }
+        );
+
+        // Merge the per-chunk buffers (reporting the first error in the file)
+        size_t vertex_total = 0, normal_total = 0, texcoord_total = 0,
+               corner_total = 0;
+        for (const Chunk &chunk : chunks) {
+            if (unlikely(chunk.error))
+                std::rethrow_exception(chunk.error);
+            vertex_total   += chunk.vertices.size();
+            normal_total   += chunk.normals.size();
+            texcoord_total += chunk.texcoords.size();
+            corner_total   += chunk.corners.size();
+            m_bbox.expand(chunk.bbox);
+        }
+
+        /// Temporary buffers for vertices, normals, and texture coordinates
+        std::vector<InputVector3f> vertices;
+        std::vector<InputNormal3f> normals;
+        std::vector<InputVector2f> texcoords;
 
-            if (unlikely(parse_error))
-                fail("could not parse line \"%s\"", buf);
-            ptr = next + 1;
+        vertices.reserve(vertex_total);
+        normals.reserve(normal_total);
+        texcoords.reserve(texcoord_total);
+
+        for (Chunk &chunk : chunks) {
+            vertices.insert(vertices.end(), chunk.vertices.begin(), chunk.vertices.end());
+            normals.insert(normals.end(), chunk.normals.begin(), chunk.normals.end());
+            texcoords.insert(texcoords.end(), chunk.texcoords.begin(), chunk.texcoords.end());
+            std::vector<InputVector3f>().swap(chunk.vertices);
+            std::vector<InputNormal3f>().swap(chunk.normals);
+            std::vector<InputVector2f>().swap(chunk.texcoords);
         }
 
-        m_vertex_count = vertex_ctr;
-        m_face_count = (ScalarSize) triangles.size();
+        /* Assign an ID to every unique (position, texcoord, normal) triplet
+           in the order of first occurrence */
+        std::unique_ptr<ScalarIndex[]> triangles(new ScalarIndex[corner_total]);
+        std::vector<ScalarIndex3> vertex_keys;
+        vertex_keys.reserve(vertices.size());
+        VertexMap vertex_map(vertices.size());
+
+        size_t corner_ctr = 0;
+        for (Chunk &chunk : chunks) {
+            for (const ScalarIndex3 &key : chunk.corners) {
+                if (unlikely(key[0] == 0 || key[0] > vertices.size()))
+                    fail("reference to invalid vertex %i!", key[0]);
+
+                auto [id, inserted] = vertex_map.insert(key);
+                if (inserted)
+                    vertex_keys.push_back(key);
+                triangles[corner_ctr++] = id;
+            }
+            std::vector<ScalarIndex3>().swap(chunk.corners);
+        }
+
+        m_vertex_count = (ScalarSize) vertex_keys.size();
+        m_face_count = (ScalarSize) (corner_total / 3);
 
         std::unique_ptr<float[]> vertex_positions(new float[m_vertex_count * 3]);
         std::unique_ptr<float[]> vertex_normals(new float[m_vertex_count * 3]);
         std::unique_ptr<float[]> vertex_texcoords(new float[m_vertex_count * 2]);
 
-        for (const auto& v_ : vertex_map) {
-            const VertexBinding *v = &v_;
+        for (ScalarIndex i = 0; i < m_vertex_count; ++i) {
+            InputFloat* position_ptr = vertex_positions.get() + i * 3;
+            InputFloat* normal_ptr   = vertex_normals.get() + i * 3;
+            InputFloat* texcoord_ptr = vertex_texcoords.get() + i * 2;
+            const ScalarIndex3 &key = vertex_keys[i];
 
-            while (v && v->key != ScalarIndex3{{0, 0, 0}}) {
-                InputFloat* position_ptr = vertex_positions.get() + v->value * 3;
-                InputFloat* normal_ptr   = vertex_normals.get() + v->value * 3;
-                InputFloat* texcoord_ptr = vertex_texcoords.get() + v->value * 2;
-                auto key = v->key;
+            dr::store(position_ptr, vertices[key[0] - 1]);
 
-                dr::store(position_ptr, vertices[key[0] - 1]);
-
-                if (key[1]) {
-                    size_t map_index = key[1] - 1;
-                    if (unlikely(map_index >= texcoords.size()))
-                        fail("reference to invalid texture coordinate %i!", key[1]);
-                    dr::store(texcoord_ptr, texcoords[map_index]);
-                }
-
-                if (!m_face_normals && key[2]) {
-                    size_t map_index = key[2] - 1;
-                    if (unlikely(map_index >= normals.size()))
-                        fail("reference to invalid normal %i!", key[2]);
-                    dr::store(normal_ptr, normals[key[2] - 1]);
-                }
+            if (key[1]) {
+                size_t map_index = key[1] - 1;
+                if (unlikely(map_index >= texcoords.size()))
+                    fail("reference to invalid texture coordinate %i!", key[1]);
+                dr::store(texcoord_ptr, texcoords[map_index]);
+            }
 
-                v = v->next;
+            if (!m_face_normals && key[2]) {
+                size_t map_index = key[2] - 1;
+                if (unlikely(map_index >= normals.size()))
+                    fail("reference to invalid normal %i!", key[2]);
+                dr::store(normal_ptr, normals[key[2] - 1]);
             }
         }
 
-        m_faces = dr::load<DynamicBuffer<UInt32>>(triangles.data(), m_face_count * 3);
+        m_faces = dr::load<DynamicBuffer<UInt32>>(triangles.get(), m_face_count * 3);
         m_vertex_positions = dr::load<FloatStorage>(vertex_positions.get(), m_vertex_count * 3);
         if (!m_face_normals)
             m_vertex_normals   = dr::load<FloatStorage>(vertex_normals.get(), m_vertex_count * 3);
@@ -409,6 +570,10 @@ public:
     }
 
     MI_DECLARE_CLASS()
+
+private:
+    /// Files are split into chunks of at least this size for parallel parsing
+    static constexpr size_t MinChunkSize = 4 * 1024 * 1024;
 };
 
 MI_IMPLEMENT_CLASS_VARIANT(OBJMesh, Mesh)
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <math.h>
+#include <mitsuba/render/optix/common.h>
+#include <mitsuba/render/optix/math.cuh>
+
+struct OptixEllipsoidsData {
+    /// Ellipsoid buffer with 12 floats per ellipsoid (see \c ellipsoids.cpp)
+    float *data;
+    /// Number of standard deviations covered by the ellipsoids
+    float extent;
+};
+
+#ifdef __CUDACC__
+
+/// Rotate a vector by the inverse of a unit quaternion (x, y, z, w)
+__device__ Vector3f rotate_inverse(const Vector4f &q, const Vector3f &v) {
+    Vector3f qv(-q.x(), -q.y(), -q.z());
+    Vector3f t = 2.f * cross(qv, v);
+    return v + q.w() * t + cross(qv, t);
+}
+
+extern "C" __global__ void __intersection__ellipsoids() {
+    const OptixHitGroupData *sbt_data = (OptixHitGroupData*) optixGetSbtDataPointer();
+    OptixEllipsoidsData *ellipsoids = (OptixEllipsoidsData*) sbt_data->data;
+    unsigned int prim_index = optixGetPrimitiveIndex();
+
+    const float *e = ellipsoids->data + 12 * prim_index;
+    Vector3f center(e[0], e[1], e[2]);
+    Vector4f quat(e[4], e[5], e[6], e[7]);
+    Vector3f radii = Vector3f(e[8], e[9], e[10]) * ellipsoids->extent;
+
+    // Ray in instance-space
+    Ray3f ray = get_ray();
+
+    // Map the ray to the space where the ellipsoid is a unit sphere. This
+    // linear map preserves the distances along the ray.
+    Vector3f l = rotate_inverse(quat, ray.o - center) / radii;
+    Vector3f d = rotate_inverse(quat, ray.d) / radii;
+
+    // Move the origin to the plane that contains the center and that is
+    // perpendicular to the ray direction (see sphere.cuh)
+    float plane_t = dot(-l, d) / squared_norm(d);
+    Vector3f o = l + plane_t * d;
+    if (squared_norm(o) > 1.f)
+        return;
+
+    float near_t, far_t;
+    bool solution_found = solve_quadratic(squared_norm(d), 2.f * dot(o, d),
+                                          squared_norm(o) - 1.f, near_t, far_t);
+
+    near_t += plane_t;
+    far_t += plane_t;
+
+    // Ellipsoid doesn't intersect with the segment on the ray
+    bool out_bounds = !(near_t <= ray.maxt && far_t >= 0.f); // NaN-aware conditionals
+
+    // Ellipsoid fully contains the segment of the ray
+    bool in_bounds = near_t < 0.f && far_t > ray.maxt;
+
+    float t = (near_t < 0.f ? far_t: near_t);
+
+    if (solution_found && !out_bounds && !in_bounds)
+        optixReportIntersection(t, OPTIX_HIT_KIND_TRIANGLE_FRONT_FACE);
+}
+
+extern "C" __global__ void __closesthit__ellipsoids() {
+    const OptixHitGroupData *sbt_data = (OptixHitGroupData *) optixGetSbtDataPointer();
+    unsigned int prim_index = optixGetPrimitiveIndex();
+    set_preliminary_intersection_to_payload(
+        optixGetRayTmax(), Vector2f(), prim_index, sbt_data->shape_registry_id);
+}
+#endif
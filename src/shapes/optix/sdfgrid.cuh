@@ -3,8 +3,14 @@
 #include <math.h>
 #include <mitsuba/render/optix/common.h>
 
+/// Number of voxels along each side of a brick (sparse representation)
+#define SDF_BRICK_SIZE 8
+/// Number of 32 bit words per brick: origin, coarse mask and voxel mask
+#define SDF_BRICK_STRIDE 20
+
 struct OptixSDFGridData {
     size_t* voxel_indices;
+    unsigned int* bricks;
     size_t res_x;
     size_t res_y;
     size_t res_z;
@@ -173,68 +179,24 @@ __device__ bool sdf_solve_cubic(float t_beg, float t_end, float c3, float c2,
     return true;
 }
 
-extern "C" __global__ void __intersection__sdfgrid() {
-    const OptixHitGroupData *sbt_data =
-        (OptixHitGroupData *) optixGetSbtDataPointer();
-    OptixSDFGridData &sdf = *((OptixSDFGridData *) sbt_data->data);
-    unsigned int voxel_index = sdf.voxel_indices[optixGetPrimitiveIndex()];
-
-    Ray3f ray = get_ray();
-    ray = sdf.to_object.transform_ray(ray); // object-space
-
-    Vector3f bbox_min = index_to_vec(voxel_index, sdf);
-    Vector3f bbox_max = bbox_min + Vector3f(1.f, 1.f, 1.f);
-    Vector3f voxel_size(sdf.voxel_size_x, sdf.voxel_size_y, sdf.voxel_size_z);
-    bbox_min *= voxel_size;
-    bbox_max *= voxel_size;
-
-    BoundingBox3f bbox_local;
-    bbox_local.min[0] = bbox_min[0];
-    bbox_local.min[1] = bbox_min[1];
-    bbox_local.min[2] = bbox_min[2];
-    bbox_local.max[0] = bbox_max[0];
-    bbox_local.max[1] = bbox_max[1];
-    bbox_local.max[2] = bbox_max[2];
-
-    float t_beg = 0;
-    float t_end = 0;
-    bool bbox_its = intersect_aabb(ray, bbox_local, t_beg, t_end);
-    // This should theoretically always hit, but OptiX might be a bit
-    // less/more tight numerically hence some rays will miss
-    if (!bbox_its) {
-        return;
-    }
-
-    optix::Transform4f to_voxel;
-    to_voxel.matrix[0][0] = (float) (sdf.res_x - 1);
-    to_voxel.matrix[0][1] = 0.f;
-    to_voxel.matrix[0][2] = 0.f;
-    to_voxel.matrix[0][3] = 0.f;
-
-    to_voxel.matrix[1][0] = 0.f;
-    to_voxel.matrix[1][1] = (float) (sdf.res_y - 1);
-    to_voxel.matrix[1][2] = 0.f;
-    to_voxel.matrix[1][3] = 0.f;
-
-    to_voxel.matrix[2][0] = 0.f;
-    to_voxel.matrix[2][1] = 0.f;
-    to_voxel.matrix[2][2] = (float) (sdf.res_z - 1);
-    to_voxel.matrix[2][3] = 0.f;
-
-    Vector3u voxel_position = index_to_vec(voxel_index, sdf);
-    to_voxel.matrix[3][0] = -1.f * ((float) voxel_position.x()); 
-    to_voxel.matrix[3][1] = -1.f * ((float) voxel_position.y());
-    to_voxel.matrix[3][2] = -1.f * ((float) voxel_position.z());
-    to_voxel.matrix[3][3] = 1.f;
-
-    ray = to_voxel.transform_ray(ray); // voxel-space [0, 1] x [0, 1] x [0, 1]
+/**
+ * Intersect a ray expressed in grid space (where voxels have unit size) with
+ * the surface contained in the voxel at position \c voxel, between the voxel
+ * entry and exit distances \c t_beg and \c t_end.
+ */
+__device__ bool intersect_voxel(const Ray3f &ray_grid, const Vector3u &voxel,
+                                float t_beg, float t_end,
+                                const OptixSDFGridData &sdf, float &t) {
+    // voxel-space [0, 1] x [0, 1] x [0, 1]
+    Ray3f ray = ray_grid;
+    ray.o -= Vector3f(voxel);
 
     /**
        Herman Hansson-Söderlund, Alex Evans, and Tomas Akenine-Möller, Ray
        Tracing of Signed Distance Function Grids, Journal of Computer Graphics
        Techniques (JCGT), vol. 11, no. 3, 94-113, 2022
     */
-    Vector3u v000 = voxel_position;
+    Vector3u v000 = voxel;
     Vector3u v100 = v000 + Vector3u(1, 0, 0);
     Vector3u v010 = v000 + Vector3u(0, 1, 0);
     Vector3u v110 = v000 + Vector3u(1, 1, 0);
@@ -259,7 +221,7 @@ extern "C" __global__ void __intersection__sdfgrid() {
     float d_y = ray.d.y();
     float d_z = ray.d.z();
 
-    float a  = s101 - s001; 
+    float a  = s101 - s001;
     float k0 = s000;
     float k1 = s100 - s000;
     float k2 = s010 - s000;
@@ -287,28 +249,175 @@ extern "C" __global__ void __intersection__sdfgrid() {
 
     // Avoid leaking through cracks
     if (sdf.watertight && (eval_sdf(t_beg) < 0)) {
-        optixReportIntersection(t_beg, OPTIX_HIT_KIND_TRIANGLE_FRONT_FACE);
-        return;
+        t = t_beg;
+        return true;
     }
 
     if (c3 != 0) {
         // Cubic polynomial
-        float t = 0;
         bool hit = sdf_solve_cubic(t_beg, t_end, c3, c2, c1, c0, t);
-
-        if (hit && t_beg <= t && t <= t_end)
-            optixReportIntersection(t, OPTIX_HIT_KIND_TRIANGLE_FRONT_FACE);
+        return hit && t_beg <= t && t <= t_end;
     } else {
         // Quadratic or linear polynomial
         float root_0;
         float root_1;
         bool hit = solve_quadratic(c2, c1, c0, root_0, root_1);
 
-        if (hit && t_beg <= root_0 && root_0 <= t_end)
-            optixReportIntersection(root_0, OPTIX_HIT_KIND_TRIANGLE_FRONT_FACE);
-        else if (hit && t_beg <= root_1 && root_1 <= t_end)
-            optixReportIntersection(root_1, OPTIX_HIT_KIND_TRIANGLE_FRONT_FACE);
+        if (hit && t_beg <= root_0 && root_0 <= t_end) {
+            t = root_0;
+            return true;
+        } else if (hit && t_beg <= root_1 && root_1 <= t_end) {
+            t = root_1;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Intersect a ray expressed in grid space with the surface contained in a
+ * brick of the sparse representation. The voxels of the brick are visited in
+ * order along the ray, and empty 4x4x4 blocks of the brick (coarse mask) are
+ * skipped in a single step.
+ */
+__device__ bool intersect_brick(const Ray3f &ray, unsigned int brick_index,
+                                const OptixSDFGridData &sdf, float &t_hit) {
+    const unsigned int *brick = sdf.bricks + brick_index * SDF_BRICK_STRIDE;
+    int res[3] = { (int) sdf.res_x - 1, (int) sdf.res_y - 1,
+                   (int) sdf.res_z - 1 };
+
+    int origin[3], brick_end[3];
+    BoundingBox3f bbox;
+    for (int k = 0; k < 3; ++k) {
+        origin[k]    = (int) brick[k];
+        brick_end[k] = min(origin[k] + SDF_BRICK_SIZE, res[k]);
+        bbox.min[k]  = (float) origin[k];
+        bbox.max[k]  = (float) brick_end[k];
+    }
+
+    float t_min = 0, t_max = 0;
+    if (!intersect_aabb(ray, bbox, t_min, t_max) || t_max < 0.f ||
+        t_min > ray.maxt)
+        return false;
+
+    // Voxel containing the first point of the ray within the brick
+    Vector3f p = ray(fmaxf(t_min, 0.f));
+    int voxel[3];
+    for (int k = 0; k < 3; ++k)
+        voxel[k] = min(max((int) floorf(p[k]), origin[k]), brick_end[k] - 1);
+
+    for (int i = 0; i < 3 * SDF_BRICK_SIZE; ++i) {
+        int local[3] = { voxel[0] - origin[0], voxel[1] - origin[1],
+                         voxel[2] - origin[2] };
+
+        // Coarse level: skip empty 4x4x4 blocks at once
+        int block_bit = (local[0] >> 2) + 2 * (local[1] >> 2) + 4 * (local[2] >> 2);
+        bool block_filled = (brick[3] >> block_bit) & 1;
+
+        int cell_min[3], cell_max[3];
+        for (int k = 0; k < 3; ++k) {
+            cell_min[k] = block_filled ? voxel[k] : origin[k] + (local[k] & ~3);
+            cell_max[k] = min(block_filled ? voxel[k] + 1 : cell_min[k] + 4,
+                              brick_end[k]);
+        }
+
+        // Fine level: intersect voxels that contain the surface
+        if (block_filled) {
+            unsigned int local_index =
+                local[0] + SDF_BRICK_SIZE * (local[1] + SDF_BRICK_SIZE * local[2]);
+            if ((brick[4 + (local_index >> 5)] >> (local_index & 31)) & 1) {
+                BoundingBox3f voxel_bbox;
+                for (int k = 0; k < 3; ++k) {
+                    voxel_bbox.min[k] = (float) voxel[k];
+                    voxel_bbox.max[k] = (float) (voxel[k] + 1);
+                }
+
+                float t_beg = 0, t_end = 0, t = 0;
+                if (intersect_aabb(ray, voxel_bbox, t_beg, t_end) &&
+                    intersect_voxel(ray, Vector3u(voxel[0], voxel[1], voxel[2]),
+                                    t_beg, t_end, sdf, t) &&
+                    t >= 0.f && t <= ray.maxt) {
+                    t_hit = t;
+                    return true;
+                }
+            }
+        }
+
+        // Advance to the next cell along the ray
+        float t_exit[3];
+        for (int k = 0; k < 3; ++k) {
+            if (ray.d[k] > 0)
+                t_exit[k] = ((float) cell_max[k] - ray.o[k]) / ray.d[k];
+            else if (ray.d[k] < 0)
+                t_exit[k] = ((float) cell_min[k] - ray.o[k]) / ray.d[k];
+            else
+                t_exit[k] = INFINITY;
+        }
+
+        float t_next = fminf(t_exit[0], fminf(t_exit[1], t_exit[2]));
+        if (t_next >= t_max || t_next > ray.maxt)
+            return false;
+
+        p = ray(t_next);
+        for (int k = 0; k < 3; ++k) {
+            if (t_exit[k] == t_next)
+                voxel[k] = ray.d[k] > 0 ? cell_max[k] : cell_min[k] - 1;
+            else
+                voxel[k] = min(max((int) floorf(p[k]), cell_min[k]), cell_max[k] - 1);
+
+            if (voxel[k] < origin[k] || voxel[k] >= brick_end[k])
+                return false;
+        }
     }
+
+    return false;
+}
+
+extern "C" __global__ void __intersection__sdfgrid() {
+    const OptixHitGroupData *sbt_data =
+        (OptixHitGroupData *) optixGetSbtDataPointer();
+    OptixSDFGridData &sdf = *((OptixSDFGridData *) sbt_data->data);
+
+    Ray3f ray = get_ray();
+    ray = sdf.to_object.transform_ray(ray); // object-space
+
+    // grid-space [0, res_x - 1] x [0, res_y - 1] x [0, res_z - 1]
+    Vector3f res((float) (sdf.res_x - 1), (float) (sdf.res_y - 1),
+                 (float) (sdf.res_z - 1));
+    ray.o *= res;
+    ray.d *= res;
+
+    if (sdf.bricks) {
+        float t = 0;
+        if (intersect_brick(ray, optixGetPrimitiveIndex(), sdf, t))
+            optixReportIntersection(t, OPTIX_HIT_KIND_TRIANGLE_FRONT_FACE);
+        return;
+    }
+
+    unsigned int voxel_index = sdf.voxel_indices[optixGetPrimitiveIndex()];
+    Vector3u voxel_position = index_to_vec(voxel_index, sdf);
+
+    BoundingBox3f bbox_local;
+    bbox_local.min[0] = (float) voxel_position[0];
+    bbox_local.min[1] = (float) voxel_position[1];
+    bbox_local.min[2] = (float) voxel_position[2];
+    bbox_local.max[0] = (float) voxel_position[0] + 1.f;
+    bbox_local.max[1] = (float) voxel_position[1] + 1.f;
+    bbox_local.max[2] = (float) voxel_position[2] + 1.f;
+
+    float t_beg = 0;
+    float t_end = 0;
+    bool bbox_its = intersect_aabb(ray, bbox_local, t_beg, t_end);
+    // This should theoretically always hit, but OptiX might be a bit
+    // less/more tight numerically hence some rays will miss
+    if (!bbox_its) {
+        return;
+    }
+
+    float t = 0;
+    if (intersect_voxel(ray, voxel_position, t_beg, t_end, sdf, t))
+        optixReportIntersection(t, OPTIX_HIT_KIND_TRIANGLE_FRONT_FACE);
 }
 
 extern "C" __global__ void __closesthit__sdfgrid() {
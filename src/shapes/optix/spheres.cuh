@@ -0,0 +1,14 @@
+#pragma once
+
+#include <mitsuba/render/optix/common.h>
+
+#ifdef __CUDACC__
+
+extern "C" __global__ void __closesthit__spheres() {
+    const OptixHitGroupData *sbt_data = (OptixHitGroupData *) optixGetSbtDataPointer();
+    unsigned int prim_index = optixGetPrimitiveIndex();
+
+    set_preliminary_intersection_to_payload(
+        optixGetRayTmax(), Vector2f(), prim_index, sbt_data->shape_registry_id);
+}
+#endif
@@ -1,15 +1,20 @@
 #include <mitsuba/render/mesh.h>
+#include <mitsuba/core/bfstream.h>
 #include <mitsuba/core/fstream.h>
-#include <mitsuba/core/mstream.h>
 #include <mitsuba/core/fresolver.h>
+#include <mitsuba/core/mmap.h>
 #include <mitsuba/core/properties.h>
 #include <mitsuba/core/util.h>
 #include <mitsuba/core/timer.h>
 #include <mitsuba/core/profiler.h>
+#include <mitsuba/core/string.h>
+#include <mitsuba/core/thread.h>
 #include <drjit/half.h>
+#include <nanothread/nanothread.h>
+#include <atomic>
+#include <mutex>
 #include <unordered_map>
 #include <unordered_set>
-#include <fstream>
 
 NAMESPACE_BEGIN(mitsuba)
 
@@ -21,7 +26,7 @@ PLY (Stanford Triangle Format) mesh loader (:monosp:`ply`)
 ----------------------------------------------------------
 
 .. pluginparameters::
- :extra-rows: 4
+ :extra-rows: 5
 
  * - filename
    - |string|
@@ -42,11 +47,37 @@ PLY (Stanford Triangle Format) mesh loader (:monosp:`ply`)
    - Is the mesh inverted, i.e. should the normal vectors be flipped? (Default:|false|, i.e.
      the normals point outside)
 
+ * - compact_vertex_attributes
+   - |bool|
+   - Store vertex normals (octahedral encoding, 2x16 bits) and texture coordinates (half
+     precision) in compact form, which reduces the memory footprint of the mesh. They are
+     then no longer exposed as (differentiable) scene parameters. (Default: |false|)
+
+ * - alias_sampling
+   - |bool|
+   - Select triangles for surface sampling (e.g. of area emitters) using an alias table,
+     which takes constant time instead of a binary search over the triangles. The mapping
+     of samples to triangles is no longer monotonic, which reduces the benefit of
+     stratified samplers. (Default: |false|)
+
+ * - opacity_bake_resolution
+   - |int|
+   - When larger than zero and the mesh uses a transparent BSDF (e.g. :ref:`mask <bsdf-mask>`),
+     triangles whose opacity is zero at all points of a grid with this many segments per edge
+     are excluded from the acceleration data structure. Rays then pass through them without
+     invoking the BSDF. (Default: 0, i.e. disabled)
+
  * - to_world
    - |transform|
    - Specifies an optional linear object-to-world transformation.
      (Default: none, i.e. object space = world space)
 
+ * - motion_filenames
+   - |string|
+   - Comma-separated list of PLY files with the vertex positions of further
+     keyframes of a deforming mesh (deformation motion blur, see below).
+     (Default: none)
+
  * - vertex_count
    - |int|
    - Total number of vertices
@@ -67,6 +98,12 @@ PLY (Stanford Triangle Format) mesh loader (:monosp:`ply`)
    - Vertex positions buffer (flatten) pre-multiplied by the object-to-world transformation.
    - |exposed|, |differentiable|, |discontinuous|
 
+ * - vertex_motion_positions
+   - :paramtype:`float[]`
+   - Vertex positions of the keyframes 1, 2, .. of a deforming mesh (flatten and
+     concatenated), pre-multiplied by the object-to-world transformation.
+   - |exposed|
+
  * - vertex_normals
    - :paramtype:`float[]`
    - Vertex normals buffer (flatten)  pre-multiplied by the object-to-world transformation.
@@ -120,6 +157,45 @@ multidimensional attribute named ``{vertex|face}_color``.
         'filename': 'my_shape.ply',
         'flip_normals': True
 
+.. _shape-ply-motion:
+
+Deforming objects (e.g. animated characters) can be motion-blurred by
+specifying additional keyframes of their vertex positions via the
+``motion_filenames`` parameter. Each file must contain the same number of
+vertices and faces as the main file, and only its vertex positions are used.
+The keyframes are uniformly distributed over the time interval :math:`[0, 1]`
+(the main file being the first one), and vertex positions are linearly
+interpolated between them at the time of each ray. The shutter of the sensor
+(its ``shutter_open`` and ``shutter_close`` parameters) should therefore span
+this interval.
+
+.. tabs::
+    .. code-tab:: xml
+        :name: ply-motion
+
+        <shape type="ply">
+            <string name="filename" value="frame_0.ply"/>
+            <string name="motion_filenames" value="frame_1.ply, frame_2.ply"/>
+        </shape>
+
+    .. code-tab:: python
+
+        'type': 'ply',
+        'filename': 'frame_0.ply',
+        'motion_filenames': 'frame_1.ply, frame_2.ply'
+
+The keyframes of any mesh can alternatively be set through its
+``vertex_motion_positions`` parameter. Shading normals, texture coordinates and
+other attributes are those of the first keyframe, and deforming meshes cannot
+be emitters or sensors. With the OptiX backend, all deforming meshes of a
+scene (or shape group) must have the same number of keyframes.
+
+In JIT variants, meshes that load the same (unmodified) file with the same
+options share their vertex and index buffers while they exist at the same
+time. This avoids parsing the static geometry of an animation again for every
+frame when consecutive frames are loaded concurrently (see the ``--pipeline``
+option of the ``mitsuba`` executable).
+
 .. note::
 
     Values stored in a RBG color attribute will automatically be converted into spectral model
@@ -130,11 +206,12 @@ template <typename Float, typename Spectrum>
 class PLYMesh final : public Mesh<Float, Spectrum> {
 public:
     MI_IMPORT_BASE(Mesh, m_name, m_bbox, m_to_world, m_vertex_count,
-                   m_face_count, m_vertex_positions, m_vertex_normals,
+                   m_face_count, m_vertex_positions, m_vertex_motion_positions,
+                   m_vertex_normals,
                    m_vertex_texcoords, m_faces, add_attribute,
                    m_face_normals, has_vertex_normals,
                    has_vertex_texcoords, recompute_vertex_normals,
-                   initialize)
+                   initialize, m_mesh_attributes)
     MI_IMPORT_TYPES()
 
     using typename Base::ScalarSize;
@@ -146,6 +223,7 @@ public:
     using typename Base::InputVector3f;
     using typename Base::InputNormal3f;
     using typename Base::FloatStorage;
+    using typename Base::MeshAttribute;
 
     struct PLYElement {
         std::string name;
@@ -184,32 +262,116 @@ public:
         if (!fs::exists(file_path))
             fail("file not found");
 
-        ref<Stream> stream = new FileStream(file_path);
+        /* In JIT variants, meshes that load the same file with the same
+           options (e.g. the static geometry of consecutive frames of an
+           animation that are loaded at the same time) share their buffers */
+        std::shared_ptr<PLYData> shared;
+        std::string motion_filenames = props.string("motion_filenames", "");
+        if constexpr (dr::is_jit_v<Float>) {
+            if (motion_filenames.empty()) {
+                std::string key = tfm::format(
+                    "%s|%i|%i|%i|%s", file_path.string(),
+                    fs::last_write_time(file_path), (int) m_face_normals,
+                    (int) flip_tex_coords, m_to_world.scalar().matrix);
+                shared = shared_data(key);
+
+                bool reused = false;
+                /* critical section */ {
+                    std::lock_guard<std::mutex> guard(shared->mutex);
+                    if (shared->loaded) {
+                        m_vertex_count     = shared->vertex_count;
+                        m_face_count       = shared->face_count;
+                        m_bbox             = shared->bbox;
+                        m_vertex_positions = shared->vertex_positions;
+                        m_vertex_normals   = shared->vertex_normals;
+                        m_vertex_texcoords = shared->vertex_texcoords;
+                        m_faces            = shared->faces;
+                        m_mesh_attributes  = shared->attributes;
+                        reused = true;
+                    }
+                }
+
+                if (reused) {
+                    Log(Debug, "\"%s\": reusing the data of an identical mesh",
+                        m_name);
+                    m_shared = std::move(shared);
+                    initialize();
+                    return;
+                }
+            }
+        }
+
+        ref<Stream> stream = new BufferedFileStream(file_path);
         ScopedPhase phase(ProfilerPhase::LoadGeometry);
         Timer timer;
 
         PLYHeader header;
         try {
             header = parse_ply_header(stream);
-            if (header.ascii) {
-                if (stream->size() > 100 * 1024)
-                    Log(Warn,
-                        "\"%s\": performance warning -- this file uses the ASCII PLY format, which "
-                        "is slow to parse. Consider converting it to the binary PLY format.",
-                        m_name);
-                stream = parse_ascii((FileStream *) stream.get(), header.elements);
-            }
         } catch (const std::exception &e) {
             fail(e.what());
         }
 
+        /* Access the element data through a pointer: binary files are
+           memory-mapped, ASCII files are converted into a binary buffer */
+        const uint8_t *data;
+        size_t data_size, offset;
+        ref<MemoryMappedFile> mmap;
+        std::unique_ptr<uint8_t[]> tmp;
+
+#if !defined(_WIN32)
+        mmap      = new MemoryMappedFile(file_path);
+        data      = (const uint8_t *) mmap->data();
+        data_size = mmap->size();
+        offset    = stream->tell();
+#else
+        // Memory-mapped IO performs surprisingly poorly on Windows
+        data_size = stream->size() - stream->tell();
+        tmp.reset(new uint8_t[data_size]);
+        stream->read(tmp.get(), data_size);
+        data      = tmp.get();
+        offset    = 0;
+#endif
+
+        if (header.ascii) {
+            if (data_size > 100 * 1024 * 1024)
+                Log(Warn,
+                    "\"%s\": performance warning -- this file uses the ASCII PLY format, which "
+                    "is slow to parse. Consider converting it to the binary PLY format.",
+                    m_name);
+            try {
+                tmp = parse_ascii((const char *) data + offset,
+                                  (const char *) data + data_size,
+                                  header.elements, data_size);
+            } catch (const std::exception &e) {
+                fail(e.what());
+            }
+            mmap   = nullptr;
+            data   = tmp.get();
+            offset = 0;
+        }
+
         bool has_vertex_normals = false;
         bool has_vertex_texcoords = false;
 
         ref<Struct> vertex_struct = new Struct();
         ref<Struct> face_struct = new Struct();
 
+        ThreadEnvironment env;
+        std::mutex mutex;
+
         for (auto &el : header.elements) {
+            size_t i_struct_size = el.struct_->size();
+            if (data_size - offset < i_struct_size * el.count)
+                fail("invalid file -- unexpected end of file");
+            const uint8_t *src = data + offset;
+            offset += i_struct_size * el.count;
+
+            // Number of packets and packets per work unit of the thread pool
+            size_t packet_count =
+                (el.count + elements_per_packet - 1) / elements_per_packet;
+            size_t grain_size = std::max<size_t>(1, packet_count / (4 * Thread::thread_count()));
+
             if (el.name == "vertex") {
                 for (auto name : { "x", "y", "z" })
                     vertex_struct->append(name, struct_type_v<InputFloat>);
@@ -250,14 +412,38 @@ public:
                 find_other_fields("vertex_", vertex_attributes_descriptors,
                                   vertex_struct, el.struct_, reserved_names);
 
-                size_t i_struct_size = el.struct_->size();
                 size_t o_struct_size = vertex_struct->size();
 
+                /* When the file stores all needed fields as host-endian
+                   'float32' values, read them directly from the mapped
+                   file instead of converting every packet */
+                ptrdiff_t i_position_offset = direct_offset(el.struct_, { "x", "y", "z" }),
+                          i_normal_offset   = direct_offset(el.struct_, { "nx", "ny", "nz" }),
+                          i_texcoord_offset = direct_offset(el.struct_, { "u", "v" });
+
+                bool direct = vertex_attributes_descriptors.empty() &&
+                              i_position_offset >= 0 &&
+                              (!has_vertex_normals || i_normal_offset >= 0) &&
+                              (!has_vertex_texcoords || i_texcoord_offset >= 0);
+
+                /* Files that only contain positions even match the internal
+                   layout, which avoids the temporary position buffer */
+                bool zero_copy = direct && !has_vertex_normals &&
+                                 !has_vertex_texcoords &&
+                                 i_struct_size == 3 * sizeof(InputFloat) &&
+                                 m_to_world.scalar() == ScalarTransform4f();
+
                 ref<StructConverter> conv;
-                try {
-                    conv = new StructConverter(el.struct_, vertex_struct);
-                } catch (const std::exception &e) {
-                    fail(e.what());
+                if (!direct) {
+                    try {
+                        conv = new StructConverter(el.struct_, vertex_struct);
+                    } catch (const std::exception &e) {
+                        fail(e.what());
+                    }
+
+                    i_position_offset = 0;
+                    i_normal_offset   = sizeof(InputFloat) * 3;
+                    i_texcoord_offset = sizeof(InputFloat) * (m_face_normals ? 3 : 6);
                 }
 
                 m_vertex_count = (ScalarSize) el.count;
@@ -265,81 +451,96 @@ public:
                 for (auto& descr: vertex_attributes_descriptors)
                     descr.buf.resize(m_vertex_count * descr.dim);
 
-                std::unique_ptr<float[]> vertex_positions(new float[m_vertex_count * 3]);
+                std::unique_ptr<float[]> vertex_positions(
+                    zero_copy ? nullptr : new float[m_vertex_count * 3]);
                 std::unique_ptr<float[]> vertex_normals(new float[m_vertex_count * 3]);
                 std::unique_ptr<float[]> vertex_texcoords(new float[m_vertex_count * 2]);
 
-                InputFloat* position_ptr = vertex_positions.get();
-                InputFloat *normal_ptr   = vertex_normals.get();
-                InputFloat *texcoord_ptr = vertex_texcoords.get();
-
-                size_t packet_count     = el.count / elements_per_packet;
-                size_t remainder_count  = el.count % elements_per_packet;
-                size_t i_packet_size    = i_struct_size * elements_per_packet;
-                size_t i_remainder_size = i_struct_size * remainder_count;
-                size_t o_packet_size    = o_struct_size * elements_per_packet;
-
-                std::unique_ptr<uint8_t[]> buf(new uint8_t[i_packet_size]);
-                std::unique_ptr<uint8_t[]> buf_o(new uint8_t[o_packet_size]);
-
-                for (size_t i = 0; i <= packet_count; ++i) {
-                    uint8_t *target = (uint8_t *) buf_o.get();
-                    size_t psize = (i != packet_count) ? i_packet_size : i_remainder_size;
-                    size_t count = (i != packet_count) ? elements_per_packet : remainder_count;
-                    stream->read(buf.get(), psize);
-                    if (unlikely(!conv->convert(count, buf.get(), buf_o.get())))
-                        fail("incompatible contents -- is this a triangle mesh?");
-
-                    for (size_t j = 0; j < count; ++j) {
-                        InputPoint3f p = dr::load<InputPoint3f>(target);
-                        p = m_to_world.scalar().transform_affine(p);
-                        if (unlikely(!all(dr::isfinite(p))))
-                            fail("mesh contains invalid vertex position data");
-                        m_bbox.expand(p);
-                        dr::store(position_ptr, p);
-                        position_ptr += 3;
-
-                        if (has_vertex_normals) {
-                            InputNormal3f n = dr::load<InputNormal3f>(
-                                target + sizeof(InputFloat) * 3);
-                            n = dr::normalize(m_to_world.scalar().transform_affine(n));
-                            dr::store(normal_ptr, n);
-                            normal_ptr += 3;
-                        }
-
-                        if (has_vertex_texcoords) {
-                            InputVector2f uv = dr::load<InputVector2f>(
-                                target + (m_face_normals
-                                              ? sizeof(InputFloat) * 3
-                                              : sizeof(InputFloat) * 6));
-                            if (flip_tex_coords)
-                                uv.y() = 1.f - uv.y();
-                            dr::store(texcoord_ptr, uv);
-                            texcoord_ptr += 2;
-                        }
+                std::atomic<bool> incompatible { false }, invalid { false };
+
+                dr::parallel_for(
+                    dr::blocked_range<size_t>(0, packet_count, grain_size),
+                    [&](const dr::blocked_range<size_t> &range) {
+                        ScopedSetThreadEnvironment set_env(env);
+                        std::unique_ptr<uint8_t[]> buf_o(
+                            direct ? nullptr : new uint8_t[o_struct_size * elements_per_packet]);
+                        ScalarBoundingBox3f bbox;
+
+                        for (size_t i = range.begin(); i != range.end(); ++i) {
+                            size_t start = i * elements_per_packet,
+                                   count = std::min(elements_per_packet, el.count - start);
+                            const uint8_t *target = src + start * i_struct_size;
+                            size_t stride = i_struct_size;
+
+                            if (!direct) {
+                                if (unlikely(!conv->convert(count, target, buf_o.get()))) {
+                                    incompatible = true;
+                                    return;
+                                }
+                                target = buf_o.get();
+                                stride = o_struct_size;
+                            }
 
-                        size_t target_offset =
-                            sizeof(InputFloat) *
-                            (!m_face_normals
-                                 ? (has_vertex_texcoords ? 8 : 6)
-                                 : (has_vertex_texcoords ? 5 : 3));
-
-                        for (size_t k = 0; k < vertex_attributes_descriptors.size(); ++k) {
-                            auto& descr = vertex_attributes_descriptors[k];
-                            memcpy(descr.buf.data() + (i * elements_per_packet + j) * descr.dim,
-                                   target + target_offset,
-                                   descr.dim * sizeof(InputFloat));
-                            target_offset += descr.dim * sizeof(InputFloat);
+                            for (size_t j = 0; j < count; ++j) {
+                                size_t index = start + j;
+
+                                InputPoint3f p = dr::load<InputPoint3f>(target + i_position_offset);
+                                p = m_to_world.scalar().transform_affine(p);
+                                if (unlikely(!all(dr::isfinite(p)))) {
+                                    invalid = true;
+                                    return;
+                                }
+                                bbox.expand(p);
+                                if (!zero_copy)
+                                    dr::store(vertex_positions.get() + index * 3, p);
+
+                                if (has_vertex_normals) {
+                                    InputNormal3f n = dr::load<InputNormal3f>(target + i_normal_offset);
+                                    n = dr::normalize(m_to_world.scalar().transform_affine(n));
+                                    dr::store(vertex_normals.get() + index * 3, n);
+                                }
+
+                                if (has_vertex_texcoords) {
+                                    InputVector2f uv = dr::load<InputVector2f>(target + i_texcoord_offset);
+                                    if (flip_tex_coords)
+                                        uv.y() = 1.f - uv.y();
+                                    dr::store(vertex_texcoords.get() + index * 2, uv);
+                                }
+
+                                size_t target_offset =
+                                    sizeof(InputFloat) *
+                                    (!m_face_normals
+                                         ? (has_vertex_texcoords ? 8 : 6)
+                                         : (has_vertex_texcoords ? 5 : 3));
+
+                                for (size_t k = 0; k < vertex_attributes_descriptors.size(); ++k) {
+                                    auto& descr = vertex_attributes_descriptors[k];
+                                    memcpy(descr.buf.data() + index * descr.dim,
+                                           target + target_offset,
+                                           descr.dim * sizeof(InputFloat));
+                                    target_offset += descr.dim * sizeof(InputFloat);
+                                }
+
+                                target += stride;
+                            }
                         }
 
-                        target += o_struct_size;
+                        std::lock_guard<std::mutex> guard(mutex);
+                        m_bbox.expand(bbox);
                     }
-                }
+                );
+
+                if (incompatible)
+                    fail("incompatible contents -- is this a triangle mesh?");
+                if (invalid)
+                    fail("mesh contains invalid vertex position data");
 
                 for (auto& descr: vertex_attributes_descriptors)
                     add_attribute(descr.name, descr.dim, descr.buf);
 
-                m_vertex_positions = dr::load<FloatStorage>(vertex_positions.get(), m_vertex_count * 3);
+                m_vertex_positions = dr::load<FloatStorage>(
+                    zero_copy ? (const InputFloat *) src : vertex_positions.get(),
+                    m_vertex_count * 3);
                 if (!m_face_normals)
                     m_vertex_normals = dr::load<FloatStorage>(vertex_normals.get(), m_vertex_count * 3);
                 if (has_vertex_texcoords)
@@ -367,14 +568,26 @@ public:
                 find_other_fields("face_", face_attributes_descriptors,
                                   face_struct, el.struct_, reserved_names);
 
-                size_t i_struct_size = el.struct_->size();
                 size_t o_struct_size = face_struct->size();
 
+                /* The common layout of a 8-bit vertex count followed by
+                   three 32-bit indices can be read without conversion */
+                const Struct::Field &count_field = el.struct_->field(field_name + ".count");
+                ptrdiff_t i_index_offset = direct_offset(el.struct_, { "i0", "i1", "i2" }, true);
+                bool direct = face_attributes_descriptors.empty() &&
+                              el.struct_->field_count() == 4 &&
+                              i_index_offset >= 0 &&
+                              (count_field.type == Struct::Type::UInt8 ||
+                               count_field.type == Struct::Type::Int8);
+
                 ref<StructConverter> conv;
-                try {
-                    conv = new StructConverter(el.struct_, face_struct);
-                } catch (const std::exception &e) {
-                    fail(e.what());
+                if (!direct) {
+                    try {
+                        conv = new StructConverter(el.struct_, face_struct);
+                    } catch (const std::exception &e) {
+                        fail(e.what());
+                    }
+                    i_index_offset = 0;
                 }
 
                 m_face_count = (ScalarSize) el.count;
@@ -383,43 +596,59 @@ public:
                     descr.buf.resize(m_face_count * descr.dim);
 
                 std::unique_ptr<uint32_t[]> faces(new uint32_t[m_face_count * 3]);
-                ScalarIndex* face_ptr = faces.get();
-
-                size_t packet_count     = el.count / elements_per_packet;
-                size_t remainder_count  = el.count % elements_per_packet;
-                size_t i_packet_size    = i_struct_size * elements_per_packet;
-                size_t i_remainder_size = i_struct_size * remainder_count;
-                size_t o_packet_size    = o_struct_size * elements_per_packet;
-
-                std::unique_ptr<uint8_t[]> buf(new uint8_t[i_packet_size]);
-                std::unique_ptr<uint8_t[]> buf_o(new uint8_t[o_packet_size]);
-
-                for (size_t i = 0; i <= packet_count; ++i) {
-                    uint8_t *target = (uint8_t *) buf_o.get();
-                    size_t psize = (i != packet_count) ? i_packet_size : i_remainder_size;
-                    size_t count = (i != packet_count) ? elements_per_packet : remainder_count;
-
-                    stream->read(buf.get(), psize);
-                    if (unlikely(!conv->convert(count, buf.get(), buf_o.get())))
-                        fail("incompatible contents -- is this a triangle mesh?");
-
-                    for (size_t j = 0; j < count; ++j) {
-                        ScalarIndex3 fi = dr::load<ScalarIndex3>(target);
-                        dr::store(face_ptr, fi);
-                        face_ptr += 3;
-
-                        size_t target_offset = sizeof(InputFloat) * 3;
-                        for (size_t k = 0; k < face_attributes_descriptors.size(); ++k) {
-                            auto& descr = face_attributes_descriptors[k];
-                            memcpy(descr.buf.data() + (i * elements_per_packet + j) * descr.dim,
-                                   target + target_offset,
-                                   descr.dim * sizeof(InputFloat));
-                            target_offset += descr.dim * sizeof(InputFloat);
-                        }
 
-                        target += o_struct_size;
+                std::atomic<bool> incompatible { false };
+
+                dr::parallel_for(
+                    dr::blocked_range<size_t>(0, packet_count, grain_size),
+                    [&](const dr::blocked_range<size_t> &range) {
+                        ScopedSetThreadEnvironment set_env(env);
+                        std::unique_ptr<uint8_t[]> buf_o(
+                            direct ? nullptr : new uint8_t[o_struct_size * elements_per_packet]);
+
+                        for (size_t i = range.begin(); i != range.end(); ++i) {
+                            size_t start = i * elements_per_packet,
+                                   count = std::min(elements_per_packet, el.count - start);
+                            const uint8_t *target = src + start * i_struct_size;
+                            size_t stride = i_struct_size;
+
+                            if (!direct) {
+                                if (unlikely(!conv->convert(count, target, buf_o.get()))) {
+                                    incompatible = true;
+                                    return;
+                                }
+                                target = buf_o.get();
+                                stride = o_struct_size;
+                            }
+
+                            for (size_t j = 0; j < count; ++j) {
+                                size_t index = start + j;
+
+                                if (direct && unlikely(target[count_field.offset] != 3)) {
+                                    incompatible = true;
+                                    return;
+                                }
+
+                                memcpy(faces.get() + index * 3, target + i_index_offset,
+                                       sizeof(ScalarIndex) * 3);
+
+                                size_t target_offset = sizeof(InputFloat) * 3;
+                                for (size_t k = 0; k < face_attributes_descriptors.size(); ++k) {
+                                    auto& descr = face_attributes_descriptors[k];
+                                    memcpy(descr.buf.data() + index * descr.dim,
+                                           target + target_offset,
+                                           descr.dim * sizeof(InputFloat));
+                                    target_offset += descr.dim * sizeof(InputFloat);
+                                }
+
+                                target += stride;
+                            }
+                        }
                     }
-                }
+                );
+
+                if (incompatible)
+                    fail("incompatible contents -- is this a triangle mesh?");
 
                 for (auto& descr: face_attributes_descriptors)
                     add_attribute(descr.name, descr.dim, descr.buf);
@@ -427,11 +656,10 @@ public:
                 m_faces = dr::load<DynamicBuffer<UInt32>>(faces.get(), m_face_count * 3);
             } else {
                 Log(Warn, "\"%s\": skipping unknown element \"%s\"", m_name, el.name);
-                stream->seek(stream->tell() + el.struct_->size() * el.count);
             }
         }
 
-        if (stream->tell() != stream->size())
+        if (offset != data_size)
             fail("invalid file -- trailing content");
 
         Log(Debug, "\"%s\": read %i faces, %i vertices (%s in %s)",
@@ -448,10 +676,139 @@ public:
                 util::time_string((float) timer2.value()));
         }
 
+        if (shared) {
+            std::lock_guard<std::mutex> guard(shared->mutex);
+            shared->vertex_count     = m_vertex_count;
+            shared->face_count       = m_face_count;
+            shared->bbox             = m_bbox;
+            shared->vertex_positions = m_vertex_positions;
+            shared->vertex_normals   = m_vertex_normals;
+            shared->vertex_texcoords = m_vertex_texcoords;
+            shared->faces            = m_faces;
+            shared->attributes       = m_mesh_attributes;
+            shared->loaded           = true;
+        }
+
+        if (!motion_filenames.empty())
+            load_motion_keys(string::tokenize(motion_filenames, ", "));
+
+        m_shared = std::move(shared);
         initialize();
     }
 
 private:
+    /// Geometry loaded from a file, which identical meshes can reuse
+    struct PLYData {
+        std::mutex mutex;
+        bool loaded = false;
+        ScalarSize vertex_count = 0, face_count = 0;
+        ScalarBoundingBox3f bbox;
+        FloatStorage vertex_positions, vertex_normals, vertex_texcoords;
+        DynamicBuffer<UInt32> faces;
+        std::unordered_map<std::string, MeshAttribute> attributes;
+    };
+
+    /**
+     * \brief Return the geometry associated with the given cache key, or a
+     * new instance that has yet to be loaded
+     *
+     * The cache only holds weak references: the geometry of a file is
+     * released once the last mesh using it is destroyed. Since the buffers of
+     * JIT variants are reference-counted, sharing them doesn't duplicate any
+     * memory, and subsequent modifications (e.g. through \c traverse())
+     * only affect the mesh that performs them.
+     */
+    static std::shared_ptr<PLYData> shared_data(const std::string &key) {
+        static std::mutex cache_mutex;
+        static std::unordered_map<std::string, std::weak_ptr<PLYData>> cache;
+
+        std::lock_guard<std::mutex> guard(cache_mutex);
+        std::shared_ptr<PLYData> data = cache[key].lock();
+        if (!data) {
+            // Drop the entries of meshes that no longer exist
+            for (auto it = cache.begin(); it != cache.end();) {
+                if (it->second.expired())
+                    it = cache.erase(it);
+                else
+                    ++it;
+            }
+            data = std::make_shared<PLYData>();
+            cache[key] = data;
+        }
+        return data;
+    }
+
+    /**
+     * \brief Load the vertex positions of further keyframes of a deforming
+     * mesh from a sequence of PLY files with the same topology
+     */
+    void load_motion_keys(const std::vector<std::string> &filenames) {
+        size_t key_size = (size_t) m_vertex_count * 3;
+        std::unique_ptr<InputFloat[]> motion(new InputFloat[key_size * filenames.size()]);
+
+        for (size_t i = 0; i < filenames.size(); ++i) {
+            Properties props("ply");
+            props.set_string("filename", filenames[i]);
+            props.set_bool("face_normals", true);
+            props.set_transform("to_world",
+                                Properties::Transform4f(m_to_world.scalar()));
+            ref<PLYMesh> key = new PLYMesh(props);
+
+            if (key->vertex_count() != m_vertex_count ||
+                key->face_count() != m_face_count)
+                Throw("Error while loading PLY file \"%s\": keyframe \"%s\" "
+                      "has %u vertices and %u faces (expected %u and %u)!",
+                      m_name, filenames[i], key->vertex_count(),
+                      key->face_count(), m_vertex_count, m_face_count);
+
+            auto &&positions = dr::migrate(key->vertex_positions_buffer(), AllocType::Host);
+            if constexpr (dr::is_jit_v<Float>)
+                dr::sync_thread();
+            memcpy(motion.get() + i * key_size, positions.data(),
+                   key_size * sizeof(InputFloat));
+
+            m_bbox.expand(key->bbox());
+        }
+
+        m_vertex_motion_positions =
+            dr::load<FloatStorage>(motion.get(), key_size * filenames.size());
+
+        Log(Debug, "\"%s\": loaded %zu additional keyframes", m_name,
+            filenames.size());
+    }
+
+    /**
+     * \brief Return the byte offset of a sequence of fields that can be read
+     * from the file without any conversion, or -1 if this is not possible
+     *
+     * This requires the fields to be stored consecutively using the host
+     * byte order and the same type as the internal representation (i.e.
+     * 'float32' for vertex data and 32-bit integers for face indices).
+     */
+    static ptrdiff_t direct_offset(const Struct *s,
+                                   std::initializer_list<const char *> names,
+                                   bool indices = false) {
+        if (s->byte_order() != Struct::host_byte_order())
+            return -1;
+
+        ptrdiff_t result = -1;
+        size_t expected = 0;
+        for (const char *name : names) {
+            if (!s->has_field(name))
+                return -1;
+            const Struct::Field &f = s->field(name);
+            bool compatible = indices ? (f.type == Struct::Type::UInt32 ||
+                                         f.type == Struct::Type::Int32)
+                                      : f.type == struct_type_v<InputFloat>;
+            if (!compatible || f.size != 4 || (result >= 0 && f.offset != expected))
+                return -1;
+            if (result < 0)
+                result = (ptrdiff_t) f.offset;
+            expected = f.offset + f.size;
+        }
+        return result;
+    }
+
     PLYHeader parse_ply_header(Stream *stream) {
         Struct::ByteOrder byte_order = Struct::host_byte_order();
         bool ply_tag_seen = false;
@@ -588,108 +945,228 @@ private:
         return header;
     }
 
-    ref<Stream> parse_ascii(FileStream *in, const std::vector<PLYElement> &elements) {
-        ref<Stream> out = new MemoryStream();
-        std::fstream &is = *in->native();
-        for (auto const &el : elements) {
-            for (size_t i = 0; i < el.count; ++i) {
-                for (auto const &field : *(el.struct_)) {
-                    switch (field.type) {
-                        case Struct::Type::Int8: {
-                                int value;
-                                if (!(is >> value)) Throw("\"%s\": could not parse \"char\" value for field %s", m_name, field.name);
-                                if (value < -128 || value > 127)
-                                    Throw("\"%s\": could not parse \"char\" value for field %s", m_name, field.name);
-                                out->write((int8_t) value);
-                            }
-                            break;
-
-                        case Struct::Type::UInt8: {
-                                int value;
-                                if (!(is >> value))
-                                    Throw("\"%s\": could not parse \"uchar\" value for field %s (may be due to non-triangular faces)", m_name, field.name);
-                                if (value < 0 || value > 255)
-                                    Throw("\"%s\": could not parse \"uchar\" value for field %s (may be due to non-triangular faces)", m_name, field.name);
-                                out->write((uint8_t) value);
-                            }
-                            break;
+    /**
+     * \brief Convert the elements of an ASCII PLY file into the binary layout
+     * described by their ``Struct`` records
+     *
+     * Every element must be stored on a separate line. The text is split into
+     * chunks at line boundaries, which are first scanned to determine the
+     * index of their first element and then parsed in parallel.
+     *
+     * \param size
+     *     Returns the size of the binary data in bytes
+     */
+    std::unique_ptr<uint8_t[]> parse_ascii(const char *start, const char *end,
+                                           const std::vector<PLYElement> &elements,
+                                           size_t &size) {
+        // Index of the first line and byte offset of every element
+        std::vector<size_t> el_line(elements.size() + 1), el_offset(elements.size());
+        size = 0;
+        for (size_t i = 0; i < elements.size(); ++i) {
+            el_line[i + 1] = el_line[i] + elements[i].count;
+            el_offset[i] = size;
+            size += elements[i].struct_->size() * elements[i].count;
+        }
+        size_t line_count = el_line.back();
 
-                        case Struct::Type::Int16: {
-                                int16_t value;
-                                if (!(is >> value)) Throw("\"%s\": could not parse \"short\" value for field %s", m_name, field.name);
-                                out->write(value);
-                            }
-                            break;
+        std::unique_ptr<uint8_t[]> out(new uint8_t[std::max<size_t>(size, 1)]);
 
-                        case Struct::Type::UInt16: {
-                                uint16_t value;
-                                if (!(is >> value)) Throw("\"%s\": could not parse \"ushort\" value for field %s", m_name, field.name);
-                                out->write(value);
-                            }
-                            break;
+        auto next_line = [end](const char *ptr) {
+            const char *next = (const char *) memchr(ptr, '\n', end - ptr);
+            return next ? next + 1 : end;
+        };
 
-                        case Struct::Type::Int32: {
-                                int32_t value;
-                                if (!(is >> value)) Throw("\"%s\": could not parse \"int\" value for field %s", m_name, field.name);
-                                out->write(value);
-                            }
-                            break;
+        auto is_blank = [](const char *ptr, const char *line_end) {
+            for (; ptr != line_end; ++ptr)
+                if (*ptr != ' ' && *ptr != '\t' && *ptr != '\r' && *ptr != '\n')
+                    return false;
+            return true;
+        };
 
-                        case Struct::Type::UInt32: {
-                                uint32_t value;
-                                if (!(is >> value)) Throw("\"%s\": could not parse \"uint\" value for field %s", m_name, field.name);
-                                out->write(value);
-                            }
-                            break;
+        // Split the text into chunks of complete lines
+        size_t text_size = end - start,
+               chunk_count = std::max<size_t>(1, std::min<size_t>(
+                   text_size / (1024 * 1024), 4 * Thread::thread_count()));
+        std::vector<const char *> bounds(chunk_count + 1, end);
+        bounds[0] = start;
+        for (size_t i = 1; i < chunk_count; ++i) {
+            const char *ptr = std::max(bounds[i - 1], start + text_size / chunk_count * i);
+            bounds[i] = ptr == start ? start : next_line(ptr - 1);
+        }
 
-                        case Struct::Type::Int64: {
-                                int64_t value;
-                                if (!(is >> value)) Throw("\"%s\": could not parse \"long\" value for field %s", m_name, field.name);
-                                out->write(value);
-                            }
-                            break;
+        ThreadEnvironment env;
+        std::vector<size_t> chunk_line(chunk_count + 1, 0);
+        std::vector<std::exception_ptr> errors(chunk_count);
+
+        // 1. Count the (non-blank) lines of every chunk
+        dr::parallel_for(
+            dr::blocked_range<size_t>(0, chunk_count, 1),
+            [&](const dr::blocked_range<size_t> &range) {
+                for (size_t i = range.begin(); i != range.end(); ++i) {
+                    size_t count = 0;
+                    for (const char *ptr = bounds[i]; ptr < bounds[i + 1]; ) {
+                        const char *next = next_line(ptr);
+                        count += !is_blank(ptr, next);
+                        ptr = next;
+                    }
+                    chunk_line[i + 1] = count;
+                }
+            }
+        );
 
-                        case Struct::Type::UInt64: {
-                                uint64_t value;
-                                if (!(is >> value)) Throw("\"%s\": could not parse \"ulong\" value for field %s", m_name, field.name);
-                                out->write(value);
-                            }
-                            break;
+        for (size_t i = 0; i < chunk_count; ++i)
+            chunk_line[i + 1] += chunk_line[i];
 
-                        case Struct::Type::Float16: {
-                                float value;
-                                if (!(is >> value)) Throw("\"%s\": could not parse \"half\" value for field %s", m_name, field.name);
-                                out->write(dr::half::float32_to_float16(value));
+        if (chunk_line.back() > line_count)
+            Throw("\"%s\": trailing tokens after end of PLY file", m_name);
+        else if (chunk_line.back() < line_count)
+            Throw("\"%s\": unexpected end of PLY file", m_name);
+
+        // 2. Parse the lines directly into the output buffer
+        dr::parallel_for(
+            dr::blocked_range<size_t>(0, chunk_count, 1),
+            [&](const dr::blocked_range<size_t> &range) {
+                ScopedSetThreadEnvironment set_env(env);
+                for (size_t i = range.begin(); i != range.end(); ++i) {
+                    try {
+                        size_t line = chunk_line[i], el = 0;
+                        for (const char *ptr = bounds[i]; ptr < bounds[i + 1]; ) {
+                            const char *next = next_line(ptr);
+                            if (is_blank(ptr, next)) {
+                                ptr = next;
+                                continue;
                             }
-                            break;
 
-                        case Struct::Type::Float32: {
-                                float value;
-                                if (!(is >> value)) Throw("\"%s\": could not parse \"float\" value for field %s", m_name, field.name);
-                                out->write(value);
-                            }
-                            break;
+                            while (line >= el_line[el + 1])
+                                ++el;
 
-                        case Struct::Type::Float64: {
-                                double value;
-                                if (!(is >> value)) Throw("\"%s\": could not parse \"double\" value for field %s", m_name, field.name);
-                                out->write(value);
-                            }
-                            break;
+                            const Struct *struct_ = elements[el].struct_.get();
+                            uint8_t *target = out.get() + el_offset[el] +
+                                              (line - el_line[el]) * struct_->size();
+
+                            for (auto const &field : *struct_)
+                                ptr = parse_ascii_value(ptr, next, field, target + field.offset);
+
+                            if (!is_blank(ptr, next))
+                                Throw("\"%s\": excess tokens in line %zu of element \"%s\" "
+                                      "(may be due to non-triangular faces)",
+                                      m_name, line - el_line[el], elements[el].name);
 
-                        default:
-                            Throw("\"%s\": internal error", m_name);
+                            ptr = next;
+                            ++line;
+                        }
+                    } catch (...) {
+                        errors[i] = std::current_exception();
                     }
                 }
             }
-        }
-        std::string token;
-        if (is >> token)
-            Throw("\"%s\": trailing tokens after end of PLY file", m_name);
-        out->seek(0);
+        );
+
+        for (auto &error : errors)
+            if (error)
+                std::rethrow_exception(error);
+
         return out;
     }
 
+    /// Parse a single value of an ASCII PLY file and store it in binary form
+    const char *parse_ascii_value(const char *ptr, const char *end,
+                                  const Struct::Field &field, uint8_t *target) const {
+        while (ptr != end && (*ptr == ' ' || *ptr == '\t'))
+            ++ptr;
+
+        auto fail = [&](const char *type) {
+            Throw("\"%s\": could not parse \"%s\" value for field %s", m_name,
+                  type, field.name);
+        };
+
+        auto parse_int = [&](const char *type, int64_t min_value, uint64_t max_value) {
+            bool negative = ptr != end && *ptr == '-';
+            if (ptr != end && (*ptr == '-' || *ptr == '+'))
+                ++ptr;
+
+            const char *digits = ptr;
+            uint64_t value = 0;
+            while (ptr != end && *ptr >= '0' && *ptr <= '9') {
+                value = value * 10 + (uint64_t) (*ptr - '0');
+                ++ptr;
+            }
+
+            if (ptr == digits || (negative && value > (uint64_t) 0 - (uint64_t) min_value) ||
+                (!negative && value > max_value))
+                fail(type);
+            return negative ? (int64_t) (0 - value) : (int64_t) value;
+        };
+
+        auto parse_float = [&](const char *type, auto value) {
+            using T = decltype(value);
+            char *next = nullptr;
+            try {
+                value = string::parse_float<T>(ptr, end, &next);
+            } catch (const std::exception &) {
+                fail(type);
+            }
+            ptr = next;
+            return value;
+        };
+
+        auto store = [target](auto value) {
+            memcpy(target, &value, sizeof(value));
+        };
+
+        switch (field.type) {
+            case Struct::Type::Int8:
+                store((int8_t) parse_int("char", -128, 127));
+                break;
+
+            case Struct::Type::UInt8:
+                store((uint8_t) parse_int("uchar", 0, 255));
+                break;
+
+            case Struct::Type::Int16:
+                store((int16_t) parse_int("short", INT16_MIN, INT16_MAX));
+                break;
+
+            case Struct::Type::UInt16:
+                store((uint16_t) parse_int("ushort", 0, UINT16_MAX));
+                break;
+
+            case Struct::Type::Int32:
+                store((int32_t) parse_int("int", INT32_MIN, INT32_MAX));
+                break;
+
+            case Struct::Type::UInt32:
+                store((uint32_t) parse_int("uint", 0, UINT32_MAX));
+                break;
+
+            case Struct::Type::Int64:
+                store((int64_t) parse_int("long", INT64_MIN, INT64_MAX));
+                break;
+
+            case Struct::Type::UInt64:
+                // Values above INT64_MAX are not supported
+                store((uint64_t) parse_int("ulong", 0, INT64_MAX));
+                break;
+
+            case Struct::Type::Float16:
+                store(dr::half::float32_to_float16(parse_float("half", 0.f)));
+                break;
+
+            case Struct::Type::Float32:
+                store(parse_float("float", 0.f));
+                break;
+
+            case Struct::Type::Float64:
+                store(parse_float("double", 0.0));
+                break;
+
+            default:
+                Throw("\"%s\": internal error", m_name);
+        }
+
+        return ptr;
+    }
+
     void find_other_fields(const std::string& type, std::vector<PLYAttributeDescriptor> &vertex_attributes_descriptors, ref<Struct> target_struct,
         ref<Struct> ref_struct, std::unordered_set<std::string> &reserved_names) {
 
@@ -844,6 +1321,9 @@ private:
     }
 
     MI_DECLARE_CLASS()
+private:
+    /// Geometry shared with identical meshes (JIT variants only)
+    std::shared_ptr<PLYData> m_shared;
 };
 
 MI_IMPLEMENT_CLASS_VARIANT(PLYMesh, Mesh)
@@ -55,6 +55,15 @@ and has a surface normal that points into the positive Z-direction.
 To change the rectangle scale, rotation, or translation, use the
 :monosp:`to_world` parameter.
 
+When the rectangle is used as an area light, reference points that see it
+under a large solid angle (e.g. a window or a softbox next to the scene)
+sample it uniformly in solid angle using the spherical rectangle
+parameterization by Ureña et al. (EGSR 2013), which avoids the variance of area
+sampling due to the varying distance and foreshortening. Small and distant
+rectangles are sampled by area. Rectangles that were sheared into general
+parallelograms by :monosp:`to_world`, as well as rectangles with
+differentiable parameters, always use area sampling.
+
 
 The following XML snippet showcases a simple example of a textured rectangle:
 
@@ -120,8 +129,15 @@ public:
         Normal3f normal = dr::normalize(m_to_world.value() * Normal3f(0.f, 0.f, 1.f));
         m_frame = Frame3f(dp_du, dp_dv, normal);
         m_inv_surface_area = dr::rcp(surface_area());
+        m_corner = m_to_world.value().transform_affine(Point3f(-1.f, -1.f, 0.f));
+
+        // Spherical rectangles require perpendicular edges
+        ScalarVector3f s = m_to_world.scalar() * ScalarVector3f(1.f, 0.f, 0.f),
+                       t = m_to_world.scalar() * ScalarVector3f(0.f, 1.f, 0.f);
+        m_solid_angle_sampling =
+            dr::abs(dr::dot(dr::normalize(s), dr::normalize(t))) < 1e-5f;
 
-        dr::make_opaque(m_frame, m_inv_surface_area);
+        dr::make_opaque(m_frame, m_inv_surface_area, m_corner);
         mark_dirty();
     }
 
@@ -159,6 +175,11 @@ public:
         return dr::norm(dr::cross(m_frame.s, m_frame.t));
     }
 
+    std::pair<ScalarVector3f, ScalarFloat> normal_bounds() const override {
+        ScalarNormal3f n = m_to_world.scalar() * ScalarNormal3f(0.f, 0.f, 1.f);
+        return { dr::normalize(ScalarVector3f(n)), 0.f };
+    }
+
     // =============================================================
     //! @{ \name Sampling routines
     // =============================================================
@@ -184,6 +205,69 @@ public:
         return m_inv_surface_area;
     }
 
+    DirectionSample3f sample_direction(const Interaction3f &it, const Point2f &sample,
+                                       Mask active) const override {
+        MI_MASK_ARGUMENT(active);
+
+        if (!m_solid_angle_sampling || parameters_grad_enabled())
+            return Base::sample_direction(it, sample, active);
+
+        SphericalRectangle sr = spherical_rectangle(it.p);
+        Mask spherical = active && sr.solid_angle > SolidAngleThreshold;
+
+        DirectionSample3f result =
+            Base::sample_direction(it, sample, active && !spherical);
+
+        if (dr::any_or<true>(spherical)) {
+            // Sample the x coordinate by its share of the solid angle
+            Float au = dr::fmadd(sample.x(), sr.solid_angle, sr.k);
+            auto [sin_au, cos_au] = dr::sincos(au);
+            Float fu = (cos_au * sr.b0 - sr.b1) / sin_au,
+                  cu = dr::clamp(dr::mulsign(dr::rsqrt(dr::fmadd(fu, fu, dr::sqr(sr.b0))), fu),
+                                 -1.f, 1.f),
+                  xu = dr::clamp(-(cu * sr.z0) * dr::rsqrt(dr::fnmadd(cu, cu, 1.f)),
+                                 sr.x0, sr.x1);
+
+            // Sample the y coordinate along the resulting line
+            Float dist = dr::sqrt(dr::fmadd(xu, xu, dr::sqr(sr.z0))),
+                  h0 = sr.y0 * dr::rsqrt(dr::fmadd(dist, dist, dr::sqr(sr.y0))),
+                  h1 = sr.y1 * dr::rsqrt(dr::fmadd(dist, dist, dr::sqr(sr.y1))),
+                  hv = dr::fmadd(sample.y(), h1 - h0, h0),
+                  hv2 = dr::sqr(hv),
+                  yv = dr::select(hv2 < 1.f - math::RayEpsilon<Float>,
+                                  hv * dist * dr::rsqrt(1.f - hv2), sr.y1);
+
+            DirectionSample3f ds = dr::zeros<DirectionSample3f>();
+            ds.p = it.p + sr.x * xu + sr.y * yv + sr.z * sr.z0;
+            ds.n = m_frame.n;
+            ds.uv = Point2f((xu - sr.x0) / (sr.x1 - sr.x0),
+                            (yv - sr.y0) / (sr.y1 - sr.y0));
+            ds.time = it.time;
+            ds.delta = false;
+            ds.d = ds.p - it.p;
+            ds.dist = dr::norm(ds.d);
+            ds.d /= ds.dist;
+            ds.pdf = dr::rcp(sr.solid_angle);
+
+            dr::masked(result, spherical) = ds;
+        }
+
+        return result;
+    }
+
+    Float pdf_direction(const Interaction3f &it, const DirectionSample3f &ds,
+                        Mask active) const override {
+        MI_MASK_ARGUMENT(active);
+
+        Float pdf = Base::pdf_direction(it, ds, active);
+        if (!m_solid_angle_sampling || parameters_grad_enabled())
+            return pdf;
+
+        SphericalRectangle sr = spherical_rectangle(it.p);
+        return dr::select(sr.solid_angle > SolidAngleThreshold,
+                          dr::rcp(sr.solid_angle), pdf);
+    }
+
     SurfaceInteraction3f eval_parameterization(const Point2f &uv,
                                                uint32_t ray_flags,
                                                Mask active) const override {
@@ -552,12 +636,18 @@ public:
 
         si.t = dr::select(active, si.t, dr::Infinity<Float>);
 
-        si.n          = m_frame.n;
-        si.sh_frame.n = m_frame.n;
-        si.dp_du      = m_frame.s;
-        si.dp_dv      = m_frame.t;
-        si.uv         = Point2f(dr::fmadd(prim_uv.x(), 0.5f, 0.5f),
-                                dr::fmadd(prim_uv.y(), 0.5f, 0.5f));
+        si.n = m_frame.n;
+        if (likely(has_flag(ray_flags, RayFlags::ShadingFrame)))
+            si.sh_frame.n = m_frame.n;
+
+        if (likely(has_flag(ray_flags, RayFlags::dPdUV))) {
+            si.dp_du = m_frame.s;
+            si.dp_dv = m_frame.t;
+        }
+
+        if (likely(has_flag(ray_flags, RayFlags::UV)))
+            si.uv = Point2f(dr::fmadd(prim_uv.x(), 0.5f, 0.5f),
+                            dr::fmadd(prim_uv.y(), 0.5f, 0.5f));
 
         si.dn_du = si.dn_dv = dr::zeros<Vector3f>();
         si.shape    = this;
@@ -600,8 +690,72 @@ public:
 
     MI_DECLARE_CLASS()
 private:
+    /// Solid angle above which \ref sample_direction() samples spherical rectangles
+    static constexpr float SolidAngleThreshold = 1e-2f;
+
+    /**
+     * \brief The rectangle as seen from a reference point, expressed in a
+     * local frame centered at the reference point
+     *
+     * The rectangle spans <tt>[x0, x1] x [y0, y1]</tt> at height \c z0 < 0.
+     */
+    struct SphericalRectangle {
+        Vector3f x, y, z;
+        Float x0, x1, y0, y1, z0;
+        Float b0, b1, k, solid_angle;
+    };
+
+    /**
+     * \brief Compute the spherical rectangle subtended by the shape
+     *
+     * Based on "An Area-Preserving Parametrization for Spherical Rectangles"
+     * by Carlos Ureña, Marcos Fajardo, and Alan King, EGSR 2013.
+     */
+    SphericalRectangle spherical_rectangle(const Point3f &o) const {
+        SphericalRectangle sr;
+        Float ex = dr::norm(m_frame.s),
+              ey = dr::norm(m_frame.t);
+        sr.x = m_frame.s / ex;
+        sr.y = m_frame.t / ey;
+        sr.z = dr::cross(sr.x, sr.y);
+
+        Vector3f d = m_corner - o;
+        sr.x0 = dr::dot(d, sr.x);
+        sr.y0 = dr::dot(d, sr.y);
+        sr.z0 = dr::dot(d, sr.z);
+
+        // Orient the frame so that the rectangle lies below the reference point
+        Mask flip = sr.z0 > 0.f;
+        sr.z0 = dr::select(flip, -sr.z0, sr.z0);
+        dr::masked(sr.z, flip) = -sr.z;
+        sr.x1 = sr.x0 + ex;
+        sr.y1 = sr.y0 + ey;
+
+        // z components of the normals of the planes through 'o' and the edges
+        Float n0z = -sr.y0 * dr::rsqrt(dr::fmadd(sr.z0, sr.z0, dr::sqr(sr.y0))),
+              n1z =  sr.x1 * dr::rsqrt(dr::fmadd(sr.z0, sr.z0, dr::sqr(sr.x1))),
+              n2z =  sr.y1 * dr::rsqrt(dr::fmadd(sr.z0, sr.z0, dr::sqr(sr.y1))),
+              n3z = -sr.x0 * dr::rsqrt(dr::fmadd(sr.z0, sr.z0, dr::sqr(sr.x0)));
+
+        // Internal angles of the spherical rectangle
+        Float g0 = dr::safe_acos(-n0z * n1z),
+              g1 = dr::safe_acos(-n1z * n2z),
+              g2 = dr::safe_acos(-n2z * n3z),
+              g3 = dr::safe_acos(-n3z * n0z);
+
+        sr.b0 = n0z;
+        sr.b1 = n2z;
+        sr.k = 2.f * dr::Pi<Float> - g2 - g3;
+        sr.solid_angle = dr::maximum(g0 + g1 - sr.k, 0.f);
+        return sr;
+    }
+
     Frame3f m_frame;
     Float m_inv_surface_area;
+    /// World-space position of the corner at object-space (-1, -1, 0)
+    Point3f m_corner;
+    /// Are the edges perpendicular, i.e. is the shape a proper rectangle?
+    bool m_solid_angle_sampling;
 };
 
 MI_IMPLEMENT_CLASS_VARIANT(Rectangle, Shape)
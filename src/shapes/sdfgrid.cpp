@@ -56,6 +56,12 @@ SDF Grid (:monosp:`sdfgrid`)
    - Specifies the method for computing shading normals. The options are
      :monosp:`analytic` or :monosp:`smooth`. (Default: :monosp:`smooth`)
 
+ * - sparse
+   - |bool|
+   - Group the voxels that contain the surface into sparse bricks of
+     8x8x8 voxels, each of which is a single primitive of the acceleration
+     data structure. (Default: |false|)
+
  * - to_world
    - |transform|
    - Specifies a linear object-to-world transformation. (Default: none (i.e. object space = world space))
@@ -76,6 +82,16 @@ The grid object-space is mapped over the range :math:`[0,1]^3`.
 A smooth method for computing normals :cite:`Hansson-Soderlund2022SDF` is
 selected as the default approach to ensure continuity across grid cells.
 
+By default, every voxel that contains a part of the surface is registered as
+a separate primitive of the acceleration data structure, whose size hence
+grows with the area of the surface measured in voxels. For high resolution
+grids, the :monosp:`sparse` parameter groups these voxels into bricks of
+8x8x8 voxels instead. A ray that reaches a brick visits its voxels in order,
+skips the empty 4x4x4 blocks of the brick in a single step, and only solves
+for the surface in the voxels that contain it. This reduces the number of
+primitives by up to two orders of magnitude, at the cost of a slightly more
+expensive intersection routine.
+
 .. warning::
     Compared with the other available shape plugins, the SDF grid has a few
     important limitations. Namely:
@@ -124,6 +140,11 @@ public:
     using typename Base::ScalarIndex;
     using typename Base::ScalarSize;
 
+    /// Number of voxels along each side of a brick (sparse representation)
+    static constexpr uint32_t BrickSize = 8;
+    /// Number of 32 bit words per brick: origin, coarse mask and voxel mask
+    static constexpr uint32_t BrickStride = 4 + BrickSize * BrickSize * BrickSize / 32;
+
     SDFGrid(const Properties &props) : Base(props) {
 #if !defined(MI_ENABLE_EMBREE)
         if constexpr (!dr::is_jit_v<Float>)
@@ -142,6 +163,7 @@ public:
                   normals_mode_str);
 
         m_watertight = props.get<bool>("watertight", false);
+        m_sparse = props.get<bool>("sparse", false);
 
         if (props.has_property("filename")) {
             FileResolver *fs   = Thread::thread()->file_resolver();
@@ -193,6 +215,8 @@ public:
         jit_free(m_host_voxel_indices);
         jit_free(m_device_bboxes);
         jit_free(m_device_voxel_indices);
+        jit_free(m_host_bricks);
+        jit_free(m_device_bricks);
     }
 
     void update() {
@@ -224,12 +248,16 @@ public:
         jit_free(m_host_voxel_indices);
         jit_free(m_device_bboxes);
         jit_free(m_device_voxel_indices);
+        jit_free(m_host_bricks);
+        jit_free(m_device_bricks);
         std::tie(m_host_bboxes,
                  m_host_voxel_indices,
                  m_device_bboxes,
                  m_device_voxel_indices,
-                 m_filled_voxel_count) = build_bboxes();
-        if (m_filled_voxel_count == 0)
+                 m_host_bricks,
+                 m_device_bricks,
+                 m_primitive_count) = build_bboxes();
+        if (m_primitive_count == 0)
             Throw("SDFGrid should at least have one non-empty voxel!");
 
         mark_dirty();
@@ -260,7 +288,7 @@ public:
         Base::parameters_changed();
     }
 
-    ScalarSize primitive_count() const override { return m_filled_voxel_count; }
+    ScalarSize primitive_count() const override { return m_primitive_count; }
 
     ScalarBoundingBox3f bbox() const override {
         ScalarBoundingBox3f bbox;
@@ -575,6 +603,7 @@ public:
 
             dr::eval(m_grid_texture.value()); // Make sure the SDF data is evaluated
             OptixSDFGridData data = { (size_t *) m_device_voxel_indices,
+                                      m_device_bricks,
                                       resolution[0],
                                       resolution[1],
                                       resolution[2],
@@ -592,7 +621,7 @@ public:
     void optix_build_input(OptixBuildInput &build_input) const override {
         build_input.type = OPTIX_BUILD_INPUT_TYPE_CUSTOM_PRIMITIVES;
         build_input.customPrimitiveArray.aabbBuffers   = &m_device_bboxes;
-        build_input.customPrimitiveArray.numPrimitives = m_filled_voxel_count;
+        build_input.customPrimitiveArray.numPrimitives = m_primitive_count;
         build_input.customPrimitiveArray.strideInBytes = 6 * sizeof(float);
         build_input.customPrimitiveArray.flags         = optix_geometry_flags;
         build_input.customPrimitiveArray.numSbtRecords = 1;
@@ -604,6 +633,8 @@ public:
         oss << "SDFgrid[" << std::endl
             << "  to_world = " << string::indent(m_to_world, 13) << ","
             << std::endl
+            << "  sparse = " << m_sparse << "," << std::endl
+            << "  primitive_count = " << m_primitive_count << "," << std::endl
             << "  " << string::indent(get_children_string()) << std::endl
             << "]";
         return oss.str();
@@ -625,57 +656,52 @@ private:
         if constexpr (dr::is_jit_v<FloatP>)
             NotImplementedError("ray_intersect_preliminary_common_impl");
 
-        Transform<Point<FloatP, 4>> to_object = m_to_object.scalar();
-        Ray3fP ray = to_object.transform_affine(ray_);
-
+        // Convert the ray to grid space, where voxels have unit size
         auto shape = m_grid_texture.tensor().shape();
-
-        uint32_t voxel_index     = m_host_voxel_indices[prim_index];
-        ScalarVector3u voxel_pos = to_voxel_position(voxel_index);
-
-        // Find voxel AABB in object space
-        ScalarBoundingBox3f bbox_local;
-        {
-            ScalarPoint3f bbox_min =
-                ScalarPoint3f(voxel_pos.x(), voxel_pos.y(), voxel_pos.z());
-            ScalarPoint3f bbox_max = bbox_min + ScalarPoint3f(1.f, 1.f, 1.f);
-            bbox_min *= m_voxel_size.scalar();
-            bbox_max *= m_voxel_size.scalar();
-            bbox_local.expand(bbox_min);
-            bbox_local.expand(bbox_max);
+        ScalarTransform4f to_grid =
+            ScalarTransform4f::scale(ScalarVector3f((float) (shape[2] - 1),
+                                                    (float) (shape[1] - 1),
+                                                    (float) (shape[0] - 1))) *
+            m_to_object.scalar();
+        Ray3fP ray = to_grid.transform_affine(ray_);
+
+        dr::mask_t<FloatP> hit;
+        FloatP t;
+        if (m_sparse) {
+            std::tie(hit, t) = intersect_brick<FloatP>(ray, prim_index, active);
+        } else {
+            uint32_t voxel_index     = m_host_voxel_indices[prim_index];
+            ScalarVector3u voxel_pos = to_voxel_position(voxel_index);
+
+            // To determine voxel intersection, we need both near and far AABB
+            // intersections
+            ScalarBoundingBox3f bbox_local(ScalarPoint3f(voxel_pos),
+                                           ScalarPoint3f(voxel_pos + 1u));
+            auto [bbox_hit, t_beg, t_end] = bbox_local.ray_intersect(ray);
+
+            std::tie(hit, t) = intersect_voxel<FloatP>(
+                ray, Point<dr::uint32_array_t<FloatP>, 3>(voxel_pos), t_beg,
+                t_end, active && bbox_hit);
+            hit = hit && bbox_hit;
         }
 
-        // To determine voxel intersection, we need both near and far AABB
-        // intersections
-        auto [bbox_hit, t_beg, t_end] = bbox_local.ray_intersect(ray);
+        active = active && hit && t >= 0.f && t <= ray.maxt;
 
+        return { active, dr::select(active, t, dr::Infinity<FloatP>),
+                 Point<FloatP, 2>(0, 0), ((uint32_t) -1), prim_index };
+    }
+
+    /* \brief Intersect a ray expressed in grid space (where voxels have unit
+     * size) with the surface contained in the voxel at position \c voxel,
+     * between the voxel entry and exit distances \c t_beg and \c t_end.
+     */
+    template <typename FloatP, typename Ray3fP>
+    MI_INLINE std::tuple<dr::mask_t<FloatP>, FloatP>
+    intersect_voxel(const Ray3fP &ray_, const Point<dr::uint32_array_t<FloatP>, 3> &voxel,
+                    FloatP t_beg, FloatP t_end, dr::mask_t<FloatP> active) const {
         // Convert ray to voxel-space [0, 1] x [0, 1] x [0, 1]
-        {
-            ScalarMatrix4f m{};
-            m[0][0] = (float) (shape[2] - 1);
-            m[0][1] = 0.f;
-            m[0][2] = 0.f;
-            m[0][3] = 0.f;
-
-            m[1][0] = 0.f;
-            m[1][1] = (float) (shape[1] - 1);
-            m[1][2] = 0.f;
-            m[1][3] = 0.f;
-
-            m[2][0] = 0.f;
-            m[2][1] = 0.f;
-            m[2][2] = (float) (shape[0] - 1);
-            m[2][3] = 0.f;
-
-            m[3][0] = -1.f * (float) voxel_pos.x();
-            m[3][1] = -1.f * (float) voxel_pos.y();
-            m[3][2] = -1.f * (float) voxel_pos.z();
-            m[3][3] = 1.f;
-
-            auto to_voxel = ScalarTransform4f(m);
-
-            ray = to_voxel.transform_affine(ray);
-        }
+        Ray3fP ray = ray_;
+        ray.o -= Vector<FloatP, 3>(voxel);
 
         /**
            Voxel intersection expressed as solution of cubic polynomial:
@@ -689,23 +715,31 @@ private:
         FloatP c2;
         FloatP c3;
         {
-            ScalarVector3u v000 = voxel_pos;
-            ScalarVector3u v100 = v000 + ScalarVector3u(1, 0, 0);
-            ScalarVector3u v010 = v000 + ScalarVector3u(0, 1, 0);
-            ScalarVector3u v110 = v000 + ScalarVector3u(1, 1, 0);
-            ScalarVector3u v001 = v000 + ScalarVector3u(0, 0, 1);
-            ScalarVector3u v101 = v000 + ScalarVector3u(1, 0, 1);
-            ScalarVector3u v011 = v000 + ScalarVector3u(0, 1, 1);
-            ScalarVector3u v111 = v000 + ScalarVector3u(1, 1, 1);
-
-            float s000 = m_host_grid_data[to_voxel_index(v000)];
-            float s100 = m_host_grid_data[to_voxel_index(v100)];
-            float s010 = m_host_grid_data[to_voxel_index(v010)];
-            float s110 = m_host_grid_data[to_voxel_index(v110)];
-            float s001 = m_host_grid_data[to_voxel_index(v001)];
-            float s101 = m_host_grid_data[to_voxel_index(v101)];
-            float s011 = m_host_grid_data[to_voxel_index(v011)];
-            float s111 = m_host_grid_data[to_voxel_index(v111)];
+            using UInt32P   = dr::uint32_array_t<FloatP>;
+            using Vector3uP = Vector<UInt32P, 3>;
+
+            Vector3uP v000(voxel);
+            Vector3uP v100 = v000 + Vector3uP(1, 0, 0);
+            Vector3uP v010 = v000 + Vector3uP(0, 1, 0);
+            Vector3uP v110 = v000 + Vector3uP(1, 1, 0);
+            Vector3uP v001 = v000 + Vector3uP(0, 0, 1);
+            Vector3uP v101 = v000 + Vector3uP(1, 0, 1);
+            Vector3uP v011 = v000 + Vector3uP(0, 1, 1);
+            Vector3uP v111 = v000 + Vector3uP(1, 1, 1);
+
+            auto fetch = [&](const Vector3uP &v) {
+                return dr::gather<FloatP>(m_host_grid_data, to_voxel_index(v),
+                                          active);
+            };
+
+            FloatP s000 = fetch(v000);
+            FloatP s100 = fetch(v100);
+            FloatP s010 = fetch(v010);
+            FloatP s110 = fetch(v110);
+            FloatP s001 = fetch(v001);
+            FloatP s101 = fetch(v101);
+            FloatP s011 = fetch(v011);
+            FloatP s111 = fetch(v111);
 
             FloatP o_x = ray.o.x();
             FloatP o_y = ray.o.y();
@@ -749,10 +783,113 @@ private:
             hit                         = hit || eval_sdf < 0;
         }
 
-        active = active && bbox_hit && hit && t >= 0.f && t <= ray.maxt;
+        return { active && hit, t };
+    }
 
-        return { active, dr::select(active, t, dr::Infinity<FloatP>),
-                 Point<FloatP, 2>(0, 0), ((uint32_t) -1), prim_index };
+    /* \brief Intersect a ray expressed in grid space with the surface
+     * contained in a brick of the sparse representation.
+     *
+     * The voxels of the brick are visited in order along the ray (3D-DDA).
+     * Empty 4x4x4 blocks of the brick are skipped in a single step using the
+     * coarse occupancy mask, and the surface is only solved for in voxels
+     * that contain it, hence the first intersection found is the closest.
+     */
+    template <typename FloatP, typename Ray3fP>
+    MI_INLINE std::tuple<dr::mask_t<FloatP>, FloatP>
+    intersect_brick(const Ray3fP &ray, ScalarIndex brick_index,
+                    dr::mask_t<FloatP> active) const {
+        using MaskP    = dr::mask_t<FloatP>;
+        using UInt32P  = dr::uint32_array_t<FloatP>;
+        using Int32P   = dr::int32_array_t<FloatP>;
+        using Point3fP = Point<FloatP, 3>;
+        using Point3iP = Point<Int32P, 3>;
+
+        const uint32_t *brick = m_host_bricks + brick_index * BrickStride;
+        auto shape = m_grid_texture.tensor().shape();
+        ScalarPoint3i origin(brick[0], brick[1], brick[2]);
+        ScalarPoint3i brick_end = dr::minimum(
+            origin + (int) BrickSize,
+            ScalarPoint3i((int) shape[2] - 1, (int) shape[1] - 1,
+                          (int) shape[0] - 1));
+
+        ScalarBoundingBox3f bbox(ScalarPoint3f(origin), ScalarPoint3f(brick_end));
+        auto [bbox_hit, t_min, t_max] = bbox.ray_intersect(ray);
+        active = active && bbox_hit && t_max >= 0.f && t_min <= ray.maxt;
+
+        // Voxel containing the first point of the ray within the brick
+        Point3iP voxel = dr::clamp(
+            dr::floor2int<Point3iP>(ray(dr::maximum(t_min, 0.f))),
+            Point3iP(origin), Point3iP(brick_end - 1));
+
+        MaskP hit = false;
+        FloatP t_hit = dr::Infinity<FloatP>;
+
+        for (uint32_t i = 0; i < 3 * BrickSize && dr::any(active); ++i) {
+            Point3iP local = voxel - Point3iP(origin);
+
+            // Coarse level: skip empty 4x4x4 blocks at once
+            Point3iP block = dr::sr<2>(local);
+            UInt32P block_bit = UInt32P(block.x() + 2 * block.y() + 4 * block.z());
+            MaskP block_filled =
+                dr::neq((UInt32P(brick[3]) >> block_bit) & 1u, 0u);
+
+            Point3iP cell_min =
+                dr::select(block_filled, voxel, Point3iP(origin) + dr::sl<2>(block));
+            Point3iP cell_max =
+                dr::minimum(dr::select(block_filled, voxel + 1, cell_min + 4),
+                            Point3iP(brick_end));
+
+            // Fine level: intersect voxels that contain the surface
+            UInt32P local_index =
+                UInt32P(local.x() + (int) BrickSize *
+                                        (local.y() + (int) BrickSize * local.z()));
+            MaskP voxel_filled = active && block_filled;
+            UInt32P word = dr::gather<UInt32P>(brick + 4, dr::sr<5>(local_index),
+                                               voxel_filled);
+            voxel_filled &= dr::neq((word >> (local_index & 31u)) & 1u, 0u);
+
+            if (dr::any(voxel_filled)) {
+                BoundingBox<Point3fP> voxel_bbox(Point3fP(voxel),
+                                                 Point3fP(voxel + 1));
+                auto [voxel_hit, t_beg, t_end] = voxel_bbox.ray_intersect(ray);
+                auto [surface_hit, t] = intersect_voxel<FloatP>(
+                    ray, Point<UInt32P, 3>(voxel), t_beg, t_end,
+                    voxel_filled && voxel_hit);
+
+                MaskP accept = voxel_filled && voxel_hit && surface_hit &&
+                               t >= 0.f && t <= ray.maxt;
+                dr::masked(t_hit, accept) = t;
+                hit |= accept;
+                active &= !accept;
+            }
+
+            // Advance to the next cell along the ray
+            Point3fP t_exit;
+            for (size_t k = 0; k < 3; ++k)
+                t_exit[k] = dr::select(
+                    ray.d[k] > 0.f, (FloatP(cell_max[k]) - ray.o[k]) / ray.d[k],
+                    dr::select(ray.d[k] < 0.f,
+                               (FloatP(cell_min[k]) - ray.o[k]) / ray.d[k],
+                               dr::Infinity<FloatP>));
+
+            FloatP t_next =
+                dr::minimum(t_exit.x(), dr::minimum(t_exit.y(), t_exit.z()));
+            active &= t_next < t_max && t_next <= ray.maxt;
+
+            Point3iP next = dr::clamp(dr::floor2int<Point3iP>(ray(t_next)),
+                                      cell_min, cell_max - 1);
+            for (size_t k = 0; k < 3; ++k) {
+                MaskP exit_k = dr::eq(t_exit[k], t_next);
+                dr::masked(next[k], exit_k && ray.d[k] > 0.f) = cell_max[k];
+                dr::masked(next[k], exit_k && ray.d[k] < 0.f) = cell_min[k] - 1;
+            }
+
+            voxel = next;
+            active &= dr::all(voxel >= Point3iP(origin) &&
+                              voxel < Point3iP(brick_end));
+        }
+
+        return { hit, t_hit };
     }
 
     /* \brief Solve cubic polynomial that gives solution to voxel intersection
@@ -857,7 +994,8 @@ private:
      * relative to the flat array of SDFGrid data. In particular, the returned
      * index maps to the bottom-left corner of the associated voxel
      */
-    MI_INLINE ScalarIndex to_voxel_index(const ScalarVector3u &v) const {
+    template <typename Vector3u_>
+    MI_INLINE dr::value_t<Vector3u_> to_voxel_index(const Vector3u_ &v) const {
         auto shape = m_grid_texture.tensor().shape();
         // Data is packed [Z, Y, X, C]
         uint32_t shape_v[3] = { (uint32_t) shape[2], (uint32_t) shape[1],
@@ -887,17 +1025,21 @@ private:
      * Returns a pointer to the array of AABBs, a pointer to an array of voxel
      * indices of the former AABBs and the count of voxels with surface in them.
      *
+     * In the sparse representation, the non-empty voxels are instead grouped
+     * into bricks. The AABBs then bound the non-empty voxels of every brick,
+     * no voxel indices are returned, and the brick data is returned in their
+     * place.
+     *
      * Depending on the variant used, the pointer returned is either host or
      * device visible
      */
-    std::tuple<void *, size_t *, void *, size_t *, size_t> build_bboxes() {
+    std::tuple<void *, size_t *, void *, size_t *, uint32_t *, uint32_t *, size_t>
+    build_bboxes() {
         auto shape = m_grid_texture.tensor().shape();
         size_t shape_v[3]  = { shape[2], shape[1], shape[0] };
         float voxel_size[3] = { m_voxel_size.scalar()[0],
                                 m_voxel_size.scalar()[1],
                                 m_voxel_size.scalar()[2] };
-        size_t max_voxel_count =
-            (shape[0] - 1) * (shape[1] - 1) * (shape[2] - 1);
         ScalarTransform4f to_world = m_to_world.scalar();
 
         float *grid = nullptr;
@@ -920,11 +1062,19 @@ private:
         using BoundingBoxType = ScalarBoundingBox3f;
 #endif
 
-        size_t count = 0;
-        BoundingBoxType *host_aabbs = (BoundingBoxType *) jit_malloc(
-            AllocType::Host, sizeof(BoundingBoxType) * max_voxel_count);
-        size_t *host_voxel_indices = (size_t *) jit_malloc(
-            AllocType::Host, sizeof(size_t) * max_voxel_count);
+        std::vector<ScalarBoundingBox3f> bboxes;
+        std::vector<size_t> voxel_indices;
+
+        // Sparse representation: slot of every brick of the grid in `bricks`
+        size_t brick_res[3];
+        for (size_t i = 0; i < 3; ++i)
+            brick_res[i] = (shape_v[i] - 1 + BrickSize - 1) / BrickSize;
+        std::vector<uint32_t> brick_slots;
+        std::vector<uint32_t> bricks;
+        if (m_sparse)
+            brick_slots.resize(brick_res[0] * brick_res[1] * brick_res[2],
+                               (uint32_t) -1);
+
         for (size_t z = 0; z < shape[0] - 1; ++z) {
             for (size_t y = 0; y < shape[1] - 1; ++y) {
                 for (size_t x = 0; x < shape[2] - 1; ++x) {
@@ -976,20 +1126,66 @@ private:
                     expand_bbox(x + 0, y + 1, z + 1);
                     expand_bbox(x + 1, y + 1, z + 1);
 
-                    size_t voxel_idx = x +
-                                       y * (shape_v[0] - 1) +
-                                       z * (shape_v[0] - 1) * (shape_v[1] - 1);
-
-                    host_voxel_indices[count] = voxel_idx;
-                    host_aabbs[count] = BoundingBoxType(bbox);
+                    if (!m_sparse) {
+                        size_t voxel_idx = x +
+                                           y * (shape_v[0] - 1) +
+                                           z * (shape_v[0] - 1) * (shape_v[1] - 1);
 
-                    count++;
+                        voxel_indices.push_back(voxel_idx);
+                        bboxes.push_back(bbox);
+                        continue;
+                    }
+
+                    size_t bx = x / BrickSize, by = y / BrickSize,
+                           bz = z / BrickSize;
+                    uint32_t &slot =
+                        brick_slots[bx + brick_res[0] * (by + brick_res[1] * bz)];
+                    if (slot == (uint32_t) -1) {
+                        slot = (uint32_t) bboxes.size();
+                        bricks.resize(bricks.size() + BrickStride, 0u);
+                        uint32_t *brick = bricks.data() + slot * BrickStride;
+                        brick[0] = (uint32_t) (bx * BrickSize);
+                        brick[1] = (uint32_t) (by * BrickSize);
+                        brick[2] = (uint32_t) (bz * BrickSize);
+                        bboxes.push_back(bbox);
+                    } else {
+                        bboxes[slot].expand(bbox);
+                    }
+
+                    // Mark the voxel and its 4x4x4 block as non-empty
+                    uint32_t *brick = bricks.data() + slot * BrickStride;
+                    uint32_t lx = (uint32_t) (x % BrickSize),
+                             ly = (uint32_t) (y % BrickSize),
+                             lz = (uint32_t) (z % BrickSize);
+                    uint32_t local_index = lx + BrickSize * (ly + BrickSize * lz);
+                    brick[3] |= 1u << ((lx >> 2) + 2 * (ly >> 2) + 4 * (lz >> 2));
+                    brick[4 + (local_index >> 5)] |= 1u << (local_index & 31);
                 }
             }
         }
 
+        size_t count = bboxes.size();
+        BoundingBoxType *host_aabbs = (BoundingBoxType *) jit_malloc(
+            AllocType::Host, sizeof(BoundingBoxType) * count);
+        for (size_t i = 0; i < count; ++i)
+            host_aabbs[i] = BoundingBoxType(bboxes[i]);
+
+        size_t *host_voxel_indices = nullptr;
+        uint32_t *host_bricks = nullptr;
+        if (m_sparse) {
+            host_bricks = (uint32_t *) jit_malloc(
+                AllocType::Host, sizeof(uint32_t) * bricks.size());
+            memcpy(host_bricks, bricks.data(), sizeof(uint32_t) * bricks.size());
+        } else {
+            host_voxel_indices = (size_t *) jit_malloc(
+                AllocType::Host, sizeof(size_t) * count);
+            memcpy(host_voxel_indices, voxel_indices.data(),
+                   sizeof(size_t) * count);
+        }
+
         void *device_aabbs = nullptr;
         size_t* device_voxel_indices = nullptr;
+        uint32_t *device_bricks = nullptr;
 
         if constexpr (dr::is_cuda_v<Float>) {
             device_aabbs =
@@ -997,15 +1193,23 @@ private:
             jit_memcpy_async(JitBackend::CUDA, device_aabbs, host_aabbs,
                        sizeof(BoundingBoxType) * count);
 
-            device_voxel_indices = (size_t *) jit_malloc(AllocType::Device,
-                                                      sizeof(size_t) * count);
-            jit_memcpy_async(JitBackend::CUDA, device_voxel_indices, host_voxel_indices,
-                       sizeof(size_t) * count);
+            if (m_sparse) {
+                device_bricks = (uint32_t *) jit_malloc(
+                    AllocType::Device, sizeof(uint32_t) * bricks.size());
+                jit_memcpy_async(JitBackend::CUDA, device_bricks, host_bricks,
+                                 sizeof(uint32_t) * bricks.size());
+            } else {
+                device_voxel_indices = (size_t *) jit_malloc(
+                    AllocType::Device, sizeof(size_t) * count);
+                jit_memcpy_async(JitBackend::CUDA, device_voxel_indices,
+                                 host_voxel_indices, sizeof(size_t) * count);
+            }
 
             jit_free(grid);
         }
 
-        return { host_aabbs, host_voxel_indices, device_aabbs, device_voxel_indices, count };
+        return { host_aabbs, host_voxel_indices, device_aabbs,
+                 device_voxel_indices, host_bricks, device_bricks, count };
     }
 
     /// Computes the SDF gradient for a given point and its containing voxel
@@ -1080,8 +1284,16 @@ private:
     void *m_device_bboxes = nullptr;
     size_t *m_device_voxel_indices = nullptr;
 
+    // Host- and device-visible bricks of the sparse representation. Every
+    // brick occupies `BrickStride` words: the voxel position of its origin,
+    // the occupancy mask of its 4x4x4 blocks and that of its voxels
+    uint32_t *m_host_bricks = nullptr;
+    uint32_t *m_device_bricks = nullptr;
+
     bool m_watertight;
-    size_t m_filled_voxel_count = 0;
+    bool m_sparse;
+    /// Number of non-empty voxels, or of bricks in the sparse representation
+    size_t m_primitive_count = 0;
     NormalMethod m_normal_method;
 };
 
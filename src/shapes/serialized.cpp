@@ -1,10 +1,14 @@
 #include <mitsuba/render/mesh.h>
 #include <mitsuba/core/fstream.h>
+#include <mitsuba/core/mmap.h>
+#include <mitsuba/core/mstream.h>
 #include <mitsuba/core/zstream.h>
 #include <mitsuba/core/fresolver.h>
 #include <mitsuba/core/properties.h>
 #include <mitsuba/core/timer.h>
 #include <mitsuba/core/profiler.h>
+#include <mutex>
+#include <unordered_map>
 
 NAMESPACE_BEGIN(mitsuba)
 
@@ -38,6 +42,26 @@ Serialized mesh loader (:monosp:`serialized`)
    - Is the mesh inverted, i.e. should the normal vectors be flipped? (Default:|false|, i.e.
      the normals point outside)
 
+ * - compact_vertex_attributes
+   - |bool|
+   - Store vertex normals (octahedral encoding, 2x16 bits) and texture coordinates (half
+     precision) in compact form, which reduces the memory footprint of the mesh. They are
+     then no longer exposed as (differentiable) scene parameters. (Default: |false|)
+
+ * - alias_sampling
+   - |bool|
+   - Select triangles for surface sampling (e.g. of area emitters) using an alias table,
+     which takes constant time instead of a binary search over the triangles. The mapping
+     of samples to triangles is no longer monotonic, which reduces the benefit of
+     stratified samplers. (Default: |false|)
+
+ * - opacity_bake_resolution
+   - |int|
+   - When larger than zero and the mesh uses a transparent BSDF (e.g. :ref:`mask <bsdf-mask>`),
+     triangles whose opacity is zero at all points of a grid with this many segments per edge
+     are excluded from the acceleration data structure. Rays then pass through them without
+     invoking the BSDF. (Default: 0, i.e. disabled)
+
  * - to_world
    - |transform|
    - Specifies an optional linear object-to-world transformation.
@@ -199,6 +223,19 @@ at the end of the file, which specifies the starting position of each sub-mesh:
 #define MI_FILEFORMAT_VERSION_V3 0x0003
 #define MI_FILEFORMAT_VERSION_V4 0x0004
 
+/// Byte ranges of the meshes stored in a .serialized file
+struct SerializedIndex : Object {
+    uint16_t version;
+    size_t file_size;
+    int64_t write_time;
+    /// Mesh \c i occupies the byte range <tt>[offsets[i], offsets[i + 1])</tt>
+    std::vector<uint64_t> offsets;
+};
+
+/// Indices of previously loaded files, shared by all instances and variants
+static std::unordered_map<std::string, ref<SerializedIndex>> serialized_index_cache;
+static std::mutex serialized_index_mutex;
+
 template <typename Float, typename Spectrum>
 class SerializedMesh final : public Mesh<Float, Spectrum> {
 public:
@@ -254,57 +291,45 @@ public:
 
         m_name = tfm::format("%s@%i", file_path.filename(), shape_index);
 
-        ref<Stream> stream = new FileStream(file_path);
         ScopedPhase phase(ProfilerPhase::LoadGeometry);
         Timer timer;
-        stream->set_byte_order(Stream::ELittleEndian);
-
-        short format = 0, version = 0;
-        stream->read(format);
-        stream->read(version);
-
-        if (format != MI_FILEFORMAT_HEADER)
-            fail("encountered an invalid file format!");
-
-        if (version != MI_FILEFORMAT_VERSION_V3 &&
-            version != MI_FILEFORMAT_VERSION_V4)
-            fail("encountered an incompatible file version!");
-
-        if (shape_index != 0) {
-            size_t file_size = stream->size();
-
-            /* Determine the position of the requested substream. This
-               is stored at the end of the file */
-            stream->seek(file_size - sizeof(uint32_t));
-
-            uint32_t count = 0;
-            stream->read(count);
 
-            if (shape_index > (int) count)
-                fail(tfm::format("Unable to unserialize mesh, shape index is "
-                                 "out of range! (requested %i out of 0..%i)",
-                                 shape_index, count - 1));
-
-            // Seek to the correct position
-            if (version == MI_FILEFORMAT_VERSION_V4) {
-                stream->seek(file_size -
-                             sizeof(uint64_t) * (count - shape_index) -
-                             sizeof(uint32_t));
-                size_t offset = 0;
-                stream->read(offset);
-                stream->seek(offset);
-            } else {
-                Assert(version == MI_FILEFORMAT_VERSION_V3);
-                stream->seek(file_size -
-                             sizeof(uint32_t) * (count - shape_index + 1));
-                uint32_t offset = 0;
-                stream->read(offset);
-                stream->seek(offset);
-            }
-            stream->skip(sizeof(short) * 2); // Skip the header
+        ref<const SerializedIndex> index;
+        try {
+            index = load_index(file_path);
+        } catch (const std::exception &e) {
+            fail(e.what());
         }
 
-        stream = new ZStream(stream);
+        uint16_t version = index->version;
+        size_t mesh_count = index->offsets.size() - 1;
+        if ((size_t) shape_index >= mesh_count)
+            fail(tfm::format("Unable to unserialize mesh, shape index is "
+                             "out of range! (requested %i out of 0..%i)",
+                             shape_index, mesh_count - 1));
+
+        /* Every mesh is decompressed from its own view of the file, which
+           lets concurrently loaded meshes of the same file proceed in
+           parallel. The first 4 bytes contain the uncompressed header. */
+        size_t region_start = index->offsets[shape_index] + sizeof(short) * 2,
+               region_size  = index->offsets[shape_index + 1] - region_start;
+
+#if !defined(_WIN32)
+        ref<MemoryMappedFile> mmap = new MemoryMappedFile(file_path);
+        if (mmap->size() < region_start + region_size)
+            fail("file was modified while loading");
+        ref<Stream> stream = new MemoryStream(
+            (uint8_t *) mmap->data() + region_start, region_size);
+#else
+        // Memory-mapped IO performs surprisingly poorly on Windows
+        ref<Stream> file_stream = new FileStream(file_path);
+        std::unique_ptr<uint8_t[]> region(new uint8_t[region_size]);
+        file_stream->seek(region_start);
+        file_stream->read(region.get(), region_size);
+        ref<Stream> stream = new MemoryStream(region.get(), region_size);
+#endif
+
+        stream = new ZStream(stream, ZStream::detect_type(stream));
         stream->set_byte_order(Stream::ELittleEndian);
 
         uint32_t flags = 0;
@@ -403,6 +428,86 @@ public:
         initialize();
     }
 
+    /**
+     * \brief Return the (cached) offsets of the meshes stored in the given
+     * file, which are read from its end-of-file dictionary
+     *
+     * The cache is shared by all variants and invalidated when the size or
+     * modification time of the file changes.
+     */
+    ref<const SerializedIndex> load_index(const fs::path &file_path) {
+        std::string key = fs::absolute(file_path).string();
+        size_t file_size = fs::file_size(file_path);
+        int64_t write_time = fs::last_write_time(file_path);
+
+        std::lock_guard<std::mutex> guard(serialized_index_mutex);
+        auto it = serialized_index_cache.find(key);
+        if (it != serialized_index_cache.end() &&
+            it->second->file_size == file_size &&
+            it->second->write_time == write_time)
+            return it->second;
+
+        ref<Stream> stream = new FileStream(file_path);
+        stream->set_byte_order(Stream::ELittleEndian);
+
+        short format = 0, version = 0;
+        stream->read(format);
+        stream->read(version);
+
+        if (format != MI_FILEFORMAT_HEADER)
+            Throw("encountered an invalid file format!");
+
+        if (version != MI_FILEFORMAT_VERSION_V3 &&
+            version != MI_FILEFORMAT_VERSION_V4)
+            Throw("encountered an incompatible file version!");
+
+        ref<SerializedIndex> index = new SerializedIndex();
+        index->version    = (uint16_t) version;
+        index->file_size  = file_size;
+        index->write_time = write_time;
+
+        /* The dictionary stores 64 bit (V4) or 32 bit (V3) offsets followed
+           by the number of meshes */
+        size_t entry_size = version == MI_FILEFORMAT_VERSION_V4
+                                ? sizeof(uint64_t) : sizeof(uint32_t);
+        uint32_t count = 0;
+        if (file_size >= sizeof(short) * 2 + sizeof(uint32_t)) {
+            stream->seek(file_size - sizeof(uint32_t));
+            stream->read(count);
+        }
+
+        size_t dict_start = file_size - sizeof(uint32_t) - entry_size * count;
+        bool valid = count > 0 &&
+                     entry_size * count + sizeof(uint32_t) <= file_size;
+
+        if (valid) {
+            stream->seek(dict_start);
+            index->offsets.resize(count + 1);
+            for (uint32_t i = 0; i < count; ++i) {
+                if (version == MI_FILEFORMAT_VERSION_V4) {
+                    uint64_t offset = 0;
+                    stream->read(offset);
+                    index->offsets[i] = offset;
+                } else {
+                    uint32_t offset = 0;
+                    stream->read(offset);
+                    index->offsets[i] = offset;
+                }
+                valid &= i == 0 ? index->offsets[i] == 0
+                                : index->offsets[i] > index->offsets[i - 1];
+            }
+            index->offsets[count] = dict_start;
+            valid &= index->offsets[count - 1] + sizeof(short) * 2 < dict_start;
+        }
+
+        // Files without a valid dictionary only provide access to one mesh
+        if (!valid)
+            index->offsets = { 0, file_size };
+
+        serialized_index_cache[key] = index;
+        return index;
+    }
+
     void read_helper(Stream *stream, bool dp, InputFloat* dst, size_t dim) {
         if (dp) {
             std::unique_ptr<double[]> values(new double[m_vertex_count * dim]);
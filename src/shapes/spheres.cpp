@@ -0,0 +1,562 @@
+#include <mitsuba/core/fwd.h>
+#include <mitsuba/core/math.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/string.h>
+#include <mitsuba/core/transform.h>
+#include <mitsuba/core/util.h>
+#include <mitsuba/core/timer.h>
+#include <mitsuba/render/fwd.h>
+#include <mitsuba/render/interaction.h>
+#include <mitsuba/render/shape.h>
+#include <mitsuba/render/srgb.h>
+
+#if defined(MI_ENABLE_EMBREE)
+#include <embree3/rtcore.h>
+#endif
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**!
+
+.. _shape-spheres:
+
+Sphere cloud (:monosp:`spheres`)
+--------------------------------
+
+.. pluginparameters::
+ :extra-rows: 2
+
+ * - centers
+   - |tensor|
+   - Tensor of shape ``(N, 3)`` with the centers of the spheres.
+
+ * - radii
+   - |tensor|
+   - Tensor of shape ``(N)`` or ``(N, 1)`` with the radius of every sphere.
+
+ * - radius
+   - |float|
+   - Radius shared by all spheres, used when ``radii`` is not specified.
+     (Default: 1.0)
+
+ * - particle_*
+   - |tensor|
+   - Optional per-sphere attributes, given as tensors of shape ``(N)``,
+     ``(N, 1)`` or ``(N, 3)``. They can be looked up using the
+     :ref:`mesh_attribute <texture-meshattribute>` texture.
+   - |exposed|, |differentiable|
+
+ * - to_world
+   - |transform|
+   - Specifies a linear object-to-world transformation that is applied to the
+     centers. Note that the radii are invariant to this transformation!
+
+ * - sphere_count
+   - |int|
+   - Total number of spheres
+   - |exposed|
+
+ * - data
+   - :paramtype:`float[]`
+   - Flattened sphere buffer pre-multiplied by the object-to-world
+     transformation. Each sphere in the buffer is structured as follows:
+     center_x, center_y, center_z, radius
+   - |exposed|
+
+This shape plugin describes a large collection of spheres, e.g. the particles
+of a simulation, as a single shape. Unlike the :ref:`sphere <shape-sphere>`
+plugin, which creates a separate shape (with its own transformation and
+material) for every sphere, all spheres are stored in one buffer and are
+intersected as the primitives of a single shape. This keeps both the loading
+time and the memory usage per sphere small, and millions of spheres can be
+passed at once from Python.
+
+All spheres share the same BSDF. Per-sphere quantities such as colors can be
+passed as additional ``particle_*`` tensors and retrieved using the
+:ref:`mesh_attribute <texture-meshattribute>` texture. In spectral variants,
+three dimensional attributes whose name contains ``color`` are converted into
+the coefficients of the spectral upsampling model, as for meshes.
+
+The spheres are traced using the built-in sphere primitives of Embree and
+OptiX, and using the kd-tree in the other variants.
+
+.. tabs::
+    .. code-tab:: python
+
+        'particles': {
+            'type': 'spheres',
+            'centers': mi.TensorXf(centers),           # shape (N, 3)
+            'radii': mi.TensorXf(radii),               # shape (N)
+            'particle_color': mi.TensorXf(colors),     # shape (N, 3)
+            'bsdf': {
+                'type': 'diffuse',
+                'reflectance': {
+                    'type': 'mesh_attribute',
+                    'name': 'particle_color'
+                }
+            }
+        }
+
+.. note:: This plugin is only available from Python, since tensor-valued
+          properties can't be specified in XML scene descriptions.
+ */
+
+template <typename Float, typename Spectrum>
+class Spheres final : public Shape<Float, Spectrum> {
+public:
+    MI_IMPORT_BASE(Shape, m_to_world, m_is_instance, m_shape_type,
+                   initialize, mark_dirty, get_children_string)
+    MI_IMPORT_TYPES()
+
+    using typename Base::ScalarIndex;
+    using typename Base::ScalarSize;
+
+    using InputFloat = float;
+    using FloatStorage = DynamicBuffer<dr::replace_scalar_t<Float, InputFloat>>;
+
+    /// Per-sphere attribute
+    struct ParticleAttribute {
+        size_t size;
+        FloatStorage buf;
+    };
+
+    Spheres(const Properties &props) : Base(props) {
+        ScopedPhase phase(ProfilerPhase::LoadGeometry);
+        Timer timer;
+
+        // 1. Centers and radii
+        const TensorXf *centers = tensor_property(props, "centers");
+        if (centers->ndim() != 2 || centers->shape(1) != 3)
+            Throw("Spheres: \"centers\" must be a tensor of shape (N, 3)!");
+
+        size_t count = centers->shape(0);
+        if (count == 0)
+            Throw("Spheres: expected at least one sphere!");
+        if (count > 0xffffffffu)
+            Throw("Spheres: too many spheres!");
+        m_sphere_count = (ScalarSize) count;
+
+        const TensorXf *radii = nullptr;
+        if (props.has_property("radii")) {
+            radii = tensor_property(props, "radii");
+            if (dr::width(radii->array()) != count ||
+                radii->ndim() > 2 || (radii->ndim() == 2 && radii->shape(1) != 1))
+                Throw("Spheres: \"radii\" must be a tensor of shape (N) or (N, 1) "
+                      "with N = %zu!", count);
+        }
+        ScalarFloat radius = props.get<ScalarFloat>("radius", 1.f);
+
+        auto &&centers_host = dr::migrate(centers->array(), AllocType::Host);
+        auto &&radii_host = radii ? dr::migrate(radii->array(), AllocType::Host)
+                                  : DynamicBuffer<Float>();
+        if constexpr (dr::is_jit_v<Float>)
+            dr::sync_thread();
+
+        const ScalarFloat *c_ptr = centers_host.data(),
+                          *r_ptr = radii ? radii_host.data() : nullptr;
+        const ScalarTransform4f &to_world = m_to_world.scalar();
+
+        std::unique_ptr<InputFloat[]> data =
+            std::make_unique<InputFloat[]>(count * 4);
+        for (size_t i = 0; i < count; ++i) {
+            ScalarPoint3f p = to_world.transform_affine(
+                ScalarPoint3f(c_ptr[3 * i + 0], c_ptr[3 * i + 1], c_ptr[3 * i + 2]));
+            ScalarFloat r = r_ptr ? r_ptr[i] : radius;
+
+            if (unlikely(!dr::all(dr::isfinite(p)) || !dr::isfinite(r) || r < 0.f))
+                Throw("Spheres: sphere %zu has an invalid center or radius!", i);
+
+            dr::store(data.get() + 4 * i,
+                      dr::Array<InputFloat, 4>((InputFloat) p.x(), (InputFloat) p.y(),
+                                               (InputFloat) p.z(), (InputFloat) r));
+        }
+        m_data = dr::load<FloatStorage>(data.get(), count * 4);
+
+        // 2. Per-sphere attributes
+        for (const std::string &name : props.property_names()) {
+            if (!string::starts_with(name, "particle_"))
+                continue;
+            if (props.type(name) != Properties::Type::Tensor)
+                Throw("Spheres: attribute \"%s\" must be a tensor!", name);
+            add_attribute(name, *props.tensor<TensorXf>(name));
+        }
+
+        recompute_bbox();
+
+        Log(Debug, "Spheres: read %u spheres (%s in %s)", m_sphere_count,
+            util::mem_string(count * 4 * sizeof(InputFloat)),
+            util::time_string((float) timer.value()));
+
+        m_shape_type = ShapeType::Spheres;
+        dr::set_attr(this, "shape_type", m_shape_type);
+
+        update_host_pointers();
+        initialize();
+    }
+
+    ScalarSize primitive_count() const override { return m_sphere_count; }
+
+    ScalarBoundingBox3f bbox() const override { return m_bbox; }
+
+    SurfaceInteraction3f compute_surface_interaction(const Ray3f &ray,
+                                                     const PreliminaryIntersection3f &pi,
+                                                     uint32_t ray_flags,
+                                                     uint32_t recursion_depth,
+                                                     Mask active) const override {
+        MI_MASK_ARGUMENT(active);
+
+        // Early exit when tracing isn't necessary
+        if (!m_is_instance && recursion_depth > 0)
+            return dr::zeros<SurfaceInteraction3f>();
+
+        bool need_dn_duv = has_flag(ray_flags, RayFlags::dNSdUV) ||
+                           has_flag(ray_flags, RayFlags::dNGdUV);
+        bool need_dp_duv = has_flag(ray_flags, RayFlags::dPdUV) || need_dn_duv;
+        bool need_uv     = has_flag(ray_flags, RayFlags::UV) || need_dp_duv;
+
+        Point4f sphere = dr::gather<Point4f>(m_data, pi.prim_index, active);
+        Point3f center(sphere.x(), sphere.y(), sphere.z());
+        Float radius = sphere.w();
+
+        SurfaceInteraction3f si = dr::zeros<SurfaceInteraction3f>();
+        si.t = dr::select(active, pi.t, dr::Infinity<Float>);
+
+        // Re-project onto the sphere to improve accuracy
+        Vector3f local = dr::normalize(ray(pi.t) - center);
+        si.p = dr::fmadd(local, radius, center);
+        si.n = si.sh_frame.n = local;
+
+        if (likely(need_uv)) {
+            Float rd_2  = dr::sqr(local.x()) + dr::sqr(local.y()),
+                  theta = unit_angle_z(local),
+                  phi   = dr::atan2(local.y(), local.x());
+
+            dr::masked(phi, phi < 0.f) += 2.f * dr::Pi<Float>;
+
+            si.uv = Point2f(phi * dr::InvTwoPi<Float>, theta * dr::InvPi<Float>);
+            if (likely(need_dp_duv)) {
+                si.dp_du = Vector3f(-local.y(), local.x(), 0.f);
+
+                Float rd      = dr::sqrt(rd_2),
+                      inv_rd  = dr::rcp(rd),
+                      cos_phi = local.x() * inv_rd,
+                      sin_phi = local.y() * inv_rd;
+
+                si.dp_dv = Vector3f(local.z() * cos_phi,
+                                    local.z() * sin_phi,
+                                    -rd);
+
+                Mask singularity_mask = active && dr::eq(rd, 0.f);
+                if (unlikely(dr::any_or<true>(singularity_mask)))
+                    si.dp_dv[singularity_mask] = Vector3f(1.f, 0.f, 0.f);
+
+                si.dp_du *= radius * dr::TwoPi<Float>;
+                si.dp_dv *= radius * dr::Pi<Float>;
+            }
+        }
+
+        if (need_dn_duv) {
+            Float inv_radius = dr::rcp(radius);
+            si.dn_du = si.dp_du * inv_radius;
+            si.dn_dv = si.dp_dv * inv_radius;
+        }
+
+        si.shape    = this;
+        si.instance = nullptr;
+
+        return si;
+    }
+
+    // =============================================================
+    //! @{ \name Per-sphere attributes
+    // =============================================================
+
+    Mask has_attribute(const std::string &name, Mask active) const override {
+        if (m_attributes.find(name) == m_attributes.end())
+            return Base::has_attribute(name, active);
+        return true;
+    }
+
+    UnpolarizedSpectrum eval_attribute(const std::string &name,
+                                       const SurfaceInteraction3f &si,
+                                       Mask active) const override {
+        const auto &it = m_attributes.find(name);
+        if (it == m_attributes.end())
+            return Base::eval_attribute(name, si, active);
+
+        const ParticleAttribute &attr = it->second;
+        if (attr.size == 1) {
+            return dr::gather<Float>(attr.buf, si.prim_index, active);
+        } else {
+            Color3f value = dr::gather<Color3f>(attr.buf, si.prim_index, active);
+            if constexpr (is_monochromatic_v<Spectrum>)
+                return luminance(value);
+            else if constexpr (is_spectral_v<Spectrum>)
+                return srgb_model_eval<UnpolarizedSpectrum>(value, si.wavelengths);
+            else
+                return value;
+        }
+    }
+
+    Float eval_attribute_1(const std::string &name,
+                           const SurfaceInteraction3f &si,
+                           Mask active) const override {
+        const auto &it = m_attributes.find(name);
+        if (it == m_attributes.end())
+            return Base::eval_attribute_1(name, si, active);
+
+        const ParticleAttribute &attr = it->second;
+        if (attr.size == 1) {
+            return dr::gather<Float>(attr.buf, si.prim_index, active);
+        } else {
+            if constexpr (dr::is_jit_v<Float>)
+                return 0.f;
+            else
+                Throw("eval_attribute_1(): Attribute \"%s\" requested but had size %u.",
+                      name, attr.size);
+        }
+    }
+
+    Color3f eval_attribute_3(const std::string &name,
+                             const SurfaceInteraction3f &si,
+                             Mask active) const override {
+        const auto &it = m_attributes.find(name);
+        if (it == m_attributes.end())
+            return Base::eval_attribute_3(name, si, active);
+
+        const ParticleAttribute &attr = it->second;
+        if (attr.size == 3) {
+            return dr::gather<Color3f>(attr.buf, si.prim_index, active);
+        } else {
+            if constexpr (dr::is_jit_v<Float>)
+                return 0.f;
+            else
+                Throw("eval_attribute_3(): Attribute \"%s\" requested but had size %u.",
+                      name, attr.size);
+        }
+    }
+
+    //! @}
+    // =============================================================
+
+    void traverse(TraversalCallback *callback) override {
+        Base::traverse(callback);
+        callback->put_parameter("sphere_count", m_sphere_count, +ParamFlags::NonDifferentiable);
+        callback->put_parameter("data",         m_data,         +ParamFlags::NonDifferentiable);
+        for (auto &[name, attr] : m_attributes)
+            callback->put_parameter(name, attr.buf, +ParamFlags::Differentiable);
+    }
+
+    void parameters_changed(const std::vector<std::string> &keys) override {
+        if (keys.empty() || string::contains(keys, "data")) {
+            if (dr::width(m_data) != 4 * (size_t) m_sphere_count)
+                Throw("Spheres: the number of spheres can't be changed by "
+                      "updating the \"data\" buffer!");
+            recompute_bbox();
+            update_host_pointers();
+            mark_dirty();
+        }
+        Base::parameters_changed();
+    }
+
+#if defined(MI_ENABLE_EMBREE)
+    RTCGeometry embree_geometry(RTCDevice device) override {
+        dr::eval(m_data); // Make sure the buffer is evaluated
+        RTCGeometry geom = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_SPHERE_POINT);
+        rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT4,
+                                   m_data.data(), 0, 4 * sizeof(InputFloat),
+                                   m_sphere_count);
+        rtcCommitGeometry(geom);
+        return geom;
+    }
+#endif
+
+#if defined(MI_ENABLE_CUDA)
+    void optix_prepare_geometry() override { }
+
+    void optix_build_input(OptixBuildInput &build_input) const override {
+        dr::eval(m_data); // Make sure the buffer is evaluated
+        m_vertex_buffer_ptr = (CUdeviceptr*) m_data.data();
+        m_radius_buffer_ptr = (CUdeviceptr*) (m_data.data() + 3);
+
+        build_input.type = OPTIX_BUILD_INPUT_TYPE_SPHERES;
+        build_input.sphereArray.vertexBuffers       = (CUdeviceptr*) &m_vertex_buffer_ptr;
+        build_input.sphereArray.vertexStrideInBytes = sizeof(InputFloat) * 4;
+        build_input.sphereArray.numVertices         = m_sphere_count;
+        build_input.sphereArray.radiusBuffers       = (CUdeviceptr*) &m_radius_buffer_ptr;
+        build_input.sphereArray.radiusStrideInBytes = sizeof(InputFloat) * 4;
+        build_input.sphereArray.singleRadius        = 0;
+        build_input.sphereArray.flags               = optix_geometry_flags;
+        build_input.sphereArray.numSbtRecords       = 1;
+        build_input.sphereArray.primitiveIndexOffset = 0;
+    }
+#endif
+
+    // =============================================================
+    //! @{ \name Native backend (kd-tree / BVH) support
+    // =============================================================
+
+    ScalarBoundingBox3f bbox(ScalarIndex index) const override {
+        auto [center, radius] = host_sphere(index);
+        return ScalarBoundingBox3f(center - radius, center + radius);
+    }
+
+    std::tuple<ScalarFloat, ScalarPoint2f, ScalarUInt32, ScalarUInt32>
+    ray_intersect_primitive_scalar(ScalarIndex index,
+                                   const ScalarRay3f &ray) const override {
+        return { intersect_sphere(index, ray), ScalarPoint2f(0.f),
+                 (ScalarUInt32) -1, index };
+    }
+
+    bool ray_test_primitive_scalar(ScalarIndex index,
+                                   const ScalarRay3f &ray) const override {
+        return intersect_sphere(index, ray) != dr::Infinity<ScalarFloat>;
+    }
+
+    //! @}
+    // =============================================================
+
+    std::string to_string() const override {
+        std::ostringstream oss;
+        oss << "Spheres[" << std::endl
+            << "  sphere_count = " << m_sphere_count << "," << std::endl
+            << "  attributes = [";
+        size_t i = 0;
+        for (const auto &[name, attr] : m_attributes)
+            oss << (i++ > 0 ? ", " : "") << name;
+        oss << "]," << std::endl
+            << "  " << string::indent(get_children_string()) << std::endl
+            << "]";
+        return oss.str();
+    }
+
+    MI_DECLARE_CLASS()
+
+private:
+    /// Look up a tensor-valued property
+    static const TensorXf *tensor_property(const Properties &props,
+                                           const std::string &name) {
+        if (!props.has_property(name))
+            Throw("Spheres: the \"%s\" parameter must be specified!", name);
+        return props.tensor<TensorXf>(name);
+    }
+
+    void add_attribute(const std::string &name, const TensorXf &tensor) {
+        size_t dim = tensor.ndim() == 2 ? tensor.shape(1) : 1;
+        if (tensor.ndim() > 2 || (dim != 1 && dim != 3) ||
+            tensor.shape(0) != m_sphere_count)
+            Throw("Spheres: attribute \"%s\" must be a tensor of shape (N), "
+                  "(N, 1) or (N, 3) with N = %u!", name, m_sphere_count);
+
+        auto &&values = dr::migrate(tensor.array(), AllocType::Host);
+        if constexpr (dr::is_jit_v<Float>)
+            dr::sync_thread();
+
+        std::vector<InputFloat> data(values.data(),
+                                     values.data() + m_sphere_count * dim);
+
+        // In spectral modes, convert RGB color to srgb model coefs if attribute name contains 'color'
+        if constexpr (is_spectral_v<Spectrum>) {
+            if (dim == 3 && name.find("color") != std::string::npos) {
+                srgb_model_fetch(data.data(), m_sphere_count);
+            }
+        }
+
+        m_attributes.insert(
+            { name, { dim, dr::load<FloatStorage>(data.data(), data.size()) } });
+    }
+
+    void recompute_bbox() {
+        auto &&data = dr::migrate(m_data, AllocType::Host);
+        if constexpr (dr::is_jit_v<Float>)
+            dr::sync_thread();
+        const InputFloat *ptr = data.data();
+
+        m_bbox.reset();
+        for (ScalarSize i = 0; i < m_sphere_count; ++i) {
+            ScalarPoint3f p(ptr[4 * i + 0], ptr[4 * i + 1], ptr[4 * i + 2]);
+            ScalarFloat r(ptr[4 * i + 3]);
+            m_bbox.expand(ScalarBoundingBox3f(p - r, p + r));
+        }
+    }
+
+    /**
+     * \brief Make the sphere data accessible to the scalar intersection
+     * routines of the native backend
+     */
+    void update_host_pointers() {
+        if constexpr (!dr::is_cuda_v<Float>) {
+            if constexpr (dr::is_jit_v<Float>) {
+                dr::eval(m_data);
+                dr::sync_thread();
+            }
+            m_host_data = m_data.data();
+        }
+    }
+
+    /// Return the center and radius of a sphere (native backend only)
+    std::pair<ScalarPoint3f, ScalarFloat> host_sphere(ScalarIndex index) const {
+        const InputFloat *s = m_host_data + 4 * index;
+        return { ScalarPoint3f(s[0], s[1], s[2]), (ScalarFloat) s[3] };
+    }
+
+    /**
+     * \brief Intersect a ray with a sphere (native backend only)
+     *
+     * Uses the same numerically robust formulation as the \c sphere plugin.
+     * \return The distance along the ray, or infinity
+     */
+    ScalarFloat intersect_sphere(ScalarIndex index, const ScalarRay3f &ray) const {
+        using Vector3d = Vector<double, 3>;
+
+        auto [center_, radius_] = host_sphere(index);
+        Vector3d center(center_), d(ray.d);
+        double radius = radius_, maxt = ray.maxt;
+
+        // Move the origin to the plane that contains the sphere center and
+        // that is perpendicular to the ray direction
+        Vector3d l = Vector3d(ray.o) - center;
+        double plane_t = dr::dot(-l, d) / dr::squared_norm(d);
+        Vector3d o = l + plane_t * d;
+        if (dr::squared_norm(o) > dr::sqr(radius))
+            return dr::Infinity<ScalarFloat>;
+
+        auto [solution_found, near_t, far_t] = math::solve_quadratic(
+            dr::squared_norm(d), 2. * dr::dot(o, d), dr::squared_norm(o) - dr::sqr(radius));
+        near_t += plane_t;
+        far_t += plane_t;
+
+        // NaN-aware conditionals
+        if (!solution_found || !(near_t <= maxt && far_t >= 0.) ||
+            (near_t < 0. && far_t > maxt))
+            return dr::Infinity<ScalarFloat>;
+
+        return (ScalarFloat) (near_t < 0. ? far_t : near_t);
+    }
+
+private:
+    ScalarBoundingBox3f m_bbox;
+
+    ScalarSize m_sphere_count = 0;
+
+    /// Centers and radii of the spheres (center_x, center_y, center_z, radius)
+    mutable FloatStorage m_data;
+
+    /// Per-sphere attributes
+    std::unordered_map<std::string, ParticleAttribute> m_attributes;
+
+    /// Host pointer to the sphere data used by the native backend
+    const InputFloat *m_host_data = nullptr;
+
+#if defined(MI_ENABLE_CUDA)
+    static constexpr uint32_t optix_geometry_flags[1] = { OPTIX_GEOMETRY_FLAG_NONE };
+
+    // For OptiX build input
+    mutable void* m_vertex_buffer_ptr = nullptr;
+    mutable void* m_radius_buffer_ptr = nullptr;
+#endif
+};
+
+MI_IMPLEMENT_CLASS_VARIANT(Spheres, Shape)
+MI_EXPORT_PLUGIN(Spheres, "Sphere cloud intersection primitive");
+NAMESPACE_END(mitsuba)
@@ -0,0 +1,121 @@
+#include <mitsuba/render/mesh.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/timer.h>
+#include <mitsuba/core/util.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**!
+
+.. _shape-subdivision:
+
+Subdivision surface (:monosp:`subdivision`)
+-------------------------------------------
+
+.. pluginparameters::
+
+ * - (Nested plugin)
+   - |shape|
+   - One or more triangle meshes (e.g. :ref:`ply <shape-ply>` or
+     :ref:`obj <shape-obj>`) that specify the control cages.
+
+ * - levels
+   - |int|
+   - Maximum number of subdivision steps. (Default: 3)
+
+ * - max_edge_length
+   - |float|
+   - When set, a mesh is only subdivided until none of its edges is longer
+     than this value (in world space). Coarse control cages are thereby
+     refined more than already detailed ones. (Default: 0, i.e. always apply
+     ``levels`` subdivision steps)
+
+This plugin turns triangle meshes into smooth surfaces using Loop subdivision.
+Every subdivision step splits each triangle into four, and moves the vertices
+towards the limit surface of the control cage. Boundary edges are treated as
+creases, and the texture coordinates and mesh attributes are interpolated
+along with the positions. Vertex normals are recomputed for meshes that
+specified them.
+
+The control cages are refined once when the scene is loaded, and replaced by
+the resulting triangle meshes. These are rendered like any other mesh by all
+ray tracing backends. Since the number of triangles grows by a factor of 4
+with every step, the ``max_edge_length`` parameter should be preferred over
+large ``levels`` values to bound the memory footprint.
+
+The BSDF, media, and emitters of the control cages carry over to the
+subdivided meshes.
+
+.. tabs::
+    .. code-tab:: xml
+        :name: subdivision-shape
+
+        <shape type="subdivision">
+            <integer name="levels" value="4"/>
+            <float name="max_edge_length" value="0.01"/>
+
+            <shape type="ply">
+                <string name="filename" value="cage.ply"/>
+                <bsdf type="diffuse"/>
+            </shape>
+        </shape>
+
+    .. code-tab:: python
+
+        'type': 'subdivision',
+        'levels': 4,
+        'max_edge_length': 0.01,
+        'cage': {
+            'type': 'ply',
+            'filename': 'cage.ply',
+            'bsdf': {
+                'type': 'diffuse'
+            }
+        }
+ */
+
+template <typename Float, typename Spectrum>
+class SubdivisionShape final : public Shape<Float, Spectrum> {
+public:
+    MI_IMPORT_BASE(Shape)
+    MI_IMPORT_TYPES(Mesh)
+
+    SubdivisionShape(const Properties &props) {
+        uint32_t levels = props.get<uint32_t>("levels", 3);
+        ScalarFloat max_edge_length = props.get<ScalarFloat>("max_edge_length", 0.f);
+        if (max_edge_length < 0.f)
+            Throw("The \"max_edge_length\" parameter must be non-negative!");
+
+        Timer timer;
+        for (auto [unused, shape] : props.objects()) {
+            const Mesh *mesh = dynamic_cast<const Mesh *>(shape.get());
+            if (!mesh)
+                Throw("Only triangle meshes can be subdivided (got %s)!",
+                      shape->to_string());
+            m_objects.push_back(mesh->subdivide(levels, max_edge_length));
+        }
+
+        if (m_objects.empty())
+            Throw("The subdivision shape requires at least one nested mesh!");
+
+        if (m_objects.size() == 1)
+            m_objects[0]->set_id(props.id());
+
+        Log(Debug, "Subdivided %zu meshes (took %s)", m_objects.size(),
+            util::time_string((float) timer.value()));
+    }
+
+    std::vector<ref<Object>> expand() const override {
+        return m_objects;
+    }
+
+    ScalarBoundingBox3f bbox() const override { return ScalarBoundingBox3f(); }
+
+    MI_DECLARE_CLASS()
+private:
+    std::vector<ref<Object>> m_objects;
+};
+
+MI_IMPLEMENT_CLASS_VARIANT(SubdivisionShape, Shape)
+MI_EXPORT_PLUGIN(SubdivisionShape, "Subdivision surface");
+NAMESPACE_END(mitsuba)
@@ -0,0 +1,70 @@
+import pytest
+import drjit as dr
+import mitsuba as mi
+
+from array import array
+
+
+def create_blender_mesh(uv_seam):
+    # Two triangles (0, 1, 2) and (0, 2, 3) of a unit quad, with one polygon
+    # per triangle, using the Blender 3.6+ data layout
+    data = {
+        'verts': array('f', [0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 1, 0]),
+        'normals': array('f', [0, 0, 1] * 4),
+        'loops': array('i', [0, 1, 2, 0, 2, 3]),
+        'loop_tris': array('I', [0, 1, 2, 3, 4, 5]),
+        'polys': array('i', [0, 1]),
+        'uvs': array('f', [0, 0, 1, 0, 1, 1,
+                           0.5 if uv_seam else 0, 0, 1, 1, 0, 1]),
+    }
+
+    props = { name: buffer.buffer_info()[0] for name, buffer in data.items() }
+    mesh = mi.load_dict({
+        'type': 'blender',
+        'name': 'quad',
+        'version': '3.6.0',
+        'mat_nr': 0,
+        'vert_count': 4,
+        'loop_tri_count': 2,
+        **props
+    })
+
+    # Keep the Blender buffers alive as long as the mesh
+    return mesh, data
+
+
+@pytest.mark.parametrize('uv_seam', [False, True])
+def test01_create(variants_all_ad_rgb, uv_seam):
+    mesh, _ = create_blender_mesh(uv_seam)
+    assert mesh.face_count() == 2
+    # The first vertex is split along the UV seam
+    assert mesh.vertex_count() == (5 if uv_seam else 4)
+
+    params = mi.traverse(mesh)
+    faces = dr.unravel(mi.Vector3u, params['faces'])
+    positions = dr.unravel(mi.Point3f, params['vertex_positions'])
+    assert dr.allclose(dr.gather(mi.Point3f, positions, faces.x), [[0, 0], [0, 0], [0, 0]])
+    assert dr.allclose(dr.gather(mi.Point3f, positions, faces.z), [[1, 0], [1, 1], [0, 0]])
+    assert dr.allclose(mesh.bbox().min, [0, 0, 0])
+    assert dr.allclose(mesh.bbox().max, [1, 1, 0])
+
+
+def test02_incremental_update(variants_all_ad_rgb):
+    mesh, _ = create_blender_mesh(True)
+    params = mi.traverse(mesh)
+
+    FloatStorage = type(params['vertex_positions'])
+    params['blender_vertex_positions'] = FloatStorage([0, 0, 1, 2, 0, 1, 2, 2, 1, 0, 2, 1])
+    params.update()
+
+    assert mesh.vertex_count() == 5
+    assert dr.allclose(mesh.bbox().min, [0, 0, 1])
+    assert dr.allclose(mesh.bbox().max, [2, 2, 1])
+
+    positions = dr.unravel(mi.Point3f, params['vertex_positions'])
+    faces = dr.unravel(mi.Vector3u, params['faces'])
+    assert dr.allclose(dr.gather(mi.Point3f, positions, faces.y), [[2, 2], [0, 2], [1, 1]])
+
+    with pytest.raises(RuntimeError, match="expected 4 vertex positions"):
+        params['blender_vertex_positions'] = FloatStorage([0, 0, 1])
+        params.update()
@@ -564,3 +564,38 @@ def test21_shape_type(variant_scalar_rgb):
         "filename" : "resources/data/common/meshes/curve.txt",
     })
     assert curve.shape_type() == mi.ShapeType.BSplineCurve.value;
+
+
+@pytest.mark.parametrize("accel", ['kdtree', 'bvh'])
+def test22_ray_intersect_native(variant_scalar_rgb, tmp_path, accel):
+    if mi.MI_ENABLE_EMBREE:
+        pytest.skip("EMBREE enabled")
+
+    # Straight tube along the X axis, made of many segments
+    filename = str(tmp_path / "tube.txt")
+    with open(filename, "w") as f:
+        for i in range(35):
+            f.write(f"{-4.25 + i * 0.25} 0 0 0.5\n")
+
+    scene = mi.load_dict({
+        "type" : "scene",
+        "accel" : accel,
+        "tube" : { "type" : "bsplinecurve", "filename" : filename }
+    })
+
+    for x in [-3.3, -0.1, 0.6, 2.9]:
+        for y in [-0.6, -0.45, -0.2, 0.0, 0.3, 0.49]:
+            ray = mi.Ray3f(o=[x, y, 10], d=[0, 0, -1])
+            hit = abs(y) < 0.5
+            assert scene.ray_test(ray) == hit
+
+            si = scene.ray_intersect(ray)
+            assert si.is_valid() == hit
+            if hit:
+                assert dr.allclose(si.t, 10 - dr.sqrt(0.25 - y * y), atol=1e-4)
+                assert dr.allclose(si.n, [0, y / 0.5, dr.sqrt(0.25 - y * y) / 0.5], atol=1e-3)
+
+    # Rays starting inside the tube do not hit its back faces
+    ray = mi.Ray3f(o=[0, 0, 0], d=[0, 0, -1])
+    assert not scene.ray_intersect(ray).is_valid()
+
@@ -458,3 +458,31 @@ def test16_sample_precomputed_silhouette(variants_vec_rgb):
 def test17_shape_type(variant_scalar_rgb):
     cylinder = mi.load_dict({ 'type': 'cylinder' })
     assert cylinder.shape_type() == mi.ShapeType.Cylinder.value;
+
+
+def test18_ray_intersect_flags(variant_scalar_rgb):
+    scene = mi.load_dict({
+        "type" : "scene",
+        "foo" : {
+            "type" : "cylinder",
+            "to_world" : mi.ScalarTransform4f.rotate([1, 0, 0], 30)
+        }
+    })
+
+    ray = mi.Ray3f([0.2, -5, 0.5], [0, 1, 0])
+    si_all = scene.ray_intersect(ray, mi.RayFlags.All, True)
+
+    # The geometric fields match, the shading frame is skipped
+    si = scene.ray_intersect(ray, mi.RayFlags.Geometric, True)
+    assert dr.allclose(si.t, si_all.t)
+    assert dr.allclose(si.n, si_all.n)
+    assert dr.allclose(si.uv, si_all.uv)
+    assert dr.allclose(si.dp_du, si_all.dp_du)
+    assert dr.allclose(si.dp_dv, si_all.dp_dv)
+    assert dr.allclose(si.sh_frame.n, 0)
+
+    si = scene.ray_intersect(ray, mi.RayFlags.Minimal, True)
+    assert dr.allclose(si.t, si_all.t)
+    assert dr.allclose(si.n, si_all.n)
+    assert dr.allclose(si.uv, 0)
+    assert dr.allclose(si.dp_du, 0)
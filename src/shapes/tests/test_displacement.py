@@ -0,0 +1,75 @@
+import pytest
+import drjit as dr
+import mitsuba as mi
+import numpy as np
+
+
+def load_displaced(**kwargs):
+    scene = mi.load_dict({
+        'type': 'scene',
+        'displaced': dict({
+            'type': 'displacement',
+            'base': {
+                'type': 'obj',
+                'filename': 'resources/data/common/meshes/rectangle.obj'
+            }
+        }, **kwargs)
+    })
+    shapes = scene.shapes()
+    assert len(shapes) == 1
+    return shapes[0]
+
+
+def test01_constant_displacement(variants_all_rgb):
+    mesh = load_displaced(displacement=0.25, scale=2, levels=3)
+    assert mesh.face_count() == 2 * 4**3
+
+    # The tessellated rectangle is shifted along its normal
+    positions = np.array(mi.traverse(mesh)['vertex_positions']).reshape(-1, 3)
+    assert np.allclose(np.abs(positions[:, 2]), 0.5)
+    assert np.allclose(np.max(np.abs(positions[:, :2]), axis=0), 1)
+
+
+def test02_textured_displacement(variants_all_rgb):
+    mesh = load_displaced(displacement={
+        'type': 'checkerboard',
+        'color0': 0.0,
+        'color1': 1.0
+    }, levels=4)
+
+    params = mi.traverse(mesh)
+    positions = np.array(params['vertex_positions']).reshape(-1, 3)
+    texcoords = np.array(params['vertex_texcoords']).reshape(-1, 2)
+
+    # Vertices strictly inside of a checkerboard cell are displaced by 0 or 1
+    inside = np.all((np.abs(texcoords - 0.5) > 1e-3) & (texcoords > 1e-3) &
+                    (texcoords < 1 - 1e-3), axis=1)
+    expected = np.where((texcoords[:, 0] > 0.5) != (texcoords[:, 1] > 0.5), 0, 1)
+    assert np.any(inside)
+    assert np.allclose(np.abs(positions[inside, 2]), expected[inside])
+
+
+def test03_watertight(variants_all_rgb):
+    # The duplicated vertices along the edges of the cube move together
+    scene = mi.load_dict({
+        'type': 'scene',
+        'displaced': {
+            'type': 'displacement',
+            'displacement': 0.5,
+            'levels': 1,
+            'base': { 'type': 'cube' }
+        }
+    })
+    mesh = scene.shapes()[0]
+    params = mi.traverse(mesh)
+    positions = np.array(params['vertex_positions']).reshape(-1, 3)
+    faces = np.array(params['faces']).reshape(-1, 3)
+
+    _, weld = np.unique(np.round(positions, 5), axis=0, return_inverse=True)
+    weld = weld.ravel()
+    edges = {}
+    for f in weld[faces]:
+        for i in range(3):
+            key = tuple(sorted((f[i], f[(i + 1) % 3])))
+            edges[key] = edges.get(key, 0) + 1
+    assert all(count == 2 for count in edges.values())
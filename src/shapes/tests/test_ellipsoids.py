@@ -0,0 +1,95 @@
+import pytest
+import drjit as dr
+import mitsuba as mi
+
+
+def create_ellipsoids(**kwargs):
+    # Ellipsoids with radii (1, 0.5, 0.25) at three standard deviations
+    centers = mi.TensorXf([0, 0, 0,
+                           4, 0, 0], shape=(2, 3))
+    scales = mi.TensorXf([1, 0.5, 0.25,
+                          1, 0.5, 0.25], shape=(2, 3))
+    scales /= 3
+    s = dr.sqrt(0.5)
+    quaternions = mi.TensorXf([0, 0, 0, 1,
+                               0, 0, s, s], shape=(2, 4))
+    return mi.load_dict({
+        "type" : "ellipsoids",
+        "centers" : centers,
+        "scales" : scales,
+        "quaternions" : quaternions,
+        "opacities" : mi.TensorXf([0.5, 1.0], shape=(2,)),
+        **kwargs
+    })
+
+
+def test01_create(variants_all_rgb):
+    s = create_ellipsoids()
+    assert s is not None
+    assert s.primitive_count() == 2
+
+    # The second ellipsoid is rotated by 90 degrees around the Z axis
+    b = s.bbox()
+    assert dr.allclose(b.min, [-1, -1, -0.25], atol=1e-5)
+    assert dr.allclose(b.max, [4.5, 1, 0.25], atol=1e-5)
+
+    with pytest.raises(RuntimeError, match="must be a tensor of shape"):
+        mi.load_dict({
+            "type" : "ellipsoids",
+            "centers" : mi.TensorXf([1, 2, 3], shape=(1, 3)),
+            "scales" : mi.TensorXf([1, 2], shape=(1, 2)),
+        })
+
+
+def test02_ray_intersect(variants_all_rgb):
+    scene = mi.load_dict({
+        "type" : "scene",
+        "ellipsoids" : create_ellipsoids()
+    })
+
+    ray = mi.Ray3f(o=[0.2, 0.1, -10], d=[0, 0, 1])
+    assert dr.all(scene.ray_test(ray))
+
+    si = scene.ray_intersect(ray)
+    assert dr.all(si.is_valid())
+    assert dr.all(si.prim_index == 0)
+
+    z = -0.25 * dr.sqrt(1 - 0.2**2 - 0.2**2)
+    assert dr.allclose(si.t, 10 + z, atol=1e-4)
+    assert dr.allclose(si.p, [0.2, 0.1, z], atol=1e-4)
+    assert dr.allclose(si.n, dr.normalize(mi.Vector3f(0.2, 0.1 / 0.25, z / 0.0625)),
+                       atol=1e-4)
+
+    # The rotated ellipsoid is 0.5 wide along the X axis
+    ray = mi.Ray3f(o=[4.4, 0.9, -10], d=[0, 0, 1])
+    assert dr.none(scene.ray_test(ray))
+    ray = mi.Ray3f(o=[4.2, 0.9, -10], d=[0, 0, 1])
+    si = scene.ray_intersect(ray)
+    assert dr.all(si.is_valid())
+    assert dr.all(si.prim_index == 1)
+
+    # Miss between the ellipsoids
+    ray = mi.Ray3f(o=[2, 0, -10], d=[0, 0, 1])
+    assert dr.none(scene.ray_test(ray))
+    assert dr.none(scene.ray_intersect(ray).is_valid())
+
+
+def test03_splat_alpha(variants_all_rgb):
+    scene = mi.load_dict({
+        "type" : "scene",
+        "ellipsoids" : create_ellipsoids()
+    })
+
+    # The largest value of the Gaussian along the ray is reached at a
+    # distance of 0.9 standard deviations from the center
+    ray = mi.Ray3f(o=[0.3, 0, -10], d=[0, 0, 1])
+    si = scene.ray_intersect(ray)
+    alpha = si.shape.eval_attribute_1("splat_alpha", si)
+    assert dr.allclose(alpha, 0.5 * dr.exp(-0.5 * 0.9**2), atol=1e-4)
+
+    # Rays leaving an ellipsoid don't account for it a second time
+    ray = mi.Ray3f(o=[0.3, 0, 0], d=[0, 0, 1])
+    si = scene.ray_intersect(ray)
+    assert dr.all(si.is_valid())
+    alpha = si.shape.eval_attribute_1("splat_alpha", si)
+    assert dr.allclose(alpha, 0)
@@ -216,3 +216,185 @@ def test03_ray_intersect_instance(variants_all_rgb, width):
         assert 'instance = nullptr' in str(pi)
     else:
         assert ('instance = [' + '0x0, ' * (width - 1) + '0x0]') in str(pi)
+
+
+def test04_motion_blur(variants_all_rgb):
+    """Check that animated instances are intersected at the time of each ray"""
+
+    scene = mi.load_string("""
+        <scene version="3.0.0">
+            <shape type="shapegroup" id="group_0">
+                <shape type="rectangle">
+                    <transform name="to_world">
+                        <scale value="0.5"/>
+                    </transform>
+                </shape>
+            </shape>
+
+            <shape type="instance">
+                <ref id="group_0"/>
+                <animation name="to_world">
+                    <transform time="0">
+                        <translate x="-2"/>
+                    </transform>
+                    <transform time="0.5">
+                        <translate x="0"/>
+                    </transform>
+                    <transform time="1">
+                        <rotate z="1" angle="90"/>
+                        <translate x="2"/>
+                    </transform>
+                </animation>
+            </shape>
+        </scene>
+    """)
+
+    bbox = scene.bbox()
+    assert bbox.min.x <= -2.5 and bbox.max.x >= 2.5
+
+    x    = [-2, -2, 0, 0, 2, 2, 1, 1]
+    time = [ 0,  1, 0.5, 0, 1, 0, 0.75, 0.25]
+    hit  = [True, False, True, False, True, False, True, False]
+
+    for i in range(len(x)):
+        ray = mi.Ray3f([x[i], 0, -10], [0, 0, 1], time[i], [])
+        si = scene.ray_intersect(ray)
+        assert dr.all(si.is_valid() == hit[i])
+        if hit[i]:
+            assert dr.allclose(si.p, [x[i], 0, 0], atol=1e-4)
+            assert dr.allclose(si.t, 10, atol=1e-4)
+
+    # The same animation can be specified as a Python object
+    animation = mi.AnimatedTransform()
+    animation.append(0, mi.ScalarTransform4f.translate([-2, 0, 0]))
+    animation.append(1, mi.ScalarTransform4f.translate([2, 0, 0]))
+
+    scene = mi.load_dict({
+        'type': 'scene',
+        'group_0': {
+            'type': 'shapegroup',
+            'shape': { 'type': 'sphere', 'radius': 0.5 }
+        },
+        'instance': {
+            'type': 'instance',
+            'group': { 'type': 'ref', 'id': 'group_0' },
+            'to_world': animation
+        }
+    })
+
+    ray = mi.Ray3f([1, 0, -10], [0, 0, 1], 0.75, [])
+    assert dr.all(scene.ray_intersect(ray).is_valid())
+    assert dr.all(scene.ray_test(ray))
+    ray = mi.Ray3f([1, 0, -10], [0, 0, 1], 0.25, [])
+    assert dr.none(scene.ray_intersect(ray).is_valid())
+
+
+def test05_instance_overrides(variants_all_rgb):
+    """Check the per-instance BSDF, texture coordinate and attribute overrides"""
+
+    from mitsuba import ScalarTransform4f as T
+
+    scene = mi.load_dict({
+        'type': 'scene',
+        'group_0': {
+            'type': 'shapegroup',
+            'shape': {
+                'type': 'rectangle',
+                'bsdf': {
+                    'type': 'diffuse',
+                    'reflectance': {
+                        'type': 'mesh_attribute',
+                        'name': 'instance_color'
+                    }
+                }
+            }
+        },
+        'instance_0': {
+            'type': 'instance',
+            'group': { 'type': 'ref', 'id': 'group_0' },
+            'to_world': T.translate([-2, 0, 0]),
+            'instance_color': { 'type': 'rgb', 'value': [0.1, 0.2, 0.3] }
+        },
+        'instance_1': {
+            'type': 'instance',
+            'group': { 'type': 'ref', 'id': 'group_0' },
+            'to_world': T.translate([2, 0, 0]),
+            'uv_offset': [1, 2, 0],
+            'bsdf': { 'type': 'conductor' }
+        }
+    })
+
+    ray = mi.Ray3f([-2, 0, -10], [0, 0, 1])
+    si = scene.ray_intersect(ray)
+    assert dr.all(si.is_valid())
+    assert dr.allclose(si.uv, [0.5, 0.5])
+    bsdf = si.bsdf()
+    assert dr.all(mi.has_flag(bsdf.flags(), mi.BSDFFlags.DiffuseReflection))
+    assert dr.allclose(bsdf.eval_diffuse_reflectance(si), [0.1, 0.2, 0.3])
+
+    ray = mi.Ray3f([2, 0, -10], [0, 0, 1])
+    si = scene.ray_intersect(ray)
+    assert dr.all(si.is_valid())
+    assert dr.allclose(si.uv, [1.5, 2.5])
+    bsdf = si.bsdf()
+    assert dr.all(mi.has_flag(bsdf.flags(), mi.BSDFFlags.DeltaReflection))
+
+    params = mi.traverse(scene)
+    assert 'instance_1.uv_offset' in params
+    assert 'instance_0.instance_color.value' in params
+
+    # Move the second instance to another tile
+    params['instance_1.uv_offset'] = mi.Vector2f(3, 0)
+    params.update()
+    si = scene.ray_intersect(ray)
+    assert dr.allclose(si.uv, [3.5, 0.5])
+
+
+def test06_levels_of_detail(variants_all_rgb):
+    """Check that instances select their level of detail by the sensor distance"""
+
+    from mitsuba import ScalarTransform4f as T
+
+    def instance(z):
+        return {
+            'type': 'instance',
+            'lod_0': { 'type': 'ref', 'id': 'fine' },
+            'lod_1': { 'type': 'ref', 'id': 'coarse' },
+            'lod_distances': '10',
+            'to_world': T.translate([0, 0, z])
+        }
+
+    scene = mi.load_dict({
+        'type': 'scene',
+        'sensor': {
+            'type': 'perspective',
+            'to_world': T.look_at(origin=[0, 0, 0], target=[0, 0, 1], up=[0, 1, 0])
+        },
+        'fine': {
+            'type': 'shapegroup',
+            'shape': { 'type': 'rectangle' }
+        },
+        'coarse': {
+            'type': 'shapegroup',
+            'shape': { 'type': 'sphere' }
+        },
+        'near': instance(5),
+        'far': instance(50),
+    })
+
+    # The near instance uses the rectangle, the far one the sphere
+    si = scene.ray_intersect(mi.Ray3f([0, 0, 0], [0, 0, 1]))
+    assert dr.allclose(si.t, 5)
+    si = scene.ray_intersect(mi.Ray3f([0, 0, 20], [0, 0, 1]))
+    assert dr.allclose(si.t, 29)
+
+    with pytest.raises(Exception, match='lod_1'):
+        mi.load_dict({
+            'type': 'scene',
+            'fine': { 'type': 'shapegroup', 'shape': { 'type': 'rectangle' } },
+            'inst': {
+                'type': 'instance',
+                'lod_0': { 'type': 'ref', 'id': 'fine' },
+                'lod_distances': '10'
+            }
+        })
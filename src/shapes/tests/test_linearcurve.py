@@ -210,3 +210,70 @@ def test10_shape_type(variant_scalar_rgb):
         "filename" : "resources/data/common/meshes/curve_6.txt",
     })
     assert curve.shape_type() == mi.ShapeType.LinearCurve.value;
+
+
+@pytest.mark.parametrize("accel", ['kdtree', 'bvh'])
+def test11_ray_intersect_native(variant_scalar_rgb, tmp_path, accel):
+    if mi.MI_ENABLE_EMBREE:
+        pytest.skip("EMBREE enabled")
+
+    # Straight tube along the X axis, made of many segments
+    filename = str(tmp_path / "tube.txt")
+    with open(filename, "w") as f:
+        for i in range(33):
+            f.write(f"{-4 + i * 0.25} 0 0 0.5\n")
+
+    scene = mi.load_dict({
+        "type" : "scene",
+        "accel" : accel,
+        "tube" : { "type" : "linearcurve", "filename" : filename }
+    })
+
+    for x in [-3.3, -0.1, 0.6, 2.9]:
+        for y in [-0.6, -0.45, -0.2, 0.0, 0.3, 0.49]:
+            ray = mi.Ray3f(o=[x, y, 10], d=[0, 0, -1])
+            hit = abs(y) < 0.5
+            assert scene.ray_test(ray) == hit
+
+            si = scene.ray_intersect(ray)
+            assert si.is_valid() == hit
+            if hit:
+                assert dr.allclose(si.t, 10 - dr.sqrt(0.25 - y * y), atol=1e-4)
+                assert dr.allclose(si.n, [0, y / 0.5, dr.sqrt(0.25 - y * y) / 0.5], atol=1e-3)
+
+
+def test12_stochastic_simplification(variants_all_rgb, tmp_path):
+    # 100 curves with three control points each
+    filename = str(tmp_path / "fur.txt")
+    with open(filename, "w") as f:
+        for i in range(100):
+            for j in range(3):
+                f.write(f"{i * 0.1} {j * 0.5} 0 0.01\n")
+            f.write("\n")
+
+    def load(**kwargs):
+        return mi.load_dict({
+            "type" : "linearcurve",
+            "filename" : filename,
+            **kwargs
+        })
+
+    s = load(simplify_ratio=4)
+    assert s.primitive_count() == 25 * 2
+    params = mi.traverse(s)
+    assert params['control_point_count'] == 25 * 3
+    radii = dr.unravel(mi.Point4f, params['control_points']).w
+    assert dr.allclose(radii, 0.04)
+
+    # The selection is deterministic for a given seed
+    assert dr.all(params['control_points'] ==
+                  mi.traverse(load(simplify_ratio=4))['control_points'])
+    other = mi.traverse(load(simplify_ratio=4, simplify_seed=1))['control_points']
+    assert dr.any(params['control_points'] != other)
+
+    radii = dr.unravel(mi.Point4f, mi.traverse(
+        load(simplify_ratio=4, simplify_widen=False))['control_points']).w
+    assert dr.allclose(radii, 0.01)
+
+    with pytest.raises(RuntimeError, match="simplify_ratio"):
+        load(simplify_ratio=0.5)
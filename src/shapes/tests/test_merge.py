@@ -0,0 +1,71 @@
+import pytest
+import drjit as dr
+import mitsuba as mi
+import numpy as np
+
+
+def test01_merge_many_meshes(variants_all_rgb):
+    count = 50
+    scene_dict = { 'type': 'scene', 'merged': { 'type': 'merge' } }
+    for i in range(count):
+        scene_dict['merged'][f'cube_{i}'] = {
+            'type': 'cube',
+            'to_world': mi.ScalarTransform4f.translate([3 * i, 0, 0])
+        }
+
+    scene = mi.load_dict(scene_dict)
+    shapes = scene.shapes()
+    assert len(shapes) == 1
+
+    mesh = shapes[0]
+    cube = mi.load_dict({ 'type': 'cube' })
+    assert mesh.vertex_count() == count * cube.vertex_count()
+    assert mesh.face_count() == count * cube.face_count()
+    assert dr.allclose(mesh.surface_area(), count * cube.surface_area())
+
+    bbox = mesh.bbox()
+    assert dr.allclose(bbox.min, [-1, -1, -1])
+    assert dr.allclose(bbox.max, [3 * (count - 1) + 1, 1, 1])
+
+    # Every cube keeps its transform and references its own vertices
+    params = mi.traverse(mesh)
+    positions = np.array(params['vertex_positions']).reshape(count, -1, 3)
+    faces = np.array(params['faces']).reshape(count, -1)
+    cube_positions = np.array(mi.traverse(cube)['vertex_positions']).reshape(-1, 3)
+    cube_faces = np.array(mi.traverse(cube)['faces'])
+    for i in range(count):
+        assert np.allclose(positions[i], cube_positions + [3 * i, 0, 0])
+        assert np.all(faces[i] == cube_faces + i * cube.vertex_count())
+
+
+def test02_merge_mesh_attributes(variants_all_rgb):
+    def create_mesh(offset, color):
+        mesh = mi.Mesh('MyMesh', 3, 1)
+        params = mi.traverse(mesh)
+        params['vertex_positions'] = [offset, 0, 0, offset + 1, 0, 0, offset, 1, 0]
+        params['faces'] = [0, 1, 2]
+        params.update()
+        mesh.add_attribute('vertex_weight', 1, [color] * 3)
+        mesh.add_attribute('face_weight', 1, [2 * color])
+        return mesh
+
+    scene = mi.load_dict({
+        'type': 'scene',
+        'merged': {
+            'type': 'merge',
+            'mesh_0': create_mesh(0, 0.25),
+            'mesh_1': create_mesh(2, 0.5),
+            'mesh_2': create_mesh(4, 0.75),
+            'cube': { 'type': 'cube' }
+        }
+    })
+
+    shapes = sorted(scene.shapes(), key=lambda s: s.face_count())
+    assert len(shapes) == 2
+    mesh = shapes[0]
+    assert mesh.face_count() == 3
+
+    params = mi.traverse(mesh)
+    assert dr.allclose(params['vertex_weight'], [0.25] * 3 + [0.5] * 3 + [0.75] * 3)
+    assert dr.allclose(params['face_weight'], [0.5, 1.0, 1.5])
+    assert dr.allclose(params['faces'], [0, 1, 2, 3, 4, 5, 6, 7, 8])
@@ -424,3 +424,38 @@ def test17_sample_precomputed_silhouette(variants_vec_rgb):
 def test18_shape_type(variant_scalar_rgb):
     rectangle = mi.load_dict({ 'type': 'rectangle' })
     assert rectangle.shape_type() == mi.ShapeType.Rectangle.value;
+
+
+def test19_solid_angle_sampling(variants_vec_rgb):
+    rectangle = mi.load_dict({ 'type': 'rectangle' })
+
+    sampler = mi.load_dict({ 'type': 'independent' })
+    sampler.seed(0, 1 << 16)
+    it = dr.zeros(mi.Interaction3f, 1 << 16)
+    it.p = [0.3, -0.2, 0.5]
+    ds = rectangle.sample_direction(it, sampler.next_2d())
+
+    # Solid angle of the rectangle, and of its half at x < 0
+    def solid_angle(x0, x1):
+        corners = [dr.normalize(mi.Vector3f(x, y, 0) - it.p)
+                   for x, y in [(x0, -1), (x1, -1), (x1, 1), (x0, 1)]]
+        return mi.warp.spherical_triangle_solid_angle(*corners[:3]) + \
+               mi.warp.spherical_triangle_solid_angle(corners[0], *corners[2:])
+
+    # Directions are sampled uniformly in solid angle
+    assert dr.allclose(ds.pdf, 1 / solid_angle(-1, 1), rtol=1e-4)
+    assert dr.allclose(ds.pdf, rectangle.pdf_direction(it, ds))
+
+    assert dr.allclose(ds.p.z, 0, atol=1e-5)
+    assert dr.all((dr.abs(ds.p.x) <= 1 + 1e-5) & (dr.abs(ds.p.y) <= 1 + 1e-5))
+    assert dr.allclose(ds.uv, (mi.Point2f(ds.p.x, ds.p.y) + 1) / 2, atol=1e-5)
+    assert dr.allclose(ds.d, dr.normalize(ds.p - it.p))
+
+    fraction = dr.count(ds.p.x < 0) / (1 << 16)
+    assert dr.allclose(fraction, solid_angle(-1, 0) / solid_angle(-1, 1), atol=1e-2)
+
+    # Distant reference points use area sampling
+    it.p = [0, 0, 100]
+    ds = rectangle.sample_direction(it, sampler.next_2d())
+    assert dr.allclose(ds.pdf, rectangle.pdf_direction(it, ds))
+    assert dr.allclose(ds.pdf, dr.squared_norm(ds.p - it.p) / (4 * dr.abs(ds.d.z)))
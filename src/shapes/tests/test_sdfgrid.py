@@ -354,3 +354,42 @@ def test08_load_tensor(variants_all_ad_rgb):
 def test09_shape_type(variant_scalar_rgb):
     sdf = mi.load_dict({ "type" : "sdfgrid" })
     assert sdf.shape_type() == mi.ShapeType.SDFGrid.value;
+
+
+def test10_sparse_bricks(variants_all_ad_rgb):
+    # Sphere of radius 0.3, sampled on a grid of 20^3 points (i.e. 3x3x3 bricks)
+    res = 20
+    values = []
+    for z in range(res):
+        for y in range(res):
+            for x in range(res):
+                p = [v / (res - 1) - 0.5 for v in (x, y, z)]
+                values.append(sum(v * v for v in p) ** 0.5 - 0.3)
+    grid = mi.TensorXf(mi.Float(values), shape=(res, res, res, 1))
+
+    shapes = [mi.load_dict({ "type" : "sdfgrid", "grid" : grid, "sparse" : sparse })
+              for sparse in [False, True]]
+    assert shapes[1].primitive_count() < shapes[0].primitive_count()
+    assert dr.allclose(shapes[0].bbox().min, shapes[1].bbox().min)
+    assert dr.allclose(shapes[0].bbox().max, shapes[1].bbox().max)
+
+    scenes = [mi.load_dict({ "type" : "scene", "sdf" : s }) for s in shapes]
+
+    n = 9
+    for x in dr.linspace(mi.Float, 0.05, 0.95, n):
+        for y in dr.linspace(mi.Float, 0.05, 0.95, n):
+            for d in [[0, 0, -1], [0.3, -0.2, -1]]:
+                ray = mi.Ray3f(o=[x, y, 3], d=dr.normalize(mi.ScalarVector3f(d)))
+                si = [s.ray_intersect(ray) for s in scenes]
+                assert dr.all(si[0].is_valid() == si[1].is_valid())
+                assert dr.all(scenes[1].ray_test(ray) == si[1].is_valid())
+
+                if dr.all(si[0].is_valid()):
+                    assert dr.allclose(si[0].t, si[1].t, atol=1e-4)
+                    assert dr.allclose(si[0].n, si[1].n, atol=1e-4)
+
+    # Ray starting inside of a brick
+    ray = mi.Ray3f(o=[0.5, 0.5, 0.5], d=[1, 0, 0])
+    si = [s.ray_intersect(ray) for s in scenes]
+    assert dr.all(si[1].is_valid())
+    assert dr.allclose(si[0].t, si[1].t, atol=1e-4)
@@ -0,0 +1,121 @@
+import pytest
+import drjit as dr
+import mitsuba as mi
+
+
+def create_spheres(**kwargs):
+    centers = mi.TensorXf([0, 0, 0,
+                           3, 0, 0,
+                           0, 4, 0], shape=(3, 3))
+    radii = mi.TensorXf([1, 0.5, 2], shape=(3,))
+    return mi.load_dict({
+        "type" : "spheres",
+        "centers" : centers,
+        "radii" : radii,
+        **kwargs
+    })
+
+
+def test01_create(variants_all_rgb):
+    s = create_spheres()
+    assert s is not None
+    assert s.primitive_count() == 3
+    assert s.shape_type() == mi.ShapeType.Spheres.value
+
+    b = s.bbox()
+    assert dr.allclose(b.min, [-2, -1, -2])
+    assert dr.allclose(b.max, [3.5, 6, 2])
+
+    # Shared radius
+    s = mi.load_dict({
+        "type" : "spheres",
+        "centers" : mi.TensorXf([1, 2, 3], shape=(1, 3)),
+        "radius" : 0.25
+    })
+    assert dr.allclose(s.bbox().min, [0.75, 1.75, 2.75])
+    assert dr.allclose(s.bbox().max, [1.25, 2.25, 3.25])
+
+    with pytest.raises(RuntimeError, match="must be a tensor of shape"):
+        mi.load_dict({
+            "type" : "spheres",
+            "centers" : mi.TensorXf([1, 2, 3, 4], shape=(2, 2)),
+        })
+
+
+def test02_to_world(variants_all_rgb):
+    s = create_spheres(to_world=mi.ScalarTransform4f.translate([1, 2, 3]))
+    b = s.bbox()
+    assert dr.allclose(b.min, [-1, 1, 1])
+    assert dr.allclose(b.max, [4.5, 8, 5])
+
+
+def test03_ray_intersect(variants_all_rgb):
+    scene = mi.load_dict({
+        "type" : "scene",
+        "spheres" : create_spheres()
+    })
+
+    for i, (center, radius) in enumerate([([0, 0, 0], 1), ([3, 0, 0], 0.5), ([0, 4, 0], 2)]):
+        ray = mi.Ray3f(o=mi.Point3f(center) + [0.1 * radius, 0.2 * radius, -10],
+                       d=[0, 0, 1])
+        assert dr.all(scene.ray_test(ray))
+
+        si = scene.ray_intersect(ray)
+        assert dr.all(si.is_valid())
+        assert dr.all(si.prim_index == i)
+
+        z = dr.sqrt(1 - 0.1**2 - 0.2**2)
+        assert dr.allclose(si.t, 10 - z * radius, atol=1e-4)
+        assert dr.allclose(si.n, [0.1, 0.2, -z], atol=1e-4)
+        assert dr.allclose(si.p, mi.Point3f(center) + radius * mi.Vector3f(0.1, 0.2, -z), atol=1e-4)
+
+    # Miss between the spheres
+    ray = mi.Ray3f(o=[1.7, 0, -10], d=[0, 0, 1])
+    assert dr.none(scene.ray_test(ray))
+    assert dr.none(scene.ray_intersect(ray).is_valid())
+
+    # Ray starting inside a sphere
+    ray = mi.Ray3f(o=[0, 0, 0], d=[1, 0, 0])
+    si = scene.ray_intersect(ray)
+    assert dr.allclose(si.t, 1)
+    assert dr.all(si.prim_index == 0)
+
+
+def test04_attributes(variants_all_rgb):
+    s = create_spheres(
+        particle_weight=mi.TensorXf([1, 2, 3], shape=(3,)),
+        particle_albedo=mi.TensorXf([0.1, 0.2, 0.3,
+                                     0.4, 0.5, 0.6,
+                                     0.7, 0.8, 0.9], shape=(3, 3)))
+
+    params = mi.traverse(s)
+    assert 'particle_weight' in params
+    assert 'particle_albedo' in params
+
+    scene = mi.load_dict({ "type" : "scene", "spheres" : s })
+    ray = mi.Ray3f(o=[0, 4, -10], d=[0, 0, 1])
+    si = scene.ray_intersect(ray)
+    assert dr.all(si.is_valid())
+
+    assert dr.all(s.has_attribute("particle_weight"))
+    assert dr.none(s.has_attribute("particle_missing"))
+    assert dr.allclose(s.eval_attribute_1("particle_weight", si), 3)
+    assert dr.allclose(s.eval_attribute_3("particle_albedo", si), [0.7, 0.8, 0.9])
+
+    texture = mi.load_dict({
+        "type" : "mesh_attribute",
+        "name" : "particle_weight",
+    })
+    assert dr.allclose(texture.eval_1(si), 3)
+
+
+def test05_parameters_changed(variants_all_rgb):
+    s = create_spheres()
+    params = mi.traverse(s)
+    assert params['sphere_count'] == 3
+
+    params['data'] = type(params['data'])([1.0] * 12)
+    params.update()
+
+    assert dr.allclose(s.bbox().min, [0, 0, 0])
+    assert dr.allclose(s.bbox().max, [2, 2, 2])
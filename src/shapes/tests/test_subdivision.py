@@ -0,0 +1,81 @@
+import pytest
+import drjit as dr
+import mitsuba as mi
+import numpy as np
+
+
+def load_subdivided(shape, **kwargs):
+    scene = mi.load_dict({
+        'type': 'scene',
+        'subdivided': dict({ 'type': 'subdivision', 'cage': shape }, **kwargs)
+    })
+    shapes = scene.shapes()
+    assert len(shapes) == 1
+    return shapes[0]
+
+
+def max_edge_length(mesh):
+    params = mi.traverse(mesh)
+    positions = np.array(params['vertex_positions']).reshape(-1, 3)
+    faces = np.array(params['faces']).reshape(-1, 3)
+    lengths = [np.linalg.norm(positions[faces[:, i]] - positions[faces[:, (i + 1) % 3]], axis=1)
+               for i in range(3)]
+    return np.max(lengths)
+
+
+def test01_subdivide_cube(variants_all_rgb):
+    mesh = load_subdivided({ 'type': 'cube' }, levels=1)
+    assert mesh.face_count() == 4 * 12
+    # Every face of the cube has 4 vertices and 5 edges
+    assert mesh.vertex_count() == 6 * (4 + 5)
+
+    # The corners are cut off, the result stays within the control cage
+    positions = np.array(mi.traverse(mesh)['vertex_positions']).reshape(-1, 3)
+    assert np.all(np.abs(positions) <= 1 + 1e-5)
+    assert not np.any(np.all(np.abs(positions) > 1 - 1e-5, axis=1))
+    assert mesh.surface_area()[0] < 24
+
+
+def test02_subdivide_watertight(variants_all_rgb):
+    # Duplicate vertices along the seams of the cube must not tear apart
+    mesh = load_subdivided({ 'type': 'cube' }, levels=2)
+    params = mi.traverse(mesh)
+    positions = np.array(params['vertex_positions']).reshape(-1, 3)
+    faces = np.array(params['faces']).reshape(-1, 3)
+
+    _, weld = np.unique(np.round(positions, 5), axis=0, return_inverse=True)
+    weld = weld.ravel()
+    edges = {}
+    for f in weld[faces]:
+        for i in range(3):
+            key = tuple(sorted((f[i], f[(i + 1) % 3])))
+            edges[key] = edges.get(key, 0) + 1
+    assert all(count == 2 for count in edges.values())
+
+
+def test03_max_edge_length(variants_all_rgb):
+    mesh = load_subdivided({ 'type': 'cube' }, levels=8, max_edge_length=100)
+    assert mesh.face_count() == 12
+
+    mesh = load_subdivided({ 'type': 'cube' }, levels=8, max_edge_length=0.5)
+    assert max_edge_length(mesh) <= 0.5
+    assert mesh.face_count() < 12 * 4**8
+    assert mesh.face_count() in [12 * 4**i for i in range(1, 8)]
+
+
+def test04_subdivide_rectangle(variants_all_rgb):
+    mesh = load_subdivided({
+        'type': 'obj',
+        'filename': 'resources/data/common/meshes/rectangle.obj'
+    }, levels=2)
+    assert mesh.face_count() == 2 * 4**2
+
+    # Boundary edges are creases: the planar cage stays planar
+    params = mi.traverse(mesh)
+    positions = np.array(params['vertex_positions']).reshape(-1, 3)
+    assert np.allclose(positions[:, 2], 0)
+    assert np.all(np.abs(positions[:, :2]) <= 1 + 1e-5)
+
+    if mesh.has_vertex_texcoords():
+        texcoords = np.array(params['vertex_texcoords']).reshape(-1, 2)
+        assert np.all((texcoords >= 0) & (texcoords <= 1))
@@ -2,14 +2,17 @@
 #include <mitsuba/core/fresolver.h>
 #include <mitsuba/core/plugin.h>
 #include <mitsuba/core/properties.h>
+#include <mitsuba/core/rfilter.h>
 #include <mitsuba/core/spectrum.h>
 #include <mitsuba/core/distr_2d.h>
+#include <mitsuba/render/compacttexture.h>
 #include <mitsuba/render/interaction.h>
 #include <mitsuba/render/texture.h>
 #include <mitsuba/render/srgb.h>
 #include <drjit/tensor.h>
 #include <drjit/texture.h>
 #include <mutex>
+#include <unordered_map>
 
 NAMESPACE_BEGIN(mitsuba)
 
@@ -34,9 +37,10 @@ Bitmap texture (:monosp:`bitmap`)
 
  * - data
    - |tensor|
-   - Tensor array containing the texture data. Similarly to the
-     :paramtype:`bitmap` parameter, this field can only be used at runtime. The
-     :paramtype:`raw` parameter must also be set to :monosp:`true`.
+   - Tensor array containing the texture data. It can be specified at runtime,
+     or loaded from a NumPy or tensor file using the ``<tensor>`` tag of the
+     XML scene description. The :paramtype:`raw` parameter must also be set to
+     :monosp:`true`.
    - |exposed|, |differentiable|
 
  * - filter_type
@@ -49,6 +53,29 @@ Bitmap texture (:monosp:`bitmap`)
      - ``nearest``: disable filtering and interpolation. In this mode, the plugin
        performs nearest neighbor lookups of texture values.
 
+     - ``trilinear``: build a MIP map pyramid when loading the texture, and
+       blend bilinear lookups into the two levels whose texel size best
+       matches the screen-space footprint of the query. The footprint is
+       derived from the ray differentials of the surface interaction.
+
+     - ``anisotropic``: like ``trilinear``, but selects the level according to
+       the minor axis of the footprint and averages up to
+       :paramtype:`max_anisotropy` lookups along its major axis. This keeps
+       surfaces seen at grazing angles sharp.
+
+     Interactions without ray differentials (e.g. after the first bounce)
+     always use the finest level.
+
+ * - max_anisotropy
+   - |int|
+   - Maximum number of lookups along the major axis of the footprint when
+     using ``anisotropic`` filtering. (Default: 8)
+
+ * - mipmap_filter
+   - |string|
+   - Reconstruction filter used to downsample the levels of the MIP map
+     pyramid, e.g. ``box``, ``tent`` or ``lanczos``. (Default: ``box``)
+
  * - wrap_mode
    - |string|
    - Controls the behavior of texture evaluations that fall outside of the
@@ -77,10 +104,38 @@ Bitmap texture (:monosp:`bitmap`)
    - |bool|
    - Hardware acceleration features can be used in CUDA mode. These features can
      cause small differences as hardware interpolation methods typically have a
-     loss of precision (not exactly 32-bit arithmetic). (Default: true)
+     loss of precision (not exactly 32-bit arithmetic). This parameter has no
+     effect on compact storage formats. (Default: true)
+
+ * - storage
+   - |string|
+   - Format used to store the texture on the device. The following options are
+     currently available:
+
+     - ``float32`` (default): single precision floating point values.
+
+     - ``float16``: half precision floating point values.
+
+     - ``uint8``: 8 bit integers that are mapped to the range of each channel
+       using a per-channel scale and offset.
+
+     Compact formats halve or quarter the memory footprint and bandwidth of
+     the texture; interpolation still runs in single precision. The texture
+     data is then no longer exposed as a differentiable parameter.
+
+     Block-compressed DDS files (BC6H or BC7) are decoded when the texture is
+     loaded and default to ``float16`` storage, or to ``uint8`` for linear
+     BC7 data that is not converted into spectral coefficients.
+
+ * - max_resolution
+   - |int|
+   - When nonzero, image files whose width or height exceeds this value are
+     downsampled by an integer factor while loading, e.g. to quickly preview
+     scenes with many large textures. JPEG files are directly decoded at a
+     reduced resolution. (Default: 0, i.e. full resolution)
 
 This plugin provides a bitmap texture that performs interpolated lookups given
-a JPEG, PNG, OpenEXR, RGBE, TGA, or BMP input file.
+a JPEG, PNG, OpenEXR, RGBE, TGA, BMP, or DDS (BC6H/BC7) input file.
 
 When loading the plugin, the data is first converted into a usable color representation
 for the renderer:
@@ -116,6 +171,8 @@ template <typename Float, typename Spectrum>
 class BitmapTexture final : public Texture<Float, Spectrum> {
 public:
     MI_IMPORT_TYPES(Texture)
+    using CompactTexture2f = CompactTexture<Float, 2>;
+    using FloatStorage = DynamicBuffer<Float>;
 
     BitmapTexture(const Properties &props) : Texture(props) {
         m_transform = props.get<ScalarTransform3f>("to_uv", ScalarTransform3f());
@@ -124,6 +181,8 @@ public:
 
         ref<Bitmap> bitmap = nullptr;
         TensorXf* tensor = nullptr;
+        fs::path file_path;
+        uint32_t max_resolution = 0;
 
         if (props.has_property("bitmap")) {
             // Creates a Bitmap texture directly from an existing Bitmap object
@@ -139,10 +198,9 @@ public:
         } else if (props.has_property("filename")) {
             // Creates a Bitmap texture by loading an image from the filesystem
             FileResolver* fs = Thread::thread()->file_resolver();
-            fs::path file_path = fs->resolve(props.string("filename"));
+            file_path = fs->resolve(props.string("filename"));
             m_name = file_path.filename().string();
-            Log(Debug, "Loading bitmap texture from \"%s\" ..", m_name);
-            bitmap = new Bitmap(file_path);
+            max_resolution = props.get<uint32_t>("max_resolution", 0);
         } else if (props.has_property("data")) {
             tensor = props.tensor<TensorXf>("data");
             if (tensor->ndim() != 3)
@@ -154,14 +212,22 @@ public:
         }
 
         std::string filter_mode_str = props.string("filter_type", "bilinear");
-        dr::FilterMode filter_mode;
+        dr::FilterMode filter_mode = dr::FilterMode::Linear;
         if (filter_mode_str == "nearest")
             filter_mode = dr::FilterMode::Nearest;
-        else if (filter_mode_str == "bilinear")
-            filter_mode = dr::FilterMode::Linear;
-        else
-            Throw("Invalid filter type \"%s\", must be one of: \"nearest\", or "
-                  "\"bilinear\"!", filter_mode_str);
+        else if (filter_mode_str == "trilinear")
+            m_mipmap_mode = MipmapMode::Trilinear;
+        else if (filter_mode_str == "anisotropic")
+            m_mipmap_mode = MipmapMode::Anisotropic;
+        else if (filter_mode_str != "bilinear")
+            Throw("Invalid filter type \"%s\", must be one of: \"nearest\", "
+                  "\"bilinear\", \"trilinear\", or \"anisotropic\"!",
+                  filter_mode_str);
+
+        m_max_anisotropy = props.get<uint32_t>("max_anisotropy", 8);
+        if (m_max_anisotropy == 0)
+            Throw("The maximum anisotropy must be positive!");
+        std::string mipmap_filter = props.string("mipmap_filter", "box");
 
         std::string wrap_mode_str = props.string("wrap_mode", "repeat");
         typename dr::WrapMode wrap_mode;
@@ -180,152 +246,227 @@ public:
         m_raw = props.get<bool>("raw", false);
         m_accel = props.get<bool>("accel", true);
 
-        if (tensor) {
-            Log(Debug, "Loading bitmap texture from tensor...");
-            if (!m_raw)
-                Throw("Bitmap \"raw\" parameter must be `true` when "
-                      "initializing using tensor data! Use a `Bitmap` "
-                      "object or a file if transformation of color data is "
-                      "required.");
-            m_texture = Texture2f(TensorXf(*tensor), m_accel, m_accel, filter_mode, wrap_mode);
-            const size_t pixel_count = tensor->shape(1) * tensor->shape(0);
-            const size_t ch_count = tensor->shape(2);
-
-            if (ch_count == 3) {
-                if constexpr (dr::is_dynamic_v<Float>)
-                    m_mean = dr::sum(luminance(dr::unravel<Color3f>(tensor->array()))) / pixel_count;
-                else {
-                    const size_t pixel_count = tensor->shape(0) * tensor->shape(1);
-                    double mean = 0.0;
-                    ScalarFloat* ptr = tensor->data();
-                    for (size_t i = 0; i < pixel_count; ++i) {
-                        ScalarColor3f value = dr::load<ScalarColor3f>(ptr);
-                        mean += (double) luminance(value);
-                        ptr += 3;
-                    }
-                    m_mean = (ScalarFloat)(mean / pixel_count);
-                }
-            }
-            else
-                m_mean = dr::sum(tensor->array()) / pixel_count;
+        std::string storage_str = props.string("storage", "");
+        if (is_mipmapped()) {
+            using ReconstructionFilter = Bitmap::ReconstructionFilter;
+            m_mipmap_filter =
+                PluginManager::instance()->create_object<ReconstructionFilter>(
+                    Properties(mipmap_filter));
+        }
 
+        if (!file_path.empty()) {
+            /* Instances that load the same file with the same options share
+               their texture data (and sampling distribution) */
+            std::string key = tfm::format(
+                "%s|%i|%s|%s|%s|%s|%i|%i|%u", file_path.string(),
+                fs::last_write_time(file_path), filter_mode_str, wrap_mode_str,
+                storage_str, mipmap_filter, (int) m_raw, (int) m_accel,
+                max_resolution);
+            m_data = shared_data(key);
         } else {
-            /* Convert to linear RGB float bitmap, will be converted
-               into spectral profile coefficients below (in place) */
-            Bitmap::PixelFormat pixel_format = bitmap->pixel_format();
-            switch (pixel_format) {
-                case Bitmap::PixelFormat::Y:
-                case Bitmap::PixelFormat::YA:
-                    pixel_format = Bitmap::PixelFormat::Y;
-                    break;
-
-                case Bitmap::PixelFormat::RGB:
-                case Bitmap::PixelFormat::RGBA:
-                case Bitmap::PixelFormat::XYZ:
-                case Bitmap::PixelFormat::XYZA:
-                    pixel_format = Bitmap::PixelFormat::RGB;
-                    break;
+            m_data = std::make_shared<BitmapData>();
+        }
 
-                default:
-                    Throw("The texture needs to have a known pixel "
-                          "format (Y[A], RGB[A], XYZ[A] are supported).");
+        /* Only the first instance loads the data, the others wait for it
+           to complete */
+        std::call_once(m_data->loaded, [&]() {
+            if (!file_path.empty()) {
+                Log(Debug, "Loading bitmap texture from \"%s\" ..", m_name);
+                bitmap = new Bitmap(file_path, Bitmap::FileFormat::Auto,
+                                    max_resolution);
             }
 
-            if (m_raw) {
-                /* Don't undo gamma correction in the conversion below.
-                   This is needed, e.g., for normal maps. */
-                bitmap->set_srgb_gamma(false);
+            /* Textures that were block-compressed on disk (BC6H/BC7) default to
+               a compact storage format, since their precision is limited anyway */
+            std::string storage = "float32";
+            if (bitmap && bitmap->metadata().has_property("block_compression") &&
+                !is_mipmapped()) {
+                bool srgb = bitmap->srgb_gamma() && !m_raw;
+                storage = (bitmap->component_format() == Struct::Type::UInt8 &&
+                           !srgb && (m_raw || !is_spectral_v<Spectrum>))
+                              ? "uint8" : "float16";
             }
+            m_storage = texture_storage(storage_str.empty() ? storage : storage_str);
+            m_data->storage = m_storage;
+
+            if (is_mipmapped() && is_compact())
+                Throw("MIP-mapped filtering requires the \"float32\" storage "
+                      "format!");
+
+            if (tensor) {
+                Log(Debug, "Loading bitmap texture from tensor...");
+                if (!m_raw)
+                    Throw("Bitmap \"raw\" parameter must be `true` when "
+                          "initializing using tensor data! Use a `Bitmap` "
+                          "object or a file if transformation of color data is "
+                          "required.");
+                if (is_compact()) {
+                    auto &&data = dr::migrate(tensor->array(), AllocType::Host);
+                    if constexpr (dr::is_jit_v<Float>)
+                        dr::sync_thread();
+                    const size_t shape[3] = { tensor->shape(0), tensor->shape(1),
+                                              tensor->shape(2) };
+                    init_texture(data.data(), shape, filter_mode, wrap_mode);
+                } else {
+                    m_data->texture = Texture2f(TensorXf(*tensor), m_accel,
+                                                m_accel, filter_mode, wrap_mode);
+                    if (is_mipmapped())
+                        build_mipmap(m_data->texture.value(), false);
+                }
+                const size_t pixel_count = tensor->shape(1) * tensor->shape(0);
+                const size_t ch_count = tensor->shape(2);
+
+                if (ch_count == 3) {
+                    if constexpr (dr::is_dynamic_v<Float>)
+                        m_data->mean = dr::sum(luminance(dr::unravel<Color3f>(tensor->array()))) / pixel_count;
+                    else {
+                        const size_t pixel_count = tensor->shape(0) * tensor->shape(1);
+                        double mean = 0.0;
+                        ScalarFloat* ptr = tensor->data();
+                        for (size_t i = 0; i < pixel_count; ++i) {
+                            ScalarColor3f value = dr::load<ScalarColor3f>(ptr);
+                            mean += (double) luminance(value);
+                            ptr += 3;
+                        }
+                        m_data->mean = (ScalarFloat)(mean / pixel_count);
+                    }
+                }
+                else
+                    m_data->mean = dr::sum(tensor->array()) / pixel_count;
 
-            // Convert the image into the working floating point representation
-            bitmap =
-                bitmap->convert(pixel_format, struct_type_v<ScalarFloat>, false);
-
-            if (dr::any(bitmap->size() < 2)) {
-                Log(Warn,
-                    "Image must be at least 2x2 pixels in size, up-sampling..");
-                using ReconstructionFilter = Bitmap::ReconstructionFilter;
-                ref<ReconstructionFilter> rfilter =
-                    PluginManager::instance()->create_object<ReconstructionFilter>(
-                        Properties("tent"));
-                bitmap =
-                    bitmap->resample(dr::maximum(bitmap->size(), 2), rfilter);
-            }
+            } else {
+                /* Convert to linear RGB float bitmap, will be converted
+                   into spectral profile coefficients below (in place) */
+                Bitmap::PixelFormat pixel_format = bitmap->pixel_format();
+                switch (pixel_format) {
+                    case Bitmap::PixelFormat::Y:
+                    case Bitmap::PixelFormat::YA:
+                        pixel_format = Bitmap::PixelFormat::Y;
+                        break;
+
+                    case Bitmap::PixelFormat::RGB:
+                    case Bitmap::PixelFormat::RGBA:
+                    case Bitmap::PixelFormat::XYZ:
+                    case Bitmap::PixelFormat::XYZA:
+                        pixel_format = Bitmap::PixelFormat::RGB;
+                        break;
+
+                    default:
+                        Throw("The texture needs to have a known pixel "
+                              "format (Y[A], RGB[A], XYZ[A] are supported).");
+                }
 
-            ScalarFloat *ptr = (ScalarFloat *) bitmap->data();
-            size_t pixel_count = bitmap->pixel_count();
-            bool exceed_unit_range = false;
+                if (m_raw) {
+                    /* Don't undo gamma correction in the conversion below.
+                       This is needed, e.g., for normal maps. */
+                    bitmap->set_srgb_gamma(false);
+                }
 
-            double mean = 0.0;
-            if (bitmap->channel_count() == 3) {
-                if (is_spectral_v<Spectrum> && !m_raw) {
-                    for (size_t i = 0; i < pixel_count; ++i) {
-                        ScalarColor3f value = dr::load<ScalarColor3f>(ptr);
-                        if (!all(value >= 0 && value <= 1))
-                            exceed_unit_range = true;
-                        value = srgb_model_fetch(value);
-                        mean += (double) srgb_model_mean(value);
-                        dr::store(ptr, value);
-                        ptr += 3;
+                // Convert the image into the working floating point representation
+                bitmap =
+                    bitmap->convert(pixel_format, struct_type_v<ScalarFloat>, false);
+
+                if (dr::any(bitmap->size() < 2)) {
+                    Log(Warn,
+                        "Image must be at least 2x2 pixels in size, up-sampling..");
+                    using ReconstructionFilter = Bitmap::ReconstructionFilter;
+                    ref<ReconstructionFilter> rfilter =
+                        PluginManager::instance()->create_object<ReconstructionFilter>(
+                            Properties("tent"));
+                    bitmap =
+                        bitmap->resample(dr::maximum(bitmap->size(), 2), rfilter);
+                }
+
+                /* Downsample the linear values, i.e. before a potential
+                   conversion into spectral coefficients */
+                if (is_mipmapped())
+                    build_mipmap(bitmap, is_spectral_v<Spectrum> && !m_raw, wrap_mode);
+
+                ScalarFloat *ptr = (ScalarFloat *) bitmap->data();
+                size_t pixel_count = bitmap->pixel_count();
+                bool exceed_unit_range = false;
+
+                double mean = 0.0;
+                if (bitmap->channel_count() == 3) {
+                    if (is_spectral_v<Spectrum> && !m_raw) {
+                        for (size_t i = 0; i < pixel_count * 3; ++i) {
+                            if (!(ptr[i] >= 0 && ptr[i] <= 1)) {
+                                exceed_unit_range = true;
+                                break;
+                            }
+                        }
+                        // Batched (parallel and vectorized) conversion
+                        srgb_model_fetch(ptr, pixel_count, 3, &mean);
+                        mean *= (double) pixel_count;
+                    } else {
+                        for (size_t i = 0; i < pixel_count; ++i) {
+                            ScalarColor3f value = dr::load<ScalarColor3f>(ptr);
+                            if (!all(value >= 0 && value <= 1))
+                                exceed_unit_range = true;
+                            mean += (double) luminance(value);
+                            ptr += 3;
+                        }
                     }
-                } else {
+                } else if (bitmap->channel_count() == 1) {
                     for (size_t i = 0; i < pixel_count; ++i) {
-                        ScalarColor3f value = dr::load<ScalarColor3f>(ptr);
-                        if (!all(value >= 0 && value <= 1))
+                        ScalarFloat value = ptr[i];
+                        if (!(value >= 0 && value <= 1))
                             exceed_unit_range = true;
-                        mean += (double) luminance(value);
-                        ptr += 3;
+                        mean += (double) value;
                     }
+                } else {
+                    Throw("Unsupported channel count: %d (expected 1 or 3)",
+                          bitmap->channel_count());
                 }
-            } else if (bitmap->channel_count() == 1) {
-                for (size_t i = 0; i < pixel_count; ++i) {
-                    ScalarFloat value = ptr[i];
-                    if (!(value >= 0 && value <= 1))
-                        exceed_unit_range = true;
-                    mean += (double) value;
-                }
-            } else {
-                Throw("Unsupported channel count: %d (expected 1 or 3)",
-                      bitmap->channel_count());
-            }
 
-            if (exceed_unit_range && !m_raw)
-                Log(Warn,
-                    "BitmapTexture: texture named \"%s\" contains pixels that "
-                    "exceed the [0, 1] range!",
-                    m_name);
+                if (exceed_unit_range && !m_raw)
+                    Log(Warn,
+                        "BitmapTexture: texture named \"%s\" contains pixels that "
+                        "exceed the [0, 1] range!",
+                        m_name);
 
-            m_mean = Float(mean / pixel_count);
+                m_data->mean = Float(mean / pixel_count);
 
-            size_t channels = bitmap->channel_count();
-            ScalarVector2i res = ScalarVector2i(bitmap->size());
-            size_t shape[3] = { (size_t) res.y(), (size_t) res.x(), channels };
-            m_texture = Texture2f(TensorXf(bitmap->data(), 3, shape), m_accel,
-                                  m_accel, filter_mode, wrap_mode);
-        }
+                size_t channels = bitmap->channel_count();
+                ScalarVector2i res = ScalarVector2i(bitmap->size());
+                size_t shape[3] = { (size_t) res.y(), (size_t) res.x(), channels };
+                init_texture((const ScalarFloat *) bitmap->data(), shape,
+                             filter_mode, wrap_mode);
+            }
+        });
+        m_storage = m_data->storage;
     }
 
     void traverse(TraversalCallback *callback) override {
-        callback->put_parameter("data",  m_texture.tensor(), +ParamFlags::Differentiable);
+        /* The texture data may be modified through the traversal, hence it
+           must no longer be shared with other instances */
+        detach();
+        if (!is_compact())
+            callback->put_parameter("data",  m_data->texture.tensor(), +ParamFlags::Differentiable);
         callback->put_parameter("to_uv", m_transform,        +ParamFlags::NonDifferentiable);
     }
 
     void
     parameters_changed(const std::vector<std::string> &keys = {}) override {
-        if (keys.empty() || string::contains(keys, "data")) {
-            const size_t channels = m_texture.shape()[2];
+        // The compact representation is immutable and not exposed
+        if (!is_compact() && (keys.empty() || string::contains(keys, "data"))) {
+            const size_t channels = texture_shape()[2];
             if (channels != 1 && channels != 3)
                 Throw("parameters_changed(): The bitmap texture %s was changed "
                       "to have %d channels, only textures with 1 or 3 channels "
                       "are supported!",
                       to_string(), channels);
-            else if (m_texture.shape()[0] < 2 || m_texture.shape()[1] < 2)
+            else if (m_data->texture.shape()[0] < 2 || m_data->texture.shape()[1] < 2)
                 Throw("parameters_changed(): The bitmap texture %s was changed,"
                       " it must be at least 2x2 pixels in size!",
                       to_string());
 
-            m_texture.set_tensor(m_texture.tensor());
-            rebuild_internals(true, m_distr2d != nullptr);
+            m_data->texture.set_tensor(m_data->texture.tensor());
+            /* Note: with spectral upsampling, the data consists of spectral
+               coefficients, which are then downsampled directly */
+            if (is_mipmapped())
+                build_mipmap(m_data->texture.value(), false);
+            rebuild_internals(true, m_data->distr2d != nullptr);
         }
     }
 
@@ -333,7 +474,7 @@ public:
                              Mask active) const override {
         MI_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
 
-        const size_t channels = m_texture.shape()[2];
+        const size_t channels = texture_shape()[2];
         if (channels == 3 && is_spectral_v<Spectrum> && m_raw) {
             DRJIT_MARK_USED(si);
             Throw("The bitmap texture %s was queried for a spectrum, but "
@@ -367,7 +508,7 @@ public:
                  Mask active = true) const override {
         MI_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
 
-        const size_t channels = m_texture.shape()[2];
+        const size_t channels = texture_shape()[2];
         if (channels == 3 && is_spectral_v<Spectrum> && !m_raw) {
             DRJIT_MARK_USED(si);
             Throw("eval_1(): The bitmap texture %s was queried for a "
@@ -389,7 +530,7 @@ public:
                          Mask active = true) const override {
         MI_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
 
-        const size_t channels = m_texture.shape()[2];
+        const size_t channels = texture_shape()[2];
         if (channels == 3 && is_spectral_v<Spectrum> && !m_raw) {
             DRJIT_MARK_USED(si);
             Throw(
@@ -401,7 +542,7 @@ public:
             if (dr::none_or<false>(active))
                 return dr::zeros<Vector2f>();
 
-            if (m_texture.filter_mode() == dr::FilterMode::Linear) {
+            if (filter_mode() == dr::FilterMode::Linear) {
                 if constexpr (!dr::is_array_v<Mask>)
                     active = true;
 
@@ -415,10 +556,7 @@ public:
                     fetch_values[2] = &f01;
                     fetch_values[3] = &f11;
 
-                    if (m_accel)
-                        m_texture.eval_fetch(uv, fetch_values, active);
-                    else
-                        m_texture.eval_fetch_nonaccel(uv, fetch_values, active);
+                    eval_fetch_texture(uv, fetch_values, active);
                 } else { // 3 channels
                     Color3f v00, v10, v01, v11;
                     dr::Array<Float *, 4> fetch_values;
@@ -427,10 +565,7 @@ public:
                     fetch_values[2] = v01.data();
                     fetch_values[3] = v11.data();
 
-                    if (m_accel)
-                        m_texture.eval_fetch(uv, fetch_values, active);
-                    else
-                        m_texture.eval_fetch_nonaccel(uv, fetch_values, active);
+                    eval_fetch_texture(uv, fetch_values, active);
 
                     f00 = luminance(v00);
                     f10 = luminance(v10);
@@ -468,7 +603,7 @@ public:
                    Mask active = true) const override {
         MI_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
 
-        const size_t channels = m_texture.shape()[2];
+        const size_t channels = texture_shape()[2];
         if (channels != 3) {
             DRJIT_MARK_USED(si);
             Throw("eval_3(): The bitmap texture %s was queried for a RGB "
@@ -493,21 +628,21 @@ public:
         if (dr::none_or<false>(active))
             return { dr::zeros<Point2f>(), dr::zeros<Float>() };
 
-        if (!m_distr2d)
+        if (!m_data->distr2d)
             init_distr();
 
-        auto [pos, pdf, sample2] = m_distr2d->sample(sample, active);
+        auto [pos, pdf, sample2] = m_data->distr2d->sample(sample, active);
 
         ScalarVector2i res = resolution();
         ScalarVector2f inv_resolution = dr::rcp(ScalarVector2f(res));
 
-        if (m_texture.filter_mode() == dr::FilterMode::Nearest) {
+        if (filter_mode() == dr::FilterMode::Nearest) {
             sample2 = (Point2f(pos) + sample2) * inv_resolution;
         } else {
             sample2 = (Point2f(pos) + 0.5f + warp::square_to_tent(sample2)) *
                       inv_resolution;
 
-            switch (m_texture.wrap_mode()) {
+            switch (wrap_mode()) {
                 case dr::WrapMode::Repeat:
                     sample2[sample2 < 0.f] += 1.f;
                     sample2[sample2 > 1.f] -= 1.f;
@@ -532,11 +667,11 @@ public:
         if (dr::none_or<false>(active))
             return dr::zeros<Float>();
 
-        if (!m_distr2d)
+        if (!m_data->distr2d)
             init_distr();
 
         ScalarVector2i res = resolution();
-        if (m_texture.filter_mode() == dr::FilterMode::Linear) {
+        if (filter_mode() == dr::FilterMode::Linear) {
             // Scale to bitmap resolution and apply shift
             Point2f uv = dr::fmadd(pos_, res, -.5f);
 
@@ -547,13 +682,13 @@ public:
             Point2f w1 = uv - Point2f(uv_i),
                     w0 = 1.f - w1;
 
-            Float v00 = m_distr2d->pdf(m_texture.wrap(uv_i + Point2i(0, 0)),
+            Float v00 = m_data->distr2d->pdf(wrap(uv_i + Point2i(0, 0)),
                                        active),
-                  v10 = m_distr2d->pdf(m_texture.wrap(uv_i + Point2i(1, 0)),
+                  v10 = m_data->distr2d->pdf(wrap(uv_i + Point2i(1, 0)),
                                        active),
-                  v01 = m_distr2d->pdf(m_texture.wrap(uv_i + Point2i(0, 1)),
+                  v01 = m_data->distr2d->pdf(wrap(uv_i + Point2i(0, 1)),
                                        active),
-                  v11 = m_distr2d->pdf(m_texture.wrap(uv_i + Point2i(1, 1)),
+                  v11 = m_data->distr2d->pdf(wrap(uv_i + Point2i(1, 1)),
                                        active);
 
             Float v0 = dr::fmadd(w0.x(), v00, w1.x() * v10),
@@ -565,9 +700,9 @@ public:
             Point2f uv = pos_ * res;
 
             // Integer pixel positions for nearest-neighbor interpolation
-            Vector2i uv_i = m_texture.wrap(dr::floor2int<Vector2i>(uv));
+            Vector2i uv_i = wrap(dr::floor2int<Vector2i>(uv));
 
-            return m_distr2d->pdf(uv_i, active) * dr::prod(res);
+            return m_data->distr2d->pdf(uv_i, active) * dr::prod(res);
         }
     }
 
@@ -592,21 +727,25 @@ public:
     }
 
     ScalarVector2i resolution() const override {
-        const size_t *shape = m_texture.shape();
+        const size_t *shape = texture_shape();
         return { (int) shape[1], (int) shape[0] };
     }
 
-    Float mean() const override { return m_mean; }
+    Float mean() const override { return m_data->mean; }
 
     bool is_spatially_varying() const override { return true; }
 
+    bool needs_differentials() const override { return is_mipmapped(); }
+
     std::string to_string() const override {
         std::ostringstream oss;
         oss << "BitmapTexture[" << std::endl
             << "  name = \"" << m_name << "\"," << std::endl
             << "  resolution = \"" << resolution() << "\"," << std::endl
             << "  raw = " << (int) m_raw << "," << std::endl
-            << "  mean = " << m_mean << "," << std::endl
+            << "  storage = " << m_storage << "," << std::endl
+            << "  mipmap_levels = " << (m_data->mipmap.size() + 1) << "," << std::endl
+            << "  mean = " << m_data->mean << "," << std::endl
             << "  transform = " << string::indent(m_transform) << std::endl
             << "]";
         return oss.str();
@@ -626,47 +765,59 @@ protected:
 
         Point2f uv = m_transform.transform_affine(si.uv);
 
-        if (m_texture.filter_mode() == dr::FilterMode::Linear) {
-            Color3f v00, v10, v01, v11;
-            dr::Array<Float *, 4> fetch_values;
-            fetch_values[0] = v00.data();
-            fetch_values[1] = v10.data();
-            fetch_values[2] = v01.data();
-            fetch_values[3] = v11.data();
-
-            if (m_accel)
-                m_texture.eval_fetch(uv, fetch_values, active);
-            else
-                m_texture.eval_fetch_nonaccel(uv, fetch_values, active);
-
-            UnpolarizedSpectrum c00, c10, c01, c11, c0, c1;
-            c00 = srgb_model_eval<UnpolarizedSpectrum>(v00, si.wavelengths);
-            c10 = srgb_model_eval<UnpolarizedSpectrum>(v10, si.wavelengths);
-            c01 = srgb_model_eval<UnpolarizedSpectrum>(v01, si.wavelengths);
-            c11 = srgb_model_eval<UnpolarizedSpectrum>(v11, si.wavelengths);
-
-            ScalarVector2i res = resolution();
-            uv = dr::fmadd(uv, res, -.5f);
-            Vector2i uv_i = dr::floor2int<Vector2i>(uv);
-
-            // Interpolation weights
-            Point2f w1 = uv - Point2f(uv_i), w0 = 1.f - w1;
-
-            c0 = dr::fmadd(w0.x(), c00, w1.x() * c10);
-            c1 = dr::fmadd(w0.x(), c01, w1.x() * c11);
-
-            return dr::fmadd(w0.y(), c0, w1.y() * c1);
+        if (is_mipmapped()) {
+            return eval_mipmap<UnpolarizedSpectrum>(
+                si, uv, active,
+                [&](size_t level, const Point2f &uv_l, Mask active_l) {
+                    return interpolate_spectral_level(level, uv_l,
+                                                      si.wavelengths, active_l);
+                });
+        } else if (filter_mode() == dr::FilterMode::Linear) {
+            return interpolate_spectral_level(0, uv, si.wavelengths, active);
         } else {
             Color3f out;
-            if (m_accel)
-                m_texture.eval(uv, out.data(), active);
-            else
-                m_texture.eval_nonaccel(uv, out.data(), active);
+            eval_texture(uv, out.data(), active);
 
             return srgb_model_eval<UnpolarizedSpectrum>(out, si.wavelengths);
         }
     }
 
+    /**
+     * \brief Bilinearly interpolates the spectra reconstructed at the four
+     * texels surrounding a UV position of the given MIP map level
+     */
+    MI_INLINE UnpolarizedSpectrum
+    interpolate_spectral_level(size_t level, const Point2f &uv_,
+                               const Wavelength &wavelengths,
+                               Mask active) const {
+        Color3f v00, v10, v01, v11;
+        dr::Array<Float *, 4> fetch_values;
+        fetch_values[0] = v00.data();
+        fetch_values[1] = v10.data();
+        fetch_values[2] = v01.data();
+        fetch_values[3] = v11.data();
+
+        eval_fetch_level(level, uv_, fetch_values, active);
+
+        UnpolarizedSpectrum c00, c10, c01, c11, c0, c1;
+        c00 = srgb_model_eval<UnpolarizedSpectrum>(v00, wavelengths);
+        c10 = srgb_model_eval<UnpolarizedSpectrum>(v10, wavelengths);
+        c01 = srgb_model_eval<UnpolarizedSpectrum>(v01, wavelengths);
+        c11 = srgb_model_eval<UnpolarizedSpectrum>(v11, wavelengths);
+
+        ScalarVector2i res = level_resolution(level);
+        Point2f uv = dr::fmadd(uv_, res, -.5f);
+        Vector2i uv_i = dr::floor2int<Vector2i>(uv);
+
+        // Interpolation weights
+        Point2f w1 = uv - Point2f(uv_i), w0 = 1.f - w1;
+
+        c0 = dr::fmadd(w0.x(), c00, w1.x() * c10);
+        c1 = dr::fmadd(w0.x(), c01, w1.x() * c11);
+
+        return dr::fmadd(w0.y(), c0, w1.y() * c1);
+    }
+
     /**
      * \brief Evaluates the texture at the given surface interaction
      *
@@ -679,11 +830,17 @@ protected:
 
         Point2f uv = m_transform.transform_affine(si.uv);
 
+        if (is_mipmapped())
+            return eval_mipmap<Float>(
+                si, uv, active,
+                [&](size_t level, const Point2f &uv_l, Mask active_l) {
+                    Float out;
+                    eval_level(level, uv_l, &out, active_l);
+                    return out;
+                });
+
         Float out;
-        if (m_accel)
-            m_texture.eval(uv, &out, active);
-        else
-            m_texture.eval_nonaccel(uv, &out, active);
+        eval_texture(uv, &out, active);
 
         return out;
     }
@@ -700,35 +857,115 @@ protected:
 
         Point2f uv = m_transform.transform_affine(si.uv);
 
+        if (is_mipmapped())
+            return eval_mipmap<Color3f>(
+                si, uv, active,
+                [&](size_t level, const Point2f &uv_l, Mask active_l) {
+                    Color3f out;
+                    eval_level(level, uv_l, out.data(), active_l);
+                    return out;
+                });
+
         Color3f out;
-        if (m_accel)
-            m_texture.eval(uv, out.data(), active);
-        else
-            m_texture.eval_nonaccel(uv, out.data(), active);
+        eval_texture(uv, out.data(), active);
 
         return out;
     }
 
+    /**
+     * \brief Filters the texture over the screen-space footprint of a
+     * surface interaction using the MIP map pyramid
+     *
+     * \param uv
+     *     Transformed UV coordinates of the interaction
+     *
+     * \param lookup
+     *     Callable <tt>lookup(level, uv, active)</tt> that bilinearly
+     *     interpolates a single level of the pyramid
+     */
+    template <typename Value, typename Lookup>
+    MI_INLINE Value eval_mipmap(const SurfaceInteraction3f &si,
+                                const Point2f &uv, Mask active,
+                                const Lookup &lookup) const {
+        // Footprint axes in texels of the finest level
+        ScalarVector2f res = ScalarVector2f(resolution());
+        Vector2f dx = m_transform.transform_affine(si.duv_dx) * res,
+                 dy = m_transform.transform_affine(si.duv_dy) * res;
+        Float len_x = dr::norm(dx), len_y = dr::norm(dy),
+              major = dr::maximum(len_x, len_y),
+              minor = dr::minimum(len_x, len_y);
+
+        Float count = 1.f, width = major;
+        Vector2f axis = 0.f;
+        uint32_t probes = 1;
+        if (m_mipmap_mode == MipmapMode::Anisotropic) {
+            // Subdivide the major axis into (at most) square footprints
+            count = dr::clamp(dr::ceil(major / dr::maximum(minor, 1e-8f)), 1.f,
+                              (ScalarFloat) m_max_anisotropy);
+            width = major / count;
+            axis  = dr::select(len_x > len_y, dx, dy) / res;
+            probes = m_max_anisotropy;
+        }
+
+        // Level of detail whose texels match the width of the footprint
+        const ScalarFloat max_level = (ScalarFloat) m_data->mipmap.size();
+        Float lod = dr::clamp(dr::log2(dr::maximum(width, 1e-8f)), 0.f, max_level);
+        Int32 level_0 = dr::floor2int<Int32>(lod);
+        Float weight_1 = lod - Float(level_0);
+
+        Value result = dr::zeros<Value>();
+        for (uint32_t i = 0; i < probes; ++i) {
+            Mask active_p = active && Float(i) < count;
+            if (i > 0 && dr::none_or<false>(active_p))
+                break;
+
+            Point2f uv_p = uv;
+            if (m_mipmap_mode == MipmapMode::Anisotropic)
+                uv_p = dr::fmadd(axis, (Float(i) + .5f) / count - .5f, uv);
+
+            for (size_t level = 0; level <= m_data->mipmap.size(); ++level) {
+                Int32 l = Int32((int32_t) level);
+                Float weight = dr::select(dr::eq(level_0, l), 1.f - weight_1,
+                               dr::select(dr::eq(level_0 + 1, l), weight_1, 0.f));
+                Mask active_l = active_p && weight > 0.f;
+                if (dr::none_or<false>(active_l))
+                    continue;
+                result += dr::select(active_l, lookup(level, uv_p, active_l) * weight,
+                                     dr::zeros<Value>());
+            }
+        }
+
+        return result / count;
+    }
+
     /**
      * \brief Recompute mean and 2D sampling distribution (if requested)
      * following an update
      */
     void rebuild_internals(bool init_mean, bool init_distr) {
-        auto&& data = dr::migrate(m_texture.value(), AllocType::Host);
+        FloatStorage data;
+        std::vector<ScalarFloat> compact_values;
+        const ScalarFloat *ptr = nullptr;
+        if (is_compact()) {
+            compact_values = m_data->compact_texture.host_values();
+            ptr = compact_values.data();
+        } else {
+            data = dr::migrate(m_data->texture.value(), AllocType::Host);
 
-        if constexpr (dr::is_jit_v<Float>)
-            dr::sync_thread();
+            if constexpr (dr::is_jit_v<Float>)
+                dr::sync_thread();
+
+            ptr = data.data();
+        }
 
         if (m_transform != ScalarTransform3f())
             dr::make_opaque(m_transform);
 
-        const ScalarFloat *ptr = data.data();
-
         double mean = 0.0;
         size_t pixel_count = (size_t) dr::prod(resolution());
         bool exceed_unit_range = false;
 
-        const size_t channels = m_texture.shape()[2];
+        const size_t channels = texture_shape()[2];
         if (channels == 3) {
             std::unique_ptr<ScalarFloat[]> importance_map(
                 init_distr ? new ScalarFloat[pixel_count] : nullptr);
@@ -750,7 +987,7 @@ protected:
             }
 
             if (init_distr)
-                m_distr2d = std::make_unique<DiscreteDistribution2D<Float>>(
+                m_data->distr2d = std::make_unique<DiscreteDistribution2D<Float>>(
                     importance_map.get(), resolution());
         } else {
             for (size_t i = 0; i < pixel_count; ++i) {
@@ -761,12 +998,12 @@ protected:
             }
 
             if (init_distr)
-                m_distr2d = std::make_unique<DiscreteDistribution2D<Float>>(
+                m_data->distr2d = std::make_unique<DiscreteDistribution2D<Float>>(
                     ptr, resolution());
         }
 
         if (init_mean)
-            m_mean = dr::opaque<Float>(ScalarFloat(mean / pixel_count));
+            m_data->mean = dr::opaque<Float>(ScalarFloat(mean / pixel_count));
 
         if (exceed_unit_range && !m_raw)
             Log(Warn,
@@ -775,26 +1012,247 @@ protected:
                 m_name);
     }
 
+    /// Evaluate the texture at the given UV position
+    MI_INLINE void eval_texture(const Point2f &uv, Float *out,
+                                Mask active) const {
+        if (is_compact())
+            m_data->compact_texture.eval(uv, out, active);
+        else if (m_accel)
+            m_data->texture.eval(uv, out, active);
+        else
+            m_data->texture.eval_nonaccel(uv, out, active);
+    }
+
+    /// Fetch the bilinear interpolation stencil around the given UV position
+    MI_INLINE void eval_fetch_texture(const Point2f &uv,
+                                      dr::Array<Float *, 4> &out,
+                                      Mask active) const {
+        if (is_compact())
+            m_data->compact_texture.eval_fetch(uv, out, active);
+        else if (m_accel)
+            m_data->texture.eval_fetch(uv, out, active);
+        else
+            m_data->texture.eval_fetch_nonaccel(uv, out, active);
+    }
+
+    /// Bilinearly interpolate the given level of the MIP map pyramid
+    MI_INLINE void eval_level(size_t level, const Point2f &uv, Float *out,
+                              Mask active) const {
+        if (level == 0)
+            eval_texture(uv, out, active);
+        else if (m_accel)
+            m_data->mipmap[level - 1].eval(uv, out, active);
+        else
+            m_data->mipmap[level - 1].eval_nonaccel(uv, out, active);
+    }
+
+    /// Fetch the bilinear interpolation stencil of the given MIP map level
+    MI_INLINE void eval_fetch_level(size_t level, const Point2f &uv,
+                                    dr::Array<Float *, 4> &out,
+                                    Mask active) const {
+        if (level == 0)
+            eval_fetch_texture(uv, out, active);
+        else if (m_accel)
+            m_data->mipmap[level - 1].eval_fetch(uv, out, active);
+        else
+            m_data->mipmap[level - 1].eval_fetch_nonaccel(uv, out, active);
+    }
+
+    /// Resolution of the given MIP map level
+    ScalarVector2i level_resolution(size_t level) const {
+        if (level == 0)
+            return resolution();
+        const size_t *shape = m_data->mipmap[level - 1].shape();
+        return { (int) shape[1], (int) shape[0] };
+    }
+
+    MI_INLINE const size_t *texture_shape() const {
+        return is_compact() ? m_data->compact_texture.shape() : m_data->texture.shape();
+    }
+
+    MI_INLINE dr::FilterMode filter_mode() const {
+        return is_compact() ? m_data->compact_texture.filter_mode() : m_data->texture.filter_mode();
+    }
+
+    MI_INLINE dr::WrapMode wrap_mode() const {
+        return is_compact() ? m_data->compact_texture.wrap_mode() : m_data->texture.wrap_mode();
+    }
+
+    /// Apply the wrap mode to integer pixel coordinates
+    template <typename T>
+    MI_INLINE dr::Array<Int32, 2> wrap(const T &pos) const {
+        if (is_compact())
+            return m_data->compact_texture.wrap(pos);
+        return m_data->texture.wrap(pos);
+    }
+
+    /// Is the texture kept in a compact storage format?
+    MI_INLINE bool is_compact() const {
+        return m_storage != TextureStorage::Float32;
+    }
+
+    /// Does the texture filter lookups using a MIP map pyramid?
+    MI_INLINE bool is_mipmapped() const {
+        return m_mipmap_mode != MipmapMode::None;
+    }
+
+    /**
+     * \brief Build the coarser levels of the MIP map pyramid from a linear
+     * bitmap of the finest level
+     *
+     * Every level halves the resolution of the previous one, down to 2x2
+     * texels. When \c to_spectral is set, the downsampled RGB values are
+     * converted into spectral coefficients afterwards. The wrap mode of the
+     * texture determines the boundary conditions of the downsampling filter.
+     */
+    void build_mipmap(const Bitmap *bitmap, bool to_spectral,
+                      dr::WrapMode wrap_mode) {
+        FilterBoundaryCondition bc;
+        switch (wrap_mode) {
+            case dr::WrapMode::Repeat: bc = FilterBoundaryCondition::Repeat; break;
+            case dr::WrapMode::Mirror: bc = FilterBoundaryCondition::Mirror; break;
+            default:                   bc = FilterBoundaryCondition::Clamp; break;
+        }
+        // Don't let negative filter lobes produce negative colors
+        std::pair<float, float> bound = { m_raw ? -dr::Infinity<float> : 0.f,
+                                          dr::Infinity<float> };
+
+        m_data->mipmap.clear();
+        ref<const Bitmap> level = bitmap;
+        ScalarVector2u res = level->size();
+        while (dr::any(res > 2u)) {
+            res = dr::maximum(res / 2u, 2u);
+            ref<Bitmap> next = level->resample(res, m_mipmap_filter.get(),
+                                               { bc, bc }, bound);
+            level = next;
+
+            size_t channels = next->channel_count();
+            if (to_spectral && channels == 3)
+                srgb_model_fetch((ScalarFloat *) next->data(),
+                                 next->pixel_count());
+
+            size_t shape[3] = { (size_t) res.y(), (size_t) res.x(), channels };
+            m_data->mipmap.emplace_back(
+                TensorXf((const ScalarFloat *) next->data(), 3, shape), m_accel,
+                m_accel, dr::FilterMode::Linear, wrap_mode);
+        }
+    }
+
+    /// Build the MIP map pyramid from the texels of the finest level
+    void build_mipmap(const FloatStorage &values, bool to_spectral) {
+        FloatStorage data = dr::migrate(values, AllocType::Host);
+        if constexpr (dr::is_jit_v<Float>)
+            dr::sync_thread();
+
+        const size_t *shape = m_data->texture.shape();
+        ref<Bitmap> bitmap = new Bitmap(
+            shape[2] == 1 ? Bitmap::PixelFormat::Y : Bitmap::PixelFormat::RGB,
+            struct_type_v<ScalarFloat>, ScalarVector2u(shape[1], shape[0]),
+            shape[2], {}, (uint8_t *) data.data());
+        build_mipmap(bitmap.get(), to_spectral, m_data->texture.wrap_mode());
+    }
+
+    /// Upload texture data using the requested storage format
+    void init_texture(const ScalarFloat *data, const size_t shape[3],
+                      dr::FilterMode filter_mode, dr::WrapMode wrap_mode) {
+        if (is_compact())
+            m_data->compact_texture =
+                CompactTexture2f(data, shape, m_storage, filter_mode, wrap_mode);
+        else
+            m_data->texture = Texture2f(TensorXf(data, 3, shape), m_accel,
+                                        m_accel, filter_mode, wrap_mode);
+    }
+
     /// Construct 2D distribution upon first access, avoid races
     MI_INLINE void init_distr() const {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        if (!m_distr2d) {
+        std::lock_guard<std::mutex> lock(m_data->mutex);
+        if (!m_data->distr2d) {
             auto self = const_cast<BitmapTexture *>(this);
             self->rebuild_internals(false, true);
         }
     }
 
 protected:
-    Texture2f m_texture;
+    /**
+     * \brief Texture data that is shared by all instances that load the same
+     * file with the same options
+     */
+    struct BitmapData {
+        Texture2f texture;
+        /// Compact backend, used instead of \ref texture unless storing float32
+        CompactTexture2f compact_texture;
+        TextureStorage storage = TextureStorage::Float32;
+        /// Coarser levels of the MIP map pyramid (the finest is \ref texture)
+        std::vector<Texture2f> mipmap;
+        Float mean;
+
+        // Optional: distribution for importance sampling
+        std::mutex mutex;
+        std::unique_ptr<DiscreteDistribution2D<Float>> distr2d;
+
+        /// Set once the data has been loaded
+        std::once_flag loaded;
+    };
+
+    /**
+     * \brief Return the data associated with the given cache key, or a new
+     * instance that has yet to be loaded
+     *
+     * The cache only holds weak references: the data of a file is released
+     * once the last texture using it is destroyed.
+     */
+    static std::shared_ptr<BitmapData> shared_data(const std::string &key) {
+        static std::mutex cache_mutex;
+        static std::unordered_map<std::string, std::weak_ptr<BitmapData>> cache;
+
+        std::lock_guard<std::mutex> guard(cache_mutex);
+        std::shared_ptr<BitmapData> data = cache[key].lock();
+        if (!data) {
+            // Drop the entries of textures that no longer exist
+            for (auto it = cache.begin(); it != cache.end();) {
+                if (it->second.expired())
+                    it = cache.erase(it);
+                else
+                    ++it;
+            }
+            data = std::make_shared<BitmapData>();
+            cache[key] = data;
+        }
+        return data;
+    }
+
+    /**
+     * \brief Give this instance its own copy of the (mutable) texture data
+     * if it is shared with other instances
+     */
+    void detach() {
+        if (is_compact() || m_data.use_count() <= 1)
+            return;
+
+        std::shared_ptr<BitmapData> data = std::make_shared<BitmapData>();
+        data->texture = Texture2f(TensorXf(m_data->texture.tensor()), m_accel,
+                                  m_accel, m_data->texture.filter_mode(),
+                                  m_data->texture.wrap_mode());
+        for (Texture2f &level : m_data->mipmap)
+            data->mipmap.emplace_back(TensorXf(level.tensor()), m_accel, m_accel,
+                                      dr::FilterMode::Linear, level.wrap_mode());
+        data->storage = m_data->storage;
+        data->mean = m_data->mean;
+        std::call_once(data->loaded, []() { });
+        m_data = std::move(data);
+    }
+
+    std::shared_ptr<BitmapData> m_data;
+    TextureStorage m_storage = TextureStorage::Float32;
+
+    enum class MipmapMode { None, Trilinear, Anisotropic };
+    MipmapMode m_mipmap_mode = MipmapMode::None;
+    ref<Bitmap::ReconstructionFilter> m_mipmap_filter;
+    uint32_t m_max_anisotropy;
     ScalarTransform3f m_transform;
     bool m_accel;
     bool m_raw;
-    Float m_mean;
     std::string m_name;
-
-    // Optional: distribution for importance sampling
-    mutable std::mutex m_mutex;
-    std::unique_ptr<DiscreteDistribution2D<Float>> m_distr2d;
 };
 
 MI_IMPLEMENT_CLASS_VARIANT(BitmapTexture, Texture)
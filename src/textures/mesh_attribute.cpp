@@ -16,7 +16,9 @@ Mesh attribute texture (:monosp:`mesh_attribute`)
 
  * - name
    - |string|
-   - Name of the attribute to evaluate. It should always start with ``"vertex_"`` or ``"face_"``.
+   - Name of the attribute to evaluate. It should always start with ``"vertex_"`` or ``"face_"``
+     (or ``"particle_"`` for the attributes of a :ref:`spheres <shape-spheres>` shape, and
+     ``"instance_"`` for the attributes of an :ref:`instance <shape-instance>`).
  * - scale
    - |float|
    - Scaling factor applied to the interpolated attribute value during evaluation.
@@ -79,8 +81,10 @@ public:
     MeshAttribute(const Properties &props)
     : Texture(props) {
         m_name = props.string("name");
-        if (m_name.find("vertex_") == std::string::npos && m_name.find("face_") == std::string::npos)
-            Throw("Invalid mesh attribute name: must be start with either \"vertex_\" or \"face_\" but was \"%s\".", m_name.c_str());
+        m_instance = m_name.find("instance_") != std::string::npos;
+        if (m_name.find("vertex_") == std::string::npos && m_name.find("face_") == std::string::npos &&
+            m_name.find("particle_") == std::string::npos && !m_instance)
+            Throw("Invalid mesh attribute name: must be start with either \"vertex_\", \"face_\", \"particle_\" or \"instance_\" but was \"%s\".", m_name.c_str());
 
         m_scale = props.get<ScalarFloat>("scale", 1.f);
     }
@@ -93,16 +97,22 @@ public:
 
     UnpolarizedSpectrum eval(const SurfaceInteraction3f &si, Mask active) const override {
         MI_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
+        if (m_instance)
+            return eval_instance_attribute<UnpolarizedSpectrum, 0>(si, active);
         return si.shape->eval_attribute(m_name, si, active) * m_scale;
     }
 
     Float eval_1(const SurfaceInteraction3f &si, Mask active = true) const override {
         MI_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
+        if (m_instance)
+            return eval_instance_attribute<Float, 1>(si, active);
         return si.shape->eval_attribute_1(m_name, si, active) * m_scale;
     }
 
     Color3f eval_3(const SurfaceInteraction3f &si, Mask active = true) const override {
         MI_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
+        if (m_instance)
+            return eval_instance_attribute<Color3f, 3>(si, active);
         return si.shape->eval_attribute_3(m_name, si, active) * m_scale;
     }
 
@@ -116,9 +126,30 @@ public:
     }
 
     MI_DECLARE_CLASS()
+protected:
+    /// Evaluate an attribute of the instance (zero for shapes that weren't instanced)
+    template <typename Value, size_t Channels>
+    Value eval_instance_attribute(const SurfaceInteraction3f &si, Mask active) const {
+        if constexpr (dr::is_jit_v<Float>)
+            active &= dr::neq(si.instance, nullptr);
+        else if (!si.instance)
+            return Value(0.f);
+
+        Value result;
+        if constexpr (Channels == 1)
+            result = si.instance->eval_attribute_1(m_name, si, active);
+        else if constexpr (Channels == 3)
+            result = si.instance->eval_attribute_3(m_name, si, active);
+        else
+            result = si.instance->eval_attribute(m_name, si, active);
+        return result * m_scale;
+    }
+
 protected:
     std::string m_name;
     float m_scale;
+    /// Is this an attribute of the instance rather than of the shape itself?
+    bool m_instance;
 };
 
 MI_IMPLEMENT_CLASS_VARIANT(MeshAttribute, Texture)
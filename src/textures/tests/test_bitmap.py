@@ -247,4 +247,120 @@ def test06_tensor_load(variants_all_rgb):
         'raw' : True
     })
 
-    assert dr.allclose(bitmap.mean(), 3.0);
\ No newline at end of file
+    assert dr.allclose(bitmap.mean(), 3.0);
+
+@pytest.mark.parametrize('storage', ['float16', 'uint8'])
+@pytest.mark.parametrize('filter_type', ['nearest', 'bilinear'])
+def test07_compact_storage(variants_vec_rgb, np_rng, storage, filter_type):
+    import numpy as np
+
+    data = np_rng.random((17, 23, 3)).astype(np.float32)
+    props = {
+        'type' : 'bitmap',
+        'data' : mi.TensorXf(data),
+        'filter_type' : filter_type,
+        'raw' : True,
+        'accel' : False
+    }
+    reference = mi.load_dict(props)
+    bitmap = mi.load_dict(dict(props, storage=storage))
+    assert dr.allclose(bitmap.resolution(), reference.resolution())
+    assert not 'data' in mi.traverse(bitmap)
+
+    atol = 2**-11 if storage == 'float16' else 0.5 / 255
+    si = dr.zeros(mi.SurfaceInteraction3f, 1024)
+    si.uv = mi.Point2f(np_rng.random((2, 1024)) * 1.5 - 0.25)
+    assert dr.allclose(bitmap.eval_3(si), reference.eval_3(si), atol=atol)
+    assert dr.allclose(bitmap.eval_1(si), reference.eval_1(si), atol=atol)
+
+    # Sampling uses the compact values
+    sample = mi.Point2f(np_rng.random((2, 1024)))
+    pos, pdf = bitmap.sample_position(sample)
+    assert dr.allclose(pdf, bitmap.pdf_position(pos), rtol=1e-3)
+
+
+@pytest.mark.parametrize('filter_type', ['trilinear', 'anisotropic'])
+def test08_mipmap(variants_vec_rgb, np_rng, filter_type):
+    import numpy as np
+
+    # Vertical stripes of alternating single-texel columns
+    data = np.zeros((64, 64, 1), dtype=np.float32)
+    data[:, 1::2] = 1.0
+    props = {
+        'type' : 'bitmap',
+        'data' : mi.TensorXf(data),
+        'raw' : True,
+        'filter_type' : filter_type
+    }
+    bitmap = mi.load_dict(props)
+    reference = mi.load_dict(dict(props, filter_type='bilinear'))
+    assert bitmap.needs_differentials()
+    assert not reference.needs_differentials()
+
+    n = 256
+    si = dr.zeros(mi.SurfaceInteraction3f, n)
+    si.uv = mi.Point2f(np_rng.random((2, n)))
+
+    # Without ray differentials, the finest level is used
+    assert dr.allclose(bitmap.eval_1(si), reference.eval_1(si), atol=1e-5)
+
+    # A footprint spanning many texels averages out the stripes
+    si.duv_dx = mi.Vector2f(0.25, 0)
+    si.duv_dy = mi.Vector2f(0, 0.25)
+    assert dr.allclose(bitmap.eval_1(si), 0.5, atol=1e-3)
+
+    # Footprint elongated along the stripes
+    si.uv = mi.Point2f((dr.arange(mi.Float, n) % 32 * 2 + 1.5) / 64, 0.5)
+    si.duv_dx = mi.Vector2f(0, 1 / 16)
+    si.duv_dy = mi.Vector2f(1 / 128, 0)
+    value = bitmap.eval_1(si)
+    if filter_type == 'anisotropic':
+        # Only the minor axis selects the level, which keeps stripes sharp
+        assert dr.allclose(value, 1.0, atol=1e-3)
+    else:
+        assert dr.allclose(value, 0.5, atol=1e-3)
+
+
+def test09_mipmap_differentials(variant_scalar_rgb):
+    bsdf = mi.load_dict({
+        'type': 'diffuse',
+        'reflectance': {
+            'type': 'bitmap',
+            'data': mi.TensorXf([0.0, 1.0, 1.0, 0.0], shape=[2, 2, 1]),
+            'raw': True,
+            'filter_type': 'trilinear'
+        }
+    })
+    assert bsdf.needs_differentials()
+
+    with pytest.raises(RuntimeError, match='float32'):
+        mi.load_dict({
+            'type': 'bitmap',
+            'data': mi.TensorXf([0.0, 1.0, 1.0, 0.0], shape=[2, 2, 1]),
+            'raw': True,
+            'filter_type': 'trilinear',
+            'storage': 'float16'
+        })
+
+
+@fresolver_append_path
+def test10_shared_data(variants_vec_backends_once_rgb):
+    # Textures loading the same file share their data until it is traversed
+    desc = {
+        'type' : 'bitmap',
+        'filename' : 'resources/data/common/textures/carrot.png'
+    }
+    a, b = mi.load_dict(desc), mi.load_dict(desc)
+
+    si = dr.zeros(mi.SurfaceInteraction3f)
+    si.uv = [0.3, 0.6]
+    ref = b.eval_3(si)
+    assert dr.allclose(a.eval_3(si), ref)
+    assert dr.allclose(a.mean(), b.mean())
+
+    params = mi.traverse(a)
+    params['data'] = dr.zeros(mi.TensorXf, params['data'].shape)
+    params.update()
+
+    assert dr.allclose(a.eval_3(si), 0)
+    assert dr.allclose(b.eval_3(si), ref)
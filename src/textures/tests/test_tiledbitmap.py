@@ -0,0 +1,102 @@
+import pytest
+import drjit as dr
+import mitsuba as mi
+import os
+
+
+def write_exr(tmpdir, name, np_rng, res=(37, 50)):
+    import numpy as np
+    data = np_rng.random((res[0], res[1], 3)).astype(np.float32)
+    filename = os.path.join(str(tmpdir), name)
+    mi.Bitmap(data, mi.Bitmap.PixelFormat.RGB).write(filename)
+    return filename
+
+
+@pytest.mark.parametrize('filter_type', ['nearest', 'bilinear'])
+@pytest.mark.parametrize('wrap_mode', ['repeat', 'clamp', 'mirror'])
+def test01_eval_matches_bitmap(variant_scalar_rgb, tmpdir, np_rng,
+                               filter_type, wrap_mode):
+    filename = write_exr(tmpdir, 'tex.exr', np_rng)
+
+    ref = mi.load_dict({
+        'type': 'bitmap',
+        'filename': filename,
+        'filter_type': filter_type,
+        'wrap_mode': wrap_mode
+    })
+    tiled = mi.load_dict({
+        'type': 'tiledbitmap',
+        'filename': filename,
+        'tile_size': 16,
+        'filter_type': filter_type,
+        'wrap_mode': wrap_mode
+    })
+
+    assert dr.all(tiled.resolution() == ref.resolution())
+    assert dr.allclose(tiled.mean(), ref.mean())
+
+    si = dr.zeros(mi.SurfaceInteraction3f)
+    for uv in np_rng.random((64, 2)) * 3 - 1:
+        si.uv = mi.Point2f(uv)
+        assert dr.allclose(tiled.eval_3(si), ref.eval_3(si), atol=1e-5)
+
+
+def test02_statistics(variant_scalar_rgb, tmpdir, np_rng):
+    filename = write_exr(tmpdir, 'tex.exr', np_rng, res=(64, 64))
+    tiled = mi.load_dict({
+        'type': 'tiledbitmap',
+        'filename': filename,
+        'tile_size': 16,
+        'filter_type': 'nearest'
+    })
+
+    cache = mi.TileCache.instance()
+    budget = cache.budget()
+    cache.clear()
+    cache.reset_statistics()
+
+    si = dr.zeros(mi.SurfaceInteraction3f)
+    si.uv = [0.1, 0.1]
+    tiled.eval_3(si)
+    tiled.eval_3(si)
+
+    stats = cache.statistics()
+    assert stats.misses > 0
+    assert stats.hits >= 1
+    assert stats.resident_tiles > 0
+
+    # A budget of a single tile forces evictions
+    tile_bytes = 16 * 16 * 3 * 4
+    cache.set_budget(tile_bytes)
+    try:
+        for i in range(4):
+            si.uv = [(i + .5) / 4, .5]
+            tiled.eval_3(si)
+        stats = cache.statistics()
+        assert stats.evictions > 0
+        assert stats.resident_bytes <= tile_bytes
+    finally:
+        cache.set_budget(budget)
+        cache.clear()
+
+
+def test03_udim(variant_scalar_rgb, tmpdir, np_rng):
+    write_exr(tmpdir, 'tex.1001.exr', np_rng)
+    filename = write_exr(tmpdir, 'tex.1012.exr', np_rng)
+
+    ref = mi.load_dict({'type': 'bitmap', 'filename': filename,
+                        'wrap_mode': 'clamp'})
+    tiled = mi.load_dict({
+        'type': 'tiledbitmap',
+        'filename': os.path.join(str(tmpdir), 'tex.<UDIM>.exr')
+    })
+
+    si = dr.zeros(mi.SurfaceInteraction3f)
+    si.uv = [1.25, -0.6]
+    ref_si = dr.zeros(mi.SurfaceInteraction3f)
+    ref_si.uv = [0.25, 0.4]
+    assert dr.allclose(tiled.eval_3(si), ref.eval_3(ref_si), atol=1e-5)
+
+    # Missing UDIM tiles evaluate to zero
+    si.uv = [0.5, -0.5]
+    assert dr.all(tiled.eval_3(si) == 0)
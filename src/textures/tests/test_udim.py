@@ -0,0 +1,51 @@
+import pytest
+import drjit as dr
+import mitsuba as mi
+import os
+
+
+def write_tiles(tmpdir, np_rng, tiles, res=(16, 24)):
+    import numpy as np
+    for tile in tiles:
+        data = np_rng.random((res[0], res[1], 3)).astype(np.float32)
+        filename = os.path.join(str(tmpdir), f'tex.{tile}.exr')
+        mi.Bitmap(data, mi.Bitmap.PixelFormat.RGB).write(filename)
+    return os.path.join(str(tmpdir), 'tex.<UDIM>.exr')
+
+
+@pytest.mark.parametrize('filter_type', ['nearest', 'bilinear'])
+def test01_eval_matches_bitmap(variants_all_rgb, tmpdir, np_rng, filter_type):
+    filename = write_tiles(tmpdir, np_rng, [1001, 1002, 1012])
+    udim = mi.load_dict({
+        'type': 'udim',
+        'filename': filename,
+        'filter_type': filter_type
+    })
+    assert dr.all(udim.resolution() == [24, 16])
+
+    si = dr.zeros(mi.SurfaceInteraction3f)
+    uv = mi.Point2f(np_rng.random((2, 64)))
+
+    # Tile 1001 + u + 10 * v covers [u, u + 1] x [-v, 1 - v]
+    for tile, offset in [(1001, [0, 0]), (1002, [1, 0]), (1012, [1, -1])]:
+        ref = mi.load_dict({
+            'type': 'bitmap',
+            'filename': filename.replace('<UDIM>', str(tile)),
+            'filter_type': filter_type,
+            'wrap_mode': 'clamp'
+        })
+        si.uv = uv
+        expected = ref.eval_3(si)
+        si.uv = uv + mi.Point2f(offset)
+        assert dr.allclose(udim.eval_3(si), expected, atol=1e-5)
+
+    # Missing tiles evaluate to zero
+    si.uv = uv + mi.Point2f(0, -1)
+    assert dr.allclose(udim.eval_3(si), 0)
+
+
+def test02_inconsistent_tiles(variant_scalar_rgb, tmpdir, np_rng):
+    write_tiles(tmpdir, np_rng, [1001])
+    filename = write_tiles(tmpdir, np_rng, [1002], res=(8, 8))
+    with pytest.raises(RuntimeError, match='same resolution'):
+        mi.load_dict({ 'type': 'udim', 'filename': filename })
@@ -0,0 +1,472 @@
+#include <mitsuba/core/fresolver.h>
+#include <mitsuba/core/plugin.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/spectrum.h>
+#include <mitsuba/core/string.h>
+#include <mitsuba/core/tilecache.h>
+#include <mitsuba/render/interaction.h>
+#include <mitsuba/render/texture.h>
+#include <mitsuba/render/srgb.h>
+#include <drjit/texture.h>
+#include <mutex>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**!
+
+.. _texture-tiledbitmap:
+
+Tiled bitmap texture (:monosp:`tiledbitmap`)
+--------------------------------------------
+
+.. pluginparameters::
+
+ * - filename
+   - |string|
+   - Filename of the bitmap to be loaded. When the filename contains the token
+     ``<UDIM>``, it is replaced by the UDIM tile numbers ``1001``, ``1002``,
+     etc., and every tile that exists on disk is loaded.
+
+ * - tile_size
+   - |int|
+   - Size of the tiles (in texels) that are loaded into the cache. Tiled
+     OpenEXR files always use their native tile size. (Default: 64)
+
+ * - filter_type
+   - |string|
+   - Specifies how pixel values are interpolated. The following options are
+     currently available:
+
+     - ``bilinear`` (default): perform bilinear interpolation.
+
+     - ``nearest``: perform nearest neighbor lookups.
+
+ * - wrap_mode
+   - |string|
+   - Controls the behavior of texture evaluations that fall outside of the
+     :math:`[0, 1]` range. The following options are currently available:
+
+     - ``repeat`` (default): tile the texture infinitely.
+
+     - ``mirror``: mirror the texture along its boundaries.
+
+     - ``clamp``: clamp coordinates to the edge of the texture.
+
+     UDIM textures always clamp lookups to the edges of the individual UDIM
+     tiles, and evaluate to zero outside of the tiles that exist.
+
+ * - raw
+   - |bool|
+   - Should the transformation to the stored color data (e.g. sRGB to linear,
+     spectral upsampling) be disabled? (Default: false)
+
+ * - to_uv
+   - |transform|
+   - Specifies an optional 3x3 transformation matrix that will be applied to UV
+     values. A 4x4 matrix can also be provided, in which case the extra row and
+     column are ignored.
+
+This plugin provides a bitmap texture for scenes whose textures do not fit
+into memory. In contrast to the :ref:`bitmap <texture-bitmap>` texture, only
+the header of the image is read when the scene is loaded. Texels are instead
+fetched through a global cache that loads tiles of the image on their first
+access and evicts the least recently used tiles once a fixed memory budget is
+exceeded. Tiled OpenEXR files are read one tile at a time, scanline OpenEXR
+files one band of rows at a time. Other formats supported by the
+:ref:`bitmap <texture-bitmap>` texture are decoded entirely whenever one of
+their tiles is needed, which is only sensible for small images.
+
+The cache is shared by all textures of this type. Its budget (1 GiB by default)
+and its hit and miss counters can be accessed from Python:
+
+.. code-block:: python
+
+    cache = mi.TileCache.instance()
+    cache.set_budget(8 * 1024**3)
+    # .. render ..
+    stats = cache.statistics()
+    print(stats.hits, stats.misses, stats.evictions)
+
+This plugin is only available in scalar variants, since the tiles are loaded
+lazily during the evaluation of the texture.
+
+.. tabs::
+    .. code-tab:: xml
+        :name: tiledbitmap-texture
+
+        <texture type="tiledbitmap">
+            <string name="filename" value="textures/albedo.<UDIM>.exr"/>
+        </texture>
+
+    .. code-tab:: python
+
+        'type': 'tiledbitmap',
+        'filename': 'textures/albedo.<UDIM>.exr'
+
+*/
+
+template <typename Float, typename Spectrum>
+class TiledBitmapTexture final : public Texture<Float, Spectrum> {
+public:
+    MI_IMPORT_TYPES(Texture)
+
+    TiledBitmapTexture(const Properties &props) : Texture(props) {
+        if constexpr (dr::is_jit_v<Float>)
+            Throw("The tiledbitmap texture is only supported in scalar "
+                  "variants!");
+
+        m_transform = props.get<ScalarTransform3f>("to_uv", ScalarTransform3f());
+
+        std::string filter_mode_str = props.string("filter_type", "bilinear");
+        if (filter_mode_str == "nearest")
+            m_filter_mode = dr::FilterMode::Nearest;
+        else if (filter_mode_str == "bilinear")
+            m_filter_mode = dr::FilterMode::Linear;
+        else
+            Throw("Invalid filter type \"%s\", must be one of: \"nearest\", or "
+                  "\"bilinear\"!", filter_mode_str);
+
+        std::string wrap_mode_str = props.string("wrap_mode", "repeat");
+        if (wrap_mode_str == "repeat")
+            m_wrap_mode = dr::WrapMode::Repeat;
+        else if (wrap_mode_str == "mirror")
+            m_wrap_mode = dr::WrapMode::Mirror;
+        else if (wrap_mode_str == "clamp")
+            m_wrap_mode = dr::WrapMode::Clamp;
+        else
+            Throw("Invalid wrap mode \"%s\", must be one of: \"repeat\", "
+                  "\"mirror\", or \"clamp\"!", wrap_mode_str);
+
+        m_raw = props.get<bool>("raw", false);
+        uint32_t tile_size = props.get<uint32_t>("tile_size", 64);
+
+        FileResolver *fs = Thread::thread()->file_resolver();
+        std::string filename = props.string("filename");
+        m_name = fs::path(filename).filename().string();
+
+        size_t udim_pos = filename.find("<UDIM>");
+        if (udim_pos == std::string::npos) {
+            fs::path file_path = fs->resolve(filename);
+            Log(Debug, "Opening tiled bitmap texture \"%s\" ..", m_name);
+            m_images.push_back(new TiledImage(file_path, tile_size, m_raw));
+            m_udim_count = ScalarVector2u(1, 1);
+        } else {
+            /* Probe the UDIM tiles 1001 + u + 10 * v. Only the headers of
+               the files are read at this point. */
+            for (uint32_t v = 0; v < 10; ++v) {
+                for (uint32_t u = 0; u < 10; ++u) {
+                    std::string name = filename;
+                    name.replace(udim_pos, 6, std::to_string(1001 + u + 10 * v));
+                    fs::path file_path = fs->resolve(name);
+                    if (!fs::exists(file_path))
+                        continue;
+                    size_t index = u + 10 * v;
+                    if (m_udim_images.size() <= index)
+                        m_udim_images.resize(index + 1);
+                    m_udim_images[index] = new TiledImage(file_path, tile_size, m_raw);
+                    m_images.push_back(m_udim_images[index]);
+                    m_udim_count = dr::maximum(m_udim_count,
+                                               ScalarVector2u(u + 1, v + 1));
+                }
+            }
+            if (m_images.empty())
+                Throw("No UDIM tiles matching \"%s\" were found!", filename);
+            Log(Debug, "Opened %u UDIM tiles of texture \"%s\"",
+                (uint32_t) m_images.size(), m_name);
+        }
+
+        m_channel_count = m_images[0]->channel_count();
+        for (const TiledImage *image : m_images) {
+            if (image->channel_count() != m_channel_count)
+                Throw("The UDIM tiles of texture \"%s\" have inconsistent "
+                      "channel counts!", m_name);
+        }
+    }
+
+    UnpolarizedSpectrum eval(const SurfaceInteraction3f &si,
+                             Mask active) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
+
+        if (m_channel_count == 3 && is_spectral_v<Spectrum> && m_raw) {
+            DRJIT_MARK_USED(si);
+            Throw("The tiledbitmap texture %s was queried for a spectrum, but "
+                  "texture conversion into spectra was explicitly disabled! "
+                  "(raw=true)",
+                  to_string());
+        }
+
+        if constexpr (!dr::is_jit_v<Float>) {
+            if (!active)
+                return 0.f;
+
+            if (m_channel_count == 1)
+                return interpolate_1(si.uv);
+
+            if constexpr (is_monochromatic_v<Spectrum>) {
+                return luminance(interpolate_3(si.uv));
+            } else if constexpr (is_spectral_v<Spectrum>) {
+                const Wavelength &wavelengths = si.wavelengths;
+                return interpolate<UnpolarizedSpectrum>(
+                    si.uv, [&](const float *texel) {
+                        Color<float, 3> rgb(texel[0], texel[1], texel[2]);
+                        return srgb_model_eval<UnpolarizedSpectrum>(
+                            srgb_model_fetch(rgb), wavelengths);
+                    });
+            } else {
+                return interpolate_3(si.uv);
+            }
+        } else {
+            DRJIT_MARK_USED(si);
+            DRJIT_MARK_USED(active);
+            return 0.f;
+        }
+    }
+
+    Float eval_1(const SurfaceInteraction3f &si,
+                 Mask active = true) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
+
+        if (m_channel_count == 3 && is_spectral_v<Spectrum> && !m_raw) {
+            DRJIT_MARK_USED(si);
+            Throw("eval_1(): The tiledbitmap texture %s was queried for a "
+                  "monochromatic value, but texture conversion to color "
+                  "spectra had previously been requested! (raw=false)",
+                  to_string());
+        }
+
+        if constexpr (!dr::is_jit_v<Float>) {
+            if (!active)
+                return 0.f;
+
+            if (m_channel_count == 1)
+                return interpolate_1(si.uv);
+            else // 3 channels
+                return luminance(interpolate_3(si.uv));
+        } else {
+            DRJIT_MARK_USED(si);
+            DRJIT_MARK_USED(active);
+            return 0.f;
+        }
+    }
+
+    Color3f eval_3(const SurfaceInteraction3f &si,
+                   Mask active = true) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
+
+        if (m_channel_count != 3) {
+            DRJIT_MARK_USED(si);
+            Throw("eval_3(): The tiledbitmap texture %s was queried for a RGB "
+                  "value, but it is monochromatic!",
+                  to_string());
+        } else if (is_spectral_v<Spectrum> && !m_raw) {
+            DRJIT_MARK_USED(si);
+            Throw("eval_3(): The tiledbitmap texture %s was queried for a RGB "
+                  "value, but texture conversion to color spectra had "
+                  "previously been requested! (raw=false)",
+                  to_string());
+        }
+
+        if constexpr (!dr::is_jit_v<Float>) {
+            if (!active)
+                return 0.f;
+            return interpolate_3(si.uv);
+        } else {
+            DRJIT_MARK_USED(si);
+            DRJIT_MARK_USED(active);
+            return 0.f;
+        }
+    }
+
+    ScalarVector2i resolution() const override {
+        return ScalarVector2i(m_images[0]->size());
+    }
+
+    /**
+     * \brief Return the mean value of the texture
+     *
+     * The mean is computed upon the first invocation by streaming all tiles
+     * of the texture through the cache.
+     */
+    Float mean() const override {
+        std::call_once(m_mean_flag, [&]() { compute_mean(); });
+        return m_mean;
+    }
+
+    bool is_spatially_varying() const override { return true; }
+
+    std::string to_string() const override {
+        std::ostringstream oss;
+        oss << "TiledBitmapTexture[" << std::endl
+            << "  name = \"" << m_name << "\"," << std::endl
+            << "  resolution = \"" << resolution() << "\"," << std::endl
+            << "  udim_tiles = " << m_images.size() << "," << std::endl
+            << "  channels = " << m_channel_count << "," << std::endl
+            << "  raw = " << (int) m_raw << "," << std::endl
+            << "  transform = " << string::indent(m_transform) << std::endl
+            << "]";
+        return oss.str();
+    }
+
+    MI_DECLARE_CLASS()
+
+protected:
+    MI_INLINE ScalarFloat interpolate_1(const Point2f &uv) const {
+        return interpolate<ScalarFloat>(
+            uv, [](const float *texel) { return (ScalarFloat) texel[0]; });
+    }
+
+    MI_INLINE ScalarColor3f interpolate_3(const Point2f &uv) const {
+        return interpolate<ScalarColor3f>(uv, [](const float *texel) {
+            return ScalarColor3f(texel[0], texel[1], texel[2]);
+        });
+    }
+
+    /**
+     * \brief Interpolate the texture at the given UV position
+     *
+     * The \c convert function maps the channels of a texel to \c Value,
+     * interpolation happens after this conversion.
+     */
+    template <typename Value, typename Func>
+    Value interpolate(const Point2f &uv_, const Func &convert) const {
+        ScalarPoint2f uv = m_transform.transform_affine(ScalarPoint2f(uv_));
+
+        // Locate the UDIM tile and the position within it
+        const TiledImage *image = m_images[0].get();
+        if (!m_udim_images.empty()) {
+            ScalarPoint2i udim((int32_t) dr::floor(uv.x()),
+                               (int32_t) dr::floor(1.f - uv.y()));
+            if (dr::any(udim < 0) || dr::any(udim >= ScalarPoint2i(m_udim_count)))
+                return dr::zeros<Value>();
+            size_t index = (size_t) (udim.x() + 10 * udim.y());
+            if (index >= m_udim_images.size() || !m_udim_images[index])
+                return dr::zeros<Value>();
+            image = m_udim_images[index].get();
+            uv = ScalarPoint2f(uv.x() - udim.x(), uv.y() + udim.y());
+        }
+
+        ScalarVector2f res(image->size());
+        float texel[3];
+
+        if (m_filter_mode == dr::FilterMode::Nearest) {
+            ScalarPoint2i pos = dr::floor2int<ScalarPoint2i>(uv * res);
+            fetch(image, pos, texel);
+            return convert(texel);
+        }
+
+        ScalarPoint2f pos = dr::fmadd(uv, res, -.5f);
+        ScalarPoint2i pos_i = dr::floor2int<ScalarPoint2i>(pos);
+        ScalarPoint2f w1 = pos - ScalarPoint2f(pos_i), w0 = 1.f - w1;
+
+        fetch(image, pos_i + ScalarPoint2i(0, 0), texel);
+        Value v00 = convert(texel);
+        fetch(image, pos_i + ScalarPoint2i(1, 0), texel);
+        Value v10 = convert(texel);
+        fetch(image, pos_i + ScalarPoint2i(0, 1), texel);
+        Value v01 = convert(texel);
+        fetch(image, pos_i + ScalarPoint2i(1, 1), texel);
+        Value v11 = convert(texel);
+
+        Value v0 = dr::fmadd(w0.x(), v00, w1.x() * v10),
+              v1 = dr::fmadd(w0.x(), v01, w1.x() * v11);
+
+        return dr::fmadd(w0.y(), v0, w1.y() * v1);
+    }
+
+    /// Fetch the channels of a texel through the global tile cache
+    void fetch(const TiledImage *image, const ScalarPoint2i &pos_,
+               float *out) const {
+        ScalarVector2i res(image->size());
+        uint32_t x = (uint32_t) wrap(pos_.x(), res.x()),
+                 y = (uint32_t) wrap(pos_.y(), res.y());
+
+        uint32_t tile_size = image->tile_size();
+        TileCache::TilePtr tile =
+            TileCache::instance()->tile(image, x / tile_size, y / tile_size);
+
+        const float *src =
+            tile->data.get() + ((size_t) (y % tile_size) * tile->size.x() +
+                                x % tile_size) * m_channel_count;
+        for (uint32_t c = 0; c < m_channel_count; ++c)
+            out[c] = src[c];
+    }
+
+    /// Apply the wrap mode to an integer texel coordinate
+    int32_t wrap(int32_t value, int32_t size) const {
+        if (!m_udim_images.empty() || m_wrap_mode == dr::WrapMode::Clamp)
+            return dr::clamp(value, 0, size - 1);
+
+        if (m_wrap_mode == dr::WrapMode::Repeat) {
+            value %= size;
+            return value < 0 ? value + size : value;
+        }
+
+        // Mirror
+        int32_t period = 2 * size;
+        value %= period;
+        if (value < 0)
+            value += period;
+        return value < size ? value : period - 1 - value;
+    }
+
+    void compute_mean() const {
+        double mean = 0.0;
+        size_t pixel_count = 0;
+        TileCache *cache = TileCache::instance();
+
+        for (const TiledImage *image : m_images) {
+            ScalarVector2u tile_count = image->tile_count();
+            for (uint32_t ty = 0; ty < tile_count.y(); ++ty) {
+                for (uint32_t tx = 0; tx < tile_count.x(); ++tx) {
+                    TileCache::TilePtr tile = cache->tile(image, tx, ty);
+                    const float *ptr = tile->data.get();
+                    size_t count = (size_t) dr::prod(tile->size);
+                    if (m_channel_count != 1 && is_spectral_v<Spectrum> && !m_raw) {
+                        // Batched conversion of a copy of the tile
+                        std::vector<float> values(ptr, ptr + count * m_channel_count);
+                        double tile_mean = 0.0;
+                        srgb_model_fetch(values.data(), count, m_channel_count,
+                                         &tile_mean);
+                        mean += tile_mean * (double) count;
+                        pixel_count += count;
+                        continue;
+                    }
+                    for (size_t i = 0; i < count; ++i, ptr += m_channel_count) {
+                        if (m_channel_count == 1) {
+                            mean += (double) ptr[0];
+                        } else {
+                            Color<float, 3> value(ptr[0], ptr[1], ptr[2]);
+                            if (is_spectral_v<Spectrum> && !m_raw)
+                                mean += (double) srgb_model_mean(srgb_model_fetch(value));
+                            else
+                                mean += (double) luminance(value);
+                        }
+                    }
+                    pixel_count += count;
+                }
+            }
+        }
+
+        m_mean = (ScalarFloat) (mean / pixel_count);
+    }
+
+protected:
+    std::string m_name;
+    std::vector<ref<TiledImage>> m_images;
+    /// UDIM tiles indexed by u + 10 * v (empty for regular textures)
+    std::vector<ref<TiledImage>> m_udim_images;
+    ScalarVector2u m_udim_count = 0;
+    uint32_t m_channel_count;
+    ScalarTransform3f m_transform;
+    dr::FilterMode m_filter_mode;
+    dr::WrapMode m_wrap_mode;
+    bool m_raw;
+
+    mutable std::once_flag m_mean_flag;
+    mutable ScalarFloat m_mean = 0.f;
+};
+
+MI_IMPLEMENT_CLASS_VARIANT(TiledBitmapTexture, Texture)
+MI_EXPORT_PLUGIN(TiledBitmapTexture, "Tiled bitmap texture")
+
+NAMESPACE_END(mitsuba)
@@ -0,0 +1,260 @@
+#include <mitsuba/core/bitmap.h>
+#include <mitsuba/core/fresolver.h>
+#include <mitsuba/core/plugin.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/string.h>
+#include <mitsuba/render/interaction.h>
+#include <mitsuba/render/texture.h>
+#include <cstring>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**!
+
+.. _texture-udim:
+
+UDIM texture (:monosp:`udim`)
+-----------------------------
+
+.. pluginparameters::
+
+ * - filename
+   - |string|
+   - Filename pattern of the tiles, containing the token ``<UDIM>``. It is
+     replaced by the UDIM tile numbers ``1001``, ``1002``, etc., and every
+     tile that exists on disk is loaded.
+
+ * - filter_type
+   - |string|
+   - Specifies how pixel values are interpolated. The following options are
+     currently available:
+
+     - ``bilinear`` (default): perform bilinear interpolation.
+
+     - ``nearest``: perform nearest neighbor lookups.
+
+ * - raw
+   - |bool|
+   - Should the transformation to the stored color data (e.g. sRGB to linear,
+     spectral upsampling) be disabled? (Default: false)
+
+ * - accel
+   - |bool|
+   - Hardware acceleration features can be used in CUDA mode. See the
+     :ref:`bitmap <texture-bitmap>` texture for details. (Default: true)
+
+ * - to_uv
+   - |transform|
+   - Specifies an optional 3x3 transformation matrix that will be applied to UV
+     values. A 4x4 matrix can also be provided, in which case the extra row and
+     column are ignored.
+
+This plugin evaluates a set of textures that share the same resolution and
+pixel format using a single lookup. The tile :math:`1001 + u + 10 v` covers
+the UV range :math:`[u, u + 1] \times [-v, 1 - v]`, following the UDIM
+convention of the :ref:`tiledbitmap <texture-tiledbitmap>` texture. Lookups are
+clamped to the edges of the individual tiles, and evaluate to zero outside of
+the tiles that exist.
+
+The tiles are packed into one :ref:`bitmap <texture-bitmap>` texture when the
+plugin is loaded. Objects that previously used separate materials that only
+differed by their textures can therefore share one material, and select their
+texture by placing their UV coordinates into different tiles. In JIT variants,
+this replaces a virtual function call over many texture (and BSDF) instances
+by a single texture evaluation, which reduces both the compilation time and
+the divergence of the generated kernels.
+
+.. tabs::
+    .. code-tab:: xml
+        :name: udim-texture
+
+        <texture type="udim">
+            <string name="filename" value="textures/albedo.<UDIM>.png"/>
+        </texture>
+
+    .. code-tab:: python
+
+        'type': 'udim',
+        'filename': 'textures/albedo.<UDIM>.png'
+
+*/
+
+template <typename Float, typename Spectrum>
+class UDIMTexture final : public Texture<Float, Spectrum> {
+public:
+    MI_IMPORT_TYPES(Texture)
+
+    using UInt32Storage = DynamicBuffer<UInt32>;
+
+    UDIMTexture(const Properties &props) : Texture(props) {
+        m_transform = props.get<ScalarTransform3f>("to_uv", ScalarTransform3f());
+        if (m_transform != ScalarTransform3f())
+            dr::make_opaque(m_transform);
+
+        std::string filter_type = props.string("filter_type", "bilinear");
+        if (filter_type != "bilinear" && filter_type != "nearest")
+            Throw("Invalid filter type \"%s\", must be one of: \"nearest\", or "
+                  "\"bilinear\"!", filter_type);
+
+        FileResolver *fs = Thread::thread()->file_resolver();
+        std::string filename = props.string("filename");
+        m_name = fs::path(filename).filename().string();
+
+        size_t udim_pos = filename.find("<UDIM>");
+        if (udim_pos == std::string::npos)
+            Throw("The filename \"%s\" must contain the token <UDIM>!", filename);
+
+        // Load the tiles 1001 + u + 10 * v that exist on disk
+        std::vector<ref<Bitmap>> tiles;
+        std::vector<uint32_t> slots(100, (uint32_t) -1);
+        for (uint32_t i = 0; i < 100; ++i) {
+            std::string name = filename;
+            name.replace(udim_pos, 6, std::to_string(1001 + i));
+            fs::path file_path = fs->resolve(name);
+            if (!fs::exists(file_path))
+                continue;
+
+            ref<Bitmap> tile = new Bitmap(file_path);
+            if (!tiles.empty() &&
+                (tile->size() != tiles[0]->size() ||
+                 tile->pixel_format() != tiles[0]->pixel_format() ||
+                 tile->component_format() != tiles[0]->component_format() ||
+                 tile->srgb_gamma() != tiles[0]->srgb_gamma()))
+                Throw("The UDIM tiles of texture \"%s\" must have the same "
+                      "resolution and pixel format!", m_name);
+
+            slots[i] = (uint32_t) tiles.size();
+            tiles.push_back(tile);
+        }
+
+        if (tiles.empty())
+            Throw("No UDIM tiles matching \"%s\" were found!", filename);
+        Log(Debug, "Loaded %u UDIM tiles of texture \"%s\"",
+            (uint32_t) tiles.size(), m_name);
+
+        /* Stack the tiles vertically. Since the rows of a bitmap are
+           contiguous, this simply concatenates their storage */
+        m_tile_count = (uint32_t) tiles.size();
+        m_tile_size = tiles[0]->size();
+        ref<Bitmap> atlas = new Bitmap(
+            tiles[0]->pixel_format(), tiles[0]->component_format(),
+            ScalarVector2u(m_tile_size.x(), m_tile_size.y() * m_tile_count));
+        atlas->set_srgb_gamma(tiles[0]->srgb_gamma());
+
+        size_t tile_bytes = tiles[0]->buffer_size();
+        for (uint32_t i = 0; i < m_tile_count; ++i)
+            std::memcpy(atlas->uint8_data() + i * tile_bytes,
+                        tiles[i]->uint8_data(), tile_bytes);
+
+        Properties nested("bitmap");
+        nested.set_object("bitmap", atlas.get());
+        nested.set_string("filter_type", filter_type);
+        nested.set_string("wrap_mode", "clamp");
+        nested.set_bool("raw", props.get<bool>("raw", false));
+        nested.set_bool("accel", props.get<bool>("accel", true));
+        m_texture = PluginManager::instance()->create_object<Texture>(nested);
+
+        m_slots = dr::load<UInt32Storage>(slots.data(), slots.size());
+    }
+
+    UnpolarizedSpectrum eval(const SurfaceInteraction3f &si,
+                             Mask active) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
+        SurfaceInteraction3f si_atlas = atlas_interaction(si, active);
+        return dr::select(active, m_texture->eval(si_atlas, active), 0.f);
+    }
+
+    Float eval_1(const SurfaceInteraction3f &si,
+                 Mask active = true) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
+        SurfaceInteraction3f si_atlas = atlas_interaction(si, active);
+        return dr::select(active, m_texture->eval_1(si_atlas, active), 0.f);
+    }
+
+    Color3f eval_3(const SurfaceInteraction3f &si,
+                   Mask active = true) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
+        SurfaceInteraction3f si_atlas = atlas_interaction(si, active);
+        return dr::select(active, m_texture->eval_3(si_atlas, active), 0.f);
+    }
+
+    void traverse(TraversalCallback *callback) override {
+        callback->put_object("atlas", m_texture.get(), +ParamFlags::Differentiable);
+        callback->put_parameter("to_uv", m_transform, +ParamFlags::NonDifferentiable);
+    }
+
+    void parameters_changed(const std::vector<std::string> &keys = {}) override {
+        if (keys.empty() || string::contains(keys, "to_uv")) {
+            if (m_transform != ScalarTransform3f())
+                dr::make_opaque(m_transform);
+        }
+    }
+
+    Float mean() const override { return m_texture->mean(); }
+
+    ScalarVector2i resolution() const override {
+        return ScalarVector2i(m_tile_size);
+    }
+
+    ScalarFloat max() const override { return m_texture->max(); }
+
+    bool is_spatially_varying() const override { return true; }
+
+    std::string to_string() const override {
+        std::ostringstream oss;
+        oss << "UDIMTexture[" << std::endl
+            << "  name = \"" << m_name << "\"," << std::endl
+            << "  tiles = " << m_tile_count << "," << std::endl
+            << "  tile_size = " << m_tile_size << "," << std::endl
+            << "  transform = " << string::indent(m_transform) << std::endl
+            << "]";
+        return oss.str();
+    }
+
+    MI_DECLARE_CLASS()
+
+protected:
+    /**
+     * \brief Map the UV coordinates of an interaction into the packed tiles
+     *
+     * Disables the lanes that lie outside of the loaded tiles.
+     */
+    SurfaceInteraction3f atlas_interaction(const SurfaceInteraction3f &si,
+                                           Mask &active) const {
+        Point2f uv = m_transform.transform_affine(si.uv);
+
+        Int32 tile_u = dr::floor2int<Int32>(uv.x()),
+              tile_v = dr::floor2int<Int32>(1.f - uv.y());
+        active &= tile_u >= 0 && tile_u < 10 && tile_v >= 0 && tile_v < 10;
+
+        UInt32 slot = dr::gather<UInt32>(
+            m_slots, UInt32(tile_u + 10 * tile_v), active);
+        active &= dr::neq(slot, (uint32_t) -1);
+
+        /* Position within the tile, clamped to the centers of its border
+           texels so that lookups don't blend with the neighboring tiles */
+        ScalarVector2f res(m_tile_size);
+        Point2f local(uv.x() - Float(tile_u), uv.y() + Float(tile_v));
+        local = dr::clamp(local, .5f / res, 1.f - .5f / res);
+
+        SurfaceInteraction3f si_atlas(si);
+        si_atlas.uv = Point2f(
+            local.x(), (Float(slot) + local.y()) / (ScalarFloat) m_tile_count);
+        si_atlas.duv_dx = si_atlas.duv_dy = 0.f;
+        return si_atlas;
+    }
+
+protected:
+    std::string m_name;
+    ref<Texture> m_texture;
+    /// Slot of each UDIM tile within the packed texture (-1 if missing)
+    UInt32Storage m_slots;
+    ScalarVector2u m_tile_size;
+    uint32_t m_tile_count;
+    ScalarTransform3f m_transform;
+};
+
+MI_IMPLEMENT_CLASS_VARIANT(UDIMTexture, Texture)
+MI_EXPORT_PLUGIN(UDIMTexture, "UDIM texture")
+
+NAMESPACE_END(mitsuba)
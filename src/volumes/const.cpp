@@ -83,6 +83,10 @@ public:
 
     ScalarFloat max() const override { return m_value->max(); }
 
+    /* Textures do not expose a lower bound of their values, hence a constant
+       volume reports the trivial one */
+    ScalarFloat min() const override { return 0.f; }
+
     std::string to_string() const override {
         std::ostringstream oss;
         oss << "ConstVolume[" << std::endl
@@ -3,6 +3,8 @@
 #include <mitsuba/core/spectrum.h>
 #include <mitsuba/core/string.h>
 #include <mitsuba/core/transform.h>
+#include <mitsuba/render/compacttexture.h>
+#include <mitsuba/render/sparsegrid.h>
 #include <mitsuba/render/srgb.h>
 #include <mitsuba/render/volume.h>
 #include <mitsuba/render/volumegrid.h>
@@ -22,13 +24,15 @@ Grid-based volume data source (:monosp:`gridvolume`)
 
  * - filename
    - |string|
-   - Filename of the volume to be loaded
+   - Filename of the volume to be loaded. Files with the extension ``.svol``
+     are loaded as sparse grids (see below).
 
  * - grid
    - :monosp:`VolumeGrid object`
    - When creating a grid volume at runtime, e.g. from Python or C++,
-     an existing ``VolumeGrid`` instance can be passed directly rather than
-     loading it from the filesystem with :paramtype:`filename`.
+     an existing ``VolumeGrid`` or ``SparseVolumeGrid`` instance can be passed
+     directly rather than loading it from the filesystem with
+     :paramtype:`filename`.
 
  * - use_grid_bbox
    - |bool|
@@ -40,10 +44,10 @@ Grid-based volume data source (:monosp:`gridvolume`)
 
  * - data
    - |tensor|
-   - Tensor array containing the grid data. This parameter can only be specified
-     when building this plugin at runtime from Python or C++ and cannot be
-     specified in the XML scene description. The :paramtype:`raw` parameter must
-     also be set to :monosp:`true` when using a tensor.
+   - Tensor array containing the grid data. It can be specified at runtime
+     from Python or C++, or loaded from a NumPy or tensor file using the
+     ``<tensor>`` tag of the XML scene description. The :paramtype:`raw`
+     parameter must also be set to :monosp:`true` when using a tensor.
    - |exposed|, |differentiable|
 
  * - filter_type
@@ -82,7 +86,34 @@ Grid-based volume data source (:monosp:`gridvolume`)
    - |bool|
    - Hardware acceleration features can be used in CUDA mode. These features can
      cause small differences as hardware interpolation methods typically have a
-     loss of precision (not exactly 32-bit arithmetic). (Default: true)
+     loss of precision (not exactly 32-bit arithmetic). This parameter has no
+     effect on sparse grids and compact storage formats. (Default: true)
+
+ * - storage
+   - |string|
+   - Format used to store the voxel values on the device. The following
+     options are currently available:
+
+     - ``float32`` (default): single precision floating point values.
+
+     - ``float16``: half precision floating point values.
+
+     - ``uint8``: 8 bit integers that are mapped to the range of each channel
+       using a per-channel scale and offset.
+
+     Compact formats halve or quarter the memory footprint and bandwidth of
+     the grid; interpolation still runs in single precision. The volume data
+     is then no longer exposed as a differentiable parameter, and sparse grids
+     only support ``float32``.
+
+ * - sparse
+   - |bool|
+   - Convert a dense volume grid into a sparse grid at load time. (Default: false)
+
+ * - sparse_threshold
+   - |float|
+   - When converting a dense grid, :math:`8^3` blocks of voxels whose values
+     do not exceed this threshold in magnitude are discarded. (Default: 0)
 
 This class implements access to volume data stored on a 3D grid using a
 simple binary exchange format (compatible with Mitsuba 0.6). When appropriate,
@@ -123,6 +154,48 @@ little endian encoding and is specified as follows:
        :code:`data[((zpos*yres + ypos)*xres + xpos)*channels + chan]`
        where (xpos, ypos, zpos, chan) denotes the lookup location.
 
+Volumes that only occupy a small part of their bounding grid (e.g. smoke or
+cloud simulation caches) can instead be stored sparsely. Sparse grids use a
+shallow tree with a fixed topology similar to NanoVDB: a dense root table
+references internal nodes of :math:`16^3` leaves, and each allocated leaf
+stores a brick of :math:`8^3` voxels. Voxels outside of the allocated leaves
+evaluate to zero. The tree is traversed using gathers, hence the same code
+path runs on the CPU and within GPU kernels. Sparse grids do not use the
+hardware texture units. They are stored in files with the extension ``.svol``,
+which are read directly into the sparse representation and use the
+following little endian encoding:
+
+.. list-table:: Sparse volume file format
+   :widths: 8 30
+   :header-rows: 1
+
+   * - Position
+     - Content
+   * - Bytes 1-3
+     - ASCII Bytes ’S’, ’V’, and ’L’
+   * - Byte 4
+     - File format version number (currently 1)
+   * - Bytes 5-8
+     - Encoding identifier (32-bit integer). Currently, only a value of 1 is
+       supported (float32-based representation)
+   * - Bytes 9-20
+     - Number of cells along the X, Y and Z axes (32 bit integers)
+   * - Bytes 21-24
+     - Number of channels (32 bit integer, supported values: 1, 3 or 6)
+   * - Bytes 25-48
+     - Axis-aligned bounding box of the data stored in single precision (order:
+       xmin, ymin, zmin, xmax, ymax, zmax)
+   * - Bytes 49-56
+     - Number of internal nodes :math:`N` and leaves :math:`L` (32 bit
+       unsigned integers)
+   * - Bytes 57-*
+     - The root table with one 32 bit unsigned entry per :math:`128^3` block of
+       the grid (ordered with x varying fastest), holding either the index of
+       an internal node or ``0xFFFFFFFF``. Then, the :math:`N \cdot 16^3` child
+       entries of all internal nodes, holding leaf indices or ``0xFFFFFFFF``.
+       Finally, the :math:`L \cdot 8^3` voxels of all leaves, each ordered
+       like a small dense grid with interleaved channels.
+
 .. tabs::
     .. code-tab:: xml
 
@@ -159,7 +232,10 @@ template <typename Float, typename Spectrum>
 class GridVolume final : public Volume<Float, Spectrum> {
 public:
     MI_IMPORT_BASE(Volume, update_bbox, m_to_local, m_bbox, m_channel_count)
-    MI_IMPORT_TYPES(VolumeGrid)
+    MI_IMPORT_TYPES(VolumeGrid, SparseVolumeGrid)
+    using SparseGridTexture = mitsuba::SparseGridTexture<Float, Spectrum>;
+    using CompactTexture3f = CompactTexture<Float, 3>;
+    using FloatStorage = DynamicBuffer<Float>;
 
     GridVolume(const Properties &props) : Base(props) {
         std::string filter_type_str = props.string("filter_type", "trilinear");
@@ -187,9 +263,11 @@ public:
 
         m_raw = props.get<bool>("raw", false);
         m_accel = props.get<bool>("accel", true);
+        m_storage = texture_storage(props.string("storage", "float32"));
 
         // Load volume data
         ref<VolumeGrid> volume_grid = nullptr;
+        ref<SparseVolumeGrid> sparse_grid = nullptr;
         TensorXf* tensor = nullptr;
         {
             ScalarVector3u res;
@@ -203,10 +281,10 @@ public:
                 // Note: ref-counted, so we don't have to worry about lifetime
                 ref<Object> other = props.object("grid");
                 volume_grid = dynamic_cast<VolumeGrid *>(other.get());
-                if (!volume_grid)
-                    Throw("Property \"grid\" must be a VolumeGrid instance.");
-                res = volume_grid->size();
-                channel_count = volume_grid->channel_count();
+                sparse_grid = dynamic_cast<SparseVolumeGrid *>(other.get());
+                if (!volume_grid && !sparse_grid)
+                    Throw("Property \"grid\" must be a VolumeGrid or "
+                          "SparseVolumeGrid instance.");
             } else if(props.has_property("data")) {
                 tensor = props.tensor<TensorXf>("data");
                 if (tensor->ndim() != 3 && tensor->ndim() != 4)
@@ -222,41 +300,64 @@ public:
                 fs::path file_path = fs->resolve(props.string("filename"));
                 if (!fs::exists(file_path))
                     Log(Error, "\"%s\": file does not exist!", file_path);
-                volume_grid = new VolumeGrid(file_path);
+                if (file_path.extension() == ".svol")
+                    sparse_grid = new SparseVolumeGrid(file_path);
+                else
+                    volume_grid = new VolumeGrid(file_path);
+            }
+
+            if (volume_grid && props.get<bool>("sparse", false)) {
+                sparse_grid = new SparseVolumeGrid(
+                    volume_grid.get(), props.get<ScalarFloat>("sparse_threshold", 0.f));
+                volume_grid = nullptr;
+            }
+
+            if (volume_grid) {
                 res = volume_grid->size();
                 channel_count = volume_grid->channel_count();
+            } else if (sparse_grid) {
+                res = sparse_grid->size();
+                channel_count = sparse_grid->channel_count();
             }
 
             ScalarUInt32 size = dr::prod(res);
 
-            // Apply spectral conversion if necessary
-            if (is_spectral_v<Spectrum> && channel_count == 3 &&
-                !m_raw) {
+            if (sparse_grid) {
+                if (is_compact())
+                    Throw("Sparse grids only support the \"float32\" storage "
+                          "format (got \"%s\")!", m_storage);
+                m_sparse = true;
+                m_sparse_leaf_origin = sparse_grid->leaf_origins();
+
+                // Apply spectral conversion to the allocated leaves if necessary
+                if (is_spectral_v<Spectrum> && channel_count == 3 && !m_raw) {
+                    size_t voxels = sparse_grid->values().size() / 3;
+                    std::vector<ScalarFloat> scaled_data(voxels * 4);
+                    m_max = srgb_to_coefficients(sparse_grid->values().data(),
+                                                 scaled_data.data(), voxels);
+                    m_sparse_texture =
+                        SparseGridTexture(sparse_grid.get(), scaled_data.data(), 4,
+                                          filter_mode, wrap_mode);
+                } else {
+                    m_sparse_texture = SparseGridTexture(
+                        sparse_grid.get(), sparse_grid->values().data(),
+                        channel_count, filter_mode, wrap_mode);
+                    m_max = sparse_grid->max();
+                    m_max_per_channel.resize(channel_count);
+                    sparse_grid->max_per_channel(m_max_per_channel.data());
+                    m_channel_count = channel_count;
+                }
+            } else if (is_spectral_v<Spectrum> && channel_count == 3 &&
+                       !m_raw) {
+                // Apply spectral conversion if necessary
                 if (tensor)
                     Throw("Spectral conversion of tensor input is not supported "
                           "and requires a volume grid");
 
-                ScalarFloat *ptr = volume_grid->data();
-
                 auto scaled_data =
                     std::unique_ptr<ScalarFloat[]>(new ScalarFloat[size * 4]);
-                ScalarFloat *scaled_data_ptr = scaled_data.get();
-                ScalarFloat max = 0.0;
-                for (ScalarUInt32 i = 0; i < size; ++i) {
-                    ScalarColor3f rgb = dr::load<ScalarColor3f>(ptr);
-                    // TODO: Make this scaling optional if the RGB values are
-                    // between 0 and 1
-                    ScalarFloat scale = dr::max(rgb) * 2.f;
-                    ScalarColor3f rgb_norm =
-                        rgb / dr::maximum((ScalarFloat) 1e-8, scale);
-                    ScalarVector3f coeff = srgb_model_fetch(rgb_norm);
-                    max = dr::maximum(max, scale);
-                    dr::store(scaled_data_ptr,
-                              dr::concat(coeff, dr::Array<ScalarFloat, 1>(scale)));
-                    ptr += 3;
-                    scaled_data_ptr += 4;
-                }
-                m_max = (float) max;
+                m_max = srgb_to_coefficients(volume_grid->data(),
+                                             scaled_data.get(), size);
 
                 size_t shape[4] = {
                     (size_t) res.z(),
@@ -264,8 +365,7 @@ public:
                     (size_t) res.x(),
                     4
                 };
-                m_texture = Texture3f(TensorXf(scaled_data.get(), 4, shape),
-                                      m_accel, m_accel, filter_mode, wrap_mode);
+                init_texture(scaled_data.get(), shape, filter_mode, wrap_mode);
             } else if (volume_grid) {
                 size_t shape[4] = {
                     (size_t) res.z(),
@@ -273,8 +373,7 @@ public:
                     (size_t) res.x(),
                     channel_count
                 };
-                m_texture = Texture3f(TensorXf(volume_grid->data(), 4, shape),
-                                      m_accel, m_accel, filter_mode, wrap_mode);
+                init_texture(volume_grid->data(), shape, filter_mode, wrap_mode);
                 m_max = volume_grid->max();
                 m_max_per_channel.resize(volume_grid->channel_count());
                 volume_grid->max_per_channel(m_max_per_channel.data());
@@ -286,17 +385,30 @@ public:
                     (size_t) res.x(),
                     channel_count
                 };
-                m_texture = Texture3f(TensorXf(tensor->array(), 4, shape),
-                                      m_accel, m_accel, filter_mode, wrap_mode);
-                m_max = (float) dr::max_nested(dr::detach(m_texture.value()));
+                if (is_compact()) {
+                    auto &&data = dr::migrate(tensor->array(), AllocType::Host);
+                    if constexpr (dr::is_jit_v<Float>)
+                        dr::sync_thread();
+                    init_texture(data.data(), shape, filter_mode, wrap_mode);
+                } else {
+                    m_texture = Texture3f(TensorXf(tensor->array(), 4, shape),
+                                          m_accel, m_accel, filter_mode, wrap_mode);
+                    m_max = (float) dr::max_nested(dr::detach(m_texture.value()));
+                }
                 m_channel_count = channel_count;
             }
+
+            /* Rounding to the compact storage format can slightly increase
+               the values, recompute the maxima from the stored data */
+            if (is_compact())
+                update_compact_max();
         }
 
         if (props.get<bool>("use_grid_bbox", false)) {
             if (tensor)
                 Throw("use_grid_bbox is unsupported with tensor input and requires a volume grid");
-            m_to_local = volume_grid->bbox_transform() * m_to_local;
+            m_to_local = (sparse_grid ? sparse_grid->bbox_transform()
+                                      : volume_grid->bbox_transform()) * m_to_local;
             update_bbox();
         }
 
@@ -304,10 +416,15 @@ public:
             m_fixed_max = true;
             m_max = props.get<ScalarFloat>("max_value");
         }
+
+        update_min();
     }
 
     void traverse(TraversalCallback *callback) override {
-        callback->put_parameter("data", m_texture.tensor(), +ParamFlags::Differentiable);
+        if (m_sparse)
+            callback->put_parameter("data", m_sparse_texture.values(), +ParamFlags::Differentiable);
+        else if (!is_compact())
+            callback->put_parameter("data", m_texture.tensor(), +ParamFlags::Differentiable);
         Base::traverse(callback);
     }
 
@@ -319,10 +436,17 @@ public:
                       "to have %d channels, only volumes with 1, 3 or 6 "
                       "channels are supported!", to_string(), channels);
 
-            m_texture.set_tensor(m_texture.tensor());
+            if (m_sparse) {
+                if (!m_fixed_max)
+                    m_max = (float) dr::max_nested(dr::detach(m_sparse_texture.values()));
+            } else if (!is_compact()) {
+                m_texture.set_tensor(m_texture.tensor());
+
+                if (!m_fixed_max)
+                    m_max = (float) dr::max_nested(dr::detach(m_texture.value()));
+            }
 
-            if (!m_fixed_max)
-                m_max = (float) dr::max_nested(dr::detach(m_texture.value()));
+            update_min();
         }
     }
 
@@ -429,13 +553,139 @@ public:
 
     ScalarFloat max() const override { return m_max; }
 
+    ScalarFloat min() const override { return m_min; }
+
     void max_per_channel(ScalarFloat *out) const override {
         for (size_t i=0; i<m_max_per_channel.size(); ++i)
             out[i] = m_max_per_channel[i];
     }
 
+    std::vector<ScalarFloat>
+    max_per_supervoxel(const ScalarVector3i &supergrid_res) const override {
+        if (m_fixed_max)
+            return Base::max_per_supervoxel(supergrid_res);
+
+        ScalarVector3i res = resolution();
+        const size_t channels = texture_channels();
+        const bool linear = filter_mode() == dr::FilterMode::Linear;
+        const dr::WrapMode wrap = wrap_mode();
+
+        /* With spectral upsampling, the last channel stores the scale that
+           bounds the reconstructed spectrum. Otherwise, bound all channels. */
+        bool scale_only = is_spectral_v<Spectrum> && channels == 4 && !m_raw;
+        auto voxel_max = [&](const ScalarFloat *ptr) {
+            if (scale_only)
+                return ptr[channels - 1];
+            ScalarFloat value = ptr[0];
+            for (size_t c = 1; c < channels; ++c)
+                value = dr::maximum(value, ptr[c]);
+            return value;
+        };
+
+        std::vector<ScalarFloat> compact_values;
+        const ScalarFloat *data = nullptr;
+        bool migrated = false;
+        if (is_compact()) {
+            compact_values = m_compact_texture.host_values();
+            data = compact_values.data();
+        } else {
+            const FloatStorage &storage =
+                m_sparse ? m_sparse_texture.values() : m_texture.tensor().array();
+            dr::eval(storage);
+            if constexpr (dr::is_cuda_v<Float>) {
+                data = (const ScalarFloat *) jit_malloc_migrate(
+                    storage.data(), AllocType::Host, false);
+                jit_sync_thread();
+                migrated = true;
+            } else {
+                data = storage.data();
+            }
+        }
+
+        std::vector<ScalarFloat> result((size_t) dr::prod(supergrid_res), 0.f);
+        auto supervoxel = [&](int32_t x, int32_t y, int32_t z) -> ScalarFloat & {
+            x = wrap_voxel_index(x, supergrid_res.x(), wrap);
+            y = wrap_voxel_index(y, supergrid_res.y(), wrap);
+            z = wrap_voxel_index(z, supergrid_res.z(), wrap);
+            return result[((size_t) z * supergrid_res.y() + y) * supergrid_res.x() + x];
+        };
+
+        if (m_sparse) {
+            /* Splat the maximum of every leaf into the supervoxels that it
+               influences. Trilinear interpolation reaches half a voxel beyond
+               the leaf boundary, and unallocated leaves evaluate to zero. */
+            constexpr uint32_t LeafDim  = SparseVolumeGrid::LeafDim,
+                               LeafSize = SparseVolumeGrid::LeafSize;
+            const ScalarFloat pad = linear ? .5f : 0.f;
+            ScalarVector3f scale = ScalarVector3f(supergrid_res) / ScalarVector3f(res);
+
+            for (size_t leaf = 0; leaf < m_sparse_leaf_origin.size(); ++leaf) {
+                const ScalarFloat *ptr = data + leaf * LeafSize * channels;
+                ScalarFloat value = 0.f;
+                for (uint32_t i = 0; i < LeafSize; ++i)
+                    value = dr::maximum(value, voxel_max(ptr + i * channels));
+
+                ScalarVector3f origin(m_sparse_leaf_origin[leaf]);
+                ScalarVector3i lo = dr::floor2int<ScalarVector3i>((origin - pad) * scale),
+                               hi = dr::floor2int<ScalarVector3i>((origin + (LeafDim + pad)) * scale);
+                for (int32_t z = lo.z(); z <= hi.z(); ++z)
+                    for (int32_t y = lo.y(); y <= hi.y(); ++y)
+                        for (int32_t x = lo.x(); x <= hi.x(); ++x) {
+                            ScalarFloat &bound = supervoxel(x, y, z);
+                            bound = dr::maximum(bound, value);
+                        }
+            }
+        } else {
+            /* The values within a supervoxel are reconstructed from the voxels
+               that overlap it. Trilinear interpolation additionally reaches
+               into the neighboring voxels up to half a voxel beyond its
+               boundary. */
+            auto voxel_range = [&](int32_t dim, int32_t cell) {
+                ScalarFloat a = (ScalarFloat) cell / supergrid_res[dim] * res[dim],
+                            b = (ScalarFloat) (cell + 1) / supergrid_res[dim] * res[dim];
+                if (linear)
+                    return std::make_pair((int32_t) dr::floor(a - .5f),
+                                          (int32_t) dr::floor(b - .5f) + 1);
+                else
+                    return std::make_pair((int32_t) dr::floor(a),
+                                          (int32_t) dr::ceil(b) - 1);
+            };
+
+            for (int32_t cz = 0; cz < supergrid_res.z(); ++cz) {
+                auto [z0, z1] = voxel_range(2, cz);
+                for (int32_t cy = 0; cy < supergrid_res.y(); ++cy) {
+                    auto [y0, y1] = voxel_range(1, cy);
+                    for (int32_t cx = 0; cx < supergrid_res.x(); ++cx) {
+                        auto [x0, x1] = voxel_range(0, cx);
+                        ScalarFloat value = 0.f;
+                        for (int32_t z = z0; z <= z1; ++z) {
+                            size_t iz = (size_t) wrap_voxel_index(z, res.z(), wrap);
+                            for (int32_t y = y0; y <= y1; ++y) {
+                                size_t iy = (size_t) wrap_voxel_index(y, res.y(), wrap);
+                                for (int32_t x = x0; x <= x1; ++x) {
+                                    size_t ix = (size_t) wrap_voxel_index(x, res.x(), wrap);
+                                    value = dr::maximum(value, voxel_max(
+                                        data + ((iz * res.y() + iy) * res.x() + ix) * channels));
+                                }
+                            }
+                        }
+                        supervoxel(cx, cy, cz) = value;
+                    }
+                }
+            }
+        }
+
+        if (migrated)
+            jit_free((void *) data);
+
+        return result;
+    }
+
     ScalarVector3i resolution() const override {
-        const size_t *shape = m_texture.shape();
+        if (m_sparse)
+            return m_sparse_texture.shape();
+        const size_t *shape =
+            is_compact() ? m_compact_texture.shape() : m_texture.shape();
         return { (int) shape[2], (int) shape[1], (int) shape[0] };
     };
 
@@ -445,8 +695,11 @@ public:
             << "  to_local = " << string::indent(m_to_local, 13) << "," << std::endl
             << "  bbox = " << string::indent(m_bbox) << "," << std::endl
             << "  dimensions = " << resolution() << "," << std::endl
+            << "  min = " << m_min << "," << std::endl
             << "  max = " << m_max << "," << std::endl
-            << "  channels = " << m_texture.shape()[3] << std::endl
+            << "  channels = " << texture_channels() << "," << std::endl
+            << "  sparse = " << m_sparse << "," << std::endl
+            << "  storage = " << m_storage << std::endl
             << "]";
         return oss.str();
     }
@@ -461,7 +714,7 @@ protected:
      * holds all scaling coefficients is omitted.
      */
     MI_INLINE size_t nchannels() const {
-        const size_t channels = m_texture.shape()[3];
+        const size_t channels = texture_channels();
         // When spectral upsampling is requested, a fourth channel is added to
         // the internal texture data to handle scaling coefficients.
         if (is_spectral_v<Spectrum> && channels == 4 && !m_raw)
@@ -480,7 +733,7 @@ protected:
 
         Point3f p = m_to_local * it.p;
 
-        if (m_texture.filter_mode() == dr::FilterMode::Linear) {
+        if (filter_mode() == dr::FilterMode::Linear) {
             dr::Array<Float, 4> d000, d100, d010, d110, d001, d101, d011, d111;
             dr::Array<Float *, 8> fetch_values;
             fetch_values[0] = d000.data();
@@ -492,10 +745,7 @@ protected:
             fetch_values[6] = d011.data();
             fetch_values[7] = d111.data();
 
-            if (m_accel)
-                m_texture.eval_fetch(p, fetch_values, active);
-            else
-                m_texture.eval_fetch_nonaccel(p, fetch_values, active);
+            eval_fetch_texture(p, fetch_values, active);
 
             UnpolarizedSpectrum v000, v001, v010, v011, v100, v101, v110, v111;
             v000 = srgb_model_eval<UnpolarizedSpectrum>(dr::head<3>(d000), it.wavelengths);
@@ -536,10 +786,7 @@ protected:
             return result;
         } else {
             dr::Array<Float, 4> v;
-            if (m_accel)
-                m_texture.eval(p, v.data(), active);
-            else
-                m_texture.eval_nonaccel(p, v.data(), active);
+            eval_texture(p, v.data(), active);
 
             return v.w() * srgb_model_eval<UnpolarizedSpectrum>(dr::head<3>(v), it.wavelengths);
         }
@@ -555,10 +802,7 @@ protected:
 
         Point3f p = m_to_local * it.p;
         Float result;
-        if (m_accel)
-            m_texture.eval(p, &result, active);
-        else
-            m_texture.eval_nonaccel(p, &result, active);
+        eval_texture(p, &result, active);
 
         return result;
     }
@@ -574,10 +818,7 @@ protected:
 
         Point3f p = m_to_local * it.p;
         Color3f result;
-        if (m_accel)
-            m_texture.eval(p, result.data(), active);
-        else
-            m_texture.eval_nonaccel(p, result.data(), active);
+        eval_texture(p, result.data(), active);
 
         return result;
     }
@@ -593,10 +834,7 @@ protected:
 
         Point3f p = m_to_local * it.p;
         dr::Array<Float, 6> result;
-        if (m_accel)
-            m_texture.eval(p, result.data(), active);
-        else
-            m_texture.eval_nonaccel(p, result.data(), active);
+        eval_texture(p, result.data(), active);
 
         return result;
     }
@@ -612,18 +850,149 @@ protected:
         MI_MASK_ARGUMENT(active);
 
         Point3f p = m_to_local * it.p;
-        if (m_accel)
+        eval_texture(p, out, active);
+    }
+
+    /// Evaluate the dense texture or the sparse grid at a local position
+    MI_INLINE void eval_texture(const Point3f &p, Float *out, Mask active) const {
+        if (m_sparse)
+            m_sparse_texture.eval(p, out, active);
+        else if (is_compact())
+            m_compact_texture.eval(p, out, active);
+        else if (m_accel)
             m_texture.eval(p, out, active);
         else
             m_texture.eval_nonaccel(p, out, active);
     }
 
+    /// Fetch the trilinear interpolation stencil around a local position
+    MI_INLINE void eval_fetch_texture(const Point3f &p,
+                                      dr::Array<Float *, 8> &out,
+                                      Mask active) const {
+        if (m_sparse)
+            m_sparse_texture.eval_fetch(p, out, active);
+        else if (is_compact())
+            m_compact_texture.eval_fetch(p, out, active);
+        else if (m_accel)
+            m_texture.eval_fetch(p, out, active);
+        else
+            m_texture.eval_fetch_nonaccel(p, out, active);
+    }
+
+    MI_INLINE dr::FilterMode filter_mode() const {
+        if (m_sparse)
+            return m_sparse_texture.filter_mode();
+        return is_compact() ? m_compact_texture.filter_mode() : m_texture.filter_mode();
+    }
+
+    MI_INLINE dr::WrapMode wrap_mode() const {
+        if (m_sparse)
+            return m_sparse_texture.wrap_mode();
+        return is_compact() ? m_compact_texture.wrap_mode() : m_texture.wrap_mode();
+    }
+
+    /// Returns the number of channels stored in the texture or sparse grid
+    MI_INLINE size_t texture_channels() const {
+        if (m_sparse)
+            return m_sparse_texture.channel_count();
+        return is_compact() ? m_compact_texture.channel_count() : m_texture.shape()[3];
+    }
+
+    /// Is the dense voxel data kept in a compact storage format?
+    MI_INLINE bool is_compact() const {
+        return m_storage != TextureStorage::Float32;
+    }
+
+    /// Upload dense voxel data using the requested storage format
+    void init_texture(const ScalarFloat *data, const size_t shape[4],
+                      dr::FilterMode filter_mode, dr::WrapMode wrap_mode) {
+        if (is_compact())
+            m_compact_texture =
+                CompactTexture3f(data, shape, m_storage, filter_mode, wrap_mode);
+        else
+            m_texture = Texture3f(TensorXf(data, 4, shape), m_accel, m_accel,
+                                  filter_mode, wrap_mode);
+    }
+
+    /// Recompute the lower bound of the voxel values
+    void update_min() {
+        // Spectral upsampling coefficients do not bound the spectrum from below
+        if (is_spectral_v<Spectrum> && texture_channels() == 4 && !m_raw) {
+            m_min = 0.f;
+        } else if (is_compact()) {
+            std::vector<ScalarFloat> values = m_compact_texture.host_values();
+            m_min = dr::Infinity<ScalarFloat>;
+            for (ScalarFloat value : values)
+                m_min = dr::minimum(m_min, value);
+        } else if (m_sparse) {
+            m_min = (float) dr::min_nested(dr::detach(m_sparse_texture.values()));
+            // Voxels outside of the allocated leaves take on the value zero
+            size_t allocated = m_sparse_leaf_origin.size() *
+                               (size_t) SparseVolumeGrid::LeafSize;
+            if (allocated < (size_t) dr::prod(resolution()))
+                m_min = dr::minimum(m_min, 0.f);
+        } else {
+            m_min = (float) dr::min_nested(dr::detach(m_texture.value()));
+        }
+    }
+
+    /// Recompute the (per-channel) maxima from the compact voxel data
+    void update_compact_max() {
+        const size_t channels = texture_channels();
+        std::vector<ScalarFloat> values = m_compact_texture.host_values();
+        std::vector<ScalarFloat> max(channels, -dr::Infinity<ScalarFloat>);
+        for (size_t i = 0; i < values.size(); ++i)
+            max[i % channels] = dr::maximum(max[i % channels], values[i]);
+
+        if (is_spectral_v<Spectrum> && channels == 4 && !m_raw) {
+            // Only the scale factor bounds the reconstructed spectrum
+            m_max = max[3];
+        } else {
+            m_max = max[0];
+            for (size_t c = 1; c < channels; ++c)
+                m_max = dr::maximum(m_max, max[c]);
+            m_max_per_channel = max;
+        }
+    }
+
+    /**
+     * \brief Convert sRGB values into spectral upsampling coefficients and a
+     * scale factor (4 values per voxel). Returns the largest scale factor.
+     */
+    static ScalarFloat srgb_to_coefficients(const ScalarFloat *in,
+                                            ScalarFloat *out, size_t count) {
+        ScalarFloat max = 0.0, *out_start = out;
+        for (size_t i = 0; i < count; ++i) {
+            ScalarColor3f rgb = dr::load<ScalarColor3f>(in);
+            // TODO: Make this scaling optional if the RGB values are
+            // between 0 and 1
+            ScalarFloat scale = dr::max(rgb) * 2.f;
+            ScalarColor3f rgb_norm =
+                rgb / dr::maximum((ScalarFloat) 1e-8, scale);
+            max = dr::maximum(max, scale);
+            dr::store(out, dr::concat(rgb_norm, dr::Array<ScalarFloat, 1>(scale)));
+            in += 3;
+            out += 4;
+        }
+        // Convert the normalized colors in a single batch
+        srgb_model_fetch(out_start, count, 4);
+        return max;
+    }
+
 protected:
     Texture3f m_texture;
+    /// Sparse backend, used instead of \ref m_texture when \ref m_sparse is set
+    SparseGridTexture m_sparse_texture;
+    std::vector<ScalarVector3u> m_sparse_leaf_origin;
+    bool m_sparse = false;
+    /// Compact backend, used instead of \ref m_texture unless storing float32
+    CompactTexture3f m_compact_texture;
+    TextureStorage m_storage = TextureStorage::Float32;
     bool m_accel;
     bool m_raw;
     bool m_fixed_max = false;
     ScalarFloat m_max;
+    ScalarFloat m_min;
     std::vector<ScalarFloat> m_max_per_channel;
 };
 
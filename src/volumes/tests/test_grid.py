@@ -1,6 +1,7 @@
 import pytest
 import drjit as dr
 import mitsuba as mi
+import numpy as np
 import os
 
 
@@ -114,3 +115,100 @@ def test06_eval_per_channel(variants_all_rgb, tmpdir):
     it.p = mi.Point3f(1.0)
     print(vol.eval_n(it))
     assert dr.allclose(vol.eval_n(it), [1.0, 2.0, 3.0, 4.0, 5.0, 6.0])
+
+
+def test07_max_per_supervoxel(variants_all_rgb, tmpdir):
+    tmp_file = os.path.join(str(tmpdir), "out.vol")
+    grid = dr.zeros(mi.TensorXf, [4, 4, 4])
+    grid[0, 1, 3] = 2.0
+    mi.VolumeGrid(grid).write(tmp_file)
+
+    # Nearest lookups only see the voxels inside each supervoxel
+    vol = mi.load_dict({
+        'type' : 'gridvolume',
+        'filename' : tmp_file,
+        'filter_type' : 'nearest'
+    })
+    bounds = vol.max_per_supervoxel(mi.ScalarVector3i(2, 2, 2))
+    assert dr.allclose(bounds, [0, 2, 0, 0, 0, 0, 0, 0])
+
+    # Trilinear lookups also reach into the adjacent voxels
+    vol = mi.load_dict({
+        'type' : 'gridvolume',
+        'filename' : tmp_file,
+    })
+    bounds = vol.max_per_supervoxel(mi.ScalarVector3i(2, 2, 2))
+    assert dr.allclose(bounds, [0, 2, 0, 2, 0, 0, 0, 0])
+
+    # Nonzero values of the second supervoxel along y
+    it = dr.zeros(mi.Interaction3f, 1)
+    it.p = mi.Point3f(0.8, 0.55, 0.1)
+    assert dr.all(vol.eval(it)[0] > 0.0)
+
+
+@pytest.mark.parametrize('filter_type', ['nearest', 'trilinear'])
+@pytest.mark.parametrize('wrap_mode', ['clamp', 'repeat', 'mirror'])
+def test08_sparse_backend(variants_all_rgb, tmpdir, np_rng, filter_type, wrap_mode):
+    tmp_file = os.path.join(str(tmpdir), "out.svol")
+    data = np.zeros((20, 40, 24, 3), dtype=np.float32)
+    data[0:9, 12:35, 3:17, :] = np_rng.random((9, 23, 14, 3))
+    grid = mi.VolumeGrid(data)
+    mi.SparseVolumeGrid(grid).write(tmp_file)
+
+    props = {
+        'type' : 'gridvolume',
+        'filter_type' : filter_type,
+        'wrap_mode' : wrap_mode,
+        'raw' : True,
+        'accel' : False
+    }
+    dense = mi.load_dict(dict(props, grid=grid))
+    sparse = mi.load_dict(dict(props, filename=tmp_file))
+    assert dr.allclose(sparse.resolution(), dense.resolution())
+    assert dr.allclose(sparse.max(), dense.max())
+
+    # Lookups straddle leaf boundaries and the edges of the volume
+    it = dr.zeros(mi.Interaction3f, 4096)
+    it.p = mi.Point3f(np_rng.random((3, 4096)) * 1.2 - 0.1)
+    assert dr.allclose(sparse.eval(it), dense.eval(it), atol=1e-6)
+
+    # The supervoxel bounds of the sparse grid are conservative
+    bounds = np.array(sparse.max_per_supervoxel(mi.ScalarVector3i(3, 5, 2)))
+    reference = np.array(dense.max_per_supervoxel(mi.ScalarVector3i(3, 5, 2)))
+    assert np.all(bounds >= reference - 1e-6)
+
+
+@pytest.mark.parametrize('storage', ['float16', 'uint8'])
+@pytest.mark.parametrize('filter_type', ['nearest', 'trilinear'])
+@pytest.mark.parametrize('wrap_mode', ['clamp', 'repeat', 'mirror'])
+def test09_compact_storage(variants_vec_rgb, np_rng, storage, filter_type, wrap_mode):
+    data = np_rng.random((6, 10, 8, 3)).astype(np.float32) * 4.0
+    grid = mi.VolumeGrid(data)
+
+    props = {
+        'type' : 'gridvolume',
+        'grid' : grid,
+        'filter_type' : filter_type,
+        'wrap_mode' : wrap_mode,
+        'raw' : True,
+        'accel' : False
+    }
+    dense = mi.load_dict(props)
+    compact = mi.load_dict(dict(props, storage=storage))
+    assert dr.allclose(compact.resolution(), dense.resolution())
+    assert not 'data' in mi.traverse(compact)
+
+    # Half precision and 8 bit quantization of values in [0, 4]
+    atol = 4.0 * (2**-11 if storage == 'float16' else 0.5 / 255)
+    it = dr.zeros(mi.Interaction3f, 1024)
+    it.p = mi.Point3f(np_rng.random((3, 1024)) * 1.2 - 0.1)
+    assert dr.allclose(compact.eval(it), dense.eval(it), atol=atol)
+
+    # The maximum bounds the stored (rounded) values
+    assert compact.max() >= dense.max() - atol
+    bounds = np.array(compact.max_per_supervoxel(mi.ScalarVector3i(2, 3, 2)))
+    assert len(bounds) == 12
+    assert dr.allclose(bounds.max(), compact.max())
+
+    with pytest.raises(RuntimeError, match='Invalid storage format'):
+        mi.load_dict(dict(props, storage='float64'))